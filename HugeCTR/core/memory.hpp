@@ -15,11 +15,24 @@
  */
 #pragma once
 
+#include <numaif.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
 #include <cstdlib>
 #include <limits>
 #include <memory>
 #include <new>
 
+// Older C libraries only define the shift, not the page size flags.
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
 /**
  * Will allocate aligned memory in std::vectors, std::unique_ptr and such.
  *
@@ -132,3 +145,138 @@ struct AlignedAllocator {
    */
   inline static shared_ptr_type make_shared(size_type n = 1) { return {allocate(n), std::free}; }
 };
+
+constexpr std::size_t huge_page_size_2m{2L * 1024 * 1024};
+constexpr std::size_t huge_page_size_1g{1024L * 1024 * 1024};
+
+/**
+ * @return Whether \p page_size can be passed to map_host_pages. 0 selects the system page size.
+ */
+inline bool is_valid_host_page_size(const std::size_t page_size) {
+  return page_size == 0 || page_size == huge_page_size_2m || page_size == huge_page_size_1g;
+}
+
+/**
+ * @return \p size rounded up to a multiple of \p page_size (or of the system page size, if 0).
+ */
+inline std::size_t host_pages_size(const std::size_t size, const std::size_t page_size) {
+  const std::size_t granularity{page_size ? page_size
+                                          : static_cast<std::size_t>(sysconf(_SC_PAGESIZE))};
+  return (size + granularity - 1) / granularity * granularity;
+}
+
+/**
+ * Maps anonymous host memory of at least \p size bytes, backed by pages of \p page_size bytes and
+ * bound to the NUMA node \p numa_node (no binding if negative). Huge pages cut the TLB misses of
+ * random gathers over large host tables.
+ *
+ * Explicit huge pages must have been reserved by the administrator (`vm.nr_hugepages`, and
+ * `hugepagesz=1G hugepages=N` on the kernel command line for 1 GiB pages). If none are left, the
+ * mapping falls back to system pages and asks for transparent huge pages instead.
+ *
+ * @return The mapping, or nullptr if it failed. Release it with unmap_host_pages.
+ */
+inline void* map_host_pages(std::size_t size, const std::size_t page_size, const int numa_node) {
+  if (!is_valid_host_page_size(page_size) ||
+      numa_node >= std::numeric_limits<unsigned long>::digits) {
+    return nullptr;
+  }
+  size = host_pages_size(size, page_size);
+
+  void* p{MAP_FAILED};
+  if (page_size) {
+    const int huge_flags{MAP_HUGETLB |
+                         (page_size == huge_page_size_1g ? MAP_HUGE_1GB : MAP_HUGE_2MB)};
+    p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | huge_flags, -1,
+             0);
+  }
+  if (p == MAP_FAILED) {
+    p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+      return nullptr;
+    }
+    if (page_size) {
+      madvise(p, size, MADV_HUGEPAGE);
+    }
+  }
+
+  // The pages are only placed when they are first touched, which happens after the binding. We
+  // issue the system call directly, so that the users of this header need not link libnuma.
+  if (numa_node >= 0) {
+    const unsigned long node_mask{1UL << numa_node};
+    if (syscall(SYS_mbind, p, size, MPOL_BIND, &node_mask,
+                std::numeric_limits<unsigned long>::digits, 0) != 0) {
+      munmap(p, size);
+      return nullptr;
+    }
+  }
+  return p;
+}
+
+/**
+ * Releases a mapping obtained from map_host_pages, with the same \p size and \p page_size.
+ */
+inline void unmap_host_pages(void* const p, const std::size_t size, const std::size_t page_size) {
+  munmap(p, host_pages_size(size, page_size));
+}
+
+/**
+ * Stateful counterpart of AlignedAllocator that backs the allocations with map_host_pages. With the
+ * default \p page_size and without a \p numa_node, it allocates like AlignedAllocator does.
+ */
+template <typename T, std::size_t ALIGNMENT = 64>
+struct HostPageAllocator {
+  using value_type = T;
+  using size_type = std::size_t;
+
+  static constexpr size_type alignment{ALIGNMENT};
+
+  template <typename U>
+  struct rebind {
+    using other = HostPageAllocator<U, alignment>;
+  };
+
+  size_type page_size{0};
+  int numa_node{-1};
+
+  constexpr HostPageAllocator() noexcept = default;
+  constexpr HostPageAllocator(const size_type page_size, const int numa_node) noexcept
+      : page_size{page_size}, numa_node{numa_node} {}
+  template <typename U>
+  constexpr HostPageAllocator(const HostPageAllocator<U, alignment>& other) noexcept
+      : page_size{other.page_size}, numa_node{other.numa_node} {}
+
+  inline bool maps_pages() const { return page_size || numa_node >= 0; }
+
+  [[nodiscard]] inline value_type* allocate(const size_type n = 1) const {
+    if (!maps_pages()) {
+      return AlignedAllocator<value_type, alignment>::allocate(n);
+    }
+    if (n > std::numeric_limits<size_type>::max() / sizeof(value_type)) {
+      throw std::bad_array_new_length();
+    }
+    void* const p{map_host_pages(n * sizeof(value_type), page_size, numa_node)};
+    if (p) {
+      return static_cast<value_type*>(p);
+    }
+
+    throw std::bad_alloc();
+  }
+
+  inline void deallocate(value_type* const p, const size_type n) const noexcept {
+    if (maps_pages()) {
+      unmap_host_pages(p, n * sizeof(value_type), page_size);
+    } else {
+      AlignedAllocator<value_type, alignment>::deallocate(p, n);
+    }
+  }
+
+  template <typename U>
+  inline bool operator==(const HostPageAllocator<U, alignment>& other) const {
+    return page_size == other.page_size && numa_node == other.numa_node;
+  }
+  template <typename U>
+  inline bool operator!=(const HostPageAllocator<U, alignment>& other) const {
+    return !operator==(other);
+  }
+};
@@ -15,6 +15,7 @@
  */
 
 #include <core23/allocator_factory.hpp>
+#include <core23/details/huge_page_host_allocator.hpp>
 #include <core23/details/low_level_cuda_allocator.hpp>
 #include <core23/details/managed_cuda_allocator.hpp>
 #include <core23/details/new_delete_allocator.hpp>
@@ -47,7 +48,12 @@ std::unique_ptr<Allocator> GetDefaultCPUAllocator(const AllocatorParams& allocat
   std::unique_ptr<Allocator> ret;
   if (!allocator_params.compressible) {
     if (allocator_params.pinned) {
-      ret.reset(new PinnedHostAllocator());
+      if (allocator_params.host_page_size > 0 || allocator_params.numa_node >= 0) {
+        ret.reset(new HugePageHostAllocator(allocator_params.host_page_size,
+                                            allocator_params.numa_node));
+      } else {
+        ret.reset(new PinnedHostAllocator());
+      }
     } else {
       ret.reset(new NewDeleteAllocator());
     }
@@ -15,6 +15,7 @@
  */
 
 #include <core23/allocator_params.hpp>
+#include <core23/details/caching_cuda_allocator.hpp>
 
 namespace HugeCTR {
 
@@ -23,5 +24,13 @@ namespace core23 {
 AllocatorParams::CustomFactory AllocatorParams::default_allocator_factory =
     [](const auto&, const auto&) -> std::unique_ptr<Allocator> { return nullptr; };
 
+AllocatorParams::CustomFactory AllocatorParams::caching_allocator_factory =
+    [](const auto&, const auto& device) -> std::unique_ptr<Allocator> {
+  if (device.type() != DeviceType::GPU) {
+    return nullptr;
+  }
+  return std::make_unique<CachingCUDAAllocator>(device);
+};
+
 }  // namespace core23
 }  // namespace HugeCTR
@@ -28,8 +28,14 @@ struct AllocatorParams {
   using CustomFactory =
       std::function<std::unique_ptr<Allocator>(const AllocatorParams&, const Device& device)>;
   static CustomFactory default_allocator_factory;
+  // Serves the GPU allocations from a CachingCUDAAllocator, see caching_cuda_allocator.hpp
+  static CustomFactory caching_allocator_factory;
   bool pinned = true;
   bool compressible = false;  // TODO: perhaps replace by a Decorator
+  // Host allocations only: 2 MiB or 1 GiB pages and the NUMA node to bind them to, see
+  // HugePageHostAllocator. 0 and -1 keep the plain cudaHostAlloc.
+  int64_t host_page_size = 0;
+  int numa_node = -1;
   CustomFactory custom_factory = default_allocator_factory;
 };
 
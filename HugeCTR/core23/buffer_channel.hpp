@@ -54,6 +54,9 @@ class BufferChannel {
   std::shared_ptr<Buffer> get_buffer(Key) const { return buffer_.lock(); }
 
  private:
+  friend BufferChannel GetRandomBufferChannel();
+  explicit BufferChannel(int64_t raw_channel) : raw_channel_(raw_channel) {}
+
   int64_t raw_channel_;
   mutable std::weak_ptr<Buffer> buffer_;
 };
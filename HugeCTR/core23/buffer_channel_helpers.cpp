@@ -29,10 +29,9 @@ std::string GetRandomBufferChannelName() {
       "abcdefghijklmnopqrstuvwxyz"
       "0123456789";
 
-  static std::random_device r;
-  static std::default_random_engine e(r());
-  static std::uniform_int_distribution<int> length_dist(32, 64);
-  static std::uniform_int_distribution<int> alpha_dist(0, sizeof(alpha) - 1);
+  thread_local std::default_random_engine e(std::random_device{}());
+  thread_local std::uniform_int_distribution<int> length_dist(32, 64);
+  thread_local std::uniform_int_distribution<int> alpha_dist(0, sizeof(alpha) - 1);
 
   std::string name(length_dist(e), 0);
   std::generate_n(name.begin(), name.length(), []() { return alpha[alpha_dist(e)]; });
@@ -40,7 +39,11 @@ std::string GetRandomBufferChannelName() {
   return name;
 }
 
-BufferChannel GetRandomBufferChannel() { return GetRandomBufferChannelName(); }
+// Every default BufferParams, thus every TensorParams, draws a channel, so it skips the name.
+BufferChannel GetRandomBufferChannel() {
+  thread_local std::mt19937_64 e(std::random_device{}());
+  return BufferChannel(static_cast<int64_t>(e()));
+}
 
 }  // namespace core23
 }  // namespace HugeCTR
@@ -17,7 +17,9 @@
 #include <core23/allocator_factory.hpp>
 #include <core23/buffer_factory.hpp>
 #include <core23/buffer_params.hpp>
+#include <core23/details/aliasing_buffer.hpp>
 #include <core23/details/confederal_buffer.hpp>
+#include <core23/details/mirrored_buffer.hpp>
 #include <core23/details/unitary_buffer.hpp>
 #include <core23/logger.hpp>
 #include <memory>
@@ -32,6 +34,7 @@ namespace core23 {
 namespace {
 
 std::unordered_map<Device, std::unordered_set<BufferChannel>> g_buffers;
+std::unordered_map<BufferChannel, BufferChannel> g_mirrored_channels;
 
 }  // namespace
 
@@ -52,7 +55,15 @@ std::shared_ptr<Buffer> GetBuffer(const BufferParams& buffer_params, const Devic
       HCTR_THROW_IF(allocator == nullptr, HugeCTR::Error_t::IllegalCall,
                     "A Buffer must be created but no allocator is specified.");
 
-      if (buffer_params.unitary) {
+      if (auto mirrored = g_mirrored_channels.find(buffer_params.channel);
+          mirrored != g_mirrored_channels.end()) {
+        BufferParams source_params;
+        source_params.channel = mirrored->second;
+        auto source = GetBuffer(source_params, device, GetAllocator(AllocatorParams(), device));
+        buffer = std::make_shared<MirroredBuffer>(device, std::move(allocator), source);
+      } else if (buffer_params.aliased) {
+        buffer = std::make_shared<AliasingBuffer>(device, std::move(allocator));
+      } else if (buffer_params.unitary) {
         buffer = std::make_shared<UnitaryBuffer>(device, std::move(allocator));
       } else {
         buffer = std::make_shared<ConfederalBuffer>(device, std::move(allocator));
@@ -64,6 +75,12 @@ std::shared_ptr<Buffer> GetBuffer(const BufferParams& buffer_params, const Devic
   return buffer;
 }
 
+void MirrorBufferChannel(const BufferChannel& channel, const BufferChannel& source) {
+  HCTR_THROW_IF(channel == source, HugeCTR::Error_t::WrongInput,
+                "A BufferChannel cannot mirror itself.");
+  g_mirrored_channels.insert_or_assign(channel, source);
+}
+
 bool AllocateBuffers(const Device& device) {
   auto it = g_buffers.find(device);
   if (it != g_buffers.end()) {
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <core23/buffer.hpp>
+#include <core23/buffer_channel.hpp>
 #include <functional>
 #include <memory>
 
@@ -34,6 +35,15 @@ struct BufferParams;
 
 [[nodiscard]] bool AllocateBuffers(const Device& device);
 
+/**
+ * Makes the Buffers of \p channel lay out their tensors over the memory of the Buffers of
+ * \p source, on the same device, instead of allocating their own. The tensors of both channels
+ * must come in the same order and sizes, e.g. the weights of two networks built from the same
+ * layers, so that each tensor of \p channel is a view of its counterpart. It must be called
+ * before the first tensor of \p channel is created.
+ */
+void MirrorBufferChannel(const BufferChannel& channel, const BufferChannel& source);
+
 }  // namespace core23
 
 }  // namespace HugeCTR
@@ -35,6 +35,8 @@ struct BufferParams {
 
   BufferChannel channel = GetRandomBufferChannel();
   bool unitary = true;
+  // One allocation like `unitary`, but the clients whose live ranges don't overlap share memory
+  bool aliased = false;
   static CustomFactory custom_factory;
 };
 
@@ -27,6 +27,11 @@ struct BufferRequirements {
   int64_t num_bytes;
   int64_t alignment;
   CUDAStream stream;
+  // The steps, e.g. the layer indices, at which the memory is first and last used. Only an
+  // aliasing Buffer looks at them. A negative `last_use` means that the memory is used until the
+  // end.
+  int64_t first_use = 0;
+  int64_t last_use = -1;
 };
 
 }  // namespace core23
@@ -128,7 +128,7 @@ template <typename KeyEntry, typename TableEntry, typename CounterType, typename
 HCTR_DEVICE_INLINE CounterType get_insert_dump(const KeyEntry key, TableEntry *table,
                                                CounterType *d_global_counter, KeyEntry &unique_out,
                                                size_t capacity, KeyEntry empty_key,
-                                               bool &is_unique) {
+                                               bool &is_unique, size_t *insert_pos = nullptr) {
   using TableValue = typename TableEntry::value_type;
   using KeyType = typename TableEntry::key_type;
   CounterType current_idx = 0;
@@ -151,6 +151,7 @@ HCTR_DEVICE_INLINE CounterType get_insert_dump(const KeyEntry key, TableEntry *t
         *table_value_ptr = insert_value.value;
         unique_out = key;
         is_unique = true;
+        if (insert_pos) *insert_pos = pos;
         break;
       } else if (old_key == key.store_idx()) {
         insert_value.value = *table_value_ptr;
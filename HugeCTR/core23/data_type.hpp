@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <cuda_bf16.h>
 #include <cuda_fp16.h>
 
 #include <cstdint>
@@ -38,7 +39,8 @@ namespace core23 {
   PH(uint32_t, UInt32)               \
   PH(int64_t, Int64)                 \
   PH(uint64_t, UInt64)               \
-  PH(void *, Pointer)
+  PH(void *, Pointer)                \
+  PH(__nv_bfloat16, BFloat16)
 
 #define DATA_TYPE_ENUMERIZE(_, E) E,
 
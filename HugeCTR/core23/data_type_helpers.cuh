@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <cuda_bf16.h>
 #include <cuda_fp16.h>
 
 #include <core23/data_type.hpp>
@@ -29,6 +30,8 @@ namespace core23 {
   PH(__half, float, __float2half)              \
   PH(float, float, static_cast<float>)         \
   PH(float, __half, __half2float)              \
+  PH(__nv_bfloat16, float, __float2bfloat16)   \
+  PH(float, __nv_bfloat16, __bfloat162float)   \
   PH(float, int32_t, static_cast<float>)       \
   PH(float, long long, static_cast<float>)     \
   PH(float, int64_t, static_cast<float>)       \
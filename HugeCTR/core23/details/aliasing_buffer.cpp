@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <core23/allocator.hpp>
+#include <core23/buffer_client.hpp>
+#include <core23/details/aliasing_buffer.hpp>
+#include <core23/device.hpp>
+#include <core23/logger.hpp>
+#include <core23/offsetted_buffer.hpp>
+#include <limits>
+#include <memory>
+
+namespace HugeCTR {
+
+namespace core23 {
+
+namespace {
+
+struct Placement {
+  BufferClient* client;
+  int64_t num_bytes;
+  int64_t alignment;
+  int64_t first_use;
+  int64_t last_use;
+  int64_t offset;
+};
+
+int64_t align_offset(int64_t offset, int64_t alignment) {
+  if (alignment != 0) {
+    int64_t rem = offset % alignment;
+    if (rem != 0) {
+      offset += alignment - rem;
+    }
+  }
+  return offset;
+}
+
+bool live_ranges_overlap(const Placement& a, const Placement& b) {
+  return a.first_use <= b.last_use && b.first_use <= a.last_use;
+}
+
+}  // namespace
+
+AliasingBuffer::AliasingBuffer(const Device& device, std::unique_ptr<Allocator> allocator)
+    : Buffer(device, std::move(allocator)), allocated_(false), ptr_(nullptr), size_(0LL) {}
+
+AliasingBuffer::~AliasingBuffer() {
+  if (allocated_ || ptr_ != nullptr) allocator()->deallocate(ptr_);
+}
+
+int64_t AliasingBuffer::plan(const ClientRequirements& client_requirements,
+                             ClientOffsets& client_offsets) const {
+  std::vector<Placement> placements;
+  placements.reserve(client_requirements.size());
+  for (BufferClient* client : insertion_order_) {
+    auto search = client_requirements.find(client);
+    if (search != client_requirements.end()) {
+      const BufferRequirements& requirements = search->second;
+      placements.push_back({client, requirements.num_bytes, requirements.alignment,
+                            requirements.first_use,
+                            requirements.last_use < 0 ? std::numeric_limits<int64_t>::max()
+                                                      : requirements.last_use,
+                            0});
+    }
+  }
+
+  // Greedy interval coloring: the largest clients are placed first, each at the lowest offset that
+  // doesn't collide with an already placed client whose live range overlaps.
+  std::stable_sort(
+      placements.begin(), placements.end(),
+      [](const Placement& a, const Placement& b) { return a.num_bytes > b.num_bytes; });
+  int64_t total_size = 0;
+  std::vector<const Placement*> conflicts;
+  for (auto it = placements.begin(); it != placements.end(); ++it) {
+    conflicts.clear();
+    for (auto placed = placements.begin(); placed != it; ++placed) {
+      if (live_ranges_overlap(*placed, *it)) {
+        conflicts.push_back(&*placed);
+      }
+    }
+    std::sort(conflicts.begin(), conflicts.end(),
+              [](const Placement* a, const Placement* b) { return a->offset < b->offset; });
+
+    int64_t offset = align_offset(0, it->alignment);
+    for (const Placement* conflict : conflicts) {
+      if (offset + it->num_bytes <= conflict->offset) {
+        break;
+      }
+      offset =
+          std::max(offset, align_offset(conflict->offset + conflict->num_bytes, it->alignment));
+    }
+    it->offset = offset;
+    total_size = std::max(total_size, offset + it->num_bytes);
+    client_offsets[it->client] = offset;
+  }
+  return total_size;
+}
+
+size_t AliasingBuffer::do_get_reserved_size(const std::unique_ptr<Allocator>& allocator,
+                                            const ClientRequirements& client_requirements) {
+  ClientOffsets client_offsets;
+  return plan(client_requirements, client_offsets);
+}
+
+Buffer::ClientOffsets AliasingBuffer::do_allocate(const std::unique_ptr<Allocator>& allocator,
+                                                  const ClientRequirements& client_requirements) {
+  if (client_requirements.empty()) {
+    HCTR_OWN_THROW(
+        HugeCTR::Error_t::IllegalCall,
+        "The buffer doesn't have any subscriber at all. What is the point of allocate()?");
+  }
+
+  if (allocated_) {
+    HCTR_OWN_THROW(HugeCTR::Error_t::IllegalCall,
+                   "The AliasingBuffer doesn't allow the multiple allocation.");
+  }
+
+  ClientOffsets client_offsets;
+  size_ = plan(client_requirements, client_offsets);
+
+  int64_t total_bytes = 0;
+  for (auto& [client, requirements] : client_requirements) {
+    total_bytes += requirements.num_bytes;
+  }
+  HCTR_LOG_S(DEBUG, ROOT) << "The AliasingBuffer packs " << total_bytes << " bytes of "
+                          << client_requirements.size() << " clients into " << size_ << " bytes"
+                          << std::endl;
+
+  // The offsets rely on the default alignment of the allocator
+  const auto& first_stream = client_requirements.begin()->second.stream;
+  ptr_ = allocator->allocate(size_, first_stream);
+  if (ptr_ == nullptr && size_) {
+    HCTR_OWN_THROW(HugeCTR::Error_t::OutOfMemory,
+                   "The AliasingBuffer failed to allocate the memory");
+  }
+  allocated_ = true;
+  insertion_order_.clear();
+
+  return client_offsets;
+}
+
+void AliasingBuffer::post_subscribe(const BufferClient* client, BufferRequirements requirements) {
+  insertion_order_.push_back(const_cast<BufferClient*>(client));
+}
+
+}  // namespace core23
+
+}  // namespace HugeCTR
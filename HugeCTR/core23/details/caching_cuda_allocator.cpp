@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <core23/details/caching_cuda_allocator.hpp>
+#include <core23/device.hpp>
+#include <core23/device_guard.hpp>
+#include <core23/logger.hpp>
+#include <core23/macros.hpp>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+namespace HugeCTR {
+
+namespace core23 {
+
+namespace {
+
+constexpr int64_t kMinBlockSize = 512;
+constexpr int64_t kSmallBlockLimit = 1 << 20;
+constexpr int64_t kLargeBlockRounding = 2 << 20;
+
+int64_t round_to_size_class(int64_t size) {
+  const int64_t rounding = size <= kSmallBlockLimit ? kMinBlockSize : kLargeBlockRounding;
+  return (size + rounding - 1) / rounding * rounding;
+}
+
+}  // namespace
+
+class CachingCUDAPool {
+ public:
+  explicit CachingCUDAPool(const Device& device) : device_(device) {}
+  ~CachingCUDAPool() {
+    // Runs at exit for the shared pools, when the CUDA runtime may be gone already. Errors are
+    // therefore ignored.
+    for (auto& [stream, free_list] : free_lists_) {
+      for (auto& [size, block] : free_list) {
+        cudaFree(block.ptr);
+        cudaEventDestroy(block.event);
+      }
+    }
+  }
+
+  static std::shared_ptr<CachingCUDAPool> get(const Device& device) {
+    HCTR_THROW_IF(device == DeviceType::CPU, Error_t::IllegalCall,
+                  "CachingCUDAAllocator cannot be used for CPU");
+    static std::mutex mutex;
+    static std::unordered_map<int64_t, std::shared_ptr<CachingCUDAPool>> pools;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& pool = pools[device.index()];
+    if (!pool) {
+      pool = std::make_shared<CachingCUDAPool>(device);
+    }
+    return pool;
+  }
+
+  void* allocate(int64_t size, cudaStream_t stream) {
+    if (size == 0) {
+      return nullptr;
+    }
+    const int64_t block_size = round_to_size_class(size);
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Block block{};
+    bool found = take_block(free_lists_[stream], block_size, block);
+    if (found) {
+      stats_.num_cache_hits++;
+    } else {
+      for (auto& [other_stream, free_list] : free_lists_) {
+        if (other_stream != stream && take_block(free_list, block_size, block)) {
+          // Kernels of the other stream may still use the block.
+          HCTR_LIB_THROW(cudaStreamWaitEvent(stream, block.event, 0));
+          stats_.num_cache_hits++;
+          stats_.num_cross_stream_hits++;
+          found = true;
+          break;
+        }
+      }
+    }
+    if (!found) {
+      block.size = block_size;
+      block.ptr = malloc_block(block_size);
+      HCTR_LIB_THROW(cudaEventCreateWithFlags(&block.event, cudaEventDisableTiming));
+      stats_.num_cache_misses++;
+    }
+
+    block.requested = size;
+    allocated_blocks_[block.ptr] = block;
+    stats_.requested_bytes += size;
+    stats_.allocated_bytes += block.size;
+    stats_.peak_allocated_bytes = std::max(stats_.peak_allocated_bytes, stats_.allocated_bytes);
+    return block.ptr;
+  }
+
+  void deallocate(void* ptr, cudaStream_t stream) {
+    if (ptr == nullptr) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = allocated_blocks_.find(ptr);
+    HCTR_THROW_IF(it == allocated_blocks_.end(), Error_t::IllegalCall,
+                  "The pointer was not allocated by the CachingCUDAAllocator");
+    Block block = it->second;
+    allocated_blocks_.erase(it);
+    stats_.requested_bytes -= block.requested;
+    stats_.allocated_bytes -= block.size;
+
+    HCTR_LIB_THROW(cudaEventRecord(block.event, stream));
+    free_lists_[stream].emplace(block.size, block);
+    stats_.cached_bytes += block.size;
+  }
+
+  CachingCUDAAllocatorStats stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+  }
+
+  void empty_cache() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    release_cached_blocks();
+  }
+
+ private:
+  struct Block {
+    void* ptr;
+    int64_t size;
+    int64_t requested;
+    cudaEvent_t event;
+  };
+  using FreeList = std::multimap<int64_t, Block>;
+
+  // Blocks of up to twice the size class are reused, larger ones would waste too much memory.
+  bool take_block(FreeList& free_list, int64_t block_size, Block& block) {
+    auto it = free_list.lower_bound(block_size);
+    if (it == free_list.end() || it->first > 2 * block_size) {
+      return false;
+    }
+    block = it->second;
+    free_list.erase(it);
+    stats_.cached_bytes -= block.size;
+    return true;
+  }
+
+  void* malloc_block(int64_t block_size) {
+    DeviceGuard device_guard(device_);
+    void* ptr = nullptr;
+    cudaError_t error = cudaMalloc(&ptr, block_size);
+    if (error == cudaErrorMemoryAllocation) {
+      // Return the cached blocks to CUDA and try again.
+      cudaGetLastError();
+      release_cached_blocks();
+      error = cudaMalloc(&ptr, block_size);
+    }
+    HCTR_LIB_THROW(error);
+    return ptr;
+  }
+
+  void release_cached_blocks() {
+    DeviceGuard device_guard(device_);
+    for (auto& [stream, free_list] : free_lists_) {
+      for (auto& [size, block] : free_list) {
+        // cudaFree synchronizes with the device, so the pending events are complete.
+        HCTR_LIB_THROW(cudaFree(block.ptr));
+        HCTR_LIB_THROW(cudaEventDestroy(block.event));
+      }
+      free_list.clear();
+    }
+    stats_.cached_bytes = 0;
+  }
+
+  Device device_;
+  mutable std::mutex mutex_;
+  std::unordered_map<cudaStream_t, FreeList> free_lists_;
+  std::unordered_map<void*, Block> allocated_blocks_;
+  CachingCUDAAllocatorStats stats_;
+};
+
+CachingCUDAAllocator::CachingCUDAAllocator(const Device& device)
+    : pool_(CachingCUDAPool::get(device)) {}
+
+CachingCUDAAllocator::~CachingCUDAAllocator() {}
+
+void* CachingCUDAAllocator::allocate(int64_t size, CUDAStream stream) {
+  return pool_->allocate(size, stream());
+}
+
+void CachingCUDAAllocator::deallocate(void* ptr, CUDAStream stream) {
+  pool_->deallocate(ptr, stream());
+}
+
+int64_t CachingCUDAAllocator::default_alignment() const { return kcudaAllocationAlignment; }
+
+CachingCUDAAllocatorStats CachingCUDAAllocator::stats(const Device& device) {
+  return CachingCUDAPool::get(device)->stats();
+}
+
+void CachingCUDAAllocator::empty_cache(const Device& device) {
+  CachingCUDAPool::get(device)->empty_cache();
+}
+
+}  // namespace core23
+
+}  // namespace HugeCTR
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <core23/allocator.hpp>
+#include <cstdint>
+#include <memory>
+
+namespace HugeCTR {
+
+namespace core23 {
+
+class Device;
+class CachingCUDAPool;
+
+struct CachingCUDAAllocatorStats {
+  int64_t requested_bytes = 0;       // Handed out, as requested
+  int64_t allocated_bytes = 0;       // Handed out, rounded up to the size classes
+  int64_t peak_allocated_bytes = 0;  // Maximum of `allocated_bytes`
+  int64_t cached_bytes = 0;          // Held in the free lists
+  int64_t num_cache_hits = 0;
+  int64_t num_cross_stream_hits = 0;  // Hits served from the free list of another stream
+  int64_t num_cache_misses = 0;
+
+  // Share of the handed out memory that is lost to the rounding to size classes
+  double fragmentation() const {
+    return allocated_bytes ? 1. - static_cast<double>(requested_bytes) / allocated_bytes : 0.;
+  }
+};
+
+/**
+ * A stream-ordered caching allocator. Freed blocks are not returned to CUDA but kept in a free list
+ * per stream, binned by size class. A block freed on a stream is reused on the same stream without
+ * any synchronization. Another stream reuses it after waiting for an event recorded at the free.
+ * All CachingCUDAAllocators of a device share one cache, so that short-lived buffers like operator
+ * workspaces find the blocks of their predecessors.
+ * To use it, set AllocatorParams::custom_factory to AllocatorParams::caching_allocator_factory.
+ */
+class CachingCUDAAllocator : public Allocator {
+ public:
+  CachingCUDAAllocator(const Device& device);
+  ~CachingCUDAAllocator() override;
+
+  void* allocate(int64_t size, CUDAStream stream) override;
+
+  void deallocate(void* ptr, CUDAStream stream) override;
+
+  int64_t default_alignment() const override;
+
+  static CachingCUDAAllocatorStats stats(const Device& device);
+  // Returns the cached blocks of the device to CUDA
+  static void empty_cache(const Device& device);
+
+ private:
+  std::shared_ptr<CachingCUDAPool> pool_;
+};
+
+}  // namespace core23
+
+}  // namespace HugeCTR
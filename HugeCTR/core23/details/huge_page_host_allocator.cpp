@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/memory.hpp>
+#include <core23/details/huge_page_host_allocator.hpp>
+#include <core23/logger.hpp>
+
+namespace HugeCTR {
+
+namespace core23 {
+
+HugePageHostAllocator::HugePageHostAllocator(int64_t page_size, int numa_node)
+    : page_size_(page_size), numa_node_(numa_node) {
+  HCTR_THROW_IF(page_size < 0 || !is_valid_host_page_size(page_size), Error_t::WrongInput,
+                "The host page size must be 0, 2 MiB or 1 GiB, not ", page_size, " bytes");
+}
+
+void* HugePageHostAllocator::allocate(int64_t size, CUDAStream) {
+  void* ptr = map_host_pages(size, page_size_, numa_node_);
+  HCTR_THROW_IF(ptr == nullptr, Error_t::OutOfMemory, "Cannot map ", size,
+                " bytes of host memory with a page size of ", page_size_, " on the NUMA node ",
+                numa_node_);
+  cudaError_t err = cudaHostRegister(ptr, size, cudaHostRegisterPortable);
+  if (err != cudaSuccess) {
+    unmap_host_pages(ptr, size, page_size_);
+    HCTR_LIB_THROW(err);
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  sizes_.emplace(ptr, size);
+  return ptr;
+}
+
+void HugePageHostAllocator::deallocate(void* ptr, CUDAStream) {
+  int64_t size;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sizes_.find(ptr);
+    HCTR_THROW_IF(it == sizes_.end(), Error_t::IllegalCall,
+                  "The pointer was not allocated by this allocator");
+    size = it->second;
+    sizes_.erase(it);
+  }
+  HCTR_LIB_THROW(cudaHostUnregister(ptr));
+  unmap_host_pages(ptr, size, page_size_);
+}
+
+int64_t HugePageHostAllocator::default_alignment() const {
+  return page_size_ ? page_size_ : sysconf(_SC_PAGESIZE);
+}
+
+}  // namespace core23
+
+}  // namespace HugeCTR
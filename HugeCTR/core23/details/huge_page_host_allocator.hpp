@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <core23/allocator.hpp>
+#include <mutex>
+#include <unordered_map>
+
+namespace HugeCTR {
+
+namespace core23 {
+
+/**
+ * Pinned host memory on huge pages bound to a NUMA node. The pages are mapped with
+ * map_host_pages from core/memory.hpp and then registered with CUDA, so that the copies to the
+ * GPUs run at the speed of cudaHostAlloc'ed memory, while the host-side gathers over the buffer
+ * take fewer TLB misses.
+ */
+class HugePageHostAllocator : public Allocator {
+ public:
+  // page_size is 0 (system pages), 2 MiB or 1 GiB, numa_node is -1 for no binding
+  HugePageHostAllocator(int64_t page_size, int numa_node);
+  ~HugePageHostAllocator() override {}
+
+  void* allocate(int64_t size, CUDAStream) override;
+
+  void deallocate(void* ptr, CUDAStream) override;
+
+  int64_t default_alignment() const override;
+
+ private:
+  int64_t page_size_;
+  int numa_node_;
+
+  // munmap() needs the size of the mapping
+  std::mutex mutex_;
+  std::unordered_map<void*, int64_t> sizes_;
+};
+
+}  // namespace core23
+
+}  // namespace HugeCTR
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core23/allocator.hpp>
+#include <core23/buffer_client.hpp>
+#include <core23/details/mirrored_buffer.hpp>
+#include <core23/device.hpp>
+#include <core23/logger.hpp>
+#include <core23/offsetted_buffer.hpp>
+#include <memory>
+
+namespace HugeCTR {
+
+namespace core23 {
+
+namespace {
+
+int64_t align_offset(int64_t offset, int64_t alignment) {
+  if (alignment != 0) {
+    int64_t rem = offset % alignment;
+    if (rem != 0) {
+      offset += alignment - rem;
+    }
+  }
+  return offset;
+}
+
+}  // namespace
+
+MirroredBuffer::MirroredBuffer(const Device& device, std::unique_ptr<Allocator> allocator,
+                               std::shared_ptr<Buffer> source)
+    : Buffer(device, std::move(allocator)),
+      source_(source),
+      allocated_(false),
+      owns_memory_(false),
+      ptr_(nullptr),
+      size_(0LL) {}
+
+MirroredBuffer::~MirroredBuffer() {
+  if (owns_memory_) allocator()->deallocate(ptr_);
+}
+
+int64_t MirroredBuffer::plan(const std::unique_ptr<Allocator>& allocator,
+                             const ClientRequirements& client_requirements,
+                             ClientOffsets& client_offsets) const {
+  int64_t current_offset = 0;
+  bool is_first = true;
+  std::queue<BufferClient*> order = insertion_order_;
+  while (!order.empty()) {
+    auto client = order.front();
+    auto search = client_requirements.find(client);
+    if (search != client_requirements.end()) {
+      int64_t alignment = search->second.alignment;
+      if (is_first) {
+        alignment = allocator->get_valid_alignment(alignment);
+        is_first = false;
+      }
+      current_offset = align_offset(current_offset, alignment);
+      client_offsets[client] = current_offset;
+      current_offset += search->second.num_bytes;
+    }
+    order.pop();
+  }
+  return current_offset;
+}
+
+size_t MirroredBuffer::do_get_reserved_size(const std::unique_ptr<Allocator>& allocator,
+                                            const ClientRequirements& client_requirements) {
+  // The memory is the source's
+  return 0;
+}
+
+Buffer::ClientOffsets MirroredBuffer::do_allocate(const std::unique_ptr<Allocator>& allocator,
+                                                  const ClientRequirements& client_requirements) {
+  if (client_requirements.empty()) {
+    HCTR_OWN_THROW(
+        HugeCTR::Error_t::IllegalCall,
+        "The buffer doesn't have any subscriber at all. What is the point of allocate()?");
+  }
+
+  if (allocated_) {
+    HCTR_OWN_THROW(HugeCTR::Error_t::IllegalCall,
+                   "The MirroredBuffer doesn't allow the multiple allocation.");
+  }
+
+  ClientOffsets client_offsets;
+  size_ = plan(allocator, client_requirements, client_offsets);
+
+  if (source_->allocatable()) {
+    source_->allocate();
+  }
+  auto [source_ptr, source_size] = source_->decay();
+  if (source_ptr != nullptr && source_size == size_) {
+    ptr_ = source_ptr;
+  } else {
+    HCTR_LOG_S(WARNING, ROOT) << "The MirroredBuffer of " << size_
+                              << " bytes doesn't match its source of " << source_size
+                              << " bytes, so it allocates its own memory." << std::endl;
+    const auto& first_stream = client_requirements.begin()->second.stream;
+    ptr_ = allocator->allocate(size_, first_stream);
+    if (ptr_ == nullptr && size_) {
+      HCTR_OWN_THROW(HugeCTR::Error_t::OutOfMemory,
+                     "The MirroredBuffer failed to allocate the memory");
+    }
+    owns_memory_ = true;
+  }
+  allocated_ = true;
+  insertion_order_ = {};
+
+  return client_offsets;
+}
+
+void MirroredBuffer::post_subscribe(const BufferClient* client, BufferRequirements requirements) {
+  insertion_order_.push(const_cast<BufferClient*>(client));
+}
+
+}  // namespace core23
+
+}  // namespace HugeCTR
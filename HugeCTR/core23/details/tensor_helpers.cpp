@@ -50,7 +50,9 @@ BufferRequirements ConvertToBufferRequirements(const TensorParams& tensor_params
   BufferRequirements requirements = {
       .num_bytes = tensor_params.shape().size() * tensor_params.data_type().size(),
       .alignment = GetValidAlignment(tensor_params.alignment(), tensor_params.data_type()),
-      .stream = tensor_params.stream()};
+      .stream = tensor_params.stream(),
+      .first_use = tensor_params.first_use(),
+      .last_use = tensor_params.last_use()};
   return requirements;
 }
 
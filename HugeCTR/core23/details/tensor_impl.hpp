@@ -39,7 +39,7 @@ class TensorImpl : public BufferClient {
   TensorImpl(TensorParams params);
 
   TensorImpl(void* data, const Shape& shape, const DataType& data_type, const Device& device)
-      : params_(TensorParams().data_type(data_type).shape(shape).device(device)),
+      : params_(shape, data_type, TensorParams::kDefaultAlignment, device, {}, {}, CUDAStream()),
         bound_data_(data) {}
 
   void* data() const;
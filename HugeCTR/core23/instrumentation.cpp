@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <netinet/in.h>
+#include <nvToolsExt.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <core23/instrumentation.hpp>
+#include <core23/logger.hpp>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+
+namespace HugeCTR {
+
+namespace {
+
+// "name{label=\"x\"}" -> "name", the TYPE line of Prometheus takes the bare name
+std::string base_name(const std::string& name) { return name.substr(0, name.find('{')); }
+
+}  // namespace
+
+NvtxRange::NvtxRange(const char* name) { nvtxRangePushA(name); }
+
+NvtxRange::~NvtxRange() { nvtxRangePop(); }
+
+MetricsRegistry& MetricsRegistry::get() {
+  static MetricsRegistry registry;
+  return registry;
+}
+
+MetricsRegistry::~MetricsRegistry() { stop_server(); }
+
+MetricCounter& MetricsRegistry::counter(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& metric = counters_[name];
+  if (!metric) metric = std::make_unique<MetricCounter>();
+  return *metric;
+}
+
+MetricGauge& MetricsRegistry::gauge(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& metric = gauges_[name];
+  if (!metric) metric = std::make_unique<MetricGauge>();
+  return *metric;
+}
+
+std::map<std::string, double> MetricsRegistry::snapshot() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::map<std::string, double> values;
+  for (auto& [name, metric] : counters_) {
+    values[name] = static_cast<double>(metric->value());
+  }
+  for (auto& [name, metric] : gauges_) {
+    values[name] = metric->value();
+  }
+  return values;
+}
+
+std::string MetricsRegistry::to_prometheus() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::ostringstream os;
+  auto write = [&os](const auto& metrics, const char* type) {
+    std::string last_base_name;
+    for (auto& [name, metric] : metrics) {
+      std::string base = base_name(name);
+      if (base != last_base_name) {
+        os << "# TYPE hugectr_" << base << " " << type << "\n";
+        last_base_name = base;
+      }
+      os << "hugectr_" << name << " " << metric->value() << "\n";
+    }
+  };
+  write(counters_, "counter");
+  write(gauges_, "gauge");
+  return os.str();
+}
+
+void MetricsRegistry::reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& [name, metric] : counters_) {
+    metric->reset();
+  }
+  for (auto& [name, metric] : gauges_) {
+    metric->reset();
+  }
+}
+
+void MetricsRegistry::start_server(int port) {
+  HCTR_THROW_IF(serving_, Error_t::IllegalCall, "The metrics server is already running");
+
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  HCTR_THROW_IF(fd < 0, Error_t::UnspecificError, "Cannot create the metrics server socket: ",
+                std::strerror(errno));
+  int reuse = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(static_cast<uint16_t>(port));
+  if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, 8) < 0) {
+    std::string reason = std::strerror(errno);
+    close(fd);
+    HCTR_OWN_THROW(Error_t::WrongInput, "Cannot serve the metrics on port ", port, ": ", reason);
+  }
+
+  server_fd_ = fd;
+  serving_ = true;
+  server_thread_ = std::thread(&MetricsRegistry::serve, this);
+  HCTR_LOG_S(INFO, ROOT) << "Serving the metrics on port " << port << std::endl;
+}
+
+void MetricsRegistry::stop_server() {
+  if (!serving_) return;
+  serving_ = false;
+  if (server_thread_.joinable()) server_thread_.join();
+  close(server_fd_);
+  server_fd_ = -1;
+}
+
+void MetricsRegistry::serve() {
+  // Polls with a timeout so that stop_server() does not have to wake up a blocking accept().
+  pollfd pfd{server_fd_, POLLIN, 0};
+  while (serving_) {
+    if (poll(&pfd, 1, 200) <= 0 || !(pfd.revents & POLLIN)) continue;
+    int client = accept(server_fd_, nullptr, nullptr);
+    if (client < 0) continue;
+
+    // Every request is answered with the metrics, whatever its path.
+    char request[1024];
+    [[maybe_unused]] ssize_t request_size = recv(client, request, sizeof(request), 0);
+    std::string body = to_prometheus();
+    std::ostringstream response;
+    response << "HTTP/1.1 200 OK\r\n"
+             << "Content-Type: text/plain; version=0.0.4\r\n"
+             << "Content-Length: " << body.size() << "\r\n"
+             << "Connection: close\r\n\r\n"
+             << body;
+    std::string bytes = response.str();
+    for (size_t sent = 0; sent < bytes.size();) {
+      ssize_t n = send(client, bytes.data() + sent, bytes.size() - sent, MSG_NOSIGNAL);
+      if (n <= 0) break;
+      sent += static_cast<size_t>(n);
+    }
+    close(client);
+  }
+}
+
+}  // namespace HugeCTR
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+/*
+ * Instrumentation shared by the training and the inference code paths.
+ *
+ * 1. NVTX ranges, so that the stages show up by name on an Nsight Systems timeline:
+ *      HCTR_NVTX_RANGE("MPModelForward");
+ *    The range covers the rest of the enclosing scope. Inside a captured CUDA graph, the range only
+ *    marks the host side of the capture.
+ *
+ * 2. Process-wide counters and gauges, to be read without a profiler attached:
+ *      static auto& bytes = MetricsRegistry::get().counter("embedding_all2all_bytes");
+ *      bytes.add(num_bytes);
+ *    Looking a metric up takes a lock, updating it does not, so the hot paths look the metric up
+ *    once and keep the reference. A name may carry Prometheus labels, e.g.
+ *    "hps_embedding_cache_hit_rate{table=\"0\"}".
+ *    The metrics are read from Python with hugectr.get_metrics() or scraped by Prometheus from the
+ *    endpoint started with hugectr.start_metrics_server(port).
+ */
+
+#include <atomic>
+#include <core/macro.hpp>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace HugeCTR {
+
+class NvtxRange {
+ public:
+  HCTR_DISALLOW_COPY_AND_MOVE(NvtxRange);
+
+  explicit NvtxRange(const char* name);
+  explicit NvtxRange(const std::string& name) : NvtxRange(name.c_str()) {}
+  ~NvtxRange();
+};
+
+#define HCTR_NVTX_CONCAT_(a, b) a##b
+#define HCTR_NVTX_CONCAT(a, b) HCTR_NVTX_CONCAT_(a, b)
+#define HCTR_NVTX_RANGE(name) \
+  ::HugeCTR::NvtxRange HCTR_NVTX_CONCAT(hctr_nvtx_range_, __LINE__)(name)
+
+// Monotonic count, e.g. the bytes sent so far
+class MetricCounter {
+ public:
+  void add(uint64_t value) { value_.fetch_add(value, std::memory_order_relaxed); }
+  uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+  void reset() { value_.store(0, std::memory_order_relaxed); }
+
+ private:
+  std::atomic<uint64_t> value_{0};
+};
+
+// Last observed value, e.g. a hit rate or a queue depth
+class MetricGauge {
+ public:
+  void set(double value) { value_.store(value, std::memory_order_relaxed); }
+  double value() const { return value_.load(std::memory_order_relaxed); }
+  void reset() { value_.store(0., std::memory_order_relaxed); }
+
+ private:
+  std::atomic<double> value_{0.};
+};
+
+class MetricsRegistry {
+ public:
+  HCTR_DISALLOW_COPY_AND_MOVE(MetricsRegistry);
+
+  static MetricsRegistry& get();
+
+  ~MetricsRegistry();
+
+  // The returned references stay valid for the lifetime of the process
+  MetricCounter& counter(const std::string& name);
+  MetricGauge& gauge(const std::string& name);
+
+  std::map<std::string, double> snapshot() const;
+
+  // Prometheus text exposition format, every metric name is prefixed with "hugectr_"
+  std::string to_prometheus() const;
+
+  void reset();
+
+  /**
+   * Serves to_prometheus() over HTTP on the given port from a background thread.
+   * Throws if the port cannot be bound or if a server is already running.
+   */
+  void start_server(int port);
+  void stop_server();
+
+ private:
+  MetricsRegistry() = default;
+
+  void serve();
+
+  mutable std::mutex mutex_;
+  std::map<std::string, std::unique_ptr<MetricCounter>> counters_;
+  std::map<std::string, std::unique_ptr<MetricGauge>> gauges_;
+
+  int server_fd_ = -1;
+  std::atomic<bool> serving_{false};
+  std::thread server_thread_;
+};
+
+}  // namespace HugeCTR
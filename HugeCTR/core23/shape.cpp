@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <core23/shape.hpp>
 #include <cstdint>
 #include <vector>
@@ -22,9 +23,21 @@ namespace HugeCTR {
 
 namespace core23 {
 
+void Shape::resize(const int64_t dims) {
+  dims_ = dims < 0 ? 0 : dims;
+  if (dims_ > kInlineDims) {
+    heap_.assign(dims_, 0);
+  }
+}
+
+void Shape::assign(const int64_t *const sizes, const size_t dims) {
+  resize(static_cast<int64_t>(dims));
+  std::copy(sizes, sizes + dims, mutable_data());
+}
+
 bool Shape::operator==(const Shape &other) const {
   return dims() == other.dims() && [&] {
-    for (size_t i = 0; i < dims(); ++i) {
+    for (int64_t i = 0; i < dims(); ++i) {
       if (size(i) != other.size(i)) {
         return false;
       }
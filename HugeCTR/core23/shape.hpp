@@ -17,6 +17,8 @@
 #pragma once
 
 #include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -24,18 +26,25 @@ namespace HugeCTR {
 
 namespace core23 {
 
-class Shape : private std::vector<int64_t> {
+// Shapes of up to kInlineDims dimensions are stored in place, so that creating and copying the
+// shape of a Tensor, a view or a TensorContainer does not allocate.
+class Shape {
  public:
+  static constexpr int64_t kInlineDims = 6;
+
   Shape() {}
-  Shape(int64_t dims) : std::vector<int64_t>(dims, 0) {}
-  Shape(std::initializer_list<int64_t> l) : std::vector<int64_t>(l) {}
-  Shape(const std::vector<int64_t> &l) : std::vector<int64_t>(l) {}
-  int64_t dims() const { return std::vector<int64_t>::size(); }
-  int64_t size(int64_t dim) const { return empty() ? 0 : at(dim); }
+  Shape(int64_t dims) { resize(dims); }
+  Shape(std::initializer_list<int64_t> l) { assign(l.begin(), l.size()); }
+  Shape(const std::vector<int64_t> &l) { assign(l.data(), l.size()); }
+  // Copied rather than moved, so that a moved-from shape stays valid.
+  Shape(const Shape &) = default;
+  Shape &operator=(const Shape &) = default;
+  int64_t dims() const { return dims_; }
+  int64_t size(int64_t dim) const { return dims_ == 0 ? 0 : at(dim); }
   int64_t &operator[](const int64_t dim) { return at(dim); }
   const int64_t &operator[](const int64_t dim) const { return at(dim); }
   int64_t size() const {
-    if (empty()) {
+    if (dims_ == 0) {
       return 0;
     }
 
@@ -46,12 +55,34 @@ class Shape : private std::vector<int64_t> {
     return sum;
   }
   void set(int64_t dim, int64_t size) { at(dim) = size; }
-  const int64_t *data() const { return std::vector<int64_t>::data(); }
+  const int64_t *data() const { return dims_ > kInlineDims ? heap_.data() : inline_; }
 
   bool operator==(const Shape &other) const;
   bool operator!=(const Shape &other) const { return !(*this == other); }
 
   std::string str() const;
+
+ private:
+  int64_t *mutable_data() { return dims_ > kInlineDims ? heap_.data() : inline_; }
+  int64_t &at(int64_t dim) {
+    check_dim(dim);
+    return mutable_data()[dim];
+  }
+  const int64_t &at(int64_t dim) const {
+    check_dim(dim);
+    return data()[dim];
+  }
+  void check_dim(int64_t dim) const {
+    if (dim < 0 || dim >= dims_) {
+      throw std::out_of_range("Shape: dimension " + std::to_string(dim) + " out of range");
+    }
+  }
+  void resize(int64_t dims);
+  void assign(const int64_t *sizes, size_t dims);
+
+  int64_t dims_ = 0;
+  int64_t inline_[kInlineDims] = {};
+  std::vector<int64_t> heap_;  // Only used beyond kInlineDims
 };
 
 std::ostream &operator<<(std::ostream &os, const Shape &s);
@@ -120,6 +120,7 @@ class TensorContainer : public TensorView<Tensor, ContainerDims> {
 
     if (viewed_ == false) {
       std::vector<TargetTensorView> host_tensor_views;
+      host_tensor_views.reserve(tensors_.size());
       std::transform(tensors_.begin(), tensors_.end(), std::back_inserter(host_tensor_views),
                      [](const Tensor& tensor) { return tensor.view<BuiltInType, TensorDims>(); });
       int64_t size = sizeof(TargetTensorView) * shape_.size();
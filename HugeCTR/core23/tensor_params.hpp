@@ -32,6 +32,8 @@ namespace core23 {
 
 class TensorParams final {
  public:
+  static constexpr int64_t kDefaultAlignment = 256;
+
   TensorParams(const Shape& shape, const DataType& data_type, int64_t alignment,
                const Device& device, const AllocatorParams allocator_params,
                const BufferParams& buffer_params, CUDAStream stream)
@@ -43,7 +45,8 @@ class TensorParams final {
         buffer_params_(buffer_params),
         stream_(stream) {}
 
-  TensorParams() : TensorParams(Shape(), DataType(), 256, Device(), {}, {}, CUDAStream()) {}
+  TensorParams()
+      : TensorParams(Shape(), DataType(), kDefaultAlignment, Device(), {}, {}, CUDAStream()) {}
   TensorParams(const Shape& shape) : TensorParams() { this->set_shape(shape); }
 
   TensorParams shape(const Shape& shape) const noexcept {
@@ -92,6 +95,14 @@ class TensorParams final {
     return p;
   }
 
+  // The steps at which the tensor is first and last used, see BufferParams::aliased
+  TensorParams live_range(int64_t first_use, int64_t last_use) const noexcept {
+    TensorParams p = *this;
+    p.first_use_ = first_use;
+    p.last_use_ = last_use;
+    return p;
+  }
+
   const Shape& shape() const { return shape_; };
 
   DataType data_type() const { return data_type_; }
@@ -101,6 +112,8 @@ class TensorParams final {
   const BufferParams& buffer_params() const { return buffer_params_; }
   const BufferChannel& buffer_channel() const { return buffer_params_.channel; }
   CUDAStream stream() const { return stream_; }
+  int64_t first_use() const { return first_use_; }
+  int64_t last_use() const { return last_use_; }
 
  private:
   void set_shape(const Shape& shape) { shape_ = shape; }
@@ -113,6 +126,8 @@ class TensorParams final {
   AllocatorParams allocator_params_;
   BufferParams buffer_params_;
   CUDAStream stream_;
+  int64_t first_use_ = 0;
+  int64_t last_use_ = -1;
 };
 
 }  // namespace core23
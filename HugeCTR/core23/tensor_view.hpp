@@ -89,6 +89,13 @@ class TensorViewBase {
   HCTR_INLINE HCTR_HOST_DEVICE int64_t stride(int64_t dim) const { return strides_[dim]; }
   HCTR_INLINE HCTR_HOST_DEVICE int64_t offset(int64_t dim) const { return offsets_[dim]; }
   HCTR_INLINE HCTR_HOST_DEVICE BuiltInType* data() const { return data_; }
+  HCTR_INLINE HCTR_HOST_DEVICE int64_t num_elements() const {
+    int64_t num_elements = 1;
+    for (int64_t d = 0; d < Dims; d++) {
+      num_elements *= shape_[d];
+    }
+    return num_elements;
+  }
 
  protected:
   BuiltInType* data_;
@@ -323,7 +323,7 @@ void weighted_sparse_forward_per_gpu(
   core23::DataType key_type = key_all_gather_recv_buffer.data_type();
   WeightedModelIndexCalculation model_index_calculation_ = WeightedModelIndexCalculation(
       core, meta.num_local_lookup_, meta.num_local_hotness_, meta.hotness_sum_, batch_size,
-      key_type, bucket_range.data_type());
+      key_type, bucket_range.data_type(), reorder_sp_weight.data_type());
 
   core23::Tensor model_key, model_offsets, model_sp_weight;
   size_t num_model_key_;
@@ -746,7 +746,7 @@ void weighted_sparse_backward_per_gpu(
       WeightedModelBackwardIndexCalculation(core, num_gpus, meta.num_local_lookup_,
                                             meta.h_local_hotness_list_, meta.h_local_table_id_list_,
                                             meta.h_local_ev_size_list_, batch_size,
-                                            model_key.data_type());
+                                            model_key.data_type(), model_sp_weight.data_type());
 
   core23::Tensor continous_unique_key, wgrad_idx_offset, sorted_bucket_id_list,
       sorted_bucket_id_offset, d_table_id_list, num_unique_key_per_table_offset,
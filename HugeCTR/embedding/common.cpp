@@ -102,6 +102,23 @@ std::ostream &operator<<(std::ostream &os, const CommunicationStrategy &p) {
   return os;
 }
 
+std::ostream &operator<<(std::ostream &os, const All2AllCompression &p) {
+  switch (p) {
+    case All2AllCompression::None:
+      os << "None";
+      break;
+    case All2AllCompression::FP16:
+      os << "FP16";
+      break;
+    case All2AllCompression::FP8:
+      os << "FP8";
+      break;
+    default:
+      HCTR_OWN_THROW(HugeCTR::Error_t::NotInitialized, "All2AllCompression is not initialized");
+  }
+  return os;
+}
+
 std::ostream &operator<<(std::ostream &os, const SortStrategy &p) {
   switch (p) {
     case SortStrategy::Radix:
@@ -138,6 +155,9 @@ std::ostream &operator<<(std::ostream &os, const AllreduceStrategy &p) {
     case AllreduceStrategy::GroupDense:
       os << "GroupDense";
       break;
+    case AllreduceStrategy::Sparse:
+      os << "Sparse";
+      break;
     default:
       HCTR_OWN_THROW(HugeCTR::Error_t::NotInitialized, "AllreduceStrategy is not initialized");
   }
@@ -213,6 +233,14 @@ void EmbeddingOutputAttr::init(std::shared_ptr<CoreResourceManager> core,
   }
   this->is_aligned = is_aligned;
 
+  bool has_concat_combiner =
+      std::any_of(h_id_to_combiner.begin(), h_id_to_combiner.end(),
+                  [](char c) { return c == static_cast<char>(Combiner::Concat); });
+  this->uniform_ev_size = (this->is_ragged && !has_concat_combiner) ? this->max_ev_size : 0;
+  this->has_average_combiner =
+      std::any_of(h_id_to_combiner.begin(), h_id_to_combiner.end(),
+                  [](char c) { return c == static_cast<char>(Combiner::Average); });
+
   this->type = ebc_param.emb_type;
 }
 
@@ -394,6 +422,23 @@ std::vector<int> get_allreduce_buffer_num_keys(
   return vocabulary_size_list;
 }
 
+// (table id, ev size) of the hybrid tables in the group. Every replicated hot row can get a
+// gradient, and so can the owned row of the key, see HotRowsAllreduce.
+static std::vector<std::pair<int, int>> get_wgrad_hybrid_tables(
+    const EmbeddingCollectionParam &ebc_param, size_t grouped_id, int gpu_id) {
+  std::vector<std::pair<int, int>> hybrid_tables;
+  for (int lookup_id = 0; lookup_id < ebc_param.num_lookup; ++lookup_id) {
+    if (!ebc_param.has_table_shard(gpu_id, grouped_id, lookup_id)) continue;
+    int table_id = ebc_param.lookup_params[lookup_id].table_id;
+    if (ebc_param.get_table_num_hot_keys(table_id) == 0) continue;
+    std::pair<int, int> table{table_id, ebc_param.lookup_params[lookup_id].ev_size};
+    if (std::find(hybrid_tables.begin(), hybrid_tables.end(), table) == hybrid_tables.end()) {
+      hybrid_tables.push_back(table);
+    }
+  }
+  return hybrid_tables;
+}
+
 WgradInitializer &WgradInitializer::init(Wgrad &other) {
   this->wgrad = &other;
   wgrad->attr = wgrad_attr;
@@ -412,18 +457,22 @@ WgradInitializer &WgradInitializer::init_indices() {
   auto key_type = ebc_param.key_type;
   int batch_size = ebc_param.universal_batch_size;
 
+  int64_t max_num_wgrad_keys = static_cast<int64_t>(batch_size) * max_num_keys;
+  for (auto &[table_id, ev_size] : get_wgrad_hybrid_tables(ebc_param, grouped_id, gpu_id)) {
+    max_num_wgrad_keys += 2 * ebc_param.get_table_num_hot_keys(table_id);
+  }
+
   HugeCTR::CudaDeviceContext context(core->get_device_id());
 
   core23::Device device(core23::DeviceType::GPU, core->get_device_id());
   core23::TensorParams params = core23::TensorParams().device(device);
   wgrad->attr.type = ebc_param.wgrad_type_;
-  wgrad->unique_keys =
-      core23::Tensor(params.shape({batch_size * max_num_keys}).data_type(key_type));
+  wgrad->unique_keys = core23::Tensor(params.shape({max_num_wgrad_keys}).data_type(key_type));
   wgrad->num_unique_keys = core23::Tensor(params.shape({1}).data_type(core23::ScalarType::UInt64));
-  wgrad->table_ids = core23::Tensor(
-      params.shape({batch_size * max_num_keys}).data_type(core23::ScalarType::Int32));
-  wgrad->ev_start_indices = core23::Tensor(
-      params.shape({batch_size * max_num_keys + 1}).data_type(core23::ScalarType::UInt32));
+  wgrad->table_ids =
+      core23::Tensor(params.shape({max_num_wgrad_keys}).data_type(core23::ScalarType::Int32));
+  wgrad->ev_start_indices =
+      core23::Tensor(params.shape({max_num_wgrad_keys + 1}).data_type(core23::ScalarType::UInt32));
   return *this;
 }
 
@@ -442,6 +491,9 @@ WgradInitializer &WgradInitializer::init_data() {
     max_buffer_size += local_max_hotness_list[i] * local_ev_size_list[i];
   }
   max_buffer_size *= batch_size;
+  for (auto &[table_id, ev_size] : get_wgrad_hybrid_tables(ebc_param, grouped_id, gpu_id)) {
+    max_buffer_size += 2 * ebc_param.get_table_num_hot_keys(table_id) * ev_size;
+  }
   core23::Device device(core23::DeviceType::GPU, core->get_device_id());
   core23::TensorParams params = core23::TensorParams().device(device);
   wgrad->data = core23::Tensor(params.shape({max_buffer_size}).data_type(wgrad->attr.type));
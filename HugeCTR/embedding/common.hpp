@@ -97,6 +97,9 @@ struct DataDistributionInput {
   int num_lookup_;
   core23::DataType key_type;
   core23::DataType offset_type;
+  // Global batch size when every sample has max_hotness keys in every lookup, so the bucket ranges
+  // are implicit. 0 with variable hotness.
+  int fixed_hotness_batch_size_ = 0;
 
   DataDistributionInput() = default;
 
@@ -134,11 +137,13 @@ enum class EmbeddingLayout : int8_t { FeatureMajor, BatchMajor };
 std::ostream &operator<<(std::ostream &os, const EmbeddingLayout &p);
 enum class CommunicationStrategy : int8_t { Uniform, Hierarchical };
 std::ostream &operator<<(std::ostream &os, const CommunicationStrategy &p);
+enum class All2AllCompression : int8_t { None, FP16, FP8 };
+std::ostream &operator<<(std::ostream &os, const All2AllCompression &p);
 enum class SortStrategy : int8_t { Radix, Segmented };
 std::ostream &operator<<(std::ostream &os, const SortStrategy &p);
 enum class KeysPreprocessStrategy : int8_t { None, AddOffset };
 std::ostream &operator<<(std::ostream &os, const KeysPreprocessStrategy &p);
-enum class AllreduceStrategy : int8_t { Dense, GroupDense };
+enum class AllreduceStrategy : int8_t { Dense, GroupDense, Sparse };
 std::ostream &operator<<(std::ostream &os, const AllreduceStrategy &p);
 enum class EmbeddingType : int8_t { Sparse, Dense };
 
@@ -206,6 +211,30 @@ struct EmbeddingCollectionParam {
   AllreduceStrategy allreduce_strategy_;
   CommunicationStrategy comm_strategy_;
 
+  // Number of sample chunks the model parallel all-to-all is split into (1 = no overlap).
+  int num_all2all_chunks_ = 1;
+  // Compression of the inter-node all-to-all of the hierarchical model parallel embedding.
+  All2AllCompression all2all_compression_ = All2AllCompression::None;
+  // Number of micro-batches whose sparse wgrad is merged before one table update (1 = none).
+  int num_gradient_accumulation_steps_ = 1;
+  // Sparse model parallel groups send every GPU its distinct keys plus reverse indices, instead of
+  // all keys, whenever that is fewer bytes.
+  bool unique_keys_before_all2all_ = false;
+  // Per table, num_shards + 1 row offsets of a range sharded model parallel table. Empty = rows
+  // are assigned to the shards round robin.
+  std::vector<std::vector<int64_t>> table_shard_row_offsets_;
+  // Per table, the sorted keys whose rows are replicated on every GPU (hybrid placement). Empty =
+  // the table is purely model parallel.
+  std::vector<std::vector<int64_t>> table_hot_keys_;
+  // The sizes that depend on the keys of a batch stay on the device: kernels are launched for the
+  // maximum number of keys and read the actual counts from device memory, so forward and backward
+  // never synchronize with the host and can be captured in a CUDA graph. Data parallel sparse
+  // groups with the segmented sort only.
+  bool sync_free_ = false;
+  // The sparse wgrad is reduced in the order of the sorted keys, without floating point atomics, so
+  // that the training is bitwise reproducible.
+  bool deterministic_ = false;
+
   EmbeddingCollectionParam(
       int num_table, int num_lookup, const std::vector<LookupParam> &lookup_params,
       const std::vector<std::vector<int>> &shard_matrix,
@@ -304,6 +333,20 @@ struct EmbeddingCollectionParam {
     *shard_id = std::distance(shard_gpus.begin(), find_shard_id_iter);
     *num_shard = static_cast<int>(shard_gpus.size());
   }
+
+  // nullptr if the rows of the table are assigned to its shards round robin.
+  const int64_t *get_table_shard_row_offsets(int table_id) const {
+    if (table_id >= static_cast<int>(table_shard_row_offsets_.size()) ||
+        table_shard_row_offsets_[table_id].empty()) {
+      return nullptr;
+    }
+    return table_shard_row_offsets_[table_id].data();
+  }
+
+  int64_t get_table_num_hot_keys(int table_id) const {
+    if (table_id >= static_cast<int>(table_hot_keys_.size())) return 0;
+    return static_cast<int64_t>(table_hot_keys_[table_id].size());
+  }
 };
 
 struct EmbeddingInput {
@@ -350,6 +393,10 @@ struct EmbeddingOutputAttr {
   int max_ev_size;
   bool is_ragged;
   bool is_aligned;
+  // Select the pooling kernel at construction: the ev size of all lookups if they share one and
+  // none of them concatenates (0 otherwise), and whether any lookup averages.
+  int uniform_ev_size;
+  bool has_average_combiner;
   core23::DataType type;
 
   void init(std::shared_ptr<CoreResourceManager> core, const EmbeddingCollectionParam &ebc_param);
@@ -61,6 +61,24 @@ __global__ void partition_and_unique_kernel(
   }
 }
 
+// One thread per key instead of one per sample, so long sequences do not serialize
+template <typename KeyType, typename BucketRangeType, typename HashTable>
+__global__ void partition_and_unique_fixed_hotness_kernel(
+    const KeyType **keys, const int *lookup_ids, const int *local_hotness_offsets,
+    int num_local_lookup, int num_valid_samples, uint64_t num_keys, HashTable hash_table,
+    CompressedDataView<KeyType, BucketRangeType> compressed_data) {
+  CUDA_1D_KERNEL_LOOP_T(uint64_t, i, num_keys) {
+    int local_lookup_id = bs_upper_bound_sub_one(local_hotness_offsets, num_local_lookup + 1,
+                                                 static_cast<int>(i / num_valid_samples));
+    int lookup_id = lookup_ids[local_lookup_id];
+    uint64_t id_in_lookup =
+        i - static_cast<uint64_t>(num_valid_samples) * local_hotness_offsets[local_lookup_id];
+    const auto key = keys[lookup_id][id_in_lookup];
+    uint32_t r_idx_plus_one = hash_table.find({key, lookup_id}, compressed_data.partitioned_data);
+    compressed_data.reverse_idx[i] = r_idx_plus_one - 1;
+  }
+}
+
 template <typename KeyType, typename BucketRangeType, typename HashTable>
 __global__ void partition_and_unique_kernel(
     const KeyType *keys, const int *feature_ids, const int *lookup_id_to_local_table_id,
@@ -77,6 +95,16 @@ __global__ void partition_and_unique_kernel(
   }
 }
 
+template <typename TableEntry>
+__global__ void clear_inserted_slots_kernel(TableEntry *table, const uint64_t *inserted_slots,
+                                            const uint64_t *num_inserted_slots) {
+  CUDA_1D_KERNEL_LOOP_T(uint64_t, i, *num_inserted_slots) {
+    TableEntry &entry = table[inserted_slots[i]];
+    entry.key = 0;
+    entry.value.value = 0;
+  }
+}
+
 template <typename BucketRangeType>
 __global__ void count_num_bucket_ids_kernel(const BucketRangeType **__restrict__ bucket_range,
                                             int num_sample_per_feature, const int *lookup_ids,
@@ -127,6 +155,26 @@ __global__ void generate_sequence_kernel(const BucketRangeType **bucket_range,
   }
 }
 
+// With fixed hotness the keys of a lookup are num_valid_samples x hotness, and the lookups follow
+// each other, so the position of a key gives its lookup, sample and slot without any bucket range.
+template <typename BucketRangeType>
+__global__ void generate_fixed_hotness_sequence_kernel(const int *local_hotness_offsets,
+                                                       int num_local_lookup, int num_valid_samples,
+                                                       int num_sample_per_lookup,
+                                                       BucketRangeType *bucket_ids,
+                                                       uint64_t num_keys) {
+  CUDA_1D_KERNEL_LOOP_T(uint64_t, i, num_keys) {
+    int local_lookup_id = bs_upper_bound_sub_one(local_hotness_offsets, num_local_lookup + 1,
+                                                 static_cast<int>(i / num_valid_samples));
+    int hotness_start = local_hotness_offsets[local_lookup_id];
+    int hotness = local_hotness_offsets[local_lookup_id + 1] - hotness_start;
+    uint64_t id_in_lookup = i - static_cast<uint64_t>(num_valid_samples) * hotness_start;
+    uint64_t sample_id = id_in_lookup / hotness;
+    uint64_t hotness_id = id_in_lookup % hotness;
+    bucket_ids[i] = sample_id + (hotness_start + hotness_id) * num_sample_per_lookup;
+  }
+}
+
 template <typename BucketRangeType>
 __global__ void compress_reverse_idx_range_kernel(const BucketRangeType *num_key_per_partition,
                                                   int64_t num_partition,
@@ -204,15 +252,22 @@ PartitionedData::PartitionedData(std::shared_ptr<core::CoreResourceManager> core
       params.shape({static_cast<int64_t>(num_partition)}).data_type(bucket_range_type));
 }
 
-ShardPartitioner::ShardPartitioner(std::shared_ptr<core::CoreResourceManager> core,
-                                   const std::vector<embedding::LookupParam> &lookup_params,
-                                   const std::vector<std::vector<int>> &shard_matrix,
-                                   const std::vector<int> &lookup_ids) {
+ShardPartitioner::ShardPartitioner(
+    std::shared_ptr<core::CoreResourceManager> core,
+    const std::vector<embedding::LookupParam> &lookup_params,
+    const std::vector<std::vector<int>> &shard_matrix, const std::vector<int> &lookup_ids,
+    const std::vector<std::vector<int64_t>> &table_shard_row_offsets,
+    const std::vector<std::vector<int64_t>> &table_hot_keys) {
   int num_global_gpu_count = core->get_global_gpu_count();
   int num_lookup = static_cast<int>(lookup_params.size());
 
   std::vector<int> h_gpu_ids;
   std::vector<int> h_num_shard_range(num_lookup + 1, 0);
+  // Never empty, so that the view always holds a valid pointer.
+  std::vector<int64_t> h_row_offsets{0};
+  std::vector<int> h_row_offsets_start(num_lookup, -1);
+  std::vector<int64_t> h_hot_keys{0};
+  std::vector<int> h_hot_keys_range(num_lookup + 1, 0);
   for (int lookup_id : lookup_ids) {
     int table_id = lookup_params[lookup_id].table_id;
     int num_shard = 0;
@@ -222,9 +277,29 @@ ShardPartitioner::ShardPartitioner(std::shared_ptr<core::CoreResourceManager> co
       num_shard += 1;
     }
     h_num_shard_range[lookup_id + 1] = num_shard;
+    if (table_id < static_cast<int>(table_shard_row_offsets.size()) &&
+        !table_shard_row_offsets[table_id].empty()) {
+      h_row_offsets_start[lookup_id] = static_cast<int>(h_row_offsets.size());
+      h_row_offsets.insert(h_row_offsets.end(), table_shard_row_offsets[table_id].begin(),
+                           table_shard_row_offsets[table_id].end());
+    }
+    if (table_id < static_cast<int>(table_hot_keys.size())) {
+      h_hot_keys_range[lookup_id + 1] = static_cast<int>(table_hot_keys[table_id].size());
+    }
   }
   std::inclusive_scan(h_num_shard_range.begin(), h_num_shard_range.end(),
                       h_num_shard_range.begin());
+  std::inclusive_scan(h_hot_keys_range.begin(), h_hot_keys_range.end(), h_hot_keys_range.begin());
+  // The first element is a placeholder, so that the range of lookup i starts after it.
+  for (int lookup_id = 0; lookup_id < num_lookup; ++lookup_id) {
+    int table_id = lookup_params[lookup_id].table_id;
+    if (h_hot_keys_range[lookup_id + 1] == h_hot_keys_range[lookup_id]) continue;
+    h_hot_keys.insert(h_hot_keys.end(), table_hot_keys[table_id].begin(),
+                      table_hot_keys[table_id].end());
+  }
+  std::transform(h_hot_keys_range.begin(), h_hot_keys_range.end(), h_hot_keys_range.begin(),
+                 [](int offset) { return offset + 1; });
+  this->self_gpu_id = core->get_global_gpu_id();
 
   core23::Device device(core23::DeviceType::GPU, core->get_device_id());
   core23::TensorParams params = core23::TensorParams().device(device);
@@ -234,8 +309,24 @@ ShardPartitioner::ShardPartitioner(std::shared_ptr<core::CoreResourceManager> co
       core23::Tensor(params.shape({static_cast<int64_t>(h_num_shard_range.size())})
                          .data_type(core23::ScalarType::Int32));
 
+  this->row_offsets = core23::Tensor(params.shape({static_cast<int64_t>(h_row_offsets.size())})
+                                         .data_type(core23::ScalarType::Int64));
+  this->row_offsets_start =
+      core23::Tensor(params.shape({static_cast<int64_t>(h_row_offsets_start.size())})
+                         .data_type(core23::ScalarType::Int32));
+
   core23::copy_sync(this->gpu_ids, h_gpu_ids);
   core23::copy_sync(this->num_shard_range, h_num_shard_range);
+  core23::copy_sync(this->row_offsets, h_row_offsets);
+  core23::copy_sync(this->row_offsets_start, h_row_offsets_start);
+
+  this->hot_keys = core23::Tensor(params.shape({static_cast<int64_t>(h_hot_keys.size())})
+                                      .data_type(core23::ScalarType::Int64));
+  this->hot_keys_range =
+      core23::Tensor(params.shape({static_cast<int64_t>(h_hot_keys_range.size())})
+                         .data_type(core23::ScalarType::Int32));
+  core23::copy_sync(this->hot_keys, h_hot_keys);
+  core23::copy_sync(this->hot_keys_range, h_hot_keys_range);
 }
 
 TablePartitioner::TablePartitioner(std::shared_ptr<core::CoreResourceManager> core, int num_lookup,
@@ -298,6 +389,15 @@ PartitionAndUniqueOperator::PartitionAndUniqueOperator(
 
   core23::copy_sync(d_lookup_ids_, grouped_lookup_param.lookup_ids);
 
+  std::vector<int> local_hotness_offsets(1, 0);
+  for (int lookup_id : grouped_lookup_param.lookup_ids) {
+    local_hotness_offsets.push_back(local_hotness_offsets.back() +
+                                    ebc_param.lookup_params[lookup_id].max_hotness);
+  }
+  d_local_hotness_offsets_ = core23::Tensor(
+      params.shape({num_local_lookup_ + 1}).data_type(core23::ScalarType::Int32));
+  core23::copy_sync(d_local_hotness_offsets_, local_hotness_offsets);
+
   embedding::WgradAttr wgrad_attr;
   wgrad_attr.init(core, ebc_param, group_id);
 
@@ -321,12 +421,40 @@ void PartitionAndUniqueOperator::init_hash_table_for_unique(
   // TODO: too large
   this->table_capacity_ = std::max(batch_size_ * num_local_features_,
                                    batch_size_per_gpu_ * num_features_);  // worst case
+  int load_factor = 2;
+  this->hash_table_capacity_ = load_factor * this->table_capacity_;
   DISPATCH_INTEGRAL_FUNCTION_CORE23(key_type.type(), KeyType, [&] {
-    int load_factor = 2;
-    size_t table_size = load_factor * this->table_capacity_ * sizeof(TableEntry<KeyType>);
+    size_t table_size = this->hash_table_capacity_ * sizeof(TableEntry<KeyType>);
     this->hash_table_storage_ = core23::Tensor(
         params.shape({static_cast<int64_t>(table_size)}).data_type(core23::ScalarType::Char));
   });
+  this->inserted_slots_ = core23::Tensor(params.shape({static_cast<int64_t>(this->table_capacity_)})
+                                             .data_type(core23::ScalarType::UInt64));
+  this->num_inserted_slots_ =
+      core23::Tensor(params.shape({1}).data_type(core23::ScalarType::UInt64));
+
+  // The only full clear, afterwards the table is kept empty by clear_hash_table
+  HCTR_LIB_THROW(cudaMemset(hash_table_storage_.data(), 0, hash_table_storage_.num_bytes()));
+  HCTR_LIB_THROW(cudaMemset(num_inserted_slots_.data(), 0, num_inserted_slots_.num_bytes()));
+}
+
+template <typename KeyType>
+void PartitionAndUniqueOperator::clear_hash_table(cudaStream_t stream) {
+  auto &kernel_param = core_->get_kernel_param();
+  int block_size = kernel_param.max_thread_per_block;
+  int grid_size = kernel_param.num_sms * (kernel_param.max_thread_per_sm / block_size);
+
+  clear_inserted_slots_kernel<<<grid_size, block_size, 0, stream>>>(
+      (TableEntry<KeyType> *)hash_table_storage_.data(), inserted_slots_.data<uint64_t>(),
+      num_inserted_slots_.data<uint64_t>());
+  HCTR_LIB_THROW(cudaMemsetAsync(num_inserted_slots_.data(), 0, num_inserted_slots_.num_bytes(),
+                                 stream));
+}
+
+int PartitionAndUniqueOperator::num_valid_samples(const DataDistributionInput &input) const {
+  int remaining =
+      input.fixed_hotness_batch_size_ - core_->get_global_gpu_id() * batch_size_per_gpu_;
+  return std::max(std::min(remaining, batch_size_per_gpu_), 0);
 }
 
 void PartitionAndUniqueOperator::fill_continuous_bucket_ids(const DataDistributionInput &input,
@@ -334,11 +462,27 @@ void PartitionAndUniqueOperator::fill_continuous_bucket_ids(const DataDistributi
                                                             core23::Tensor &h_num_bucket_ids,
                                                             cudaStream_t stream) {
   HCTR_CHECK(h_num_bucket_ids.data_type() == core23::ScalarType::UInt64);
+  auto &kernel_param = core_->get_kernel_param();
+
+  if (input.fixed_hotness_batch_size_ > 0) {
+    // The number of keys is known on the host, no need to count them and wait
+    int num_valid = num_valid_samples(input);
+    uint64_t num_keys = static_cast<uint64_t>(num_valid) * num_local_features_;
+    *h_num_bucket_ids.data<uint64_t>() = num_keys;
+    if (num_keys == 0) return;
+
+    int block_size = kernel_param.max_thread_per_block;
+    int grid_size = ceildiv(num_keys, (uint64_t)block_size);
+    DISPATCH_INTEGRAL_FUNCTION_CORE23(bucket_ids.data_type().type(), BucketRangeType, [&] {
+      generate_fixed_hotness_sequence_kernel<<<grid_size, block_size, 0, stream>>>(
+          d_local_hotness_offsets_.data<int>(), num_local_lookup_, num_valid, batch_size_per_gpu_,
+          bucket_ids.data<BucketRangeType>(), num_keys);
+    });
+    return;
+  }
   HCTR_LIB_THROW(
       cudaMemsetAsync(h_num_bucket_ids.data<uint64_t>(), 0, h_num_bucket_ids.num_bytes(), stream));
 
-  auto &kernel_param = core_->get_kernel_param();
-
   DISPATCH_INTEGRAL_FUNCTION_CORE23(bucket_ids.data_type().type(), BucketRangeType, [&] {
     auto bucket_range_ptrs = input.get_dp_bucket_range_pointer_ptr<BucketRangeType>();
     int block_size = std::min((int)d_lookup_ids_.num_elements(), kernel_param.max_thread_per_block);
@@ -379,9 +523,12 @@ void PartitionAndUniqueOperator::partition_and_unique_on_dp_input(
       auto dp_keys_ptrs = input.get_dp_keys_pointer_ptr<KeyType>();
       auto dp_bucket_range_ptrs = input.get_dp_bucket_range_pointer_ptr<BucketRangeType>();
 
-      cal_range_on_selected_lookup_ids_kernel<<<1, 1, 0, stream>>>(
-          dp_bucket_range_ptrs, d_lookup_ids_.data<int>(), num_local_lookup_, batch_size_per_gpu_,
-          range_on_lookup_ids.data<BucketRangeType>());
+      const bool fixed_hotness = input.fixed_hotness_batch_size_ > 0;
+      if (!fixed_hotness) {
+        cal_range_on_selected_lookup_ids_kernel<<<1, 1, 0, stream>>>(
+            dp_bucket_range_ptrs, d_lookup_ids_.data<int>(), num_local_lookup_,
+            batch_size_per_gpu_, range_on_lookup_ids.data<BucketRangeType>());
+      }
 
       HCTR_LIB_THROW(cudaMemsetAsync(
           compressed_data.partitioned_data.d_num_key_per_partition.data(), 0,
@@ -398,14 +545,25 @@ void PartitionAndUniqueOperator::partition_and_unique_on_dp_input(
       int block_size = 512;
       int grid_size = kernel_param.num_sms * (kernel_param.max_thread_per_sm / block_size);
 
-      HCTR_LIB_THROW(
-          cudaMemsetAsync(hash_table_storage_.data(), 0, hash_table_storage_.num_bytes(), stream));
       UniqueTableView<KeyType, BucketRangeType, partitioner_view_type> hash_table{
-          (TableEntry<KeyType> *)hash_table_storage_.data(), table_capacity_, partitioner_view};
-      partition_and_unique_kernel<<<grid_size, block_size, 0, stream>>>(
-          dp_keys_ptrs, dp_bucket_range_ptrs, d_lookup_ids_.data<int>(),
-          range_on_lookup_ids.data<BucketRangeType>(), num_local_lookup_, batch_size_per_gpu_,
-          hash_table, compressed_data_view);
+          (TableEntry<KeyType> *)hash_table_storage_.data(), hash_table_capacity_,
+          inserted_slots_.data<uint64_t>(), num_inserted_slots_.data<uint64_t>(),
+          partitioner_view};
+      if (fixed_hotness) {
+        int num_valid = num_valid_samples(input);
+        uint64_t num_keys = static_cast<uint64_t>(num_valid) * num_local_features_;
+        if (num_keys > 0) {
+          partition_and_unique_fixed_hotness_kernel<<<grid_size, block_size, 0, stream>>>(
+              dp_keys_ptrs, d_lookup_ids_.data<int>(), d_local_hotness_offsets_.data<int>(),
+              num_local_lookup_, num_valid, num_keys, hash_table, compressed_data_view);
+        }
+      } else {
+        partition_and_unique_kernel<<<grid_size, block_size, 0, stream>>>(
+            dp_keys_ptrs, dp_bucket_range_ptrs, d_lookup_ids_.data<int>(),
+            range_on_lookup_ids.data<BucketRangeType>(), num_local_lookup_, batch_size_per_gpu_,
+            hash_table, compressed_data_view);
+      }
+      clear_hash_table<KeyType>(stream);
     });
   });
 }
@@ -426,15 +584,15 @@ void PartitionAndUniqueOperator::partition_and_unique_by_table_id(
 
   DISPATCH_INTEGRAL_FUNCTION_CORE23(keys_gpu_major.data_type().type(), KeyType, [&] {
     DISPATCH_INTEGRAL_FUNCTION_CORE23(bucket_range_data_type.type(), BucketRangeType, [&] {
-      HCTR_LIB_THROW(
-          cudaMemsetAsync(hash_table_storage_.data(), 0, hash_table_storage_.num_bytes(), stream));
       HCTR_LIB_THROW(cudaMemsetAsync(
           compressed_data.partitioned_data.d_num_key_per_partition.data(), 0,
           compressed_data.partitioned_data.d_num_key_per_partition.num_bytes(), stream));
 
       IdentityPartitionerView identity_partitioner;
       UniqueTableView<KeyType, BucketRangeType, IdentityPartitionerView> hash_table{
-          (TableEntry<KeyType> *)hash_table_storage_.data(), table_capacity_, identity_partitioner};
+          (TableEntry<KeyType> *)hash_table_storage_.data(), hash_table_capacity_,
+          inserted_slots_.data<uint64_t>(), num_inserted_slots_.data<uint64_t>(),
+          identity_partitioner};
       CompressedDataView<KeyType, BucketRangeType> compressed_data_view{
           compressed_data.partitioned_data.view<KeyType, BucketRangeType>(),
           compressed_data.reverse_idx.data<BucketRangeType>()};
@@ -448,6 +606,7 @@ void PartitionAndUniqueOperator::partition_and_unique_by_table_id(
           keys_gpu_major.data<KeyType>(), feature_ids_gpu_major.data<int>(),
           table_partitioner.lookup_id_to_local_table_id.data<int>(), num_keys, hash_table,
           compressed_data_view);
+      clear_hash_table<KeyType>(stream);
     });
   });
 }
@@ -21,6 +21,7 @@
 #include <core23/cuda_primitives.cuh>
 #include <embedding/common.hpp>
 #include <embedding/data_distributor/data_compression_operators.hpp>
+#include <embedding/operators/row_sharding.hpp>
 #include <gpu_cache/include/hash_functions.cuh>
 #include <memory>
 #include <utils.cuh>
@@ -71,13 +72,35 @@ struct Hash {
 struct ShardPartitionerView {
   int *gpu_ids;
   int *num_shard_range;
+  int64_t *row_offsets;
+  int *row_offsets_start;
+  int64_t *hot_keys;
+  int *hot_keys_range;
+  int self_gpu_id;
 
   template <typename KeyType>
   DEVICE_INLINE int operator()(const KeyPair<KeyType> &key_pair) const noexcept {
     const auto &key = key_pair.key;
     const int &feature_id = key_pair.feature_id;
+    // Hot rows of hybrid tables are replicated, they are looked up locally.
+    int lo = hot_keys_range[feature_id];
+    int hi = hot_keys_range[feature_id + 1];
+    while (lo < hi) {
+      int mid = (lo + hi) / 2;
+      if (hot_keys[mid] < static_cast<int64_t>(key)) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    if (lo < hot_keys_range[feature_id + 1] && hot_keys[lo] == static_cast<int64_t>(key)) {
+      return self_gpu_id;
+    }
+
     int num_shard = num_shard_range[feature_id + 1] - num_shard_range[feature_id];
-    uint64_t shard_id = (uint64_t)key % (uint64_t)num_shard;
+    int start = row_offsets_start[feature_id];
+    int shard_id =
+        embedding::row_shard_id(key, start < 0 ? nullptr : row_offsets + start, num_shard);
     return gpu_ids[num_shard_range[feature_id] + shard_id];
   }
 };
@@ -85,18 +108,27 @@ struct ShardPartitionerView {
 struct ShardPartitioner {
   core23::Tensor gpu_ids;
   core23::Tensor num_shard_range;
+  core23::Tensor row_offsets;        // of the range sharded tables
+  core23::Tensor row_offsets_start;  // per lookup, -1 = round robin
+  core23::Tensor hot_keys;           // sorted per lookup, of the hybrid tables
+  core23::Tensor hot_keys_range;     // per lookup
+  int self_gpu_id = 0;
 
   ShardPartitioner() = default;
 
   ShardPartitioner(std::shared_ptr<core::CoreResourceManager> core,
                    const std::vector<embedding::LookupParam> &lookup_params,
                    const std::vector<std::vector<int>> &shard_matrix,
-                   const std::vector<int> &lookup_ids);
+                   const std::vector<int> &lookup_ids,
+                   const std::vector<std::vector<int64_t>> &table_shard_row_offsets = {},
+                   const std::vector<std::vector<int64_t>> &table_hot_keys = {});
 
   using view_type = ShardPartitionerView;
 
   view_type view() const noexcept {
-    return view_type{gpu_ids.data<int>(), num_shard_range.data<int>()};
+    return view_type{gpu_ids.data<int>(), num_shard_range.data<int>(), row_offsets.data<int64_t>(),
+                     row_offsets_start.data<int>(), hot_keys.data<int64_t>(),
+                     hot_keys_range.data<int>(), self_gpu_id};
   }
 };
 
@@ -156,6 +188,10 @@ struct UniqueTableView {
   TableEntry<KeyType> *table;
   size_t capacity;
 
+  // Slots filled by this call, so that only those are cleared afterwards.
+  uint64_t *inserted_slots;
+  uint64_t *num_inserted_slots;
+
   Partitioner partitioner;
 
   using ResultType = PartitionedDataView<KeyType, BucketRangeType>;
@@ -170,12 +206,15 @@ struct UniqueTableView {
 
     KeyPair<KeyType> unique_out = {0, 0};
     bool is_unique = true;
+    size_t insert_pos = 0;
     auto r_idx_plus_one =
         core23::get_insert_dump<KeyPair<KeyType>, TableEntry<KeyType>, BucketRangeType, Hash>(
-            key_pair, table, current_d_num_key, unique_out, capacity, {0, 0}, is_unique);
+            key_pair, table, current_d_num_key, unique_out, capacity, {0, 0}, is_unique,
+            &insert_pos);
     if (is_unique) {
       current_partitioned_keys[r_idx_plus_one - 1] = unique_out.key;
       current_feature_ids[r_idx_plus_one - 1] = unique_out.feature_id;
+      inserted_slots[atomic_add(num_inserted_slots, uint64_t{1})] = insert_pos;
     }
     return partition_id * result.max_num_key_per_partition + r_idx_plus_one;
   }
@@ -102,11 +102,25 @@ class PartitionAndUniqueOperator {
   core23::Tensor frequent_key_hash_table_storage_;
 
   core23::Tensor hash_table_storage_;
-  size_t table_capacity_;
+  size_t table_capacity_;       // max number of keys
+  size_t hash_table_capacity_;  // number of slots
+
+  // The hash table is persistent, only the slots filled by the last call are cleared.
+  core23::Tensor inserted_slots_;      // uint64_t
+  core23::Tensor num_inserted_slots_;  // uint64_t
+
+  template <typename KeyType>
+  void clear_hash_table(cudaStream_t stream);
 
   core23::Tensor range_on_lookup_ids;
 
   core23::Tensor d_lookup_ids_;  // int
+  // Offsets of the local lookups in a sample with max_hotness keys per lookup, size
+  // num_local_lookup_ + 1
+  core23::Tensor d_local_hotness_offsets_;  // int
+
+  // Number of samples of this GPU that have keys, for fixed hotness
+  int num_valid_samples(const DataDistributionInput &input) const;
   int num_local_lookup_;
   int num_local_features_;
   int num_features_;
@@ -114,6 +114,13 @@ class SparseMPDataDistributionOp : public IDataDistributionOp {
   void convert_indices(embedding::EmbeddingInput &output);
 
  private:
+  // Unique the first num_keys sorted keys per destination GPU, and exchange the unique counts.
+  void unique_keys_per_gpu(size_t num_keys, cudaStream_t stream);
+
+  // Whether num_unique_keys keys plus num_keys reverse indices are fewer bytes than num_keys keys.
+  // Sender and receiver evaluate it on the same counts, so they agree on what is sent.
+  bool send_unique_keys(size_t peer, size_t num_keys, size_t num_unique_keys) const;
+
   std::shared_ptr<core::CoreResourceManager> core_;
 
   embedding::EmbeddingCollectionParam ebc_param_;
@@ -142,6 +149,24 @@ class SparseMPDataDistributionOp : public IDataDistributionOp {
     void *h_recv_k_per_g;
   } sparse_temp_storage_;
 
+  // Unique keys before the all-to-all (EmbeddingCollectionParam::unique_keys_before_all2all_).
+  // The sorted keys are partitioned by their GPU label, so the reverse indices point into the
+  // partition of the destination GPU.
+  struct MPUniqueStorage {
+    MPUniqueStorage(std::shared_ptr<core::CoreResourceManager> core, int num_send_keys,
+                    int num_recv_keys, core23::DataType key_type, core23::DataType offset_type);
+
+    std::unique_ptr<TablePartitioner> gpu_partitioner;  // identity over the global GPU ids
+    CompressedData unique_keys;
+    core23::Tensor u_per_g;           // unique keys per GPU, received from nccl
+    core23::Tensor unique_keys_recv;  // received from nccl
+    core23::Tensor reverse_idx_recv;  // received from nccl
+    core23::Tensor h_send_u_per_g;
+    core23::Tensor h_recv_u_per_g;
+  };
+  std::unique_ptr<MPUniqueStorage> unique_storage_;
+  PartitionAndUniqueOperator partition_and_unique_operator_;
+
   mp::LabelAndCountKeysOperator label_and_count_keys_operator_;
   mp::LabelAndCountKeysOperator::Result label_and_count_keys_output_;
   mp::CountKeysOperator count_keys_operator_;
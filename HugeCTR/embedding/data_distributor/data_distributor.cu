@@ -22,6 +22,19 @@
 
 namespace HugeCTR {
 
+namespace {
+
+template <typename KeyType>
+__global__ void hash_keys_kernel(const KeyType* keys, size_t num_keys, uint64_t num_rows,
+                                 KeyType* hashed_keys) {
+  CUDA_1D_KERNEL_LOOP_T(size_t, i, num_keys) {
+    hashed_keys[i] =
+        static_cast<KeyType>(embedding::hash_key_to_row(static_cast<uint64_t>(keys[i]), num_rows));
+  }
+}
+
+}  // namespace
+
 DataDistributor::DataDistributor(
     std::vector<std::shared_ptr<core::CoreResourceManager>>& core_resource_managers,
     const embedding::EmbeddingCollectionParam& ebc_param,
@@ -42,6 +55,11 @@ DataDistributor::DataDistributor(
     const embedding::LookupParam& lookup_param = ebc_param.lookup_params[lookup_id];
     feature_pooling_factors_.push_back(lookup_param.max_hotness);
     feature_id_to_table_id_map_[lookup_id] = lookup_param.table_id;
+    const auto& table_param = emb_table_param_list[lookup_param.table_id];
+    HCTR_CHECK_HINT(!table_param.hash_keys || table_param.max_vocabulary_size > 0,
+                    "hash_keys is only supported by static tables.");
+    lookup_num_hashed_rows_.push_back(table_param.hash_keys ? table_param.max_vocabulary_size : 0);
+    hashes_keys_ = hashes_keys_ || table_param.hash_keys;
     for (size_t group_id = 0; group_id < ebc_param.grouped_lookup_params.size(); ++group_id) {
       if (!ebc_param.lookup_id_in_group(group_id, lookup_id)) continue;
       feature_id_to_group_id_map_[lookup_id] = group_id;
@@ -51,6 +69,7 @@ DataDistributor::DataDistributor(
   init_comm_data();
   init_filtered_all_to_all();
   init_fixed_dp_bucket_range();
+  hashed_keys_.resize(num_local_gpus_, std::vector<core23::Tensor>(num_features_));
 
   for (size_t gpu_id = 0; gpu_id < num_local_gpus_; ++gpu_id) {
     data_distribution_input_.emplace_back(core_resource_managers_[gpu_id], ebc_param.num_lookup,
@@ -72,7 +91,6 @@ void DataDistributor::init_comm_data() {
     core23::TensorParams params = core23::TensorParams().device(device);
 
     GpuCommData comm_data;
-    comm_data.last_batch_size = 0;
 
     size_t num_keys = num_features * ebc_param_.universal_batch_size;
 
@@ -153,21 +171,67 @@ void DataDistributor::init_fixed_dp_bucket_range() {
   }
 }
 
+void DataDistributor::hash_keys(int gpu_id, std::vector<core23::Tensor>& dp_keys,
+                                cudaStream_t stream) {
+  auto core = core_resource_managers_[gpu_id];
+  for (size_t lookup_id = 0; lookup_id < num_features_; ++lookup_id) {
+    const int64_t num_rows = lookup_num_hashed_rows_[lookup_id];
+    if (num_rows == 0) continue;
+
+    const core23::Tensor& keys = dp_keys[lookup_id];
+    core23::Tensor& hashed_keys = hashed_keys_[gpu_id][lookup_id];
+    if (hashed_keys.empty() || hashed_keys.num_elements() < keys.num_elements()) {
+      core23::Device device(core23::DeviceType::GPU, core->get_device_id());
+      hashed_keys = core23::Tensor(core23::TensorParams()
+                                       .device(device)
+                                       .shape({keys.num_elements()})
+                                       .data_type(ebc_param_.key_type));
+    }
+    if (keys.num_elements() > 0) {
+      DISPATCH_INTEGRAL_FUNCTION_CORE23(ebc_param_.key_type.type(), KeyType, [&] {
+        auto& kernel_param = core->get_kernel_param();
+        constexpr int block_size = 256;
+        int grid_size = kernel_param.num_sms * (kernel_param.max_thread_per_sm / block_size);
+        hash_keys_kernel<<<grid_size, block_size, 0, stream>>>(
+            keys.data<KeyType>(), keys.num_elements(), num_rows, hashed_keys.data<KeyType>());
+        HCTR_LIB_THROW(cudaPeekAtLastError());
+      });
+    }
+    dp_keys[lookup_id] = hashed_keys;
+  }
+}
+
 void DataDistributor::distribute(int gpu_id, const std::vector<core23::Tensor>& dp_keys,
                                  const std::vector<core23::Tensor>& dp_bucket_range,
                                  DataDistributor::Result& output, int batch_size) {
+  prepare_input(gpu_id, dp_keys, dp_bucket_range, output, batch_size);
+  distribute_prepared(gpu_id, output);
+}
+
+void DataDistributor::prepare_input(int gpu_id, const std::vector<core23::Tensor>& dp_keys,
+                                    const std::vector<core23::Tensor>& dp_bucket_range,
+                                    DataDistributor::Result& output, int batch_size) {
   auto core = core_resource_managers_[gpu_id];
   CudaDeviceContext ctx(core->get_device_id());
   cudaStream_t stream = core->get_local_gpu()->get_stream();
 
-  const bool bucket_ranges_outdated = batch_size != gpu_comm_data_[gpu_id].last_batch_size;
-  gpu_comm_data_[gpu_id].last_batch_size = batch_size;
+  // With variable hotness, the data reader provides the bucket ranges of every batch
+  const bool variable_hotness = !dp_bucket_range.empty();
+  int& last_batch_size =
+      gpu_comm_data_[gpu_id].last_batch_size[output[0].num_keys_per_bucket.data()];
+  const bool bucket_ranges_outdated = variable_hotness || batch_size != last_batch_size;
+  last_batch_size = variable_hotness ? -1 : batch_size;
 
   // sparse_forward new full batch bucket range (to be deprecated)
   // sparse_forward dp bucket ranges (to be moved to data reader)
   if (bucket_ranges_outdated) {
-    compute_dp_bucket_range_operators_[gpu_id](fixed_dp_bucket_range_[gpu_id],
-                                               output[0].num_keys_per_bucket, batch_size, stream);
+    if (variable_hotness) {
+      compute_dp_bucket_range_operators_[gpu_id].count_keys_per_bucket(
+          dp_bucket_range, output[0].num_keys_per_bucket, stream);
+    } else {
+      compute_dp_bucket_range_operators_[gpu_id](fixed_dp_bucket_range_[gpu_id],
+                                                 output[0].num_keys_per_bucket, batch_size, stream);
+    }
 
     // Instead of recomputing for each group, copy computed result
     for (size_t grouped_id = 1; grouped_id < ebc_param_.grouped_lookup_params.size();
@@ -178,7 +242,23 @@ void DataDistributor::distribute(int gpu_id, const std::vector<core23::Tensor>&
     }
   }
 
-  data_distribution_input_[gpu_id].copy_tensor_vec(dp_keys, fixed_dp_bucket_range_[gpu_id], stream);
+  data_distribution_input_[gpu_id].fixed_hotness_batch_size_ = variable_hotness ? 0 : batch_size;
+  const std::vector<core23::Tensor>& bucket_range =
+      variable_hotness ? dp_bucket_range : fixed_dp_bucket_range_[gpu_id];
+  // Only the pointers are read, so the keys are not copied unless some are hashed
+  if (!hashes_keys_) {
+    data_distribution_input_[gpu_id].copy_tensor_vec(dp_keys, bucket_range, stream);
+    return;
+  }
+  std::vector<core23::Tensor> keys = dp_keys;
+  hash_keys(gpu_id, keys, stream);
+  data_distribution_input_[gpu_id].copy_tensor_vec(keys, bucket_range, stream);
+}
+
+void DataDistributor::distribute_prepared(int gpu_id, DataDistributor::Result& output) {
+  auto core = core_resource_managers_[gpu_id];
+  CudaDeviceContext ctx(core->get_device_id());
+  cudaStream_t stream = core->get_local_gpu()->get_stream();
 
   for (size_t grouped_id = 0; grouped_id < ebc_param_.grouped_lookup_params.size(); grouped_id++) {
     data_distribution_ops_[grouped_id][gpu_id]->distribute(data_distribution_input_[gpu_id],
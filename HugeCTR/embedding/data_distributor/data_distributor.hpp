@@ -26,7 +26,6 @@
 #include <embedding/operators/dp_index_calculation.hpp>
 #include <embedding/operators/keys_to_indices.hpp>
 #include <embedding/operators/mp_index_calculation.hpp>
-#include <embedding/operators/transpose_input.hpp>
 #include <optional>
 #include <unordered_map>
 #include <vector>
@@ -41,15 +40,26 @@ class DataDistributor {
                   const embedding::EmbeddingCollectionParam& ebc_param,
                   const std::vector<embedding::EmbeddingTableParam>& emb_table_param_list);
 
+  // dp_bucket_range are the CSR offsets of dp_keys with variable hotness, empty if every sample
+  // has max_hotness keys
   void distribute(int gpu_id, const std::vector<core23::Tensor>& dp_keys,
                   const std::vector<core23::Tensor>& dp_bucket_range, Result& output,
                   int batch_size);
 
+  // distribute() in two steps. prepare_input() uploads the pointers of dp_keys from host memory
+  // and can not be captured in a CUDA graph, distribute_prepared() only launches kernels and can.
+  void prepare_input(int gpu_id, const std::vector<core23::Tensor>& dp_keys,
+                     const std::vector<core23::Tensor>& dp_bucket_range, Result& output,
+                     int batch_size);
+
+  void distribute_prepared(int gpu_id, Result& output);
+
  private:
   struct GpuCommData {
     // This is a performance optimization to prevent us from computing bucket ranges each iteration.
-    // If the current_batch_size == last_batch_size then the bucket_ranges are the same.
-    int last_batch_size;
+    // If the current_batch_size == last_batch_size then the bucket_ranges are the same. Kept per
+    // output, since the pipeline alternates between two of them.
+    std::unordered_map<const void*, int> last_batch_size;
     core23::Tensor hotness_bucket_range;
   };
 
@@ -59,6 +69,9 @@ class DataDistributor {
 
   void init_fixed_dp_bucket_range();
 
+  // Replaces the keys of the lookups of tables with hash_keys by their rows
+  void hash_keys(int gpu_id, std::vector<core23::Tensor>& dp_keys, cudaStream_t stream);
+
   std::vector<std::shared_ptr<core::CoreResourceManager>> core_resource_managers_;
   std::vector<int> feature_pooling_factors_;
   std::vector<std::vector<int>> resident_feature_tables_;  // [gpu_id][feature_id]
@@ -72,6 +85,10 @@ class DataDistributor {
 
   std::vector<std::vector<core23::Tensor>> fixed_dp_bucket_range_;
 
+  std::vector<int64_t> lookup_num_hashed_rows_;  // 0 if the table does not hash its keys
+  bool hashes_keys_ = false;                     // Any table hashes its keys
+  std::vector<std::vector<core23::Tensor>> hashed_keys_;  // [gpu_id][lookup_id]
+
   size_t batch_size_;
   size_t batch_size_per_gpu_;
 
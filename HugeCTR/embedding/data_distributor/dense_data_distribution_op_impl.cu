@@ -100,7 +100,8 @@ DenseMPDataDistributionOp::DenseMPTempStorage::DenseMPTempStorage(
   core23::TensorParams params = core23::TensorParams().device(device);
 
   this->shard_partitioner_ = std::make_unique<ShardPartitioner>(
-      core, ebc_param.lookup_params, ebc_param.shard_matrix, grouped_lookup_param.lookup_ids);
+      core, ebc_param.lookup_params, ebc_param.shard_matrix, grouped_lookup_param.lookup_ids,
+      ebc_param.table_shard_row_offsets_, ebc_param.table_hot_keys_);
 
   std::vector<int> local_lookup_id_to_global_lookup_ids =
       calc_local_lookup_id_to_global_lookup_ids(global_gpu_id, ebc_param, group_id);
@@ -19,6 +19,7 @@
 #include <cooperative_groups/scan.h>
 #include <cuda_runtime.h>
 
+#include <embedding/operators/row_sharding.hpp>
 #include <utils.cuh>
 #include <utils.hpp>
 
@@ -39,6 +40,7 @@ __global__ void label_and_count_keys(
     const int* __restrict lookup_bucket_threads, const int* __restrict lookup_ids,
     const int* __restrict lookup_num_shards, const int* __restrict lookup_gpus,
     const int* __restrict hotness_bucket_range, const uint32_t* __restrict gpu_lookup_range,
+    const int64_t* __restrict row_offsets, const int* __restrict lookup_row_offsets_start,
     key_t* flat_keys, uint32_t* labels, offset_t* keys_per_gpu, offset_t* keys_per_bucket,
     int batch_size_per_gpu, int num_gpus, int this_gpu_id, int num_lookup) {
   extern __shared__ uint32_t dynamic_smem[];
@@ -53,6 +55,9 @@ __global__ void label_and_count_keys(
   int num_shards = lookup_num_shards[lookup];
   int bucket_threads = lookup_bucket_threads[lookup];
   int lookup_bucket_start = hotness_bucket_range[lookup] * batch_size_per_gpu;
+  int row_offsets_start = lookup_row_offsets_start[lookup];
+  const int64_t* lookup_row_offsets =
+      row_offsets_start < 0 ? nullptr : row_offsets + row_offsets_start;
 
   labels += lookup_bucket_start;  // skip to where we care about
   flat_keys += lookup_bucket_start;
@@ -85,7 +90,7 @@ __global__ void label_and_count_keys(
     for (int k = bucket_group.thread_rank(); k < num_keys; k += bucket_group.size()) {
       // Which GPU does my embedding reside on?
       key_t key = lookup_keys[range_start + k];
-      int gpu_id = smem_lookup_gpus[key % num_shards];
+      int gpu_id = smem_lookup_gpus[::embedding::row_shard_id(key, lookup_row_offsets, num_shards)];
       labels[range_start + k] = gpu_id;
       flat_keys[range_start + k] = key;
 
@@ -235,6 +240,18 @@ __global__ void compute_bucket_ranges_with_padding(offset_t** bucket_ranges,
   }
 }
 
+template <typename offset_t>
+__global__ void count_keys_per_bucket(offset_t** bucket_ranges, offset_t* keys_per_bucket,
+                                      int batch_size_per_gpu) {
+  const int lookup_id = blockIdx.y;
+  const offset_t* bucket_range = bucket_ranges[lookup_id];
+
+  CUDA_1D_KERNEL_LOOP(bucket_idx, batch_size_per_gpu) {
+    keys_per_bucket[lookup_id * batch_size_per_gpu + bucket_idx] =
+        bucket_range[bucket_idx + 1] - bucket_range[bucket_idx];
+  }
+}
+
 template <int TILE_SIZE, typename offset_t>
 __global__ void compute_shard_ranges(uint32_t* shard_ranges,
                                      const offset_t** __restrict bucket_ranges,
@@ -349,6 +366,8 @@ LabelAndCountKeysOperator::LabelAndCountKeysOperator(
   std::vector<int> h_lookup_bucket_threads(ebc_param.num_lookup, 0);
   std::vector<int> h_hotness_bucket_range(ebc_param.num_lookup + 1, 0);
   std::vector<int> h_lookup_ids;
+  std::vector<int64_t> h_row_offsets;
+  std::vector<int> h_lookup_row_offsets_start(ebc_param.num_lookup, -1);
   // e.g: num_tables = 4, GPU0 tables [0, 2], GPU1 tables [1, 2, 3]
   //        gpu_lookup_range = [0,1,1,2,2|2,2,3,4,5] * batch_size
   h_per_gpu_lookup_range = std::vector<uint32_t>(global_gpu_count_ * ebc_param.num_lookup + 1, 0);
@@ -367,6 +386,14 @@ LabelAndCountKeysOperator::LabelAndCountKeysOperator(
 
     if (lookup_in_group) h_lookup_ids.push_back(lookup_id);
 
+    const int64_t* row_offsets =
+        ebc_param.get_table_shard_row_offsets(ebc_param.lookup_params[lookup_id].table_id);
+    if (lookup_in_group && row_offsets != nullptr) {
+      h_lookup_row_offsets_start[lookup_id] = static_cast<int>(h_row_offsets.size());
+      h_row_offsets.insert(h_row_offsets.end(), row_offsets,
+                           row_offsets + h_lookup_num_gpus[lookup_id] + 1);
+    }
+
     // cooperative groups need partition to be power of 2
     int hotness = ebc_param.lookup_params[lookup_id].max_hotness;
     h_lookup_bucket_threads[lookup_id] = min(highest_pow2(hotness), 32);
@@ -401,6 +428,13 @@ LabelAndCountKeysOperator::LabelAndCountKeysOperator(
                          .data_type(core23::ScalarType::UInt32));
   this->lookup_ids = core23::Tensor(params.shape({static_cast<int64_t>(h_lookup_ids.size())})
                                         .data_type(core23::ScalarType::Int32));
+  // Never empty, so that the kernel always gets a valid pointer.
+  h_row_offsets.push_back(0);
+  this->row_offsets = core23::Tensor(params.shape({static_cast<int64_t>(h_row_offsets.size())})
+                                         .data_type(core23::ScalarType::Int64));
+  this->lookup_row_offsets_start =
+      core23::Tensor(params.shape({static_cast<int64_t>(h_lookup_row_offsets_start.size())})
+                         .data_type(core23::ScalarType::Int32));
 
   core23::copy_sync(lookup_gpu_ids, h_lookup_gpu_ids);
   core23::copy_sync(lookup_num_gpus, h_lookup_num_gpus);
@@ -408,6 +442,8 @@ LabelAndCountKeysOperator::LabelAndCountKeysOperator(
   core23::copy_sync(hotness_bucket_range, h_hotness_bucket_range);
   core23::copy_sync(gpu_lookup_range, h_per_gpu_lookup_range);
   core23::copy_sync(lookup_ids, h_lookup_ids);
+  core23::copy_sync(row_offsets, h_row_offsets);
+  core23::copy_sync(lookup_row_offsets_start, h_lookup_row_offsets_start);
 }
 
 void LabelAndCountKeysOperator::operator()(const DataDistributionInput& input,
@@ -438,7 +474,9 @@ void LabelAndCountKeysOperator::operator()(const DataDistributionInput& input,
           (const int*)lookup_bucket_threads.data<int>(), (const int*)lookup_ids.data<int>(),
           (const int*)lookup_num_gpus.data<int>(), (const int*)lookup_gpu_ids.data<int>(),
           (const int*)hotness_bucket_range.data<int>(),
-          (const uint32_t*)gpu_lookup_range.data<uint32_t>(), output.flat_keys.data<KeyType>(),
+          (const uint32_t*)gpu_lookup_range.data<uint32_t>(),
+          (const int64_t*)row_offsets.data<int64_t>(),
+          (const int*)lookup_row_offsets_start.data<int>(), output.flat_keys.data<KeyType>(),
           output.local_labels.data<uint32_t>(), output.keys_per_gpu.data<BucketRangeType>(),
           output.keys_per_bucket.data<BucketRangeType>(), batch_size_per_gpu_, global_gpu_count_,
           global_gpu_id_, input.num_lookup_);
@@ -650,6 +688,26 @@ void ComputeDPBucketRangeOperator::operator()(std::vector<core23::Tensor> dp_buc
   HCTR_LIB_THROW(cudaGetLastError());
 }
 
+void ComputeDPBucketRangeOperator::count_keys_per_bucket(
+    const std::vector<core23::Tensor>& dp_bucket_ranges, core23::Tensor keys_per_bucket,
+    cudaStream_t stream) {
+  int num_lookup = dp_bucket_ranges.size();
+
+  init_tensor_list(h_ptrs_, dp_bucket_ranges);
+  core23::copy_async(d_ptrs_, h_ptrs_, stream);
+
+  dim3 block(128);
+  dim3 grid((batch_size_per_gpu_ + block.x - 1) / block.x, num_lookup);
+
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(dp_bucket_ranges[0].data_type().type(), BucketRangeType, [&] {
+    kernels::count_keys_per_bucket<<<grid, block, 0, stream>>>(
+        d_ptrs_.data<BucketRangeType*>(), keys_per_bucket.data<BucketRangeType>(),
+        batch_size_per_gpu_);
+  });
+
+  HCTR_LIB_THROW(cudaGetLastError());
+}
+
 ConcatKeysAndBucketRangeOperator::ConcatKeysAndBucketRangeOperator(
     std::shared_ptr<core::CoreResourceManager> core,
     const embedding::EmbeddingCollectionParam& ebc_param, size_t grouped_id)
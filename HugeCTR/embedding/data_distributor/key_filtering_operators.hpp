@@ -32,6 +32,10 @@ class ComputeDPBucketRangeOperator {
   void operator()(std::vector<core23::Tensor> dp_bucket_ranges, core23::Tensor keys_per_bucket,
                   int current_batch_size, cudaStream_t stream);
 
+  // keys_per_bucket of the bucket ranges of a data reader with variable hotness
+  void count_keys_per_bucket(const std::vector<core23::Tensor>& dp_bucket_ranges,
+                             core23::Tensor keys_per_bucket, cudaStream_t stream);
+
  private:
   core23::Tensor h_ptrs_;
   core23::Tensor d_ptrs_;
@@ -71,6 +75,8 @@ class LabelAndCountKeysOperator {
   core23::Tensor hotness_bucket_range;
   core23::Tensor gpu_lookup_range;
   core23::Tensor lookup_ids;
+  core23::Tensor row_offsets;               // of the range sharded tables
+  core23::Tensor lookup_row_offsets_start;  // -1 = round robin
 
   int batch_size_ = 0;
   int batch_size_per_gpu_ = 0;
@@ -18,11 +18,26 @@
 #include <HugeCTR/include/utils.cuh>
 #include <HugeCTR/include/utils.hpp>
 #include <cub/cub.cuh>
+#include <embedding/data_distributor/data_compression_operators.cuh>
 #include <embedding/data_distributor/data_distribution_op.hpp>
 #include <embedding/operators/communication.hpp>
+#include <numeric>
 
 namespace HugeCTR {
 
+namespace {
+
+// Restores the keys of one peer from its unique keys: reverse_idx is into the partitioned keys of
+// the sender, whose partitions are stride apart.
+template <typename KeyType, typename BucketRangeType>
+__global__ void expand_unique_keys_kernel(const KeyType* __restrict__ unique_keys,
+                                          const BucketRangeType* __restrict__ reverse_idx,
+                                          size_t num_keys, size_t stride, KeyType* keys) {
+  CUDA_1D_KERNEL_LOOP_T(size_t, i, num_keys) { keys[i] = unique_keys[reverse_idx[i] % stride]; }
+}
+
+}  // namespace
+
 SparseDPDataDistributionOp::SparseDPDataDistributionOp(
     std::shared_ptr<core::CoreResourceManager> core,
     const embedding::EmbeddingCollectionParam& ebc_param, size_t group_id,
@@ -64,6 +79,13 @@ void SparseDPDataDistributionOp::distribute(const DataDistributionInput& input,
   // --- copy DP keys and sparse_forward DP bucket range
   concat_keys_and_bucket_range_operator_(input, output.keys, output.bucket_range, stream);
 
+  if (ebc_param_.sync_free_) {
+    // The kernels after this read the number of keys from the end of the bucket range
+    output.h_num_keys = output.keys.num_elements();
+    convert_indices(output);
+    return;
+  }
+
   DISPATCH_INTEGRAL_FUNCTION_CORE23(ebc_param_.offset_type.type(), BucketRangeType, [&] {
     BucketRangeType num_keys = 0;
     int num_buckets = output.bucket_range.num_elements();
@@ -148,6 +170,41 @@ SparseMPDataDistributionOp::MPTempStorage::MPTempStorage(
   });
 }
 
+SparseMPDataDistributionOp::MPUniqueStorage::MPUniqueStorage(
+    std::shared_ptr<core::CoreResourceManager> core, int num_send_keys, int num_recv_keys,
+    core23::DataType key_type, core23::DataType offset_type) {
+  CudaDeviceContext ctx(core->get_device_id());
+
+  int num_global_gpus = core->get_global_gpu_count();
+
+  core23::Device device(core23::DeviceType::GPU, core->get_device_id());
+  core23::TensorParams params = core23::TensorParams().device(device);
+
+  // The sorted keys are labeled with their GPU, which doubles as the lookup id of the partitioner
+  std::vector<int> h_gpu_ids(num_global_gpus);
+  std::iota(h_gpu_ids.begin(), h_gpu_ids.end(), 0);
+  this->gpu_partitioner = std::make_unique<TablePartitioner>();
+  this->gpu_partitioner->lookup_id_to_local_table_id =
+      core23::Tensor(params.shape({num_global_gpus}).data_type(core23::ScalarType::Int32));
+  core23::copy_sync(this->gpu_partitioner->lookup_id_to_local_table_id, h_gpu_ids);
+
+  this->unique_keys.partitioned_data =
+      PartitionedData(core, num_global_gpus, num_send_keys, key_type, offset_type);
+  this->unique_keys.reverse_idx =
+      core23::Tensor(params.shape({num_send_keys}).data_type(offset_type));
+
+  this->u_per_g = core23::Tensor(params.shape({num_global_gpus}).data_type(offset_type));
+  this->unique_keys_recv = core23::Tensor(params.shape({num_recv_keys}).data_type(key_type));
+  this->reverse_idx_recv = core23::Tensor(params.shape({num_recv_keys}).data_type(offset_type));
+
+  this->h_send_u_per_g = core23::Tensor(params.shape({num_global_gpus})
+                                            .data_type(offset_type)
+                                            .device(core23::DeviceType::CPU));
+  this->h_recv_u_per_g = core23::Tensor(params.shape({num_global_gpus})
+                                            .data_type(offset_type)
+                                            .device(core23::DeviceType::CPU));
+}
+
 SparseMPDataDistributionOp::SparseMPDataDistributionOp(
     std::shared_ptr<core::CoreResourceManager> core,
     const embedding::EmbeddingCollectionParam& ebc_param, size_t group_id,
@@ -156,6 +213,7 @@ SparseMPDataDistributionOp::SparseMPDataDistributionOp(
       ebc_param_(ebc_param),
       num_global_gpus_(core->get_global_gpu_count()),
       batch_size_per_gpu_(ebc_param.universal_batch_size / num_global_gpus_),
+      partition_and_unique_operator_(core, ebc_param, group_id),
       label_and_count_keys_operator_(core, ebc_param, group_id),
       label_and_count_keys_output_(core, ebc_param, group_id),
       count_keys_operator_(core, ebc_param, group_id),
@@ -184,6 +242,13 @@ SparseMPDataDistributionOp::SparseMPDataDistributionOp(
   sparse_temp_storage_ = MPTempStorage(core, ebc_param_.universal_batch_size, sample_max_nnz_,
                                        max_local_features, max_local_buckets, max_buckets_in_group,
                                        ebc_param_.key_type, ebc_param_.offset_type);
+  if (ebc_param_.unique_keys_before_all2all_) {
+    unique_storage_ = std::make_unique<MPUniqueStorage>(
+        core, batch_size_per_gpu_ * sample_max_nnz_,
+        ebc_param_.universal_batch_size * max_local_features, ebc_param_.key_type,
+        ebc_param_.offset_type);
+    partition_and_unique_operator_.init_hash_table_for_unique(core, ebc_param_.key_type);
+  }
   if (ebc_param_.keys_preprocess_strategy_ == embedding::KeysPreprocessStrategy::AddOffset) {
     indices_converter_ = std::make_unique<embedding::KeysToIndicesConverter>(
         core, emb_table_param_list, ebc_param_, group_id);
@@ -307,11 +372,29 @@ void SparseMPDataDistributionOp::all2all_keys(embedding::EmbeddingInput& output,
                                  cudaMemcpyDeviceToHost, stream));
   HCTR_LIB_THROW(cudaStreamSynchronize(stream));
 
+  size_t num_send_keys = 0;
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(send_k_per_g.data_type().type(), BucketRangeType, [&] {
+    for (size_t peer = 0; peer < num_global_gpus_; ++peer) {
+      num_send_keys += static_cast<BucketRangeType*>(h_send_k_per_g)[peer];
+    }
+  });
+  if (unique_storage_) {
+    unique_keys_per_gpu(num_send_keys, stream);
+  }
+
   size_t send_offset = 0;
   size_t recv_offset = 0;
+  size_t recv_unique_offset = 0;
 
   DISPATCH_INTEGRAL_FUNCTION_CORE23(send_tensor.data_type().type(), KeyType, [&] {
     DISPATCH_INTEGRAL_FUNCTION_CORE23(send_k_per_g.data_type().type(), BucketRangeType, [&] {
+      auto offset_nccl_type =
+          core23::get_nccl_dtype_from_tensor_scalar_type_core23(send_k_per_g.data_type().type());
+      const BucketRangeType* h_send_u_per_g =
+          unique_storage_ ? unique_storage_->h_send_u_per_g.data<BucketRangeType>() : nullptr;
+      const BucketRangeType* h_recv_u_per_g =
+          unique_storage_ ? unique_storage_->h_recv_u_per_g.data<BucketRangeType>() : nullptr;
+
       ncclGroupStart();
       for (size_t peer = 0; peer < num_global_gpus_; ++peer) {
         auto send_num_keys = static_cast<BucketRangeType*>(h_send_k_per_g)[peer];
@@ -320,23 +403,106 @@ void SparseMPDataDistributionOp::all2all_keys(embedding::EmbeddingInput& output,
         //        core->get_global_gpu_id(),
         //               (int)peer, (int)send_num_keys, (int)recv_num_keys);
         if (send_num_keys > 0) {
-          HCTR_LIB_THROW(ncclSend(send_tensor.data<KeyType>() + send_offset, send_num_keys,
-                                  nccl_type, peer, core_->get_nccl(), stream));
+          if (h_send_u_per_g && send_unique_keys(peer, send_num_keys, h_send_u_per_g[peer])) {
+            auto& unique_keys = unique_storage_->unique_keys;
+            auto& partitioned_data = unique_keys.partitioned_data;
+            HCTR_LIB_THROW(ncclSend(partitioned_data.partitioned_keys.data<KeyType>() +
+                                        peer * partitioned_data.max_num_key_per_partition,
+                                    h_send_u_per_g[peer], nccl_type, peer, core_->get_nccl(),
+                                    stream));
+            HCTR_LIB_THROW(ncclSend(unique_keys.reverse_idx.data<BucketRangeType>() + send_offset,
+                                    send_num_keys, offset_nccl_type, peer, core_->get_nccl(),
+                                    stream));
+          } else {
+            HCTR_LIB_THROW(ncclSend(send_tensor.data<KeyType>() + send_offset, send_num_keys,
+                                    nccl_type, peer, core_->get_nccl(), stream));
+          }
         }
         if (recv_num_keys > 0) {
-          HCTR_LIB_THROW(ncclRecv(recv_tensor.data<KeyType>() + recv_offset, recv_num_keys,
-                                  nccl_type, peer, core_->get_nccl(), stream));
+          if (h_recv_u_per_g && send_unique_keys(peer, recv_num_keys, h_recv_u_per_g[peer])) {
+            HCTR_LIB_THROW(
+                ncclRecv(unique_storage_->unique_keys_recv.data<KeyType>() + recv_unique_offset,
+                         h_recv_u_per_g[peer], nccl_type, peer, core_->get_nccl(), stream));
+            HCTR_LIB_THROW(
+                ncclRecv(unique_storage_->reverse_idx_recv.data<BucketRangeType>() + recv_offset,
+                         recv_num_keys, offset_nccl_type, peer, core_->get_nccl(), stream));
+            recv_unique_offset += h_recv_u_per_g[peer];
+          } else {
+            HCTR_LIB_THROW(ncclRecv(recv_tensor.data<KeyType>() + recv_offset, recv_num_keys,
+                                    nccl_type, peer, core_->get_nccl(), stream));
+          }
         }
         send_offset += send_num_keys;
         recv_offset += recv_num_keys;
       }
       ncclGroupEnd();
+
+      if (!h_recv_u_per_g) return;
+
+      // --- expand the unique keys of every peer that sent them
+      auto& kernel_param = core_->get_kernel_param();
+      int block_size = kernel_param.max_thread_per_block;
+      size_t stride = unique_storage_->unique_keys.partitioned_data.max_num_key_per_partition;
+      size_t peer_offset = 0;
+      size_t peer_unique_offset = 0;
+      for (size_t peer = 0; peer < num_global_gpus_; ++peer) {
+        auto recv_num_keys = static_cast<BucketRangeType*>(h_recv_k_per_g)[peer];
+        if (recv_num_keys > 0 && send_unique_keys(peer, recv_num_keys, h_recv_u_per_g[peer])) {
+          int grid_size = std::min<size_t>((recv_num_keys + block_size - 1) / block_size,
+                                           kernel_param.num_sms * 8);
+          expand_unique_keys_kernel<<<grid_size, block_size, 0, stream>>>(
+              unique_storage_->unique_keys_recv.data<KeyType>() + peer_unique_offset,
+              unique_storage_->reverse_idx_recv.data<BucketRangeType>() + peer_offset,
+              recv_num_keys, stride, recv_tensor.data<KeyType>() + peer_offset);
+          HCTR_LIB_THROW(cudaPeekAtLastError());
+          peer_unique_offset += h_recv_u_per_g[peer];
+        }
+        peer_offset += recv_num_keys;
+      }
     });
   });
 
   output.h_num_keys = recv_offset;
 }
 
+void SparseMPDataDistributionOp::unique_keys_per_gpu(size_t num_keys, cudaStream_t stream) {
+  auto& unique_keys = unique_storage_->unique_keys;
+  auto sorted_labels = sparse_temp_storage_.sorted_local_labels;
+
+  // The labels of the valid keys are global GPU ids, and they are read as the lookup ids
+  partition_and_unique_operator_.partition_and_unique_by_table_id(
+      sparse_temp_storage_.sorted_local_keys, sorted_labels, num_keys,
+      *unique_storage_->gpu_partitioner, unique_keys, stream);
+
+  auto send_u_per_g = unique_keys.partitioned_data.d_num_key_per_partition;
+  auto recv_u_per_g = unique_storage_->u_per_g;
+  auto nccl_type =
+      core23::get_nccl_dtype_from_tensor_scalar_type_core23(send_u_per_g.data_type().type());
+  size_t count_bytes = send_u_per_g.data_type().size();
+
+  ncclGroupStart();
+  for (size_t peer = 0; peer < num_global_gpus_; ++peer) {
+    HCTR_LIB_THROW(ncclSend(static_cast<char*>(send_u_per_g.data()) + peer * count_bytes, 1,
+                            nccl_type, peer, core_->get_nccl(), stream));
+    HCTR_LIB_THROW(ncclRecv(static_cast<char*>(recv_u_per_g.data()) + peer * count_bytes, 1,
+                            nccl_type, peer, core_->get_nccl(), stream));
+  }
+  ncclGroupEnd();
+
+  core23::copy_async(unique_storage_->h_send_u_per_g, send_u_per_g, stream);
+  core23::copy_async(unique_storage_->h_recv_u_per_g, recv_u_per_g, stream);
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+}
+
+bool SparseMPDataDistributionOp::send_unique_keys(size_t peer, size_t num_keys,
+                                                  size_t num_unique_keys) const {
+  // The keys of this GPU never leave it, nothing is gained
+  if (!unique_storage_ || peer == static_cast<size_t>(core_->get_global_gpu_id())) return false;
+  size_t key_bytes = ebc_param_.key_type.size();
+  size_t offset_bytes = ebc_param_.offset_type.size();
+  return num_unique_keys * key_bytes + num_keys * offset_bytes < num_keys * key_bytes;
+}
+
 void SparseMPDataDistributionOp::filter_after_all2all(embedding::EmbeddingInput& output,
                                                       cudaStream_t stream) {
   // --- computes bucket ranges received from nccl
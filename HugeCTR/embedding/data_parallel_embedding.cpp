@@ -144,6 +144,11 @@ UniformDPEmbedding::UniformDPEmbedding(std::shared_ptr<CoreResourceManager> core
   dp_model_forward_ = DPModelForward(core_);
 
   allreduce_comm_ = NcclAllReduceInplaceComm(core_);
+  if (meta_.allreduce_strategy_ == AllreduceStrategy::Sparse) {
+    sparse_allreduce_ =
+        SparseAllreduce(core_, meta_.max_ev_size_,
+                        meta_.num_local_hotness_ * (universal_batch_size / num_gpus));
+  }
   if (std::find(meta_.h_local_combiner_list_.begin(), meta_.h_local_combiner_list_.end(),
                 static_cast<char>(Combiner::Average)) != meta_.h_local_combiner_list_.end()) {
     average_combiner_ = AverageCombiner(core, num_gpus, meta_.num_local_lookup_,
@@ -192,16 +197,18 @@ UniformDPEmbedding::UniformDPEmbedding(std::shared_ptr<CoreResourceManager> core
   local_reduce_index_calculation_ = {core, local_reduce_index_calculation, sort_op, cal_dst_ids,
                                      segmented_unique};
   local_reduce_.init(core, meta_.max_ev_size_,
-                     meta_.num_local_hotness_ * (params.universal_batch_size / num_gpus));
+                     meta_.num_local_hotness_ * (params.universal_batch_size / num_gpus),
+                     params.deterministic_);
 }
 
 void UniformDPEmbedding::backward_index_calculation(const EmbeddingInput& embedding_input,
                                                     Wgrad& wgrad, int batch_size) {
   int num_gpus = core_->get_global_gpu_count();
   local_reduce_buffer_.data = wgrad.data;
-  local_reduce_index_calculation_.cal_for_sparse_indices(embedding_input, wgrad.ev_start_indices,
-                                                         reduction_indices_, local_reduce_buffer_,
-                                                         batch_size / num_gpus);
+  // The wgrad may be narrowed to the touched rows by the sparse allreduce
+  local_reduce_index_calculation_.cal_for_sparse_indices(
+      embedding_input, sparse_allreduce_.dense_ev_start_indices(wgrad), reduction_indices_,
+      local_reduce_buffer_, batch_size / num_gpus);
 }
 
 void UniformDPEmbedding::forward(const EmbeddingInput& embedding_input, ILookup* embedding_table,
@@ -279,6 +286,8 @@ void UniformDPEmbedding::backward_per_gpu(Stage stage, const EmbeddingInput& emb
     case Stage::DPAllreduce: {
       if (meta_.allreduce_strategy_ == AllreduceStrategy::Dense) {
         dense_allreduce(wgrad, batch_size);
+      } else if (meta_.allreduce_strategy_ == AllreduceStrategy::Sparse) {
+        sparse_allreduce_.allreduce(local_reduce_buffer_, wgrad, allreduce_comm_);
       }
     } break;
     default:
@@ -22,6 +22,7 @@
 #include <embedding/operators/dp_index_calculation.hpp>
 #include <embedding/operators/model_backward.hpp>
 #include <embedding/operators/model_forward.hpp>
+#include <embedding/operators/sparse_allreduce.hpp>
 
 namespace embedding {
 
@@ -77,6 +78,7 @@ class UniformDPEmbedding : public IGroupedEmbeddingOp {
   AverageCombiner average_combiner_;
 
   NcclAllReduceInplaceComm allreduce_comm_;
+  SparseAllreduce sparse_allreduce_;
 
   core23::Tensor embedding_vec_;
 
@@ -121,7 +121,7 @@ DenseUniformModelParallelEmbeddingMeta::DenseUniformModelParallelEmbeddingMeta(
 
 DenseUniformModelParallelEmbedding::DenseUniformModelParallelEmbedding(
     std::shared_ptr<CoreResourceManager> core, const EmbeddingCollectionParam &params,
-    size_t grouped_id)
+    size_t grouped_id, const std::vector<int> &table_id_to_vocabulary_size)
     : core_(core), meta_(core, params, grouped_id) {
   HugeCTR::CudaDeviceContext context(core_->get_device_id());
 
@@ -129,6 +129,8 @@ DenseUniformModelParallelEmbedding::DenseUniformModelParallelEmbedding(
   all2all_comm_ = NcclAll2AllComm(core);
   network_forward_ = NetworkForward(core);
   network_backward_ = NetworkBackward(core);
+  hot_rows_allreduce_ =
+      HotRowsAllreduce(core, params, grouped_id, meta_.ev_size_, table_id_to_vocabulary_size);
 
   local_reduce_index_calculation_.init(core);
 
@@ -198,6 +200,7 @@ void DenseUniformModelParallelEmbedding::local_reduce(Wgrad &wgrad, int batch_si
   HugeCTR::CudaDeviceContext context(core_->get_device_id());
 
   local_reduce_.local_reduce(reduction_indices_, model_comm_buffer_, wgrad);
+  hot_rows_allreduce_.allreduce(wgrad);
 }
 
 void DenseUniformModelParallelEmbedding::forward_per_gpu(Stage stage,
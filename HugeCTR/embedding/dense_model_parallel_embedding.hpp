@@ -19,6 +19,7 @@
 #include <embedding/embedding.hpp>
 #include <embedding/operators/communication.hpp>
 #include <embedding/operators/compress_offset.hpp>
+#include <embedding/operators/hot_rows_allreduce.hpp>
 #include <embedding/operators/index_calculation.hpp>
 #include <embedding/operators/model_backward.hpp>
 #include <embedding/operators/model_forward.hpp>
@@ -70,6 +71,7 @@ class DenseUniformModelParallelEmbedding : public IGroupedEmbeddingOp {
   NetworkForward network_forward_;
 
   NetworkBackward network_backward_;
+  HotRowsAllreduce hot_rows_allreduce_;
 
   core23::Tensor embedding_vec_;
 
@@ -92,7 +94,8 @@ class DenseUniformModelParallelEmbedding : public IGroupedEmbeddingOp {
 
  public:
   DenseUniformModelParallelEmbedding(std::shared_ptr<CoreResourceManager> core,
-                                     const EmbeddingCollectionParam &params, size_t grouped_id);
+                                     const EmbeddingCollectionParam &params, size_t grouped_id,
+                                     const std::vector<int> &table_id_to_vocabulary_size);
 
   void forward_per_gpu(Stage stage, const EmbeddingInput &embedding_input, ILookup *embedding_table,
                        EmbeddingOutput &embedding_output, int batch_size) override;
@@ -21,8 +21,61 @@
 #include <embedding/model_parallel_embedding.hpp>
 namespace embedding {
 
+const char *stage_name(Stage stage) {
+  switch (stage) {
+    case Stage::DPForward:
+      return "DPForward";
+    case Stage::DPBackwardIndexCalculation:
+      return "DPBackwardIndexCalculation";
+    case Stage::DPLocalReduce:
+      return "DPLocalReduce";
+    case Stage::DPAllreduce:
+      return "DPAllreduce";
+    case Stage::DenseDPForward:
+      return "DenseDPForward";
+    case Stage::DenseDPBackwardIndexCalculation:
+      return "DenseDPBackwardIndexCalculation";
+    case Stage::DenseDPLocalReduce:
+      return "DenseDPLocalReduce";
+    case Stage::DenseDPAllReduce:
+      return "DenseDPAllReduce";
+    case Stage::HierMPModelForward:
+      return "HierMPModelForward";
+    case Stage::HierMPNetworkForward:
+      return "HierMPNetworkForward";
+    case Stage::HierMPBackwardIndexCalculation:
+      return "HierMPBackwardIndexCalculation";
+    case Stage::HierMPNetworkBackward:
+      return "HierMPNetworkBackward";
+    case Stage::HierMPLocalReduce:
+      return "HierMPLocalReduce";
+    case Stage::MPModelForward:
+      return "MPModelForward";
+    case Stage::MPNetworkdForward:
+      return "MPNetworkForward";
+    case Stage::MPBackwardIndexCalculation:
+      return "MPBackwardIndexCalculation";
+    case Stage::MPNetworkBackward:
+      return "MPNetworkBackward";
+    case Stage::MPLocalReduce:
+      return "MPLocalReduce";
+    case Stage::DenseMPModelForward:
+      return "DenseMPModelForward";
+    case Stage::DenseMPNetworkForward:
+      return "DenseMPNetworkForward";
+    case Stage::DenseMPBackwardIndexCalculation:
+      return "DenseMPBackwardIndexCalculation";
+    case Stage::DenseMPNetworkBackward:
+      return "DenseMPNetworkBackward";
+    case Stage::DenseMPLocalReduce:
+      return "DenseMPLocalReduce";
+  }
+  return "UnknownStage";
+}
+
 std::vector<std::unique_ptr<IGroupedEmbeddingOp>> create_grouped_embeddings(
-    std::shared_ptr<CoreResourceManager> core, const EmbeddingCollectionParam &ebc_param) {
+    std::shared_ptr<CoreResourceManager> core, const EmbeddingCollectionParam &ebc_param,
+    const std::vector<int> &table_id_to_vocabulary_size) {
   std::vector<std::unique_ptr<IGroupedEmbeddingOp>> embeddings;
 
   for (size_t emb_id = 0; emb_id < ebc_param.grouped_lookup_params.size(); ++emb_id) {
@@ -31,8 +84,8 @@ std::vector<std::unique_ptr<IGroupedEmbeddingOp>> create_grouped_embeddings(
     auto comm_strategy = ebc_param.comm_strategy_;
 
     if (embedding_type == EmbeddingType::Dense && tps == TablePlacementStrategy::ModelParallel) {
-      embeddings.push_back(
-          std::make_unique<DenseUniformModelParallelEmbedding>(core, ebc_param, emb_id));
+      embeddings.push_back(std::make_unique<DenseUniformModelParallelEmbedding>(
+          core, ebc_param, emb_id, table_id_to_vocabulary_size));
     } else if (embedding_type == EmbeddingType::Sparse &&
                tps == TablePlacementStrategy::DataParallel) {
       embeddings.push_back(std::make_unique<UniformDPEmbedding>(core, ebc_param, emb_id));
@@ -50,6 +50,9 @@ enum class Stage {
   DenseMPLocalReduce,
 };
 
+// Name of the stage, as shown on the NVTX timeline
+const char *stage_name(Stage stage);
+
 class IGroupedEmbeddingOp {
  public:
   virtual ~IGroupedEmbeddingOp() = default;
@@ -67,6 +70,7 @@ class IGroupedEmbeddingOp {
 };
 
 std::vector<std::unique_ptr<IGroupedEmbeddingOp>> create_grouped_embeddings(
-    std::shared_ptr<CoreResourceManager> core, const EmbeddingCollectionParam &ebc_param);
+    std::shared_ptr<CoreResourceManager> core, const EmbeddingCollectionParam &ebc_param,
+    const std::vector<int> &table_id_to_vocabulary_size);
 
 }  // namespace embedding
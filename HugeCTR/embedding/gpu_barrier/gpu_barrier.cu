@@ -20,15 +20,31 @@
 namespace HugeCTR {
 namespace gpu_barrier {
 
+// Every flag owns a 128-byte line, so that the GPUs that signal a peer at the same time do not
+// write to the line it spins on
+constexpr size_t kFlagStride = 128 / sizeof(size_t);
+
+__device__ __forceinline__ size_t load_acquire(const size_t* flag) {
+  size_t value;
+  asm volatile("ld.acquire.sys.global.u64 %0, [%1];" : "=l"(value) : "l"(flag) : "memory");
+  return value;
+}
+
+__device__ __forceinline__ void store_release(size_t* flag, size_t value) {
+  asm volatile("st.release.sys.global.u64 [%0], %1;" ::"l"(flag), "l"(value) : "memory");
+}
+
+// Each GPU only spins on its own memory, and the peers write their flags into it over NVLink. The
+// release/acquire pair makes the writes of a GPU before the barrier visible to all peers after it.
 __device__ __forceinline__ void sync_all_gpus_func(size_t** d_rem_barrier_flags, size_t my_local_id,
                                                    size_t ndevs) {
-  size_t count = d_rem_barrier_flags[my_local_id][my_local_id];
+  size_t count = d_rem_barrier_flags[my_local_id][my_local_id * kFlagStride];
   size_t g_tid = blockIdx.x * blockDim.x + threadIdx.x;
+  // All threads read the count before the own flag is bumped
+  __syncthreads();
   if (g_tid < ndevs) {
-    volatile size_t* rem_flag = d_rem_barrier_flags[g_tid];
-    volatile size_t* my_flag = d_rem_barrier_flags[my_local_id];
-    rem_flag[my_local_id] = (count + 1);
-    while (my_flag[g_tid] < (count + 1)) {
+    store_release(d_rem_barrier_flags[g_tid] + my_local_id * kFlagStride, count + 1);
+    while (load_acquire(d_rem_barrier_flags[my_local_id] + g_tid * kFlagStride) < count + 1) {
     }
   }
   __syncthreads();
@@ -49,7 +65,7 @@ __global__ void sync_all_gpus_report_host_cuda(size_t** d_rem_barrier_flags, siz
   size_t g_tid = blockIdx.x * blockDim.x + threadIdx.x;
   sync_all_gpus_func(d_rem_barrier_flags, my_local_id, ndevs);
   if ((g_tid == 0) && (my_local_id == 0)) {
-    *h_report_ptr = *d_report_count;
+    store_release(h_report_ptr, *d_report_count);
   }
 }
 
@@ -64,7 +80,7 @@ __global__ void sync_all_gpus_report_host_and_inc_cuda(size_t** d_rem_barrier_fl
   size_t count = *d_report_count;
   sync_all_gpus_func(d_rem_barrier_flags, my_local_id, ndevs);
   if ((g_tid == 0) && (my_local_id == 0)) {
-    *h_report_ptr = count;
+    store_release(h_report_ptr, count);
   }
   if (g_tid == 0) {
     *d_report_count = (count + 1);
@@ -83,8 +99,8 @@ GPUBarrier::GPUBarrier(size_t num_gpus, const std::vector<int>& dev_list, bool e
 
   for (size_t g = 0; g < num_gpus_; g++) {
     HCTR_LIB_THROW(cudaSetDevice(dev_list_[g]));
-    HCTR_LIB_THROW(cudaMalloc(&d_barrier_flags_[g], num_gpus_ * sizeof(size_t)));
-    HCTR_LIB_THROW(cudaMemset(d_barrier_flags_[g], 0, num_gpus_ * sizeof(size_t)));
+    HCTR_LIB_THROW(cudaMalloc(&d_barrier_flags_[g], num_gpus_ * kFlagStride * sizeof(size_t)));
+    HCTR_LIB_THROW(cudaMemset(d_barrier_flags_[g], 0, num_gpus_ * kFlagStride * sizeof(size_t)));
   }
 
   for (size_t g = 0; g < num_gpus_; g++) {
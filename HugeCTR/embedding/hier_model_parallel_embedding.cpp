@@ -171,13 +171,18 @@ HierModelParallelEmbedding::HierModelParallelEmbedding(std::shared_ptr<CoreResou
                                        segmentd_unique, cal_dst_offset_mp);
 
   local_reduce_.init(core, meta_.output_attr.max_ev_size,
-                     meta_.num_local_hotness_ * params.universal_batch_size);
+                     meta_.num_local_hotness_ * params.universal_batch_size, params.deterministic_);
 
   embedding_vec_ = core23::init_tensor_list<float>(
       params.universal_batch_size * meta_.num_local_hotness_, core->get_device_id());
 
   model_comm_buffer_.init(core, meta_.model_buffer_attr, params.universal_batch_size);
   network_buffer_.init(core, meta_.hier_network_buffer_attr, params.universal_batch_size);
+  if (params.all2all_compression_ != All2AllCompression::None) {
+    compressed_all2all_comm_ =
+        CompressedHierAll2AllComm(core, params.all2all_compression_,
+                                  intra_reduction_buffer_.data_list, network_buffer_.data_list);
+  }
 }
 
 void HierModelParallelEmbedding::model_forward(const EmbeddingInput &embedding_input,
@@ -197,7 +202,12 @@ void HierModelParallelEmbedding::model_forward(const EmbeddingInput &embedding_i
 void HierModelParallelEmbedding::network_forward(const EmbeddingInput &embedding_input,
                                                  EmbeddingOutput &embedding_output,
                                                  int batch_size) {
-  all2all_comm_.hier_communicate(intra_reduction_buffer_.data_list, network_buffer_.data_list);
+  if (compressed_all2all_comm_.compression() != All2AllCompression::None) {
+    compressed_all2all_comm_.communicate(intra_reduction_buffer_.data_list,
+                                         network_buffer_.data_list);
+  } else {
+    all2all_comm_.hier_communicate(intra_reduction_buffer_.data_list, network_buffer_.data_list);
+  }
   network_forward_.sparse_forward(embedding_input.num_keys_per_bucket, network_buffer_,
                                   meta_.hier_network_indices, embedding_output, batch_size);
 }
@@ -213,7 +223,12 @@ void HierModelParallelEmbedding::network_backward(const EmbeddingOutput &top_gra
                                                   Wgrad &wgrad, int batch_size) {
   network_backward_.sparse_backward(embedding_input.num_keys_per_bucket, top_grad,
                                     meta_.hier_network_indices, network_buffer_, batch_size);
-  all2all_comm_.hier_communicate(network_buffer_.data_list, intra_reduction_buffer_.data_list);
+  if (compressed_all2all_comm_.compression() != All2AllCompression::None) {
+    compressed_all2all_comm_.communicate_with_error_feedback(network_buffer_.data_list,
+                                                             intra_reduction_buffer_.data_list);
+  } else {
+    all2all_comm_.hier_communicate(network_buffer_.data_list, intra_reduction_buffer_.data_list);
+  }
   gpu_barrier_->sync_all_gpus(core_->get_local_gpu()->get_stream(), core_->get_local_gpu_id());
   intra_model_backward_.backward(intra_model_comm_buffer_.attr, intra_reduction_buffer_,
                                  embedding_input, model_comm_buffer_, batch_size);
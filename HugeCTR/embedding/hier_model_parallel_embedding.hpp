@@ -19,6 +19,7 @@
 #include "common.hpp"
 #include "embedding.hpp"
 #include "model_parallel_embedding.hpp"
+#include "operators/compressed_communication.hpp"
 #include "operators/hier_model_backward.hpp"
 #include "operators/hier_model_forward.hpp"
 
@@ -65,6 +66,7 @@ class HierModelParallelEmbedding : public IGroupedEmbeddingOp {
   CompressOffset compress_offset_;
   IntraModelForward intra_model_forward_;
   NcclAll2AllComm all2all_comm_;
+  CompressedHierAll2AllComm compressed_all2all_comm_;
   NetworkForward network_forward_;
 
   NetworkBackward network_backward_;
@@ -172,6 +172,11 @@ UniformModelParallelEmbedding::UniformModelParallelEmbedding(
   compress_offset_ = CompressOffset(core, meta_.num_local_lookup_ + 1, params.offset_type);
   model_forward_ = ModelForward{core};
   all2all_comm_ = NcclAll2AllComm(core);
+  if (params.num_all2all_chunks_ > 1) {
+    chunked_all2all_comm_ = ChunkedAll2AllComm(core, params.num_all2all_chunks_);
+    model_comm_ev_sizes_.assign(core->get_global_gpu_count(),
+                                meta_.model_buffer_attr.h_id_to_ev_size);
+  }
   network_forward_ = NetworkForward(core);
   network_backward_ = NetworkBackward(core);
 
@@ -201,7 +206,7 @@ UniformModelParallelEmbedding::UniformModelParallelEmbedding(
   }
 
   local_reduce_.init(core, meta_.max_ev_size_,
-                     meta_.num_local_hotness_ * params.universal_batch_size);
+                     meta_.num_local_hotness_ * params.universal_batch_size, params.deterministic_);
 
   core23::Device device(core23::DeviceType::GPU, core->get_device_id());
   core23::TensorParams tensor_params = core23::TensorParams().device(device);
@@ -228,6 +233,18 @@ void UniformModelParallelEmbedding::model_forward(const EmbeddingInput &embeddin
 void UniformModelParallelEmbedding::network_forward(const EmbeddingInput &embedding_input,
                                                     EmbeddingOutput &embedding_output,
                                                     int batch_size) {
+  if (chunked_all2all_comm_.num_chunks() > 1) {
+    int batch_size_per_gpu = batch_size / static_cast<int>(core_->get_global_gpu_count());
+    chunked_all2all_comm_.communicate_then(
+        model_comm_buffer_.data_list, model_comm_ev_sizes_, network_buffer_.data_list,
+        network_buffer_.attr.h_id_to_ev_size_list, batch_size_per_gpu,
+        [&](int bid_begin, int bid_end) {
+          network_forward_.sparse_forward(embedding_input.num_keys_per_bucket, network_buffer_,
+                                          meta_.network_indices, embedding_output, batch_size,
+                                          bid_begin, bid_end);
+        });
+    return;
+  }
   all2all_comm_.communicate(model_comm_buffer_.data_list, network_buffer_.data_list);
   network_forward_.sparse_forward(embedding_input.num_keys_per_bucket, network_buffer_,
                                   meta_.network_indices, embedding_output, batch_size);
@@ -236,6 +253,18 @@ void UniformModelParallelEmbedding::network_forward(const EmbeddingInput &embedd
 void UniformModelParallelEmbedding::network_backward(const EmbeddingOutput &top_grad,
                                                      const EmbeddingInput &embedding_input,
                                                      Wgrad &wgrad, int batch_size) {
+  if (chunked_all2all_comm_.num_chunks() > 1) {
+    int batch_size_per_gpu = batch_size / static_cast<int>(core_->get_global_gpu_count());
+    chunked_all2all_comm_.communicate_after(
+        network_buffer_.data_list, network_buffer_.attr.h_id_to_ev_size_list,
+        model_comm_buffer_.data_list, model_comm_ev_sizes_, batch_size_per_gpu,
+        [&](int bid_begin, int bid_end) {
+          network_backward_.sparse_backward(embedding_input.num_keys_per_bucket, top_grad,
+                                            meta_.network_indices, network_buffer_, batch_size,
+                                            bid_begin, bid_end);
+        });
+    return;
+  }
   network_backward_.sparse_backward(embedding_input.num_keys_per_bucket, top_grad,
                                     meta_.network_indices, network_buffer_, batch_size);
 
@@ -92,6 +92,8 @@ class UniformModelParallelEmbedding : public IGroupedEmbeddingOp {
   CompressOffset compress_offset_;
   ModelForward model_forward_;
   NcclAll2AllComm all2all_comm_;
+  ChunkedAll2AllComm chunked_all2all_comm_;
+  std::vector<std::vector<int>> model_comm_ev_sizes_;  // Per peer, for chunked_all2all_comm_.
   NetworkForward network_forward_;
 
   NetworkBackward network_backward_;
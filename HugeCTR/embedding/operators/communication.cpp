@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <core23/instrumentation.hpp>
+#include <core23/macros.hpp>
 #include <core23/registry.hpp>
 #include <embedding/operators/communication.hpp>
 #include <utils.hpp>
@@ -27,6 +30,8 @@ ncclDataType_t get_nccl_dtype_from_tensor_scalar_type_core23(core23::ScalarType
       return ncclFloat32;
     case core23::ScalarType::Half:
       return ncclHalf;
+    case core23::ScalarType::BFloat16:
+      return ncclBfloat16;
     case core23::ScalarType::Int64:
       return ncclInt64;
     case core23::ScalarType::UInt64:
@@ -47,6 +52,80 @@ ncclDataType_t get_nccl_dtype_from_tensor_scalar_type_core23(core23::ScalarType
 }  // namespace HugeCTR
 
 namespace embedding {
+
+namespace {
+
+// Bytes sent to the other GPUs. A replayed CUDA graph does not pass through here, so the messages
+// posted during a capture are not counted.
+void count_sent_bytes(cudaStream_t stream, uint64_t num_bytes) {
+  cudaStreamCaptureStatus capture_status;
+  HCTR_LIB_THROW(cudaStreamIsCapturing(stream, &capture_status));
+  if (capture_status != cudaStreamCaptureStatusNone) return;
+  static auto& counter = HugeCTR::MetricsRegistry::get().counter("embedding_all2all_sent_bytes");
+  counter.add(num_bytes);
+}
+
+}  // namespace
+
+// ncclMemAlloc and ncclCommRegister came with NCCL 2.19.
+#if NCCL_VERSION_CODE >= NCCL_VERSION(2, 19, 0)
+#define HCTR_NCCL_USER_BUFFER_REGISTRATION
+#endif
+
+NcclRegisteredAllocator::NcclRegisteredAllocator(int device_id, ncclComm_t comm)
+    : device_id_(device_id), comm_(comm) {}
+
+void* NcclRegisteredAllocator::allocate(int64_t size, core23::CUDAStream) {
+  HugeCTR::CudaDeviceContext context(device_id_);
+  void* ptr = nullptr;
+#ifdef HCTR_NCCL_USER_BUFFER_REGISTRATION
+  HCTR_LIB_THROW(ncclMemAlloc(&ptr, size));
+  void* handle = nullptr;
+  HCTR_LIB_THROW(ncclCommRegister(comm_, ptr, size, &handle));
+  std::lock_guard<std::mutex> lock(mutex_);
+  ptr_to_handle_[ptr] = handle;
+#else
+  HCTR_LIB_THROW(cudaMalloc(&ptr, size));
+#endif
+  return ptr;
+}
+
+void NcclRegisteredAllocator::deallocate(void* ptr, core23::CUDAStream) {
+  HugeCTR::CudaDeviceContext context(device_id_);
+#ifdef HCTR_NCCL_USER_BUFFER_REGISTRATION
+  void* handle = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ptr_to_handle_.find(ptr);
+    HCTR_CHECK_HINT(it != ptr_to_handle_.end(), "The buffer was not allocated by this allocator.");
+    handle = it->second;
+    ptr_to_handle_.erase(it);
+  }
+  HCTR_LIB_THROW(ncclCommDeregister(comm_, handle));
+  HCTR_LIB_THROW(ncclMemFree(ptr));
+#else
+  HCTR_LIB_THROW(cudaFree(ptr));
+#endif
+}
+
+int64_t NcclRegisteredAllocator::default_alignment() const {
+  return HugeCTR::core23::kcudaAllocationAlignment;
+}
+
+core23::AllocatorParams get_comm_buffer_allocator_params(
+    std::shared_ptr<CoreResourceManager> core) {
+  core23::AllocatorParams allocator_params;
+  if (core->get_global_gpu_count() > 1) {
+    int device_id = core->get_device_id();
+    ncclComm_t comm = core->get_nccl();
+    allocator_params.custom_factory = [device_id, comm](const core23::AllocatorParams&,
+                                                        const core23::Device&) {
+      return std::unique_ptr<core23::Allocator>(new NcclRegisteredAllocator(device_id, comm));
+    };
+  }
+  return allocator_params;
+}
+
 NcclAll2AllComm::NcclAll2AllComm(std::shared_ptr<CoreResourceManager> core) : core_(core) {}
 
 void NcclAll2AllComm::communicate(const std::vector<core23::Tensor>& send_tensors,
@@ -57,6 +136,7 @@ void NcclAll2AllComm::communicate(const std::vector<core23::Tensor>& send_tensor
   HugeCTR::CudaDeviceContext ctx(device_id);
   HCTR_LIB_THROW(ncclGroupStart());
   int num_total_gpu = core_->get_global_gpu_count();
+  uint64_t sent_bytes = 0;
   for (int p = 0; p < num_total_gpu; ++p) {
     ncclDataType_t nccl_dtype =
         core23::get_nccl_dtype_from_tensor_scalar_type_core23(send_tensors[p].data_type().type());
@@ -64,8 +144,10 @@ void NcclAll2AllComm::communicate(const std::vector<core23::Tensor>& send_tensor
                             comm, core_->get_local_gpu()->get_stream()));
     HCTR_LIB_THROW(ncclRecv(recv_tensors[p].data(), recv_tensors[p].num_elements(), nccl_dtype, p,
                             comm, core_->get_local_gpu()->get_stream()));
+    if (p != core_->get_global_gpu_id()) sent_bytes += send_tensors[p].num_bytes();
   }
   HCTR_LIB_THROW(ncclGroupEnd());
+  count_sent_bytes(core_->get_local_gpu()->get_stream(), sent_bytes);
 }
 
 void NcclAll2AllComm::dense_communicate(const core23::Tensor& send_tensor,
@@ -87,6 +169,7 @@ void NcclAll2AllComm::dense_communicate(const core23::Tensor& send_tensor,
     HugeCTR::CudaDeviceContext ctx(device_id);
     HCTR_LIB_THROW(ncclGroupStart());
     int num_total_gpu = core_->get_global_gpu_count();
+    uint64_t sent_bytes = 0;
     for (int p = 0; p < num_total_gpu; ++p) {
       ncclDataType_t nccl_dtype =
           core23::get_nccl_dtype_from_tensor_scalar_type_core23(send_tensor.data_type().type());
@@ -96,8 +179,12 @@ void NcclAll2AllComm::dense_communicate(const core23::Tensor& send_tensor,
                               p, comm, core_->get_local_gpu()->get_stream()));
       send_offset += send_key_ptr[p] * length_per_key * data_size_type;
       recv_offset += recv_key_ptr[p] * length_per_key * data_size_type;
+      if (p != core_->get_global_gpu_id()) {
+        sent_bytes += send_key_ptr[p] * length_per_key * data_size_type;
+      }
     }
     HCTR_LIB_THROW(ncclGroupEnd());
+    count_sent_bytes(core_->get_local_gpu()->get_stream(), sent_bytes);
   });
 }
 
@@ -115,16 +202,145 @@ void NcclAll2AllComm::hier_communicate(const std::vector<core23::Tensor>& send_t
   HCTR_CHECK(send_tensors.size() == static_cast<size_t>(num_node));
   HCTR_CHECK(recv_tensors.size() == static_cast<size_t>(num_node));
 
+  int my_node_id = core_->get_global_gpu_id() / num_local_gpu;
+
+  // The buffers were already reduced within the node, so each GPU exchanges one message per
+  // remote node with the GPU of the same local id (its rail). The block of the own node is a
+  // device copy and the empty blocks, whose peer block is empty as well, are not posted.
+  if (send_tensors[my_node_id].num_bytes() > 0) {
+    HCTR_LIB_THROW(cudaMemcpyAsync(recv_tensors[my_node_id].data(), send_tensors[my_node_id].data(),
+                                   send_tensors[my_node_id].num_bytes(), cudaMemcpyDeviceToDevice,
+                                   stream));
+  }
   HCTR_LIB_THROW(ncclGroupStart());
+  uint64_t sent_bytes = 0;
   for (int node_id = 0; node_id < num_node; ++node_id) {
+    if (node_id == my_node_id) continue;
     ncclDataType_t nccl_dtype = core23::get_nccl_dtype_from_tensor_scalar_type_core23(
         send_tensors[node_id].data_type().type());
-    HCTR_LIB_THROW(ncclSend(send_tensors[node_id].data(), send_tensors[node_id].num_elements(),
-                            nccl_dtype, node_id * num_local_gpu + local_gpu_id, comm, stream));
-    HCTR_LIB_THROW(ncclRecv(recv_tensors[node_id].data(), recv_tensors[node_id].num_elements(),
-                            nccl_dtype, node_id * num_local_gpu + local_gpu_id, comm, stream));
+    int peer = node_id * num_local_gpu + local_gpu_id;
+    if (send_tensors[node_id].num_elements() > 0) {
+      HCTR_LIB_THROW(ncclSend(send_tensors[node_id].data(), send_tensors[node_id].num_elements(),
+                              nccl_dtype, peer, comm, stream));
+      sent_bytes += send_tensors[node_id].num_bytes();
+    }
+    if (recv_tensors[node_id].num_elements() > 0) {
+      HCTR_LIB_THROW(ncclRecv(recv_tensors[node_id].data(), recv_tensors[node_id].num_elements(),
+                              nccl_dtype, peer, comm, stream));
+    }
   }
   HCTR_LIB_THROW(ncclGroupEnd());
+  count_sent_bytes(stream, sent_bytes);
+}
+
+ChunkedAll2AllComm::ChunkedAll2AllComm(std::shared_ptr<CoreResourceManager> core, int num_chunks)
+    : core_(core),
+      num_chunks_(num_chunks),
+      comm_stream_([&core] {
+        HugeCTR::CudaDeviceContext ctx(core->get_device_id());
+        return core23::CUDAStream(cudaStreamNonBlocking);
+      }()) {
+  HCTR_CHECK_HINT(num_chunks_ >= 1, "num_chunks should be >= 1, got ", num_chunks_);
+  HugeCTR::CudaDeviceContext ctx(core_->get_device_id());
+
+  events_ = std::shared_ptr<std::vector<cudaEvent_t>>(
+      new std::vector<cudaEvent_t>(num_chunks_ + 1), [](std::vector<cudaEvent_t>* events) {
+        for (cudaEvent_t event : *events) {
+          cudaEventDestroy(event);
+        }
+        delete events;
+      });
+  for (cudaEvent_t& event : *events_) {
+    HCTR_LIB_THROW(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+  }
+}
+
+void ChunkedAll2AllComm::communicate_chunk(const std::vector<core23::Tensor>& send_tensors,
+                                           const std::vector<std::vector<int>>& send_ev_sizes,
+                                           std::vector<core23::Tensor>& recv_tensors,
+                                           const std::vector<std::vector<int>>& recv_ev_sizes,
+                                           int batch_size_per_gpu, int bid_begin, int bid_end) {
+  auto& comm = core_->get_nccl();
+  cudaStream_t stream = comm_stream_();
+  int64_t num_samples = bid_end - bid_begin;
+
+  // The samples of a chunk are contiguous within each lookup, so every lookup is one message.
+  auto post = [&](const core23::Tensor& tensor, const std::vector<int>& ev_sizes, int peer,
+                  bool send) {
+    ncclDataType_t nccl_dtype =
+        core23::get_nccl_dtype_from_tensor_scalar_type_core23(tensor.data_type().type());
+    char* ptr = static_cast<char*>(tensor.data());
+    int64_t data_size_type = tensor.data_type().size();
+    int64_t ev_start = 0;
+    for (int ev_size : ev_sizes) {
+      char* chunk_ptr =
+          ptr + (ev_start * batch_size_per_gpu + int64_t{bid_begin} * ev_size) * data_size_type;
+      if (send) {
+        HCTR_LIB_THROW(ncclSend(chunk_ptr, num_samples * ev_size, nccl_dtype, peer, comm, stream));
+      } else {
+        HCTR_LIB_THROW(ncclRecv(chunk_ptr, num_samples * ev_size, nccl_dtype, peer, comm, stream));
+      }
+      ev_start += ev_size;
+    }
+  };
+
+  HCTR_LIB_THROW(ncclGroupStart());
+  int num_total_gpu = core_->get_global_gpu_count();
+  for (int p = 0; p < num_total_gpu; ++p) {
+    post(send_tensors[p], send_ev_sizes[p], p, true);
+    post(recv_tensors[p], recv_ev_sizes[p], p, false);
+  }
+  HCTR_LIB_THROW(ncclGroupEnd());
+}
+
+void ChunkedAll2AllComm::communicate_then(
+    const std::vector<core23::Tensor>& send_tensors,
+    const std::vector<std::vector<int>>& send_ev_sizes, std::vector<core23::Tensor>& recv_tensors,
+    const std::vector<std::vector<int>>& recv_ev_sizes, int batch_size_per_gpu,
+    const std::function<void(int bid_begin, int bid_end)>& consume) {
+  HugeCTR::CudaDeviceContext ctx(core_->get_device_id());
+  cudaStream_t stream = core_->get_local_gpu()->get_stream();
+  auto& events = *events_;
+  int chunk_size = (batch_size_per_gpu + num_chunks_ - 1) / num_chunks_;
+
+  HCTR_LIB_THROW(cudaEventRecord(events[num_chunks_], stream));
+  HCTR_LIB_THROW(cudaStreamWaitEvent(comm_stream_(), events[num_chunks_]));
+  for (int chunk_id = 0; chunk_id < num_chunks_; ++chunk_id) {
+    int bid_begin = std::min(chunk_id * chunk_size, batch_size_per_gpu);
+    int bid_end = std::min(bid_begin + chunk_size, batch_size_per_gpu);
+    communicate_chunk(send_tensors, send_ev_sizes, recv_tensors, recv_ev_sizes,
+                      batch_size_per_gpu, bid_begin, bid_end);
+    HCTR_LIB_THROW(cudaEventRecord(events[chunk_id], comm_stream_()));
+  }
+  for (int chunk_id = 0; chunk_id < num_chunks_; ++chunk_id) {
+    int bid_begin = std::min(chunk_id * chunk_size, batch_size_per_gpu);
+    int bid_end = std::min(bid_begin + chunk_size, batch_size_per_gpu);
+    HCTR_LIB_THROW(cudaStreamWaitEvent(stream, events[chunk_id]));
+    consume(bid_begin, bid_end);
+  }
+}
+
+void ChunkedAll2AllComm::communicate_after(
+    const std::vector<core23::Tensor>& send_tensors,
+    const std::vector<std::vector<int>>& send_ev_sizes, std::vector<core23::Tensor>& recv_tensors,
+    const std::vector<std::vector<int>>& recv_ev_sizes, int batch_size_per_gpu,
+    const std::function<void(int bid_begin, int bid_end)>& produce) {
+  HugeCTR::CudaDeviceContext ctx(core_->get_device_id());
+  cudaStream_t stream = core_->get_local_gpu()->get_stream();
+  auto& events = *events_;
+  int chunk_size = (batch_size_per_gpu + num_chunks_ - 1) / num_chunks_;
+
+  for (int chunk_id = 0; chunk_id < num_chunks_; ++chunk_id) {
+    int bid_begin = std::min(chunk_id * chunk_size, batch_size_per_gpu);
+    int bid_end = std::min(bid_begin + chunk_size, batch_size_per_gpu);
+    produce(bid_begin, bid_end);
+    HCTR_LIB_THROW(cudaEventRecord(events[chunk_id], stream));
+    HCTR_LIB_THROW(cudaStreamWaitEvent(comm_stream_(), events[chunk_id]));
+    communicate_chunk(send_tensors, send_ev_sizes, recv_tensors, recv_ev_sizes,
+                      batch_size_per_gpu, bid_begin, bid_end);
+  }
+  HCTR_LIB_THROW(cudaEventRecord(events[num_chunks_], comm_stream_()));
+  HCTR_LIB_THROW(cudaStreamWaitEvent(stream, events[num_chunks_]));
 }
 
 NcclAllReduceInplaceComm::NcclAllReduceInplaceComm(std::shared_ptr<CoreResourceManager> core)
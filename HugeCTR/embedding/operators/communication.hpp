@@ -16,9 +16,16 @@
 #pragma once
 
 #include <core/core.hpp>
+#include <core23/allocator.hpp>
+#include <core23/allocator_params.hpp>
+#include <core23/cuda_stream.hpp>
 #include <core23/tensor.hpp>
 #include <core23/tensor_operations.hpp>
 #include <core23/tensor_params.hpp>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace HugeCTR {
 namespace core23 {
@@ -31,6 +38,33 @@ namespace embedding {
 namespace core23 = HugeCTR::core23;
 using core::CoreResourceManager;
 
+/**
+ * Serves the embedding communication buffers from ncclMemAlloc and registers them with the NCCL
+ * communicator of the GPU, so that the collectives on them can take the zero-copy and NVLS
+ * transports instead of staging through the NCCL internal buffers. The buffers are allocated once
+ * in the init() of their owner and reused by every iteration, so one registration each suffices.
+ *
+ * With NCCL older than 2.19 it falls back to plain cudaMalloc.
+ */
+class NcclRegisteredAllocator : public core23::Allocator {
+  int device_id_;
+  ncclComm_t comm_;
+  std::mutex mutex_;
+  std::unordered_map<void*, void*> ptr_to_handle_;
+
+ public:
+  NcclRegisteredAllocator(int device_id, ncclComm_t comm);
+
+  void* allocate(int64_t size, core23::CUDAStream stream) override;
+
+  void deallocate(void* ptr, core23::CUDAStream stream) override;
+
+  int64_t default_alignment() const override;
+};
+
+// The allocator params of the buffers that the all-to-all and all-reduce of `core` read or write.
+core23::AllocatorParams get_comm_buffer_allocator_params(std::shared_ptr<CoreResourceManager> core);
+
 class NcclAll2AllComm {
   std::shared_ptr<CoreResourceManager> core_;
 
@@ -50,6 +84,55 @@ class NcclAll2AllComm {
                         std::vector<core23::Tensor>& recv_tensors);
 };
 
+/**
+ * All-to-all of feature-major embedding buffers ([lookup][sample][ev]), split into `num_chunks`
+ * ranges of samples. The exchange runs on a side stream, so that the current stream can process
+ * one chunk while the next one is in flight.
+ *
+ * `*_ev_sizes[p]` lists the ev sizes of the lookups stored in `*_tensors[p]`, in buffer order.
+ */
+class ChunkedAll2AllComm {
+  std::shared_ptr<CoreResourceManager> core_;
+  int num_chunks_ = 1;
+  core23::CUDAStream comm_stream_;
+  std::shared_ptr<std::vector<cudaEvent_t>> events_;  // One per chunk + one to fork.
+
+  void communicate_chunk(const std::vector<core23::Tensor>& send_tensors,
+                         const std::vector<std::vector<int>>& send_ev_sizes,
+                         std::vector<core23::Tensor>& recv_tensors,
+                         const std::vector<std::vector<int>>& recv_ev_sizes,
+                         int batch_size_per_gpu, int bid_begin, int bid_end);
+
+ public:
+  ChunkedAll2AllComm() = default;
+
+  ChunkedAll2AllComm(std::shared_ptr<CoreResourceManager> core, int num_chunks);
+
+  int num_chunks() const { return num_chunks_; }
+
+  /**
+   * Exchanges the buffers and calls `consume(bid_begin, bid_end)` for each chunk. Work issued by
+   * `consume` on the current stream starts as soon as that chunk arrived.
+   */
+  void communicate_then(const std::vector<core23::Tensor>& send_tensors,
+                        const std::vector<std::vector<int>>& send_ev_sizes,
+                        std::vector<core23::Tensor>& recv_tensors,
+                        const std::vector<std::vector<int>>& recv_ev_sizes,
+                        int batch_size_per_gpu,
+                        const std::function<void(int bid_begin, int bid_end)>& consume);
+
+  /**
+   * Calls `produce(bid_begin, bid_end)` for each chunk and sends the chunk as soon as the work
+   * that `produce` issued on the current stream is done.
+   */
+  void communicate_after(const std::vector<core23::Tensor>& send_tensors,
+                         const std::vector<std::vector<int>>& send_ev_sizes,
+                         std::vector<core23::Tensor>& recv_tensors,
+                         const std::vector<std::vector<int>>& recv_ev_sizes,
+                         int batch_size_per_gpu,
+                         const std::function<void(int bid_begin, int bid_end)>& produce);
+};
+
 class NcclAllReduceInplaceComm {
   std::shared_ptr<CoreResourceManager> core_;
 
@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cuda_fp8.h>
+
+#include <algorithm>
+#include <embedding/operators/compressed_communication.hpp>
+#include <utils.hpp>
+
+namespace embedding {
+
+namespace {
+
+constexpr float FP8_E4M3_MAX = 448.f;
+constexpr int kGroupSize = CompressedHierAll2AllComm::fp8_group_size;
+
+__forceinline__ __device__ float to_float(float val) { return val; }
+__forceinline__ __device__ float to_float(__half val) { return __half2float(val); }
+
+template <typename emb_t>
+__forceinline__ __device__ emb_t from_float(float val);
+template <>
+__forceinline__ __device__ float from_float<float>(float val) {
+  return val;
+}
+template <>
+__forceinline__ __device__ __half from_float<__half>(float val) {
+  return __float2half(val);
+}
+
+template <typename emb_t>
+__global__ void compress_fp16_kernel(const emb_t *src, float *residual, __half *dst, int64_t n) {
+  for (int64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
+    float val = to_float(src[i]);
+    if (residual) val += residual[i];
+    __half q = __float2half(val);
+    dst[i] = q;
+    if (residual) residual[i] = val - __half2float(q);
+  }
+}
+
+template <typename emb_t>
+__global__ void decompress_fp16_kernel(const __half *src, emb_t *dst, int64_t n) {
+  for (int64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
+    dst[i] = from_float<emb_t>(__half2float(src[i]));
+  }
+}
+
+// One warp per group of kGroupSize elements.
+template <typename emb_t>
+__global__ void compress_fp8_kernel(const emb_t *src, float *residual, __nv_fp8_e4m3 *dst,
+                                    float *scales, int64_t n) {
+  constexpr int kElemsPerLane = kGroupSize / 32;
+  int lane = threadIdx.x % 32;
+  int64_t num_groups = (n + kGroupSize - 1) / kGroupSize;
+  int64_t num_warps = int64_t{gridDim.x} * blockDim.x / 32;
+
+  for (int64_t g = (int64_t{blockIdx.x} * blockDim.x + threadIdx.x) / 32; g < num_groups;
+       g += num_warps) {
+    float vals[kElemsPerLane];
+    float amax = 0.f;
+#pragma unroll
+    for (int k = 0; k < kElemsPerLane; ++k) {
+      int64_t i = g * kGroupSize + k * 32 + lane;
+      vals[k] = 0.f;
+      if (i < n) {
+        vals[k] = to_float(src[i]);
+        if (residual) vals[k] += residual[i];
+      }
+      amax = fmaxf(amax, fabsf(vals[k]));
+    }
+#pragma unroll
+    for (int mask = 16; mask > 0; mask >>= 1) {
+      amax = fmaxf(amax, __shfl_xor_sync(0xffffffff, amax, mask));
+    }
+    float scale = amax > 0.f ? amax / FP8_E4M3_MAX : 1.f;
+    if (lane == 0) scales[g] = scale;
+
+#pragma unroll
+    for (int k = 0; k < kElemsPerLane; ++k) {
+      int64_t i = g * kGroupSize + k * 32 + lane;
+      if (i < n) {
+        __nv_fp8_e4m3 q(vals[k] / scale);
+        dst[i] = q;
+        if (residual) residual[i] = vals[k] - static_cast<float>(q) * scale;
+      }
+    }
+  }
+}
+
+template <typename emb_t>
+__global__ void decompress_fp8_kernel(const __nv_fp8_e4m3 *src, const float *scales, emb_t *dst,
+                                      int64_t n) {
+  for (int64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
+    dst[i] = from_float<emb_t>(static_cast<float>(src[i]) * scales[i / kGroupSize]);
+  }
+}
+
+// FP8 payloads: [n x fp8][padding to 4 bytes][ceil(n / kGroupSize) x float scale].
+int64_t fp8_scale_offset(int64_t n) { return (n + 3) / 4 * 4; }
+
+int64_t payload_bytes(All2AllCompression compression, int64_t n) {
+  if (compression == All2AllCompression::FP16) {
+    return n * static_cast<int64_t>(sizeof(__half));
+  }
+  return fp8_scale_offset(n) +
+         (n + kGroupSize - 1) / kGroupSize * static_cast<int64_t>(sizeof(float));
+}
+
+}  // namespace
+
+CompressedHierAll2AllComm::CompressedHierAll2AllComm(
+    std::shared_ptr<CoreResourceManager> core, All2AllCompression compression,
+    const std::vector<core23::Tensor> &forward_send_tensors,
+    const std::vector<core23::Tensor> &forward_recv_tensors)
+    : core_(core), compression_(compression) {
+  HCTR_CHECK_HINT(compression_ != All2AllCompression::None,
+                  "CompressedHierAll2AllComm requires a compression");
+  HCTR_CHECK(forward_send_tensors.size() == forward_recv_tensors.size());
+  HugeCTR::CudaDeviceContext ctx(core_->get_device_id());
+  core23::Device device(core23::DeviceType::GPU, core_->get_device_id());
+
+  for (size_t node_id = 0; node_id < forward_send_tensors.size(); ++node_id) {
+    int64_t num_bytes =
+        std::max(payload_bytes(compression_, forward_send_tensors[node_id].num_elements()),
+                 payload_bytes(compression_, forward_recv_tensors[node_id].num_elements()));
+    auto params = core23::TensorParams()
+                      .shape({std::max<int64_t>(num_bytes, 1)})
+                      .data_type(core23::ScalarType::Char)
+                      .device(device);
+    send_payloads_.emplace_back(params);
+    recv_payloads_.emplace_back(params);
+  }
+}
+
+void CompressedHierAll2AllComm::communicate(const std::vector<core23::Tensor> &send_tensors,
+                                            std::vector<core23::Tensor> &recv_tensors,
+                                            bool error_feedback) {
+  HugeCTR::CudaDeviceContext ctx(core_->get_device_id());
+  auto &comm = core_->get_nccl();
+  auto stream = core_->get_local_gpu()->get_stream();
+
+  int num_total_gpu = core_->get_global_gpu_count();
+  int num_local_gpu = core_->get_local_gpu_count();
+  int local_gpu_id = core_->get_local_gpu_id();
+  int num_node = num_total_gpu / num_local_gpu;
+  HCTR_CHECK(send_tensors.size() == static_cast<size_t>(num_node));
+  HCTR_CHECK(recv_tensors.size() == static_cast<size_t>(num_node));
+  HCTR_CHECK(send_payloads_.size() == static_cast<size_t>(num_node));
+
+  if (error_feedback && residuals_.empty()) {
+    core23::Device device(core23::DeviceType::GPU, core_->get_device_id());
+    for (int node_id = 0; node_id < num_node; ++node_id) {
+      int64_t n = std::max<int64_t>(send_tensors[node_id].num_elements(), 1);
+      residuals_.emplace_back(
+          core23::TensorParams().shape({n}).data_type(core23::ScalarType::Float).device(device));
+      HCTR_LIB_THROW(cudaMemsetAsync(residuals_.back().data(), 0,
+                                     residuals_.back().num_bytes(), stream));
+    }
+  }
+
+  constexpr int block_size = 256;
+  int max_grid_size = core_->get_kernel_param().num_sms * 8;
+  auto grid_size = [&](int64_t num_threads) {
+    return static_cast<int>(
+        std::max<int64_t>(1, std::min<int64_t>((num_threads + block_size - 1) / block_size,
+                                               max_grid_size)));
+  };
+
+  for (int node_id = 0; node_id < num_node; ++node_id) {
+    const core23::Tensor &src = send_tensors[node_id];
+    int64_t n = src.num_elements();
+    float *residual = nullptr;
+    if (error_feedback) {
+      HCTR_CHECK(residuals_[node_id].num_elements() >= n);
+      residual = residuals_[node_id].data<float>();
+    }
+    char *payload = send_payloads_[node_id].data<char>();
+    DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(src.data_type().type(), emb_t, [&] {
+      if (compression_ == All2AllCompression::FP16) {
+        compress_fp16_kernel<<<grid_size(n), block_size, 0, stream>>>(
+            src.data<emb_t>(), residual, reinterpret_cast<__half *>(payload), n);
+      } else {
+        int64_t num_groups = (n + kGroupSize - 1) / kGroupSize;
+        compress_fp8_kernel<<<grid_size(num_groups * 32), block_size, 0, stream>>>(
+            src.data<emb_t>(), residual, reinterpret_cast<__nv_fp8_e4m3 *>(payload),
+            reinterpret_cast<float *>(payload + fp8_scale_offset(n)), n);
+      }
+    });
+  }
+
+  HCTR_LIB_THROW(ncclGroupStart());
+  for (int node_id = 0; node_id < num_node; ++node_id) {
+    int peer = node_id * num_local_gpu + local_gpu_id;
+    HCTR_LIB_THROW(ncclSend(send_payloads_[node_id].data(),
+                            payload_bytes(compression_, send_tensors[node_id].num_elements()),
+                            ncclChar, peer, comm, stream));
+    HCTR_LIB_THROW(ncclRecv(recv_payloads_[node_id].data(),
+                            payload_bytes(compression_, recv_tensors[node_id].num_elements()),
+                            ncclChar, peer, comm, stream));
+  }
+  HCTR_LIB_THROW(ncclGroupEnd());
+
+  for (int node_id = 0; node_id < num_node; ++node_id) {
+    core23::Tensor &dst = recv_tensors[node_id];
+    int64_t n = dst.num_elements();
+    const char *payload = recv_payloads_[node_id].data<char>();
+    DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(dst.data_type().type(), emb_t, [&] {
+      if (compression_ == All2AllCompression::FP16) {
+        decompress_fp16_kernel<<<grid_size(n), block_size, 0, stream>>>(
+            reinterpret_cast<const __half *>(payload), dst.data<emb_t>(), n);
+      } else {
+        decompress_fp8_kernel<<<grid_size(n), block_size, 0, stream>>>(
+            reinterpret_cast<const __nv_fp8_e4m3 *>(payload),
+            reinterpret_cast<const float *>(payload + fp8_scale_offset(n)), dst.data<emb_t>(), n);
+      }
+    });
+  }
+}
+
+}  // namespace embedding
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <embedding/common.hpp>
+#include <embedding/operators/communication.hpp>
+
+namespace embedding {
+
+/**
+ * Inter-node all-to-all of the hierarchical model parallel embedding with compressed payloads.
+ * Each buffer is quantized before it is sent and restored at the receiver:
+ *
+ * - `FP16`: Elements are sent as half.
+ * - `FP8`: Elements are sent as fp8 (e4m3) with one float scale per group of
+ *   `fp8_group_size` consecutive elements.
+ *
+ * `communicate_with_error_feedback` keeps the quantization error of every send buffer and adds it
+ * to the next payload, so that the rounding error of gradients does not accumulate over steps.
+ */
+class CompressedHierAll2AllComm {
+  std::shared_ptr<CoreResourceManager> core_;
+  All2AllCompression compression_ = All2AllCompression::None;
+
+  // Per node, sized for the larger direction.
+  std::vector<core23::Tensor> send_payloads_;
+  std::vector<core23::Tensor> recv_payloads_;
+  // Per node, allocated on first use.
+  std::vector<core23::Tensor> residuals_;
+
+  void communicate(const std::vector<core23::Tensor> &send_tensors,
+                   std::vector<core23::Tensor> &recv_tensors, bool error_feedback);
+
+ public:
+  static constexpr int fp8_group_size = 64;
+
+  CompressedHierAll2AllComm() = default;
+
+  /**
+   * @param forward_send_tensors Buffers sent in forward, per node.
+   * @param forward_recv_tensors Buffers received in forward (and sent in backward), per node.
+   */
+  CompressedHierAll2AllComm(std::shared_ptr<CoreResourceManager> core,
+                            All2AllCompression compression,
+                            const std::vector<core23::Tensor> &forward_send_tensors,
+                            const std::vector<core23::Tensor> &forward_recv_tensors);
+
+  All2AllCompression compression() const { return compression_; }
+
+  void communicate(const std::vector<core23::Tensor> &send_tensors,
+                   std::vector<core23::Tensor> &recv_tensors) {
+    communicate(send_tensors, recv_tensors, false);
+  }
+
+  void communicate_with_error_feedback(const std::vector<core23::Tensor> &send_tensors,
+                                       std::vector<core23::Tensor> &recv_tensors) {
+    communicate(send_tensors, recv_tensors, true);
+  }
+};
+
+}  // namespace embedding
@@ -17,6 +17,7 @@
 
 #include <embedding/common.hpp>
 #include <embedding/view.hpp>
+#include <utility>
 #include <utils.cuh>
 
 #define EV_NUM 32
@@ -315,6 +316,30 @@ inline void get_kernel_config_use_warp(const int num_sms, const int num_thread_p
   return;
 }
 
+// A multi to one descriptor with a get_sp_weight(i) member scales the i-th source ev by that
+// sparse weight, so the weighted lookups run the same pooling kernels as the unweighted ones.
+template <typename CopyDesc>
+HOST_DEVICE_INLINE constexpr auto has_sp_weight(int)
+    -> decltype(std::declval<CopyDesc &>().get_sp_weight(0), bool()) {
+  return true;
+}
+
+template <typename CopyDesc>
+HOST_DEVICE_INLINE constexpr bool has_sp_weight(long) {
+  return false;
+}
+
+template <typename CopyDesc>
+DEVICE_INLINE auto get_sp_weight(CopyDesc &copy_desc, int i, int)
+    -> decltype(copy_desc.get_sp_weight(i)) {
+  return copy_desc.get_sp_weight(i);
+}
+
+template <typename CopyDesc>
+DEVICE_INLINE float get_sp_weight(CopyDesc &copy_desc, int i, long) {
+  return 1.f;
+}
+
 template <typename CopyDesc, int kMaxElemPerThread>
 __global__ void multi_to_one_cta_per_ev_kernel(CopyDesc copy_desc) {
   using src_type = typename CopyDesc::SrcT;
@@ -324,7 +349,7 @@ __global__ void multi_to_one_cta_per_ev_kernel(CopyDesc copy_desc) {
 
   if (i_ev < copy_desc.num_vec_) {
     vec_length_type vec_length = copy_desc.get_vec_length(i_ev);
-    int average_pooling_factor = copy_desc.get_average_pooling_factor(i_ev);
+    float average_pooling_factor = copy_desc.get_average_pooling_factor(i_ev);
     dst_type *dst_ev = copy_desc.get_dst_ptr(i_ev);
 
     int start = copy_desc.get_offset(i_ev);
@@ -333,10 +358,12 @@ __global__ void multi_to_one_cta_per_ev_kernel(CopyDesc copy_desc) {
     float accum[kMaxElemPerThread] = {0.f};
     for (int r = 0; r < (end - start); ++r) {
       const src_type *src_ev = copy_desc.get_src_ptr(r + start);
+      const float weight = get_sp_weight(copy_desc, r + start, 0);
 #pragma unroll kMaxElemPerThread
       for (int i = 0; i < kMaxElemPerThread && blockDim.x * i + threadIdx.x < vec_length; ++i) {
-        accum[i] += HugeCTR::TypeConvertFunc<float, src_type>::convert(
+        float elem = HugeCTR::TypeConvertFunc<float, src_type>::convert(
             src_ev[blockDim.x * i + threadIdx.x]);
+        accum[i] += has_sp_weight<CopyDesc>(0) ? elem * weight : elem;
       }
     }
 #pragma unroll kMaxElemPerThread
@@ -411,45 +438,6 @@ __global__ void multi_to_one_warp_per_ev_vec4_kernel(CopyDesc copy_desc) {
   }
 }
 
-template <typename CopyDesc, int kMaxElemPerThread>
-__global__ void multi_to_one_weight_cta_per_ev_kernel(CopyDesc copy_desc) {
-  using src_type = typename CopyDesc::SrcT;
-  using dst_type = typename CopyDesc::DstT;
-  using vec_length_type = int;
-  int i_ev = blockIdx.x;
-
-  if (i_ev < copy_desc.num_vec_) {
-    vec_length_type vec_length = copy_desc.get_vec_length(i_ev);
-    float average_pooling_factor = copy_desc.get_average_pooling_factor(i_ev);
-    dst_type *dst_ev = copy_desc.get_dst_ptr(i_ev);
-
-    int start = copy_desc.get_offset(i_ev);
-    int end = copy_desc.get_offset(i_ev + 1);
-
-    float accum[kMaxElemPerThread] = {0.f};
-    for (int r = 0; r < (end - start); ++r) {
-      const src_type *src_ev = copy_desc.get_src_ptr(r + start);
-      const float weight = copy_desc.get_sp_weight(r + start);
-#pragma unroll kMaxElemPerThread
-      for (int i = 0; i < kMaxElemPerThread && blockDim.x * i + threadIdx.x < vec_length; ++i) {
-        accum[i] += HugeCTR::TypeConvertFunc<float, src_type>::convert(
-                        src_ev[blockDim.x * i + threadIdx.x]) /
-                    weight;
-      }
-    }
-#pragma unroll kMaxElemPerThread
-    for (int i = 0; i < kMaxElemPerThread; ++i) {
-      accum[i] /= average_pooling_factor;
-    }
-
-#pragma unroll kMaxElemPerThread
-    for (int i = 0; i < kMaxElemPerThread && blockDim.x * i + threadIdx.x < vec_length; ++i) {
-      dst_ev[blockDim.x * i + threadIdx.x] =
-          HugeCTR::TypeConvertFunc<dst_type, float>::convert(accum[i]);
-    }
-  }
-}
-
 template <typename CopyDesc, int kMaxElemPerThread>
 __global__ void multi_to_one_warp_per_ev_vec4_less_block_kernel(CopyDesc copy_desc) {
   using src_type = typename CopyDesc::SrcT;
@@ -501,210 +489,173 @@ __global__ void multi_to_one_warp_per_ev_vec4_less_block_kernel(CopyDesc copy_de
   }
 }
 
-template <typename CopyDesc, int kMaxElemPerThread>
-__global__ void one_to_one_atomic_vec4(CopyDesc copy_desc, int ev_length) {
+/**
+ * Load-balanced pooling for lookups whose hotness varies a lot within one launch. Bags are
+ * processed in tiles of kNumGroups bags per CTA. Every bag of a tile with at most
+ * 2 * kNumGroups keys is pooled by a group of kGroupSize lanes (several bags per warp for small
+ * ev sizes); the remaining long bags are then pooled one after the other by the whole CTA, keys
+ * being spread over all groups and the partial sums reduced in shared memory.
+ *
+ * With kEvSize > 0 all bags have exactly that ev size, which fills the group, so the loops are
+ * fully unrolled vec4 loads without bounds checks. With kSumOnly no bag is averaged. The keys of a
+ * weighted descriptor are scaled by their sparse weight as they are loaded.
+ */
+template <typename CopyDesc, int kGroupSize, int kMaxElemPerThread, int kEvSize = 0,
+          bool kSumOnly = false>
+__global__ void multi_to_one_load_balanced_vec4_kernel(CopyDesc copy_desc) {
   using src_type = typename CopyDesc::SrcT;
   using dst_type = typename CopyDesc::DstT;
+  using vec_length_type = int;
 
-  const int lane_id = threadIdx.x & 31;
-  const int warp_id = threadIdx.x >> 5;
-  const int warp_num = blockDim.x >> 5;
-  int local_sample_num = EV_NUM;
   constexpr int copy_width = 4;
   constexpr int kWarpSize = 32;
+  constexpr int kNumWarps = 8;
+  constexpr int kNumGroups = kNumWarps * kWarpSize / kGroupSize;
+  constexpr int kGroupElems = copy_width * kGroupSize * kMaxElemPerThread;
+  constexpr int kLongBagThreshold = 2 * kNumGroups;
+  constexpr bool kFixedEvSize = kEvSize > 0;
+  static_assert(!kFixedEvSize || kEvSize == kGroupElems, "kEvSize must fill the group exactly");
 
-  int global_index = EV_NUM * (blockIdx.x * warp_num + warp_id);
-  {
-    if (global_index >= copy_desc.num_vec()) return;
-    local_sample_num = local_sample_num < copy_desc.num_vec() - global_index
-                           ? local_sample_num
-                           : copy_desc.num_vec() - global_index;
-  }
-  for (int sp = 0; sp < local_sample_num; ++sp) {
-    const src_type *tmp_src = copy_desc.get_src_ptr(global_index);
-    dst_type *tmp_dst = copy_desc.get_dst_ptr(global_index);
-    int vec_length = copy_desc.get_vec_length(global_index);
-    for (int i = 0; i < kMaxElemPerThread && 4 * kWarpSize * i + 4 * lane_id < vec_length; ++i) {
-      Vec4T<float> src_elem;
-      // Vec4T<float> accum[kMaxElemPerThread];
-      int idx4 = 4 * kWarpSize * i + 4 * lane_id;
-      int n = min(vec_length - idx4, copy_width);
-      src_elem.load(tmp_src + idx4, n);
-      src_elem.atomic_store_accum(tmp_dst + idx4, n);
-    }
-    global_index++;
-  }
-  return;
-}
-
-template <typename CopyDesc, int kMaxElemPerThread>
-__global__ void multi_to_one_weight_warp_per_ev_vec4_kernel(CopyDesc copy_desc) {
-  using src_type = typename CopyDesc::SrcT;
-  using dst_type = typename CopyDesc::DstT;
-  using vec_length_type = int;
+  __shared__ __align__(16) float partial_sum[kNumGroups * kGroupElems];
 
-  constexpr int copy_width = 4;
-  constexpr int kWarpSize = 32;
+  const int group_id = (threadIdx.y * kWarpSize + threadIdx.x) / kGroupSize;
+  const int group_lane_id = threadIdx.x % kGroupSize;
+  const int tile_start = blockIdx.x * kNumGroups;
 
-  int lane_id = threadIdx.x;
-  int warp_id = threadIdx.y;
-  int i_ev = blockIdx.x * blockDim.y + warp_id;
+  // short bags, one group per bag
+  int i_ev = tile_start + group_id;
   if (i_ev < copy_desc.num_vec_) {
-    vec_length_type vec_length = copy_desc.get_vec_length(i_ev);
-    float average_pooling_factor = copy_desc.get_average_pooling_factor(i_ev);
-
     int start = copy_desc.get_offset(i_ev);
     int end = copy_desc.get_offset(i_ev + 1);
+    if (end - start <= kLongBagThreshold) {
+      vec_length_type vec_length = kFixedEvSize ? kEvSize : copy_desc.get_vec_length(i_ev);
+      float average_pooling_factor = kSumOnly ? 1 : copy_desc.get_average_pooling_factor(i_ev);
+      dst_type *dst_ev = copy_desc.get_dst_ptr(i_ev);
 
-    dst_type *dst_ev = copy_desc.get_dst_ptr(i_ev);
-
-    Vec4T<float> accum[kMaxElemPerThread];
-    int L = end - start;
-    for (int r = 0; r < L; r += kWarpSize) {
-      int l = r + lane_id < L ? start + r + lane_id : 0;
-
-      for (int j = 0; j < kWarpSize && r + j < L; ++j) {
-        int j_ev = __shfl_sync(0xFFFFFFFF, l, j);
-        const src_type *src_ev = copy_desc.get_src_ptr(j_ev);
-        const float weight = copy_desc.get_sp_weight(j_ev);
-
+      Vec4T<float> accum[kMaxElemPerThread];
+      for (int r = start; r < end; ++r) {
+        const src_type *src_ev = copy_desc.get_src_ptr(r);
+        const float weight = get_sp_weight(copy_desc, r, 0);
 #pragma unroll kMaxElemPerThread
-        for (int i = 0; i < kMaxElemPerThread && 4 * kWarpSize * i + 4 * lane_id < vec_length;
+        for (int i = 0;
+             i < kMaxElemPerThread &&
+             (kFixedEvSize || copy_width * (kGroupSize * i + group_lane_id) < vec_length);
              ++i) {
           Vec4T<src_type> src_elem;
-          int idx4 = 4 * kWarpSize * i + 4 * lane_id;
-          int n = min(vec_length - idx4, copy_width);
+          int idx4 = copy_width * (kGroupSize * i + group_lane_id);
+          int n = kFixedEvSize ? copy_width : min(vec_length - idx4, copy_width);
           src_elem.load(src_ev + idx4, n);
-          accum[i].accumulate_multiply(src_elem, weight);
+          if (has_sp_weight<CopyDesc>(0)) {
+            accum[i].accumulate_multiply(src_elem, weight);
+          } else {
+            accum[i].accumulate(src_elem);
+          }
         }
       }
-    }
 
 #pragma unroll kMaxElemPerThread
-    for (int i = 0; i < kMaxElemPerThread; ++i) {
-      accum[i].val.x /= average_pooling_factor;
-      accum[i].val.y /= average_pooling_factor;
-      accum[i].val.z /= average_pooling_factor;
-      accum[i].val.w /= average_pooling_factor;
-    }
-
-#pragma unroll kMaxElemPerThread
-    for (int i = 0; i < kMaxElemPerThread && 4 * kWarpSize * i + 4 * lane_id < vec_length; ++i) {
-      int idx4 = 4 * kWarpSize * i + 4 * lane_id;
-      int n = min(vec_length - idx4, copy_width);
-      accum[i].store(dst_ev + idx4, n);
+      for (int i = 0; i < kMaxElemPerThread &&
+                      (kFixedEvSize || copy_width * (kGroupSize * i + group_lane_id) < vec_length);
+           ++i) {
+        int idx4 = copy_width * (kGroupSize * i + group_lane_id);
+        int n = kFixedEvSize ? copy_width : min(vec_length - idx4, copy_width);
+        if (!kSumOnly) {
+          accum[i].val.x /= average_pooling_factor;
+          accum[i].val.y /= average_pooling_factor;
+          accum[i].val.z /= average_pooling_factor;
+          accum[i].val.w /= average_pooling_factor;
+        }
+        accum[i].store(dst_ev + idx4, n);
+      }
     }
   }
-}
-
-template <typename CopyDesc, int kMaxElemPerThread>
-__global__ void multi_to_one_weight_warp_per_ev_vec4_network_kernel(CopyDesc copy_desc) {
-  using src_type = typename CopyDesc::SrcT;
-  using dst_type = typename CopyDesc::DstT;
-  using vec_length_type = int;
-
-  constexpr int copy_width = 4;
-  constexpr int kWarpSize = 32;
-
-  int lane_id = threadIdx.x;
-  int warp_id = threadIdx.y;
-  int i_ev = blockIdx.x * blockDim.y + warp_id;
-  if (i_ev < copy_desc.num_vec_) {
-    vec_length_type vec_length = copy_desc.get_vec_length(i_ev);
-    float average_pooling_factor = copy_desc.get_average_pooling_factor(i_ev);
 
+  // long bags, the whole CTA per bag
+  int tile_end = min(tile_start + kNumGroups, static_cast<int>(copy_desc.num_vec_));
+  for (i_ev = tile_start; i_ev < tile_end; ++i_ev) {
     int start = copy_desc.get_offset(i_ev);
     int end = copy_desc.get_offset(i_ev + 1);
+    if (end - start <= kLongBagThreshold) continue;
 
-    dst_type *dst_ev = copy_desc.get_dst_ptr(i_ev);
-
+    vec_length_type vec_length = kFixedEvSize ? kEvSize : copy_desc.get_vec_length(i_ev);
     Vec4T<float> accum[kMaxElemPerThread];
-    int L = end - start;
-    for (int r = 0; r < L; r += kWarpSize) {
-      int l = r + lane_id < L ? start + r + lane_id : 0;
-
-      for (int j = 0; j < kWarpSize && r + j < L; ++j) {
-        int j_ev = __shfl_sync(0xFFFFFFFF, l, j);
-        const src_type *src_ev = copy_desc.get_src_ptr(j_ev);
-
+    for (int r = start + group_id; r < end; r += kNumGroups) {
+      const src_type *src_ev = copy_desc.get_src_ptr(r);
+      const float weight = get_sp_weight(copy_desc, r, 0);
 #pragma unroll kMaxElemPerThread
-        for (int i = 0; i < kMaxElemPerThread && 4 * kWarpSize * i + 4 * lane_id < vec_length;
-             ++i) {
-          Vec4T<src_type> src_elem;
-          int idx4 = 4 * kWarpSize * i + 4 * lane_id;
-          int n = min(vec_length - idx4, copy_width);
-          src_elem.load(src_ev + idx4, n);
+      for (int i = 0; i < kMaxElemPerThread &&
+                      (kFixedEvSize || copy_width * (kGroupSize * i + group_lane_id) < vec_length);
+           ++i) {
+        Vec4T<src_type> src_elem;
+        int idx4 = copy_width * (kGroupSize * i + group_lane_id);
+        int n = kFixedEvSize ? copy_width : min(vec_length - idx4, copy_width);
+        src_elem.load(src_ev + idx4, n);
+        if (has_sp_weight<CopyDesc>(0)) {
+          accum[i].accumulate_multiply(src_elem, weight);
+        } else {
           accum[i].accumulate(src_elem);
         }
       }
     }
-
 #pragma unroll kMaxElemPerThread
-    for (int i = 0; i < kMaxElemPerThread; ++i) {
-      accum[i].val.x /= average_pooling_factor;
-      accum[i].val.y /= average_pooling_factor;
-      accum[i].val.z /= average_pooling_factor;
-      accum[i].val.w /= average_pooling_factor;
+    for (int i = 0; i < kMaxElemPerThread &&
+                    (kFixedEvSize || copy_width * (kGroupSize * i + group_lane_id) < vec_length);
+         ++i) {
+      int idx4 = copy_width * (kGroupSize * i + group_lane_id);
+      int n = kFixedEvSize ? copy_width : min(vec_length - idx4, copy_width);
+      accum[i].store(partial_sum + group_id * kGroupElems + idx4, n);
     }
+    __syncthreads();
 
-#pragma unroll kMaxElemPerThread
-    for (int i = 0; i < kMaxElemPerThread && 4 * kWarpSize * i + 4 * lane_id < vec_length; ++i) {
-      int idx4 = 4 * kWarpSize * i + 4 * lane_id;
-      int n = min(vec_length - idx4, copy_width);
-      accum[i].store(dst_ev + idx4, n);
+    float average_pooling_factor = kSumOnly ? 1 : copy_desc.get_average_pooling_factor(i_ev);
+    dst_type *dst_ev = copy_desc.get_dst_ptr(i_ev);
+    for (int e = threadIdx.y * kWarpSize + threadIdx.x; e < vec_length;
+         e += kNumWarps * kWarpSize) {
+      float sum = 0.f;
+      for (int g = 0; g < kNumGroups; ++g) {
+        sum += partial_sum[g * kGroupElems + e];
+      }
+      if (!kSumOnly) sum /= average_pooling_factor;
+      dst_ev[e] = HugeCTR::TypeConvertFunc<dst_type, float>::convert(sum);
     }
+    __syncthreads();
   }
 }
 
 template <typename CopyDesc, int kMaxElemPerThread>
-__global__ void multi_to_one_weight_warp_per_ev_vec4_model_kernel(CopyDesc copy_desc) {
+__global__ void one_to_one_atomic_vec4(CopyDesc copy_desc, int ev_length) {
   using src_type = typename CopyDesc::SrcT;
   using dst_type = typename CopyDesc::DstT;
-  using vec_length_type = int;
 
+  const int lane_id = threadIdx.x & 31;
+  const int warp_id = threadIdx.x >> 5;
+  const int warp_num = blockDim.x >> 5;
+  int local_sample_num = EV_NUM;
   constexpr int copy_width = 4;
   constexpr int kWarpSize = 32;
 
-  int lane_id = threadIdx.x;
-  int warp_id = threadIdx.y;
-  int i_ev = blockIdx.x * blockDim.y + warp_id;
-  if (i_ev < copy_desc.num_vec_) {
-    vec_length_type vec_length = copy_desc.get_vec_length(i_ev);
-
-    int start = copy_desc.get_offset(i_ev);
-    int end = copy_desc.get_offset(i_ev + 1);
-
-    dst_type *dst_ev = copy_desc.get_dst_ptr(i_ev);
-
-    Vec4T<float> accum[kMaxElemPerThread];
-    int L = end - start;
-    for (int r = 0; r < L; r += kWarpSize) {
-      int l = r + lane_id < L ? start + r + lane_id : 0;
-
-      for (int j = 0; j < kWarpSize && r + j < L; ++j) {
-        int j_ev = __shfl_sync(0xFFFFFFFF, l, j);
-        const src_type *src_ev = copy_desc.get_src_ptr(j_ev);
-        const float weight = copy_desc.get_sp_weight(j_ev);
-
-#pragma unroll kMaxElemPerThread
-        for (int i = 0; i < kMaxElemPerThread && 4 * kWarpSize * i + 4 * lane_id < vec_length;
-             ++i) {
-          Vec4T<src_type> src_elem;
-          int idx4 = 4 * kWarpSize * i + 4 * lane_id;
-          int n = min(vec_length - idx4, copy_width);
-          src_elem.load(src_ev + idx4, n);
-          accum[i].accumulate_multiply(src_elem, weight);
-        }
-      }
-    }
-
-#pragma unroll kMaxElemPerThread
+  int global_index = EV_NUM * (blockIdx.x * warp_num + warp_id);
+  {
+    if (global_index >= copy_desc.num_vec()) return;
+    local_sample_num = local_sample_num < copy_desc.num_vec() - global_index
+                           ? local_sample_num
+                           : copy_desc.num_vec() - global_index;
+  }
+  for (int sp = 0; sp < local_sample_num; ++sp) {
+    const src_type *tmp_src = copy_desc.get_src_ptr(global_index);
+    dst_type *tmp_dst = copy_desc.get_dst_ptr(global_index);
+    int vec_length = copy_desc.get_vec_length(global_index);
     for (int i = 0; i < kMaxElemPerThread && 4 * kWarpSize * i + 4 * lane_id < vec_length; ++i) {
+      Vec4T<float> src_elem;
+      // Vec4T<float> accum[kMaxElemPerThread];
       int idx4 = 4 * kWarpSize * i + 4 * lane_id;
       int n = min(vec_length - idx4, copy_width);
-      accum[i].store(dst_ev + idx4, n);
+      src_elem.load(tmp_src + idx4, n);
+      src_elem.atomic_store_accum(tmp_dst + idx4, n);
     }
+    global_index++;
   }
+  return;
 }
 
 template <typename CopyDesc, int kMaxElemPerThread>
@@ -1065,7 +1016,7 @@ struct MultiToOne {
 
   HOST_DEVICE_INLINE int get_offset(int i) { return static_cast<int>(get_offset_(i)); }
   HOST_DEVICE_INLINE int get_vec_length(int i) { return get_vec_length_(i); }
-  HOST_DEVICE_INLINE int get_average_pooling_factor(int i) {
+  HOST_DEVICE_INLINE float get_average_pooling_factor(int i) {
     return get_average_pooling_factor_(i);
   }
   HOST_DEVICE_INLINE const SrcType *get_src_ptr(int i) { return get_src_tensor_(i); }
@@ -1339,24 +1290,67 @@ void copy_multi_to_one(CopyDesc copy_desc, const HugeCTR::core23::KernelParams &
 }
 
 template <typename CopyDesc>
-void copy_multi_to_one_weight(CopyDesc copy_desc, int max_ev_size, cudaStream_t stream) {
-  if (max_ev_size <= 128) {
-    int grid_size = (copy_desc.num_vec_ - 1) / 2 + 1;
-    dim3 block_size{32, 2};
-    multi_to_one_weight_warp_per_ev_vec4_kernel<CopyDesc, 1>
-        <<<grid_size, block_size, 0, stream>>>(copy_desc);
+void copy_multi_to_one_load_balanced(CopyDesc copy_desc, int max_ev_size, cudaStream_t stream) {
+  if (copy_desc.num_vec_ == 0) return;
+  // 8 warps per CTA, each CTA pools a tile of num_groups = 256 / kGroupSize bags
+  dim3 block_size{32, 8};
+  auto launch = [&](auto kernel, int num_groups) {
+    int grid_size = (copy_desc.num_vec_ - 1) / num_groups + 1;
+    kernel<<<grid_size, block_size, 0, stream>>>(copy_desc);
+  };
+  if (max_ev_size <= 16) {
+    launch(multi_to_one_load_balanced_vec4_kernel<CopyDesc, 4, 1>, 64);
+  } else if (max_ev_size <= 32) {
+    launch(multi_to_one_load_balanced_vec4_kernel<CopyDesc, 8, 1>, 32);
+  } else if (max_ev_size <= 64) {
+    launch(multi_to_one_load_balanced_vec4_kernel<CopyDesc, 16, 1>, 16);
+  } else if (max_ev_size <= 128) {
+    launch(multi_to_one_load_balanced_vec4_kernel<CopyDesc, 32, 1>, 8);
   } else if (max_ev_size <= 256) {
-    int grid_size = (copy_desc.num_vec_ - 1) / 2 + 1;
-    dim3 block_size{32, 2};
-    multi_to_one_weight_warp_per_ev_vec4_kernel<CopyDesc, 2>
-        <<<grid_size, block_size, 0, stream>>>(copy_desc);
-  } else if (max_ev_size <= 1024) {
-    multi_to_one_weight_cta_per_ev_kernel<CopyDesc, 1>
-        <<<copy_desc.num_vec_, max_ev_size, 0, stream>>>(copy_desc);
+    launch(multi_to_one_load_balanced_vec4_kernel<CopyDesc, 32, 2>, 8);
   } else {
-    HCTR_OWN_THROW(HugeCTR::Error_t::IllegalCall,
-                   "HugeCTR does not support emb vector size >= 4096");
+    copy_multi_to_one(copy_desc, max_ev_size, stream);
+  }
+}
+
+/**
+ * Pools with the load-balanced kernel specialized for \p ev_size , which all bags of \p copy_desc
+ * must have. \p sum_only tells that no bag is averaged.
+ *
+ * @return false if \p ev_size is not one of 8, 16, 32, 64, 128 and 256, in which case nothing is
+ * launched and the caller falls back to the generic kernels.
+ */
+template <typename CopyDesc>
+bool copy_multi_to_one_fixed_ev_size(CopyDesc copy_desc, int ev_size, bool sum_only,
+                                     cudaStream_t stream) {
+  if (copy_desc.num_vec_ == 0) return ev_size > 0;
+  dim3 block_size{32, 8};
+  auto launch = [&](auto kernel, int num_groups) {
+    int grid_size = (copy_desc.num_vec_ - 1) / num_groups + 1;
+    kernel<<<grid_size, block_size, 0, stream>>>(copy_desc);
+  };
+#define HCTR_LAUNCH_FIXED_EV_SIZE(EV_SIZE, GROUP_SIZE, ELEMS)                                   \
+  case EV_SIZE:                                                                                \
+    if (sum_only) {                                                                            \
+      launch(multi_to_one_load_balanced_vec4_kernel<CopyDesc, GROUP_SIZE, ELEMS, EV_SIZE, true>, \
+             256 / GROUP_SIZE);                                                                \
+    } else {                                                                                   \
+      launch(multi_to_one_load_balanced_vec4_kernel<CopyDesc, GROUP_SIZE, ELEMS, EV_SIZE, false>, \
+             256 / GROUP_SIZE);                                                                \
+    }                                                                                          \
+    return true;
+
+  switch (ev_size) {
+    HCTR_LAUNCH_FIXED_EV_SIZE(8, 2, 1)
+    HCTR_LAUNCH_FIXED_EV_SIZE(16, 4, 1)
+    HCTR_LAUNCH_FIXED_EV_SIZE(32, 8, 1)
+    HCTR_LAUNCH_FIXED_EV_SIZE(64, 16, 1)
+    HCTR_LAUNCH_FIXED_EV_SIZE(128, 32, 1)
+    HCTR_LAUNCH_FIXED_EV_SIZE(256, 32, 2)
+    default:
+      return false;
   }
+#undef HCTR_LAUNCH_FIXED_EV_SIZE
 }
 
 template <typename CopyDesc>
@@ -350,7 +350,8 @@ void IntraModelForward::intra_forward(const core23::Tensor &evs, const core23::T
           local_gpu_id,
           num_local_gpus,
       };
-      copy_multi_to_one(multi_to_one_desc, intra_model_comm_buffer.attr.max_ev_size, stream);
+      copy_multi_to_one_load_balanced(multi_to_one_desc, intra_model_comm_buffer.attr.max_ev_size,
+                                      stream);
     });
   });
 }
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <embedding/operators/hot_rows_allreduce.hpp>
+#include <embedding/operators/row_sharding.hpp>
+#include <utils.cuh>
+
+namespace embedding {
+
+namespace {
+
+template <typename key_t, typename wgrad_t>
+__global__ void scatter_hot_wgrad_kernel(const key_t *unique_keys, const uint64_t *num_unique_keys,
+                                         const int *wgrad_table_ids,
+                                         const uint32_t *ev_start_indices, const wgrad_t *wgrad,
+                                         const int *table_ids, const int64_t *replica_begin,
+                                         const int64_t *num_hot_rows_per_table,
+                                         const int64_t *slot_offsets, int num_tables,
+                                         int64_t num_hot_rows, int ev_size, float *buffer,
+                                         int *local_entries) {
+  uint64_t num_keys = num_unique_keys[0];
+  CUDA_1D_KERNEL_LOOP_T(uint64_t, i, num_keys) {
+    int table_id = wgrad_table_ids[i];
+    int64_t index = static_cast<int64_t>(unique_keys[i]);
+    for (int t = 0; t < num_tables; ++t) {
+      if (table_ids[t] != table_id) continue;
+      int64_t pos = index - replica_begin[t];
+      if (pos < 0 || pos >= num_hot_rows_per_table[t]) break;
+
+      int64_t slot = slot_offsets[t] + pos;
+      const wgrad_t *src = wgrad + ev_start_indices[i];
+      for (int j = 0; j < ev_size; ++j) {
+        buffer[slot * ev_size + j] = HugeCTR::TypeConvertFunc<float, wgrad_t>::convert(src[j]);
+      }
+      buffer[num_hot_rows * ev_size + slot] = 1.f;
+      local_entries[slot] = static_cast<int>(i);
+      break;
+    }
+  }
+}
+
+template <typename key_t, typename wgrad_t>
+__global__ void gather_hot_wgrad_kernel(const float *buffer, const int *local_entries,
+                                        const int *slot_table_ids,
+                                        const int64_t *slot_replica_indices,
+                                        const int64_t *slot_owned_indices, int64_t num_hot_rows,
+                                        int ev_size, key_t *unique_keys, uint64_t *num_unique_keys,
+                                        int *wgrad_table_ids, uint32_t *ev_start_indices,
+                                        wgrad_t *wgrad) {
+  CUDA_1D_KERNEL_LOOP_T(int64_t, slot, num_hot_rows) {
+    if (buffer[num_hot_rows * ev_size + slot] == 0.f) continue;
+    const float *src = buffer + slot * ev_size;
+
+    auto write = [&](uint64_t entry) {
+      wgrad_t *dst = wgrad + entry * ev_size;
+      for (int j = 0; j < ev_size; ++j) {
+        dst[j] = HugeCTR::TypeConvertFunc<wgrad_t, float>::convert(src[j]);
+      }
+    };
+    auto append = [&](int64_t index) {
+      uint64_t entry = atomicAdd(reinterpret_cast<unsigned long long *>(num_unique_keys), 1ull);
+      unique_keys[entry] = static_cast<key_t>(index);
+      wgrad_table_ids[entry] = slot_table_ids[slot];
+      ev_start_indices[entry] = static_cast<uint32_t>(entry * ev_size);
+      write(entry);
+    };
+
+    if (local_entries[slot] >= 0) {
+      write(local_entries[slot]);
+    } else {
+      append(slot_replica_indices[slot]);
+    }
+    if (slot_owned_indices[slot] >= 0) {
+      append(slot_owned_indices[slot]);
+    }
+  }
+}
+
+}  // namespace
+
+HotRowsAllreduce::HotRowsAllreduce(std::shared_ptr<CoreResourceManager> core,
+                                   const EmbeddingCollectionParam &ebc_param, size_t grouped_id,
+                                   int ev_size, const std::vector<int> &table_id_to_vocabulary_size)
+    : core_(core), ev_size_(ev_size) {
+  HugeCTR::CudaDeviceContext context(core_->get_device_id());
+  int gpu_id = core_->get_global_gpu_id();
+  const auto &group_params = ebc_param.grouped_lookup_params[grouped_id];
+  const auto &grouped_table_param =
+      ebc_param.grouped_table_params[group_params.grouped_table_idx];
+
+  std::vector<int> lookup_table_ids;
+  for (int lookup_id : group_params.lookup_ids) {
+    lookup_table_ids.push_back(ebc_param.lookup_params[lookup_id].table_id);
+  }
+  bool has_hot_rows = false;
+  for (int table_id : grouped_table_param.table_ids) {
+    has_hot_rows |= ebc_param.get_table_num_hot_keys(table_id) > 0;
+  }
+  if (!has_hot_rows) return;
+
+  std::vector<int> h_table_ids;
+  std::vector<int64_t> h_replica_begin;
+  std::vector<int64_t> h_num_hot_rows_per_table;
+  std::vector<int64_t> h_slot_offsets;
+  std::vector<int> h_slot_table_ids;
+  std::vector<int64_t> h_slot_replica_indices;
+  std::vector<int64_t> h_slot_owned_indices;
+
+  // Same layout as RaggedStaticEmbeddingTable: [owned rows | replicated hot rows] per table.
+  int64_t table_begin = 0;
+  for (int table_id : grouped_table_param.table_ids) {
+    if (ebc_param.shard_matrix[gpu_id][table_id] == 0) continue;
+    int shard_id, num_shards;
+    ebc_param.get_table_shard_id(gpu_id, table_id, &shard_id, &num_shards);
+    const int64_t *row_offsets = ebc_param.get_table_shard_row_offsets(table_id);
+    int64_t vocabulary_size = table_id_to_vocabulary_size[table_id];
+    HCTR_CHECK_HINT(vocabulary_size > 0, "hybrid placement requires static tables.");
+    int64_t num_owned_rows = row_shard_num_rows(vocabulary_size, row_offsets, shard_id, num_shards);
+    int64_t num_hot_rows = ebc_param.get_table_num_hot_keys(table_id);
+
+    if (num_hot_rows > 0 && std::find(lookup_table_ids.begin(), lookup_table_ids.end(),
+                                      table_id) != lookup_table_ids.end()) {
+      h_table_ids.push_back(table_id);
+      h_replica_begin.push_back(table_begin + num_owned_rows);
+      h_num_hot_rows_per_table.push_back(num_hot_rows);
+      h_slot_offsets.push_back(num_hot_rows_);
+      num_hot_rows_ += num_hot_rows;
+
+      const auto &hot_keys = ebc_param.table_hot_keys_[table_id];
+      for (int64_t pos = 0; pos < num_hot_rows; ++pos) {
+        h_slot_table_ids.push_back(table_id);
+        h_slot_replica_indices.push_back(table_begin + num_owned_rows + pos);
+        bool is_owner = row_shard_id(hot_keys[pos], row_offsets, num_shards) == shard_id;
+        h_slot_owned_indices.push_back(
+            is_owner ? table_begin + static_cast<int64_t>(row_shard_local_index(
+                                         hot_keys[pos], row_offsets, shard_id, num_shards))
+                     : -1);
+      }
+    }
+    table_begin += num_owned_rows + num_hot_rows;
+  }
+  num_tables_ = static_cast<int>(h_table_ids.size());
+  if (num_hot_rows_ == 0) return;
+
+  core23::Device device(core23::DeviceType::GPU, core_->get_device_id());
+  core23::TensorParams params = core23::TensorParams().device(device);
+  auto make_tensor = [&](auto &h_vec, core23::ScalarType type) {
+    auto tensor =
+        core23::Tensor(params.shape({static_cast<int64_t>(h_vec.size())}).data_type(type));
+    core23::copy_sync(tensor, h_vec);
+    return tensor;
+  };
+  table_ids_ = make_tensor(h_table_ids, core23::ScalarType::Int32);
+  replica_begin_ = make_tensor(h_replica_begin, core23::ScalarType::Int64);
+  num_hot_rows_per_table_ = make_tensor(h_num_hot_rows_per_table, core23::ScalarType::Int64);
+  slot_offsets_ = make_tensor(h_slot_offsets, core23::ScalarType::Int64);
+  slot_table_ids_ = make_tensor(h_slot_table_ids, core23::ScalarType::Int32);
+  slot_replica_indices_ = make_tensor(h_slot_replica_indices, core23::ScalarType::Int64);
+  slot_owned_indices_ = make_tensor(h_slot_owned_indices, core23::ScalarType::Int64);
+
+  buffer_ = core23::Tensor(
+      params.shape({num_hot_rows_ * (ev_size_ + 1)}).data_type(core23::ScalarType::Float));
+  local_entries_ =
+      core23::Tensor(params.shape({num_hot_rows_}).data_type(core23::ScalarType::Int32));
+}
+
+void HotRowsAllreduce::allreduce(Wgrad &wgrad) {
+  if (empty()) return;
+  HugeCTR::CudaDeviceContext context(core_->get_device_id());
+  auto stream = core_->get_local_gpu()->get_stream();
+  auto &comm = core_->get_nccl();
+
+  HCTR_LIB_THROW(cudaMemsetAsync(buffer_.data(), 0, buffer_.num_bytes(), stream));
+  HCTR_LIB_THROW(cudaMemsetAsync(local_entries_.data(), 0xff, local_entries_.num_bytes(), stream));
+
+  constexpr int block_size = 256;
+  const int grid_size = core_->get_kernel_param().num_sms *
+                        core_->get_kernel_param().max_thread_per_block / block_size;
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(wgrad.unique_keys.data_type().type(), key_t, [&] {
+    DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(wgrad.data.data_type().type(), wgrad_t, [&] {
+      scatter_hot_wgrad_kernel<<<grid_size, block_size, 0, stream>>>(
+          wgrad.unique_keys.data<key_t>(), wgrad.num_unique_keys.data<uint64_t>(),
+          wgrad.table_ids.data<int>(), wgrad.ev_start_indices.data<uint32_t>(),
+          wgrad.data.data<wgrad_t>(), table_ids_.data<int>(), replica_begin_.data<int64_t>(),
+          num_hot_rows_per_table_.data<int64_t>(), slot_offsets_.data<int64_t>(), num_tables_,
+          num_hot_rows_, ev_size_, buffer_.data<float>(), local_entries_.data<int>());
+      HCTR_LIB_THROW(cudaPeekAtLastError());
+
+      HCTR_LIB_THROW(ncclAllReduce(buffer_.data(), buffer_.data(), buffer_.num_elements(),
+                                   ncclFloat32, ncclSum, comm, stream));
+
+      gather_hot_wgrad_kernel<<<grid_size, block_size, 0, stream>>>(
+          buffer_.data<float>(), local_entries_.data<int>(), slot_table_ids_.data<int>(),
+          slot_replica_indices_.data<int64_t>(), slot_owned_indices_.data<int64_t>(),
+          num_hot_rows_, ev_size_, wgrad.unique_keys.data<key_t>(),
+          wgrad.num_unique_keys.data<uint64_t>(), wgrad.table_ids.data<int>(),
+          wgrad.ev_start_indices.data<uint32_t>(), wgrad.data.data<wgrad_t>());
+      HCTR_LIB_THROW(cudaPeekAtLastError());
+    });
+  });
+}
+
+}  // namespace embedding
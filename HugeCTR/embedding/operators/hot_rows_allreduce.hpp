@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <core23/tensor.hpp>
+#include <embedding/common.hpp>
+
+namespace embedding {
+namespace core23 = HugeCTR::core23;
+using core::CoreResourceManager;
+
+/**
+ * Sums the gradients of the replicated hot rows of hybrid tables across all GPUs. Hot keys are
+ * looked up locally, so every GPU only holds the gradients of its own samples. After the
+ * allreduce, every replica that received a gradient anywhere is updated with the same sum, and so
+ * is the row of the owner, which keeps the dumped table in sync with the replicas.
+ */
+class HotRowsAllreduce {
+  std::shared_ptr<CoreResourceManager> core_;
+  int ev_size_ = 0;
+  int64_t num_hot_rows_ = 0;
+
+  // Per hybrid table of the group.
+  core23::Tensor table_ids_;
+  core23::Tensor replica_begin_;  // index of the first replicated row in the grouped table
+  core23::Tensor num_hot_rows_per_table_;
+  core23::Tensor slot_offsets_;  // of the table in the dense buffer
+  int num_tables_ = 0;
+
+  // Per hot row.
+  core23::Tensor slot_table_ids_;
+  core23::Tensor slot_replica_indices_;
+  core23::Tensor slot_owned_indices_;  // -1 if another GPU owns the key
+
+  core23::Tensor buffer_;         // float, num_hot_rows * ev_size gradients + num_hot_rows flags
+  core23::Tensor local_entries_;  // int, the wgrad entry of the replicated row or -1
+
+ public:
+  HotRowsAllreduce() = default;
+
+  HotRowsAllreduce(std::shared_ptr<CoreResourceManager> core,
+                   const EmbeddingCollectionParam &ebc_param, size_t grouped_id, int ev_size,
+                   const std::vector<int> &table_id_to_vocabulary_size);
+
+  bool empty() const { return num_hot_rows_ == 0; }
+
+  /**
+   * Allreduces the gradients of the hot rows in \p wgrad and appends the wgrad entries of the hot
+   * rows that did not receive a local gradient, as well as those of the owned rows.
+   */
+  void allreduce(Wgrad &wgrad);
+};
+
+}  // namespace embedding
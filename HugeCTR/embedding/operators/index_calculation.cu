@@ -602,8 +602,9 @@ __global__ void get_unique_key(const key_t *__restrict__ sorted_keys,
     }
   }
 
+  // key_num is only known here with sync_free_, and may be 0
   if (blockIdx.x * blockDim.x + threadIdx.x == 0) {
-    *unique_key_num = key_flag_buffer[key_num - 1];
+    *unique_key_num = key_num > 0 ? key_flag_buffer[key_num - 1] : 0;
   }
 }
 
@@ -625,8 +626,9 @@ __global__ void get_unique_key_same_ev_size(
     }
   }
 
+  // key_num is only known here with sync_free_, and may be 0
   if (blockIdx.x * blockDim.x + threadIdx.x == 0) {
-    *unique_key_num = key_flag_buffer[key_num - 1];
+    *unique_key_num = key_num > 0 ? key_flag_buffer[key_num - 1] : 0;
   }
 }
 
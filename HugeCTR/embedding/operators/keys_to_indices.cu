@@ -17,6 +17,7 @@
 #include <HugeCTR/include/utils.cuh>
 
 #include "keys_to_indices.hpp"
+#include "row_sharding.hpp"
 using namespace core;
 
 namespace embedding {
@@ -26,7 +27,10 @@ __global__ void keys_to_indices_kernel(key_t* keys, size_t num_keys,
                                        const int* table_id_list, const int* local_table_ids,
                                        int num_local_table_ids,
                                        const uint64_t* num_keys_per_table_offset,
-                                       const int* num_shards) {
+                                       const int* num_shards, const int* shard_ids,
+                                       const int64_t* row_offsets, const int* row_offsets_start,
+                                       const int64_t* hot_keys, const int* hot_keys_start,
+                                       const int* num_hot_keys) {
   CUDA_1D_KERNEL_LOOP_T(offset_t, tid, num_keys) {
     int table_id_idx = bs_upper_bound_sub_one(num_keys_per_lookup_offset, num_lookups + 1, tid);
 
@@ -36,7 +40,30 @@ __global__ void keys_to_indices_kernel(key_t* keys, size_t num_keys,
     uint64_t start = num_keys_per_table_offset[local_table_id_idx];
     key_t k = keys[tid];
 
-    uint64_t idx = k / (num_shards == nullptr ? 1 : num_shards[table_id]);
+    uint64_t idx = k;
+    if (num_shards != nullptr) {
+      int start_idx = row_offsets_start[table_id];
+      idx = row_shard_local_index(k, start_idx < 0 ? nullptr : row_offsets + start_idx,
+                                  shard_ids[table_id], num_shards[table_id]);
+    }
+    if (hot_keys != nullptr && hot_keys_start[table_id] >= 0) {
+      const int64_t* table_hot_keys = hot_keys + hot_keys_start[table_id];
+      int num_hot = num_hot_keys[table_id];
+      int lo = 0;
+      int hi = num_hot;
+      while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (table_hot_keys[mid] < static_cast<int64_t>(k)) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+      if (lo < num_hot && table_hot_keys[lo] == static_cast<int64_t>(k)) {
+        uint64_t end = num_keys_per_table_offset[local_table_id_idx + 1];
+        idx = end - start - num_hot + lo;
+      }
+    }
 
     keys[tid] = static_cast<key_t>(start + idx);
   }
@@ -64,6 +91,10 @@ KeysToIndicesConverter::KeysToIndicesConverter(std::shared_ptr<CoreResourceManag
   } else if (grouped_table_param.table_placement_strategy ==
              TablePlacementStrategy::ModelParallel) {
     h_num_shards_.resize(ebc_param.shard_matrix[0].size());
+    h_shard_ids_.resize(ebc_param.shard_matrix[0].size());
+    h_row_offsets_start_.assign(ebc_param.shard_matrix[0].size(), -1);
+    h_hot_keys_start_.assign(ebc_param.shard_matrix[0].size(), -1);
+    h_num_hot_keys_.assign(ebc_param.shard_matrix[0].size(), 0);
     for (int table_id : grouped_table_param.table_ids) {
       if (ebc_param.shard_matrix[global_gpu_id][table_id] == 0) continue;
       h_local_table_ids_.push_back(table_id);
@@ -84,10 +115,23 @@ KeysToIndicesConverter::KeysToIndicesConverter(std::shared_ptr<CoreResourceManag
       HCTR_CHECK(find_shard_id_iter != shard_gpu_list.end());
       int shard_id = static_cast<int>(std::distance(shard_gpu_list.begin(), find_shard_id_iter));
 
-      uint64_t num_keys =
-          table_params[table_id].max_vocabulary_size / num_shards +
-          (shard_id < table_params[table_id].max_vocabulary_size % num_shards ? 1 : 0);
-      h_num_keys_per_table_offset.push_back(num_keys);
+      h_shard_ids_[table_id] = shard_id;
+
+      const int64_t* row_offsets = ebc_param.get_table_shard_row_offsets(table_id);
+      if (row_offsets != nullptr) {
+        h_row_offsets_start_[table_id] = static_cast<int>(h_row_offsets_.size());
+        h_row_offsets_.insert(h_row_offsets_.end(), row_offsets, row_offsets + num_shards + 1);
+      }
+      uint64_t num_keys = row_shard_num_rows(table_params[table_id].max_vocabulary_size,
+                                             row_offsets, shard_id, num_shards);
+      int64_t num_hot_keys = ebc_param.get_table_num_hot_keys(table_id);
+      if (num_hot_keys > 0) {
+        h_hot_keys_start_[table_id] = static_cast<int>(h_hot_keys_.size());
+        h_num_hot_keys_[table_id] = static_cast<int>(num_hot_keys);
+        h_hot_keys_.insert(h_hot_keys_.end(), ebc_param.table_hot_keys_[table_id].begin(),
+                           ebc_param.table_hot_keys_[table_id].end());
+      }
+      h_num_keys_per_table_offset.push_back(num_keys + num_hot_keys);
     }
   } else {
     HCTR_OWN_THROW(HugeCTR::Error_t::UnspecificError,
@@ -114,6 +158,32 @@ KeysToIndicesConverter::KeysToIndicesConverter(std::shared_ptr<CoreResourceManag
         core23::Tensor(num_shards_params.shape({static_cast<int64_t>(h_num_shards_.size())})
                            .data_type(core23::ScalarType::Int32));
     core23::copy_sync(num_shards_, h_num_shards_);
+    shard_ids_ = core23::Tensor(num_shards_params.shape({static_cast<int64_t>(h_shard_ids_.size())})
+                                    .data_type(core23::ScalarType::Int32));
+    core23::copy_sync(shard_ids_, h_shard_ids_);
+    row_offsets_start_ =
+        core23::Tensor(num_shards_params.shape({static_cast<int64_t>(h_row_offsets_start_.size())})
+                           .data_type(core23::ScalarType::Int32));
+    core23::copy_sync(row_offsets_start_, h_row_offsets_start_);
+    if (!h_row_offsets_.empty()) {
+      row_offsets_ =
+          core23::Tensor(num_shards_params.shape({static_cast<int64_t>(h_row_offsets_.size())})
+                             .data_type(core23::ScalarType::Int64));
+      core23::copy_sync(row_offsets_, h_row_offsets_);
+    }
+    if (!h_hot_keys_.empty()) {
+      hot_keys_ = core23::Tensor(num_shards_params.shape({static_cast<int64_t>(h_hot_keys_.size())})
+                                     .data_type(core23::ScalarType::Int64));
+      core23::copy_sync(hot_keys_, h_hot_keys_);
+      hot_keys_start_ =
+          core23::Tensor(num_shards_params.shape({static_cast<int64_t>(h_hot_keys_start_.size())})
+                             .data_type(core23::ScalarType::Int32));
+      core23::copy_sync(hot_keys_start_, h_hot_keys_start_);
+      num_hot_keys_ =
+          core23::Tensor(num_shards_params.shape({static_cast<int64_t>(h_num_hot_keys_.size())})
+                             .data_type(core23::ScalarType::Int32));
+      core23::copy_sync(num_hot_keys_, h_num_hot_keys_);
+    }
   }
 }
 
@@ -134,7 +204,13 @@ void KeysToIndicesConverter::convert(core23::Tensor& keys, size_t num_keys,
           keys.data<key_t>(), num_keys, num_keys_per_lookup_offset.data<offset_t>(), num_lookups,
           table_id_list.data<int>(), local_table_ids_.data<int>(), local_table_ids_.num_elements(),
           num_keys_per_table_offset_.data<uint64_t>(),
-          !h_num_shards_.empty() ? num_shards_.data<int>() : nullptr);
+          !h_num_shards_.empty() ? num_shards_.data<int>() : nullptr,
+          !h_num_shards_.empty() ? shard_ids_.data<int>() : nullptr,
+          !h_row_offsets_.empty() ? row_offsets_.data<int64_t>() : nullptr,
+          !h_num_shards_.empty() ? row_offsets_start_.data<int>() : nullptr,
+          !h_hot_keys_.empty() ? hot_keys_.data<int64_t>() : nullptr,
+          !h_hot_keys_.empty() ? hot_keys_start_.data<int>() : nullptr,
+          !h_hot_keys_.empty() ? num_hot_keys_.data<int>() : nullptr);
     });
   });
 }
@@ -22,11 +22,26 @@ class KeysToIndicesConverter {
   std::shared_ptr<core::CoreResourceManager> core_;
 
   std::vector<int> h_num_shards_;
+  std::vector<int> h_shard_ids_;
   std::vector<int> h_local_table_ids_;
+  // Row offsets of the range sharded tables, and where they start per table (-1 = round robin).
+  std::vector<int64_t> h_row_offsets_;
+  std::vector<int> h_row_offsets_start_;
+  // Hot keys of the hybrid tables, and where they start per table (-1 = none). Their replicated
+  // rows follow the owned rows of the table.
+  std::vector<int64_t> h_hot_keys_;
+  std::vector<int> h_hot_keys_start_;
+  std::vector<int> h_num_hot_keys_;
 
   core23::Tensor num_keys_per_table_offset_;
   core23::Tensor local_table_ids_;
   core23::Tensor num_shards_;
+  core23::Tensor shard_ids_;
+  core23::Tensor row_offsets_;
+  core23::Tensor row_offsets_start_;
+  core23::Tensor hot_keys_;
+  core23::Tensor hot_keys_start_;
+  core23::Tensor num_hot_keys_;
 
  public:
   KeysToIndicesConverter(std::shared_ptr<CoreResourceManager> core,
@@ -64,7 +64,7 @@ __global__ void mp_cal_src_ptrs_same_ev_size(const T** src_ptr, const uint32_t*
 }
 
 void LocalReduce::init(std::shared_ptr<CoreResourceManager> core, int max_ev_size,
-                       size_t max_input_num) {
+                       size_t max_input_num, bool deterministic) {
   HugeCTR::CudaDeviceContext ctx(core->get_device_id());
 
   this->core_ = core;
@@ -115,6 +115,7 @@ void LocalReduce::init(std::shared_ptr<CoreResourceManager> core, int max_ev_siz
                          .device(device));
 
   this->partial_reduce_result_.max_input_num = max_input_num;
+  this->partial_reduce_result_.deterministic = deterministic;
 }
 
 void LocalReduce::local_reduce(const ReductionIndices& reduction_indices,
@@ -246,13 +247,16 @@ void dp_local_reduce_from_feature_major_top_grad(
   const int* dst_table_ids_ptr = wgrad.table_ids.data<int>();
   const uint32_t* dst_ev_start_indices_ptr = wgrad.ev_start_indices.data<uint32_t>();
   const uint32_t* dst_ids_ptr = reduction_indices.dst_ids.data<uint32_t>();
+  // The number of keys is read on the device, reduction_indices.num_elements is only an upper bound
+  // with sync_free_
+  const uint64_t* num_key_ptr = reduction_indices.num_key.data<uint64_t>();
 
   DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(src_buffer.attr.type.type(), emb_t, [&] {
     DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(wgrad.data.data_type().type(), grad_t, [&] {
       const emb_t* src_ptr = src_buffer.data.data<emb_t>();
       grad_t* dst_ptr = wgrad.data.data<grad_t>();
       auto multi_to_one_desc_first_stage = make_MultiToOne_reduce_new<emb_t, grad_t>(
-          [=] __device__() { return reduction_indices.num_elements; },
+          [=] __device__() { return static_cast<size_t>(*num_key_ptr); },
           [=] __device__(int i) { return src_id_to_ev_size_ptr[i]; },
           [=] __device__(int i) { return dst_ids_ptr[i]; },
 
@@ -303,6 +307,9 @@ void dp_local_reduce_from_batch_major_top_grad(
   const int* dst_table_ids_ptr = wgrad.table_ids.data<int>();
   const uint32_t* dst_ev_start_indices_ptr = wgrad.ev_start_indices.data<uint32_t>();
   const uint32_t* dst_ids_ptr = reduction_indices.dst_ids.data<uint32_t>();
+  // The number of keys is read on the device, reduction_indices.num_elements is only an upper bound
+  // with sync_free_
+  const uint64_t* num_key_ptr = reduction_indices.num_key.data<uint64_t>();
 
   DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(src_buffer.attr.type.type(), emb_t, [&] {
     DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(wgrad.data.data_type().type(), grad_t, [&] {
@@ -310,7 +317,7 @@ void dp_local_reduce_from_batch_major_top_grad(
 
       grad_t* dst_ptr = wgrad.data.data<grad_t>();
       auto multi_to_one_desc_first_stage = make_MultiToOne_reduce_new<emb_t, grad_t>(
-          [=] __device__() { return reduction_indices.num_elements; },
+          [=] __device__() { return static_cast<size_t>(*num_key_ptr); },
           [=] __device__(int i) { return src_id_to_ev_size_ptr[i]; },
           [=] __device__(int i) { return dst_ids_ptr[i]; },
           [=] __device__(int i) {
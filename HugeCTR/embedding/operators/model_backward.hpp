@@ -39,6 +39,8 @@ struct PartialReduceResult {
 
   core23::Tensor src_ptrs;
   size_t max_input_num;
+  // The partial results are reduced without atomics, see multi_to_one_reduce_final_deterministic.
+  bool deterministic = false;
 };
 
 class LocalReduce {
@@ -47,7 +49,8 @@ class LocalReduce {
   PartialReduceResult partial_reduce_result_;
 
  public:
-  void init(std::shared_ptr<CoreResourceManager> core, int max_ev_size, size_t max_input_num);
+  void init(std::shared_ptr<CoreResourceManager> core, int max_ev_size, size_t max_input_num,
+            bool deterministic = false);
 
   void local_reduce(const ReductionIndices &reduction_indices, const ModelCommBuffer &src_buffer,
                     Wgrad &wgrad, int batch_size);
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <embedding/operators/communication.hpp>
 #include <embedding/operators/generic_lookup.cuh>
 #include <embedding/operators/model_forward.hpp>
 #include <utils.cuh>
@@ -86,7 +87,13 @@ void dp_forward_to_feature_major_output(const core23::Tensor &lookup_res,
                                      embedding_output_attr.id_to_combiner.data<char>(),
                                      (const float **)lookup_res.data(),
                                      output_buffer.data<emb_t>()};
-          copy_multi_to_one(multi_to_one_desc, embedding_output_attr.max_ev_size, stream);
+          if (!copy_multi_to_one_fixed_ev_size(multi_to_one_desc,
+                                               embedding_output_attr.uniform_ev_size,
+                                               !embedding_output_attr.has_average_combiner,
+                                               stream)) {
+            copy_multi_to_one_load_balanced(multi_to_one_desc, embedding_output_attr.max_ev_size,
+                                            stream);
+          }
         });
       });
 }
@@ -138,7 +145,13 @@ void dp_forward_to_batch_major_output(const core23::Tensor &lookup_res,
                 return output_buffer_ptr + bid * dst_id_to_ev_start_indices_ptr[num_lookup] +
                        dst_id_to_ev_start_indices_ptr[lookup_id];
               });
-          copy_multi_to_one(multi_to_one_desc, embedding_output_attr.max_ev_size, stream);
+          if (!copy_multi_to_one_fixed_ev_size(multi_to_one_desc,
+                                               embedding_output_attr.uniform_ev_size,
+                                               !embedding_output_attr.has_average_combiner,
+                                               stream)) {
+            copy_multi_to_one_load_balanced(multi_to_one_desc, embedding_output_attr.max_ev_size,
+                                            stream);
+          }
         });
       });
 }
@@ -199,8 +212,12 @@ void ModelForward::sparse_forward(const core23::Tensor &mp_ev, const core23::Ten
                      batch_size_per_gpu * id_to_ev_start_indices_ptr[i_lookup] +
                      local_batch_id * ev_size;
             });
-        copy_multi_to_one(multi_to_one_desc, core_->get_kernel_param(),
-                          model_comm_buffer.attr.max_ev_size, stream);
+        if (!copy_multi_to_one_fixed_ev_size(multi_to_one_desc,
+                                             model_comm_buffer.attr.uniform_ev_size, true,
+                                             stream)) {
+          copy_multi_to_one_load_balanced(multi_to_one_desc, model_comm_buffer.attr.max_ev_size,
+                                          stream);
+        }
       });
     });
   }
@@ -289,6 +306,11 @@ void ModelCommBufferAttr::init(std::shared_ptr<CoreResourceManager> core,
   this->max_ev_size = h_id_to_ev_size.empty()
                           ? 0
                           : *std::max_element(h_id_to_ev_size.begin(), h_id_to_ev_size.end());
+  this->uniform_ev_size =
+      std::equal(h_id_to_ev_size.begin() + (h_id_to_ev_size.empty() ? 0 : 1),
+                 h_id_to_ev_size.end(), h_id_to_ev_size.begin())
+          ? this->max_ev_size
+          : 0;
   this->type = ebc_param.emb_type;
 }
 
@@ -328,7 +350,8 @@ void ModelCommBuffer::init(std::shared_ptr<CoreResourceManager> core,
                            const ModelCommBufferAttr &attr, int batch_size) {
   HugeCTR::CudaDeviceContext context(core->get_device_id());
   core23::Device device(core23::DeviceType::GPU, core->get_device_id());
-  core23::TensorParams params = core23::TensorParams().device(device);
+  core23::TensorParams params = core23::TensorParams().device(device).allocator_params(
+      get_comm_buffer_allocator_params(core));
 
   this->data_list.clear();
   for (int gpu_id = 0; gpu_id < attr.num_gpus; ++gpu_id) {
@@ -365,7 +388,8 @@ void DenseModelCommBuffer::init(std::shared_ptr<CoreResourceManager> core,
                                 const DenseModelCommBufferAttr &attr, int batch_size) {
   HugeCTR::CudaDeviceContext context(core->get_device_id());
   core23::Device device(core23::DeviceType::GPU, core->get_device_id());
-  core23::TensorParams params = core23::TensorParams().device(device);
+  core23::TensorParams params = core23::TensorParams().device(device).allocator_params(
+      get_comm_buffer_allocator_params(core));
   // FIX:when tensor dimension is , num local lookup is 0??
   // We can not create size 0 Tensor
   this->data = core23::Tensor(
@@ -46,6 +46,7 @@ struct ModelCommBufferAttr {
 
   EmbeddingLayout layout;
   int max_ev_size;
+  int uniform_ev_size;  // ev size of all lookups if they share one, 0 otherwise
   core23::DataType type;
 
   void init(std::shared_ptr<CoreResourceManager> core, const EmbeddingCollectionParam &ebc_param,
@@ -35,7 +35,11 @@ __global__ void multi_to_one_reduce_vec4_v2(CopyDesc copy_desc, float* partial_b
   constexpr int copy_width = 4;
   int global_index = EV_NUM * (blockIdx.x * warp_num + warp_id);
   {
-    if (global_index >= copy_desc.num_vec()) return;
+    // The grid may be sized for more keys than num_vec(), the second stage skips these warps
+    if (global_index >= copy_desc.num_vec()) {
+      if (lane_id == 0) partial_ev_length[blockIdx.x * warp_num + warp_id] = -1;
+      return;
+    }
     local_sample_num = local_sample_num < copy_desc.num_vec() - global_index
                            ? local_sample_num
                            : copy_desc.num_vec() - global_index;
@@ -244,13 +248,63 @@ __global__ void multi_to_one_reduce_final_v2(CopyDesc copy_desc, int local_sampl
   return;
 }
 
+// A deterministic replacement of multi_to_one_reduce_final_v2. The partial results of a
+// destination are consecutive, since the first stage reads the keys sorted by destination. The warp
+// of the first one adds all of them and the part the first stage stored, always in the same order,
+// so no two warps accumulate into the same destination.
+template <typename CopyDesc, int kMaxElemPerThread, int kWarpSize>
+__global__ void multi_to_one_reduce_final_deterministic(CopyDesc copy_desc) {
+  using src_type = typename CopyDesc::SrcT;
+  using dst_type = typename CopyDesc::DstT;
+
+  const int lane_id = threadIdx.x & 31;
+  const int warp_id = threadIdx.x >> 5;
+  const int warp_num = blockDim.x >> 5;
+  constexpr int copy_width = 4;
+  const int num_vec = copy_desc.num_vec();
+  for (int index = blockIdx.x * warp_num + warp_id; index < num_vec;
+       index += gridDim.x * warp_num) {
+    const int vec_length = copy_desc.get_src_vec_length(index);
+    if (vec_length == -1) continue;
+    const uint32_t dst_id = copy_desc.get_dst_id(index);
+    if (index > 0 && copy_desc.get_src_vec_length(index - 1) != -1 &&
+        copy_desc.get_dst_id(index - 1) == dst_id) {
+      continue;
+    }
+
+    Vec4T<float> accum[kMaxElemPerThread];
+    for (int next = index; next < num_vec && copy_desc.get_src_vec_length(next) != -1 &&
+                           copy_desc.get_dst_id(next) == dst_id;
+         ++next) {
+      const src_type* tmp_src = copy_desc.get_src_ptr(next);
+      for (int i = 0; i < kMaxElemPerThread && 4 * kWarpSize * i + 4 * lane_id < vec_length; ++i) {
+        Vec4T<src_type> src_elem;
+        int idx4 = 4 * kWarpSize * i + 4 * lane_id;
+        int n = min(vec_length - idx4, copy_width);
+        src_elem.load(tmp_src + idx4, n);
+        accum[i].accumulate(src_elem);
+      }
+    }
+
+    dst_type* tmp_dst = copy_desc.get_dst_ptr(index);
+    for (int i = 0; i < kMaxElemPerThread && 4 * kWarpSize * i + 4 * lane_id < vec_length; ++i) {
+      Vec4T<float> dst_elem;
+      int idx4 = 4 * kWarpSize * i + 4 * lane_id;
+      int n = min(vec_length - idx4, copy_width);
+      dst_elem.load(tmp_dst + idx4, n);
+      accum[i].accumulate(dst_elem);
+      accum[i].store(tmp_dst + idx4, n);
+    }
+  }
+}
+
 template <typename CopyDesc1, typename CopyDesc2, int kWarpSize = 32>
 void multi_to_one_reduce_v2(CopyDesc1 copy_desc1, CopyDesc2 copy_desc2,
                             const HugeCTR::core23::KernelParams& kernel_params,
                             float* partial_buffer, uint32_t* partial_dst_ids,
                             int32_t* partial_ev_length, int max_ev_length,
                             size_t first_stage_key_num, size_t second_stage_key_num,
-                            cudaStream_t stream) {
+                            cudaStream_t stream, bool deterministic = false) {
   int grid_size = (first_stage_key_num - 1) / WGRAD_REDUCE_BLOCK_SIZE + 1;
   int block_size = WGRAD_REDUCE_BLOCK_SIZE;
 
@@ -263,9 +317,14 @@ void multi_to_one_reduce_v2(CopyDesc1 copy_desc1, CopyDesc2 copy_desc2,
     get_kernel_config_use_warp(kernel_params.num_sms, kernel_params.max_thread_per_sm,
                                WGRAD_REDUCE_BLOCK_SIZE, kernel_params.warp_size,
                                second_stage_key_num, &second_grid_size, &second_local_sample, 1);
-    if (second_local_sample < 8) second_local_sample = 8;
-    multi_to_one_reduce_final_v2<CopyDesc2, 1, kWarpSize>
-        <<<second_grid_size, block_size, 0, stream>>>(copy_desc2, second_local_sample);
+    if (deterministic) {
+      multi_to_one_reduce_final_deterministic<CopyDesc2, 1, kWarpSize>
+          <<<second_grid_size, block_size, 0, stream>>>(copy_desc2);
+    } else {
+      if (second_local_sample < 8) second_local_sample = 8;
+      multi_to_one_reduce_final_v2<CopyDesc2, 1, kWarpSize>
+          <<<second_grid_size, block_size, 0, stream>>>(copy_desc2, second_local_sample);
+    }
 
     //} else {
     //  multi_to_one_reduce_final_v2<CopyDesc1, 1, kWarpSize>
@@ -282,9 +341,14 @@ void multi_to_one_reduce_v2(CopyDesc1 copy_desc1, CopyDesc2 copy_desc2,
     get_kernel_config_use_warp(kernel_params.num_sms, kernel_params.max_thread_per_sm,
                                WGRAD_REDUCE_BLOCK_SIZE, kernel_params.warp_size,
                                second_stage_key_num, &second_grid_size, &second_local_sample, 1);
-    if (second_local_sample < 8) second_local_sample = 8;
-    multi_to_one_reduce_final_v2<CopyDesc2, 2, kWarpSize>
-        <<<second_grid_size, block_size, 0, stream>>>(copy_desc2, second_local_sample);
+    if (deterministic) {
+      multi_to_one_reduce_final_deterministic<CopyDesc2, 2, kWarpSize>
+          <<<second_grid_size, block_size, 0, stream>>>(copy_desc2);
+    } else {
+      if (second_local_sample < 8) second_local_sample = 8;
+      multi_to_one_reduce_final_v2<CopyDesc2, 2, kWarpSize>
+          <<<second_grid_size, block_size, 0, stream>>>(copy_desc2, second_local_sample);
+    }
 
     //} else {
     //  multi_to_one_reduce_final_v2<CopyDesc1, 2, kWarpSize>
@@ -335,7 +399,7 @@ void multi_to_one_reduce_v2(CopyDesc1 multi_to_one_desc_first_stage,
     multi_to_one_reduce_v2(multi_to_one_desc_first_stage, multi_to_one_desc_second_stage,
                            kernel_params, partial_grad_ev_ptr, partial_dst_id_array_ptr,
                            partial_ev_length_ptr, max_ev_size, reduction_indices.num_elements,
-                           second_num, stream);
+                           second_num, stream, partial_reduce_result.deterministic);
   });
 }
 
@@ -30,7 +30,8 @@ void network_backward_from_feature_major_top_grad(const core23::Tensor& dp_num_k
                                                   const NetworkIndices& network_indices,
                                                   const HugeCTR::core23::KernelParams kernel_params,
                                                   NetworkBuffer& network_buffer, int batch_size,
-                                                  int gpu_id, int num_gpus, cudaStream_t stream) {
+                                                  int bid_begin, int bid_end, int gpu_id,
+                                                  int num_gpus, cudaStream_t stream) {
   auto& top_grad_attr = top_grad.attr;
   auto& network_attr = network_buffer.attr;
   int batch_size_per_gpu = batch_size / num_gpus;
@@ -51,16 +52,19 @@ void network_backward_from_feature_major_top_grad(const core23::Tensor& dp_num_k
         dst_emb_t** network_comm_buffer_ptr = (dst_emb_t**)network_buffer.data.data();
         const char* combiner_ptr = top_grad_attr.id_to_combiner.data<char>();
         int num_network_dst_lookup_ids = network_indices.network_dst_lookup_ids.num_elements();
+        int vec_offset = bid_begin * num_network_dst_lookup_ids;
 
         auto one_to_multi_desc = make_MultiToOne<emb_t, dst_emb_t>(
-            num_network_dst_lookup_ids * batch_size_per_gpu,
+            (bid_end - bid_begin) * num_network_dst_lookup_ids,
             [=] __device__(int i) {
+              i += vec_offset;
               int bid = i / num_network_dst_lookup_ids;
               int lookup_id = i % num_network_dst_lookup_ids;
               return bid * network_offsets_ptr[num_network_dst_lookup_ids] +
                      network_offsets_ptr[lookup_id];
             },
             [=] __device__(int i) {
+              i += vec_offset;
               int bid = i / num_network_dst_lookup_ids;
               int lookup_id = network_dst_lookup_ids_ptr[i % num_network_dst_lookup_ids];
 
@@ -72,10 +76,12 @@ void network_backward_from_feature_major_top_grad(const core23::Tensor& dp_num_k
               }
             },
             [=] __device__(int i) {
+              i += vec_offset;
               int dst_lookup_id = network_dst_lookup_ids_ptr[i % num_network_dst_lookup_ids];
               return d_ev_size_offset_ptr[dst_lookup_id + 1] - d_ev_size_offset_ptr[dst_lookup_id];
             },
             [=] __device__(int i) {
+              i += vec_offset;
               int bid = i / num_network_dst_lookup_ids;
               int lookup_id = network_dst_lookup_ids_ptr[i % num_network_dst_lookup_ids];
 
@@ -106,7 +112,8 @@ void network_backward_from_batch_major_top_grad(const core23::Tensor& dp_num_key
                                                 const NetworkIndices& network_indices,
                                                 const HugeCTR::core23::KernelParams kernel_params,
                                                 NetworkBuffer& network_buffer, int batch_size,
-                                                int gpu_id, int num_gpus, cudaStream_t stream) {
+                                                int bid_begin, int bid_end, int gpu_id,
+                                                int num_gpus, cudaStream_t stream) {
   auto& top_grad_attr = top_grad.attr;
   auto& network_attr = network_buffer.attr;
   int batch_size_per_gpu = batch_size / num_gpus;
@@ -128,16 +135,19 @@ void network_backward_from_batch_major_top_grad(const core23::Tensor& dp_num_key
         dst_emb_t** network_comm_buffer_ptr = (dst_emb_t**)network_buffer.data.data();
         const char* combiner_ptr = top_grad_attr.id_to_combiner.data<char>();
         int num_network_dst_lookup_ids = network_indices.network_dst_lookup_ids.num_elements();
+        int vec_offset = bid_begin * num_network_dst_lookup_ids;
 
         auto one_to_multi_desc = make_MultiToOne<emb_t, dst_emb_t>(
-            num_network_dst_lookup_ids * batch_size_per_gpu,
+            (bid_end - bid_begin) * num_network_dst_lookup_ids,
             [=] __device__(int i) {
+              i += vec_offset;
               int bid = i / num_network_dst_lookup_ids;
               int lookup_id = i % num_network_dst_lookup_ids;
               return bid * network_offsets_ptr[num_network_dst_lookup_ids] +
                      network_offsets_ptr[lookup_id];
             },
             [=] __device__(int i) {
+              i += vec_offset;
               int bid = i / num_network_dst_lookup_ids;
               int lookup_id = network_dst_lookup_ids_ptr[i % num_network_dst_lookup_ids];
 
@@ -149,10 +159,12 @@ void network_backward_from_batch_major_top_grad(const core23::Tensor& dp_num_key
               }
             },
             [=] __device__(int i) {
+              i += vec_offset;
               int dst_lookup_id = network_dst_lookup_ids_ptr[i % num_network_dst_lookup_ids];
               return d_ev_size_offset_ptr[dst_lookup_id + 1] - d_ev_size_offset_ptr[dst_lookup_id];
             },
             [=] __device__(int i) {
+              i += vec_offset;
               int bid = i / num_network_dst_lookup_ids;
               int lookup_id = network_dst_lookup_ids_ptr[i % num_network_dst_lookup_ids];
 
@@ -371,20 +383,30 @@ void NetworkBackward::sparse_backward(const core23::Tensor& dp_num_keys_per_buck
                                       const EmbeddingOutput& top_grad,
                                       const NetworkIndices& network_indices,
                                       NetworkBuffer& network_buffer, int batch_size) {
+  sparse_backward(dp_num_keys_per_bucket, top_grad, network_indices, network_buffer, batch_size, 0,
+                  batch_size / static_cast<int>(core_->get_global_gpu_count()));
+}
+
+void NetworkBackward::sparse_backward(const core23::Tensor& dp_num_keys_per_bucket,
+                                      const EmbeddingOutput& top_grad,
+                                      const NetworkIndices& network_indices,
+                                      NetworkBuffer& network_buffer, int batch_size, int bid_begin,
+                                      int bid_end) {
   HugeCTR::CudaDeviceContext ctx(core_->get_device_id());
   auto stream = core_->get_local_gpu()->get_stream();
   int gpu_id = core_->get_global_gpu_id();
   int num_gpus = core_->get_global_gpu_count();
+  if (bid_end <= bid_begin) return;
 
   if (top_grad.attr.layout == EmbeddingLayout::FeatureMajor) {
-    network_backward_from_feature_major_top_grad(dp_num_keys_per_bucket, top_grad, network_indices,
-                                                 core_->get_kernel_param(), network_buffer,
-                                                 batch_size, gpu_id, num_gpus, stream);
+    network_backward_from_feature_major_top_grad(
+        dp_num_keys_per_bucket, top_grad, network_indices, core_->get_kernel_param(),
+        network_buffer, batch_size, bid_begin, bid_end, gpu_id, num_gpus, stream);
   } else {
     HCTR_ASSERT(top_grad.attr.layout == EmbeddingLayout::BatchMajor);
-    network_backward_from_batch_major_top_grad(dp_num_keys_per_bucket, top_grad, network_indices,
-                                               core_->get_kernel_param(), network_buffer,
-                                               batch_size, gpu_id, num_gpus, stream);
+    network_backward_from_batch_major_top_grad(
+        dp_num_keys_per_bucket, top_grad, network_indices, core_->get_kernel_param(),
+        network_buffer, batch_size, bid_begin, bid_end, gpu_id, num_gpus, stream);
   }
 }
 
@@ -35,6 +35,11 @@ class NetworkBackward {
                        const EmbeddingOutput &top_grad, const NetworkIndices &network_indices,
                        NetworkBuffer &network_buffer, int batch_size);
 
+  // Only processes the samples [bid_begin, bid_end) of the local batch.
+  void sparse_backward(const core23::Tensor &dp_num_keys_per_bucket,
+                       const EmbeddingOutput &top_grad, const NetworkIndices &network_indices,
+                       NetworkBuffer &network_buffer, int batch_size, int bid_begin, int bid_end);
+
   void compute(const core23::Tensor &row_lengths, const core23::Tensor &d_combiner_list,
                const core23::Tensor &top_grad, const core23::Tensor &network_ids,
                const core23::Tensor &network_gpu_ids, const core23::Tensor &network_offsets,
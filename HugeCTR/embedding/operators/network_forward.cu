@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <embedding/operators/communication.hpp>
 #include <embedding/operators/generic_lookup.cuh>
 #include <embedding/operators/network_forward.hpp>
 #include <utils.hpp>
@@ -133,6 +134,7 @@ void NetworkBufferAttr::init(std::shared_ptr<CoreResourceManager> core,
     core23::copy_sync(this->id_to_ev_size_list[ggpu_id], h_id_to_ev_size[ggpu_id]);
     core23::copy_sync(this->id_to_ev_start_indices_list[ggpu_id], h_id_ev_start_indices[ggpu_id]);
   }
+  this->h_id_to_ev_size_list = h_id_to_ev_size;
   this->id_to_ev_size =
       core23::init_tensor_list<int32_t>(this->id_to_ev_size_list, params.device().index());
   this->id_to_ev_start_indices =
@@ -160,7 +162,8 @@ void NetworkBuffer::init(std::shared_ptr<CoreResourceManager> core, const Networ
   int batch_size_per_gpu = batch_size / core->get_global_gpu_count();
   HugeCTR::CudaDeviceContext context(core->get_device_id());
   core23::Device device(core23::DeviceType::GPU, core->get_device_id());
-  core23::TensorParams params = core23::TensorParams().device(device);
+  core23::TensorParams params = core23::TensorParams().device(device).allocator_params(
+      get_comm_buffer_allocator_params(core));
   for (int ggpu_id = 0; ggpu_id < attr.num_gpus; ++ggpu_id) {
     this->data_list.emplace_back(
         params.shape({batch_size_per_gpu * attr.gpu_id_to_max_ev_elements[ggpu_id]})
@@ -228,7 +231,8 @@ void DenseNetworkBuffer::init(std::shared_ptr<CoreResourceManager> core,
   HugeCTR::CudaDeviceContext context(core->get_device_id());
 
   core23::Device device(core23::DeviceType::GPU, core->get_device_id());
-  core23::TensorParams params = core23::TensorParams().device(device);
+  core23::TensorParams params = core23::TensorParams().device(device).allocator_params(
+      get_comm_buffer_allocator_params(core));
   this->data = core23::Tensor(
       params.shape({batch_size * attr.max_hotness * attr.ev_size}).data_type(attr.type));
 }
@@ -242,7 +246,8 @@ void network_forward_to_batch_major_output(const core23::Tensor& dp_num_keys_per
                                            const NetworkIndices& network_indices,
                                            const HugeCTR::core23::KernelParams& kernel_params,
                                            EmbeddingOutput& embedding_output, int batch_size,
-                                           int gpu_id, int num_gpus, cudaStream_t stream) {
+                                           int bid_begin, int bid_end, int gpu_id, int num_gpus,
+                                           cudaStream_t stream) {
   int batch_size_per_gpu = batch_size / num_gpus;
   auto& network_comm_buffer = network_buffer.data;
   auto& output_buffer = embedding_output.data;
@@ -267,16 +272,19 @@ void network_forward_to_batch_major_output(const core23::Tensor& dp_num_keys_per
         const char* dst_combiner_ptr = output_attr.id_to_combiner.data<char>();
         dst_emb_t* output_buffer_ptr = output_buffer.data<dst_emb_t>();
         int num_network_dst_lookup_ids = network_indices.network_dst_lookup_ids.num_elements();
+        int vec_offset = bid_begin * num_network_dst_lookup_ids;
 
         auto multi_to_one_desc = make_MultiToOne<emb_t, dst_emb_t>(
-            num_network_dst_lookup_ids * batch_size_per_gpu,
+            (bid_end - bid_begin) * num_network_dst_lookup_ids,
             [=] __device__(int i) {
+              i += vec_offset;
               int bid = i / num_network_dst_lookup_ids;
               int lookup_id = i % num_network_dst_lookup_ids;
               return bid * network_offsets_ptr[num_network_dst_lookup_ids] +
                      network_offsets_ptr[lookup_id];
             },
             [=] __device__(int i) {
+              i += vec_offset;
               int bid = i / num_network_dst_lookup_ids;
               int lookup_id = network_dst_lookup_ids_ptr[i % num_network_dst_lookup_ids];
 
@@ -288,6 +296,7 @@ void network_forward_to_batch_major_output(const core23::Tensor& dp_num_keys_per
               }
             },
             [=] __device__(int i) {
+              i += vec_offset;
               int dst_lookup_id = network_dst_lookup_ids_ptr[i % num_network_dst_lookup_ids];
               return dst_ev_start_indices_ptr[dst_lookup_id + 1] -
                      dst_ev_start_indices_ptr[dst_lookup_id];
@@ -305,13 +314,17 @@ void network_forward_to_batch_major_output(const core23::Tensor& dp_num_keys_per
               return network_comm_buffer_ptr[network_gpu_id] + ev_offset + bid * ev_size;
             },
             [=] __device__(int i) {
+              i += vec_offset;
               int bid = i / num_network_dst_lookup_ids;
               int lookup_id = network_dst_lookup_ids_ptr[i % num_network_dst_lookup_ids];
               int ev_offset = dst_ev_start_indices_ptr[num_lookup] * bid;
 
               return output_buffer_ptr + ev_offset + dst_ev_start_indices_ptr[lookup_id];
             });
-        copy_multi_to_one(multi_to_one_desc, kernel_params, max_ev_size, stream);
+        if (!copy_multi_to_one_fixed_ev_size(multi_to_one_desc, output_attr.uniform_ev_size,
+                                             !output_attr.has_average_combiner, stream)) {
+          copy_multi_to_one(multi_to_one_desc, kernel_params, max_ev_size, stream);
+        }
       });
     });
   });
@@ -322,7 +335,8 @@ void network_forward_to_feature_major_output(const core23::Tensor& dp_num_keys_p
                                              const NetworkIndices& network_indices,
                                              const HugeCTR::core23::KernelParams& kernel_params,
                                              EmbeddingOutput& embedding_output, int batch_size,
-                                             int gpu_id, int num_gpus, cudaStream_t stream) {
+                                             int bid_begin, int bid_end, int gpu_id, int num_gpus,
+                                             cudaStream_t stream) {
   int batch_size_per_gpu = batch_size / num_gpus;
   auto& network_comm_buffer = network_buffer.data;
   auto& output_buffer = embedding_output.data;
@@ -346,16 +360,19 @@ void network_forward_to_feature_major_output(const core23::Tensor& dp_num_keys_p
         const char* dst_combiner_ptr = output_attr.id_to_combiner.data<char>();
         dst_emb_t* output_buffer_ptr = output_buffer.data<dst_emb_t>();
         int num_network_dst_lookup_ids = network_indices.network_dst_lookup_ids.num_elements();
+        int vec_offset = bid_begin * num_network_dst_lookup_ids;
 
         auto multi_to_one_desc = make_MultiToOne<emb_t, dst_emb_t>(
-            num_network_dst_lookup_ids * batch_size_per_gpu,
+            (bid_end - bid_begin) * num_network_dst_lookup_ids,
             [=] __device__(int i) {
+              i += vec_offset;
               int bid = i / num_network_dst_lookup_ids;
               int lookup_id = i % num_network_dst_lookup_ids;
               return bid * network_offsets_ptr[num_network_dst_lookup_ids] +
                      network_offsets_ptr[lookup_id];
             },
             [=] __device__(int i) {
+              i += vec_offset;
               int bid = i / num_network_dst_lookup_ids;
               int lookup_id = network_dst_lookup_ids_ptr[i % num_network_dst_lookup_ids];
 
@@ -367,6 +384,7 @@ void network_forward_to_feature_major_output(const core23::Tensor& dp_num_keys_p
               }
             },
             [=] __device__(int i) {
+              i += vec_offset;
               int dst_lookup_id = network_dst_lookup_ids_ptr[i % num_network_dst_lookup_ids];
               return dst_ev_start_indices_ptr[dst_lookup_id + 1] -
                      dst_ev_start_indices_ptr[dst_lookup_id];
@@ -384,6 +402,7 @@ void network_forward_to_feature_major_output(const core23::Tensor& dp_num_keys_p
               return network_comm_buffer_ptr[network_gpu_id] + ev_offset + bid * ev_size;
             },
             [=] __device__(int i) {
+              i += vec_offset;
               int bid = i / num_network_dst_lookup_ids;
               int lookup_id = network_dst_lookup_ids_ptr[i % num_network_dst_lookup_ids];
 
@@ -392,7 +411,10 @@ void network_forward_to_feature_major_output(const core23::Tensor& dp_num_keys_p
                   dst_ev_start_indices_ptr[lookup_id + 1] - dst_ev_start_indices_ptr[lookup_id];
               return output_buffer_ptr + ev_offset + bid * ev_size;
             });
-        copy_multi_to_one(multi_to_one_desc, kernel_params, max_ev_size, stream);
+        if (!copy_multi_to_one_fixed_ev_size(multi_to_one_desc, output_attr.uniform_ev_size,
+                                             !output_attr.has_average_combiner, stream)) {
+          copy_multi_to_one(multi_to_one_desc, kernel_params, max_ev_size, stream);
+        }
       });
     });
   });
@@ -572,20 +594,30 @@ void NetworkForward::sparse_forward(const core23::Tensor& dp_num_keys_per_bucket
                                     const NetworkBuffer& network_buffer,
                                     const NetworkIndices& network_indices,
                                     EmbeddingOutput& embedding_output, int batch_size) {
+  sparse_forward(dp_num_keys_per_bucket, network_buffer, network_indices, embedding_output,
+                 batch_size, 0, batch_size / static_cast<int>(core_->get_global_gpu_count()));
+}
+
+void NetworkForward::sparse_forward(const core23::Tensor& dp_num_keys_per_bucket,
+                                    const NetworkBuffer& network_buffer,
+                                    const NetworkIndices& network_indices,
+                                    EmbeddingOutput& embedding_output, int batch_size,
+                                    int bid_begin, int bid_end) {
   HugeCTR::CudaDeviceContext ctx(core_->get_device_id());
   auto stream = core_->get_local_gpu()->get_stream();
   int gpu_id = core_->get_global_gpu_id();
   int num_gpus = core_->get_global_gpu_count();
+  if (bid_end <= bid_begin) return;
 
   if (embedding_output.attr.layout == EmbeddingLayout::FeatureMajor) {
     network_forward_to_feature_major_output(dp_num_keys_per_bucket, network_buffer, network_indices,
                                             core_->get_kernel_param(), embedding_output, batch_size,
-                                            gpu_id, num_gpus, stream);
+                                            bid_begin, bid_end, gpu_id, num_gpus, stream);
   } else {
     HCTR_ASSERT(embedding_output.attr.layout == EmbeddingLayout::BatchMajor);
     network_forward_to_batch_major_output(dp_num_keys_per_bucket, network_buffer, network_indices,
                                           core_->get_kernel_param(), embedding_output, batch_size,
-                                          gpu_id, num_gpus, stream);
+                                          bid_begin, bid_end, gpu_id, num_gpus, stream);
   }
 }
 
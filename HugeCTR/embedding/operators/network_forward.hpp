@@ -37,6 +37,7 @@ struct NetworkIndices {
 };
 
 struct NetworkBufferAttr {
+  std::vector<std::vector<int>> h_id_to_ev_size_list;
   std::vector<core23::Tensor> id_to_ev_size_list;
   core23::Tensor id_to_ev_size;
 
@@ -112,6 +113,12 @@ class NetworkForward {
                       const NetworkBuffer &network_buffer, const NetworkIndices &network_indices,
                       EmbeddingOutput &embedding_output, int batch_size);
 
+  // Only processes the samples [bid_begin, bid_end) of the local batch.
+  void sparse_forward(const core23::Tensor &dp_num_keys_per_bucket,
+                      const NetworkBuffer &network_buffer, const NetworkIndices &network_indices,
+                      EmbeddingOutput &embedding_output, int batch_size, int bid_begin,
+                      int bid_end);
+
   void dense_forward(const EmbeddingInput &embedding_input,
                      const DenseNetworkBuffer &network_buffer,
                      const DenseNetworkIndices &network_indices, EmbeddingOutput &embedding_output,
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_runtime.h>
+
+#include <core/macro.hpp>
+#include <cstdint>
+
+namespace embedding {
+
+// Rows of a model parallel table are assigned to its shards either round robin (row_offsets ==
+// nullptr) or by range: the s-th shard owns rows [row_offsets[s], row_offsets[s + 1]).
+
+template <typename key_t>
+HOST_DEVICE_INLINE int row_shard_id(const key_t &key, const int64_t *row_offsets,
+                                    int num_shards) {
+  if (row_offsets == nullptr) {
+    return static_cast<int>(static_cast<uint64_t>(key) % static_cast<uint64_t>(num_shards));
+  }
+  // Last shard whose first row is <= key.
+  int lo = 0;
+  int hi = num_shards - 1;
+  while (lo < hi) {
+    int mid = (lo + hi + 1) / 2;
+    if (row_offsets[mid] <= static_cast<int64_t>(key)) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  return lo;
+}
+
+template <typename key_t>
+HOST_DEVICE_INLINE uint64_t row_shard_local_index(const key_t &key, const int64_t *row_offsets,
+                                                  int shard_id, int num_shards) {
+  if (row_offsets == nullptr) {
+    return static_cast<uint64_t>(key) / static_cast<uint64_t>(num_shards);
+  }
+  return static_cast<uint64_t>(static_cast<int64_t>(key) - row_offsets[shard_id]);
+}
+
+inline int64_t row_shard_num_rows(int64_t vocabulary_size, const int64_t *row_offsets,
+                                  int shard_id, int num_shards) {
+  if (row_offsets == nullptr) {
+    return vocabulary_size / num_shards + (shard_id < vocabulary_size % num_shards ? 1 : 0);
+  }
+  return row_offsets[shard_id + 1] - row_offsets[shard_id];
+}
+
+}  // namespace embedding
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <cub/cub.cuh>
+#include <embedding/operators/sparse_allreduce.hpp>
+#include <utils.cuh>
+
+namespace embedding {
+
+namespace {
+
+__device__ __forceinline__ void atomic_accumulate(float *dst, float value) {
+  atomicAdd(dst, value);
+}
+
+__device__ __forceinline__ void atomic_accumulate(__half *dst, __half value) {
+  atomicAdd(dst, value);
+}
+
+template <typename key_t, typename wgrad_t>
+__global__ void pack_touched_rows_kernel(const key_t *local_keys, const uint64_t *num_local_keys,
+                                         const uint32_t *ev_start_indices, const wgrad_t *wgrad,
+                                         int max_ev_size, uint64_t max_num_rows, key_t *send_keys,
+                                         wgrad_t *send_rows) {
+  uint64_t num_rows = *num_local_keys;
+  CUDA_1D_KERNEL_LOOP_T(uint64_t, i, max_num_rows * max_ev_size) {
+    uint64_t row = i / max_ev_size;
+    int j = static_cast<int>(i % max_ev_size);
+    if (row >= num_rows) continue;
+
+    key_t key = local_keys[row];
+    uint32_t begin = ev_start_indices[key];
+    if (j == 0) send_keys[row] = key;
+    if (j < static_cast<int>(ev_start_indices[key + 1] - begin)) {
+      send_rows[i] = wgrad[begin + j];
+    }
+  }
+}
+
+template <typename key_t, typename wgrad_t>
+__global__ void accumulate_gathered_rows_kernel(const key_t *recv_keys, const wgrad_t *recv_rows,
+                                                const uint64_t *num_rows_per_gpu, int num_gpus,
+                                                int gpu_id, int max_ev_size, uint64_t max_num_rows,
+                                                const uint32_t *ev_start_indices, wgrad_t *wgrad,
+                                                char *row_flags) {
+  CUDA_1D_KERNEL_LOOP_T(uint64_t, i, num_gpus * max_num_rows * max_ev_size) {
+    uint64_t gathered_row = i / max_ev_size;
+    int j = static_cast<int>(i % max_ev_size);
+    int src_gpu_id = static_cast<int>(gathered_row / max_num_rows);
+    if (gathered_row % max_num_rows >= num_rows_per_gpu[src_gpu_id]) continue;
+
+    key_t key = recv_keys[gathered_row];
+    if (j == 0) row_flags[key] = 1;
+    // The local gradients are already in place
+    if (src_gpu_id == gpu_id) continue;
+    uint32_t begin = ev_start_indices[key];
+    if (j < static_cast<int>(ev_start_indices[key + 1] - begin)) {
+      atomic_accumulate(wgrad + begin + j, recv_rows[i]);
+    }
+  }
+}
+
+template <typename key_t>
+__global__ void gather_touched_row_indices_kernel(const key_t *unique_keys,
+                                                  const uint64_t *num_unique_keys,
+                                                  const int *dense_table_ids,
+                                                  const uint32_t *dense_ev_start_indices,
+                                                  int *table_ids, uint32_t *ev_start_indices) {
+  CUDA_1D_KERNEL_LOOP_T(uint64_t, i, *num_unique_keys) {
+    key_t key = unique_keys[i];
+    table_ids[i] = dense_table_ids[key];
+    ev_start_indices[i] = dense_ev_start_indices[key];
+  }
+}
+
+}  // namespace
+
+SparseAllreduce::SparseAllreduce(std::shared_ptr<CoreResourceManager> core, int max_ev_size,
+                                 int64_t max_num_local_rows)
+    : core_(core), max_ev_size_(max_ev_size), max_num_local_rows_(max_num_local_rows) {}
+
+void SparseAllreduce::init(const Wgrad &wgrad) {
+  auto stream = core_->get_local_gpu()->get_stream();
+  int num_gpus = core_->get_global_gpu_count();
+  num_rows_ = wgrad.unique_keys.num_elements();
+
+  // Each GPU receives the rows of all GPUs, which should take fewer bytes than the wgrad
+  int64_t gathered_row_bytes =
+      max_ev_size_ * wgrad.data.data_type().size() + wgrad.unique_keys.data_type().size();
+  max_num_gathered_rows_ =
+      std::min(max_num_local_rows_, wgrad.data.num_bytes() / (num_gpus * gathered_row_bytes));
+
+  core23::Device device(core23::DeviceType::GPU, core_->get_device_id());
+  core23::TensorParams params = core23::TensorParams().device(device);
+  auto snapshot = [&](const core23::Tensor &tensor) {
+    core23::Tensor copy(params.shape(tensor.shape()).data_type(tensor.data_type()));
+    core23::copy_async(copy, tensor, stream);
+    return copy;
+  };
+  dense_unique_keys_ = snapshot(wgrad.unique_keys);
+  dense_table_ids_ = snapshot(wgrad.table_ids);
+  dense_ev_start_indices_ = snapshot(wgrad.ev_start_indices);
+  dense_num_unique_keys_ = snapshot(wgrad.num_unique_keys);
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  if (max_num_gathered_rows_ == 0) return;
+
+  d_num_rows_per_gpu_ =
+      core23::Tensor(params.shape({num_gpus}).data_type(core23::ScalarType::UInt64));
+  h_num_rows_per_gpu_ = core23::Tensor(core23::TensorParams()
+                                           .device(core23::DeviceType::CPU)
+                                           .shape({num_gpus})
+                                           .data_type(core23::ScalarType::UInt64));
+  send_keys_ = core23::Tensor(
+      params.shape({max_num_gathered_rows_}).data_type(wgrad.unique_keys.data_type()));
+  recv_keys_ = core23::Tensor(
+      params.shape({num_gpus * max_num_gathered_rows_}).data_type(wgrad.unique_keys.data_type()));
+  send_rows_ = core23::Tensor(
+      params.shape({max_num_gathered_rows_ * max_ev_size_}).data_type(wgrad.data.data_type()));
+  recv_rows_ = core23::Tensor(params.shape({num_gpus * max_num_gathered_rows_ * max_ev_size_})
+                                  .data_type(wgrad.data.data_type()));
+  row_flags_ = core23::Tensor(params.shape({num_rows_}).data_type(core23::ScalarType::Char));
+
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(wgrad.unique_keys.data_type().type(), key_t, [&] {
+    size_t temp_bytes = 0;
+    cub::DeviceSelect::Flagged(nullptr, temp_bytes, cub::CountingInputIterator<key_t>(0),
+                               (char *)nullptr, (key_t *)nullptr, (uint64_t *)nullptr, num_rows_);
+    temp_select_storage_ = core23::Tensor(
+        params.shape({static_cast<int64_t>(temp_bytes)}).data_type(core23::ScalarType::Char));
+  });
+}
+
+void SparseAllreduce::restore_dense_indices(Wgrad &wgrad) {
+  if (!is_sparse_) return;
+  auto stream = core_->get_local_gpu()->get_stream();
+  core23::copy_async(wgrad.unique_keys, dense_unique_keys_, stream);
+  core23::copy_async(wgrad.table_ids, dense_table_ids_, stream);
+  core23::copy_async(wgrad.ev_start_indices, dense_ev_start_indices_, stream);
+  core23::copy_async(wgrad.num_unique_keys, dense_num_unique_keys_, stream);
+  is_sparse_ = false;
+}
+
+void SparseAllreduce::allreduce(const Wgrad &local_wgrad, Wgrad &wgrad,
+                                NcclAllReduceInplaceComm &dense_comm) {
+  HugeCTR::CudaDeviceContext context(core_->get_device_id());
+  if (dense_unique_keys_.empty()) init(wgrad);
+  auto stream = core_->get_local_gpu()->get_stream();
+  auto &comm = core_->get_nccl();
+  int num_gpus = core_->get_global_gpu_count();
+
+  uint64_t max_num_rows = 0;
+  if (max_num_gathered_rows_ > 0) {
+    HCTR_LIB_THROW(ncclAllGather(local_wgrad.num_unique_keys.data(), d_num_rows_per_gpu_.data(), 1,
+                                 ncclUint64, comm, stream));
+    core23::copy_async(h_num_rows_per_gpu_, d_num_rows_per_gpu_, stream);
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    const uint64_t *h_num_rows = h_num_rows_per_gpu_.data<uint64_t>();
+    max_num_rows = *std::max_element(h_num_rows, h_num_rows + num_gpus);
+  }
+  if (max_num_gathered_rows_ == 0 || max_num_rows > static_cast<uint64_t>(max_num_gathered_rows_)) {
+    restore_dense_indices(wgrad);
+    dense_comm.communicate(wgrad.data, wgrad.data.num_elements());
+    return;
+  }
+
+  is_sparse_ = true;
+  if (max_num_rows == 0) {
+    HCTR_LIB_THROW(cudaMemsetAsync(wgrad.num_unique_keys.data(), 0,
+                                   wgrad.num_unique_keys.num_bytes(), stream));
+    return;
+  }
+
+  constexpr int block_size = 256;
+  const int grid_size = core_->get_kernel_param().num_sms *
+                        core_->get_kernel_param().max_thread_per_block / block_size;
+  auto key_nccl_type =
+      core23::get_nccl_dtype_from_tensor_scalar_type_core23(wgrad.unique_keys.data_type().type());
+  auto wgrad_nccl_type =
+      core23::get_nccl_dtype_from_tensor_scalar_type_core23(wgrad.data.data_type().type());
+
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(wgrad.unique_keys.data_type().type(), key_t, [&] {
+    DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(wgrad.data.data_type().type(), wgrad_t, [&] {
+      pack_touched_rows_kernel<<<grid_size, block_size, 0, stream>>>(
+          local_wgrad.unique_keys.data<key_t>(), local_wgrad.num_unique_keys.data<uint64_t>(),
+          dense_ev_start_indices_.data<uint32_t>(), wgrad.data.data<wgrad_t>(), max_ev_size_,
+          max_num_rows, send_keys_.data<key_t>(), send_rows_.data<wgrad_t>());
+      HCTR_LIB_THROW(cudaPeekAtLastError());
+
+      HCTR_LIB_THROW(ncclGroupStart());
+      HCTR_LIB_THROW(ncclAllGather(send_keys_.data(), recv_keys_.data(), max_num_rows,
+                                   key_nccl_type, comm, stream));
+      HCTR_LIB_THROW(ncclAllGather(send_rows_.data(), recv_rows_.data(),
+                                   max_num_rows * max_ev_size_, wgrad_nccl_type, comm, stream));
+      HCTR_LIB_THROW(ncclGroupEnd());
+
+      HCTR_LIB_THROW(cudaMemsetAsync(row_flags_.data(), 0, row_flags_.num_bytes(), stream));
+      accumulate_gathered_rows_kernel<<<grid_size, block_size, 0, stream>>>(
+          recv_keys_.data<key_t>(), recv_rows_.data<wgrad_t>(),
+          d_num_rows_per_gpu_.data<uint64_t>(), num_gpus, core_->get_global_gpu_id(),
+          max_ev_size_, max_num_rows, dense_ev_start_indices_.data<uint32_t>(),
+          wgrad.data.data<wgrad_t>(), row_flags_.data<char>());
+      HCTR_LIB_THROW(cudaPeekAtLastError());
+
+      size_t temp_bytes = temp_select_storage_.num_bytes();
+      HCTR_LIB_THROW(cub::DeviceSelect::Flagged(
+          temp_select_storage_.data(), temp_bytes, cub::CountingInputIterator<key_t>(0),
+          row_flags_.data<char>(), wgrad.unique_keys.data<key_t>(),
+          wgrad.num_unique_keys.data<uint64_t>(), num_rows_, stream));
+
+      gather_touched_row_indices_kernel<<<grid_size, block_size, 0, stream>>>(
+          wgrad.unique_keys.data<key_t>(), wgrad.num_unique_keys.data<uint64_t>(),
+          dense_table_ids_.data<int>(), dense_ev_start_indices_.data<uint32_t>(),
+          wgrad.table_ids.data<int>(), wgrad.ev_start_indices.data<uint32_t>());
+      HCTR_LIB_THROW(cudaPeekAtLastError());
+    });
+  });
+}
+
+}  // namespace embedding
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <core23/tensor.hpp>
+#include <embedding/common.hpp>
+#include <embedding/operators/communication.hpp>
+
+namespace embedding {
+namespace core23 = HugeCTR::core23;
+using core::CoreResourceManager;
+
+/**
+ * Allreduces the wgrad of data parallel tables by rows. Every GPU allgathers the rows it touched
+ * and adds those of the other GPUs to its wgrad, which is then narrowed to the union of the touched
+ * rows, so that only these rows are updated. When the gathered rows would not be smaller than the
+ * wgrad, the whole wgrad is allreduced instead, so the choice is made every iteration.
+ *
+ * The wgrad has the layout of \p AllreduceWgradInitializer . Its indices are kept here, since the
+ * wgrad only holds those of the touched rows after a sparse allreduce.
+ */
+class SparseAllreduce {
+  std::shared_ptr<CoreResourceManager> core_;
+  int max_ev_size_ = 0;
+  int64_t max_num_local_rows_ = 0;  // rows a GPU can touch in one batch
+
+  int64_t num_rows_ = 0;
+  int64_t max_num_gathered_rows_ = 0;  // per GPU, beyond that the dense allreduce is cheaper
+  bool is_sparse_ = false;             // whether the wgrad indices are narrowed
+
+  // The indices of the whole wgrad
+  core23::Tensor dense_unique_keys_;
+  core23::Tensor dense_table_ids_;
+  core23::Tensor dense_ev_start_indices_;
+  core23::Tensor dense_num_unique_keys_;
+
+  core23::Tensor d_num_rows_per_gpu_;  // uint64_t
+  core23::Tensor h_num_rows_per_gpu_;  // uint64_t
+  core23::Tensor send_keys_;
+  core23::Tensor recv_keys_;
+  core23::Tensor send_rows_;  // max_ev_size_ elements per row
+  core23::Tensor recv_rows_;
+  core23::Tensor row_flags_;  // char, per row of the wgrad
+  core23::Tensor temp_select_storage_;
+
+  void init(const Wgrad &wgrad);
+
+  void restore_dense_indices(Wgrad &wgrad);
+
+ public:
+  SparseAllreduce() = default;
+
+  SparseAllreduce(std::shared_ptr<CoreResourceManager> core, int max_ev_size,
+                  int64_t max_num_local_rows);
+
+  /**
+   * @return The offsets of the rows in the whole wgrad, for the local reduce.
+   */
+  const core23::Tensor &dense_ev_start_indices(const Wgrad &wgrad) const {
+    return dense_ev_start_indices_.empty() ? wgrad.ev_start_indices : dense_ev_start_indices_;
+  }
+
+  /**
+   * Sums \p wgrad across all GPUs.
+   *
+   * @param local_wgrad The rows this GPU touched, in its unique_keys and num_unique_keys.
+   * @param wgrad The whole wgrad, narrowed to the touched rows of all GPUs on a sparse allreduce.
+   */
+  void allreduce(const Wgrad &local_wgrad, Wgrad &wgrad, NcclAllReduceInplaceComm &dense_comm);
+};
+
+}  // namespace embedding
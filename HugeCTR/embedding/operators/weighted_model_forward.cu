@@ -38,35 +38,39 @@ void WeightedModelForward::compute(const core23::Tensor &mp_ev, const core23::Te
   if (num_local_embedding_ > 0) {
     DISPATCH_INTEGRAL_FUNCTION_CORE23(model_offset.data_type().type(), offset_t, [&] {
       DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(model_comm_buffer.data_type().type(), emb_t, [&] {
-        const offset_t *model_offset_ptr = model_offset.data<offset_t>();
-        const int *d_local_ev_size_list_ptr = d_local_ev_size_list.data<int>();
-        const int *d_local_ev_size_offset_ptr = d_local_ev_size_offset.data<int>();
-        const float **mp_ev_ptr = static_cast<const float **>(mp_ev.data());
-        emb_t **model_comm_buffer_ptr = static_cast<emb_t **>(model_comm_buffer.data());
-        const float *sp_weight_ptr = sp_weight.data<float>();
+        DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(sp_weight.data_type().type(), weight_t, [&] {
+          const offset_t *model_offset_ptr = model_offset.data<offset_t>();
+          const int *d_local_ev_size_list_ptr = d_local_ev_size_list.data<int>();
+          const int *d_local_ev_size_offset_ptr = d_local_ev_size_offset.data<int>();
+          const float **mp_ev_ptr = static_cast<const float **>(mp_ev.data());
+          emb_t **model_comm_buffer_ptr = static_cast<emb_t **>(model_comm_buffer.data());
+          const weight_t *sp_weight_ptr = sp_weight.data<weight_t>();
 
-        auto multi_to_one_desc = make_MultiToOneWeight<float, emb_t>(
-            batch_size * num_local_embedding_,
-            [=] __device__(int i) { return model_offset_ptr[i]; },
-            [=] __device__(int i) { return 1.0f; },
-            [=] __device__(int i) {
-              int i_lookup = i / batch_size;
-              return d_local_ev_size_list_ptr[i_lookup];
-            },
-            [=] __device__(int i) { return mp_ev_ptr[i]; },
-            [=] __device__(int i) {
-              int i_lookup = i / batch_size;
-              int batch_id = i % batch_size;
-              int gpu_id = batch_id / batch_size_per_gpu;
-              int ev_size =
-                  d_local_ev_size_offset_ptr[i_lookup + 1] - d_local_ev_size_offset_ptr[i_lookup];
-              int local_batch_id = batch_id % batch_size_per_gpu;
-              return model_comm_buffer_ptr[gpu_id] +
-                     batch_size_per_gpu * d_local_ev_size_offset_ptr[i_lookup] +
-                     local_batch_id * ev_size;
-            },
-            [=] __device__(int i) { return sp_weight_ptr[i]; });
-        copy_multi_to_one_weight(multi_to_one_desc, max_ev_size, stream);
+          auto multi_to_one_desc = make_MultiToOneWeight<float, emb_t>(
+              batch_size * num_local_embedding_,
+              [=] __device__(int i) { return model_offset_ptr[i]; },
+              [=] __device__(int i) { return 1.0f; },
+              [=] __device__(int i) {
+                int i_lookup = i / batch_size;
+                return d_local_ev_size_list_ptr[i_lookup];
+              },
+              [=] __device__(int i) { return mp_ev_ptr[i]; },
+              [=] __device__(int i) {
+                int i_lookup = i / batch_size;
+                int batch_id = i % batch_size;
+                int gpu_id = batch_id / batch_size_per_gpu;
+                int ev_size = d_local_ev_size_offset_ptr[i_lookup + 1] -
+                              d_local_ev_size_offset_ptr[i_lookup];
+                int local_batch_id = batch_id % batch_size_per_gpu;
+                return model_comm_buffer_ptr[gpu_id] +
+                       batch_size_per_gpu * d_local_ev_size_offset_ptr[i_lookup] +
+                       local_batch_id * ev_size;
+              },
+              [=] __device__(int i) {
+                return HugeCTR::TypeConvertFunc<float, weight_t>::convert(sp_weight_ptr[i]);
+              });
+          copy_multi_to_one_load_balanced(multi_to_one_desc, max_ev_size, stream);
+        });
       });
     });
   }
@@ -253,7 +253,7 @@ __global__ void scan_id_space_offset(const key_t* hash_keys, const uint32_t* has
 WeightedModelIndexCalculation::WeightedModelIndexCalculation(
     std::shared_ptr<CoreResourceManager> core, int num_local_embedding, int local_hotness_sum,
     int hotness_sum, int universal_batch_size, core23::DataType key_type,
-    core23::DataType offset_type)
+    core23::DataType offset_type, core23::DataType sp_weight_type)
     : core_(core),
       num_local_embedding_(num_local_embedding),
       local_hotness_sum_(local_hotness_sum),
@@ -276,7 +276,7 @@ WeightedModelIndexCalculation::WeightedModelIndexCalculation(
 
   model_sp_weight_ = core23::Tensor(params.shape({universal_batch_size_ * local_hotness_sum_})
                                         .device(device)
-                                        .data_type(core23::ScalarType::Float));
+                                        .data_type(sp_weight_type));
 
   num_key_in_bucket_for_combiner_ =
       core23::Tensor(params.shape({universal_batch_size_ * num_local_embedding_})
@@ -397,7 +397,7 @@ WeightedModelBackwardIndexCalculation::WeightedModelBackwardIndexCalculation(
     std::shared_ptr<CoreResourceManager> core, int num_gpus, int num_local_embedding,
     const std::vector<int>& h_local_hotness_list, const std::vector<int>& h_local_id_space_list,
     const std::vector<int>& h_local_ev_size_list, int universal_batch_size,
-    core23::DataType key_type)
+    core23::DataType key_type, core23::DataType sp_weight_type)
     : core_(core), num_gpus_(num_gpus), num_local_embedding_(num_local_embedding) {
   HugeCTR::CudaDeviceContext ctx(core_->get_device_id());
 
@@ -513,7 +513,7 @@ WeightedModelBackwardIndexCalculation::WeightedModelBackwardIndexCalculation(
 
     sorted_sp_weight_list_ = core23::Tensor(params.shape({universal_batch_size * local_hotness_sum})
                                                 .device({device})
-                                                .data_type(core23::ScalarType::Float));
+                                                .data_type(sp_weight_type));
   }
 
   {
@@ -587,8 +587,7 @@ void WeightedModelBackwardIndexCalculation::compute(
                                      sorted_bucket_id_list_.num_bytes(), stream));
       HCTR_LIB_THROW(cudaMemsetAsync(sorted_bucket_id_offset_.data<uint32_t>(), 0,
                                      sorted_bucket_id_offset_.num_bytes(), stream));
-      // TODO:: need to fix  a flexsible type
-      HCTR_LIB_THROW(cudaMemsetAsync(sorted_sp_weight_list_.data<float>(), 0,
+      HCTR_LIB_THROW(cudaMemsetAsync(sorted_sp_weight_list_.data(), 0,
                                      sorted_sp_weight_list_.num_bytes(), stream));
 
       if (num_local_embedding_ > 0 && num_model_key > 0ul) {
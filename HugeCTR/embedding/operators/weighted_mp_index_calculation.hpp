@@ -46,7 +46,8 @@ class WeightedModelIndexCalculation {
 
   WeightedModelIndexCalculation(std::shared_ptr<CoreResourceManager> core, int num_local_embedding,
                                 int local_hotness_sum, int hotness_sum, int universal_batch_size,
-                                core23::DataType key_type, core23::DataType offset_type);
+                                core23::DataType key_type, core23::DataType offset_type,
+                                core23::DataType sp_weight_type = core23::ScalarType::Float);
 
   void compute(const core23::Tensor& key, const core23::Tensor& bucket_range, size_t num_key,
                const core23::Tensor& d_local_embedding_list,
@@ -98,7 +99,9 @@ class WeightedModelBackwardIndexCalculation {
                                         const std::vector<int>& h_local_hotness_list,
                                         const std::vector<int>& h_local_id_space_list,
                                         const std::vector<int>& h_local_ev_size_list,
-                                        int universal_batch_size, core23::DataType key_type);
+                                        int universal_batch_size, core23::DataType key_type,
+                                        core23::DataType sp_weight_type =
+                                            core23::ScalarType::Float);
 
   void compute(const core23::Tensor& model_key, size_t num_model_key,
                const core23::Tensor& model_offset, const core23::Tensor& id_space_offset,
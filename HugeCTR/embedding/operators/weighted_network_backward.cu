@@ -38,68 +38,71 @@ void WeightedNetworkBackward::compute(
     DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(top_grad.data_type().type(), emb_t, [&] {
       DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(
           network_comm_buffer.data_type().type(), dst_emb_t, [&] {
-            const offset_t** row_lengths_ptr = static_cast<const offset_t**>(row_lengths.data());
-            const int* network_ids_ptr = network_ids.data<int>();
-            const int* network_gpu_ids_ptr = network_gpu_ids.data<int>();
-            const int* network_offsets_ptr = network_offsets.data<int>();
-            const int* network_dst_lookup_ids_ptr = network_dst_lookup_ids.data<int>();
-            const int** network_ev_sizes_ptr = static_cast<const int**>(network_ev_sizes.data());
-            const int** network_ev_offsets_ptr =
-                static_cast<const int**>(network_ev_offsets.data());
-            const int* d_ev_size_offset_ptr = d_ev_size_offset.data<int>();
-            const emb_t** top_grad_ptr = static_cast<const emb_t**>(top_grad.data());
-            dst_emb_t** network_comm_buffer_ptr =
-                static_cast<dst_emb_t**>(network_comm_buffer.data());
-            const float* sp_sum_ptr = sp_sum.data<float>();
-            const char* combiner_ptr = d_combiner_list.data<char>();
-            int num_network_dst_lookup_ids = network_dst_lookup_ids.num_elements();
-            int gpu_id = core_->get_global_gpu_id();
+            DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(sp_sum.data_type().type(), sum_t, [&] {
+              const offset_t** row_lengths_ptr = static_cast<const offset_t**>(row_lengths.data());
+              const int* network_ids_ptr = network_ids.data<int>();
+              const int* network_gpu_ids_ptr = network_gpu_ids.data<int>();
+              const int* network_offsets_ptr = network_offsets.data<int>();
+              const int* network_dst_lookup_ids_ptr = network_dst_lookup_ids.data<int>();
+              const int** network_ev_sizes_ptr = static_cast<const int**>(network_ev_sizes.data());
+              const int** network_ev_offsets_ptr =
+                  static_cast<const int**>(network_ev_offsets.data());
+              const int* d_ev_size_offset_ptr = d_ev_size_offset.data<int>();
+              const emb_t** top_grad_ptr = static_cast<const emb_t**>(top_grad.data());
+              dst_emb_t** network_comm_buffer_ptr =
+                  static_cast<dst_emb_t**>(network_comm_buffer.data());
+              const sum_t* sp_sum_ptr = sp_sum.data<sum_t>();
+              const char* combiner_ptr = d_combiner_list.data<char>();
+              int num_network_dst_lookup_ids = network_dst_lookup_ids.num_elements();
+              int gpu_id = core_->get_global_gpu_id();
 
-            auto one_to_multi_desc = make_MultiToOneWeight<emb_t, dst_emb_t>(
-                num_network_dst_lookup_ids * batch_size_per_gpu,
-                [=] __device__(int i) {
-                  int bid = i / num_network_dst_lookup_ids;
-                  int lookup_id = i % num_network_dst_lookup_ids;
-                  return bid * network_offsets_ptr[num_network_dst_lookup_ids] +
-                         network_offsets_ptr[lookup_id];
-                },
-                [=] __device__(int i) {
-                  int bid = i / num_network_dst_lookup_ids;
-                  int lookup_id = network_dst_lookup_ids_ptr[i % num_network_dst_lookup_ids];
+              auto one_to_multi_desc = make_MultiToOneWeight<emb_t, dst_emb_t>(
+                  num_network_dst_lookup_ids * batch_size_per_gpu,
+                  [=] __device__(int i) {
+                    int bid = i / num_network_dst_lookup_ids;
+                    int lookup_id = i % num_network_dst_lookup_ids;
+                    return bid * network_offsets_ptr[num_network_dst_lookup_ids] +
+                           network_offsets_ptr[lookup_id];
+                  },
+                  [=] __device__(int i) {
+                    int bid = i / num_network_dst_lookup_ids;
+                    int lookup_id = network_dst_lookup_ids_ptr[i % num_network_dst_lookup_ids];
 
-                  if (combiner_ptr[lookup_id] == static_cast<char>(Combiner::Average)) {
-                    return sp_sum_ptr[lookup_id * batch_size_per_gpu + bid];
-                  } else {
-                    return 1.0f;
-                  }
-                },
-                [=] __device__(int i) {
-                  int dst_lookup_id = network_dst_lookup_ids_ptr[i % num_network_dst_lookup_ids];
-                  return d_ev_size_offset_ptr[dst_lookup_id + 1] -
-                         d_ev_size_offset_ptr[dst_lookup_id];
-                },
-                [=] __device__(int i) {
-                  int bid = i / num_network_dst_lookup_ids;
-                  int lookup_id = network_dst_lookup_ids_ptr[i % num_network_dst_lookup_ids];
+                    if (combiner_ptr[lookup_id] == static_cast<char>(Combiner::Average)) {
+                      return HugeCTR::TypeConvertFunc<float, sum_t>::convert(
+                          sp_sum_ptr[lookup_id * batch_size_per_gpu + bid]);
+                    } else {
+                      return 1.0f;
+                    }
+                  },
+                  [=] __device__(int i) {
+                    int dst_lookup_id = network_dst_lookup_ids_ptr[i % num_network_dst_lookup_ids];
+                    return d_ev_size_offset_ptr[dst_lookup_id + 1] -
+                           d_ev_size_offset_ptr[dst_lookup_id];
+                  },
+                  [=] __device__(int i) {
+                    int bid = i / num_network_dst_lookup_ids;
+                    int lookup_id = network_dst_lookup_ids_ptr[i % num_network_dst_lookup_ids];
 
-                  int ev_size =
-                      d_ev_size_offset_ptr[lookup_id + 1] - d_ev_size_offset_ptr[lookup_id];
-                  return top_grad_ptr[lookup_id] + bid * ev_size;
-                },
-                [=] __device__(int i) {
-                  int bid = i / network_offsets_ptr[num_network_dst_lookup_ids];
-                  int id = i % network_offsets_ptr[num_network_dst_lookup_ids];
+                    int ev_size =
+                        d_ev_size_offset_ptr[lookup_id + 1] - d_ev_size_offset_ptr[lookup_id];
+                    return top_grad_ptr[lookup_id] + bid * ev_size;
+                  },
+                  [=] __device__(int i) {
+                    int bid = i / network_offsets_ptr[num_network_dst_lookup_ids];
+                    int id = i % network_offsets_ptr[num_network_dst_lookup_ids];
 
-                  int network_gpu_id = network_gpu_ids_ptr[id];
-                  int network_id = network_ids_ptr[id];
-                  int ev_offset =
-                      network_ev_offsets_ptr[network_gpu_id][network_id] * batch_size_per_gpu;
-                  int ev_size = network_ev_sizes_ptr[network_gpu_id][network_id];
+                    int network_gpu_id = network_gpu_ids_ptr[id];
+                    int network_id = network_ids_ptr[id];
+                    int ev_offset =
+                        network_ev_offsets_ptr[network_gpu_id][network_id] * batch_size_per_gpu;
+                    int ev_size = network_ev_sizes_ptr[network_gpu_id][network_id];
 
-                  return network_comm_buffer_ptr[network_gpu_id] + ev_offset + bid * ev_size;
-                },
-                [=] __device__(int i) { return 1.0; });
-            copy_one_to_multi_weight(one_to_multi_desc, max_ev_size, stream);
+                    return network_comm_buffer_ptr[network_gpu_id] + ev_offset + bid * ev_size;
+                  },
+                  [=] __device__(int i) { return 1.0; });
+              copy_one_to_multi_weight(one_to_multi_desc, max_ev_size, stream);
+            });
           });
     });
   });
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <embedding/operators/unique_op.hpp>
+#include <embedding/operators/wgrad_accumulation.hpp>
+#include <utils.cuh>
+
+namespace embedding {
+
+namespace {
+
+constexpr uint64_t kLockedSlot = ~uint64_t{0};
+
+template <typename key_t, typename wgrad_t>
+__global__ void accumulate_wgrad_kernel(const key_t *keys, const uint64_t *num_keys,
+                                        const int *table_ids, const uint32_t *ev_start_indices,
+                                        const wgrad_t *wgrad, const int *table_id_to_ev_size,
+                                        float scale, uint64_t *hash_slots, uint64_t *hash_pos,
+                                        uint64_t hash_capacity, key_t *acc_keys,
+                                        uint64_t *acc_num_keys, int *acc_table_ids,
+                                        uint32_t *acc_ev_start_indices, float *acc_data,
+                                        uint64_t capacity, int max_ev_size) {
+  CUDA_1D_KERNEL_LOOP_T(uint64_t, i, num_keys[0]) {
+    const key_t key = keys[i];
+    const int table_id = table_ids[i];
+    uint32_t hash = MurmurHash3_32<int>::hash_combine(MurmurHash3_32<key_t>::hash(key),
+                                                      MurmurHash3_32<int>::hash(table_id));
+    uint64_t pos = hash % hash_capacity;
+    uint64_t entry = 0;
+    bool is_new = false;
+    for (uint64_t num_probes = 0;; ++num_probes) {
+      assert(num_probes < hash_capacity && "error: wgrad accumulation hash table is full");
+      volatile uint64_t *slot = hash_slots + pos;
+      uint64_t current = *slot;
+      if (current == 0) {
+        current = atomicCAS(reinterpret_cast<unsigned long long *>(hash_slots + pos), 0ull,
+                            static_cast<unsigned long long>(kLockedSlot));
+        if (current == 0) {
+          entry = atomicAdd(reinterpret_cast<unsigned long long *>(acc_num_keys), 1ull);
+          assert(entry < capacity && "error: wgrad accumulation buffer is full");
+          acc_keys[entry] = key;
+          acc_table_ids[entry] = table_id;
+          acc_ev_start_indices[entry] = static_cast<uint32_t>(entry * max_ev_size);
+          hash_pos[entry] = pos;
+          __threadfence();
+          *slot = entry + 1;
+          is_new = true;
+          break;
+        }
+      }
+      while (current == kLockedSlot) {
+        current = *slot;
+      }
+      entry = current - 1;
+      if (acc_keys[entry] == key && acc_table_ids[entry] == table_id) break;
+      pos = (pos + 1) % hash_capacity;
+    }
+
+    // Keys are unique within one wgrad, so no other thread writes this entry.
+    const int ev_size = table_id_to_ev_size[table_id];
+    const wgrad_t *src = wgrad + ev_start_indices[i];
+    float *dst = acc_data + entry * max_ev_size;
+    for (int j = 0; j < ev_size; ++j) {
+      float value = scale * HugeCTR::TypeConvertFunc<float, wgrad_t>::convert(src[j]);
+      dst[j] = is_new ? value : dst[j] + value;
+    }
+  }
+}
+
+__global__ void clear_hash_slots_kernel(const uint64_t *hash_pos, const uint64_t *num_entries,
+                                        uint64_t *hash_slots) {
+  CUDA_1D_KERNEL_LOOP_T(uint64_t, i, num_entries[0]) { hash_slots[hash_pos[i]] = 0; }
+}
+
+}  // namespace
+
+WgradAccumulator::WgradAccumulator(std::shared_ptr<CoreResourceManager> core,
+                                   const EmbeddingCollectionParam &ebc_param, size_t grouped_id,
+                                   const Wgrad &wgrad,
+                                   const std::vector<int> &table_id_to_vocabulary_size)
+    : core_(core) {
+  HugeCTR::CudaDeviceContext context(core_->get_device_id());
+  const auto &group_params = ebc_param.grouped_lookup_params[grouped_id];
+  const auto &table_ids =
+      ebc_param.grouped_table_params[group_params.grouped_table_idx].table_ids;
+
+  for (int lookup_id : group_params.lookup_ids) {
+    max_ev_size_ = std::max(max_ev_size_, ebc_param.lookup_params[lookup_id].ev_size);
+  }
+
+  // The union of the unique keys of all micro-batches, at most the total number of rows.
+  capacity_ = wgrad.unique_keys.num_elements() * ebc_param.num_gradient_accumulation_steps_;
+  int64_t num_rows = 0;
+  bool is_static = true;
+  for (int table_id : table_ids) {
+    is_static &= table_id_to_vocabulary_size[table_id] > 0;
+    num_rows += table_id_to_vocabulary_size[table_id];
+  }
+  if (is_static) capacity_ = std::min(capacity_, num_rows);
+  capacity_ = std::max<int64_t>(capacity_, 1);
+  hash_capacity_ = 2 * capacity_;
+  HCTR_CHECK_HINT(capacity_ * max_ev_size_ <= std::numeric_limits<uint32_t>::max(),
+                  "wgrad accumulation buffer exceeds uint32_t ev_start_indices, got ",
+                  capacity_ * max_ev_size_, " elements.");
+
+  core23::Device device(core23::DeviceType::GPU, core_->get_device_id());
+  core23::TensorParams params = core23::TensorParams().device(device);
+  hash_slots_ =
+      core23::Tensor(params.shape({hash_capacity_}).data_type(core23::ScalarType::UInt64));
+  hash_pos_ = core23::Tensor(params.shape({capacity_}).data_type(core23::ScalarType::UInt64));
+
+  accumulated_wgrad_.attr = wgrad.attr;
+  accumulated_wgrad_.attr.type = core23::ScalarType::Float;
+  accumulated_wgrad_.unique_keys =
+      core23::Tensor(params.shape({capacity_}).data_type(wgrad.unique_keys.data_type()));
+  accumulated_wgrad_.num_unique_keys =
+      core23::Tensor(params.shape({1}).data_type(core23::ScalarType::UInt64));
+  accumulated_wgrad_.table_ids =
+      core23::Tensor(params.shape({capacity_}).data_type(core23::ScalarType::Int32));
+  accumulated_wgrad_.ev_start_indices =
+      core23::Tensor(params.shape({capacity_ + 1}).data_type(core23::ScalarType::UInt32));
+  accumulated_wgrad_.data = core23::Tensor(
+      params.shape({capacity_ * max_ev_size_}).data_type(core23::ScalarType::Float));
+
+  HCTR_LIB_THROW(cudaMemset(hash_slots_.data(), 0, hash_slots_.num_bytes()));
+  HCTR_LIB_THROW(cudaMemset(accumulated_wgrad_.num_unique_keys.data(), 0,
+                            accumulated_wgrad_.num_unique_keys.num_bytes()));
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+}
+
+void WgradAccumulator::accumulate(const Wgrad &wgrad, float scale) {
+  HugeCTR::CudaDeviceContext context(core_->get_device_id());
+  auto stream = core_->get_local_gpu()->get_stream();
+
+  constexpr int block_size = 256;
+  const auto &kernel_param = core_->get_kernel_param();
+  const int grid_size = kernel_param.num_sms * kernel_param.max_thread_per_block / block_size;
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(wgrad.unique_keys.data_type().type(), key_t, [&] {
+    DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(wgrad.data.data_type().type(), wgrad_t, [&] {
+      accumulate_wgrad_kernel<<<grid_size, block_size, 0, stream>>>(
+          wgrad.unique_keys.data<key_t>(), wgrad.num_unique_keys.data<uint64_t>(),
+          wgrad.table_ids.data<int>(), wgrad.ev_start_indices.data<uint32_t>(),
+          wgrad.data.data<wgrad_t>(), wgrad.attr.table_id_to_ev_size.data<int>(), scale,
+          hash_slots_.data<uint64_t>(), hash_pos_.data<uint64_t>(), hash_capacity_,
+          accumulated_wgrad_.unique_keys.data<key_t>(),
+          accumulated_wgrad_.num_unique_keys.data<uint64_t>(),
+          accumulated_wgrad_.table_ids.data<int>(),
+          accumulated_wgrad_.ev_start_indices.data<uint32_t>(),
+          accumulated_wgrad_.data.data<float>(), capacity_, max_ev_size_);
+    });
+  });
+  HCTR_LIB_THROW(cudaPeekAtLastError());
+}
+
+void WgradAccumulator::clear() {
+  HugeCTR::CudaDeviceContext context(core_->get_device_id());
+  auto stream = core_->get_local_gpu()->get_stream();
+
+  constexpr int block_size = 256;
+  const auto &kernel_param = core_->get_kernel_param();
+  const int grid_size = kernel_param.num_sms * kernel_param.max_thread_per_block / block_size;
+  clear_hash_slots_kernel<<<grid_size, block_size, 0, stream>>>(
+      hash_pos_.data<uint64_t>(), accumulated_wgrad_.num_unique_keys.data<uint64_t>(),
+      hash_slots_.data<uint64_t>());
+  HCTR_LIB_THROW(cudaPeekAtLastError());
+  HCTR_LIB_THROW(cudaMemsetAsync(accumulated_wgrad_.num_unique_keys.data(), 0,
+                                 accumulated_wgrad_.num_unique_keys.num_bytes(), stream));
+}
+
+}  // namespace embedding
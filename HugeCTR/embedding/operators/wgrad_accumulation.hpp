@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <core23/tensor.hpp>
+#include <embedding/common.hpp>
+
+namespace embedding {
+namespace core23 = HugeCTR::core23;
+using core::CoreResourceManager;
+
+/**
+ * Merges the sparse wgrad of several micro-batches on the GPU, so that the embedding table is
+ * updated once with the union of their unique keys. The (table id, key) pairs are deduplicated with
+ * an open addressing hash table that persists across micro-batches; only its used slots are
+ * cleared after the update.
+ */
+class WgradAccumulator {
+  std::shared_ptr<CoreResourceManager> core_;
+  int max_ev_size_ = 0;
+  int64_t capacity_ = 0;       // max number of accumulated keys
+  int64_t hash_capacity_ = 0;  // number of hash table slots
+
+  core23::Tensor hash_slots_;  // uint64_t, 0 = empty, else the accumulated entry + 1
+  core23::Tensor hash_pos_;    // uint64_t, per accumulated entry, its hash table slot
+
+  Wgrad accumulated_wgrad_;  // float data, max_ev_size_ floats per entry
+
+ public:
+  WgradAccumulator() = default;
+
+  WgradAccumulator(std::shared_ptr<CoreResourceManager> core,
+                   const EmbeddingCollectionParam &ebc_param, size_t grouped_id,
+                   const Wgrad &wgrad, const std::vector<int> &table_id_to_vocabulary_size);
+
+  /**
+   * Adds `scale` * \p wgrad to the accumulated wgrad. Keys seen for the first time get a new entry.
+   */
+  void accumulate(const Wgrad &wgrad, float scale);
+
+  const Wgrad &get_accumulated_wgrad() const { return accumulated_wgrad_; }
+
+  void clear();
+};
+
+}  // namespace embedding
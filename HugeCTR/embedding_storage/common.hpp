@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <core23/macros.hpp>
 #include <core23/tensor.hpp>
 #include <core23/tensor_operations.hpp>
 #include <core23/tensor_params.hpp>
@@ -73,6 +74,60 @@ struct InitParams {
   }
 };
 
+// Built-in eviction of the rows of a dynamic table, counted in updates of the table.
+struct DynamicEvictionParams {
+  int64_t ttl_steps = 0;             // evict rows not looked up for more steps, 0 disables
+  uint64_t min_frequency = 0;        // evict rows looked up fewer times per scan, 0 disables
+  uint64_t admission_threshold = 0;  // create rows at the K-th lookup of their key, <= 1 disables
+  int64_t scan_interval = 1000;      // steps between two eviction scans
+
+  DynamicEvictionParams() = default;
+
+  DynamicEvictionParams(int64_t ttl_steps, uint64_t min_frequency, uint64_t admission_threshold,
+                        int64_t scan_interval)
+      : ttl_steps(ttl_steps),
+        min_frequency(min_frequency),
+        admission_threshold(admission_threshold),
+        scan_interval(scan_interval) {
+    HCTR_CHECK_HINT(ttl_steps >= 0, "ttl_steps should be >= 0");
+    HCTR_CHECK_HINT(scan_interval > 0, "scan_interval should be > 0");
+  }
+
+  bool evicts() const { return ttl_steps > 0 || min_frequency > 0; }
+  bool admits() const { return admission_threshold > 1; }
+  bool enabled() const { return evicts() || admits(); }
+
+  bool operator==(const DynamicEvictionParams &other) const {
+    return ttl_steps == other.ttl_steps && min_frequency == other.min_frequency &&
+           admission_threshold == other.admission_threshold &&
+           scan_interval == other.scan_interval;
+  }
+};
+
+// Offload of the colder rows of a dynamic table, with their optimizer states, to a file per table
+// and GPU on an SSD.
+struct DynamicOffloadParams {
+  std::string path;             // directory of the row files, empty disables
+  int64_t max_gpu_rows = 0;     // rows of a table kept in GPU memory, per GPU
+  int64_t host_buffer_mb = 64;  // host buffer of the writes to the file of a table
+
+  DynamicOffloadParams() = default;
+
+  DynamicOffloadParams(const std::string &path, int64_t max_gpu_rows, int64_t host_buffer_mb)
+      : path(path), max_gpu_rows(max_gpu_rows), host_buffer_mb(host_buffer_mb) {
+    HCTR_CHECK_HINT(!path.empty(), "path should not be empty");
+    HCTR_CHECK_HINT(max_gpu_rows > 0, "max_gpu_rows should be > 0");
+    HCTR_CHECK_HINT(host_buffer_mb > 0, "host_buffer_mb should be > 0");
+  }
+
+  bool enabled() const { return !path.empty(); }
+
+  bool operator==(const DynamicOffloadParams &other) const {
+    return path == other.path && max_gpu_rows == other.max_gpu_rows &&
+           host_buffer_mb == other.host_buffer_mb;
+  }
+};
+
 struct EmbeddingTableParam {
   int table_id;
   int max_vocabulary_size;  // -1 means dynamic
@@ -80,16 +135,40 @@ struct EmbeddingTableParam {
 
   HugeCTR::OptParams opt_param;
   InitParams init_param;
+  bool fp16_opt_state = false;  // Store optimizer states in fp16 (static tables only).
+  DynamicEvictionParams eviction_param;  // Dynamic tables only.
+  // Keys of any value are hashed into the max_vocabulary_size rows (static tables only).
+  bool hash_keys = false;
+  DynamicOffloadParams offload_param;  // Dynamic tables only.
 
   EmbeddingTableParam() = default;
 
   EmbeddingTableParam(int table_id, int max_vocabulary_size, int ev_size,
-                      HugeCTR::OptParams opt_param, InitParams init_param = InitParams()) {
+                      HugeCTR::OptParams opt_param, InitParams init_param = InitParams(),
+                      bool fp16_opt_state = false,
+                      DynamicEvictionParams eviction_param = DynamicEvictionParams(),
+                      bool hash_keys = false,
+                      DynamicOffloadParams offload_param = DynamicOffloadParams()) {
     this->table_id = table_id;
     this->max_vocabulary_size = max_vocabulary_size;
     this->ev_size = ev_size;
     this->opt_param = opt_param;
     this->init_param = init_param;
+    this->fp16_opt_state = fp16_opt_state;
+    this->eviction_param = eviction_param;
+    this->hash_keys = hash_keys;
+    this->offload_param = offload_param;
   }
 };
+
+// The row of a key in a table with hash_keys. The finalizer of MurmurHash3 spreads close keys over
+// the rows, so that the collisions do not depend on how the keys were assigned.
+HCTR_HOST_DEVICE inline uint64_t hash_key_to_row(uint64_t key, uint64_t num_rows) {
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  key *= 0xc4ceb2bd8b4e8ec1ULL;
+  key ^= key >> 33;
+  return key % num_rows;
+}
 }  // namespace embedding
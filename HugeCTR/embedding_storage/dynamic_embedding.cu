@@ -17,9 +17,12 @@
 #include <cuda_runtime_api.h>
 #include <curand_kernel.h>
 
+#include <algorithm>
+#include <cstring>
 #include <cub/cub.cuh>
 #include <dynamic_embedding_table/dynamic_embedding_table.hpp>
 #include <embedding_storage/dynamic_embedding.hpp>
+#include <embedding_storage/keyed_init.cuh>
 #include <embedding_storage/optimizers.cuh>
 #include <utils.cuh>
 
@@ -32,6 +35,93 @@ constexpr det::DynamicEmbeddingTable<KeyT, ValueT> *cast_table(void *t) noexcept
   return reinterpret_cast<det::DynamicEmbeddingTable<KeyT, ValueT> *>(t);
 }
 
+// Eviction metadata of a key: [last seen step, lookups since the last scan, admitted].
+constexpr size_t kMetaDim = 3;
+
+// Bound of the rows of the default initializer, as the vocabulary is unknown.
+constexpr float kDefaultUpBound = 0.05f;
+
+inline int grid_size_of(size_t n, int block_size) {
+  return static_cast<int>((std::max<size_t>(n, 1) - 1) / block_size + 1);
+}
+
+__global__ void count_meta_kernel(float *const *meta, size_t num_keys, uint32_t step,
+                                  uint32_t admission_threshold) {
+  for (size_t i = blockIdx.x * static_cast<size_t>(blockDim.x) + threadIdx.x; i < num_keys;
+       i += static_cast<size_t>(blockDim.x) * gridDim.x) {
+    auto m = reinterpret_cast<uint32_t *>(meta[i]);
+    m[0] = step;
+    // A key can appear more than once per lookup.
+    if (atomicAdd(&m[1], 1u) + 1u >= admission_threshold) {
+      m[2] = 1u;
+    }
+  }
+}
+
+__global__ void read_admitted_kernel(const float *const *meta, size_t num_keys, char *admitted) {
+  for (size_t i = blockIdx.x * static_cast<size_t>(blockDim.x) + threadIdx.x; i < num_keys;
+       i += static_cast<size_t>(blockDim.x) * gridDim.x) {
+    admitted[i] = reinterpret_cast<const uint32_t *>(meta[i])[2] != 0u;
+  }
+}
+
+// Flags the admitted rows not looked up for more than `ttl` steps or fewer than `min_frequency`
+// times since the last scan, and the pending keys not looked up for more than `ttl` steps, or all
+// of them without a ttl. Resets the lookup counts.
+__global__ void expire_meta_kernel(float *meta, size_t num_keys, uint32_t step, uint32_t ttl,
+                                   uint32_t min_frequency, char *expired) {
+  for (size_t i = blockIdx.x * static_cast<size_t>(blockDim.x) + threadIdx.x; i < num_keys;
+       i += static_cast<size_t>(blockDim.x) * gridDim.x) {
+    auto m = reinterpret_cast<uint32_t *>(meta + i * kMetaDim);
+    const bool stale = ttl > 0 && step - m[0] > ttl;
+    expired[i] = m[2] ? stale || m[1] < min_frequency : stale || ttl == 0;
+    m[1] = 0u;
+  }
+}
+
+template <typename key_t>
+__global__ void gather_keys_kernel(const key_t *keys, const uint32_t *indices, size_t num_indices,
+                                   key_t *gathered_keys) {
+  for (size_t i = blockIdx.x * static_cast<size_t>(blockDim.x) + threadIdx.x; i < num_indices;
+       i += static_cast<size_t>(blockDim.x) * gridDim.x) {
+    gathered_keys[i] = keys[indices[i]];
+  }
+}
+
+__global__ void fill_evs_kernel(float **evs, size_t num_keys, float *default_ev) {
+  for (size_t i = blockIdx.x * static_cast<size_t>(blockDim.x) + threadIdx.x; i < num_keys;
+       i += static_cast<size_t>(blockDim.x) * gridDim.x) {
+    evs[i] = default_ev;
+  }
+}
+
+__global__ void scatter_evs_kernel(float *const *gathered_evs, const uint32_t *indices,
+                                   size_t num_indices, float **evs) {
+  for (size_t i = blockIdx.x * static_cast<size_t>(blockDim.x) + threadIdx.x; i < num_indices;
+       i += static_cast<size_t>(blockDim.x) * gridDim.x) {
+    evs[indices[i]] = gathered_evs[i];
+  }
+}
+
+// One warp per vector, like the optimizers.
+template <typename wgrad_t>
+__global__ void gather_wgrad_kernel(const wgrad_t *wgrad, const uint32_t *ev_start_indices,
+                                    const uint32_t *indices, size_t num_indices,
+                                    const uint32_t *gathered_ev_start_indices,
+                                    wgrad_t *gathered_wgrad) {
+  const uint64_t thread_id = blockIdx.x * static_cast<uint64_t>(blockDim.x) + threadIdx.x;
+  const uint64_t tid = thread_id / kUpdateWarpSize;
+  const uint32_t lane_id = thread_id % kUpdateWarpSize;
+  if (tid >= num_indices) return;
+
+  const uint32_t src = ev_start_indices[indices[tid]];
+  const uint32_t dst = gathered_ev_start_indices[tid];
+  const uint32_t ev_size = gathered_ev_start_indices[tid + 1] - dst;
+  for (uint32_t i = lane_id; i < ev_size; i += kUpdateWarpSize) {
+    gathered_wgrad[dst + i] = wgrad[src + i];
+  }
+}
+
 }  // namespace
 
 DynamicEmbeddingTable::DynamicEmbeddingTable(const HugeCTR::GPUResource &gpu_resource,
@@ -47,6 +137,19 @@ DynamicEmbeddingTable::DynamicEmbeddingTable(const HugeCTR::GPUResource &gpu_res
   const auto &grouped_table_params = ebc_param.grouped_table_params[grouped_table_id];
   const auto &table_ids = grouped_table_params.table_ids;
 
+  eviction_param_ = table_params[table_ids[0]].eviction_param;
+  for (auto table_id : table_ids) {
+    HCTR_CHECK_HINT(table_params[table_id].eviction_param == eviction_param_,
+                    "grouped dynamic embedding tables should have the same eviction params.");
+  }
+  offload_param_ = table_params[table_ids[0]].offload_param;
+  for (auto table_id : table_ids) {
+    HCTR_CHECK_HINT(table_params[table_id].offload_param == offload_param_,
+                    "grouped dynamic embedding tables should have the same offload params.");
+  }
+  HCTR_CHECK_HINT(!offload_param_.enabled() || !eviction_param_.admits(),
+                  "dynamic embedding tables with offload do not support admission.");
+
   h_table_ids_.assign(table_ids.begin(), table_ids.end());
   DISPATCH_INTEGRAL_FUNCTION_CORE23(key_type_.type(), key_t, [&] {
     std::vector<size_t> dim_per_class;
@@ -63,16 +166,26 @@ DynamicEmbeddingTable::DynamicEmbeddingTable(const HugeCTR::GPUResource &gpu_res
 
     dim_per_class_ = dim_per_class;
 
-    table_ =
-        new det::DynamicEmbeddingTable<key_t, float>(dim_per_class.size(), dim_per_class.data());
+    // A row is drawn from its key when it is first looked up, so the rows do not depend on the
+    // order of the lookups, on the GPU that owns the key, or on whether the row was evicted before.
+    std::vector<cuco::initializer> initializer_per_class;
+    for (auto table_id : table_ids) {
+      initializer_per_class.push_back(keyed_initializer(
+          table_params[table_id].init_param,
+          table_init_seed(gpu_resource.get_replica_uniform_seed(), table_id), kDefaultUpBound));
+    }
+    table_ = new det::DynamicEmbeddingTable<key_t, float>(
+        dim_per_class.size(), dim_per_class.data(), std::move(initializer_per_class));
     cast_table<key_t, float>(table_)->initialize(stream);
 
     // Some optimizers contain state, which will be contained in `table_opt_states_`.
     dim_per_class.clear();
     for (auto table_id : table_ids) {
       auto &emb_table_param = table_params[table_id];
-      dim_per_class.push_back(emb_table_param.ev_size * opt_param.num_parameters_per_weight());
+      dim_per_class.push_back(emb_table_param.ev_size * opt_param.num_parameters_per_weight() +
+                              opt_param.num_parameters_per_row());
     }
+    opt_dim_per_class_ = dim_per_class;
     table_opt_states_ = new det::DynamicEmbeddingTable<key_t, float>(dim_per_class.size(),
                                                                      dim_per_class.data(), "zeros");
     cast_table<key_t, float>(table_opt_states_)->initialize(stream);
@@ -88,8 +201,48 @@ DynamicEmbeddingTable::DynamicEmbeddingTable(const HugeCTR::GPUResource &gpu_res
 
     weight_view_ = std::make_unique<core23::Tensor>(core23::init_tensor_list<float>(
         ebc_param.universal_batch_size * max_total_hotness, core_->get_device_id()));
+
+    if (eviction_param_.enabled()) {
+      dim_per_class.assign(table_ids.size(), kMetaDim);
+      table_meta_ = new det::DynamicEmbeddingTable<key_t, float>(dim_per_class.size(),
+                                                                 dim_per_class.data(), "zeros");
+      cast_table<key_t, float>(table_meta_)->initialize(stream);
+
+      const int64_t max_num_keys = ebc_param.universal_batch_size * max_total_hotness;
+      core23::Device device(core23::DeviceType::GPU, core_->get_device_id());
+      core23::TensorParams params = core23::TensorParams().device(device);
+
+      meta_view_ = core23::init_tensor_list<float>(max_num_keys, core_->get_device_id());
+      admitted_ = core23::Tensor(params.shape({max_num_keys}).data_type(core23::ScalarType::Char));
+
+      if (eviction_param_.admits()) {
+        const int64_t max_ev_size = *std::max_element(dim_per_class_.begin(), dim_per_class_.end());
+        admitted_indices_ =
+            core23::Tensor(params.shape({max_num_keys}).data_type(core23::ScalarType::UInt32));
+        admitted_keys_ = core23::Tensor(params.shape({max_num_keys}).data_type(key_type_));
+        admitted_evs_ = core23::init_tensor_list<float>(max_num_keys, core_->get_device_id());
+        admitted_ev_start_indices_ = core23::Tensor(
+            params.shape({max_num_keys + 1}).data_type(core23::ScalarType::UInt32));
+        admitted_wgrad_ = core23::Tensor(
+            params.shape({max_num_keys * max_ev_size}).data_type(core23::ScalarType::Float));
+        default_ev_ =
+            core23::Tensor(params.shape({max_ev_size}).data_type(core23::ScalarType::Float));
+        HCTR_LIB_THROW(cudaMemsetAsync(default_ev_.data(), 0, default_ev_.num_bytes(), stream));
+      }
+    }
   });
 
+  if (offload_param_.enabled()) {
+    resident_.resize(table_ids.size());
+    for (size_t i = 0; i < table_ids.size(); ++i) {
+      const std::string path = offload_param_.path + "/table" + std::to_string(table_ids[i]) +
+                               "_gpu" + std::to_string(core_->get_global_gpu_id()) + ".rows";
+      const size_t row_bytes = sizeof(float) * (dim_per_class_[i] + opt_dim_per_class_[i]);
+      row_stores_.push_back(std::make_unique<SSDRowStore>(
+          path, row_bytes, static_cast<size_t>(offload_param_.host_buffer_mb) << 20));
+    }
+  }
+
   // Await GPU.
   HCTR_LIB_THROW(cudaStreamSynchronize(stream));
 }
@@ -148,17 +301,93 @@ void DynamicEmbeddingTable::lookup(const core23::Tensor &keys, size_t num_keys,
     }
   });
   if (num_keys > 0) {
+    if (offload_param_.enabled()) {
+      stage_rows(keys.data(), num_keys, mapped_id_space_list.data(), id_space_offset_cpu.data(),
+                 num_id_space_offset - 1, stream);
+    }
+    if (eviction_param_.enabled()) {
+      lookup_meta(keys.data(), num_keys, mapped_id_space_list.data(), id_space_offset_cpu.data(),
+                  num_id_space_offset - 1, true, stream);
+    }
     DISPATCH_INTEGRAL_FUNCTION_CORE23(keys.data_type().type(), key_t, [&] {
       auto table = cast_table<key_t, float>(table_);
 
-      table->lookup_unsafe(keys.data<key_t>(), (float **)emb_vec.data(), num_keys,
-                           mapped_id_space_list.data(), id_space_offset_cpu.data(),
-                           num_id_space_offset - 1, stream);
+      if (!eviction_param_.admits()) {
+        table->lookup_unsafe(keys.data<key_t>(), (float **)emb_vec.data(), num_keys,
+                             mapped_id_space_list.data(), id_space_offset_cpu.data(),
+                             num_id_space_offset - 1, stream);
+        HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+        return;
+      }
+
+      // Only the admitted keys get a row, the others look up zeros.
+      const std::vector<char> admitted_cpu = admitted(num_keys, stream);
+      std::vector<uint32_t> indices_cpu;
+      std::vector<size_t> admitted_offset_cpu{0};
+      for (size_t i = 0; i + 1 < num_id_space_offset; ++i) {
+        for (size_t j = id_space_offset_cpu[i]; j < id_space_offset_cpu[i + 1]; ++j) {
+          if (admitted_cpu[j]) {
+            indices_cpu.push_back(j);
+          }
+        }
+        admitted_offset_cpu.push_back(indices_cpu.size());
+      }
+      const size_t num_admitted = indices_cpu.size();
+
+      constexpr int block_size = 256;
+      fill_evs_kernel<<<grid_size_of(num_keys, block_size), block_size, 0, stream>>>(
+          (float **)emb_vec.data(), num_keys, default_ev_.data<float>());
+      if (num_admitted > 0) {
+        HCTR_LIB_THROW(cudaMemcpyAsync(admitted_indices_.data(), indices_cpu.data(),
+                                       sizeof(uint32_t) * num_admitted, cudaMemcpyHostToDevice,
+                                       stream));
+        gather_keys_kernel<<<grid_size_of(num_admitted, block_size), block_size, 0, stream>>>(
+            keys.data<key_t>(), admitted_indices_.data<uint32_t>(), num_admitted,
+            admitted_keys_.data<key_t>());
+        table->lookup_unsafe(admitted_keys_.data<key_t>(), (float **)admitted_evs_.data(),
+                             num_admitted, mapped_id_space_list.data(),
+                             admitted_offset_cpu.data(), num_id_space_offset - 1, stream);
+        scatter_evs_kernel<<<grid_size_of(num_admitted, block_size), block_size, 0, stream>>>(
+            (float **)admitted_evs_.data(), admitted_indices_.data<uint32_t>(), num_admitted,
+            (float **)emb_vec.data());
+      }
       HCTR_LIB_THROW(cudaStreamSynchronize(stream));
     });
   }
 }
 
+void DynamicEmbeddingTable::lookup_meta(const void *keys, size_t num_keys,
+                                        const size_t *id_spaces, const size_t *id_space_offsets,
+                                        size_t num_id_spaces, bool count, cudaStream_t stream) {
+  HCTR_CHECK_HINT(num_keys <= static_cast<size_t>(meta_view_.num_elements()),
+                  "DynamicEmbeddingTable looks up more keys than the batch can hold.");
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(key_type_.type(), key_t, [&] {
+    cast_table<key_t, float>(table_meta_)
+        ->lookup_unsafe(static_cast<const key_t *>(keys), (float **)meta_view_.data(), num_keys,
+                        id_spaces, id_space_offsets, num_id_spaces, stream);
+  });
+  if (count) {
+    constexpr int block_size = 256;
+    count_meta_kernel<<<grid_size_of(num_keys, block_size), block_size, 0, stream>>>(
+        (float **)meta_view_.data(), num_keys, step_,
+        static_cast<uint32_t>(
+            std::min<uint64_t>(eviction_param_.admission_threshold, UINT32_MAX)));
+  }
+  HCTR_LIB_THROW(cudaPeekAtLastError());
+}
+
+std::vector<char> DynamicEmbeddingTable::admitted(size_t num_keys, cudaStream_t stream) {
+  constexpr int block_size = 256;
+  read_admitted_kernel<<<grid_size_of(num_keys, block_size), block_size, 0, stream>>>(
+      (float **)meta_view_.data(), num_keys, admitted_.data<char>());
+
+  std::vector<char> admitted_cpu(num_keys);
+  HCTR_LIB_THROW(cudaMemcpyAsync(admitted_cpu.data(), admitted_.data(), num_keys,
+                                 cudaMemcpyDeviceToHost, stream));
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  return admitted_cpu;
+}
+
 void DynamicEmbeddingTable::update(const core23::Tensor &unique_keys,
                                    const core23::Tensor &num_unique_keys,
                                    const core23::Tensor &table_ids,
@@ -196,7 +425,7 @@ void DynamicEmbeddingTable::update(const core23::Tensor &unique_keys,
     }
     table_range_cpu.push_back(num_unique_keys_cpu);
 
-    const auto mapped_unique_table_ids = remap_id_space(unique_table_ids_cpu);
+    auto mapped_unique_table_ids = remap_id_space(unique_table_ids_cpu);
     size_t num_table = mapped_unique_table_ids.size();
     // Request exclusive access to avoid update race.
     const std::lock_guard lock(write_mutex_);
@@ -204,47 +433,110 @@ void DynamicEmbeddingTable::update(const core23::Tensor &unique_keys,
     // FIXME: use another buffer
     DISPATCH_INTEGRAL_FUNCTION_CORE23(unique_keys.data_type().type(), key_t, [&] {
       DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(wgrad.data_type().type(), wgrad_t, [&] {
+        const key_t *keys_ptr = unique_keys.data<key_t>();
+        const uint32_t *ev_start_indices_ptr = ev_start_indices.data<uint32_t>();
         wgrad_t *wgrad_ptr = const_cast<wgrad_t *>(wgrad.data<wgrad_t>());
+        size_t num_keys = num_unique_keys_cpu;
+
+        // Drop the keys that are not admitted yet, they have no row to update.
+        if (eviction_param_.admits()) {
+          lookup_meta(keys_ptr, num_keys, mapped_unique_table_ids.data(), table_range_cpu.data(),
+                      num_table, false, stream);
+          const std::vector<char> admitted_cpu = admitted(num_keys, stream);
+          std::vector<uint32_t> ev_start_indices_cpu(num_keys + 1);
+          HCTR_LIB_THROW(cudaMemcpyAsync(ev_start_indices_cpu.data(), ev_start_indices_ptr,
+                                         sizeof(uint32_t) * (num_keys + 1),
+                                         cudaMemcpyDeviceToHost, stream));
+          HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+
+          std::vector<uint32_t> indices_cpu;
+          std::vector<uint32_t> admitted_ev_start_indices_cpu{0};
+          std::vector<size_t> admitted_table_ids;
+          std::vector<size_t> admitted_range_cpu{0};
+          for (size_t t = 0; t < num_table; ++t) {
+            for (size_t i = table_range_cpu[t]; i < table_range_cpu[t + 1]; ++i) {
+              if (admitted_cpu[i]) {
+                indices_cpu.push_back(i);
+                admitted_ev_start_indices_cpu.push_back(admitted_ev_start_indices_cpu.back() +
+                                                        ev_start_indices_cpu[i + 1] -
+                                                        ev_start_indices_cpu[i]);
+              }
+            }
+            if (indices_cpu.size() > admitted_range_cpu.back()) {
+              admitted_table_ids.push_back(mapped_unique_table_ids[t]);
+              admitted_range_cpu.push_back(indices_cpu.size());
+            }
+          }
+          num_keys = indices_cpu.size();
+          if (num_keys == 0) {
+            return;
+          }
+
+          HCTR_LIB_THROW(cudaMemcpyAsync(admitted_indices_.data(), indices_cpu.data(),
+                                         sizeof(uint32_t) * num_keys, cudaMemcpyHostToDevice,
+                                         stream));
+          HCTR_LIB_THROW(cudaMemcpyAsync(
+              admitted_ev_start_indices_.data(), admitted_ev_start_indices_cpu.data(),
+              sizeof(uint32_t) * (num_keys + 1), cudaMemcpyHostToDevice, stream));
+
+          constexpr int block_size = 256;
+          auto gathered_keys = admitted_keys_.data<key_t>();
+          auto gathered_wgrad = reinterpret_cast<wgrad_t *>(admitted_wgrad_.data());
+          gather_keys_kernel<<<grid_size_of(num_keys, block_size), block_size, 0, stream>>>(
+              keys_ptr, admitted_indices_.data<uint32_t>(), num_keys, gathered_keys);
+          gather_wgrad_kernel<<<update_grid_size(num_keys, block_size), block_size, 0, stream>>>(
+              wgrad_ptr, ev_start_indices_ptr, admitted_indices_.data<uint32_t>(), num_keys,
+              admitted_ev_start_indices_.data<uint32_t>(), gathered_wgrad);
+          // The host vectors are in use until the copies are done.
+          HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+
+          keys_ptr = gathered_keys;
+          ev_start_indices_ptr = admitted_ev_start_indices_.data<uint32_t>();
+          wgrad_ptr = gathered_wgrad;
+          mapped_unique_table_ids = admitted_table_ids;
+          table_range_cpu = admitted_range_cpu;
+          num_table = admitted_table_ids.size();
+        }
+
+        const float lr =
+            device_lr_ ? opt_param_.lr_multiplier : opt_param_.lr * opt_param_.lr_multiplier;
 
         switch (opt_param_.optimizer) {
           case HugeCTR::Optimizer_t::Ftrl: {
             auto table_opt_states = cast_table<key_t, float>(table_opt_states_);
             table_opt_states->lookup_unsafe(
-                unique_keys.data<key_t>(), (float **)opt_state_view_->data(), num_unique_keys_cpu,
+                keys_ptr, (float **)opt_state_view_->data(), num_keys,
                 mapped_unique_table_ids.data(), table_range_cpu.data(), num_table, stream);
 
             auto table = cast_table<key_t, float>(table_);
-            table->lookup_unsafe(unique_keys.data<key_t>(), (float **)weight_view_->data(),
-                                 num_unique_keys_cpu, mapped_unique_table_ids.data(),
+            table->lookup_unsafe(keys_ptr, (float **)weight_view_->data(),
+                                 num_keys, mapped_unique_table_ids.data(),
                                  table_range_cpu.data(), num_table, stream);
 
-            const float lambda2_plus_beta_div_lr = opt_param_.hyperparams.ftrl.lambda2 +
-                                                   opt_param_.hyperparams.ftrl.beta / opt_param_.lr;
-
             constexpr int block_size = 256;
-            const int grid_size = (static_cast<int64_t>(num_unique_keys_cpu) - 1) / block_size + 1;
+            const int grid_size = update_grid_size(num_keys, block_size);
 
             ftrl_update_grad_kernel<<<grid_size, block_size, 0, stream>>>(
-                ev_start_indices.data<uint32_t>(), num_unique_keys_cpu, opt_param_.lr,
-                opt_param_.hyperparams.ftrl.lambda1, lambda2_plus_beta_div_lr,
-                (float **)opt_state_view_->data(), (float **)weight_view_->data(),
-                opt_param_.scaler, wgrad_ptr);
+                ev_start_indices_ptr, num_keys, device_lr_, lr,
+                opt_param_.hyperparams.ftrl.lambda1, opt_param_.hyperparams.ftrl.lambda2,
+                opt_param_.hyperparams.ftrl.beta, (float **)opt_state_view_->data(),
+                (float **)weight_view_->data(), opt_param_.scaler, wgrad_ptr);
           } break;
 
           case HugeCTR::Optimizer_t::Adam: {
             auto table_opt_states = cast_table<key_t, float>(table_opt_states_);
             table_opt_states->lookup_unsafe(
-                unique_keys.data<key_t>(), (float **)opt_state_view_->data(), num_unique_keys_cpu,
+                keys_ptr, (float **)opt_state_view_->data(), num_keys,
                 mapped_unique_table_ids.data(), table_range_cpu.data(), num_table, stream);
 
             ++opt_param_.hyperparams.adam.times;
-            const float lr_scaled_bias = opt_param_.lr * opt_param_.hyperparams.adam.bias();
+            const float lr_scaled_bias = lr * opt_param_.hyperparams.adam.bias();
 
             constexpr int block_size = 256;
-            const int grid_size = (static_cast<int64_t>(num_unique_keys_cpu) - 1) / block_size + 1;
+            const int grid_size = update_grid_size(num_keys, block_size);
 
             adam_update_grad_kernel<<<grid_size, block_size, 0, stream>>>(
-                ev_start_indices.data<uint32_t>(), num_unique_keys_cpu, lr_scaled_bias,
+                ev_start_indices_ptr, num_keys, device_lr_, lr_scaled_bias,
                 opt_param_.hyperparams.adam.beta1, opt_param_.hyperparams.adam.beta2,
                 (float **)opt_state_view_->data(), opt_param_.hyperparams.adam.epsilon,
                 opt_param_.scaler, wgrad_ptr);
@@ -253,14 +545,14 @@ void DynamicEmbeddingTable::update(const core23::Tensor &unique_keys,
           case HugeCTR::Optimizer_t::RMSProp: {
             auto table_opt_states = cast_table<key_t, float>(table_opt_states_);
             table_opt_states->lookup_unsafe(
-                unique_keys.data<key_t>(), (float **)opt_state_view_->data(), num_unique_keys_cpu,
+                keys_ptr, (float **)opt_state_view_->data(), num_keys,
                 mapped_unique_table_ids.data(), table_range_cpu.data(), num_table, stream);
 
             constexpr int block_size = 256;
-            const int grid_size = (static_cast<int64_t>(num_unique_keys_cpu) - 1) / block_size + 1;
+            const int grid_size = update_grid_size(num_keys, block_size);
 
             rms_prop_update_grad_kernel<<<grid_size, block_size, 0, stream>>>(
-                ev_start_indices.data<uint32_t>(), num_unique_keys_cpu, opt_param_.lr,
+                ev_start_indices_ptr, num_keys, device_lr_, lr,
                 opt_param_.hyperparams.rmsprop.beta, (float **)opt_state_view_->data(),
                 opt_param_.hyperparams.rmsprop.epsilon, opt_param_.scaler, wgrad_ptr);
           } break;
@@ -268,29 +560,60 @@ void DynamicEmbeddingTable::update(const core23::Tensor &unique_keys,
           case HugeCTR::Optimizer_t::AdaGrad: {
             auto table_opt_states = cast_table<key_t, float>(table_opt_states_);
             table_opt_states->lookup_unsafe(
-                unique_keys.data<key_t>(), (float **)opt_state_view_->data(), num_unique_keys_cpu,
+                keys_ptr, (float **)opt_state_view_->data(), num_keys,
                 mapped_unique_table_ids.data(), table_range_cpu.data(), num_table, stream);
 
             constexpr int block_size = 256;
-            const int grid_size = (static_cast<int64_t>(num_unique_keys_cpu) - 1) / block_size + 1;
+            const int grid_size = update_grid_size(num_keys, block_size);
 
             ada_grad_update_grad_kernel<<<grid_size, block_size, 0, stream>>>(
-                ev_start_indices.data<uint32_t>(), num_unique_keys_cpu, opt_param_.lr,
+                ev_start_indices_ptr, num_keys, device_lr_, lr,
+                (float **)opt_state_view_->data(), opt_param_.hyperparams.adagrad.epsilon,
+                opt_param_.scaler, wgrad_ptr);
+          } break;
+
+          case HugeCTR::Optimizer_t::RowWiseAdaGrad: {
+            auto table_opt_states = cast_table<key_t, float>(table_opt_states_);
+            table_opt_states->lookup_unsafe(
+                keys_ptr, (float **)opt_state_view_->data(), num_keys,
+                mapped_unique_table_ids.data(), table_range_cpu.data(), num_table, stream);
+
+            constexpr int block_size = 256;
+            const int grid_size = update_grid_size(num_keys, block_size);
+
+            row_wise_ada_grad_update_grad_kernel<<<grid_size, block_size, 0, stream>>>(
+                ev_start_indices_ptr, num_keys, device_lr_, lr,
                 (float **)opt_state_view_->data(), opt_param_.hyperparams.adagrad.epsilon,
                 opt_param_.scaler, wgrad_ptr);
           } break;
 
+          case HugeCTR::Optimizer_t::LazyAdam: {
+            auto table_opt_states = cast_table<key_t, float>(table_opt_states_);
+            table_opt_states->lookup_unsafe(
+                keys_ptr, (float **)opt_state_view_->data(), num_keys,
+                mapped_unique_table_ids.data(), table_range_cpu.data(), num_table, stream);
+
+            constexpr int block_size = 256;
+            const int grid_size = update_grid_size(num_keys, block_size);
+
+            lazy_adam_update_grad_kernel<<<grid_size, block_size, 0, stream>>>(
+                ev_start_indices_ptr, num_keys, device_lr_, lr,
+                opt_param_.hyperparams.adam.beta1, opt_param_.hyperparams.adam.beta2,
+                (float **)opt_state_view_->data(), opt_param_.hyperparams.adam.epsilon,
+                opt_param_.scaler, wgrad_ptr);
+          } break;
+
           case HugeCTR::Optimizer_t::MomentumSGD: {
             auto table_opt_states = cast_table<key_t, float>(table_opt_states_);
             table_opt_states->lookup_unsafe(
-                unique_keys.data<key_t>(), (float **)opt_state_view_->data(), num_unique_keys_cpu,
+                keys_ptr, (float **)opt_state_view_->data(), num_keys,
                 mapped_unique_table_ids.data(), table_range_cpu.data(), num_table, stream);
 
             constexpr int block_size = 256;
-            const int grid_size = (static_cast<int64_t>(num_unique_keys_cpu) - 1) / block_size + 1;
+            const int grid_size = update_grid_size(num_keys, block_size);
 
             momentum_update_grad_kernel<<<grid_size, block_size, 0, stream>>>(
-                ev_start_indices.data<uint32_t>(), num_unique_keys_cpu, opt_param_.lr,
+                ev_start_indices_ptr, num_keys, device_lr_, lr,
                 opt_param_.hyperparams.momentum.factor, (float **)opt_state_view_->data(),
                 opt_param_.scaler, wgrad_ptr);
           } break;
@@ -298,24 +621,24 @@ void DynamicEmbeddingTable::update(const core23::Tensor &unique_keys,
           case HugeCTR::Optimizer_t::Nesterov: {
             auto table_opt_states = cast_table<key_t, float>(table_opt_states_);
             table_opt_states->lookup_unsafe(
-                unique_keys.data<key_t>(), (float **)opt_state_view_->data(), num_unique_keys_cpu,
+                keys_ptr, (float **)opt_state_view_->data(), num_keys,
                 mapped_unique_table_ids.data(), table_range_cpu.data(), num_table, stream);
 
             constexpr int block_size = 256;
-            const int grid_size = (static_cast<int64_t>(num_unique_keys_cpu) - 1) / block_size + 1;
+            const int grid_size = update_grid_size(num_keys, block_size);
 
             nesterov_update_grad_kernel<<<grid_size, block_size, 0, stream>>>(
-                ev_start_indices.data<uint32_t>(), num_unique_keys_cpu, opt_param_.lr,
+                ev_start_indices_ptr, num_keys, device_lr_, lr,
                 opt_param_.hyperparams.nesterov.mu, (float **)opt_state_view_->data(),
                 opt_param_.scaler, wgrad_ptr);
           } break;
 
           case HugeCTR::Optimizer_t::SGD: {
             constexpr int block_size = 256;
-            const int grid_size = (static_cast<int64_t>(num_unique_keys_cpu) - 1) / block_size + 1;
+            const int grid_size = update_grid_size(num_keys, block_size);
 
             sgd_update_grad_kernel<<<grid_size, block_size, 0, stream>>>(
-                ev_start_indices.data<uint32_t>(), num_unique_keys_cpu, opt_param_.lr,
+                ev_start_indices_ptr, num_keys, device_lr_, lr,
                 opt_param_.scaler, wgrad_ptr);
           } break;
 
@@ -327,13 +650,21 @@ void DynamicEmbeddingTable::update(const core23::Tensor &unique_keys,
         // `scatter_add` automatically handles the offsets in `grad_ev_offset` using
         // the embedding vector dimensions given at construction.
         auto table = cast_table<key_t, float>(table_);
-        table->scatter_add(unique_keys.data<key_t>(), wgrad.data<float>(), num_unique_keys_cpu,
+        table->scatter_add(keys_ptr, reinterpret_cast<const float *>(wgrad_ptr), num_keys,
                            mapped_unique_table_ids.data(), table_range_cpu.data(), num_table,
                            stream);
         HCTR_LIB_THROW(cudaStreamSynchronize(stream));
       });
     });
   }
+
+  if (eviction_param_.enabled()) {
+    const std::lock_guard lock(write_mutex_);
+    ++step_;
+    if (step_ % eviction_param_.scan_interval == 0) {
+      evict_expired(stream);
+    }
+  }
 }
 
 void DynamicEmbeddingTable::assign(const core23::Tensor &keys, size_t num_keys,
@@ -362,6 +693,11 @@ void DynamicEmbeddingTable::assign(const core23::Tensor &keys, size_t num_keys,
       });
 
   if (num_keys > 0) {
+    // The stored rows are assigned in GPU memory.
+    if (offload_param_.enabled()) {
+      stage_rows(keys.data(), num_keys, mapped_id_space_list.data(), id_space_offset_cpu.data(),
+                 num_table_offset - 1, stream);
+    }
     DISPATCH_INTEGRAL_FUNCTION_CORE23(keys.data_type().type(), key_t, [&] {
       // `scatter_add` automatically handles the offsets in `grad_ev_offset` using
       // the embedding vector dimensions given at construction.
@@ -406,10 +742,9 @@ void DynamicEmbeddingTable::dump_by_id(core23::Tensor *h_keys_tensor,
     key_t *d_keys;
     float *d_values;
     auto values_sizes = table->size_per_class();
-    auto key_nums = this->key_num_per_table();
 
-    auto key_num = key_nums[table_index];
     auto values_size = values_sizes[table_index];
+    auto key_num = values_size / dim_per_class_[table_index];
 
     HCTR_LIB_THROW(cudaMalloc(&d_keys, sizeof(key_t) * key_num));
     HCTR_LIB_THROW(cudaMalloc(&d_values, sizeof(float) * values_size));
@@ -426,6 +761,17 @@ void DynamicEmbeddingTable::dump_by_id(core23::Tensor *h_keys_tensor,
     HCTR_LIB_THROW(cudaStreamSynchronize(stream));
     HCTR_LIB_THROW(cudaFree(d_keys));
     HCTR_LIB_THROW(cudaFree(d_values));
+
+    // The offloaded rows follow the rows in GPU memory, without their optimizer states.
+    if (offload_param_.enabled()) {
+      const size_t ev_size = dim_per_class_[table_index];
+      size_t row = key_num;
+      row_stores_[table_index]->for_each([&](uint64_t key, const char *stored_row) {
+        h_keys[row] = static_cast<key_t>(key);
+        std::memcpy(h_values + row * ev_size, stored_row, sizeof(float) * ev_size);
+        ++row;
+      });
+    }
   });
 }
 
@@ -466,9 +812,38 @@ void DynamicEmbeddingTable::load_by_id(core23::Tensor *h_keys_tensor,
                                    cudaMemcpyHostToDevice, stream));
 
     table->scatter_update_by_index(table_index, d_keys, d_values, key_num, stream);
+
+    // The loaded keys are admitted and seen now.
+    if (table_meta_) {
+      std::vector<uint32_t> h_meta(key_num * kMetaDim, 0u);
+      for (size_t i = 0; i < key_num; ++i) {
+        h_meta[i * kMetaDim] = step_;
+        h_meta[i * kMetaDim + 2] = 1u;
+      }
+      float *d_meta;
+      HCTR_LIB_THROW(cudaMalloc(&d_meta, sizeof(float) * h_meta.size()));
+      auto table_meta = cast_table<key_t, float>(table_meta_);
+      table_meta->lookup_by_index(table_index, d_keys, d_meta, key_num, stream);
+      HCTR_LIB_THROW(cudaMemcpyAsync(d_meta, h_meta.data(), sizeof(float) * h_meta.size(),
+                                     cudaMemcpyHostToDevice, stream));
+      table_meta->scatter_update_by_index(table_index, d_keys, d_meta, key_num, stream);
+      HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+      HCTR_LIB_THROW(cudaFree(d_meta));
+    }
+
     HCTR_LIB_THROW(cudaStreamSynchronize(stream));
     HCTR_LIB_THROW(cudaFree(d_keys));
     HCTR_LIB_THROW(cudaFree(d_values));
+
+    // The loaded rows are in GPU memory, and replace the stored ones.
+    if (offload_param_.enabled()) {
+      const std::lock_guard lock(write_mutex_);
+      const std::vector<uint64_t> loaded_keys(h_keys, h_keys + key_num);
+      for (uint64_t key : loaded_keys) {
+        resident_[table_index][key] = num_lookups_;
+      }
+      row_stores_[table_index]->erase(loaded_keys.data(), loaded_keys.size());
+    }
   });
 }
 
@@ -500,6 +875,9 @@ size_t DynamicEmbeddingTable::key_num() const {
       kn += sizes[i] / dim_per_class_[i];
     }
   });
+  for (const auto &row_store : row_stores_) {
+    kn += row_store->size();
+  }
   return kn;
 }
 
@@ -531,6 +909,9 @@ std::vector<size_t> DynamicEmbeddingTable::key_num_per_table() const {
       key_nums.push_back(sizes[i] / dim_per_class_[i]);
     }
   });
+  for (size_t i = 0; i < row_stores_.size(); ++i) {
+    key_nums[i] += row_stores_[i]->size();
+  }
   return key_nums;
 }
 
@@ -551,8 +932,16 @@ void DynamicEmbeddingTable::clear() {
   DISPATCH_INTEGRAL_FUNCTION_CORE23(key_type_.type(), key_t, [&] {
     auto table = cast_table<key_t, float>(table_);
     table->clear(stream);
+    cast_table<key_t, float>(table_opt_states_)->clear(stream);
+    if (table_meta_) {
+      cast_table<key_t, float>(table_meta_)->clear(stream);
+    }
     HCTR_LIB_THROW(cudaStreamSynchronize(stream));
   });
+  for (size_t i = 0; i < row_stores_.size(); ++i) {
+    resident_[i].clear();
+    row_stores_[i]->clear();
+  }
 }
 
 void DynamicEmbeddingTable::evict(const core23::Tensor &keys, size_t num_keys,
@@ -577,12 +966,283 @@ void DynamicEmbeddingTable::evict(const core23::Tensor &keys, size_t num_keys,
     }
   });
 
+  remove(keys.data(), num_keys, mapped_id_space_list.data(), id_space_offset_cpu.data(),
+         num_id_space_offset, stream);
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+
+  // The evicted keys may be offloaded.
+  if (offload_param_.enabled() && num_keys > 0) {
+    const std::vector<uint64_t> keys_cpu = download_keys(keys.data(), num_keys, stream);
+    const std::lock_guard lock(write_mutex_);
+    for (size_t i = 0; i < mapped_id_space_list.size() && i + 1 < id_space_offset_cpu.size();
+         ++i) {
+      const size_t id_space = mapped_id_space_list[i];
+      const size_t begin = id_space_offset_cpu[i];
+      const size_t end = id_space_offset_cpu[i + 1];
+      for (size_t j = begin; j < end; ++j) {
+        resident_[id_space].erase(keys_cpu[j]);
+      }
+      row_stores_[id_space]->erase(keys_cpu.data() + begin, end - begin);
+    }
+  }
+}
+
+void DynamicEmbeddingTable::remove(const void *keys, size_t num_keys, const size_t *id_spaces,
+                                   const size_t *id_space_offsets, size_t num_id_spaces,
+                                   cudaStream_t stream) {
   DISPATCH_INTEGRAL_FUNCTION_CORE23(key_type_.type(), key_t, [&] {
+    auto typed_keys = static_cast<const key_t *>(keys);
+    cast_table<key_t, float>(table_)->remove(typed_keys, num_keys, id_spaces, id_space_offsets,
+                                             num_id_spaces, stream);
+    cast_table<key_t, float>(table_opt_states_)
+        ->remove(typed_keys, num_keys, id_spaces, id_space_offsets, num_id_spaces, stream);
+    if (table_meta_) {
+      cast_table<key_t, float>(table_meta_)
+          ->remove(typed_keys, num_keys, id_spaces, id_space_offsets, num_id_spaces, stream);
+    }
+  });
+}
+
+void DynamicEmbeddingTable::evict_expired(cudaStream_t stream) {
+  const uint32_t ttl =
+      static_cast<uint32_t>(std::min<int64_t>(eviction_param_.ttl_steps, UINT32_MAX));
+  const uint32_t min_frequency =
+      static_cast<uint32_t>(std::min<uint64_t>(eviction_param_.min_frequency, UINT32_MAX));
+
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(key_type_.type(), key_t, [&] {
+    auto table_meta = cast_table<key_t, float>(table_meta_);
+    const std::vector<size_t> sizes = table_meta->size_per_class();
+
+    for (size_t id_space = 0; id_space < sizes.size(); ++id_space) {
+      const size_t num_keys = sizes[id_space] / kMetaDim;
+      if (num_keys == 0) {
+        continue;
+      }
+
+      key_t *d_keys;
+      float *d_meta;
+      char *d_expired;
+      key_t *d_expired_keys;
+      int *d_num_expired;
+      HCTR_LIB_THROW(cudaMalloc(&d_keys, sizeof(key_t) * num_keys));
+      HCTR_LIB_THROW(cudaMalloc(&d_meta, sizeof(float) * sizes[id_space]));
+      HCTR_LIB_THROW(cudaMalloc(&d_expired, num_keys));
+      HCTR_LIB_THROW(cudaMalloc(&d_expired_keys, sizeof(key_t) * num_keys));
+      HCTR_LIB_THROW(cudaMalloc(&d_num_expired, sizeof(int)));
+
+      table_meta->eXport(id_space, d_keys, d_meta, num_keys, stream);
+      constexpr int block_size = 256;
+      expire_meta_kernel<<<grid_size_of(num_keys, block_size), block_size, 0, stream>>>(
+          d_meta, num_keys, step_, ttl, min_frequency, d_expired);
+      table_meta->scatter_update_by_index(id_space, d_keys, d_meta, num_keys, stream);
+
+      size_t temp_bytes = 0;
+      HCTR_LIB_THROW(cub::DeviceSelect::Flagged(nullptr, temp_bytes, d_keys, d_expired,
+                                                d_expired_keys, d_num_expired,
+                                                static_cast<int>(num_keys), stream));
+      void *d_temp;
+      HCTR_LIB_THROW(cudaMalloc(&d_temp, temp_bytes));
+      HCTR_LIB_THROW(cub::DeviceSelect::Flagged(d_temp, temp_bytes, d_keys, d_expired,
+                                                d_expired_keys, d_num_expired,
+                                                static_cast<int>(num_keys), stream));
+      int num_expired;
+      HCTR_LIB_THROW(cudaMemcpyAsync(&num_expired, d_num_expired, sizeof(int),
+                                     cudaMemcpyDeviceToHost, stream));
+      HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+
+      // The pending keys have no rows, removing them from the other tables is a no-op.
+      if (num_expired > 0) {
+        const size_t expired_offsets[2] = {0, static_cast<size_t>(num_expired)};
+        remove(d_expired_keys, num_expired, &id_space, expired_offsets, 1, stream);
+        // Only the rows in GPU memory expire, the offloaded rows are not looked up meanwhile.
+        if (offload_param_.enabled()) {
+          for (uint64_t key : download_keys(d_expired_keys, num_expired, stream)) {
+            resident_[id_space].erase(key);
+          }
+        }
+      }
+      HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+      HCTR_LIB_THROW(cudaFree(d_keys));
+      HCTR_LIB_THROW(cudaFree(d_meta));
+      HCTR_LIB_THROW(cudaFree(d_expired));
+      HCTR_LIB_THROW(cudaFree(d_expired_keys));
+      HCTR_LIB_THROW(cudaFree(d_num_expired));
+      HCTR_LIB_THROW(cudaFree(d_temp));
+    }
+  });
+}
+
+std::vector<uint64_t> DynamicEmbeddingTable::download_keys(const void *keys, size_t num_keys,
+                                                           cudaStream_t stream) {
+  std::vector<uint64_t> keys_cpu(num_keys);
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(key_type_.type(), key_t, [&] {
+    std::vector<key_t> typed_keys_cpu(num_keys);
+    HCTR_LIB_THROW(cudaMemcpyAsync(typed_keys_cpu.data(), keys, sizeof(key_t) * num_keys,
+                                   cudaMemcpyDeviceToHost, stream));
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    std::transform(typed_keys_cpu.begin(), typed_keys_cpu.end(), keys_cpu.begin(),
+                   [](key_t key) { return static_cast<uint64_t>(key); });
+  });
+  return keys_cpu;
+}
+
+void DynamicEmbeddingTable::stage_rows(const void *keys, size_t num_keys,
+                                       const size_t *id_spaces, const size_t *id_space_offsets,
+                                       size_t num_id_spaces, cudaStream_t stream) {
+  const std::vector<uint64_t> keys_cpu = download_keys(keys, num_keys, stream);
+
+  // Like an update, staging changes the rows.
+  const std::lock_guard lock(write_mutex_);
+  const uint32_t lookup = ++num_lookups_;
+  const size_t max_rows = static_cast<size_t>(offload_param_.max_gpu_rows);
+
+  for (size_t i = 0; i < num_id_spaces; ++i) {
+    const size_t id_space = id_spaces[i];
+    auto &resident = resident_[id_space];
+    const SSDRowStore &row_store = *row_stores_[id_space];
+
+    std::vector<uint64_t> promoted_keys;
+    for (size_t j = id_space_offsets[i]; j < id_space_offsets[i + 1]; ++j) {
+      const uint64_t key = keys_cpu[j];
+      auto [it, inserted] = resident.try_emplace(key, lookup);
+      if (!inserted) {
+        it->second = lookup;
+      } else if (row_store.contains(key)) {
+        promoted_keys.push_back(key);
+      }
+    }
+
+    // Offloads down to 90% of `max_rows`, so that the scan for the least recently looked up rows
+    // is amortized over several lookups. The rows of this lookup and of the previous one are kept,
+    // the previous batch may still be updated with lookahead.
+    if (resident.size() > max_rows) {
+      std::vector<std::pair<uint32_t, uint64_t>> candidates;
+      for (const auto &[key, last_lookup] : resident) {
+        if (last_lookup + 1 < lookup) {
+          candidates.emplace_back(last_lookup, key);
+        }
+      }
+      const size_t num_offloaded =
+          std::min(resident.size() - (max_rows - max_rows / 10), candidates.size());
+      if (num_offloaded > 0) {
+        std::nth_element(candidates.begin(), candidates.begin() + (num_offloaded - 1),
+                         candidates.end());
+        std::vector<uint64_t> offloaded_keys;
+        offloaded_keys.reserve(num_offloaded);
+        for (size_t k = 0; k < num_offloaded; ++k) {
+          offloaded_keys.push_back(candidates[k].second);
+          resident.erase(candidates[k].second);
+        }
+        offload_rows(id_space, offloaded_keys, stream);
+      }
+    }
+
+    if (!promoted_keys.empty()) {
+      promote_rows(id_space, promoted_keys, stream);
+    }
+  }
+}
+
+void DynamicEmbeddingTable::offload_rows(size_t id_space, const std::vector<uint64_t> &keys,
+                                         cudaStream_t stream) {
+  const size_t num_keys = keys.size();
+  const size_t ev_size = dim_per_class_[id_space];
+  const size_t opt_dim = opt_dim_per_class_[id_space];
+  const size_t offsets[2] = {0, num_keys};
+
+  std::vector<float> h_weights(num_keys * ev_size);
+  std::vector<float> h_opt_states(num_keys * opt_dim);
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(key_type_.type(), key_t, [&] {
+    const std::vector<key_t> h_keys(keys.begin(), keys.end());
+    key_t *d_keys;
+    float *d_values;
+    HCTR_LIB_THROW(cudaMalloc(&d_keys, sizeof(key_t) * num_keys));
+    HCTR_LIB_THROW(cudaMalloc(&d_values, sizeof(float) * num_keys * std::max(ev_size, opt_dim)));
+    HCTR_LIB_THROW(cudaMemcpyAsync(d_keys, h_keys.data(), sizeof(key_t) * num_keys,
+                                   cudaMemcpyHostToDevice, stream));
+
+    cast_table<key_t, float>(table_)->lookup(d_keys, d_values, num_keys, &id_space, offsets, 1,
+                                             stream);
+    HCTR_LIB_THROW(cudaMemcpyAsync(h_weights.data(), d_values, sizeof(float) * h_weights.size(),
+                                   cudaMemcpyDeviceToHost, stream));
+    if (opt_dim > 0) {
+      cast_table<key_t, float>(table_opt_states_)
+          ->lookup(d_keys, d_values, num_keys, &id_space, offsets, 1, stream);
+      HCTR_LIB_THROW(cudaMemcpyAsync(h_opt_states.data(), d_values,
+                                     sizeof(float) * h_opt_states.size(), cudaMemcpyDeviceToHost,
+                                     stream));
+    }
+    remove(d_keys, num_keys, &id_space, offsets, 1, stream);
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    HCTR_LIB_THROW(cudaFree(d_keys));
+    HCTR_LIB_THROW(cudaFree(d_values));
+  });
+
+  // A stored row is the weights followed by the optimizer states.
+  SSDRowStore &row_store = *row_stores_[id_space];
+  std::vector<char> rows(num_keys * row_store.row_bytes());
+  for (size_t i = 0; i < num_keys; ++i) {
+    char *row = rows.data() + i * row_store.row_bytes();
+    std::memcpy(row, &h_weights[i * ev_size], sizeof(float) * ev_size);
+    std::memcpy(row + sizeof(float) * ev_size, &h_opt_states[i * opt_dim],
+                sizeof(float) * opt_dim);
+  }
+  row_store.put(keys.data(), num_keys, rows.data());
+}
+
+void DynamicEmbeddingTable::promote_rows(size_t id_space, const std::vector<uint64_t> &keys,
+                                         cudaStream_t stream) {
+  const size_t num_keys = keys.size();
+  const size_t ev_size = dim_per_class_[id_space];
+  const size_t opt_dim = opt_dim_per_class_[id_space];
+  const size_t offsets[2] = {0, num_keys};
+
+  SSDRowStore &row_store = *row_stores_[id_space];
+  std::vector<char> rows(num_keys * row_store.row_bytes());
+  row_store.get(keys.data(), num_keys, rows.data());
+  std::vector<float> h_weights(num_keys * ev_size);
+  std::vector<float> h_opt_states(num_keys * opt_dim);
+  for (size_t i = 0; i < num_keys; ++i) {
+    const char *row = rows.data() + i * row_store.row_bytes();
+    std::memcpy(&h_weights[i * ev_size], row, sizeof(float) * ev_size);
+    std::memcpy(&h_opt_states[i * opt_dim], row + sizeof(float) * ev_size,
+                sizeof(float) * opt_dim);
+  }
+
+  // Like `load_by_id`, the lookups insert the rows that the updates overwrite.
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(key_type_.type(), key_t, [&] {
+    const std::vector<key_t> h_keys(keys.begin(), keys.end());
+    key_t *d_keys;
+    float *d_weights;
+    float *d_opt_states = nullptr;
+    HCTR_LIB_THROW(cudaMalloc(&d_keys, sizeof(key_t) * num_keys));
+    HCTR_LIB_THROW(cudaMalloc(&d_weights, sizeof(float) * h_weights.size()));
+    HCTR_LIB_THROW(cudaMemcpyAsync(d_keys, h_keys.data(), sizeof(key_t) * num_keys,
+                                   cudaMemcpyHostToDevice, stream));
+
     auto table = cast_table<key_t, float>(table_);
-    table->remove(keys.data<key_t>(), num_keys, mapped_id_space_list.data(),
-                  id_space_offset_cpu.data(), num_id_space_offset, stream);
+    table->lookup(d_keys, d_weights, num_keys, &id_space, offsets, 1, stream);
+    HCTR_LIB_THROW(cudaMemcpyAsync(d_weights, h_weights.data(), sizeof(float) * h_weights.size(),
+                                   cudaMemcpyHostToDevice, stream));
+    table->scatter_update(d_keys, d_weights, num_keys, &id_space, offsets, 1, stream);
+    if (opt_dim > 0) {
+      HCTR_LIB_THROW(cudaMalloc(&d_opt_states, sizeof(float) * h_opt_states.size()));
+      auto table_opt_states = cast_table<key_t, float>(table_opt_states_);
+      table_opt_states->lookup(d_keys, d_opt_states, num_keys, &id_space, offsets, 1, stream);
+      HCTR_LIB_THROW(cudaMemcpyAsync(d_opt_states, h_opt_states.data(),
+                                     sizeof(float) * h_opt_states.size(), cudaMemcpyHostToDevice,
+                                     stream));
+      table_opt_states->scatter_update(d_keys, d_opt_states, num_keys, &id_space, offsets, 1,
+                                       stream);
+    }
     HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    HCTR_LIB_THROW(cudaFree(d_keys));
+    HCTR_LIB_THROW(cudaFree(d_weights));
+    if (d_opt_states) {
+      HCTR_LIB_THROW(cudaFree(d_opt_states));
+    }
   });
+  row_store.erase(keys.data(), num_keys);
 }
 
 }  // namespace embedding
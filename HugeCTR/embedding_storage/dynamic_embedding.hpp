@@ -16,8 +16,11 @@
 #pragma once
 
 #include <embedding_storage/embedding_table.hpp>
+#include <embedding_storage/ssd_row_store.hpp>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <unordered_map>
 
 namespace embedding {
 
@@ -35,11 +38,63 @@ class DynamicEmbeddingTable final : public IDynamicEmbeddingTable {
   std::vector<int> h_table_ids_;
 
   HugeCTR::OptParams opt_param_;
+  const float *device_lr_ = nullptr;
   void *table_opt_states_;
 
   std::unique_ptr<core23::Tensor> opt_state_view_;
   std::unique_ptr<core23::Tensor> weight_view_;
 
+  // Eviction. `table_meta_` holds [last seen step, lookups since the last scan, admitted] of every
+  // key looked up, as uint32 in float slots. The steps count the updates of the table.
+  DynamicEvictionParams eviction_param_;
+  void *table_meta_ = nullptr;
+  uint32_t step_ = 0;
+  core23::Tensor meta_view_;
+  core23::Tensor admitted_;
+  // Scratch of the admitted keys, only allocated with an admission threshold.
+  core23::Tensor admitted_indices_;
+  core23::Tensor admitted_keys_;
+  core23::Tensor admitted_evs_;
+  core23::Tensor admitted_ev_start_indices_;
+  core23::Tensor admitted_wgrad_;
+  core23::Tensor default_ev_;  // zeros, looked up by the keys that are not admitted yet
+
+  // Looks up the metadata of the keys into `meta_view_`, stamping and counting them if `count`.
+  void lookup_meta(const void *keys, size_t num_keys, const size_t *id_spaces,
+                   const size_t *id_space_offsets, size_t num_id_spaces, bool count,
+                   cudaStream_t stream);
+
+  // Downloads the admitted flags of the keys of the last `lookup_meta`.
+  std::vector<char> admitted(size_t num_keys, cudaStream_t stream);
+
+  // Removes the keys from the weights, the optimizer states and the eviction metadata.
+  void remove(const void *keys, size_t num_keys, const size_t *id_spaces,
+              const size_t *id_space_offsets, size_t num_id_spaces, cudaStream_t stream);
+
+  // Evicts the expired and infrequent rows and forgets the keys pending admission.
+  void evict_expired(cudaStream_t stream);
+
+  // Offload. The GPU holds at most `offload_param_.max_gpu_rows` rows per table, the least
+  // recently looked up rows are moved with their optimizer states to a row store per table.
+  // `resident_` maps the keys with a row in GPU memory to their last lookup, per local id space.
+  DynamicOffloadParams offload_param_;
+  std::vector<size_t> opt_dim_per_class_;
+  uint32_t num_lookups_ = 0;
+  std::vector<std::unordered_map<uint64_t, uint32_t>> resident_;
+  std::vector<std::unique_ptr<SSDRowStore>> row_stores_;
+
+  // Moves the stored rows of the keys to the GPU, and the least recently looked up rows to the
+  // stores if the tables would exceed `max_gpu_rows`.
+  void stage_rows(const void *keys, size_t num_keys, const size_t *id_spaces,
+                  const size_t *id_space_offsets, size_t num_id_spaces, cudaStream_t stream);
+
+  void offload_rows(size_t id_space, const std::vector<uint64_t> &keys, cudaStream_t stream);
+
+  void promote_rows(size_t id_space, const std::vector<uint64_t> &keys, cudaStream_t stream);
+
+  // Downloads keys of the key type as uint64.
+  std::vector<uint64_t> download_keys(const void *keys, size_t num_keys, cudaStream_t stream);
+
  public:
   DynamicEmbeddingTable(const HugeCTR::GPUResource &gpu_resource,
                         std::shared_ptr<CoreResourceManager> core,
@@ -76,6 +131,19 @@ class DynamicEmbeddingTable final : public IDynamicEmbeddingTable {
   void load_by_id(core23::Tensor *h_keys_tensor, core23::Tensor *h_embedding_table,
                   int table_id) override;
 
+  std::vector<size_t> dirty_key_num_per_table() const override { return key_num_per_table(); }
+
+  void dump_dirty_by_id(core23::Tensor *h_keys_tensor, core23::Tensor *h_embedding_table,
+                        int table_id) override {
+    dump_by_id(h_keys_tensor, h_embedding_table, table_id);
+  }
+
+  void dump_update_counts_by_id(core23::Tensor *h_update_counts, int table_id) override {
+    HCTR_OWN_THROW(HugeCTR::Error_t::IllegalCall,
+                   "Dynamic embedding tables do not count the updates of their rows, their rows "
+                   "are pruned by eviction.");
+  }
+
   size_t size() const override;
 
   size_t capacity() const override;
@@ -98,6 +166,8 @@ class DynamicEmbeddingTable final : public IDynamicEmbeddingTable {
              size_t num_id_space_offset, const core23::Tensor &id_space_list) override;
 
   void set_learning_rate(float lr) override { opt_param_.lr = lr; }
+
+  void set_device_learning_rate(const float *lr) override { device_lr_ = lr; }
 };
 
 }  // namespace embedding
@@ -119,7 +119,8 @@ class DynamicEmbeddingTableCPU final : public IDynamicEmbeddingTable {
       const size_t ev_size = table_params.at(table_id).ev_size;
       weights_.emplace_back(std::make_unique<WeightIDSpace>(ev_size));
       opt_states_.emplace_back(
-          std::make_unique<OptStateIDSpace>(ev_size * opt_param.num_parameters_per_weight()));
+          std::make_unique<OptStateIDSpace>(ev_size * opt_param.num_parameters_per_weight() +
+                                            opt_param.num_parameters_per_row()));
     }
   }
 
@@ -260,7 +261,7 @@ class DynamicEmbeddingTableCPU final : public IDynamicEmbeddingTable {
 
     // Apply optimizers.
     {
-      const float lr = opt_param_.lr;
+      const float lr = opt_param_.lr * opt_param_.lr_multiplier;
       const float scaler = opt_param_.scaler;
 
       switch (opt_param_.optimizer) {
@@ -270,7 +271,7 @@ class DynamicEmbeddingTableCPU final : public IDynamicEmbeddingTable {
 
           const float lambda1 = opt_param_.hyperparams.ftrl.lambda1;
           const float lambda2_plus_beta_div_lr = opt_param_.hyperparams.ftrl.lambda2 +
-                                                 opt_param_.hyperparams.ftrl.beta / opt_param_.lr;
+                                                 opt_param_.hyperparams.ftrl.beta / lr;
           for (uint32_t i = 0; i < k.size(); ++i) {
             ftrl_update_grad(i, g_off.data(), lr, lambda1, lambda2_plus_beta_div_lr, s.data(),
                              w.data(), scaler, g.data());
@@ -281,7 +282,7 @@ class DynamicEmbeddingTableCPU final : public IDynamicEmbeddingTable {
           std::vector<float*> s = gather_opt_states(k, is_off, is);
 
           ++opt_param_.hyperparams.adam.times;
-          const float lr_scaled_bias = opt_param_.lr * opt_param_.hyperparams.adam.bias();
+          const float lr_scaled_bias = lr * opt_param_.hyperparams.adam.bias();
           const float beta1 = opt_param_.hyperparams.adam.beta1;
           const float beta2 = opt_param_.hyperparams.adam.beta2;
           const float epsilon = opt_param_.hyperparams.adam.epsilon;
@@ -310,6 +311,28 @@ class DynamicEmbeddingTableCPU final : public IDynamicEmbeddingTable {
           }
         } break;
 
+        case HugeCTR::Optimizer_t::RowWiseAdaGrad: {
+          std::vector<float*> s = gather_opt_states(k, is_off, is);
+
+          const float epsilon = opt_param_.hyperparams.adagrad.epsilon;
+          for (uint32_t i = 0; i < k.size(); ++i) {
+            row_wise_ada_grad_update_grad(i, g_off.data(), lr, s.data(), epsilon, scaler,
+                                          g.data());
+          }
+        } break;
+
+        case HugeCTR::Optimizer_t::LazyAdam: {
+          std::vector<float*> s = gather_opt_states(k, is_off, is);
+
+          const float beta1 = opt_param_.hyperparams.adam.beta1;
+          const float beta2 = opt_param_.hyperparams.adam.beta2;
+          const float epsilon = opt_param_.hyperparams.adam.epsilon;
+          for (uint32_t i = 0; i < k.size(); ++i) {
+            lazy_adam_update_grad(i, g_off.data(), lr, beta1, beta2, s.data(), epsilon, scaler,
+                                  g.data());
+          }
+        } break;
+
         case HugeCTR::Optimizer_t::MomentumSGD: {
           std::vector<float*> s = gather_opt_states(k, is_off, is);
 
@@ -404,6 +427,15 @@ class DynamicEmbeddingTableCPU final : public IDynamicEmbeddingTable {
     throw std::runtime_error("Not implemented yet!");
   }
 
+  std::vector<size_t> dirty_key_num_per_table() const override {
+    throw std::runtime_error("Not implemented yet!");
+  }
+
+  void dump_dirty_by_id(core23::Tensor* h_keys_tensor, core23::Tensor* h_embedding_table,
+                        int table_id) override {
+    throw std::runtime_error("Not implemented yet!");
+  }
+
   void dump(core23::Tensor* keys, core23::Tensor* id_space_offset, core23::Tensor* embedding_table,
             core23::Tensor* ev_size_list, core23::Tensor* id_space) override {
     throw std::runtime_error("Not implemented yet!");
@@ -480,6 +512,11 @@ class DynamicEmbeddingTableCPU final : public IDynamicEmbeddingTable {
   }
 
   void set_learning_rate(float lr) override { opt_param_.lr = lr; }
+
+  void set_device_learning_rate(const float* lr) override {
+    HCTR_OWN_THROW(HugeCTR::Error_t::IllegalCall,
+                   "the CPU dynamic embedding table does not support a device learning rate");
+  }
 };
 
 }  // namespace embedding
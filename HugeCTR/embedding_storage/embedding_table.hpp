@@ -50,6 +50,17 @@ class IGroupedEmbeddingTable : public ILookup {
   virtual void load_by_id(core23::Tensor *h_keys_tensor, core23::Tensor *h_embedding_table,
                           int table_id) = 0;
 
+  // The rows updated since the last dump_dirty_by_id of their table. The tables that do not track
+  // their updates report all of their rows.
+  virtual std::vector<size_t> dirty_key_num_per_table() const = 0;
+
+  virtual void dump_dirty_by_id(core23::Tensor *h_keys_tensor, core23::Tensor *h_embedding_table,
+                                int table_id) = 0;
+
+  // The number of updates of each row of a table, saturated at 255, in the order of dump_by_id.
+  // Used to prune the rows that were rarely trained.
+  virtual void dump_update_counts_by_id(core23::Tensor *h_update_counts, int table_id) = 0;
+
   virtual size_t size() const = 0;
 
   virtual size_t capacity() const = 0;
@@ -69,6 +80,10 @@ class IGroupedEmbeddingTable : public ILookup {
   virtual void clear() = 0;
 
   virtual void set_learning_rate(float lr) = 0;
+
+  // The update reads the learning rate from lr, a float in device memory, instead of the one set
+  // by set_learning_rate. Either way it is multiplied by the lr_multiplier of the table.
+  virtual void set_device_learning_rate(const float *lr) = 0;
 };
 
 class IDynamicEmbeddingTable : public IGroupedEmbeddingTable {
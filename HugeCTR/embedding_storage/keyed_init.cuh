@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <cuco/initializer.cuh>
+#include <embedding_storage/common.hpp>
+
+namespace embedding {
+
+// Seed of the rows of a table drawn from their keys. The table id is mixed in by SplitMix64, so
+// that two tables with the same keys start with different rows.
+inline unsigned long long table_init_seed(unsigned long long seed, int table_id) {
+  uint64_t x = seed + 0x9e3779b97f4a7c15ULL * (static_cast<uint64_t>(table_id) + 1);
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+// Initializer of the rows of a table from their keys, uniform in (-up_bound, up_bound] with the
+// up_bound of init_param, or default_up_bound for the default initializer. A row gets the same
+// values on any GPU and under any sharding, so the GPUs do not need to agree on a generator state.
+inline cuco::initializer keyed_initializer(const InitParams &init_param,
+                                           unsigned long long table_seed, float default_up_bound) {
+  float up_bound = default_up_bound;
+  if (init_param.initializer_type == HugeCTR::Initializer_t::Uniform) {
+    up_bound = init_param.uniform_params.up_bound;
+  } else if (init_param.initializer_type != HugeCTR::Initializer_t::Default) {
+    HCTR_OWN_THROW(HugeCTR::Error_t::IllegalCall, "initializer can not be drawn from the keys");
+  }
+  return cuco::initializer(table_seed, -up_bound, up_bound);
+}
+
+}  // namespace embedding
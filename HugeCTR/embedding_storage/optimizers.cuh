@@ -15,25 +15,40 @@
  */
 #pragma once
 #include <core23/data_type_helpers.cuh>
+#include <utils.cuh>
 
 namespace embedding {
 namespace {
 
+// The update kernels run one warp per unique embedding vector, whose lanes stride over its
+// elements, so that the accesses of a warp are coalesced and a wide vector is not updated
+// serially by one thread. Their learning rate is lr, times *device_lr unless it is null. The
+// row-wise optimizers sum the squared gradients of a vector over the lanes of its warp.
+constexpr int kUpdateWarpSize = 32;
+
+inline int update_grid_size(size_t num_ev, int block_size) {
+  return (static_cast<int64_t>(num_ev) * kUpdateWarpSize - 1) / block_size + 1;
+}
+
 /**
  * SGD (Stateless)
  * ---------------
  * g_i = -eta * g_i / s
  */
 template <typename wgrad_t>
-__global__ void sgd_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_ev, float lr,
-                                       float scaler, wgrad_t* g) {
-  uint32_t tid = blockIdx.x * blockDim.x + threadIdx.x;
+__global__ void sgd_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_ev,
+                                       const float* device_lr, float lr, float scaler,
+                                       wgrad_t* g) {
+  const uint64_t thread_id = blockIdx.x * static_cast<uint64_t>(blockDim.x) + threadIdx.x;
+  const uint32_t tid = thread_id / kUpdateWarpSize;
+  const uint32_t lane_id = thread_id % kUpdateWarpSize;
   if (tid >= num_ev) return;
+  if (device_lr) lr *= *device_lr;
 
   uint32_t start = ev_offsets[tid];
   uint32_t end = ev_offsets[tid + 1];
 
-  for (uint32_t i = start; i < end; ++i) {
+  for (uint32_t i = start + lane_id; i < end; i += kUpdateWarpSize) {
     float gi = core23::TypeConverter<float, wgrad_t>::value(g[i]) / scaler;
 
     g[i] = core23::TypeConverter<wgrad_t, float>::value(-lr * gi);
@@ -47,18 +62,21 @@ __global__ void sgd_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_
  * g_i = -eta * v_i
  */
 template <typename wgrad_t>
-__global__ void momentum_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_ev, float lr,
-                                            float momentum_decay, float** state_tensors,
-                                            float scaler, wgrad_t* g) {
-  uint32_t tid = blockIdx.x * blockDim.x + threadIdx.x;
+__global__ void momentum_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_ev,
+                                            const float* device_lr, float lr, float momentum_decay,
+                                            float** state_tensors, float scaler, wgrad_t* g) {
+  const uint64_t thread_id = blockIdx.x * static_cast<uint64_t>(blockDim.x) + threadIdx.x;
+  const uint32_t tid = thread_id / kUpdateWarpSize;
+  const uint32_t lane_id = thread_id % kUpdateWarpSize;
   if (tid >= num_ev) return;
+  if (device_lr) lr *= *device_lr;
 
   uint32_t start = ev_offsets[tid];
   uint32_t end = ev_offsets[tid + 1];
 
   float* m = state_tensors[tid] - start;
 
-  for (uint32_t i = start; i < end; ++i) {
+  for (uint32_t i = start + lane_id; i < end; i += kUpdateWarpSize) {
     float gi = core23::TypeConverter<float, wgrad_t>::value(g[i]) / scaler;
     float mi = m[i] = momentum_decay * m[i] - lr * gi;
 
@@ -75,18 +93,21 @@ __global__ void momentum_update_grad_kernel(const uint32_t* ev_offsets, uint32_t
  * g_i = -eta * v_i
  */
 template <typename wgrad_t>
-__global__ void nesterov_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_ev, float lr,
-                                            float momentum_decay, float** state_tensors,
-                                            float scaler, wgrad_t* g) {
-  uint32_t tid = blockIdx.x * blockDim.x + threadIdx.x;
+__global__ void nesterov_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_ev,
+                                            const float* device_lr, float lr, float momentum_decay,
+                                            float** state_tensors, float scaler, wgrad_t* g) {
+  const uint64_t thread_id = blockIdx.x * static_cast<uint64_t>(blockDim.x) + threadIdx.x;
+  const uint32_t tid = thread_id / kUpdateWarpSize;
+  const uint32_t lane_id = thread_id % kUpdateWarpSize;
   if (tid >= num_ev) return;
+  if (device_lr) lr *= *device_lr;
 
   uint32_t start = ev_offsets[tid];
   uint32_t end = ev_offsets[tid + 1];
 
   float* m = state_tensors[tid] - start;
 
-  for (uint32_t i = start; i < end; ++i) {
+  for (uint32_t i = start + lane_id; i < end; i += kUpdateWarpSize) {
     float gi = core23::TypeConverter<float, wgrad_t>::value(g[i]) / scaler;
     float mi_prev = m[i];
     float mi = m[i] = momentum_decay * mi_prev - lr * gi;
@@ -104,18 +125,22 @@ __global__ void nesterov_update_grad_kernel(const uint32_t* ev_offsets, uint32_t
  * g_i = -eta * g_i / (sqrt(v_i) + epsilon)
  */
 template <typename wgrad_t>
-__global__ void ada_grad_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_ev, float lr,
+__global__ void ada_grad_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_ev,
+                                            const float* device_lr, float lr,
                                             float** state_tensors, float epsilon, float scaler,
                                             wgrad_t* g) {
-  uint32_t tid = blockIdx.x * blockDim.x + threadIdx.x;
+  const uint64_t thread_id = blockIdx.x * static_cast<uint64_t>(blockDim.x) + threadIdx.x;
+  const uint32_t tid = thread_id / kUpdateWarpSize;
+  const uint32_t lane_id = thread_id % kUpdateWarpSize;
   if (tid >= num_ev) return;
+  if (device_lr) lr *= *device_lr;
 
   uint32_t start = ev_offsets[tid];
   uint32_t end = ev_offsets[tid + 1];
 
   float* v = state_tensors[tid] - start;
 
-  for (uint32_t i = start; i < end; ++i) {
+  for (uint32_t i = start + lane_id; i < end; i += kUpdateWarpSize) {
     float gi = core23::TypeConverter<float, wgrad_t>::value(g[i]) / scaler;
     float vi = v[i] = v[i] + gi * gi;
 
@@ -123,6 +148,45 @@ __global__ void ada_grad_update_grad_kernel(const uint32_t* ev_offsets, uint32_t
   }
 }
 
+/**
+ * Row-wise AdaGrad
+ * ----------------
+ * g_i = g_i / s
+ * v = v + mean(g_i^2)
+ * g_i = -eta * g_i / (sqrt(v) + epsilon)
+ */
+template <typename wgrad_t>
+__global__ void row_wise_ada_grad_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_ev,
+                                                     const float* device_lr, float lr,
+                                                     float** state_tensors, float epsilon,
+                                                     float scaler, wgrad_t* g) {
+  const uint64_t thread_id = blockIdx.x * static_cast<uint64_t>(blockDim.x) + threadIdx.x;
+  const uint32_t tid = thread_id / kUpdateWarpSize;
+  const uint32_t lane_id = thread_id % kUpdateWarpSize;
+  if (tid >= num_ev) return;
+  if (device_lr) lr *= *device_lr;
+
+  uint32_t start = ev_offsets[tid];
+  uint32_t end = ev_offsets[tid + 1];
+
+  float* v = state_tensors[tid];
+  float vi = *v;
+
+  float sum_gi_sq = 0.f;
+  for (uint32_t i = start + lane_id; i < end; i += kUpdateWarpSize) {
+    float gi = core23::TypeConverter<float, wgrad_t>::value(g[i]) / scaler;
+    sum_gi_sq += gi * gi;
+  }
+  vi += HugeCTR::warpReduceSum(sum_gi_sq) / (end - start);
+  if (lane_id == 0) *v = vi;
+
+  for (uint32_t i = start + lane_id; i < end; i += kUpdateWarpSize) {
+    float gi = core23::TypeConverter<float, wgrad_t>::value(g[i]) / scaler;
+
+    g[i] = core23::TypeConverter<wgrad_t, float>::value(-lr * gi / (sqrtf(vi) + epsilon));
+  }
+}
+
 /**
  * RMSProp
  * -------
@@ -131,18 +195,22 @@ __global__ void ada_grad_update_grad_kernel(const uint32_t* ev_offsets, uint32_t
  * g_i = -eta * g_i / (sqrt(v_i) + epsilon)
  */
 template <typename wgrad_t>
-__global__ void rms_prop_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_ev, float lr,
-                                            float beta, float** state_tensors, float epsilon,
-                                            float scaler, wgrad_t* g) {
-  uint32_t tid = blockIdx.x * blockDim.x + threadIdx.x;
+__global__ void rms_prop_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_ev,
+                                            const float* device_lr, float lr, float beta,
+                                            float** state_tensors, float epsilon, float scaler,
+                                            wgrad_t* g) {
+  const uint64_t thread_id = blockIdx.x * static_cast<uint64_t>(blockDim.x) + threadIdx.x;
+  const uint32_t tid = thread_id / kUpdateWarpSize;
+  const uint32_t lane_id = thread_id % kUpdateWarpSize;
   if (tid >= num_ev) return;
+  if (device_lr) lr *= *device_lr;
 
   uint32_t start = ev_offsets[tid];
   uint32_t end = ev_offsets[tid + 1];
 
   float* v = state_tensors[tid] - start;
 
-  for (uint32_t i = start; i < end; ++i) {
+  for (uint32_t i = start + lane_id; i < end; i += kUpdateWarpSize) {
     float gi = core23::TypeConverter<float, wgrad_t>::value(g[i]) / scaler;
     float vi = v[i] = beta * v[i] + (1.f - beta) * gi * gi;
 
@@ -164,11 +232,14 @@ __global__ void rms_prop_update_grad_kernel(const uint32_t* ev_offsets, uint32_t
  */
 template <typename wgrad_t>
 __global__ void adam_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_ev,
-                                        float lr_scaled_bias, float beta1, float beta2,
-                                        float** state_tensors, float epsilon, float scaler,
-                                        wgrad_t* g) {
-  uint32_t tid = blockIdx.x * blockDim.x + threadIdx.x;
+                                        const float* device_lr, float lr_scaled_bias, float beta1,
+                                        float beta2, float** state_tensors, float epsilon,
+                                        float scaler, wgrad_t* g) {
+  const uint64_t thread_id = blockIdx.x * static_cast<uint64_t>(blockDim.x) + threadIdx.x;
+  const uint32_t tid = thread_id / kUpdateWarpSize;
+  const uint32_t lane_id = thread_id % kUpdateWarpSize;
   if (tid >= num_ev) return;
+  if (device_lr) lr_scaled_bias *= *device_lr;
 
   uint32_t start = ev_offsets[tid];
   uint32_t end = ev_offsets[tid + 1];
@@ -176,7 +247,7 @@ __global__ void adam_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num
   float* m = state_tensors[tid] - start;
   float* v = m + end - start;
 
-  for (uint32_t i = start; i < end; ++i) {
+  for (uint32_t i = start + lane_id; i < end; i += kUpdateWarpSize) {
     float gi = core23::TypeConverter<float, wgrad_t>::value(g[i]) / scaler;
     float mi = m[i] = beta1 * m[i] + (1.f - beta1) * gi;
     float vi = v[i] = beta2 * v[i] + (1.f - beta2) * gi * gi;
@@ -186,6 +257,59 @@ __global__ void adam_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num
   }
 }
 
+/**
+ * Lazy Adam
+ * ---------
+ * g_i = g_i / s
+ * t = t + 1
+ * m_i = beta_1 * m_i + (1 - beta_1) * g_i
+ * v = beta_2 * v + (1 - beta_2) * mean(g_i^2)
+ *
+ * g_i = -eta * sqrt(1 - beta_2^t) / (1 - beta_1^t) * m_i / (sqrt(v) + epsilon)
+ *
+ * The state of a vector is [m_0, ..., m_n-1, v, t], t counts the updates of the vector.
+ */
+template <typename wgrad_t>
+__global__ void lazy_adam_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_ev,
+                                             const float* device_lr, float lr, float beta1,
+                                             float beta2, float** state_tensors, float epsilon,
+                                             float scaler, wgrad_t* g) {
+  const uint64_t thread_id = blockIdx.x * static_cast<uint64_t>(blockDim.x) + threadIdx.x;
+  const uint32_t tid = thread_id / kUpdateWarpSize;
+  const uint32_t lane_id = thread_id % kUpdateWarpSize;
+  if (tid >= num_ev) return;
+  if (device_lr) lr *= *device_lr;
+
+  uint32_t start = ev_offsets[tid];
+  uint32_t end = ev_offsets[tid + 1];
+
+  float* m = state_tensors[tid] - start;
+  float* v = m + end;
+  float* t = v + 1;
+  float vi = *v;
+  const float ti = *t + 1.f;
+
+  float sum_gi_sq = 0.f;
+  for (uint32_t i = start + lane_id; i < end; i += kUpdateWarpSize) {
+    float gi = core23::TypeConverter<float, wgrad_t>::value(g[i]) / scaler;
+    sum_gi_sq += gi * gi;
+  }
+  vi = beta2 * vi + (1.f - beta2) * HugeCTR::warpReduceSum(sum_gi_sq) / (end - start);
+  if (lane_id == 0) {
+    *v = vi;
+    *t = ti;
+  }
+  const float lr_scaled_bias = lr * sqrtf(1.f - powf(beta2, ti)) / (1.f - powf(beta1, ti));
+
+  for (uint32_t i = start + lane_id; i < end; i += kUpdateWarpSize) {
+    float gi = core23::TypeConverter<float, wgrad_t>::value(g[i]) / scaler;
+    float mi = m[i] = beta1 * m[i] + (1.f - beta1) * gi;
+
+    g[i] =
+        core23::TypeConverter<wgrad_t, float>::value(-lr_scaled_bias * mi / (sqrtf(vi) + epsilon));
+  }
+}
+
 /**
  * FTRL
  * ----
@@ -200,12 +324,16 @@ __global__ void adam_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num
  *   w_i = -sqrt((beta + sqrt(n_i)) / eta + lambda_2) * (z_i - sign(z_i) * lambda_1)
  */
 template <typename wgrad_t>
-__global__ void ftrl_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_ev, float lr,
-                                        float lambda1, float lambda2_plus_beta_div_lr,
-                                        float** state_tensors, float** weight_tensors, float scaler,
-                                        wgrad_t* g) {
-  uint32_t tid = blockIdx.x * blockDim.x + threadIdx.x;
+__global__ void ftrl_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_ev,
+                                        const float* device_lr, float lr, float lambda1,
+                                        float lambda2, float beta, float** state_tensors,
+                                        float** weight_tensors, float scaler, wgrad_t* g) {
+  const uint64_t thread_id = blockIdx.x * static_cast<uint64_t>(blockDim.x) + threadIdx.x;
+  const uint32_t tid = thread_id / kUpdateWarpSize;
+  const uint32_t lane_id = thread_id % kUpdateWarpSize;
   if (tid >= num_ev) return;
+  if (device_lr) lr *= *device_lr;
+  const float lambda2_plus_beta_div_lr = lambda2 + beta / lr;
 
   uint32_t start = ev_offsets[tid];
   uint32_t end = ev_offsets[tid + 1];
@@ -214,7 +342,7 @@ __global__ void ftrl_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num
   float* z = n + end - start;
   float* w = weight_tensors[tid] - start;
 
-  for (uint32_t i = start; i < end; ++i) {
+  for (uint32_t i = start + lane_id; i < end; i += kUpdateWarpSize) {
     float gi = core23::TypeConverter<float, wgrad_t>::value(g[i]) / scaler;
     float ni = n[i];
     float ni_prev_sqrt = sqrtf(ni + FLT_EPSILON);
@@ -106,6 +106,35 @@ inline void ada_grad_update_grad(uint32_t idx, const uint32_t* ev_offsets, float
   }
 }
 
+/**
+ * Row-wise AdaGrad
+ * ----------------
+ * g_i = g_i / s
+ * v = v + mean(g_i^2)
+ * g_i = -eta * g_i / (sqrt(v) + epsilon)
+ */
+inline void row_wise_ada_grad_update_grad(uint32_t idx, const uint32_t* ev_offsets, float lr,
+                                          float** state_tensors, float epsilon, float scaler,
+                                          float* g) {
+  const uint32_t start = ev_offsets[idx];
+  const uint32_t end = ev_offsets[idx + 1];
+
+  float* v = state_tensors[idx];
+
+  float sum_gi_sq = 0.f;
+  for (uint32_t i = start; i < end; ++i) {
+    float gi = g[i] / scaler;
+    sum_gi_sq += gi * gi;
+  }
+  const float vi = *v = *v + sum_gi_sq / (end - start);
+
+  for (uint32_t i = start; i < end; ++i) {
+    float gi = g[i] / scaler;
+
+    g[i] = -lr * gi / (std::sqrt(vi) + epsilon);
+  }
+}
+
 /**
  * RMSProp
  * -------
@@ -158,6 +187,46 @@ inline void adam_update_grad(uint32_t idx, const uint32_t* ev_offsets, float lr_
   }
 }
 
+/**
+ * Lazy Adam
+ * ---------
+ * g_i = g_i / s
+ * t = t + 1
+ * m_i = beta_1 * m_i + (1 - beta_1) * g_i
+ * v = beta_2 * v + (1 - beta_2) * mean(g_i^2)
+ *
+ * g_i = -eta * sqrt(1 - beta_2^t) / (1 - beta_1^t) * m_i / (sqrt(v) + epsilon)
+ *
+ * The state of a vector is [m_0, ..., m_n-1, v, t], t counts the updates of the vector.
+ */
+inline void lazy_adam_update_grad(uint32_t idx, const uint32_t* ev_offsets, float lr, float beta1,
+                                  float beta2, float** state_tensors, float epsilon, float scaler,
+                                  float* g) {
+  const uint32_t start = ev_offsets[idx];
+  const uint32_t end = ev_offsets[idx + 1];
+
+  float* m = state_tensors[idx] - start;
+  float* v = m + end;
+  float* t = v + 1;
+
+  float sum_gi_sq = 0.f;
+  for (uint32_t i = start; i < end; ++i) {
+    float gi = g[i] / scaler;
+    sum_gi_sq += gi * gi;
+  }
+  const float vi = *v = beta2 * *v + (1.f - beta2) * sum_gi_sq / (end - start);
+  const float ti = *t = *t + 1.f;
+  const float lr_scaled_bias =
+      lr * std::sqrt(1.f - std::pow(beta2, ti)) / (1.f - std::pow(beta1, ti));
+
+  for (uint32_t i = start; i < end; ++i) {
+    float gi = g[i] / scaler;
+    float mi = m[i] = beta1 * m[i] + (1.f - beta1) * gi;
+
+    g[i] = -lr_scaled_bias * mi / (std::sqrt(vi) + epsilon);
+  }
+}
+
 /**
  * FTRL
  * ----
@@ -19,7 +19,9 @@
 
 #include <data_simulator.hpp>
 #include <embedding/operators/generic_lookup.cuh>
+#include <embedding/operators/row_sharding.hpp>
 #include <embedding/view.hpp>
+#include <embedding_storage/keyed_init.cuh>
 #include <embedding_storage/ragged_static_embedding.hpp>
 #include <numeric>
 #include <utils.cuh>
@@ -47,6 +49,19 @@ __global__ void ragged_static_embedding_table_lookup_kernel(
   }
 }
 
+// The keys that update gets are the rows of the table, see RaggedKeyToIndicesFunc. They are unique,
+// so the counts need no atomics.
+template <typename key_t>
+__global__ void mark_dirty_rows_kernel(const key_t *keys, const uint64_t *num_keys_ptr,
+                                       uint8_t *dirty_rows, uint8_t *update_counts) {
+  CUDA_1D_KERNEL_LOOP_T(uint64_t, tid, *num_keys_ptr) {
+    const key_t row = keys[tid];
+    dirty_rows[row] = 1;
+    const uint8_t count = update_counts[row];
+    if (count < UINT8_MAX) update_counts[row] = count + 1;
+  }
+}
+
 template <typename key_t, typename index_t>
 struct RaggedKeyToIndicesFunc {
   int *local_table_ids;
@@ -81,6 +96,49 @@ struct OptimizierInput {
 };
 
 constexpr int num_load_floats = 4;
+
+/**
+ * Optimizer states can be stored in fp16. To keep small updates from being rounded away, they are
+ * written back with stochastic rounding: random bits are added to the 13 mantissa bits that the
+ * conversion drops, before truncating. The bits are a hash of the state index and the update step,
+ * so that data parallel replicas round identically.
+ */
+DEVICE_INLINE uint32_t stochastic_rounding_bits(uint64_t idx, uint32_t seed) {
+  uint64_t h = (idx + 1) * 0x9e3779b97f4a7c15ULL ^ seed;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  return static_cast<uint32_t>(h);
+}
+
+DEVICE_INLINE __half stochastic_round_to_half(float v, uint64_t idx, uint32_t seed) {
+  if (!isfinite(v)) return __float2half(v);
+  uint32_t bits = __float_as_uint(v) + (stochastic_rounding_bits(idx, seed) & 0x1fffu);
+  return __float2half_rz(__uint_as_float(bits));
+}
+
+DEVICE_INLINE void store_opt_state(float *dst, float v, uint64_t, uint32_t) { *dst = v; }
+
+DEVICE_INLINE void store_opt_state(__half *dst, float v, uint64_t idx, uint32_t seed) {
+  *dst = stochastic_round_to_half(v, idx, seed);
+}
+
+DEVICE_INLINE void store_opt_state4(float *dst, Vec4T<float> &v, uint64_t, uint32_t) {
+  v.store(dst, 4);
+}
+
+DEVICE_INLINE void store_opt_state4(__half *dst, Vec4T<float> &v, uint64_t idx, uint32_t seed) {
+  __half2 *dst2 = reinterpret_cast<__half2 *>(dst);
+  dst2[0] = __halves2half2(stochastic_round_to_half(v.val.x, idx, seed),
+                           stochastic_round_to_half(v.val.y, idx + 1, seed));
+  dst2[1] = __halves2half2(stochastic_round_to_half(v.val.z, idx + 2, seed),
+                           stochastic_round_to_half(v.val.w, idx + 3, seed));
+}
+
+template <typename opt_t>
+DEVICE_INLINE float load_opt_state(const opt_t *src) {
+  return HugeCTR::TypeConvertFunc<float, opt_t>::convert(*src);
+}
 template <typename wgrad_t>
 struct SGDOptimizer {
   DEVICE_INLINE void update4(const OptimizierInput<wgrad_t> &input, float *ev) {
@@ -109,6 +167,7 @@ template <typename wgrad_t, typename acc_t>
 struct AdaGradOptimizer {
   acc_t *v;
   float epsilon;
+  uint32_t seed;
 
   DEVICE_INLINE void update4(const OptimizierInput<wgrad_t> &input, float *ev) {
     Vec4T<float> vi;
@@ -132,7 +191,8 @@ struct AdaGradOptimizer {
     gi.val.z = -input.lr * gi.val.z / (sqrtf(vi.val.z) + epsilon);
     gi.val.w = -input.lr * gi.val.w / (sqrtf(vi.val.w) + epsilon);
 
-    vi.store(v + input.ev_start_indices + input.ev_id, 4);
+    store_opt_state4(v + input.ev_start_indices + input.ev_id, vi,
+                     input.ev_start_indices + input.ev_id, seed);
 
     ev_plus_gi.accumulate(gi);
 
@@ -147,7 +207,8 @@ struct AdaGradOptimizer {
     vi = vi + gi * gi;
 
     gi = -input.lr * gi / (sqrtf(vi) + epsilon);
-    v[input.ev_start_indices + input.ev_id] = HugeCTR::TypeConvertFunc<acc_t, float>::convert(vi);
+    store_opt_state(v + input.ev_start_indices + input.ev_id, vi,
+                    input.ev_start_indices + input.ev_id, seed);
     ev[input.ev_id] += gi;
   }
 };
@@ -160,6 +221,7 @@ struct FtrlOptimizer {
   float beta;
   float lambda1;
   float lambda2;
+  uint32_t seed;
   /**
    * FTRL
    * ----
@@ -239,8 +301,10 @@ struct FtrlOptimizer {
     weight.val.z = p.val.z / q.val.z * signbit(lambda1 - abs(zi.val.z));
     weight.val.w = p.val.w / q.val.w * signbit(lambda1 - abs(zi.val.w));
 
-    ni.store(n + input.ev_start_indices + input.ev_id, 4);
-    zi.store(z + input.ev_start_indices + input.ev_id, 4);
+    store_opt_state4(n + input.ev_start_indices + input.ev_id, ni,
+                     input.ev_start_indices + input.ev_id, seed);
+    store_opt_state4(z + input.ev_start_indices + input.ev_id, zi,
+                     input.ev_start_indices + input.ev_id, seed);
     weight.store(ev + input.ev_id, 4);
   }
 
@@ -263,19 +327,269 @@ struct FtrlOptimizer {
     float p = (1.f - 2.f * signbit(zi)) * lambda1 - zi;
     float q = sqrt_ni_new / input.lr + lambda2_plus_beta_div_lr;
 
-    n[input.ev_start_indices + input.ev_id] = HugeCTR::TypeConvertFunc<opt_t, float>::convert(ni);
-    z[input.ev_start_indices + input.ev_id] = HugeCTR::TypeConvertFunc<opt_t, float>::convert(zi);
+    store_opt_state(n + input.ev_start_indices + input.ev_id, ni,
+                    input.ev_start_indices + input.ev_id, seed);
+    store_opt_state(z + input.ev_start_indices + input.ev_id, zi,
+                    input.ev_start_indices + input.ev_id, seed);
     ev[input.ev_id] = p / q * signbit(lambda1 - abs(zi));
   }
 };
 
+/**
+ * The optimizers below keep their state(s) in a tensor that is indexed like the embedding table.
+ * Adam interleaves m and v per element ([m_0, v_0, m_1, v_1, ...]), so that the state of four
+ * weights is fetched with two coalesced vector transactions.
+ */
+template <typename wgrad_t, typename opt_t>
+struct MomentumSGDOptimizer {
+  opt_t *m;
+  float momentum_decay;
+  uint32_t seed;
+
+  DEVICE_INLINE float step(float gi, float lr, float &mi) {
+    mi = momentum_decay * mi - lr * gi;
+    return mi;
+  }
+
+  DEVICE_INLINE void update4(const OptimizierInput<wgrad_t> &input, float *ev) {
+    const uint64_t idx = input.ev_start_indices + input.ev_id;
+    Vec4T<float> gi;
+    gi.load(input.wgrad + input.ev_id, 4);
+    Vec4T<float> mi;
+    mi.load(m + idx, 4);
+    Vec4T<float> weight;
+    weight.load(ev + input.ev_id, 4);
+
+    weight.val.x += step(gi.val.x / input.scaler, input.lr, mi.val.x);
+    weight.val.y += step(gi.val.y / input.scaler, input.lr, mi.val.y);
+    weight.val.z += step(gi.val.z / input.scaler, input.lr, mi.val.z);
+    weight.val.w += step(gi.val.w / input.scaler, input.lr, mi.val.w);
+
+    store_opt_state4(m + idx, mi, idx, seed);
+    weight.store(ev + input.ev_id, 4);
+  }
+
+  DEVICE_INLINE void update(const OptimizierInput<wgrad_t> &input, float *ev) {
+    const uint64_t idx = input.ev_start_indices + input.ev_id;
+    float gi = HugeCTR::TypeConvertFunc<float, wgrad_t>::convert(input.wgrad[input.ev_id]);
+    float mi = load_opt_state(m + idx);
+    ev[input.ev_id] += step(gi / input.scaler, input.lr, mi);
+    store_opt_state(m + idx, mi, idx, seed);
+  }
+};
+
+template <typename wgrad_t, typename opt_t>
+struct NesterovOptimizer {
+  opt_t *m;
+  float momentum_decay;
+  uint32_t seed;
+
+  DEVICE_INLINE float step(float gi, float lr, float &mi) {
+    float mi_prev = mi;
+    mi = momentum_decay * mi_prev - lr * gi;
+    return mi + momentum_decay * mi - momentum_decay * mi_prev;
+  }
+
+  DEVICE_INLINE void update4(const OptimizierInput<wgrad_t> &input, float *ev) {
+    const uint64_t idx = input.ev_start_indices + input.ev_id;
+    Vec4T<float> gi;
+    gi.load(input.wgrad + input.ev_id, 4);
+    Vec4T<float> mi;
+    mi.load(m + idx, 4);
+    Vec4T<float> weight;
+    weight.load(ev + input.ev_id, 4);
+
+    weight.val.x += step(gi.val.x / input.scaler, input.lr, mi.val.x);
+    weight.val.y += step(gi.val.y / input.scaler, input.lr, mi.val.y);
+    weight.val.z += step(gi.val.z / input.scaler, input.lr, mi.val.z);
+    weight.val.w += step(gi.val.w / input.scaler, input.lr, mi.val.w);
+
+    store_opt_state4(m + idx, mi, idx, seed);
+    weight.store(ev + input.ev_id, 4);
+  }
+
+  DEVICE_INLINE void update(const OptimizierInput<wgrad_t> &input, float *ev) {
+    const uint64_t idx = input.ev_start_indices + input.ev_id;
+    float gi = HugeCTR::TypeConvertFunc<float, wgrad_t>::convert(input.wgrad[input.ev_id]);
+    float mi = load_opt_state(m + idx);
+    ev[input.ev_id] += step(gi / input.scaler, input.lr, mi);
+    store_opt_state(m + idx, mi, idx, seed);
+  }
+};
+
+template <typename wgrad_t, typename opt_t>
+struct RMSPropOptimizer {
+  opt_t *v;
+  float beta;
+  float epsilon;
+  uint32_t seed;
+
+  DEVICE_INLINE float step(float gi, float lr, float &vi) {
+    vi = beta * vi + (1.f - beta) * gi * gi;
+    return -lr * gi / (sqrtf(vi) + epsilon);
+  }
+
+  DEVICE_INLINE void update4(const OptimizierInput<wgrad_t> &input, float *ev) {
+    const uint64_t idx = input.ev_start_indices + input.ev_id;
+    Vec4T<float> gi;
+    gi.load(input.wgrad + input.ev_id, 4);
+    Vec4T<float> vi;
+    vi.load(v + idx, 4);
+    Vec4T<float> weight;
+    weight.load(ev + input.ev_id, 4);
+
+    weight.val.x += step(gi.val.x / input.scaler, input.lr, vi.val.x);
+    weight.val.y += step(gi.val.y / input.scaler, input.lr, vi.val.y);
+    weight.val.z += step(gi.val.z / input.scaler, input.lr, vi.val.z);
+    weight.val.w += step(gi.val.w / input.scaler, input.lr, vi.val.w);
+
+    store_opt_state4(v + idx, vi, idx, seed);
+    weight.store(ev + input.ev_id, 4);
+  }
+
+  DEVICE_INLINE void update(const OptimizierInput<wgrad_t> &input, float *ev) {
+    const uint64_t idx = input.ev_start_indices + input.ev_id;
+    float gi = HugeCTR::TypeConvertFunc<float, wgrad_t>::convert(input.wgrad[input.ev_id]);
+    float vi = load_opt_state(v + idx);
+    ev[input.ev_id] += step(gi / input.scaler, input.lr, vi);
+    store_opt_state(v + idx, vi, idx, seed);
+  }
+};
+
+/**
+ * `input.lr` is expected to be pre-multiplied with the bias correction of the current step.
+ */
+template <typename wgrad_t, typename opt_t>
+struct AdamOptimizer {
+  opt_t *mv;
+  float beta1;
+  float beta2;
+  float epsilon;
+  uint32_t seed;
+
+  DEVICE_INLINE float step(float gi, float lr_scaled_bias, float &mi, float &vi) {
+    mi = beta1 * mi + (1.f - beta1) * gi;
+    vi = beta2 * vi + (1.f - beta2) * gi * gi;
+    return -lr_scaled_bias * mi / (sqrtf(vi) + epsilon);
+  }
+
+  DEVICE_INLINE void update4(const OptimizierInput<wgrad_t> &input, float *ev) {
+    const uint64_t idx = 2 * (input.ev_start_indices + input.ev_id);
+    Vec4T<float> gi;
+    gi.load(input.wgrad + input.ev_id, 4);
+    Vec4T<float> mv01;
+    mv01.load(mv + idx, 4);
+    Vec4T<float> mv23;
+    mv23.load(mv + idx + 4, 4);
+    Vec4T<float> weight;
+    weight.load(ev + input.ev_id, 4);
+
+    weight.val.x += step(gi.val.x / input.scaler, input.lr, mv01.val.x, mv01.val.y);
+    weight.val.y += step(gi.val.y / input.scaler, input.lr, mv01.val.z, mv01.val.w);
+    weight.val.z += step(gi.val.z / input.scaler, input.lr, mv23.val.x, mv23.val.y);
+    weight.val.w += step(gi.val.w / input.scaler, input.lr, mv23.val.z, mv23.val.w);
+
+    store_opt_state4(mv + idx, mv01, idx, seed);
+    store_opt_state4(mv + idx + 4, mv23, idx + 4, seed);
+    weight.store(ev + input.ev_id, 4);
+  }
+
+  DEVICE_INLINE void update(const OptimizierInput<wgrad_t> &input, float *ev) {
+    const uint64_t idx = 2 * (input.ev_start_indices + input.ev_id);
+    float gi = HugeCTR::TypeConvertFunc<float, wgrad_t>::convert(input.wgrad[input.ev_id]);
+    float mi = load_opt_state(mv + idx);
+    float vi = load_opt_state(mv + idx + 1);
+    ev[input.ev_id] += step(gi / input.scaler, input.lr, mi, vi);
+    store_opt_state(mv + idx, mi, idx, seed);
+    store_opt_state(mv + idx + 1, vi, idx + 1, seed);
+  }
+};
+
+/**
+ * The row-wise optimizers below keep their per row state(s) in a float tensor that is indexed by
+ * the row, i.e., the key that update gets. All lanes of a warp update a row together and reduce its
+ * squared gradients.
+ */
+template <typename wgrad_t>
+struct RowOptimizerInput {
+  const wgrad_t *wgrad;
+  uint64_t ev_start_indices;
+  uint64_t row;
+  int ev_size;
+  float lr;
+  float scaler;
+};
+
+template <typename wgrad_t>
+DEVICE_INLINE float row_mean_grad_square(const RowOptimizerInput<wgrad_t> &input) {
+  float sum_gi_sq = 0.f;
+  for (int i = threadIdx.x % warpSize; i < input.ev_size; i += warpSize) {
+    float gi = HugeCTR::TypeConvertFunc<float, wgrad_t>::convert(input.wgrad[i]) / input.scaler;
+    sum_gi_sq += gi * gi;
+  }
+  return HugeCTR::warpReduceSum(sum_gi_sq) / input.ev_size;
+}
+
+template <typename wgrad_t>
+struct RowWiseAdaGradOptimizer {
+  float *v;
+  float epsilon;
+
+  DEVICE_INLINE void update_row(const RowOptimizerInput<wgrad_t> &input, float *ev) {
+    float vi = v[input.row];
+    vi += row_mean_grad_square(input);
+    if (threadIdx.x % warpSize == 0) v[input.row] = vi;
+
+    const float lr_div_sqrt_vi = input.lr / (sqrtf(vi) + epsilon);
+    for (int i = threadIdx.x % warpSize; i < input.ev_size; i += warpSize) {
+      float gi = HugeCTR::TypeConvertFunc<float, wgrad_t>::convert(input.wgrad[i]) / input.scaler;
+      ev[i] -= lr_div_sqrt_vi * gi;
+    }
+  }
+};
+
+/**
+ * Corrects the bias of every row with its own step count t, which only advances when the row is
+ * updated. `input.lr` is not pre-multiplied with a bias correction.
+ */
+template <typename wgrad_t, typename opt_t>
+struct LazyAdamOptimizer {
+  opt_t *m;
+  float2 *vt;
+  float beta1;
+  float beta2;
+  float epsilon;
+  uint32_t seed;
+
+  DEVICE_INLINE void update_row(const RowOptimizerInput<wgrad_t> &input, float *ev) {
+    float2 vti = vt[input.row];
+    vti.x = beta2 * vti.x + (1.f - beta2) * row_mean_grad_square(input);
+    vti.y += 1.f;
+    if (threadIdx.x % warpSize == 0) vt[input.row] = vti;
+
+    const float lr_scaled_bias =
+        input.lr * sqrtf(1.f - powf(beta2, vti.y)) / (1.f - powf(beta1, vti.y));
+    const float sqrt_vi_plus_eps = sqrtf(vti.x) + epsilon;
+    for (int i = threadIdx.x % warpSize; i < input.ev_size; i += warpSize) {
+      const uint64_t idx = input.ev_start_indices + i;
+      float gi = HugeCTR::TypeConvertFunc<float, wgrad_t>::convert(input.wgrad[i]) / input.scaler;
+      float mi = load_opt_state(m + idx);
+      mi = beta1 * mi + (1.f - beta1) * gi;
+      ev[i] -= lr_scaled_bias * mi / sqrt_vi_plus_eps;
+      store_opt_state(m + idx, mi, idx, seed);
+    }
+  }
+};
+
 template <typename key_t, typename index_t, typename wgrad_t, typename OptimizerFunc,
           typename KeyToIndicesFunc>
 __global__ void update4_kernel(const key_t *keys, const size_t *num_keys_ptr, const int *table_ids,
                                const wgrad_t *grad_ev, const uint32_t *ev_start_indices,
                                KeyToIndicesFunc key_to_indices_func, float *emb_table,
-                               OptimizerFunc optimizer, float lr, float scaler) {
+                               OptimizerFunc optimizer, const float *device_lr, float lr,
+                               float scaler) {
   if (*num_keys_ptr == 0) return;
+  if (device_lr) lr *= *device_lr;
   size_t num_steps = (*num_keys_ptr - 1) / (blockDim.x * gridDim.x) + 1;
   for (size_t step = 0; step < num_steps; step++) {
     size_t tid = step * blockDim.x * gridDim.x + (size_t)blockIdx.x * blockDim.x + threadIdx.x;
@@ -315,8 +629,10 @@ template <typename key_t, typename index_t, typename emb_t, typename OptimizerFu
 __global__ void update_kernel(const key_t *keys, const uint64_t *num_keys_ptr, const int *table_ids,
                               const emb_t *grad_ev, const uint32_t *ev_start_indices,
                               KeyToIndicesFunc key_to_indices_func, float *emb_table,
-                              OptimizerFunc optimizer, float lr, float scaler) {
+                              OptimizerFunc optimizer, const float *device_lr, float lr,
+                              float scaler) {
   if (*num_keys_ptr == 0) return;
+  if (device_lr) lr *= *device_lr;
   uint64_t num_steps = (*num_keys_ptr - 1) / (blockDim.x * gridDim.x) + 1;
   for (size_t step = 0; step < num_steps; step++) {
     uint64_t tid = step * blockDim.x * gridDim.x + (size_t)blockIdx.x * blockDim.x + threadIdx.x;
@@ -349,6 +665,60 @@ __global__ void update_kernel(const key_t *keys, const uint64_t *num_keys_ptr, c
   }
 }
 
+template <typename key_t, typename index_t, typename wgrad_t, typename OptimizerFunc,
+          typename KeyToIndicesFunc>
+__global__ void update_row_wise_kernel(const key_t *keys, const uint64_t *num_keys_ptr,
+                                       const int *table_ids, const wgrad_t *grad_ev,
+                                       const uint32_t *ev_start_indices,
+                                       KeyToIndicesFunc key_to_indices_func, float *emb_table,
+                                       OptimizerFunc optimizer, const float *device_lr, float lr,
+                                       float scaler) {
+  if (*num_keys_ptr == 0) return;
+  if (device_lr) lr *= *device_lr;
+  uint64_t num_steps = (*num_keys_ptr - 1) / (blockDim.x * gridDim.x) + 1;
+  for (size_t step = 0; step < num_steps; step++) {
+    uint64_t tid = step * blockDim.x * gridDim.x + (size_t)blockIdx.x * blockDim.x + threadIdx.x;
+    uint64_t emb_table_ev_start_indices_frag;
+    uint64_t row_frag;
+    int ev_size_frag = std::numeric_limits<int>::max();
+    uint32_t grad_ev_offset_frag;
+    if (tid < *num_keys_ptr) {
+      key_t key = keys[tid];
+      int table_id = table_ids[tid];
+      key_to_indices_func(key, table_id, &emb_table_ev_start_indices_frag, &ev_size_frag);
+      row_frag = static_cast<uint64_t>(key);
+      grad_ev_offset_frag = ev_start_indices[tid];
+    }
+
+    for (int lane_id = 0; lane_id < warpSize; lane_id++) {
+      int ev_size = __shfl_sync(0xffffffff, ev_size_frag, lane_id);
+      if (ev_size == std::numeric_limits<int>::max()) {
+        break;
+      }
+      const wgrad_t *grad_ev_for_update =
+          grad_ev + __shfl_sync(0xffffffff, grad_ev_offset_frag, lane_id);
+      uint64_t ev_start_indices_v =
+          __shfl_sync(0xffffffff, emb_table_ev_start_indices_frag, lane_id);
+      uint64_t row = __shfl_sync(0xffffffff, row_frag, lane_id);
+      float *ev = emb_table + ev_start_indices_v;
+
+      RowOptimizerInput<wgrad_t> input{grad_ev_for_update, ev_start_indices_v, row, ev_size, lr,
+                                       scaler};
+      optimizer.update_row(input, ev);
+    }
+  }
+}
+
+// One thread per element of the rows, drawn from the keys of the rows.
+template <typename key_t>
+__global__ void init_rows_from_keys_kernel(const key_t *keys, uint64_t num_rows, int ev_size,
+                                           cuco::initializer initializer, float *evs) {
+  CUDA_1D_KERNEL_LOOP_T(uint64_t, i, num_rows * ev_size) {
+    uint64_t row = i / ev_size;
+    evs[i] = initializer(keys[row], static_cast<uint32_t>(i - row * ev_size));
+  }
+}
+
 }  // namespace
 
 RaggedStaticEmbeddingTable::RaggedStaticEmbeddingTable(
@@ -369,6 +739,14 @@ RaggedStaticEmbeddingTable::RaggedStaticEmbeddingTable(
   for (const auto &table_param : table_params) {
     use_vectorized_kernel_ &= (table_param.ev_size % num_load_floats == 0);
   }
+  const bool fp16_opt_state = table_params[grouped_table_param.table_ids[0]].fp16_opt_state;
+  for (int table_id : grouped_table_param.table_ids) {
+    HCTR_CHECK_HINT(table_params[table_id].fp16_opt_state == fp16_opt_state,
+                    "grouped embedding table does not support grouping embedding table with "
+                    "different optimizer state precision.");
+  }
+  core23::DataType opt_state_type =
+      fp16_opt_state ? core23::ScalarType::Half : core23::ScalarType::Float;
 
   DISPATCH_INTEGRAL_FUNCTION_CORE23(key_type.type(), key_t, [&] {
     DISPATCH_INTEGRAL_FUNCTION_CORE23(index_type.type(), index_t, [&] {
@@ -386,6 +764,7 @@ RaggedStaticEmbeddingTable::RaggedStaticEmbeddingTable(
             num_key += 1;
           }
           h_num_key_per_table_.push_back(num_key);
+          h_num_hot_key_per_table_.push_back(0);
           h_num_key_per_table_offset.push_back(num_key);
 
           uint64_t segment_emb_table_size = num_key * table_params[table_id].ev_size;
@@ -416,20 +795,34 @@ RaggedStaticEmbeddingTable::RaggedStaticEmbeddingTable(
           h_table_max_vocabulary_size_.push_back(table_params[table_id].max_vocabulary_size);
           int shard_id =
               static_cast<int>(std::distance(shard_gpu_list.begin(), find_shard_id_iter));
+          const int64_t *row_offsets = ebc_param.get_table_shard_row_offsets(table_id);
           for (int64_t k = 0; k < table_params[table_id].max_vocabulary_size; ++k) {
-            if (k % num_shards == shard_id) {
+            if (row_shard_id(k, row_offsets, num_shards) == shard_id) {
               h_key_list.push_back(k);
               num_key += 1;
             }
           }
 
+          // The replicated hot rows of a hybrid table follow its owned rows. They are not dumped,
+          // the owner keeps its own rows of the hot keys in sync.
+          const int64_t num_hot_key = ebc_param.get_table_num_hot_keys(table_id);
+          HCTR_CHECK_HINT(num_hot_key == 0 || !fp16_opt_state,
+                          "hybrid placement does not support fp16_opt_state.");
+          if (num_hot_key > 0) {
+            h_key_list.insert(h_key_list.end(), ebc_param.table_hot_keys_[table_id].begin(),
+                              ebc_param.table_hot_keys_[table_id].end());
+          }
+
           h_num_key_per_table_.push_back(num_key);
-          h_num_key_per_table_offset.push_back(num_key);
+          h_num_hot_key_per_table_.push_back(num_hot_key);
+          h_num_key_per_table_offset.push_back(num_key + num_hot_key);
           uint64_t segment_emb_table_size = num_key * table_params[table_id].ev_size;
           h_size_per_table_.push_back(segment_emb_table_size);
-          h_emb_table_ev_offset_.push_back(segment_emb_table_size);
+          uint64_t segment_emb_table_capacity =
+              (num_key + num_hot_key) * table_params[table_id].ev_size;
+          h_emb_table_ev_offset_.push_back(segment_emb_table_capacity);
           h_local_ev_sizes_.push_back(table_params[table_id].ev_size);
-          emb_table_size_ += segment_emb_table_size;
+          emb_table_size_ += segment_emb_table_capacity;
         }
       }
 
@@ -459,12 +852,18 @@ RaggedStaticEmbeddingTable::RaggedStaticEmbeddingTable(
       local_ev_size_list_ =
           core23::Tensor(params.shape({static_cast<int64_t>(h_local_ev_sizes_.size())})
                              .data_type(core23::ScalarType::Int32));
+      dirty_rows_ = core23::Tensor(params.shape({static_cast<int64_t>(h_key_list.size())})
+                                       .data_type(core23::ScalarType::UInt8));
+      update_counts_ = core23::Tensor(params.shape({static_cast<int64_t>(h_key_list.size())})
+                                          .data_type(core23::ScalarType::UInt8));
 
       core23::copy_sync(table_ids_, h_table_ids_);
       core23::copy_sync(keys_, h_key_list);
       core23::copy_sync(num_key_per_table_offset_, h_num_key_per_table_offset);
       core23::copy_sync(emb_table_ev_offset_, h_emb_table_ev_offset_);
       core23::copy_sync(local_ev_size_list_, h_local_ev_sizes_);
+      HCTR_LIB_THROW(cudaMemset(dirty_rows_.data(), 0, dirty_rows_.num_bytes()));
+      HCTR_LIB_THROW(cudaMemset(update_counts_.data(), 0, update_counts_.num_bytes()));
     });
   });
 
@@ -472,8 +871,8 @@ RaggedStaticEmbeddingTable::RaggedStaticEmbeddingTable(
     DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(emb_type.type(), emb_t, [&] {
       core23::Device device(core23::DeviceType::GPU, core->get_device_id());
       core23::TensorParams params = core23::TensorParams().device(device);
-      auto accum_tensor = core23::Tensor(params.shape({static_cast<int64_t>(emb_table_size_)})
-                                             .data_type(core23::ScalarType::Float));
+      auto accum_tensor = core23::Tensor(
+          params.shape({static_cast<int64_t>(emb_table_size_)}).data_type(opt_state_type));
 
       HCTR_LIB_THROW(cudaMemset(accum_tensor.data(), 0, accum_tensor.num_bytes()));
       opt_buffer_ = AdaGradOptBuffer{accum_tensor};
@@ -483,10 +882,10 @@ RaggedStaticEmbeddingTable::RaggedStaticEmbeddingTable(
     DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(emb_type.type(), emb_t, [&] {
       core23::Device device(core23::DeviceType::GPU, core->get_device_id());
       core23::TensorParams params = core23::TensorParams().device(device);
-      auto z_tensor = core23::Tensor(params.shape({static_cast<int64_t>(emb_table_size_)})
-                                         .data_type(core23::ScalarType::Float));
-      auto n_tensor = core23::Tensor(params.shape({static_cast<int64_t>(emb_table_size_)})
-                                         .data_type(core23::ScalarType::Float));
+      auto z_tensor = core23::Tensor(
+          params.shape({static_cast<int64_t>(emb_table_size_)}).data_type(opt_state_type));
+      auto n_tensor = core23::Tensor(
+          params.shape({static_cast<int64_t>(emb_table_size_)}).data_type(opt_state_type));
 
       HCTR_LIB_THROW(cudaMemset(z_tensor.data(), 0, z_tensor.num_bytes()));
       HCTR_LIB_THROW(cudaMemset(n_tensor.data(), 0, n_tensor.num_bytes()));
@@ -494,60 +893,98 @@ RaggedStaticEmbeddingTable::RaggedStaticEmbeddingTable(
     });
   }
 
-  for (size_t i = 0; i < h_table_ids_.size(); i++) {
-    int table_id = h_table_ids_[i];
-    std::function<void(const curandGenerator_t &)> init_table_functor;
-
-    if (table_params[table_id].init_param.initializer_type == HugeCTR::Initializer_t::Default) {
-      init_table_functor = [&](const curandGenerator_t &generator) {
-        float up_bound = sqrt(1.f / h_table_max_vocabulary_size_[i]);
-        size_t offset = h_emb_table_ev_offset_[i];
-        size_t num_elements = h_emb_table_ev_offset_[i + 1] - h_emb_table_ev_offset_[i];
-
-        HugeCTR::UniformGenerator::fill(emb_table_.data<float>() + offset, num_elements, -up_bound,
-                                        up_bound, gpu_resource.get_sm_count(), generator,
-                                        gpu_resource.get_stream());
-      };
-    } else if (table_params[table_id].init_param.initializer_type ==
-               HugeCTR::Initializer_t::Uniform) {
-      init_table_functor = [&](const curandGenerator_t &generator) {
-        float up_bound = table_params[table_id].init_param.uniform_params.up_bound;
-        size_t offset = h_emb_table_ev_offset_[i];
-        size_t num_elements = h_emb_table_ev_offset_[i + 1] - h_emb_table_ev_offset_[i];
-
-        HugeCTR::UniformGenerator::fill(emb_table_.data<float>() + offset, num_elements, -up_bound,
-                                        up_bound, gpu_resource.get_sm_count(), generator,
-                                        gpu_resource.get_stream());
-      };
-    } else if (table_params[table_id].init_param.initializer_type ==
-               HugeCTR::Initializer_t::Sinusoidal) {
-      init_table_functor = [&](const curandGenerator_t &) {
-        const SinusoidalParams &sinus_params = table_params[table_id].init_param.sinusoidal_params;
-        int max_sequence_len = sinus_params.max_sequence_len;
-        int ev_size = sinus_params.ev_size;
-        size_t offset = h_emb_table_ev_offset_[i];
-        size_t num_elements = h_emb_table_ev_offset_[i + 1] - h_emb_table_ev_offset_[i];
-
-        HCTR_CHECK_HINT(max_sequence_len * ev_size == static_cast<int>(num_elements),
-                        "max_sequent_len * ev_size ", max_sequence_len * ev_size,
-                        " should equal to num_elements ", num_elements);
-        HugeCTR::SinusoidalGenerator::fill(emb_table_.data<float>() + offset, num_elements, ev_size,
-                                           max_sequence_len, gpu_resource.get_sm_count(),
-                                           gpu_resource.get_stream());
-      };
-    } else {
-      HCTR_OWN_THROW(HugeCTR::Error_t::IllegalCall, "initializer not implemented");
+  if (opt_param.optimizer == HugeCTR::Optimizer_t::Adam ||
+      opt_param.optimizer == HugeCTR::Optimizer_t::RMSProp ||
+      opt_param.optimizer == HugeCTR::Optimizer_t::MomentumSGD ||
+      opt_param.optimizer == HugeCTR::Optimizer_t::Nesterov) {
+    core23::Device device(core23::DeviceType::GPU, core->get_device_id());
+    core23::TensorParams params = core23::TensorParams().device(device);
+    const size_t num_states = HugeCTR::OptParams::num_parameters_per_weight(opt_param.optimizer);
+    auto state_tensor =
+        core23::Tensor(params.shape({static_cast<int64_t>(num_states * emb_table_size_)})
+                           .data_type(opt_state_type));
+
+    HCTR_LIB_THROW(cudaMemset(state_tensor.data(), 0, state_tensor.num_bytes()));
+    switch (opt_param.optimizer) {
+      case HugeCTR::Optimizer_t::Adam:
+        opt_buffer_ = AdamOptBuffer{state_tensor};
+        break;
+      case HugeCTR::Optimizer_t::RMSProp:
+        opt_buffer_ = RMSPropOptBuffer{state_tensor};
+        break;
+      default:
+        opt_buffer_ = MomentumOptBuffer{state_tensor};
+        break;
     }
+  }
 
-    // data parallel table should use same curand seed across all gpus
-    if (grouped_table_param.table_placement_strategy == TablePlacementStrategy::DataParallel) {
-      init_table_functor(gpu_resource.get_replica_uniform_curand_generator());
+  if (opt_param.optimizer == HugeCTR::Optimizer_t::RowWiseAdaGrad ||
+      opt_param.optimizer == HugeCTR::Optimizer_t::LazyAdam) {
+    core23::Device device(core23::DeviceType::GPU, core->get_device_id());
+    core23::TensorParams params = core23::TensorParams().device(device);
+    const int64_t num_rows = keys_.num_elements();
+    const size_t num_row_states = HugeCTR::OptParams::num_parameters_per_row(opt_param.optimizer);
+    auto row_state_tensor =
+        core23::Tensor(params.shape({static_cast<int64_t>(num_row_states) * num_rows})
+                           .data_type(core23::ScalarType::Float));
+
+    HCTR_LIB_THROW(cudaMemset(row_state_tensor.data(), 0, row_state_tensor.num_bytes()));
+    if (opt_param.optimizer == HugeCTR::Optimizer_t::RowWiseAdaGrad) {
+      opt_buffer_ = RowWiseAdaGradOptBuffer{row_state_tensor};
     } else {
-      init_table_functor(gpu_resource.get_replica_variant_curand_generator());
+      auto m_tensor = core23::Tensor(
+          params.shape({static_cast<int64_t>(emb_table_size_)}).data_type(opt_state_type));
+      HCTR_LIB_THROW(cudaMemset(m_tensor.data(), 0, m_tensor.num_bytes()));
+      opt_buffer_ = LazyAdamOptBuffer{m_tensor, row_state_tensor};
     }
   }
+
+  // The default and uniform rows are drawn from their keys, so the replicas of data parallel
+  // tables and the hot rows of hybrid tables start the same on all the GPUs, and a table starts
+  // the same however it is sharded.
+  const unsigned long long init_seed = gpu_resource.get_replica_uniform_seed();
+  for (size_t i = 0; i < h_table_ids_.size(); i++) {
+    int table_id = h_table_ids_[i];
+    const InitParams &init_param = table_params[table_id].init_param;
+    size_t offset = h_emb_table_ev_offset_[i];
+
+    if (init_param.initializer_type == HugeCTR::Initializer_t::Sinusoidal) {
+      const SinusoidalParams &sinus_params = init_param.sinusoidal_params;
+      int max_sequence_len = sinus_params.max_sequence_len;
+      int ev_size = sinus_params.ev_size;
+      size_t num_elements = h_emb_table_ev_offset_[i + 1] - offset;
+
+      HCTR_CHECK_HINT(h_num_hot_key_per_table_[i] == 0,
+                      "sinusoidal initializer does not support hybrid placement.");
+      HCTR_CHECK_HINT(max_sequence_len * ev_size == static_cast<int>(num_elements),
+                      "max_sequent_len * ev_size ", max_sequence_len * ev_size,
+                      " should equal to num_elements ", num_elements);
+      HugeCTR::SinusoidalGenerator::fill(emb_table_.data<float>() + offset, num_elements, ev_size,
+                                         max_sequence_len, gpu_resource.get_sm_count(),
+                                         gpu_resource.get_stream());
+      continue;
+    }
+
+    float default_up_bound = sqrt(1.f / h_table_max_vocabulary_size_[i]);
+    cuco::initializer initializer =
+        keyed_initializer(init_param, table_init_seed(init_seed, table_id), default_up_bound);
+    const size_t key_offset = h_num_key_per_table_offset_[i];
+    const uint64_t num_rows = h_num_key_per_table_offset_[i + 1] - key_offset;
+    const int ev_size = h_local_ev_sizes_[i];
+    if (num_rows == 0) continue;
+    constexpr int block_size = 256;
+    int grid_size = std::min<size_t>((num_rows * ev_size - 1) / block_size + 1,
+                                     gpu_resource.get_sm_count() * 32);
+    DISPATCH_INTEGRAL_FUNCTION_CORE23(keys_.data_type().type(), key_t, [&] {
+      init_rows_from_keys_kernel<<<grid_size, block_size, 0, gpu_resource.get_stream()>>>(
+          keys_.data<key_t>() + key_offset, num_rows, ev_size, initializer,
+          emb_table_.data<float>() + offset);
+    });
+    HCTR_LIB_THROW(cudaGetLastError());
+  }
 }
 
+
 void RaggedStaticEmbeddingTable::lookup(const core23::Tensor &keys, size_t num_keys,
                                         const core23::Tensor &id_space_offset,
                                         size_t num_id_space_offset,
@@ -589,6 +1026,20 @@ void RaggedStaticEmbeddingTable::update(const core23::Tensor &unique_keys,
   HCTR_CHECK(num_unique_keys.data_type() == core23::ScalarType::UInt64);
   HCTR_CHECK(table_ids.data_type() == core23::ScalarType::Int32);
   HCTR_CHECK(ev_start_indices.data_type() == core23::ScalarType::UInt32);
+  const uint32_t seed = ++update_step_;
+  // The kernels multiply it with the scheduled learning rate if there is one
+  const float lr_scale =
+      device_lr_ ? opt_param_.lr_multiplier : opt_param_.lr * opt_param_.lr_multiplier;
+
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(unique_keys.data_type().type(), key_t, [&] {
+    constexpr int block_size = 256;
+    const auto &kernel_param = core_->get_kernel_param();
+    const int grid_size =
+        HugeCTR::ceildiv(kernel_param.num_sms * kernel_param.max_thread_per_sm, block_size);
+    mark_dirty_rows_kernel<<<grid_size, block_size, 0, stream>>>(
+        unique_keys.data<key_t>(), num_unique_keys.data<size_t>(), dirty_rows_.data<uint8_t>(),
+        update_counts_.data<uint8_t>());
+  });
 
   if (opt_param_.optimizer == HugeCTR::Optimizer_t::SGD) {
     DISPATCH_INTEGRAL_FUNCTION_CORE23(unique_keys.data_type().type(), key_t, [&] {
@@ -615,7 +1066,7 @@ void RaggedStaticEmbeddingTable::update(const core23::Tensor &unique_keys,
           kernel<<<grid_size, block_size, 0, stream>>>(
               unique_keys.data<key_t>(), num_unique_keys.data<size_t>(), table_ids.data<int>(),
               wgrad.data<wgrad_t>(), ev_start_indices.data<uint32_t>(), key_to_indices_func,
-              emb_table_.data<float>(), optimizer, opt_param_.lr, opt_param_.scaler);
+              emb_table_.data<float>(), optimizer, device_lr_, lr_scale, opt_param_.scaler);
         });
       });
     });
@@ -636,7 +1087,7 @@ void RaggedStaticEmbeddingTable::update(const core23::Tensor &unique_keys,
                 };
                 AdaGradOptimizer<wgrad_t, acc_t> optimizer{
                     adagrad_opt_buffer->opt_accum_tensor.data<acc_t>(),
-                    opt_param_.hyperparams.adagrad.epsilon};
+                    opt_param_.hyperparams.adagrad.epsilon, seed};
 
                 constexpr int block_size = 256;
                 const auto &kernel_param = core_->get_kernel_param();
@@ -650,8 +1101,8 @@ void RaggedStaticEmbeddingTable::update(const core23::Tensor &unique_keys,
                 kernel<<<grid_size, block_size, 0, stream>>>(
                     unique_keys.data<key_t>(), num_unique_keys.data<size_t>(),
                     table_ids.data<int>(), wgrad.data<wgrad_t>(), ev_start_indices.data<uint32_t>(),
-                    key_to_indices_func, emb_table_.data<float>(), optimizer, opt_param_.lr,
-                    opt_param_.scaler);
+                    key_to_indices_func, emb_table_.data<float>(), optimizer, device_lr_,
+                    lr_scale, opt_param_.scaler);
               });
         });
       });
@@ -674,7 +1125,8 @@ void RaggedStaticEmbeddingTable::update(const core23::Tensor &unique_keys,
                 FtrlOptimizer<wgrad_t, opt_t> optimizer{
                     ftrl_opt_buffer->opt_z_tensor.data<opt_t>(),
                     ftrl_opt_buffer->opt_n_tensor.data<opt_t>(), opt_param_.hyperparams.ftrl.beta,
-                    opt_param_.hyperparams.ftrl.lambda1, opt_param_.hyperparams.ftrl.lambda2};
+                    opt_param_.hyperparams.ftrl.lambda1, opt_param_.hyperparams.ftrl.lambda2,
+                    seed};
 
                 constexpr int block_size = 256;
                 const auto &kernel_param = core_->get_kernel_param();
@@ -688,12 +1140,135 @@ void RaggedStaticEmbeddingTable::update(const core23::Tensor &unique_keys,
                 kernel<<<grid_size, block_size, 0, stream>>>(
                     unique_keys.data<key_t>(), num_unique_keys.data<size_t>(),
                     table_ids.data<int>(), wgrad.data<wgrad_t>(), ev_start_indices.data<uint32_t>(),
-                    key_to_indices_func, emb_table_.data<float>(), optimizer, opt_param_.lr,
-                    opt_param_.scaler);
+                    key_to_indices_func, emb_table_.data<float>(), optimizer, device_lr_,
+                    lr_scale, opt_param_.scaler);
               });
         });
       });
     });
+  } else if (opt_param_.optimizer == HugeCTR::Optimizer_t::Adam ||
+             opt_param_.optimizer == HugeCTR::Optimizer_t::RMSProp ||
+             opt_param_.optimizer == HugeCTR::Optimizer_t::MomentumSGD ||
+             opt_param_.optimizer == HugeCTR::Optimizer_t::Nesterov) {
+    float lr = lr_scale;
+    if (opt_param_.optimizer == HugeCTR::Optimizer_t::Adam) {
+      ++opt_param_.hyperparams.adam.times;
+      lr *= opt_param_.hyperparams.adam.bias();
+    }
+
+    DISPATCH_INTEGRAL_FUNCTION_CORE23(unique_keys.data_type().type(), key_t, [&] {
+      DISPATCH_INTEGRAL_FUNCTION_CORE23(num_key_per_table_offset_.data_type().type(), index_t, [&] {
+        DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(wgrad.data_type().type(), wgrad_t, [&] {
+          RaggedKeyToIndicesFunc<key_t, index_t> key_to_indices_func{
+              table_ids_.data<int>(),
+              local_ev_size_list_.data<int>(),
+              table_ids_.num_elements(),
+              num_key_per_table_offset_.data<index_t>(),
+              emb_table_ev_offset_.data<uint64_t>(),
+          };
+
+          auto launch = [&](auto optimizer) {
+            constexpr int block_size = 256;
+            const auto &kernel_param = core_->get_kernel_param();
+            const int grid_size =
+                HugeCTR::ceildiv(kernel_param.num_sms * kernel_param.max_thread_per_sm, block_size);
+            auto kernel = use_vectorized_kernel_
+                              ? update4_kernel<key_t, index_t, wgrad_t, decltype(optimizer),
+                                               decltype(key_to_indices_func)>
+                              : update_kernel<key_t, index_t, wgrad_t, decltype(optimizer),
+                                              decltype(key_to_indices_func)>;
+            kernel<<<grid_size, block_size, 0, stream>>>(
+                unique_keys.data<key_t>(), num_unique_keys.data<size_t>(), table_ids.data<int>(),
+                wgrad.data<wgrad_t>(), ev_start_indices.data<uint32_t>(), key_to_indices_func,
+                emb_table_.data<float>(), optimizer, device_lr_, lr, opt_param_.scaler);
+          };
+
+          const auto &hyperparams = opt_param_.hyperparams;
+          if (opt_param_.optimizer == HugeCTR::Optimizer_t::Adam) {
+            auto adam_opt_buffer = std::get_if<AdamOptBuffer>(&opt_buffer_);
+            HCTR_CHECK_HINT(adam_opt_buffer != nullptr, "Adam Opt Buffer not initialized.");
+            auto &mv = adam_opt_buffer->opt_mv_tensor;
+            DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(mv.data_type().type(), opt_t, [&] {
+              launch(AdamOptimizer<wgrad_t, opt_t>{mv.data<opt_t>(), hyperparams.adam.beta1,
+                                                   hyperparams.adam.beta2,
+                                                   hyperparams.adam.epsilon, seed});
+            });
+          } else if (opt_param_.optimizer == HugeCTR::Optimizer_t::RMSProp) {
+            auto rmsprop_opt_buffer = std::get_if<RMSPropOptBuffer>(&opt_buffer_);
+            HCTR_CHECK_HINT(rmsprop_opt_buffer != nullptr, "RMSProp Opt Buffer not initialized.");
+            auto &v = rmsprop_opt_buffer->opt_v_tensor;
+            DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(v.data_type().type(), opt_t, [&] {
+              launch(RMSPropOptimizer<wgrad_t, opt_t>{v.data<opt_t>(), hyperparams.rmsprop.beta,
+                                                      hyperparams.rmsprop.epsilon, seed});
+            });
+          } else {
+            auto momentum_opt_buffer = std::get_if<MomentumOptBuffer>(&opt_buffer_);
+            HCTR_CHECK_HINT(momentum_opt_buffer != nullptr,
+                            "Momentum Opt Buffer not initialized.");
+            auto &m = momentum_opt_buffer->opt_m_tensor;
+            DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(m.data_type().type(), opt_t, [&] {
+              if (opt_param_.optimizer == HugeCTR::Optimizer_t::MomentumSGD) {
+                launch(MomentumSGDOptimizer<wgrad_t, opt_t>{m.data<opt_t>(),
+                                                            hyperparams.momentum.factor, seed});
+              } else {
+                launch(NesterovOptimizer<wgrad_t, opt_t>{m.data<opt_t>(), hyperparams.nesterov.mu,
+                                                         seed});
+              }
+            });
+          }
+        });
+      });
+    });
+  } else if (opt_param_.optimizer == HugeCTR::Optimizer_t::RowWiseAdaGrad ||
+             opt_param_.optimizer == HugeCTR::Optimizer_t::LazyAdam) {
+    DISPATCH_INTEGRAL_FUNCTION_CORE23(unique_keys.data_type().type(), key_t, [&] {
+      DISPATCH_INTEGRAL_FUNCTION_CORE23(num_key_per_table_offset_.data_type().type(), index_t, [&] {
+        DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(wgrad.data_type().type(), wgrad_t, [&] {
+          RaggedKeyToIndicesFunc<key_t, index_t> key_to_indices_func{
+              table_ids_.data<int>(),
+              local_ev_size_list_.data<int>(),
+              table_ids_.num_elements(),
+              num_key_per_table_offset_.data<index_t>(),
+              emb_table_ev_offset_.data<uint64_t>(),
+          };
+
+          auto launch = [&](auto optimizer) {
+            constexpr int block_size = 256;
+            const auto &kernel_param = core_->get_kernel_param();
+            const int grid_size =
+                HugeCTR::ceildiv(kernel_param.num_sms * kernel_param.max_thread_per_sm, block_size);
+            update_row_wise_kernel<key_t, index_t, wgrad_t, decltype(optimizer),
+                                   decltype(key_to_indices_func)>
+                <<<grid_size, block_size, 0, stream>>>(
+                    unique_keys.data<key_t>(), num_unique_keys.data<size_t>(),
+                    table_ids.data<int>(), wgrad.data<wgrad_t>(), ev_start_indices.data<uint32_t>(),
+                    key_to_indices_func, emb_table_.data<float>(), optimizer, device_lr_,
+                    lr_scale, opt_param_.scaler);
+          };
+
+          const auto &hyperparams = opt_param_.hyperparams;
+          if (opt_param_.optimizer == HugeCTR::Optimizer_t::RowWiseAdaGrad) {
+            auto row_wise_adagrad_opt_buffer = std::get_if<RowWiseAdaGradOptBuffer>(&opt_buffer_);
+            HCTR_CHECK_HINT(row_wise_adagrad_opt_buffer != nullptr,
+                            "RowWiseAdaGrad Opt Buffer not initialized.");
+            launch(RowWiseAdaGradOptimizer<wgrad_t>{
+                row_wise_adagrad_opt_buffer->opt_accum_tensor.data<float>(),
+                hyperparams.adagrad.epsilon});
+          } else {
+            auto lazy_adam_opt_buffer = std::get_if<LazyAdamOptBuffer>(&opt_buffer_);
+            HCTR_CHECK_HINT(lazy_adam_opt_buffer != nullptr,
+                            "LazyAdam Opt Buffer not initialized.");
+            auto &m = lazy_adam_opt_buffer->opt_m_tensor;
+            float2 *vt = reinterpret_cast<float2 *>(lazy_adam_opt_buffer->opt_row_tensor.data());
+            DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(m.data_type().type(), opt_t, [&] {
+              launch(LazyAdamOptimizer<wgrad_t, opt_t>{m.data<opt_t>(), vt, hyperparams.adam.beta1,
+                                                       hyperparams.adam.beta2,
+                                                       hyperparams.adam.epsilon, seed});
+            });
+          }
+        });
+      });
+    });
   } else {
     HCTR_OWN_THROW(HugeCTR::Error_t::IllegalCall, "optimizer not implemented");
   }
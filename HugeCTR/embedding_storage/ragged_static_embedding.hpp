@@ -31,12 +31,39 @@ struct FtrlOptBuffer {
   core23::Tensor opt_n_tensor;
 };
 
-using OptBuffer = std::variant<AdaGradOptBuffer, FtrlOptBuffer>;
+// m and v interleaved per element.
+struct AdamOptBuffer {
+  core23::Tensor opt_mv_tensor;
+};
+
+struct RMSPropOptBuffer {
+  core23::Tensor opt_v_tensor;
+};
+
+// Shared by MomentumSGD and Nesterov.
+struct MomentumOptBuffer {
+  core23::Tensor opt_m_tensor;
+};
+
+// One float accumulator per row.
+struct RowWiseAdaGradOptBuffer {
+  core23::Tensor opt_accum_tensor;
+};
+
+// m per element, and v and t as floats per row.
+struct LazyAdamOptBuffer {
+  core23::Tensor opt_m_tensor;
+  core23::Tensor opt_row_tensor;
+};
+
+using OptBuffer = std::variant<AdaGradOptBuffer, FtrlOptBuffer, AdamOptBuffer, RMSPropOptBuffer,
+                               MomentumOptBuffer, RowWiseAdaGradOptBuffer, LazyAdamOptBuffer>;
 
 class RaggedStaticEmbeddingTable final : public IGroupedEmbeddingTable {
   std::shared_ptr<CoreResourceManager> core_;
 
-  std::vector<size_t> h_num_key_per_table_;
+  std::vector<size_t> h_num_key_per_table_;      // owned keys
+  std::vector<size_t> h_num_hot_key_per_table_;  // replicated hot keys of hybrid tables
   std::vector<size_t> h_num_key_per_table_offset_;
   std::vector<size_t> h_size_per_table_;
   std::vector<uint64_t> h_emb_table_ev_offset_;
@@ -52,10 +79,14 @@ class RaggedStaticEmbeddingTable final : public IGroupedEmbeddingTable {
   core23::Tensor emb_table_;
   core23::Tensor emb_table_ev_offset_;  // num_local_id_space + 1
   core23::Tensor local_ev_size_list_;   // num_local_id_space
+  core23::Tensor dirty_rows_;           // one flag per row of keys_, set by update
+  core23::Tensor update_counts_;        // uint8_t per row of keys_, saturating, set by update
   bool use_vectorized_kernel_;
 
   HugeCTR::OptParams opt_param_;
   OptBuffer opt_buffer_;
+  uint32_t update_step_{0};  // Seeds the stochastic rounding of fp16 optimizer states.
+  const float *device_lr_ = nullptr;
 
  public:
   RaggedStaticEmbeddingTable(const HugeCTR::GPUResource &gpu_resource,
@@ -89,6 +120,13 @@ class RaggedStaticEmbeddingTable final : public IGroupedEmbeddingTable {
   void load_by_id(core23::Tensor *h_keys_tensor, core23::Tensor *h_embedding_table,
                   int table_id) override;
 
+  std::vector<size_t> dirty_key_num_per_table() const override;
+
+  void dump_dirty_by_id(core23::Tensor *h_keys_tensor, core23::Tensor *h_embedding_table,
+                        int table_id) override;
+
+  void dump_update_counts_by_id(core23::Tensor *h_update_counts, int table_id) override;
+
   size_t size() const override;
 
   size_t capacity() const override;
@@ -108,6 +146,8 @@ class RaggedStaticEmbeddingTable final : public IGroupedEmbeddingTable {
   void clear() override;
 
   void set_learning_rate(float lr) override { opt_param_.lr = lr; }
+
+  void set_device_learning_rate(const float *lr) override { device_lr_ = lr; }
 };
 
 }  // namespace embedding
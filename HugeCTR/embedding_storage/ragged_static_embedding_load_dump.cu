@@ -16,6 +16,7 @@
 
 #include <curand_kernel.h>
 
+#include <cub/cub.cuh>
 #include <data_simulator.hpp>
 #include <embedding/operators/generic_lookup.cuh>
 #include <embedding/view.hpp>
@@ -62,9 +63,10 @@ __global__ void embedding_insert_kernel(
 template <typename key_t, typename index_t, typename emb_t>
 __global__ void embedding_insert_by_tableindex_kernel(
     const key_t *insert_keys, size_t num_keys, const key_t *keys_table,
-    const index_t *num_key_per_table_offset, const emb_t *insert_embedding_values,
-    float *embedding_table, int table_index, size_t max_vocabulary_size,
-    const uint64_t *embedding_table_offsets, const int *table_ev_size_list) {
+    const index_t *num_key_per_table_offset, size_t num_table_keys, size_t num_hot_keys,
+    const emb_t *insert_embedding_values, float *embedding_table, int table_index,
+    size_t max_vocabulary_size, const uint64_t *embedding_table_offsets,
+    const int *table_ev_size_list) {
   uint32_t tid = threadIdx.x + blockIdx.x * blockDim.x;
   if (tid >= num_keys) return;
 
@@ -72,18 +74,57 @@ __global__ void embedding_insert_by_tableindex_kernel(
   key_t insert_key = insert_keys[tid];
   assert(insert_key < max_vocabulary_size);
   assert(insert_key >= 0);
-  index_t key_offset = num_key_per_table_offset[table_index];
-  uint64_t idx =
-      static_cast<uint64_t>(bs_upper_bound_sub_one(keys_table + key_offset, num_keys, insert_key));
+  const key_t *table_keys = keys_table + num_key_per_table_offset[table_index];
   uint64_t embedding_value_offset = embedding_table_offsets[table_index];
   float *tmp_embedding_table = embedding_table + embedding_value_offset;
   uint64_t input_offset = (uint64_t)tid * (uint64_t)embedding_vector_size;
-  uint64_t output_offset = (uint64_t)idx * (uint64_t)embedding_vector_size;
 
-  for (uint64_t i = 0; i < embedding_vector_size; ++i) {
-    float ei =
-        HugeCTR::TypeConvertFunc<float, emb_t>::convert(insert_embedding_values[input_offset + i]);
-    tmp_embedding_table[output_offset + i] = ei;
+  auto insert = [&](uint64_t idx) {
+    uint64_t output_offset = (uint64_t)idx * (uint64_t)embedding_vector_size;
+    for (uint64_t i = 0; i < embedding_vector_size; ++i) {
+      float ei = HugeCTR::TypeConvertFunc<float, emb_t>::convert(
+          insert_embedding_values[input_offset + i]);
+      tmp_embedding_table[output_offset + i] = ei;
+    }
+  };
+  // The owned keys, followed by the replicated hot keys of a hybrid table. Both are sorted.
+  if (num_table_keys > 0) {
+    int64_t idx = bs_upper_bound_sub_one(table_keys, static_cast<int64_t>(num_table_keys),
+                                         insert_key);
+    if (idx >= 0 && idx < static_cast<int64_t>(num_table_keys) && table_keys[idx] == insert_key) {
+      insert(idx);
+    }
+  }
+  if (num_hot_keys > 0) {
+    const key_t *hot_keys = table_keys + num_table_keys;
+    int64_t pos = bs_upper_bound_sub_one(hot_keys, static_cast<int64_t>(num_hot_keys), insert_key);
+    if (pos >= 0 && pos < static_cast<int64_t>(num_hot_keys) && hot_keys[pos] == insert_key) {
+      insert(num_table_keys + pos);
+    }
+  }
+}
+
+__global__ void count_dirty_rows_kernel(const uint8_t *dirty_rows, size_t num_rows,
+                                        unsigned long long *num_dirty_rows) {
+  unsigned long long local_num_dirty_rows = 0;
+  CUDA_1D_KERNEL_LOOP_T(size_t, i, num_rows) { local_num_dirty_rows += dirty_rows[i]; }
+  if (local_num_dirty_rows > 0) {
+    atomicAdd(num_dirty_rows, local_num_dirty_rows);
+  }
+}
+
+template <typename key_t>
+__global__ void gather_dirty_rows_kernel(const uint64_t *dirty_row_indices, size_t num_dirty_rows,
+                                         const key_t *table_keys, const float *table_vectors,
+                                         int ev_size, key_t *dirty_keys, float *dirty_vectors) {
+  CUDA_1D_KERNEL_LOOP_T(size_t, i, num_dirty_rows * ev_size) {
+    size_t dirty_row = i / ev_size;
+    int ev_id = i % ev_size;
+    uint64_t row = dirty_row_indices[dirty_row];
+    if (ev_id == 0) {
+      dirty_keys[dirty_row] = table_keys[row];
+    }
+    dirty_vectors[i] = table_vectors[row * ev_size + ev_id];
   }
 }
 
@@ -201,6 +242,7 @@ void RaggedStaticEmbeddingTable::load_by_id(core23::Tensor *h_keys_tensor,
           size_t max_vocabulary_size = h_table_max_vocabulary_size_[table_index];
           size_t num_keys = h_keys_tensor->num_elements();
           size_t table_keys = h_num_key_per_table_[table_index];
+          size_t hot_keys = h_num_hot_key_per_table_[table_index];
 
           {
             constexpr int block_size = 256;
@@ -208,14 +250,135 @@ void RaggedStaticEmbeddingTable::load_by_id(core23::Tensor *h_keys_tensor,
                 (static_cast<int64_t>(h_keys_tensor->num_elements()) - 1) / block_size + 1;
             embedding_insert_by_tableindex_kernel<<<grid_size, block_size>>>(
                 (key_t *)d_keys.data(), num_keys, keys_.data<key_t>(),
-                num_key_per_table_offset_.data<index_t>(), (float *)d_embedding_vector.data(),
-                emb_table_.data<float>(), table_index, max_vocabulary_size,
-                emb_table_ev_offset_.data<uint64_t>(), local_ev_size_list_.data<int>());
+                num_key_per_table_offset_.data<index_t>(), table_keys, hot_keys,
+                (float *)d_embedding_vector.data(), emb_table_.data<float>(), table_index,
+                max_vocabulary_size, emb_table_ev_offset_.data<uint64_t>(),
+                local_ev_size_list_.data<int>());
           }
         });
   });
 }
 
+std::vector<size_t> RaggedStaticEmbeddingTable::dirty_key_num_per_table() const {
+  CudaDeviceContext context(core_->get_device_id());
+  auto stream = core_->get_local_gpu()->get_stream();
+
+  core23::Device device(core23::DeviceType::GPU, core_->get_device_id());
+  core23::TensorParams params = core23::TensorParams().device(device);
+  auto num_dirty_rows = core23::Tensor(params.shape({static_cast<int64_t>(h_table_ids_.size())})
+                                           .data_type(core23::ScalarType::UInt64));
+  HCTR_LIB_THROW(cudaMemsetAsync(num_dirty_rows.data(), 0, num_dirty_rows.num_bytes(), stream));
+
+  // The replicated hot rows are not dumped, only the owned rows are counted.
+  const auto &kernel_param = core_->get_kernel_param();
+  constexpr int block_size = 256;
+  for (size_t i = 0; i < h_table_ids_.size(); ++i) {
+    if (h_num_key_per_table_[i] == 0) continue;
+    const int grid_size =
+        std::min<size_t>((h_num_key_per_table_[i] - 1) / block_size + 1,
+                         kernel_param.num_sms * kernel_param.max_thread_per_sm / block_size);
+    count_dirty_rows_kernel<<<grid_size, block_size, 0, stream>>>(
+        dirty_rows_.data<uint8_t>() + h_num_key_per_table_offset_[i], h_num_key_per_table_[i],
+        reinterpret_cast<unsigned long long *>(num_dirty_rows.data<uint64_t>() + i));
+  }
+  std::vector<size_t> h_num_dirty_rows(h_table_ids_.size());
+  HCTR_LIB_THROW(cudaMemcpyAsync(h_num_dirty_rows.data(), num_dirty_rows.data(),
+                                 num_dirty_rows.num_bytes(), cudaMemcpyDeviceToHost, stream));
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  return h_num_dirty_rows;
+}
+
+void RaggedStaticEmbeddingTable::dump_dirty_by_id(core23::Tensor *h_keys_tensor,
+                                                  core23::Tensor *h_embedding_table,
+                                                  int table_id) {
+  auto it = find(h_table_ids_.begin(), h_table_ids_.end(), table_id);
+  int table_index = 0;
+  if (it != h_table_ids_.end()) {
+    table_index = it - h_table_ids_.begin();
+  } else {
+    HCTR_OWN_THROW(HugeCTR::Error_t::WrongInput, "Error: Wrong table id");
+  }
+
+  CudaDeviceContext context(core_->get_device_id());
+  auto stream = core_->get_local_gpu()->get_stream();
+  const size_t num_keys = h_num_key_per_table_[table_index];
+  const int ev_size = h_local_ev_sizes_[table_index];
+  uint8_t *dirty_rows = dirty_rows_.data<uint8_t>() + h_num_key_per_table_offset_[table_index];
+
+  core23::Device device(core23::DeviceType::GPU, core_->get_device_id());
+  core23::TensorParams params = core23::TensorParams().device(device);
+  auto dirty_row_indices = core23::Tensor(
+      params.shape({static_cast<int64_t>(std::max<size_t>(num_keys, 1))})
+          .data_type(core23::ScalarType::UInt64));
+  auto num_dirty_rows = core23::Tensor(params.shape({1}).data_type(core23::ScalarType::UInt64));
+  size_t temp_bytes = 0;
+  cub::DeviceSelect::Flagged(nullptr, temp_bytes, cub::CountingInputIterator<uint64_t>(0),
+                             dirty_rows, (uint64_t *)nullptr, (size_t *)nullptr, num_keys, stream);
+  auto temp_storage =
+      core23::Tensor(params.shape({static_cast<int64_t>(std::max<size_t>(temp_bytes, 1))})
+                         .data_type(core23::ScalarType::Char));
+  cub::DeviceSelect::Flagged(temp_storage.data(), temp_bytes,
+                             cub::CountingInputIterator<uint64_t>(0), dirty_rows,
+                             dirty_row_indices.data<uint64_t>(), num_dirty_rows.data<size_t>(),
+                             num_keys, stream);
+  size_t h_num_dirty_rows = 0;
+  HCTR_LIB_THROW(cudaMemcpyAsync(&h_num_dirty_rows, num_dirty_rows.data(), sizeof(size_t),
+                                 cudaMemcpyDeviceToHost, stream));
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  HCTR_CHECK_HINT(h_num_dirty_rows == static_cast<size_t>(h_keys_tensor->num_elements()),
+                  "The number of dirty keys of table %d changed since it was queried", table_id);
+
+  auto key_type = keys_.data_type();
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(key_type.type(), key_t, [&] {
+    if (h_num_dirty_rows == 0) return;
+    auto dirty_keys =
+        core23::Tensor(params.shape({static_cast<int64_t>(h_num_dirty_rows)}).data_type(key_type));
+    auto dirty_vectors =
+        core23::Tensor(params.shape({static_cast<int64_t>(h_num_dirty_rows * ev_size)})
+                           .data_type(core23::ScalarType::Float));
+
+    constexpr int block_size = 256;
+    const auto &kernel_param = core_->get_kernel_param();
+    const int grid_size =
+        std::min<size_t>((h_num_dirty_rows * ev_size - 1) / block_size + 1,
+                         kernel_param.num_sms * kernel_param.max_thread_per_sm / block_size);
+    gather_dirty_rows_kernel<<<grid_size, block_size, 0, stream>>>(
+        dirty_row_indices.data<uint64_t>(), h_num_dirty_rows,
+        keys_.data<key_t>() + h_num_key_per_table_offset_[table_index],
+        emb_table_.data<float>() + h_emb_table_ev_offset_[table_index], ev_size,
+        dirty_keys.data<key_t>(), dirty_vectors.data<float>());
+    HCTR_LIB_THROW(cudaMemcpyAsync(h_keys_tensor->data(), dirty_keys.data(),
+                                   dirty_keys.num_bytes(), cudaMemcpyDeviceToHost, stream));
+    HCTR_LIB_THROW(cudaMemcpyAsync(h_embedding_table->data(), dirty_vectors.data(),
+                                   dirty_vectors.num_bytes(), cudaMemcpyDeviceToHost, stream));
+  });
+
+  // The next delta starts from this dump, the replicated hot rows included.
+  HCTR_LIB_THROW(cudaMemsetAsync(dirty_rows, 0,
+                                 h_num_key_per_table_offset_[table_index + 1] -
+                                     h_num_key_per_table_offset_[table_index],
+                                 stream));
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+}
+
+void RaggedStaticEmbeddingTable::dump_update_counts_by_id(core23::Tensor *h_update_counts,
+                                                          int table_id) {
+  auto it = find(h_table_ids_.begin(), h_table_ids_.end(), table_id);
+  if (it == h_table_ids_.end()) {
+    HCTR_OWN_THROW(HugeCTR::Error_t::WrongInput, "Error: Wrong table id");
+  }
+  int table_index = it - h_table_ids_.begin();
+  HCTR_CHECK(h_update_counts->data_type() == core23::ScalarType::UInt8);
+
+  CudaDeviceContext context(core_->get_device_id());
+  auto stream = core_->get_local_gpu()->get_stream();
+  HCTR_LIB_THROW(cudaMemcpyAsync(
+      h_update_counts->data(),
+      update_counts_.data<uint8_t>() + h_num_key_per_table_offset_[table_index],
+      h_num_key_per_table_[table_index], cudaMemcpyDeviceToHost, stream));
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+}
+
 size_t RaggedStaticEmbeddingTable::size() const { return emb_table_size_; }
 
 size_t RaggedStaticEmbeddingTable::capacity() const { return emb_table_size_; }
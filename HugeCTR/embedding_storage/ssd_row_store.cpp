@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <core23/error.hpp>
+#include <core23/logger.hpp>
+#include <cstdio>
+#include <cstring>
+#include <embedding_storage/ssd_row_store.hpp>
+
+namespace embedding {
+
+namespace {
+
+// Rows that are adjacent in the file are read with one call, up to this size.
+constexpr size_t kMaxReadBytes = size_t{1} << 24;
+
+void write_fully(int fd, const char *data, size_t size, uint64_t offset, const std::string &path) {
+  size_t bytes_written = 0;
+  while (bytes_written < size) {
+    const ssize_t ret = ::pwrite(fd, data + bytes_written, size - bytes_written,
+                                 static_cast<off_t>(offset + bytes_written));
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    HCTR_THROW_IF(ret <= 0, HugeCTR::Error_t::BrokenFile, "Cannot write ", path, ": ",
+                  std::strerror(errno));
+    bytes_written += ret;
+  }
+}
+
+void read_fully(int fd, char *data, size_t size, uint64_t offset, const std::string &path) {
+  size_t bytes_read = 0;
+  while (bytes_read < size) {
+    const ssize_t ret = ::pread(fd, data + bytes_read, size - bytes_read,
+                                static_cast<off_t>(offset + bytes_read));
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    HCTR_THROW_IF(ret <= 0, HugeCTR::Error_t::BrokenFile, "Cannot read ", path, ": ",
+                  ret < 0 ? std::strerror(errno) : "unexpected end of file");
+    bytes_read += ret;
+  }
+}
+
+}  // namespace
+
+SSDRowStore::SSDRowStore(const std::string &path, size_t row_bytes, size_t buffer_bytes)
+    : path_(path), row_bytes_(row_bytes) {
+  HCTR_THROW_IF(row_bytes_ == 0, HugeCTR::Error_t::WrongInput, "The rows of ", path_,
+                " are empty.");
+  buffer_rows_ = std::max<size_t>(buffer_bytes / row_bytes_, 1);
+  fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  HCTR_THROW_IF(fd_ < 0, HugeCTR::Error_t::FileCannotOpen, "Cannot open ", path_, ": ",
+                std::strerror(errno));
+  buffer_.reserve(buffer_rows_ * row_bytes_);
+}
+
+SSDRowStore::~SSDRowStore() {
+  ::close(fd_);
+  if (::unlink(path_.c_str()) != 0) {
+    HCTR_LOG_S(WARNING, WORLD) << "Cannot remove " << path_ << ": " << std::strerror(errno)
+                               << std::endl;
+  }
+}
+
+void SSDRowStore::put(const uint64_t *keys, size_t num_keys, const char *rows) {
+  for (size_t i = 0; i < num_keys; ++i) {
+    if (buffer_.size() == buffer_rows_ * row_bytes_) {
+      flush_buffer();
+    }
+    index_[keys[i]] = file_bytes_ + buffer_.size();
+    buffer_.insert(buffer_.end(), rows + i * row_bytes_, rows + (i + 1) * row_bytes_);
+  }
+
+  const uint64_t live_bytes = index_.size() * row_bytes_;
+  if (file_bytes_ > 2 * live_bytes && file_bytes_ > buffer_rows_ * row_bytes_) {
+    compact();
+  }
+}
+
+void SSDRowStore::get(const uint64_t *keys, size_t num_keys, char *rows) const {
+  std::vector<std::pair<uint64_t, size_t>> offsets;
+  offsets.reserve(num_keys);
+  for (size_t i = 0; i < num_keys; ++i) {
+    auto it = index_.find(keys[i]);
+    HCTR_THROW_IF(it == index_.end(), HugeCTR::Error_t::WrongInput, "Key ", keys[i],
+                  " is not stored in ", path_);
+    offsets.emplace_back(it->second, i);
+  }
+  read_rows(offsets, rows);
+}
+
+void SSDRowStore::erase(const uint64_t *keys, size_t num_keys) {
+  for (size_t i = 0; i < num_keys; ++i) {
+    index_.erase(keys[i]);
+  }
+}
+
+void SSDRowStore::clear() {
+  index_.clear();
+  buffer_.clear();
+  file_bytes_ = 0;
+  HCTR_THROW_IF(::ftruncate(fd_, 0) != 0, HugeCTR::Error_t::BrokenFile, "Cannot truncate ",
+                path_, ": ", std::strerror(errno));
+}
+
+void SSDRowStore::for_each(const std::function<void(uint64_t key, const char *row)> &visit) const {
+  std::vector<uint64_t> keys;
+  std::vector<std::pair<uint64_t, size_t>> offsets;
+  keys.reserve(index_.size());
+  offsets.reserve(index_.size());
+  for (const auto &[key, offset] : index_) {
+    offsets.emplace_back(offset, keys.size());
+    keys.push_back(key);
+  }
+
+  // Visits the rows in chunks, the store does not fit the host memory in general.
+  const size_t chunk_rows = std::max<size_t>(kMaxReadBytes / row_bytes_, 1);
+  std::sort(offsets.begin(), offsets.end());
+  std::vector<char> rows(std::min(chunk_rows, offsets.size()) * row_bytes_);
+  for (size_t begin = 0; begin < offsets.size(); begin += chunk_rows) {
+    const size_t end = std::min(begin + chunk_rows, offsets.size());
+    std::vector<std::pair<uint64_t, size_t>> chunk(offsets.begin() + begin, offsets.begin() + end);
+    for (size_t i = 0; i < chunk.size(); ++i) {
+      chunk[i].second = i;
+    }
+    read_rows(chunk, rows.data());
+    for (size_t i = begin; i < end; ++i) {
+      visit(keys[offsets[i].second], rows.data() + (i - begin) * row_bytes_);
+    }
+  }
+}
+
+void SSDRowStore::flush_buffer() {
+  if (buffer_.empty()) {
+    return;
+  }
+  write_fully(fd_, buffer_.data(), buffer_.size(), file_bytes_, path_);
+  file_bytes_ += buffer_.size();
+  buffer_.clear();
+}
+
+void SSDRowStore::read_rows(const std::vector<std::pair<uint64_t, size_t>> &offsets,
+                            char *rows) const {
+  std::vector<std::pair<uint64_t, size_t>> sorted(offsets);
+  std::sort(sorted.begin(), sorted.end());
+
+  std::vector<char> run;
+  size_t i = 0;
+  while (i < sorted.size()) {
+    const uint64_t offset = sorted[i].first;
+    if (offset >= file_bytes_) {
+      std::memcpy(rows + sorted[i].second * row_bytes_, buffer_.data() + (offset - file_bytes_),
+                  row_bytes_);
+      ++i;
+      continue;
+    }
+
+    // Reads the run of adjacent rows in the file that starts here.
+    size_t j = i + 1;
+    while (j < sorted.size() && sorted[j].first == offset + (j - i) * row_bytes_ &&
+           sorted[j].first < file_bytes_ && (j - i + 1) * row_bytes_ <= kMaxReadBytes) {
+      ++j;
+    }
+    if (j - i == 1) {
+      read_fully(fd_, rows + sorted[i].second * row_bytes_, row_bytes_, offset, path_);
+    } else {
+      run.resize((j - i) * row_bytes_);
+      read_fully(fd_, run.data(), run.size(), offset, path_);
+      for (size_t k = i; k < j; ++k) {
+        std::memcpy(rows + sorted[k].second * row_bytes_, run.data() + (k - i) * row_bytes_,
+                    row_bytes_);
+      }
+    }
+    i = j;
+  }
+}
+
+void SSDRowStore::compact() {
+  flush_buffer();
+
+  const std::string tmp_path = path_ + ".compact";
+  const int tmp_fd = ::open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  HCTR_THROW_IF(tmp_fd < 0, HugeCTR::Error_t::FileCannotOpen, "Cannot open ", tmp_path, ": ",
+                std::strerror(errno));
+
+  // Copies the live rows in the order of the file, so that the rows written together stay
+  // together.
+  std::vector<std::pair<uint64_t, uint64_t>> offsets;
+  offsets.reserve(index_.size());
+  for (const auto &[key, offset] : index_) {
+    offsets.emplace_back(offset, key);
+  }
+  std::sort(offsets.begin(), offsets.end());
+
+  const size_t chunk_rows = std::max<size_t>(kMaxReadBytes / row_bytes_, 1);
+  std::vector<char> rows(std::min(chunk_rows, offsets.size()) * row_bytes_);
+  uint64_t new_bytes = 0;
+  for (size_t begin = 0; begin < offsets.size(); begin += chunk_rows) {
+    const size_t end = std::min(begin + chunk_rows, offsets.size());
+    std::vector<std::pair<uint64_t, size_t>> chunk;
+    chunk.reserve(end - begin);
+    for (size_t i = begin; i < end; ++i) {
+      chunk.emplace_back(offsets[i].first, i - begin);
+    }
+    read_rows(chunk, rows.data());
+    write_fully(tmp_fd, rows.data(), chunk.size() * row_bytes_, new_bytes, tmp_path);
+    for (size_t i = begin; i < end; ++i) {
+      index_[offsets[i].second] = new_bytes + (i - begin) * row_bytes_;
+    }
+    new_bytes += chunk.size() * row_bytes_;
+  }
+
+  HCTR_THROW_IF(::rename(tmp_path.c_str(), path_.c_str()) != 0, HugeCTR::Error_t::BrokenFile,
+                "Cannot replace ", path_, ": ", std::strerror(errno));
+  ::close(fd_);
+  fd_ = tmp_fd;
+  file_bytes_ = new_bytes;
+}
+
+}  // namespace embedding
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace embedding {
+
+/**
+ * A log-structured store of fixed-size rows in a file, for the rows that a dynamic embedding
+ * table offloads from the GPU. New rows, and new versions of rows, are appended to a host buffer
+ * that is written to the end of the file when it is full, so that the SSD only sees large
+ * sequential writes. The index in host memory maps the keys to the offsets of their latest
+ * versions. Reads are sorted by offset and coalesced.
+ *
+ * Erased and overwritten rows leave garbage in the file, which is compacted once it takes more
+ * space than the live rows. The file is removed with the store.
+ */
+class SSDRowStore {
+ public:
+  SSDRowStore(const std::string &path, size_t row_bytes, size_t buffer_bytes);
+  ~SSDRowStore();
+
+  SSDRowStore(const SSDRowStore &) = delete;
+  SSDRowStore &operator=(const SSDRowStore &) = delete;
+
+  size_t size() const { return index_.size(); }
+  size_t row_bytes() const { return row_bytes_; }
+  bool contains(uint64_t key) const { return index_.find(key) != index_.end(); }
+
+  // Appends the rows, `num_keys * row_bytes()` bytes, replacing the stored versions.
+  void put(const uint64_t *keys, size_t num_keys, const char *rows);
+
+  // Reads the rows of the keys, which must be stored, in the order of the keys.
+  void get(const uint64_t *keys, size_t num_keys, char *rows) const;
+
+  // Forgets the keys. Keys that are not stored are ignored.
+  void erase(const uint64_t *keys, size_t num_keys);
+
+  void clear();
+
+  // Visits all the stored rows, in the order of the file.
+  void for_each(const std::function<void(uint64_t key, const char *row)> &visit) const;
+
+ private:
+  void flush_buffer();
+  void read_rows(const std::vector<std::pair<uint64_t, size_t>> &offsets, char *rows) const;
+  void compact();
+
+  std::string path_;
+  int fd_;
+  size_t row_bytes_;
+  size_t buffer_rows_;
+
+  std::unordered_map<uint64_t, uint64_t> index_;  // key -> offset of the latest version
+  uint64_t file_bytes_ = 0;                       // Written to the file, without the buffer.
+  std::vector<char> buffer_;                      // Rows appended after `file_bytes_`.
+};
+
+}  // namespace embedding
@@ -170,6 +170,7 @@ struct EmbeddingParameterInfo {
   // only for train dump,other parts don't need this variable
   int embedding_collection_id = 0;
   std::shared_ptr<struct GlobalEmbeddingDistribution> gemb_distribution;
+  bool dirty_only = false;  // only the rows updated since the last dump of this kind
 };
 
 }  // namespace embedding
@@ -14,11 +14,42 @@
  * limitations under the License.
  */
 
+#include <omp.h>
+
+#include <algorithm>
+#include <cmath>
 #include <embedding_storage/weight_io/parameter_IO.hpp>
+#include <future>
+#include <hps/quantize.hpp>
 
 using namespace HugeCTR;
 namespace embedding {
 
+namespace {
+
+// The size of the keys and weights of a chunk that load_embedding_weight_in_chunks reads at once.
+constexpr size_t LoadChunkNbytes = 256ul << 20;
+
+// Row-wise like the fp8 tables of the HPS (see quantize.cu), which dequantize by the scale.
+void quantize_rows_fp8(const float* vectors, size_t num_rows, size_t ev_size,
+                       __nv_fp8_e4m3* quant_vectors, float* scales) {
+#pragma omp parallel for
+  for (size_t row = 0; row < num_rows; ++row) {
+    const float* src = vectors + row * ev_size;
+    float amax = 0.f;
+    for (size_t i = 0; i < ev_size; ++i) {
+      amax = std::max(amax, std::abs(src[i]));
+    }
+    const float scale = std::max(amax / FP8_E4M3_MAX, 1.f / (FP8_E4M3_MAX * CLAMP));
+    scales[row] = scale;
+    for (size_t i = 0; i < ev_size; ++i) {
+      quant_vectors[row * ev_size + i] = __nv_fp8_e4m3(src[i] / scale);
+    }
+  }
+}
+
+}  // namespace
+
 EmbeddingParameterIO::EmbeddingParameterIO(
     std::shared_ptr<HugeCTR::ResourceManager> resource_manager) {
   resource_manager_ = resource_manager.get();
@@ -82,7 +113,7 @@ void EmbeddingParameterIO::load_metadata(const std::string& parameters_folder_pa
 }
 
 void EmbeddingParameterIO::get_parameter_info_from_model(
-    const std::string& path, std::vector<struct EmbeddingParameterInfo>& epis) {
+    const std::string& path, std::vector<struct EmbeddingParameterInfo>& epis, bool dirty_only) {
   int collections_num = embedding_collections_.size();
   if (collections_num == 0) {
     HCTR_OWN_THROW(HugeCTR::Error_t::UnspecificError,
@@ -100,6 +131,7 @@ void EmbeddingParameterIO::get_parameter_info_from_model(
     tmp_epi.table_nums = tmp_ebc_param.num_table;
     tmp_epi.key_type = tmp_ebc_param.key_type;
     tmp_epi.embedding_value_type = tmp_ebc_param.emb_type;
+    tmp_epi.dirty_only = dirty_only;
 
     if (embedding_collections_[i]->embedding_optimizers_.size() > 0)
       tmp_epi.optimizer_type = embedding_collections_[i]->embedding_optimizers_[0];
@@ -123,7 +155,9 @@ void EmbeddingParameterIO::get_parameter_info_from_model(
 
       for (int grouped_id = 0; grouped_id < embedding_group_num; ++grouped_id) {
         auto group_table_ids = tmp_embedding_tables_per_gpu[grouped_id]->table_ids();
-        auto group_table_kns = tmp_embedding_tables_per_gpu[grouped_id]->key_num_per_table();
+        auto group_table_kns =
+            dirty_only ? tmp_embedding_tables_per_gpu[grouped_id]->dirty_key_num_per_table()
+                       : tmp_embedding_tables_per_gpu[grouped_id]->key_num_per_table();
 
         for (int tmp_table_index = 0; tmp_table_index < group_table_ids.size(); ++tmp_table_index) {
           int tmp_table_id = group_table_ids[tmp_table_index];
@@ -328,8 +362,13 @@ void EmbeddingParameterIO::dump_embedding_weight(const std::string& parameters_f
           HCTR_OWN_THROW(HugeCTR::Error_t::UnspecificError,
                          "can't find table id in any grouped tables");
         }
-        group_embedding_tables[0][group_index]->dump_by_id(&key_tensor_tmp, &weight_tensor_tmp,
-                                                           table_id);
+        if (epi.dirty_only) {
+          group_embedding_tables[0][group_index]->dump_dirty_by_id(&key_tensor_tmp,
+                                                                   &weight_tensor_tmp, table_id);
+        } else {
+          group_embedding_tables[0][group_index]->dump_by_id(&key_tensor_tmp, &weight_tensor_tmp,
+                                                             table_id);
+        }
         char* table_key_ptr = (char*)key_tensor_tmp.data();
         char* table_weight_ptr = (char*)weight_tensor_tmp.data();
 #ifdef ENABLE_MPI
@@ -420,8 +459,13 @@ void EmbeddingParameterIO::dump_embedding_weight(const std::string& parameters_f
 
             HugeCTR::CudaDeviceContext context(core_list_[hit_gpu_id]->get_device_id());
 
-            group_embedding_tables[hit_gpu_id][group_index]->dump_by_id(
-                &key_tensor_tmp, &weight_tensor_tmp, table_id);
+            if (epi.dirty_only) {
+              group_embedding_tables[hit_gpu_id][group_index]->dump_dirty_by_id(
+                  &key_tensor_tmp, &weight_tensor_tmp, table_id);
+            } else {
+              group_embedding_tables[hit_gpu_id][group_index]->dump_by_id(
+                  &key_tensor_tmp, &weight_tensor_tmp, table_id);
+            }
             key_t* tmp_table_key_ptr_part = key_tensor_tmp.data<key_t>();
             float* tmp_table_weight_ptr_part = weight_tensor_tmp.data<float>();
 
@@ -445,6 +489,146 @@ void EmbeddingParameterIO::dump_embedding_weight(const std::string& parameters_f
   });
 }
 
+void EmbeddingParameterIO::export_embedding_weight(const std::string& path,
+                                                   const struct EmbeddingParameterInfo& epi,
+                                                   const std::vector<int>& table_ids,
+                                                   const std::vector<std::string>& table_names,
+                                                   const EmbeddingExportParams& params) {
+  HCTR_CHECK_HINT(table_ids.size() == table_names.size(), "Every exported table needs a name.");
+  HCTR_CHECK_HINT(params.min_update_count >= 0 && params.min_update_count <= UINT8_MAX,
+                  "min_update_count must be in [0, 255], the update counts saturate at 255.");
+  HCTR_CHECK_HINT(params.min_l2_norm >= 0.f, "min_l2_norm must not be negative.");
+  int num_local_gpus = resource_manager_->get_local_gpu_count();
+  int nrank = resource_manager_->get_num_process();
+  int myrank = resource_manager_->get_process_id();
+
+  auto file_system = get_fs_object(path);
+  file_system->make_dir(path);
+  EmbeddingCollection* tmp_ebc = embedding_collections_[epi.embedding_collection_id];
+  auto& group_embedding_tables = tmp_ebc->embedding_tables_;
+  const float min_squared_l2_norm = params.min_l2_norm * params.min_l2_norm;
+
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(epi.key_type.type(), key_t, [&] {
+    for (size_t i = 0; i < table_ids.size(); ++i) {
+      const int table_id = table_ids[i];
+      const size_t table_ev_length = epi.table_embedding_vector_lengths.at(table_id);
+
+      int group_index = -1;
+      for (int group_id = 0; group_id < static_cast<int>(group_embedding_tables.size());
+           ++group_id) {
+        const std::vector<int>& group_table_ids =
+            tmp_ebc->ebc_param_.grouped_table_params[group_id].table_ids;
+        if (std::find(group_table_ids.begin(), group_table_ids.end(), table_id) !=
+            group_table_ids.end()) {
+          group_index = group_id;
+          break;
+        }
+      }
+      if (group_index == -1) {
+        HCTR_OWN_THROW(HugeCTR::Error_t::UnspecificError,
+                       "can't find table id in any grouped tables");
+      }
+
+      // The GPUs of this process that export rows of the table, a data parallel table is exported
+      // from the first GPU only.
+      std::vector<int> local_gpu_id_hit;
+      int parallel_mode = epi.gemb_distribution->get_parallel(table_id);
+      if (parallel_mode == 1) {
+        if (myrank == 0) {
+          local_gpu_id_hit.push_back(0);
+        }
+      } else if (parallel_mode == 2) {
+        for (int local_gpu_id = 0; local_gpu_id < num_local_gpus; ++local_gpu_id) {
+          int global_gpu_id = core_list_[local_gpu_id]->get_global_gpu_id();
+          if (epi.gemb_distribution->get(global_gpu_id, table_id) > 0) {
+            local_gpu_id_hit.push_back(local_gpu_id);
+          }
+        }
+      } else {
+        HCTR_OWN_THROW(HugeCTR::Error_t::UnspecificError,
+                       "For now , 3G embedding don't support this parallel model");
+      }
+
+      std::vector<long long> keys;
+      std::vector<float> weights;
+      for (int hit_gpu_id : local_gpu_id_hit) {
+        HugeCTR::CudaDeviceContext context(core_list_[hit_gpu_id]->get_device_id());
+        int global_gpu_id = core_list_[hit_gpu_id]->get_global_gpu_id();
+        const size_t num_keys = epi.gemb_distribution->get(global_gpu_id, table_id);
+
+        core23::Device device(core23::DeviceType::CPU);
+        core23::TensorParams tensor_params = core23::TensorParams().device(device);
+        core23::Tensor key_tensor_tmp{
+            tensor_params.shape({static_cast<int64_t>(num_keys)}).data_type(epi.key_type)};
+        core23::Tensor weight_tensor_tmp{
+            tensor_params.shape({static_cast<int64_t>(num_keys * table_ev_length)})
+                .data_type(epi.embedding_value_type)};
+        core23::Tensor update_count_tensor_tmp{tensor_params.shape({static_cast<int64_t>(num_keys)})
+                                                   .data_type(core23::ScalarType::UInt8)};
+
+        auto& table = group_embedding_tables[hit_gpu_id][group_index];
+        table->dump_by_id(&key_tensor_tmp, &weight_tensor_tmp, table_id);
+        if (params.min_update_count > 0) {
+          table->dump_update_counts_by_id(&update_count_tensor_tmp, table_id);
+        }
+        const key_t* h_keys = key_tensor_tmp.data<key_t>();
+        const float* h_weights = weight_tensor_tmp.data<float>();
+        const uint8_t* h_update_counts = update_count_tensor_tmp.data<uint8_t>();
+
+        for (size_t row = 0; row < num_keys; ++row) {
+          const float* ev = h_weights + row * table_ev_length;
+          if (params.min_update_count > 0 && h_update_counts[row] < params.min_update_count) {
+            continue;
+          }
+          if (min_squared_l2_norm > 0.f) {
+            float squared_l2_norm = 0.f;
+            for (size_t j = 0; j < table_ev_length; ++j) {
+              squared_l2_norm += ev[j] * ev[j];
+            }
+            if (squared_l2_norm < min_squared_l2_norm) {
+              continue;
+            }
+          }
+          keys.push_back(static_cast<long long>(h_keys[row]));
+          weights.insert(weights.end(), ev, ev + table_ev_length);
+        }
+      }
+
+      // The pruned rows of the processes are written one after the other.
+      const size_t num_rows = keys.size();
+      std::vector<size_t> offset_per_rank(nrank, 0);
+      offset_per_rank[myrank] = num_rows;
+#ifdef ENABLE_MPI
+      HCTR_MPI_THROW(MPI_Allgather(&num_rows, 1, MPI_SIZE_T, offset_per_rank.data(), 1, MPI_SIZE_T,
+                                   MPI_COMM_WORLD));
+#endif
+      std::exclusive_scan(offset_per_rank.begin(), offset_per_rank.end(), offset_per_rank.begin(),
+                          0);
+      const size_t row_offset = offset_per_rank[myrank];
+
+      const std::string table_path = path + "/" + table_names[i];
+      file_system->make_dir(table_path);
+      file_system->write_to(table_path + "/key", keys.data(), row_offset * sizeof(long long),
+                            num_rows * sizeof(long long));
+      if (params.fp8_quant) {
+        std::vector<__nv_fp8_e4m3> quant_weights(weights.size());
+        std::vector<float> scales(num_rows);
+        quantize_rows_fp8(weights.data(), num_rows, table_ev_length, quant_weights.data(),
+                          scales.data());
+        file_system->write_to(table_path + "/emb_vector", quant_weights.data(),
+                              row_offset * table_ev_length * sizeof(__nv_fp8_e4m3),
+                              quant_weights.size() * sizeof(__nv_fp8_e4m3));
+        file_system->write_to(table_path + "/quant_scale", scales.data(),
+                              row_offset * sizeof(float), num_rows * sizeof(float));
+      } else {
+        file_system->write_to(table_path + "/emb_vector", weights.data(),
+                              row_offset * table_ev_length * sizeof(float),
+                              weights.size() * sizeof(float));
+      }
+    }
+  });
+}
+
 void EmbeddingParameterIO::dump_opt_state(const std::string& parameters_folder_path,
                                           struct EmbeddingParameterInfo& epi,
                                           const std::vector<int>& table_ids) {
@@ -521,7 +705,7 @@ void EmbeddingParameterIO::load_embedding_weight(
     float* weight_tensor_ptr = weight_tensor_tmp.data<float>();
     float* embedding_weights_ptr = embedding_weights.data<float>();
 
-    file_system->read_from(ebc_weight_path, weight_tensor_ptr, key_num * ev_length * sizeof(key_t),
+    file_system->read_from(ebc_weight_path, weight_tensor_ptr, key_num * ev_length * sizeof(float),
                            FileHeadNbytes);
     size_t tmp_target_key_offset = 0;
     // TODO::need use openmp optimize
@@ -540,6 +724,124 @@ void EmbeddingParameterIO::load_embedding_weight(
   });
 }
 
+void EmbeddingParameterIO::load_embedding_weight_in_chunks(
+    const struct EmbeddingParameterInfo& epi, int fs_table_id,
+    const std::vector<embeddingFilter>& key_selects, const LoadChunkFunc& load_chunk,
+    const core23::DataType& target_key_type, const core23::DataType& target_value_type) {
+  auto file_system = get_fs_object(epi.parameter_folder_path, SparseFSType::FS);
+  std::string ebc_key_path = epi.parameter_folder_path + "/key" + std::to_string(fs_table_id);
+  std::string ebc_weight_path = epi.parameter_folder_path + "/weight" + std::to_string(fs_table_id);
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(epi.key_type.type(), key_t, [&] {
+    size_t ev_length = epi.table_embedding_vector_lengths.at(fs_table_id);
+    size_t key_file_length = file_system->get_file_size(ebc_key_path);
+    size_t weight_file_length = file_system->get_file_size(ebc_weight_path);
+    size_t key_num = (key_file_length - FileHeadNbytes) / sizeof(key_t);
+    size_t weight_num = (weight_file_length - FileHeadNbytes) / sizeof(float) / ev_length;
+    if (key_num != weight_num)
+      HCTR_OWN_THROW(HugeCTR::Error_t::WrongInput,
+                     "Error: key num is not equal with embedding vector num");
+    if (key_num == 0) return;
+
+    const size_t chunk_key_num =
+        std::max<size_t>(LoadChunkNbytes / (sizeof(key_t) + ev_length * sizeof(float)), 1);
+    const size_t num_filters = key_selects.size();
+
+    struct KeyChunk {
+      core23::Tensor keys;
+      core23::Tensor weights;
+      size_t num_keys = 0;
+      size_t first_weight = 0;  // the first key of the chunk whose weights are read
+      std::vector<std::vector<bool>> selected;
+    };
+    // Double buffered, the host tensors are pinned.
+    core23::Device device(core23::DeviceType::CPU);
+    core23::TensorParams params = core23::TensorParams().device(device);
+    std::vector<KeyChunk> chunks(2);
+    for (auto& chunk : chunks) {
+      chunk.keys = core23::Tensor(
+          params.shape({static_cast<int64_t>(chunk_key_num)}).data_type(epi.key_type));
+      chunk.weights =
+          core23::Tensor(params.shape({static_cast<int64_t>(chunk_key_num * ev_length)})
+                             .data_type(core23::ScalarType::Float));
+      chunk.selected.resize(num_filters);
+    }
+
+    auto read_chunk = [&](size_t start, KeyChunk& chunk) {
+      chunk.num_keys = std::min(chunk_key_num, key_num - start);
+      key_t* chunk_keys = chunk.keys.data<key_t>();
+      file_system->read_from(ebc_key_path, chunk_keys, chunk.num_keys * sizeof(key_t),
+                             FileHeadNbytes + start * sizeof(key_t));
+      size_t first = chunk.num_keys;
+      size_t last = 0;
+      for (size_t f = 0; f < num_filters; ++f) {
+        auto& selected = chunk.selected[f];
+        selected.assign(chunk.num_keys, false);
+        for (size_t i = 0; i < chunk.num_keys; ++i) {
+          if (key_selects[f]((size_t)chunk_keys[i])) {
+            selected[i] = true;
+            first = std::min(first, i);
+            last = std::max(last, i);
+          }
+        }
+      }
+      chunk.first_weight = first;
+      if (first < chunk.num_keys) {
+        file_system->read_from(ebc_weight_path, chunk.weights.data<float>() + first * ev_length,
+                               (last - first + 1) * ev_length * sizeof(float),
+                               FileHeadNbytes + (start + first) * ev_length * sizeof(float));
+      }
+    };
+
+    std::future<void> next_read =
+        std::async(std::launch::async, read_chunk, 0, std::ref(chunks[0]));
+    for (size_t start = 0, chunk_id = 0; start < key_num; start += chunk_key_num, ++chunk_id) {
+      next_read.get();
+      KeyChunk& chunk = chunks[chunk_id % 2];
+      if (start + chunk_key_num < key_num) {
+        next_read = std::async(std::launch::async, read_chunk, start + chunk_key_num,
+                               std::ref(chunks[(chunk_id + 1) % 2]));
+      }
+      if (chunk.first_weight == chunk.num_keys) continue;
+
+      std::vector<std::exception_ptr> errors(num_filters);
+#pragma omp parallel for num_threads(num_filters)
+      for (size_t f = 0; f < num_filters; ++f) {
+        try {
+          const auto& selected = chunk.selected[f];
+          size_t target_key_num = std::count(selected.begin(), selected.end(), true);
+          if (target_key_num == 0) continue;
+          core23::Tensor keys(
+              params.shape({static_cast<int64_t>(target_key_num)}).data_type(target_key_type));
+          core23::Tensor embedding_weights(
+              params.shape({static_cast<int64_t>(target_key_num * ev_length)})
+                  .data_type(target_value_type));
+          const key_t* chunk_keys = chunk.keys.data<key_t>();
+          const float* chunk_weights = chunk.weights.data<float>();
+          key_t* keys_ptr = keys.data<key_t>();
+          float* embedding_weights_ptr = embedding_weights.data<float>();
+          size_t target_key_offset = 0;
+          for (size_t i = 0; i < chunk.num_keys; ++i) {
+            if (!selected[i]) continue;
+            keys_ptr[target_key_offset] = chunk_keys[i];
+            std::copy_n(chunk_weights + i * ev_length, ev_length,
+                        embedding_weights_ptr + target_key_offset * ev_length);
+            ++target_key_offset;
+          }
+          load_chunk(f, keys, embedding_weights);
+        } catch (...) {
+          errors[f] = std::current_exception();
+        }
+      }
+      for (auto& error : errors) {
+        if (error) {
+          if (next_read.valid()) next_read.wait();
+          std::rethrow_exception(error);
+        }
+      }
+    }
+  });
+}
+
 void EmbeddingParameterIO::load_opt_state(const struct EmbeddingParameterInfo& epi, int fs_table_id,
                                           core23::Tensor& keys, core23::Tensor& optimizer_buffer,
                                           embeddingFilter key_select,
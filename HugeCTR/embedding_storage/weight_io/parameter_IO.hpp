@@ -19,12 +19,20 @@
 #include <embedding_storage/weight_io/data_info.hpp>
 #include <embedding_storage/weight_io/fs_interface.hpp>
 #include <embeddings/embedding_collection.hpp>
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <vector>
 
 namespace embedding {
 
+// Selects and encodes the rows of an inference export, see export_embedding_weight.
+struct EmbeddingExportParams {
+  int min_update_count = 0;  // rows updated fewer times are pruned, the counts saturate at 255
+  float min_l2_norm = 0.f;   // rows with a smaller L2 norm are pruned
+  bool fp8_quant = false;    // e4m3 values with a float scale per row
+};
+
 class EmbeddingParameterIO {
  public:
   EmbeddingParameterIO() = default;
@@ -46,6 +54,21 @@ class EmbeddingParameterIO {
                              const core23::DataType& target_key_type,
                              const core23::DataType& target_value_type);
 
+  using LoadChunkFunc = std::function<void(size_t filter_id, core23::Tensor& keys,
+                                           core23::Tensor& embedding_weights)>;
+
+  /**
+   * Streams a table of the parameter folder in chunks of keys, the read of the next chunk overlaps
+   * the loading of the current one. Only the weights between the first and the last selected keys
+   * of a chunk are read. The keys of a chunk that key_selects[i] selects are handed to
+   * load_chunk(i, ...), concurrently for the different filters.
+   */
+  void load_embedding_weight_in_chunks(const struct EmbeddingParameterInfo& epi, int fs_table_id,
+                                       const std::vector<embeddingFilter>& key_selects,
+                                       const LoadChunkFunc& load_chunk,
+                                       const core23::DataType& target_key_type,
+                                       const core23::DataType& target_value_type);
+
   void load_opt_state(const struct EmbeddingParameterInfo& epi, int fs_table_id,
                       core23::Tensor& keys, core23::Tensor& optimizer_buffer,
                       embeddingFilter key_select,
@@ -54,7 +77,8 @@ class EmbeddingParameterIO {
                       const core23::DataType& target_value_type);
 
   void get_parameter_info_from_model(const std::string& path,
-                                     std::vector<struct EmbeddingParameterInfo>& epis);
+                                     std::vector<struct EmbeddingParameterInfo>& epis,
+                                     bool dirty_only = false);
 
   void dump_metadata(const std::string& parameters_folder_path,
                      const struct EmbeddingParameterInfo& epi,
@@ -64,6 +88,17 @@ class EmbeddingParameterIO {
                              struct EmbeddingParameterInfo& epi,
                              const std::vector<int>& table_ids = std::vector<int>());
 
+  /**
+   * Writes the tables in the raw format of the HPS, a folder per table under \p path named by
+   * \p table_names , with the `key` (int64) and `emb_vector` files. The rows that fail the
+   * thresholds of \p params are pruned. With fp8_quant, `emb_vector` holds e4m3 values and
+   * `quant_scale` the float scale of each row, which the HPS loads as they are.
+   */
+  void export_embedding_weight(const std::string& path, const struct EmbeddingParameterInfo& epi,
+                               const std::vector<int>& table_ids,
+                               const std::vector<std::string>& table_names,
+                               const EmbeddingExportParams& params);
+
   void dump_opt_state(const std::string& parameters_folder_path, struct EmbeddingParameterInfo& epi,
                       const std::vector<int>& table_ids = std::vector<int>());
 
@@ -21,11 +21,12 @@
 #include <general_buffer2.hpp>
 #include <gpu_resource.hpp>
 #include <memory>
+#include <string>
 #include <tensor2.hpp>
 #include <vector>
 
 namespace HugeCTR {
-enum class AllReduceAlgo { ONESHOT, NCCL };
+enum class AllReduceAlgo { ONESHOT, NCCL, AUTO };
 
 class AllReduceInPlaceComm {
  public:
@@ -36,6 +37,8 @@ class AllReduceInPlaceComm {
   virtual void register_coll_buf(Handle coll) = 0;
   virtual void update_size(Handle coll, const size_t ar_size) = 0;
   virtual void all_reduce(Handle coll, cudaStream_t stream, size_t device_id) = 0;
+  // Called once all the collectives are registered and the communicators can transfer
+  virtual void select_backends() {}
 #ifdef ENABLE_MPI
   static std::shared_ptr<AllReduceInPlaceComm> create(
       size_t num_process, AllReduceAlgo algo, bool use_mixed_precision,
@@ -50,6 +53,9 @@ class AllReduceInPlaceComm {
   static std::shared_ptr<AllReduceInPlaceComm> create_oneshot(
       size_t num_process, bool use_mixed_precision,
       const std::vector<std::shared_ptr<GPUResource>>& gpu_resources, IbComm* ib_comm);
+  static std::shared_ptr<AllReduceInPlaceComm> create_auto(
+      size_t num_process, bool use_mixed_precision,
+      const std::vector<std::shared_ptr<GPUResource>>& gpu_resources, IbComm* ib_comm);
 #endif
   static std::shared_ptr<AllReduceInPlaceComm> create_nccl(
       size_t num_process, bool use_mixed_precision,
@@ -57,6 +63,9 @@ class AllReduceInPlaceComm {
   static std::shared_ptr<AllReduceInPlaceComm> create_oneshot(
       size_t num_process, bool use_mixed_precision,
       const std::vector<std::shared_ptr<GPUResource>>& gpu_resources);
+  static std::shared_ptr<AllReduceInPlaceComm> create_auto(
+      size_t num_process, bool use_mixed_precision,
+      const std::vector<std::shared_ptr<GPUResource>>& gpu_resources);
 };
 
 #ifdef ENABLE_MPI
@@ -153,4 +162,83 @@ class NCCLARInplaceComm : public AllReduceInPlaceComm {
   size_t num_procs_ = 1;
   size_t num_gpus_ = 1;
 };
+
+#ifdef ENABLE_MPI
+/**
+ * Two-level all-reduce: a reduce-scatter among the GPUs of the process, an all-reduce of each
+ * shard among the processes and an all-gather among the GPUs of the process.
+ */
+template <typename T>
+class NCCLTwoLevelARInplaceComm : public AllReduceInPlaceComm {
+ public:
+  virtual Handle register_coll() final;
+  virtual void set_coll_buf(Handle coll, void* ar_ptr, size_t ar_size, size_t device_id) final;
+  virtual void register_coll_buf(Handle coll) final;
+  virtual void update_size(Handle coll, const size_t ar_size) final;
+  virtual void all_reduce(Handle coll, cudaStream_t stream, size_t device_id) final;
+
+  NCCLTwoLevelARInplaceComm(size_t num_procs,
+                            const std::vector<std::shared_ptr<GPUResource>>& gpu_resources);
+  ~NCCLTwoLevelARInplaceComm();
+
+ private:
+  struct ARContextPerGPU {
+    void* ar_ptr_ = NULL;
+  };
+
+  struct ARContext {
+    std::vector<ARContextPerGPU> ctx_;
+    size_t ar_size_ = 0;
+  };
+
+  const std::vector<std::shared_ptr<GPUResource>>& gpu_resources_;
+  std::vector<std::unique_ptr<ARContext>> ar_ctx_;
+  std::vector<ncclComm_t> intra_comms_;
+  std::vector<ncclComm_t> inter_comms_;
+  size_t num_procs_ = 1;
+  size_t num_gpus_ = 1;
+};
+#endif
+
+/**
+ * Forwards every collective to all of its backends and, in select_backends(), times the
+ * all-reduce of each registered collective with every backend that supports its size and keeps
+ * the fastest one. The timings are maxed over all the GPUs, so every process picks the same
+ * backend. The buffers are zeroed after the timing. Until then, the first backend is used.
+ */
+class AutoARInplaceComm : public AllReduceInPlaceComm {
+ public:
+  struct Backend {
+    std::string name_;
+    std::shared_ptr<AllReduceInPlaceComm> comm_;
+    size_t size_alignment_ = 1;
+  };
+
+  virtual Handle register_coll() final;
+  virtual void set_coll_buf(Handle coll, void* ar_ptr, size_t ar_size, size_t device_id) final;
+  virtual void register_coll_buf(Handle coll) final;
+  virtual void update_size(Handle coll, const size_t ar_size) final;
+  virtual void all_reduce(Handle coll, cudaStream_t stream, size_t device_id) final;
+  virtual void select_backends() final;
+
+  AutoARInplaceComm(std::vector<Backend>&& backends,
+                    const std::vector<std::shared_ptr<GPUResource>>& gpu_resources);
+
+ private:
+  struct ARContext {
+    std::vector<Handle> handles_;
+    std::vector<void*> ar_ptrs_;
+    size_t ar_size_ = 0;
+    size_t backend_ = 0;
+  };
+
+  float time_all_reduce(Handle coll, size_t backend);
+
+  std::vector<Backend> backends_;
+  const std::vector<std::shared_ptr<GPUResource>>& gpu_resources_;
+  std::vector<std::unique_ptr<ARContext>> ar_ctx_;
+  size_t num_gpus_ = 1;
+  int warmup_iters_ = 5;
+  int timed_iters_ = 20;
+};
 }  // namespace HugeCTR
@@ -113,6 +113,7 @@ class IbComm {
   std::vector<pthread_t> proxy_thread_;
   std::unique_ptr<ProxyCommand> proxy_cmd_;
   std::vector<std::unique_ptr<IbvProxy::InitConfig>> proxy_cfg_;
+  std::vector<std::unique_ptr<ProxyThreadConfig>> proxy_thread_cfg_;
 
   // Keep a copy local to the main thread as well, in addition to proxy thread for numa
   struct HierA2ACollContextPerGPU {
@@ -22,6 +22,7 @@
 
 #include <boost/serialization/strong_typedef.hpp>
 #include <boost/variant.hpp>
+#include <chrono>
 #include <common.hpp>
 #include <condition_variable>
 
@@ -46,6 +47,9 @@ struct CollSyncHelper {
     while (*(volatile size_t*)(&recv_bcast_cnt_) < count)
       ;
   }
+  bool recv_bcast_ready(size_t count) const {
+    return *(const volatile size_t*)(&recv_bcast_cnt_) >= count;
+  }
 
  private:
   volatile size_t recv_bcast_cnt_ = 1;
@@ -184,6 +188,15 @@ struct ProxyCommand {
   volatile int destroy_ = 0;
 };
 
+// How a proxy thread waits while none of its proxies makes progress: it spins for spin_iters_
+// rounds, then yields the core for yield_iters_ rounds, then sleeps with an exponential backoff
+// of up to max_sleep_us_. With max_sleep_us_ = 0 it keeps yielding instead.
+struct ProxyPollPolicy {
+  size_t spin_iters_ = 1 << 14;
+  size_t yield_iters_ = 1 << 10;
+  size_t max_sleep_us_ = 0;
+};
+
 struct IbvProxy {
   struct IbQpInfo {
     uint32_t lid;
@@ -269,6 +282,7 @@ struct IbvProxy {
     int num_send_completions_ = 0;
     int num_expected_atomic_completions_ = 0;
     int num_atomic_completions_ = 0;
+    std::chrono::steady_clock::time_point send_start_;
 
     bool skip_barrier_ = false;
 
@@ -281,7 +295,8 @@ struct IbvProxy {
     void process_recv();
     void process_send();
     bool wait_send_completion();
-    void stm();
+    // Returns whether the collective made progress
+    bool stm();
   };
 
   struct HierA2AvCollContext {
@@ -325,6 +340,7 @@ struct IbvProxy {
     int num_send_completions_ = 0;
     int num_expected_atomic_completions_ = 0;
     int num_atomic_completions_ = 0;
+    std::chrono::steady_clock::time_point send_start_;
 
     bool skip_barrier_ = false;
 
@@ -338,7 +354,8 @@ struct IbvProxy {
     void process_recv();
     void process_send();
     bool wait_send_completion();
-    void stm();
+    // Returns whether the collective made progress
+    bool stm();
   };
 
   struct SharpContext {
@@ -410,7 +427,7 @@ struct IbvProxy {
     void init_buf(const M2PARBufInit& in, P2MARBufInit& out);
     void process_sharp_completions();
     void process_new_command();
-    void stm();
+    bool stm();
   };
 
   IbvProxy(const InitConfig* cfg);
@@ -439,7 +456,14 @@ struct IbvProxy {
   void exec_proxy_cmd(const M2PStateTransition& in, P2MNull& __unused);
 
   void stm_init();
-  void stm();
+  // Returns whether any collective made progress
+  bool stm();
+};
+
+// The proxies run by one proxy thread, see IbComm::init_proxy_threads()
+struct ProxyThreadConfig {
+  std::vector<IbvProxy::InitConfig*> proxy_cfgs_;
+  ProxyPollPolicy poll_policy_;
 };
 
 struct ProxyCommandVisitor : public boost::static_visitor<void> {
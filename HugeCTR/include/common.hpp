@@ -29,6 +29,7 @@
 #include <iomanip>
 #include <iostream>
 #include <numeric>
+#include <optional>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -86,7 +87,7 @@ struct NameID {
   unsigned int id;
 };
 
-enum class LrPolicy_t { fixed };
+enum class LrPolicy_t { fixed, cosine, step };
 
 enum class Optimizer_t {
   Ftrl,
@@ -96,6 +97,8 @@ enum class Optimizer_t {
   Nesterov,
   MomentumSGD,
   SGD,
+  RowWiseAdaGrad,
+  LazyAdam,
   DEFAULT,
   NOT_INITIALIZED
 };
@@ -111,6 +114,12 @@ enum class Regularizer_t { L1, L2, None };
 
 enum class Alignment_t { Auto, None };
 
+enum class IOBackend_t { AIO, IOUring, IOUringSQPoll, GDS };
+
+enum class DataCache_t { Off, Device, Host };
+
+enum class DataTransform_t { Log1p, Bucketize, Modulo };
+
 enum class GroupLayer_t { GroupFusedInnerProduct };
 
 enum class Layer_t {
@@ -151,6 +160,8 @@ enum class Layer_t {
   Cast,
   ElementwiseMultiply,
   SequenceMask,
+  AUGRU,
+  GroupedMLP,
   Unknown
 };
 
@@ -187,6 +198,68 @@ struct TrainState {
   cudaEvent_t* event = nullptr;
 };
 
+/**
+ * A transform the multi-hot RawAsync reader applies on the GPU while it splits a batch.
+ * Log1p: the dense feature index becomes log(1 + x).
+ * Bucketize: the dense feature index becomes the number of boundaries <= x, boundaries sorted.
+ * Modulo: the keys of slot index become key mod modulo, in [0, modulo).
+ */
+struct DataTransformParam {
+  DataTransform_t type;
+  int index;
+  long long modulo;
+  std::vector<float> boundaries;
+
+  DataTransformParam(DataTransform_t type, int index, long long modulo = 0,
+                     const std::vector<float>& boundaries = std::vector<float>())
+      : type(type), index(index), modulo(modulo), boundaries(boundaries) {}
+};
+
+/**
+ * Makes the multi-hot RawAsync reader generate every batch on the GPU instead of reading the
+ * files, to benchmark the model without the I/O. The hotness of the slots is nnz_per_slot.
+ * The keys of a slot are drawn from a pool of unique_key_ratio x batch_size x hotness keys of its
+ * vocabulary, uniformly or with the power law of power_law_type (alpha for Specific), so that the
+ * hot keys are the same in every batch.
+ */
+struct SyntheticDataParam {
+  Distribution_t distribution;
+  PowerLaw_t power_law_type;
+  float alpha;
+  float unique_key_ratio;
+  std::vector<long long> slot_size_array;  // empty: the slot_size_array of the DataReaderParams
+  unsigned long long seed;
+
+  SyntheticDataParam(Distribution_t distribution = Distribution_t::PowerLaw,
+                     PowerLaw_t power_law_type = PowerLaw_t::Specific, float alpha = 1.2f,
+                     float unique_key_ratio = 0.1f,
+                     const std::vector<long long>& slot_size_array = std::vector<long long>(),
+                     unsigned long long seed = 0)
+      : distribution(distribution),
+        power_law_type(power_law_type),
+        alpha(alpha),
+        unique_key_ratio(unique_key_ratio),
+        slot_size_array(slot_size_array),
+        seed(seed) {}
+
+  // The exponent of the power law, 0 for the uniform distribution
+  float get_alpha() const {
+    if (distribution == Distribution_t::Uniform) {
+      return 0.f;
+    }
+    switch (power_law_type) {
+      case PowerLaw_t::Long:
+        return 0.9f;
+      case PowerLaw_t::Medium:
+        return 1.1f;
+      case PowerLaw_t::Short:
+        return 1.3f;
+      default:
+        return alpha;
+    }
+  }
+};
+
 struct AsyncParam {
   int num_threads;
   int num_batches_per_thread;
@@ -197,10 +270,27 @@ struct AsyncParam {
   Alignment_t aligned_type;
   bool multi_hot_reader;
   bool is_dense_float;
+  IOBackend_t io_backend;
+  int shuffle_block_size;
+  bool variable_length;
+  DataCache_t train_data_cache;
+  bool compressed;
+  std::vector<DataTransformParam> transforms;
+  std::optional<SyntheticDataParam> synthetic;
+  std::string key_profile_file;
+  bool striped_upload;
+  bool int64_file_keys;
 
   AsyncParam(int num_threads, int num_batches_per_thread, int max_num_requests_per_thread,
              int io_depth, int io_alignment, bool shuffle, Alignment_t aligned_type,
-             bool multi_hot_reader, bool is_dense_float)
+             bool multi_hot_reader, bool is_dense_float,
+             IOBackend_t io_backend = IOBackend_t::AIO, int shuffle_block_size = 0,
+             bool variable_length = false, DataCache_t train_data_cache = DataCache_t::Off,
+             bool compressed = false,
+             const std::vector<DataTransformParam>& transforms = std::vector<DataTransformParam>(),
+             const std::optional<SyntheticDataParam>& synthetic = std::nullopt,
+             const std::string& key_profile_file = std::string(), bool striped_upload = false,
+             bool int64_file_keys = false)
       : num_threads(num_threads),
         num_batches_per_thread(num_batches_per_thread),
         max_num_requests_per_thread(max_num_requests_per_thread),
@@ -209,7 +299,17 @@ struct AsyncParam {
         shuffle(shuffle),
         aligned_type(aligned_type),
         multi_hot_reader(multi_hot_reader),
-        is_dense_float(is_dense_float) {}
+        is_dense_float(is_dense_float),
+        io_backend(io_backend),
+        shuffle_block_size(shuffle_block_size),
+        variable_length(variable_length),
+        train_data_cache(train_data_cache),
+        compressed(compressed),
+        transforms(transforms),
+        synthetic(synthetic),
+        key_profile_file(key_profile_file),
+        striped_upload(striped_upload),
+        int64_file_keys(int64_file_keys) {}
 };
 
 struct HybridEmbeddingParam {
@@ -221,6 +321,7 @@ struct HybridEmbeddingParam {
   double efficiency_bandwidth_ratio;
   hybrid_embedding::CommunicationType communication_type;
   hybrid_embedding::HybridEmbeddingType hybrid_embedding_type;
+  size_t recalibration_interval = 0;  // in training iterations, 0 keeps the initial model
 };
 
 typedef struct DataSetHeader_ {
@@ -17,6 +17,7 @@
 
 #include <core23/tensor_container.hpp>
 #include <cpu_resource.hpp>
+#include <functional>
 #include <gpu_learning_rate_scheduler.hpp>
 #include <gpu_resource.hpp>
 #include <layer.hpp>
@@ -26,6 +27,7 @@
 #include <metrics.hpp>
 #include <optimizer.hpp>
 #include <optional>
+#include <step_profiler.hpp>
 #include <string>
 #include <vector>
 
@@ -115,6 +117,11 @@ class Network final {
    */
   void download_params_to_host(float* weight);
 
+  /**
+   * Writing opt states to cpu buffer.
+   */
+  void download_opt_states_to_host(char* h_opt_states);
+
   /**
    * Read parameters from cpu buffer.
    */
@@ -164,7 +171,8 @@ class Network final {
   void search_algorithm();
 
   /**
-   * copy weights from train layers to evaluate layers
+   * copy weights from train layers to evaluate layers, unless the evaluate layers already share
+   * the weights of the train layers
    */
   void copy_weights_from_train_layers_to_evaluate_layers();
 
@@ -184,7 +192,30 @@ class Network final {
                            const std::map<std::string, float>& label_weights);
   void set_raw_metrics(metrics::Core23MultiLossMetricMap&& raw_metrics);
   void set_optimizer(std::unique_ptr<Optimizer> optimizer);
-  void create_and_set_optimizer(const OptParams& opt_params);
+  /**
+   * @param shard if set, the optimizer only keeps the states of and updates this shard of the
+   * flattened weights
+   */
+  void create_and_set_optimizer(const OptParams& opt_params,
+                                std::optional<WeightShard> shard = std::nullopt);
+
+  /**
+   * Calls hook right after the bprop of layer, e.g. to start the allreduce of the wgrads it
+   * completes.
+   */
+  void set_bprop_hook(const Layer* layer, std::function<void()> hook);
+
+  /**
+   * Calls hook right after the optimizer updated the weights, e.g. to all-gather the shards of a
+   * sharded optimizer.
+   */
+  void set_update_hook(std::function<void()> hook);
+
+  /**
+   * Times the fprop and bprop of every layer, the hooks and the optimizer update of the training
+   * with profiler while it is active. nullptr stops it.
+   */
+  void set_profiler(StepProfiler* profiler);
 
  private:
   friend class Model;
@@ -192,16 +223,21 @@ class Network final {
   void conv_weight_(std::optional<core23::TensorContainer<__half, 1, 1>>& target_opt,
                     const std::optional<core23::TensorContainer<float, 1, 1>>& source_opt);
   void prop_layers(const std::vector<Layer*>& layers, bool fprop, bool train);
+  void profile(const std::string& name, StepProfiler::Kind kind, const std::function<void()>& work,
+               double flops = 0.0, double bytes = 0.0);
 
   void set_losses_common(const std::map<std::string, std::unique_ptr<ILoss>>& losses,
                          const std::map<std::string, float>& label_weights,
-                         std::map<std::string, core23::Tensor>& loss_tensors);
+                         std::map<std::string, core23::Tensor>& loss_tensors,
+                         std::unique_ptr<IFusedLoss>& fused_loss);
 
   std::vector<std::unique_ptr<Layer>> train_layers_;    /**< vector of layers */
   std::vector<std::unique_ptr<Layer>> evaluate_layers_; /**< vector of layers */
 
   std::map<std::string, std::unique_ptr<ILoss>> train_losses_;    /**< map of loss layers */
   std::map<std::string, std::unique_ptr<ILoss>> evaluate_losses_; /**< map of loss layers */
+  std::unique_ptr<IFusedLoss> train_fused_loss_;    /**< fused train losses, if any */
+  std::unique_ptr<IFusedLoss> evaluate_fused_loss_; /**< fused evaluate losses, if any */
 
   std::map<std::string, int> label_dims_; /** < map of dimensions of labels */
 
@@ -228,6 +264,12 @@ class Network final {
   bool use_mixed_precision_;
 
   std::shared_ptr<GpuLearningRateScheduler> lr_sched_;
+
+  std::map<const Layer*, std::function<void()>> bprop_hooks_;
+  std::function<void()> update_hook_;
+
+  StepProfiler* profiler_ = nullptr;
+  std::map<const Layer*, std::string> layer_names_;  // For the profiler
 };
 
 }  // namespace HugeCTR
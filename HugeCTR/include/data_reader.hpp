@@ -57,7 +57,8 @@ class IDataReader {
   virtual void create_drwg_norm(std::string file_list, Check_t check_type,
                                 bool start_reading_from_beginning = true) = 0;
   virtual void create_drwg_raw(std::string file_name, long long num_samples, bool float_label_dense,
-                               bool data_shuffle, bool start_reading_from_beginning = true) = 0;
+                               bool data_shuffle, bool start_reading_from_beginning = true,
+                               bool parse_on_device = false) = 0;
 
 #ifndef DISABLE_CUDF
   virtual void create_drwg_parquet(
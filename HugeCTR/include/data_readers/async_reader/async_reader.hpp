@@ -30,7 +30,8 @@ class AsyncReaderImpl {
   AsyncReaderImpl(std::string fname, size_t batch_size_bytes,
                   const ResourceManager* resource_manager, int num_threads,
                   int num_batches_per_thread, size_t io_block_size, int io_depth, int io_alignment,
-                  bool shuffle = false, bool wait_for_gpu_idle = false);
+                  bool shuffle = false, bool wait_for_gpu_idle = false,
+                  bool striped_upload = false);
 
   bool is_currently_loading();
   size_t get_num_buffers() const;
@@ -56,9 +57,9 @@ class AsyncReaderImpl {
   InternalBatchBuffer* last_buffer_ = nullptr;
   size_t total_file_size_;
   bool wait_for_gpu_idle_;
+  bool striped_upload_;
   int queue_id_;
   bool loop_ = true;
-  cudaEvent_t event_success_;
 
   std::vector<size_t> batch_ids_;
   std::vector<std::unique_ptr<InternalBatchBuffer>> buffers_;
@@ -39,7 +39,7 @@ class AsyncReader : public SchedulableDataReader {
               const std::shared_ptr<ResourceManager>& resource_manager, int num_threads,
               int num_batches_per_thread, size_t io_block_size, int io_depth, int io_alignment,
               bool shuffle = false, bool wait_for_gpu_idle = false,
-              Alignment_t aligned = Alignment_t::None);
+              Alignment_t aligned = Alignment_t::None, bool striped_upload = false);
 
   long long read_a_batch_to_device_delay_release() override;
   long long get_full_batchsize() const override;
@@ -101,7 +101,8 @@ class AsyncReader : public SchedulableDataReader {
   void create_drwg_norm(std::string file_list, Check_t check_type,
                         bool start_reading_from_beginning = true) override;
   void create_drwg_raw(std::string file_name, long long num_samples, bool float_label_dense,
-                       bool data_shuffle, bool start_reading_from_beginning = true) override;
+                       bool data_shuffle, bool start_reading_from_beginning = true,
+                       bool parse_on_device = false) override;
 #ifndef DISABLE_CUDF
   void create_drwg_parquet(std::string file_list, bool strict_order_of_batches,
                            const std::vector<long long> slot_offset,
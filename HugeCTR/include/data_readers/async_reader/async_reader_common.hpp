@@ -16,10 +16,14 @@
 #pragma once
 
 #include <cuda_runtime.h>
+#include <unistd.h>
 
 // For the tensor bags
 #include <atomic>
+#include <condition_variable>
 #include <core23/tensor.hpp>
+#include <cstdint>
+#include <mutex>
 #include <tensor2.hpp>
 #include <vector>
 
@@ -47,13 +51,22 @@ struct InternalBatchBuffer {
   char* host_data;
 
   std::atomic<BufferStatus> status;
+  // The consumer sleeps on status_cv until the buffer is ready or finished
+  std::mutex status_mutex;
+  std::condition_variable status_cv;
+  // Eventfd of the reader thread that fills the buffer, it sleeps on it while it cannot progress
+  int reader_eventfd = -1;
+  // The consumer is blocked on this buffer, so the GPU does not need to be idle to upload it
+  std::atomic<bool> consumer_waiting{false};
   std::vector<iocb*> io_reqs;
   int num_outstanding_reqs;
   std::atomic<cudaEvent_t*> ready_to_upload_event, safe_to_upload_event;
   int num_submitted_h2d_chunks;
   int num_submitted_broadcasts;
   bool preload_done;
+  bool upload_pending = false;  // Submitted, and not counted by the reader thread yet
   cudaEvent_t event;
+  std::vector<cudaEvent_t> stripe_events;  // per GPU, only for the striped upload
 
   // Following the rule of 5 just in case
   // Only need the destructor here
@@ -64,7 +77,42 @@ struct InternalBatchBuffer {
   InternalBatchBuffer(InternalBatchBuffer&& other) = default;
   InternalBatchBuffer& operator=(InternalBatchBuffer&& other) = default;
 
+  // Sets a status the consumer may be waiting for
+  void publish_status(BufferStatus new_status) {
+    {
+      std::lock_guard<std::mutex> lock(status_mutex);
+      status.store(new_status);
+    }
+    status_cv.notify_all();
+  }
+  bool publish_status(BufferStatus expected, BufferStatus new_status) {
+    {
+      std::lock_guard<std::mutex> lock(status_mutex);
+      if (!status.compare_exchange_strong(expected, new_status)) {
+        return false;
+      }
+    }
+    status_cv.notify_all();
+    return true;
+  }
+  template <typename Pred>
+  BufferStatus wait_status(Pred pred) {
+    std::unique_lock<std::mutex> lock(status_mutex);
+    status_cv.wait(lock, [&] { return pred(status.load()); });
+    return status.load();
+  }
+  // Wakes up the reader thread, once the buffer is given back or the GPU may be used
+  void ring_reader() const {
+    const uint64_t one = 1;
+    if (reader_eventfd >= 0) {
+      [[maybe_unused]] ssize_t ret = write(reader_eventfd, &one, sizeof(one));
+    }
+  }
+
   ~InternalBatchBuffer() {
+    for (auto stripe_event : stripe_events) {
+      HCTR_LIB_CHECK_(cudaEventDestroy(stripe_event));
+    }
     for (auto ptr : dev_data) {
       HCTR_LIB_CHECK_(cudaFree(ptr));
     }
@@ -34,6 +34,7 @@ struct ThreadAsyncReaderParameters {
   int num_h2d_chunks;
   bool wait_for_gpu_idle;
   bool loop;
+  bool striped_upload;  // chunk i is uploaded to GPU i, then copied to the other GPUs
 };
 
 class ThreadAsyncReader {
@@ -41,7 +42,8 @@ class ThreadAsyncReader {
   ThreadAsyncReader(std::string fname, const ResourceManager* resource_manager,
                     size_t batch_size_bytes, int device_id, cudaStream_t stream,
                     std::vector<size_t> batch_ids, std::vector<InternalBatchBuffer*> dest_buffers,
-                    ThreadAsyncReaderParameters params, size_t total_file_size);
+                    ThreadAsyncReaderParameters params, size_t total_file_size,
+                    std::vector<cudaStream_t> device_streams);
 
   void load();
   void reset();
@@ -53,23 +55,28 @@ class ThreadAsyncReader {
   size_t batch_size_bytes_;
   int device_id_;
   cudaStream_t stream_;
+  std::vector<cudaStream_t> device_streams_;  // of all the local GPUs
   int num_dest_buffers_;
   int max_num_blocks_per_batch_;
   size_t total_file_size_;
   io_context_t ioctx_;
   std::atomic<WorkerStatus> status_;
+  // Rung by the completed reads, the uploads done, the consumer and reset()
+  int doorbell_;
 
   std::vector<size_t> batch_ids_;
   std::vector<InternalBatchBuffer*> dest_buffers_;
   ThreadAsyncReaderParameters params_;
   int num_buffers_waiting_io_;
 
-  void try_submit_io(size_t batch_id, int io_id);
-  void wait_io();
-  bool wait_for_gpu_idle(InternalBatchBuffer* buffer);
-  void try_submit_upload(InternalBatchBuffer* buffer);
-  void try_submit_p2p(InternalBatchBuffer* buffer);
+  // The try_ and reap_ steps return whether they did anything, the thread sleeps once none does
+  bool try_submit_io(size_t batch_id, int io_id);
+  bool reap_io();
+  bool wait_for_gpu_idle(InternalBatchBuffer* buffer, cudaStream_t stream);
+  bool try_submit_upload(InternalBatchBuffer* buffer);
+  bool try_submit_p2p(InternalBatchBuffer* buffer);
   bool check_completion(InternalBatchBuffer* buffer);
+  void wait_doorbell();
 };
 
 }  // namespace HugeCTR
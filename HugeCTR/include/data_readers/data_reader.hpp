@@ -112,8 +112,8 @@ class DataReader : public IDataReader {
                         bool start_reading_from_beginning = true) override;
 
   void create_drwg_raw(std::string file_name, long long num_samples, bool float_label_dense,
-                       bool data_shuffle = false,
-                       bool start_reading_from_beginning = true) override;
+                       bool data_shuffle = false, bool start_reading_from_beginning = true,
+                       bool parse_on_device = false) override;
 #ifndef DISABLE_CUDF
 
   void create_drwg_parquet(std::string file_list, bool strict_order_of_batches,
@@ -59,7 +59,8 @@ static void consumer_thread_func_(const std::shared_ptr<IDataReaderWorker>& data
                                   const std::shared_ptr<std::atomic<bool>>& p_loop_flag,
                                   int device_id, volatile bool* end_flag = nullptr) {
   try {
-    CudaDeviceContext context(device_id);
+    // reads and decodes into the pinned buffers of the worker, keep it on the GPU's numa node
+    CudaCPUDeviceContext context(device_id);
     while (!p_loop_flag->load() && !*end_flag) {
       usleep(2);
     }
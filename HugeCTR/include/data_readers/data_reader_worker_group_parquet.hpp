@@ -26,8 +26,7 @@ class DataReaderWorkerGroupParquet : public DataReaderWorkerGroup {
   std::shared_ptr<Source> create_source(size_t worker_id, size_t num_worker,
                                         const std::string& file_name, bool repeat,
                                         const DataSourceParams& data_source_params) override {
-    return std::make_shared<ParquetFileSource>(
-        worker_id, num_worker, file_name, strict_order_of_batches_, repeat, data_source_params);
+    return std::make_shared<ParquetFileSource>(worker_id, file_name, repeat, data_source_params);
   }
 
  public:
@@ -50,7 +50,8 @@ class DataReaderWorkerGroupRaw : public DataReaderWorkerGroup {
                            std::string file_name, long long num_samples, bool repeat,
                            const std::vector<DataReaderSparseParam> params, int label_dim,
                            int dense_dim, int batchsize, bool float_label_dense,
-                           bool data_shuffle = false, bool start_reading_from_beginning = true)
+                           bool data_shuffle = false, bool start_reading_from_beginning = true,
+                           bool parse_on_device = false)
       : DataReaderWorkerGroup(start_reading_from_beginning, DataReaderType_t::Raw, false, nullptr,
                               output_buffers.size()),
         num_samples_(num_samples),
@@ -80,7 +81,7 @@ class DataReaderWorkerGroupRaw : public DataReaderWorkerGroup {
       std::shared_ptr<IDataReaderWorker> data_reader(new DataReaderWorkerRaw<TypeKey>(
           i, num_workers, resource_manager_->get_local_gpu(i % local_gpu_count),
           data_reader_loop_flag_, output_buffers[i], file_offset_list_, repeat, params,
-          float_label_dense));
+          float_label_dense, parse_on_device));
       data_readers_.push_back(data_reader);
     }
     create_data_reader_threads();
@@ -29,16 +29,31 @@
 
 namespace HugeCTR {
 
+/**
+ * Splits a batch of Raw samples on the device, like \p DataReaderWorkerRaw does on the host: the
+ * label and dense features of the samples in [batch_size_start_idx, batch_size_end_idx) go to
+ * \p label_dense , the keys of all the samples to the CSR of every sparse input. The samples past
+ * \p current_batch_size get zero label and dense features and empty rows.
+ */
+template <typename T>
+void parse_raw_batch(const core23::Tensor& samples, long long current_batch_size, int batch_size,
+                     int label_dim, int dense_dim, bool float_label_dense,
+                     int batch_size_start_idx, int batch_size_end_idx,
+                     const std::vector<DataReaderSparseParam>& params, core23::Tensor& label_dense,
+                     std::vector<SparseTensor23>& sparse_tensors, cudaStream_t stream);
+
 template <class T>
 class DataReaderWorkerRaw : public IDataReaderWorker {
  private:
   std::vector<DataReaderSparseParam> params_; /**< configuration of data reader sparse input */
   bool float_label_dense_;
+  bool parse_on_device_;
   size_t total_slot_num_;
   std::vector<size_t> last_batch_nnz_;
 
   core23::Tensor host_dense_buffer_;
   std::vector<CSR23<T>> host_sparse_buffer_;
+  core23::Tensor device_sample_buffer_;  // the samples of a batch, for parse_on_device_
 
   void read_new_file() {
     Error_t flag = source_->next_source(1);
@@ -61,7 +76,8 @@ class DataReaderWorkerRaw : public IDataReaderWorker {
                       const std::shared_ptr<std::atomic<bool>>& loop_flag,
                       const std::shared_ptr<ThreadBuffer23>& buffer,
                       std::shared_ptr<MmapOffsetList>& file_offset_list, bool repeat,
-                      const std::vector<DataReaderSparseParam>& params, bool float_label_dense);
+                      const std::vector<DataReaderSparseParam>& params, bool float_label_dense,
+                      bool parse_on_device = false);
 
   void do_h2d(){};
   /**
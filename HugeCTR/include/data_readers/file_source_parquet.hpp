@@ -24,6 +24,7 @@
 #include <data_readers/metadata.hpp>
 #include <data_readers/source.hpp>
 #include <fstream>
+#include <future>
 #include <io/file_loader.hpp>
 #include <utils.hpp>
 #include <vector>
@@ -35,9 +36,7 @@ namespace cudf_io = cudf::io;
 class ParquetFileSource : public Source {
  private:
   FileList file_list_; /**< file list of data set */
-  const long long offset_;
   const unsigned int worker_id_;
-  const long long stride_;  // num_workers
   unsigned int counter_{0};
   long long curr_row_idx_;                  // current row offset within current file
   long long row_group_offset_;              // first row offset of current group
@@ -54,9 +53,13 @@ class ParquetFileSource : public Source {
   int row_group_size_;                      // size of current row_group
   cudaStream_t slice_stream_;               /**< worker stream for slicing row_group */
   std::unique_ptr<FileLoader> file_loader_; /**< loader to load data from file system to memory */
+  std::unique_ptr<cudf_io::datasource> datasource_; /**< range reads of the current file */
+  std::vector<std::string> columns_;                /**< projection, empty to read all columns */
+  std::future<cudf_io::table_with_metadata> prefetched_table_;
+  int prefetched_row_group_ = -1;
 
   const bool repeat_;
-  const bool sequential_file_consumption_;
+  const long long prefetch_depth_;  // files of this worker prefetched ahead of the current one
   /**
    * Private Helper function to get metadata file address
    */
@@ -81,13 +84,16 @@ class ParquetFileSource : public Source {
     return file_name;
   }
   Error_t find_next_file_and_group(long long expected_num_row_group) noexcept;
+  cudf_io::table_with_metadata read_table(int row_group_id, rmm::mr::device_memory_resource* mr);
+  void drop_prefetch();
 
  public:
   /**
-   * Ctor
+   * Ctor. Every worker walks all the files of the list in order, and is handed a share of their
+   * row groups by next_source(), so that the workers are balanced whatever the number and the
+   * sizes of the files.
    */
-  ParquetFileSource(unsigned int worker_id, unsigned int stride, const std::string& file_list,
-                    bool sequtial_file_consumption, bool repeat,
+  ParquetFileSource(unsigned int worker_id, const std::string& file_list, bool repeat,
                     const DataSourceParams& data_source_params);
 
   ~ParquetFileSource();
@@ -107,6 +113,15 @@ class ParquetFileSource : public Source {
   Error_t next_source(long long expected_num_row_group) noexcept;
   bool is_open() noexcept;
   cudf_io::table_with_metadata read_group(size_t row_group_id, rmm::mr::device_memory_resource* mr);
+  /**
+   * Starts decoding row group row_group_id of the current file in the background, the next
+   * read_group() of that row group returns it. Does nothing past the last row group.
+   */
+  void prefetch_group(size_t row_group_id, rmm::mr::device_memory_resource* mr);
+  /**
+   * Only decode the given columns. The columns of the tables are then in the order of names.
+   */
+  void set_column_projection(const std::vector<std::string>& names);
   /*
     jump to specific parquet file calculated through global_record_id;
     if dst == cur, dont need to load again
@@ -17,6 +17,8 @@
 
 #include <core23/tensor.hpp>
 #include <data_readers/multi_hot/detail/data_reader_impl.hpp>
+#include <data_readers/multi_hot/key_frequency_sketch.hpp>
+#include <data_readers/multi_hot/split_batch.hpp>
 #include <scheduleable.hpp>
 #include <sparse_tensor.hpp>
 #include <tensor2.hpp>
@@ -34,7 +36,14 @@ class AsyncDataReader : public SchedulableDataReader {
                   size_t num_threads_per_file, size_t num_batches_per_thread,
                   const std::vector<DataReaderSparseParam>& params, size_t label_dim,
                   size_t dense_dim, bool mixed_precision, bool shuffle,
-                  bool schedule_uploads = false, bool is_dense_float = false);
+                  bool schedule_uploads = false, bool is_dense_float = false,
+                  IOBackend_t io_backend = IOBackend_t::AIO, size_t shuffle_block_size = 0,
+                  bool variable_length = false, DataCache_t data_cache = DataCache_t::Off,
+                  bool compressed = false,
+                  const std::vector<DataTransformParam>& transforms = {},
+                  const std::optional<SyntheticDataParam>& synthetic = std::nullopt,
+                  const std::string& key_profile_file = std::string(),
+                  bool int64_file_keys = false);
 
   long long read_a_batch_to_device_delay_release() override;
   long long get_full_batchsize() const override;
@@ -84,6 +93,8 @@ class AsyncDataReader : public SchedulableDataReader {
 
   std::vector<std::vector<SparseTensor23>> get_current_sparse_tensor23s() const;
   std::vector<std::vector<core23::Tensor>>& get_current_sparse_values();
+  // [gpu][feature] CSR offsets of the keys in the value tensors. Empty if the hotness is fixed.
+  std::vector<std::vector<core23::Tensor>>& get_current_sparse_bucket_ranges();
   bool is_batch_cached() const { return current_batch_cached_; }
   size_t get_current_inflight_id() const { return inflight_id_; }  // TODO: remove?
 
@@ -94,7 +105,8 @@ class AsyncDataReader : public SchedulableDataReader {
   void create_drwg_norm(std::string file_list, Check_t check_type,
                         bool start_reading_from_beginning = true) override;
   void create_drwg_raw(std::string file_name, long long num_samples, bool float_label_dense,
-                       bool data_shuffle, bool start_reading_from_beginning = true) override;
+                       bool data_shuffle, bool start_reading_from_beginning = true,
+                       bool parse_on_device = false) override;
 #ifndef DISABLE_CUDF
   void create_drwg_parquet(std::string file_list, bool strict_order_of_batches,
                            const std::vector<long long> slot_offset,
@@ -114,6 +126,9 @@ class AsyncDataReader : public SchedulableDataReader {
     std::vector<core23::Tensor> sparse_tensor_ptrs;
     std::vector<std::vector<SparseTensor23>> sparse_tensors;
     std::vector<std::vector<core23::Tensor>> sparse_values;  // check out from sparse_tensors
+    // variable-length only, check out from the row offsets of sparse_tensors
+    std::vector<core23::Tensor> sparse_bucket_range_ptrs;
+    std::vector<std::vector<core23::Tensor>> sparse_bucket_ranges;
   };
 
   void assign_dense_and_label_tensors(core23::Tensor label_tensor, core23::Tensor dense_tensor,
@@ -121,6 +136,18 @@ class AsyncDataReader : public SchedulableDataReader {
 
   void init_batch_tensors(size_t num_inflight);
 
+  void init_transforms(const std::vector<DataTransformParam>& transforms);
+
+  void init_synthetic(const SyntheticDataParam& synthetic);
+
+  // Merges the key sketches of the GPUs into the profile written to key_profile_file_
+  void write_key_profile() const;
+
+  void init_data_cache();
+  void free_data_cache();
+  // Next batch of the epoch from the data cache, the order is reshuffled every epoch
+  size_t next_cached_batch();
+
   const std::shared_ptr<ResourceManager> resource_manager_;
   std::unique_ptr<DataReaderImpl> reader_impl_;
   size_t sample_size_items_, current_batch_size_;  // current global batch size
@@ -139,6 +166,7 @@ class AsyncDataReader : public SchedulableDataReader {
   std::vector<std::vector<SparseTensor23>> current_sparse_tensors_;  // [gpu][categorical_feature]
   std::vector<std::vector<core23::Tensor>>
       current_sparse_values_;  // the value tensor is checked out from current_sparse_tensors_
+  std::vector<std::vector<core23::Tensor>> current_sparse_bucket_ranges_;
 
   bool current_batch_cached_ = false;
 
@@ -156,7 +184,45 @@ class AsyncDataReader : public SchedulableDataReader {
   std::vector<core23::Tensor> bucket_position_tensors_;
   std::vector<core23::Tensor> max_hotness_tensors_;
   bool is_dense_float_;
+  bool int64_file_keys_;  // 64-bit keys in the files, narrowed to SparseType by the split
   std::vector<core23::Tensor> temp_tensors_;
+
+  bool variable_length_;
+  size_t samples_per_record_ = 0;
+  std::vector<core23::Tensor> record_scratch_tensors_;  // [gpu]
+
+  // Applied by the split kernels, empty without transforms
+  std::vector<SplitTransforms> split_transforms_;    // [gpu]
+  std::vector<core23::Tensor> transform_tensors_;   // the device tables of split_transforms_
+
+  // The batches of the first epoch are copied to the data cache, later epochs are served from it
+  // and the file readers are stopped.
+  DataCache_t data_cache_;
+  bool shuffle_;
+  bool serve_from_cache_ = false;
+  size_t num_cached_batches_ = 0;
+  size_t cache_pitch_bytes_ = 0;                                   // per batch and GPU
+  std::vector<uint8_t*> cache_data_;                               // [gpu]
+  // [gpu], the device copy of the current batch of a host cache
+  std::vector<uint8_t*> cache_staging_;
+  std::vector<size_t> cache_batch_sizes_;                          // [batch]
+  std::vector<std::vector<size_t>> cache_local_batch_sizes_;       // [gpu][batch]
+  std::vector<std::vector<size_t>> cache_local_batch_size_bytes_;  // [gpu][batch]
+  std::vector<size_t> cache_order_;
+  size_t cache_epoch_ = 0;
+  size_t cache_pos_ = 0;
+
+  // Without files every batch is generated on the GPU, see SyntheticDataParam
+  bool synthetic_ = false;
+  float synthetic_alpha_ = 0.f;
+  uint64_t synthetic_seed_ = 0;
+  size_t synthetic_step_ = 0;
+  std::vector<core23::Tensor> synthetic_batch_tensors_;  // [gpu], the raw samples
+  std::vector<core23::Tensor> synthetic_key_tensors_;    // [gpu], the slot_key_params
+
+  // Key frequencies of the batches read, written to key_profile_file_ on destruction
+  std::string key_profile_file_;
+  std::vector<std::unique_ptr<KeyFrequencySketch<SparseType>>> key_sketches_;  // [gpu]
 };
 
 }  // namespace MultiHot
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Chunk-compressed RawAsync format. The samples of a fixed-length RawAsync file are grouped into
+ * chunks of samples_per_chunk samples (the last chunk of the file can be shorter) that are LZ4
+ * compressed independently, so batches made of whole chunks can be read and decompressed without
+ * touching the rest of the file:
+ *
+ *   chunk   := header | payload | padding
+ *   header  CompressedChunkHeader
+ *   payload compressed_bytes bytes of LZ4 block format, the GPU decompresses it with nvCOMP
+ *
+ * The next chunk starts at a multiple of 8 bytes. The chunks are followed by the index, the
+ * uint64 file offsets of the chunks and of the end of the last one, and by CompressedFileFooter.
+ */
+constexpr uint64_t COMPRESSED_MAGIC = 0x4b4843345a4c4348ull;  // "HCLZ4CHK"
+
+struct CompressedChunkHeader {
+  uint64_t compressed_bytes;
+  uint64_t uncompressed_bytes;
+};
+
+struct CompressedFileFooter {
+  uint64_t magic;
+  uint64_t num_samples;
+  uint64_t num_chunks;
+  uint32_t samples_per_chunk;
+  uint32_t sample_size_bytes;
+};
+
+/**
+ * Reads the footer and the index (num_chunks + 1 offsets) of a chunk-compressed file.
+ */
+CompressedFileFooter read_compressed_footer(const std::string& file_name);
+std::vector<uint64_t> read_compressed_index(const std::string& file_name,
+                                            const CompressedFileFooter& footer);
+
+}  // namespace HugeCTR
@@ -15,10 +15,12 @@
  */
 #pragma once
 
+#include <common.hpp>
 #include <data_readers/multi_hot/detail/batch_locations.hpp>
 #include <data_readers/multi_hot/detail/io_context.hpp>
 #include <data_readers/multi_hot/detail/time_helper.hpp>
 #include <data_readers/multi_hot/detail/work_queue.hpp>
+#include <functional>
 #include <memory>
 #include <queue>
 
@@ -51,6 +53,8 @@ class BatchFileReader {
         : data(nullptr),
           shard_size_bytes(0),
           batch_size_bytes(0),
+          shard_num_samples(0),
+          batch_num_samples(0),
           slot_id(__slot),
           batch_id(0),
           batch_i(0),
@@ -60,8 +64,12 @@ class BatchFileReader {
     void release() { reader->release_batch(this); }
 
     uint8_t* data = nullptr;
+    // With block shuffle, the shard is read into several pieces of the buffer, data is the first.
+    std::vector<IOBuffer> pieces;
     size_t shard_size_bytes = 0;
     size_t batch_size_bytes = 0;
+    size_t shard_num_samples = 0;  // only set for variable-length samples
+    size_t batch_num_samples = 0;
     size_t slot_id = 0;
     size_t batch_id = 0;
     size_t batch_i = 0;
@@ -70,11 +78,17 @@ class BatchFileReader {
 
    private:
     uint8_t* aligned_data = nullptr;
+    size_t num_pending_ios = 0;
     BatchFileReader* reader;
   };
 
+  // Returns the device buffer batch_i is read into with IOBackend_t::GDS
+  using DeviceBufferFn = std::function<uint8_t*(size_t batch_i)>;
+
   BatchFileReader(const std::string& fname, size_t slot, size_t max_batches_inflight,
-                  std::unique_ptr<IBatchLocations> batch_locations);
+                  std::unique_ptr<IBatchLocations> batch_locations,
+                  IOBackend_t io_backend = IOBackend_t::AIO,
+                  DeviceBufferFn device_buffers = nullptr);
   BatchFileReader(const BatchFileReader& other) = delete;
   ~BatchFileReader();
 
@@ -82,6 +96,8 @@ class BatchFileReader {
   const std::vector<const Batch*>& read_batches(size_t timeout_us = 10);
   void release_batch(const Batch* batch);
   size_t get_queue_depth() const;
+  size_t get_alignment() const;
+  void register_buffers(const std::vector<IOBuffer>& buffers);
 
  private:
   void submit_reads();
@@ -102,8 +118,11 @@ class BatchFileReader {
   std::unique_ptr<IBatchLocations> batch_locations_;
   IBatchLocations::iterator batch_locations_iterator_;
   std::unique_ptr<IOContext> io_ctx_;
+  DeviceBufferFn device_buffers_;  // batches are read straight into device memory if set
 
   int fd_;
+  size_t max_segments_ = 1;  // per batch
+  size_t epoch_ = 0;
   size_t buf_size_ = 0;  // used for numa_free
   std::atomic<size_t> num_inflight_ = {0};
 };
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <data_readers/multi_hot/detail/batch_forward_iterator.hpp>
 #include <memory>
 #include <random>
@@ -28,12 +29,74 @@ T round_up(T x, T y) {
   return ((x + y - 1) / y) * y;
 }
 
+struct FileSegment {
+  size_t offset;
+  size_t size;
+};
+
 struct BatchDescriptor {
   size_t i;
   size_t id;
   size_t offset;
   size_t shard_size_bytes;
   size_t batch_size_bytes;
+  // Number of samples of the shard and of the batch if the samples are of variable size, 0 if
+  // they follow from the sizes in bytes
+  size_t shard_num_samples = 0;
+  size_t batch_num_samples = 0;
+  // With block shuffle, the file ranges that make up the shard, in batch order. Empty if the
+  // shard is the contiguous range at offset.
+  std::vector<FileSegment> segments;
+};
+
+/**
+ * @brief Bijection on [0, n) drawn from (seed, epoch), so that every reader computes the same
+ * block order without storing it. A 4-round Feistel network on the smallest even number of bits
+ * that covers n, values >= n are cycle-walked back into the range.
+ */
+class BlockPermutation {
+ public:
+  BlockPermutation(size_t n = 0, unsigned long long seed = 0) : n_(n), seed_(seed) {
+    size_t bits = 2;
+    while ((1ull << bits) < n) {
+      bits += 2;
+    }
+    half_bits_ = bits / 2;
+    mask_ = (1ull << half_bits_) - 1;
+  }
+
+  size_t size() const { return n_; }
+
+  size_t operator()(size_t x, size_t epoch) const {
+    do {
+      x = feistel(x, epoch);
+    } while (x >= n_);
+    return x;
+  }
+
+ private:
+  static uint64_t mix(uint64_t x) {  // splitmix64 finalizer
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+  }
+
+  uint64_t feistel(uint64_t x, size_t epoch) const {
+    uint64_t left = x >> half_bits_;
+    uint64_t right = x & mask_;
+    for (uint64_t round = 0; round < 4; ++round) {
+      uint64_t key = mix(seed_ ^ mix(epoch * 4 + round));
+      uint64_t tmp = left ^ (mix(right ^ key) & mask_);
+      left = right;
+      right = tmp;
+    }
+    return (left << half_bits_) | right;
+  }
+
+  size_t n_;
+  unsigned long long seed_;
+  size_t half_bits_;
+  uint64_t mask_;
 };
 
 /**
@@ -52,6 +115,10 @@ class IBatchLocations {
   virtual std::vector<std::unique_ptr<IBatchLocations>> distribute(size_t n) const = 0;
   virtual std::vector<std::unique_ptr<IBatchLocations>> shard(
       size_t n, size_t min_batch_size_bytes) const = 0;
+  // Upper bound of BatchDescriptor::segments, 1 for contiguous shards
+  virtual size_t get_max_segments() const = 0;
+  // Batches returned after this call belong to the given epoch
+  virtual void set_epoch(size_t epoch) = 0;
 
  private:
   virtual BatchDescriptor at(size_t i) = 0;
@@ -59,22 +126,32 @@ class IBatchLocations {
 
 /**
  * @brief Provides the batch locations at computable offsets because batches are equal sizes
+ *
+ * With a non-zero shuffle_block_size_bytes, the file is split into blocks of that size (a
+ * multiple of the sample size) and the batches are cut from the blocks in an order that is
+ * permuted every epoch. Every shard is then read as a few large segments, which keeps the reads
+ * sequential enough for the disks while mixing samples from all over the file.
  */
 class BatchLocations : public IBatchLocations {
  public:
   BatchLocations(size_t batch_size_bytes, size_t start_offset, size_t end_offset,
-                 bool shuffle = false, unsigned long long seed = 0)
+                 bool shuffle = false, unsigned long long seed = 0,
+                 size_t shuffle_block_size_bytes = 0)
       : shard_size_bytes_(batch_size_bytes),
         batch_size_bytes_(batch_size_bytes),
         start_offset_(start_offset),
         end_offset_(end_offset),
         shard_id_(0),
         ids_(((end_offset - start_offset) + batch_size_bytes - 1) / batch_size_bytes),
-        order_(ids_.size()) {
+        order_(ids_.size()),
+        block_size_bytes_(shuffle_block_size_bytes) {
     std::iota(ids_.begin(), ids_.end(), 0);
     std::iota(order_.begin(), order_.end(), 0);
 
-    if (shuffle) {
+    if (block_size_bytes_ > 0) {
+      // A partial last block stays at the end of the file
+      permutation_ = BlockPermutation((end_offset - start_offset) / block_size_bytes_, seed);
+    } else if (shuffle) {
       std::mt19937 gen(seed);
       std::shuffle(ids_.begin(), ids_.end(), gen);
     }
@@ -121,6 +198,16 @@ class BatchLocations : public IBatchLocations {
 
   size_t count() { return this->end() - this->begin(); }
 
+  size_t get_max_segments() const {
+    if (block_size_bytes_ == 0) {
+      return 1;
+    }
+    // a shard can start and end inside a block
+    return (shard_size_bytes_ + block_size_bytes_ - 1) / block_size_bytes_ + 1;
+  }
+
+  void set_epoch(size_t epoch) { epoch_ = epoch; }
+
  private:
   BatchDescriptor at(size_t i) {
     size_t batch_id = ids_[i % ids_.size()];
@@ -138,6 +225,29 @@ class BatchLocations : public IBatchLocations {
 
     size_t global_offset = start_offset_ + batch_id * batch_size_bytes_;
     desc.batch_size_bytes = std::min(end_offset_, batch_end) - global_offset;
+
+    if (block_size_bytes_ > 0 && desc.shard_size_bytes > 0) {
+      // Map the shard of the permuted block stream back to the file
+      const size_t epoch = epoch_ + i / ids_.size();
+      size_t begin = desc.offset - start_offset_;
+      const size_t end = begin + desc.shard_size_bytes;
+      while (begin < end) {
+        size_t block = begin / block_size_bytes_;
+        size_t block_end = std::min((block + 1) * block_size_bytes_, end);
+        size_t physical_block = block < permutation_.size() ? permutation_(block, epoch) : block;
+        size_t offset = start_offset_ + physical_block * block_size_bytes_ +
+                        (begin - block * block_size_bytes_);
+        size_t size = block_end - begin;
+        if (!desc.segments.empty() &&
+            desc.segments.back().offset + desc.segments.back().size == offset) {
+          desc.segments.back().size += size;
+        } else {
+          desc.segments.push_back({offset, size});
+        }
+        begin = block_end;
+      }
+      desc.offset = desc.segments.front().offset;
+    }
     return desc;
   }
 
@@ -148,6 +258,9 @@ class BatchLocations : public IBatchLocations {
   size_t shard_id_;
   std::vector<size_t> ids_;    // for shuffle
   std::vector<size_t> order_;  // global iteration order
+  size_t block_size_bytes_;    // 0 if the samples of a batch are contiguous
+  BlockPermutation permutation_;
+  size_t epoch_ = 0;
 };
 
 }  // namespace HugeCTR
\ No newline at end of file
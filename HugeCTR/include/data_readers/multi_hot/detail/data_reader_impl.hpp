@@ -19,6 +19,9 @@
 #include <data_readers/multi_hot/detail/atomic_wrapper.hpp>
 #include <data_readers/multi_hot/detail/batch_file_reader.hpp>
 #include <data_readers/multi_hot/detail/device_transfer.hpp>
+#ifdef ENABLE_NVCOMP
+#include <data_readers/multi_hot/detail/lz4_decompressor.hpp>
+#endif
 #include <data_readers/multi_hot/detail/system_latch.hpp>
 #include <future>
 #include <memory>
@@ -37,6 +40,8 @@ struct FileSource {
   std::string name;
   size_t sample_size_bytes;
   size_t slot_id;
+  bool variable_length = false;  // the variable-length format, sample_size_bytes is unused
+  bool compressed = false;       // chunk-compressed, sample_size_bytes is the uncompressed size
 };
 
 enum BatchState {
@@ -78,25 +83,50 @@ class DataReaderImpl {
 
     size_t get_id() const { return id; }
 
+    // Decompressed sizes for chunk-compressed files
     size_t get_local_batch_size_bytes(size_t device_id, size_t slot) const {
       assert(device_id < local_batches.size());
       assert(slot < local_batches[device_id].io_batches.size());
-      return local_batches[device_id].io_batches[slot]->shard_size_bytes;
+      const auto io_batch = local_batches[device_id].io_batches[slot];
+      return compressed_sample_size_bytes[slot] > 0
+                 ? io_batch->shard_num_samples * compressed_sample_size_bytes[slot]
+                 : io_batch->shard_size_bytes;
     }
 
-    size_t get_batch_size_bytes() const { return local_batches[0].io_batches[0]->batch_size_bytes; }
+    size_t get_batch_size_bytes() const {
+      const auto io_batch = local_batches[0].io_batches[0];
+      return compressed_sample_size_bytes[0] > 0
+                 ? io_batch->batch_num_samples * compressed_sample_size_bytes[0]
+                 : io_batch->batch_size_bytes;
+    }
+
+    // Only for variable-length files
+    size_t get_local_num_samples(size_t device_id, size_t slot) const {
+      assert(device_id < local_batches.size());
+      assert(slot < local_batches[device_id].io_batches.size());
+      return local_batches[device_id].io_batches[slot]->shard_num_samples;
+    }
+
+    size_t get_num_samples() const { return local_batches[0].io_batches[0]->batch_num_samples; }
 
    private:
     struct LocalBatch {
       std::vector<const BatchFileReader::Batch*> io_batches;  // [slot]
       // For DP, device_data.size() == 1, for MP, device_data.size() == num_features
       std::vector<uint8_t*> device_data;
+      // For chunk-compressed slots, the buffers the chunks are uploaded to and decompressed
+      // from into device_data
+      std::vector<uint8_t*> compressed_data;
+      // With GDS, the buffers the files are read into. device_data points into them, past the
+      // misalignment of the file offset of the current batch.
+      std::vector<uint8_t*> device_buffers;
       std::vector<DeviceTransfer*> device_transfers;  // max slots in length
       AtomicWrapper<size_t> num_transfers;
     };
 
     std::atomic<BatchState> state;
     std::vector<LocalBatch> local_batches;
+    std::vector<size_t> compressed_sample_size_bytes;  // [slot], 0 if not compressed
     size_t id;
     size_t total_ios;
     std::atomic<size_t> num_completed_io;
@@ -112,6 +142,8 @@ class DataReaderImpl {
    * @param batch_size Number of samples per batch
    * @param num_threads_per_file Number of threads per file reader
    * @param num_batches_per_thread Number of in-flight batches per thread reader
+   * @param shuffle_block_size If shuffle, the number of samples per block of the block shuffle,
+   *                           0 to only shuffle the order of the batches
    * @param gpus_slot_ownership_matrix Matrix indicating what GPUs own which slots. E.g:
    *                                Node 0: GPU | 0 1 2 3       Node 1: GPU | 0 1 2 3
    *                                        -------------               -------------
@@ -128,11 +160,15 @@ class DataReaderImpl {
   DataReaderImpl(const std::vector<FileSource>& source_files,
                  const std::shared_ptr<ResourceManager>& resource_manager, size_t batch_size,
                  size_t num_threads_per_file, size_t num_batches_per_thread, bool shuffle,
-                 bool schedule_uploads);
+                 bool schedule_uploads, IOBackend_t io_backend = IOBackend_t::AIO,
+                 size_t shuffle_block_size = 0);
   ~DataReaderImpl();
 
   void start();
 
+  // Stops the reader threads once the last batch returned by get_batch() has been released
+  void stop();
+
   const Batch& get_batch();
 
   void device_release_last_batch_here(cudaStream_t stream, int gpu_id) const;
@@ -143,6 +179,11 @@ class DataReaderImpl {
 
   size_t get_total_inflight_batches() const;
 
+  size_t get_total_batches() const { return num_batches_; }
+
+  // Upper bound of the local batch size of the slot in bytes
+  size_t get_local_batch_size_bytes(size_t slot) const { return local_batch_size_bytes_.at(slot); }
+
  private:
   Batch& get_parent(size_t batch_i);
 
@@ -150,8 +191,18 @@ class DataReaderImpl {
 
   void upload_batches(size_t device_id);
 
+  // Upper bound of the local batch sizes of the slots in bytes
+  std::vector<size_t> local_batch_size_bytes_;
+  // Chunk-compressed slots only, upper bound of the compressed local batch sizes in bytes
+  std::vector<size_t> local_compressed_size_bytes_;
+  std::vector<size_t> samples_per_chunk_;  // [slot], 0 if not compressed
+#ifdef ENABLE_NVCOMP
+  std::vector<std::vector<std::unique_ptr<LZ4Decompressor>>> decompressors_;  // [gpu][slot]
+#endif
+
   std::unique_ptr<IBatchLocations> configure_locations(FileSource source, size_t batch_size,
-                                                       bool shuffle) const;
+                                                       bool shuffle,
+                                                       size_t shuffle_block_size) const;
 
   static void CUDART_CB release_batch_callback(cudaStream_t stream, cudaError_t status,
                                                void* user_data);
@@ -169,6 +220,7 @@ class DataReaderImpl {
   size_t num_batches_ = 0;
   volatile bool running_ = false;
   bool schedule_uploads_ = false;
+  bool direct_to_device_ = false;  // GDS, no host bounce buffer and no H2D copy
   Batch* last_batch_ = nullptr;
   std::vector<std::unique_ptr<Batch>> batch_buffers_;
 
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <data_readers/multi_hot/detail/io_context.hpp>
 #include <utils.hpp>
 
 namespace HugeCTR {
@@ -23,22 +24,27 @@ class DeviceTransfer {
  public:
   DeviceTransfer(size_t upload_gpu, uint8_t* upload_src, uint8_t* upload_dst, size_t size_bytes)
       : upload_gpu_(upload_gpu),
-        upload_src_(const_cast<uint8_t*>(upload_src)),
-        upload_dst_(const_cast<uint8_t*>(upload_dst)),
-        size_bytes_(size_bytes) {}
+        upload_srcs_({{const_cast<uint8_t*>(upload_src), size_bytes}}),
+        upload_dst_(const_cast<uint8_t*>(upload_dst)) {}
+
+  // Gathers the pieces back to back into upload_dst
+  DeviceTransfer(size_t upload_gpu, const std::vector<IOBuffer>& upload_srcs, uint8_t* upload_dst)
+      : upload_gpu_(upload_gpu), upload_srcs_(upload_srcs), upload_dst_(upload_dst) {}
 
   size_t get_device_id() const { return upload_gpu_; }
 
   void execute(const cudaStream_t& stream) {
-    HCTR_LIB_THROW(
-        cudaMemcpyAsync(upload_dst_, upload_src_, size_bytes_, cudaMemcpyHostToDevice, stream));
+    uint8_t* dst = upload_dst_;
+    for (const auto& src : upload_srcs_) {
+      HCTR_LIB_THROW(cudaMemcpyAsync(dst, src.data, src.size, cudaMemcpyHostToDevice, stream));
+      dst += src.size;
+    }
   }
 
  private:
   size_t upload_gpu_;
-  uint8_t* upload_src_;
+  std::vector<IOBuffer> upload_srcs_;
   uint8_t* upload_dst_;
-  size_t size_bytes_;
 };
 
 }  // namespace HugeCTR
\ No newline at end of file
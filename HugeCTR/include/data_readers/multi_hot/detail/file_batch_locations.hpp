@@ -15,19 +15,160 @@
  */
 #pragma once
 
-#include << data_readers / multi_hot / detail / batch_locations.hpp>
+#include <data_readers/multi_hot/detail/batch_locations.hpp>
+#include <data_readers/multi_hot/variable_length_format.hpp>
+#include <numeric>
+#include <stdexcept>
 
 namespace HugeCTR {
 
-class VariableBatchLocations {};
-
 /**
- * @brief Batch locations are stored in a file.
+ * @brief Batch locations of a variable-length file, read from the index stored in the file. Also
+ * used for chunk-compressed files, with a chunk per record.
+ *
+ * A batch is made of batch_size / samples_per_record consecutive records and is sharded on record
+ * boundaries, so every shard is a contiguous range that can be split on the GPU.
  */
-// class FileBatchLocations : public IBatchLocations {
-// public:
-//  // TODO
-//  // mmap_source
-//};
+class VariableBatchLocations : public IBatchLocations {
+ public:
+  VariableBatchLocations(const std::string& file_name, size_t batch_size, bool shuffle = false,
+                         unsigned long long seed = 0)
+      : VariableBatchLocations(read_var_len_footer(file_name), file_name, batch_size, shuffle,
+                               seed) {}
+
+  VariableBatchLocations(const VarLenFileFooter& footer, std::vector<uint64_t> record_offsets,
+                         size_t batch_size, bool shuffle = false, unsigned long long seed = 0)
+      : VariableBatchLocations(footer.num_samples, footer.samples_per_record,
+                               std::move(record_offsets), batch_size, shuffle, seed) {}
+
+  VariableBatchLocations(size_t num_samples, size_t samples_per_record,
+                         std::vector<uint64_t> record_offsets, size_t batch_size,
+                         bool shuffle = false, unsigned long long seed = 0)
+      : record_offsets_(std::move(record_offsets)),
+        num_samples_(num_samples),
+        samples_per_record_(samples_per_record),
+        batch_size_(batch_size) {
+    if (batch_size_ % samples_per_record_) {
+      throw std::invalid_argument("Batch size is not a multiple of the samples per record");
+    }
+    records_per_batch_ = batch_size_ / samples_per_record_;
+    records_per_shard_ = records_per_batch_;
+
+    const size_t num_records = record_offsets_.size() - 1;
+    ids_.resize((num_records + records_per_batch_ - 1) / records_per_batch_);
+    std::iota(ids_.begin(), ids_.end(), 0);
+    order_ = ids_;
+    if (shuffle) {
+      std::mt19937 gen(seed);
+      std::shuffle(ids_.begin(), ids_.end(), gen);
+    }
+    max_shard_size_bytes_ = compute_max_shard_size_bytes();
+  }
+
+  // Upper bound of the shard sizes in bytes
+  size_t get_batch_size_bytes() const { return max_shard_size_bytes_; }
+
+  size_t get_samples_per_record() const { return samples_per_record_; }
+
+  std::vector<std::unique_ptr<IBatchLocations>> distribute(size_t n) const {
+    std::vector<std::unique_ptr<IBatchLocations>> batch_locations;
+    for (size_t i = 0; i < n; ++i) {
+      auto other = new VariableBatchLocations(*this);
+      other->ids_.clear();
+      other->order_.clear();
+      batch_locations.emplace_back(other);
+    }
+
+    // round-robin distribute batches between threads
+    for (size_t i = 0; i < ids_.size(); ++i) {
+      auto other = static_cast<VariableBatchLocations*>(batch_locations[i % n].get());
+      other->ids_.emplace_back(ids_[i]);
+      other->order_.emplace_back(order_[i]);
+    }
+    return batch_locations;
+  }
+
+  // min_batch_size_bytes does not apply, shards are cut on record boundaries
+  std::vector<std::unique_ptr<IBatchLocations>> shard(size_t n, size_t) const {
+    if (records_per_batch_ % n) {
+      throw std::invalid_argument(
+          "The samples per record should divide the local batch size");
+    }
+    std::vector<std::unique_ptr<IBatchLocations>> batch_locations;
+    for (size_t i = 0; i < n; ++i) {
+      auto other = new VariableBatchLocations(*this);
+      other->records_per_shard_ = records_per_batch_ / n;
+      other->shard_id_ = i;
+      other->max_shard_size_bytes_ = other->compute_max_shard_size_bytes();
+      batch_locations.emplace_back(other);
+    }
+    return batch_locations;
+  }
+
+  IBatchLocations::iterator begin() { return IBatchLocations::iterator(this, 0ul); }
+
+  IBatchLocations::iterator end() { return IBatchLocations::iterator(this, ids_.size()); }
+
+  size_t count() { return this->end() - this->begin(); }
+
+  size_t get_max_segments() const { return 1; }
+
+  void set_epoch(size_t) {}
+
+ private:
+  VariableBatchLocations(const VarLenFileFooter& footer, const std::string& file_name,
+                         size_t batch_size, bool shuffle, unsigned long long seed)
+      : VariableBatchLocations(footer, read_var_len_index(file_name, footer), batch_size, shuffle,
+                               seed) {}
+
+  size_t num_records() const { return record_offsets_.size() - 1; }
+
+  // Samples of records [begin, end)
+  size_t num_samples(size_t begin, size_t end) const {
+    return std::min(end * samples_per_record_, num_samples_) -
+           std::min(begin * samples_per_record_, num_samples_);
+  }
+
+  size_t compute_max_shard_size_bytes() const {
+    size_t max_size = 0;
+    for (size_t batch = 0; batch * records_per_batch_ < num_records(); ++batch) {
+      size_t begin = std::min(batch * records_per_batch_ + shard_id_ * records_per_shard_,
+                              num_records());
+      size_t end = std::min(begin + records_per_shard_, num_records());
+      max_size = std::max<size_t>(max_size, record_offsets_[end] - record_offsets_[begin]);
+    }
+    return max_size;
+  }
+
+  BatchDescriptor at(size_t i) {
+    size_t batch_id = ids_[i % ids_.size()];
+    BatchDescriptor desc;
+    desc.i = order_[i % order_.size()];
+    desc.id = batch_id;
+
+    const size_t batch_begin = batch_id * records_per_batch_;
+    const size_t batch_end = std::min(batch_begin + records_per_batch_, num_records());
+    const size_t begin = std::min(batch_begin + shard_id_ * records_per_shard_, batch_end);
+    const size_t end = std::min(begin + records_per_shard_, batch_end);
+
+    desc.offset = begin < end ? record_offsets_[begin] : SIZE_MAX;
+    desc.shard_size_bytes = record_offsets_[end] - record_offsets_[begin];
+    desc.batch_size_bytes = record_offsets_[batch_end] - record_offsets_[batch_begin];
+    desc.shard_num_samples = num_samples(begin, end);
+    desc.batch_num_samples = num_samples(batch_begin, batch_end);
+    return desc;
+  }
+
+  std::vector<uint64_t> record_offsets_;  // num_records + 1
+  size_t num_samples_;
+  size_t samples_per_record_;
+  size_t batch_size_;
+  size_t records_per_batch_;
+  size_t records_per_shard_;
+  size_t shard_id_ = 0;
+  size_t max_shard_size_bytes_ = 0;
+  std::vector<size_t> ids_;    // for shuffle
+  std::vector<size_t> order_;  // global iteration order
+};
 
-}  // namespace HugeCTR
\ No newline at end of file
+}  // namespace HugeCTR
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cufile.h>
+
+#include <data_readers/multi_hot/detail/io_context.hpp>
+
+namespace HugeCTR {
+
+// GPUDirect Storage: reads go from the file straight into device memory through the cuFile batch
+// API, so IORequest::data must be a device pointer. The file has to be registered before the
+// first submit().
+class GDSContext : public IOContext {
+ public:
+  GDSContext(size_t io_depth);
+  ~GDSContext();
+
+  void submit(const IORequest& request);
+  const std::vector<IOEvent>& collect(size_t min_reqs, size_t timeout_us);
+  size_t get_alignment() const;
+
+  void register_buffers(const std::vector<IOBuffer>& buffers);
+  void register_file(int fd);
+
+ private:
+  size_t io_depth_ = 0;
+  size_t num_inflight_ = 0;
+  CUfileBatchHandle_t batch_handle_;
+  CUfileHandle_t file_handle_;
+  int fd_ = -1;
+  std::vector<CUfileIOParams_t> pending_ios_;  // submitted to cuFile on collect()
+  std::vector<CUfileIOEvents_t> tmp_io_events_;
+  std::vector<IOEvent> tmp_events_;  // prevent dynamic memory allocation
+  std::vector<void*> registered_buffers_;
+};
+
+}  // namespace HugeCTR
@@ -43,6 +43,11 @@ struct IORequest {
 //  IOReadRequest(int fd, uint8_t* data, size_t length, size_t offset, void* user_data);
 //};
 
+struct IOBuffer {
+  uint8_t* data;
+  size_t size;
+};
+
 struct IOEvent {
   IOError error;
   void* user_data;
@@ -54,6 +59,10 @@ class IOContext {
   virtual void submit(const IORequest& request) = 0;
   virtual const std::vector<IOEvent>& collect(size_t min_reqs, size_t timeout_us) = 0;
   virtual size_t get_alignment() const = 0;
+
+  // Optional hints for contexts that can pin the buffers and the file once up front
+  virtual void register_buffers(const std::vector<IOBuffer>& buffers) {}
+  virtual void register_file(int fd) {}
 };
 
 }  // namespace HugeCTR
\ No newline at end of file
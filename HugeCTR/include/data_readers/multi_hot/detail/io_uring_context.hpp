@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <liburing.h>
+
+#include <data_readers/multi_hot/detail/io_context.hpp>
+
+namespace HugeCTR {
+
+// Reads are only queued on submit() and handed to the kernel in batches on collect(). With
+// sq_poll, a kernel thread polls the submission queue and no syscall is needed to submit.
+class IOUringContext : public IOContext {
+ public:
+  IOUringContext(size_t io_depth, bool sq_poll);
+  ~IOUringContext();
+
+  void submit(const IORequest& request);
+  const std::vector<IOEvent>& collect(size_t min_reqs, size_t timeout_us);
+  size_t get_alignment() const;
+
+  void register_buffers(const std::vector<IOBuffer>& buffers);
+  void register_file(int fd);
+
+ private:
+  int find_buffer(const uint8_t* data, size_t size) const;
+
+  size_t io_depth_ = 0;
+  size_t num_pending_ = 0;  // queued, but not submitted yet
+  size_t num_inflight_ = 0;
+  io_uring ring_;
+  std::vector<IOEvent> tmp_events_;  // prevent dynamic memory allocation
+  std::vector<io_uring_cqe*> tmp_cqes_;
+  std::vector<IOBuffer> buffers_;
+  int registered_fd_ = -1;
+};
+
+}  // namespace HugeCTR
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_runtime.h>
+#include <nvcomp/lz4.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace HugeCTR {
+
+// Decompresses the back to back chunks of a chunk-compressed shard on the GPU with the batched
+// LZ4 API of nvCOMP. The chunk headers are walked on the device, so the host only needs the
+// number of chunks.
+class LZ4Decompressor {
+ public:
+  // Allocates on the current device
+  LZ4Decompressor(size_t max_chunks, size_t max_chunk_bytes);
+  LZ4Decompressor(const LZ4Decompressor& other) = delete;
+  ~LZ4Decompressor();
+
+  void decompress(const uint8_t* src, size_t num_chunks, uint8_t* dst, cudaStream_t stream);
+  // Throws if a chunk of the last decompress() failed, the stream must have been synchronized
+  void check_status(size_t num_chunks) const;
+
+ private:
+  size_t max_chunks_;
+  size_t temp_bytes_ = 0;
+  void* temp_ = nullptr;
+  const void** compressed_ptrs_ = nullptr;
+  size_t* compressed_bytes_ = nullptr;
+  size_t* uncompressed_bytes_ = nullptr;
+  size_t* actual_uncompressed_bytes_ = nullptr;
+  void** uncompressed_ptrs_ = nullptr;
+  nvcompStatus_t* statuses_ = nullptr;
+  nvcompStatus_t* host_statuses_ = nullptr;  // pinned
+};
+
+}  // namespace HugeCTR
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_runtime.h>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace HugeCTR {
+
+// Key frequency statistics of one slot, estimated by a KeyFrequencySketch
+struct KeySlotProfile {
+  uint64_t num_keys = 0;        // occurrences
+  double cardinality = 0.;      // distinct keys
+  double top_keys_share = 0.;   // share of the occurrences that are top keys
+  double power_law_alpha = 0.;  // fitted to the counts of the top keys, 0 if there are too few
+  std::vector<std::pair<long long, uint64_t>> top_keys;  // (key, count), most frequent first
+};
+
+/**
+ * Streaming key frequency statistics of every slot, kept on one GPU. Per slot:
+ * - a count-min sketch of depth x width counters, which estimates the count of any key. The
+ *   estimates never undercount and overcount by at most e / width of the occurrences with
+ *   probability 1 - exp(-depth).
+ * - a HyperLogLog of 2^hll_precision registers, which estimates the number of distinct keys within
+ *   about 1.04 / sqrt(2^hll_precision).
+ * - a table of num_candidates heavy hitter candidates, in which a key replaces the least frequent
+ *   key of its bucket once its estimated count is higher. The candidates are only a superset of the
+ *   top keys; their counts come from the count-min sketch.
+ * The updates are lock-free atomics, a race between two keys of a bucket can lose a candidate.
+ */
+template <typename KeyType>
+class KeyFrequencySketch {
+ public:
+  // The tables in host memory, those of several GPUs merge into one
+  struct HostCopy {
+    size_t num_slots, width, depth;
+    int hll_precision;
+    std::vector<unsigned long long> counters;      // [slot][depth][width]
+    std::vector<uint32_t> registers;               // [slot][2^hll_precision]
+    std::vector<std::vector<KeyType>> candidates;  // [slot]
+
+    void merge(const HostCopy& other);
+    uint64_t estimate(size_t slot, KeyType key) const;
+    std::vector<KeySlotProfile> profile(size_t top_k) const;
+  };
+
+  KeyFrequencySketch(size_t num_slots, int device_id, size_t width = 1 << 16, size_t depth = 4,
+                     int hll_precision = 14, size_t num_candidates = 4096);
+  ~KeyFrequencySketch();
+  KeyFrequencySketch(const KeyFrequencySketch&) = delete;
+  KeyFrequencySketch& operator=(const KeyFrequencySketch&) = delete;
+
+  /**
+   * Adds the first num_rows x hotness[slot] keys of every slot, asynchronously on stream.
+   * @param slot_keys Device array of the num_slots key arrays
+   * @param hotness Device array of the num_slots hotnesses
+   * @param max_hotness The max of hotness
+   */
+  void add(const KeyType* const* slot_keys, const int* hotness, int max_hotness, size_t num_rows,
+           cudaStream_t stream);
+
+  // Synchronous
+  HostCopy to_host() const;
+
+ private:
+  int device_id_;
+  size_t num_slots_, width_, depth_, num_candidates_;
+  int hll_precision_;
+  unsigned long long* counters_ = nullptr;
+  uint32_t* registers_ = nullptr;
+  KeyType* candidates_ = nullptr;
+  unsigned long long* candidate_counts_ = nullptr;  // the estimates at the last update
+};
+
+/**
+ * Writes the profiles as JSON:
+ * {"slots": [{"slot": 0, "num_keys": ..., "cardinality": ..., "top_keys_share": ...,
+ *             "power_law_alpha": ..., "top_keys": [[key, count], ...]}, ...]}
+ */
+void write_key_profile(const std::string& path, const std::vector<KeySlotProfile>& profiles);
+
+}  // namespace HugeCTR
@@ -1,30 +1,77 @@
-/*
- * Copyright (c) 2023, NVIDIA CORPORATION.
- *
- * Licensed under the Apache License, Version 2.0 (the "License");
- * you may not use this file except in compliance with the License.
- * You may obtain a copy of the License at
- *
- *     http://www.apache.org/licenses/LICENSE-2.0
- *
- * Unless required by applicable law or agreed to in writing, software
- * distributed under the License is distributed on an "AS IS" BASIS,
- * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
- * See the License for the specific language governing permissions and
- * limitations under the License.
- */
-#pragma once
-
-#include <core23/tensor.hpp>
-#include <tensor2.hpp>
-
-namespace HugeCTR {
-
-template <typename DenseType, typename SparseType>
-void split_3_way_feat_major(core23::Tensor label_tensor, core23::Tensor dense_tensor,
-                            core23::Tensor sparse_tensors, core23::Tensor label_dense_sparse_tensor,
-                            core23::Tensor bucket_ids, core23::Tensor bucket_positions,
-                            core23::Tensor max_hotnesses, cudaStream_t stream,
-                            bool is_dense_float = false);
-
-}  // namespace HugeCTR
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <core23/tensor.hpp>
+#include <tensor2.hpp>
+
+namespace HugeCTR {
+
+/**
+ * Device tables of the DataTransformParam of a reader, applied by the split kernels in the same
+ * pass. The dense transforms apply to the values once converted, i.e. after the log(1 + x) of
+ * the int dense features. Without transforms all the pointers are null and the plain split
+ * kernels run.
+ */
+struct SplitTransforms {
+  const int* dense_ops = nullptr;         // dense_dim DataTransform_t, -1 keeps the feature
+  const int* boundary_offsets = nullptr;  // dense_dim + 1, into boundaries
+  const float* boundaries = nullptr;
+  const long long* key_modulo = nullptr;  // num_slots, 0 keeps the keys
+
+  bool empty() const { return dense_ops == nullptr; }
+};
+
+/**
+ * Splits a batch of fixed-length samples into the label and dense tensors and, per slot, the keys.
+ *
+ * @param int64_file_keys The samples store 64-bit keys while SparseType is 32-bit. The keys are
+ *                        narrowed in the same pass, after the key transforms.
+ */
+template <typename DenseType, typename SparseType>
+void split_3_way_feat_major(const core23::Tensor& label_tensor, const core23::Tensor& dense_tensor,
+                            const core23::Tensor& sparse_tensors,
+                            const core23::Tensor& label_dense_sparse_tensor,
+                            const core23::Tensor& bucket_ids,
+                            const core23::Tensor& bucket_positions,
+                            const core23::Tensor& max_hotnesses, cudaStream_t stream,
+                            bool is_dense_float = false,
+                            const SplitTransforms& transforms = SplitTransforms(),
+                            bool int64_file_keys = false);
+
+/**
+ * Splits a shard of a variable-length file (see variable_length_format.hpp) into the label and
+ * dense tensors and, per slot, the compacted keys and the CSR offsets of the samples.
+ *
+ * @param sparse_tensors Device array of the num_slots key tensors, of batch_size x max hotness
+ * @param bucket_ranges Device array of the num_slots offset tensors, of batch_size + 1. The offsets
+ *                      of the samples past num_samples are the number of keys.
+ * @param data The records of the shard in device memory
+ * @param num_samples Number of samples of the shard, at most batch_size
+ * @param record_scratch UInt64 of at least num_records x (num_slots + 1) + num_slots
+ */
+template <typename DenseType, typename SparseType>
+void split_3_way_variable_length(const core23::Tensor& label_tensor,
+                                 const core23::Tensor& dense_tensor,
+                                 const core23::Tensor& sparse_tensors,
+                                 const core23::Tensor& bucket_ranges, const void* data,
+                                 size_t num_samples, size_t samples_per_record,
+                                 const core23::Tensor& max_hotnesses,
+                                 const core23::Tensor& record_scratch,
+                                 cudaStream_t stream, bool is_dense_float = false,
+                                 const SplitTransforms& transforms = SplitTransforms());
+
+}  // namespace HugeCTR
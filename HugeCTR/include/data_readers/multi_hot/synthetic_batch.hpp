@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <core23/tensor.hpp>
+
+namespace HugeCTR {
+
+/**
+ * Generates num_samples samples in the raw multi-hot layout, [label | dense | keys] of int items
+ * per sample, so that they are split like the samples read from a file.
+ * The labels are 0 or 1, the dense features are uniform in [0, 1) if is_dense_float and ints in
+ * [0, 100) otherwise. The key of a column of slot s is drawn from the first pool_size[s] ranks of
+ * the slot: uniformly if alpha is 0, with the power law x^-alpha otherwise. Rank r becomes the key
+ * r * stride[s] mod vocabulary_size[s], with the stride coprime to the vocabulary size, so the
+ * keys of distinct ranks are distinct and the hot keys are not adjacent.
+ * The samples only depend on the seed.
+ *
+ * @param label_dense_sparse_tensor Int32 of num_samples x sample_dim
+ * @param bucket_ids The slot of every key column, Int32 of the total hotness
+ * @param slot_key_params Int64 of 3 x the number of slots: the pool sizes, >= 1, the vocabulary
+ *                        sizes, >= the pool sizes, and the strides
+ */
+template <typename SparseType>
+void generate_synthetic_batch(core23::Tensor label_dense_sparse_tensor, size_t num_samples,
+                              size_t label_dim, size_t dense_dim, bool is_dense_float,
+                              core23::Tensor bucket_ids, core23::Tensor slot_key_params,
+                              float alpha, uint64_t seed, cudaStream_t stream);
+
+// A stride for generate_synthetic_batch, coprime to vocabulary_size and close to its golden ratio
+long long synthetic_key_stride(long long vocabulary_size);
+
+}  // namespace HugeCTR
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_runtime.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Variable-length RawAsync format. Instead of padding every slot to its max hotness, the samples
+ * are stored in records of samples_per_record samples (the last record of the file can be
+ * shorter):
+ *
+ *   record      := header | label_dense | offsets | padding | keys | padding
+ *   header      VarLenRecordHeader
+ *   label_dense num_samples x (label_dim + dense_dim) 4-byte values, sample-major like the
+ *               fixed-length format
+ *   offsets     num_slots x num_samples + 1 uint32, the CSR offsets of bucket (slot, sample) into
+ *               keys, slot-major
+ *   keys        num_keys keys of key_bytes each
+ *
+ * keys and the next record start at multiples of 8 bytes. The records are followed by the index,
+ * the uint64 file offsets of the records and of the end of the last one, and by VarLenFileFooter.
+ */
+constexpr uint64_t VAR_LEN_MAGIC = 0x4e454c5241564348ull;  // "HCVARLEN"
+
+struct VarLenRecordHeader {
+  uint64_t record_size_bytes;
+  uint32_t num_samples;
+  uint32_t num_keys;
+};
+
+struct VarLenFileFooter {
+  uint64_t magic;
+  uint64_t num_samples;
+  uint64_t num_records;
+  uint32_t samples_per_record;
+  uint32_t label_dim;
+  uint32_t dense_dim;
+  uint32_t num_slots;
+  uint32_t key_bytes;
+  uint32_t reserved;
+};
+
+__host__ __device__ inline size_t var_len_offsets_begin(size_t num_samples, size_t label_dim,
+                                                        size_t dense_dim) {
+  return sizeof(VarLenRecordHeader) + num_samples * (label_dim + dense_dim) * sizeof(int32_t);
+}
+
+__host__ __device__ inline size_t var_len_keys_begin(size_t num_samples, size_t label_dim,
+                                                     size_t dense_dim, size_t num_slots) {
+  size_t end = var_len_offsets_begin(num_samples, label_dim, dense_dim) +
+               (num_slots * num_samples + 1) * sizeof(uint32_t);
+  return (end + 7) / 8 * 8;
+}
+
+/**
+ * Reads the footer and the index (num_records + 1 offsets) of a variable-length file.
+ */
+VarLenFileFooter read_var_len_footer(const std::string& file_name);
+std::vector<uint64_t> read_var_len_index(const std::string& file_name,
+                                         const VarLenFileFooter& footer);
+
+/**
+ * Writes a variable-length file sample by sample.
+ */
+class VarLenFileWriter {
+ public:
+  VarLenFileWriter(const std::string& file_name, size_t samples_per_record, size_t label_dim,
+                   size_t dense_dim, size_t num_slots, size_t key_bytes);
+  ~VarLenFileWriter();
+
+  /**
+   * @param label_dense label_dim + dense_dim 4-byte values
+   * @param keys The keys of every slot
+   */
+  void append(const int32_t* label_dense, const std::vector<std::vector<int64_t>>& keys);
+  // Writes the last record, the index and the footer
+  void close();
+
+ private:
+  void flush_record();
+
+  std::ofstream file_;
+  VarLenFileFooter footer_;
+  std::vector<uint64_t> index_;
+  std::vector<int32_t> label_dense_;
+  std::vector<std::vector<int64_t>> keys_;  // [slot], of the samples of the current record
+  std::vector<std::vector<uint32_t>> hotness_;  // [slot][sample]
+  size_t num_pending_samples_ = 0;
+  bool closed_ = false;
+};
+
+}  // namespace HugeCTR
@@ -17,6 +17,7 @@
 
 #include <embeddings/hybrid_embedding/utils.hpp>
 #include <gpu_learning_rate_scheduler.hpp>
+#include <memory>
 #include <optimizer.hpp>
 #include <sparse_tensor.hpp>
 #include <tensor2.hpp>
@@ -24,6 +25,7 @@
 namespace HugeCTR {
 
 struct BufferBag;
+class DeltaTracker;
 class IEmbedding {
  public:
   virtual ~IEmbedding() {}
@@ -65,6 +67,14 @@ class IEmbedding {
   virtual void freeze() = 0;
   virtual void unfreeze() = 0;
   virtual bool is_trainable() const = 0;
+
+  // Records the rows that update_params() changes on every local GPU, see DeltaTracker. Returns
+  // false if the embedding does not support it.
+  virtual bool enable_delta_tracking(size_t staging_rows) { return false; }
+  virtual const std::vector<std::shared_ptr<DeltaTracker>>& get_delta_trackers() const {
+    static const std::vector<std::shared_ptr<DeltaTracker>> none;
+    return none;
+  }
 };
 
 struct SparseEmbeddingHashParams {
@@ -20,7 +20,9 @@
 #include <embedding_training_cache/parameter_server_manager.hpp>
 #include <embeddings/distributed_slot_sparse_embedding_hash.hpp>
 #include <embeddings/localized_slot_sparse_embedding_hash.hpp>
+#include <future>
 #include <iterator>
+#include <thread_pool.hpp>
 
 namespace HugeCTR {
 
@@ -29,6 +31,8 @@ class EmbeddingTrainingCacheImplBase {
   virtual void dump() = 0;
   virtual void update(std::vector<std::string>&) = 0;
   virtual void update(std::string&) = 0;
+  virtual void prefetch(std::vector<std::string>&) = 0;
+  virtual void prefetch(std::string&) = 0;
   virtual void update_sparse_model_file() = 0;
   virtual std::vector<std::pair<std::vector<long long>, std::vector<float>>> get_incremental_model(
       const std::vector<long long>&) = 0;
@@ -40,6 +44,18 @@ class EmbeddingTrainingCacheImpl : public EmbeddingTrainingCacheImplBase {
   std::vector<std::shared_ptr<IEmbedding>> embeddings_;
   ParameterServerManager<TypeKey> ps_manager_;
 
+  // Asynchronous tiering, see prefetch(). The single worker runs the write-backs and the
+  // prefetches in submission order, so a prefetch sees every write-back that was submitted before.
+  bool async_tiering_;
+  std::unique_ptr<ThreadPool> tiering_thread_;
+  std::vector<BufferBag> prefetch_bags_;
+  std::vector<size_t> prefetch_hit_sizes_;
+  std::vector<std::string> prefetch_keyset_files_;
+  std::vector<BufferBag> write_back_bags_;
+  std::vector<size_t> write_back_sizes_;
+  std::future<void> prefetch_done_;
+  std::future<void> write_back_done_;
+
   size_t get_max_embedding_size_() {
     size_t max_embedding_size = 0;
     for (auto& one_embedding : embeddings_) {
@@ -56,6 +72,20 @@ class EmbeddingTrainingCacheImpl : public EmbeddingTrainingCacheImplBase {
    */
   void load_(std::vector<std::string>& keyset_file_list);
 
+  /**
+   * @brief Waits until the background write-back and prefetch are done, and rethrows their
+   *        errors. Must precede every access to the parameter servers from the calling thread.
+   */
+  void wait_for_tiering_();
+
+  /**
+   * @brief Merges the vectors the last pass dumped to write_back_bags_[i] into the prefetched
+   *        prefetch_bags_[i], which were read before that pass was written back.
+   */
+  void overlay_write_back_(size_t i);
+
+  void update_async_(std::vector<std::string>& keyset_file_list);
+
  public:
   EmbeddingTrainingCacheImpl(std::vector<TrainPSType_t>& ps_types,
                              std::vector<std::shared_ptr<IEmbedding>>& embeddings,
@@ -63,12 +93,13 @@ class EmbeddingTrainingCacheImpl : public EmbeddingTrainingCacheImplBase {
                              std::vector<std::string>& sparse_embedding_files,
                              std::shared_ptr<ResourceManager> resource_manager,
                              std::vector<std::string>& local_paths,
-                             std::vector<HMemCacheConfig>& hmem_cache_configs);
+                             std::vector<HMemCacheConfig>& hmem_cache_configs,
+                             bool async_tiering = false);
 
   EmbeddingTrainingCacheImpl(const EmbeddingTrainingCacheImpl&) = delete;
   EmbeddingTrainingCacheImpl& operator=(const EmbeddingTrainingCacheImpl&) = delete;
 
-  ~EmbeddingTrainingCacheImpl() = default;
+  ~EmbeddingTrainingCacheImpl() override;
 
   /**
    * @brief Dump the downloaded embeddings from GPUs to sparse_model_entity_.
@@ -89,10 +120,24 @@ class EmbeddingTrainingCacheImpl : public EmbeddingTrainingCacheImplBase {
    */
   void update(std::string& keyset_file) override;
 
+  /**
+   * @brief In the asynchronous tiering mode, starts reading the embeddings for the given keysets
+   *        in the background, while the current pass trains. The next update() with the same
+   *        keysets then takes the prefetched embeddings, and writes the dumped ones back in the
+   *        background. Does nothing otherwise.
+   * @param keyset_file_list The file list storing keyset files of the next pass.
+   */
+  void prefetch(std::vector<std::string>& keyset_file_list) override;
+
+  void prefetch(std::string& keyset_file) override;
+
   std::vector<std::pair<std::vector<long long>, std::vector<float>>> get_incremental_model(
       const std::vector<long long>& keys_to_load) override;
 
-  void update_sparse_model_file() override { ps_manager_.update_sparse_model_file(); }
+  void update_sparse_model_file() override {
+    wait_for_tiering_();
+    ps_manager_.update_sparse_model_file();
+  }
 };
 
 }  // namespace HugeCTR
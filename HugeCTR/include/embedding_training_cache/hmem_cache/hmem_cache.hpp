@@ -16,6 +16,8 @@
 #pragma once
 
 #include <embedding_training_cache/hmem_cache/sparse_model_file_ts.hpp>
+#include <future>
+#include <thread_pool.hpp>
 
 namespace HugeCTR {
 
@@ -52,14 +54,22 @@ class HMemCache {
   std::vector<HashTableType> key_idx_maps_;
   std::vector<std::vector<size_t>> slot_ids_;
   std::vector<std::vector<std::vector<float>>> cache_datas_;
+  // A block is dirty when it holds vectors newer than their copy in the sparse model file
+  std::vector<bool> is_dirty_;
 
   bool is_full_{false};
   int head_id_{-1};
 
   std::shared_ptr<SparseModelFileTS<TypeKey>> sparse_model_file_ptr_;
 
+  // The evicted block is parked in the reserved slot (num_block_) and written back to the sparse
+  // model file from this thread, so that the eviction overlaps with the next training pass.
+  std::unique_ptr<ThreadPool> write_back_thread_;
+  std::future<void> write_back_done_;
+
   size_t find_(TypeKey key);
   std::pair<int, size_t> cascade_find_(TypeKey key);
+  void wait_for_write_back_();
 
  public:
   HMemCache(size_t num_cached_pass, double target_hit_rate, size_t max_num_evict,
@@ -67,6 +77,8 @@ class HMemCache {
             bool use_slot_id, Optimizer_t opt_type, size_t emb_vec_size,
             std::shared_ptr<ResourceManager> resource_manager);
 
+  ~HMemCache();
+
   std::pair<std::vector<long long>, std::vector<float>> read(long long const *key_ptr, size_t len);
   void read(TypeKey *key_ptr, size_t &len, size_t *slot_id_ptr, std::vector<float *> &data_ptrs);
   void write(const TypeKey *key_ptr, size_t len, size_t const *slot_id_ptr,
@@ -74,7 +86,10 @@ class HMemCache {
 
   void sync_to_ssd();
 
-  auto get_sparse_model_file() { return sparse_model_file_ptr_; }
+  auto get_sparse_model_file() {
+    wait_for_write_back_();
+    return sparse_model_file_ptr_;
+  }
 };
 
 }  // namespace HugeCTR
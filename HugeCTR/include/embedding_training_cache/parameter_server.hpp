@@ -56,6 +56,11 @@ class ParameterServer {
    */
   void load_keyset_from_file(std::string keyset_file);
 
+  /**
+   * @brief The keyset loaded last by load_keyset_from_file.
+   */
+  const std::vector<TypeKey> &get_keyset() const { return keyset_; }
+
   /**
    * @brief Pull embedding vectors from the sparse embedding model according to
    *        keyset_. It only loads embedding vectors that their corresponding
@@ -26,6 +26,8 @@ template <typename TypeKey>
 class ParameterServerManager {
   std::vector<std::shared_ptr<ParameterServer<TypeKey>>> ps_;
   BufferBag buf_bag_;
+  size_t buffer_size_;
+  size_t max_vec_size_;
 
  public:
   ParameterServerManager(std::vector<TrainPSType_t>& ps_types,
@@ -45,6 +47,12 @@ class ParameterServerManager {
 
   BufferBag& get_buffer_bag() { return buf_bag_; }
 
+  /**
+   * @brief Creates a bag with its own host buffers for keys, slot_id, embedding and opt_states,
+   *        sized like those of the shared bag. The device-side staging buffers are shared.
+   */
+  BufferBag create_staging_bag();
+
   void update_sparse_model_file() {
     for (auto& ps : ps_) ps->flush_emb_tbl_to_ssd();
   }
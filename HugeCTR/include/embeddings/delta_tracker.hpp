@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_runtime.h>
+
+#include <cstdint>
+
+namespace HugeCTR {
+
+/**
+ * Records on the GPU which rows of the embedding table of one GPU the training updated, so that
+ * they can be streamed to the inference side without collecting the keys on the host.
+ *
+ * mark() sets the rows of the batch in a bitmap, and their keys, on the training stream after the
+ * optimizer, so a row is recorded once however often it is updated. extract() compacts the marked
+ * rows and their vectors into pinned buffers on a side stream, without waiting for the training,
+ * and unmarks them. A row updated while it is extracted is marked again, so it is sent again by
+ * the next extract() even if the vector that was read mixes two versions.
+ */
+class DeltaTracker {
+ public:
+  /**
+   * @param device_id Device of the table.
+   * @param stream Training stream, that updates the table.
+   * @param table Rows of embedding_vec_size floats.
+   * @param num_rows Rows of the table.
+   * @param staging_rows Rows returned by one extract() at most.
+   */
+  DeltaTracker(int device_id, cudaStream_t stream, const float* table, size_t num_rows,
+               size_t embedding_vec_size, size_t staging_rows);
+  DeltaTracker(const DeltaTracker&) = delete;
+  DeltaTracker& operator=(const DeltaTracker&) = delete;
+  ~DeltaTracker();
+
+  /**
+   * Marks the rows value_index[0, nnz) of the keys[0, nnz), on the training stream.
+   */
+  template <typename TypeHashKey>
+  void mark(const TypeHashKey* keys, const size_t* value_index, size_t nnz);
+
+  /**
+   * Unmarks all the rows on the training stream, e.g., once the table is reloaded.
+   */
+  void reset();
+
+  /**
+   * The next extract() calls include the updates issued so far on the training stream.
+   */
+  void record();
+
+  /**
+   * Copies up to staging_rows marked rows to keys() and vectors(), and unmarks them. Only waits
+   * for the side stream.
+   *
+   * @return The number of rows copied, staging_rows if more may be left.
+   */
+  size_t extract();
+
+  const long long* keys() const { return h_keys_; }
+  const float* vectors() const { return h_vectors_; }
+  size_t get_staging_rows() const { return staging_rows_; }
+  size_t get_embedding_vec_size() const { return embedding_vec_size_; }
+
+ private:
+  int device_id_;
+  cudaStream_t stream_;
+  const float* table_;
+  size_t num_rows_;
+  size_t embedding_vec_size_;
+  size_t staging_rows_;
+
+  uint32_t* d_marked_;     // Bitmap of the rows
+  long long* d_row_keys_;  // Key of every row, valid where marked
+  size_t* d_rows_;         // Rows of the last extract()
+  long long* d_keys_;
+  float* d_vectors_;
+  unsigned long long* d_count_;
+  long long* h_keys_;
+  float* h_vectors_;
+  unsigned long long* h_count_;
+  cudaStream_t side_stream_;
+  cudaEvent_t recorded_;
+};
+
+}  // namespace HugeCTR
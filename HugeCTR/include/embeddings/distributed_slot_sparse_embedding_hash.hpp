@@ -18,6 +18,7 @@
 #include <omp.h>
 
 #include <common.hpp>
+#include <embeddings/delta_tracker.hpp>
 #include <embeddings/embedding_data.hpp>
 #include <embeddings/sparse_embedding_functors.hpp>
 #include <utils.hpp>
@@ -83,6 +84,8 @@ class DistributedSlotSparseEmbeddingHash : public IEmbedding {
 
   SparseEmbeddingFunctors functors_;
 
+  std::vector<std::shared_ptr<DeltaTracker>> delta_trackers_; /**< Empty unless tracking. */
+
   std::vector<EmbeddingOptimizer<TypeHashKey, TypeEmbeddingComp>> embedding_optimizers_;
 
   /**
@@ -244,6 +247,11 @@ class DistributedSlotSparseEmbeddingHash : public IEmbedding {
           wgrad_tensors_[id], hash_table_value_tensors_[id],
           embedding_data_.get_local_gpu(id).get_sm_count(),
           embedding_data_.get_local_gpu(id).get_stream());
+      if (!delta_trackers_.empty()) {
+        delta_trackers_[id]->mark(embedding_data_.get_value_tensors(true)[id].get_ptr(),
+                                  hash_value_index_tensors_[id].get_ptr(),
+                                  *embedding_data_.get_nnz_array(true)[id]);
+      }
     }
 
     return;
@@ -436,6 +444,12 @@ class DistributedSlotSparseEmbeddingHash : public IEmbedding {
 
   bool is_trainable() const override { return embedding_data_.is_trainable_; }
 
+  bool enable_delta_tracking(size_t staging_rows) override;
+
+  const std::vector<std::shared_ptr<DeltaTracker>> &get_delta_trackers() const override {
+    return delta_trackers_;
+  }
+
   USE_EMBEDDING_DATA_FUNCTION(embedding_data_)
 };  // end of class DistributedSlotSparseEmbeddingHash
 
@@ -20,9 +20,10 @@
 #include <embedding/data_distributor/data_distributor.hpp>
 #include <embedding/embedding.hpp>
 #include <embedding/gpu_barrier/gpu_barrier.hpp>
-#include <embedding/operators/transpose_input.hpp>
+#include <embedding/operators/wgrad_accumulation.hpp>
 #include <embedding_storage/embedding_table.hpp>
 #include <embedding_storage/ragged_static_embedding.hpp>
+#include <functional>
 #include <include/exchange_wgrad.hpp>
 #include <include/network_buffer_channels.hpp>
 #include <optimizer.hpp>
@@ -39,22 +40,44 @@ class EmbeddingTableConfig {
 
   EmbeddingTableConfig(const std::string &name, int max_vocabulary_size, int ev_size,
                        std::optional<HugeCTR::OptParams> opt_param_or_empty,
-                       std::optional<::embedding::InitParams> init_param_or_empty)
+                       std::optional<::embedding::InitParams> init_param_or_empty,
+                       bool fp16_opt_state = false, float lr_multiplier = 1.f,
+                       std::optional<::embedding::DynamicEvictionParams> eviction_param_or_empty =
+                           std::nullopt,
+                       bool hash_keys = false,
+                       std::optional<::embedding::DynamicOffloadParams> offload_param_or_empty =
+                           std::nullopt)
       : name(name) {
+    HCTR_CHECK_HINT(lr_multiplier >= 0.f, "lr_multiplier of table ", name, " is negative");
+    HCTR_CHECK_HINT(!eviction_param_or_empty.has_value() || max_vocabulary_size < 0, "Table ",
+                    name, " is static, eviction is only supported by dynamic tables.");
+    HCTR_CHECK_HINT(!hash_keys || max_vocabulary_size > 0, "Table ", name,
+                    " is dynamic, hash_keys is only supported by static tables.");
+    HCTR_CHECK_HINT(!offload_param_or_empty.has_value() || max_vocabulary_size < 0, "Table ",
+                    name, " is static, offload is only supported by dynamic tables.");
     HugeCTR::OptParams opt_param;
     if (opt_param_or_empty.has_value()) {
       opt_param = opt_param_or_empty.value();
     } else {
       opt_param.optimizer = HugeCTR::Optimizer_t::NOT_INITIALIZED;
     }
+    opt_param.lr_multiplier = lr_multiplier;
 
     ::embedding::InitParams init_param{ev_size};
     if (init_param_or_empty.has_value()) {
       init_param = init_param_or_empty.value();
     }
 
-    this->table_param =
-        ::embedding::EmbeddingTableParam{-1, max_vocabulary_size, ev_size, opt_param, init_param};
+    this->table_param = ::embedding::EmbeddingTableParam{
+        -1,
+        max_vocabulary_size,
+        ev_size,
+        opt_param,
+        init_param,
+        fp16_opt_state,
+        eviction_param_or_empty.value_or(::embedding::DynamicEvictionParams()),
+        hash_keys,
+        offload_param_or_empty.value_or(::embedding::DynamicOffloadParams())};
   }
 };
 
@@ -78,6 +101,14 @@ class EmbeddingCollectionConfig {
 
   std::vector<ShardStrategy> shard_strategy_;
   std::vector<std::vector<std::string>> shard_matrix_;
+  // table name -> num_shards + 1 row offsets of a range sharded model parallel table
+  std::unordered_map<std::string, std::vector<int64_t>> shard_row_offsets_;
+
+  // Hybrid placement: at most this many hot rows per table are replicated. A row is hot if the
+  // sampled all-to-all traffic it causes exceeds the cost of allreducing its gradient.
+  int64_t hybrid_max_num_hot_rows_ = 1 << 20;
+  double hybrid_all_to_all_bandwidth_ = 1.0;
+  double hybrid_all_reduce_bandwidth_ = 1.0;
 
   ::embedding::EmbeddingLayout output_layout_;
 
@@ -85,18 +116,40 @@ class EmbeddingCollectionConfig {
   ::embedding::KeysPreprocessStrategy keys_preprocess_strategy_;
   ::embedding::AllreduceStrategy allreduce_strategy_;
   ::embedding::CommunicationStrategy comm_strategy_;
+  int num_all2all_chunks_;
+  ::embedding::All2AllCompression all2all_compression_;
+  int num_gradient_accumulation_steps_;
+  bool unique_keys_before_all2all_;
+  bool sync_free_;
+  bool deterministic_;
 
   std::string batch_major_output_name_;
 
   // if we need more configuration about EmbeddingCollection
   EmbeddingCollectionConfig(bool use_exclusive_keys,
-                            ::embedding::CommunicationStrategy comm_strategy)
+                            ::embedding::CommunicationStrategy comm_strategy,
+                            int num_all2all_chunks = 1,
+                            ::embedding::All2AllCompression all2all_compression =
+                                ::embedding::All2AllCompression::None,
+                            int num_gradient_accumulation_steps = 1,
+                            bool unique_keys_before_all2all = false, bool sync_free = false,
+                            bool sparse_allreduce = false, bool deterministic = false)
       : output_layout_(::embedding::EmbeddingLayout::FeatureMajor),
         sort_strategy_(use_exclusive_keys ? ::embedding::SortStrategy::Radix
                                           : ::embedding::SortStrategy::Segmented),
         keys_preprocess_strategy_(::embedding::KeysPreprocessStrategy::AddOffset),
-        allreduce_strategy_(::embedding::AllreduceStrategy::Dense),
-        comm_strategy_(comm_strategy) {
+        allreduce_strategy_(sparse_allreduce ? ::embedding::AllreduceStrategy::Sparse
+                                             : ::embedding::AllreduceStrategy::Dense),
+        comm_strategy_(comm_strategy),
+        num_all2all_chunks_(num_all2all_chunks),
+        all2all_compression_(all2all_compression),
+        num_gradient_accumulation_steps_(num_gradient_accumulation_steps),
+        unique_keys_before_all2all_(unique_keys_before_all2all),
+        sync_free_(sync_free),
+        deterministic_(deterministic) {
+    HCTR_CHECK_HINT(num_all2all_chunks_ >= 1, "num_all2all_chunks should be >= 1");
+    HCTR_CHECK_HINT(num_gradient_accumulation_steps_ >= 1,
+                    "num_gradient_accumulation_steps should be >= 1");
     if (comm_strategy_ == ::embedding::CommunicationStrategy::Hierarchical) {
       HCTR_LOG(INFO, ROOT, "Using Hier Communication Strategy\n");
     }
@@ -153,12 +206,25 @@ class EmbeddingCollectionConfig {
   }
 
   void shard(const std::vector<std::vector<std::string>> &shard_matrix,
-             const std::vector<ShardStrategy> &shard_strategy) {
+             const std::vector<ShardStrategy> &shard_strategy,
+             const std::unordered_map<std::string, std::vector<int64_t>> &row_splits = {}) {
     shard_matrix_.clear();
     shard_strategy_.clear();
+    shard_row_offsets_.clear();
 
     shard_matrix_ = shard_matrix;
     shard_strategy_ = shard_strategy;
+    shard_row_offsets_ = row_splits;
+  }
+
+  void hybrid_param(int64_t max_num_hot_rows, double all_to_all_bandwidth,
+                    double all_reduce_bandwidth) {
+    HCTR_CHECK_HINT(max_num_hot_rows >= 0, "max_num_hot_rows should be >= 0");
+    HCTR_CHECK_HINT(all_to_all_bandwidth > 0 && all_reduce_bandwidth > 0,
+                    "hybrid placement bandwidths should be > 0");
+    hybrid_max_num_hot_rows_ = max_num_hot_rows;
+    hybrid_all_to_all_bandwidth_ = all_to_all_bandwidth;
+    hybrid_all_reduce_bandwidth_ = all_reduce_bandwidth;
   }
 };
 
@@ -238,13 +304,71 @@ inline std::vector<std::vector<int>> create_shard_matrix_from_ebc_config(
   return shard_matrix;
 }
 
+inline std::vector<std::vector<int64_t>> create_table_shard_row_offsets_from_ebc_config(
+    const TableNameToIDDict &table_name_to_id_dict, const EmbeddingCollectionConfig &config) {
+  std::vector<std::vector<int64_t>> table_shard_row_offsets(table_name_to_id_dict.size());
+  if (config.shard_row_offsets_.empty()) return table_shard_row_offsets;
+
+  auto shard_matrix = create_shard_matrix_from_ebc_config(table_name_to_id_dict, config);
+  for (auto &[name, row_offsets] : config.shard_row_offsets_) {
+    HCTR_CHECK_HINT(table_name_to_id_dict.find(name) != table_name_to_id_dict.end(),
+                    "create_table_shard_row_offsets_from_ebc_config error, no such name: ", name,
+                    "\n");
+    int table_id = table_name_to_id_dict.at(name);
+
+    bool is_model_parallel = false;
+    for (auto &shard_strategy : config.shard_strategy_) {
+      auto placement_strategy = get_table_place_strategy(shard_strategy);
+      if (placement_strategy != "mp" && placement_strategy != "hybrid") continue;
+      auto group_strategy = get_table_group_strategy(shard_strategy);
+      if (std::find(group_strategy.begin(), group_strategy.end(), name) != group_strategy.end()) {
+        is_model_parallel = true;
+      }
+    }
+    HCTR_CHECK_HINT(is_model_parallel, "row_splits requires a model parallel table: ", name, "\n");
+
+    int num_shards = 0;
+    for (auto &shard_on_each_gpu : shard_matrix) {
+      num_shards += shard_on_each_gpu[table_id];
+    }
+    HCTR_CHECK_HINT(row_offsets.size() == static_cast<size_t>(num_shards + 1), "row_splits of ",
+                    name, " should have num_shards + 1 = ", num_shards + 1, " offsets\n");
+
+    int64_t vocabulary_size = -1;
+    for (auto &table_config : config.emb_table_config_list_) {
+      if (table_config.name == name) vocabulary_size = table_config.table_param.max_vocabulary_size;
+    }
+    HCTR_CHECK_HINT(vocabulary_size > 0, "row_splits requires a static table: ", name, "\n");
+    HCTR_CHECK_HINT(row_offsets.front() == 0 && row_offsets.back() == vocabulary_size,
+                    "row_splits of ", name, " should start at 0 and end at the vocabulary size ",
+                    vocabulary_size, "\n");
+    HCTR_CHECK_HINT(std::is_sorted(row_offsets.begin(), row_offsets.end()), "row_splits of ", name,
+                    " should be non-decreasing\n");
+    table_shard_row_offsets[table_id] = row_offsets;
+  }
+  return table_shard_row_offsets;
+}
+
+inline std::vector<std::string> get_hybrid_table_names_from_ebc_config(
+    const EmbeddingCollectionConfig &config) {
+  std::vector<std::string> hybrid_table_names;
+  for (auto &shard_strategy : config.shard_strategy_) {
+    if (get_table_place_strategy(shard_strategy) != "hybrid") continue;
+    auto group_strategy = get_table_group_strategy(shard_strategy);
+    hybrid_table_names.insert(hybrid_table_names.end(), group_strategy.begin(),
+                              group_strategy.end());
+  }
+  return hybrid_table_names;
+}
+
 inline std::vector<::embedding::GroupedTableParam> create_grouped_embedding_param_from_ebc_config(
     const TableNameToIDDict &table_name_to_id_dict, const EmbeddingCollectionConfig &config) {
   std::vector<::embedding::GroupedTableParam> grouped_embedding_params;
   for (auto &shard_strategy : config.shard_strategy_) {
     auto placement_strategy_string = get_table_place_strategy(shard_strategy);
     ::embedding::TablePlacementStrategy placement_strategy;
-    if (placement_strategy_string == "mp") {
+    // Hybrid tables are model parallel, their hot rows are replicated on top (table_hot_keys_).
+    if (placement_strategy_string == "mp" || placement_strategy_string == "hybrid") {
       placement_strategy = ::embedding::TablePlacementStrategy::ModelParallel;
     } else if (placement_strategy_string == "dp") {
       placement_strategy = ::embedding::TablePlacementStrategy::DataParallel;
@@ -280,6 +404,9 @@ class EmbeddingCollection {
 
   std::vector<std::vector<EmbeddingOutputAttr>> embedding_output_attrs_;
   std::vector<std::vector<Wgrad>> wgrad_list_;
+  // Per gpu and group, only with num_gradient_accumulation_steps_ > 1.
+  std::vector<std::vector<WgradAccumulator>> wgrad_accumulators_;
+  std::vector<std::vector<int>> num_accumulated_steps_;
   std::unique_ptr<HugeCTR::GPUBarrier> gpu_barrier_;
 
   void init_embedding_output_attrs(std::vector<std::shared_ptr<CoreResourceManager>> core);
@@ -295,6 +422,12 @@ class EmbeddingCollection {
     return embedding_tables_[gpu_id][grouped_table_id].get();
   }
 
+  // Runs \p run for each of \p grouped_ids in \p stage. The groups of a local stage run
+  // concurrently, one side stream per table, and the all-to-alls of a backward network stage are
+  // merged into one NCCL group.
+  void run_grouped_stage(Stage stage, int gpu_id, const std::vector<size_t> &grouped_ids,
+                         const std::function<void(size_t)> &run);
+
  public:
   // Fix:load and dump use these , put it on public temporary
   std::vector<HugeCTR::OptParams> embedding_optimizers_;
@@ -314,6 +447,9 @@ class EmbeddingCollection {
   void cache_ddl_output(int gpu_id, const HugeCTR::DataDistributor::Result &input,
                         HugeCTR::DataDistributor::Result &output, int batch_size);
 
+  // Whether any of the embeddings runs \p stage, in training or in evaluation.
+  bool has_stage(Stage stage, bool is_train) const;
+
   void forward_per_gpu(Stage stage, bool is_train, int gpu_id,
                        const HugeCTR::DataDistributor::Result &input, core23::Tensor &output_buffer,
                        int batch_size);
@@ -333,6 +469,9 @@ class EmbeddingCollection {
 
   void set_learning_rate(float lr);
 
+  // The tables of every local GPU read the learning rate of its scheduler from then on
+  void set_learning_rate_scheduler(const HugeCTR::GpuLearningRateSchedulers &lr_scheds);
+
   std::vector<std::vector<IGroupedEmbeddingTable *>> get_grouped_embedding_tables() {
     std::vector<std::vector<IGroupedEmbeddingTable *>> grouped_embedding_tables;
     grouped_embedding_tables.resize(embedding_tables_.size());
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Layout of the samples of a RawAsync data file: `label_dim` labels and `dense_dim` dense features
+ * (4 bytes each), followed by `nnz_per_slot[i]` keys of `key_bytes` bytes for every slot.
+ */
+struct RawSampleLayout {
+  int label_dim;
+  int dense_dim;
+  std::vector<int> nnz_per_slot;
+  int key_bytes;
+};
+
+using KeyFrequencies = std::unordered_map<int64_t, int64_t>;
+
+/**
+ * Counts the keys of the first `num_samples` samples of a RawAsync data file.
+ *
+ * @return Per slot, the number of occurrences of every key.
+ */
+std::vector<KeyFrequencies> sample_raw_key_frequencies(const std::string &file_name,
+                                                       const RawSampleLayout &layout,
+                                                       int64_t num_samples);
+
+/**
+ * Selects the keys of a model parallel table whose rows are replicated on every GPU (hybrid
+ * placement). Uses the IB_NVLink threshold of the hybrid embedding: a key is hot if it occurs more
+ * than `num_gpus * all_to_all_bandwidth / all_reduce_bandwidth * num_gpus / (num_gpus - 1)` times
+ * per iteration, i.e., if fetching it through the all-to-all costs more than allreducing its
+ * gradient.
+ *
+ * @param frequencies The sampled key frequencies of the table.
+ * @param num_iterations Number of iterations that were sampled.
+ * @return The sorted hot keys, at most `max_num_hot_keys` of the most frequent ones.
+ */
+std::vector<int64_t> select_hot_keys(const KeyFrequencies &frequencies, int64_t num_iterations,
+                                     int num_gpus, double all_to_all_bandwidth,
+                                     double all_reduce_bandwidth, int64_t max_num_hot_keys);
+
+}  // namespace HugeCTR
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <embeddings/embedding_collection.hpp>
+#include <string>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Statistics of one embedding table, as consumed by `plan_embedding_sharding`.
+ */
+struct EmbeddingPlannerTableStats {
+  std::string name;
+  int64_t vocabulary_size;
+  int ev_size;
+  int max_hotness;
+  // Measured average number of keys per sample (<= 0 = assume `max_hotness`).
+  double lookup_frequency;
+  // Number of float optimizer states per weight (e.g., 2 for Adam).
+  int num_optimizer_states;
+
+  EmbeddingPlannerTableStats(const std::string &name, int64_t vocabulary_size, int ev_size,
+                             int max_hotness, double lookup_frequency = -1.0,
+                             int num_optimizer_states = 1)
+      : name(name),
+        vocabulary_size(vocabulary_size),
+        ev_size(ev_size),
+        max_hotness(max_hotness),
+        lookup_frequency(lookup_frequency),
+        num_optimizer_states(num_optimizer_states) {}
+
+  double keys_per_sample() const { return lookup_frequency > 0 ? lookup_frequency : max_hotness; }
+  int64_t num_bytes() const {
+    return vocabulary_size * ev_size * static_cast<int64_t>(sizeof(float)) *
+           (1 + num_optimizer_states);
+  }
+};
+
+/**
+ * Description of the GPUs that the tables are distributed across.
+ */
+struct EmbeddingPlannerDeviceSpec {
+  int num_gpus;
+  int global_batch_size;
+  int64_t memory_bytes_per_gpu;
+  // GB/s of the embedding lookups (HBM) and of the all-to-all (NVLink / network) per GPU.
+  double memory_bandwidth;
+  double comm_bandwidth;
+  // Tables up to this size are replicated (data parallel); 0 disables data parallel placement.
+  int64_t max_data_parallel_table_bytes;
+  // [num_gpus][num_gpus] relative cost of moving data between two GPUs, e.g., GpuTopology::cost;
+  // empty if all the GPUs are connected alike.
+  std::vector<std::vector<double>> link_cost;
+
+  EmbeddingPlannerDeviceSpec(int num_gpus, int global_batch_size, int64_t memory_bytes_per_gpu,
+                             double memory_bandwidth, double comm_bandwidth,
+                             int64_t max_data_parallel_table_bytes = 0,
+                             const std::vector<std::vector<double>> &link_cost = {})
+      : num_gpus(num_gpus),
+        global_batch_size(global_batch_size),
+        memory_bytes_per_gpu(memory_bytes_per_gpu),
+        memory_bandwidth(memory_bandwidth),
+        comm_bandwidth(comm_bandwidth),
+        max_data_parallel_table_bytes(max_data_parallel_table_bytes),
+        link_cost(link_cost) {}
+};
+
+/**
+ * Result of `plan_embedding_sharding`. `shard_matrix` and `shard_strategy` can be passed to
+ * `EmbeddingCollectionConfig::shard` as they are.
+ */
+struct EmbeddingShardPlan {
+  std::vector<std::vector<std::string>> shard_matrix;
+  std::vector<ShardStrategy> shard_strategy;
+
+  // Estimated per GPU cost (us per iteration) and memory (bytes).
+  std::vector<double> gpu_cost;
+  std::vector<int64_t> gpu_memory;
+
+  double imbalance() const;
+
+  /**
+   * @return A human readable summary of the placement (dry-run report).
+   */
+  std::string report() const;
+};
+
+/**
+ * Distributes embedding tables across GPUs, so that the maximum estimated per GPU lookup plus
+ * communication cost is minimized (greedy longest processing time first).
+ *
+ * Small tables are replicated (data parallel). Model parallel tables that would not fit on a
+ * single GPU, or whose cost exceeds the balanced per GPU cost, are split row-wise across several
+ * GPUs. With a link_cost, the partial results of the shards of a table, which are reduced across
+ * them, cost more between slowly connected GPUs, so that the shards of a table gather on, e.g.,
+ * NVLink-connected GPUs.
+ */
+EmbeddingShardPlan plan_embedding_sharding(const std::vector<EmbeddingPlannerTableStats> &tables,
+                                           const EmbeddingPlannerDeviceSpec &spec);
+
+}  // namespace HugeCTR
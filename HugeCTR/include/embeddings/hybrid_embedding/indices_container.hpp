@@ -17,6 +17,7 @@
 
 #include <cuda_runtime.h>
 
+#include <algorithm>
 #include <common.hpp>
 #include <data_readers/async_reader/async_reader_common.hpp>
 #include <embeddings/hybrid_embedding/data.hpp>
@@ -44,6 +45,13 @@ class BatchIndices {
 
   void compute(int raw_device_id, size_t batch_size, cudaStream_t stream);
 
+  // The categories of the batch are unique already, only the indices are computed again
+  void recompute_indices(int raw_device_id, cudaStream_t stream);
+
+  // Marks the indices of every device outdated, e.g. after the model was re-calibrated
+  void invalidate() { std::fill(stale_.begin(), stale_.end(), 1); }
+  bool is_stale(int raw_device_id) const { return stale_[raw_device_id]; }
+
   FrequentEmbeddingCompression<dtype>& get_frequent(int raw_device_id) {
     return frequent_compression_[raw_device_id];
   }
@@ -59,6 +67,7 @@ class BatchIndices {
   std::vector<Data<dtype>> data_;
   std::vector<FrequentEmbeddingCompression<dtype>> frequent_compression_;
   std::vector<InfrequentEmbeddingSelection<dtype>> infrequent_selection_;
+  std::vector<char> stale_;  // per device, not bool since the devices are set concurrently
 };
 
 }  // namespace hybrid_embedding
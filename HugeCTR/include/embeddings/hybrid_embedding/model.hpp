@@ -68,6 +68,9 @@ struct Model {
   Tensor2<dtype> frequent_categories;
   std::vector<dtype> h_frequent_model_table_offsets;
   std::vector<dtype> h_infrequent_model_table_offsets;
+  // Whether a category has the same infrequent location in every model, frequent or not, as is
+  // needed to re-calibrate the model while training
+  bool fixed_infrequent_location = false;
 
   // constructors: overloaded for convenience / unit tests
   // copy constructor
@@ -94,7 +97,7 @@ struct Model {
                                std::shared_ptr<GeneralBuffer2<CudaAllocator>> buf);
   void init_hybrid_model(const CalibrationData &calibration, Statistics<dtype> &statistics,
                          const Data<dtype> &data, Tensor2<dtype> &tmp_categories,
-                         cudaStream_t stream);
+                         cudaStream_t stream, size_t max_num_frequent = 0);
 };
 
 }  // namespace hybrid_embedding
@@ -111,7 +111,8 @@ struct Statistics {
   void sort_categories_by_count(const Tensor2<dtype> &samples, cudaStream_t stream);
   void calculate_frequent_and_infrequent_categories(
       dtype *frequent_categories, dtype *infrequent_categories, dtype *category_location,
-      const size_t num_frequent, const size_t num_infrequent, cudaStream_t stream);
+      const size_t num_frequent, const size_t num_infrequent, cudaStream_t stream,
+      bool fixed_infrequent_location = false);
   void calculate_infrequent_model_table_offsets(
       std::vector<dtype> &h_infrequent_model_table_offsets, const dtype *infrequent_categories,
       const Tensor2<dtype> &category_location, uint32_t global_instance_id,
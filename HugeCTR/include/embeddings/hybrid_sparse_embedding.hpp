@@ -59,6 +59,7 @@ struct HybridSparseEmbeddingParams {
   double efficiency_bandwidth_ratio;
   hybrid_embedding::HybridEmbeddingType hybrid_embedding_type;
   OptParams opt_params;  // optimizer params
+  size_t recalibration_interval;  // train iterations between two re-calibrations, 0 for none
 };
 
 ///
@@ -132,6 +133,15 @@ class HybridSparseEmbedding : public SchedulableEmbeding {
   std::vector<BatchIndices<dtype>> train_batch_indices_; /**< Stores indices for Batch. */
   std::vector<BatchIndices<dtype>> eval_batch_indices_;  /**< Stores indices for Batch. */
 
+  // Re-calibration: data_statistics_ keeps the last num_iterations_statistics complete train
+  // batches, in which the frequent categories are looked for again every recalibration_interval
+  // train iterations.
+  size_t num_train_iterations_ = 0;
+  size_t num_window_batches_ = 0;
+  size_t window_slot_ = 0;
+  bool record_window_batch_ = false;
+  size_t max_num_frequent_recalibrated_ = 0;
+
   // TODO: this parameter is not used by HE at all.
   // We should be in pursuit of merging SparseEmbeddingHashParams and HybridSparseEmbeddingParams
   SparseEmbeddingHashParams dummy_params_;
@@ -151,6 +161,19 @@ class HybridSparseEmbedding : public SchedulableEmbeding {
     }
   }
 
+  Tensor2<float>& get_infrequent_embedding_vectors(size_t i) {
+    switch (embedding_params_.communication_type) {
+      case CommunicationType::NVLink_SingleNode:
+        return infrequent_embeddings_single_node_[i].infrequent_embedding_vectors_;
+      case CommunicationType::IB_NVLink:
+        return infrequent_embeddings_ib_nvlink_[i].infrequent_embedding_vectors_;
+      case CommunicationType::IB_NVLink_Hier:
+        return infrequent_embeddings_ib_nvlink_hier_[i].infrequent_embedding_vectors_;
+      default:
+        throw std::runtime_error("Unsupported communication type");
+    }
+  }
+
   InfrequentEmbeddingBase<dtype>& get_infrequent_embedding(size_t i) {
     switch (embedding_params_.communication_type) {
       case CommunicationType::NVLink_SingleNode:
@@ -213,6 +236,12 @@ class HybridSparseEmbedding : public SchedulableEmbeding {
 
   void setup_buffered_indices(bool is_train, AsyncReader<dtype>* data_reader);
 
+  /**
+   * Looks for the frequent categories again in the last train batches and moves the embedding
+   * vectors of the categories which became frequent or infrequent to their new store.
+   */
+  void recalibrate();
+
   void forward(bool is_train) override;
   void backward() override;
   void update_params() override;
@@ -268,6 +297,7 @@ class HybridSparseEmbedding : public SchedulableEmbeding {
   void global_barrier(bool is_train, int i) override;
   void infreq_network_backward(int i) override;
   void infreq_model_backward(int i) override;
+  void recalibrate_if_due() override;
 };
 
 }  // namespace HugeCTR
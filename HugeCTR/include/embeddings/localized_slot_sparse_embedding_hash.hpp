@@ -18,6 +18,7 @@
 #include <omp.h>
 
 #include <common.hpp>
+#include <embeddings/delta_tracker.hpp>
 #include <embeddings/embedding_data.hpp>
 #include <embeddings/sparse_embedding_functors.hpp>
 #include <utils.hpp>
@@ -83,6 +84,8 @@ class LocalizedSlotSparseEmbeddingHash : public IEmbedding {
 
   SparseEmbeddingFunctors functors_;
 
+  std::vector<std::shared_ptr<DeltaTracker>> delta_trackers_; /**< Empty unless tracking. */
+
   Tensors2<TypeEmbeddingComp> all2all_tensors_; /**< the temple buffer to store all2all results */
 
   Tensors2<TypeEmbeddingComp> utest_all2all_tensors_;
@@ -359,6 +362,11 @@ class LocalizedSlotSparseEmbeddingHash : public IEmbedding {
           wgrad_tensors_[id], hash_table_value_tensors_[id],
           embedding_data_.get_local_gpu(id).get_sm_count(),
           embedding_data_.get_local_gpu(id).get_stream());
+      if (!delta_trackers_.empty()) {
+        delta_trackers_[id]->mark(embedding_data_.get_value_tensors(true)[id].get_ptr(),
+                                  hash_value_index_tensors_[id].get_ptr(),
+                                  *embedding_data_.get_nnz_array(true)[id]);
+      }
     }
   }
 
@@ -606,6 +614,12 @@ class LocalizedSlotSparseEmbeddingHash : public IEmbedding {
 
   bool is_trainable() const override { return embedding_data_.is_trainable_; }
 
+  bool enable_delta_tracking(size_t staging_rows) override;
+
+  const std::vector<std::shared_ptr<DeltaTracker>> &get_delta_trackers() const override {
+    return delta_trackers_;
+  }
+
   USE_EMBEDDING_DATA_FUNCTION(embedding_data_)
 
 };  // end of class LocalizedSlotSparseEmbeddingHash
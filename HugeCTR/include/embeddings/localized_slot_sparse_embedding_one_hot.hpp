@@ -47,8 +47,6 @@ class LocalizedSlotSparseEmbeddingOneHot : public IEmbedding {
   Tensors2<size_t> hash_table_slot_id_tensors_; /**< the tensors for storing slot ids */
   Tensors2<size_t> hash_value_index_tensors_;   /**< Hash value index. The index is corresponding to
                                                    the line   number of the value. */
-  Tensors2<TypeEmbeddingComp>
-      embedding_feature_tensors_; /**< the output tensor of the forward(). */
   Tensor2<TypeEmbeddingComp *> train_embedding_features_;
   Tensor2<TypeEmbeddingComp *> evaluate_embedding_features_;
   Tensors2<TypeEmbeddingComp> wgrad_tensors_; /**< the input tensor of the backward(). */
@@ -63,7 +61,6 @@ class LocalizedSlotSparseEmbeddingOneHot : public IEmbedding {
 
   SparseEmbeddingFunctors functors_;
 
-  Tensors2<TypeEmbeddingComp> all2all_tensors_; /**< the temple buffer to store all2all results */
   Tensors2<TypeEmbeddingComp> utest_all2all_tensors_;
   Tensors2<TypeEmbeddingComp> utest_reorder_tensors_;
   Tensors2<TypeEmbeddingComp> utest_backward_temp_tensors_;
@@ -32,8 +32,38 @@ class ExchangeWgrad {
   virtual void init_ar_comm(const std::vector<void*>& ptr, size_t sizes) = 0;
   virtual void update_embed_wgrad_size(size_t size) = 0;
   virtual void allreduce(size_t device_id, cudaStream_t stream) = 0;
+  /**
+   * Splits the wgrad buffer into buckets that are allreduced while the backward pass still runs.
+   * @param ranges the [begin, end) byte offsets of the buckets, in the order they get ready
+   */
+  virtual void init_buckets(const std::vector<std::pair<size_t, size_t>>& ranges) = 0;
+  /**
+   * Starts the allreduce of a bucket on a side stream once the work on stream is done. The last
+   * bucket makes stream wait for all of them.
+   */
+  virtual void allreduce_bucket(size_t bucket, size_t device_id, cudaStream_t stream) = 0;
+  /**
+   * Sets the flattened dense wgrads and fp32 master weights that are split into one shard per GPU
+   * when the dense optimizer is sharded.
+   * @param num_weights the number of elements of each of them
+   */
+  virtual void init_shards(const std::vector<void*>& wgrad_ptrs,
+                           const std::vector<float*>& weight_ptrs, size_t num_weights) = 0;
+  /**
+   * Copies the weights of the shard each GPU updated to all the other GPUs.
+   */
+  virtual void all_gather_weights(size_t device_id, cudaStream_t stream) = 0;
 };
 
+/**
+ * The [begin, end) range of the flattened dense weights that the GPU of global id rank updates when
+ * the dense optimizer is sharded across num_ranks GPUs.
+ */
+inline std::pair<size_t, size_t> get_weight_shard(size_t num_weights, size_t rank,
+                                                  size_t num_ranks) {
+  return {num_weights * rank / num_ranks, num_weights * (rank + 1) / num_ranks};
+}
+
 template <typename TypeFP>
 class NetworkExchangeWgrad : public ExchangeWgrad {
  public:
@@ -43,8 +73,13 @@ class NetworkExchangeWgrad : public ExchangeWgrad {
   void init_ar_comm(const std::vector<void*>& ptr, size_t size) final;
   void update_embed_wgrad_size(size_t size) final;
   void allreduce(size_t device_id, cudaStream_t stream);
+  void init_buckets(const std::vector<std::pair<size_t, size_t>>& ranges) final;
+  void allreduce_bucket(size_t bucket, size_t device_id, cudaStream_t stream) final;
+  void init_shards(const std::vector<void*>& wgrad_ptrs, const std::vector<float*>& weight_ptrs,
+                   size_t num_weights) final;
+  void all_gather_weights(size_t device_id, cudaStream_t stream) final;
   NetworkExchangeWgrad(const std::shared_ptr<ResourceManager>& resource_manager);
-  ~NetworkExchangeWgrad() = default;
+  ~NetworkExchangeWgrad();
 
  private:
   // TODO remove them after hybrid embedding is deprecated
@@ -53,6 +88,10 @@ class NetworkExchangeWgrad : public ExchangeWgrad {
   std::shared_ptr<ResourceManager> resource_manager_;
 
   AllReduceInPlaceComm::Handle ar_handle_;
+  std::vector<void*> wgrad_ptrs_;
+  std::vector<AllReduceInPlaceComm::Handle> bucket_handles_;
+  // per GPU: the ready event of each bucket, then the completion of the last one
+  std::vector<std::vector<cudaEvent_t>> bucket_events_;
 
   size_t network_wgrad_size_ = 0;
   size_t num_gpus_ = 0;
@@ -67,6 +106,11 @@ class GroupedExchangeWgrad : public ExchangeWgrad {
   void init_ar_comm(const std::vector<void*>& ptr, size_t size) final;
   void update_embed_wgrad_size(size_t size) final;
   void allreduce(size_t device_id, cudaStream_t stream);
+  void init_buckets(const std::vector<std::pair<size_t, size_t>>& ranges) final;
+  void allreduce_bucket(size_t bucket, size_t device_id, cudaStream_t stream) final;
+  void init_shards(const std::vector<void*>& wgrad_ptrs, const std::vector<float*>& weight_ptrs,
+                   size_t num_weights) final;
+  void all_gather_weights(size_t device_id, cudaStream_t stream) final;
   GroupedExchangeWgrad(const std::shared_ptr<ResourceManager>& resource_manager);
   ~GroupedExchangeWgrad() = default;
 
@@ -83,4 +127,33 @@ class GroupedExchangeWgrad : public ExchangeWgrad {
   size_t embed_wgrad_size_ = 0;
   size_t num_gpus_ = 0;
 };
+
+/**
+ * Exchanges the dense wgrads for an optimizer that is sharded across all the GPUs (ZeRO stage 1):
+ * allreduce() reduce-scatters the wgrads, so that each GPU only gets the sum of the wgrads of its
+ * own shard, and all_gather_weights() broadcasts the shard of each GPU once it is updated.
+ */
+template <typename TypeFP>
+class ShardedExchangeWgrad : public ExchangeWgrad {
+ public:
+  void init_ar_comm(const std::vector<void*>& ptr, size_t size) final;
+  void update_embed_wgrad_size(size_t size) final;
+  void allreduce(size_t device_id, cudaStream_t stream) final;
+  void init_buckets(const std::vector<std::pair<size_t, size_t>>& ranges) final;
+  void allreduce_bucket(size_t bucket, size_t device_id, cudaStream_t stream) final;
+  void init_shards(const std::vector<void*>& wgrad_ptrs, const std::vector<float*>& weight_ptrs,
+                   size_t num_weights) final;
+  void all_gather_weights(size_t device_id, cudaStream_t stream) final;
+  ShardedExchangeWgrad(const std::shared_ptr<ResourceManager>& resource_manager);
+  ~ShardedExchangeWgrad() = default;
+
+ private:
+  std::shared_ptr<ResourceManager> resource_manager_;
+
+  std::vector<TypeFP*> wgrad_ptrs_;
+  std::vector<float*> weight_ptrs_;
+
+  size_t num_weights_ = 0;
+  size_t num_gpus_ = 0;
+};
 }  // namespace HugeCTR
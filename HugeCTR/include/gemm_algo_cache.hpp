@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cublasLt.h>
+#include <cublas_v2.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Process-wide cache of the GEMM algorithms picked by the algorithm search, so that the other
+ * GPUs of a process, the other processes and later runs take them instead of timing the
+ * candidates again. It can be loaded from and saved to a file.
+ *
+ * An entry is keyed by the GEMM and by the current GPU (name, compute capability, SM count),
+ * driver and cuBLASLt versions, since an algorithm is neither valid nor the fastest on others.
+ * The cache is disabled until load() is called, so find() misses and insert() is a no-op.
+ */
+class GemmAlgoCache {
+  mutable std::mutex mutex_;
+  bool enabled_ = false;
+  std::string path_;
+  std::map<std::string, std::string> entries_;  // key to the hex bytes of the algorithm
+
+  GemmAlgoCache() = default;
+
+  bool find(const std::string& gemm, void* algo, size_t size) const;
+  void insert(const std::string& gemm, const void* algo, size_t size);
+
+ public:
+  static GemmAlgoCache& get();
+
+  GemmAlgoCache(const GemmAlgoCache&) = delete;
+  GemmAlgoCache& operator=(const GemmAlgoCache&) = delete;
+
+  /**
+   * Enables the cache and adds the entries of \p path if the file exists.
+   */
+  void load(const std::string& path);
+  /**
+   * Writes all the entries to the file given to load(). The file is replaced atomically.
+   */
+  void save() const;
+
+  bool enabled() const { return enabled_; }
+
+  std::string serialize() const;
+  void deserialize(const std::string& entries);
+
+  /**
+   * Looks up the cuBLASLt algorithm of a GEMM, which is discarded if it does not pass
+   * cublasLtMatmulAlgoCheck or needs more than \p workspace_size bytes of workspace.
+   */
+  bool find(cublasLtHandle_t handle, cublasLtMatmulDesc_t op_desc, cublasLtMatrixLayout_t a_desc,
+            cublasLtMatrixLayout_t b_desc, cublasLtMatrixLayout_t c_desc,
+            cublasLtMatrixLayout_t d_desc, size_t workspace_size, cublasLtMatmulAlgo_t* algo) const;
+  void insert(cublasLtMatmulDesc_t op_desc, cublasLtMatrixLayout_t a_desc,
+              cublasLtMatrixLayout_t b_desc, cublasLtMatrixLayout_t c_desc,
+              cublasLtMatrixLayout_t d_desc, size_t workspace_size,
+              const cublasLtMatmulAlgo_t& algo);
+
+  /**
+   * Looks up the algorithm of a cublasGemmEx call, described by its transposes, sizes and data
+   * types.
+   */
+  bool find(const std::vector<int64_t>& gemm_ex, cublasGemmAlgo_t* algo) const;
+  void insert(const std::vector<int64_t>& gemm_ex, cublasGemmAlgo_t algo);
+};
+
+}  // namespace HugeCTR
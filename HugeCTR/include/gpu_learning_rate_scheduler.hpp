@@ -22,6 +22,11 @@
 
 namespace HugeCTR {
 
+/**
+ * The learning rate schedule of LearningRateScheduler, kept in device memory and advanced by a
+ * kernel, so that the update kernels read the learning rate through a pointer and a training step
+ * does not need to set it from the host.
+ */
 class GpuLearningRateScheduler {
   const float base_lr_;
   const size_t warmup_steps_;
@@ -29,6 +34,8 @@ class GpuLearningRateScheduler {
   const size_t decay_steps_;
   const float decay_power_;
   const float end_lr_;
+  const LrPolicy_t policy_;
+  const float decay_rate_;
   size_t* step_;
   float* current_lr_;
   float* last_lr_;
@@ -37,9 +44,11 @@ class GpuLearningRateScheduler {
  public:
   GpuLearningRateScheduler(float base_lr, size_t warmup_steps, size_t decay_start,
                            size_t decay_steps, float decay_power, float end_lr,
-                           const std::shared_ptr<GPUResource>& gpu_resource);
+                           const std::shared_ptr<GPUResource>& gpu_resource,
+                           LrPolicy_t policy = LrPolicy_t::fixed, float decay_rate = 0.1f);
   ~GpuLearningRateScheduler();
 
+  // Advances the schedule by one step on the stream of the GPU
   void update();
 
   float* get_learning_rate() const;
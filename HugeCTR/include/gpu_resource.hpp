@@ -40,6 +40,7 @@ class GPUResource {
   cudaStream_t p2p_stream_;    /**< cuda stream for broadcast copy */
   curandGenerator_t replica_uniform_curand_generator_;
   curandGenerator_t replica_variant_curand_generator_;
+  unsigned long long replica_uniform_seed_;
   cublasHandle_t cublas_handle_;
   cublasHandle_t cublas_handle_wgrad_;
   cudnnHandle_t cudnn_handle_;
@@ -88,6 +89,8 @@ class GPUResource {
   const curandGenerator_t& get_replica_variant_curand_generator() const {
     return replica_variant_curand_generator_;
   }
+  // Same on all the GPUs, for the random values that must not depend on the placement
+  unsigned long long get_replica_uniform_seed() const { return replica_uniform_seed_; }
   const cublasHandle_t& get_cublas_handle() const { return cublas_handle_; }
   const cublasHandle_t& get_cublas_handle_wgrad() const { return cublas_handle_wgrad_; }
   const cublasLtHandle_t& get_cublaslt_handle() const { return cublaslt_handle_; }
@@ -98,6 +101,8 @@ class GPUResource {
   int get_cc_major() const { return cc_major_; }
   int get_cc_minor() const { return cc_minor_; }
   bool support_nccl() const { return comm_ != nullptr; }
+  // Replaces the NCCL communicator, the previous one is aborted or destroyed by the caller.
+  void set_nccl(const ncclComm_t& comm) { comm_ = comm; }
 
   void set_wgrad_event_sync(const cudaStream_t& sync_stream) const;
   void wait_on_wgrad_event(const cudaStream_t& sync_stream) const;
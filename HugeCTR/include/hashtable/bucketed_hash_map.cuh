@@ -0,0 +1,416 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cooperative_groups.h>
+#include <cuda_runtime.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace HugeCTR {
+
+namespace bucketed_hash_map {
+
+namespace cg = cooperative_groups;
+
+/**
+ * Keys are stored as 64-bit words, whatever their type, so that every key type is claimed with the
+ * same 64-bit CAS and a bucket of kBucketSize slots spans one 64-byte segment. The packing maps
+ * std::numeric_limits<Key>::max(), the reserved empty key, to all ones, so that an empty table is
+ * a memset to 0xff.
+ */
+template <typename Key>
+struct KeyPacker {
+  static_assert(std::is_integral_v<Key> && sizeof(Key) <= sizeof(uint64_t),
+                "Keys must be integers of at most 64 bits");
+
+  using UnsignedKey = std::make_unsigned_t<Key>;
+
+  static constexpr uint64_t mask =
+      ~static_cast<uint64_t>(static_cast<UnsignedKey>(std::numeric_limits<Key>::max()));
+  static constexpr uint64_t empty = ~uint64_t{0};
+
+  __forceinline__ __host__ __device__ static uint64_t pack(Key key) {
+    return static_cast<uint64_t>(static_cast<UnsignedKey>(key)) ^ mask;
+  }
+  __forceinline__ __host__ __device__ static Key unpack(uint64_t word) {
+    return static_cast<Key>(word ^ mask);
+  }
+};
+
+// MurmurHash3 64-bit finalizer
+__forceinline__ __host__ __device__ uint64_t hash(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+__forceinline__ __device__ uint64_t load_volatile(const uint64_t* ptr) {
+  return *reinterpret_cast<const volatile uint64_t*>(ptr);
+}
+
+/**
+ * Device-side view of a BucketedHashMap. The slots are grouped into buckets of kBucketSize, and a
+ * key is handled by a tile of kBucketSize threads: each thread of the tile looks at one slot of the
+ * bucket, and the tile moves on to the next bucket (linear probing over buckets) only if the whole
+ * bucket is full. Because the lookups stop at the first bucket with an empty slot, erase() does
+ * not leave tombstones behind but rebuilds the table, see BucketedHashMap::erase().
+ */
+template <typename Key, typename Value, int kBucketSize = 8>
+struct BucketedHashMapView {
+  using Packer = KeyPacker<Key>;
+  static constexpr Value empty_value = std::numeric_limits<Value>::max();
+
+  uint64_t* keys;
+  Value* values;
+  size_t num_buckets;
+
+  __forceinline__ __device__ size_t first_bucket(uint64_t packed) const {
+    return hash(packed) % num_buckets;
+  }
+
+  /**
+   * Returns the slot of the key, or num_buckets * kBucketSize if it is not in the map. Every
+   * thread of the tile gets the same result.
+   */
+  template <typename Tile>
+  __device__ size_t find(const Tile& tile, Key key) const {
+    const uint64_t packed = Packer::pack(key);
+    size_t bucket = first_bucket(packed);
+    for (size_t probe = 0; probe < num_buckets; ++probe) {
+      const size_t slot = bucket * kBucketSize + tile.thread_rank();
+      const uint64_t existing = load_volatile(keys + slot);
+      const uint32_t match = tile.ballot(existing == packed);
+      if (match) {
+        return bucket * kBucketSize + __ffs(match) - 1;
+      }
+      if (tile.any(existing == Packer::empty)) {
+        break;
+      }
+      bucket = (bucket + 1) == num_buckets ? 0 : bucket + 1;
+    }
+    return num_buckets * kBucketSize;
+  }
+
+  /**
+   * Finds the slot of the key or claims a new one. Returns the slot and whether this tile claimed
+   * it, or num_buckets * kBucketSize if the map is full. Concurrent calls with the same key end up
+   * in the same slot, because every tile tries the empty slots of a bucket in ascending order.
+   */
+  template <typename Tile>
+  __device__ size_t find_or_claim(const Tile& tile, Key key, bool& claimed) const {
+    const uint64_t packed = Packer::pack(key);
+    size_t bucket = first_bucket(packed);
+    claimed = false;
+    for (size_t probe = 0; probe < num_buckets; ++probe) {
+      const size_t slot = bucket * kBucketSize + tile.thread_rank();
+      const uint64_t existing = load_volatile(keys + slot);
+      const uint32_t match = tile.ballot(existing == packed);
+      if (match) {
+        return bucket * kBucketSize + __ffs(match) - 1;
+      }
+      uint32_t empty = tile.ballot(existing == Packer::empty);
+      while (empty) {
+        const int leader = __ffs(empty) - 1;
+        uint64_t previous = 0;
+        if (tile.thread_rank() == leader) {
+          previous = atomicCAS(reinterpret_cast<unsigned long long*>(keys + slot),
+                               static_cast<unsigned long long>(Packer::empty),
+                               static_cast<unsigned long long>(packed));
+        }
+        previous = tile.shfl(previous, leader);
+        if (previous == Packer::empty || previous == packed) {
+          claimed = previous == Packer::empty;
+          return bucket * kBucketSize + leader;
+        }
+        empty &= ~(1u << leader);
+      }
+      bucket = (bucket + 1) == num_buckets ? 0 : bucket + 1;
+    }
+    return num_buckets * kBucketSize;
+  }
+
+  // Waits for the tile that claimed the slot to publish its value
+  __forceinline__ __device__ Value wait_for_value(size_t slot) const {
+    Value value;
+    do {
+      value = *reinterpret_cast<const volatile Value*>(values + slot);
+    } while (value == empty_value);
+    return value;
+  }
+};
+
+namespace kernels {
+
+// One tile of kBucketSize threads per key
+template <int kBucketSize>
+__forceinline__ __device__ size_t tile_index() {
+  return (static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x) / kBucketSize;
+}
+
+template <typename Key, typename Value, int kBucketSize>
+__global__ void insert_or_assign(BucketedHashMapView<Key, Value, kBucketSize> map,
+                                 const Key* keys, const Value* values, size_t len) {
+  auto tile = cg::tiled_partition<kBucketSize>(cg::this_thread_block());
+  const size_t i = tile_index<kBucketSize>();
+  if (i >= len) return;
+  bool claimed;
+  const size_t slot = map.find_or_claim(tile, keys[i], claimed);
+  assert(slot < map.num_buckets * kBucketSize && "error: insert fails: table is full");
+  if (tile.thread_rank() == 0) {
+    map.values[slot] = values[i];
+  }
+}
+
+template <typename Key, typename Value, int kBucketSize>
+__global__ void find(BucketedHashMapView<Key, Value, kBucketSize> map, const Key* keys,
+                     Value* values, size_t len) {
+  auto tile = cg::tiled_partition<kBucketSize>(cg::this_thread_block());
+  const size_t i = tile_index<kBucketSize>();
+  if (i >= len) return;
+  const size_t slot = map.find(tile, keys[i]);
+  if (tile.thread_rank() == 0) {
+    values[i] = slot < map.num_buckets * kBucketSize ? map.values[slot] : map.empty_value;
+  }
+}
+
+// Keys that are not found get the next value of the counter
+template <typename Key, typename Value, int kBucketSize>
+__global__ void find_or_insert(BucketedHashMapView<Key, Value, kBucketSize> map, const Key* keys,
+                               Value* values, size_t len, size_t* counter) {
+  auto tile = cg::tiled_partition<kBucketSize>(cg::this_thread_block());
+  const size_t i = tile_index<kBucketSize>();
+  if (i >= len) return;
+  bool claimed;
+  const size_t slot = map.find_or_claim(tile, keys[i], claimed);
+  assert(slot < map.num_buckets * kBucketSize && "error: get_insert fails: table is full");
+  if (tile.thread_rank() == 0) {
+    if (claimed) {
+      const Value value = static_cast<Value>(
+          atomicAdd(reinterpret_cast<unsigned long long*>(counter), 1ULL));
+      *reinterpret_cast<volatile Value*>(map.values + slot) = value;
+      values[i] = value;
+    } else {
+      values[i] = map.wait_for_value(slot);
+    }
+  }
+}
+
+template <typename Key, typename Value, int kBucketSize>
+__global__ void mark_erased(BucketedHashMapView<Key, Value, kBucketSize> map, const Key* keys,
+                            size_t len) {
+  auto tile = cg::tiled_partition<kBucketSize>(cg::this_thread_block());
+  const size_t i = tile_index<kBucketSize>();
+  if (i >= len) return;
+  const size_t slot = map.find(tile, keys[i]);
+  if (tile.thread_rank() == 0 && slot < map.num_buckets * kBucketSize) {
+    map.values[slot] = map.empty_value;
+  }
+}
+
+// Occupied slots, erased slots excluded
+template <typename Key, typename Value, int kBucketSize>
+__global__ void count(BucketedHashMapView<Key, Value, kBucketSize> map, size_t* size) {
+  using Packer = KeyPacker<Key>;
+  __shared__ unsigned long long block_count;
+  if (threadIdx.x == 0) block_count = 0;
+  __syncthreads();
+  const size_t slot = static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+  const bool occupied = slot < map.num_buckets * kBucketSize &&
+                        map.keys[slot] != Packer::empty && map.values[slot] != map.empty_value;
+  const uint32_t warp_count = __popc(__ballot_sync(0xffffffff, occupied));
+  if ((threadIdx.x & 31) == 0 && warp_count) {
+    atomicAdd(&block_count, static_cast<unsigned long long>(warp_count));
+  }
+  __syncthreads();
+  if (threadIdx.x == 0 && block_count) {
+    atomicAdd(reinterpret_cast<unsigned long long*>(size), block_count);
+  }
+}
+
+// Compacts the occupied slots into keys/values, counter is the number of pairs written so far
+template <typename Key, typename Value, int kBucketSize>
+__global__ void dump(BucketedHashMapView<Key, Value, kBucketSize> map, Key* keys, Value* values,
+                     size_t* counter) {
+  using Packer = KeyPacker<Key>;
+  __shared__ unsigned long long block_offset;
+  __shared__ unsigned int block_count;
+  if (threadIdx.x == 0) block_count = 0;
+  __syncthreads();
+  const size_t slot = static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+  uint64_t packed = Packer::empty;
+  Value value = map.empty_value;
+  if (slot < map.num_buckets * kBucketSize) {
+    packed = map.keys[slot];
+    value = map.values[slot];
+  }
+  const bool occupied = packed != Packer::empty && value != map.empty_value;
+  unsigned int local = 0;
+  if (occupied) local = atomicAdd(&block_count, 1u);
+  __syncthreads();
+  if (threadIdx.x == 0 && block_count) {
+    block_offset = atomicAdd(reinterpret_cast<unsigned long long*>(counter),
+                             static_cast<unsigned long long>(block_count));
+  }
+  __syncthreads();
+  if (occupied) {
+    keys[block_offset + local] = Packer::unpack(packed);
+    values[block_offset + local] = value;
+  }
+}
+
+}  // namespace kernels
+
+/**
+ * Host-side owner of a bucketed open-addressing map on the current device. The bulk operations
+ * are asynchronous on the given stream. std::numeric_limits<Key>::max() cannot be used as a key,
+ * and std::numeric_limits<Value>::max() cannot be used as a value.
+ */
+template <typename Key, typename Value, int kBucketSize = 8>
+class BucketedHashMap {
+  static_assert(kBucketSize > 0 && kBucketSize <= 32 && (kBucketSize & (kBucketSize - 1)) == 0,
+                "The bucket size must be a power of 2 of at most a warp");
+  static_assert(sizeof(Value) == sizeof(unsigned long long),
+                "Values are published with 64-bit stores");
+
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using View = BucketedHashMapView<Key, Value, kBucketSize>;
+
+  static constexpr int bucket_size = kBucketSize;
+  static constexpr int block_size = 256;
+
+  // Allocates at least num_slots slots, rounded up to whole buckets
+  explicit BucketedHashMap(size_t num_slots) {
+    view_.num_buckets = std::max<size_t>((num_slots + kBucketSize - 1) / kBucketSize, 1);
+    check(cudaMalloc(reinterpret_cast<void**>(&view_.keys), this->num_slots() * sizeof(uint64_t)));
+    check(cudaMalloc(reinterpret_cast<void**>(&view_.values), this->num_slots() * sizeof(Value)));
+    check(cudaMalloc(reinterpret_cast<void**>(&d_scratch_counter_), sizeof(size_t)));
+    clear(0);
+    check(cudaStreamSynchronize(0));
+  }
+
+  ~BucketedHashMap() {
+    cudaFree(view_.keys);
+    cudaFree(view_.values);
+    cudaFree(d_scratch_counter_);
+  }
+
+  BucketedHashMap(const BucketedHashMap&) = delete;
+  BucketedHashMap& operator=(const BucketedHashMap&) = delete;
+
+  size_t num_slots() const { return view_.num_buckets * kBucketSize; }
+
+  const View& view() const { return view_; }
+
+  void clear(cudaStream_t stream) {
+    // The packed empty key and the empty value are both all ones
+    check(cudaMemsetAsync(view_.keys, 0xff, num_slots() * sizeof(uint64_t), stream));
+    check(cudaMemsetAsync(view_.values, 0xff, num_slots() * sizeof(Value), stream));
+  }
+
+  void insert_or_assign(const Key* d_keys, const Value* d_values, size_t len,
+                        cudaStream_t stream) {
+    if (len == 0) return;
+    kernels::insert_or_assign<<<tile_grid(len), block_size, 0, stream>>>(view_, d_keys, d_values,
+                                                                         len);
+  }
+
+  // Keys that are not in the map get std::numeric_limits<Value>::max()
+  void find(const Key* d_keys, Value* d_values, size_t len, cudaStream_t stream) const {
+    if (len == 0) return;
+    kernels::find<<<tile_grid(len), block_size, 0, stream>>>(view_, d_keys, d_values, len);
+  }
+
+  void find_or_insert(const Key* d_keys, Value* d_values, size_t len, size_t* d_counter,
+                      cudaStream_t stream) {
+    if (len == 0) return;
+    kernels::find_or_insert<<<tile_grid(len), block_size, 0, stream>>>(view_, d_keys, d_values,
+                                                                       len, d_counter);
+  }
+
+  // d_size is overwritten with the number of pairs in the map
+  void size(size_t* d_size, cudaStream_t stream) const {
+    check(cudaMemsetAsync(d_size, 0, sizeof(size_t), stream));
+    kernels::count<<<slot_grid(), block_size, 0, stream>>>(view_, d_size);
+  }
+
+  // d_counter is overwritten with the number of dumped pairs
+  void dump(Key* d_keys, Value* d_values, size_t* d_counter, cudaStream_t stream) const {
+    check(cudaMemsetAsync(d_counter, 0, sizeof(size_t), stream));
+    kernels::dump<<<slot_grid(), block_size, 0, stream>>>(view_, d_keys, d_values, d_counter);
+  }
+
+  /**
+   * Removes the keys from the map. The erased slots are compacted away and the remaining pairs
+   * are inserted again, so the probe sequences never run over tombstones. This costs a pass over
+   * the whole table and should be done in large batches.
+   */
+  void erase(const Key* d_keys, size_t len, cudaStream_t stream) {
+    if (len == 0) return;
+    kernels::mark_erased<<<tile_grid(len), block_size, 0, stream>>>(view_, d_keys, len);
+
+    Key* d_live_keys;
+    Value* d_live_values;
+    check(cudaMallocAsync(reinterpret_cast<void**>(&d_live_keys), num_slots() * sizeof(Key),
+                          stream));
+    check(cudaMallocAsync(reinterpret_cast<void**>(&d_live_values), num_slots() * sizeof(Value),
+                          stream));
+    dump(d_live_keys, d_live_values, d_scratch_counter_, stream);
+    size_t num_live;
+    check(cudaMemcpyAsync(&num_live, d_scratch_counter_, sizeof(size_t), cudaMemcpyDeviceToHost,
+                          stream));
+    check(cudaStreamSynchronize(stream));
+    clear(stream);
+    insert_or_assign(d_live_keys, d_live_values, num_live, stream);
+    check(cudaFreeAsync(d_live_keys, stream));
+    check(cudaFreeAsync(d_live_values, stream));
+  }
+
+ private:
+  View view_{};
+  size_t* d_scratch_counter_ = nullptr;
+
+  static void check(cudaError_t error) {
+    if (error != cudaSuccess) {
+      throw std::runtime_error(std::string("BucketedHashMap: ") + cudaGetErrorString(error));
+    }
+  }
+
+  static unsigned int tile_grid(size_t len) {
+    return static_cast<unsigned int>((len * kBucketSize + block_size - 1) / block_size);
+  }
+
+  unsigned int slot_grid() const {
+    return static_cast<unsigned int>((num_slots() + block_size - 1) / block_size);
+  }
+};
+
+}  // namespace bucketed_hash_map
+
+using bucketed_hash_map::BucketedHashMap;
+
+}  // namespace HugeCTR
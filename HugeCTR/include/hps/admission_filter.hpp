@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <hps/hot_key_set.hpp>
+#include <hps/inference_utils.hpp>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Decides which keys that missed the embedding cache are worth inserting. Keeps one-off keys (e.g.,
+ * scans by bots) from evicting the hot set of a table.
+ *
+ * - `Frequency`: Admits keys once they missed at least `threshold` times (count-min sketch).
+ * - `Probabilistic`: Admits each key with probability `threshold`.
+ * - `Doorkeeper`: Admits keys seen before since the last reset of a Bloom filter, which is reset
+ *   after `capacity` distinct keys.
+ *
+ * @tparam Key Data-type to be used for keys.
+ */
+template <typename Key>
+class AdmissionFilter {
+ public:
+  /**
+   * @param policy The admission policy.
+   * @param threshold Policy specific threshold (<= 0 = use the policy's default).
+   * @param capacity Number of keys that the embedding cache can hold.
+   */
+  AdmissionFilter(AdmissionPolicy_t policy, float threshold, size_t capacity);
+  AdmissionFilter(const AdmissionFilter&) = delete;
+  AdmissionFilter& operator=(const AdmissionFilter&) = delete;
+
+  AdmissionPolicy_t policy() const { return policy_; }
+  float threshold() const { return threshold_; }
+  size_t num_rejected_keys() const { return num_rejected_keys_; }
+
+  /**
+   * Filters a batch of keys that missed the embedding cache.
+   *
+   * @param keys The missing keys.
+   * @param num_keys Number of \p keys .
+   * @param admitted_indices Receives the (ascending) indices of the admitted keys.
+   *
+   * @return Number of admitted keys.
+   */
+  size_t admit(const Key* keys, size_t num_keys, uint64_t* admitted_indices);
+
+ private:
+  bool admit_key(Key key);
+
+  static constexpr size_t num_doorkeeper_hashes_{3};
+
+  AdmissionPolicy_t policy_;
+  float threshold_;
+
+  std::mutex mutex_;
+  std::unique_ptr<CountMinSketch> sketch_;
+  std::default_random_engine rng_;
+  std::uniform_real_distribution<float> dist_;
+  std::vector<uint64_t> doorkeeper_bits_;
+  size_t doorkeeper_capacity_;
+  size_t num_doorkeeper_keys_{0};
+
+  std::atomic<size_t> num_rejected_keys_{0};
+};
+
+}  // namespace HugeCTR
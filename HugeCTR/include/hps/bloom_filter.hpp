@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_runtime_api.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+namespace HugeCTR {
+
+/**
+ * Device-resident Bloom filter over the keys that the HPS database tiers can resolve. It is used
+ * by the embedding cache to separate brand-new keys from actual cache misses. The former can never
+ * be found by the parameter server and are answered with the default embedding vector right away.
+ *
+ * The filter must only be consulted after it was populated with *all* keys of the table (see
+ * `seal`). Until then, and after every `clear`, `is_sealed` returns false.
+ */
+template <typename Key>
+class BloomFilter {
+ public:
+  /**
+   * @param capacity Expected number of keys in the table.
+   * @param bits_per_key Number of filter bits to reserve per key.
+   * @param num_hashes Number of bits probed per key.
+   * @param max_query_length Maximum number of keys passed to `filter_missing`.
+   */
+  BloomFilter(size_t capacity, size_t bits_per_key, size_t num_hashes, size_t max_query_length);
+  ~BloomFilter();
+  BloomFilter(const BloomFilter&) = delete;
+  BloomFilter& operator=(const BloomFilter&) = delete;
+
+  size_t num_bits() const { return num_words_ * 32; }
+  size_t num_hashes() const { return num_hashes_; }
+  bool is_sealed() const { return sealed_.load(std::memory_order_acquire); }
+
+  /**
+   * Resets all bits. The filter will be ignored until it is sealed again.
+   */
+  void clear();
+
+  /**
+   * Adds keys to the filter.
+   *
+   * @param h_keys Keys residing in host memory.
+   * @param num_keys Number of keys.
+   */
+  void insert(const Key* h_keys, size_t num_keys);
+
+  /**
+   * Marks the filter as complete. From now on `filter_missing` will drop keys.
+   */
+  void seal() { sealed_.store(true, std::memory_order_release); }
+
+  /**
+   * Removes all keys that are definitely not in the table from the list of missing keys (in
+   * order) and fills their slots in `d_hit_emb_vec` with `default_value`.
+   *
+   * @param d_missing_keys Missing keys.
+   * @param d_missing_index Position of each missing key in `d_hit_emb_vec`.
+   * @param missing_length Number of missing keys.
+   * @param d_hit_emb_vec Embedding vector buffer.
+   * @param default_value Default value for absent keys.
+   * @param emb_vec_size Number of floats per embedding vector.
+   * @param stream The stream to use. Will be synchronized before returning.
+   *
+   * @return Number of missing keys that remain and need to be looked up.
+   */
+  size_t filter_missing(Key* d_missing_keys, uint64_t* d_missing_index, size_t missing_length,
+                        float* d_hit_emb_vec, float default_value, size_t emb_vec_size,
+                        cudaStream_t stream);
+
+ private:
+  static constexpr size_t insert_batch_size_{64 * 1024};
+  static constexpr size_t block_size_{256};
+
+  size_t num_words_;
+  size_t num_hashes_;
+  size_t max_query_length_;
+  uint32_t* d_bits_{nullptr};
+  std::atomic<bool> sealed_{false};
+
+  // Updates are staged through a dedicated stream so that they do not interfere with lookups.
+  std::mutex insert_mutex_;
+  cudaStream_t insert_stream_;
+  Key* d_insert_keys_{nullptr};
+
+  // Scratch space for compacting the remaining missing keys.
+  std::mutex filter_mutex_;
+  Key* d_remaining_keys_{nullptr};
+  uint64_t* d_remaining_index_{nullptr};
+  size_t* d_remaining_length_{nullptr};
+  size_t* h_remaining_length_{nullptr};
+};
+
+}  // namespace HugeCTR
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Shadow of the keys that recently missed the GPU embedding cache of a table. Every missing key is
+ * inserted into the cache, so a key that misses again while it is still among the last
+ * `capacity()` distinct missing keys has been evicted in the meantime. A cache with `capacity()`
+ * more slots would likely have kept it, so these ghost hits estimate what growing the cache by
+ * that much would gain.
+ */
+class CacheGhostList {
+ public:
+  explicit CacheGhostList(size_t capacity);
+
+  size_t capacity() const;
+  void set_capacity(size_t capacity);
+
+  // Accounts for the distinct keys that missed the cache in one lookup.
+  template <typename TypeHashKey>
+  void record(const TypeHashKey* keys, size_t num_keys);
+
+  // Ghost hits since the previous call.
+  size_t take_hits();
+
+ private:
+  void evict_excess();
+
+  mutable std::mutex mutex_;
+  size_t capacity_;
+  size_t hits_{0};
+  std::list<uint64_t> keys_;  // Most recent first
+  std::unordered_map<uint64_t, std::list<uint64_t>::iterator> positions_;
+};
+
+/**
+ * Moves GPU cache capacity from the table that gains the least per byte to the one that gains the
+ * most, keeping the total within the original budget.
+ *
+ * @param num_sets Sets of the cache of each table.
+ * @param set_bytes Bytes of one set of each table.
+ * @param gain_per_byte Estimated hits per byte of additional capacity of each table.
+ * @param step Fraction of the donor's capacity that is moved.
+ * @param min_gain_ratio Capacity only moves if the receiver gains this many times more per byte.
+ * @return The new number of sets of each table, equal to num_sets if nothing is moved.
+ */
+std::vector<size_t> rebalance_cache_sets(const std::vector<size_t>& num_sets,
+                                         const std::vector<size_t>& set_bytes,
+                                         const std::vector<double>& gain_per_byte, double step,
+                                         double min_gain_ratio = 2.0);
+
+}  // namespace HugeCTR
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Header of a cache key log file. Every table follows as the length of its name (uint32), the
+ * name, the number of keys (uint64) and the keys, stored as 64 bit like in the raw model.
+ */
+struct CacheKeyLogHeader final {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+  uint64_t num_tables;
+};
+
+/**
+ * The keys that the GPU embedding cache of a model held, so that a starting HPS instance can load
+ * them into its caches before serving, instead of starting cold. Tables are matched by name, so a
+ * log written by one replica can warm up any other replica of the same model.
+ *
+ * @tparam Key The key type of the embedding cache.
+ */
+template <typename Key>
+class CacheKeyLog final {
+ public:
+  // Reads a log written by write().
+  explicit CacheKeyLog(const std::string& path);
+
+  inline size_t num_tables() const { return keys_.size(); }
+
+  // The keys of a table, nullptr if the log does not have the table.
+  const std::vector<Key>* keys(const std::string& table_name) const;
+
+  /**
+   * Writes the keys of the tables. The log is written next to \p path and then renamed, so that
+   * other instances never read a partial log.
+   */
+  static void write(const std::string& path, const std::vector<std::string>& table_names,
+                    const std::vector<std::vector<Key>>& keys);
+
+ private:
+  std::unordered_map<std::string, std::vector<Key>> keys_;
+};
+
+}  // namespace HugeCTR
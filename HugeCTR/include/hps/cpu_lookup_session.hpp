@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <core23/instrumentation.hpp>
+#include <hps/hier_parameter_server_base.hpp>
+#include <hps/inference_utils.hpp>
+#include <memory>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Lookup session of GPU-less serving tiers, which queries the volatile and persistent database
+ * tiers of the parameter server directly into host memory, bypassing the embedding caches. The
+ * model may have an empty `deployed_devices` list, so that no GPU resources are created for it.
+ *
+ * The keys of a query are deduplicated first. The unique keys are split into partitions of at
+ * least `min_keys_per_partition` keys, which are fetched concurrently by the async lookup workers
+ * of the parameter server, and their vectors are then gathered to the positions of all the keys.
+ */
+class CpuLookupSession final {
+ public:
+  CpuLookupSession(const InferenceParams& inference_params,
+                   const std::shared_ptr<HierParameterServerBase>& parameter_server,
+                   const std::vector<size_t>& embedding_vec_size_per_table,
+                   size_t min_keys_per_partition = 1024);
+  CpuLookupSession(CpuLookupSession const&) = delete;
+  CpuLookupSession& operator=(CpuLookupSession const&) = delete;
+
+  /**
+   * Looks up \p num_keys keys of table \p table_id . \p h_keys are `long long` or `unsigned int`
+   * as per `InferenceParams::i64_input_key`, and \p h_vectors must hold `num_keys` vectors.
+   */
+  void lookup(const void* h_keys, float* h_vectors, size_t num_keys, size_t table_id);
+  void lookup(const std::vector<const void*>& h_keys_per_table,
+              const std::vector<float*>& h_vectors_per_table,
+              const std::vector<size_t>& num_keys_per_table);
+
+  const InferenceParams& get_inference_params() const { return inference_params_; }
+
+ private:
+  template <typename TypeHashKey>
+  void lookup_impl(const TypeHashKey* h_keys, float* h_vectors, size_t num_keys, size_t table_id);
+
+  const InferenceParams inference_params_;
+  const std::shared_ptr<HierParameterServerBase> parameter_server_;
+  const std::vector<size_t> embedding_vec_size_per_table_;
+  const size_t min_keys_per_partition_;
+
+  MetricCounter* num_keys_;
+  MetricCounter* num_unique_keys_;
+};
+
+}  // namespace HugeCTR
@@ -60,7 +60,8 @@ class DatabaseBackendBase {
 
   DatabaseBackendBase() = delete;
 
-  DatabaseBackendBase(size_t max_batch_size);
+  DatabaseBackendBase(size_t max_batch_size, size_t load_dump_num_threads = 1,
+                      bool load_dump_direct_io = false);
 
   virtual ~DatabaseBackendBase() = default;
 
@@ -224,6 +225,18 @@ class DatabaseBackendBase {
 
   virtual size_t dump_bin(const std::string& table_name, std::ofstream& file) = 0;
 
+  /**
+   * Appends the value size and the key/value pairs of a table to the raw dump at \p path , after
+   * its header. The default implementation streams them through \p dump_bin(table_name, file) .
+   * Backends override it to write parts of the table in parallel at their offsets in the file.
+   *
+   * @param table_name The name of the table to be dumped.
+   * @param path File system path of the dump, that already contains the header.
+   *
+   * @return The number of key/value pairs dumped.
+   */
+  virtual size_t dump_bin(const std::string& table_name, const std::string& path);
+
 #ifdef HCTR_USE_ROCKS_DB
   virtual size_t dump_sst(const std::string& table_name, rocksdb::SstFileWriter& file) = 0;
 #endif  // HCTR_USE_ROCKS_DB
@@ -236,17 +249,27 @@ class DatabaseBackendBase {
    */
   virtual size_t load_dump(const std::string& table_name, const std::string& path);
 
+  /**
+   * Loads a raw dump. The file is split into ranges of whole pairs, that \p load_dump_num_threads
+   * threads read with large positioned reads (optionally bypassing the page cache) and insert
+   * concurrently, batch by batch.
+   */
   virtual size_t load_dump_bin(const std::string& table_name, const std::string& path);
 
   virtual size_t load_dump_sst(const std::string& table_name, const std::string& path);
 
  private:
   const size_t max_batch_size_;  // Temporary, until find a better solution.
+  const size_t load_dump_num_threads_;
+  const bool load_dump_direct_io_;
 };
 
 struct DatabaseBackendParams {
   size_t max_batch_size{64L *
                         1024};  // Maximum number of key/value pairs per read/write transaction.
+  size_t load_dump_num_threads{
+      8};  // Number of threads that read and insert the pairs of a raw dump concurrently.
+  bool load_dump_direct_io{false};  // Read raw dumps with O_DIRECT, bypassing the page cache.
 };
 
 template <typename Key, typename Params>
@@ -258,7 +281,9 @@ class DatabaseBackend : public DatabaseBackendBase<Key> {
 
   DatabaseBackend() = delete;
 
-  DatabaseBackend(const Params& params) : Base(params.max_batch_size), params_{params} {}
+  DatabaseBackend(const Params& params)
+      : Base(params.max_batch_size, params.load_dump_num_threads, params.load_dump_direct_io),
+        params_{params} {}
 
   virtual ~DatabaseBackend() = default;
 
@@ -18,7 +18,9 @@
 #include <rocksdb/db.h>
 
 #include <cstdint>
+#include <numeric>
 #include <type_traits>
+#include <vector>
 
 namespace HugeCTR {
 
@@ -63,6 +65,33 @@ inline uint64_t rrxmrrxmsx_0(uint64_t x) {
 #endif
 #define HCTR_HPS_KEY_TO_PART_INDEX_(KEY) (rrxmrrxmsx_0(KEY) % num_partitions)
 
+/**
+ * Groups keys by the partition they belong to (counting sort). Upon return, the indices of all keys
+ * that belong to partition `p` are stored in `grouped_indices[part_offsets[p]]` to
+ * `grouped_indices[part_offsets[p + 1] - 1]`. If `indices` is non-null, only the keys referenced
+ * by `indices` are considered (indirect mode).
+ */
+template <typename Key>
+inline void group_by_partition(const size_t num_partitions, const size_t num_indices,
+                               const size_t* const indices, const Key* const keys,
+                               std::vector<size_t>& part_offsets,
+                               std::vector<size_t>& grouped_indices) {
+  std::vector<size_t> part_indices(num_indices);
+  part_offsets.assign(num_partitions + 1, 0);
+  for (size_t j{0}; j < num_indices; ++j) {
+    const size_t part_index{HCTR_HPS_KEY_TO_PART_INDEX_(keys[indices ? indices[j] : j])};
+    part_indices[j] = part_index;
+    ++part_offsets[part_index + 1];
+  }
+  std::partial_sum(part_offsets.begin(), part_offsets.end(), part_offsets.begin());
+
+  std::vector<size_t> cursors(part_offsets.begin(), part_offsets.end() - 1);
+  grouped_indices.resize(num_indices);
+  for (size_t j{0}; j < num_indices; ++j) {
+    grouped_indices[cursors[part_indices[j]]++] = indices ? indices[j] : j;
+  }
+}
+
 /**
  * Time budget checking and resolution.
  */
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <hps/database_backend.hpp>
+#include <hps/hash_map_backend.hpp>
+#include <hps/ibv_rpc.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace HugeCTR {
+
+// TODO: Remove me!
+#pragma GCC diagnostic push
+#pragma GCC diagnostic error "-Wconversion"
+
+struct DistributedHashMapBackendParams final : public VolatileBackendParams {
+  // Storage of the local shard (see \p HashMapBackendParams ).
+  size_t allocation_rate{256L * 1024 * 1024};
+  size_t value_page_size{0};
+  int numa_node{-1};
+
+  std::vector<std::string> hosts;  // "host:port" of every inference host that shares the tables,
+                                   // in the same order on all hosts.
+  size_t rank{0};                  // Index of this host in `hosts`.
+  std::string ib_device{"mlx5_0"};  // InfiniBand or RoCE device to connect the hosts with.
+  uint8_t ib_port{1};               // Port of `ib_device`.
+  size_t message_size{16L * 1024 * 1024};  // Maximum size of a request or response. Larger
+                                           // batches are split. Each host registers 4 buffers of
+                                           // this size per other host.
+  size_t connect_timeout{300};  // Seconds to wait for the other hosts to start.
+};
+
+#ifdef HCTR_USE_RDMA
+
+/**
+ * \p DatabaseBackend implementation that shards the tables across a set of inference hosts. Each
+ * key is owned by one host, which stores it in a local \p HashMapBackend . Keys owned by other
+ * hosts are looked up, inserted and evicted with requests over InfiniBand or RoCE (see
+ * \p IbvRpcEndpoint ), batched per host and sent to all the hosts at once.
+ *
+ * The set of hosts is fixed. All of them must be started with the same `hosts` and
+ * `num_partitions`. Dumps only contain the shard of this host.
+ *
+ * @tparam Key The data-type that is used for keys in this database.
+ */
+template <typename Key>
+class DistributedHashMapBackend final
+    : public VolatileBackend<Key, DistributedHashMapBackendParams> {
+ public:
+  using Base = VolatileBackend<Key, DistributedHashMapBackendParams>;
+
+  HCTR_DISALLOW_COPY_AND_MOVE(DistributedHashMapBackend);
+
+  DistributedHashMapBackend() = delete;
+
+  /**
+   * Construct a new DistributedHashMapBackend object, which connects to the other hosts.
+   */
+  DistributedHashMapBackend(const DistributedHashMapBackendParams& params);
+
+  const char* get_name() const override { return "DistributedHashMap"; }
+
+  bool is_shared() const override { return true; }
+
+  size_t size(const std::string& table_name) const override;
+
+  size_t contains(const std::string& table_name, size_t num_keys, const Key* keys,
+                  const std::chrono::nanoseconds& time_budget) const override;
+
+  size_t insert(const std::string& table_name, size_t num_pairs, const Key* keys,
+                const char* values, uint32_t value_size, size_t value_stride) override;
+
+  size_t fetch(const std::string& table_name, size_t num_keys, const Key* keys, char* values,
+               size_t value_stride, const DatabaseMissCallback& on_miss,
+               const std::chrono::nanoseconds& time_budget) override;
+
+  size_t fetch(const std::string& table_name, size_t num_indices, const size_t* indices,
+               const Key* keys, char* values, size_t value_stride,
+               const DatabaseMissCallback& on_miss,
+               const std::chrono::nanoseconds& time_budget) override;
+
+  size_t evict(const std::string& table_name) override;
+
+  size_t evict(const std::string& table_name, size_t num_keys, const Key* keys) override;
+
+  std::vector<std::string> find_tables(const std::string& model_name) override;
+
+  size_t dump_bin(const std::string& table_name, std::ofstream& file) override;
+
+  size_t dump_bin(const std::string& table_name, const std::string& path) override;
+
+#ifdef HCTR_USE_ROCKS_DB
+  size_t dump_sst(const std::string& table_name, rocksdb::SstFileWriter& file) override;
+#endif  // HCTR_USE_ROCKS_DB
+
+  /**
+   * @return The index of the host that owns \p key .
+   */
+  size_t owner_of(Key key) const;
+
+ protected:
+  /**
+   * Groups the keys by owner, like \p group_by_partition .
+   */
+  void group_by_owner_(size_t num_indices, const size_t* indices, const Key* keys,
+                       std::vector<size_t>& host_offsets,
+                       std::vector<size_t>& grouped_indices) const;
+
+  /**
+   * @return The other hosts that own some of the grouped keys, all of them if \p host_offsets is
+   * empty.
+   */
+  std::vector<size_t> peers_with_keys_(const std::vector<size_t>& host_offsets) const;
+
+  /**
+   * Sends requests to the hosts in \p peers in rounds, until \p make_request returns 0 for all of
+   * them, and does \p local_work while the first round is in flight.
+   *
+   * @param make_request Writes the next request to a host, returns its size.
+   * @param on_response Handles the response of a host.
+   */
+  void exchange_(const std::vector<size_t>& peers,
+                 const std::function<size_t(size_t peer, char* request)>& make_request,
+                 const std::function<void()>& local_work,
+                 const std::function<void(size_t peer, const char* response)>& on_response) const;
+
+  size_t fetch_(const std::string& table_name, size_t num_indices, const size_t* indices,
+                const Key* keys, char* values, size_t value_stride,
+                const DatabaseMissCallback& on_miss, const std::chrono::nanoseconds& time_budget);
+
+  /**
+   * Serves a request of another host with the local shard.
+   */
+  size_t handle_request_(const char* request, size_t request_size, char* response,
+                         size_t max_response_size);
+
+ protected:
+  std::unique_ptr<HashMapBackend<Key>> local_;  // Shard of this host
+  std::unique_ptr<IbvRpcEndpoint> endpoint_;    // Null with a single host
+};
+
+#endif  // HCTR_USE_RDMA
+
+// TODO: Remove me!
+#pragma GCC diagnostic pop
+
+}  // namespace HugeCTR
@@ -17,11 +17,17 @@
 
 #include <cuda_runtime_api.h>
 
+#include <core23/instrumentation.hpp>
+#include <hps/bloom_filter.hpp>
+#include <hps/cache_capacity_balancer.hpp>
 #include <hps/embedding_cache_base.hpp>
 #include <hps/embedding_cache_gpu.hpp>
+#include <hps/hit_rate_threshold_controller.hpp>
+#include <hps/hot_key_set.hpp>
 #include <hps/inference_utils.hpp>
 #include <hps/memory_pool.hpp>
 #include <hps/unique_op/unique_op.hpp>
+#include <map>
 #include <memory>
 #include <nv_gpu_cache.hpp>
 #include <thread_pool.hpp>
@@ -46,6 +52,8 @@ class EmbeddingCache : public EmbeddingCacheBase,
                                   size_t num_keys, float hit_rate_threshold, cudaStream_t stream);
   virtual void lookup_from_device(size_t table_id, float* d_vectors, MemoryBlock* memory_block,
                                   size_t num_keys, float hit_rate_threshold, cudaStream_t stream);
+  virtual bool lookup_from_device_capturable(size_t table_id, float* d_vectors, const void* d_keys,
+                                             size_t num_keys, cudaStream_t stream);
   virtual void insert(size_t table_id, EmbeddingCacheWorkspace& workspace_handler,
                       cudaStream_t stream);
 
@@ -58,8 +66,17 @@ class EmbeddingCache : public EmbeddingCacheBase,
                     size_t end_index, cudaStream_t stream);
   virtual void refresh(size_t table_id, const void* d_keys, const void* d_vectors, size_t length,
                        cudaStream_t stream);
+  virtual void load_from_device(size_t table_id, const void* d_keys, const float* d_vectors,
+                                size_t num_keys, cudaStream_t stream);
   virtual void finalize();
 
+  virtual void clear_bloom_filter(size_t table_id);
+  virtual void insert_bloom_filter(size_t table_id, const void* h_keys, size_t num_keys);
+  virtual void seal_bloom_filter(size_t table_id);
+  virtual void refresh_hot_keys(size_t table_id, cudaStream_t stream);
+  virtual void rebalance_capacity();
+  virtual size_t conflict_evictions(size_t table_id);
+
   virtual EmbeddingCacheWorkspace create_workspace();
   virtual void destroy_workspace(EmbeddingCacheWorkspace&);
   virtual EmbeddingCacheRefreshspace create_refreshspace();
@@ -73,14 +90,33 @@ class EmbeddingCache : public EmbeddingCacheBase,
   virtual void set_profiler(int iteration, int warmup, bool enable_bench) {
     ec_profiler_->set_config(iteration, warmup, enable_bench);
   };
-  virtual void profiler_print() { ec_profiler_->print(); };
+  virtual void profiler_print();
 
  private:
   static const size_t BLOCK_SIZE_ = 64;
+  static const size_t BLOOM_FILTER_BITS_PER_KEY_ = 10;
+  static const size_t BLOOM_FILTER_NUM_HASHES_ = 7;
 
+  template <int set_associativity>
   using NVCache =
       gpu_cache::gpu_cache<TypeHashKey, uint64_t, std::numeric_limits<TypeHashKey>::max(),
-                           SET_ASSOCIATIVITY, SLAB_SIZE>;
+                           set_associativity, SLAB_SIZE>;
+  // Creates the dynamic cache of a table, or attaches to the one of the owner process
+  template <int set_associativity>
+  std::unique_ptr<gpu_cache::gpu_cache_api<TypeHashKey>> create_nv_cache(size_t table_id,
+                                                                         size_t num_set,
+                                                                         size_t emb_vec_size);
+  std::unique_ptr<gpu_cache::gpu_cache_api<TypeHashKey>> create_table_cache(size_t table_id,
+                                                                            size_t num_set);
+  // The cache of a table. It is replaced when the capacity is rebalanced, so callers keep the
+  // returned pointer for as long as they use it.
+  std::shared_ptr<gpu_cache::gpu_cache_api<TypeHashKey>> table_cache(size_t table_id) const {
+    return std::atomic_load(&gpu_emb_caches_[table_id]);
+  }
+  // Replaces the cache of a table by one of num_set sets, holding the keys of the old one that fit.
+  void resize_table_cache(size_t table_id, size_t num_set);
+  size_t ghost_list_capacity(size_t table_id) const;
+
   using UniqueOp =
       unique_op::unique_op<TypeHashKey, uint64_t, std::numeric_limits<TypeHashKey>::max(),
                            std::numeric_limits<uint64_t>::max()>;
@@ -92,7 +128,24 @@ class EmbeddingCache : public EmbeddingCacheBase,
   embedding_cache_config cache_config_;
 
   // The shared thread-safe embedding cache
-  std::vector<std::unique_ptr<gpu_cache::gpu_cache_api<TypeHashKey>>> gpu_emb_caches_;
+  std::vector<std::shared_ptr<gpu_cache::gpu_cache_api<TypeHashKey>>> gpu_emb_caches_;
+
+  // Files through which the caches are published to reader processes (owner only)
+  std::vector<std::string> shared_cache_handle_files_;
+
+  // Bloom filters over the keys known to the parameter server, 1 per embedding table (optional)
+  std::vector<std::unique_ptr<BloomFilter<TypeHashKey>>> bloom_filters_;
+
+  // The hottest keys, which are kept outside of the evicting GPU cache, 1 per table (optional)
+  std::vector<std::unique_ptr<HotKeySet<TypeHashKey>>> hot_key_sets_;
+
+  // Recently missing keys, estimating the gain of a larger cache, 1 per embedding table (only if
+  // the capacity is rebalanced)
+  std::vector<std::unique_ptr<CacheGhostList>> ghost_lists_;
+  float rebalance_percentage_{0};
+
+  // Learned hit rate thresholds, 1 per embedding table (optional)
+  std::vector<std::unique_ptr<HitRateThresholdController>> hit_rate_threshold_controllers_;
 
   // streams for asynchronous parameter server insert threads
   std::vector<cudaStream_t> insert_streams_;
@@ -111,6 +164,36 @@ class EmbeddingCache : public EmbeddingCacheBase,
 
   // benchmark profiler
   std::unique_ptr<profiler> ec_profiler_;
+
+  // Exported lookup statistics, 1 per embedding table
+  struct TableMetrics {
+    MetricCounter* unique_keys;
+    MetricCounter* missing_keys;
+    MetricGauge* hit_rate;
+  };
+  std::vector<TableMetrics> table_metrics_;
+
+  // State of the graph-capturable lookups of one table on one stream. Captured graphs refer to it,
+  // so it must stay in place.
+  struct CapturableLookupContext {
+    EmbeddingCache* cache;
+    MemoryBlock* memory_block;
+    size_t table_id;
+  };
+
+  // Contexts of graph-capturable lookups per stream, 1 per embedding table
+  std::map<cudaStream_t, std::vector<CapturableLookupContext>> capturable_lookup_contexts_;
+
+  // mutex for capturable_lookup_contexts_
+  std::mutex capturable_lookup_mutex_;
+
+  CapturableLookupContext& get_capturable_lookup_context(size_t table_id, cudaStream_t stream);
+
+  // Fetches keys that missed a graph-capturable lookup from the parameter server, and inserts them.
+  void insert_missing_keys_async(size_t table_id, std::vector<TypeHashKey> keys);
+
+  // Host node of graph-capturable lookups. Must not call into CUDA.
+  static void CUDART_CB capturable_lookup_callback(void* user_data);
 };
 
 }  // namespace HugeCTR
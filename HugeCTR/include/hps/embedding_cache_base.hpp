@@ -41,6 +41,15 @@ class EmbeddingCacheBase {
                                   size_t num_keys, float hit_rate_threshold,
                                   cudaStream_t stream) = 0;
 
+  // Variant of `lookup_from_device` that can be captured into a CUDA graph. It never waits on the
+  // host. Keys that miss the cache are answered with the default embedding vector, and are fetched
+  // from the parameter server and inserted in the background. Returns false if the cache does not
+  // support such lookups.
+  virtual bool lookup_from_device_capturable(size_t table_id, float* d_vectors, const void* d_keys,
+                                             size_t num_keys, cudaStream_t stream) {
+    return false;
+  }
+
   virtual void insert(size_t table_id, EmbeddingCacheWorkspace& workspace_handler,
                       cudaStream_t stream) = 0;
   virtual void init(const size_t table_id, EmbeddingCacheRefreshspace& refreshspace_handler,
@@ -54,6 +63,47 @@ class EmbeddingCacheBase {
                        cudaStream_t stream) = 0;
   virtual void finalize() = 0;
 
+  // Maintenance of the Bloom filters over the keys known to the parameter server. Only honored by
+  // caches that keep such filters (see `InferenceParams::use_bloom_filter`).
+  virtual void clear_bloom_filter(size_t table_id) {}
+  virtual void insert_bloom_filter(size_t table_id, const void* h_keys, size_t num_keys) {}
+  virtual void seal_bloom_filter(size_t table_id) {}
+
+  // Reloads the embedding vectors of the always-resident hot keys (if any) from the parameter
+  // server.
+  virtual void refresh_hot_keys(size_t table_id, cudaStream_t stream) {}
+
+  // Called once all `init` or `refresh` calls of a table in one pass have been issued. Caches that
+  // build a new version of the table next to the one serving lookups make it visible here.
+  virtual void finish_refresh(size_t table_id, cudaStream_t stream) {}
+
+  // Writes rows that already live on the device of the cache, e.g. the embedding table of a model
+  // trained in the same process, without a round trip through the model files. By default the rows
+  // become the new contents of the table, the same way a refresh pass does.
+  virtual void load_from_device(size_t table_id, const void* d_keys, const float* d_vectors,
+                                size_t num_keys, cudaStream_t stream) {
+    refresh(table_id, d_keys, d_vectors, num_keys, stream);
+    finish_refresh(table_id, stream);
+  }
+
+  // Replaces the contents of a table with a pre-hashed table image (see `PrehashedTable`): the
+  // num_slots + 1 keys and rows of its hash table, and the num_rows embedding vectors in row
+  // order. Returns false if the cache cannot take the image as is; the caller then inserts the
+  // rows one by one.
+  virtual bool init_prehashed(size_t table_id, const void* keys, const uint32_t* rows,
+                              size_t num_slots, const void* vectors, size_t num_rows,
+                              cudaStream_t stream) {
+    return false;
+  }
+
+  // Moves GPU cache capacity between the tables, towards the tables whose hit rate would grow the
+  // most (see `InferenceParams::cache_rebalance_percentage`). Called between refreshes.
+  virtual void rebalance_capacity() {}
+
+  // Number of GPU embedding cache entries of a table that were evicted because their slabset was
+  // fully occupied.
+  virtual size_t conflict_evictions(size_t table_id) { return 0; }
+
   virtual EmbeddingCacheWorkspace create_workspace() = 0;
   virtual void destroy_workspace(EmbeddingCacheWorkspace&) = 0;
   virtual EmbeddingCacheRefreshspace create_refreshspace() = 0;
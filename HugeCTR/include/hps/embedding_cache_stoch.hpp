@@ -17,6 +17,7 @@
 
 #include <cuda_runtime_api.h>
 
+#include <hps/admission_filter.hpp>
 #include <hps/embedding_cache_base.hpp>
 #include <hps/embedding_cache_gpu.hpp>
 #include <hps/inference_utils.hpp>
@@ -99,6 +100,9 @@ class EmbeddingCacheStoch : public EmbeddingCacheBase,
   // The shared thread-safe embedding cache
   std::vector<std::unique_ptr<ecache::EmbedCacheBase<TypeHashKey>>> gpu_emb_caches_;
 
+  // Admission filters in front of the insert path, 1 per embedding table (nullptr = admit all)
+  std::vector<std::unique_ptr<AdmissionFilter<TypeHashKey>>> admission_filters_;
+
   // streams for asynchronous parameter server insert threads
   std::vector<cudaStream_t> insert_streams_;
 
@@ -128,6 +132,11 @@ class EmbeddingCacheStoch : public EmbeddingCacheBase,
     ModifyContextHandle modify_handle_;
     LookupContextHandle lookup_handle_;
     cudaEvent_t modify_event_;
+    // Admitted subset of the missing keys (only allocated if the table has an admission filter).
+    TypeHashKey* h_admitted_keys_{nullptr};
+    uint64_t* h_admitted_index_{nullptr};
+    uint64_t* d_admitted_index_{nullptr};
+    float* d_admitted_emb_vec_{nullptr};
   };
 
   struct RefreshPrivateData {
@@ -148,6 +157,12 @@ class EmbeddingCacheStoch : public EmbeddingCacheBase,
                const float* d_values, float hit_rate, ModifyContextHandle modify_handle,
                cudaEvent_t modify_event, cudaStream_t stream);
 
+  // Passes missing keys through the admission filter of the table. If keys were rejected, \p h_keys
+  // and \p d_values are redirected to the admitted subset. Returns the number of admitted keys.
+  size_t Admit(const size_t table_id, WorkspacePrivateData* private_data,
+               const TypeHashKey*& h_keys, const size_t len, const float*& d_values,
+               cudaStream_t stream);
+
   std::vector<std::map<cudaStream_t, PerStreamLookupData>> lookup_handle_map_vec_;
   std::vector<RefreshPrivateData> refresh_private_data_;
   DefaultAllocator allocator_;
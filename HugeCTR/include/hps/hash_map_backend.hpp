@@ -17,11 +17,15 @@
 
 #include <parallel_hashmap/phmap.h>
 
+#include <algorithm>
 #include <condition_variable>
 #include <core/memory.hpp>
 #include <deque>
 #include <functional>
 #include <hps/database_backend.hpp>
+#include <hps/prehashed_table.hpp>
+#include <hps/value_codec.hpp>
+#include <memory>
 #include <shared_mutex>
 #include <thread>
 #include <thread_pool.hpp>
@@ -37,6 +41,33 @@ namespace HugeCTR {
 struct HashMapBackendParams final : public VolatileBackendParams {
   size_t allocation_rate{256L * 1024 *
                          1024};  // Number of additional bytes to allocate per allocation cycle.
+  double compaction_threshold{
+      0.5};  // If, after resolving an overflow, more than this fraction of the value slots in a
+             // partition are unused, live values are relocated into as few value pages as
+             // possible, and empty pages are returned to the OS. Set to 1 to disable compaction.
+  size_t value_page_size{0};  // Backs the value pages with 2 MiB or 1 GiB huge pages (0 = off).
+  int numa_node{-1};          // If not negative, binds the value pages to this NUMA node.
+  DatabaseValueFormat_t value_format{
+      DatabaseValueFormat_t::Float32};  // Format in which the values are stored in the pages.
+  std::unordered_map<std::string, DatabaseValueFormat_t>
+      table_value_formats;  // Overrides `value_format` for individual tables.
+};
+
+/**
+ * Memory utilization of a \p HashMapBackend table.
+ */
+struct HashMapBackendMemoryStats final {
+  size_t num_pages{0};       // Number of value pages allocated.
+  size_t num_slots{0};       // Total number of value slots in all pages.
+  size_t num_free_slots{0};  // Number of value slots that are not occupied.
+  size_t num_bytes{0};       // Total memory allocated for value pages (in bytes).
+
+  /**
+   * @return Fraction of the allocated value slots that are not occupied.
+   */
+  inline double fragmentation() const {
+    return num_slots ? static_cast<double>(num_free_slots) / static_cast<double>(num_slots) : 0;
+  }
 };
 
 /**
@@ -88,14 +119,46 @@ class HashMapBackend final : public VolatileBackend<Key, HashMapBackendParams> {
 
   size_t dump_bin(const std::string& table_name, std::ofstream& file) override;
 
+  /**
+   * Writes all partitions in parallel, each one at its offset in the file, through large buffers.
+   * The partitions stay locked meanwhile, so that their sizes, and hence the offsets, hold.
+   */
+  size_t dump_bin(const std::string& table_name, const std::string& path) override;
+
 #ifdef HCTR_USE_ROCKS_DB
   size_t dump_sst(const std::string& table_name, rocksdb::SstFileWriter& file) override;
 #endif  // HCTR_USE_ROCKS_DB
 
+  /**
+   * Attaches a pre-hashed table file (see \p PrehashedTable) as the read-only base of a table, in
+   * place of inserting its pairs. The file is memory-mapped, so that the table is available at
+   * once, and its pages are only read when the keys are looked up. Pairs inserted afterwards live
+   * next to it and take precedence over it. Evicting keys only affects the inserted pairs, and
+   * dumps only contain the inserted pairs. \p size counts the keys of both. Evicting the table
+   * detaches the file.
+   *
+   * @param table_name The name of the table.
+   * @param path The pre-hashed table file, with keys of type \p Key.
+   * @param value_size The size of a value of the table, which the file must match.
+   *
+   * @return The number of keys in the file.
+   */
+  size_t attach_prehashed_table(const std::string& table_name, const std::string& path,
+                                size_t value_size);
+
+  /**
+   * Gather value storage statistics for a table.
+   *
+   * @param table_name The name of the table to be queried.
+   *
+   * @return Memory utilization accumulated over all partitions of the table.
+   */
+  HashMapBackendMemoryStats memory_stats(const std::string& table_name) const;
+
  protected:
 #if 1
   // Better performance on most systems.
-  using CharAllocator = AlignedAllocator<char>;
+  using CharAllocator = HostPageAllocator<char>;
   static constexpr size_t value_page_alignment{CharAllocator::alignment};
 #else
   using CharAllocator = std::allocator<char>;
@@ -113,14 +176,18 @@ class HashMapBackend final : public VolatileBackend<Key, HashMapBackendParams> {
     union {
       time_t last_access;
       uint64_t access_count;
+      uint64_t referenced;
     };
     ValuePtr value;
   };
   using Entry = std::pair<const Key, Payload>;
 
   struct Partition final {
-    const uint32_t value_size;
+    const uint32_t value_size;  // Size of the values passed to `insert` and returned by `fetch`.
+    const DatabaseValueFormat_t value_format;
+    const uint32_t encoded_value_size;  // Size of the values in the value pages.
     const size_t allocation_rate;
+    const double compaction_threshold;
 
     // Pooled payload storage.
     std::vector<ValuePage> value_pages;
@@ -129,21 +196,99 @@ class HashMapBackend final : public VolatileBackend<Key, HashMapBackendParams> {
     // Key -> Payload map.
     phmap::flat_hash_map<Key, Payload> entries;
 
+    // Access control (guards all of the above).
+    mutable std::shared_mutex read_write_guard;
+
     Partition() = delete;
 
-    Partition(const uint32_t value_size, const HashMapBackendParams& params)
-        : value_size{value_size}, allocation_rate{params.allocation_rate} {}
+    Partition(const uint32_t value_size, const DatabaseValueFormat_t value_format,
+              const HashMapBackendParams& params)
+        : value_size{value_size},
+          value_format{value_format},
+          encoded_value_size{
+              static_cast<uint32_t>(HugeCTR::encoded_value_size(value_format, value_size))},
+          allocation_rate{params.allocation_rate},
+          compaction_threshold{params.compaction_threshold} {}
+
+    inline size_t value_stride() const {
+      // Compressed values are decoded element by element, and do not benefit from the alignment.
+      const size_t alignment{value_format == DatabaseValueFormat_t::Float32 ? value_page_alignment
+                                                                            : sizeof(float)};
+      return (encoded_value_size + alignment - 1) / alignment * alignment;
+    }
+
+    inline void encode_value(const char* const value, const ValuePtr encoded) const {
+      if (value_format == DatabaseValueFormat_t::Float32) {
+        std::copy_n(value, value_size, encoded);
+      } else {
+        HugeCTR::encode_value(value_format, value, value_size, encoded);
+      }
+    }
+
+    inline void decode_value(const ValuePtr encoded, char* const value) const {
+      if (value_format == DatabaseValueFormat_t::Float32) {
+        std::copy_n(encoded, value_size, value);
+      } else {
+        HugeCTR::decode_value(value_format, encoded, value_size, value);
+      }
+    }
+
+    inline size_t num_slots() const {
+      return value_pages.empty() ? 0 : value_pages.size() * (allocation_rate / value_stride());
+    }
   };
 
+  // Partitions own a mutex and must never be relocated. Hence, we use a deque instead of a vector.
+  using PartitionList = std::deque<Partition>;
+
   // Actual data.
   CharAllocator char_allocator_;
-  std::unordered_map<std::string, std::vector<Partition>> tables_;
+  std::unordered_map<std::string, PartitionList> tables_;
 
-  // Access control.
+  // Access control. Only guards the table directory (creation / removal of tables). Individual
+  // partitions are protected by their own `read_write_guard`, so that operations on one partition
+  // never have to wait for operations on another.
   mutable std::shared_mutex read_write_guard_;
 
+  // Pre-hashed tables underneath the tables of the same name (guarded by `read_write_guard_`).
+  std::unordered_map<std::string, std::shared_ptr<const PrehashedTable<Key>>> prehashed_tables_;
+
+  // The pre-hashed table attached to a table, if any. Takes the directory lock itself.
+  std::shared_ptr<const PrehashedTable<Key>> find_prehashed_table_(
+      const std::string& table_name) const;
+
+  // Implementations of `contains` and `fetch` that ignore the pre-hashed tables.
+  size_t contains_(const std::string& table_name, size_t num_keys, const Key* keys,
+                   const std::chrono::nanoseconds& time_budget) const;
+
+  size_t fetch_(const std::string& table_name, size_t num_keys, const Key* keys, char* values,
+                size_t value_stride, const DatabaseMissCallback& on_miss,
+                const std::chrono::nanoseconds& time_budget);
+
+  size_t fetch_(const std::string& table_name, size_t num_indices, const size_t* indices,
+                const Key* keys, char* values, size_t value_stride,
+                const DatabaseMissCallback& on_miss, const std::chrono::nanoseconds& time_budget);
+
+  // Locate the partitions of a table, or create them, if they do not exist yet. Returns with
+  // `lock` holding shared ownership of the table directory.
+  PartitionList& get_or_create_table_(const std::string& table_name, uint32_t value_size,
+                                      std::shared_lock<std::shared_mutex>& lock);
+
+  // Number of keys that are processed as a group in `fetch_batch_`. Hash map slots are prefetched
+  // one group ahead, and values are prefetched before copying.
+  static constexpr size_t fetch_window_size{16};
+
+  // Fetch a batch of values from `part`. The `j`-th key of the batch is `keys[indexer(j)]`.
+  template <typename Indexer>
+  size_t fetch_batch_(Partition& part, size_t batch_size, const Indexer& indexer, const Key* keys,
+                      char* values, size_t value_stride, const DatabaseMissCallback& on_miss);
+
   // Overflow resolution.
   size_t resolve_overflow_(const std::string& table_name, size_t part_index, Partition& part);
+
+  // Relocates live values into the fullest value pages, and releases pages that become empty.
+  // Returns the number of released pages.
+  size_t compact_(Partition& part);
 };
 
 // TODO: Remove me!
@@ -91,7 +91,7 @@ namespace HugeCTR {
                                                                                              \
       /* Race-conditions here are deliberately ignored because insignificant in practice. */ \
       __VA_ARGS__;                                                                           \
-      std::copy_n(payload.value, part.value_size, &values[(k - keys) * value_stride]);       \
+      part.decode_value(payload.value, &values[(k - keys) * value_stride]);                  \
     } else {                                                                                 \
       on_miss(k - keys);                                                                     \
       ++miss_count;                                                                          \
@@ -116,6 +116,11 @@ namespace HugeCTR {
         const time_t now{std::time(nullptr)};                                                 \
         HCTR_HPS_DB_APPLY_(MODE, HCTR_HPS_HASH_MAP_FETCH_IMPL_(payload.last_access = now));   \
       } break;                                                                                \
+      case DatabaseOverflowPolicy_t::EvictClock: {                                            \
+        /* Only write if not yet set, to avoid dirtying the cache line for hot keys. */       \
+        HCTR_HPS_DB_APPLY_(MODE, HCTR_HPS_HASH_MAP_FETCH_IMPL_(                               \
+                                     if (!payload.referenced) { payload.referenced = 1; }));  \
+      } break;                                                                                \
     }                                                                                         \
     return true;                                                                              \
   }()
@@ -144,8 +149,7 @@ namespace HugeCTR {
     if (res.second) {                                                                        \
       /* If no free space, allocate another buffer, and fill pointer queue. */               \
       if (part.value_slots.empty()) {                                                        \
-        const size_t stride{(value_size + value_page_alignment - 1) / value_page_alignment * \
-                            value_page_alignment};                                           \
+        const size_t stride{part.value_stride()};                                            \
         const size_t num_values{part.allocation_rate / stride};                              \
         HCTR_CHECK(num_values > 0);                                                          \
                                                                                              \
@@ -167,7 +171,7 @@ namespace HugeCTR {
       ++num_inserts;                                                                         \
     }                                                                                        \
                                                                                              \
-    std::copy_n(&values[(k - keys) * value_stride], value_size, payload.value);              \
+    part.encode_value(&values[(k - keys) * value_stride], payload.value);                    \
   } while (0)
 
 /**
@@ -191,6 +195,11 @@ namespace HugeCTR {
         const time_t now{std::time(nullptr)};                                                 \
         HCTR_HPS_DB_APPLY_(MODE, HCTR_HPS_HASH_MAP_INSERT_IMPL_(payload.last_access = now));  \
       } break;                                                                                \
+      case DatabaseOverflowPolicy_t::EvictClock: {                                            \
+        /* New entries start unreferenced. Updates must not alter the reference bit. */       \
+        HCTR_HPS_DB_APPLY_(MODE, HCTR_HPS_HASH_MAP_INSERT_IMPL_(                              \
+                                     if (res.second) { payload.referenced = 0; }));           \
+      } break;                                                                                \
     }                                                                                         \
     return true;                                                                              \
   }()
@@ -15,15 +15,22 @@
  */
 #pragma once
 
+#include <chrono>
 #include <common.hpp>
+#include <condition_variable>
+#include <future>
 #include <hps/database_backend.hpp>
 #include <hps/embedding_cache_base.hpp>
 #include <hps/hier_parameter_server_base.hpp>
 #include <hps/inference_utils.hpp>
 #include <hps/memory_pool.hpp>
 #include <hps/message.hpp>
+#include <hps/miss_coalescer.hpp>
+#include <hps/near_cache_backend.hpp>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <parallel_hashmap/phmap.h>
 #include <string>
 #include <thread>
 #include <unordered_map>
@@ -53,13 +60,20 @@ class HierParameterServer : public HierParameterServerBase {
   virtual void* apply_buffer(const std::string& model_name, int device_id,
                              CACHE_SPACE_TYPE cache_type = CACHE_SPACE_TYPE::WORKER);
   virtual void free_buffer(void* p);
-  virtual void lookup(const void* h_keys, size_t length, float* h_vectors,
-                      const std::string& model_name, size_t table_id);
+  virtual void lookup(
+      const void* h_keys, size_t length, float* h_vectors, const std::string& model_name,
+      size_t table_id,
+      const std::chrono::nanoseconds& time_budget = std::chrono::nanoseconds::zero());
+  virtual std::future<void> lookup_async(
+      const void* h_keys, size_t length, float* h_vectors, const std::string& model_name,
+      size_t table_id,
+      const std::chrono::nanoseconds& time_budget = std::chrono::nanoseconds::zero());
   virtual void refresh_embedding_cache(const std::string& model_name, int device_id);
   virtual void insert_embedding_cache(size_t table_id,
                                       std::shared_ptr<EmbeddingCacheBase> embedding_cache,
                                       EmbeddingCacheWorkspace& workspace_handler,
                                       cudaStream_t stream);
+  virtual void write_cache_key_log(const std::string& model_name, const std::string& path);
   virtual void parse_hps_configuraion(const std::string& hps_json_config_file);
   virtual std::map<std::string, InferenceParams> get_hps_model_configuration_map();
   virtual void set_profiler(int iteration, int warmup, bool enable_bench) {
@@ -68,6 +82,33 @@ class HierParameterServer : public HierParameterServerBase {
   virtual void profiler_print();
 
  private:
+  // (Re-)builds the Bloom filters of all embedding caches of a model from its sparse model files.
+  void refresh_bloom_filters_per_model(const InferenceParams& inference_params);
+  // Maps a database tag to the model and the index of its embedding table. False if unknown.
+  bool resolve_tag_name(const std::string& tag_name, std::string& model_name,
+                        size_t& table_id) const;
+  // Adds keys received through an update source to the Bloom filters of the affected table.
+  void update_bloom_filters(const std::string& tag_name, size_t num_keys, const TypeHashKey* keys);
+  // Writes values received through an update source to the rows of the affected table that reside
+  // in the GPU embedding caches.
+  void update_embedding_caches(const std::string& tag_name, size_t num_keys,
+                               const TypeHashKey* keys, const char* values, size_t value_size);
+  // Remembers keys received through an update source until the next refresh of the models that
+  // only refresh updated keys.
+  void record_updated_keys(const std::string& tag_name, size_t num_keys, const TypeHashKey* keys);
+  // Refreshes the embedding caches of a model periodically until the parameter server shuts down.
+  void run_background_refresh(const InferenceParams& inference_params);
+  // Number of keys that the refresh workspace of an embedding cache holds at least.
+  static size_t refresh_chunk_size(const embedding_cache_config& cache_config);
+  // Fills the new embedding cache of a model version with the keys held by the cache of the
+  // previous version, looked up anew from the databases, before it replaces that cache.
+  void warm_up_embedding_cache(const std::string& model_name,
+                               const std::shared_ptr<EmbeddingCacheBase>& old_cache,
+                               const std::shared_ptr<EmbeddingCacheBase>& new_cache);
+  // Fills the embedding caches of a model with the keys of its key_log_warmup_file, looked up from
+  // the databases, before the parameter server serves the model.
+  void warm_up_embedding_caches_from_key_log(const InferenceParams& inference_params);
+
   // Parameter server configuration
   parameter_server_config ps_config_;
 
@@ -76,14 +117,33 @@ class HierParameterServer : public HierParameterServerBase {
   bool volatile_db_initialize_after_startup_;
   double volatile_db_cache_rate_;
   bool volatile_db_cache_missed_embeddings_;
-  mutable ThreadPool volatile_db_async_inserter_{"vdb inserter", 1};
+  mutable ThreadPool volatile_db_async_inserter_{"vdb inserter", TaskPriority::Refresh, 1};
+  NearCacheBackend<TypeHashKey>* near_cache_{nullptr};  // Wraps `volatile_db_` if enabled.
+
+  // Lookups are split into chunks. While the persistent DB resolves the misses of one chunk, the
+  // volatile DB is already queried for the next chunk.
+  static constexpr size_t lookup_pipeline_chunk_size{16 * 1024};
+  mutable ThreadPool lookup_pipeline_{"hps lookup", TaskPriority::Lookup};
+  mutable ThreadPool lookup_async_workers_{"hps async lookup", TaskPriority::Lookup};
 
   std::unique_ptr<DatabaseBackendBase<TypeHashKey>> persistent_db_;
   bool persistent_db_initialize_after_startup_;
+  bool persistent_db_bulk_load_;
+
+  // Content hash of every chunk of the model file that each database table was last loaded from.
+  // The chunks of a new model version with the same hash are already in the databases, and are
+  // shared with the previous version instead of being inserted again.
+  struct LoadedTable {
+    std::vector<size_t> chunk_hashes;
+    size_t num_keys{0};
+  };
+  std::unordered_map<std::string, LoadedTable> loaded_tables_;
+  std::mutex loaded_tables_mutex_;
 
   // Realtime data ingestion.
   std::unique_ptr<MessageSource<TypeHashKey>> volatile_db_source_;
   std::unique_ptr<MessageSource<TypeHashKey>> persistent_db_source_;
+  std::unique_ptr<MessageSource<TypeHashKey>> near_cache_source_;  // Invalidates `near_cache_`.
 
   // Buffer pool that manages workspace and refreshspace of embedding caches
   std::shared_ptr<ManagerPool> buffer_pool_;
@@ -92,6 +152,27 @@ class HierParameterServer : public HierParameterServerBase {
   // Embedding caches of all models deployed on all devices, e.g., {"dcn": {0: dcn_embedding_cache0,
   // 1: dcnembedding_cache1}}
   std::map<std::string, std::map<int64_t, std::shared_ptr<EmbeddingCacheBase>>> model_cache_map_;
+  // Coalesces concurrent embedding cache misses, 1 per embedding table of each model
+  std::map<std::string, std::vector<std::shared_ptr<MissCoalescer<TypeHashKey>>>> miss_coalescers_;
+  // Guards `model_cache_map_` and `miss_coalescers_` against concurrent access
+  std::mutex model_cache_map_mutex_;
+  // Position at which the next refresh of an embedding cache continues, per model and device.
+  struct RefreshCursor {
+    size_t table_id{0};
+    size_t set_index{0};
+  };
+  std::map<std::string, std::map<int64_t, RefreshCursor>> refresh_cursors_;
+  // Keys updated since the last refresh, per model, device and embedding table. Only holds the
+  // models that set `refresh_updated_keys_only`.
+  std::map<std::string, std::map<int64_t, std::vector<phmap::flat_hash_set<TypeHashKey>>>>
+      updated_keys_;
+  // Guards `refresh_cursors_` and `updated_keys_`
+  std::mutex refresh_state_mutex_;
+  // Threads of the models that set `background_refresh`
+  std::vector<std::thread> background_refreshers_;
+  bool stop_background_refreshers_{false};
+  std::mutex background_refreshers_mutex_;
+  std::condition_variable background_refreshers_cv_;
   // model configuration of all models deployed on HPS, e.g., {"dcn": dcn_inferenceParamesStruct}
   std::map<std::string, InferenceParams> inference_params_map_;
   // benchmark profiler
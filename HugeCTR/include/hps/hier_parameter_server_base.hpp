@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <chrono>
+#include <future>
 #include <hps/embedding_cache_base.hpp>
 #include <hps/inference_utils.hpp>
 #include <memory>
@@ -59,13 +61,35 @@ class HierParameterServerBase {
   virtual void* apply_buffer(const std::string& model_name, int device_id,
                              CACHE_SPACE_TYPE cache_type = CACHE_SPACE_TYPE::WORKER) = 0;
   virtual void free_buffer(void* p) = 0;
-  virtual void lookup(const void* h_keys, size_t length, float* h_vectors,
-                      const std::string& model_name, size_t table_id) = 0;
+  /**
+   * Retrieve the embeddings for \p length keys from the database tiers. Keys not found in any tier,
+   * or not resolved within \p time_budget , are set to the default embedding vector.
+   *
+   * @param time_budget Soft deadline for the entire lookup (see also `DatabaseBackend::fetch`).
+   * `zero` means no deadline.
+   */
+  virtual void lookup(
+      const void* h_keys, size_t length, float* h_vectors, const std::string& model_name,
+      size_t table_id,
+      const std::chrono::nanoseconds& time_budget = std::chrono::nanoseconds::zero()) = 0;
+  /**
+   * Same as `lookup`, but returns immediately. \p h_keys and \p h_vectors must remain valid until
+   * the returned future becomes ready.
+   */
+  virtual std::future<void> lookup_async(
+      const void* h_keys, size_t length, float* h_vectors, const std::string& model_name,
+      size_t table_id,
+      const std::chrono::nanoseconds& time_budget = std::chrono::nanoseconds::zero()) = 0;
   virtual void refresh_embedding_cache(const std::string& model_name, int device_id) = 0;
   virtual void insert_embedding_cache(size_t table_id,
                                       std::shared_ptr<EmbeddingCacheBase> embedding_cache,
                                       EmbeddingCacheWorkspace& workspace_handler,
                                       cudaStream_t stream) = 0;
+  /**
+   * Writes the keys that the GPU embedding cache of a model holds to a cache key log, from which
+   * other instances can warm up their caches (see key_log_warmup_file).
+   */
+  virtual void write_cache_key_log(const std::string& model_name, const std::string& path) = 0;
   virtual void parse_hps_configuraion(const std::string& hps_json_config_file) = 0;
   virtual std::map<std::string, InferenceParams> get_hps_model_configuration_map() = 0;
   virtual void set_profiler(int iteration, int warmup, bool enable_bench) = 0;
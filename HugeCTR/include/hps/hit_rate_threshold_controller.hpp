@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Learns the hit rate threshold of an embedding table. Lookups whose hit rate is below the
+ * threshold insert their missing keys synchronously; all others answer the misses with default
+ * values and insert them in the background. The threshold is set as high as possible, while the
+ * synchronous inserts are expected to add at most a given latency to each lookup on average.
+ *
+ * The estimate is based on the hit rates and numbers of missing keys of recent lookups, and on
+ * the measured cost of resolving a missing key (parameter server lookup and cache insert).
+ */
+class HitRateThresholdController {
+ public:
+  /**
+   * @param initial_threshold Threshold to use until the first insert has been measured.
+   * @param latency_budget_us Average latency per lookup that synchronous inserts may add.
+   * @param window Number of recent lookups to base the estimate on.
+   * @param update_interval Number of lookups after which the threshold is re-estimated.
+   */
+  HitRateThresholdController(float initial_threshold, double latency_budget_us,
+                             size_t window = 256, size_t update_interval = 32);
+
+  float threshold() const { return threshold_.load(std::memory_order_relaxed); }
+
+  /**
+   * Accounts for a lookup.
+   *
+   * @param hit_rate Hit rate of the lookup.
+   * @param num_missing_keys Number of keys that the lookup could not resolve from the cache.
+   */
+  void record_lookup(double hit_rate, size_t num_missing_keys);
+
+  /**
+   * Accounts for the insertion of missing keys (synchronous or asynchronous).
+   *
+   * @param num_keys Number of keys inserted.
+   * @param elapsed_us Time it took to fetch and insert them.
+   */
+  void record_insert(size_t num_keys, double elapsed_us);
+
+ private:
+  static constexpr double cost_smoothing_{0.1};
+
+  void update_threshold();
+
+  const double latency_budget_us_;
+  const size_t window_;
+  const size_t update_interval_;
+  std::atomic<float> threshold_;
+
+  struct Sample {
+    double hit_rate;
+    size_t num_missing_keys;
+  };
+  std::mutex mutex_;
+  std::vector<Sample> samples_;
+  size_t next_sample_{0};
+  size_t num_lookups_since_update_{0};
+  double cost_per_key_us_{0};
+  bool has_cost_{false};
+};
+
+}  // namespace HugeCTR
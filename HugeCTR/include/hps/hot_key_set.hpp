@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_runtime_api.h>
+
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Host-side count-min sketch to estimate key frequencies in bounded memory. Counters are halved
+ * periodically, so that the estimates follow shifts in the traffic.
+ */
+class CountMinSketch {
+ public:
+  CountMinSketch(size_t width, size_t depth);
+
+  /**
+   * Counts one occurrence of \p key .
+   *
+   * @return The updated frequency estimate.
+   */
+  uint32_t add(uint64_t key);
+
+  /**
+   * @return True if the counters have been halved since the last call.
+   */
+  bool aged();
+
+ private:
+  size_t width_;
+  size_t depth_;
+  std::vector<uint32_t> counters_;
+  size_t num_updates_{0};
+  bool aged_{false};
+};
+
+/**
+ * Small, always-resident set of the hottest keys of an embedding table. The embedding cache
+ * consults it for keys that it could not find, so that the most popular keys are never lost to
+ * `Replace` evictions. Keys are ranked by how often they missed the embedding cache.
+ *
+ * @tparam Key Data-type to be used for keys.
+ */
+template <typename Key>
+class HotKeySet {
+ public:
+  /**
+   * @param capacity Maximum number of resident keys.
+   * @param emb_vec_size Number of floats per embedding vector.
+   * @param max_query_length Maximum number of keys passed to `filter_missing`.
+   */
+  HotKeySet(size_t capacity, size_t emb_vec_size, size_t max_query_length);
+  ~HotKeySet();
+  HotKeySet(const HotKeySet&) = delete;
+  HotKeySet& operator=(const HotKeySet&) = delete;
+
+  size_t capacity() const { return capacity_; }
+  size_t size() const;
+
+  /**
+   * @return A snapshot of the resident keys.
+   */
+  std::vector<Key> keys() const;
+
+  /**
+   * Accounts for keys that missed the embedding cache and promotes the hottest of them.
+   *
+   * @param h_keys The missing keys in host memory.
+   * @param d_vectors The embedding vectors of \p h_keys in device memory (same order).
+   * @param num_keys Number of keys.
+   * @param stream The stream to use. Will be synchronized before returning.
+   */
+  void record(const Key* h_keys, const float* d_vectors, size_t num_keys, cudaStream_t stream);
+
+  /**
+   * Resolves resident keys from the list of missing keys. Their embedding vectors are written to
+   * `d_hit_emb_vec`, and they are removed from the list.
+   *
+   * @return Number of missing keys that remain.
+   */
+  size_t filter_missing(Key* d_missing_keys, uint64_t* d_missing_index, size_t missing_length,
+                        float* d_hit_emb_vec, cudaStream_t stream);
+
+  /**
+   * Overwrites the embedding vectors of resident keys.
+   */
+  void refresh(const Key* d_keys, const float* d_vectors, size_t length, cudaStream_t stream);
+
+  /**
+   * Same as `refresh`, but the (at most `capacity()`) keys and vectors reside in host memory.
+   */
+  void refresh_from_host(const Key* h_keys, const float* h_vectors, size_t length,
+                         cudaStream_t stream);
+
+ private:
+  static constexpr uint32_t promotion_threshold_{2};
+  static constexpr uint32_t empty_slot_{UINT32_MAX};
+  static constexpr size_t block_size_{256};
+
+  size_t capacity_;
+  size_t emb_vec_size_;
+  size_t max_query_length_;
+
+  // Residency bookkeeping (host).
+  struct Entry {
+    uint32_t count;
+    uint32_t slot;
+  };
+  mutable std::mutex record_mutex_;
+  CountMinSketch sketch_;
+  std::unordered_map<Key, Entry> resident_;
+  std::vector<uint32_t> free_slots_;
+  uint32_t min_count_{0};
+
+  // Open addressing index (key -> slot) and slot storage (device). Readers hold the lock shared.
+  std::shared_mutex device_mutex_;
+  size_t num_buckets_;
+  std::vector<Key> h_bucket_keys_;
+  std::vector<uint32_t> h_bucket_slots_;
+  Key* d_bucket_keys_{nullptr};
+  uint32_t* d_bucket_slots_{nullptr};
+  float* d_vectors_{nullptr};
+  uint32_t* d_promotions_{nullptr};
+  Key* d_staging_keys_{nullptr};
+  float* d_staging_vectors_{nullptr};
+
+  // Scratch space for compacting the remaining missing keys.
+  std::mutex filter_mutex_;
+  Key* d_remaining_keys_{nullptr};
+  uint64_t* d_remaining_index_{nullptr};
+  size_t* d_remaining_length_{nullptr};
+  size_t* h_remaining_length_{nullptr};
+};
+
+}  // namespace HugeCTR
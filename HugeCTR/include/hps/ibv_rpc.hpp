@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#ifdef HCTR_USE_RDMA
+
+#include <infiniband/verbs.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Request/response messaging between a fixed set of hosts over InfiniBand or RoCE reliable
+ * connections. The QPs are set up like those of the \p IbvProxy of the hierarchical all-to-all,
+ * but their information is exchanged over TCP, since the hosts are not part of an MPI job.
+ *
+ * Each pair of hosts is connected by two QPs, one for the requests of either side. A request is
+ * built in a registered buffer, sent with an RDMA SEND, handled by the server thread of the peer,
+ * and answered with an RDMA SEND into another registered buffer. The requests to the same peer are
+ * serialized, those to different peers overlap.
+ */
+class IbvRpcEndpoint final {
+ public:
+  /**
+   * Handles a request of a peer, writes the response and returns its size. An empty response
+   * reports a failure.
+   */
+  using Handler = std::function<size_t(const char* request, size_t request_size, char* response,
+                                       size_t max_response_size)>;
+
+  /**
+   * Connects to all the other hosts. They must be started within \p connect_timeout .
+   *
+   * @param hosts "host:port" of every host, the same list on all hosts.
+   * @param rank Index of this host in \p hosts , which also gives the port it listens on.
+   * @param ib_device Name of the InfiniBand device, e.g., mlx5_0.
+   * @param ib_port Port of the InfiniBand device.
+   * @param message_size Maximum size of a request or a response.
+   * @param connect_timeout How long to wait for the other hosts.
+   * @param handler Called by the server thread for each request of a peer.
+   */
+  IbvRpcEndpoint(const std::vector<std::string>& hosts, size_t rank, const std::string& ib_device,
+                 uint8_t ib_port, size_t message_size, std::chrono::seconds connect_timeout,
+                 Handler handler);
+
+  IbvRpcEndpoint(const IbvRpcEndpoint&) = delete;
+  IbvRpcEndpoint& operator=(const IbvRpcEndpoint&) = delete;
+
+  ~IbvRpcEndpoint();
+
+  size_t num_hosts() const { return num_hosts_; }
+  size_t rank() const { return rank_; }
+  size_t message_size() const { return message_size_; }
+
+  /**
+   * Reserves the connection to a peer for one or more requests. To avoid deadlocks, threads that
+   * lock several peers must lock them in ascending order.
+   */
+  std::unique_lock<std::mutex> lock(size_t peer) {
+    return std::unique_lock<std::mutex>(peers_[peer].mutex);
+  }
+
+  /**
+   * @return The buffer in which the next request to \p peer is built.
+   */
+  char* request_buffer(size_t peer) { return peers_[peer].client.send_buffer; }
+
+  /**
+   * Sends the first \p request_size bytes of the request buffer of \p peer .
+   */
+  void post(size_t peer, size_t request_size);
+
+  /**
+   * Waits for the response to the request posted to \p peer .
+   *
+   * @param response_size Set to the size of the response, 0 if the peer failed to handle it.
+   * @return The response, valid until the next request to \p peer .
+   */
+  const char* wait(size_t peer, size_t* response_size);
+
+ private:
+  struct QpInfo {
+    uint32_t rank;
+    uint32_t lid;
+    uint8_t ib_port;
+    uint32_t qpn;
+    // For RoCE
+    uint64_t spn;
+    uint64_t iid;
+    enum ibv_mtu mtu;
+    uint32_t is_roce;
+  };
+
+  struct Connection {
+    ibv_qp* qp{nullptr};
+    char* send_buffer{nullptr};
+    char* recv_buffer{nullptr};
+    ibv_mr* send_mr{nullptr};
+    ibv_mr* recv_mr{nullptr};
+  };
+
+  struct Peer {
+    std::mutex mutex;
+    ibv_cq* client_cq{nullptr};
+    Connection client;  // Requests of this host
+    Connection server;  // Requests of the peer
+  };
+
+  void open_device(const std::string& ib_device);
+  void create_connection(Connection& connection, ibv_cq* send_cq, ibv_cq* recv_cq);
+  QpInfo local_qp_info(const Connection& connection) const;
+  void connect_qp(const Connection& connection, QpInfo remote) const;
+  void post_recv(Connection& connection, uint64_t wr_id);
+  void post_send(Connection& connection, size_t size, uint64_t wr_id);
+  void destroy_connection(Connection& connection);
+  void release();
+
+  void accept_peers(int listen_fd, std::chrono::steady_clock::time_point deadline);
+  void server_loop();
+
+  const size_t num_hosts_;
+  const size_t rank_;
+  const uint8_t ib_port_;
+  const size_t message_size_;
+  const Handler handler_;
+
+  ibv_context* context_{nullptr};
+  ibv_pd* pd_{nullptr};
+  ibv_cq* server_send_cq_{nullptr};
+  ibv_cq* server_recv_cq_{nullptr};
+  std::unique_ptr<Peer[]> peers_;
+
+  std::atomic<bool> stop_{false};
+  std::thread server_thread_;
+};
+
+}  // namespace HugeCTR
+
+#endif  // HCTR_USE_RDMA
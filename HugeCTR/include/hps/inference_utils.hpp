@@ -28,6 +28,7 @@
 #include <optional>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace HugeCTR {
@@ -49,6 +50,7 @@ enum class DatabaseType_t {
   HashMap,
   ParallelHashMap,
   MultiProcessHashMap,
+  DistributedHashMap,
   RedisCluster,
   RocksDB,
 };
@@ -56,6 +58,13 @@ enum class DatabaseOverflowPolicy_t {
   EvictRandom,
   EvictLeastUsed,
   EvictOldest,
+  EvictClock,
+};
+enum class DatabaseValueFormat_t {
+  Float32,
+  Float16,
+  BFloat16,
+  FP8,
 };
 enum class UpdateSourceType_t {
   Null,
@@ -67,6 +76,17 @@ enum class EmbeddingCacheType_t {
   UVM,
   Stochastic,
 };
+enum class AdmissionPolicy_t {
+  Disabled,
+  Frequency,
+  Probabilistic,
+  Doorkeeper,
+};
+enum class SharedCacheRole_t {
+  Disabled,
+  Owner,
+  Reader,
+};
 
 constexpr const char* hctr_enum_to_c_str(const DatabaseType_t value) {
   // Remark: Dependent functions assume lower-case, and underscore separated.
@@ -79,6 +99,8 @@ constexpr const char* hctr_enum_to_c_str(const DatabaseType_t value) {
       return "parallel_hash_map";
     case DatabaseType_t::MultiProcessHashMap:
       return "multi_process_hash_map";
+    case DatabaseType_t::DistributedHashMap:
+      return "distributed_hash_map";
     case DatabaseType_t::RedisCluster:
       return "redis_cluster";
     case DatabaseType_t::RocksDB:
@@ -112,10 +134,27 @@ constexpr const char* hctr_enum_to_c_str(const DatabaseOverflowPolicy_t value) {
       return "evict_least_used";
     case DatabaseOverflowPolicy_t::EvictOldest:
       return "evict_oldest";
+    case DatabaseOverflowPolicy_t::EvictClock:
+      return "evict_clock";
     default:
       return "<unknown DatabaseOverflowPolicy_t value>";
   }
 }
+constexpr const char* hctr_enum_to_c_str(const DatabaseValueFormat_t value) {
+  // Remark: Dependent functions assume lower-case, and underscore separated.
+  switch (value) {
+    case DatabaseValueFormat_t::Float32:
+      return "float32";
+    case DatabaseValueFormat_t::Float16:
+      return "float16";
+    case DatabaseValueFormat_t::BFloat16:
+      return "bfloat16";
+    case DatabaseValueFormat_t::FP8:
+      return "fp8_e4m3";
+    default:
+      return "<unknown DatabaseValueFormat_t value>";
+  }
+}
 constexpr const char* hctr_enum_to_c_str(const UpdateSourceType_t value) {
   // Remark: Dependent functions assume lower-case, and underscore separated.
   switch (value) {
@@ -127,6 +166,34 @@ constexpr const char* hctr_enum_to_c_str(const UpdateSourceType_t value) {
       return "<unknown UpdateSourceType_t value>";
   }
 }
+constexpr const char* hctr_enum_to_c_str(const AdmissionPolicy_t value) {
+  // Remark: Dependent functions assume lower-case, and underscore separated.
+  switch (value) {
+    case AdmissionPolicy_t::Disabled:
+      return "disabled";
+    case AdmissionPolicy_t::Frequency:
+      return "frequency";
+    case AdmissionPolicy_t::Probabilistic:
+      return "probabilistic";
+    case AdmissionPolicy_t::Doorkeeper:
+      return "doorkeeper";
+    default:
+      return "<unknown AdmissionPolicy_t value>";
+  }
+}
+constexpr const char* hctr_enum_to_c_str(const SharedCacheRole_t value) {
+  // Remark: Dependent functions assume lower-case, and underscore separated.
+  switch (value) {
+    case SharedCacheRole_t::Disabled:
+      return "disabled";
+    case SharedCacheRole_t::Owner:
+      return "owner";
+    case SharedCacheRole_t::Reader:
+      return "reader";
+    default:
+      return "<unknown SharedCacheRole_t value>";
+  }
+}
 
 inline std::ostream& operator<<(std::ostream& os, DatabaseType_t value) {
   return os << hctr_enum_to_c_str(value);
@@ -134,6 +201,9 @@ inline std::ostream& operator<<(std::ostream& os, DatabaseType_t value) {
 inline std::ostream& operator<<(std::ostream& os, DatabaseOverflowPolicy_t value) {
   return os << hctr_enum_to_c_str(value);
 }
+inline std::ostream& operator<<(std::ostream& os, DatabaseValueFormat_t value) {
+  return os << hctr_enum_to_c_str(value);
+}
 inline std::ostream& operator<<(std::ostream& os, UpdateSourceType_t value) {
   return os << hctr_enum_to_c_str(value);
 }
@@ -141,6 +211,12 @@ inline std::ostream& operator<<(std::ostream& os, UpdateSourceType_t value) {
 inline std::ostream& operator<<(std::ostream& os, EmbeddingCacheType_t value) {
   return os << hctr_enum_to_c_str(value);
 }
+inline std::ostream& operator<<(std::ostream& os, AdmissionPolicy_t value) {
+  return os << hctr_enum_to_c_str(value);
+}
+inline std::ostream& operator<<(std::ostream& os, SharedCacheRole_t value) {
+  return os << hctr_enum_to_c_str(value);
+}
 
 DatabaseType_t get_hps_database_type(const nlohmann::json& json, const std::string& key,
                                      DatabaseType_t default_value);
@@ -148,8 +224,15 @@ UpdateSourceType_t get_hps_updatesource_type(const nlohmann::json& json, const s
                                              UpdateSourceType_t default_value);
 DatabaseOverflowPolicy_t get_hps_overflow_policy(const nlohmann::json& json, const std::string& key,
                                                  DatabaseOverflowPolicy_t default_value);
+DatabaseValueFormat_t get_hps_value_format(const nlohmann::json& json, const std::string& key,
+                                           DatabaseValueFormat_t default_value);
 EmbeddingCacheType_t get_hps_embeddingcache_type(const nlohmann::json& json, const std::string& key,
                                                  EmbeddingCacheType_t default_value);
+std::vector<AdmissionPolicy_t> get_hps_admission_policies(const nlohmann::json& json,
+                                                          const std::string& key,
+                                                          AdmissionPolicy_t default_value);
+SharedCacheRole_t get_hps_shared_cache_role(const nlohmann::json& json, const std::string& key,
+                                            SharedCacheRole_t default_value);
 
 struct VolatileDatabaseParams {
   DatabaseType_t type{DatabaseType_t::ParallelHashMap};
@@ -160,13 +243,22 @@ struct VolatileDatabaseParams {
   std::string password;
   size_t num_partitions{16};
   size_t allocation_rate{256L * 1024 * 1024};  // Only used with HashMap type backends.
+  size_t value_page_size{0};  // Huge page size for the values (only for HashMap, 0 = off).
+  int numa_node{-1};          // NUMA node to bind the values to (only for HashMap, -1 = off).
   size_t shared_memory_size{
       16L * 1024 * 1024 *
       1024};  // Size-limit of the shared memory (only for Multi-Process hashmap).
   std::string shared_memory_name{
       "hctr_mp_hash_map_database"};  // Name of the shared memory (only for Multi-Process hashmap).
   bool shared_memory_auto_remove{true};
+  bool shared_memory_numa_aware{false};  // Only for Multi-Process hashmap.
+  size_t host_rank{0};  // Index of this host in `address` (only for Distributed hashmap).
+  std::string ib_device{"mlx5_0"};  // RDMA device (only for Distributed hashmap).
+  int ib_port{1};                   // Port of the RDMA device (only for Distributed hashmap).
+  size_t message_size{16L * 1024 * 1024};  // Max. request size (only for Distributed hashmap).
+  size_t connect_timeout{300};  // Seconds to wait for all hosts (only for Distributed hashmap).
   size_t num_node_connections{5};  // Only used with Redis backend.
+  size_t max_pipeline_depth{4};    // Only used with Redis backend.
   size_t max_batch_size{64L * 1024};
 
   bool enable_tls{false};
@@ -180,10 +272,17 @@ struct VolatileDatabaseParams {
   DatabaseOverflowPolicy_t overflow_policy{DatabaseOverflowPolicy_t::EvictRandom};
   double overflow_resolution_target{0.8};
 
+  // Value storage related (only for HashMap and Multi-Process hashmap).
+  DatabaseValueFormat_t value_format{DatabaseValueFormat_t::Float32};
+  std::unordered_map<std::string, DatabaseValueFormat_t>
+      table_value_formats;  // Overrides `value_format` per embedding table name.
+
   // Caching behavior related.
   bool initialize_after_startup{true};
   double initial_cache_rate{1.0};
   bool cache_missed_embeddings{false};
+  size_t near_cache_capacity{0};  // Embeddings of a shared DB kept in this process (0 = off).
+  size_t near_cache_ttl_ms{60000};  // Max. age of the near cache entries (0 = no expiry).
 
   // Real-time update mechanism related.
   std::vector<std::string> update_filters{{"^hps_.+$"}};  // Should be a regex for Kafka.
@@ -218,9 +317,13 @@ struct PersistentDatabaseParams {
   size_t num_threads{16};  // 16 = Default for RocksDB.
   bool read_only{false};
   size_t max_batch_size{64L * 1024};
+  size_t block_cache_size{8L * 1024 * 1024};
+  size_t bloom_filter_bits{10};  // 0 = Disable bloom filters.
+  bool use_direct_reads{false};
 
   // Caching behavior related.
   bool initialize_after_startup{true};
+  bool bulk_load{false};  // Initialize the tables from SST files rather than by inserts.
 
   // Real-time update mechanism related.
   std::vector<std::string> update_filters{{"^hps_.+$"}};  // Should be a regex for Kafka.
@@ -229,9 +332,10 @@ struct PersistentDatabaseParams {
   PersistentDatabaseParams(DatabaseType_t type,
                            // Backend specific.
                            const std::string& path, size_t num_threads, bool read_only,
-                           size_t max_batch_size,
+                           size_t max_batch_size, size_t block_cache_size,
+                           size_t bloom_filter_bits, bool use_direct_reads,
                            // Caching behavior related.
-                           bool initialize_after_startup,
+                           bool initialize_after_startup, bool bulk_load,
                            // Real-time update mechanism related.
                            const std::vector<std::string>& update_filters);
 
@@ -251,12 +355,16 @@ struct UpdateSourceParams {
   size_t failure_backoff_ms{50};
   size_t max_commit_interval{32};
 
+  // Also apply the received updates to the rows that reside in the GPU embedding caches.
+  bool update_embedding_cache{false};
+
   UpdateSourceParams() {}
   UpdateSourceParams(UpdateSourceType_t type,
                      // Backend specific.
                      const std::string& brokers, size_t metadata_refresh_interval_ms,
                      size_t receive_buffer_size, size_t poll_timeout_ms, size_t max_batch_size,
-                     size_t failure_backoff_ms, size_t max_commit_interval);
+                     size_t failure_backoff_ms, size_t max_commit_interval,
+                     bool update_embedding_cache = false);
 
   bool operator==(const UpdateSourceParams& p) const;
   bool operator!=(const UpdateSourceParams& p) const;
@@ -311,6 +419,60 @@ struct InferenceParams {
   bool init_ec;
   bool enable_pagelock;
   bool fp8_quant;
+  // Keep a GPU Bloom filter per table to answer keys unknown to the database tiers directly. The
+  // filter is built from the sparse model files and Kafka updates.
+  bool use_bloom_filter;
+  // Number of hot keys per table that are kept resident outside of the GPU embedding cache (0 =
+  // disabled).
+  size_t hot_key_set_size;
+  // Set associativity (2, 4 or 8) of the dynamic GPU embedding cache of each table (empty = use
+  // the default for all tables).
+  std::vector<size_t> set_associativity_per_table;
+  // Shard the device-resident part of the UVM embedding cache across the deployed devices, which
+  // access each other's shards through peer access.
+  bool shard_uvm_table;
+  // Number of pinned staging buffers that the UVM embedding cache gathers host-resident embedding
+  // vectors into.
+  size_t uvm_table_staging_buffers;
+  // Average latency (in microseconds) that synchronous inserts of missing keys may add to each
+  // lookup. If positive, the hit rate threshold is learned per table (0 = use hit_rate_threshold).
+  float sync_insert_latency_budget_us;
+  // Admission policy applied to the keys that missed the stochastic embedding cache of each table,
+  // before they are inserted (empty = admit all keys).
+  std::vector<AdmissionPolicy_t> admission_policy_per_table;
+  // Policy specific admission threshold of each table (minimum miss count for frequency,
+  // probability for probabilistic; empty or <= 0 = use the policy's default).
+  std::vector<float> admission_threshold_per_table;
+  // Serve plugin lookups through a variant that never waits on the host, so that they can be
+  // captured into CUDA graphs. Missing keys are answered with the default value and inserted in the
+  // background.
+  bool use_capturable_lookup;
+  // Share the dynamic GPU embedding cache of each device between the processes that deploy this
+  // model, e.g. several Triton model instances. The owner allocates and refreshes the caches, the
+  // readers attach to them through CUDA IPC.
+  SharedCacheRole_t shared_cache_role;
+  // Time budget of a single refresh_embedding_cache call in milliseconds (0 = unlimited). A refresh
+  // that runs out of time stops after the current batch of sets and resumes there on the next call.
+  float refresh_time_budget_ms;
+  // Refresh only the keys received through the update source since the last refresh, instead of
+  // scanning the whole embedding cache.
+  bool refresh_updated_keys_only;
+  // Let HPS refresh the embedding caches itself from a background thread, first after
+  // `refresh_delay` and then every `refresh_interval` seconds.
+  bool background_refresh;
+  // Merge the single table lookups from device that concurrent callers issue within this window
+  // (in microseconds) into one embedding cache query (0 = disabled).
+  float lookup_batching_window_us;
+  // Maximum number of keys of a merged lookup (0 = max_batchsize times the maximum number of keys
+  // per sample of the table).
+  size_t lookup_batching_max_keys;
+  // Fraction of the dynamic GPU embedding cache of a table that is moved to the table that would
+  // gain the most from it on each background refresh (0 = fixed capacities).
+  float cache_rebalance_percentage;
+  // Cache key log to load into the GPU embedding caches at startup, and the one that the background
+  // refresh writes the cached keys to (empty = none), see CacheKeyLog.
+  std::string key_log_warmup_file;
+  std::string key_log_record_file;
 
   InferenceParams(const std::string& model_name, size_t max_batchsize, float hit_rate_threshold,
                   const std::string& dense_model_file,
@@ -338,7 +500,20 @@ struct InferenceParams {
                   const EmbeddingCacheType_t embedding_cache_type = EmbeddingCacheType_t::Dynamic,
                   bool use_context_stream = true, bool fuse_embedding_table = false,
                   bool use_hctr_cache_implementation = true, bool init_ec = true,
-                  bool enable_pagelock = false, bool fp8_quant = false);
+                  bool enable_pagelock = false, bool fp8_quant = false,
+                  bool use_bloom_filter = false, size_t hot_key_set_size = 0,
+                  const std::vector<size_t>& set_associativity_per_table = {},
+                  bool shard_uvm_table = false, size_t uvm_table_staging_buffers = 2,
+                  float sync_insert_latency_budget_us = 0,
+                  const std::vector<AdmissionPolicy_t>& admission_policy_per_table = {},
+                  const std::vector<float>& admission_threshold_per_table = {},
+                  bool use_capturable_lookup = false,
+                  SharedCacheRole_t shared_cache_role = SharedCacheRole_t::Disabled,
+                  float refresh_time_budget_ms = 0, bool refresh_updated_keys_only = false,
+                  bool background_refresh = false, float lookup_batching_window_us = 0,
+                  size_t lookup_batching_max_keys = 0, float cache_rebalance_percentage = 0,
+                  const std::string& key_log_warmup_file = "",
+                  const std::string& key_log_record_file = "");
 };
 
 struct parameter_server_config {
@@ -407,6 +582,7 @@ struct embedding_cache_config {
   // Each vector will have the size of E(# of embedding tables in the model)
   std::vector<size_t> embedding_vec_size_;  // # of float in emb_vec
   std::vector<size_t> num_set_in_cache_;    // # of cache set in the cache
+  std::vector<size_t> set_associativity_;   // # of slabs per cache set
   std::vector<std::string>
       embedding_table_name_;  // ## of embedding tables be cached by current embedding cache
   std::vector<size_t>
@@ -414,6 +590,7 @@ struct embedding_cache_config {
                                      // will query from a embedding table
   bool use_hctr_cache_implementation;  // if true - use the nv_gpu_cache implementation else use
                                        // embedding_cache lib
+  SharedCacheRole_t shared_cache_role_;  // Whether the caches are shared with other processes
 };
 
 struct EmbeddingCacheWorkspace {
@@ -471,6 +648,14 @@ void fill_default_emb_vec_async(float* d_vals_merge_dst_ptr, const float default
                                 const size_t emb_vec_size, const size_t block_size,
                                 cudaStream_t stream);
 
+// Graph-capturable variant, for which the number of missing keys resides in device memory.
+// `max_missing_len` bounds it.
+void fill_default_emb_vec_async(float* d_vals_merge_dst_ptr, const float default_emb_vec,
+                                const uint64_t* d_missing_index_ptr,
+                                const size_t* d_missing_len_ptr, const size_t max_missing_len,
+                                const size_t emb_vec_size, const size_t block_size,
+                                cudaStream_t stream);
+
 void decompress_emb_vec_async(const float* d_unique_src_ptr, const uint64_t* d_unique_index_ptr,
                               float* d_decompress_dst_ptr, const size_t decompress_len,
                               const size_t emb_vec_size, const size_t block_size,
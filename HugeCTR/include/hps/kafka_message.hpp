@@ -17,6 +17,7 @@
 
 #include <rdkafka.h>
 
+#include <atomic>
 #include <condition_variable>
 #include <hps/message.hpp>
 #include <thread>
@@ -31,9 +32,17 @@ struct KafkaMessageSinkParams : public MessageSinkParams {
   size_t send_buffer_size =
       256 * 1024;  // The maximum message size to send. Hence, this value should must be in [16 +
                    // value_size, message.max.bytes of the broker - 1024].
-  size_t num_send_buffers = 1024;  // Maximum number of send buffers.
+  size_t num_send_buffers = 1024;  // Maximum number of send buffers. Bounds the amount of data
+                                   // that is queued or in flight at any time.
   bool await_connection =
       false;  // Awaits a handshake with the broker by attempting to queue an empty message.
+  std::string compression_codec = "none";  // Compression of message batches: none, gzip, snappy,
+                                           // lz4 or zstd.
+  int compression_level = -1;  // Codec specific compression level, -1 = codec default.
+  std::string value_precision = "fp32";  // Precision of the values on the wire: fp32, fp16 or fp8
+                                         // (with a scale per value). Values must be float vectors
+                                         // unless fp32 is used. Consumers restore fp32 values.
+  size_t linger_ms = 100;  // How long to wait for more messages to fill a batch.
 };
 
 /**
@@ -62,6 +71,9 @@ class KafkaMessageSink final : public MessageSink<Key, KafkaMessageSinkParams> {
 
   virtual void flush() override;
 
+  size_t num_delivered_success() const { return num_delivered_success_; }
+  size_t num_delivered_failure() const { return num_delivered_failure_; }
+
  protected:
   /**
    * Internally called to find/create Kafka topics.
@@ -97,6 +109,9 @@ class KafkaMessageSink final : public MessageSink<Key, KafkaMessageSinkParams> {
 
   std::chrono::milliseconds queue_full_backoff_delay_ = std::chrono::milliseconds(50);
 
+  // Encoding of the values on the wire, determined by `value_precision`.
+  uint32_t value_prefix_;
+
   std::unordered_map<std::string, rd_kafka_topic_t*> topics_;
 
   // Preallocated buffers to speed up sending.
@@ -128,8 +143,8 @@ class KafkaMessageSink final : public MessageSink<Key, KafkaMessageSinkParams> {
    */
   void on_delivered(const rd_kafka_message_t& msg);
 
-  size_t num_delivered_success_ = 0;
-  size_t num_delivered_failure_ = 0;
+  std::atomic<size_t> num_delivered_success_{0};
+  std::atomic<size_t> num_delivered_failure_{0};
 };
 
 /**
@@ -155,8 +170,8 @@ class KafkaMessageSource final : public MessageSource<Key> {
    * @param receive_buffer_size Size of a receive buffer. This should be identical to the broker's
    * \p send_buffer_size .
    * @param poll_timeout_ms Timeout for downloading messages in milliseconds.
-   * @param max_batch_size Maximum number of key/values that can accumulate before invoking
-   * callback.
+   * @param max_batch_size Maximum number of distinct keys that can accumulate before invoking
+   * callback. Repeated updates of a key in between are merged, only the latest value is delivered.
    * @param failure_backoff_ms In case something bad happened, wait this number of milliseconds.
    * @param max_commit_interval Regardless of the amount of values that are available, after this
    * many messages have been decoded, invoke the callback and commit.
@@ -174,6 +189,7 @@ class KafkaMessageSource final : public MessageSource<Key> {
   size_t num_keys_delivered() const { return num_keys_delivered_; }
   size_t num_keys_committed() const { return num_keys_committed_; }
   size_t num_messages_committed() const { return num_messages_committed_; }
+  size_t num_keys_coalesced() const { return num_keys_coalesced_; }
 
   virtual void engage(std::function<Callback> callback) override;
 
@@ -194,6 +210,7 @@ class KafkaMessageSource final : public MessageSource<Key> {
   size_t num_keys_delivered_ = 0;
   size_t num_keys_committed_ = 0;
   size_t num_messages_committed_ = 0;
+  size_t num_keys_coalesced_ = 0;
 
   void resubscribe();
   void run(std::function<Callback> callback);
@@ -16,7 +16,11 @@
 #pragma once
 
 #include <chrono>
+#include <condition_variable>
+#include <core23/instrumentation.hpp>
+#include <exception>
 #include <hps/lookup_session_base.hpp>
+#include <mutex>
 #include <thread_pool.hpp>
 
 namespace HugeCTR {
@@ -31,6 +35,24 @@ class LookupSession : public LookupSessionBase {
   virtual void lookup_impl(const void* const h_keys, float* const d_vectors, const size_t num_keys,
                            const size_t table_id, cudaStream_t stream) override final;
 
+  // Single table lookups from device of concurrent callers, merged into one embedding cache query
+  // (see `InferenceParams::lookup_batching_window_us`).
+  struct LookupBatch {
+    std::vector<const void*> d_keys;
+    std::vector<float*> d_vectors;
+    std::vector<size_t> num_keys;
+    std::vector<cudaEvent_t> keys_ready;  // Recorded on the stream of each caller, if any.
+    size_t total_num_keys = 0;
+    bool closed = false;
+    bool done = false;
+    std::exception_ptr error;
+  };
+  // Joins or opens the batch of `table_id`. The caller that opened it waits for the window to pass
+  // or for the batch to fill up, and then runs it for all callers.
+  void lookup_from_device_batched(const void* d_keys, float* d_vectors, size_t num_keys,
+                                  size_t table_id, cudaStream_t stream);
+  void run_lookup_batch(LookupBatch& batch, size_t table_id);
+
  public:
   virtual ~LookupSession();
   LookupSession(const InferenceParams& inference_params,
@@ -52,6 +74,8 @@ class LookupSession : public LookupSessionBase {
   virtual void lookup_from_device(const std::vector<const void*>& d_keys_per_table,
                                   const std::vector<float*>& d_vectors_per_table,
                                   const std::vector<size_t>& num_keys_per_table) override final;
+  virtual void lookup_from_device_capturable(const void* d_keys, float* d_vectors, size_t num_keys,
+                                             size_t table_id, cudaStream_t stream) override final;
 
   virtual const InferenceParams get_inference_params() const override { return inference_params_; }
   virtual void set_profiler(int iteration, int warmup, bool enable_bench) {
@@ -80,6 +104,17 @@ class LookupSession : public LookupSessionBase {
 
   ThreadPool table_fusion_thread_pool_;
   const std::chrono::milliseconds wait_duration_{1000};
+
+  std::mutex batching_mutex_;
+  std::condition_variable batching_cv_;
+  std::vector<std::shared_ptr<LookupBatch>> open_batch_per_table_;
+  // A batch runs through the staging buffers of its table, one batch at a time.
+  std::vector<std::unique_ptr<std::mutex>> batch_run_mutex_per_table_;
+  std::vector<size_t> batch_max_keys_per_table_;
+  std::vector<void*> batch_key_buffer_per_table_;
+  std::vector<float*> batch_vec_buffer_per_table_;
+  MetricCounter* num_batches_ = nullptr;
+  MetricCounter* num_batched_requests_ = nullptr;
 };
 
 }  // namespace HugeCTR
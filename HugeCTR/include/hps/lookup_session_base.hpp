@@ -50,6 +50,9 @@ class LookupSessionBase {
   virtual void lookup_from_device(const std::vector<const void*>& d_keys_per_table,
                                   const std::vector<float*>& d_vectors_per_table,
                                   const std::vector<size_t>& num_keys_per_table) = 0;
+  // Lookup that can be captured into a CUDA graph (see `InferenceParams::use_capturable_lookup`).
+  virtual void lookup_from_device_capturable(const void* d_keys, float* d_vectors, size_t num_keys,
+                                             size_t table_id, cudaStream_t stream) = 0;
   virtual const InferenceParams get_inference_params() const = 0;
 
   static std::shared_ptr<LookupSessionBase> create(
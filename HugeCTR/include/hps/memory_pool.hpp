@@ -17,7 +17,11 @@
 
 #include <cuda_runtime_api.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <core23/logger.hpp>
+#include <data_readers/multi_hot/detail/work_queue.hpp>
 #include <hps/embedding_cache.hpp>
 #include <iostream>
 #include <map>
@@ -34,7 +38,6 @@ class MemoryPool;
 
 class MemoryBlock {
  public:
-  MemoryBlock* pNext;  // next mem block
   EmbeddingCacheWorkspace worker_buffer;
   EmbeddingCacheRefreshspace refresh_buffer;
   bool bUsed;        // occupied
@@ -44,15 +47,14 @@ class MemoryBlock {
     this->bBelong = false;
     this->bUsed = false;
     this->pMem = nullptr;
-    this->pNext = nullptr;
   };
 };
 class MemoryPool {
  public:
   MemoryPool(size_t nBlock, std::shared_ptr<EmbeddingCacheBase> embedding_cache,
-             CACHE_SPACE_TYPE cache_type = CACHE_SPACE_TYPE::WORKER) {
-    _nBlock = nBlock;
-    _pHeader = nullptr;
+             CACHE_SPACE_TYPE cache_type = CACHE_SPACE_TYPE::WORKER)
+      : _free_blocks(2 * MAX_MEMORY_SIZE) {
+    _nBlock = std::min<size_t>(nBlock, MAX_MEMORY_SIZE);
     _pBuffer = nullptr;
     _embedding_cache = embedding_cache;
     _device_id = embedding_cache->get_cache_config().cuda_dev_id_;
@@ -70,63 +72,38 @@ class MemoryPool {
       }
     }
   }
+  // Lock-free, unless the pool is exhausted and has to grow.
   void* AllocMemory() {
-    std::lock_guard<std::mutex> lock(_mutex);
     MemoryBlock* pRes = nullptr;
-    if (_pHeader == nullptr) {
-      HCTR_LOG(WARNING, WORLD, "memory pool is empty\n");
-    } else {
-      pRes = _pHeader;
-      _pHeader = _pHeader->pNext;
+    if (!_free_blocks.dequeue(pRes)) {
+      pRes = GrowMemory();
+    }
+    if (pRes) {
+      ++_nUsed;
       pRes->bUsed = true;
     }
     return (void*)(pRes);
   }
 
   void InitMemory(CACHE_SPACE_TYPE space_type = CACHE_SPACE_TYPE::WORKER) {
-    CudaDeviceContext dev_restorer{_device_id};
     if (_pBuffer) return;
-    _Alloc[0] = (MemoryBlock*)(new MemoryBlock());
-    _pBuffer = _Alloc[0];
-    _pHeader = _pBuffer;
-    _pHeader->bUsed = false;
-    _pHeader->bBelong = true;
-    if (space_type == CACHE_SPACE_TYPE::WORKER) {
-      EmbeddingCacheWorkspace worker_buffer = _embedding_cache->create_workspace();
-      _pHeader->worker_buffer = (worker_buffer);
-    }
-    if (space_type == CACHE_SPACE_TYPE::REFRESHER) {
-      EmbeddingCacheRefreshspace refresh_buffer = _embedding_cache->create_refreshspace();
-      _pHeader->refresh_buffer = (refresh_buffer);
-    }
-    _pHeader->pMem = this;
-    MemoryBlock* tmp1 = _pHeader;
-    for (size_t i = 1; i < _nBlock; i++) {
-      _Alloc[i] = (MemoryBlock*)(new MemoryBlock());
-      _Alloc[i]->bUsed = false;
-      _Alloc[i]->pNext = NULL;
-      if (space_type == CACHE_SPACE_TYPE::WORKER) {
-        EmbeddingCacheWorkspace worker_buffer = _embedding_cache->create_workspace();
-        _Alloc[i]->worker_buffer = (worker_buffer);
-      }
-      if (space_type == CACHE_SPACE_TYPE::REFRESHER) {
-        EmbeddingCacheRefreshspace refresh_buffer = _embedding_cache->create_refreshspace();
-        _Alloc[i]->refresh_buffer = (refresh_buffer);
-      }
-      _Alloc[i]->bBelong = true;
-      _Alloc[i]->pMem = this;
-      tmp1->pNext = _Alloc[i];
-      tmp1 = _Alloc[i];
+    for (size_t i = 0; i < _nBlock; i++) {
+      _Alloc[i] = CreateBlock(space_type);
+      _free_blocks.enqueue(_Alloc[i]);
     }
+    _pBuffer = _nBlock ? _Alloc[0] : nullptr;
   }
 
   void FreeMemory(void* p) {
-    std::lock_guard<std::mutex> lock(_mutex);
     MemoryBlock* pBlock = (MemoryBlock*)p;
     if (pBlock->bBelong) {
       pBlock->bUsed = false;
-      pBlock->pNext = _pHeader;
-      _pHeader = pBlock;
+      --_nUsed;
+      // The queue can hold all blocks. It only appears full while another thread is in the middle
+      // of taking a block out of it.
+      while (!_free_blocks.enqueue(pBlock)) {
+        std::this_thread::yield();
+      }
     }
     return;
   }
@@ -146,14 +123,60 @@ class MemoryPool {
     }
   }
 
+ private:
+  MemoryBlock* CreateBlock(CACHE_SPACE_TYPE space_type) {
+    CudaDeviceContext dev_restorer{_device_id};
+    MemoryBlock* pBlock = new MemoryBlock();
+    if (space_type == CACHE_SPACE_TYPE::WORKER) {
+      pBlock->worker_buffer = _embedding_cache->create_workspace();
+    }
+    if (space_type == CACHE_SPACE_TYPE::REFRESHER) {
+      pBlock->refresh_buffer = _embedding_cache->create_refreshspace();
+    }
+    pBlock->bBelong = true;
+    pBlock->pMem = this;
+    return pBlock;
+  }
+
+  // Adds a block to an exhausted pool instead of making the caller wait for a free one.
+  MemoryBlock* GrowMemory() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    // The queue may also appear empty while a block is being returned to it. `_nUsed` may lag
+    // behind, but never overcounts, so only grow the pool once every block is truly in use.
+    MemoryBlock* pRes = nullptr;
+    while (_nUsed < _nBlock) {
+      if (_free_blocks.dequeue(pRes)) {
+        return pRes;
+      }
+      std::this_thread::yield();
+    }
+    if (_free_blocks.dequeue(pRes)) {
+      return pRes;
+    }
+    if (_nBlock >= MAX_MEMORY_SIZE) {
+      HCTR_LOG(WARNING, WORLD, "memory pool is empty\n");
+      return nullptr;
+    }
+    pRes = CreateBlock(_cache_type);
+    _Alloc[_nBlock] = pRes;
+    if (!_pBuffer) {
+      _pBuffer = pRes;
+    }
+    ++_nBlock;
+    HCTR_LOG(INFO, WORLD, "memory pool exhausted, grew to %zu blocks\n", _nBlock.load());
+    return pRes;
+  }
+
  public:
   MemoryBlock* _pBuffer;
-  MemoryBlock* _pHeader;
   std::shared_ptr<EmbeddingCacheBase> _embedding_cache;
   int _device_id;
-  size_t _nBlock;
+  std::atomic<size_t> _nBlock;
+  std::atomic<size_t> _nUsed{0};
+  // Only taken to grow and destroy the pool.
   std::mutex _mutex;
   MemoryBlock* _Alloc[MAX_MEMORY_SIZE];
+  mpmc_bounded_queue<MemoryBlock*> _free_blocks;
   CACHE_SPACE_TYPE _cache_type;
 };
 
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Coalesces concurrent fetches of embedding cache misses for a single table (singleflight). If a
+ * key is already being fetched on behalf of another caller, the result of that fetch is awaited
+ * instead of querying the database tiers again.
+ *
+ * @tparam Key Data-type to be used for keys.
+ */
+template <typename Key>
+class MissCoalescer {
+ public:
+  using FetchFunction = std::function<void(const Key* keys, size_t num_keys, float* vectors)>;
+
+  size_t num_coalesced_keys() const { return num_coalesced_keys_; }
+
+  /**
+   * Resolves the embedding vectors for a batch of keys.
+   *
+   * @param keys The keys to resolve.
+   * @param num_keys Number of \p keys .
+   * @param emb_vec_size Number of floats per embedding vector.
+   * @param vectors Buffer that receives the resolved embedding vectors.
+   * @param fetch Function used to resolve the keys that are not in-flight yet.
+   */
+  void fetch(const Key* keys, size_t num_keys, size_t emb_vec_size, float* vectors,
+             const FetchFunction& fetch);
+
+ private:
+  struct Flight {
+    std::vector<float> vectors;
+    std::promise<void> done;
+    std::shared_future<void> result{done.get_future().share()};
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<Key, std::pair<std::shared_ptr<Flight>, size_t>> in_flight_;
+  std::atomic<size_t> num_coalesced_keys_{0};
+};
+
+}  // namespace HugeCTR
@@ -19,6 +19,7 @@
 #include <cuda_runtime_api.h>
 
 #include <cstdint>
+#include <functional>
 #include <hps/database_backend.hpp>
 #include <hps/quantize.hpp>
 #include <io/filesystem.hpp>
@@ -66,7 +67,11 @@ struct UnifiedEmbeddingTable {
  */
 class IModelLoader {
  public:
-  ~IModelLoader() = default;
+  // Receives the keys, the vectors and the number of keys of a chunk
+  using ChunkConsumer =
+      std::function<void(const void* keys, const void* vectors, size_t num_keys)>;
+
+  virtual ~IModelLoader() = default;
   /**
    * @brief Returns all embedding keys and vectors for a specific number of iterations for cache and
    * uvm
@@ -145,6 +150,15 @@ class IModelLoader {
    */
   virtual std::pair<void*, size_t> getvectors(size_t iteration, size_t emb_size,
                                               bool fp8_quant = false) = 0;
+  /**
+   * Streams the whole table of the last load() through consume, one iteration of keys and vectors
+   * at a time. The next chunk is read, with large sequential reads, while consume processes the
+   * current one, so at most two chunks are held in host memory.
+   *
+   * @param emb_size The embedding vector size
+   * @param consume Called in order for every chunk, on the calling thread
+   */
+  virtual void for_each_chunk(size_t emb_size, const ChunkConsumer& consume) = 0;
 
   virtual void* get_cache_keys() = 0;
   virtual void* get_caceh_vecs() = 0;
@@ -173,8 +187,15 @@ class RawModelLoader : public IModelLoader {
   std::string embedding_folder_path;
   size_t key_num_iteration = 0;
   std::shared_ptr<HugeCTR::Quantize<float, __nv_fp8_e4m3>> quantizer_;
+  // emb_vector holds e4m3 values with the scales in quant_scale, see Model::embedding_export
+  bool prequantized_ = false;
   cudaStream_t stream;
+  // Bound of the vectors of an iteration, if load() chooses the number of keys per iteration
+  static constexpr size_t max_iteration_vector_bytes_{256ull << 20};
   virtual void load_emb(const std::string& table_name, const std::string& path);
+  // Reads the keys and vectors of an iteration into the buffers, returns the number of keys
+  size_t read_iteration_(size_t iteration, size_t emb_size, std::vector<TKey>& keys,
+                         std::vector<TValue>& vectors) const;
 
  public:
   RawModelLoader();
@@ -193,6 +214,7 @@ class RawModelLoader : public IModelLoader {
   virtual std::pair<void*, size_t> getkeys(size_t iteration);
   virtual std::pair<void*, size_t> getvectors(size_t iteration, size_t emb_size,
                                               bool fp8_quant = false);
+  virtual void for_each_chunk(size_t emb_size, const ChunkConsumer& consume);
   virtual void* get_cache_keys();
   virtual void* get_caceh_vecs();
   virtual size_t get_cache_key_count();
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <boost/interprocess/containers/flat_map.hpp>
 #include <boost/interprocess/containers/string.hpp>
 #include <boost/interprocess/containers/vector.hpp>
@@ -24,6 +25,8 @@
 #include <boost/unordered_map.hpp>
 #include <core/macro.hpp>
 #include <hps/database_backend.hpp>
+#include <hps/value_codec.hpp>
+#include <unordered_map>
 
 namespace HugeCTR {
 
@@ -41,6 +44,23 @@ struct MultiProcessHashMapBackendParams final : public VolatileBackendParams {
   std::chrono::nanoseconds heart_beat_frequency{std::chrono::milliseconds{
       100}};               // Frequency at which we tick up the heart-beat frequency counter.
   bool auto_remove{true};  // Remove SHM if this is the last process to detach from the SHM.
+  bool numa_aware{false};  // Move the values of each partition to the NUMA node that accesses
+                           // them most often.
+  DatabaseValueFormat_t value_format{
+      DatabaseValueFormat_t::Float32};  // Format in which the values are stored in shared memory.
+  std::unordered_map<std::string, DatabaseValueFormat_t>
+      table_value_formats;  // Overrides `value_format` for individual tables.
+};
+
+struct MultiProcessHashMapBackendNumaStats final {
+  size_t num_local_accesses{0};     // Keys fetched from partitions on the caller's NUMA node.
+  size_t num_remote_accesses{0};    // Keys fetched from partitions on another NUMA node.
+  size_t num_unplaced_accesses{0};  // Keys fetched from partitions that were not placed yet.
+
+  inline double remote_ratio() const {
+    const size_t n{num_local_accesses + num_remote_accesses};
+    return n ? static_cast<double>(num_remote_accesses) / static_cast<double>(n) : 0;
+  }
 };
 
 template <typename Key>
@@ -90,6 +110,12 @@ class MultiProcessHashMapBackend final
   size_t dump_sst(const std::string& table_name, rocksdb::SstFileWriter& file) override;
 #endif  // HCTR_USE_ROCKS_DB
 
+  /**
+   * Cross-socket traffic of \p table_name , accumulated by all connected processes. Only recorded
+   * if `numa_aware` is enabled.
+   */
+  MultiProcessHashMapBackendNumaStats numa_stats(const std::string& table_name) const;
+
  protected:
   using Segment = boost::interprocess::managed_shared_memory;
   template <typename T>
@@ -110,6 +136,7 @@ class MultiProcessHashMapBackend final
 
  protected:
   static constexpr size_t value_page_alignment{1};
+  static constexpr size_t max_numa_nodes{8};
 
   using ValuePage = SharedVector<char>;
   using ValuePtr = boost::interprocess::offset_ptr<char>;
@@ -119,13 +146,16 @@ class MultiProcessHashMapBackend final
     union {
       time_t last_access;
       uint64_t access_count;
+      uint64_t referenced;
     };
     ValuePtr value;
   };
   using Entry = std::pair<const Key, Payload>;
 
   struct Partition final {
-    uint32_t value_size;
+    uint32_t value_size;  // Size of the values passed to `insert` and returned by `fetch`.
+    DatabaseValueFormat_t value_format;
+    uint32_t encoded_value_size;  // Size of the values in the value pages.
     size_t allocation_rate;
     size_t overflow_margin;
     DatabaseOverflowPolicy_t overflow_policy;
@@ -138,11 +168,22 @@ class MultiProcessHashMapBackend final
     // Key -> Payload map.
     SharedFlatMap<Key, Payload> entries;
 
+    // NUMA placement. Counters are shared by all processes and updated atomically.
+    int numa_node{-1};
+    size_t num_placed_pages{0};
+    uint64_t num_node_accesses[max_numa_nodes]{};
+    uint64_t num_local_accesses{0};
+    uint64_t num_remote_accesses{0};
+    uint64_t num_unplaced_accesses{0};
+
     Partition() = delete;
 
-    Partition(const uint32_t value_size, const MultiProcessHashMapBackendParams& params,
-              Segment& segment)
+    Partition(const uint32_t value_size, const DatabaseValueFormat_t value_format,
+              const MultiProcessHashMapBackendParams& params, Segment& segment)
         : value_size{value_size},
+          value_format{value_format},
+          encoded_value_size{
+              static_cast<uint32_t>(HugeCTR::encoded_value_size(value_format, value_size))},
           allocation_rate{params.allocation_rate},
           overflow_margin{params.overflow_margin},
           overflow_policy{params.overflow_policy},
@@ -150,6 +191,27 @@ class MultiProcessHashMapBackend final
           value_pages(segment.get_allocator<ValuePage>()),
           value_slots(segment.get_allocator<ValuePtr>()),
           entries(segment.get_allocator<Entry>()) {}
+
+    inline size_t value_stride() const {
+      return (encoded_value_size + value_page_alignment - 1) / value_page_alignment *
+             value_page_alignment;
+    }
+
+    inline void encode_value(const char* const value, const ValuePtr& encoded) const {
+      if (value_format == DatabaseValueFormat_t::Float32) {
+        std::copy_n(value, value_size, encoded.get());
+      } else {
+        HugeCTR::encode_value(value_format, value, value_size, encoded.get());
+      }
+    }
+
+    inline void decode_value(const ValuePtr& encoded, char* const value) const {
+      if (value_format == DatabaseValueFormat_t::Float32) {
+        std::copy_n(encoded.get(), value_size, value);
+      } else {
+        HugeCTR::decode_value(value_format, encoded.get(), value_size, value);
+      }
+    }
   };
 
   struct SharedMemory final {
@@ -188,6 +250,10 @@ class MultiProcessHashMapBackend final
 
   // Overflow resolution.
   size_t resolve_overflow_(const std::string& table_name, size_t part_index, Partition& part);
+
+  // NUMA placement.
+  void record_numa_access_(Partition& part, int numa_node, size_t num_accesses) const;
+  void place_partition_(const std::string& table_name, size_t part_index, Partition& part);
 };
 
 // TODO: Remove me!
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <core23/instrumentation.hpp>
+#include <hps/database_backend.hpp>
+#include <hps/hash_map_backend.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace HugeCTR {
+
+// TODO: Remove me!
+#pragma GCC diagnostic push
+#pragma GCC diagnostic error "-Wconversion"
+
+/**
+ * \p DatabaseBackend implementation that keeps the recently fetched values of a shared backend
+ * (e.g., a Redis cluster) in a bounded \p HashMapBackend of this process, so that hot keys are
+ * served without a network round trip. Everything else is delegated to the shared backend.
+ *
+ * The near cache is kept coherent by
+ *   - evicting the keys that are inserted or evicted through this backend, including the updates
+ *     received through an update source, and those passed to \p invalidate ; and
+ *   - dropping all its entries every \p ttl , which bounds the staleness of values that were
+ *     updated by other processes without notifying this one.
+ *
+ * @tparam Key The data-type that is used for keys in this database.
+ */
+template <typename Key>
+class NearCacheBackend final : public DatabaseBackendBase<Key> {
+ public:
+  using Base = DatabaseBackendBase<Key>;
+
+  HCTR_DISALLOW_COPY_AND_MOVE(NearCacheBackend);
+
+  NearCacheBackend() = delete;
+
+  /**
+   * @param backend The shared backend, which is owned by the near cache from now on.
+   * @param near_cache_params Parameters of the near cache. Its capacity is bounded by
+   * `overflow_margin` per partition.
+   * @param ttl Time after which the entries are dropped (`zero` = never).
+   */
+  NearCacheBackend(std::unique_ptr<Base> backend, const HashMapBackendParams& near_cache_params,
+                   const std::chrono::milliseconds& ttl);
+
+  const char* get_name() const override { return name_.c_str(); }
+
+  bool is_shared() const override { return backend_->is_shared(); }
+
+  size_t capacity(const std::string& table_name) const override {
+    return backend_->capacity(table_name);
+  }
+
+  size_t size(const std::string& table_name) const override { return backend_->size(table_name); }
+
+  size_t contains(const std::string& table_name, size_t num_keys, const Key* keys,
+                  const std::chrono::nanoseconds& time_budget) const override;
+
+  size_t insert(const std::string& table_name, size_t num_pairs, const Key* keys,
+                const char* values, uint32_t value_size, size_t value_stride) override;
+
+  size_t fetch(const std::string& table_name, size_t num_keys, const Key* keys, char* values,
+               size_t value_stride, const DatabaseMissCallback& on_miss,
+               const std::chrono::nanoseconds& time_budget) override;
+
+  size_t fetch(const std::string& table_name, size_t num_indices, const size_t* indices,
+               const Key* keys, char* values, size_t value_stride,
+               const DatabaseMissCallback& on_miss,
+               const std::chrono::nanoseconds& time_budget) override;
+
+  size_t evict(const std::string& table_name) override;
+
+  size_t evict(const std::string& table_name, size_t num_keys, const Key* keys) override;
+
+  std::vector<std::string> find_tables(const std::string& model_name) override {
+    return backend_->find_tables(model_name);
+  }
+
+  size_t dump_bin(const std::string& table_name, std::ofstream& file) override {
+    return backend_->dump_bin(table_name, file);
+  }
+
+  size_t dump_bin(const std::string& table_name, const std::string& path) override {
+    return backend_->dump_bin(table_name, path);
+  }
+
+#ifdef HCTR_USE_ROCKS_DB
+  size_t dump_sst(const std::string& table_name, rocksdb::SstFileWriter& file) override {
+    return backend_->dump_sst(table_name, file);
+  }
+#endif  // HCTR_USE_ROCKS_DB
+
+  /**
+   * Drops keys from the near cache only, because they were updated in the shared backend by
+   * another process.
+   *
+   * @return The number of keys that were in the near cache.
+   */
+  size_t invalidate(const std::string& table_name, size_t num_keys, const Key* keys);
+
+ protected:
+  /**
+   * Drops all entries of the near cache if the \p ttl has elapsed since they were last dropped.
+   */
+  void expire_();
+
+  /**
+   * Fetches the keys referenced by \p indices from the shared backend, and puts those that were
+   * found into the near cache.
+   */
+  size_t fetch_from_backend_(const std::string& table_name, const std::vector<size_t>& indices,
+                             const Key* keys, char* values, size_t value_stride,
+                             const DatabaseMissCallback& on_miss,
+                             const std::chrono::nanoseconds& time_budget);
+
+  const std::unique_ptr<Base> backend_;
+  const std::unique_ptr<HashMapBackend<Key>> near_cache_;
+  const std::chrono::nanoseconds ttl_;
+  const std::string name_;
+
+  std::atomic<std::chrono::steady_clock::rep> next_expiry_;
+  std::mutex tables_guard_;
+  std::unordered_set<std::string> tables_;  // Tables that have entries in the near cache.
+
+  MetricCounter* num_hits_;
+  MetricCounter* num_misses_;
+};
+
+// TODO: Remove me!
+#pragma GCC diagnostic pop
+
+}  // namespace HugeCTR
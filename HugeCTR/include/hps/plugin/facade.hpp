@@ -44,6 +44,20 @@ class Facade final {
   void forward(const char* model_name, const int32_t table_id, const int32_t global_replica_id,
                const size_t num_keys, const size_t emb_vec_size, const void* d_keys,
                void* d_vectors, bool i64_input_tensor, cudaStream_t context_stream);
+
+  // Lookup of all the tables of the model in one call, d_keys[i] holds the keys of table i
+  void forward(const char* model_name, const int32_t global_replica_id,
+               const std::vector<size_t>& num_keys, const std::vector<size_t>& emb_vec_sizes,
+               const std::vector<const void*>& d_keys, const std::vector<void*>& d_vectors,
+               bool i64_input_tensor, cudaStream_t context_stream);
+
+  // Whether forward returns once the lookup is enqueued on context_stream
+  bool is_stream_ordered(const char* model_name) const;
+
+  // Writes the rows of a table that live on the device of global_replica_id into HPS
+  void update(const char* model_name, const int32_t table_id, const int32_t global_replica_id,
+              const size_t num_keys, const size_t emb_vec_size, const void* d_keys,
+              const float* d_vectors, bool i64_input_tensor, cudaStream_t context_stream);
 };
 
 }  // namespace HierarchicalParameterServer
\ No newline at end of file
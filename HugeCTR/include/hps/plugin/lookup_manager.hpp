@@ -46,6 +46,27 @@ class LookupManager final {
                const void* values_ptr, void* emb_vector_ptr, bool i64_input_tensor,
                cudaStream_t context_stream);
 
+  // Looks up all the tables of the model at once, values_ptrs[i] holds the keys of table i. The
+  // tables are queried concurrently (and together when they are fused) instead of one by one,
+  // unless the lookups have to run on the context stream.
+  void forward(const std::string& model_name, const int32_t global_replica_id,
+               const std::vector<size_t>& num_keys_per_table,
+               const std::vector<size_t>& emb_vec_size_per_table,
+               const std::vector<const void*>& values_ptrs,
+               const std::vector<void*>& emb_vector_ptrs, bool i64_input_tensor,
+               cudaStream_t context_stream);
+
+  // Writes num_keys rows from the device of global_replica_id into the table, e.g. the trained
+  // table of a model in the same process. Nothing goes through the model files.
+  void update(const std::string& model_name, const int32_t table_id,
+              const int32_t global_replica_id, const size_t num_keys, const size_t emb_vec_size,
+              const void* d_keys, const float* d_vectors, bool i64_input_tensor,
+              cudaStream_t context_stream);
+
+  // Whether forward only enqueues work on the context stream, without waiting on the host. The
+  // caller can then return right away and let the stream order the lookup with its other work.
+  bool is_stream_ordered(const std::string& model_name) const;
+
   bool init_check(parameter_server_config& ps_config, const int32_t global_batch_size,
                   const int32_t num_replicas_in_sync, pluginType_t plugin_type) const;
 
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <core/macro.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace HugeCTR {
+
+/**
+ * Header of a pre-hashed table file. The sections follow at page aligned offsets.
+ */
+struct PrehashedTableHeader final {
+  char magic[8];
+  uint32_t version;
+  uint32_t key_size;     // Size of a key in bytes.
+  uint64_t value_size;   // Size of a value in bytes.
+  uint64_t num_keys;     // Number of distinct keys.
+  uint64_t num_rows;     // Number of values, the rows of the raw model.
+  uint64_t num_slots;    // Number of hash table slots, a power of 2.
+  uint64_t keys_offset;  // num_slots + 1 keys.
+  uint64_t rows_offset;  // num_slots + 1 uint32 rows.
+  uint64_t values_offset;
+};
+
+/**
+ * An embedding table stored as a ready-made hash table, so that HPS maps it into memory at startup
+ * instead of parsing the raw model and hashing every key.
+ *
+ * The layout is the one of the GPU static table (gpu_cache::StaticHashTable), which can copy it as
+ * is: the keys are open-addressed in num_slots slots by MurmurHash3_32 and probed in groups of 16
+ * slots, with one extra slot for the key ~0, and every slot holds the row of its value. The values
+ * are the rows of the raw model in file order. The file is written by write() next to the raw
+ * model, and is only valid for a static table of num_rows keys, or the capacity given to write().
+ *
+ * @tparam Key The key type, which must be the key type of the file.
+ */
+template <typename Key>
+class PrehashedTable final {
+ public:
+  HCTR_DISALLOW_COPY_AND_MOVE(PrehashedTable);
+
+  static constexpr Key empty_key{static_cast<Key>(~static_cast<Key>(0))};
+  static constexpr uint64_t group_size{16};
+
+  // Maps the file read-only.
+  PrehashedTable(const std::string& path);
+
+  ~PrehashedTable();
+
+  inline size_t num_keys() const { return header_->num_keys; }
+  inline size_t num_rows() const { return header_->num_rows; }
+  inline size_t num_slots() const { return header_->num_slots; }
+  inline size_t value_size() const { return header_->value_size; }
+
+  inline const Key* keys() const { return keys_; }
+  inline const uint32_t* rows() const { return rows_; }
+  inline const char* values() const { return values_; }
+
+  // The value of a key, nullptr if the table does not contain it.
+  const char* find(Key key) const;
+
+  // The path of the pre-hashed table of a raw model folder.
+  static std::string default_path(const std::string& model_path);
+
+  /**
+   * Builds the pre-hashed table of a raw model folder (`key` and `emb_vector` files). Only the keys
+   * are held in memory, the values are copied in chunks. A key that occurs twice keeps its first
+   * value.
+   *
+   * @param model_path The raw model folder.
+   * @param path The file to write, default_path(model_path) if empty.
+   * @param capacity The number of keys of the static tables to load it into, the number of rows of
+   * the model if 0.
+   */
+  static void write(const std::string& model_path, const std::string& path = "",
+                    size_t capacity = 0);
+
+  // The number of slots of a static table of this capacity.
+  static size_t num_slots_for(size_t capacity);
+
+ private:
+  void* data_{nullptr};
+  size_t size_{0};
+  const PrehashedTableHeader* header_{nullptr};
+  const Key* keys_{nullptr};
+  const uint32_t* rows_{nullptr};
+  const char* values_{nullptr};
+};
+
+}  // namespace HugeCTR
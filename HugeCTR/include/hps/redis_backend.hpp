@@ -35,6 +35,8 @@ struct RedisClusterBackendParams final : public VolatileBackendParams {
 
   size_t num_node_connections{5};  // Maximum number of simultaneous connections that are formed
                                    // with the same redis server node.
+  size_t max_pipeline_depth{4};    // Maximum number of `max_batch_size` sized queries that are
+                                   // sent to a node in a single round-trip.
 
   bool enable_tls{
       false};  // If true, connections formed with server nodes will be secured using SSL/TLS.
@@ -152,7 +154,7 @@ class RedisClusterBackend final : public VolatileBackend<Key, RedisClusterBacken
   std::unique_ptr<sw::redis::RedisCluster> redis_;
 
   // Worker used to update timestamps and carry out overflow handling.
-  mutable ThreadPool background_worker_{"redis bg worker", 1};
+  mutable ThreadPool background_worker_{"redis bg worker", TaskPriority::Refresh, 1};
 };
 
 #endif  // HCTR_USE_REDIS
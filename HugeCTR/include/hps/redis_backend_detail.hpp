@@ -211,7 +211,8 @@ class RedisDirectValueInserter final
                                   char* const values, const size_t value_stride,
                                   const std::function<void(size_t)>& on_miss, size_t& miss_count,
                                   const DatabaseOverflowPolicy_t overflow_policy,
-                                  std::shared_ptr<std::vector<Key>>& touched_keys)
+                                  std::shared_ptr<std::vector<Key>>& touched_keys,
+                                  const size_t k_views_offset = 0)
       : keys{keys},
         k_views{&k_views},
         values{values},
@@ -219,7 +220,8 @@ class RedisDirectValueInserter final
         on_miss{&on_miss},
         miss_count(&miss_count),
         overflow_policy{overflow_policy},
-        touched_keys{&touched_keys} {}
+        touched_keys{&touched_keys},
+        index{k_views_offset} {}
 
   inline RedisDirectValueInserter& operator=(sw::redis::Optional<sw::redis::StringView>&& v_view) {
     const Key* const k{reinterpret_cast<const Key*>(k_views->at(index++).data())};
@@ -254,7 +256,7 @@ class RedisDirectValueInserter final
   size_t* const miss_count;
   const DatabaseOverflowPolicy_t overflow_policy;
   std::shared_ptr<std::vector<Key>>* touched_keys;
-  size_t index{0};
+  size_t index;
 };
 
 /**
@@ -355,62 +357,43 @@ class RedisBinFileInserter final
 
 /**
  * Redis Backend / Fetch
+ *
+ * `HCTR_HPS_REDIS_FETCH_QUEUE_` appends one `HMGET` batch to the pipeline `pipe`.
+ * `HCTR_HPS_REDIS_FETCH_EXEC_` sends all queued batches in a single round-trip, and deserializes
+ * the responses directly into `values`.
  */
-#ifdef HCTR_HPS_REDIS_FETCH_
-#error HCTR_HPS_REDIS_FETCH_ already defined. Potential naming conflict!
+#ifdef HCTR_HPS_REDIS_FETCH_QUEUE_
+#error HCTR_HPS_REDIS_FETCH_QUEUE_ already defined. Potential naming conflict!
 #endif
-#if 0
-#define HCTR_HPS_REDIS_FETCH_DEFINE_V_VIEWS() std::vector<sw::redis::Optional<std::string>> v_views
-#define HCTR_HPS_REDIS_FETCH_(MODE)                                                                \
-  [&]() {                                                                                          \
-    static_assert(std::is_same_v<decltype(miss_count), size_t>);                                   \
-    static_assert(std::is_same_v<decltype(k_views), std::vector<sw::redis::StringView>>);          \
-                                                                                                   \
-    k_views.clear();                                                                               \
-    HCTR_HPS_DB_APPLY_(MODE, k_views.emplace_back(reinterpret_cast<const char*>(k), sizeof(Key))); \
-                                                                                                   \
-    v_views.clear();                                                                               \
-    v_views.reserve(k_views.size());                                                               \
-    redis_->hmget(hkey_v, k_views.begin(), k_views.end(), std::back_inserter(v_views));            \
-                                                                                                   \
-    for (auto v_it{v_views.begin()}; v_it != v_views.end(); ++v_it) {                              \
-      const Key* const k{reinterpret_cast<const Key*>(k_views[v_it - v_views.begin()].data())};    \
-      const sw::redis::Optional<std::string>& v_view{*v_it};                                       \
-      if (v_view) {                                                                                \
-        HCTR_CHECK(v_view->size() <= value_stride);                                                \
-        std::copy(v_view->begin(), v_view->end(), &values[(k - keys) * value_stride]);             \
-                                                                                                   \
-        if (this->params_.overflow_policy != DatabaseOverflowPolicy_t::EvictRandom) {              \
-          if (!touched_keys) {                                                                     \
-            touched_keys = std::make_shared<std::vector<Key>>();                                   \
-          }                                                                                        \
-          touched_keys->emplace_back(keys[k - keys]);                                              \
-        }                                                                                          \
-      } else {                                                                                     \
-        on_miss(k - keys);                                                                         \
-        ++miss_count;                                                                              \
-      }                                                                                            \
-    }                                                                                              \
-    return true;                                                                                   \
-  }()
-#else
-#define HCTR_HPS_REDIS_FETCH_DEFINE_V_VIEWS() \
-  do {                                        \
-  } while (0)
-#define HCTR_HPS_REDIS_FETCH_(MODE)                                                                \
+#define HCTR_HPS_REDIS_FETCH_QUEUE_(MODE)                                                          \
   [&]() {                                                                                          \
     static_assert(std::is_same_v<decltype(k_views), std::vector<sw::redis::StringView>>);          \
+    static_assert(std::is_same_v<decltype(batch_offsets), std::vector<size_t>>);                   \
                                                                                                    \
-    k_views.clear();                                                                               \
+    const size_t batch_offset{k_views.size()};                                                     \
     HCTR_HPS_DB_APPLY_(MODE, k_views.emplace_back(reinterpret_cast<const char*>(k), sizeof(Key))); \
                                                                                                    \
-    redis_->hmget(                                                                                 \
-        hkey_v, k_views.begin(), k_views.end(),                                                    \
-        RedisDirectValueInserter<Key>(keys, k_views, values, value_stride, on_miss, miss_count,    \
-                                      this->params_.overflow_policy, touched_keys));               \
+    batch_offsets.emplace_back(batch_offset);                                                      \
+    pipe.hmget(hkey_v, std::next(k_views.begin(), static_cast<ptrdiff_t>(batch_offset)),           \
+               k_views.end());                                                                     \
     return true;                                                                                   \
   }()
+
+#ifdef HCTR_HPS_REDIS_FETCH_EXEC_
+#error HCTR_HPS_REDIS_FETCH_EXEC_ already defined. Potential naming conflict!
 #endif
+#define HCTR_HPS_REDIS_FETCH_EXEC_()                                                          \
+  [&]() {                                                                                     \
+    sw::redis::QueuedReplies replies{pipe.exec()};                                            \
+    HCTR_CHECK(replies.size() == batch_offsets.size());                                       \
+                                                                                              \
+    for (size_t idx{0}; idx < replies.size(); ++idx) {                                        \
+      replies.get(idx, RedisDirectValueInserter<Key>(                                         \
+                           keys, k_views, values, value_stride, on_miss, miss_count,          \
+                           this->params_.overflow_policy, touched_keys, batch_offsets[idx])); \
+    }                                                                                         \
+    return true;                                                                              \
+  }()
 
 #ifdef HCTR_HPS_REDIS_INSERT_
 #error HCTR_HPS_REDIS_INSERT_ already defined. Potential naming conflict!
@@ -464,6 +447,16 @@ class RedisBinFileInserter final
         });                                                                                    \
         pipe.hset(hkey_m, km_views.begin(), km_views.end());                                   \
       } break;                                                                                 \
+      case DatabaseOverflowPolicy_t::EvictClock: {                                             \
+        HCTR_HPS_DB_APPLY_(MODE, {                                                             \
+          kv_views.emplace_back(                                                               \
+              std::piecewise_construct,                                                        \
+              std::forward_as_tuple(reinterpret_cast<const char*>(k), sizeof(Key)),            \
+              std::forward_as_tuple(&values[(k - keys) * value_stride], value_size));          \
+          /* New entries start unreferenced. Updates must not alter the reference bit. */      \
+          pipe.hsetnx(hkey_m, {reinterpret_cast<const char*>(k), sizeof(Key)}, "0");           \
+        });                                                                                    \
+      } break;                                                                                 \
     }                                                                                          \
     pipe.hset(hkey_v, kv_views.begin(), kv_views.end());                                       \
     pipe.hlen(hkey_v);                                                                         \
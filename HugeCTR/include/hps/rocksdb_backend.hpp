@@ -21,7 +21,10 @@
 #include <unordered_map>
 
 #ifdef HCTR_USE_ROCKS_DB
+#include <rocksdb/cache.h>
 #include <rocksdb/db.h>
+#include <rocksdb/filter_policy.h>
+#include <rocksdb/table.h>
 #endif  // HCTR_USE_ROCKS_DB
 
 namespace HugeCTR {
@@ -36,10 +39,18 @@ struct RocksDBBackendParams final : public PersistentBackendParams {
   bool read_only{
       false};  // If \p true will open the database in \p read-only mode. This allows simultaneously
                // querying the same RocksDB database from multiple clients.
+  size_t block_cache_size{8L * 1024 * 1024};  // Size of the block cache shared by all tables.
+  size_t bloom_filter_bits{10};  // Bits per key of the bloom filters (0 = no filters).
+  bool use_direct_reads{false};  // If \p true, bypasses the OS page cache when reading.
+  size_t bulk_load_file_size{256L * 1024 * 1024};  // Target size of the SST files written by a
+                                                   // \p RocksDBBulkLoader .
 };
 
 #ifdef HCTR_USE_ROCKS_DB
 
+template <typename Key>
+class RocksDBBulkLoader;
+
 /**
  * \p DatabaseBackend implementation that connects to a RocksDB to store/retrieve information (i.e.
  * harddisk storage).
@@ -96,6 +107,8 @@ class RocksDBBackend final : public PersistentBackend<Key, RocksDBBackendParams>
   size_t load_dump_sst(const std::string& table_name, const std::string& path) override;
 
  protected:
+  friend class RocksDBBulkLoader<Key>;
+
   inline rocksdb::ColumnFamilyHandle* get_column_handle_(const std::string& table_name) const {
     const auto& it{column_handles_.find(table_name)};
     return it != column_handles_.end() ? it->second : nullptr;
@@ -122,6 +135,68 @@ class RocksDBBackend final : public PersistentBackend<Key, RocksDBBackendParams>
   rocksdb::IngestExternalFileOptions ingest_file_options_;
 };
 
+/**
+ * Loads a large number of key/value pairs into a table of a \p RocksDBBackend , bypassing its
+ * write path. The pairs are spilled to one file per key range while they are added. finish() then
+ * sorts the ranges and writes each of them to an SST file in parallel, and ingests all the files
+ * at once. The auto-compactions of the table are disabled meanwhile.
+ *
+ * The ranges are chosen so that each SST file has about `bulk_load_file_size` bytes. This bounds
+ * the memory used by finish() to that size per thread of the database.
+ *
+ * @tparam Key The data-type that is used for keys in this database.
+ */
+template <typename Key>
+class RocksDBBulkLoader final {
+ public:
+  HCTR_DISALLOW_COPY_AND_MOVE(RocksDBBulkLoader);
+
+  RocksDBBulkLoader() = delete;
+
+  /**
+   * @param db The database.
+   * @param table_name The table to load the pairs into.
+   * @param num_pairs_hint Roughly the number of pairs that will be added.
+   * @param value_size The size of each value in bytes.
+   */
+  RocksDBBulkLoader(RocksDBBackend<Key>& db, const std::string& table_name, size_t num_pairs_hint,
+                    uint32_t value_size);
+
+  /**
+   * Removes the spilled pairs, and turns the auto-compactions back on if finish() was not called.
+   */
+  ~RocksDBBulkLoader();
+
+  /**
+   * Adds pairs, which override the values of the same keys added earlier or already in the table.
+   */
+  void add(size_t num_pairs, const Key* keys, const char* values, size_t value_stride);
+
+  /**
+   * Ingests all pairs added so far into the table.
+   *
+   * @return The number of distinct keys ingested.
+   */
+  size_t finish();
+
+ protected:
+  size_t range_of_(Key key) const;
+
+  std::filesystem::path range_path_(size_t range) const;
+
+  void enable_auto_compactions_(bool enable);
+
+  RocksDBBackend<Key>& db_;
+  const std::string table_name_;
+  const uint32_t value_size_;
+  const std::filesystem::path dir_;
+  rocksdb::ColumnFamilyHandle* const ch_;
+  size_t num_ranges_;
+  std::vector<size_t> range_sizes_;  // Number of pairs spilled per range.
+  ThreadPool workers_;
+  bool finished_{false};
+};
+
 #endif  // HCTR_USE_ROCKS_DB
 
 // TODO: Remove me!
@@ -29,6 +29,10 @@ namespace HugeCTR {
 
 /**
  * RocksDB Backend / Fetch
+ *
+ * Uses the batched `MultiGet` API, which sorts the keys with the comparator of the column family,
+ * and reads values as `PinnableSlice`s. Thus, values are copied directly from the block cache into
+ * `values`, without intermediate `std::string` allocations.
  */
 #ifdef HCTR_HPS_ROCKSDB_FETCH_
 #error HCTR_HPS_ROCKSDB_FETCH_ already defined. Potential naming conflict!
@@ -37,24 +41,25 @@ namespace HugeCTR {
   [&]() {                                                                                          \
     static_assert(std::is_same_v<decltype(miss_count), size_t>);                                   \
     static_assert(std::is_same_v<decltype(k_views), std::vector<rocksdb::Slice>>);                 \
-    static_assert(std::is_same_v<decltype(v_views), std::vector<std::string>>);                    \
+    static_assert(std::is_same_v<decltype(v_views), std::vector<rocksdb::PinnableSlice>>);         \
+    static_assert(std::is_same_v<decltype(statuses), std::vector<rocksdb::Status>>);               \
                                                                                                    \
     k_views.clear();                                                                               \
     HCTR_HPS_DB_APPLY_(MODE, k_views.emplace_back(reinterpret_cast<const char*>(k), sizeof(Key))); \
-    col_handles.resize(k_views.size(), ch);                                                        \
                                                                                                    \
-    v_views.clear();                                                                               \
-    v_views.reserve(col_handles.size());                                                           \
-    const std::vector<rocksdb::Status>& statuses{                                                  \
-        db_->MultiGet(read_options_, col_handles, k_views, &v_views)};                             \
+    v_views.resize(k_views.size());                                                                \
+    statuses.resize(k_views.size());                                                               \
+    db_->MultiGet(read_options_, ch, k_views.size(), k_views.data(), v_views.data(),               \
+                  statuses.data());                                                                \
                                                                                                    \
-    for (size_t idx{0}; idx < batch_size; ++idx) {                                                 \
+    for (size_t idx{0}; idx < k_views.size(); ++idx) {                                             \
       const Key* const k{reinterpret_cast<const Key*>(k_views[idx].data())};                       \
       const rocksdb::Status& s{statuses[idx]};                                                     \
       if (s.ok()) {                                                                                \
-        const std::string& v_view{v_views[idx]};                                                   \
+        rocksdb::PinnableSlice& v_view{v_views[idx]};                                              \
         HCTR_CHECK(v_view.size() <= value_stride);                                                 \
-        std::copy(v_view.begin(), v_view.end(), &values[(k - keys) * value_stride]);               \
+        std::copy_n(v_view.data(), v_view.size(), &values[(k - keys) * value_stride]);             \
+        v_view.Reset();                                                                            \
       } else if (s.IsNotFound()) {                                                                 \
         on_miss(k - keys);                                                                         \
         ++miss_count;                                                                              \
@@ -51,6 +51,10 @@ class StaticTable : public EmbeddingCacheBase,
                     cudaStream_t stream) override;
   virtual void refresh(size_t table_id, const void* d_keys, const void* d_vectors, size_t length,
                        cudaStream_t stream) override;
+  virtual void finish_refresh(size_t table_id, cudaStream_t stream) override;
+  virtual bool init_prehashed(size_t table_id, const void* keys, const uint32_t* rows,
+                              size_t num_slots, const void* vectors, size_t num_rows,
+                              cudaStream_t stream) override;
 
   virtual EmbeddingCacheWorkspace create_workspace() override;
   virtual void destroy_workspace(EmbeddingCacheWorkspace&) override;
@@ -83,6 +87,13 @@ class StaticTable : public EmbeddingCacheBase,
 
   void* d_insert_keys_buffer_;
 
+  // Tables that serve lookups already receive new contents as a new generation, which replaces the
+  // previous one in `finish_refresh`.
+  std::vector<bool> table_initialized_;
+  std::vector<bool> building_generation_;
+  void add_to_table(size_t table_id, const TypeHashKey* d_keys, const TypeEmbVec* vectors,
+                    const float* quant_scales, size_t length, cudaStream_t stream);
+
   // The parameter server that it is bound to
   HierParameterServerBase* parameter_server_;
 
@@ -68,8 +68,19 @@ class UvmTable : public EmbeddingCacheBase,
     ec_profiler_->set_config(iteration, warmup, enable_bench);
   };
 
+  /**
+   * Shards the device-resident keys of all embedding tables across the caches of one model (one
+   * per device, in the same order on all calls). Must be called before the caches are initialized.
+   */
+  static void connect_shards(const std::vector<std::shared_ptr<UvmTable>>& shards);
+
  private:
+  static const size_t BLOCK_SIZE_ = 64;
+
   using Cache = gpu_cache::UvmTable<TypeHashKey, size_t>;
+  using UniqueOp =
+      unique_op::unique_op<TypeHashKey, uint64_t, std::numeric_limits<TypeHashKey>::max(),
+                           std::numeric_limits<uint64_t>::max()>;
 
   // This function is not used for static table
   virtual const std::vector<cudaStream_t>& get_insert_streams() { return refresh_streams_; }
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <hps/inference_utils.hpp>
+#include <string>
+
+namespace HugeCTR {
+
+/**
+ * Conversion of the `float` embedding vectors that are passed to \p DatabaseBackend::insert into
+ * the compact representation in which a volatile database stores them, and back. The formats are
+ *   - \p Float32 : Stored as is.
+ *   - \p Float16 / \p BFloat16 : 2 bytes per element, rounded to nearest even.
+ *   - \p FP8 : A `float` scale, followed by 1 byte (e4m3) per element. As in `quantize.cu`, the
+ *     scale maps the largest magnitude of the vector to the largest finite e4m3 value.
+ *
+ * Values whose size is not a multiple of `sizeof(float)` can only be stored as \p Float32 .
+ */
+
+/**
+ * @return Whether values of \p value_size bytes can be stored in \p format .
+ */
+inline bool is_value_format_applicable(const DatabaseValueFormat_t format,
+                                       const size_t value_size) {
+  return format == DatabaseValueFormat_t::Float32 || value_size % sizeof(float) == 0;
+}
+
+/**
+ * @return The format in which a volatile backend with \p params stores the values of
+ * \p table_name .
+ */
+template <typename Params>
+inline DatabaseValueFormat_t table_value_format(const Params& params,
+                                                const std::string& table_name) {
+  const auto& it{params.table_value_formats.find(table_name)};
+  return it != params.table_value_formats.end() ? it->second : params.value_format;
+}
+
+/**
+ * @return The number of bytes needed to store a value of \p value_size bytes in \p format .
+ */
+size_t encoded_value_size(DatabaseValueFormat_t format, size_t value_size);
+
+/**
+ * Converts a vector of `value_size / sizeof(float)` floats into \p format .
+ */
+void encode_value(DatabaseValueFormat_t format, const char* value, size_t value_size,
+                  char* encoded);
+
+/**
+ * Converts a value stored in \p format back into `value_size / sizeof(float)` floats.
+ */
+void decode_value(DatabaseValueFormat_t format, const char* encoded, size_t value_size,
+                  char* value);
+
+}  // namespace HugeCTR
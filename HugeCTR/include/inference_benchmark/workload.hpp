@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Draws keys from [0, num_keys) like the scrambled Zipfian generator of YCSB (Gray et al., "Quickly
+ * Generating Billion-Record Synthetic Databases"). The popularity ranks are hashed to keys, so that
+ * the hot keys are spread over the partitions of the database. theta = 0 draws uniform keys.
+ */
+class KeyGenerator {
+ public:
+  KeyGenerator(const uint64_t num_keys, const double theta)
+      : num_keys_{num_keys}, theta_{theta}, uniform_{0, num_keys - 1} {
+    if (theta_ > 0) {
+      zeta_n_ = zeta(num_keys_, theta_);
+      alpha_ = 1. / (1. - theta_);
+      eta_ = (1. - std::pow(2. / static_cast<double>(num_keys_), 1. - theta_)) /
+             (1. - zeta(2, theta_) / zeta_n_);
+    }
+  }
+
+  template <typename Generator>
+  uint64_t operator()(Generator& gen) {
+    if (theta_ <= 0) {
+      return uniform_(gen);
+    }
+    const double u{unit_(gen)};
+    const double uz{u * zeta_n_};
+    uint64_t rank;
+    if (uz < 1.) {
+      rank = 0;
+    } else if (uz < 1. + std::pow(0.5, theta_)) {
+      rank = 1;
+    } else {
+      rank = static_cast<uint64_t>(static_cast<double>(num_keys_) *
+                                   std::pow(eta_ * u - eta_ + 1., alpha_));
+    }
+    return scramble(std::min(rank, num_keys_ - 1)) % num_keys_;
+  }
+
+ private:
+  static double zeta(const uint64_t n, const double theta) {
+    double sum{0};
+    for (uint64_t i{1}; i <= n; ++i) {
+      sum += 1. / std::pow(static_cast<double>(i), theta);
+    }
+    return sum;
+  }
+
+  // splitmix64 finalizer.
+  static uint64_t scramble(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  const uint64_t num_keys_;
+  const double theta_;
+  double zeta_n_{0};
+  double alpha_{0};
+  double eta_{0};
+  std::uniform_int_distribution<uint64_t> uniform_;
+  std::uniform_real_distribution<double> unit_{0., 1.};
+};
+
+/**
+ * Collects the latencies of one kind of operation.
+ */
+class LatencyStats {
+ public:
+  void record(const std::chrono::nanoseconds latency, const size_t num_keys) {
+    latencies_.push_back(latency.count());
+    num_keys_ += num_keys;
+  }
+
+  void merge(const LatencyStats& other) {
+    latencies_.insert(latencies_.end(), other.latencies_.begin(), other.latencies_.end());
+    num_keys_ += other.num_keys_;
+  }
+
+  size_t num_ops() const { return latencies_.size(); }
+  size_t num_keys() const { return num_keys_; }
+
+  /**
+   * Sorts the latencies, must be called before the percentiles are queried.
+   */
+  void finalize() { std::sort(latencies_.begin(), latencies_.end()); }
+
+  /**
+   * @return The latency in microseconds below which \p p percent of the operations completed.
+   */
+  double percentile(const double p) const {
+    if (latencies_.empty()) {
+      return 0;
+    }
+    const size_t i{static_cast<size_t>(p / 100. * static_cast<double>(latencies_.size() - 1))};
+    return static_cast<double>(latencies_[i]) / 1000.;
+  }
+
+  double mean() const {
+    if (latencies_.empty()) {
+      return 0;
+    }
+    double sum{0};
+    for (const int64_t latency : latencies_) {
+      sum += static_cast<double>(latency);
+    }
+    return sum / static_cast<double>(latencies_.size()) / 1000.;
+  }
+
+  /**
+   * @return The number of operations per power-of-two bucket of microseconds. Bucket i counts the
+   * latencies in [2^(i-1), 2^i) us, bucket 0 those below 1 us.
+   */
+  std::vector<size_t> histogram() const {
+    std::vector<size_t> buckets;
+    for (const int64_t latency : latencies_) {
+      size_t bucket{0};
+      for (int64_t us{latency / 1000}; us > 0; us >>= 1) {
+        ++bucket;
+      }
+      if (bucket >= buckets.size()) {
+        buckets.resize(bucket + 1);
+      }
+      ++buckets[bucket];
+    }
+    return buckets;
+  }
+
+  nlohmann::json to_json(const double seconds) const {
+    return {
+        {"ops", num_ops()},
+        {"keys", num_keys()},
+        {"ops_per_second", static_cast<double>(num_ops()) / seconds},
+        {"keys_per_second", static_cast<double>(num_keys()) / seconds},
+        {"mean_us", mean()},
+        {"p50_us", percentile(50)},
+        {"p99_us", percentile(99)},
+        {"p999_us", percentile(99.9)},
+        {"max_us", percentile(100)},
+        {"histogram_log2_us", histogram()},
+    };
+  }
+
+ private:
+  std::vector<int64_t> latencies_;
+  size_t num_keys_{0};
+};
+
+}  // namespace HugeCTR
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <io/filesystem.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * @brief Read-through cache of a remote file system in a local directory, e.g., on an NVMe SSD.
+ *
+ * A file is cached whole the first time it is read or prefetched, under the hash of its path and
+ * size, so that the next epochs read it locally. A remote file replaced by one of the same size
+ * is not detected. When the cache would exceed its capacity, the least recently read files are
+ * evicted; files larger than the capacity are read from the remote file system.
+ *
+ * The processes of a node, e.g., the ranks, can share the cache directory. A file is downloaded
+ * once under a per-file lock, to a temporary name renamed into place, the mtime of a cached file
+ * is its last read, and the eviction holds a lock of the directory. A file evicted while it is
+ * being read stays readable until it is closed.
+ *
+ * Prefetched files are downloaded by prefetch_depth threads, each file as parallel ranged reads of
+ * the remote file system, e.g., ranged GETs of S3. A file that is still queued or downloading is
+ * read from the remote file system range by range rather than waited for, so that the reader can
+ * start on a file that is not cached yet.
+ *
+ * Writes, uploads, copies and deletions go to the remote file system; those of a cached path drop
+ * its cached copy in this process.
+ */
+class CachingFileSystem final : public FileSystem {
+ public:
+  /**
+   * @param remote The cached file system.
+   * @param cache_dir Local cache directory, created if missing.
+   * @param capacity Bytes of the cache, 0 for no bound.
+   * @param prefetch_depth Number of files prefetched in parallel.
+   * @param evict_after_read Whether release() deletes the cached copy of a file.
+   */
+  CachingFileSystem(std::unique_ptr<FileSystem> remote, const std::string& cache_dir,
+                    size_t capacity, int prefetch_depth = 1, bool evict_after_read = false);
+
+  ~CachingFileSystem();
+
+  size_t get_file_size(const std::string& path) const override;
+
+  void create_dir(const std::string& path) override;
+
+  void delete_file(const std::string& path) override;
+
+  void fetch(const std::string& source_path, const std::string& target_path) override;
+
+  void upload(const std::string& source_path, const std::string& target_path) override;
+
+  int write(const std::string& path, const void* data, size_t data_size, bool overwrite) override;
+
+  int read(const std::string& path, void* buffer, size_t buffer_size, size_t offset) override;
+
+  void copy(const std::string& source_path, const std::string& target_path) override;
+
+  void batch_fetch(const std::string& source_dir, const std::string& target_dir) override;
+
+  void batch_upload(const std::string& source_dir, const std::string& target_dir) override;
+
+  /**
+   * @brief Downloads the files into the cache on the background threads, in order.
+   */
+  void prefetch(const std::vector<std::string>& paths) override;
+
+  /**
+   * @brief Drops the file from the prefetch queue, and deletes its cached copy if evict_after_read.
+   */
+  void release(const std::string& path) override;
+
+ private:
+  /**
+   * @brief Downloads the file into the cache if it is not there yet.
+   *
+   * @return The local path of the cached file, empty if the file does not fit the cache.
+   */
+  std::string ensure_cached(const std::string& path);
+
+  // Copies the remote file to the local path with chunked ranged reads, several in flight.
+  void download(const std::string& path, size_t size, const std::string& local_path);
+
+  // Whether the file is queued or being downloaded by a prefetch thread.
+  bool is_prefetching(const std::string& path);
+
+  // Evicts the least recently read files until incoming_size more bytes fit.
+  void evict(size_t incoming_size);
+
+  void forget(const std::string& path);
+
+  void prefetch_loop();
+
+  std::unique_ptr<FileSystem> remote_;
+  std::string cache_dir_;
+  size_t capacity_;
+  bool evict_after_read_;
+
+  mutable std::mutex sizes_mutex_;
+  mutable std::unordered_map<std::string, size_t> sizes_;  // Remote file sizes
+
+  std::mutex prefetch_mutex_;
+  std::condition_variable prefetch_cv_;
+  std::deque<std::string> prefetch_queue_;
+  std::unordered_set<std::string> downloading_;
+  bool stop_ = false;
+  std::vector<std::thread> prefetch_threads_;
+};
+
+}  // namespace HugeCTR
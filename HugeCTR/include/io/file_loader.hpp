@@ -20,6 +20,7 @@
 #include <io/filesystem.hpp>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace HugeCTR {
 
@@ -56,6 +57,38 @@ class FileLoader {
    */
   Error_t load(const std::string& file_name) noexcept;
 
+  /**
+   * @brief Open the file for range reads with read(), without loading it to CPU memory
+   *
+   * @param file_name
+   * @return 'Success', 'BrokenFile', 'FileCannotOpen'
+   */
+  Error_t open(const std::string& file_name) noexcept;
+
+  /**
+   * @brief Read a byte range of the opened file, can be called from several threads
+   *
+   * @param data buffer of at least size bytes
+   * @param size
+   * @param offset
+   * @return the number of bytes read, or -1 on error
+   */
+  long long read(char* data, size_t size, size_t offset) noexcept;
+
+  /**
+   * @brief Hint that the files will be loaded soon, see FileSystem::prefetch
+   *
+   * @param file_names
+   */
+  void prefetch(const std::vector<std::string>& file_names);
+
+  /**
+   * @brief Hint that the file has been consumed, see FileSystem::release
+   *
+   * @param file_name
+   */
+  void release(const std::string& file_name);
+
   /**
    * @brief clean the loaded data and set corresponding flags
    *
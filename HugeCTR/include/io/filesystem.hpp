@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
@@ -92,6 +93,34 @@ class FileSystem {
    */
   virtual int read(const std::string& path, void* buffer, size_t buffer_size, size_t offset) = 0;
 
+  /**
+   * @brief Asynchronous write, which keeps the calling thread free while the data is uploaded.
+   *
+   * @param path, data, data_size, overwrite See write. data must stay valid until the future is
+   * ready.
+   * @return Future of the number of successfully written bytes, get() rethrows the write errors.
+   */
+  virtual std::future<int> write_async(const std::string& path, const void* data, size_t data_size,
+                                       bool overwrite) {
+    return std::async(std::launch::async, [this, path, data, data_size, overwrite] {
+      return write(path, data, data_size, overwrite);
+    });
+  }
+
+  /**
+   * @brief Asynchronous read, so that a caller can keep several reads in flight.
+   *
+   * @param path, buffer, buffer_size, offset See read. buffer must stay valid until the future is
+   * ready.
+   * @return Future of the number of successfully read bytes, get() rethrows the read errors.
+   */
+  virtual std::future<int> read_async(const std::string& path, void* buffer, size_t buffer_size,
+                                      size_t offset) {
+    return std::async(std::launch::async, [this, path, buffer, buffer_size, offset] {
+      return read(path, buffer, buffer_size, offset);
+    });
+  }
+
   /**
    * @brief Copy a specific file within a file system.
    *
@@ -115,6 +144,22 @@ class FileSystem {
    * @param target_dir
    */
   virtual void batch_upload(const std::string& source_dir, const std::string& target_dir) = 0;
+
+  /**
+   * @brief Hint that the files will be read soon, so that a caching file system can start
+   * downloading them in the background. Does nothing by default.
+   *
+   * @param paths Remote file paths, in the order they will be read.
+   */
+  virtual void prefetch(const std::vector<std::string>& paths) {}
+
+  /**
+   * @brief Hint that the file has been consumed, so that a caching file system can free its space
+   * early. Does nothing by default.
+   *
+   * @param path Remote file path.
+   */
+  virtual void release(const std::string& path) {}
 };
 
 enum class FileSystemType_t { Local, HDFS, S3, GCS, Other };
@@ -123,10 +168,28 @@ struct DataSourceParams {
   FileSystemType_t type;
   std::string server;
   int port;
-
-  DataSourceParams(const FileSystemType_t type, const std::string& server, const int port)
-      : type(type), server(server), port(port){};
-  DataSourceParams() : type(FileSystemType_t::Local), server("localhost"), port(9000){};
+  std::string cache_dir;  // Local directory caching the remote files, empty for no cache
+  size_t cache_capacity;  // Bytes of the cache, 0 for no bound
+  int prefetch_depth;     // Files downloaded ahead of the one being read, in parallel
+  bool evict_after_read;  // Delete a cached file once it has been consumed
+
+  DataSourceParams(const FileSystemType_t type, const std::string& server, const int port,
+                   const std::string& cache_dir = "", const size_t cache_capacity = 0,
+                   const int prefetch_depth = 1, const bool evict_after_read = false)
+      : type(type),
+        server(server),
+        port(port),
+        cache_dir(cache_dir),
+        cache_capacity(cache_capacity),
+        prefetch_depth(prefetch_depth),
+        evict_after_read(evict_after_read){};
+  DataSourceParams()
+      : type(FileSystemType_t::Local),
+        server("localhost"),
+        port(9000),
+        cache_capacity(0),
+        prefetch_depth(1),
+        evict_after_read(false){};
 };
 
 class FileSystemBuilder {
@@ -59,6 +59,8 @@ struct GCSConfigs {
   std::string scheme;
   std::string default_bucket;
   std::optional<double> retry_limit_time;
+  size_t part_size = 64 << 20;  // Bytes of a ranged read or of a composite upload part.
+  int max_concurrency = 16;     // Requests in flight for one read, write, fetch or upload.
 
   GCSConfigs();
 
@@ -100,7 +102,13 @@ class GCSFileSystem final : public FileSystem {
   void batch_upload(const std::string& source_dir, const std::string& target_dir) override;
 
  private:
+  size_t read_range(const GCSPath& gcs_path, void* buffer, size_t nbytes, size_t offset);
+
+  void composite_write(const GCSPath& gcs_path, const void* data, size_t data_size);
+
   std::unique_ptr<google::cloud::storage::Client> client_;
+  size_t part_size_;
+  int max_concurrency_;
 };
 #endif
 
@@ -15,8 +15,17 @@
  */
 #pragma once
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
 #include <core23/logger.hpp>
 #include <fstream>
+#include <functional>
+#include <future>
+#include <memory>
 #include <nlohmann/json.hpp>
 #include <regex>
 #include <string>
@@ -74,6 +83,75 @@ class IOUtils {
     std::regex pattern_b("^https:\\/\\/storage.cloud.google.com\\/*([\\w\\W]+)*");
     return regex_match(url, pattern_a) || regex_match(url, pattern_b);
   }
+
+  /**
+   * @brief Runs task(i) for every i in [0, num_tasks) on up to max_concurrency threads, in order
+   * of i, and rethrows the first exception of a task once all threads are done.
+   */
+  static void parallel_for(size_t num_tasks, int max_concurrency,
+                           const std::function<void(size_t)>& task) {
+    const size_t num_threads =
+        std::min(num_tasks, static_cast<size_t>(std::max(max_concurrency, 1)));
+    if (num_threads <= 1) {
+      for (size_t i = 0; i < num_tasks; ++i) {
+        task(i);
+      }
+      return;
+    }
+    std::atomic<size_t> next_task{0};
+    std::vector<std::future<void>> threads;
+    for (size_t t = 0; t < num_threads; ++t) {
+      threads.emplace_back(std::async(std::launch::async, [&] {
+        for (size_t i = next_task++; i < num_tasks; i = next_task++) {
+          task(i);
+        }
+      }));
+    }
+    for (auto& thread : threads) {
+      thread.wait();
+    }
+    for (auto& thread : threads) {
+      thread.get();
+    }
+  }
+
+  /**
+   * @brief Maps a local file into memory to read it, the mapping is released with the pointer.
+   *
+   * @param path Local file path.
+   * @param size Set to the file size.
+   */
+  static std::shared_ptr<const char> map_file_for_read(const std::string& path, size_t* size) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    HCTR_CHECK_HINT(fd >= 0, "Cannot open the local file ", path);
+    *size = lseek(fd, 0, SEEK_END);
+    return map_file(fd, *size, PROT_READ, path);
+  }
+
+  /**
+   * @brief Creates or truncates a local file of the given size and maps it into memory to write
+   * it, the mapping is released with the pointer.
+   */
+  static std::shared_ptr<char> map_file_for_write(const std::string& path, size_t size) {
+    const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    HCTR_CHECK_HINT(fd >= 0, "Cannot create the local file ", path);
+    HCTR_CHECK_HINT(ftruncate(fd, size) == 0, "Cannot resize the local file ", path);
+    return map_file(fd, size, PROT_READ | PROT_WRITE, path);
+  }
+
+ private:
+  // Takes the ownership of fd.
+  static std::shared_ptr<char> map_file(int fd, size_t size, int prot, const std::string& path) {
+    if (size == 0) {
+      close(fd);
+      return {};
+    }
+    void* data = mmap(nullptr, size, prot, MAP_SHARED, fd, 0);
+    close(fd);
+    HCTR_CHECK_HINT(data != MAP_FAILED, "Cannot map the local file ", path);
+    return std::shared_ptr<char>(static_cast<char*>(data),
+                                 [size](char* data) { munmap(data, size); });
+  }
 };
 
 }  // namespace HugeCTR
\ No newline at end of file
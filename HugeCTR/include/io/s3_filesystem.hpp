@@ -51,6 +51,10 @@ struct S3Configs {
 
   S3CredentialsType credentials_type = S3CredentialsType::Default;
 
+  size_t part_size = 64 << 20;  // Bytes of a ranged GET or of an upload part, at least 5 MiB.
+
+  int max_concurrency = 16;  // Requests in flight for one read, write, fetch or upload.
+
   bool ready_to_connect = false;
 
   S3Configs();
@@ -115,7 +119,13 @@ class S3FileSystem final : public FileSystem {
   void batch_upload(const std::string& source_dir, const std::string& target_dir) override;
 
  private:
+  size_t read_range(const S3Path& s3_path, void* buffer, size_t nbytes, size_t offset);
+
+  void multipart_write(const S3Path& s3_path, const void* data, size_t data_size);
+
   std::unique_ptr<Aws::S3::S3Client> client_;
+  size_t part_size_;
+  int max_concurrency_;
 };
 #endif
 }  // namespace HugeCTR
\ No newline at end of file
@@ -90,6 +90,13 @@ class Layer {
    * Some of the layers requires algorithm search like fully connected layer
    */
   virtual void search_algorithm() {}
+
+  /*
+   * Estimates of the floating-point operations and of the bytes of device memory that a forward
+   * or backward pass performs and moves, to place the layer against the roofline when profiling.
+   */
+  virtual double get_flops(bool fprop) const { return 0.0; }
+  virtual double get_bytes(bool fprop) const;
 };
 
 }  // namespace HugeCTR
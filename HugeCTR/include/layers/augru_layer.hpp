@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cublas_v2.h>
+
+#include <trainable_layer.hpp>
+#include <vector>
+
+namespace HugeCTR {
+
+template <typename T>
+class AUGRULayer;
+
+/**
+ * GRU with attentional update gate (Interest Evolving Layer of DIEN) as a derived class of Layer.
+ *
+ * For each step t, with a_t the attention score of the step:
+ *   u_t = sigmoid(x_t W_u + h_{t-1} U_u + b_u)
+ *   r_t = sigmoid(x_t W_r + h_{t-1} U_r + b_r)
+ *   c_t = tanh(x_t W_c + r_t * (h_{t-1} U_c) + b_c)
+ *   h_t = (1 - a_t * u_t) * h_{t-1} + a_t * u_t * c_t
+ * The input projection of all the steps is one GEMM, each step then runs one GEMM for the
+ * recurrent projection and one fused kernel for the gates. The steps past the sequence length of a
+ * sample keep its hidden state, so the output is the state after its last valid step.
+ */
+template <>
+class AUGRULayer<float> : public TrainableLayer<float> {
+ public:
+  /**
+   * Ctor of AUGRULayer.
+   * @param in_tensors the input sequence (batch_size, seq_len, vector_size), the attention scores
+   * (batch_size, seq_len) and optionally the sequence lengths (batch_size, 1), as fed to
+   * SequenceMaskLayer
+   * @param out_tensor the final hidden state (batch_size, hidden_size)
+   */
+  AUGRULayer(const std::vector<core23::Tensor>& in_tensors, const core23::Tensor& out_tensor,
+             const std::shared_ptr<GPUResource>& gpu_resource,
+             std::vector<Initializer_t> initializer_types = std::vector<Initializer_t>());
+
+  /**
+   * A method of implementing the forward pass of AUGRU
+   * @param stream CUDA stream where the forward propagation is executed
+   */
+  void fprop(bool is_train) final;
+  /**
+   * A method of implementing the backward pass of AUGRU.
+   * The gradients of the sequence and of the attention scores overwrite them.
+   * @param stream CUDA stream where the backward propagation is executed
+   */
+  void bprop() final;
+
+ private:
+  std::unique_ptr<DataSimulator> get_default_initializer(const int index) override;
+
+  int64_t batch_size_;
+  int64_t seq_len_;
+  int64_t vector_size_;
+  int64_t hidden_size_;
+
+  core23::Tensor gates_x_;  // (batch_size * seq_len, 3 * hidden_size): x W, then its gradient
+  core23::Tensor gates_h_;  // (seq_len, batch_size, 3 * hidden_size): h U, then its gradient
+  core23::Tensor gates_;    // (seq_len, batch_size, 3 * hidden_size): u, r, c
+  core23::Tensor hiddens_;  // (seq_len + 1, batch_size, hidden_size): h_0 = 0 to h_T
+  core23::Tensor dh_;       // (batch_size, hidden_size)
+};
+
+}  // namespace HugeCTR
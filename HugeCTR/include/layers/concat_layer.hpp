@@ -35,6 +35,8 @@ class ConcatLayer : public Layer {
               const std::shared_ptr<GPUResource>& gpu_resource);
   ~ConcatLayer() override{};
 
+  void initialize() override;
+
   /**
    * Concat's forward pass to gather data to the output tensor
    * @param stream CUDA stream where the forward propagation is executed
@@ -45,6 +47,11 @@ class ConcatLayer : public Layer {
    * @param stream CUDA stream where the forward propagation is executed
    */
   void bprop() override;
+
+ private:
+  int max_width_ = 0;
+  core23::Tensor input_tensor_ptrs_;
+  core23::Tensor offsets_;  // int32_t, the column where each input starts, plus the total width
 };
 
 }  // namespace HugeCTR
@@ -23,14 +23,20 @@ namespace HugeCTR {
 
 /**
  * Dropout layer which selects an arbitrary fraction of inputs to 0
+ *
+ * With recompute, the layer keeps no mask for bprop: the mask of an iteration is regenerated in
+ * bprop from a counter-based random number generator, a seed and the iteration number, which is
+ * kept on the device so that the CUDA graphs replay a different mask every iteration.
  */
 template <typename T>
 class DropoutLayer : public Layer {
  public:
   DropoutLayer(const core23::Tensor& input_tensor, const core23::Tensor& output_tensor, float rate,
-               const std::shared_ptr<GPUResource>& gpu_resource);
+               const std::shared_ptr<GPUResource>& gpu_resource, bool recompute = false);
   ~DropoutLayer() override;
 
+  void initialize() override;
+
   /**
    * A method of implementing the forward pass of Dropout
    * @param stream CUDA stream where the forward propagation is executed
@@ -52,6 +58,10 @@ class DropoutLayer : public Layer {
   core23::Tensor noise_mask_;
   cudnnTensorDescriptor_t in_out_desc_;
   size_t reserveSpaceSizeInBytes_;
+
+  bool recompute_;
+  unsigned long long seed_;
+  core23::Tensor iteration_;  // [1], number of the training iteration of the current mask
 };
 
 }  // namespace HugeCTR
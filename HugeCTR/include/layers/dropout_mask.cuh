@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <curand_kernel.h>
+
+#include <cstdint>
+
+namespace HugeCTR {
+
+/**
+ * The mask of a recomputed dropout is never stored: the uniforms of 4 consecutive elements are
+ * drawn from the Philox subsequence of their group, at the offset of the training iteration, so
+ * that any kernel regenerates the mask of an iteration from the seed and the iteration number.
+ */
+__device__ __forceinline__ float4 dropout_uniform4(unsigned long long seed, size_t group,
+                                                   int64_t iteration) {
+  curandStatePhilox4_32_10_t state;
+  curand_init(seed, group, static_cast<unsigned long long>(iteration) * 4, &state);
+  return curand_uniform4(&state);
+}
+
+/**
+ * @return scale if the element idx is kept in the iteration, 0 if it is dropped.
+ */
+__device__ __forceinline__ float dropout_factor(unsigned long long seed, size_t idx,
+                                                int64_t iteration, float rate, float scale) {
+  const float4 rand = dropout_uniform4(seed, idx / 4, iteration);
+  const float keep[4] = {rand.x, rand.y, rand.z, rand.w};
+  return keep[idx % 4] > rate ? scale : 0.f;
+}
+
+}  // namespace HugeCTR
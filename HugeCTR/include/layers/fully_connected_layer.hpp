@@ -40,6 +40,10 @@ class FullyConnectedLayer<float> : public TrainableLayer<float> {
   cublasGemmAlgo_t falgo_{CUBLAS_GEMM_DEFAULT};
   cublasGemmAlgo_t balgo_W_{CUBLAS_GEMM_DEFAULT};
   cublasGemmAlgo_t balgo_Xn_{CUBLAS_GEMM_DEFAULT};
+  // With a single output, e.g., the logit of BinaryCrossEntropyLoss, the layer skips cuBLAS and
+  // runs one kernel per pass, which sums the gradients of its blocks into these
+  core23::Tensor single_output_partials_;
+  core23::Tensor single_output_counter_;
 
   std::vector<core23::Tensor>& get_in_tensors(bool is_train) { return this->input_tensors_; }
 
@@ -52,6 +56,10 @@ class FullyConnectedLayer<float> : public TrainableLayer<float> {
    * backward pass
    */
   void bprop() final;
+  /*
+   * initialize the single output kernels
+   */
+  void initialize() final;
   /*
    * algorithm search for cublasGemmEx
    */
@@ -42,6 +42,9 @@ class FullyConnectedLayer<__half> : public TrainableLayer<__half> {
    * stores the references to the output tensors of GEMM.
    */
   core23::Tensor identity_tensor_;
+  // Gradient partials of the blocks and their counter, when the single output kernels are used
+  core23::Tensor single_output_partials_;
+  core23::Tensor single_output_counter_;
 
   /*
    * initializers for this layer.
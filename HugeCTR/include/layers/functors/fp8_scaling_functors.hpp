@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_fp16.h>
+#include <cuda_fp8.h>
+#include <library_types.h>
+
+#include <common.hpp>
+
+namespace HugeCTR {
+
+template <typename Fp8>
+struct Fp8Format;
+
+// E4M3 keeps more mantissa bits, it is used for the activations and weights of the forward pass.
+template <>
+struct Fp8Format<__nv_fp8_e4m3> {
+  static constexpr float max = 448.0f;
+  static constexpr cudaDataType data_type = CUDA_R_8F_E4M3;
+};
+
+// E5M2 keeps the dynamic range the gradients of the backward pass need.
+template <>
+struct Fp8Format<__nv_fp8_e5m2> {
+  static constexpr float max = 57344.0f;
+  static constexpr cudaDataType data_type = CUDA_R_8F_E5M2;
+};
+
+/**
+ * Delayed scaling state of a tensor that is quantized to fp8 every iteration.
+ *
+ * The scale of an iteration is derived from the largest amax recorded in the previous
+ * history_len - 1 iterations, and the amax of the current iteration is recorded while quantizing,
+ * so the quantization does not wait for a reduction over the tensor it quantizes.
+ */
+struct Fp8TensorScale {
+  float* amax_history = nullptr;  // [history_len]
+  float* scale = nullptr;         // x_fp8 = saturate(x * scale)
+  float* scale_inv = nullptr;     // dequantization factor the fp8 GEMMs read
+  int history_len = 0;
+
+  // Number of floats of the buffer of a state with a history of history_len iterations
+  static size_t num_elements(int history_len) { return history_len + 2; }
+
+  void set_buffer(float* buffer, int history_len);
+};
+
+/**
+ * Clears the amax history and resets the scale to 1.
+ */
+void fp8_init_scale(const Fp8TensorScale& scale, cudaStream_t stream);
+
+/**
+ * Quantizes the row-major rows x cols matrix `in` to fp8. If update_scale, the scale is first
+ * recomputed from the history and the amax of `in` is recorded as the one of `step`, otherwise
+ * (inference) the current scale is used as is. If out_t is not null, the cols x rows transpose is
+ * written to it as well.
+ */
+template <typename T, typename Fp8>
+void fp8_quantize(const T* in, Fp8* out, Fp8* out_t, size_t rows, size_t cols,
+                  const Fp8TensorScale& scale, int64_t step, bool update_scale,
+                  cudaStream_t stream);
+
+}  // namespace HugeCTR
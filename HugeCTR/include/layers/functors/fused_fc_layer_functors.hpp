@@ -22,11 +22,25 @@
 
 #include <common.hpp>
 #include <layer.hpp>
+#include <layers/functors/fp8_scaling_functors.hpp>
 #include <layers/functors/fused_gemm_functors.hpp>
 #include <type_traits>
 
 namespace HugeCTR {
 
+/**
+ * fp8 copies of the GEMM operands of a fully connected layer and their scaling states.
+ */
+struct Fp8FCLayerBuffers {
+  __nv_fp8_e4m3* bottom = nullptr;    // batch_size x bottom_size
+  __nv_fp8_e4m3* kernel = nullptr;    // bottom_size x top_size
+  __nv_fp8_e4m3* kernel_t = nullptr;  // top_size x bottom_size
+  __nv_fp8_e5m2* grad_top = nullptr;  // batch_size x top_size
+  Fp8TensorScale bottom_scale;
+  Fp8TensorScale kernel_scale;
+  Fp8TensorScale grad_scale;
+};
+
 template <typename T>
 struct CublasFusedFCLayerDesc {
   CublasDesc<T> fprop_desc;
@@ -37,6 +51,13 @@ struct CublasFusedFCLayerDesc {
                       size_t bottom_size, size_t top_size, bool enable_tf32_compute);
   void set_bprop_attr(T* dbias_bottom_ptr, T* dbias_top_ptr, T* mask_in_ptr, size_t batch_size,
                       size_t bottom_size, size_t top_size, bool enable_tf32_compute);
+  // fprop and dgrad in fp8, wgrad in T. The ReLU of the fp8 fprop produces no mask and the fp8
+  // dgrad has no dReLU epilogue, so the bias gradient is always fused with wgrad.
+  void set_fp8_fprop_attr(const T* bias_ptr, Activation_t act, size_t batch_size,
+                          size_t bottom_size, size_t top_size,
+                          const Fp8FCLayerBuffers& fp8_buffers);
+  void set_fp8_bprop_attr(T* dbias_top_ptr, size_t batch_size, size_t bottom_size, size_t top_size,
+                          const Fp8FCLayerBuffers& fp8_buffers);
 };
 
 template <typename T>
@@ -58,6 +79,9 @@ template <typename T>
 class FusedFCLayerFunctors {
   GemmFunctor<T> gemm_functor_;
 
+  void reverse_relu(const T* mask_aux, size_t mask_aux_size, const T* train_top, T* grad_top,
+                    cudaStream_t stream);
+
  public:
   void fprop(const T* kernel, const T* bottom, T* top,
              const CublasFusedFCLayerDesc<T>& cublas_layer_desc,
@@ -71,6 +95,25 @@ class FusedFCLayerFunctors {
              cudaStream_t stream, cudaStream_t overlap_stream, cudaEvent_t& event_overlap,
              bool async_wgrad, bool skip_dgrad);
 
+  /*
+   * fp8 versions, the descriptors must have been set by set_fp8_fprop_attr/set_fp8_bprop_attr.
+   * The scales are only updated in training, with the amax histories of `step`.
+   */
+  void fprop_fp8(const T* kernel, const T* bottom, T* top, const Fp8FCLayerBuffers& fp8_buffers,
+                 size_t batch_size, size_t bottom_size, size_t top_size, int64_t step,
+                 bool is_train, const CublasFusedFCLayerDesc<T>& cublas_layer_desc,
+                 const CublasFusedFCLayerAlgo<T>& cublas_layer_algo,
+                 cublasLtHandle_t cublaslt_handle, cudaStream_t stream);
+
+  void bprop_fp8(const T* bottom, const T* train_top, const T* mask_aux, size_t mask_aux_size,
+                 T* grad_top, T* bottom_bprop, T* kernel_grad,
+                 const Fp8FCLayerBuffers& fp8_buffers, size_t batch_size, size_t top_size,
+                 int64_t step, const CublasFusedFCLayerDesc<T>& cublas_layer_desc,
+                 const CublasFusedFCLayerAlgo<T>& cublas_layer_algo,
+                 cublasLtHandle_t cublaslt_handle, cudaStream_t stream,
+                 cudaStream_t overlap_stream, cudaEvent_t& event_overlap, bool async_wgrad,
+                 bool skip_dgrad);
+
   void search_algorithm(T* bottom, T* top, T* kernel, size_t batch_size, size_t input_size,
                         size_t output_size, const CublasFusedFCLayerDesc<T>& cublas_layer_desc,
                         CublasFusedFCLayerAlgo<T>& cublas_layer_algo,
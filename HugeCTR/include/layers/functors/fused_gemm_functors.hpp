@@ -41,6 +41,11 @@ struct CublasDesc {
                       cublasOperation_t op_a, cublasOperation_t op_b, cublasLtOrder_t order,
                       bool enable_tf32_compute, T* dbias_ptr = nullptr,
                       const T* mask_in_ptr = nullptr);
+  // D (m x n) = A^T * B with fp8 A (k x m) and B (k x n), column-major, as cuBLASLt only takes a
+  // transposed A with fp8 inputs. The dequantization factors are read from the device.
+  void set_fp8_attr(size_t m, size_t n, size_t k, cudaDataType type_a, cudaDataType type_b,
+                    const float* a_scale_inv, const float* b_scale_inv,
+                    const T* bias_ptr = nullptr, Activation_t act = Activation_t::None);
 
   ~CublasDesc();
 };
@@ -68,6 +73,11 @@ struct GemmFunctor {
                   const T* mat_c, T* mat_d, const CublasDesc<T>& cublas_desc,
                   const CublasAlgo<T>& cublas_algo, cublasLtHandle_t cublaslt_handle,
                   cudaStream_t stream);
+  // Same with the fp8 A and B of a descriptor set by CublasDesc::set_fp8_attr
+  void operator()(const float alpha, const void* mat_a, const void* mat_b, const float beta,
+                  const T* mat_c, T* mat_d, const CublasDesc<T>& cublas_desc,
+                  const CublasAlgo<T>& cublas_algo, cublasLtHandle_t cublaslt_handle,
+                  cudaStream_t stream);
 };
 
 template class CublasDesc<float>;
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_runtime.h>
+
+#include <cstdint>
+
+namespace HugeCTR {
+
+/**
+ * Sums (or averages if mean) the (outer, reduce_size, inner) input over its middle axis into the
+ * (outer, 1, inner) output, accumulating in float. Any axis of a tensor maps to this view, with
+ * outer and inner the products of the dims before and after the axis.
+ *
+ * The loads are vectorized up to 16 bytes when inner (or reduce_size if inner is 1) and the
+ * pointers allow it. If inner is 1, the rows are reduced by a warp, or by a block if long, with
+ * shuffles; otherwise, each thread reduces a vector of columns with coalesced loads.
+ */
+template <typename T>
+void reduce_fprop(const T* input, T* output, int64_t outer, int64_t reduce_size, int64_t inner,
+                  bool mean, cudaStream_t stream);
+
+/** Backward of reduce_fprop: broadcasts the output gradient over the reduced axis. */
+template <typename T>
+void reduce_bprop(const T* top_grad, T* dgrad, int64_t outer, int64_t reduce_size, int64_t inner,
+                  bool mean, cudaStream_t stream);
+
+}  // namespace HugeCTR
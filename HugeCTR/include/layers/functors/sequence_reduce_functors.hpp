@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_runtime.h>
+
+#include <cstdint>
+
+namespace HugeCTR {
+
+/**
+ * Sums (or averages if mean) the first seq_lens[b] steps of each sample b of the padded
+ * (batch_size, max_seq_len, vector_size) input into the (batch_size, 1, vector_size) output.
+ * The padded steps are not read, so the work follows the real lengths. The lengths have the
+ * type of the input, as the ones SequenceMaskLayer reads.
+ */
+template <typename T>
+void sequence_reduce_fprop(const T* input, const T* seq_lens, T* output, int64_t batch_size,
+                           int64_t max_seq_len, int64_t vector_size, bool mean,
+                           cudaStream_t stream);
+
+/**
+ * Backward of sequence_reduce_fprop: broadcasts the output gradient to the valid steps of each
+ * sample and zeroes the gradient of the padded ones.
+ */
+template <typename T>
+void sequence_reduce_bprop(const T* top_grad, const T* seq_lens, T* dgrad, int64_t batch_size,
+                           int64_t max_seq_len, int64_t vector_size, bool mean,
+                           cudaStream_t stream);
+
+}  // namespace HugeCTR
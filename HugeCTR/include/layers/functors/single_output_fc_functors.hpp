@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#pragma once
+
+#include <cuda_runtime.h>
+
+#include <cstdint>
+
+namespace HugeCTR {
+
+/**
+ * Fully connected layer with a single output, e.g., the logit fed to BinaryCrossEntropyLoss:
+ * top[r] = dot(bottom[r, :], weight) + bias[0]. One warp computes one row, accumulating in float,
+ * which is a single kernel instead of a GEMM with one column and a bias kernel.
+ */
+template <typename T>
+void single_output_fc_fprop(const T* bottom, const T* weight, const T* bias, T* top,
+                            int64_t batch_size, int64_t input_size, cudaStream_t stream);
+
+/**
+ * Backward of single_output_fc_fprop in one kernel. Overwrites bottom with its gradient
+ * top_grad[r] * weight, adds the weight gradient to wgrad, and adds (or writes, if not
+ * accumulate_bias) the bias gradient to bias_grad[0].
+ *
+ * Each block sums its rows into partials, and the last block to finish sums the partials of the
+ * blocks in order, so the result does not depend on the scheduling.
+ *
+ * @param partials single_output_fc_partials_size(input_size) floats.
+ * @param counter Zero before the first call, left zero by every call.
+ */
+template <typename T>
+void single_output_fc_bprop(T* bottom, const T* weight, const T* top_grad, T* wgrad, T* bias_grad,
+                            bool accumulate_bias, float* partials, unsigned int* counter,
+                            int64_t batch_size, int64_t input_size, cudaStream_t stream);
+
+int64_t single_output_fc_partials_size(int64_t input_size);
+
+}  // namespace HugeCTR
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <type_traits>
+
+namespace HugeCTR {
+
+constexpr size_t kMaxPackBytes = 16;
+
+/** N elements loaded and stored with a single instruction, e.g., as a float4 or 4 half2. */
+template <typename T, int N>
+struct alignas(sizeof(T) * N) Pack {
+  T data[N];
+};
+
+/**
+ * The largest number of elements, up to 16 bytes, that divides length and whose size all the
+ * pointers are aligned to.
+ */
+template <typename T>
+inline int pack_size(int64_t length, std::initializer_list<const void*> ptrs) {
+  int n = static_cast<int>(kMaxPackBytes / sizeof(T));
+  const auto misaligned = [&](const void* ptr) {
+    return reinterpret_cast<uintptr_t>(ptr) % (n * sizeof(T)) != 0;
+  };
+  while (n > 1 && (length % n != 0 || std::any_of(ptrs.begin(), ptrs.end(), misaligned))) {
+    n /= 2;
+  }
+  return n;
+}
+
+/** Calls launch with the pack size as an std::integral_constant, to instantiate the kernels. */
+template <typename T, int N = static_cast<int>(kMaxPackBytes / sizeof(T)), typename Launch>
+void dispatch_pack_size(int pack_size, const Launch& launch) {
+  if constexpr (N > 1) {
+    if (pack_size < N) {
+      dispatch_pack_size<T, N / 2>(pack_size, launch);
+      return;
+    }
+  }
+  launch(std::integral_constant<int, N>());
+}
+
+}  // namespace HugeCTR
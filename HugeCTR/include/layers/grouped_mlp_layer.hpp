@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#pragma once
+
+#include <cublas_v2.h>
+
+#include <layer.hpp>
+#include <trainable_layer.hpp>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * The MLP towers of a multi-task model, which all have the same layer sizes. Layer i of all the
+ * towers runs as one batched cuBLAS GEMM, followed by one kernel adding the biases and applying
+ * the ReLUs of all the towers, and the backward likewise, so the number of launches does not
+ * grow with the number of towers.
+ *
+ * The towers either have one input each or share a single input, which then gets the sum of
+ * their gradients. The weights are ordered tower by tower, each tower as an MLPLayer, so the
+ * model files have the layout of the consecutive MLP layers of the towers.
+ */
+template <typename T>
+class GroupedMLPLayer : public TrainableLayer<T> {
+  int64_t num_towers_;
+  int64_t batch_size_;
+  int64_t input_size_;
+  std::vector<int64_t> num_outputs_;
+  std::vector<Activation_t> acts_;
+  std::vector<bool> use_bias_;
+  bool skip_head_dgrad_;
+  bool enable_tf32_compute_;
+
+  // Outputs and, for the ReLU layers, gradients of the inner layers, as [layer][tower]
+  std::vector<std::vector<core23::Tensor>> train_tensors_, dact_tensors_;
+  // Outputs of the last layer if it has a ReLU, since the top tensors get their gradients
+  std::vector<core23::Tensor> mask_tensors_;
+  // Gradients of the towers w.r.t. a shared input, before they are summed
+  core23::Tensor shared_dgrad_tensor_;
+  core23::Tensor ones_tensor_;
+  // The device pointer arrays of the batched GEMMs and kernels of every layer
+  core23::Tensor pointer_tensor_;
+
+  void** get_pointer_array(int64_t layer, int array);
+
+  std::unique_ptr<DataSimulator> get_uniform_initializer(const int index) override;
+  std::unique_ptr<DataSimulator> get_xavier_uniform_initializer(const int index) override;
+  std::unique_ptr<DataSimulator> get_xavier_norm_initializer(const int index) override;
+  std::unique_ptr<DataSimulator> get_default_initializer(const int index) override;
+
+ public:
+  /**
+   * @param bottom_tensors One (batch_size, input_size) input per tower, or one shared by all.
+   * @param top_tensors One (batch_size, num_outputs.back()) output per tower.
+   * @param num_outputs Output size of each layer of a tower.
+   * @param acts Activation of each layer, Relu or None.
+   * @param use_bias Whether each layer has a bias.
+   */
+  GroupedMLPLayer(const std::vector<core23::Tensor>& bottom_tensors,
+                  const std::vector<core23::Tensor>& top_tensors,
+                  const std::vector<int64_t>& num_outputs,
+                  const std::shared_ptr<GPUResource>& gpu_resource,
+                  const std::vector<Activation_t>& acts, const std::vector<bool>& use_bias,
+                  std::vector<Initializer_t> initializer_types = std::vector<Initializer_t>(),
+                  bool skip_head_dgrad = false, bool enable_tf32_compute = false);
+  GroupedMLPLayer(const GroupedMLPLayer&) = delete;
+  GroupedMLPLayer& operator=(const GroupedMLPLayer&) = delete;
+
+  void fprop(bool is_train) final;
+  void bprop() final;
+  void initialize() final;
+
+  int64_t get_num_towers() const { return num_towers_; }
+};
+
+}  // namespace HugeCTR
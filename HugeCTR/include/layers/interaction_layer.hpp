@@ -31,6 +31,9 @@ class InteractionLayer : public Layer {
 
   bool separate_Y_and_dY_;
 
+  // fp16 inputs too large for the tiled kernels, which fit the generic tensor core kernels
+  bool use_generic_kernels_ = false;
+
   std::vector<core23::Tensor> intermediate_tensors_;
 
  private:
@@ -25,6 +25,9 @@ namespace HugeCTR {
 
 /**
  * LayerNorm layer
+ *
+ * An activation and a dropout can be fused into its output. The fused dropout keeps no mask, it is
+ * regenerated in bprop like the one of a DropoutLayer with recompute.
  */
 template <typename T>
 class LayerNormLayer : public TrainableLayer<T> {
@@ -35,7 +38,9 @@ class LayerNormLayer : public TrainableLayer<T> {
    * LayerNorm parameters
    */
   struct Params {
-    double eps; /**< small value to avoid divide-by-zero error*/
+    double eps;                            /**< small value to avoid divide-by-zero error*/
+    Activation_t act = Activation_t::None; /**< activation fused into the normalized output */
+    float dropout_rate = 0.f; /**< rate of the dropout fused after the activation, 0 for none */
   };
   /**
    * Ctor of LayerNormLayer.
@@ -61,6 +66,8 @@ class LayerNormLayer : public TrainableLayer<T> {
    */
   void bprop() override;
 
+  void initialize() override;
+
  private:
   /**
    * A method of defining how gamma and beta are initialized.
@@ -80,6 +87,9 @@ class LayerNormLayer : public TrainableLayer<T> {
   // these tensors are internal only managed by smart ptrs
   core23::Tensor result_save_mean_;
   core23::Tensor result_save_var_;
+
+  unsigned long long dropout_seed_;
+  core23::Tensor dropout_iteration_;  // [1], number of the training iteration of the current mask
 };
 
 }  // namespace HugeCTR
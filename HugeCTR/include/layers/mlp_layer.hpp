@@ -26,6 +26,13 @@
 
 namespace HugeCTR {
 
+/**
+ * A stack of fully connected layers with fused bias and ReLU epilogues.
+ *
+ * With enable_fp8, the fprop and dgrad GEMMs run in fp8 (E4M3 activations and weights, E5M2
+ * gradients) with per-tensor delayed scaling, while wgrad stays in T. It needs T = __half, an
+ * sm89+ GPU and a batch size and layer sizes that are multiples of 16.
+ */
 template <typename T>
 class MLPLayer : public TrainableLayer<T> {
   std::vector<core23::Tensor> train_tensors_, mask_tensors_, dact_tensors_, db_tensors_;
@@ -44,6 +51,12 @@ class MLPLayer : public TrainableLayer<T> {
   bool fuse_wb_;
   bool enable_tf32_compute_;
   bool skip_head_dgrad_;
+  bool enable_fp8_;
+
+  // fp8 operands of every layer, and the raw gradients of the ReLU layers before their dReLU
+  std::vector<core23::Tensor> fp8_operand_tensors_, fp8_scale_tensors_, dgrad_tensors_;
+  std::vector<Fp8FCLayerBuffers> fp8_buffers_;
+  int64_t fp8_step_ = 0;
 
   bool event_overlap_created_;
   cudaEvent_t event_overlap_;
@@ -63,7 +76,7 @@ class MLPLayer : public TrainableLayer<T> {
            const std::vector<bool>& use_bias,
            std::vector<Initializer_t> initializer_types = std::vector<Initializer_t>(),
            bool skip_head_dgrad = false, bool async_wgrad = false, bool fuse_wb = false,
-           bool enable_tf32_compute = false);
+           bool enable_tf32_compute = false, bool enable_fp8 = false);
 
   MLPLayer(const MLPLayer& C) = delete;
   MLPLayer& operator=(const MLPLayer&);
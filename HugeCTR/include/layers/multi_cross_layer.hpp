@@ -71,8 +71,8 @@ struct MultiCrossBackwardFunctorv2 {
                   std::vector<core23::Tensor>& kernel_output_tensors,
                   std::vector<core23::Tensor>& grad_tensors,
                   std::vector<core23::Tensor>& bias_output_tensors,
-                  std::vector<core23::Tensor>& XU_tensors, core23::Tensor accum_dx_tensor_,
-                  std::vector<core23::Tensor> bprop_bottoms, int num_layers,
+                  std::vector<core23::Tensor>& XU_tensors, core23::Tensor& accum_dx_tensor,
+                  std::vector<core23::Tensor>& bprop_bottoms, int num_layers,
                   const std::vector<CublasDesc<T>>& xu_descr_,
                   const std::vector<CublasDesc<T>>& xuvb_descr_,
                   const std::vector<CublasDesc<T>>& du_descrs_bprop_,
@@ -112,6 +112,13 @@ class MultiCrossLayer : public TrainableLayer<T> {
   std::vector<core23::Tensor> hidden_tensors_;     // DCNv1: x_i * w ; DCNv2: x * x_i * w + b; T_7
   std::vector<core23::Tensor> XU_tensors_;         // DCNv2:
 
+  // Gathered once so that fprop and bprop pass the same tensors every iteration
+  std::vector<core23::Tensor> kernel_tensors_;       // DCNv1: w ; DCNv2: U, V
+  std::vector<core23::Tensor> bias_tensors_;
+  std::vector<core23::Tensor> kernel_grad_tensors_;  // DCNv1: dw ; DCNv2: dU, dV
+  std::vector<core23::Tensor> bias_grad_tensors_;
+  std::vector<core23::Tensor> output_tensors_;       // activation_tensors_[1:]
+
   core23::Tensor tmp_mat_tensors_[4];  //[h,w]
 
   core23::Tensor accum_dx_tensor_;
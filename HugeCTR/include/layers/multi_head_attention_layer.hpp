@@ -24,6 +24,12 @@ namespace HugeCTR {
 /**
  * Layer which does mult-head attention by input tensors.
  * All the input tensors should have the same shape.
+ *
+ * With fused_attention, the scores are never materialized: a tiled kernel computes QK^T, the
+ * mask, an online softmax and the product with V on chip and keeps only the logsumexp of every
+ * row, from which the backward pass recomputes the probabilities. The memory traffic is then
+ * linear in the sequence lengths, which allows longer sequences. It supports up to 128 hidden
+ * units per head.
  */
 template <typename T>
 class MultiHeadAttentionLayer : public Layer {
@@ -31,7 +37,8 @@ class MultiHeadAttentionLayer : public Layer {
   MultiHeadAttentionLayer(const std::vector<core23::Tensor>& input_tensors,
                           std::vector<core23::Tensor>& output_tensors, int num_attention_heads,
                           bool transpose_b, const std::shared_ptr<GPUResource>& gpu_resource,
-                          bool use_mixed_precision, bool enable_tf32_compute);
+                          bool use_mixed_precision, bool enable_tf32_compute,
+                          bool fused_attention = false);
   // void initialize() override;
   /**
    * MultiHeadAttentionLayer's forward propagation
@@ -47,12 +54,16 @@ class MultiHeadAttentionLayer : public Layer {
   std::vector<T>& get_debug_vector() { return debug_vector_; };
 
  private:
+  void fused_fprop(bool is_train);
+  void fused_bprop();
+
   bool enable_tf32_compute_;
   bool use_mixed_precision_;
   int64_t num_;
   int64_t dims_;
   bool transpose_b_;
   int64_t num_head_;
+  bool fused_attention_;
 
   core23::Tensor fprop_query_tensor_;
   core23::Tensor fprop_softmax_tensor_;
@@ -64,6 +75,10 @@ class MultiHeadAttentionLayer : public Layer {
   core23::Tensor attention_score_4d_;
   core23::Tensor attention_softmax_4d_;
 
+  // fused_attention only, [batch_size, head_num, seq_from] float
+  core23::Tensor softmax_lse_tensor_;
+  core23::Tensor softmax_delta_tensor_;
+
   // masked_softmax_layer_ xor softmax_layer_
   std::unique_ptr<MaskedSoftmaxLayer<T>> masked_softmax_layer_;
   std::unique_ptr<SoftmaxLayer<T>> softmax_layer_;
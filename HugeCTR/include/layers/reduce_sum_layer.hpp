@@ -30,6 +30,14 @@ class ReduceSumLayer : public Layer {
  public:
   ReduceSumLayer(const core23::Tensor& input_tensor, core23::Tensor& output_tensor, int axis,
                  const std::shared_ptr<GPUResource>& gpu_resource);
+  /**
+   * Reduces only the first seq_lens[b] steps of each sample b of the (batch_size, max_seq_len,
+   * vector_size) input along axis 1, as the padded steps of a sequence feature would.
+   * @param seq_len_tensor the (batch_size, 1) sequence lengths, as fed to SequenceMaskLayer
+   */
+  ReduceSumLayer(const core23::Tensor& input_tensor, const core23::Tensor& seq_len_tensor,
+                 core23::Tensor& output_tensor, int axis,
+                 const std::shared_ptr<GPUResource>& gpu_resource);
   ~ReduceSumLayer(){};
 
   /**
@@ -34,6 +34,8 @@ class SliceLayer : public Layer {
              const std::shared_ptr<GPUResource>& gpu_resource);
   ~SliceLayer() override{};
 
+  void initialize() override;
+
   /**
    * Slice's forward pass to gather data to the output tensor
    * @param stream CUDA stream where the forward propagation is executed
@@ -47,6 +49,8 @@ class SliceLayer : public Layer {
 
  private:
   std::vector<int> slices_start_;
+  core23::Tensor output_tensor_ptrs_;
+  core23::Tensor slices_;  // int32_t, the first column and the width of each output
 };
 
 }  // namespace HugeCTR
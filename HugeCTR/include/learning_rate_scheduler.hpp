@@ -24,25 +24,37 @@ class LearningRateScheduler {
   size_t decay_steps_;
   float decay_power_;
   float end_lr_;
+  LrPolicy_t policy_;
+  float decay_rate_;
   size_t step_{0};
   float current_lr_{0.f};
 
  public:
   // decay_start means no decay will be used.
+  // After decay_start the learning rate decays to end_lr over decay_steps steps, polynomially with
+  // decay_power for LrPolicy_t::fixed or along a half cosine for LrPolicy_t::cosine. With
+  // LrPolicy_t::step it is multiplied by decay_rate every decay_steps steps, down to end_lr.
   LearningRateScheduler(float base_lr, size_t warmup_steps = 1, size_t decay_start = 0,
-                        size_t decay_steps = 1, float decay_power = 2.f, float end_lr = 0.f)
+                        size_t decay_steps = 1, float decay_power = 2.f, float end_lr = 0.f,
+                        LrPolicy_t policy = LrPolicy_t::fixed, float decay_rate = 0.1f)
       : base_lr_(base_lr),
         warmup_steps_(warmup_steps),
         decay_start_(decay_start),
         decay_steps_(decay_steps),
         decay_power_(decay_power),
-        end_lr_(end_lr) {
+        end_lr_(end_lr),
+        policy_(policy),
+        decay_rate_(decay_rate) {
     if (base_lr < 0 || warmup_steps < 0 || decay_steps < 0 || decay_power < 1.0f || end_lr < 0.f) {
       HCTR_OWN_THROW(
           Error_t::WrongInput,
           "base_lr < 0 || warmup_steps < 0 || decay_steps < 0 || decay_power < 1.0 || end_lr "
           "< 0.f");
     }
+    if (policy == LrPolicy_t::step && (decay_steps == 0 || decay_rate <= 0.f || decay_rate > 1.f)) {
+      HCTR_OWN_THROW(Error_t::WrongInput,
+                     "LrPolicy_t::step needs decay_steps > 0 and decay_rate in (0, 1]");
+    }
   }
 
   void reset(float base_lr, size_t warmup_steps, size_t decay_start, size_t decay_steps,
@@ -71,6 +83,12 @@ class LearningRateScheduler {
       if (decay_start_ != 0) {
         if (step_ <= decay_start_) {
           current_lr_ = base_lr_;
+        } else if (policy_ == LrPolicy_t::step) {
+          float lr = base_lr_ * pow(decay_rate_, (step_ - decay_start_) / decay_steps_);
+          current_lr_ = lr > end_lr_ ? lr : end_lr_;
+        } else if (policy_ == LrPolicy_t::cosine && step_ <= decay_start_ + decay_steps_) {
+          float lr_factor = 0.5f * (1.f + cos(M_PI * (step_ - decay_start_) / decay_steps_));
+          current_lr_ = end_lr_ + (base_lr_ - end_lr_) * lr_factor;
         } else if (step_ <= decay_start_ + decay_steps_) {
           float lr_factor =
               pow(((decay_start_ + decay_steps_ - step_) / ((float)decay_steps_)), decay_power_);
@@ -16,7 +16,10 @@
 #pragma once
 
 #include <functional>
+#include <map>
+#include <memory>
 #include <regularizer.hpp>
+#include <string>
 #include <vector>
 
 namespace HugeCTR {
@@ -30,6 +33,8 @@ class ILoss {
   virtual int get_device_id() const = 0;
   virtual float regularizer_compute_rterm() = 0;
   virtual void regularizer_initialize_wgrad(bool is_train) = 0;
+  virtual RegularizationGrad regularizer_fuse_into_optimizer() = 0;
+  virtual float regularizer_compute_deferred_rterm() = 0;
 
   virtual float get_label_weight() const = 0;
   virtual void set_label_weight(float new_weight) = 0;
@@ -85,6 +90,9 @@ class Loss : public ILoss {
   }
   std::vector<core23::Tensor>& get_input_tensors(bool is_train) { return input_tensors_; }
 
+  template <typename>
+  friend class FusedBinaryCrossEntropyLoss;
+
  protected:
   bool gen_loss_summary_;
   int get_total_gpu_count() const { return total_gpu_count_; }
@@ -116,6 +124,12 @@ class Loss : public ILoss {
 
   float regularizer_compute_rterm();
   void regularizer_initialize_wgrad(bool is_train);
+  /**
+   * Leaves the gradient of the regularization term to the optimizer, see
+   * Regularizer::fuse_into_optimizer.
+   */
+  RegularizationGrad regularizer_fuse_into_optimizer() override;
+  float regularizer_compute_deferred_rterm() override;
 
   float get_label_weight() const override { return label_weight; }
   void set_label_weight(float new_weight) override { label_weight = new_weight; }
@@ -167,4 +181,72 @@ class MultiCrossEntropyLoss : public Loss<T> {
                         float scaler = 1.f, bool gen_loss_summary = true);
 };
 
+/**
+ * @brief
+ *
+ * Computes the losses and gradients of all the tasks of a multi-task model at once.
+ */
+class IFusedLoss {
+ public:
+  virtual ~IFusedLoss() = 0;
+  virtual void compute(bool is_train, long long current_batchsize, float rterm) = 0;
+
+  /**
+   * loss tensor(type: float): contains a single value, the sum of the losses of all the tasks.
+   */
+  virtual const core23::Tensor& get_total_loss_tensor() const = 0;
+};
+
+/**
+ * @brief
+ *
+ * Fuses the BinaryCrossEntropyLoss heads of a multi-task model, so that the losses, gradients and
+ * regularizer terms of all the tasks are computed by one kernel instead of one kernel and one
+ * memset per task. The loss of every task is still written to the loss tensor of its head, and
+ * their sum is kept on device as well, so that it is read back with a single copy.
+ */
+template <typename T>
+class FusedBinaryCrossEntropyLoss : public IFusedLoss {
+  std::vector<BinaryCrossEntropyLoss<T>*> losses_;
+  std::shared_ptr<GPUResource> gpu_resource_;
+  int batch_size_;
+  int total_gpu_count_;
+  float scaler_;
+  bool gen_loss_summary_;
+  bool params_uploaded_ = false;
+
+  // Per task
+  core23::Tensor inputs_;         // T*
+  core23::Tensor labels_;         // const float*
+  core23::Tensor losses_ptrs_;    // float*
+  core23::Tensor label_weights_;  // float
+  core23::Tensor block_counters_;
+  // The running sums of the tasks, followed by the running sum of all the tasks
+  core23::Tensor partial_losses_;
+  core23::Tensor task_counter_;
+  core23::Tensor total_loss_;
+
+  void upload_params();
+
+ public:
+  FusedBinaryCrossEntropyLoss(const std::vector<BinaryCrossEntropyLoss<T>*>& losses);
+
+  /**
+   * @param current_batchsize the rows of dgrad beyond it are set to 0, as in Loss::compute.
+   * @param rterm added to the loss of every task, as in Loss::compute.
+   */
+  void compute(bool is_train, long long current_batchsize, float rterm) override;
+
+  const core23::Tensor& get_total_loss_tensor() const override { return total_loss_; }
+};
+
+/**
+ * @return A fused loss over \p losses if there are several of them and they are all
+ * BinaryCrossEntropyLoss<T>, otherwise nullptr. The label weights of the heads are read on the
+ * first compute.
+ */
+template <typename T>
+std::unique_ptr<IFusedLoss> create_fused_loss(
+    const std::map<std::string, std::unique_ptr<ILoss>>& losses);
+
 }  // namespace HugeCTR
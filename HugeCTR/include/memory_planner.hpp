@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <map>
+#include <memory>
+#include <resource_manager.hpp>
+#include <string>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Accounts for the GPU memory of a model by the parts that use it, and advises the largest batch
+ * size and the number of embedding rows that fit.
+ *
+ * The footprint of a part is measured as the drop of the free memory of each local GPU while the
+ * part is created, so that it includes the padding of the allocators, the hash tables and the
+ * workspaces that static estimates miss. Each part is split into the bytes that do not depend on
+ * the batch size, such as the embedding tables and the weights, and the rest, which is assumed to
+ * grow linearly with the batch size.
+ */
+class MemoryPlanner {
+ public:
+  /** The row of an embedding table, to advise how many more of them fit. */
+  struct RowType {
+    int ev_size;
+    size_t bytes_per_row;  // With the optimizer states.
+  };
+
+  explicit MemoryPlanner(const std::shared_ptr<ResourceManager>& resource_manager);
+
+  /** Starts measuring a part. Parts are measured one after another. */
+  void begin();
+
+  /**
+   * Attributes the memory allocated on the local GPUs since `begin` to the part `name`, adding to
+   * it if it was measured before.
+   * @param fixed_bytes The bytes of the part per local GPU that do not depend on the batch size.
+   */
+  void end(const std::string& name, const std::vector<size_t>& fixed_bytes);
+
+  /** Like above, for a part that is either entirely fixed or entirely scales. */
+  void end(const std::string& name, bool scales_with_batch);
+
+  bool empty() const { return parts_.empty(); }
+
+  /**
+   * The largest global batch size that fits the GPU with the least free memory, a multiple of the
+   * number of GPUs, keeping a headroom free.
+   */
+  long long max_batchsize(long long batchsize) const;
+
+  /** The plan of the GPU with the least free memory, as a table. */
+  std::string report(long long batchsize, const std::vector<RowType>& row_types) const;
+
+ private:
+  struct Part {
+    std::vector<size_t> total_bytes;  // Per local GPU
+    std::vector<size_t> fixed_bytes;
+  };
+
+  std::vector<size_t> free_bytes(std::vector<size_t>* total_bytes = nullptr) const;
+  size_t tightest_gpu(const std::vector<size_t>& free) const;
+  size_t headroom(size_t total_bytes) const;
+
+  std::shared_ptr<ResourceManager> resource_manager_;
+  std::vector<size_t> free_at_begin_;
+  std::vector<std::string> part_names_;  // In the order of measurement
+  std::map<std::string, Part> parts_;
+};
+
+}  // namespace HugeCTR
@@ -33,7 +33,17 @@ namespace metrics {
 
 using CountType = u_int32_t;
 enum class RawType { Loss, Pred, Label };
-enum class Type { AUC, AverageLoss, HitRate, NDCG, SMAPE };
+enum class Type {
+  AUC,
+  AverageLoss,
+  HitRate,
+  NDCG,
+  SMAPE,
+  StreamingAUC,
+  QueryHitRate,
+  QueryNDCG,
+  QueryMRR
+};
 
 using Core23RawMetricMap = std::map<RawType, core23::Tensor>;
 using Core23MultiLossMetricMap = std::map<std::string, Core23RawMetricMap>;
@@ -45,6 +55,7 @@ class Metric {
  public:
   static std::unique_ptr<Metric> Create(const Type type, bool use_mixed_precision,
                                         int batch_size_eval, int n_batches, int label_dim,
+                                        int top_k, int candidates_per_query,
                                         const std::shared_ptr<ResourceManager>& resource_manager);
   Metric();
   virtual ~Metric();
@@ -56,6 +67,12 @@ class Metric {
     return std::vector<float>(0.0, 1);
   }
   virtual std::string name() const = 0;
+  /**
+   * @return The half width of the 95% confidence interval of the metric over the batches reduced
+   * since the last finalize_metric(), or a negative value if the metric cannot bound it. All the
+   * GPUs take part in the computation, and the reduction goes on afterwards.
+   */
+  virtual float get_confidence_half_width() { return -1.0f; }
   void set_current_batch_size(int batch_size) { current_batch_size_ = batch_size; }
 
  protected:
@@ -77,9 +94,10 @@ class AverageLoss : public Metric {
 
  private:
   std::shared_ptr<ResourceManager> resource_manager_;
-  std::vector<float*> loss_local_;
-  float loss_global_;
+  std::vector<float*> loss_sum_;    // Device variable, summed over the batches
+  std::vector<float*> loss_local_;  // Host variable
   int n_batches_;
+  int n_nets_;
 };
 
 template <typename T>
@@ -103,12 +121,9 @@ class HitRate : public Metric {
   int n_batches_;
   int num_local_gpus_;
 
+  // Device variables, summed over the batches
   std::vector<int*> checked_count_;
   std::vector<int*> hit_count_;
-  std::vector<int> checked_local_;
-  std::vector<int> hits_local_;
-  int checked_global_;
-  int hits_global_;
 };
 
 template <typename T>
@@ -132,11 +147,9 @@ class SMAPE : public Metric {
   int n_batches_;
   int num_local_gpus_;
 
-  std::vector<float*> error_;       // Device variable
-  std::vector<int> checked_local_;  // Host variable
-  std::vector<float> error_local_;  // Host variable
-  int checked_global_;
-  float error_global_;
+  // Summed over the batches
+  std::vector<float*> error_;             // Device variable
+  std::vector<long long> checked_local_;  // Host variable
 };
 
 enum class ReallocType_t { NO_COPY, MMAP, DEFAULT };
@@ -331,6 +344,89 @@ class AUC : public Metric {
   std::vector<float> per_class_aucs_;
 };
 
+/**
+ * AUC approximated from fixed-resolution histograms of the predictions of the negative and of the
+ * positive samples. A batch only adds to the histograms of its GPU, so the memory does not depend
+ * on the number of evaluated samples, and the histograms are all-reduced once, in
+ * finalize_metric(). A pair whose predictions fall into the same bin counts half, so the error is
+ * at most half the fraction of such pairs, about 1 / (2 * num_bins_) when the predictions spread
+ * over [0, 1]. With label_dim > 1, every class has its own histograms and the result is the mean
+ * of the per-class AUCs.
+ */
+template <typename T>
+class StreamingAUC : public Metric {
+ public:
+  using PredType = T;
+  using LabelType = float;
+  StreamingAUC(int batch_size_per_gpu, int label_dim,
+               const std::shared_ptr<ResourceManager>& resource_manager);
+  ~StreamingAUC() override;
+
+  void local_reduce(int local_gpu_id, Core23RawMetricMap raw_metrics) override;
+  void global_reduce(int n_nets) override;
+  float finalize_metric() override;
+  std::string name() const override { return "StreamingAUC"; };
+  std::vector<float> get_per_class_metric() const { return per_class_aucs_; }
+  float get_confidence_half_width() override;
+
+ private:
+  size_t num_bin_bytes() const { return 2 * num_classes_ * num_bins_ * sizeof(unsigned long long); }
+
+  const int num_bins_ = 1 << 14;
+  const size_t num_classes_;
+
+  std::shared_ptr<ResourceManager> resource_manager_;
+  int batch_size_per_gpu_;
+  int num_local_gpus_;
+
+  // Device variables: (num_classes, num_bins) counts of the negatives, then of the positives
+  std::vector<unsigned long long*> bins_;
+  std::vector<unsigned long long*> interim_bins_;  // allocated by get_confidence_half_width()
+  std::vector<float> per_class_aucs_;
+};
+
+/**
+ * HitRate@K, NDCG@K or MRR over candidate lists, for retrieval models. The evaluation samples hold
+ * the candidates of a query contiguously, candidates_per_query of them, and a candidate is
+ * relevant if its label is positive. A block per query ranks its relevant candidates by counting
+ * the candidates scored above them, ties going to the earlier candidate, which selects the top K
+ * without sorting the list. Per query:
+ * - HitRate@K is 1 if a relevant candidate is in the top K,
+ * - NDCG@K is the DCG of the top K, with the label as the gain, over the DCG of the ideal order,
+ * - MRR is the reciprocal rank of the first relevant candidate, over the whole list.
+ * The queries without a relevant candidate are skipped. The per-query values are summed on the
+ * device over the batches and all-reduced across all the GPUs in finalize_metric().
+ */
+template <typename T>
+class QueryMetric : public Metric {
+ public:
+  using PredType = T;
+  using LabelType = float;
+  QueryMetric(Type type, int batch_size_per_gpu, int top_k, int candidates_per_query,
+              const std::shared_ptr<ResourceManager>& resource_manager);
+  ~QueryMetric() override;
+
+  void local_reduce(int local_gpu_id, Core23RawMetricMap raw_metrics) override;
+  void global_reduce(int n_nets) override {}
+  float finalize_metric() override;
+  std::string name() const override;
+
+ private:
+  // Summed over the queries: the ones with a relevant candidate, the hits, the reciprocal ranks
+  // and the NDCGs
+  static constexpr int num_sums_ = 4;
+
+  const Type type_;
+  const int top_k_;
+  const int candidates_per_query_;
+
+  std::shared_ptr<ResourceManager> resource_manager_;
+  int batch_size_per_gpu_;
+  int num_local_gpus_;
+
+  std::vector<double*> sums_;  // Device variables
+};
+
 class NDCGStorage {
  public:
   void alloc_main(size_t num_local_samples, size_t num_bins, size_t num_partitions,
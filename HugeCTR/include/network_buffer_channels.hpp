@@ -43,4 +43,12 @@ core23::BufferChannel GetWgradHalfBufferChannel();
 
 core23::BufferChannel GetOptStateBufferChannnel();
 
+/**
+ * Sets the step in which the dense layer outputs created from now on are live and returns the
+ * previous one. The outputs of different steps, e.g. of the train and eval layers, may then share
+ * memory in an aliased Blobs buffer. The default, -1, keeps them live throughout.
+ */
+int64_t SetActivationStep(int64_t step);
+int64_t GetActivationStep();
+
 }  // namespace HugeCTR
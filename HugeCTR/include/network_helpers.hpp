@@ -53,6 +53,17 @@ std::vector<core23::Tensor> get_trainable_tensor_vector(
   return param_tensors;
 }
 
+template <typename DType>
+std::vector<core23::Tensor> get_layer_wgrads(Layer* layer) {
+  if (auto trainable_layer = dynamic_cast<TrainableLayer<DType>*>(layer)) {
+    return trainable_layer->get_wgrads();
+  }
+  if (auto trainable_layer = dynamic_cast<TrainableLayer<DType, true>*>(layer)) {
+    return trainable_layer->get_wgrads();
+  }
+  return {};
+}
+
 template <typename DType>
 std::vector<core23::Tensor> get_weight_tensor_vector(
     const std::vector<std::unique_ptr<Layer>>& layers) {
@@ -25,6 +25,7 @@
 #include <network_buffer_channels.hpp>
 #include <network_helpers.hpp>
 #include <optional>
+#include <regularizer.hpp>
 
 namespace HugeCTR {
 
@@ -32,6 +33,8 @@ using WeightTensors = core23::TensorContainer<float, 1, 1>;
 using WeightHalfTensors = core23::TensorContainer<__half, 1, 1>;
 template <typename T>
 using WgradTensors = core23::TensorContainer<T, 1, 1>;
+// The [begin, end) range of the flattened weights that a sharded optimizer updates
+using WeightShard = std::pair<int64_t, int64_t>;
 
 struct FtrlOptHyperParams {
   static constexpr size_t num_parameters_per_weight = 2;
@@ -47,6 +50,8 @@ struct FtrlOptHyperParams {
   bool operator!=(const FtrlOptHyperParams& other) const { return !(*this == other); }
 };
 
+// Shared by Adam and LazyAdam. LazyAdam keeps m per element, but v and the step count t per row of
+// an embedding table, and corrects the bias of a row with the number of times it was updated.
 struct AdamOptHyperParams {
   static constexpr size_t num_parameters_per_weight = 2;
 
@@ -80,6 +85,8 @@ struct RMSPropOptHyperParams {
   bool operator!=(const RMSPropOptHyperParams& other) const { return !(*this == other); }
 };
 
+// Shared by AdaGrad and RowWiseAdaGrad. RowWiseAdaGrad keeps one accumulator per row of an
+// embedding table, of the mean of the squared gradients of the row.
 struct AdaGradOptHyperParams {
   static constexpr size_t num_parameters_per_weight = 1;
 
@@ -152,6 +159,10 @@ struct OptParams {
   OptHyperParams hyperparams;
   Update_t update_type{Update_t::Local};
   float scaler{};
+  // Sort-free sparse update of the legacy embeddings, see EmbeddingOptimizer::update
+  bool fused_update{false};
+  // Scales the learning rate of an embedding collection table
+  float lr_multiplier{1.f};
 
   inline static size_t num_parameters_per_weight(Optimizer_t opt_type) {
     switch (opt_type) {
@@ -169,6 +180,10 @@ struct OptParams {
         return NesterovOptHyperParams::num_parameters_per_weight;
       case Optimizer_t::SGD:
         return SGDOptHyperParams::num_parameters_per_weight;
+      case Optimizer_t::RowWiseAdaGrad:
+        return 0;
+      case Optimizer_t::LazyAdam:
+        return 1;
       default:
         HCTR_OWN_THROW(Error_t::NotInitialized, "OptParams not correctly initialized.");
         return 0;
@@ -177,10 +192,26 @@ struct OptParams {
 
   inline size_t num_parameters_per_weight() const { return num_parameters_per_weight(optimizer); }
 
+  // The states that the row-wise optimizers keep per row of an embedding table, on top of those per
+  // weight.
+  inline static size_t num_parameters_per_row(Optimizer_t opt_type) {
+    switch (opt_type) {
+      case Optimizer_t::RowWiseAdaGrad:
+        return 1;  // the accumulator
+      case Optimizer_t::LazyAdam:
+        return 2;  // v and t
+      default:
+        return 0;
+    }
+  }
+
+  inline size_t num_parameters_per_row() const { return num_parameters_per_row(optimizer); }
+
   bool operator==(const OptParams& other) const {
     return (optimizer == other.optimizer) && (lr == other.lr) &&
            (hyperparams == other.hyperparams) && (update_type == other.update_type) &&
-           (scaler == other.scaler);
+           (scaler == other.scaler) && (fused_update == other.fused_update) &&
+           (lr_multiplier == other.lr_multiplier);
   }
 
   bool operator!=(const OptParams& other) const { return !(*this == other); }
@@ -191,6 +222,7 @@ class OptParamsPy {
   Optimizer_t optimizer;
   Update_t update_type;
   OptHyperParams hyperparams;
+  bool fused_update = false;
   bool initialized;
 
   OptParamsPy();
@@ -204,6 +236,8 @@ class Optimizer {
  public:
   /**
    * Helper to create a speicifed Optimizer object
+   * @param shard if set, the optimizer only keeps the states of and updates this shard of the
+   * weights, which only Adam supports
    */
   template <typename T>
   static std::unique_ptr<Optimizer> Create(const OptParams& params,
@@ -212,7 +246,8 @@ class Optimizer {
                                            std::vector<core23::Tensor> wgrade_tensors,
                                            const float scaler,
                                            const std::shared_ptr<GPUResource>& gpu_resource,
-                                           bool use_mixed_precision);
+                                           bool use_mixed_precision,
+                                           std::optional<WeightShard> shard = std::nullopt);
 
   /*
    * Constructor of Optimizer with new Tensor
@@ -267,12 +302,19 @@ class Optimizer {
 
   const Optimizer_t& get_optimizer_type() { return optimizer_type_; }
 
+  /**
+   * Adds the gradient of a regularization term to the wgrads in the update, instead of a separate
+   * pass over the weights before it.
+   */
+  void set_regularization_grad(const RegularizationGrad& grad) { regularization_grad_ = grad; }
+
  protected:
   std::optional<WeightTensors> weight_tensors_;
   std::shared_ptr<GPUResource> gpu_resource_;
   float lr_;  // learning rate
   const float scaler_;
   Optimizer_t optimizer_type_;
+  RegularizationGrad regularization_grad_;
 
   std::shared_ptr<GpuLearningRateScheduler> gpu_learning_rate_scheduler_;
 
@@ -326,6 +368,13 @@ class EmbeddingOptimizer {
   Tensor2<uint32_t> hash_value_index_count_counter_tensors_; /**< The temp memory to store the
                                                                 counter of the count of hash table
                                                                 value indexes in update_params(). */
+
+  // Only with OptParams::fused_update
+  Tensor2<uint32_t> row_unique_index_tensors_; /**< The unique index of every row of the table in
+                                                  the current batch, all ones for none. */
+  Tensor2<size_t> unique_rows_tensors_;        /**< The row of every unique index. */
+  Tensor2<float> unique_wgrad_tensors_;        /**< The summed gradients of every unique index. */
+
   SparseEmbeddingHashParams& param;
 
  public:
@@ -338,6 +387,14 @@ class EmbeddingOptimizer {
 
   void reset(GPUResource const& local_gpu) { initialize(local_gpu); }
 
+  /**
+   * Sorts the keys by hash_value_index to sum the gradients of every row, then applies the
+   * optimizer to every row of the batch. With OptParams::fused_update the rows are instead made
+   * unique with atomics on a per-row index, the gradients summed into the unique rows with atomics,
+   * and the optimizer applied in a single kernel, without a sort or a host synchronization. The
+   * order of the float additions then varies between runs. Only for the updates that only touch
+   * the rows of the batch: Local, LazyGlobal Adam, and Global AdaGrad and SGD.
+   */
   void update(size_t batch_size, size_t slot_num, size_t embedding_vec_size,
               size_t max_vocabulary_size_per_gpu, size_t nnz,
               const Tensor2<TypeHashKey>& row_offset, Tensor2<size_t>& hash_value_index,
@@ -36,11 +36,14 @@ class AdamOptimizer : public Optimizer {
    * @param beta1 beta1 in Adam paper
    * @param beta2 beta2 in Adam paper
    * @param epsilon epsilon in Adam paper
+   * @param shard if set, m and v are only kept for and only this range of the flattened weights is
+   * updated
    */
   AdamOptimizer(std::optional<WeightTensors> weight_tensors,
                 std::optional<WgradTensors<T>> wgrad_tensors,
                 const std::shared_ptr<GPUResource>& gpu_resource, float learning_rate = 0.001,
-                float beta1 = 0.9, float beta2 = 0.999, float epsilon = 1e-7, float scaler = 1.f);
+                float beta1 = 0.9, float beta2 = 0.999, float epsilon = 1e-7, float scaler = 1.f,
+                std::optional<WeightShard> shard = std::nullopt);
 
   void initialize() override;
 
@@ -56,6 +59,7 @@ class AdamOptimizer : public Optimizer {
   // named as in Algorithm 1 of Adam paper (arXiv:1412.6980)
   // except that alpha is lr_ in class Optimizer
   std::optional<WgradTensors<T>> wgrad_tensors_;
+  WeightShard shard_;
   core23::Tensor m_tensor_;
   core23::Tensor v_tensor_;
   uint64_t t_;
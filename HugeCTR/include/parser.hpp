@@ -63,14 +63,18 @@ inline nlohmann::json read_json_file(const std::string& filename) {
 struct Solver {
   std::string model_name;
   unsigned long long seed; /**< seed of data simulator */
-  LrPolicy_t lr_policy;    /**< the only fixed lr is supported now. */
+  LrPolicy_t lr_policy;    /**< the decay of the learning rate scheduler */
   float lr;
   size_t warmup_steps;
   size_t decay_start;
   size_t decay_steps;
   float decay_power;
   float end_lr;
+  float decay_rate; /**< the factor of every decay of LrPolicy_t::step */
   int max_eval_batches;                /**< the number of batches for evaluations */
+  float eval_auc_tolerance;            /**< half width of the AUC interval to stop eval at */
+  int eval_top_k;                      /**< K of the query metrics */
+  int eval_candidates_per_query;       /**< length of the candidate lists of the query metrics */
   int batchsize_eval;                  /**< batchsize for eval */
   int batchsize;                       /**< batchsize */
   std::vector<std::vector<int>> vvgpu; /**< device map */
@@ -88,13 +92,24 @@ struct Solver {
   bool train_inter_iteration_overlap;
   bool eval_intra_iteration_overlap;
   bool eval_inter_iteration_overlap;
+  bool train_embedding_lookahead;
   bool use_embedding_collection;
+  bool gpu_learning_rate_scheduling;
   AllReduceAlgo all_reduce_algo;
   bool grouped_all_reduce;
   size_t num_iterations_statistics;
   bool perf_logging;
   bool drop_incomplete_batch;
+  bool fuse_dense_layers;
+  float allreduce_bucket_size_mb;
+  bool async_checkpoint;
+  std::string algorithm_search_cache; /**< file of the GEMM algorithms, empty to search again */
+  bool broadcast_algorithm_search;
+  bool shard_dense_optimizer; /**< split the dense optimizer states across all the GPUs */
+  bool share_eval_activations; /**< let the eval layer outputs reuse the train ones' memory */
   std::string kafka_brokers;
+  std::string kafka_compression_codec;
+  std::string kafka_value_precision;
   DataSourceParams data_source_params;
   std::vector<std::shared_ptr<TrainingCallback>> training_callbacks;
   Solver() {}
@@ -151,6 +166,7 @@ const std::map<std::string, Layer_t> LAYER_TYPE_MAP = {
     {"FmOrder2", Layer_t::FmOrder2},
     {"InnerProduct", Layer_t::InnerProduct},
     {"MLP", Layer_t::MLP},
+    {"GroupedMLP", Layer_t::GroupedMLP},
     {"Interaction", Layer_t::Interaction},
     {"MultiCross", Layer_t::MultiCross},
     {"MultiCrossEntropyLoss", Layer_t::MultiCrossEntropyLoss},
@@ -160,6 +176,7 @@ const std::map<std::string, Layer_t> LAYER_TYPE_MAP = {
     {"Gather", Layer_t::Gather},
     {"PReLU_Dice", Layer_t::PReLU_Dice},
     {"GRU", Layer_t::GRU},
+    {"AUGRU", Layer_t::AUGRU},
     {"MatrixMultiply", Layer_t::MatrixMultiply},
     {"MultiHeadAttention", Layer_t::MultiHeadAttention},
     {"Scale", Layer_t::Scale},
@@ -186,6 +203,7 @@ const std::map<std::string, Layer_t> LAYER_TYPE_MAP_MP = {
     {"FmOrder2", Layer_t::FmOrder2},
     {"FusedInnerProduct", Layer_t::FusedInnerProduct},
     {"MLP", Layer_t::MLP},
+    {"GroupedMLP", Layer_t::GroupedMLP},
     {"InnerProduct", Layer_t::InnerProduct},
     {"Interaction", Layer_t::Interaction},
     {"MultiCross", Layer_t::MultiCross},
@@ -209,7 +227,8 @@ const std::map<std::string, Initializer_t> INITIALIZER_TYPE_MAP = {
     {"XavierUniform", Initializer_t::XavierUniform},
     {"Zero", Initializer_t::Zero}};
 static const std::map<std::string, AllReduceAlgo> ALLREDUCE_ALGO_MAP = {
-    {"Oneshot", AllReduceAlgo::ONESHOT}, {"NCCL", AllReduceAlgo::NCCL}};
+    {"Oneshot", AllReduceAlgo::ONESHOT}, {"NCCL", AllReduceAlgo::NCCL},
+    {"Auto", AllReduceAlgo::AUTO}};
 
 static const std::map<std::string, Optimizer_t> OPTIMIZER_TYPE_MAP = {
     {"Ftrl", Optimizer_t::Ftrl},
@@ -218,7 +237,9 @@ static const std::map<std::string, Optimizer_t> OPTIMIZER_TYPE_MAP = {
     {"AdaGrad", Optimizer_t::AdaGrad},
     {"MomentumSGD", Optimizer_t::MomentumSGD},
     {"Nesterov", Optimizer_t::Nesterov},
-    {"SGD", Optimizer_t::SGD}};
+    {"SGD", Optimizer_t::SGD},
+    {"RowWiseAdaGrad", Optimizer_t::RowWiseAdaGrad},
+    {"LazyAdam", Optimizer_t::LazyAdam}};
 
 static const std::map<std::string, Update_t> UPDATE_TYPE_MAP = {
     {"Local", Update_t::Local}, {"Global", Update_t::Global}, {"LazyGlobal", Update_t::LazyGlobal}};
@@ -90,17 +90,78 @@ class GraphScheduleable : public Scheduleable {
   void run(std::shared_ptr<GPUResource> gpu, bool use_graph) override;
 };
 
+/**
+ * A scheduleable of a dependency-scheduled Pipeline with the names of the buffers it reads and
+ * writes. The scheduleable should not pick its own stream, the Pipeline assigns one.
+ */
+struct PipelineNode {
+  std::shared_ptr<Scheduleable> scheduleable;
+  std::vector<std::string> inputs;
+  std::vector<std::string> outputs;
+};
+
+/**
+ * Runs a scheduleable on a stream (relative to the current one) after waiting for the events of
+ * the nodes it depends on, then records its own completion event. Built by Pipeline from
+ * PipelineNode.
+ */
+class DependencyScheduleable : public Scheduleable {
+ private:
+  std::shared_ptr<Scheduleable> scheduleable_;
+  std::string stream_name_;
+  int priority_;
+  std::vector<cudaEvent_t> wait_events_;
+  std::optional<cudaEvent_t> completion_event_;
+
+ public:
+  HCTR_DISALLOW_COPY_AND_MOVE(DependencyScheduleable);
+
+  DependencyScheduleable(std::shared_ptr<Scheduleable> scheduleable,
+                         const std::string &stream_name, int priority);
+
+  ~DependencyScheduleable() override;
+
+  const std::string &get_stream_name() const { return stream_name_; }
+
+  void wait(cudaEvent_t event) { wait_events_.push_back(event); }
+
+  cudaEvent_t record_done();
+
+  void init(std::shared_ptr<GPUResource> gpu) override;
+
+  void run(std::shared_ptr<GPUResource> gpu, bool use_graph) override;
+};
+
 class Pipeline {
  private:
   std::string stream_name_;
   std::shared_ptr<GPUResource> gpu_resource_;
   std::vector<std::shared_ptr<Scheduleable>> scheduleable_list_;
+  bool capture_as_one_graph_ = false;
+  GraphWrapper graph_;
 
  public:
   Pipeline() = default;
 
+  /**
+   * @param capture_as_one_graph whether run_graph() captures the whole list as one CUDA graph
+   * instead of the graphs of the individual scheduleables.
+   */
+  Pipeline(const std::string &stream_name, std::shared_ptr<GPUResource> gpu_resource,
+           const std::vector<std::shared_ptr<Scheduleable>> &scheduleable_list,
+           bool capture_as_one_graph = false);
+
+  /**
+   * Schedules the nodes by the buffers they declare, as a sequential program in the order of
+   * nodes would run them: a node waits for the last writer of each of its inputs and for the
+   * readers and the writer of each of its outputs. A node continues the stream of one of its
+   * predecessors when it can, otherwise it gets a side stream, and events are only recorded
+   * across streams. The side streams running a node of the critical path get a higher priority.
+   * @param capture_as_one_graph whether run_graph() captures all the streams as one CUDA graph.
+   * It needs the workloads to launch the same kernels with the same arguments every run.
+   */
   Pipeline(const std::string &stream_name, std::shared_ptr<GPUResource> gpu_resource,
-           const std::vector<std::shared_ptr<Scheduleable>> &scheduleable_list);
+           const std::vector<PipelineNode> &nodes, bool capture_as_one_graph = false);
 
   std::string get_stream_name() { return stream_name_; }
 
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <metrics.hpp>
+#include <mutex>
+#include <resource_manager.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace HugeCTR {
+
+namespace metrics {
+
+/**
+ * Writes the predictions of the evaluation pipelines to files, instead of reducing them into a
+ * metric. Each process writes its share of every batch, which are the valid samples of its local
+ * GPUs in order, into one file per output column, `<prefix>_<rank>_pred<column>.bin`. The files
+ * hold the predictions as raw `float`s.
+ *
+ * The predictions are copied to pinned host buffers on the stream of the evaluation, and written
+ * by a background thread, so that the next batches are read and evaluated meanwhile. A GPU only
+ * waits for the writer once all of its buffers are in flight.
+ */
+class PredictionWriter : public Metric {
+ public:
+  PredictionWriter(const std::string& output_prefix, bool use_mixed_precision,
+                   int batch_size_per_gpu, int label_dim,
+                   const std::shared_ptr<ResourceManager>& resource_manager);
+  ~PredictionWriter() override;
+
+  void local_reduce(int local_gpu_id, Core23RawMetricMap raw_metrics) override;
+  void global_reduce(int n_nets) override {}
+  float finalize_metric() override { return static_cast<float>(flush()); }
+  std::string name() const override { return "Predictions"; }
+
+  /**
+   * Waits until the predictions of all the batches so far are written.
+   * @return The number of samples written by this process.
+   */
+  size_t flush();
+
+ private:
+  static constexpr size_t num_slots_{2};
+
+  struct Slot {
+    float* h_preds;
+    size_t num_samples;
+    cudaEvent_t ready;
+  };
+
+  bool is_batch_submitted_(size_t batch) const;
+  void write_loop_();
+
+  std::shared_ptr<ResourceManager> resource_manager_;
+  bool use_mixed_precision_;
+  int batch_size_per_gpu_;
+  int label_dim_;
+
+  std::vector<float*> d_preds_;           // fp32 copies of the predictions, per local GPU
+  std::vector<std::vector<Slot>> slots_;  // Pinned buffers per local GPU
+  std::vector<std::ofstream> files_;      // One per output column
+  std::vector<float> column_;             // Gather buffer of the writer
+
+  std::vector<size_t> num_submitted_batches_;  // Per local GPU
+  size_t num_written_batches_{0};
+  size_t num_written_samples_{0};
+  bool terminate_{false};
+  std::exception_ptr error_;
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::thread writer_;
+};
+
+}  // namespace metrics
+
+}  // namespace HugeCTR
@@ -20,6 +20,7 @@
 
 #include <collectives/all_reduce_comm.hpp>
 #include <common.hpp>
+#include <core23/instrumentation.hpp>
 #include <device_map.hpp>
 #include <embeddings/hybrid_embedding/utils.hpp>
 #include <hps/inference_utils.hpp>
@@ -118,6 +119,7 @@ void CommonPybind(pybind11::module& m) {
       .value("InnerProduct", HugeCTR::Layer_t::InnerProduct)
       .value("FusedInnerProduct", HugeCTR::Layer_t::FusedInnerProduct)
       .value("MLP", HugeCTR::Layer_t::MLP)
+      .value("GroupedMLP", HugeCTR::Layer_t::GroupedMLP)
       .value("Interaction", HugeCTR::Layer_t::Interaction)
       .value("MultiCrossEntropyLoss", HugeCTR::Layer_t::MultiCrossEntropyLoss)
       .value("ReLU", HugeCTR::Layer_t::ReLU)
@@ -132,6 +134,7 @@ void CommonPybind(pybind11::module& m) {
       .value("Gather", HugeCTR::Layer_t::Gather)
       .value("PReLU_Dice", HugeCTR::Layer_t::PReLU_Dice)
       .value("GRU", HugeCTR::Layer_t::GRU)
+      .value("AUGRU", HugeCTR::Layer_t::AUGRU)
       .value("MatrixMultiply", HugeCTR::Layer_t::MatrixMultiply)
       .value("MultiHeadAttention", HugeCTR::Layer_t::MultiHeadAttention)
       .value("Scale", HugeCTR::Layer_t::Scale)
@@ -154,24 +157,56 @@ void CommonPybind(pybind11::module& m) {
       .value("Auto", HugeCTR::Alignment_t::Auto)
       .value("Non", HugeCTR::Alignment_t::None)
       .export_values();
+  pybind11::enum_<HugeCTR::IOBackend_t>(m, "IOBackend_t")
+      .value("AIO", HugeCTR::IOBackend_t::AIO)
+      .value("IOUring", HugeCTR::IOBackend_t::IOUring)
+      .value("IOUringSQPoll", HugeCTR::IOBackend_t::IOUringSQPoll)
+      .value("GDS", HugeCTR::IOBackend_t::GDS)
+      .export_values();
+  pybind11::enum_<HugeCTR::DataCache_t>(m, "DataCache_t")
+      .value("Off", HugeCTR::DataCache_t::Off)
+      .value("Device", HugeCTR::DataCache_t::Device)
+      .value("Host", HugeCTR::DataCache_t::Host)
+      .export_values();
+  pybind11::enum_<HugeCTR::DataTransform_t>(m, "DataTransform_t")
+      .value("Log1p", HugeCTR::DataTransform_t::Log1p)
+      .value("Bucketize", HugeCTR::DataTransform_t::Bucketize)
+      .value("Modulo", HugeCTR::DataTransform_t::Modulo)
+      .export_values();
+  pybind11::class_<HugeCTR::DataTransformParam>(m, "DataTransformParam")
+      .def(pybind11::init<DataTransform_t, int, long long, const std::vector<float>&>(),
+           pybind11::arg("type"), pybind11::arg("index"), pybind11::arg("modulo") = 0,
+           pybind11::arg("boundaries") = std::vector<float>());
   pybind11::class_<HugeCTR::AsyncParam>(m, "AsyncParam")
-      .def(pybind11::init<int, int, int, int, int, bool, Alignment_t, bool, bool>(),
+      .def(pybind11::init<int, int, int, int, int, bool, Alignment_t, bool, bool, IOBackend_t,
+                          int, bool, DataCache_t, bool, const std::vector<DataTransformParam>&,
+                          const std::optional<SyntheticDataParam>&, const std::string&, bool,
+                          bool>(),
            pybind11::arg("num_threads"), pybind11::arg("num_batches_per_thread"),
            pybind11::arg("max_num_requests_per_thread") = 0, pybind11::arg("io_depth") = 0,
            pybind11::arg("io_alignment") = 0, pybind11::arg("shuffle"),
            pybind11::arg("aligned_type") = Alignment_t::None,
-           pybind11::arg("multi_hot_reader") = true, pybind11::arg("is_dense_float") = true);
+           pybind11::arg("multi_hot_reader") = true, pybind11::arg("is_dense_float") = true,
+           pybind11::arg("io_backend") = IOBackend_t::AIO, pybind11::arg("shuffle_block_size") = 0,
+           pybind11::arg("variable_length") = false,
+           pybind11::arg("train_data_cache") = DataCache_t::Off,
+           pybind11::arg("compressed") = false,
+           pybind11::arg("transforms") = std::vector<DataTransformParam>(),
+           pybind11::arg("synthetic") = std::nullopt, pybind11::arg("key_profile_file") = "",
+           pybind11::arg("striped_upload") = false, pybind11::arg("int64_file_keys") = false);
   pybind11::class_<HugeCTR::HybridEmbeddingParam>(m, "HybridEmbeddingParam")
       .def(pybind11::init<size_t, int64_t, double, double, double, double,
                           hybrid_embedding::CommunicationType,
-                          hybrid_embedding::HybridEmbeddingType>(),
+                          hybrid_embedding::HybridEmbeddingType, size_t>(),
            pybind11::arg("max_num_frequent_categories"),
            pybind11::arg("max_num_infrequent_samples"), pybind11::arg("p_dup_max"),
            pybind11::arg("max_all_reduce_bandwidth"), pybind11::arg("max_all_to_all_bandwidth"),
            pybind11::arg("efficiency_bandwidth_ratio"), pybind11::arg("communication_type"),
-           pybind11::arg("hybrid_embedding_type"));
+           pybind11::arg("hybrid_embedding_type"), pybind11::arg("recalibration_interval") = 0);
   pybind11::enum_<HugeCTR::LrPolicy_t>(m, "LrPolicy_t")
       .value("fixed", HugeCTR::LrPolicy_t::fixed)
+      .value("cosine", HugeCTR::LrPolicy_t::cosine)
+      .value("step", HugeCTR::LrPolicy_t::step)
       .export_values();
   pybind11::enum_<HugeCTR::Optimizer_t>(m, "Optimizer_t")
       .value("Ftrl", HugeCTR::Optimizer_t::Ftrl)
@@ -181,6 +216,8 @@ void CommonPybind(pybind11::module& m) {
       .value("MomentumSGD", HugeCTR::Optimizer_t::MomentumSGD)
       .value("Nesterov", HugeCTR::Optimizer_t::Nesterov)
       .value("SGD", HugeCTR::Optimizer_t::SGD)
+      .value("RowWiseAdaGrad", HugeCTR::Optimizer_t::RowWiseAdaGrad)
+      .value("LazyAdam", HugeCTR::Optimizer_t::LazyAdam)
       .export_values();
   pybind11::enum_<HugeCTR::Update_t>(m, "Update_t")
       .value("Local", HugeCTR::Update_t::Local)
@@ -213,6 +250,10 @@ void CommonPybind(pybind11::module& m) {
       .value("HitRate", HugeCTR::metrics::Type::HitRate)
       .value("NDCG", HugeCTR::metrics::Type::NDCG)
       .value("SMAPE", HugeCTR::metrics::Type::SMAPE)
+      .value("StreamingAUC", HugeCTR::metrics::Type::StreamingAUC)
+      .value("QueryHitRate", HugeCTR::metrics::Type::QueryHitRate)
+      .value("QueryNDCG", HugeCTR::metrics::Type::QueryNDCG)
+      .value("QueryMRR", HugeCTR::metrics::Type::QueryMRR)
       .export_values();
   pybind11::enum_<HugeCTR::DeviceMap::Layout>(m, "DeviceLayout")
       .value("LocalFirst", HugeCTR::DeviceMap::Layout::LOCAL_FIRST)
@@ -221,6 +262,7 @@ void CommonPybind(pybind11::module& m) {
   pybind11::enum_<HugeCTR::AllReduceAlgo>(m, "AllReduceAlgo")
       .value("OneShot", HugeCTR::AllReduceAlgo::ONESHOT)
       .value("NCCL", HugeCTR::AllReduceAlgo::NCCL)
+      .value("Auto", HugeCTR::AllReduceAlgo::AUTO)
       .export_values();
   pybind11::enum_<HugeCTR::hybrid_embedding::HybridEmbeddingType>(m, "HybridEmbeddingType")
       .value("Distributed", HugeCTR::hybrid_embedding::HybridEmbeddingType::Distributed)
@@ -240,6 +282,14 @@ void CommonPybind(pybind11::module& m) {
       .value("Short", HugeCTR::PowerLaw_t::Short)
       .value("Specific", HugeCTR::PowerLaw_t::Specific)
       .export_values();
+  pybind11::class_<HugeCTR::SyntheticDataParam>(m, "SyntheticDataParam")
+      .def(pybind11::init<Distribution_t, PowerLaw_t, float, float, const std::vector<long long>&,
+                          unsigned long long>(),
+           pybind11::arg("distribution") = Distribution_t::PowerLaw,
+           pybind11::arg("power_law_type") = PowerLaw_t::Specific, pybind11::arg("alpha") = 1.2f,
+           pybind11::arg("unique_key_ratio") = 0.1f,
+           pybind11::arg("slot_size_array") = std::vector<long long>(),
+           pybind11::arg("seed") = 0);
   pybind11::enum_<HugeCTR::Tensor_t>(m, "Tensor_t")
       .value("Train", HugeCTR::Tensor_t::Train)
       .value("Evaluate", HugeCTR::Tensor_t::Evaluate)
@@ -255,6 +305,8 @@ void CommonPybind(pybind11::module& m) {
              HugeCTR::DatabaseType_t::ParallelHashMap)
       .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseType_t::MultiProcessHashMap),
              HugeCTR::DatabaseType_t::MultiProcessHashMap)
+      .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseType_t::DistributedHashMap),
+             HugeCTR::DatabaseType_t::DistributedHashMap)
       .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseType_t::RedisCluster),
              HugeCTR::DatabaseType_t::RedisCluster)
       .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseType_t::RocksDB),
@@ -267,6 +319,8 @@ void CommonPybind(pybind11::module& m) {
              HugeCTR::DatabaseOverflowPolicy_t::EvictLeastUsed)
       .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseOverflowPolicy_t::EvictOldest),
              HugeCTR::DatabaseOverflowPolicy_t::EvictOldest)
+      .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseOverflowPolicy_t::EvictClock),
+             HugeCTR::DatabaseOverflowPolicy_t::EvictClock)
       .export_values();
   pybind11::enum_<HugeCTR::UpdateSourceType_t>(m, "UpdateSourceType_t")
       .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::UpdateSourceType_t::Null),
@@ -274,6 +328,19 @@ void CommonPybind(pybind11::module& m) {
       .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::UpdateSourceType_t::KafkaMessageQueue),
              HugeCTR::UpdateSourceType_t::KafkaMessageQueue)
       .export_values();
+  m.def(
+      "get_metrics", [] { return HugeCTR::MetricsRegistry::get().snapshot(); },
+      "The counters and gauges of this process, by name");
+  m.def(
+      "reset_metrics", [] { HugeCTR::MetricsRegistry::get().reset(); },
+      "Sets all the counters and gauges to zero");
+  m.def(
+      "start_metrics_server",
+      [](int port) { HugeCTR::MetricsRegistry::get().start_server(port); },
+      "Serves the metrics in the Prometheus text format over HTTP", pybind11::arg("port"));
+  m.def(
+      "stop_metrics_server", [] { HugeCTR::MetricsRegistry::get().stop_server(); },
+      "Stops the server started by start_metrics_server");
 }
 
 }  // namespace python_lib
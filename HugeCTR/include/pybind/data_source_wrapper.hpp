@@ -28,11 +28,18 @@ void DataSourcePybind(pybind11::module &m) {
   pybind11::module data = m.def_submodule("data", "data submodule of hugectr");
   pybind11::class_<HugeCTR::DataSourceParams, std::shared_ptr<HugeCTR::DataSourceParams>>(
       data, "DataSourceParams")
-      .def(pybind11::init<FileSystemType_t, const std::string &, const int>(),
-           pybind11::arg("source"), pybind11::arg("server"), pybind11::arg("port"))
+      .def(pybind11::init<FileSystemType_t, const std::string &, const int, const std::string &,
+                          const size_t, const int, const bool>(),
+           pybind11::arg("source"), pybind11::arg("server"), pybind11::arg("port"),
+           pybind11::arg("cache_dir") = "", pybind11::arg("cache_capacity") = 0,
+           pybind11::arg("prefetch_depth") = 1, pybind11::arg("evict_after_read") = false)
       .def_readwrite("source", &HugeCTR::DataSourceParams::type)
       .def_readwrite("server", &HugeCTR::DataSourceParams::server)
-      .def_readwrite("port", &HugeCTR::DataSourceParams::port);
+      .def_readwrite("port", &HugeCTR::DataSourceParams::port)
+      .def_readwrite("cache_dir", &HugeCTR::DataSourceParams::cache_dir)
+      .def_readwrite("cache_capacity", &HugeCTR::DataSourceParams::cache_capacity)
+      .def_readwrite("prefetch_depth", &HugeCTR::DataSourceParams::prefetch_depth)
+      .def_readwrite("evict_after_read", &HugeCTR::DataSourceParams::evict_after_read);
 }
 }  // namespace python_lib
 }  // namespace HugeCTR
\ No newline at end of file
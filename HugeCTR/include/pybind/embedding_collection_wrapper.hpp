@@ -20,29 +20,56 @@
 #include <pybind11/stl.h>
 
 #include <embeddings/embedding_collection.hpp>
+#include <embeddings/embedding_planner.hpp>
+#include <resource_managers/gpu_topology.hpp>
 
 namespace HugeCTR {
 
 namespace python_lib {
 
 void EmbeddingCollectionPybind(pybind11::module &m) {
+  pybind11::class_<::embedding::DynamicEvictionParams>(m, "DynamicEvictionParams")
+      .def(pybind11::init<int64_t, uint64_t, uint64_t, int64_t>(), pybind11::arg("ttl_steps") = 0,
+           pybind11::arg("min_frequency") = 0, pybind11::arg("admission_threshold") = 0,
+           pybind11::arg("scan_interval") = 1000);
+  pybind11::class_<::embedding::DynamicOffloadParams>(m, "DynamicOffloadParams")
+      .def(pybind11::init<const std::string &, int64_t, int64_t>(), pybind11::arg("path"),
+           pybind11::arg("max_gpu_rows"), pybind11::arg("host_buffer_mb") = 64);
   pybind11::class_<EmbeddingTableConfig, std::shared_ptr<EmbeddingTableConfig>>(
       m, "EmbeddingTableConfig")
       .def(pybind11::init<const std::string &, int, int, std::optional<OptParams>,
-                          std::optional<embedding::InitParams>>(),
+                          std::optional<embedding::InitParams>, bool, float,
+                          std::optional<::embedding::DynamicEvictionParams>, bool,
+                          std::optional<::embedding::DynamicOffloadParams>>(),
            pybind11::arg("name"), pybind11::arg("max_vocabulary_size"), pybind11::arg("ev_size"),
            pybind11::arg("opt_params_or_empty") = std::nullopt,
-           pybind11::arg("init_param_or_empty") = std::nullopt);
+           pybind11::arg("init_param_or_empty") = std::nullopt,
+           pybind11::arg("fp16_opt_state") = false, pybind11::arg("lr_multiplier") = 1.f,
+           pybind11::arg("eviction_param_or_empty") = std::nullopt,
+           pybind11::arg("hash_keys") = false,
+           pybind11::arg("offload_param_or_empty") = std::nullopt);
   pybind11::enum_<::embedding::CommunicationStrategy>(m, "CommunicationStrategy")
       .value("Uniform", ::embedding::CommunicationStrategy::Uniform)
       .value("Hierarchical", ::embedding::CommunicationStrategy::Hierarchical)
       .export_values();
+  pybind11::enum_<::embedding::All2AllCompression>(m, "All2AllCompression")
+      .value("Non", ::embedding::All2AllCompression::None)
+      .value("FP16", ::embedding::All2AllCompression::FP16)
+      .value("FP8", ::embedding::All2AllCompression::FP8)
+      .export_values();
   pybind11::class_<HugeCTR::EmbeddingCollectionConfig,
                    std::shared_ptr<HugeCTR::EmbeddingCollectionConfig>>(m,
                                                                         "EmbeddingCollectionConfig")
-      .def(pybind11::init<bool, ::embedding::CommunicationStrategy>(),
+      .def(pybind11::init<bool, ::embedding::CommunicationStrategy, int,
+                          ::embedding::All2AllCompression, int, bool, bool, bool, bool>(),
            pybind11::arg("use_exclusive_keys") = false,
-           pybind11::arg("comm_strategy") = ::embedding::CommunicationStrategy::Uniform)
+           pybind11::arg("comm_strategy") = ::embedding::CommunicationStrategy::Uniform,
+           pybind11::arg("num_all2all_chunks") = 1,
+           pybind11::arg("all2all_compression") = ::embedding::All2AllCompression::None,
+           pybind11::arg("num_gradient_accumulation_steps") = 1,
+           pybind11::arg("unique_keys_before_all2all") = false,
+           pybind11::arg("sync_free") = false, pybind11::arg("sparse_allreduce") = false,
+           pybind11::arg("deterministic") = false)
       .def("embedding_lookup",
            pybind11::overload_cast<const EmbeddingTableConfig &, const std::string &,
                                    const std::string &, const std::string &>(
@@ -57,7 +84,46 @@ void EmbeddingCollectionPybind(pybind11::module &m) {
            pybind11::arg("table_config"), pybind11::arg("bottom_name"), pybind11::arg("top_name"),
            pybind11::arg("combiner"))
       .def("shard", &HugeCTR::EmbeddingCollectionConfig::shard, pybind11::arg("shard_matrix"),
-           pybind11::arg("shard_strategy"));
+           pybind11::arg("shard_strategy"),
+           pybind11::arg("row_splits") = std::unordered_map<std::string, std::vector<int64_t>>{})
+      .def("hybrid_param", &HugeCTR::EmbeddingCollectionConfig::hybrid_param,
+           pybind11::arg("max_num_hot_rows"), pybind11::arg("all_to_all_bandwidth"),
+           pybind11::arg("all_reduce_bandwidth"));
+  pybind11::class_<HugeCTR::EmbeddingPlannerTableStats>(m, "EmbeddingPlannerTableStats")
+      .def(pybind11::init<const std::string &, int64_t, int, int, double, int>(),
+           pybind11::arg("name"), pybind11::arg("vocabulary_size"), pybind11::arg("ev_size"),
+           pybind11::arg("max_hotness"), pybind11::arg("lookup_frequency") = -1.0,
+           pybind11::arg("num_optimizer_states") = 1);
+  pybind11::class_<HugeCTR::EmbeddingPlannerDeviceSpec>(m, "EmbeddingPlannerDeviceSpec")
+      .def(pybind11::init<int, int, int64_t, double, double, int64_t,
+                          const std::vector<std::vector<double>> &>(),
+           pybind11::arg("num_gpus"), pybind11::arg("global_batch_size"),
+           pybind11::arg("memory_bytes_per_gpu"), pybind11::arg("memory_bandwidth"),
+           pybind11::arg("comm_bandwidth"), pybind11::arg("max_data_parallel_table_bytes") = 0,
+           pybind11::arg("link_cost") = std::vector<std::vector<double>>{});
+  pybind11::enum_<HugeCTR::GpuLinkType>(m, "GpuLinkType")
+      .value("Self", HugeCTR::GpuLinkType::Self)
+      .value("NVLink", HugeCTR::GpuLinkType::NVLink)
+      .value("PCIeSwitch", HugeCTR::GpuLinkType::PCIeSwitch)
+      .value("PCIeHostBridge", HugeCTR::GpuLinkType::PCIeHostBridge)
+      .value("CPU", HugeCTR::GpuLinkType::CPU)
+      .value("CrossSocket", HugeCTR::GpuLinkType::CrossSocket);
+  pybind11::class_<HugeCTR::GpuTopology>(m, "GpuTopology")
+      .def_static("discover", &HugeCTR::GpuTopology::discover, pybind11::arg("device_list"))
+      .def_readonly("device_list", &HugeCTR::GpuTopology::device_list)
+      .def_readonly("link_type", &HugeCTR::GpuTopology::link_type)
+      .def_readonly("nvlink_count", &HugeCTR::GpuTopology::nvlink_count)
+      .def_readonly("cost", &HugeCTR::GpuTopology::cost)
+      .def("report", &HugeCTR::GpuTopology::report);
+  pybind11::class_<HugeCTR::EmbeddingShardPlan>(m, "EmbeddingShardPlan")
+      .def_readonly("shard_matrix", &HugeCTR::EmbeddingShardPlan::shard_matrix)
+      .def_readonly("shard_strategy", &HugeCTR::EmbeddingShardPlan::shard_strategy)
+      .def_readonly("gpu_cost", &HugeCTR::EmbeddingShardPlan::gpu_cost)
+      .def_readonly("gpu_memory", &HugeCTR::EmbeddingShardPlan::gpu_memory)
+      .def("imbalance", &HugeCTR::EmbeddingShardPlan::imbalance)
+      .def("report", &HugeCTR::EmbeddingShardPlan::report);
+  m.def("plan_embedding_sharding", &HugeCTR::plan_embedding_sharding, pybind11::arg("tables"),
+        pybind11::arg("spec"));
 }
 
 }  // namespace python_lib
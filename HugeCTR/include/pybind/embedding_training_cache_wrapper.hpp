@@ -82,7 +82,8 @@ HMemCacheConfig CreateHMemCache(size_t num_blocks, double target_hit_rate, size_
 
 std::shared_ptr<EmbeddingTrainingCacheParams> CreateETC(
     std::vector<TrainPSType_t>& ps_types, std::vector<std::string>& sparse_models,
-    std::vector<std::string>& local_paths, std::vector<HMemCacheConfig>& hcache_configs) {
+    std::vector<std::string>& local_paths, std::vector<HMemCacheConfig>& hcache_configs,
+    bool async_tiering) {
   std::shared_ptr<EmbeddingTrainingCacheParams> etc_params;
   check_sparse_models(sparse_models);
 
@@ -124,7 +125,8 @@ std::shared_ptr<EmbeddingTrainingCacheParams> CreateETC(
   }
 
   etc_params.reset(
-      new EmbeddingTrainingCacheParams(ps_types, sparse_models, local_paths, hcache_configs));
+      new EmbeddingTrainingCacheParams(ps_types, sparse_models, local_paths, hcache_configs,
+                                       async_tiering));
   return etc_params;
 }
 
@@ -136,7 +138,8 @@ void EmbeddingTrainingCachePybind(pybind11::module& m) {
   m.def("CreateETC", &HugeCTR::python_lib::CreateETC, pybind11::arg("ps_types"),
         pybind11::arg("sparse_models") = std::vector<std::string>(),
         pybind11::arg("local_paths") = std::vector<std::string>(),
-        pybind11::arg("hmem_cache_configs") = std::vector<HMemCacheConfig>());
+        pybind11::arg("hmem_cache_configs") = std::vector<HMemCacheConfig>(),
+        pybind11::arg("async_tiering") = false);
   pybind11::class_<HugeCTR::EmbeddingTrainingCacheParams,
                    std::shared_ptr<HugeCTR::EmbeddingTrainingCacheParams>>(
       m, "EmbeddingTrainingCacheParams");
@@ -148,6 +151,13 @@ void EmbeddingTrainingCachePybind(pybind11::module& m) {
       .def("update",
            pybind11::overload_cast<std::vector<std::string>&>(
                &HugeCTR::EmbeddingTrainingCache::update),
+           pybind11::arg("keyset_file_list"))
+      .def("prefetch",
+           pybind11::overload_cast<std::string&>(&HugeCTR::EmbeddingTrainingCache::prefetch),
+           pybind11::arg("keyset_file"))
+      .def("prefetch",
+           pybind11::overload_cast<std::vector<std::string>&>(
+               &HugeCTR::EmbeddingTrainingCache::prefetch),
            pybind11::arg("keyset_file_list"));
 }
 
@@ -20,15 +20,60 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <hps/cpu_lookup_session.hpp>
 #include <hps/embedding_cache.hpp>
 #include <hps/hier_parameter_server.hpp>
 #include <hps/lookup_session.hpp>
+#include <hps/prehashed_table.hpp>
 #include <pybind/hpsconversion.hpp>
 
 namespace HugeCTR {
 
 namespace python_lib {
 
+/**
+ * @brief Completion of an asynchronous HPS lookup
+ *
+ * The event is recorded on the stream of the lookup once all its work is enqueued. Other streams
+ * can wait for it without blocking the host.
+ */
+class LookupEvent {
+ public:
+  LookupEvent(int64_t device_id, cudaStream_t stream) : device_id_(device_id) {
+    CudaDeviceContext context(device_id_);
+    HCTR_LIB_THROW(cudaEventCreateWithFlags(&event_, cudaEventDisableTiming));
+    HCTR_LIB_THROW(cudaEventRecord(event_, stream));
+  }
+  LookupEvent(LookupEvent const&) = delete;
+  LookupEvent& operator=(LookupEvent const&) = delete;
+  ~LookupEvent() {
+    CudaDeviceContext context(device_id_);
+    HCTR_LIB_CHECK_(cudaEventDestroy(event_));
+  }
+
+  // Blocks until the lookup is done.
+  void synchronize() const { HCTR_LIB_THROW(cudaEventSynchronize(event_)); }
+  // Whether the lookup is done.
+  bool query() const {
+    const cudaError_t status = cudaEventQuery(event_);
+    if (status == cudaErrorNotReady) {
+      return false;
+    }
+    HCTR_LIB_THROW(status);
+    return true;
+  }
+  // Makes the work enqueued later on the stream wait for the lookup.
+  void wait(uintptr_t stream) const {
+    CudaDeviceContext context(device_id_);
+    HCTR_LIB_THROW(cudaStreamWaitEvent(reinterpret_cast<cudaStream_t>(stream), event_, 0));
+  }
+  uintptr_t handle() const { return reinterpret_cast<uintptr_t>(event_); }
+
+ private:
+  int64_t device_id_;
+  cudaEvent_t event_;
+};
+
 /**
  * @brief Main HPS class
  *
@@ -37,6 +82,8 @@ namespace python_lib {
  * for each model, e.g., {"dcn": [0], "deepfm": [1], "wdl": [0], "dlrm": [2]}. To support
  * multiple models deployed on multiple GPUs, e.g., {"dcn": [0, 1, 2, 3], "deepfm": [0, 1],
  * "wdl": [0], "dlrm": [2, 3]}, this class needs to be modified in the future.
+ *
+ * A model without deployed devices is looked up from the CPU only, see `CpuLookupSession`.
  */
 class HPS {
  public:
@@ -50,9 +97,39 @@ class HPS {
                                   size_t table_id, int64_t device_id);
   void lookup_fromdlpack(pybind11::capsule& keys, pybind11::capsule& out_tensor,
                          const std::string& model_name, size_t table_id, int64_t device_id);
+  /**
+   * Looks up the keys of a GPU DLPack tensor into a GPU DLPack tensor on the stream, and returns
+   * once the lookup is enqueued. The keys and the output must stay alive until the returned event
+   * completes.
+   */
+  std::shared_ptr<LookupEvent> lookup_async(pybind11::capsule& keys, pybind11::capsule& out_tensor,
+                                            const std::string& model_name, size_t table_id,
+                                            uintptr_t stream, int64_t device_id);
+  // Same for several tables of a model, one after the other on the stream.
+  std::shared_ptr<LookupEvent> lookup_batch_async(std::vector<pybind11::capsule>& keys,
+                                                  std::vector<pybind11::capsule>& out_tensors,
+                                                  const std::string& model_name,
+                                                  const std::vector<size_t>& table_ids,
+                                                  uintptr_t stream, int64_t device_id);
 
  private:
+  // Device pointers and size of the lookup of one table from DLPack tensors.
+  struct DLPackLookup {
+    const void* d_keys;
+    float* d_vectors;
+    size_t num_keys;
+    size_t table_id;
+  };
+
   void initialize();
+  DLPackLookup check_dlpack_lookup(pybind11::capsule& keys, pybind11::capsule& out_tensor,
+                                   const std::string& model_name, size_t table_id,
+                                   int64_t device_id) const;
+  std::shared_ptr<LookupEvent> lookup_dlpack_async(const std::vector<DLPackLookup>& lookups,
+                                                   const std::string& model_name,
+                                                   uintptr_t stream, int64_t device_id);
+  pybind11::array_t<float> lookup_cpu(pybind11::array_t<size_t>& h_keys,
+                                      CpuLookupSession& lookup_session, size_t table_id);
   parameter_server_config ps_config_;
 
   std::shared_ptr<HierParameterServerBase>
@@ -62,6 +139,8 @@ class HPS {
       lookup_session_map_;  // Lookup sessions of all models deployed on all devices, currently only
                             // the first session on the first device will be used during lookup,
                             // i.e., there will be no batching or scheduling
+  std::map<std::string, std::shared_ptr<CpuLookupSession>>
+      cpu_lookup_session_map_;  // Lookup sessions of the models without deployed devices
   std::map<std::string, std::map<int64_t, std::vector<float*>>> d_vectors_per_table_map_;
 
   std::map<std::string, std::vector<unsigned int*>> h_keys_per_table_map_;
@@ -100,6 +179,14 @@ HPS::HPS(parameter_server_config& ps_config) : ps_config_(ps_config) { initializ
 void HPS::initialize() {
   parameter_server_ = HierParameterServerBase::create(ps_config_);
   for (auto& inference_params : ps_config_.inference_params_array) {
+    if (inference_params.deployed_devices.empty()) {
+      cpu_lookup_session_map_.emplace(
+          inference_params.model_name,
+          std::make_shared<CpuLookupSession>(
+              inference_params, parameter_server_,
+              ps_config_.embedding_vec_size_.at(inference_params.model_name)));
+      continue;
+    }
     std::map<int64_t, std::shared_ptr<LookupSessionBase>> lookup_sessions;
     for (const auto& device_id : inference_params.deployed_devices) {
       inference_params.device_id = device_id;
@@ -223,9 +310,106 @@ void HPS::lookup_fromdlpack(pybind11::capsule& keys, pybind11::capsule& vectors,
                               cudaMemcpyDeviceToDevice));
   }
 }
+HPS::DLPackLookup HPS::check_dlpack_lookup(pybind11::capsule& keys, pybind11::capsule& out_tensor,
+                                            const std::string& model_name, size_t table_id,
+                                            int64_t device_id) const {
+  const auto session_it = lookup_session_map_.find(model_name);
+  HCTR_CHECK_HINT(session_it != lookup_session_map_.end(),
+                  "The model name does not exist in HPS, or has no deployed devices.");
+  HCTR_CHECK_HINT(session_it->second.count(device_id) > 0,
+                  "The model is not deployed on device ", device_id, ".");
+  const auto& max_keys_per_sample_per_table =
+      ps_config_.max_feature_num_per_sample_per_emb_table_.at(model_name);
+  const auto& embedding_size_per_table = ps_config_.embedding_vec_size_.at(model_name);
+  const auto& inference_params =
+      parameter_server_->get_hps_model_configuration_map().at(model_name);
+  HCTR_CHECK_HINT(table_id < embedding_size_per_table.size(), "The table id is out of range.");
+
+  // The tensors are used in place, so they must be dense and on the device of the lookup.
+  auto num_elements = [device_id](const HPSTensor& tensor, const char* name) {
+    HCTR_CHECK_HINT(tensor.device == DeviceType::CUDA && tensor.device_id == device_id, name,
+                    " should be on GPU ", device_id, ".");
+    size_t count = 1;
+    int64_t stride = 1;
+    for (int i = tensor.ndim - 1; i >= 0; --i) {
+      HCTR_CHECK_HINT(!tensor.strides || tensor.shape[i] == 1 || tensor.strides[i] == stride,
+                      name, " should be contiguous.");
+      stride *= tensor.shape[i];
+      count *= static_cast<size_t>(tensor.shape[i]);
+    }
+    return count;
+  };
+  const HPSTensor hps_key = fromDLPack(keys);
+  const HPSTensor hps_vec = fromDLPack(out_tensor);
+  const size_t num_keys = num_elements(hps_key, "The keys");
+  const size_t num_vectors = num_elements(hps_vec, "The output");
+  const bool i64_key = inference_params.i64_input_key;
+  HCTR_CHECK_HINT(hps_key.type == (i64_key ? DataType::Int64 : DataType::Int),
+                  "The keys should be ", i64_key ? "int64" : "int32", " for model ", model_name,
+                  ".");
+  HCTR_CHECK_HINT(hps_vec.type == DataType::Float, "The output should be float32.");
+  HCTR_CHECK_HINT(
+      num_keys <= max_keys_per_sample_per_table[table_id] * inference_params.max_batchsize,
+      "The number of keys to be queried should be no large than "
+      "max_keys_per_sample_per_table[table_id] * inference_params.max_batchsize.");
+  HCTR_CHECK_HINT(num_vectors >= num_keys * embedding_size_per_table[table_id],
+                  "The output should hold embedding vector size * number of embedding keys "
+                  "floats.");
+
+  return {static_cast<const char*>(hps_key.data) + hps_key.byte_offset,
+          reinterpret_cast<float*>(static_cast<char*>(hps_vec.data) + hps_vec.byte_offset),
+          num_keys, table_id};
+}
+
+std::shared_ptr<LookupEvent> HPS::lookup_dlpack_async(const std::vector<DLPackLookup>& lookups,
+                                                      const std::string& model_name,
+                                                      uintptr_t stream, int64_t device_id) {
+  const auto& lookup_session = lookup_session_map_.at(model_name).at(device_id);
+  const cudaStream_t cuda_stream = reinterpret_cast<cudaStream_t>(stream);
+  // Only the misses of the embedding cache wait for the databases, other Python threads run
+  // meanwhile.
+  pybind11::gil_scoped_release release;
+  for (const auto& lookup : lookups) {
+    if (lookup.num_keys == 0) {
+      continue;
+    }
+    lookup_session->lookup_from_device(lookup.d_keys, lookup.d_vectors, lookup.num_keys,
+                                       lookup.table_id, cuda_stream);
+  }
+  return std::make_shared<LookupEvent>(device_id, cuda_stream);
+}
+
+std::shared_ptr<LookupEvent> HPS::lookup_async(pybind11::capsule& keys,
+                                               pybind11::capsule& out_tensor,
+                                               const std::string& model_name, size_t table_id,
+                                               uintptr_t stream, int64_t device_id) {
+  const DLPackLookup lookup =
+      check_dlpack_lookup(keys, out_tensor, model_name, table_id, device_id);
+  return lookup_dlpack_async({lookup}, model_name, stream, device_id);
+}
+
+std::shared_ptr<LookupEvent> HPS::lookup_batch_async(std::vector<pybind11::capsule>& keys,
+                                                     std::vector<pybind11::capsule>& out_tensors,
+                                                     const std::string& model_name,
+                                                     const std::vector<size_t>& table_ids,
+                                                     uintptr_t stream, int64_t device_id) {
+  HCTR_CHECK_HINT(keys.size() == table_ids.size() && out_tensors.size() == table_ids.size(),
+                  "There should be as many keys and outputs as table ids.");
+  std::vector<DLPackLookup> lookups;
+  for (size_t i = 0; i < table_ids.size(); ++i) {
+    lookups.push_back(
+        check_dlpack_lookup(keys[i], out_tensors[i], model_name, table_ids[i], device_id));
+  }
+  return lookup_dlpack_async(lookups, model_name, stream, device_id);
+}
+
 pybind11::array_t<float> HPS::lookup(pybind11::array_t<size_t>& h_keys,
                                      const std::string& model_name, size_t table_id,
                                      int64_t device_id) {
+  const auto cpu_it = cpu_lookup_session_map_.find(model_name);
+  if (cpu_it != cpu_lookup_session_map_.end()) {
+    return lookup_cpu(h_keys, *cpu_it->second, table_id);
+  }
   if (lookup_session_map_.find(model_name) == lookup_session_map_.end()) {
     HCTR_OWN_THROW(Error_t::WrongInput, "The model name does not exist in HPS.");
   }
@@ -273,6 +457,35 @@ pybind11::array_t<float> HPS::lookup(pybind11::array_t<size_t>& h_keys,
   return h_vectors;
 }
 
+pybind11::array_t<float> HPS::lookup_cpu(pybind11::array_t<size_t>& h_keys,
+                                         CpuLookupSession& lookup_session, size_t table_id) {
+  const auto& embedding_size_per_table =
+      ps_config_.embedding_vec_size_.at(lookup_session.get_inference_params().model_name);
+  pybind11::buffer_info key_buf = h_keys.request();
+  HCTR_CHECK_HINT(key_buf.ndim == 1, "Number of dimensions of h_keys must be one.");
+  HCTR_CHECK_HINT(table_id < embedding_size_per_table.size(), "The table id is out of range.");
+  const size_t num_keys = key_buf.size;
+
+  // The keys are passed as is for long long keys, and narrowed for unsigned int keys.
+  std::vector<unsigned int> u32_keys;
+  const void* key_ptr = key_buf.ptr;
+  if (!lookup_session.get_inference_params().i64_input_key) {
+    const long long* i64_keys = static_cast<const long long*>(key_buf.ptr);
+    u32_keys.assign(i64_keys, i64_keys + num_keys);
+    key_ptr = u32_keys.data();
+  }
+
+  pybind11::array_t<float> h_vectors(
+      std::vector<size_t>{num_keys, embedding_size_per_table[table_id]});
+  float* vec_ptr = static_cast<float*>(h_vectors.request().ptr);
+  {
+    // The database tiers are queried by the HPS workers, other Python threads may run meanwhile.
+    pybind11::gil_scoped_release release;
+    lookup_session.lookup(key_ptr, vec_ptr, num_keys, table_id);
+  }
+  return h_vectors;
+}
+
 void HPSPybind(pybind11::module& m) {
   pybind11::module infer = m.def_submodule("inference", "inference submodule of hugectr");
 
@@ -322,9 +535,9 @@ void HPSPybind(pybind11::module& m) {
                                                                        "PersistentDatabaseParams")
       .def(pybind11::init<DatabaseType_t,
                           // Backend specific.
-                          const std::string&, size_t, bool, size_t,
+                          const std::string&, size_t, bool, size_t, size_t, size_t, bool,
                           // Caching behavior related.
-                          bool,
+                          bool, bool,
                           // Real-time update mechanism related.
                           const std::vector<std::string>&>(),
            pybind11::arg("backend") = DatabaseType_t::Disabled,
@@ -332,8 +545,10 @@ void HPSPybind(pybind11::module& m) {
            pybind11::arg("path") = (std::filesystem::temp_directory_path() / "rocksdb").string(),
            pybind11::arg("num_threads") = 16, pybind11::arg("read_only") = false,
            pybind11::arg("max_batch_size") = 64L * 1024L,
+           pybind11::arg("block_cache_size") = 8L * 1024L * 1024L,
+           pybind11::arg("bloom_filter_bits") = 10, pybind11::arg("use_direct_reads") = false,
            // Caching behavior related.
-           pybind11::arg("initialize_after_startup") = true,
+           pybind11::arg("initialize_after_startup") = true, pybind11::arg("bulk_load") = false,
            // Real-time update mechanism related.
            pybind11::arg("update_filters") = std::vector<std::string>{"^hps_.+$"});
 
@@ -341,14 +556,16 @@ void HPSPybind(pybind11::module& m) {
       infer, "UpdateSourceParams")
       .def(pybind11::init<UpdateSourceType_t,
                           // Backend specific.
-                          const std::string&, size_t, size_t, size_t, size_t, size_t, size_t>(),
+                          const std::string&, size_t, size_t, size_t, size_t, size_t, size_t,
+                          bool>(),
            pybind11::arg("type") = UpdateSourceType_t::Null,
            // Backend specific.
            pybind11::arg("brokers") = "127.0.0.1:9092",
            pybind11::arg("metadata_refresh_interval_ms") = 30'000,
            pybind11::arg("receive_buffer_size") = 256 * 1024,
            pybind11::arg("poll_timeout_ms") = 500, pybind11::arg("max_batch_size") = 8 * 1024,
-           pybind11::arg("failure_backoff_ms") = 50, pybind11::arg("max_commit_interval") = 32);
+           pybind11::arg("failure_backoff_ms") = 50, pybind11::arg("max_commit_interval") = 32,
+           pybind11::arg("update_embedding_cache") = false);
 
   pybind11::enum_<EmbeddingCacheType_t>(infer, "EmbeddingCacheType_t")
       .value("Dynamic", EmbeddingCacheType_t::Dynamic)
@@ -357,6 +574,19 @@ void HPSPybind(pybind11::module& m) {
       .value(hctr_enum_to_c_str(EmbeddingCacheType_t::Stochastic), EmbeddingCacheType_t::Stochastic)
       .export_values();
 
+  pybind11::enum_<AdmissionPolicy_t>(infer, "AdmissionPolicy_t")
+      .value("Disabled", AdmissionPolicy_t::Disabled)
+      .value("Frequency", AdmissionPolicy_t::Frequency)
+      .value("Probabilistic", AdmissionPolicy_t::Probabilistic)
+      .value("Doorkeeper", AdmissionPolicy_t::Doorkeeper)
+      .export_values();
+
+  pybind11::enum_<SharedCacheRole_t>(infer, "SharedCacheRole_t")
+      .value("Disabled", SharedCacheRole_t::Disabled)
+      .value("Owner", SharedCacheRole_t::Owner)
+      .value("Reader", SharedCacheRole_t::Reader)
+      .export_values();
+
   pybind11::class_<HugeCTR::InferenceParams, std::shared_ptr<HugeCTR::InferenceParams>>(
       infer, "InferenceParams")
       .def(pybind11::init<const std::string&, const size_t, const float, const std::string&,
@@ -370,7 +600,11 @@ void HPSPybind(pybind11::module& m) {
                           const float, const float, const std::vector<size_t>&,
                           const std::vector<size_t>&, const std::vector<std::string>&,
                           const std::string&, const size_t, const size_t, const std::string&, bool,
-                          const EmbeddingCacheType_t&, bool, bool, bool, bool, bool, bool>(),
+                          const EmbeddingCacheType_t&, bool, bool, bool, bool, bool, bool,
+                          bool, size_t, const std::vector<size_t>&, bool, size_t, float,
+                          const std::vector<AdmissionPolicy_t>&, const std::vector<float>&,
+                          bool, SharedCacheRole_t, float, bool, bool, float, size_t, float,
+                          const std::string&, const std::string&>(),
 
            pybind11::arg("model_name"), pybind11::arg("max_batchsize"),
            pybind11::arg("hit_rate_threshold"), pybind11::arg("dense_model_file"),
@@ -402,7 +636,23 @@ void HPSPybind(pybind11::module& m) {
            pybind11::arg("use_context_stream") = true,
            pybind11::arg("fuse_embedding_table") = false,
            pybind11::arg("use_hctr_cache_implementation") = true, pybind11::arg("init_ec") = true,
-           pybind11::arg("enable_pagelock") = false, pybind11::arg("fp8_quant") = false);
+           pybind11::arg("enable_pagelock") = false, pybind11::arg("fp8_quant") = false,
+           pybind11::arg("use_bloom_filter") = false, pybind11::arg("hot_key_set_size") = 0,
+           pybind11::arg("set_associativity_per_table") = std::vector<size_t>{},
+           pybind11::arg("shard_uvm_table") = false,
+           pybind11::arg("uvm_table_staging_buffers") = 2,
+           pybind11::arg("sync_insert_latency_budget_us") = 0.0f,
+           pybind11::arg("admission_policy_per_table") = std::vector<AdmissionPolicy_t>{},
+           pybind11::arg("admission_threshold_per_table") = std::vector<float>{},
+           pybind11::arg("use_capturable_lookup") = false,
+           pybind11::arg("shared_cache_role") = SharedCacheRole_t::Disabled,
+           pybind11::arg("refresh_time_budget_ms") = 0.0f,
+           pybind11::arg("refresh_updated_keys_only") = false,
+           pybind11::arg("background_refresh") = false,
+           pybind11::arg("lookup_batching_window_us") = 0.0f,
+           pybind11::arg("lookup_batching_max_keys") = 0,
+           pybind11::arg("cache_rebalance_percentage") = 0.0f,
+           pybind11::arg("key_log_warmup_file") = "", pybind11::arg("key_log_record_file") = "");
 
   pybind11::class_<HugeCTR::parameter_server_config,
                    std::shared_ptr<HugeCTR::parameter_server_config>>(infer,
@@ -427,7 +677,35 @@ void HPSPybind(pybind11::module& m) {
            pybind11::arg("model_name"), pybind11::arg("table_id"), pybind11::arg("device_id") = 0)
       .def("lookup_fromdlpack", &HugeCTR::python_lib::HPS::lookup_fromdlpack, pybind11::arg("keys"),
            pybind11::arg("out_tensor"), pybind11::arg("model_name"), pybind11::arg("table_id"),
+           pybind11::arg("device_id") = 0)
+      .def("lookup_async", &HugeCTR::python_lib::HPS::lookup_async, pybind11::arg("keys"),
+           pybind11::arg("out_tensor"), pybind11::arg("model_name"), pybind11::arg("table_id"),
+           pybind11::arg("stream") = 0, pybind11::arg("device_id") = 0)
+      .def("lookup_batch_async", &HugeCTR::python_lib::HPS::lookup_batch_async,
+           pybind11::arg("keys"), pybind11::arg("out_tensors"), pybind11::arg("model_name"),
+           pybind11::arg("table_ids"), pybind11::arg("stream") = 0,
            pybind11::arg("device_id") = 0);
+
+  pybind11::class_<HugeCTR::python_lib::LookupEvent,
+                   std::shared_ptr<HugeCTR::python_lib::LookupEvent>>(infer, "LookupEvent")
+      .def("synchronize", &HugeCTR::python_lib::LookupEvent::synchronize,
+           pybind11::call_guard<pybind11::gil_scoped_release>())
+      .def("query", &HugeCTR::python_lib::LookupEvent::query)
+      .def("wait", &HugeCTR::python_lib::LookupEvent::wait, pybind11::arg("stream"))
+      .def_property_readonly("handle", &HugeCTR::python_lib::LookupEvent::handle);
+
+  infer.def(
+      "write_prehashed_table",
+      [](const std::string& model_path, const std::string& path, const size_t capacity,
+         const bool i64_input_key) {
+        if (i64_input_key) {
+          PrehashedTable<long long>::write(model_path, path, capacity);
+        } else {
+          PrehashedTable<unsigned int>::write(model_path, path, capacity);
+        }
+      },
+      pybind11::arg("model_path"), pybind11::arg("path") = "", pybind11::arg("capacity") = 0,
+      pybind11::arg("i64_input_key") = true);
 }
 
 }  // namespace python_lib
@@ -24,6 +24,7 @@
 #include <embedding_training_cache/embedding_training_cache.hpp>
 #include <embeddings/embedding_collection.hpp>
 #include <exchange_wgrad.hpp>
+#include <future>
 #include <graph_wrapper.hpp>
 #include <hps/hier_parameter_server.hpp>
 #include <hps/kafka_message.hpp>
@@ -31,11 +32,13 @@
 #include <inference/preallocated_buffer2.hpp>
 #include <io/filesystem.hpp>
 #include <loss.hpp>
+#include <memory_planner.hpp>
 #include <metrics.hpp>
 #include <optimizer.hpp>
 #include <parser.hpp>
 #include <pipeline.hpp>
 #include <pybind/common_helpers.hpp>
+#include <step_profiler.hpp>
 #include <string>
 #include <thread>
 #include <utility>
@@ -70,6 +73,7 @@ std::map<Layer_t, std::string> LAYER_TYPE_TO_STRING = {
     {Layer_t::Gather, "Gather"},
     {Layer_t::PReLU_Dice, "PReLU_Dice"},
     {Layer_t::GRU, "GRU"},
+    {Layer_t::AUGRU, "AUGRU"},
     {Layer_t::MatrixMultiply, "MatrixMultiply"},
     {Layer_t::MultiHeadAttention, "MultiHeadAttention"},
     {Layer_t::Scale, "Scale"},
@@ -82,6 +86,7 @@ std::map<Layer_t, std::string> LAYER_TYPE_TO_STRING = {
     {Layer_t::ElementwiseMultiply, "ElementwiseMultiply"},
     {Layer_t::MultiCross, "MultiCross"},
     {Layer_t::MLP, "MLP"},
+    {Layer_t::GroupedMLP, "GroupedMLP"},
     {Layer_t::SequenceMask, "SequenceMask"}};
 
 std::map<Layer_t, std::string> LAYER_TYPE_TO_STRING_MP = {
@@ -109,13 +114,15 @@ std::map<Layer_t, std::string> LAYER_TYPE_TO_STRING_MP = {
     {Layer_t::FusedInnerProduct, "FusedInnerProduct"},
     {Layer_t::MultiCross, "MultiCross"},
     {Layer_t::MLP, "MLP"},
+    {Layer_t::GroupedMLP, "GroupedMLP"},
     {Layer_t::SequenceMask, "SequenceMask"}};
 
 std::set<Layer_t> TRAINABLE_LAYERS = {Layer_t::InnerProduct, Layer_t::FusedInnerProduct,
                                       Layer_t::MultiCross,   Layer_t::WeightMultiply,
                                       Layer_t::BatchNorm,    Layer_t::LayerNorm,
                                       Layer_t::GRU,          Layer_t::MultiHeadAttention,
-                                      Layer_t::MLP};
+                                      Layer_t::MLP,          Layer_t::AUGRU,
+                                      Layer_t::GroupedMLP};
 
 std::map<Embedding_t, std::string> EMBEDDING_TYPE_TO_STRING = {
     {Embedding_t::DistributedSlotSparseEmbeddingHash, "DistributedSlotSparseEmbeddingHash"},
@@ -134,7 +141,8 @@ std::map<Initializer_t, std::string> INITIALIZER_TYPE_TO_STRING = {
     {Initializer_t::Zero, "Zero"}};
 
 std::map<AllReduceAlgo, std::string> ALLREDUCE_ALGO_TO_STRING = {
-    {AllReduceAlgo::ONESHOT, "OneShot"}, {AllReduceAlgo::NCCL, "NCCL"}};
+    {AllReduceAlgo::ONESHOT, "OneShot"}, {AllReduceAlgo::NCCL, "NCCL"},
+    {AllReduceAlgo::AUTO, "Auto"}};
 
 std::map<hybrid_embedding::CommunicationType, std::string> HE_COMM_TYPE_TO_STRING = {
     {hybrid_embedding::CommunicationType::IB_NVLink_Hier, "IB_NVLink_Hierarchical"},
@@ -170,18 +178,21 @@ struct DataReaderParams {
   std::vector<long long int> slot_size_array;
   DataSourceParams data_source_params;
   AsyncParam async_param;
+  bool parse_on_device;
   DataReaderParams(DataReaderType_t data_reader_type, std::string source, std::string keyset,
                    std::string eval_source, Check_t check_type, int cache_eval_data,
                    long long num_samples, long long eval_num_samples, bool float_label_dense,
                    bool read_file_sequentially, int num_workers,
                    std::vector<long long>& slot_size_array,
-                   const DataSourceParams& data_source_params, const AsyncParam& async_param);
+                   const DataSourceParams& data_source_params, const AsyncParam& async_param,
+                   bool parse_on_device = false);
   DataReaderParams(DataReaderType_t data_reader_type, std::vector<std::string> source,
                    std::vector<std::string> keyset, std::string eval_source, Check_t check_type,
                    int cache_eval_data, long long num_samples, long long eval_num_samples,
                    bool float_label_dense, bool read_file_sequentially, int num_workers,
                    std::vector<long long>& slot_size_array,
-                   const DataSourceParams& data_source_params, const AsyncParam& async_param);
+                   const DataSourceParams& data_source_params, const AsyncParam& async_param,
+                   bool parse_on_device = false);
 };
 
 struct Input {
@@ -228,18 +239,23 @@ struct EmbeddingTrainingCacheParams {
   std::vector<std::string> local_paths;
   std::vector<HMemCacheConfig> hmem_cache_configs;
   std::vector<std::string> incremental_keyset_files;
+  bool async_tiering;
   EmbeddingTrainingCacheParams(std::vector<TrainPSType_t>& _ps_types,
                                std::vector<std::string>& _sparse_models,
                                std::vector<std::string>& _local_paths,
-                               std::vector<HMemCacheConfig>& _hmem_cache_configs);
+                               std::vector<HMemCacheConfig>& _hmem_cache_configs,
+                               bool _async_tiering = false);
   EmbeddingTrainingCacheParams();
 };
 
 struct DenseLayerComputeConfig {
   bool async_wgrad;
   bool fuse_wb;
+  bool enable_fp8;
+  bool recompute;
   DenseLayerComputeConfig();
-  DenseLayerComputeConfig(bool async_wgrad, bool fuse_wb);
+  DenseLayerComputeConfig(bool async_wgrad, bool fuse_wb, bool enable_fp8 = false,
+                          bool recompute = false);
 };
 
 struct DenseLayer {
@@ -273,6 +289,7 @@ struct DenseLayer {
   int max_sequence_len_to;
   int num_attention_heads;
   bool transpose_b;
+  bool fused_attention;
   std::vector<float> target_weight_vec;
   bool use_regularizer;
   Regularizer_t regularizer_type;
@@ -285,6 +302,9 @@ struct DenseLayer {
   std::vector<bool> biases;
   DenseLayerComputeConfig compute_config;
 
+  // rate of a recomputed Dropout fused into a LayerNorm, 0 for none
+  float fused_dropout_rate = 0.f;
+
   // reshape layer param
   std::vector<int64_t> reshape_out_dimension;
 
@@ -316,7 +336,7 @@ struct DenseLayer {
              std::vector<bool> biases = std::vector<bool>(),
              DenseLayerComputeConfig compute_config = DenseLayerComputeConfig(),
              const std::vector<int64_t>& reshape_out_dimension = {}, int dim = 0,
-             const std::vector<int64_t>& index = {});
+             const std::vector<int64_t>& index = {}, bool fused_attention = false);
 };
 
 struct GroupDenseLayer {
@@ -403,6 +423,15 @@ void save_graph_to_json(nlohmann::json& layer_config_array,
 void calculate_tensor_dimensions(std::map<std::string, std::vector<int>>& tensor_shape_info_raw,
                                  DenseLayer& dense_layer);
 
+/**
+ * Merges the elementwise layers and GEMMs that follow an InnerProduct or MLP layer into it, when
+ * they are its only consumer: a ReLU becomes the activation epilogue of its last GEMM and another
+ * InnerProduct or MLP layer with the same initializers and compute config extends it.
+ * The weights keep their order, so the dense model files stay compatible.
+ */
+void fuse_dense_layers(std::vector<DenseLayer>& dense_layers,
+                       const std::map<std::string, std::vector<int>>& tensor_shape_info_raw);
+
 void init_optimizer_params(OptParams& opt_params, const Solver& solver,
                            const std::shared_ptr<OptParamsPy>& opt_params_py);
 
@@ -451,8 +480,14 @@ class Model final {
 
   void summary();
 
+  /**
+   * Trains the model.
+   * @param profile_iterations If positive, the first profile_iterations training iterations are
+   * timed part by part, see `StepProfiler`, without CUDA graphs, and the report is logged.
+   * @param profile_path The JSON file the profile is written to, if not empty.
+   */
   void fit(int num_epochs, int max_iter, int display, int eval_interval, int snapshot,
-           std::string snapshot_prefix);
+           std::string snapshot_prefix, int profile_iterations = 0, std::string profile_path = "");
 
   void set_source(std::vector<std::string> source, std::vector<std::string> keyset,
                   std::string eval_source);
@@ -465,6 +500,15 @@ class Model final {
 
   std::vector<std::pair<std::string, float>> get_eval_metrics();
 
+  /**
+   * Scores the evaluation source and writes the predictions to files, see
+   * `metrics::PredictionWriter`. Reading, embedding lookup, dense forward and writing overlap as in
+   * the evaluation. Stops after max_batches batches, or at the end of the source if max_batches
+   * is not positive.
+   * @return The number of samples scored by this process.
+   */
+  size_t predict(const std::string& output_prefix, int max_batches);
+
   Error_t get_current_loss(float* loss);
 
   Error_t download_params_to_files(std::string prefix, int iter);
@@ -537,16 +581,31 @@ class Model final {
   }
 
   bool use_gpu_learning_rate_scheduling() const {
-    return !embeddings_.empty() && !embeddings_[0]->get_learning_rate_schedulers().empty();
+    return solver_.gpu_learning_rate_scheduling ||
+           (!embeddings_.empty() && !embeddings_[0]->get_learning_rate_schedulers().empty());
   }
 
   void load_dense_weights(const std::string& dense_model_file);
   void load_sparse_weights(const std::vector<std::string>& sparse_embedding_files);
   void load_sparse_weights(const std::map<std::string, std::string>& sparse_embedding_files_maps);
   void load_dense_optimizer_states(const std::string& dense_opt_states_file);
+  /**
+   * Recovers from a failed or timed out collective without restarting the job: recreates the
+   * NCCL communicators, then restores the dense model of every GPU from the last async
+   * checkpoint, which also brings the replicas back in sync.
+   */
+  void recover();
   void load_sparse_optimizer_states(const std::vector<std::string>& sparse_opt_states_files);
   void embedding_load(const std::string& path, const std::vector<std::string>& table_names);
-  void embedding_dump(const std::string& path, const std::vector<std::string>& table_names);
+  void embedding_dump(const std::string& path, const std::vector<std::string>& table_names,
+                      bool incremental = false);
+  /**
+   * Exports the tables for the HPS, pruned by update count and L2 norm and optionally row-wise
+   * quantized to fp8 (see EmbeddingParameterIO::export_embedding_weight).
+   */
+  void embedding_export(const std::string& path, const std::vector<std::string>& table_names,
+                        int min_update_count = 0, float min_l2_norm = 0.f,
+                        bool fp8_quant = false);
   void load_sparse_optimizer_states(
       const std::map<std::string, std::string>& sparse_opt_states_files_map);
   void freeze_embedding() {
@@ -662,6 +721,9 @@ class Model final {
 
   std::shared_ptr<IDataReader> init_data_reader_;
   std::shared_ptr<ExchangeWgrad> exchange_wgrad_;
+  std::unique_ptr<MemoryPlanner> memory_planner_;
+  std::unique_ptr<StepProfiler> profiler_;
+  std::string profile_path_;
   bool embedding_dependent_;
   bool high_level_eval_;
   HugeCTR::Timer timer_log;
@@ -669,12 +731,50 @@ class Model final {
   std::set<std::string> embedding_dependent_tensors_;
 
   std::shared_ptr<DataDistributor> train_data_distributor_, eval_data_distributor_;
+  // Whether the CUDA graph of the training pipeline covers the whole step, embedding included
+  bool capture_train_step_ = false;
 
   std::vector<std::shared_ptr<TrainingCallback>> training_callbacks_;
 
+  // Pinned snapshot of the dense weights, then the dense optimizer states, which
+  // dense_checkpoint_writer_ writes to files in the background if solver_.async_checkpoint is set.
+  char* dense_checkpoint_buffer_ = nullptr;
+  size_t dense_checkpoint_buffer_size_ = 0;
+  std::future<void> dense_checkpoint_writer_;
+
+  // Push of the rows updated since the last dump_incremental_model_2kafka() without the embedding
+  // training cache, see stream_incremental_model_2kafka_().
+  std::future<void> incremental_model_stream_;
+
+  // The shard of the flattened dense weights whose optimizer states each local GPU keeps and
+  // updates. Empty unless solver_.shard_dense_optimizer is set and there are several GPUs.
+  std::vector<WeightShard> dense_shards_;
+
   Error_t download_dense_params_to_files_(std::string weights_file,
                                           std::string dense_opt_states_file);
 
+  /**
+   * Puts the shards of the dense optimizer states of all the GPUs together, in the layout of the
+   * unsharded states, on the master process. All the processes must call it.
+   */
+  std::vector<float> gather_sharded_dense_opt_states_();
+
+  /**
+   * Wait until the background write of the last dense snapshot is done, if any.
+   */
+  void wait_for_dense_checkpoint_();
+
+  /**
+   * Streams the rows that the training updated since the last call to the message sink, from the
+   * DeltaTracker of every embedding, on a background thread.
+   */
+  void stream_incremental_model_2kafka_();
+
+  /**
+   * Wait until the background push of the last incremental model is done, if any.
+   */
+  void wait_for_incremental_model_stream_();
+
   Error_t download_sparse_params_to_files_(const std::vector<std::string>& embedding_files,
                                            const std::vector<std::string>& sparse_opt_state_files);
 
@@ -684,6 +784,9 @@ class Model final {
       const std::vector<std::string>& sparse_embedding_files,
       const std::vector<std::string>& local_paths,
       const std::vector<HMemCacheConfig>& hmem_cache_configs);
+  std::vector<std::vector<int64_t>> create_table_hot_keys_(
+      const EmbeddingCollectionConfig& ebc_config, const TableNameToIDDict& table_name_to_id_dict,
+      const std::vector<std::vector<int>>& shard_matrix);
   void init_params_for_dense_();
   void init_params_for_sparse_();
   void init_embedding_training_cache_(const std::vector<TrainPSType_t>& ps_types,
@@ -695,13 +798,25 @@ class Model final {
   Error_t load_opt_states_for_dense_(const std::string& dense_opt_states_file);
   Error_t load_opt_states_for_sparse_(const std::vector<std::string>& sparse_opt_states_files);
   void exchange_wgrad(size_t device_id);
+  // Whether the training runs CUDA graphs, which it does not while it is profiled.
+  bool train_with_cuda_graph() const;
+  void start_profiling_(int num_iterations, const std::string& path);
+  void end_profiled_iteration_();
+  // Runs work, timed by the profiler while it is active.
+  void profile_(size_t local_id, const std::string& name, StepProfiler::Kind kind,
+                const std::function<void()>& work);
+  void profile_ebc_stage_(size_t local_id, size_t ebc_id, embedding::Stage stage,
+                          const std::function<void()>& work);
+  void init_wgrad_buckets_(const std::vector<void*>& wgrad_buffer_ptrs, size_t wgrad_buffer_size);
   void pre_add_dense_layer(DenseLayer& dense_layer);
   void add_dense_layers(std::vector<DenseLayer>& dense_layers);
 
   void create_networks();
   void build_networks();
   void initialize();
+  void search_algorithm_with_cache_();
   void create_metrics();
+  int get_label_dim_() const;
   void create_pipelines();
   std::vector<core23::Tensor> wgrad_tensor_successor_;
 
@@ -773,6 +888,17 @@ class Model final {
   void create_evaluate_pipeline_with_ebc(std::vector<std::shared_ptr<NetworkType>>& networks);
 
   bool skip_prefetch_in_last_batch(bool is_train);
+  /**
+   * Makes the streams of the GPUs wait for the metrics, which the evaluate pipeline may accumulate
+   * on a side stream.
+   */
+  void wait_for_eval_metrics();
+  /**
+   * @return Whether the 95% confidence interval of the AUC over the eval batches so far is within
+   * solver_.eval_auc_tolerance, so that the evaluation can stop early.
+   */
+  bool is_eval_auc_within_tolerance(int num_eval_batches);
+  void prepare_train_ddl_input(int local_id);
   long long read_a_batch(bool is_train);
   void train_pipeline(size_t current_batch_size);
   void evaluate_pipeline(size_t current_batch_size);
@@ -30,7 +30,7 @@ void ModelPybind(pybind11::module &m) {
       m, "DataReaderParams")
       .def(pybind11::init<DataReaderType_t, std::string, std::string, std::string, Check_t, int,
                           long long, long long, bool, bool, int, std::vector<long long> &,
-                          const DataSourceParams &, const AsyncParam &>(),
+                          const DataSourceParams &, const AsyncParam &, bool>(),
            pybind11::arg("data_reader_type"), pybind11::arg("source"), pybind11::arg("keyset") = "",
            pybind11::arg("eval_source"), pybind11::arg("check_type"),
            pybind11::arg("cache_eval_data") = 0, pybind11::arg("num_samples") = 0,
@@ -39,10 +39,12 @@ void ModelPybind(pybind11::module &m) {
            pybind11::arg("slot_size_array") = std::vector<long long>(),
            pybind11::arg("data_source_params") = new DataSourceParams(),
            pybind11::arg("async_param") =
-               AsyncParam{16, 4, 512000, 4, 512, false, Alignment_t::None, false, false})
+               AsyncParam{16, 4, 512000, 4, 512, false, Alignment_t::None, false, false},
+           pybind11::arg("parse_on_device") = false)
       .def(pybind11::init<DataReaderType_t, std::vector<std::string>, std::vector<std::string>,
                           std::string, Check_t, int, long long, long long, bool, bool, int,
-                          std::vector<long long> &, const DataSourceParams &, const AsyncParam &>(),
+                          std::vector<long long> &, const DataSourceParams &, const AsyncParam &,
+                          bool>(),
            pybind11::arg("data_reader_type"), pybind11::arg("source"),
            pybind11::arg("keyset") = std::vector<std::string>(), pybind11::arg("eval_source"),
            pybind11::arg("check_type"), pybind11::arg("cache_eval_data") = 0,
@@ -52,7 +54,8 @@ void ModelPybind(pybind11::module &m) {
            pybind11::arg("slot_size_array") = std::vector<long long>(),
            pybind11::arg("data_source_params") = new DataSourceParams(),
            pybind11::arg("async_param") =
-               AsyncParam{16, 4, 512000, 4, 512, false, Alignment_t::None, false, false});
+               AsyncParam{16, 4, 512000, 4, 512, false, Alignment_t::None, false, false},
+           pybind11::arg("parse_on_device") = false);
   pybind11::class_<HugeCTR::Input, std::shared_ptr<HugeCTR::Input>>(m, "Input")
       .def(pybind11::init<int, std::string, int, std::string,
                           std::vector<DataReaderSparseParam> &>(),
@@ -82,8 +85,9 @@ void ModelPybind(pybind11::module &m) {
                                     hybrid_embedding::CommunicationType::NVLink_SingleNode,
                                     hybrid_embedding::HybridEmbeddingType::Distributed});
   pybind11::class_<HugeCTR::DenseLayerComputeConfig>(m, "DenseLayerComputeConfig")
-      .def(pybind11::init<bool, bool>(), pybind11::arg("async_wgrad") = false,
-           pybind11::arg("fuse_wb") = false);
+      .def(pybind11::init<bool, bool, bool, bool>(), pybind11::arg("async_wgrad") = false,
+           pybind11::arg("fuse_wb") = false, pybind11::arg("enable_fp8") = false,
+           pybind11::arg("recompute") = false);
   pybind11::class_<HugeCTR::DenseLayer, std::shared_ptr<HugeCTR::DenseLayer>>(m, "DenseLayer")
       .def(pybind11::init<Layer_t, std::vector<std::string> &, std::vector<std::string> &, float,
                           float, Initializer_t, Initializer_t, float, float, size_t, Initializer_t,
@@ -93,7 +97,7 @@ void ModelPybind(pybind11::module &m) {
                           int, bool, std::vector<float> &, bool, Regularizer_t, float, FcPosition_t,
                           Activation_t, std::vector<size_t>, bool, std::vector<Activation_t>,
                           std::vector<bool>, DenseLayerComputeConfig, const std::vector<int64_t> &,
-                          int, const std::vector<int64_t> &>(),
+                          int, const std::vector<int64_t> &, bool>(),
            pybind11::arg("layer_type"), pybind11::arg("bottom_names"), pybind11::arg("top_names"),
            pybind11::arg("factor") = 1.0, pybind11::arg("eps") = 0.00001,
            pybind11::arg("gamma_init_type") = Initializer_t::Default,
@@ -123,7 +127,8 @@ void ModelPybind(pybind11::module &m) {
            pybind11::arg("biases") = std::vector<bool>(),
            pybind11::arg("compute_config") = DenseLayerComputeConfig(),
            pybind11::arg("shape") = std::vector<int64_t>(), pybind11::arg("dim") = 0,
-           pybind11::arg("index") = std::vector<int64_t>());
+           pybind11::arg("index") = std::vector<int64_t>(),
+           pybind11::arg("fused_attention") = false);
 
   pybind11::class_<HugeCTR::GroupDenseLayer, std::shared_ptr<HugeCTR::GroupDenseLayer>>(
       m, "GroupDenseLayer")
@@ -147,7 +152,8 @@ void ModelPybind(pybind11::module &m) {
       .def("fit", &HugeCTR::Model::fit, pybind11::arg("num_epochs") = 0,
            pybind11::arg("max_iter") = 2000, pybind11::arg("display") = 200,
            pybind11::arg("eval_interval") = 1000, pybind11::arg("snapshot") = 10000,
-           pybind11::arg("snapshot_prefix") = "")
+           pybind11::arg("snapshot_prefix") = "", pybind11::arg("profile_iterations") = 0,
+           pybind11::arg("profile_path") = "")
       .def("set_source",
            pybind11::overload_cast<std::vector<std::string>, std::vector<std::string>, std::string>(
                &HugeCTR::Model::set_source),
@@ -174,6 +180,7 @@ void ModelPybind(pybind11::module &m) {
       .def("unfreeze_dense", &HugeCTR::Model::unfreeze_dense)
       .def("load_dense_weights", &HugeCTR::Model::load_dense_weights,
            pybind11::arg("dense_model_file"))
+      .def("recover", &HugeCTR::Model::recover)
       .def("load_sparse_weights",
            pybind11::overload_cast<const std::vector<std::string> &>(
                &HugeCTR::Model::load_sparse_weights),
@@ -186,10 +193,13 @@ void ModelPybind(pybind11::module &m) {
            pybind11::overload_cast<const std::string &, const std::vector<std::string> &>(
                &HugeCTR::Model::embedding_load),
            pybind11::arg("path"), pybind11::arg("table_names") = std::vector<std::string>())
-      .def("embedding_dump",
-           pybind11::overload_cast<const std::string &, const std::vector<std::string> &>(
-               &HugeCTR::Model::embedding_dump),
-           pybind11::arg("path"), pybind11::arg("table_names") = std::vector<std::string>())
+      .def("embedding_dump", &HugeCTR::Model::embedding_dump, pybind11::arg("path"),
+           pybind11::arg("table_names") = std::vector<std::string>(),
+           pybind11::arg("incremental") = false)
+      .def("embedding_export", &HugeCTR::Model::embedding_export, pybind11::arg("path"),
+           pybind11::arg("table_names") = std::vector<std::string>(),
+           pybind11::arg("min_update_count") = 0, pybind11::arg("min_l2_norm") = 0.f,
+           pybind11::arg("fp8_quant") = false)
       .def("load_dense_optimizer_states", &HugeCTR::Model::load_dense_optimizer_states,
            pybind11::arg("dense_opt_states_file"))
       .def("load_sparse_optimizer_states",
@@ -220,6 +230,8 @@ void ModelPybind(pybind11::module &m) {
              return loss;
            })
       .def("get_eval_metrics", &HugeCTR::Model::get_eval_metrics)
+      .def("predict", &HugeCTR::Model::predict, pybind11::arg("output_prefix"),
+           pybind11::arg("max_batches") = 0)
       .def("get_incremental_model",
            [](HugeCTR::Model &self) {
              auto inc_sparse_model = self.get_incremental_model();
@@ -27,7 +27,8 @@ namespace python_lib {
 std::shared_ptr<OptParamsPy> CreateOptimizer(Optimizer_t optimizer_type, Update_t update_type,
                                              float beta, float lambda1, float lambda2, float beta1,
                                              float beta2, float epsilon, float initial_accu_value,
-                                             float momentum_factor, bool atomic_update) {
+                                             float momentum_factor, bool atomic_update,
+                                             bool fused_update) {
   std::shared_ptr<OptParamsPy> opt_params;
   OptHyperParams opt_hyper_params;
   opt_hyper_params.ftrl.beta = beta;
@@ -42,6 +43,7 @@ std::shared_ptr<OptParamsPy> CreateOptimizer(Optimizer_t optimizer_type, Update_
   opt_hyper_params.nesterov.mu = momentum_factor;
   opt_hyper_params.sgd.atomic_update = atomic_update;
   opt_params.reset(new OptParamsPy(optimizer_type, update_type, opt_hyper_params));
+  opt_params->fused_update = fused_update;
   return opt_params;
 }
 
@@ -53,7 +55,8 @@ void OptimizerPybind(pybind11::module& m) {
         pybind11::arg("lambda1") = 0.f, pybind11::arg("lambda2") = 0.f,
         pybind11::arg("beta1") = 0.9, pybind11::arg("beta2") = 0.999,
         pybind11::arg("epsilon") = 0.0000001, pybind11::arg("initial_accu_value") = 0.f,
-        pybind11::arg("momentum_factor") = 0.0, pybind11::arg("atomic_update") = true);
+        pybind11::arg("momentum_factor") = 0.0, pybind11::arg("atomic_update") = true,
+        pybind11::arg("fused_update") = false);
 }
 
 }  // namespace python_lib
@@ -28,15 +28,21 @@ namespace python_lib {
 std::unique_ptr<Solver> CreateSolver(
     const std::string& model_name, unsigned long long seed, LrPolicy_t lr_policy, float lr,
     size_t warmup_steps, size_t decay_start, size_t decay_steps, float decay_power, float end_lr,
-    int max_eval_batches, int batchsize_eval, int batchsize,
+    float decay_rate, int max_eval_batches, float eval_auc_tolerance, int eval_top_k,
+    int eval_candidates_per_query, int batchsize_eval, int batchsize,
     const std::vector<std::vector<int>>& vvgpu, bool repeat_dataset, bool use_mixed_precision,
-    bool enable_tf32_compute, float scaler, std::map<metrics::Type, float> metrics_spec,
-    bool i64_input_key, bool use_algorithm_search, bool use_cuda_graph, bool gen_loss_summary,
-    bool train_intra_iteration_overlap, bool train_inter_iteration_overlap,
-    bool eval_intra_iteration_overlap, bool eval_inter_iteration_overlap,
-    DeviceMap::Layout device_layout, bool use_embedding_collection, AllReduceAlgo all_reduce_algo,
-    bool grouped_all_reduce, size_t num_iterations_statistics, bool perf_logging,
-    bool drop_incomplete_batch, std::string& kafka_brokers,
+    bool enable_tf32_compute, float scaler,
+    std::map<metrics::Type, float> metrics_spec, bool i64_input_key, bool use_algorithm_search,
+    bool use_cuda_graph, bool gen_loss_summary, bool train_intra_iteration_overlap,
+    bool train_inter_iteration_overlap, bool eval_intra_iteration_overlap,
+    bool eval_inter_iteration_overlap, bool train_embedding_lookahead,
+    DeviceMap::Layout device_layout, bool use_embedding_collection,
+    bool gpu_learning_rate_scheduling, AllReduceAlgo all_reduce_algo, bool grouped_all_reduce,
+    size_t num_iterations_statistics, bool perf_logging, bool drop_incomplete_batch,
+    bool fuse_dense_layers, float allreduce_bucket_size_mb, bool async_checkpoint,
+    const std::string& algorithm_search_cache, bool broadcast_algorithm_search,
+    bool shard_dense_optimizer, bool share_eval_activations, std::string& kafka_brokers,
+    const std::string& kafka_compression_codec, const std::string& kafka_value_precision,
     const std::vector<std::shared_ptr<TrainingCallback>>& training_callbacks) {
   if (use_mixed_precision && enable_tf32_compute) {
     HCTR_OWN_THROW(Error_t::WrongInput,
@@ -47,6 +53,19 @@ std::unique_ptr<Solver> CreateSolver(
                    "Scaler of mixed precision training should be either 128/256/512/1024");
   }*/
 
+  HCTR_CHECK_HINT(eval_auc_tolerance >= 0.f, "eval_auc_tolerance must not be negative");
+  HCTR_CHECK_HINT(eval_top_k > 0, "eval_top_k must be positive");
+  HCTR_CHECK_HINT(eval_candidates_per_query >= 0, "eval_candidates_per_query must not be negative");
+  if (shard_dense_optimizer && (grouped_all_reduce || allreduce_bucket_size_mb > 0.f)) {
+    HCTR_OWN_THROW(Error_t::WrongInput,
+                   "shard_dense_optimizer cannot be used with grouped_all_reduce or "
+                   "allreduce_bucket_size_mb");
+  }
+  if (shard_dense_optimizer && async_checkpoint) {
+    HCTR_OWN_THROW(Error_t::WrongInput,
+                   "shard_dense_optimizer and async_checkpoint cannot be true at the same time");
+  }
+
   std::unique_ptr<Solver> solver(new Solver());
   solver->model_name = model_name;
   solver->seed = seed;
@@ -57,7 +76,11 @@ std::unique_ptr<Solver> CreateSolver(
   solver->decay_steps = decay_steps;
   solver->decay_power = decay_power;
   solver->end_lr = end_lr;
+  solver->decay_rate = decay_rate;
   solver->max_eval_batches = max_eval_batches;
+  solver->eval_auc_tolerance = eval_auc_tolerance;
+  solver->eval_top_k = eval_top_k;
+  solver->eval_candidates_per_query = eval_candidates_per_query;
   solver->batchsize_eval = batchsize_eval;
   solver->batchsize = batchsize;
   solver->vvgpu.assign(vvgpu.begin(), vvgpu.end());
@@ -74,14 +97,25 @@ std::unique_ptr<Solver> CreateSolver(
   solver->train_inter_iteration_overlap = train_inter_iteration_overlap;
   solver->eval_intra_iteration_overlap = eval_intra_iteration_overlap;
   solver->eval_inter_iteration_overlap = eval_inter_iteration_overlap;
+  solver->train_embedding_lookahead = train_embedding_lookahead;
   solver->device_layout = device_layout;
   solver->use_embedding_collection = use_embedding_collection;
+  solver->gpu_learning_rate_scheduling = gpu_learning_rate_scheduling;
   solver->all_reduce_algo = all_reduce_algo;
   solver->grouped_all_reduce = grouped_all_reduce;
   solver->num_iterations_statistics = num_iterations_statistics;
   solver->perf_logging = perf_logging;
   solver->drop_incomplete_batch = drop_incomplete_batch;
+  solver->fuse_dense_layers = fuse_dense_layers;
+  solver->allreduce_bucket_size_mb = allreduce_bucket_size_mb;
+  solver->async_checkpoint = async_checkpoint;
+  solver->algorithm_search_cache = algorithm_search_cache;
+  solver->broadcast_algorithm_search = broadcast_algorithm_search;
+  solver->shard_dense_optimizer = shard_dense_optimizer;
+  solver->share_eval_activations = share_eval_activations;
   solver->kafka_brokers = kafka_brokers;
+  solver->kafka_compression_codec = kafka_compression_codec;
+  solver->kafka_value_precision = kafka_value_precision;
   solver->training_callbacks = training_callbacks;
   return solver;
 }
@@ -98,7 +132,11 @@ void SolverPybind(pybind11::module& m) {
       .def_readonly("decay_steps", &HugeCTR::Solver::decay_steps)
       .def_readonly("decay_power", &HugeCTR::Solver::decay_power)
       .def_readonly("end_lr", &HugeCTR::Solver::end_lr)
+      .def_readonly("decay_rate", &HugeCTR::Solver::decay_rate)
       .def_readonly("max_eval_batches", &HugeCTR::Solver::max_eval_batches)
+      .def_readonly("eval_auc_tolerance", &HugeCTR::Solver::eval_auc_tolerance)
+      .def_readonly("eval_top_k", &HugeCTR::Solver::eval_top_k)
+      .def_readonly("eval_candidates_per_query", &HugeCTR::Solver::eval_candidates_per_query)
       .def_readonly("batchsize_eval", &HugeCTR::Solver::batchsize_eval)
       .def_readonly("batchsize", &HugeCTR::Solver::batchsize)
       .def_readonly("vvgpu", &HugeCTR::Solver::vvgpu)
@@ -117,19 +155,31 @@ void SolverPybind(pybind11::module& m) {
                     &HugeCTR::Solver::train_inter_iteration_overlap)
       .def_readonly("eval_intra_iteration_overlap", &HugeCTR::Solver::eval_intra_iteration_overlap)
       .def_readonly("eval_inter_iteration_overlap", &HugeCTR::Solver::eval_inter_iteration_overlap)
+      .def_readonly("train_embedding_lookahead", &HugeCTR::Solver::train_embedding_lookahead)
       .def_readonly("device_layout", &HugeCTR::Solver::device_layout)
+      .def_readonly("gpu_learning_rate_scheduling", &HugeCTR::Solver::gpu_learning_rate_scheduling)
       .def_readonly("all_reduce_algo", &HugeCTR::Solver::all_reduce_algo)
       .def_readonly("grouped_all_reduce", &HugeCTR::Solver::grouped_all_reduce)
       .def_readonly("num_iterations_statistics", &HugeCTR::Solver::num_iterations_statistics)
       .def_readonly("perf_logging", &HugeCTR::Solver::perf_logging)
       .def_readonly("drop_incomplete_batch", &HugeCTR::Solver::drop_incomplete_batch)
+      .def_readonly("fuse_dense_layers", &HugeCTR::Solver::fuse_dense_layers)
+      .def_readonly("allreduce_bucket_size_mb", &HugeCTR::Solver::allreduce_bucket_size_mb)
+      .def_readonly("async_checkpoint", &HugeCTR::Solver::async_checkpoint)
+      .def_readonly("algorithm_search_cache", &HugeCTR::Solver::algorithm_search_cache)
+      .def_readonly("broadcast_algorithm_search", &HugeCTR::Solver::broadcast_algorithm_search)
+      .def_readonly("shard_dense_optimizer", &HugeCTR::Solver::shard_dense_optimizer)
+      .def_readonly("share_eval_activations", &HugeCTR::Solver::share_eval_activations)
       .def_readonly("training_callbacks", &HugeCTR::Solver::training_callbacks);
   m.def("CreateSolver", &HugeCTR::python_lib::CreateSolver, pybind11::arg("model_name") = "",
         pybind11::arg("seed") = 0, pybind11::arg("lr_policy") = LrPolicy_t::fixed,
         pybind11::arg("lr") = 0.001, pybind11::arg("warmup_steps") = 1,
         pybind11::arg("decay_start") = 0, pybind11::arg("decay_steps") = 1,
         pybind11::arg("decay_power") = 2.f, pybind11::arg("end_lr") = 0.f,
-        pybind11::arg("max_eval_batches") = 100, pybind11::arg("batchsize_eval") = 2048,
+        pybind11::arg("decay_rate") = 0.1f,
+        pybind11::arg("max_eval_batches") = 100, pybind11::arg("eval_auc_tolerance") = 0.f,
+        pybind11::arg("eval_top_k") = 10, pybind11::arg("eval_candidates_per_query") = 0,
+        pybind11::arg("batchsize_eval") = 2048,
         pybind11::arg("batchsize") = 2048,
         pybind11::arg("vvgpu") = std::vector<std::vector<int>>(1, std::vector<int>(1, 0)),
         pybind11::arg("repeat_dataset") = true, pybind11::arg("use_mixed_precision") = false,
@@ -141,12 +191,21 @@ void SolverPybind(pybind11::module& m) {
         pybind11::arg("train_inter_iteration_overlap") = false,
         pybind11::arg("eval_intra_iteration_overlap") = false,
         pybind11::arg("eval_inter_iteration_overlap") = false,
+        pybind11::arg("train_embedding_lookahead") = false,
         pybind11::arg("device_layout") = DeviceMap::Layout::LOCAL_FIRST,
         pybind11::arg("use_embedding_collection") = false,
+        pybind11::arg("gpu_learning_rate_scheduling") = false,
         pybind11::arg("all_reduce_algo") = AllReduceAlgo::NCCL,
         pybind11::arg("grouped_all_reduce") = false,
         pybind11::arg("num_iterations_statistics") = 20, pybind11::arg("perf_logging") = false,
-        pybind11::arg("drop_incomplete_batch") = true, pybind11::arg("kafka_brokers") = "",
+        pybind11::arg("drop_incomplete_batch") = true, pybind11::arg("fuse_dense_layers") = false,
+        pybind11::arg("allreduce_bucket_size_mb") = 0.f, pybind11::arg("async_checkpoint") = false,
+        pybind11::arg("algorithm_search_cache") = "",
+        pybind11::arg("broadcast_algorithm_search") = false,
+        pybind11::arg("shard_dense_optimizer") = false,
+        pybind11::arg("share_eval_activations") = false,
+        pybind11::arg("kafka_brokers") = "", pybind11::arg("kafka_compression_codec") = "none",
+        pybind11::arg("kafka_value_precision") = "fp32",
         pybind11::arg("training_callbacks") = std::vector<std::shared_ptr<TrainingCallback>>());
 }
 
@@ -25,6 +25,19 @@
 
 namespace HugeCTR {
 
+/**
+ * The gradient of an L1 or L2 regularization term with respect to a weight, l1 * sign(w) + l2 * w,
+ * which the dense optimizers add to the wgrads in their update kernels.
+ */
+struct RegularizationGrad {
+  float l1 = 0.f;
+  float l2 = 0.f;
+
+  __host__ __device__ __forceinline__ float operator()(float weight) const {
+    return l2 * weight + (weight > 0.f ? l1 : -l1);
+  }
+};
+
 /**
  * @brief Abstract base class of Regularizer
  */
@@ -68,6 +81,21 @@ class Regularizer {
    */
   float get_rterm() const { return h_rterm_; }
 
+  /*
+   * Leaves the gradient of the regularization term to the optimizer, which adds it where it reads
+   * the weights anyway. initialize_wgrad() then only zeroes the wgrads and compute_rterm() yields
+   * zero, the term is only computed by compute_deferred_rterm() when the loss is read.
+   * @param num_replicas the number of GPUs whose wgrads are summed up before the update
+   * @return the gradient to add to the summed up wgrads
+   */
+  RegularizationGrad fuse_into_optimizer(int num_replicas);
+
+  /*
+   * Computes the regularization term of the current weights if it was left out of compute_rterm()
+   * by fuse_into_optimizer(), zero otherwise
+   */
+  float compute_deferred_rterm();
+
  protected:
   int get_batch_size() const { return batch_size_; }
   int get_device_id() const { return gpu_resource_->get_device_id(); }
@@ -93,11 +121,16 @@ class Regularizer {
    */
   virtual void do_initialize_wgrad(const float* weight, T* wgrad, int num_elements,
                                    cudaStream_t stream) = 0;
+  /*
+   * The gradient that do_initialize_wgrad writes, for the optimizer to add it instead
+   */
+  virtual RegularizationGrad do_get_grad() const = 0;
 
   std::optional<WeightTensors> weight_tensors_;
   std::optional<WgradTensors<T>> wgrad_tensors_;
   int batch_size_;
   float h_rterm_;
+  bool fused_ = false;
   std::shared_ptr<GPUResource> gpu_resource_;
 };
 
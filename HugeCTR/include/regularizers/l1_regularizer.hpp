@@ -63,6 +63,10 @@ class L1Regularizer : public Regularizer<T> {
    */
   void do_initialize_wgrad(const float* weight, T* wgrad, int num_elements,
                            cudaStream_t stream) override;
+  /*
+   * The gradient is sign(weight) * (lambda / batch_size)
+   */
+  RegularizationGrad do_get_grad() const override;
 
   const float lambda_;
 };
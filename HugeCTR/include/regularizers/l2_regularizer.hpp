@@ -65,6 +65,10 @@ class L2Regularizer : public Regularizer<T> {
    */
   void do_initialize_wgrad(const float* weight, T* wgrad, int num_elements,
                            cudaStream_t stream) override;
+  /*
+   * The gradient is weight * (lambda / batch_size)
+   */
+  RegularizationGrad do_get_grad() const override;
 
   const float lambda_;
 };
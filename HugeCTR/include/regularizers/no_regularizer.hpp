@@ -63,6 +63,10 @@ class NoRegularizer : public Regularizer<T> {
    */
   void do_initialize_wgrad(const float* weight, T* wgrad, int num_elements,
                            cudaStream_t stream) override;
+  /*
+   * The gradient is zero
+   */
+  RegularizationGrad do_get_grad() const override;
 };
 
 }  // namespace HugeCTR
@@ -21,6 +21,7 @@
 #include <device_map.hpp>
 #include <gpu_resource.hpp>
 #include <resource_manager_base.hpp>
+#include <resource_managers/gpu_topology.hpp>
 #include <rmm/mr/device/device_memory_resource.hpp>
 
 namespace HugeCTR {
@@ -44,6 +45,11 @@ class ResourceManager : public ResourceManagerBase {
   virtual int get_process_id_from_gpu_global_id(size_t global_gpu_id) const = 0;
   virtual bool p2p_enabled(int src_dev, int dst_dev) const = 0;
   virtual bool all_p2p_enabled() const = 0;
+  // How the local GPUs are connected, indexed by local GPU id.
+  virtual const GpuTopology& get_gpu_topology() const = 0;
+  // Aborts the NCCL communicators of the local GPUs and creates new ones. Collective over all
+  // the processes, e.g., after a collective failed or timed out.
+  virtual void recreate_nccl_comms() = 0;
 
   virtual DeviceMap::Layout get_device_layout() const = 0;
 
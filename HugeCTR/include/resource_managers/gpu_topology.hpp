@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * @brief How two GPUs of a node are connected, from the fastest to the slowest.
+ */
+enum class GpuLinkType {
+  Self,
+  NVLink,          // Direct NVLinks, or NVLinks to the same NVSwitch partition
+  PCIeSwitch,      // Through one or more PCIe switches
+  PCIeHostBridge,  // Through a PCIe host bridge
+  CPU,             // Through the interconnect of the PCIe host bridges of a CPU
+  CrossSocket      // Through the interconnect between CPU sockets, e.g., QPI or UPI
+};
+
+/**
+ * @brief Interconnect of the local GPUs, discovered with NVML, and a cost model on top of it.
+ *
+ * The matrices are indexed by local GPU id. cost is the approximate time in seconds to move 1 GB
+ * between two GPUs, i.e., the inverse of the bandwidth of their link. It only tells the links
+ * apart, e.g., an NVLink pair from a pair on a partitioned NVSwitch or on PCIe, and is not a
+ * measurement.
+ */
+struct GpuTopology {
+  std::vector<int> device_list;
+  std::vector<std::vector<GpuLinkType>> link_type;
+  std::vector<std::vector<int>> nvlink_count;  // NVLinks between two GPUs, or to their NVSwitch
+  std::vector<std::vector<double>> cost;
+
+  /**
+   * @brief Discovers how the GPUs are connected.
+   *
+   * @param device_list CUDA device ids of the local GPUs.
+   */
+  static GpuTopology discover(const std::vector<int>& device_list);
+
+  /**
+   * @return A human readable matrix of the links.
+   */
+  std::string report() const;
+};
+
+/**
+ * @brief Approximate seconds per GB over a link, see GpuTopology.
+ */
+double gpu_link_cost(GpuLinkType link_type, int nvlink_count);
+
+}  // namespace HugeCTR
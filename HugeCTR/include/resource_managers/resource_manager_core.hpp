@@ -32,11 +32,13 @@ class ResourceManagerCore : public ResourceManager {
   std::shared_ptr<CPUResource> cpu_resource_;
   std::vector<std::shared_ptr<GPUResource>> gpu_resources_; /**< GPU resource vector */
   std::vector<std::vector<bool>> p2p_matrix_;
+  GpuTopology gpu_topology_;
 
   std::vector<std::shared_ptr<rmm::mr::device_memory_resource>> base_cuda_mr_;
   std::vector<std::shared_ptr<rmm::mr::device_memory_resource>> memory_resource_;
   std::vector<rmm::mr::device_memory_resource*> original_device_resource_;
 
+  std::vector<ncclComm_t> create_nccl_comms();
   void all2all_warmup();
   void enable_all_peer_accesses();
   void initialize_rmm_resources();
@@ -106,6 +108,8 @@ class ResourceManagerCore : public ResourceManager {
 
   bool p2p_enabled(int src_dev, int dst_dev) const override;
   bool all_p2p_enabled() const override;
+  const GpuTopology& get_gpu_topology() const override { return gpu_topology_; }
+  void recreate_nccl_comms() override;
 
   DeviceMap::Layout get_device_layout() const override { return device_map_.get_device_layout(); }
 
@@ -91,6 +91,8 @@ class ResourceManagerExt : public ResourceManager {
     return core_->p2p_enabled(src_dev, dst_dev);
   }
   bool all_p2p_enabled() const override { return core_->all_p2p_enabled(); }
+  const GpuTopology& get_gpu_topology() const override { return core_->get_gpu_topology(); }
+  void recreate_nccl_comms() override { core_->recreate_nccl_comms(); }
 
   DeviceMap::Layout get_device_layout() const override { return core_->get_device_layout(); }
 
@@ -61,6 +61,8 @@ class SchedulableEmbeding : public IEmbedding {
   virtual void global_barrier(bool is_train, int i) = 0;
   virtual void infreq_network_backward(int i) = 0;
   virtual void infreq_model_backward(int i) = 0;
+  // Called between two training iterations, when no work of the embedding is in flight
+  virtual void recalibrate_if_due() = 0;
 };
 
 }  // namespace HugeCTR
\ No newline at end of file
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_runtime.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <resource_manager.hpp>
+#include <string>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Times the parts of the training iterations, i.e., the fprop and bprop of every dense layer, the
+ * embedding stages, the communication and the optimizer updates, with CUDA events on the streams
+ * they run on. From the FLOPs and bytes the parts declare, it reports the achieved throughputs
+ * against the peaks of the GPU and whether each part is memory- or compute-bound.
+ *
+ * A part that overlaps with the parts on other streams is charged for the time they share.
+ */
+class StepProfiler {
+ public:
+  enum class Kind { Layer, Embedding, Communication, Optimizer };
+
+  /**
+   * @param num_iterations The number of iterations to time.
+   * @param use_mixed_precision Whether the peak FLOP/s are those of the FP16 Tensor Cores rather
+   * than of FP32.
+   * @param peak_tflops The peak FLOP/s in TFLOP/s, derived from the GPU if 0.
+   * @param peak_gbps The peak memory bandwidth in GB/s, derived from the GPU if 0.
+   */
+  StepProfiler(const std::shared_ptr<ResourceManager>& resource_manager, int num_iterations,
+               bool use_mixed_precision, double peak_tflops = 0.0, double peak_gbps = 0.0);
+  ~StepProfiler();
+
+  StepProfiler(const StepProfiler&) = delete;
+  StepProfiler& operator=(const StepProfiler&) = delete;
+
+  /** Whether iterations are left to time. */
+  bool active() const { return num_timed_iterations_ < num_iterations_; }
+
+  /**
+   * Runs `work`, timing what it enqueues on the current stream of the local GPU. Can be called
+   * from the threads of different local GPUs at once.
+   */
+  void time(size_t local_gpu_id, const std::string& name, Kind kind,
+            const std::function<void()>& work, double flops = 0.0, double bytes = 0.0);
+
+  /** Waits for the timed work of the iteration and accumulates it. */
+  void end_iteration();
+
+  /** The parts ranked by their time, as a table. */
+  std::string report() const;
+
+  /** Writes the report as JSON. */
+  void write_json(const std::string& path) const;
+
+ private:
+  struct Timing {
+    std::string name;
+    Kind kind;
+    double flops;
+    double bytes;
+    cudaEvent_t start;
+    cudaEvent_t stop;
+  };
+
+  struct Part {
+    Kind kind;
+    size_t num_calls = 0;
+    double milliseconds = 0.0;
+    double flops = 0.0;
+    double bytes = 0.0;
+  };
+
+  // A row of the report, averaged over the iterations and the local GPUs.
+  struct Row {
+    std::string name;
+    Kind kind;
+    double milliseconds;  // Per iteration
+    double flops;         // Per iteration
+    double bytes;         // Per iteration
+    double tflops;
+    double gbps;
+    const char* bound;
+    double peak_fraction;  // Of the resource it is bound by
+  };
+
+  cudaEvent_t next_event(size_t local_gpu_id);
+  std::vector<Row> rows() const;
+
+  std::shared_ptr<ResourceManager> resource_manager_;
+  int num_iterations_;
+  int num_timed_iterations_ = 0;
+  double peak_flops_;
+  double peak_bytes_per_second_;
+
+  // Per local GPU
+  std::vector<std::vector<cudaEvent_t>> events_;
+  std::vector<size_t> num_used_events_;
+  std::vector<std::vector<Timing>> timings_;
+  std::vector<std::map<std::string, Part>> parts_;
+};
+
+}  // namespace HugeCTR
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <core/macro.hpp>
 #include <deque>
@@ -29,6 +30,21 @@
 
 namespace HugeCTR {
 
+// The queued tasks of higher priority run first
+enum class TaskPriority { Dump = 0, Refresh = 1, Lookup = 2 };
+
+/**
+ * A pool either owns num_workers threads, or is a share of the process-wide workers that runs at
+ * most max_concurrency of its tasks at a time, in submission order, with its priority.
+ *
+ * The process-wide workers, HCTR_DEFAULT_CONCURRENCY or one per usable CPU, are spread over the
+ * NUMA nodes, and each node has a queue per priority. A task is queued on the node of the
+ * submitting thread, and an idle worker takes the task of highest priority of its node, else steals
+ * one from the other nodes. HCTR_THREAD_AFFINITY pins the workers: "numa" (default) to the CPUs of
+ * their node, "core" to one CPU each, "none" not at all.
+ * A worker that waits for tasks with await() or await_idle() runs queued tasks meanwhile, so that
+ * the tasks may wait for tasks of other shares.
+ */
 class ThreadPool final {
  public:
   HCTR_DISALLOW_COPY_AND_MOVE(ThreadPool);
@@ -37,11 +53,16 @@ class ThreadPool final {
 
   ThreadPool(const std::string& name, size_t num_workers);
 
+  // A share of the process-wide workers, max_concurrency 0 for all of them
+  ThreadPool(const std::string& name, TaskPriority priority, size_t max_concurrency = 0);
+
   virtual ~ThreadPool();
 
   inline const std::string& name() const { return name_; }
 
-  inline size_t size() const { return workers_.size(); }
+  inline size_t size() const { return shared_ ? max_concurrency_ : workers_.size(); }
+
+  inline bool shared() const { return shared_; }
 
   bool idle() const;
 
@@ -49,19 +70,31 @@ class ThreadPool final {
 
   std::future<void> submit(std::function<void()> task);
 
+  // The default share, of all the process-wide workers
   static ThreadPool& get();
 
   template <typename Iterator>
   inline static void await(Iterator first, const Iterator& last) {
     for (; first != last; first++) {
+      help_while([&first]() {
+        return first->wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+      });
       first->get();
     }
   }
 
+  // On a process-wide worker, runs queued tasks as long as pending() holds, else returns
+  static void help_while(const std::function<bool()>& pending);
+
  private:
   const std::string name_;
   std::vector<std::thread> workers_;
 
+  const bool shared_ = false;
+  const TaskPriority priority_ = TaskPriority::Refresh;
+  const size_t max_concurrency_ = 0;
+  size_t num_running_ = 0;  // tasks of a share handed to the process-wide workers
+
   mutable std::mutex barrier_;  // Must be obtained to ensure exclusive access.
   mutable std::condition_variable
       submit_sempahore_;  // Triggered on submission. Workers wait for this.
@@ -73,6 +106,10 @@ class ThreadPool final {
       packages_;  // Work packages that have not been processed yet.
 
   void run_(const size_t thread_index);
+
+  // Hands a task of a share to the process-wide workers
+  void dispatch_(std::packaged_task<void()> package);
+  void finished_();
 };
 
 }  // namespace HugeCTR
\ No newline at end of file
@@ -156,6 +156,33 @@ class TrainableLayer : public Layer {
   std::vector<core23::Tensor> get_master_weights() { return master_weights_; };
   std::vector<core23::Tensor> get_weights() { return weights_; };
   std::vector<core23::Tensor> get_wgrads() { return wgrads_; };
+
+  /**
+   * Every weight is assumed to take part in a multiply-add per row of the first input, as in a
+   * GEMM, and the bprop computes both the data and the weight gradients.
+   */
+  double get_flops(bool fprop) const override {
+    if (input_tensors_.empty() || input_tensors_[0].empty()) {
+      return 0.0;
+    }
+    const core23::Tensor& input = input_tensors_[0];
+    const double rows =
+        static_cast<double>(input.num_elements()) / input.shape().size(input.dims() - 1);
+    double num_weights = 0.0;
+    for (const core23::Tensor& weight : weights_) {
+      num_weights += weight.num_elements();
+    }
+    return (fprop ? 2.0 : 4.0) * rows * num_weights;
+  }
+
+  double get_bytes(bool fprop) const override {
+    double weight_bytes = 0.0;
+    for (const core23::Tensor& weight : weights_) {
+      weight_bytes += weight.num_bytes();
+    }
+    // The bprop reads the weights and writes the wgrads.
+    return Layer::get_bytes(fprop) + (fprop ? 1.0 : 2.0) * weight_bytes;
+  }
 };
 
 template <typename DType, bool use_FP32_weight>
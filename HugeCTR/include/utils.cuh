@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <cuda_bf16.h>
 #include <cuda_fp16.h>
 #include <cuda_runtime.h>
 
@@ -85,6 +86,14 @@ struct TypeFunc<__half> {
   static __forceinline__ __device__ __half add(__half a, __half b) { return __hadd(a, b); }
 };
 
+template <>
+struct TypeFunc<__nv_bfloat16> {
+  static __forceinline__ __device__ __nv_bfloat16 zero() { return __float2bfloat16(0.0f); }
+  static __forceinline__ __device__ __nv_bfloat16 add(__nv_bfloat16 a, __nv_bfloat16 b) {
+    return __float2bfloat16(__bfloat162float(a) + __bfloat162float(b));
+  }
+};
+
 template <>
 struct TypeFunc<__half2> {
   static __forceinline__ __device__ __half2 zero() { return __float2half2_rn(0.0f); }
@@ -104,6 +113,20 @@ struct TypeConvertFunc<float, __half> {
   static __forceinline__ __device__ float convert(__half val) { return __half2float(val); }
 };
 
+template <>
+struct TypeConvertFunc<__nv_bfloat16, float> {
+  static __forceinline__ __device__ __nv_bfloat16 convert(float val) {
+    return __float2bfloat16(val);
+  }
+};
+
+template <>
+struct TypeConvertFunc<float, __nv_bfloat16> {
+  static __forceinline__ __device__ float convert(__nv_bfloat16 val) {
+    return __bfloat162float(val);
+  }
+};
+
 template <>
 struct TypeConvertFunc<float, float> {
   static __forceinline__ __device__ float convert(float val) { return val; }
@@ -14,12 +14,37 @@
  * limitations under the License.
  */
 
+#include <omp.h>
+
+#include <algorithm>
 #include <collectives/all_reduce_comm.hpp>
 #include <collectives/ib_comm.hpp>
+#include <limits>
 #include <utils.hpp>
 
 namespace HugeCTR {
 
+namespace {
+
+bool all_peers_accessible(const std::vector<std::shared_ptr<GPUResource>>& gpu_resources) {
+  for (auto& src : gpu_resources) {
+    for (auto& dst : gpu_resources) {
+      if (src == dst) {
+        continue;
+      }
+      int can_access = 0;
+      HCTR_LIB_THROW(
+          cudaDeviceCanAccessPeer(&can_access, src->get_device_id(), dst->get_device_id()));
+      if (!can_access) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 std::shared_ptr<AllReduceInPlaceComm> AllReduceInPlaceComm::create_nccl(
     size_t num_process, bool use_mixed_precision,
     const std::vector<std::shared_ptr<GPUResource>>& gpu_resources) {
@@ -62,9 +87,46 @@ std::shared_ptr<AllReduceInPlaceComm> AllReduceInPlaceComm::create_oneshot(
   }
 }
 
+std::shared_ptr<AllReduceInPlaceComm> AllReduceInPlaceComm::create_auto(
+    size_t num_process, bool use_mixed_precision,
+    const std::vector<std::shared_ptr<GPUResource>>& gpu_resources, IbComm* ib_comm) {
+  const size_t num_gpus = gpu_resources.size();
+  std::vector<AutoARInplaceComm::Backend> backends;
+  backends.push_back({"NCCL", create_nccl(num_process, use_mixed_precision, gpu_resources)});
+  if (num_process == 1) {
+    if (num_gpus > 1 && all_peers_accessible(gpu_resources)) {
+      backends.push_back({"OneShot",
+                          create_oneshot(num_process, use_mixed_precision, gpu_resources, ib_comm),
+                          16 * num_gpus});
+    }
+    return std::make_shared<AutoARInplaceComm>(std::move(backends), gpu_resources);
+  }
+  // The OneShot multi-node all-reduce relies on SHARP, which RoCE fabrics lack
+  if (ib_comm && ib_comm->is_infiniBand_device()) {
+    backends.push_back({"OneShot",
+                        create_oneshot(num_process, use_mixed_precision, gpu_resources, ib_comm),
+                        16 * num_gpus});
+  }
+  if (num_gpus > 1) {
+    if (use_mixed_precision) {
+      backends.push_back(
+          {"NCCL two-level",
+           std::make_shared<NCCLTwoLevelARInplaceComm<__half>>(num_process, gpu_resources)});
+    } else {
+      backends.push_back(
+          {"NCCL two-level",
+           std::make_shared<NCCLTwoLevelARInplaceComm<float>>(num_process, gpu_resources)});
+    }
+  }
+  return std::make_shared<AutoARInplaceComm>(std::move(backends), gpu_resources);
+}
+
 std::shared_ptr<AllReduceInPlaceComm> AllReduceInPlaceComm::create(
     size_t num_process, AllReduceAlgo algo, bool use_mixed_precision,
     const std::vector<std::shared_ptr<GPUResource>>& gpu_resources, IbComm* ib_comm) {
+  if (algo == AllReduceAlgo::AUTO) {
+    return create_auto(num_process, use_mixed_precision, gpu_resources, ib_comm);
+  }
   return (algo == AllReduceAlgo::ONESHOT)
              ? create_oneshot(num_process, use_mixed_precision, gpu_resources, ib_comm)
              : create_nccl(num_process, use_mixed_precision, gpu_resources);
@@ -72,9 +134,24 @@ std::shared_ptr<AllReduceInPlaceComm> AllReduceInPlaceComm::create(
 
 #else
 
+std::shared_ptr<AllReduceInPlaceComm> AllReduceInPlaceComm::create_auto(
+    size_t num_process, bool use_mixed_precision,
+    const std::vector<std::shared_ptr<GPUResource>>& gpu_resources) {
+  std::vector<AutoARInplaceComm::Backend> backends;
+  backends.push_back({"NCCL", create_nccl(num_process, use_mixed_precision, gpu_resources)});
+  if (num_process == 1 && gpu_resources.size() > 1 && all_peers_accessible(gpu_resources)) {
+    backends.push_back({"OneShot", create_oneshot(num_process, use_mixed_precision, gpu_resources),
+                        16 * gpu_resources.size()});
+  }
+  return std::make_shared<AutoARInplaceComm>(std::move(backends), gpu_resources);
+}
+
 std::shared_ptr<AllReduceInPlaceComm> AllReduceInPlaceComm::create(
     size_t num_process, AllReduceAlgo algo, bool use_mixed_precision,
     const std::vector<std::shared_ptr<GPUResource>>& gpu_resources) {
+  if (algo == AllReduceAlgo::AUTO) {
+    return create_auto(num_process, use_mixed_precision, gpu_resources);
+  }
   return (algo == AllReduceAlgo::ONESHOT)
              ? create_oneshot(num_process, use_mixed_precision, gpu_resources)
              : create_nccl(num_process, use_mixed_precision, gpu_resources);
@@ -425,4 +502,210 @@ void NCCLARInplaceComm<T>::all_reduce(AllReduceInPlaceComm::Handle coll, cudaStr
 template class NCCLARInplaceComm<__half>;
 template class NCCLARInplaceComm<float>;
 
+#ifdef ENABLE_MPI
+template <typename T>
+NCCLTwoLevelARInplaceComm<T>::NCCLTwoLevelARInplaceComm(
+    size_t num_procs, const std::vector<std::shared_ptr<GPUResource>>& gpu_resources)
+    : gpu_resources_(gpu_resources), num_procs_(num_procs), num_gpus_(gpu_resources.size()) {
+  std::vector<int> device_list;
+  for (auto& gpu_resource : gpu_resources_) {
+    device_list.push_back(gpu_resource->get_device_id());
+  }
+  intra_comms_.resize(num_gpus_);
+  HCTR_LIB_THROW(ncclCommInitAll(intra_comms_.data(), num_gpus_, device_list.data()));
+
+  int pid;
+  HCTR_MPI_THROW(MPI_Comm_rank(MPI_COMM_WORLD, &pid));
+  inter_comms_.resize(num_gpus_);
+  for (size_t g = 0; g < num_gpus_; g++) {
+    ncclUniqueId inter_id;
+    if (pid == 0) {
+      HCTR_LIB_THROW(ncclGetUniqueId(&inter_id));
+    }
+    HCTR_MPI_THROW(MPI_Bcast(&inter_id, sizeof(inter_id), MPI_BYTE, 0, MPI_COMM_WORLD));
+    CudaDeviceContext context(device_list[g]);
+    HCTR_LIB_THROW(ncclCommInitRank(&inter_comms_[g], num_procs_, inter_id, pid));
+  }
+}
+
+template <typename T>
+NCCLTwoLevelARInplaceComm<T>::~NCCLTwoLevelARInplaceComm() {
+  for (size_t g = 0; g < num_gpus_; g++) {
+    ncclCommDestroy(intra_comms_[g]);
+    ncclCommDestroy(inter_comms_[g]);
+  }
+}
+
+template <typename T>
+AllReduceInPlaceComm::Handle NCCLTwoLevelARInplaceComm<T>::register_coll() {
+  ar_ctx_.emplace_back(std::make_unique<ARContext>());
+  Handle handle = (Handle)(ar_ctx_.size() - 1);
+  ar_ctx_[handle]->ctx_.resize(num_gpus_);
+
+  return handle;
+}
+
+template <typename T>
+void NCCLTwoLevelARInplaceComm<T>::set_coll_buf(Handle coll, void* ar_ptr, size_t ar_size,
+                                                size_t g) {
+  auto& ctx = ar_ctx_[coll];
+  ctx->ctx_[g].ar_ptr_ = ar_ptr;
+  if ((ctx->ar_size_ != 0) && (ctx->ar_size_ != ar_size)) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "AR size mismatch");
+  }
+  ctx->ar_size_ = ar_size;
+}
+
+template <typename T>
+void NCCLTwoLevelARInplaceComm<T>::update_size(Handle coll, const size_t ar_size) {
+  ar_ctx_[coll]->ar_size_ = ar_size;
+}
+
+template <typename T>
+void NCCLTwoLevelARInplaceComm<T>::register_coll_buf(Handle coll) {}
+
+template <typename T>
+void NCCLTwoLevelARInplaceComm<T>::all_reduce(AllReduceInPlaceComm::Handle coll,
+                                              cudaStream_t stream, size_t g) {
+  auto& ctx = ar_ctx_[coll];
+  T* ar_ptr = reinterpret_cast<T*>(ctx->ctx_[g].ar_ptr_);
+  const size_t count = ctx->ar_size_ / sizeof(T);
+  const size_t shard_count = count / num_gpus_;
+  const auto data_type = NcclDataType<T>::getType();
+  if (shard_count > 0) {
+    T* shard_ptr = ar_ptr + g * shard_count;
+    HCTR_LIB_THROW(ncclReduceScatter(ar_ptr, shard_ptr, shard_count, data_type, ncclSum,
+                                     intra_comms_[g], stream));
+    HCTR_LIB_THROW(ncclAllReduce(shard_ptr, shard_ptr, shard_count, data_type, ncclSum,
+                                 inter_comms_[g], stream));
+    HCTR_LIB_THROW(
+        ncclAllGather(shard_ptr, ar_ptr, shard_count, data_type, intra_comms_[g], stream));
+  }
+  // The tail that does not split evenly among the GPUs goes through the global communicator
+  const size_t tail_count = count - shard_count * num_gpus_;
+  if (tail_count > 0) {
+    T* tail_ptr = ar_ptr + shard_count * num_gpus_;
+    HCTR_LIB_THROW(ncclAllReduce(tail_ptr, tail_ptr, tail_count, data_type, ncclSum,
+                                 gpu_resources_[g]->get_nccl(), stream));
+  }
+}
+
+template class NCCLTwoLevelARInplaceComm<__half>;
+template class NCCLTwoLevelARInplaceComm<float>;
+#endif
+
+AutoARInplaceComm::AutoARInplaceComm(std::vector<Backend>&& backends,
+                                     const std::vector<std::shared_ptr<GPUResource>>& gpu_resources)
+    : backends_(std::move(backends)),
+      gpu_resources_(gpu_resources),
+      num_gpus_(gpu_resources.size()) {
+  HCTR_CHECK_HINT(!backends_.empty(), "The automatic all-reduce needs at least one backend");
+}
+
+AllReduceInPlaceComm::Handle AutoARInplaceComm::register_coll() {
+  ar_ctx_.emplace_back(std::make_unique<ARContext>());
+  Handle handle = (Handle)(ar_ctx_.size() - 1);
+  auto& ctx = ar_ctx_[handle];
+  ctx->ar_ptrs_.resize(num_gpus_);
+  for (auto& backend : backends_) {
+    ctx->handles_.push_back(backend.comm_->register_coll());
+  }
+
+  return handle;
+}
+
+void AutoARInplaceComm::set_coll_buf(Handle coll, void* ar_ptr, size_t ar_size, size_t g) {
+  auto& ctx = ar_ctx_[coll];
+  ctx->ar_ptrs_[g] = ar_ptr;
+  ctx->ar_size_ = ar_size;
+  for (size_t b = 0; b < backends_.size(); b++) {
+    backends_[b].comm_->set_coll_buf(ctx->handles_[b], ar_ptr, ar_size, g);
+  }
+}
+
+void AutoARInplaceComm::update_size(Handle coll, const size_t ar_size) {
+  auto& ctx = ar_ctx_[coll];
+  ctx->ar_size_ = ar_size;
+  for (size_t b = 0; b < backends_.size(); b++) {
+    backends_[b].comm_->update_size(ctx->handles_[b], ar_size);
+  }
+}
+
+void AutoARInplaceComm::register_coll_buf(Handle coll) {
+  auto& ctx = ar_ctx_[coll];
+  for (size_t b = 0; b < backends_.size(); b++) {
+    backends_[b].comm_->register_coll_buf(ctx->handles_[b]);
+  }
+}
+
+void AutoARInplaceComm::all_reduce(AllReduceInPlaceComm::Handle coll, cudaStream_t stream,
+                                   size_t g) {
+  auto& ctx = ar_ctx_[coll];
+  backends_[ctx->backend_].comm_->all_reduce(ctx->handles_[ctx->backend_], stream, g);
+}
+
+float AutoARInplaceComm::time_all_reduce(Handle coll, size_t backend) {
+  auto& ctx = ar_ctx_[coll];
+  auto& comm = backends_[backend].comm_;
+  const Handle handle = ctx->handles_[backend];
+  std::vector<float> elapsed_ms(num_gpus_);
+#pragma omp parallel num_threads(num_gpus_)
+  {
+    size_t g = omp_get_thread_num();
+    CudaDeviceContext context(gpu_resources_[g]->get_device_id());
+    cudaStream_t stream = gpu_resources_[g]->get_stream();
+    for (int i = 0; i < warmup_iters_; i++) {
+      comm->all_reduce(handle, stream, g);
+    }
+    cudaEvent_t start, stop;
+    HCTR_LIB_THROW(cudaEventCreate(&start));
+    HCTR_LIB_THROW(cudaEventCreate(&stop));
+    HCTR_LIB_THROW(cudaEventRecord(start, stream));
+    for (int i = 0; i < timed_iters_; i++) {
+      comm->all_reduce(handle, stream, g);
+    }
+    HCTR_LIB_THROW(cudaEventRecord(stop, stream));
+    HCTR_LIB_THROW(cudaEventSynchronize(stop));
+    HCTR_LIB_THROW(cudaEventElapsedTime(&elapsed_ms[g], start, stop));
+    HCTR_LIB_THROW(cudaEventDestroy(start));
+    HCTR_LIB_THROW(cudaEventDestroy(stop));
+  }
+  float max_elapsed_ms = *std::max_element(elapsed_ms.begin(), elapsed_ms.end());
+#ifdef ENABLE_MPI
+  HCTR_MPI_THROW(
+      MPI_Allreduce(MPI_IN_PLACE, &max_elapsed_ms, 1, MPI_FLOAT, MPI_MAX, MPI_COMM_WORLD));
+#endif
+  return max_elapsed_ms / timed_iters_;
+}
+
+void AutoARInplaceComm::select_backends() {
+  for (size_t coll = 0; coll < ar_ctx_.size(); coll++) {
+    auto& ctx = ar_ctx_[coll];
+    if (ctx->ar_size_ == 0) {
+      continue;
+    }
+    float best_ms = std::numeric_limits<float>::max();
+    for (size_t b = 0; b < backends_.size(); b++) {
+      if (ctx->ar_size_ % backends_[b].size_alignment_ != 0) {
+        continue;
+      }
+      float ms = time_all_reduce((Handle)coll, b);
+      if (ms < best_ms) {
+        best_ms = ms;
+        ctx->backend_ = b;
+      }
+    }
+    HCTR_LOG(INFO, ROOT, "All-reduce of %zu bytes uses %s (%.3f ms)\n", ctx->ar_size_,
+             backends_[ctx->backend_].name_.c_str(), best_ms);
+
+    // The timing summed up the buffers in place
+    for (size_t g = 0; g < num_gpus_; g++) {
+      CudaDeviceContext context(gpu_resources_[g]->get_device_id());
+      cudaStream_t stream = gpu_resources_[g]->get_stream();
+      HCTR_LIB_THROW(cudaMemsetAsync(ctx->ar_ptrs_[g], 0, ctx->ar_size_, stream));
+      HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    }
+  }
+}
+
 }  // namespace HugeCTR
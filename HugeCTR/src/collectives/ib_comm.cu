@@ -18,30 +18,113 @@
 #include <infiniband/verbs.h>
 #include <linux/mempolicy.h>
 #include <numaif.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
 
+#include <algorithm>
 #include <collectives/ib_comm.hpp>
+#include <core23/instrumentation.hpp>
 #include <iostream>
 #include <sstream>
 #include <utils.cuh>
 #include <utils.hpp>
 
 namespace HugeCTR {
-static void* proxy_thread_func(void* cfg) {
-  auto ibv_config = (struct IbvProxy::InitConfig*)cfg;
+namespace {
+
+uint64_t thread_cpu_time_us() {
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+// Waits between the rounds of a proxy thread as set by its ProxyPollPolicy, and adds the CPU time
+// of the thread to the "ib_proxy_cpu_time_us" metric.
+class ProxyPoller {
+  static constexpr size_t kCpuTimeReportRounds = 1 << 16;
+
+  ProxyPollPolicy policy_;
+  size_t num_rounds_ = 0;
+  size_t num_idle_rounds_ = 0;
+  size_t sleep_us_ = 1;
+  uint64_t last_cpu_time_us_;
+
+  void report_cpu_time() {
+    static auto& cpu_time = MetricsRegistry::get().counter("ib_proxy_cpu_time_us");
+    const uint64_t now = thread_cpu_time_us();
+    cpu_time.add(now - last_cpu_time_us_);
+    last_cpu_time_us_ = now;
+  }
+
+ public:
+  ProxyPoller(const ProxyPollPolicy& policy)
+      : policy_(policy), last_cpu_time_us_(thread_cpu_time_us()) {}
+  ~ProxyPoller() { report_cpu_time(); }
+
+  void wait(bool progress) {
+    if (++num_rounds_ % kCpuTimeReportRounds == 0) {
+      report_cpu_time();
+    }
+    if (progress) {
+      num_idle_rounds_ = 0;
+      sleep_us_ = 1;
+      return;
+    }
+    if (++num_idle_rounds_ <= policy_.spin_iters_) {
+      return;
+    }
+    if (policy_.max_sleep_us_ == 0 ||
+        num_idle_rounds_ <= policy_.spin_iters_ + policy_.yield_iters_) {
+      sched_yield();
+      return;
+    }
+    usleep(sleep_us_);
+    sleep_us_ = std::min(2 * sleep_us_, policy_.max_sleep_us_);
+  }
+};
+
+void* proxy_thread_func(void* cfg) {
+  auto thread_cfg = static_cast<ProxyThreadConfig*>(cfg);
 
   // set numa allocation policy to local
   set_mempolicy(MPOL_LOCAL, NULL, 0);
 
-  CudaCPUDeviceContext context(ibv_config->device_id_);
-
-  IbvProxy* proxy = new IbvProxy(ibv_config);
-  while (*(volatile int*)&proxy->destroy_ != 1) {
-    proxy->stm();
+  // The proxies of a thread serve neighbouring GPUs, so it runs on the NUMA node of the first one.
+  CudaCPUDeviceContext context(thread_cfg->proxy_cfgs_.front()->device_id_);
+
+  std::vector<std::unique_ptr<IbvProxy>> proxies;
+  for (auto ibv_config : thread_cfg->proxy_cfgs_) {
+    proxies.emplace_back(new IbvProxy(ibv_config));
+  }
+  ProxyPoller poller(thread_cfg->poll_policy_);
+  size_t num_destroyed = 0;
+  while (num_destroyed < proxies.size()) {
+    bool progress = false;
+    num_destroyed = 0;
+    // Proxies in the INIT state execute commands of the main thread in order of proxy id, which
+    // is the order they are stored in.
+    for (auto& proxy : proxies) {
+      if (*(volatile int*)&proxy->destroy_ == 1) {
+        num_destroyed++;
+      } else if (proxy->state_ == INIT) {
+        CudaDeviceContext device_context(proxy->cfg_.device_id_);
+        progress |= proxy->stm();
+      } else {
+        progress |= proxy->stm();
+      }
+    }
+    poller.wait(progress);
+  }
+  for (auto& proxy : proxies) {
+    CudaDeviceContext device_context(proxy->cfg_.device_id_);
+    proxy.reset();
   }
-  delete (proxy);
   return NULL;
 }
 
+}  // namespace
+
 // Helpers
 void IbComm::detect_ib_devs() {
   // Init hwloc topology
@@ -316,12 +399,34 @@ void IbComm::calculate_gpu_nic_affinity() {
 void IbComm::init_proxy_threads() {
   proxy_cmd_ = std::make_unique<ProxyCommand>(num_gpus_);
   proxy_cmd_->reset();
-  proxy_thread_.resize(num_gpus_);
   proxy_cfg_.resize(num_gpus_);
   for (auto& cfg : proxy_cfg_) {
     cfg = std::make_unique<IbvProxy::InitConfig>();
   }
 
+  // By default every GPU has its own proxy thread, which busy-polls and yields when idle.
+  ProxyPollPolicy poll_policy;
+  if (getenv("IB_PROXY_SPIN_ITERS")) {
+    poll_policy.spin_iters_ = atoll(getenv("IB_PROXY_SPIN_ITERS"));
+  }
+  if (getenv("IB_PROXY_YIELD_ITERS")) {
+    poll_policy.yield_iters_ = atoll(getenv("IB_PROXY_YIELD_ITERS"));
+  }
+  if (getenv("IB_PROXY_MAX_SLEEP_US")) {
+    poll_policy.max_sleep_us_ = atoll(getenv("IB_PROXY_MAX_SLEEP_US"));
+  }
+  size_t gpus_per_thread = 1;
+  if (getenv("IB_PROXY_GPUS_PER_THREAD")) {
+    gpus_per_thread = std::max(atoi(getenv("IB_PROXY_GPUS_PER_THREAD")), 1);
+  }
+  const size_t num_threads = (num_gpus_ + gpus_per_thread - 1) / gpus_per_thread;
+  proxy_thread_.resize(num_threads);
+  proxy_thread_cfg_.resize(num_threads);
+  for (auto& thread_cfg : proxy_thread_cfg_) {
+    thread_cfg = std::make_unique<ProxyThreadConfig>();
+    thread_cfg->poll_policy_ = poll_policy;
+  }
+
   for (size_t g = 0; g < num_gpus_; g++) {
     size_t device_id = device_list_[g];
 
@@ -335,7 +440,10 @@ void IbComm::init_proxy_threads() {
     cfg->num_gpus_ = num_gpus_;
     cfg->num_procs_ = num_procs_;
     cfg->my_proc_ = my_proc_;
+    proxy_thread_cfg_[g / gpus_per_thread]->proxy_cfgs_.push_back(cfg.get());
+  }
 
+  for (size_t t = 0; t < num_threads; t++) {
     sched_param param;
     pthread_attr_t attr;
     pthread_attr_init(&attr);
@@ -344,7 +452,8 @@ void IbComm::init_proxy_threads() {
     param.sched_priority = sched_get_priority_max(SCHED_FIFO);
     ;
     pthread_attr_setschedparam(&attr, &param);
-    int ret = pthread_create(&proxy_thread_[g], &attr, &proxy_thread_func, cfg.get());
+    int ret =
+        pthread_create(&proxy_thread_[t], &attr, &proxy_thread_func, proxy_thread_cfg_[t].get());
     PROXY_ASSERT(ret == 0);
   }
 }
@@ -831,8 +940,8 @@ void IbComm::finalize() {
     proxy_cmd_->reset();
   }
   proxy_cmd_->set_destroy();
-  for (size_t g = 0; g < num_gpus_; g++) {
-    int ret = pthread_join(proxy_thread_[g], NULL);
+  for (size_t t = 0; t < proxy_thread_.size(); t++) {
+    int ret = pthread_join(proxy_thread_[t], NULL);
     PROXY_ASSERT(ret == 0);
   }
   is_finalized_ = true;
@@ -17,6 +17,7 @@
 #ifdef ENABLE_MPI
 
 #include <collectives/ib_proxy.hpp>
+#include <core23/instrumentation.hpp>
 
 namespace HugeCTR {
 // ProxyCommand
@@ -59,6 +60,20 @@ void ProxyCommand::reset() {
   }
 }
 
+namespace {
+
+// Time from a command of the GPU to the completion of its sends
+void record_transfer(std::chrono::steady_clock::time_point start) {
+  static auto& transfer_time = MetricsRegistry::get().counter("ib_proxy_transfer_time_us");
+  static auto& num_transfers = MetricsRegistry::get().counter("ib_proxy_transfers");
+  transfer_time.add(std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - start)
+                        .count());
+  num_transfers.add(1);
+}
+
+}  // namespace
+
 static int oob_bcast(void* comm_context, void* buf, int size, int root) {
   HCTR_MPI_THROW(MPI_Bcast(buf, size, MPI_BYTE, root, MPI_COMM_WORLD));
   return 0;
@@ -564,29 +579,37 @@ bool IbvProxy::HierA2ACollContext::wait_send_completion() {
   return true;
 }
 
-void IbvProxy::HierA2ACollContext::stm() {
+bool IbvProxy::HierA2ACollContext::stm() {
   switch (state_) {
     case BUF_INIT_PENDING: {
       HCTR_CHECK_(false, "No buffers are registered for the collective.");
       break;
     }
     case WAIT_RECV_CMD: {
-      if (check_recv()) {
+      // The other proxies wait for proxy 0 here rather than in process_recv(), so that a thread
+      // running several proxies doesn't block on one of them.
+      if (check_recv() && (proxy_ctx_->cfg_.proxy_id_ == 0 ||
+                           sync_helper_->recv_bcast_ready(last_recv_cmd_ + 1))) {
+        send_start_ = std::chrono::steady_clock::now();
         process_recv();
         process_send();
         state_ = WAIT_COMPLETION;
+        return true;
       }
       break;
     }
     case WAIT_COMPLETION: {
+      const int num_completions = num_send_completions_ + num_atomic_completions_;
       if (wait_send_completion()) {
         state_ = WAIT_COMPLETION;
-      } else {
-        state_ = WAIT_RECV_CMD;
+        return num_send_completions_ + num_atomic_completions_ != num_completions;
       }
-      break;
+      state_ = WAIT_RECV_CMD;
+      record_transfer(send_start_);
+      return true;
     }
   }
+  return false;
 }
 
 IbvProxy::HierA2AvCollContext::HierA2AvCollContext(IbvProxy* _proxy_ctx,
@@ -814,29 +837,37 @@ bool IbvProxy::HierA2AvCollContext::wait_send_completion() {
   return true;
 }
 
-void IbvProxy::HierA2AvCollContext::stm() {
+bool IbvProxy::HierA2AvCollContext::stm() {
   switch (state_) {
     case BUF_INIT_PENDING: {
       HCTR_CHECK_(false, "No buffers are registered for the collective.");
       break;
     }
     case WAIT_RECV_CMD: {
-      if (check_recv()) {
+      // The other proxies wait for proxy 0 here rather than in process_recv(), so that a thread
+      // running several proxies doesn't block on one of them.
+      if (check_recv() && (proxy_ctx_->cfg_.proxy_id_ == 0 ||
+                           sync_helper_->recv_bcast_ready(last_recv_cmd_ + 1))) {
+        send_start_ = std::chrono::steady_clock::now();
         process_recv();
         process_send();
         state_ = WAIT_COMPLETION;
+        return true;
       }
       break;
     }
     case WAIT_COMPLETION: {
+      const int num_completions = num_send_completions_ + num_atomic_completions_;
       if (wait_send_completion()) {
         state_ = WAIT_COMPLETION;
-      } else {
-        state_ = WAIT_RECV_CMD;
+        return num_send_completions_ + num_atomic_completions_ != num_completions;
       }
-      break;
+      state_ = WAIT_RECV_CMD;
+      record_transfer(send_start_);
+      return true;
     }
   }
+  return false;
 }
 
 IbvProxy::HierA2AvCollContext::~HierA2AvCollContext() {
@@ -940,10 +971,12 @@ void IbvProxy::stm_init() {
   cfg_.proxy_cmd_->post_completion(cfg_.proxy_id_);
 }
 
-void IbvProxy::stm() {
+bool IbvProxy::stm() {
+  bool progress = false;
   switch (state_) {
     case INIT: {
       stm_init();
+      progress = true;
       break;
     }
     case READY_TO_TRANSFER: {
@@ -959,22 +992,24 @@ void IbvProxy::stm() {
       // Only one active context at a time
       if (hier_a2a_v_coll_ctx_.size() > 0) {
         auto& ctx = hier_a2a_v_coll_ctx_[active_ctx_];
-        ctx->stm();
+        progress |= ctx->stm();
         if (ctx->state_ == IbvProxy::HierA2AvCollContext::WAIT_RECV_CMD) {
           active_ctx_ = (active_ctx_ + 1) % hier_a2a_v_coll_ctx_.size();
         }
       }
       for (auto& ar_ctx_ : ar_coll_ctx_) {
-        ar_ctx_->stm();
+        progress |= ar_ctx_->stm();
       }
 
       break;
     }
     case DESTROY: {
       destroy_ = 1;
+      progress = true;
       break;
     }
   }
+  return progress;
 }
 
 // AR implementation
@@ -1307,17 +1342,20 @@ void IbvProxy::ARCollContext::process_new_command() {
   }
 }
 
-void IbvProxy::ARCollContext::stm() {
+bool IbvProxy::ARCollContext::stm() {
   switch (state_) {
     case BUF_INIT_PENDING: {
       HCTR_CHECK_(false, "No buffers are registered for the collective.");
       break;
     }
     case PROCESS_SHARP: {
+      const size_t num_requests = sharp_req_counter_ + sharp_cmpl_counter_;
       process_sharp_completions();
       process_new_command();
+      return sharp_req_counter_ + sharp_cmpl_counter_ != num_requests;
     }
   }
+  return false;
 }
 
 IbvProxy::ARCollContext::~ARCollContext() {
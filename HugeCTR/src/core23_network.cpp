@@ -14,15 +14,18 @@
  * limitations under the License.
  */
 
+#include <cxxabi.h>
 #include <omp.h>
 
 #include <core23_network.hpp>
+#include <cstdlib>
 #include <io/filesystem.hpp>
 #include <network_helpers.hpp>
 #include <nlohmann/json.hpp>
 #include <parser.hpp>
 #include <regularizer.hpp>
 #include <trainable_layer.hpp>
+#include <typeinfo>
 
 namespace HugeCTR {
 
@@ -51,9 +54,13 @@ void Network::train(int64_t current_batchsize) {
 
   float rterm = train_losses_.begin()->second->regularizer_compute_rterm();
 
-  for (std::map<std::string, std::unique_ptr<ILoss>>::iterator iter = train_losses_.begin();
-       iter != train_losses_.end(); ++iter) {
-    iter->second->compute(true, current_batchsize, rterm);
+  if (train_fused_loss_) {
+    train_fused_loss_->compute(true, current_batchsize, rterm);
+  } else {
+    for (std::map<std::string, std::unique_ptr<ILoss>>::iterator iter = train_losses_.begin();
+         iter != train_losses_.end(); ++iter) {
+      iter->second->compute(true, current_batchsize, rterm);
+    }
   }
 
   train_losses_.begin()->second->regularizer_initialize_wgrad(true);  // Only 1 regularizer for now
@@ -72,9 +79,13 @@ void Network::eval(int64_t current_batchsize) {
 
   float rterm = evaluate_losses_.begin()->second->regularizer_compute_rterm();
 
-  for (std::map<std::string, std::unique_ptr<ILoss>>::iterator iter = evaluate_losses_.begin();
-       iter != evaluate_losses_.end(); ++iter) {
-    iter->second->compute(false, current_batchsize, rterm);
+  if (evaluate_fused_loss_) {
+    evaluate_fused_loss_->compute(false, current_batchsize, rterm);
+  } else {
+    for (std::map<std::string, std::unique_ptr<ILoss>>::iterator iter = evaluate_losses_.begin();
+         iter != evaluate_losses_.end(); ++iter) {
+      iter->second->compute(false, current_batchsize, rterm);
+    }
   }
 
   evaluate_losses_.begin()->second->regularizer_initialize_wgrad(
@@ -91,10 +102,21 @@ void Network::predict() {
 
 float Network::get_loss() {
   float loss_host = 0.f;
+  CudaDeviceContext context(get_device_id());
+  // The regularization term is left out of the losses if the optimizer adds its gradient. It is
+  // only computed here then, from the current weights, and added to every loss as before.
+  const float rterm =
+      train_losses_.begin()->second->regularizer_compute_deferred_rterm() * train_losses_.size();
+  if (train_fused_loss_) {
+    HCTR_LIB_THROW(cudaMemcpyAsync(&loss_host, train_fused_loss_->get_total_loss_tensor().data(),
+                                   sizeof(float), cudaMemcpyDeviceToHost,
+                                   gpu_resource_->get_stream()));
+    HCTR_LIB_THROW(cudaStreamSynchronize(gpu_resource_->get_stream()));
+    return loss_host + rterm;
+  }
+
   float* loss_temp = new float[train_loss_tensor_.size()];
   size_t i = 0;
-
-  CudaDeviceContext context(get_device_id());
   for (auto& loss_tensor : train_loss_tensor_) {
     HCTR_LIB_THROW(cudaMemcpyAsync(&loss_temp[i], loss_tensor.second.data(), sizeof(float),
                                    cudaMemcpyDeviceToHost, gpu_resource_->get_stream()));
@@ -105,7 +127,7 @@ float Network::get_loss() {
     loss_host += loss_temp[i];
   }
   delete loss_temp;
-  return loss_host;
+  return loss_host + rterm;
 }
 
 metrics::Core23MultiLossMetricMap Network::get_raw_metrics_all() const { return raw_metrics_; }
@@ -185,6 +207,16 @@ void Network::download_params_to_host(float* weight) {
   return;
 }
 
+void Network::download_opt_states_to_host(char* h_opt_states) {
+  CudaDeviceContext context(get_device_id());
+
+  if (opt_tensor_->empty()) {
+    return;
+  }
+  HCTR_LIB_THROW(cudaMemcpy(h_opt_states, opt_tensor_->data(), opt_tensor_->num_bytes(),
+                            cudaMemcpyDeviceToHost));
+}
+
 void Network::upload_params_to_device(float* params) {
   CudaDeviceContext context(get_device_id());
 
@@ -228,7 +260,17 @@ void Network::exchange_wgrad() {
 }
 
 void Network::update_params() {
-  optimizer_->update();
+  // The optimizer reads the weights, the wgrads and its states, and writes the weights and the
+  // states.
+  const double bytes = 2.0 * train_weight_tensor_->num_bytes() + 2.0 * opt_tensor_->num_bytes() +
+                       (use_mixed_precision_ ? wgrad_tensor_half_->num_bytes()
+                                             : wgrad_tensor_->num_bytes());
+  profile(
+      "dense optimizer update", StepProfiler::Kind::Optimizer, [this] { optimizer_->update(); },
+      0.0, bytes);
+  if (update_hook_) {
+    profile("dense update hook", StepProfiler::Kind::Communication, update_hook_);
+  }
   return;
 }
 
@@ -256,6 +298,12 @@ void Network::search_algorithm() {
 
 void Network::copy_weights_from_train_layers_to_evaluate_layers() {
   CudaDeviceContext context(get_device_id());
+  // The eval weights are views of the train weights, see core23::MirrorBufferChannel
+  if (evaluate_weight_tensor_->data() == train_weight_tensor_->data() &&
+      (!use_mixed_precision_ ||
+       evaluate_weight_tensor_half_->data() == train_weight_tensor_half_->data())) {
+    return;
+  }
   HCTR_LIB_THROW(cudaMemcpyAsync(evaluate_weight_tensor_->data(), train_weight_tensor_->data(),
                                  train_weight_tensor_->num_bytes(), cudaMemcpyDeviceToDevice,
                                  gpu_resource_->get_stream()));
@@ -310,12 +358,12 @@ void Network::set_evaluate_layers(std::vector<std::unique_ptr<Layer>>&& evaluate
 
 void Network::set_train_losses(std::map<std::string, std::unique_ptr<ILoss>>&& train_losses,
                                const std::map<std::string, float>& label_weights) {
-  set_losses_common(train_losses, label_weights, train_loss_tensor_);
+  set_losses_common(train_losses, label_weights, train_loss_tensor_, train_fused_loss_);
   train_losses_ = std::move(train_losses);
 }
 void Network::set_evaluate_losses(std::map<std::string, std::unique_ptr<ILoss>>&& evaluate_losses,
                                   const std::map<std::string, float>& label_weights) {
-  set_losses_common(evaluate_losses, label_weights, evaluate_loss_tensor_);
+  set_losses_common(evaluate_losses, label_weights, evaluate_loss_tensor_, evaluate_fused_loss_);
   evaluate_losses_ = std::move(evaluate_losses);
 }
 
@@ -336,22 +384,27 @@ void Network::set_optimizer(std::unique_ptr<Optimizer> optimizer) {
   optimizer_ = std::move(optimizer);
 }
 
-void Network::create_and_set_optimizer(const OptParams& opt_params) {
+void Network::create_and_set_optimizer(const OptParams& opt_params,
+                                       std::optional<WeightShard> shard) {
   if (use_mixed_precision_) {
     auto weight_tensors = get_master_weight_tensor_vector<__half>(train_layers_);
     auto weight_half_tensors = get_weight_tensor_vector<__half>(train_layers_);
     auto wgrad_tensors = get_wgrad_tensor_vector<__half>(train_layers_);
     optimizer_ =
         Optimizer::Create<__half>(opt_params, weight_tensors, weight_half_tensors, wgrad_tensors,
-                                  opt_params.scaler, gpu_resource_, use_mixed_precision_);
+                                  opt_params.scaler, gpu_resource_, use_mixed_precision_, shard);
   } else {
     auto weight_tensors = get_weight_tensor_vector<float>(train_layers_);
     auto weight_half_tensors = std::vector<core23::Tensor>();
     auto wgrad_tensors = get_wgrad_tensor_vector<float>(train_layers_);
     optimizer_ =
         Optimizer::Create<float>(opt_params, weight_tensors, weight_half_tensors, wgrad_tensors,
-                                 opt_params.scaler, gpu_resource_, use_mixed_precision_);
+                                 opt_params.scaler, gpu_resource_, use_mixed_precision_, shard);
   }
+  // The update kernel adds the gradient of the regularization term, so that the weights are not
+  // read by another pass before the bprop. Only 1 regularizer for now.
+  optimizer_->set_regularization_grad(
+      train_losses_.begin()->second->regularizer_fuse_into_optimizer());
   auto opt_tensors = optimizer_->get_opt_state_tensors();
   int64_t num_opt_tensors = opt_tensors.size();
   opt_tensor_.emplace(opt_tensors, core23::Shape({num_opt_tensors}));
@@ -373,20 +426,73 @@ void Network::conv_weight_(std::optional<core23::TensorContainer<__half, 1, 1>>&
 }
 
 void Network::prop_layers(const std::vector<Layer*>& layers, bool fprop, bool train) {
+  // The evaluation is not profiled.
+  const bool profiled = train && profiler_ && profiler_->active();
   if (fprop) {
     for (auto& layer : layers) {
-      layer->fprop(train);
+      if (profiled) {
+        profile(
+            "fprop " + layer_names_[layer], StepProfiler::Kind::Layer,
+            [layer, train] { layer->fprop(train); }, layer->get_flops(true),
+            layer->get_bytes(true));
+      } else {
+        layer->fprop(train);
+      }
     }
   } else {
     for (auto it = layers.rbegin(); it != layers.rend(); it++) {
-      (*it)->bprop();
+      Layer* layer = *it;
+      if (profiled) {
+        profile(
+            "bprop " + layer_names_[layer], StepProfiler::Kind::Layer, [layer] { layer->bprop(); },
+            layer->get_flops(false), layer->get_bytes(false));
+      } else {
+        layer->bprop();
+      }
+      if (auto hook = bprop_hooks_.find(layer); hook != bprop_hooks_.end()) {
+        profile("bprop hook of " + layer_names_[layer], StepProfiler::Kind::Communication,
+                hook->second);
+      }
     }
   }
 }
 
+void Network::profile(const std::string& name, const StepProfiler::Kind kind,
+                      const std::function<void()>& work, const double flops, const double bytes) {
+  if (profiler_ && profiler_->active()) {
+    profiler_->time(gpu_resource_->get_local_id(), name, kind, work, flops, bytes);
+  } else {
+    work();
+  }
+}
+
+void Network::set_profiler(StepProfiler* profiler) {
+  profiler_ = profiler;
+  layer_names_.clear();
+  for (size_t i = 0; i < train_layers_.size(); i++) {
+    const Layer* layer = train_layers_[i].get();
+    const char* type_name = typeid(*layer).name();
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(type_name, nullptr, nullptr, &status);
+    std::string name = status == 0 ? demangled : type_name;
+    std::free(demangled);
+    if (name.rfind("HugeCTR::", 0) == 0) {
+      name = name.substr(9);
+    }
+    layer_names_[layer] = std::to_string(i) + " " + name;
+  }
+}
+
+void Network::set_bprop_hook(const Layer* layer, std::function<void()> hook) {
+  bprop_hooks_[layer] = std::move(hook);
+}
+
+void Network::set_update_hook(std::function<void()> hook) { update_hook_ = std::move(hook); }
+
 void Network::set_losses_common(const std::map<std::string, std::unique_ptr<ILoss>>& losses,
                                 const std::map<std::string, float>& label_weights,
-                                std::map<std::string, core23::Tensor>& loss_tensors) {
+                                std::map<std::string, core23::Tensor>& loss_tensors,
+                                std::unique_ptr<IFusedLoss>& fused_loss) {
   for (auto& pair : losses) {
     if (use_mixed_precision_) {
       auto loss_ptr = dynamic_cast<Loss<__half>*>(pair.second.get());
@@ -401,6 +507,9 @@ void Network::set_losses_common(const std::map<std::string, std::unique_ptr<ILos
     }
     pair.second->set_label_weight(it->second);
   }
+  // The BinaryCrossEntropyLoss heads of a multi-task model are computed in one kernel
+  fused_loss = use_mixed_precision_ ? create_fused_loss<__half>(losses)
+                                    : create_fused_loss<float>(losses);
 }
 
 }  // namespace HugeCTR
@@ -35,7 +35,8 @@ namespace HugeCTR {
 AsyncReaderImpl::AsyncReaderImpl(std::string fname, size_t batch_size_bytes,
                                  const ResourceManager* resource_manager, int num_threads,
                                  int num_batches_per_thread, size_t io_block_size, int io_depth,
-                                 int io_alignment, bool shuffle, bool wait_for_gpu_idle)
+                                 int io_alignment, bool shuffle, bool wait_for_gpu_idle,
+                                 bool striped_upload)
     :
 
       fname_(fname),
@@ -48,11 +49,18 @@ AsyncReaderImpl::AsyncReaderImpl(std::string fname, size_t batch_size_bytes,
       io_depth_(io_depth),
       io_alignment_(io_alignment),
       wait_for_gpu_idle_(wait_for_gpu_idle),
+      striped_upload_(striped_upload && num_devices_ > 1),
       queue_id_(0),
       thread_batch_ids_(num_threads_),
       thread_buffer_ids_(num_threads_),
       gpu_thread_ids_(num_devices_),
       local_readers_(num_threads_) {
+  if (striped_upload_ && !resource_manager_->all_p2p_enabled()) {
+    HCTR_LOG(WARNING, ROOT,
+             "The striped upload of the AsyncReader needs P2P access between all the GPUs, every "
+             "batch is uploaded to a single GPU instead\n");
+    striped_upload_ = false;
+  }
   total_file_size_ = std::filesystem::file_size(fname);
   num_batches_ = (total_file_size_ + batch_size_bytes_ - 1) / batch_size_bytes;
   batch_ids_.resize(num_batches_);
@@ -81,7 +89,6 @@ AsyncReaderImpl::AsyncReaderImpl(std::string fname, size_t batch_size_bytes,
     CudaDeviceContext ctx(device_id);
     HCTR_LIB_THROW(cudaStreamCreateWithPriority(&streams_[id], cudaStreamNonBlocking, -100));
   }
-  HCTR_LIB_THROW(cudaEventCreateWithFlags(&event_success_, cudaEventDisableTiming));
 
   // For correct perf benchmarking create the thread readers upfront
   create_workers();
@@ -124,8 +131,8 @@ void AsyncReaderImpl::create_workers() {
           fname_, resource_manager_, batch_size_bytes_, raw_id, streams_[raw_id],
           thread_batch_ids_[thid], thread_buffer_ptrs,
           ThreadAsyncReaderParameters{io_block_size_, io_alignment_, io_depth_, num_devices_,
-                                      wait_for_gpu_idle_, loop_},
-          total_file_size_);
+                                      wait_for_gpu_idle_, loop_, striped_upload_},
+          total_file_size_, streams_);
     }));
   }
   for (auto& thread : threads_) {
@@ -163,20 +170,26 @@ BatchDesc AsyncReaderImpl::get_batch() {
         "Requested a batch from a file that is not being loaded. Please call load_async() first!");
   }
 
+  auto is_done = [](BufferStatus status) {
+    return status == BufferStatus::ReadReady || status == BufferStatus::PermanentlyResident ||
+           status == BufferStatus::Finished;
+  };
   for (size_t attempt = 0; attempt < buffers_.size(); attempt++) {
     last_buffer_ = buffers_[queue_id_].get();
 
     auto status = last_buffer_->status.load();
-    while (status != BufferStatus::Finished) {
-      if (status == BufferStatus::ReadReady || status == BufferStatus::PermanentlyResident) {
-        return {last_buffer_->size, last_buffer_->dev_data,
-                status == BufferStatus::PermanentlyResident, static_cast<size_t>(last_buffer_->id)};
-      }
+    if (!is_done(status)) {
+      // Nothing else runs on the GPU while we sleep, so the reader can upload right away
       if (wait_for_gpu_idle_) {
-        last_buffer_->ready_to_upload_event.store(&event_success_);
+        last_buffer_->consumer_waiting.store(true);
+        last_buffer_->ring_reader();
       }
-
-      status = last_buffer_->status.load();
+      status = last_buffer_->wait_status(is_done);
+      last_buffer_->consumer_waiting.store(false);
+    }
+    if (status != BufferStatus::Finished) {
+      return {last_buffer_->size, last_buffer_->dev_data,
+              status == BufferStatus::PermanentlyResident, static_cast<size_t>(last_buffer_->id)};
     }
     queue_id_ = (queue_id_ + 1) % buffers_.size();
   }
@@ -205,6 +218,7 @@ void AsyncReaderImpl::wait_for_gpu_event(cudaEvent_t* event, int raw_device_id)
     for (auto bufid : thread_buffer_ids_.at(thid)) {
       if (buffers_[bufid]->status == BufferStatus::UploadInProcess) {
         buffers_[bufid]->ready_to_upload_event.store(event);
+        buffers_[bufid]->ring_reader();
       }
     }
   }
@@ -213,7 +227,9 @@ void AsyncReaderImpl::wait_for_gpu_event(cudaEvent_t* event, int raw_device_id)
 void AsyncReaderImpl::finalize_batch() {
   // Don't update status of finished or resident buffers
   BufferStatus expected = BufferStatus::ReadReady;
-  last_buffer_->status.compare_exchange_strong(expected, BufferStatus::IOReady);
+  if (last_buffer_->status.compare_exchange_strong(expected, BufferStatus::IOReady)) {
+    last_buffer_->ring_reader();
+  }
   if (loop_ && last_buffer_->id == (int64_t)num_batches_ - 1) {
     queue_id_ = 0;
   } else {
@@ -245,9 +261,6 @@ void AsyncReaderImpl::reset() {
   queue_id_ = 0;
 }
 
-AsyncReaderImpl::~AsyncReaderImpl() {
-  reset();
-  cudaEventDestroy(event_success_);
-}
+AsyncReaderImpl::~AsyncReaderImpl() { reset(); }
 
 }  // namespace HugeCTR
@@ -32,7 +32,8 @@ AsyncReader<SparseType>::AsyncReader(std::string fname, size_t batch_size, size_
                                      const std::shared_ptr<ResourceManager>& resource_manager,
                                      int num_threads, int num_batches_per_thread,
                                      size_t io_block_size, int io_depth, int io_alignment,
-                                     bool shuffle, bool wait_for_gpu_idle, Alignment_t aligned)
+                                     bool shuffle, bool wait_for_gpu_idle, Alignment_t aligned,
+                                     bool striped_upload)
     : resource_manager_(resource_manager),
       mixed_precision_(mixed_precision),
       batch_size_(batch_size),
@@ -59,7 +60,7 @@ AsyncReader<SparseType>::AsyncReader(std::string fname, size_t batch_size, size_
   sparse_dim_ = sparse_dim;
   reader_impl_ = std::make_unique<AsyncReaderImpl>(
       fname, batch_size_bytes, resource_manager.get(), num_threads, num_batches_per_thread,
-      io_block_size, io_depth, io_alignment, shuffle, wait_for_gpu_idle);
+      io_block_size, io_depth, io_alignment, shuffle, wait_for_gpu_idle, striped_upload);
 
   for (uint32_t i = 0; i < resource_manager_->get_local_gpu_count(); i++) {
     auto local_gpu = resource_manager_->get_local_gpu(i);
@@ -200,8 +201,11 @@ long long AsyncReader<SparseType>::read_a_batch_to_device_delay_release() {
 
     if (!current_batch_cached_) {  // data can be cached for eval
 
-      auto ptr_wrap =
-          std::make_shared<RawPtrWrapper>(reinterpret_cast<InputType*>(batch.dev_data[i]));
+      // A non-owning view of the samples, so that no tensor is bound per batch
+      const int64_t sample_shape[] = {current_batch_size_,
+                                      static_cast<int64_t>(sample_size_items_)};
+      const core23::TensorView<const int, 2> samples(
+          reinterpret_cast<const InputType*>(batch.dev_data[i]), sample_shape);
       // To save memory we're going to use the space in the Data for the unprocessed
       //  sparse features, and then run to_unique_categories essentially in place
       //    auto current_batch_size = batch.size_bytes / (sample_size_items_ * sizeof(dtype));
@@ -210,20 +214,12 @@ long long AsyncReader<SparseType>::read_a_batch_to_device_delay_release() {
       if (mixed_precision_) {
         split_3_way<__half, SparseType>(
             batch_tensors.label_tensors[i], batch_tensors.dense_tensors[i],
-            batch_tensors.sparse_tensors[i].get_value_tensor(),
-            core23::Tensor::bind(reinterpret_cast<void*>(ptr_wrap->get_ptr()),
-                                 {current_batch_size_, static_cast<int64_t>(sample_size_items_)},
-                                 core23::ToScalarType<InputType>::value,
-                                 core23::Device(core23::DeviceType::GPU, gpu_id)),
+            batch_tensors.sparse_tensors[i].get_value_tensor(), samples,
             global_dev_id * batch_size_per_dev_, (global_dev_id + 1) * batch_size_per_dev_, stream);
       } else {
         split_3_way<float, SparseType>(
             batch_tensors.label_tensors[i], batch_tensors.dense_tensors[i],
-            batch_tensors.sparse_tensors[i].get_value_tensor(),
-            core23::Tensor::bind(reinterpret_cast<void*>(ptr_wrap->get_ptr()),
-                                 {current_batch_size_, static_cast<int64_t>(sample_size_items_)},
-                                 core23::ToScalarType<InputType>::value,
-                                 core23::Device(core23::DeviceType::GPU, gpu_id)),
+            batch_tensors.sparse_tensors[i].get_value_tensor(), samples,
             global_dev_id * batch_size_per_dev_, (global_dev_id + 1) * batch_size_per_dev_, stream);
       }
     }
@@ -490,7 +486,8 @@ void AsyncReader<SparseType>::create_drwg_norm(std::string file_list, Check_t ch
 template <typename SparseType>
 void AsyncReader<SparseType>::create_drwg_raw(std::string file_name, long long num_samples,
                                               bool float_label_dense, bool data_shuffle,
-                                              bool start_reading_from_beginning) {}
+                                              bool start_reading_from_beginning,
+                                              bool parse_on_device) {}
 #ifndef DISABLE_CUDF
 template <typename SparseType>
 void AsyncReader<SparseType>::create_drwg_parquet(std::string file_list,
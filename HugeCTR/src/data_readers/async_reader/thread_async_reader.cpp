@@ -15,6 +15,8 @@
  */
 
 #include <fcntl.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 #include <cassert>
 #include <common.hpp>
@@ -24,16 +26,30 @@
 #include <numeric>
 #include <resource_manager.hpp>
 #include <stdexcept>
+#include <utils.hpp>
 namespace HugeCTR {
 
+namespace {
+
+// Runs on the CUDA callback thread once the upload of the buffer is done, so no CUDA call here
+void CUDART_CB upload_done(void* user_data) {
+  auto buffer = static_cast<InternalBatchBuffer*>(user_data);
+  buffer->publish_status(BufferStatus::UploadSubmitted, BufferStatus::ReadReady);
+  buffer->ring_reader();
+}
+
+}  // namespace
+
 ThreadAsyncReader::ThreadAsyncReader(std::string fname, const ResourceManager* resource_mananager,
                                      size_t batch_size_bytes, int device_id, cudaStream_t stream,
                                      std::vector<size_t> batch_ids,
                                      std::vector<InternalBatchBuffer*> dest_buffers,
-                                     ThreadAsyncReaderParameters params, size_t total_file_size)
+                                     ThreadAsyncReaderParameters params, size_t total_file_size,
+                                     std::vector<cudaStream_t> device_streams)
     : batch_size_bytes_(batch_size_bytes),
       device_id_(device_id),
       stream_(stream),
+      device_streams_(device_streams),
       total_file_size_(total_file_size),
       batch_ids_(batch_ids),
       dest_buffers_(dest_buffers),
@@ -46,6 +62,8 @@ ThreadAsyncReader::ThreadAsyncReader(std::string fname, const ResourceManager* r
 #endif
   HCTR_CHECK_HINT(params_.io_block_size % params_.io_alignment == 0,
                   " params_.io_block_size % params_.io_alignment != 0");
+  HCTR_CHECK_HINT(!params_.striped_upload || params_.num_h2d_chunks == (int)device_streams_.size(),
+                  "The striped upload needs one chunk per GPU");
 
   num_dest_buffers_ = dest_buffers_.size();
 
@@ -65,6 +83,11 @@ ThreadAsyncReader::ThreadAsyncReader(std::string fname, const ResourceManager* r
     }
   };
 
+  doorbell_ = eventfd(0, EFD_CLOEXEC);
+  if (doorbell_ == -1) {
+    HCTR_OWN_THROW(Error_t::UnspecificError, "eventfd failed");
+  }
+
   max_num_blocks_per_batch_ = batch_size_bytes_ / params_.io_block_size + 2;
   size_t pinned_size = 0;
   for (auto buf : dest_buffers_) {
@@ -75,6 +98,14 @@ ThreadAsyncReader::ThreadAsyncReader(std::string fname, const ResourceManager* r
     assert((size_t)buf->raw_host_ptr % params_.io_alignment == 0);
 
     HCTR_LIB_THROW(cudaEventCreateWithFlags(&buf->event, cudaEventDisableTiming));
+    buf->reader_eventfd = doorbell_;
+    if (params_.striped_upload) {
+      buf->stripe_events.resize(device_streams_.size());
+      for (size_t id = 0; id < device_streams_.size(); id++) {
+        CudaDeviceContext ctx(resource_mananager->get_local_gpu(id)->get_device_id());
+        HCTR_LIB_THROW(cudaEventCreateWithFlags(&buf->stripe_events[id], cudaEventDisableTiming));
+      }
+    }
 
     buf->io_reqs.resize(max_num_blocks_per_batch_);
     for (auto& req : buf->io_reqs) {
@@ -98,6 +129,7 @@ void ThreadAsyncReader::load() {
     buf->safe_to_upload_event.store(nullptr);
     buf->ready_to_upload_event.store(nullptr);
     buf->preload_done = false;
+    buf->upload_pending = false;
   }
 
   ioctx_ = 0;
@@ -117,25 +149,27 @@ void ThreadAsyncReader::load() {
     //   return;
     // }
 
+    bool progress = false;
     for (int i = 0; i < num_dest_buffers_; i++) {
       if (id_per_host_buffer[i] < num_batches) {
-        try_submit_io(batch_ids_[id_per_host_buffer[i]], i);
+        progress |= try_submit_io(batch_ids_[id_per_host_buffer[i]], i);
       }
     }
-    wait_io();
+    progress |= reap_io();
     for (int i = 0; i < num_dest_buffers_; i++) {
       if (id_per_host_buffer[i] < num_batches) {
-        try_submit_p2p(dest_buffers_[i]);
+        progress |= try_submit_p2p(dest_buffers_[i]);
       }
     }
     for (int i = 0; i < num_dest_buffers_; i++) {
       if (id_per_host_buffer[i] < num_batches) {
-        try_submit_upload(dest_buffers_[i]);
+        progress |= try_submit_upload(dest_buffers_[i]);
       }
     }
     for (int i = 0; i < num_dest_buffers_; i++) {
       if (id_per_host_buffer[i] < num_batches) {
         if (check_completion(dest_buffers_[i])) {
+          progress = true;
           processed++;
           id_per_host_buffer[i] += num_dest_buffers_;
           if (params_.loop && id_per_host_buffer[i] >= num_batches) {
@@ -144,10 +178,13 @@ void ThreadAsyncReader::load() {
         }
       }
     }
-    usleep(10);
     if (!params_.loop && processed >= num_batches) {
       break;
     }
+    // Whatever unblocks one of the steps rings the doorbell after it, so no wakeup is lost
+    if (!progress) {
+      wait_doorbell();
+    }
   }
 
   if (io_destroy(ioctx_) < 0) {
@@ -156,25 +193,34 @@ void ThreadAsyncReader::load() {
 
   HCTR_LIB_THROW(cudaStreamSynchronize(stream_));
 
-  if (status_.load() != WorkerStatus::Terminate) {
-    for (int i = 0; i < num_dest_buffers_; i++) {
-      BufferStatus expected = BufferStatus::IOReady;
-      while (!dest_buffers_[i]->status.compare_exchange_weak(expected, BufferStatus::Finished)) {
-        expected = BufferStatus::IOReady;
-      }
+  // Each buffer is finished once the consumer gives it back
+  for (int i = 0; i < num_dest_buffers_ && status_.load() != WorkerStatus::Terminate; i++) {
+    while (!dest_buffers_[i]->publish_status(BufferStatus::IOReady, BufferStatus::Finished) &&
+           status_.load() != WorkerStatus::Terminate) {
+      wait_doorbell();
     }
   }
 }
 
-void ThreadAsyncReader::try_submit_io(size_t batch_id, int io_id) {
+void ThreadAsyncReader::wait_doorbell() {
+  uint64_t count;
+  while (read(doorbell_, &count, sizeof(count)) < 0) {
+    if (errno != EINTR) {
+      HCTR_OWN_THROW(Error_t::UnspecificError, "read of the eventfd failed");
+    }
+  }
+}
+
+bool ThreadAsyncReader::try_submit_io(size_t batch_id, int io_id) {
   auto& buffer = dest_buffers_[io_id];
-  if (buffer->status.load() != BufferStatus::IOReady) {
-    return;
+  // A buffer given back before its upload was counted still holds the previous batch
+  if (buffer->status.load() != BufferStatus::IOReady || buffer->upload_pending) {
+    return false;
   }
   // Maybe we have already loaded this batch before?!
   if (buffer->id == (int64_t)batch_id) {
-    buffer->status.store(BufferStatus::PermanentlyResident);
-    return;
+    buffer->publish_status(BufferStatus::PermanentlyResident);
+    return true;
   }
 
   buffer->status.store(BufferStatus::IOInProcess);
@@ -200,6 +246,7 @@ void ThreadAsyncReader::try_submit_io(size_t batch_id, int io_id) {
 
     io_prep_pread(req, fd_, buffer->raw_host_ptr + params_.io_block_size * block,
                   params_.io_block_size, raw_beg_offset + params_.io_block_size * block);
+    io_set_eventfd(req, doorbell_);
     req->data = (void*)buffer;
   }
 
@@ -208,14 +255,18 @@ void ThreadAsyncReader::try_submit_io(size_t batch_id, int io_id) {
   if (ret < 0) {
     HCTR_OWN_THROW(Error_t::UnspecificError, "io_submit failed");
   }
+  return true;
 }
 
-void ThreadAsyncReader::wait_io() {
-  timespec timeout = {0, 10'000l};
+bool ThreadAsyncReader::reap_io() {
+  if (num_buffers_waiting_io_ == 0) {
+    return false;
+  }
+  // Does not block, the completions ring the doorbell
+  timespec timeout = {0, 0};
 
   io_event events[max_num_blocks_per_batch_];
-  int num_completed =
-      io_getevents(ioctx_, max_num_blocks_per_batch_, max_num_blocks_per_batch_, events, &timeout);
+  int num_completed = io_getevents(ioctx_, 0, max_num_blocks_per_batch_, events, &timeout);
   if (num_completed < 0) {
     HCTR_OWN_THROW(Error_t::UnspecificError, "io_getevents failed");
   }
@@ -236,28 +287,32 @@ void ThreadAsyncReader::wait_io() {
       }
     }
   }
+  return num_completed > 0;
 }
 
-bool ThreadAsyncReader::wait_for_gpu_idle(InternalBatchBuffer* buffer) {
-  if (params_.wait_for_gpu_idle && buffer->preload_done) {
+bool ThreadAsyncReader::wait_for_gpu_idle(InternalBatchBuffer* buffer, cudaStream_t stream) {
+  if (params_.wait_for_gpu_idle && buffer->preload_done && !buffer->consumer_waiting.load()) {
     auto event_ptr = buffer->ready_to_upload_event.load();
     if (event_ptr == nullptr) {
       return false;
     } else {
       buffer->ready_to_upload_event.store(nullptr);
-      HCTR_LIB_THROW(cudaStreamWaitEvent(stream_, *event_ptr));
+      HCTR_LIB_THROW(cudaStreamWaitEvent(stream, *event_ptr));
     }
   }
   return true;
 }
 
-void ThreadAsyncReader::try_submit_upload(InternalBatchBuffer* buffer) {
+bool ThreadAsyncReader::try_submit_upload(InternalBatchBuffer* buffer) {
   if (buffer->status.load() != BufferStatus::UploadInProcess ||
       buffer->num_submitted_h2d_chunks >= params_.num_h2d_chunks) {
-    return;
+    return false;
   }
-  if (!wait_for_gpu_idle(buffer)) {
-    return;
+  // With the striped upload, every GPU uploads one chunk over its own PCIe link
+  const int dst_id = params_.striped_upload ? buffer->num_submitted_h2d_chunks : device_id_;
+  cudaStream_t stream = params_.striped_upload ? device_streams_[dst_id] : stream_;
+  if (!wait_for_gpu_idle(buffer, stream)) {
+    return false;
   }
 
   // H2D upload
@@ -265,35 +320,73 @@ void ThreadAsyncReader::try_submit_upload(InternalBatchBuffer* buffer) {
   if (buffer->num_submitted_h2d_chunks == 0 && buffer->safe_to_upload_event != nullptr) {
     HCTR_LIB_THROW(cudaStreamWaitEvent(stream_, *buffer->safe_to_upload_event));
   }
+  if (params_.striped_upload) {
+    // The other streams wait for the same point of ours, buffer->event is recorded again once
+    // the batch is complete
+    if (buffer->num_submitted_h2d_chunks == 0) {
+      HCTR_LIB_THROW(cudaEventRecord(buffer->event, stream_));
+    }
+    if (stream != stream_) {
+      HCTR_LIB_THROW(cudaStreamWaitEvent(stream, buffer->event));
+    }
+  }
 
   size_t chunk_size = (buffer->size + params_.num_h2d_chunks - 1) / params_.num_h2d_chunks;
-  size_t beg_offset = chunk_size * buffer->num_submitted_h2d_chunks;
+  size_t beg_offset = std::min(buffer->size, chunk_size * buffer->num_submitted_h2d_chunks);
   size_t end_offset = std::min(buffer->size, chunk_size * (buffer->num_submitted_h2d_chunks + 1));
 
-  HCTR_LIB_THROW(cudaMemcpyAsync(buffer->dev_data[device_id_] + beg_offset,
-                                 buffer->host_data + beg_offset, end_offset - beg_offset,
-                                 cudaMemcpyHostToDevice, stream_));
+  if (end_offset > beg_offset) {
+    HCTR_LIB_THROW(cudaMemcpyAsync(buffer->dev_data[dst_id] + beg_offset,
+                                   buffer->host_data + beg_offset, end_offset - beg_offset,
+                                   cudaMemcpyHostToDevice, stream));
+  }
   buffer->num_submitted_h2d_chunks++;
+  return true;
 }
 
-void ThreadAsyncReader::try_submit_p2p(InternalBatchBuffer* buffer) {
+bool ThreadAsyncReader::try_submit_p2p(InternalBatchBuffer* buffer) {
   if (buffer->status.load() != BufferStatus::UploadInProcess ||
       buffer->num_submitted_h2d_chunks < params_.num_h2d_chunks) {
-    return;
+    return false;
   }
-  if (!wait_for_gpu_idle(buffer)) {
-    return;
+  const int src_id = buffer->num_submitted_broadcasts;
+  const bool all_submitted = src_id == (int)buffer->dev_data.size();
+  cudaStream_t stream =
+      params_.striped_upload && !all_submitted ? device_streams_[src_id] : stream_;
+  if (!wait_for_gpu_idle(buffer, stream)) {
+    return false;
+  }
+
+  // All-gather the chunks, every GPU copies its chunk to the others over NVLink
+  if (params_.striped_upload && !all_submitted) {
+    size_t chunk_size = (buffer->size + params_.num_h2d_chunks - 1) / params_.num_h2d_chunks;
+    size_t beg_offset = std::min(buffer->size, chunk_size * src_id);
+    size_t end_offset = std::min(buffer->size, chunk_size * (src_id + 1));
+    for (int dst_id = 0; dst_id < (int)buffer->dev_data.size() && end_offset > beg_offset;
+         dst_id++) {
+      if (dst_id != src_id) {
+        HCTR_LIB_THROW(cudaMemcpyAsync(buffer->dev_data[dst_id] + beg_offset,
+                                       buffer->dev_data[src_id] + beg_offset,
+                                       end_offset - beg_offset, cudaMemcpyDefault, stream));
+      }
+    }
+    if (stream != stream_) {
+      HCTR_LIB_THROW(cudaEventRecord(buffer->stripe_events[src_id], stream));
+      HCTR_LIB_THROW(cudaStreamWaitEvent(stream_, buffer->stripe_events[src_id]));
+    }
+    buffer->num_submitted_broadcasts++;
+    return true;
   }
 
   // Broadcast to the other GPUs
-  if (buffer->num_submitted_broadcasts != (int)buffer->dev_data.size()) {
+  if (!all_submitted) {
     if (device_id_ != buffer->num_submitted_broadcasts) {
       HCTR_LIB_THROW(cudaMemcpyAsync(buffer->dev_data[buffer->num_submitted_broadcasts],
                                      buffer->dev_data[device_id_], buffer->size, cudaMemcpyDefault,
                                      stream_));
     }
     buffer->num_submitted_broadcasts++;
-    return;
+    return true;
   }
 
   // Here we've submitted everything
@@ -305,32 +398,30 @@ void ThreadAsyncReader::try_submit_p2p(InternalBatchBuffer* buffer) {
   buffer->num_submitted_broadcasts = 0;
   HCTR_LIB_THROW(cudaEventRecord(buffer->event, stream_));
   buffer->status.store(BufferStatus::UploadSubmitted);
+  buffer->upload_pending = true;
+  // The buffer is handed to the consumer as soon as the stream gets there
+  HCTR_LIB_THROW(cudaLaunchHostFunc(stream_, upload_done, buffer));
+  return true;
 }
 
 bool ThreadAsyncReader::check_completion(InternalBatchBuffer* buffer) {
-  if (buffer->status.load() != BufferStatus::UploadSubmitted) {
+  // upload_done() moved the buffer on, maybe even the consumer already gave it back
+  if (!buffer->upload_pending || buffer->status.load() == BufferStatus::UploadSubmitted) {
     return false;
   }
-
-  auto res = cudaEventQuery(buffer->event);
-  if (res == cudaSuccess) {
-    buffer->status.store(BufferStatus::ReadReady);
-    return true;
-  }
-  if (res == cudaErrorNotReady) {
-    return false;
-  }
-  HCTR_LIB_THROW(res);
-  return false;
+  buffer->upload_pending = false;
+  return true;
 }
 
 void ThreadAsyncReader::reset() {
   status_.store(WorkerStatus::Terminate);
   for (auto buf : dest_buffers_) {
-    buf->status.store(BufferStatus::IOReady);
+    buf->publish_status(BufferStatus::IOReady);
   }
+  const uint64_t one = 1;
+  [[maybe_unused]] ssize_t ret = write(doorbell_, &one, sizeof(one));
 }
 
-ThreadAsyncReader::~ThreadAsyncReader() = default;
+ThreadAsyncReader::~ThreadAsyncReader() { close(doorbell_); }
 
 }  // namespace HugeCTR
@@ -280,7 +280,7 @@ void DataReader<TypeKey>::create_drwg_norm(std::string file_name, Check_t check_
 template <typename TypeKey>
 void DataReader<TypeKey>::create_drwg_raw(std::string file_name, long long num_samples,
                                           bool float_label_dense, bool data_shuffle,
-                                          bool start_reading_from_beginning) {
+                                          bool start_reading_from_beginning, bool parse_on_device) {
   // check if key type compatible with dataset
   size_t file_size = std::filesystem::file_size(file_name);
   size_t expected_file_size = (label_dim_ + dense_dim_) * sizeof(float);
@@ -295,7 +295,8 @@ void DataReader<TypeKey>::create_drwg_raw(std::string file_name, long long num_s
   source_type_ = SourceType_t::Mmap;
   worker_group_.reset(new DataReaderWorkerGroupRaw<TypeKey>(
       thread_buffers_, resource_manager_, file_name, num_samples, repeat_, params_, label_dim_,
-      dense_dim_, batchsize_, float_label_dense, data_shuffle, start_reading_from_beginning));
+      dense_dim_, batchsize_, float_label_dense, data_shuffle, start_reading_from_beginning,
+      parse_on_device));
   file_name_ = file_name;
 }
 #ifndef DISABLE_CUDF
@@ -27,10 +27,11 @@ DataReaderWorkerRaw<T>::DataReaderWorkerRaw(const int worker_id, const int worke
                                             std::shared_ptr<MmapOffsetList>& file_offset_list,
                                             bool repeat,
                                             const std::vector<DataReaderSparseParam>& params,
-                                            bool float_label_dense)
+                                            bool float_label_dense, bool parse_on_device)
     : IDataReaderWorker(worker_id, worker_num, gpu_resource, !repeat, loop_flag, buffer),
       params_(params),
       float_label_dense_(float_label_dense),
+      parse_on_device_(parse_on_device),
       total_slot_num_(0),
       last_batch_nnz_(params.size(), 0) {
   CudaCPUDeviceContext ctx(gpu_resource->get_device_id());
@@ -47,6 +48,23 @@ DataReaderWorkerRaw<T>::DataReaderWorkerRaw(const int worker_id, const int worke
   int label_dim = buffer->label_dim;
   int dense_dim = buffer->dense_dim;
 
+  for (auto& param : params) {
+    total_slot_num_ += param.slot_num;
+  }
+
+  if (parse_on_device_) {
+    // The samples are copied as they are in the file and split on the device
+    int64_t sample_length = total_slot_num_ * sizeof(int) + (label_dim + dense_dim) * sizeof(int);
+    device_sample_buffer_ = core23::Tensor(
+        core23::TensorParams()
+            .data_type(core23::ScalarType::Char)
+            .shape({batch_size * sample_length})
+            .device({core23::DeviceType::GPU, static_cast<int8_t>(gpu_resource->get_device_id())}));
+    // allocate eagerly
+    device_sample_buffer_.data();
+    return;
+  }
+
   core23::TensorParams common_tensor_params =
       core23::TensorParams().device(core23::DeviceType::CPU);
   host_dense_buffer_ =
@@ -58,10 +76,6 @@ DataReaderWorkerRaw<T>::DataReaderWorkerRaw(const int worker_id, const int worke
     host_sparse_buffer_.emplace_back(batch_size * param.slot_num,
                                      batch_size * param.max_feature_num);
   }
-
-  for (auto& param : params) {
-    total_slot_num_ += param.slot_num;
-  }
 }
 
 template <typename T>
@@ -101,6 +115,25 @@ void DataReaderWorkerRaw<T>::read_a_batch() {
   size_t label_dense_length = label_dense_dim * (float_label_dense_ ? sizeof(float) : sizeof(int));
   size_t sample_length = total_slot_num_ * sizeof(int) + label_dense_length;
 
+  if (parse_on_device_) {
+    CudaCPUDeviceContext context(gpu_resource_->get_device_id());
+    HCTR_LIB_THROW(cudaMemcpyAsync(device_sample_buffer_.data(), data_buffer,
+                                   current_batchsize * sample_length, cudaMemcpyHostToDevice,
+                                   gpu_resource_->get_memcpy_stream()));
+
+    if (!wait_until_h2d_ready()) return;
+    buffer23_->current_batch_size = current_batchsize;
+    parse_raw_batch<T>(device_sample_buffer_, current_batchsize, buffer23_->batch_size, label_dim,
+                       dense_dim, float_label_dense_, batch_size_start_idx, batch_size_end_idx,
+                       params_, buffer23_->device_dense_buffers, buffer23_->device_sparse_buffers,
+                       gpu_resource_->get_memcpy_stream());
+    HCTR_LIB_THROW(cudaStreamSynchronize(gpu_resource_->get_memcpy_stream()));
+
+    assert(buffer23_->state.load() == BufferState::Writing);
+    buffer23_->state.store(BufferState::ReadyForRead);
+    return;
+  }
+
   for (auto& each_csr : host_sparse_buffer_) {
     each_csr.reset();
   }
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <common.hpp>
+#include <data_readers/data_reader_worker_raw.hpp>
+
+namespace HugeCTR {
+
+namespace {
+
+// A sample is label_dense_dim label and dense features followed by one int key per slot, all of
+// them 4 bytes.
+__global__ void parse_raw_label_dense_kernel(const int* samples, int sample_items,
+                                             long long current_batch_size, int label_dim,
+                                             int label_dense_dim, bool float_label_dense,
+                                             int batch_size_start_idx, int num_local_samples,
+                                             float* label_dense) {
+  int idx = blockDim.x * blockIdx.x + threadIdx.x;
+  if (idx < num_local_samples * label_dense_dim) {
+    const int sample = batch_size_start_idx + idx / label_dense_dim;
+    const int col = idx % label_dense_dim;
+    float val = 0.f;
+    if (sample < current_batch_size) {
+      const int item = samples[static_cast<int64_t>(sample) * sample_items + col];
+      if (float_label_dense) {
+        val = __int_as_float(item);
+      } else {
+        // the int dense features are preprocessed like on the host
+        val = col < label_dim ? static_cast<float>(item) : logf(item + 1.f);
+      }
+    }
+    label_dense[idx] = val;
+  }
+}
+
+template <typename T>
+__global__ void parse_raw_sparse_kernel(const int* samples, int sample_items,
+                                        long long current_batch_size, int batch_size,
+                                        int key_offset, int slot_num, T* values, T* row_offsets) {
+  int idx = blockDim.x * blockIdx.x + threadIdx.x;
+  const int num_rows = batch_size * slot_num;
+  const int num_values = static_cast<int>(current_batch_size) * slot_num;
+  if (idx <= num_rows) {
+    // every slot of a Raw sample has exactly one key
+    row_offsets[idx] = static_cast<T>(min(idx, num_values));
+  }
+  if (idx < num_values) {
+    const int sample = idx / slot_num;
+    const int slot = idx % slot_num;
+    values[idx] =
+        static_cast<T>(samples[static_cast<int64_t>(sample) * sample_items + key_offset + slot]);
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void parse_raw_batch(const core23::Tensor& samples, long long current_batch_size, int batch_size,
+                     int label_dim, int dense_dim, bool float_label_dense,
+                     int batch_size_start_idx, int batch_size_end_idx,
+                     const std::vector<DataReaderSparseParam>& params, core23::Tensor& label_dense,
+                     std::vector<SparseTensor23>& sparse_tensors, cudaStream_t stream) {
+  const int label_dense_dim = label_dim + dense_dim;
+  int total_slot_num = 0;
+  for (auto& param : params) {
+    total_slot_num += param.slot_num;
+  }
+  const int sample_items = label_dense_dim + total_slot_num;
+  const int* samples_ptr = samples.data<int>();
+  const int num_local_samples = batch_size_end_idx - batch_size_start_idx;
+
+  const int BLOCK_DIM = 256;
+  if (num_local_samples * label_dense_dim > 0) {
+    const int GRID_DIM = (num_local_samples * label_dense_dim - 1) / BLOCK_DIM + 1;
+    parse_raw_label_dense_kernel<<<GRID_DIM, BLOCK_DIM, 0, stream>>>(
+        samples_ptr, sample_items, current_batch_size, label_dim, label_dense_dim,
+        float_label_dense, batch_size_start_idx, num_local_samples, label_dense.data<float>());
+  }
+
+  int key_offset = label_dense_dim;
+  for (size_t param_id = 0; param_id < params.size(); ++param_id) {
+    const int slot_num = params[param_id].slot_num;
+    auto& sparse_tensor = sparse_tensors[param_id];
+    const int GRID_DIM = batch_size * slot_num / BLOCK_DIM + 1;
+    parse_raw_sparse_kernel<<<GRID_DIM, BLOCK_DIM, 0, stream>>>(
+        samples_ptr, sample_items, current_batch_size, batch_size, key_offset, slot_num,
+        static_cast<T*>(sparse_tensor.get_value_ptr()),
+        static_cast<T*>(sparse_tensor.get_rowoffset_ptr()));
+    *sparse_tensor.get_nnz_ptr() = current_batch_size * slot_num;
+    key_offset += slot_num;
+  }
+}
+
+template void parse_raw_batch<uint32_t>(const core23::Tensor& samples,
+                                        long long current_batch_size, int batch_size,
+                                        int label_dim, int dense_dim, bool float_label_dense,
+                                        int batch_size_start_idx, int batch_size_end_idx,
+                                        const std::vector<DataReaderSparseParam>& params,
+                                        core23::Tensor& label_dense,
+                                        std::vector<SparseTensor23>& sparse_tensors,
+                                        cudaStream_t stream);
+template void parse_raw_batch<long long>(const core23::Tensor& samples,
+                                         long long current_batch_size, int batch_size,
+                                         int label_dim, int dense_dim, bool float_label_dense,
+                                         int batch_size_start_idx, int batch_size_end_idx,
+                                         const std::vector<DataReaderSparseParam>& params,
+                                         core23::Tensor& label_dense,
+                                         std::vector<SparseTensor23>& sparse_tensors,
+                                         cudaStream_t stream);
+
+}  // namespace HugeCTR
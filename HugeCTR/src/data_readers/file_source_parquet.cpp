@@ -20,13 +20,43 @@ namespace HugeCTR {
 using namespace cudf;
 namespace cudf_io = cudf::io;
 
-ParquetFileSource::ParquetFileSource(unsigned int worker_id, unsigned int stride,
-                                     const std::string& file_list, bool sequtial_file_consumption,
+namespace {
+
+/**
+ * Serves cuDF the byte ranges it asks for, i.e., the footer and the column chunks of the
+ * requested row groups and columns, straight from the file system instead of loading the whole
+ * file to CPU memory first.
+ */
+class RangeDataSource : public cudf_io::datasource {
+ public:
+  RangeDataSource(FileLoader* file_loader) : file_loader_(file_loader) {}
+
+  std::unique_ptr<buffer> host_read(size_t offset, size_t size) override {
+    std::vector<uint8_t> data(size);
+    data.resize(host_read(offset, size, data.data()));
+    return buffer::create(std::move(data));
+  }
+
+  size_t host_read(size_t offset, size_t size, uint8_t* dst) override {
+    long long bytes_read = file_loader_->read(reinterpret_cast<char*>(dst), size, offset);
+    if (bytes_read < 0) {
+      HCTR_OWN_THROW(Error_t::BrokenFile, "failed to read a file");
+    }
+    return bytes_read;
+  }
+
+  size_t size() const override { return file_loader_->get_current_file_size(); }
+
+ private:
+  FileLoader* file_loader_;
+};
+
+}  // namespace
+
+ParquetFileSource::ParquetFileSource(unsigned int worker_id, const std::string& file_list,
                                      bool repeat, const DataSourceParams& data_source_params)
     : file_list_(file_list),
-      offset_(worker_id * !(sequtial_file_consumption)),
       worker_id_(worker_id),
-      stride_(stride),
       row_group_offset_(0),
       can_read_file_(false),
       file_metadata_(),
@@ -34,7 +64,7 @@ ParquetFileSource::ParquetFileSource(unsigned int worker_id, unsigned int stride
       curr_row_group_(0),
       num_row_groups_(0),
       repeat_(repeat),
-      sequential_file_consumption_(sequtial_file_consumption) {
+      prefetch_depth_(data_source_params.prefetch_depth) {
   slice_stream_ = NULL;
   file_loader_ = std::make_unique<FileLoader>(data_source_params);
   // load _metadata.json
@@ -43,16 +73,10 @@ ParquetFileSource::ParquetFileSource(unsigned int worker_id, unsigned int stride
     file_metadata_.get_parquet_metadata(metadata_file_name);
     rows_file_offset_ = std::move(file_metadata_.get_rows_file_offset());
   }
-
-  if (file_list_.get_num_of_files() < stride_ && !sequtial_file_consumption) {
-    HCTR_LOG(WARNING, ROOT,
-             "The number of data reader workers should be no greater than the "
-             "number of files in "
-             "concurrent mode \n");
-  }
 }
 
 ParquetFileSource::~ParquetFileSource() {
+  drop_prefetch();
   cudaStreamDestroy(slice_stream_);
   slice_stream_ = NULL;
   file_loader_->clean();
@@ -68,13 +92,8 @@ Error_t ParquetFileSource::read(char* ptr, size_t bytes_to_read) { return Error_
 Error_t ParquetFileSource::find_next_file_and_group(long long expected_num_row_group) noexcept {
 #ifdef ENABLE_ARROW_PARQUET
   while (expected_num_row_group > 0) {
-    if (sequential_file_consumption_) {
-      // counter_ % num_files = file_id
-      file_name_ = file_list_.get_a_file_with_id(counter_, repeat_);
-    } else {
-      // (offset_ + counter_ * stride_) % num_files = file_id
-      file_name_ = file_list_.get_a_file_with_id(offset_ + counter_ * stride_, repeat_);
-    }
+    // counter_ % num_files = file_id
+    file_name_ = file_list_.get_a_file_with_id(counter_, repeat_);
     counter_++;  // counter_ should be accum for every source.
     if (file_name_.empty()) {
       return Error_t::EndOfFile;
@@ -109,7 +128,11 @@ Error_t ParquetFileSource::find_next_file_and_group(long long expected_num_row_g
 // counter_ always points to next file name
 Error_t ParquetFileSource::next_source(long long expected_num_row_group) noexcept {
   try {
+    drop_prefetch();
     file_loader_->clean();
+    if (can_read_file_) {
+      file_loader_->release(file_name_);
+    }
     can_read_file_ = false;
     auto res = this->find_next_file_and_group(expected_num_row_group);
     if (res == Error_t::EndOfFile) {
@@ -119,12 +142,27 @@ Error_t ParquetFileSource::next_source(long long expected_num_row_group) noexcep
       HCTR_OWN_THROW(res, "Library Dependency Error. Rebuild with Arrow::Parquet Library");
     }
     // check if file exists
-    Error_t err = file_loader_->load(file_name_);
+    Error_t err = file_loader_->open(file_name_);
     if (err != Error_t::Success) {
       return err;
     }
-    parquet_args_ = cudf_io::parquet_reader_options::builder(cudf_io::source_info{
-        file_loader_->get_loaded_data(), file_loader_->get_current_file_size()});
+    // Let a caching file system download this file and the next ones in the background, the
+    // reads of this file go to the remote file system until it is cached.
+    std::vector<std::string> file_names{file_name_};
+    for (long long i = 0; i < prefetch_depth_; i++) {
+      const std::string next_file_name = file_list_.get_a_file_with_id(counter_ + i, repeat_);
+      if (next_file_name.empty()) {
+        break;
+      }
+      file_names.push_back(next_file_name);
+    }
+    file_loader_->prefetch(file_names);
+    datasource_ = std::make_unique<RangeDataSource>(file_loader_.get());
+    parquet_args_ =
+        cudf_io::parquet_reader_options::builder(cudf_io::source_info{datasource_.get()});
+    if (!columns_.empty()) {
+      parquet_args_.set_columns(columns_);
+    }
     curr_row_idx_ = 0;  // set row to zero id
     row_group_index_ = 0;
     row_group_offset_ = 0;
@@ -146,26 +184,22 @@ cudf_io::table_with_metadata ParquetFileSource::read_group(size_t row_group_id,
       HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
     }
   }
-  cudf_io::table_with_metadata x;
   curr_row_idx_ = 0;
   curr_row_group_ = row_group_id;
-  std::vector<cudf::size_type> row_list = {curr_row_group_};
-  std::vector<std::vector<cudf::size_type>> rgrps = {row_list};
-  parquet_args_.set_row_groups(rgrps);
-  parquet_args_.set_num_rows(-1);
-  parquet_args_.set_timestamp_type(cudf::data_type(cudf::type_id::EMPTY));
-  auto tbl_w_metadata = cudf_io::read_parquet(parquet_args_, mr);
+  cudf_io::table_with_metadata tbl_w_metadata;
+  if (prefetched_table_.valid() && prefetched_row_group_ == curr_row_group_) {
+    tbl_w_metadata = prefetched_table_.get();
+    prefetched_row_group_ = -1;
+  } else {
+    drop_prefetch();
+    tbl_w_metadata = read_table(curr_row_group_, mr);
+  }
 
   if (!counter_) {
     HCTR_OWN_THROW(Error_t::UnspecificError, "Read parquet file first\n");
   }
-  if (sequential_file_consumption_) {
-    // counter_ % num_files = file_id
-    file_name_ = file_list_.get_a_file_with_id(counter_ - 1, repeat_);
-  } else {
-    // (offset_ + counter_ * stride_) % num_files = file_id
-    file_name_ = file_list_.get_a_file_with_id(offset_ + (counter_ - 1) * stride_, repeat_);
-  }
+  // counter_ % num_files = file_id
+  file_name_ = file_list_.get_a_file_with_id(counter_ - 1, repeat_);
   // Must have Parquet library
   std::vector<long long> row_groups_offset =
       file_metadata_.get_file_stats(get_filename(file_name_)).row_groups_offset;
@@ -178,15 +212,58 @@ cudf_io::table_with_metadata ParquetFileSource::read_group(size_t row_group_id,
   return tbl_w_metadata;
 }
 
+cudf_io::table_with_metadata ParquetFileSource::read_table(int row_group_id,
+                                                           rmm::mr::device_memory_resource* mr) {
+  // A copy, so that a prefetch does not race with the options of the next read
+  cudf_io::parquet_reader_options parquet_args = parquet_args_;
+  std::vector<std::vector<cudf::size_type>> rgrps = {{row_group_id}};
+  parquet_args.set_row_groups(rgrps);
+  parquet_args.set_num_rows(-1);
+  parquet_args.set_timestamp_type(cudf::data_type(cudf::type_id::EMPTY));
+  return cudf_io::read_parquet(parquet_args, mr);
+}
+
+void ParquetFileSource::prefetch_group(size_t row_group_id, rmm::mr::device_memory_resource* mr) {
+  drop_prefetch();
+  if (!can_read_file_ || static_cast<int>(row_group_id) >= num_row_groups_) {
+    return;
+  }
+  int device_id;
+  HCTR_LIB_THROW(cudaGetDevice(&device_id));
+  prefetched_row_group_ = row_group_id;
+  prefetched_table_ = std::async(std::launch::async, [this, row_group_id, mr, device_id] {
+    CudaDeviceContext ctx(device_id);
+    return read_table(row_group_id, mr);
+  });
+}
+
+void ParquetFileSource::drop_prefetch() {
+  if (prefetched_table_.valid()) {
+    try {
+      prefetched_table_.get();
+    } catch (const std::exception& err) {
+      // read again, and report, by the next read_group()
+    }
+  }
+  prefetched_row_group_ = -1;
+}
+
+void ParquetFileSource::set_column_projection(const std::vector<std::string>& names) {
+  if (names == columns_) {
+    return;
+  }
+  drop_prefetch();
+  columns_ = names;
+  if (can_read_file_) {
+    parquet_args_.set_columns(columns_);
+  }
+}
+
 const Metadata& ParquetFileSource::get_file_metadata() { return file_metadata_; }
 int ParquetFileSource::get_cur_file_id() {
   // counter_ always points to the next file to be read
   int num_files = file_list_.get_num_of_files();
-  if (sequential_file_consumption_) {
-    return (counter_ - 1) % num_files;
-  } else {
-    return offset_ + (counter_ - 1) * stride_ % num_files;
-  }
+  return (counter_ - 1) % num_files;
 }
 bool ParquetFileSource::reach_eof() { return curr_row_idx_ >= file_total_rows_; }
 bool ParquetFileSource::row_group_eof() {
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <cmath>
 #include <common.hpp>
 #include <core23/tensor.hpp>
 #include <data_reader.hpp>
@@ -21,6 +23,8 @@
 #include <data_readers/async_reader/async_reader_common.hpp>
 #include <data_readers/multi_hot/async_data_reader.hpp>
 #include <data_readers/multi_hot/split_batch.hpp>
+#include <data_readers/multi_hot/synthetic_batch.hpp>
+#include <data_readers/multi_hot/variable_length_format.hpp>
 #include <inference/preallocated_buffer2.hpp>
 #include <resource_manager.hpp>
 #include <tensor2.hpp>
@@ -33,7 +37,11 @@ AsyncDataReader<SparseType>::AsyncDataReader(
     std::vector<FileSource> data_files, const std::shared_ptr<ResourceManager>& resource_manager,
     size_t batch_size, size_t num_threads_per_file, size_t num_batches_per_thread,
     const std::vector<DataReaderSparseParam>& params, size_t label_dim, size_t dense_dim,
-    bool mixed_precision, bool shuffle, bool schedule_uploads, bool is_dense_float)
+    bool mixed_precision, bool shuffle, bool schedule_uploads, bool is_dense_float,
+    IOBackend_t io_backend, size_t shuffle_block_size, bool variable_length,
+    DataCache_t data_cache, bool compressed, const std::vector<DataTransformParam>& transforms,
+    const std::optional<SyntheticDataParam>& synthetic, const std::string& key_profile_file,
+    bool int64_file_keys)
     : resource_manager_(resource_manager),
       mixed_precision_(mixed_precision),
       batch_size_(batch_size),
@@ -45,7 +53,13 @@ AsyncDataReader<SparseType>::AsyncDataReader(
       s3w_streams_(resource_manager->get_local_gpu_count()),
       d2d_streams_(resource_manager->get_local_gpu_count()),
       cache_buffers_(false),
-      is_dense_float_(is_dense_float) {
+      is_dense_float_(is_dense_float),
+      int64_file_keys_(int64_file_keys && sizeof(SparseType) != sizeof(long long)),
+      variable_length_(variable_length),
+      data_cache_(data_cache),
+      shuffle_(shuffle),
+      synthetic_(synthetic.has_value()),
+      key_profile_file_(key_profile_file) {
   assert(batch_size_ % resource_manager_->get_global_gpu_count() == 0);
   assert(params.size() == 1);
   static_assert(sizeof(LabelType) == sizeof(InputType));
@@ -69,18 +83,43 @@ AsyncDataReader<SparseType>::AsyncDataReader(
 
   size_t sparse_dim = params[0].slot_num;
 
+  const size_t file_key_bytes = int64_file_keys_ ? sizeof(long long) : sizeof(SparseType);
   sample_size_items_ = label_dim + dense_dim +
-                       static_cast<int64_t>(total_nnz_) * (sizeof(SparseType) / sizeof(InputType));
+                       static_cast<int64_t>(total_nnz_) * (file_key_bytes / sizeof(InputType));
 
   label_dim_ = label_dim;
   dense_dim_ = dense_dim_align8;
   sparse_dim_ = sparse_dim;
 
+  if (synthetic_ && (compressed || variable_length_ || data_cache_ != DataCache_t::Off)) {
+    throw std::invalid_argument(
+        "Synthetic data cannot be compressed, variable-length or cached, there are no files");
+  }
+  if (int64_file_keys_ && (synthetic_ || variable_length_)) {
+    throw std::invalid_argument(
+        "Only the keys of fixed-length files can be narrowed to 32 bits by the split");
+  }
   data_files[0].sample_size_bytes = sample_size_items_ * sizeof(InputType);
+  data_files[0].compressed = compressed;
+  if (compressed && variable_length_) {
+    throw std::invalid_argument("Variable-length files cannot be chunk-compressed");
+  }
+  if (variable_length_) {
+    const VarLenFileFooter footer = read_var_len_footer(data_files[0].name);
+    if (footer.label_dim != label_dim || footer.dense_dim != dense_dim ||
+        footer.num_slots != sparse_dim || footer.key_bytes != sizeof(SparseType)) {
+      throw std::invalid_argument("The layout of " + data_files[0].name +
+                                  " does not match the label, dense and sparse params");
+    }
+    data_files[0].variable_length = true;
+    samples_per_record_ = footer.samples_per_record;
+  }
 
-  reader_impl_.reset(new DataReaderImpl(data_files, resource_manager, batch_size,
-                                        num_threads_per_file, num_batches_per_thread, shuffle,
-                                        schedule_uploads));
+  if (!synthetic_) {
+    reader_impl_.reset(new DataReaderImpl(data_files, resource_manager, batch_size,
+                                          num_threads_per_file, num_batches_per_thread, shuffle,
+                                          schedule_uploads, io_backend, shuffle_block_size));
+  }
 
   for (size_t i = 0; i < resource_manager_->get_local_gpu_count(); i++) {
     auto local_gpu = resource_manager_->get_local_gpu(i);
@@ -121,6 +160,17 @@ AsyncDataReader<SparseType>::AsyncDataReader(
     bucket_position_tensors_.emplace_back(bucket_position_tensor);
     max_hotness_tensors_.emplace_back(max_hotness_tensor);
 
+    if (variable_length_) {
+      const int64_t num_records =
+          (batch_size_per_dev_ + samples_per_record_ - 1) / samples_per_record_;
+      record_scratch_tensors_.emplace_back(
+          core23::TensorParams()
+              .shape({num_records * static_cast<int64_t>(sparse_dim_ + 1) +
+                      static_cast<int64_t>(sparse_dim_)})
+              .data_type(core23::ScalarType::UInt64)
+              .device({core23::DeviceType::GPU, static_cast<int8_t>(gpu_id)}));
+    }
+
     // set default stream
     s3w_streams_[i] = local_gpu->get_stream();
     d2d_streams_[i] = local_gpu->get_stream();
@@ -156,6 +206,256 @@ AsyncDataReader<SparseType>::AsyncDataReader(
   }
 
   set_tensor_buffering(1);
+  init_transforms(transforms);
+  init_data_cache();
+  if (synthetic_) {
+    init_synthetic(*synthetic);
+  }
+  if (!key_profile_file_.empty()) {
+    // The keys past the hotness of a variable-length sample are padding
+    if (variable_length_) {
+      throw std::invalid_argument("The keys of variable-length files cannot be profiled");
+    }
+    for (size_t i = 0; i < resource_manager_->get_local_gpu_count(); i++) {
+      key_sketches_.emplace_back(std::make_unique<KeyFrequencySketch<SparseType>>(
+          sparse_dim_, resource_manager_->get_local_gpu(i)->get_device_id()));
+    }
+    HCTR_LOG_S(INFO, ROOT) << "Multi-Hot AsyncDataReader: key frequency profile to "
+                           << key_profile_file_ << std::endl;
+  }
+}
+
+template <typename SparseType>
+void AsyncDataReader<SparseType>::write_key_profile() const {
+  auto merged = key_sketches_[0]->to_host();
+  for (size_t i = 1; i < key_sketches_.size(); i++) {
+    merged.merge(key_sketches_[i]->to_host());
+  }
+  // Every process profiles the batches of its GPUs
+  std::string path = key_profile_file_;
+  if (resource_manager_->get_num_process() > 1) {
+    path += "." + std::to_string(resource_manager_->get_process_id());
+  }
+  constexpr size_t top_k = 1000;
+  HugeCTR::write_key_profile(path, merged.profile(top_k));
+  HCTR_LOG_S(INFO, WORLD) << "Multi-Hot AsyncDataReader: key frequency profile written to "
+                          << path << std::endl;
+}
+
+template <typename SparseType>
+void AsyncDataReader<SparseType>::init_synthetic(const SyntheticDataParam& synthetic) {
+  if (synthetic.slot_size_array.size() != sparse_dim_) {
+    throw std::invalid_argument("Synthetic data needs the vocabulary size of each of the " +
+                                std::to_string(sparse_dim_) + " slots, got " +
+                                std::to_string(synthetic.slot_size_array.size()));
+  }
+  if (!(synthetic.unique_key_ratio > 0.f && synthetic.unique_key_ratio <= 1.f)) {
+    throw std::invalid_argument("The unique_key_ratio of synthetic data should be in (0, 1]");
+  }
+  synthetic_alpha_ = synthetic.get_alpha();
+  if (synthetic.distribution == Distribution_t::PowerLaw && !(synthetic_alpha_ > 0.f)) {
+    throw std::invalid_argument("The alpha of a power law should be > 0");
+  }
+  synthetic_seed_ = synthetic.seed != 0
+                        ? synthetic.seed
+                        : resource_manager_->get_local_cpu()->get_replica_uniform_seed();
+
+  // [pool sizes | vocabulary sizes | strides]
+  std::vector<long long> slot_key_params(3 * sparse_dim_);
+  for (size_t slot = 0; slot < sparse_dim_; ++slot) {
+    const long long vocabulary_size = synthetic.slot_size_array[slot];
+    if (vocabulary_size <= 0) {
+      throw std::invalid_argument("The vocabulary size of slot " + std::to_string(slot) +
+                                  " should be > 0");
+    }
+    const double keys_per_batch = static_cast<double>(batch_size_) * nnz_per_slot_[slot];
+    const auto pool_size =
+        static_cast<long long>(std::ceil(synthetic.unique_key_ratio * keys_per_batch));
+    slot_key_params[slot] = std::clamp(pool_size, 1ll, vocabulary_size);
+    slot_key_params[sparse_dim_ + slot] = vocabulary_size;
+    slot_key_params[2 * sparse_dim_ + slot] = synthetic_key_stride(vocabulary_size);
+  }
+
+  for (size_t i = 0; i < resource_manager_->get_local_gpu_count(); i++) {
+    auto gpu_id = resource_manager_->get_local_gpu(i)->get_device_id();
+    CudaDeviceContext ctx(gpu_id);
+    synthetic_batch_tensors_.emplace_back(
+        core23::TensorParams()
+            .shape({static_cast<int64_t>(batch_size_per_dev_),
+                    static_cast<int64_t>(sample_size_items_)})
+            .data_type(core23::ToScalarType<InputType>::value)
+            .device({core23::DeviceType::GPU, static_cast<int8_t>(gpu_id)}));
+    synthetic_key_tensors_.emplace_back(
+        core23::TensorParams()
+            .shape({static_cast<int64_t>(slot_key_params.size())})
+            .data_type(core23::ScalarType::LongLong)
+            .device({core23::DeviceType::GPU, static_cast<int8_t>(gpu_id)}));
+    HCTR_LIB_THROW(cudaMemcpy(synthetic_key_tensors_.back().data(), slot_key_params.data(),
+                              synthetic_key_tensors_.back().num_bytes(), cudaMemcpyHostToDevice));
+  }
+  HCTR_LOG_S(INFO, ROOT) << "Multi-Hot AsyncDataReader: synthetic data, "
+                         << (synthetic_alpha_ == 0.f
+                                 ? std::string("uniform")
+                                 : "power law alpha = " + std::to_string(synthetic_alpha_))
+                         << ", unique_key_ratio = " << synthetic.unique_key_ratio << std::endl;
+}
+
+template <typename SparseType>
+void AsyncDataReader<SparseType>::init_transforms(
+    const std::vector<DataTransformParam>& transforms) {
+  const size_t num_local_gpus = resource_manager_->get_local_gpu_count();
+  split_transforms_.assign(num_local_gpus, SplitTransforms());
+  if (transforms.empty()) {
+    return;
+  }
+
+  std::vector<int> dense_ops(dense_dim_, -1);
+  std::vector<std::vector<float>> dense_boundaries(dense_dim_);
+  std::vector<long long> key_modulo(sparse_dim_, 0);
+  for (const auto& transform : transforms) {
+    if (transform.type == DataTransform_t::Modulo) {
+      if (transform.index < 0 || static_cast<size_t>(transform.index) >= sparse_dim_) {
+        throw std::invalid_argument("Modulo transform of slot " + std::to_string(transform.index) +
+                                    ", there are " + std::to_string(sparse_dim_) + " slots");
+      }
+      if (transform.modulo <= 0) {
+        throw std::invalid_argument("The modulo of slot " + std::to_string(transform.index) +
+                                    " should be > 0");
+      }
+      if (key_modulo[transform.index] != 0) {
+        throw std::invalid_argument("Slot " + std::to_string(transform.index) +
+                                    " has more than one transform");
+      }
+      key_modulo[transform.index] = transform.modulo;
+      continue;
+    }
+
+    if (transform.index < 0 || static_cast<size_t>(transform.index) >= dense_dim_) {
+      throw std::invalid_argument("Transform of dense feature " + std::to_string(transform.index) +
+                                  ", there are " + std::to_string(dense_dim_) + " dense features");
+    }
+    if (dense_ops[transform.index] != -1) {
+      throw std::invalid_argument("Dense feature " + std::to_string(transform.index) +
+                                  " has more than one transform");
+    }
+    if (transform.type == DataTransform_t::Log1p && !is_dense_float_) {
+      throw std::invalid_argument(
+          "Log1p transform of int dense features, they are already log(1 + x) transformed");
+    }
+    if (transform.type == DataTransform_t::Bucketize &&
+        (transform.boundaries.empty() ||
+         !std::is_sorted(transform.boundaries.begin(), transform.boundaries.end()))) {
+      throw std::invalid_argument("The boundaries of dense feature " +
+                                  std::to_string(transform.index) +
+                                  " should be sorted and not empty");
+    }
+    dense_ops[transform.index] = static_cast<int>(transform.type);
+    dense_boundaries[transform.index] = transform.boundaries;
+  }
+
+  std::vector<int> boundary_offsets(1, 0);
+  std::vector<float> boundaries;
+  for (const auto& feature_boundaries : dense_boundaries) {
+    boundaries.insert(boundaries.end(), feature_boundaries.begin(), feature_boundaries.end());
+    boundary_offsets.push_back(static_cast<int>(boundaries.size()));
+  }
+  boundaries.resize(std::max<size_t>(boundaries.size(), 1));
+
+  for (size_t i = 0; i < num_local_gpus; i++) {
+    auto gpu_id = resource_manager_->get_local_gpu(i)->get_device_id();
+    CudaDeviceContext ctx(gpu_id);
+    auto make_tensor = [&](const auto& h_vec, core23::ScalarType type) {
+      core23::Tensor tensor(core23::TensorParams()
+                                .shape({static_cast<int64_t>(h_vec.size())})
+                                .data_type(type)
+                                .device({core23::DeviceType::GPU, static_cast<int8_t>(gpu_id)}));
+      HCTR_LIB_THROW(cudaMemcpy(tensor.data(), h_vec.data(), tensor.num_bytes(),
+                                cudaMemcpyHostToDevice));
+      transform_tensors_.push_back(tensor);
+      return tensor;
+    };
+    split_transforms_[i].dense_ops = make_tensor(dense_ops, core23::ScalarType::Int32).data<int>();
+    split_transforms_[i].boundary_offsets =
+        make_tensor(boundary_offsets, core23::ScalarType::Int32).data<int>();
+    split_transforms_[i].boundaries =
+        make_tensor(boundaries, core23::ScalarType::Float).data<float>();
+    split_transforms_[i].key_modulo =
+        make_tensor(key_modulo, core23::ScalarType::LongLong).data<long long>();
+  }
+  HCTR_LOG_S(INFO, ROOT) << "Multi-Hot AsyncDataReader: " << transforms.size()
+                         << " transforms applied by the split kernels" << std::endl;
+}
+
+template <typename SparseType>
+void AsyncDataReader<SparseType>::init_data_cache() {
+  if (data_cache_ == DataCache_t::Off) {
+    return;
+  }
+  const size_t num_batches = reader_impl_->get_total_batches();
+  const size_t num_local_gpus = resource_manager_->get_local_gpu_count();
+  // Keeps every cached batch as aligned as the buffers of the reader
+  cache_pitch_bytes_ = round_up<size_t>(reader_impl_->get_local_batch_size_bytes(0), 256);
+  cache_batch_sizes_.resize(num_batches);
+  cache_local_batch_sizes_.assign(num_local_gpus, std::vector<size_t>(num_batches));
+  cache_local_batch_size_bytes_.assign(num_local_gpus, std::vector<size_t>(num_batches));
+  cache_data_.assign(num_local_gpus, nullptr);
+  cache_staging_.assign(num_local_gpus, nullptr);
+
+  for (size_t i = 0; i < num_local_gpus; i++) {
+    // the host cache is allocated on the numa node of the GPU
+    CudaCPUDeviceContext ctx(resource_manager_->get_local_gpu(i)->get_device_id());
+    cudaError_t err;
+    if (data_cache_ == DataCache_t::Device) {
+      err = cudaMalloc(&cache_data_[i], num_batches * cache_pitch_bytes_);
+    } else {
+      err = cudaMallocHost(&cache_data_[i], num_batches * cache_pitch_bytes_);
+      if (err == cudaSuccess) {
+        err = cudaMalloc(&cache_staging_[i], cache_pitch_bytes_);
+      }
+    }
+    if (err != cudaSuccess) {
+      cudaGetLastError();  // clear the allocation error
+      HCTR_LOG_S(WARNING, WORLD) << "Multi-Hot AsyncDataReader: the "
+                                 << num_batches * cache_pitch_bytes_
+                                 << " bytes of the data cache of GPU " << i
+                                 << " cannot be allocated, reading from the files every epoch"
+                                 << std::endl;
+      free_data_cache();
+      data_cache_ = DataCache_t::Off;
+      return;
+    }
+  }
+}
+
+template <typename SparseType>
+void AsyncDataReader<SparseType>::free_data_cache() {
+  for (size_t i = 0; i < cache_data_.size(); i++) {
+    CudaDeviceContext ctx(resource_manager_->get_local_gpu(i)->get_device_id());
+    if (data_cache_ == DataCache_t::Device) {
+      cudaFree(cache_data_[i]);
+    } else {
+      cudaFreeHost(cache_data_[i]);
+      cudaFree(cache_staging_[i]);
+    }
+  }
+  cache_data_.clear();
+  cache_staging_.clear();
+}
+
+template <typename SparseType>
+size_t AsyncDataReader<SparseType>::next_cached_batch() {
+  if (cache_pos_ == cache_order_.size()) {
+    cache_order_.resize(num_cached_batches_);
+    std::iota(cache_order_.begin(), cache_order_.end(), 0);
+    if (shuffle_) {
+      // Same order on every node
+      std::mt19937 gen(resource_manager_->get_local_cpu()->get_replica_uniform_seed() +
+                       ++cache_epoch_);
+      std::shuffle(cache_order_.begin(), cache_order_.end(), gen);
+    }
+    cache_pos_ = 0;
+  }
+  return cache_order_[cache_pos_++];
 }
 
 template <typename SparseType>
@@ -240,35 +540,80 @@ void AsyncDataReader<SparseType>::init_batch_tensors(size_t num_inflight) {
         *device_sparse_tensors[fea_id].get_nnz_ptr() = batch_size_per_dev_ * hotness;
       }
 
+      // The split writes the CSR offsets of the variable-length samples into the row offsets
+      std::vector<core23::Tensor> device_bucket_ranges;
+      if (variable_length_) {
+        core23::Tensor temp_bucket_range_ptrs(
+            core23::TensorParams()
+                .shape({static_cast<int64_t>(sparse_dim_), 1ll})
+                .data_type(core23::ScalarType::UInt64)
+                .device({core23::DeviceType::GPU, static_cast<int8_t>(gpu_id)}));
+        for (size_t fea_id = 0; fea_id < sparse_dim_; ++fea_id) {
+          auto offset_ptr = device_sparse_tensors[fea_id].get_rowoffset_ptr();
+          device_bucket_ranges.push_back(core23::Tensor::bind(
+              offset_ptr, {static_cast<int64_t>(batch_size_per_dev_ + 1)},
+              core23::ToScalarType<SparseType>::value,
+              core23::Device(core23::DeviceType::GPU, static_cast<int8_t>(gpu_id))));
+          HCTR_LIB_THROW(
+              cudaMemcpy(reinterpret_cast<SparseType**>(temp_bucket_range_ptrs.data()) + fea_id,
+                         &offset_ptr, sizeof(SparseType*), cudaMemcpyHostToDevice));
+        }
+        batch_tensors.sparse_bucket_range_ptrs.emplace_back(temp_bucket_range_ptrs);
+      }
+
       batch_tensors.sparse_tensors.emplace_back(device_sparse_tensors);
       batch_tensors.sparse_tensor_ptrs.emplace_back(temp_sparse_tensor_ptrs);
       batch_tensors.sparse_values.emplace_back(device_values_tensors);
+      batch_tensors.sparse_bucket_ranges.emplace_back(device_bucket_ranges);
     }
   }
   // Needed for get_value_tensors() on construction
   // current_sparse_tensors_ = inflight_batch_tensors_.at(0).sparse_tensors;
   current_sparse_values_ = inflight_batch_tensors_.at(0).sparse_values;
+  current_sparse_bucket_ranges_ = inflight_batch_tensors_.at(0).sparse_bucket_ranges;
 }
 
 template <typename SparseType>
 long long AsyncDataReader<SparseType>::read_a_batch_to_device_delay_release() {
-  const DataReaderImpl::Batch& batch = reader_impl_->get_batch();
-
   const size_t slot_id = 0;  // TODO: multi-hot
+  const size_t num_batches = synthetic_ ? 0 : reader_impl_->get_total_batches();
+
+  if (data_cache_ != DataCache_t::Off && !serve_from_cache_ && num_cached_batches_ == num_batches) {
+    // The first epoch is in the cache, no more file reads
+    reader_impl_->stop();
+    serve_from_cache_ = true;
+  }
+
+  const DataReaderImpl::Batch* batch =
+      serve_from_cache_ || synthetic_ ? nullptr : &reader_impl_->get_batch();
+  const size_t cache_id = serve_from_cache_ ? next_cached_batch() : num_cached_batches_;
+  const bool fill_cache = data_cache_ != DataCache_t::Off && !serve_from_cache_;
+
+  size_t current_batch_id = synthetic_          ? synthetic_step_
+                            : serve_from_cache_ ? cache_id
+                                                : static_cast<size_t>(batch->get_id());
 
   if (cache_buffers_) {
     // TODO: replace with cache policy like LRU when number of batches exceeds what we can store
-    inflight_id_ = batch.get_id();
+    inflight_id_ = current_batch_id;
   } else {
     inflight_id_ = (inflight_id_ + 1) % inflight_batch_tensors_.size();  // FIFO
   }
 
   BatchTensors& batch_tensors = inflight_batch_tensors_.at(inflight_id_);
 
-  size_t current_batch_id = static_cast<size_t>(batch.get_id());
-  current_batch_size_ = batch.get_batch_size_bytes() / (sample_size_items_ * sizeof(InputType));
+  if (synthetic_) {
+    current_batch_size_ = batch_size_;
+  } else if (serve_from_cache_) {
+    current_batch_size_ = cache_batch_sizes_[cache_id];
+  } else {
+    current_batch_size_ =
+        variable_length_ ? batch->get_num_samples()
+                         : batch->get_batch_size_bytes() / (sample_size_items_ * sizeof(InputType));
+  }
   // current_sparse_tensors_ = batch_tensors.sparse_tensors;
   current_sparse_values_ = batch_tensors.sparse_values;
+  current_sparse_bucket_ranges_ = batch_tensors.sparse_bucket_ranges;
   current_batch_cached_ = (current_batch_id == batch_tensors.tag) && cache_buffers_;
 
   int num_local_gpus = resource_manager_->get_local_gpu_count();
@@ -277,53 +622,115 @@ long long AsyncDataReader<SparseType>::read_a_batch_to_device_delay_release() {
     auto local_gpu = resource_manager_->get_local_gpu(i);
     auto gpu_id = local_gpu->get_device_id();
     CudaCPUDeviceContext ctx(gpu_id);
-
     const cudaStream_t& stream = s3w_streams_[i];
 
-    size_t current_batch_size_per_device =
-        batch.get_local_batch_size_bytes(i, slot_id) / (sample_size_items_ * sizeof(InputType));
+    size_t current_batch_size_per_device;
+    size_t local_batch_size_bytes;
+    uint8_t* data;
+    uint8_t* cache_data =
+        cache_data_.empty() ? nullptr : cache_data_[i] + cache_id * cache_pitch_bytes_;
+    if (synthetic_) {
+      current_batch_size_per_device = batch_size_per_dev_;
+      local_batch_size_bytes = synthetic_batch_tensors_[i].num_bytes();
+      data = synthetic_batch_tensors_[i].data<uint8_t>();
+    } else if (serve_from_cache_) {
+      current_batch_size_per_device = cache_local_batch_sizes_[i][cache_id];
+      local_batch_size_bytes = cache_local_batch_size_bytes_[i][cache_id];
+      data = data_cache_ == DataCache_t::Device ? cache_data : cache_staging_[i];
+    } else {
+      local_batch_size_bytes = batch->get_local_batch_size_bytes(i, slot_id);
+      current_batch_size_per_device =
+          variable_length_ ? batch->get_local_num_samples(i, slot_id)
+                           : local_batch_size_bytes / (sample_size_items_ * sizeof(InputType));
+      data = batch->get_device_data(i, slot_id);
+    }
 
     // schedule at correct place in iteration
     HCTR_LIB_THROW(cudaStreamWaitEvent(stream, split_schedule_events_[i]));
 
-    if (!current_batch_cached_) {  // data can be cached for eval
+    if (synthetic_) {
+      // Every GPU and every step draws different samples
+      const size_t global_id = resource_manager_->get_gpu_global_id_from_local_id(i);
+      const uint64_t stream_id =
+          synthetic_step_ * resource_manager_->get_global_gpu_count() + global_id + 1;
+      const uint64_t seed = synthetic_seed_ ^ (stream_id * 0x9e3779b97f4a7c15ull);
+      generate_synthetic_batch<SparseType>(
+          synthetic_batch_tensors_[i], current_batch_size_per_device, label_dim_, dense_dim_,
+          is_dense_float_, bucket_id_tensors_[i], synthetic_key_tensors_[i], synthetic_alpha_,
+          seed, stream);
+    }
+
+    if (serve_from_cache_ && data_cache_ == DataCache_t::Host && local_batch_size_bytes > 0) {
+      HCTR_LIB_THROW(cudaMemcpyAsync(data, cache_data, local_batch_size_bytes,
+                                     cudaMemcpyHostToDevice, stream));
+    }
+
+    if (!current_batch_cached_ && variable_length_) {
+      // Also without local samples, all buckets have to be emptied
+      if (mixed_precision_) {
+        split_3_way_variable_length<__half, SparseType>(
+            batch_tensors.label_tensors[i], batch_tensors.dense_tensors[i],
+            batch_tensors.sparse_tensor_ptrs[i], batch_tensors.sparse_bucket_range_ptrs[i], data,
+            current_batch_size_per_device, samples_per_record_, max_hotness_tensors_[i],
+            record_scratch_tensors_[i], stream, is_dense_float_, split_transforms_[i]);
+      } else {
+        split_3_way_variable_length<float, SparseType>(
+            batch_tensors.label_tensors[i], batch_tensors.dense_tensors[i],
+            batch_tensors.sparse_tensor_ptrs[i], batch_tensors.sparse_bucket_range_ptrs[i], data,
+            current_batch_size_per_device, samples_per_record_, max_hotness_tensors_[i],
+            record_scratch_tensors_[i], stream, is_dense_float_, split_transforms_[i]);
+      }
+    } else if (!current_batch_cached_) {  // data can be cached for eval
 
       // >0 check because when batch is incomplete not all devices may have data-parallel shard
       if (static_cast<int64_t>(current_batch_size_per_device) > 0) {
-        auto ptr_wrap = std::make_shared<RawPtrWrapper>(
-            reinterpret_cast<InputType*>(batch.get_device_data(i, slot_id)));
+        const core23::Tensor samples = core23::Tensor::bind(
+            data,
+            {static_cast<int64_t>(current_batch_size_per_device),
+             static_cast<int64_t>(sample_size_items_)},
+            core23::ToScalarType<InputType>::value,
+            core23::Device(core23::DeviceType::GPU, static_cast<int8_t>(gpu_id)));
 
         if (mixed_precision_) {
           split_3_way_feat_major<__half, SparseType>(
               batch_tensors.label_tensors[i], batch_tensors.dense_tensors[i],
-              batch_tensors.sparse_tensor_ptrs[i],
-              core23::Tensor::bind(
-                  reinterpret_cast<void*>(ptr_wrap->get_ptr()),
-                  {static_cast<int64_t>(current_batch_size_per_device),
-                   static_cast<int64_t>(sample_size_items_)},
-                  core23::ToScalarType<InputType>::value,
-                  core23::Device(core23::DeviceType::GPU, static_cast<int8_t>(gpu_id))),
-              bucket_id_tensors_[i], bucket_position_tensors_[i], max_hotness_tensors_[i], stream,
-              is_dense_float_);
+              batch_tensors.sparse_tensor_ptrs[i], samples, bucket_id_tensors_[i],
+              bucket_position_tensors_[i], max_hotness_tensors_[i], stream, is_dense_float_,
+              split_transforms_[i], int64_file_keys_);
         } else {
           split_3_way_feat_major<float, SparseType>(
               batch_tensors.label_tensors[i], batch_tensors.dense_tensors[i],
-              batch_tensors.sparse_tensor_ptrs[i],
-              core23::Tensor::bind(
-                  reinterpret_cast<void*>(ptr_wrap->get_ptr()),
-                  {static_cast<int64_t>(current_batch_size_per_device),
-                   static_cast<int64_t>(sample_size_items_)},
-                  core23::ToScalarType<InputType>::value,
-                  core23::Device(core23::DeviceType::GPU, static_cast<int8_t>(gpu_id))),
-              bucket_id_tensors_[i], bucket_position_tensors_[i], max_hotness_tensors_[i], stream,
-              is_dense_float_);
+              batch_tensors.sparse_tensor_ptrs[i], samples, bucket_id_tensors_[i],
+              bucket_position_tensors_[i], max_hotness_tensors_[i], stream, is_dense_float_,
+              split_transforms_[i], int64_file_keys_);
         }
       }
     }
 
+    if (fill_cache) {
+      // Before the batch is released below
+      cache_local_batch_sizes_[i][cache_id] = current_batch_size_per_device;
+      cache_local_batch_size_bytes_[i][cache_id] = local_batch_size_bytes;
+      if (local_batch_size_bytes > 0) {
+        HCTR_LIB_THROW(cudaMemcpyAsync(cache_data, data, local_batch_size_bytes,
+                                       data_cache_ == DataCache_t::Device ? cudaMemcpyDeviceToDevice
+                                                                          : cudaMemcpyDeviceToHost,
+                                       stream));
+      }
+    }
+
     auto sparse_ready_event = local_gpu->get_event("sparse_tensors_ready");
     HCTR_LIB_THROW(cudaEventRecord(sparse_ready_event, stream));
 
+    // After the event, the embedding does not wait for the profile
+    if (!key_sketches_.empty() && !current_batch_cached_) {
+      key_sketches_[i]->add(
+          reinterpret_cast<const SparseType* const*>(batch_tensors.sparse_tensor_ptrs[i].data()),
+          max_hotness_tensors_[i].data<int>(),
+          *std::max_element(nnz_per_slot_.begin(), nnz_per_slot_.end()),
+          current_batch_size_per_device, stream);
+    }
+
     auto d2d_stream = d2d_streams_[i];
 
     // Need result from split-3-way
@@ -341,9 +748,18 @@ long long AsyncDataReader<SparseType>::read_a_batch_to_device_delay_release() {
 
     // batch.device_data can be reused. Needs to be called after D2D because cudaStreamAddCallback
     // has latency and will delay execution of D2D.
-    reader_impl_->device_release_last_batch_here(d2d_stream, i);
+    if (!serve_from_cache_ && !synthetic_) {
+      reader_impl_->device_release_last_batch_here(d2d_stream, i);
+    }
   }
 
+  if (fill_cache) {
+    cache_batch_sizes_[cache_id] = current_batch_size_;
+    num_cached_batches_++;
+  }
+  if (synthetic_) {
+    synthetic_step_++;
+  }
   batch_tensors.tag = current_batch_id;
   return current_batch_size_;
 }
@@ -432,22 +848,31 @@ void AsyncDataReader<SparseType>::schedule_d2d_here(cudaStream_t stream, int raw
 
 template <typename SparseType>
 void AsyncDataReader<SparseType>::schedule_here(cudaStream_t stream, int raw_device_id) {
+  if (synthetic_) {
+    return;  // nothing to upload
+  }
   reader_impl_->schedule_upload_here(raw_device_id, stream, false);
 }
 
 template <typename SparseType>
 void AsyncDataReader<SparseType>::schedule_here_graph(cudaStream_t stream, int raw_device_id) {
+  if (synthetic_) {
+    return;
+  }
   reader_impl_->schedule_upload_here(raw_device_id, stream, true);
 }
 
 template <typename SparseType>
 void AsyncDataReader<SparseType>::update_schedule_graph(int raw_device_id) {
+  if (synthetic_) {
+    return;
+  }
   reader_impl_->upload_notify(raw_device_id);
 }
 
 template <typename SparseType>
 size_t AsyncDataReader<SparseType>::get_max_batches_inflight() const {
-  return reader_impl_->get_total_inflight_batches();
+  return synthetic_ ? 1 : reader_impl_->get_total_inflight_batches();
 }
 
 template <typename SparseType>
@@ -489,7 +914,9 @@ bool AsyncDataReader<SparseType>::is_started() const {
 }
 template <typename SparseType>
 void AsyncDataReader<SparseType>::start() {
-  reader_impl_->start();
+  if (!synthetic_) {
+    reader_impl_->start();
+  }
 }
 template <typename SparseType>
 std::vector<core23::Tensor> AsyncDataReader<SparseType>::get_dense_tensor23s() const {
@@ -511,6 +938,11 @@ std::vector<std::vector<core23::Tensor>>& AsyncDataReader<SparseType>::get_curre
   return current_sparse_values_;
 }
 template <typename SparseType>
+std::vector<std::vector<core23::Tensor>>&
+AsyncDataReader<SparseType>::get_current_sparse_bucket_ranges() {
+  return current_sparse_bucket_ranges_;
+}
+template <typename SparseType>
 std::vector<std::vector<SparseTensor<SparseType>>>
 AsyncDataReader<SparseType>::get_value_tensor_buffers() const {
   throw std::runtime_error("Deprecated");
@@ -523,7 +955,8 @@ void AsyncDataReader<SparseType>::create_drwg_norm(std::string file_list, Check_
 template <typename SparseType>
 void AsyncDataReader<SparseType>::create_drwg_raw(std::string file_name, long long num_samples,
                                                   bool float_label_dense, bool data_shuffle,
-                                                  bool start_reading_from_beginning) {}
+                                                  bool start_reading_from_beginning,
+                                                  bool parse_on_device) {}
 #ifndef DISABLE_CUDF
 template <typename SparseType>
 void AsyncDataReader<SparseType>::create_drwg_parquet(std::string file_list,
@@ -538,8 +971,17 @@ void AsyncDataReader<SparseType>::set_source(std::string file_list) {}
 
 template <typename SparseType>
 AsyncDataReader<SparseType>::~AsyncDataReader() {
+  if (!key_sketches_.empty()) {
+    try {
+      write_key_profile();
+    } catch (const std::exception& e) {
+      HCTR_LOG_S(ERROR, WORLD) << "Multi-Hot AsyncDataReader: the key frequency profile cannot be "
+                               << "written: " << e.what() << std::endl;
+    }
+  }
   // Underlying reader mush be destroyed BEFORE the events
   reader_impl_.reset(nullptr);
+  free_data_cache();
   for (auto& e : completion_events_) {
     cudaEventDestroy(e);
   }
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <data_readers/multi_hot/compressed_format.hpp>
+#include <fstream>
+#include <stdexcept>
+
+namespace HugeCTR {
+
+CompressedFileFooter read_compressed_footer(const std::string& file_name) {
+  std::ifstream file(file_name, std::ifstream::binary | std::ifstream::ate);
+  if (!file.is_open()) {
+    throw std::runtime_error("No such file: " + file_name);
+  }
+  const size_t file_size = file.tellg();
+  CompressedFileFooter footer;
+  if (file_size < sizeof(footer)) {
+    throw std::runtime_error(file_name + " is not a chunk-compressed file");
+  }
+  file.seekg(file_size - sizeof(footer));
+  file.read(reinterpret_cast<char*>(&footer), sizeof(footer));
+  if (!file || footer.magic != COMPRESSED_MAGIC) {
+    throw std::runtime_error(file_name + " is not a chunk-compressed file");
+  }
+  return footer;
+}
+
+std::vector<uint64_t> read_compressed_index(const std::string& file_name,
+                                            const CompressedFileFooter& footer) {
+  std::ifstream file(file_name, std::ifstream::binary | std::ifstream::ate);
+  const size_t file_size = file.tellg();
+  std::vector<uint64_t> index(footer.num_chunks + 1);
+  const size_t index_bytes = index.size() * sizeof(uint64_t);
+  if (file_size < sizeof(footer) + index_bytes) {
+    throw std::runtime_error("Truncated index in " + file_name);
+  }
+  file.seekg(file_size - sizeof(footer) - index_bytes);
+  file.read(reinterpret_cast<char*>(index.data()), index_bytes);
+  if (!file || index.back() != file_size - sizeof(footer) - index_bytes) {
+    throw std::runtime_error("Corrupted index in " + file_name);
+  }
+  return index;
+}
+
+}  // namespace HugeCTR
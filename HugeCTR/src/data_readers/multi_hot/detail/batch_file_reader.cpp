@@ -21,11 +21,44 @@
 #include <common.hpp>
 #include <data_readers/multi_hot/detail/aio_context.hpp>
 #include <data_readers/multi_hot/detail/batch_file_reader.hpp>
+#ifdef ENABLE_IO_URING
+#include <data_readers/multi_hot/detail/io_uring_context.hpp>
+#endif
+#ifdef ENABLE_GDS
+#include <data_readers/multi_hot/detail/gds_context.hpp>
+#endif
 
 namespace HugeCTR {
 
+namespace {
+
+IOContext* create_io_context(IOBackend_t io_backend, size_t io_depth) {
+  switch (io_backend) {
+    case IOBackend_t::AIO:
+      return new AIOContext(io_depth);
+#ifdef ENABLE_IO_URING
+    case IOBackend_t::IOUring:
+      return new IOUringContext(io_depth, false);
+    case IOBackend_t::IOUringSQPoll:
+      return new IOUringContext(io_depth, true);
+#endif
+#ifdef ENABLE_GDS
+    case IOBackend_t::GDS:
+      return new GDSContext(io_depth);
+#endif
+    default:
+      HCTR_OWN_THROW(Error_t::WrongInput,
+                     "IO backend is not available, rebuild with -DENABLE_IO_URING=ON for io_uring "
+                     "or -DENABLE_GDS=ON for GDS.");
+  }
+  return nullptr;
+}
+
+}  // namespace
+
 BatchFileReader::BatchFileReader(const std::string& fname, size_t slot, size_t max_batches_inflight,
-                                 std::unique_ptr<IBatchLocations> batch_locations)
+                                 std::unique_ptr<IBatchLocations> batch_locations,
+                                 IOBackend_t io_backend, DeviceBufferFn device_buffers)
     : slot_id_(slot)
       // having multiple IOs in-flight to the same location will break data reader
       ,
@@ -33,27 +66,47 @@ BatchFileReader::BatchFileReader(const std::string& fname, size_t slot, size_t m
       free_batches_(max_batches_inflight_),
       batch_locations_(std::move(batch_locations)),
       batch_locations_iterator_(batch_locations_->begin()),
-      io_ctx_(new AIOContext(max_batches_inflight_)),
-      buf_size_(batch_locations_->get_batch_size_bytes() + io_ctx_->get_alignment()) {
+      io_ctx_(create_io_context(io_backend,
+                                max_batches_inflight_ * batch_locations_->get_max_segments())),
+      device_buffers_(std::move(device_buffers)),
+      max_segments_(batch_locations_->get_max_segments()),
+      buf_size_(batch_locations_->get_batch_size_bytes() +
+                (2 * max_segments_ - 1) * io_ctx_->get_alignment()) {
+  HCTR_CHECK_HINT((io_backend == IOBackend_t::GDS) == static_cast<bool>(device_buffers_),
+                  "GDS reads need the device buffers of the batches.");
   tmp_completed_batches_.reserve(max_batches_inflight_);
   empty_batches_.reserve(max_batches_inflight_);
 
   for (size_t i = 0; i < max_batches_inflight_; ++i) {
-    uint8_t* data = (uint8_t*)numa_alloc_local(
-        buf_size_);  // aligned_alloc(io_ctx_->get_alignment(), buf_size);
-    HCTR_LIB_THROW(cudaHostRegister(data, buf_size_, 0));
+    // With GDS, the destination is only known when a batch is submitted
+    uint8_t* data = nullptr;
+    if (!device_buffers_) {
+      data = (uint8_t*)numa_alloc_local(
+          buf_size_);  // aligned_alloc(io_ctx_->get_alignment(), buf_size);
+      HCTR_LIB_THROW(cudaHostRegister(data, buf_size_, 0));
+    }
 
     batches_.emplace_back(this, data, slot);
+    batches_.back().pieces.reserve(max_segments_);
   }
 
   for (size_t i = 0; i < max_batches_inflight_; ++i) {
     free_batches_.push(batches_.data() + i);
   }
 
+  if (!device_buffers_) {
+    std::vector<IOBuffer> io_buffers;
+    for (const auto& batch : batches_) {
+      io_buffers.push_back({batch.aligned_data, buf_size_});
+    }
+    io_ctx_->register_buffers(io_buffers);
+  }
+
   fd_ = open(fname.c_str(), O_RDONLY | O_DIRECT);
   if (fd_ == -1) {
     throw std::runtime_error("No such file: " + fname);
   };
+  io_ctx_->register_file(fd_);
 }
 
 BatchFileReader::~BatchFileReader() {
@@ -61,10 +114,12 @@ BatchFileReader::~BatchFileReader() {
   // free our buffers
   io_ctx_.reset();
 
-  for (auto& batch : batches_) {
-    cudaHostUnregister(batch.aligned_data);
-    numa_free(batch.aligned_data, buf_size_);
-    // free(batch.aligned_data);
+  if (!device_buffers_) {
+    for (auto& batch : batches_) {
+      cudaHostUnregister(batch.aligned_data);
+      numa_free(batch.aligned_data, buf_size_);
+      // free(batch.aligned_data);
+    }
   }
   close(fd_);
 }
@@ -83,6 +138,7 @@ void BatchFileReader::submit_reads() {
   while (true) {
     if (batch_locations_iterator_ == batch_locations_->end()) {
       if (num_inflight_ == 0) {
+        batch_locations_->set_epoch(++epoch_);
         batch_locations_iterator_ = batch_locations_->begin();
       } else {
         // Wait for batches from previous epoch to complete. Edge case where batch_i=0 from previous
@@ -100,6 +156,8 @@ void BatchFileReader::submit_reads() {
 
       batch->shard_size_bytes = descriptor.shard_size_bytes;
       batch->batch_size_bytes = descriptor.batch_size_bytes;
+      batch->shard_num_samples = descriptor.shard_num_samples;
+      batch->batch_num_samples = descriptor.batch_num_samples;
       batch->batch_id = descriptor.id;
       batch->batch_i = descriptor.i;
       batch->start_time = 0.f;
@@ -112,14 +170,28 @@ void BatchFileReader::submit_reads() {
         batch->data = nullptr;  // no data to return
         empty_batches_.emplace_back(const_cast<const Batch*>(batch));
       } else {
-        // Our data will start further into the buffer if the offset is not aligned
-        size_t misalignment = descriptor.offset % io_ctx_->get_alignment();
-        batch->data = batch->aligned_data + misalignment;
+        if (device_buffers_) {
+          batch->aligned_data = device_buffers_(descriptor.i);
+        }
+        if (descriptor.segments.empty()) {
+          descriptor.segments.push_back({descriptor.offset, descriptor.shard_size_bytes});
+        }
         batch->start_time = time_double();
-
-        IORequest io_req{fd_, batch->aligned_data, descriptor.shard_size_bytes, descriptor.offset,
-                         (void*)batch};
-        io_ctx_->submit(io_req);
+        batch->num_pending_ios = descriptor.segments.size();
+
+        // Every segment is read into its own aligned piece of the buffer
+        batch->pieces.clear();
+        uint8_t* aligned_data = batch->aligned_data;
+        for (const auto& segment : descriptor.segments) {
+          // Our data will start further into the buffer if the offset is not aligned
+          size_t misalignment = segment.offset % io_ctx_->get_alignment();
+          batch->pieces.push_back({aligned_data + misalignment, segment.size});
+
+          IORequest io_req{fd_, aligned_data, segment.size, segment.offset, (void*)batch};
+          io_ctx_->submit(io_req);
+          aligned_data += round_up(segment.size + misalignment, io_ctx_->get_alignment());
+        }
+        batch->data = batch->pieces.front().data;
       }
     } else {
       break;  // queue depth full
@@ -133,6 +205,9 @@ const std::vector<const BatchFileReader::Batch*>& BatchFileReader::collect(size_
   tmp_completed_batches_.clear();
   for (const auto& event : events) {
     auto batch = reinterpret_cast<Batch*>(event.user_data);
+    if (--batch->num_pending_ios > 0) {
+      continue;  // wait for all segments
+    }
     batch->end_time = time;
     tmp_completed_batches_.emplace_back(const_cast<const Batch*>(batch));
   }
@@ -150,4 +225,10 @@ void BatchFileReader::release_batch(const BatchFileReader::Batch* batch) {
 
 size_t BatchFileReader::get_queue_depth() const { return max_batches_inflight_; }
 
+size_t BatchFileReader::get_alignment() const { return io_ctx_->get_alignment(); }
+
+void BatchFileReader::register_buffers(const std::vector<IOBuffer>& buffers) {
+  io_ctx_->register_buffers(buffers);
+}
+
 }  // namespace HugeCTR
\ No newline at end of file
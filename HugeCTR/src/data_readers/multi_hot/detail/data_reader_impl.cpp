@@ -14,8 +14,12 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <cassert>
+#include <core23/instrumentation.hpp>
+#include <data_readers/multi_hot/compressed_format.hpp>
 #include <data_readers/multi_hot/detail/data_reader_impl.hpp>
+#include <data_readers/multi_hot/detail/file_batch_locations.hpp>
 #include <filesystem>
 #include <set>
 
@@ -25,18 +29,36 @@ namespace MultiHot {
 DataReaderImpl::DataReaderImpl(const std::vector<FileSource>& source_files,
                                const std::shared_ptr<ResourceManager>& resource_manager,
                                size_t batch_size, size_t num_reader_threads_per_device,
-                               size_t num_batches_per_thread, bool shuffle, bool schedule_uploads)
-    : resource_manager_(resource_manager), schedule_uploads_(schedule_uploads) {
+                               size_t num_batches_per_thread, bool shuffle, bool schedule_uploads,
+                               IOBackend_t io_backend, size_t shuffle_block_size)
+    : resource_manager_(resource_manager),
+      schedule_uploads_(schedule_uploads),
+      direct_to_device_(io_backend == IOBackend_t::GDS) {
   const size_t local_gpu_count = resource_manager->get_local_gpu_count();
   const size_t global_gpu_count = resource_manager->get_global_gpu_count();
   const size_t num_slots = source_files.size();
 
+  const bool block_shuffle = shuffle && shuffle_block_size > 0;
+  if (block_shuffle && direct_to_device_) {
+    throw std::invalid_argument("Block shuffle is not supported with GDS");
+  }
+
   for (auto source : source_files) {
     if (batch_size % global_gpu_count) {
       throw std::invalid_argument("Batch size not divisible by number of GPUs");
     }
+    if (source.compressed) {
+#ifndef ENABLE_NVCOMP
+      throw std::invalid_argument(
+          "Chunk-compressed files are not available, rebuild with -DENABLE_NVCOMP=ON");
+#endif
+      if (direct_to_device_) {
+        throw std::invalid_argument("Chunk-compressed files are not supported with GDS");
+      }
+    }
 
-    std::unique_ptr<IBatchLocations> locations = configure_locations(source, batch_size, shuffle);
+    std::unique_ptr<IBatchLocations> locations = configure_locations(
+        source, batch_size, shuffle, block_shuffle ? shuffle_block_size : 0);
     if (num_batches_ == 0) {
       num_batches_ = locations->count();
     } else if (num_batches_ != locations->count()) {
@@ -44,10 +66,25 @@ DataReaderImpl::DataReaderImpl(const std::vector<FileSource>& source_files,
     }
 
     // TODO: refactor this for dynamic pooling
-    const size_t local_batch_size_bytes =
-        (batch_size / global_gpu_count) * source.sample_size_bytes;
+    size_t local_batch_size_bytes = (batch_size / global_gpu_count) * source.sample_size_bytes;
 
     auto device_locations = locations->shard(global_gpu_count, local_batch_size_bytes);
+    size_t max_shard_size_bytes = 0;  // variable-length and compressed files
+    if (source.variable_length || source.compressed) {
+      for (const auto& shard_locations : device_locations) {
+        max_shard_size_bytes =
+            std::max(max_shard_size_bytes, shard_locations->get_batch_size_bytes());
+      }
+    }
+    if (source.variable_length) {
+      local_batch_size_bytes = max_shard_size_bytes;
+    }
+    local_batch_size_bytes_.push_back(local_batch_size_bytes);
+    local_compressed_size_bytes_.push_back(source.compressed ? max_shard_size_bytes : 0);
+    samples_per_chunk_.push_back(
+        source.compressed
+            ? static_cast<VariableBatchLocations*>(locations.get())->get_samples_per_record()
+            : 0);
 
     for (size_t i = 0; i < local_gpu_count; ++i) {
       // move thread to correct numa
@@ -58,9 +95,17 @@ DataReaderImpl::DataReaderImpl(const std::vector<FileSource>& source_files,
       auto thread_locations =
           device_locations[global_gpu_id]->distribute(num_reader_threads_per_device);
 
+      BatchFileReader::DeviceBufferFn device_buffers;
+      if (direct_to_device_) {
+        device_buffers = [this, i, slot = source.slot_id](size_t batch_i) {
+          return get_parent(batch_i).local_batches[i].device_buffers[slot];
+        };
+      }
+
       for (size_t thread = 0; thread < thread_locations.size(); ++thread) {
         auto reader = new BatchFileReader(source.name, source.slot_id, num_batches_per_thread,
-                                          std::move(thread_locations[thread]));
+                                          std::move(thread_locations[thread]), io_backend,
+                                          device_buffers);
         file_readers_[i].emplace_back(reader);
       }
     }
@@ -82,6 +127,10 @@ DataReaderImpl::DataReaderImpl(const std::vector<FileSource>& source_files,
     batch->in_use_count = {resource_manager->get_local_gpu_count()};
 
     batch->local_batches.resize(resource_manager->get_local_gpu_count());
+    for (size_t slot = 0; slot < num_slots; ++slot) {
+      batch->compressed_sample_size_bytes.push_back(
+          samples_per_chunk_[slot] > 0 ? source_files[slot].sample_size_bytes : 0);
+    }
     size_t gpu = 0;
     for (auto& local_batch : batch->local_batches) {
       CudaDeviceContext ctx(resource_manager->get_local_gpu(gpu)->get_device_id());
@@ -91,12 +140,25 @@ DataReaderImpl::DataReaderImpl(const std::vector<FileSource>& source_files,
       local_batch.num_transfers = 0;
 
       // Allocate buffer for each slot
-      for (auto source : source_files) {
+      for (size_t slot = 0; slot < num_slots; ++slot) {
         uint8_t* ptr = nullptr;
-        size_t local_batch_size_bytes = (batch_size / global_gpu_count) * source.sample_size_bytes;
+        size_t local_batch_size_bytes = local_batch_size_bytes_[slot];
+        if (direct_to_device_) {
+          // Room for the misalignment and the rounding up of the aligned reads
+          local_batch_size_bytes += 2 * file_readers_[gpu].front()->get_alignment();
+        }
         HCTR_LIB_THROW(cudaMalloc(&ptr, local_batch_size_bytes));
         HCTR_LIB_THROW(cudaMemset(ptr, 0, local_batch_size_bytes));
         local_batch.device_data.push_back(ptr);
+        if (direct_to_device_) {
+          local_batch.device_buffers.push_back(ptr);
+        }
+
+        uint8_t* compressed_ptr = nullptr;
+        if (samples_per_chunk_[slot] > 0) {
+          HCTR_LIB_THROW(cudaMalloc(&compressed_ptr, local_compressed_size_bytes_[slot]));
+        }
+        local_batch.compressed_data.push_back(compressed_ptr);
       }
 
       gpu++;
@@ -105,6 +167,39 @@ DataReaderImpl::DataReaderImpl(const std::vector<FileSource>& source_files,
     batch_buffers_[i] = std::move(batch);
   }
 
+  if (direct_to_device_) {
+    for (auto& [gpu, readers] : file_readers_) {
+      CudaDeviceContext ctx(resource_manager->get_local_gpu(gpu)->get_device_id());
+      std::vector<IOBuffer> buffers;
+      for (size_t slot = 0; slot < num_slots; ++slot) {
+        size_t size_bytes = local_batch_size_bytes_[slot] + 2 * readers.front()->get_alignment();
+        for (auto& batch : batch_buffers_) {
+          buffers.push_back({batch->local_batches[gpu].device_buffers[slot], size_bytes});
+        }
+      }
+      // cuFile buffer registrations are per process, one reader is enough
+      readers.front()->register_buffers(buffers);
+    }
+  }
+
+#ifdef ENABLE_NVCOMP
+  decompressors_.resize(local_gpu_count);
+  for (size_t i = 0; i < local_gpu_count; ++i) {
+    CudaDeviceContext ctx(resource_manager->get_local_gpu(i)->get_device_id());
+    for (size_t slot = 0; slot < num_slots; ++slot) {
+      const size_t samples_per_chunk = samples_per_chunk_[slot];
+      if (samples_per_chunk > 0) {
+        const size_t max_chunks =
+            (batch_size / global_gpu_count + samples_per_chunk - 1) / samples_per_chunk;
+        decompressors_[i].emplace_back(std::make_unique<LZ4Decompressor>(
+            max_chunks, samples_per_chunk * source_files[slot].sample_size_bytes));
+      } else {
+        decompressors_[i].emplace_back(nullptr);
+      }
+    }
+  }
+#endif
+
   pending_transfers_.resize(resource_manager->get_local_gpu_count());
 
   for (size_t i = 0; i < resource_manager->get_local_gpu_count(); ++i) {
@@ -146,15 +241,37 @@ DataReaderImpl::~DataReaderImpl() {
   // TODO: free GPU mem
 }
 
-std::unique_ptr<IBatchLocations> DataReaderImpl::configure_locations(FileSource source,
-                                                                     size_t batch_size,
-                                                                     bool shuffle) const {
+std::unique_ptr<IBatchLocations> DataReaderImpl::configure_locations(
+    FileSource source, size_t batch_size, bool shuffle, size_t shuffle_block_size) const {
+  if (source.compressed) {
+    if (shuffle_block_size > 0) {
+      throw std::invalid_argument("Block shuffle is not supported with chunk-compressed files");
+    }
+    const CompressedFileFooter footer = read_compressed_footer(source.name);
+    if (footer.sample_size_bytes != source.sample_size_bytes) {
+      throw std::invalid_argument("The sample size of " + source.name +
+                                  " does not match the label, dense and sparse params");
+    }
+    return std::make_unique<VariableBatchLocations>(
+        footer.num_samples, footer.samples_per_chunk, read_compressed_index(source.name, footer),
+        batch_size, shuffle, resource_manager_->get_local_cpu()->get_replica_uniform_seed());
+  }
+  if (source.variable_length) {
+    if (shuffle_block_size > 0) {
+      throw std::invalid_argument("Block shuffle is not supported with variable-length files");
+    }
+    return std::make_unique<VariableBatchLocations>(
+        source.name, batch_size, shuffle,
+        resource_manager_->get_local_cpu()->get_replica_uniform_seed());
+  }
+
   const size_t file_size = std::filesystem::file_size(source.name);
   assert(file_size > 0);
 
   auto locations = std::make_unique<BatchLocations>(
       batch_size * source.sample_size_bytes, 0, file_size, shuffle,
-      resource_manager_->get_local_cpu()->get_replica_uniform_seed());
+      resource_manager_->get_local_cpu()->get_replica_uniform_seed(),
+      shuffle_block_size * source.sample_size_bytes);
   return locations;
 }
 
@@ -180,6 +297,24 @@ void DataReaderImpl::start() {
   }
 }
 
+void DataReaderImpl::stop() {
+  running_ = false;
+  for (auto& thread : file_reader_threads_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+  for (auto& thread : placement_threads_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+  // The release callback of the last batch must not run after the readers are gone
+  for (auto& stream : callback_streams_) {
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  }
+}
+
 const DataReaderImpl::Batch& DataReaderImpl::get_batch() {
   const size_t buf_pos = batch_i_ % batch_buffers_.size();
 
@@ -188,11 +323,20 @@ const DataReaderImpl::Batch& DataReaderImpl::get_batch() {
   // needs to be set to NOT_READY on calling thread, not callback thread, otherwise there will be
   // race condition where CPU runs ahead and the next batch could be ready to consume from the
   // previous iteration.
-  while (batch->state.load(std::memory_order_acquire) != BatchState::READY_TO_CONSUME) {
-    // spin
+  {
+    HCTR_NVTX_RANGE("MultiHot::get_batch wait");
+    while (batch->state.load(std::memory_order_acquire) != BatchState::READY_TO_CONSUME) {
+      // spin
+    }
   }
   batch->state = BatchState::NOT_READY;
 
+  // The batches that are already read, i.e. how far the readers are ahead of the training
+  static auto& queue_depth = MetricsRegistry::get().gauge("data_reader_ready_batches");
+  queue_depth.set(std::count_if(batch_buffers_.begin(), batch_buffers_.end(), [](auto& buffer) {
+    return buffer->state.load(std::memory_order_relaxed) == BatchState::READY_TO_CONSUME;
+  }));
+
   compute_batch_stats(batch);
 
   batch_i_ = (batch_i_ + 1) % num_batches_;
@@ -244,7 +388,8 @@ DataReaderImpl::Batch& DataReaderImpl::get_parent(size_t batch_i) {
 }
 
 void DataReaderImpl::read_batches(BatchFileReader& file_reader, int device_id) {
-  CudaCPUDeviceContext ctx(device_id);  // move thread to appropriate numa
+  // move thread to appropriate numa, device_id is the local id of the GPU
+  CudaCPUDeviceContext ctx(resource_manager_->get_local_gpu(device_id)->get_device_id());
 
   while (running_) {
     const std::vector<const BatchFileReader::Batch*>& io_batches = file_reader.read_batches(10);
@@ -255,12 +400,21 @@ void DataReaderImpl::read_batches(BatchFileReader& file_reader, int device_id) {
       local_batch.io_batches[io_batch->slot_id] = io_batch;
 
       DeviceTransfer* transfer = nullptr;
-      if (io_batch->shard_size_bytes > 0)  // incomplete batch may not have local batch on all GPUs
+      if (direct_to_device_) {
+        // Already in device memory, the upload thread only has to synchronize
+        if (io_batch->shard_size_bytes > 0) {
+          local_batch.device_data[io_batch->slot_id] = io_batch->data;
+        }
+      } else if (io_batch->shard_size_bytes > 0)  // incomplete batch may not have local batch on
+                                                   // all GPUs
       {
+        // chunk-compressed slots are decompressed by the upload thread
+        uint8_t* dst = local_batch.compressed_data[io_batch->slot_id]
+                           ? local_batch.compressed_data[io_batch->slot_id]
+                           : local_batch.device_data[io_batch->slot_id];
         transfer = new DeviceTransfer(device_id,
-                                      io_batch->data,                              // src
-                                      local_batch.device_data[io_batch->slot_id],  // dst
-                                      io_batch->shard_size_bytes);
+                                      io_batch->pieces,  // src
+                                      dst);
       }
 
       size_t buf_idx = local_batch.num_transfers++;  // atomic
@@ -313,9 +467,12 @@ void DataReaderImpl::upload_batches(size_t device_id) {
         local_batch.num_transfers.raw.load(std::memory_order_relaxed) > 0) {
       // Schedule transfers at correct place in iteration
       if (schedule_uploads_) {
-        while (pending_transfers_[device_id].raw == 0) {
+        while (pending_transfers_[device_id].raw == 0 && running_) {
           // spin
         }
+        if (!running_) {
+          break;
+        }
 
         pending_transfers_[device_id].raw--;
         HCTR_LIB_THROW(cudaStreamWaitEvent(stream, placement_events_[device_id]));
@@ -332,6 +489,20 @@ void DataReaderImpl::upload_batches(size_t device_id) {
         }
       }
 
+#ifdef ENABLE_NVCOMP
+      // Overlaps with the training of the previous batch like the H2D copies
+      for (size_t slot = 0; slot < samples_per_chunk_.size(); ++slot) {
+        const size_t samples_per_chunk = samples_per_chunk_[slot];
+        const auto io_batch = local_batch.io_batches[slot];
+        if (samples_per_chunk > 0 && io_batch->shard_size_bytes > 0) {
+          decompressors_[device_id][slot]->decompress(
+              local_batch.compressed_data[slot],
+              (io_batch->shard_num_samples + samples_per_chunk - 1) / samples_per_chunk,
+              local_batch.device_data[slot], stream);
+        }
+      }
+#endif
+
       // It's possible that this local batch has been uploaded but the other local batches haven't.
       // In this case we will attempt to upload again because state == READY_TO_UPLOAD. Therefore,
       // set num_transfers to 0 to prevent uploading this local batch again.
@@ -340,6 +511,17 @@ void DataReaderImpl::upload_batches(size_t device_id) {
       // necessary for decrement of num_completed_uploads because it is checked on the host
       HCTR_LIB_THROW(cudaStreamSynchronize(stream));
 
+#ifdef ENABLE_NVCOMP
+      for (size_t slot = 0; slot < samples_per_chunk_.size(); ++slot) {
+        const size_t samples_per_chunk = samples_per_chunk_[slot];
+        const auto io_batch = local_batch.io_batches[slot];
+        if (samples_per_chunk > 0 && io_batch->shard_size_bytes > 0) {
+          decompressors_[device_id][slot]->check_status(
+              (io_batch->shard_num_samples + samples_per_chunk - 1) / samples_per_chunk);
+        }
+      }
+#endif
+
       // all devices have uploaded their local batch, main thread can now consume
       if (++batch->num_completed_uploads == batch->local_batches.size()) {
         batch->state.store(BatchState::READY_TO_CONSUME, std::memory_order_release);
@@ -393,6 +575,9 @@ void DataReaderImpl::compute_batch_stats(Batch* batch) {
   io_stats.batch_min_latency = n == 1 ? latency : std::min(io_stats.batch_min_latency, latency);
   io_stats.batch_max_latency = n == 1 ? latency : std::max(io_stats.batch_max_latency, latency);
   io_stats.batch_avg_latency = batch_avg;
+
+  static auto& batch_latency = MetricsRegistry::get().gauge("data_reader_batch_latency_seconds");
+  batch_latency.set(latency);
 }
 
 }  // namespace MultiHot
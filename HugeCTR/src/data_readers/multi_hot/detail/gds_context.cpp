@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <data_readers/multi_hot/detail/gds_context.hpp>
+#include <stdexcept>
+#include <string>
+
+namespace HugeCTR {
+
+#define round_up(x, y) ((((x) + ((y)-1)) / (y)) * (y))
+
+namespace {
+
+void check_cufile(CUfileError_t status, const std::string& what) {
+  if (status.err != CU_FILE_SUCCESS) {
+    throw std::runtime_error(what + " failed: " + std::to_string(status.err));
+  }
+}
+
+}  // namespace
+
+GDSContext::GDSContext(size_t io_depth) : io_depth_(io_depth), tmp_io_events_(io_depth) {
+  tmp_events_.reserve(io_depth);
+  pending_ios_.reserve(io_depth);
+
+  check_cufile(cuFileDriverOpen(), "cuFileDriverOpen");
+  check_cufile(cuFileBatchIOSetUp(&batch_handle_, io_depth), "cuFileBatchIOSetUp");
+}
+
+GDSContext::~GDSContext() {
+  // app can't exit with IO requests in-flight
+  (void)collect(num_inflight_, 1e6);  // wait 1s
+  assert(num_inflight_ == 0);
+
+  cuFileBatchIODestroy(batch_handle_);
+  for (void* buffer : registered_buffers_) {
+    cuFileBufDeregister(buffer);
+  }
+  if (fd_ != -1) {
+    cuFileHandleDeregister(file_handle_);
+  }
+  cuFileDriverClose();
+}
+
+void GDSContext::register_buffers(const std::vector<IOBuffer>& buffers) {
+  for (const auto& buffer : buffers) {
+    // Unregistered buffers still work, cuFile then stages the reads in its own bounce buffers
+    if (cuFileBufRegister(buffer.data, buffer.size, 0).err == CU_FILE_SUCCESS) {
+      registered_buffers_.push_back(buffer.data);
+    }
+  }
+}
+
+void GDSContext::register_file(int fd) {
+  CUfileDescr_t descr;
+  std::memset(&descr, 0, sizeof(descr));
+  descr.handle.fd = fd;
+  descr.type = CU_FILE_HANDLE_TYPE_OPAQUE_FD;
+  check_cufile(cuFileHandleRegister(&file_handle_, &descr), "cuFileHandleRegister");
+  fd_ = fd;
+}
+
+void GDSContext::submit(const IORequest& request) {
+  assert(num_inflight_ + pending_ios_.size() < io_depth_);
+  if (request.fd != fd_) {
+    throw std::runtime_error("GDSContext::submit() called with an unregistered file");
+  }
+
+  // Aligned reads take the direct DMA path
+  size_t aligned_offset = (request.offset / get_alignment()) * get_alignment();
+  size_t size = round_up(request.size + (request.offset - aligned_offset), get_alignment());
+
+  CUfileIOParams_t io;
+  std::memset(&io, 0, sizeof(io));
+  io.mode = CUFILE_BATCH;
+  io.fh = file_handle_;
+  io.opcode = CUFILE_READ;
+  io.cookie = request.user_data;
+  io.u.batch.devPtr_base = request.data;
+  io.u.batch.devPtr_offset = 0;
+  io.u.batch.file_offset = aligned_offset;
+  io.u.batch.size = size;
+  pending_ios_.push_back(io);
+}
+
+const std::vector<IOEvent>& GDSContext::collect(size_t min_reqs, size_t timeout_us) {
+  if (!pending_ios_.empty()) {
+    check_cufile(cuFileBatchIOSubmit(batch_handle_, pending_ios_.size(), pending_ios_.data(), 0),
+                 "cuFileBatchIOSubmit");
+    num_inflight_ += pending_ios_.size();
+    pending_ios_.clear();
+  }
+
+  tmp_events_.clear();
+  if (num_inflight_ == 0) {
+    return tmp_events_;
+  }
+
+  timespec timeout = {0, (long)timeout_us * 1000};
+  unsigned num_completed = io_depth_;
+  check_cufile(cuFileBatchIOGetStatus(batch_handle_, std::min(min_reqs, num_inflight_),
+                                      &num_completed, tmp_io_events_.data(), &timeout),
+               "cuFileBatchIOGetStatus");
+
+  for (unsigned i = 0; i < num_completed; ++i) {
+    const auto& io_event = tmp_io_events_[i];
+    if (io_event.status != CUFILE_COMPLETE) {
+      throw std::runtime_error("cuFileBatchIOGetStatus returned failed event: " +
+                               std::to_string(io_event.status));
+    }
+
+    IOEvent event;
+    event.error = IOError::IO_SUCCESS;
+    event.user_data = io_event.cookie;
+
+    tmp_events_.emplace_back(event);
+  }
+  num_inflight_ -= num_completed;
+
+  return tmp_events_;
+}
+
+size_t GDSContext::get_alignment() const {
+  return 4096;  // O_DIRECT requirement
+}
+
+}  // namespace HugeCTR
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <data_readers/multi_hot/detail/io_uring_context.hpp>
+#include <stdexcept>
+#include <string>
+
+namespace HugeCTR {
+
+#define round_up(x, y) ((((x) + ((y)-1)) / (y)) * (y))
+
+IOUringContext::IOUringContext(size_t io_depth, bool sq_poll) : io_depth_(io_depth) {
+  tmp_events_.reserve(io_depth);
+
+  io_uring_params params;
+  std::memset(&params, 0, sizeof(params));
+  if (sq_poll) {
+    params.flags |= IORING_SETUP_SQPOLL;
+    params.sq_thread_idle = 2000;  // ms before the polling thread goes to sleep
+  }
+  int ret = io_uring_queue_init_params(io_depth, &ring_, &params);
+  if (ret < 0) {
+    throw std::runtime_error("io_uring_queue_init_params failed: " + std::string(strerror(-ret)));
+  }
+  tmp_cqes_.resize(params.cq_entries);
+}
+
+IOUringContext::~IOUringContext() {
+  // app can't exit with IO requests in-flight
+  (void)collect(num_inflight_, 1e6);  // wait 1s
+  assert(num_inflight_ == 0);
+  io_uring_queue_exit(&ring_);
+}
+
+void IOUringContext::register_buffers(const std::vector<IOBuffer>& buffers) {
+  std::vector<iovec> iovecs;
+  for (const auto& buffer : buffers) {
+    // Reads are rounded up to the alignment, the buffers are page allocated so this is safe
+    iovecs.push_back({buffer.data, round_up(buffer.size, get_alignment())});
+    buffers_.push_back({buffer.data, iovecs.back().iov_len});
+  }
+  int ret = io_uring_register_buffers(&ring_, iovecs.data(), iovecs.size());
+  if (ret < 0) {
+    // e.g. RLIMIT_MEMLOCK too small, fall back to regular reads
+    buffers_.clear();
+  }
+}
+
+void IOUringContext::register_file(int fd) {
+  if (io_uring_register_files(&ring_, &fd, 1) == 0) {
+    registered_fd_ = fd;
+  }
+}
+
+int IOUringContext::find_buffer(const uint8_t* data, size_t size) const {
+  for (size_t i = 0; i < buffers_.size(); ++i) {
+    if (data >= buffers_[i].data && data + size <= buffers_[i].data + buffers_[i].size) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+void IOUringContext::submit(const IORequest& request) {
+  assert(num_inflight_ < io_depth_);
+
+  io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (!sqe) {
+    (void)io_uring_submit(&ring_);
+    num_pending_ = 0;
+    sqe = io_uring_get_sqe(&ring_);
+    if (!sqe) {
+      throw std::runtime_error("io_uring submission queue full");
+    }
+  }
+
+  // For O_DIRECT, offsets and sizes need to be aligned
+  size_t aligned_offset = (request.offset / get_alignment()) * get_alignment();
+  size_t size = round_up(request.size + (request.offset - aligned_offset), get_alignment());
+
+  const bool fixed_file = request.fd == registered_fd_;
+  const int fd = fixed_file ? 0 : request.fd;
+  const int buf_index = find_buffer(request.data, size);
+  if (buf_index >= 0) {
+    io_uring_prep_read_fixed(sqe, fd, request.data, size, aligned_offset, buf_index);
+  } else {
+    io_uring_prep_read(sqe, fd, request.data, size, aligned_offset);
+  }
+  if (fixed_file) {
+    sqe->flags |= IOSQE_FIXED_FILE;
+  }
+  io_uring_sqe_set_data(sqe, request.user_data);
+
+  num_pending_++;
+  num_inflight_++;
+}
+
+const std::vector<IOEvent>& IOUringContext::collect(size_t min_reqs, size_t timeout_us) {
+  if (num_pending_ > 0) {
+    int ret = io_uring_submit(&ring_);
+    if (ret < 0) {
+      throw std::runtime_error("io_uring_submit failed: " + std::string(strerror(-ret)));
+    }
+    num_pending_ = 0;
+  }
+
+  min_reqs = std::min(min_reqs, num_inflight_);
+  if (min_reqs > 0 && io_uring_cq_ready(&ring_) < min_reqs) {
+    __kernel_timespec timeout = {0, (long long)timeout_us * 1000};
+    io_uring_cqe* cqe = nullptr;
+    int ret = io_uring_wait_cqes(&ring_, &cqe, min_reqs, &timeout, nullptr);
+    if (ret < 0 && ret != -ETIME && ret != -EINTR) {
+      throw std::runtime_error("io_uring_wait_cqes failed: " + std::string(strerror(-ret)));
+    }
+  }
+
+  unsigned num_completed = io_uring_peek_batch_cqe(&ring_, tmp_cqes_.data(), tmp_cqes_.size());
+
+  tmp_events_.clear();
+  for (unsigned i = 0; i < num_completed; ++i) {
+    io_uring_cqe* cqe = tmp_cqes_[i];
+    if (cqe->res < 0) {
+      throw std::runtime_error("io_uring returned failed event: " +
+                               std::string(strerror(-cqe->res)));
+    }
+
+    IOEvent event;
+    event.error = IOError::IO_SUCCESS;
+    event.user_data = io_uring_cqe_get_data(cqe);
+
+    tmp_events_.emplace_back(event);
+  }
+  io_uring_cq_advance(&ring_, num_completed);
+  num_inflight_ -= num_completed;
+
+  return tmp_events_;
+}
+
+size_t IOUringContext::get_alignment() const {
+  return 4096;  // O_DIRECT requirement
+}
+
+}  // namespace HugeCTR
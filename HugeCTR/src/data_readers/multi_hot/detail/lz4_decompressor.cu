@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <common.hpp>
+#include <data_readers/multi_hot/compressed_format.hpp>
+#include <data_readers/multi_hot/detail/lz4_decompressor.hpp>
+#include <stdexcept>
+#include <string>
+
+namespace HugeCTR {
+
+namespace {
+
+// A shard has at most a few hundred chunks, a single thread walks them
+__global__ void locate_chunks_kernel(const uint8_t* src, size_t num_chunks, uint8_t* dst,
+                                     const void** compressed_ptrs, size_t* compressed_bytes,
+                                     size_t* uncompressed_bytes, void** uncompressed_ptrs) {
+  for (size_t c = 0; c < num_chunks; ++c) {
+    const auto* header = reinterpret_cast<const CompressedChunkHeader*>(src);
+    compressed_ptrs[c] = src + sizeof(CompressedChunkHeader);
+    compressed_bytes[c] = header->compressed_bytes;
+    uncompressed_bytes[c] = header->uncompressed_bytes;
+    uncompressed_ptrs[c] = dst;
+    src += (sizeof(CompressedChunkHeader) + header->compressed_bytes + 7) / 8 * 8;
+    dst += header->uncompressed_bytes;
+  }
+}
+
+void check_nvcomp(nvcompStatus_t status, const char* what,
+                  Error_t error = Error_t::UnspecificError) {
+  if (status != nvcompSuccess) {
+    HCTR_OWN_THROW(error,
+                   std::string(what) + " failed with nvCOMP status " + std::to_string(status));
+  }
+}
+
+}  // namespace
+
+LZ4Decompressor::LZ4Decompressor(size_t max_chunks, size_t max_chunk_bytes)
+    : max_chunks_(max_chunks) {
+  check_nvcomp(nvcompBatchedLZ4DecompressGetTempSize(max_chunks, max_chunk_bytes, &temp_bytes_),
+               "nvcompBatchedLZ4DecompressGetTempSize");
+  HCTR_LIB_THROW(cudaMalloc(&temp_, temp_bytes_));
+  HCTR_LIB_THROW(cudaMalloc(&compressed_ptrs_, max_chunks * sizeof(void*)));
+  HCTR_LIB_THROW(cudaMalloc(&compressed_bytes_, max_chunks * sizeof(size_t)));
+  HCTR_LIB_THROW(cudaMalloc(&uncompressed_bytes_, max_chunks * sizeof(size_t)));
+  HCTR_LIB_THROW(cudaMalloc(&actual_uncompressed_bytes_, max_chunks * sizeof(size_t)));
+  HCTR_LIB_THROW(cudaMalloc(&uncompressed_ptrs_, max_chunks * sizeof(void*)));
+  HCTR_LIB_THROW(cudaMalloc(&statuses_, max_chunks * sizeof(nvcompStatus_t)));
+  HCTR_LIB_THROW(cudaMallocHost(&host_statuses_, max_chunks * sizeof(nvcompStatus_t)));
+}
+
+LZ4Decompressor::~LZ4Decompressor() {
+  cudaFree(temp_);
+  cudaFree(compressed_ptrs_);
+  cudaFree(compressed_bytes_);
+  cudaFree(uncompressed_bytes_);
+  cudaFree(actual_uncompressed_bytes_);
+  cudaFree(uncompressed_ptrs_);
+  cudaFree(statuses_);
+  cudaFreeHost(host_statuses_);
+}
+
+void LZ4Decompressor::decompress(const uint8_t* src, size_t num_chunks, uint8_t* dst,
+                                 cudaStream_t stream) {
+  if (num_chunks > max_chunks_) {
+    throw std::invalid_argument("Too many chunks for the LZ4 decompressor");
+  }
+  if (num_chunks == 0) {
+    return;
+  }
+  locate_chunks_kernel<<<1, 1, 0, stream>>>(src, num_chunks, dst, compressed_ptrs_,
+                                            compressed_bytes_, uncompressed_bytes_,
+                                            uncompressed_ptrs_);
+  HCTR_LIB_THROW(cudaPeekAtLastError());
+  check_nvcomp(nvcompBatchedLZ4DecompressAsync(compressed_ptrs_, compressed_bytes_,
+                                               uncompressed_bytes_, actual_uncompressed_bytes_,
+                                               num_chunks, temp_, temp_bytes_, uncompressed_ptrs_,
+                                               statuses_, stream),
+               "nvcompBatchedLZ4DecompressAsync");
+  HCTR_LIB_THROW(cudaMemcpyAsync(host_statuses_, statuses_, num_chunks * sizeof(nvcompStatus_t),
+                                 cudaMemcpyDeviceToHost, stream));
+}
+
+void LZ4Decompressor::check_status(size_t num_chunks) const {
+  for (size_t c = 0; c < num_chunks; ++c) {
+    check_nvcomp(host_statuses_[c], "LZ4 decompression of a chunk", Error_t::BrokenFile);
+  }
+}
+
+}  // namespace HugeCTR
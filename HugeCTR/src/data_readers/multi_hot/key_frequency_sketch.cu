@@ -0,0 +1,339 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <common.hpp>
+#include <data_readers/multi_hot/key_frequency_sketch.hpp>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <nlohmann/json.hpp>
+#include <numeric>
+#include <utils.hpp>
+
+namespace HugeCTR {
+
+namespace {
+
+constexpr int kWays = 8;  // candidates per bucket
+
+// MurmurHash3 fmix64, the same on the host and on the device
+__host__ __device__ __forceinline__ uint64_t hash_key(uint64_t key) {
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdull;
+  key ^= key >> 33;
+  key *= 0xc4ceb9fe1a85ec53ull;
+  key ^= key >> 33;
+  return key;
+}
+
+// Row d of the count-min sketch, by double hashing
+__host__ __device__ __forceinline__ uint32_t counter_index(uint64_t hash, uint32_t d,
+                                                           uint32_t width) {
+  const uint32_t h1 = static_cast<uint32_t>(hash);
+  const uint32_t h2 = static_cast<uint32_t>(hash >> 32) | 1u;
+  return (h1 + d * h2) % width;
+}
+
+template <typename KeyType>
+__host__ __device__ __forceinline__ KeyType empty_key() {
+  return std::numeric_limits<KeyType>::max();
+}
+
+template <typename KeyType>
+__device__ __forceinline__ KeyType atomic_cas_key(KeyType* address, KeyType compare, KeyType val) {
+  if constexpr (sizeof(KeyType) == sizeof(unsigned long long)) {
+    return static_cast<KeyType>(atomicCAS(reinterpret_cast<unsigned long long*>(address),
+                                          static_cast<unsigned long long>(compare),
+                                          static_cast<unsigned long long>(val)));
+  } else {
+    return static_cast<KeyType>(atomicCAS(reinterpret_cast<unsigned int*>(address),
+                                          static_cast<unsigned int>(compare),
+                                          static_cast<unsigned int>(val)));
+  }
+}
+
+// One grid row per slot, one thread per key
+template <typename KeyType>
+__global__ void add_keys_kernel(const KeyType* const* __restrict slot_keys,
+                                const int* __restrict hotness, size_t num_rows,
+                                unsigned long long* counters, uint32_t* registers,
+                                KeyType* candidates, unsigned long long* candidate_counts,
+                                uint32_t width, uint32_t depth, int hll_precision,
+                                uint32_t num_buckets) {
+  const uint32_t slot = blockIdx.y;
+  const size_t num_keys = num_rows * hotness[slot];
+  const KeyType* keys = slot_keys[slot];
+  unsigned long long* slot_counters = counters + static_cast<size_t>(slot) * depth * width;
+  uint32_t* slot_registers = registers + (static_cast<size_t>(slot) << hll_precision);
+
+  for (size_t i = blockIdx.x * static_cast<size_t>(blockDim.x) + threadIdx.x; i < num_keys;
+       i += static_cast<size_t>(blockDim.x) * gridDim.x) {
+    const KeyType key = keys[i];
+    const uint64_t hash = hash_key(static_cast<uint64_t>(key));
+
+    // The counts after this update are the estimate of the key
+    unsigned long long count = ~0ull;
+    for (uint32_t d = 0; d < depth; ++d) {
+      const unsigned long long c =
+          atomicAdd(&slot_counters[d * width + counter_index(hash, d, width)], 1ull) + 1;
+      count = c < count ? c : count;
+    }
+
+    // Leading zeros of the bits below the register index, the sentinel bounds them
+    const uint32_t reg = static_cast<uint32_t>(hash >> (64 - hll_precision));
+    const uint32_t rank = __clzll((hash << hll_precision) | (1ull << (hll_precision - 1))) + 1;
+    atomicMax(&slot_registers[reg], rank);
+
+    if (key == empty_key<KeyType>()) {
+      continue;
+    }
+    const size_t bucket =
+        (static_cast<size_t>(slot) * num_buckets + hash_key(hash) % num_buckets) * kWays;
+    KeyType* ways = candidates + bucket;
+    unsigned long long* way_counts = candidate_counts + bucket;
+    int min_way = 0;
+    unsigned long long min_count = ~0ull;
+    bool found = false;
+    for (int w = 0; w < kWays; ++w) {
+      if (ways[w] == key) {
+        atomicMax(&way_counts[w], count);
+        found = true;
+        break;
+      }
+      const unsigned long long c = way_counts[w];
+      if (c < min_count) {
+        min_count = c;
+        min_way = w;
+      }
+    }
+    if (!found && count > min_count) {
+      const KeyType old = ways[min_way];
+      if (atomic_cas_key(&ways[min_way], old, key) == old) {
+        atomicExch(&way_counts[min_way], count);
+      }
+    }
+  }
+}
+
+template <typename T>
+void fill_device(T* ptr, T value, size_t n) {
+  std::vector<T> host(n, value);
+  HCTR_LIB_THROW(cudaMemcpy(ptr, host.data(), n * sizeof(T), cudaMemcpyHostToDevice));
+}
+
+}  // namespace
+
+template <typename KeyType>
+KeyFrequencySketch<KeyType>::KeyFrequencySketch(size_t num_slots, int device_id, size_t width,
+                                                size_t depth, int hll_precision,
+                                                size_t num_candidates)
+    : device_id_(device_id),
+      num_slots_(num_slots),
+      width_(width),
+      depth_(depth),
+      num_candidates_((num_candidates + kWays - 1) / kWays * kWays),
+      hll_precision_(hll_precision) {
+  if (num_slots_ == 0 || width_ == 0 || depth_ == 0 || num_candidates_ == 0) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "The key frequency sketch needs slots and counters");
+  }
+  if (hll_precision_ < 4 || hll_precision_ > 18) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "The HyperLogLog precision should be in [4, 18]");
+  }
+  CudaDeviceContext ctx(device_id_);
+  const size_t num_counters = num_slots_ * depth_ * width_;
+  const size_t num_registers = num_slots_ << hll_precision_;
+  const size_t total_candidates = num_slots_ * num_candidates_;
+  HCTR_LIB_THROW(cudaMalloc(&counters_, num_counters * sizeof(unsigned long long)));
+  HCTR_LIB_THROW(cudaMalloc(&registers_, num_registers * sizeof(uint32_t)));
+  HCTR_LIB_THROW(cudaMalloc(&candidates_, total_candidates * sizeof(KeyType)));
+  HCTR_LIB_THROW(cudaMalloc(&candidate_counts_, total_candidates * sizeof(unsigned long long)));
+  HCTR_LIB_THROW(cudaMemset(counters_, 0, num_counters * sizeof(unsigned long long)));
+  HCTR_LIB_THROW(cudaMemset(registers_, 0, num_registers * sizeof(uint32_t)));
+  fill_device(candidates_, empty_key<KeyType>(), total_candidates);
+  HCTR_LIB_THROW(cudaMemset(candidate_counts_, 0, total_candidates * sizeof(unsigned long long)));
+}
+
+template <typename KeyType>
+KeyFrequencySketch<KeyType>::~KeyFrequencySketch() {
+  CudaDeviceContext ctx(device_id_);
+  cudaFree(counters_);
+  cudaFree(registers_);
+  cudaFree(candidates_);
+  cudaFree(candidate_counts_);
+}
+
+template <typename KeyType>
+void KeyFrequencySketch<KeyType>::add(const KeyType* const* slot_keys, const int* hotness,
+                                      int max_hotness, size_t num_rows, cudaStream_t stream) {
+  const size_t max_keys = num_rows * max_hotness;
+  if (max_keys == 0) {
+    return;
+  }
+  constexpr unsigned int block_dim = 256;
+  const dim3 grid_dim(std::min<size_t>((max_keys + block_dim - 1) / block_dim, 1024), num_slots_);
+  add_keys_kernel<<<grid_dim, block_dim, 0, stream>>>(
+      slot_keys, hotness, num_rows, counters_, registers_, candidates_, candidate_counts_,
+      width_, depth_, hll_precision_, num_candidates_ / kWays);
+  HCTR_LIB_THROW(cudaPeekAtLastError());
+}
+
+template <typename KeyType>
+typename KeyFrequencySketch<KeyType>::HostCopy KeyFrequencySketch<KeyType>::to_host() const {
+  CudaDeviceContext ctx(device_id_);
+  // The updates run on the streams of the reader
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+  HostCopy copy{num_slots_, width_, depth_, hll_precision_, {}, {}, {}};
+  copy.counters.resize(num_slots_ * depth_ * width_);
+  copy.registers.resize(num_slots_ << hll_precision_);
+  std::vector<KeyType> candidates(num_slots_ * num_candidates_);
+  HCTR_LIB_THROW(cudaMemcpy(copy.counters.data(), counters_,
+                            copy.counters.size() * sizeof(unsigned long long),
+                            cudaMemcpyDeviceToHost));
+  HCTR_LIB_THROW(cudaMemcpy(copy.registers.data(), registers_,
+                            copy.registers.size() * sizeof(uint32_t), cudaMemcpyDeviceToHost));
+  HCTR_LIB_THROW(cudaMemcpy(candidates.data(), candidates_, candidates.size() * sizeof(KeyType),
+                            cudaMemcpyDeviceToHost));
+  copy.candidates.resize(num_slots_);
+  for (size_t slot = 0; slot < num_slots_; ++slot) {
+    for (size_t i = slot * num_candidates_; i < (slot + 1) * num_candidates_; ++i) {
+      if (candidates[i] != empty_key<KeyType>()) {
+        copy.candidates[slot].push_back(candidates[i]);
+      }
+    }
+  }
+  return copy;
+}
+
+template <typename KeyType>
+void KeyFrequencySketch<KeyType>::HostCopy::merge(const HostCopy& other) {
+  if (other.num_slots != num_slots || other.width != width || other.depth != depth ||
+      other.hll_precision != hll_precision) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "Only sketches of the same size can be merged");
+  }
+  for (size_t i = 0; i < counters.size(); ++i) {
+    counters[i] += other.counters[i];
+  }
+  for (size_t i = 0; i < registers.size(); ++i) {
+    registers[i] = std::max(registers[i], other.registers[i]);
+  }
+  for (size_t slot = 0; slot < num_slots; ++slot) {
+    candidates[slot].insert(candidates[slot].end(), other.candidates[slot].begin(),
+                            other.candidates[slot].end());
+  }
+}
+
+template <typename KeyType>
+uint64_t KeyFrequencySketch<KeyType>::HostCopy::estimate(size_t slot, KeyType key) const {
+  const uint64_t hash = hash_key(static_cast<uint64_t>(key));
+  const unsigned long long* slot_counters = counters.data() + slot * depth * width;
+  uint64_t count = std::numeric_limits<uint64_t>::max();
+  for (uint32_t d = 0; d < depth; ++d) {
+    count = std::min<uint64_t>(count, slot_counters[d * width + counter_index(hash, d, width)]);
+  }
+  return count;
+}
+
+template <typename KeyType>
+std::vector<KeySlotProfile> KeyFrequencySketch<KeyType>::HostCopy::profile(size_t top_k) const {
+  std::vector<KeySlotProfile> profiles(num_slots);
+  const size_t m = size_t{1} << hll_precision;
+  for (size_t slot = 0; slot < num_slots; ++slot) {
+    KeySlotProfile& profile = profiles[slot];
+
+    // Every key increments one counter of every row
+    const unsigned long long* row = counters.data() + slot * depth * width;
+    profile.num_keys = std::accumulate(row, row + width, uint64_t{0});
+
+    // HyperLogLog, with linear counting for the small cardinalities
+    double sum = 0.;
+    size_t num_zeros = 0;
+    for (size_t i = slot * m; i < (slot + 1) * m; ++i) {
+      sum += std::ldexp(1., -static_cast<int>(registers[i]));
+      num_zeros += registers[i] == 0;
+    }
+    const double alpha_m = 0.7213 / (1. + 1.079 / m);
+    double cardinality = alpha_m * m * m / sum;
+    if (cardinality <= 2.5 * m && num_zeros > 0) {
+      cardinality = m * std::log(static_cast<double>(m) / num_zeros);
+    }
+    profile.cardinality = profile.num_keys ? cardinality : 0.;
+
+    std::vector<KeyType> keys = candidates[slot];
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    for (KeyType key : keys) {
+      profile.top_keys.emplace_back(static_cast<long long>(key), estimate(slot, key));
+    }
+    std::sort(profile.top_keys.begin(), profile.top_keys.end(),
+              [](const auto& a, const auto& b) { return a.second > b.second; });
+    if (profile.top_keys.size() > top_k) {
+      profile.top_keys.resize(top_k);
+    }
+
+    uint64_t top_count = 0;
+    for (const auto& [key, count] : profile.top_keys) {
+      top_count += count;
+    }
+    profile.top_keys_share =
+        profile.num_keys ? std::min(1., static_cast<double>(top_count) / profile.num_keys) : 0.;
+
+    // count ~ rank^-alpha, least squares in log-log space
+    if (profile.top_keys.size() >= 2) {
+      double sx = 0., sy = 0., sxx = 0., sxy = 0.;
+      const double n = profile.top_keys.size();
+      for (size_t rank = 0; rank < profile.top_keys.size(); ++rank) {
+        const double x = std::log(rank + 1.);
+        const double y = std::log(static_cast<double>(profile.top_keys[rank].second));
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+      }
+      profile.power_law_alpha = -(n * sxy - sx * sy) / (n * sxx - sx * sx);
+    }
+  }
+  return profiles;
+}
+
+void write_key_profile(const std::string& path, const std::vector<KeySlotProfile>& profiles) {
+  nlohmann::json slots = nlohmann::json::array();
+  for (size_t slot = 0; slot < profiles.size(); ++slot) {
+    const KeySlotProfile& profile = profiles[slot];
+    nlohmann::json top_keys = nlohmann::json::array();
+    for (const auto& [key, count] : profile.top_keys) {
+      top_keys.push_back({key, count});
+    }
+    slots.push_back({{"slot", slot},
+                     {"num_keys", profile.num_keys},
+                     {"cardinality", profile.cardinality},
+                     {"top_keys_share", profile.top_keys_share},
+                     {"power_law_alpha", profile.power_law_alpha},
+                     {"top_keys", top_keys}});
+  }
+
+  std::ofstream file(path);
+  if (!file.is_open()) {
+    HCTR_OWN_THROW(Error_t::FileCannotOpen, "Cannot open " + path);
+  }
+  file << std::setw(2) << nlohmann::json{{"slots", slots}} << std::endl;
+}
+
+template class KeyFrequencySketch<uint32_t>;
+template class KeyFrequencySketch<long long>;
+
+}  // namespace HugeCTR
@@ -1,134 +1,373 @@
-/*
- * Copyright (c) 2023, NVIDIA CORPORATION.
- *
- * Licensed under the Apache License, Version 2.0 (the "License");
- * you may not use this file except in compliance with the License.
- * You may obtain a copy of the License at
- *
- *     http://www.apache.org/licenses/LICENSE-2.0
- *
- * Unless required by applicable law or agreed to in writing, software
- * distributed under the License is distributed on an "AS IS" BASIS,
- * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
- * See the License for the specific language governing permissions and
- * limitations under the License.
- */
-
-#include <cassert>
-#include <data_readers/multi_hot/split_batch.hpp>
-
-namespace HugeCTR {
-template <bool ISFLOAT = true>
-struct DenseOp_t {
-  __host__ __device__ __forceinline__ float operator()(const int* in) { return 0.f; }
-  DenseOp_t() = default;
-};
-template <>
-struct DenseOp_t<true> {
-  __host__ __device__ __forceinline__ float operator()(const int* in) {
-    return *reinterpret_cast<const float*>(in);
-  }
-};
-template <>
-struct DenseOp_t<false> {
-  __host__ __device__ __forceinline__ float operator()(const int* in) {
-    return static_cast<float>(logf(*in + 1.f));
-  }
-};
-
-using int_dense_op_t = DenseOp_t<false>;
-using float_dense_op_t = DenseOp_t<true>;
-
-template <typename DenseType, typename SparseType, typename DenseOp>
-__global__ void split_feat_major_kernel(float* __restrict label, int label_dim,
-                                        DenseType* __restrict dense, int dense_dim,
-                                        SparseType** __restrict sparse_tensors, int sparse_dim,
-                                        const int* __restrict label_dense_sparse,
-                                        const int* __restrict bucket_ids,
-                                        const int* __restrict bucket_positions,
-                                        const int* __restrict max_hotnesses, uint32_t batch_size,
-                                        uint32_t sample_dim, DenseOp dop) {
-  for (uint32_t idx = blockIdx.x * blockDim.x + threadIdx.x; idx < batch_size * sample_dim;
-       idx += blockDim.x * gridDim.x) {
-    const uint32_t row = idx / sample_dim;
-    const uint32_t col = idx - row * sample_dim;
-
-    if (col < label_dim)  // store in label tensor
-    {
-      auto col_data = label_dense_sparse[idx];  // Load column
-      label[row * label_dim + col] = static_cast<float>(col_data);
-    } else if (col < label_dim + dense_dim)  // store in dense tensor
-    {
-      const auto dense_col = col - label_dim;
-      // sizeof(int) == sizeof(float)
-      const int* col_data = reinterpret_cast<const int*>(label_dense_sparse) + idx;
-      dense[row * dense_dim + dense_col] = static_cast<DenseType>(dop(col_data));
-    } else  // store in sparse tensors
-    {
-      auto col_data = label_dense_sparse[idx];  // Load column
-      if constexpr (std::is_same<SparseType, long long>::value) {
-        const auto sparse_col = col - label_dim - dense_dim;
-        const auto bucket_id = bucket_ids[sparse_col / 2];
-        const auto bucket_idx =
-            (row * max_hotnesses[bucket_id] + bucket_positions[sparse_col / 2]) * 2 +
-            (sparse_col & 1);
-        reinterpret_cast<int**>(sparse_tensors)[bucket_id][bucket_idx] = col_data;
-      } else {
-        const auto sparse_col = col - label_dim - dense_dim;
-        const auto bucket_id = bucket_ids[sparse_col];
-        const auto bucket_idx = row * max_hotnesses[bucket_id] + bucket_positions[sparse_col];
-        sparse_tensors[bucket_id][bucket_idx] = static_cast<SparseType>(col_data);
-      }
-    }
-  }
-}
-
-template <typename DenseType, typename SparseType>
-void split_3_way_feat_major(core23::Tensor label_tensor, core23::Tensor dense_tensor,
-                            core23::Tensor sparse_tensors, core23::Tensor label_dense_sparse_tensor,
-                            core23::Tensor bucket_ids, core23::Tensor bucket_positions,
-                            core23::Tensor max_hotnesses, cudaStream_t stream,
-                            bool dense_is_float) {
-  const auto batch_size = label_dense_sparse_tensor.size(0);
-  const auto label_dim = label_tensor.size(1);
-  const auto dense_dim = dense_tensor.size(1);
-  const auto sparse_dim = sparse_tensors.size(0);
-  const auto sample_dim = label_dense_sparse_tensor.size(1);
-  assert(label_dim > 0 && "label_dim is 0");
-  assert(dense_dim > 0 && "dense_dim is 0");
-  assert(sample_dim > 0 && "sample_dim is 0");
-
-  constexpr dim3 block_dim(128);
-  const dim3 grid_dim((batch_size * sample_dim + block_dim.x - 1) / block_dim.x);
-  if (dense_is_float) {
-    auto DOP = float_dense_op_t();
-    split_feat_major_kernel<<<grid_dim, block_dim, 0, stream>>>(
-        label_tensor.data<float>(), label_dim, dense_tensor.data<DenseType>(), dense_dim,
-        reinterpret_cast<SparseType**>(sparse_tensors.data()), sparse_dim,
-        label_dense_sparse_tensor.data<int>(), bucket_ids.data<int>(), bucket_positions.data<int>(),
-        max_hotnesses.data<int>(), batch_size, sample_dim, DOP);
-  } else {
-    auto DOP = int_dense_op_t();
-    split_feat_major_kernel<<<grid_dim, block_dim, 0, stream>>>(
-        label_tensor.data<float>(), label_dim, dense_tensor.data<DenseType>(), dense_dim,
-        reinterpret_cast<SparseType**>(sparse_tensors.data()), sparse_dim,
-        label_dense_sparse_tensor.data<int>(), bucket_ids.data<int>(), bucket_positions.data<int>(),
-        max_hotnesses.data<int>(), batch_size, sample_dim, DOP);
-  }
-
-  HCTR_LIB_THROW(cudaPeekAtLastError());
-}
-
-#define INSTANTIATE_SPLIT_3_WAY_23(DENSE_T, SPARSE_T)                                          \
-  template void split_3_way_feat_major<DENSE_T, SPARSE_T>(                                     \
-      core23::Tensor label_tensor, core23::Tensor dense_tensor, core23::Tensor sparse_tensors, \
-      core23::Tensor label_dense_sparse_tensor, core23::Tensor bucket_ids,                     \
-      core23::Tensor bucket_positions, core23::Tensor max_hotnesses, cudaStream_t stream,      \
-      bool float_dense)
-
-INSTANTIATE_SPLIT_3_WAY_23(float, uint32_t);
-INSTANTIATE_SPLIT_3_WAY_23(__half, uint32_t);
-INSTANTIATE_SPLIT_3_WAY_23(float, long long);
-INSTANTIATE_SPLIT_3_WAY_23(__half, long long);
-
-}  // namespace HugeCTR
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cassert>
+#include <common.hpp>
+#include <data_readers/multi_hot/split_batch.hpp>
+#include <data_readers/multi_hot/variable_length_format.hpp>
+
+namespace HugeCTR {
+template <bool ISFLOAT = true>
+struct DenseOp_t {
+  __host__ __device__ __forceinline__ float operator()(const int* in) { return 0.f; }
+  DenseOp_t() = default;
+};
+template <>
+struct DenseOp_t<true> {
+  __host__ __device__ __forceinline__ float operator()(const int* in) {
+    return *reinterpret_cast<const float*>(in);
+  }
+};
+template <>
+struct DenseOp_t<false> {
+  __host__ __device__ __forceinline__ float operator()(const int* in) {
+    return static_cast<float>(logf(*in + 1.f));
+  }
+};
+
+using int_dense_op_t = DenseOp_t<false>;
+using float_dense_op_t = DenseOp_t<true>;
+
+// Without transforms the split kernels are instantiated with NoTransform, which compiles away
+struct NoTransform {
+  static constexpr bool enabled = false;
+  __device__ __forceinline__ float dense(int, float x) const { return x; }
+  template <typename T>
+  __device__ __forceinline__ T key(int, T value) const {
+    return value;
+  }
+};
+
+struct ColumnTransform {
+  static constexpr bool enabled = true;
+  SplitTransforms t;
+
+  __device__ __forceinline__ float dense(int col, float x) const {
+    const int op = t.dense_ops[col];
+    if (op == static_cast<int>(DataTransform_t::Log1p)) {
+      return log1pf(x);
+    }
+    if (op == static_cast<int>(DataTransform_t::Bucketize)) {
+      // upper bound of x in the sorted boundaries
+      int lo = t.boundary_offsets[col];
+      int hi = t.boundary_offsets[col + 1];
+      const int begin = lo;
+      while (lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if (t.boundaries[mid] <= x) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+      return static_cast<float>(lo - begin);
+    }
+    return x;
+  }
+
+  template <typename T>
+  __device__ __forceinline__ T key(int slot, T value) const {
+    const long long modulo = t.key_modulo[slot];
+    if (modulo == 0) {
+      return value;
+    }
+    const long long r = static_cast<long long>(value) % modulo;
+    return static_cast<T>(r < 0 ? r + modulo : r);
+  }
+};
+
+// FileKeyType is the key type of the samples, long long for 64-bit keys narrowed to SparseType
+template <typename DenseType, typename SparseType, typename FileKeyType, typename DenseOp,
+          typename Transform>
+__global__ void split_feat_major_kernel(float* __restrict label, int label_dim,
+                                        DenseType* __restrict dense, int dense_dim,
+                                        SparseType** __restrict sparse_tensors, int sparse_dim,
+                                        const int* __restrict label_dense_sparse,
+                                        const int* __restrict bucket_ids,
+                                        const int* __restrict bucket_positions,
+                                        const int* __restrict max_hotnesses, uint32_t batch_size,
+                                        uint32_t sample_dim, DenseOp dop, Transform transform) {
+  for (uint32_t idx = blockIdx.x * blockDim.x + threadIdx.x; idx < batch_size * sample_dim;
+       idx += blockDim.x * gridDim.x) {
+    const uint32_t row = idx / sample_dim;
+    const uint32_t col = idx - row * sample_dim;
+
+    if (col < label_dim)  // store in label tensor
+    {
+      auto col_data = label_dense_sparse[idx];  // Load column
+      label[row * label_dim + col] = static_cast<float>(col_data);
+    } else if (col < label_dim + dense_dim)  // store in dense tensor
+    {
+      const auto dense_col = col - label_dim;
+      // sizeof(int) == sizeof(float)
+      const int* col_data = reinterpret_cast<const int*>(label_dense_sparse) + idx;
+      dense[row * dense_dim + dense_col] =
+          static_cast<DenseType>(transform.dense(dense_col, dop(col_data)));
+    } else  // store in sparse tensors
+    {
+      auto col_data = label_dense_sparse[idx];  // Load column
+      if constexpr (std::is_same<FileKeyType, long long>::value &&
+                    (Transform::enabled || !std::is_same<SparseType, long long>::value)) {
+        // The transforms and the narrowing need the whole key, the thread of its low half
+        // writes it
+        const auto sparse_col = col - label_dim - dense_dim;
+        if ((sparse_col & 1) == 0) {
+          const auto bucket_id = bucket_ids[sparse_col / 2];
+          const auto bucket_idx = row * max_hotnesses[bucket_id] + bucket_positions[sparse_col / 2];
+          const long long key =
+              (static_cast<long long>(static_cast<uint32_t>(label_dense_sparse[idx + 1])) << 32) |
+              static_cast<uint32_t>(col_data);
+          sparse_tensors[bucket_id][bucket_idx] =
+              static_cast<SparseType>(transform.key(bucket_id, key));
+        }
+      } else if constexpr (std::is_same<FileKeyType, long long>::value) {
+        const auto sparse_col = col - label_dim - dense_dim;
+        const auto bucket_id = bucket_ids[sparse_col / 2];
+        const auto bucket_idx =
+            (row * max_hotnesses[bucket_id] + bucket_positions[sparse_col / 2]) * 2 +
+            (sparse_col & 1);
+        reinterpret_cast<int**>(sparse_tensors)[bucket_id][bucket_idx] = col_data;
+      } else {
+        const auto sparse_col = col - label_dim - dense_dim;
+        const auto bucket_id = bucket_ids[sparse_col];
+        const auto bucket_idx = row * max_hotnesses[bucket_id] + bucket_positions[sparse_col];
+        sparse_tensors[bucket_id][bucket_idx] =
+            transform.key(bucket_id, static_cast<SparseType>(col_data));
+      }
+    }
+  }
+}
+
+template <typename DenseType, typename SparseType>
+void split_3_way_feat_major(const core23::Tensor& label_tensor, const core23::Tensor& dense_tensor,
+                            const core23::Tensor& sparse_tensors,
+                            const core23::Tensor& label_dense_sparse_tensor,
+                            const core23::Tensor& bucket_ids,
+                            const core23::Tensor& bucket_positions,
+                            const core23::Tensor& max_hotnesses, cudaStream_t stream,
+                            bool dense_is_float, const SplitTransforms& transforms,
+                            bool int64_file_keys) {
+  const auto batch_size = label_dense_sparse_tensor.size(0);
+  const auto label_dim = label_tensor.size(1);
+  const auto dense_dim = dense_tensor.size(1);
+  const auto sparse_dim = sparse_tensors.size(0);
+  const auto sample_dim = label_dense_sparse_tensor.size(1);
+  assert(label_dim > 0 && "label_dim is 0");
+  assert(dense_dim > 0 && "dense_dim is 0");
+  assert(sample_dim > 0 && "sample_dim is 0");
+
+  constexpr dim3 block_dim(128);
+  const dim3 grid_dim((batch_size * sample_dim + block_dim.x - 1) / block_dim.x);
+  auto split = [&](auto dop, auto transform) {
+    auto launch = [&](auto file_key) {
+      split_feat_major_kernel<DenseType, SparseType, decltype(file_key)>
+          <<<grid_dim, block_dim, 0, stream>>>(
+              label_tensor.data<float>(), label_dim, dense_tensor.data<DenseType>(), dense_dim,
+              reinterpret_cast<SparseType**>(sparse_tensors.data()), sparse_dim,
+              label_dense_sparse_tensor.data<int>(), bucket_ids.data<int>(),
+              bucket_positions.data<int>(), max_hotnesses.data<int>(), batch_size, sample_dim, dop,
+              transform);
+    };
+    if (int64_file_keys) {
+      launch(0ll);
+    } else {
+      launch(SparseType());
+    }
+  };
+  auto split_transformed = [&](auto dop) {
+    if (transforms.empty()) {
+      split(dop, NoTransform());
+    } else {
+      split(dop, ColumnTransform{transforms});
+    }
+  };
+  if (dense_is_float) {
+    split_transformed(float_dense_op_t());
+  } else {
+    split_transformed(int_dense_op_t());
+  }
+
+  HCTR_LIB_THROW(cudaPeekAtLastError());
+}
+
+// Finds the records of the shard and, per slot, where the keys of every record start in the
+// compacted key tensor. The records only have to be walked once, so a single block does it.
+__global__ void locate_var_len_records_kernel(const uint8_t* __restrict data, uint32_t num_records,
+                                              uint32_t num_slots, uint32_t label_dim,
+                                              uint32_t dense_dim, uint64_t* record_begin,
+                                              uint64_t* slot_key_begin, uint64_t* slot_num_keys) {
+  if (threadIdx.x == 0) {
+    uint64_t begin = 0;
+    for (uint32_t r = 0; r < num_records; ++r) {
+      record_begin[r] = begin;
+      begin += reinterpret_cast<const VarLenRecordHeader*>(data + begin)->record_size_bytes;
+    }
+  }
+  __syncthreads();
+
+  for (uint32_t slot = threadIdx.x; slot < num_slots; slot += blockDim.x) {
+    uint64_t num_keys = 0;
+    for (uint32_t r = 0; r < num_records; ++r) {
+      const uint8_t* record = data + record_begin[r];
+      const uint32_t n = reinterpret_cast<const VarLenRecordHeader*>(record)->num_samples;
+      const uint32_t* offsets = reinterpret_cast<const uint32_t*>(
+          record + var_len_offsets_begin(n, label_dim, dense_dim));
+      slot_key_begin[r * num_slots + slot] = num_keys;
+      num_keys += offsets[(slot + 1) * n] - offsets[slot * n];
+    }
+    slot_num_keys[slot] = num_keys;
+  }
+}
+
+// One thread per (sample, slot) copies the keys of the bucket and writes its offset, one thread
+// per sample splits the label and dense features. Buckets past the last sample are empty.
+template <typename DenseType, typename SparseType, typename DenseOp, typename Transform>
+__global__ void split_var_len_kernel(
+    float* __restrict label, int label_dim, DenseType* __restrict dense, int dense_dim,
+    SparseType** __restrict sparse_tensors, SparseType** __restrict bucket_ranges,
+    const int* __restrict max_hotnesses, uint32_t num_slots, const uint8_t* __restrict data,
+    const uint64_t* __restrict record_begin, const uint64_t* __restrict slot_key_begin,
+    const uint64_t* __restrict slot_num_keys, uint32_t num_samples, uint32_t samples_per_record,
+    uint32_t batch_size, DenseOp dop, Transform transform) {
+  const uint32_t num_cols = num_slots + 1;
+  for (uint32_t idx = blockIdx.x * blockDim.x + threadIdx.x; idx < (batch_size + 1) * num_cols;
+       idx += blockDim.x * gridDim.x) {
+    const uint32_t row = idx / num_cols;
+    const uint32_t col = idx - row * num_cols;
+
+    if (row >= num_samples) {
+      if (col < num_slots) {
+        bucket_ranges[col][row] = static_cast<SparseType>(slot_num_keys[col]);
+      }
+      continue;
+    }
+
+    const uint32_t r = row / samples_per_record;
+    const uint32_t i = row - r * samples_per_record;
+    const uint8_t* record = data + record_begin[r];
+    const uint32_t n = reinterpret_cast<const VarLenRecordHeader*>(record)->num_samples;
+
+    if (col == num_slots) {
+      const int* label_dense = reinterpret_cast<const int*>(record + sizeof(VarLenRecordHeader)) +
+                               i * (label_dim + dense_dim);
+      for (int c = 0; c < label_dim; ++c) {
+        label[row * label_dim + c] = static_cast<float>(label_dense[c]);
+      }
+      for (int c = 0; c < dense_dim; ++c) {
+        dense[row * dense_dim + c] =
+            static_cast<DenseType>(transform.dense(c, dop(label_dense + label_dim + c)));
+      }
+    } else {
+      const uint32_t* offsets = reinterpret_cast<const uint32_t*>(
+          record + var_len_offsets_begin(n, label_dim, dense_dim));
+      const SparseType* keys = reinterpret_cast<const SparseType*>(
+          record + var_len_keys_begin(n, label_dim, dense_dim, num_slots));
+      const uint32_t begin = offsets[col * n + i];
+      const uint32_t end = offsets[col * n + i + 1];
+      const uint64_t dst = slot_key_begin[r * num_slots + col] + begin - offsets[col * n];
+      bucket_ranges[col][row] = static_cast<SparseType>(dst);
+
+      // Never write past the value tensor, even if the file exceeds the max hotness
+      const uint64_t capacity = static_cast<uint64_t>(batch_size) * max_hotnesses[col];
+      for (uint32_t k = begin; k < end && dst + (k - begin) < capacity; ++k) {
+        sparse_tensors[col][dst + (k - begin)] = transform.key(col, keys[k]);
+      }
+    }
+  }
+}
+
+template <typename DenseType, typename SparseType>
+void split_3_way_variable_length(const core23::Tensor& label_tensor,
+                                 const core23::Tensor& dense_tensor,
+                                 const core23::Tensor& sparse_tensors,
+                                 const core23::Tensor& bucket_ranges, const void* data,
+                                 size_t num_samples, size_t samples_per_record,
+                                 const core23::Tensor& max_hotnesses,
+                                 const core23::Tensor& record_scratch,
+                                 cudaStream_t stream, bool is_dense_float,
+                                 const SplitTransforms& transforms) {
+  const auto batch_size = label_tensor.size(0);
+  const auto label_dim = label_tensor.size(1);
+  const auto dense_dim = dense_tensor.size(1);
+  const auto num_slots = sparse_tensors.size(0);
+  const size_t num_records = (num_samples + samples_per_record - 1) / samples_per_record;
+  assert(num_samples <= static_cast<size_t>(batch_size) && "num_samples exceeds batch size");
+  assert(static_cast<int64_t>(num_records * (num_slots + 1) + num_slots) <=
+             record_scratch.num_elements() &&
+         "record_scratch is too small");
+
+  uint64_t* record_begin = record_scratch.data<uint64_t>();
+  uint64_t* slot_key_begin = record_begin + num_records;
+  uint64_t* slot_num_keys = slot_key_begin + num_records * num_slots;
+  const auto* bytes = reinterpret_cast<const uint8_t*>(data);
+
+  locate_var_len_records_kernel<<<1, 128, 0, stream>>>(bytes, num_records, num_slots, label_dim,
+                                                       dense_dim, record_begin, slot_key_begin,
+                                                       slot_num_keys);
+
+  constexpr dim3 block_dim(128);
+  const dim3 grid_dim(((batch_size + 1) * (num_slots + 1) + block_dim.x - 1) / block_dim.x);
+  auto split = [&](auto dop, auto transform) {
+    split_var_len_kernel<<<grid_dim, block_dim, 0, stream>>>(
+        label_tensor.data<float>(), label_dim, dense_tensor.data<DenseType>(), dense_dim,
+        reinterpret_cast<SparseType**>(sparse_tensors.data()),
+        reinterpret_cast<SparseType**>(bucket_ranges.data()), max_hotnesses.data<int>(), num_slots,
+        bytes, record_begin, slot_key_begin, slot_num_keys, num_samples, samples_per_record,
+        batch_size, dop, transform);
+  };
+  auto split_transformed = [&](auto dop) {
+    if (transforms.empty()) {
+      split(dop, NoTransform());
+    } else {
+      split(dop, ColumnTransform{transforms});
+    }
+  };
+  if (is_dense_float) {
+    split_transformed(float_dense_op_t());
+  } else {
+    split_transformed(int_dense_op_t());
+  }
+
+  HCTR_LIB_THROW(cudaPeekAtLastError());
+}
+
+#define INSTANTIATE_SPLIT_3_WAY_23(DENSE_T, SPARSE_T)                                          \
+  template void split_3_way_feat_major<DENSE_T, SPARSE_T>(                                     \
+      const core23::Tensor& label_tensor, const core23::Tensor& dense_tensor,                  \
+      const core23::Tensor& sparse_tensors, const core23::Tensor& label_dense_sparse_tensor,   \
+      const core23::Tensor& bucket_ids, const core23::Tensor& bucket_positions,                \
+      const core23::Tensor& max_hotnesses, cudaStream_t stream, bool float_dense,              \
+      const SplitTransforms& transforms, bool int64_file_keys)
+
+INSTANTIATE_SPLIT_3_WAY_23(float, uint32_t);
+INSTANTIATE_SPLIT_3_WAY_23(__half, uint32_t);
+INSTANTIATE_SPLIT_3_WAY_23(float, long long);
+INSTANTIATE_SPLIT_3_WAY_23(__half, long long);
+
+#define INSTANTIATE_SPLIT_3_WAY_VARIABLE_LENGTH(DENSE_T, SPARSE_T)                                 \
+  template void split_3_way_variable_length<DENSE_T, SPARSE_T>(                                    \
+      const core23::Tensor& label_tensor, const core23::Tensor& dense_tensor,                      \
+      const core23::Tensor& sparse_tensors, const core23::Tensor& bucket_ranges, const void* data, \
+      size_t num_samples, size_t samples_per_record, const core23::Tensor& max_hotnesses,          \
+      const core23::Tensor& record_scratch, cudaStream_t stream, bool is_dense_float,              \
+      const SplitTransforms& transforms)
+
+INSTANTIATE_SPLIT_3_WAY_VARIABLE_LENGTH(float, uint32_t);
+INSTANTIATE_SPLIT_3_WAY_VARIABLE_LENGTH(__half, uint32_t);
+INSTANTIATE_SPLIT_3_WAY_VARIABLE_LENGTH(float, long long);
+INSTANTIATE_SPLIT_3_WAY_VARIABLE_LENGTH(__half, long long);
+
+}  // namespace HugeCTR
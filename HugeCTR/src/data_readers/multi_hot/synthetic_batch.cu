@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <common.hpp>
+#include <data_readers/multi_hot/synthetic_batch.hpp>
+#include <numeric>
+
+namespace HugeCTR {
+
+namespace {
+
+// SplitMix64, a counter-based generator: every column of every sample is an independent stream
+__device__ __forceinline__ uint64_t mix64(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ull;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+// Uniform in [0, 1)
+__device__ __forceinline__ double to_unit(uint64_t x) {
+  return static_cast<double>(x >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Inverse CDF of the power law x^-alpha over [1, pool_size + 1), shifted to [0, pool_size)
+__device__ __forceinline__ long long power_law_rank(double u, long long pool_size, double alpha) {
+  const double max = static_cast<double>(pool_size) + 1.0;
+  double x;
+  if (fabs(alpha - 1.0) < 1e-6) {
+    x = exp(u * log(max));
+  } else {
+    const double e = 1.0 - alpha;
+    x = pow((pow(max, e) - 1.0) * u + 1.0, 1.0 / e);
+  }
+  const long long rank = static_cast<long long>(x) - 1;
+  return rank < 0 ? 0 : (rank < pool_size ? rank : pool_size - 1);
+}
+
+template <typename SparseType>
+__global__ void generate_synthetic_batch_kernel(
+    int* __restrict label_dense_sparse, uint32_t num_samples, uint32_t label_dim,
+    uint32_t dense_dim, uint32_t total_nnz, bool is_dense_float, const int* __restrict bucket_ids,
+    const long long* __restrict slot_key_params, uint32_t num_slots, double alpha, uint64_t seed) {
+  constexpr uint32_t key_items = sizeof(SparseType) / sizeof(int);
+  const uint32_t num_cols = label_dim + dense_dim + total_nnz;
+  const uint32_t sample_dim = label_dim + dense_dim + total_nnz * key_items;
+
+  for (uint64_t idx = blockIdx.x * static_cast<uint64_t>(blockDim.x) + threadIdx.x;
+       idx < static_cast<uint64_t>(num_samples) * num_cols;
+       idx += static_cast<uint64_t>(blockDim.x) * gridDim.x) {
+    const uint64_t row = idx / num_cols;
+    const uint32_t col = idx - row * num_cols;
+    int* sample = label_dense_sparse + row * sample_dim;
+    const double u = to_unit(mix64(seed ^ mix64(idx)));
+
+    if (col < label_dim) {
+      sample[col] = u < 0.5 ? 0 : 1;
+    } else if (col < label_dim + dense_dim) {
+      sample[col] = is_dense_float ? __float_as_int(static_cast<float>(u))
+                                   : static_cast<int>(u * 100.0);
+    } else {
+      const uint32_t key_col = col - label_dim - dense_dim;
+      const int slot = bucket_ids[key_col];
+      const long long pool_size = slot_key_params[slot];
+      const long long vocabulary_size = slot_key_params[num_slots + slot];
+      const long long stride = slot_key_params[2 * num_slots + slot];
+
+      long long rank = alpha == 0.0 ? static_cast<long long>(u * static_cast<double>(pool_size))
+                                    : power_law_rank(u, pool_size, alpha);
+      rank = rank < pool_size ? rank : pool_size - 1;
+      const auto key = static_cast<SparseType>(
+          static_cast<unsigned __int128>(rank) * static_cast<unsigned long long>(stride) %
+          static_cast<unsigned long long>(vocabulary_size));
+
+      // The samples are int aligned only, the halves of a 64-bit key are written separately
+      const int* key_items_ptr = reinterpret_cast<const int*>(&key);
+      int* dst = sample + label_dim + dense_dim + key_col * key_items;
+      for (uint32_t i = 0; i < key_items; ++i) {
+        dst[i] = key_items_ptr[i];
+      }
+    }
+  }
+}
+
+}  // namespace
+
+template <typename SparseType>
+void generate_synthetic_batch(core23::Tensor label_dense_sparse_tensor, size_t num_samples,
+                              size_t label_dim, size_t dense_dim, bool is_dense_float,
+                              core23::Tensor bucket_ids, core23::Tensor slot_key_params,
+                              float alpha, uint64_t seed, cudaStream_t stream) {
+  if (num_samples == 0) {
+    return;
+  }
+  const uint32_t total_nnz = bucket_ids.size(0);
+  const uint32_t num_slots = slot_key_params.size(0) / 3;
+  const uint64_t num_threads = num_samples * (label_dim + dense_dim + total_nnz);
+
+  constexpr unsigned int block_dim = 256;
+  const unsigned int grid_dim =
+      std::min<uint64_t>((num_threads + block_dim - 1) / block_dim, 65536);
+  generate_synthetic_batch_kernel<SparseType><<<grid_dim, block_dim, 0, stream>>>(
+      label_dense_sparse_tensor.data<int>(), num_samples, label_dim, dense_dim, total_nnz,
+      is_dense_float, bucket_ids.data<int>(), slot_key_params.data<long long>(), num_slots, alpha,
+      seed);
+  HCTR_LIB_THROW(cudaPeekAtLastError());
+}
+
+long long synthetic_key_stride(long long vocabulary_size) {
+  if (vocabulary_size <= 2) {
+    return 1;
+  }
+  long long stride = static_cast<long long>(static_cast<double>(vocabulary_size) * 0.6180339887);
+  while (std::gcd(stride, vocabulary_size) != 1) {
+    ++stride;
+  }
+  return stride;
+}
+
+template void generate_synthetic_batch<uint32_t>(core23::Tensor, size_t, size_t, size_t, bool,
+                                                 core23::Tensor, core23::Tensor, float, uint64_t,
+                                                 cudaStream_t);
+template void generate_synthetic_batch<long long>(core23::Tensor, size_t, size_t, size_t, bool,
+                                                  core23::Tensor, core23::Tensor, float, uint64_t,
+                                                  cudaStream_t);
+
+}  // namespace HugeCTR
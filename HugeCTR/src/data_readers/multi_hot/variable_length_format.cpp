@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+#include <data_readers/multi_hot/variable_length_format.hpp>
+#include <stdexcept>
+
+namespace HugeCTR {
+
+VarLenFileFooter read_var_len_footer(const std::string& file_name) {
+  std::ifstream file(file_name, std::ifstream::binary | std::ifstream::ate);
+  if (!file.is_open()) {
+    throw std::runtime_error("No such file: " + file_name);
+  }
+  const size_t file_size = file.tellg();
+  VarLenFileFooter footer;
+  if (file_size < sizeof(footer)) {
+    throw std::runtime_error(file_name + " is not a variable-length file");
+  }
+  file.seekg(file_size - sizeof(footer));
+  file.read(reinterpret_cast<char*>(&footer), sizeof(footer));
+  if (!file || footer.magic != VAR_LEN_MAGIC) {
+    throw std::runtime_error(file_name + " is not a variable-length file");
+  }
+  return footer;
+}
+
+std::vector<uint64_t> read_var_len_index(const std::string& file_name,
+                                         const VarLenFileFooter& footer) {
+  std::ifstream file(file_name, std::ifstream::binary | std::ifstream::ate);
+  const size_t file_size = file.tellg();
+  std::vector<uint64_t> index(footer.num_records + 1);
+  const size_t index_bytes = index.size() * sizeof(uint64_t);
+  if (file_size < sizeof(footer) + index_bytes) {
+    throw std::runtime_error("Truncated index in " + file_name);
+  }
+  file.seekg(file_size - sizeof(footer) - index_bytes);
+  file.read(reinterpret_cast<char*>(index.data()), index_bytes);
+  if (!file || index.back() != file_size - sizeof(footer) - index_bytes) {
+    throw std::runtime_error("Corrupted index in " + file_name);
+  }
+  return index;
+}
+
+VarLenFileWriter::VarLenFileWriter(const std::string& file_name, size_t samples_per_record,
+                                   size_t label_dim, size_t dense_dim, size_t num_slots,
+                                   size_t key_bytes)
+    : file_(file_name, std::ofstream::binary | std::ofstream::trunc),
+      keys_(num_slots),
+      hotness_(num_slots) {
+  if (!file_.is_open()) {
+    throw std::runtime_error("Cannot open " + file_name);
+  }
+  if (samples_per_record == 0 || (key_bytes != 4 && key_bytes != 8)) {
+    throw std::invalid_argument("samples_per_record should be > 0 and key_bytes 4 or 8");
+  }
+  footer_ = {VAR_LEN_MAGIC,
+             0,
+             0,
+             static_cast<uint32_t>(samples_per_record),
+             static_cast<uint32_t>(label_dim),
+             static_cast<uint32_t>(dense_dim),
+             static_cast<uint32_t>(num_slots),
+             static_cast<uint32_t>(key_bytes),
+             0};
+  index_.push_back(0);
+}
+
+VarLenFileWriter::~VarLenFileWriter() {
+  if (!closed_) {
+    try {
+      close();
+    } catch (const std::exception&) {
+      // destructors must not throw, call close() to see the error
+    }
+  }
+}
+
+void VarLenFileWriter::append(const int32_t* label_dense,
+                              const std::vector<std::vector<int64_t>>& keys) {
+  if (keys.size() != footer_.num_slots) {
+    throw std::invalid_argument("Expected the keys of " + std::to_string(footer_.num_slots) +
+                                " slots");
+  }
+  label_dense_.insert(label_dense_.end(), label_dense,
+                      label_dense + footer_.label_dim + footer_.dense_dim);
+  for (size_t slot = 0; slot < keys.size(); ++slot) {
+    keys_[slot].insert(keys_[slot].end(), keys[slot].begin(), keys[slot].end());
+    hotness_[slot].push_back(static_cast<uint32_t>(keys[slot].size()));
+  }
+  footer_.num_samples++;
+  if (++num_pending_samples_ == footer_.samples_per_record) {
+    flush_record();
+  }
+}
+
+void VarLenFileWriter::flush_record() {
+  if (num_pending_samples_ == 0) {
+    return;
+  }
+  const size_t n = num_pending_samples_;
+  const size_t num_slots = footer_.num_slots;
+
+  std::vector<uint32_t> offsets(1, 0);
+  for (size_t slot = 0; slot < num_slots; ++slot) {
+    for (auto hotness : hotness_[slot]) {
+      offsets.push_back(offsets.back() + hotness);
+    }
+  }
+  const size_t num_keys = offsets.back();
+  const size_t keys_begin = var_len_keys_begin(n, footer_.label_dim, footer_.dense_dim, num_slots);
+  const size_t record_size = (keys_begin + num_keys * footer_.key_bytes + 7) / 8 * 8;
+
+  std::vector<char> record(record_size, 0);
+  VarLenRecordHeader header{record_size, static_cast<uint32_t>(n),
+                            static_cast<uint32_t>(num_keys)};
+  std::memcpy(record.data(), &header, sizeof(header));
+  std::memcpy(record.data() + sizeof(header), label_dense_.data(),
+              label_dense_.size() * sizeof(int32_t));
+  std::memcpy(record.data() + var_len_offsets_begin(n, footer_.label_dim, footer_.dense_dim),
+              offsets.data(), offsets.size() * sizeof(uint32_t));
+  char* dst = record.data() + keys_begin;
+  for (size_t slot = 0; slot < num_slots; ++slot) {
+    for (int64_t key : keys_[slot]) {
+      if (footer_.key_bytes == 4) {
+        uint32_t k = static_cast<uint32_t>(key);
+        std::memcpy(dst, &k, sizeof(k));
+      } else {
+        std::memcpy(dst, &key, sizeof(key));
+      }
+      dst += footer_.key_bytes;
+    }
+    keys_[slot].clear();
+    hotness_[slot].clear();
+  }
+  file_.write(record.data(), record.size());
+
+  index_.push_back(index_.back() + record_size);
+  footer_.num_records++;
+  label_dense_.clear();
+  num_pending_samples_ = 0;
+}
+
+void VarLenFileWriter::close() {
+  flush_record();
+  file_.write(reinterpret_cast<const char*>(index_.data()), index_.size() * sizeof(uint64_t));
+  file_.write(reinterpret_cast<const char*>(&footer_), sizeof(footer_));
+  file_.close();
+  closed_ = true;
+  if (!file_) {
+    throw std::runtime_error("Failed to write variable-length file");
+  }
+}
+
+}  // namespace HugeCTR
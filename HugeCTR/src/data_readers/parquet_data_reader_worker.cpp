@@ -28,11 +28,11 @@ void ParquetDataReaderWorker<T>::do_h2d() {
   while (!this->skip_read_ && loop_flag_->load()) {
     try {
       if (!row_group_reader_->source_available()) {
-        row_group_reader_->read_new_file(strict_order_of_batches_ ? worker_id_ + 1 : 1);
+        row_group_reader_->read_new_file(worker_id_ + 1);
       }
       if (row_group_reader_->get_local_row_group_id() >=
           row_group_reader_->get_current_num_row_groups()) {
-        long long expected_next_num_group = strict_order_of_batches_ ? worker_num_ : 1;
+        long long expected_next_num_group = worker_num_;
         long long last_row_group_id =
             row_group_reader_->get_local_row_group_id() - expected_next_num_group;
         expected_next_num_group -=
@@ -415,8 +415,7 @@ ParquetDataReaderWorker<T>::ParquetDataReaderWorker(
   // TODO this eager allocation is a WAR of resolving race condition with the main thread;
   // Do not remove the allocation before we have a better way to resolve the race condition
   device_memory_dense_dim_array_.data();
-  source_ = std::make_shared<ParquetFileSource>(
-      worker_id, worker_num, file_list, strict_order_of_batches, repeat, data_source_params);
+  source_ = std::make_shared<ParquetFileSource>(worker_id, file_list, repeat, data_source_params);
 
   if ((int)slot_offset_.size() < slots_) {
     slot_offset_.resize(slots_, static_cast<long long int>(0));
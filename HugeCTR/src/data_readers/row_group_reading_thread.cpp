@@ -17,6 +17,7 @@
 #include <data_readers/row_group_reading_thread.hpp>
 #include <map>
 #include <string>
+#include <vector>
 namespace HugeCTR {
 
 // static std::map<BufferState, std::string> stat_str;
@@ -173,7 +174,9 @@ Error_t RowGroupReadingThread<T>::get_one_read_group(
   }
   CudaDeviceContext ctx(device_id_);
   auto tbl_w_metadata = source_->read_group(this->local_row_group_id_, this->memory_resource_);
-  this->local_row_group_id_ += this->strict_order_of_batches_ ? this->num_workers_ : 1;
+  this->local_row_group_id_ += this->num_workers_;
+  // decode the next row group of this worker while the current one is dumped and consumed
+  source_->prefetch_group(this->local_row_group_id_, this->memory_resource_);
   tbl_w_metadata.tbl.swap(this->cached_df_);
   cudf::table_view data_view = cached_df_->view();
   dump_table_data_to(data_view, dense_idx_to_parquet_col_, categorical_idx_parquet_col_, params,
@@ -209,6 +212,24 @@ void RowGroupReadingThread<T>::read_new_file(long long expected_row_groups) {
       if (metadata.get_metadata_status()) {
         auto label_col_names = metadata.get_label_names();
         auto dense_col_names = metadata.get_cont_names();
+        auto cat_col_names = metadata.get_cat_names();
+
+        // Only decode the used columns. They are projected in the order of the file, so the
+        // column of the table is the rank of the parquet column among the used ones.
+        std::map<int, std::string> used_cols;
+        for (auto cols : {&label_col_names, &dense_col_names, &cat_col_names}) {
+          for (auto& c : *cols) {
+            used_cols.emplace(c.index, c.col_name);
+          }
+        }
+        std::map<int, int> table_col;
+        std::vector<std::string> projection;
+        for (auto& [index, name] : used_cols) {
+          table_col.emplace(index, static_cast<int>(projection.size()));
+          projection.push_back(name);
+        }
+        source->set_column_projection(projection);
+
         if (dense_idx_to_parquet_col_.size() != (label_col_names.size() + dense_col_names.size())) {
           int i = 0;
           dense_idx_to_parquet_col_.clear();
@@ -217,7 +238,7 @@ void RowGroupReadingThread<T>::read_new_file(long long expected_row_groups) {
             tmp_col_index.insert(c.index);
           }
           for (auto it = tmp_col_index.begin(); it != tmp_col_index.end(); it++) {
-            dense_idx_to_parquet_col_.insert(std::make_pair(i, *it));
+            dense_idx_to_parquet_col_.insert(std::make_pair(i, table_col.at(*it)));
             i++;
           }
           tmp_col_index.clear();
@@ -225,13 +246,11 @@ void RowGroupReadingThread<T>::read_new_file(long long expected_row_groups) {
             tmp_col_index.insert(c.index);
           }
           for (auto it = tmp_col_index.begin(); it != tmp_col_index.end(); it++) {
-            dense_idx_to_parquet_col_.insert(std::make_pair(i, *it));
+            dense_idx_to_parquet_col_.insert(std::make_pair(i, table_col.at(*it)));
             i++;
           }
         }
         tmp_col_index.clear();
-
-        auto cat_col_names = metadata.get_cat_names();
         if (categorical_idx_parquet_col_.size() != cat_col_names.size()) {
           categorical_idx_parquet_col_.clear();
           int i = 0;
@@ -239,7 +258,7 @@ void RowGroupReadingThread<T>::read_new_file(long long expected_row_groups) {
             tmp_col_index.insert(c.index);
           }
           for (auto it = tmp_col_index.begin(); it != tmp_col_index.end(); it++) {
-            categorical_idx_parquet_col_.insert(std::make_pair(i, *it));
+            categorical_idx_parquet_col_.insert(std::make_pair(i, table_col.at(*it)));
             i++;
           }
         }
@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 
+#include <parallel_hashmap/phmap.h>
+
+#include <cstring>
 #include <embedding_training_cache/embedding_training_cache_impl.hpp>
 #include <sstream>
 #include <string>
@@ -38,13 +41,49 @@ EmbeddingTrainingCacheImpl<TypeKey>::EmbeddingTrainingCacheImpl(
     std::vector<SparseEmbeddingHashParams>& embedding_params,
     std::vector<std::string>& sparse_embedding_files,
     std::shared_ptr<ResourceManager> resource_manager, std::vector<std::string>& local_paths,
-    std::vector<HMemCacheConfig>& hmem_cache_configs)
+    std::vector<HMemCacheConfig>& hmem_cache_configs, bool async_tiering)
     : embeddings_(embeddings),
       ps_manager_(ps_types, sparse_embedding_files, get_embedding_type(embeddings),
                   embedding_params, get_max_embedding_size_(), resource_manager, local_paths,
-                  hmem_cache_configs) {
+                  hmem_cache_configs),
+      async_tiering_(async_tiering) {
   HCTR_LOG_S(WARNING, WORLD) << "EmbeddingTrainingCache will be deprecated in a future release"
                              << std::endl;
+  if (async_tiering_) {
+    // The parameter servers synchronize the ranks with MPI barriers, which must not run
+    // concurrently on two threads.
+    HCTR_THROW_IF(resource_manager->get_num_process() > 1, Error_t::WrongInput,
+                  "Asynchronous tiering is only supported with a single process");
+    tiering_thread_ = std::make_unique<ThreadPool>("etc tiering", TaskPriority::Dump, 1);
+    for (size_t i = 0; i < embeddings_.size(); i++) {
+      prefetch_bags_.push_back(ps_manager_.create_staging_bag());
+      write_back_bags_.push_back(ps_manager_.create_staging_bag());
+    }
+    prefetch_hit_sizes_.resize(embeddings_.size(), 0);
+    write_back_sizes_.resize(embeddings_.size(), 0);
+    HCTR_LOG(INFO, ROOT, "EmbeddingTrainingCache: asynchronous tiering enabled\n");
+  }
+}
+
+template <typename TypeKey>
+EmbeddingTrainingCacheImpl<TypeKey>::~EmbeddingTrainingCacheImpl() {
+  if (tiering_thread_) {
+    try {
+      wait_for_tiering_();
+    } catch (const std::exception& err) {
+      HCTR_LOG_S(ERROR, WORLD) << err.what() << std::endl;
+    }
+  }
+}
+
+template <typename TypeKey>
+void EmbeddingTrainingCacheImpl<TypeKey>::wait_for_tiering_() {
+  if (write_back_done_.valid()) {
+    write_back_done_.get();
+  }
+  if (prefetch_done_.valid()) {
+    prefetch_done_.get();
+  }
 }
 
 template <typename TypeKey>
@@ -71,6 +110,7 @@ void EmbeddingTrainingCacheImpl<TypeKey>::load_(std::vector<std::string>& keyset
 template <typename TypeKey>
 void EmbeddingTrainingCacheImpl<TypeKey>::dump() {
   try {
+    wait_for_tiering_();
     for (size_t i = 0; i < embeddings_.size(); i++) {
       auto ptr_ps = ps_manager_.get_parameter_server(i);
 
@@ -89,6 +129,10 @@ void EmbeddingTrainingCacheImpl<TypeKey>::dump() {
 
 template <typename TypeKey>
 void EmbeddingTrainingCacheImpl<TypeKey>::update(std::vector<std::string>& keyset_file_list) {
+  if (async_tiering_) {
+    update_async_(keyset_file_list);
+    return;
+  }
   try {
 #ifndef KEY_HIT_RATIO
     HCTR_LOG(INFO, ROOT, "Preparing embedding table for next pass\n");
@@ -114,10 +158,128 @@ void EmbeddingTrainingCacheImpl<TypeKey>::update(std::string& keyset_file) {
   update(keyset_file_list);
 }
 
+template <typename TypeKey>
+void EmbeddingTrainingCacheImpl<TypeKey>::update_async_(
+    std::vector<std::string>& keyset_file_list) {
+  try {
+    HCTR_THROW_IF(keyset_file_list.size() != embeddings_.size(), Error_t::WrongInput,
+                  "num of keyset_file and num of embeddings don't equal");
+    wait_for_tiering_();
+    const bool prefetched{prefetch_keyset_files_ == keyset_file_list};
+    prefetch_keyset_files_.clear();
+#ifndef KEY_HIT_RATIO
+    HCTR_LOG(INFO, ROOT, "Preparing embedding table for next pass (%s)\n",
+             prefetched ? "prefetched" : "not prefetched");
+#endif
+
+    for (size_t i = 0; i < embeddings_.size(); i++) {
+      embeddings_[i]->dump_parameters(write_back_bags_[i], &write_back_sizes_[i]);
+    }
+    for (auto& embedding : embeddings_) {
+      embedding->reset();
+      embedding->reset_optimizer();
+    }
+
+    if (prefetched) {
+      for (size_t i = 0; i < embeddings_.size(); i++) {
+        overlay_write_back_(i);
+        embeddings_[i]->load_parameters(prefetch_bags_[i], prefetch_hit_sizes_[i]);
+      }
+      write_back_done_ = tiering_thread_->submit([this]() {
+        for (size_t i = 0; i < embeddings_.size(); i++) {
+          ps_manager_.get_parameter_server(i)->push(write_back_bags_[i], write_back_sizes_[i]);
+        }
+      });
+    } else {
+      // Nothing to overlay, the parameter servers must be up to date before they are read.
+      for (size_t i = 0; i < embeddings_.size(); i++) {
+        ps_manager_.get_parameter_server(i)->push(write_back_bags_[i], write_back_sizes_[i]);
+      }
+      load_(keyset_file_list);
+    }
+  } catch (const std::exception& err) {
+    HCTR_LOG_S(ERROR, WORLD) << err.what() << std::endl;
+    throw;
+  }
+}
+
+template <typename TypeKey>
+void EmbeddingTrainingCacheImpl<TypeKey>::overlay_write_back_(size_t i) {
+  const BufferBag& dumped{write_back_bags_[i]};
+  BufferBag& prefetched{prefetch_bags_[i]};
+  size_t& hit_size{prefetch_hit_sizes_[i]};
+  const size_t dump_size{write_back_sizes_[i]};
+  const size_t vec_size{embeddings_[i]->get_embedding_params().embedding_vec_size};
+
+  const TypeKey* dumped_keys{Tensor2<TypeKey>::stretch_from(dumped.keys).get_ptr()};
+  const size_t* dumped_slot_ids{Tensor2<size_t>::stretch_from(dumped.slot_id).get_ptr()};
+  TypeKey* keys{Tensor2<TypeKey>::stretch_from(prefetched.keys).get_ptr()};
+  size_t* slot_ids{Tensor2<size_t>::stretch_from(prefetched.slot_id).get_ptr()};
+
+  phmap::flat_hash_map<TypeKey, size_t> rows;
+  rows.reserve(hit_size);
+  for (size_t row = 0; row < hit_size; row++) {
+    rows.emplace(keys[row], row);
+  }
+  const auto& keyset{ps_manager_.get_parameter_server(i)->get_keyset()};
+  const phmap::flat_hash_set<TypeKey> next_keys(keyset.begin(), keyset.end());
+
+  auto copy_row = [&](size_t src, size_t dst) {
+    memcpy(prefetched.embedding.get_ptr() + dst * vec_size,
+           dumped.embedding.get_ptr() + src * vec_size, vec_size * sizeof(float));
+    for (size_t s = 0; s < prefetched.opt_states.size(); s++) {
+      memcpy(prefetched.opt_states[s].get_ptr() + dst * vec_size,
+             dumped.opt_states[s].get_ptr() + src * vec_size, vec_size * sizeof(float));
+    }
+  };
+
+  // Vectors trained in the last pass replace the stale prefetched ones. Keys that the last pass
+  // created are not in the parameter server yet, so they are appended if the next pass uses them.
+  for (size_t row = 0; row < dump_size; row++) {
+    const TypeKey key{dumped_keys[row]};
+    const auto it{rows.find(key)};
+    if (it != rows.end()) {
+      copy_row(row, it->second);
+    } else if (next_keys.count(key)) {
+      keys[hit_size] = key;
+      slot_ids[hit_size] = dumped_slot_ids[row];
+      copy_row(row, hit_size);
+      hit_size++;
+    }
+  }
+}
+
+template <typename TypeKey>
+void EmbeddingTrainingCacheImpl<TypeKey>::prefetch(std::vector<std::string>& keyset_file_list) {
+  if (!async_tiering_) {
+    return;
+  }
+  HCTR_THROW_IF(keyset_file_list.size() != embeddings_.size(), Error_t::WrongInput,
+                "num of keyset_file and num of embeddings don't equal");
+  if (prefetch_done_.valid()) {
+    prefetch_done_.get();
+  }
+  prefetch_keyset_files_ = keyset_file_list;
+  prefetch_done_ = tiering_thread_->submit([this, keyset_file_list]() {
+    for (size_t i = 0; i < ps_manager_.get_size(); i++) {
+      auto ptr_ps = ps_manager_.get_parameter_server(i);
+      ptr_ps->load_keyset_from_file(keyset_file_list[i]);
+      ptr_ps->pull(prefetch_bags_[i], prefetch_hit_sizes_[i]);
+    }
+  });
+}
+
+template <typename TypeKey>
+void EmbeddingTrainingCacheImpl<TypeKey>::prefetch(std::string& keyset_file) {
+  std::vector<std::string> keyset_file_list(embeddings_.size(), keyset_file);
+  prefetch(keyset_file_list);
+}
+
 template <typename TypeKey>
 std::vector<std::pair<std::vector<long long>, std::vector<float>>>
 EmbeddingTrainingCacheImpl<TypeKey>::get_incremental_model(
     const std::vector<long long>& keys_to_load) {
+  wait_for_tiering_();
   std::vector<std::pair<std::vector<long long>, std::vector<float>>> inc_model;
   size_t dump_size{0};
 
@@ -63,11 +63,14 @@ HMemCache<TypeKey>::HMemCache(size_t num_cached_pass, double target_hit_rate, si
       vec_per_line_{1 + OptParams::num_parameters_per_weight(opt_type)},
       resource_manager_{resource_manager},
       sparse_model_file_ptr_(std::make_shared<SparseModelFileTS<TypeKey>>(
-          sparse_model_file, local_path, use_slot_id, opt_type, emb_vec_size, resource_manager)) {
+          sparse_model_file, local_path, use_slot_id, opt_type, emb_vec_size, resource_manager)),
+      write_back_thread_{
+          std::make_unique<ThreadPool>("hmem-cache write-back", TaskPriority::Dump, 1)} {
   // +1 is reserved for a temp buffer
   key_idx_maps_.resize(num_block_ + 1);
   slot_ids_.resize(num_block_ + 1);
   cache_datas_.resize(num_block_ + 1);
+  is_dirty_.resize(num_block_ + 1, false);
 #pragma omp parallel for num_threads(num_block_ + 1)
   for (auto i = 0; i < num_block_ + 1; i++) {
     key_idx_maps_[i].reserve(block_capacity_);
@@ -81,6 +84,22 @@ HMemCache<TypeKey>::HMemCache(size_t num_cached_pass, double target_hit_rate, si
   }
 }
 
+template <typename TypeKey>
+HMemCache<TypeKey>::~HMemCache() {
+  try {
+    wait_for_write_back_();
+  } catch (const std::exception &err) {
+    HCTR_LOG_S(ERROR, WORLD) << err.what() << std::endl;
+  }
+}
+
+template <typename TypeKey>
+void HMemCache<TypeKey>::wait_for_write_back_() {
+  if (write_back_done_.valid()) {
+    write_back_done_.get();
+  }
+}
+
 template <typename TypeKey>
 std::pair<std::vector<long long>, std::vector<float>> HMemCache<TypeKey>::read(
     long long const *key_ptr, size_t len) {
@@ -113,6 +132,8 @@ void HMemCache<TypeKey>::read(TypeKey *key_ptr, size_t &len, size_t *slot_id_ptr
   if (data_ptrs.size() != vec_per_line_) {
     HCTR_OWN_THROW(Error_t::WrongInput, "Num of data files and pointers doesn't equal");
   }
+  // The keys of a block being written back are in neither the cache nor the file index
+  wait_for_write_back_();
   auto const num_thread{24};
   std::vector<std::vector<std::vector<TypeKey>>> sub_exist_keys(
       num_thread, std::vector<std::vector<TypeKey>>(2));
@@ -173,10 +194,13 @@ void HMemCache<TypeKey>::read(TypeKey *key_ptr, size_t &len, size_t *slot_id_ptr
   auto const tail_id{(head_id_ + 1) % num_block_};
   auto hit_rate{(len != 0) ? (1.0 * keys_vec[0].size() / len) : 0.};
 
-#pragma omp parallel for num_threads(24)
+  // The new block inherits the dirty vectors it copies from the cached blocks
+  bool hit_dirty{false};
+#pragma omp parallel for num_threads(24) reduction(|| : hit_dirty)
   for (size_t cnt = 0; cnt < idx_vecs[0].size(); cnt++) {
     size_t blk_idx{idx_vecs[0][cnt] / block_capacity_};
     size_t line_idx{idx_vecs[0][cnt] % block_capacity_};
+    hit_dirty = hit_dirty || is_dirty_[blk_idx];
     if (use_slot_id_) {
       slot_id_ptr[cnt] = slot_ids_[blk_idx][line_idx];
     }
@@ -241,10 +265,17 @@ void HMemCache<TypeKey>::read(TypeKey *key_ptr, size_t &len, size_t *slot_id_ptr
 
   if (!is_full_ || (hit_rate < target_hit_rate_ && pass_counter < max_num_evict_)) {
     if (is_full_) {
-      sparse_model_file_ptr_->dump_update(key_idx_maps_[num_block_], slot_ids_[num_block_],
-                                          cache_datas_[num_block_]);
+      // Clean blocks are identical to the file, only the dirty ones need to be written back
+      is_dirty_[num_block_] = is_dirty_[tail_id];
+      if (is_dirty_[num_block_]) {
+        write_back_done_ = write_back_thread_->submit([this]() {
+          sparse_model_file_ptr_->dump_update(key_idx_maps_[num_block_], slot_ids_[num_block_],
+                                              cache_datas_[num_block_]);
+        });
+      }
       pass_counter++;
     }
+    is_dirty_[tail_id] = hit_dirty;
     head_id_ = tail_id;
     if (!is_full_ && (head_id_ == num_block_ - 1)) {
       is_full_ = true;
@@ -257,6 +288,7 @@ void HMemCache<TypeKey>::read(TypeKey *key_ptr, size_t &len, size_t *slot_id_ptr
 template <typename TypeKey>
 void HMemCache<TypeKey>::write(const TypeKey *key_ptr, size_t len, size_t const *slot_id_ptr,
                                std::vector<float *> &data_ptrs) {
+  wait_for_write_back_();
   size_t const num_thread(24);
   std::vector<std::vector<std::vector<size_t>>> sub_src_idx_vecs(num_thread);
   std::vector<std::vector<std::vector<size_t>>> sub_dst_idx_vecs(num_thread);
@@ -354,6 +386,9 @@ void HMemCache<TypeKey>::write(const TypeKey *key_ptr, size_t len, size_t const
     }
   }
   sparse_model_file_ptr_->dump_insert(key_ptr, new_key_src_idx_vec, slot_id_ptr, data_ptrs);
+  for (auto dst_idx : dst_idx_vecs[0]) {
+    is_dirty_[dst_idx / block_capacity_] = true;
+  }
   {
     const double hit_rate{100.0 * src_idx_vecs[0].size() / len};
     HCTR_LOG_S(INFO, WORLD) << "HMEM-Cache PS: Hit rate [dump]: " << std::setprecision(4)
@@ -363,6 +398,7 @@ void HMemCache<TypeKey>::write(const TypeKey *key_ptr, size_t len, size_t const
 
 template <typename TypeKey>
 void HMemCache<TypeKey>::sync_to_ssd() {
+  wait_for_write_back_();
   if (!is_full_ && head_id_ == -1) return;
   auto num_blk{is_full_ ? num_block_ : (head_id_ + 1)};
   auto tail_id{is_full_ ? (head_id_ + 1) % num_block_ : 0};
@@ -373,8 +409,11 @@ void HMemCache<TypeKey>::sync_to_ssd() {
   }
   for (auto cnt{0}; cnt < num_blk; cnt++) {
     auto blk_idx{(tail_id + cnt) % num_block_};
-    sparse_model_file_ptr_->dump_update(key_idx_maps_[blk_idx], slot_ids_[blk_idx],
-                                        cache_datas_[blk_idx]);
+    if (is_dirty_[blk_idx]) {
+      sparse_model_file_ptr_->dump_update(key_idx_maps_[blk_idx], slot_ids_[blk_idx],
+                                          cache_datas_[blk_idx]);
+      is_dirty_[blk_idx] = false;
+    }
     if (resource_manager_->is_master_process()) {
       bar.progress(cnt + 1, num_blk);
     }
@@ -25,7 +25,8 @@ ParameterServerManager<TypeKey>::ParameterServerManager(
     std::vector<Embedding_t> embedding_types,
     std::vector<SparseEmbeddingHashParams>& embedding_params, size_t buffer_size,
     std::shared_ptr<ResourceManager> resource_manager, std::vector<std::string>& local_paths,
-    std::vector<HMemCacheConfig>& hmem_cache_configs) {
+    std::vector<HMemCacheConfig>& hmem_cache_configs)
+    : buffer_size_(buffer_size) {
   try {
     if (sparse_embedding_files.size() == 0)
       HCTR_OWN_THROW(Error_t::WrongInput,
@@ -97,6 +98,7 @@ ParameterServerManager<TypeKey>::ParameterServerManager(
         embedding_params.begin(), embedding_params.end(),
         [](auto const& a, auto const& b) { return a.embedding_vec_size < b.embedding_vec_size; });
     size_t const max_vec_size{it->embedding_vec_size};
+    max_vec_size_ = max_vec_size;
 
     it = std::max_element(embedding_params.begin(), embedding_params.end(),
                           [](auto const& a, auto const& b) {
@@ -167,6 +169,24 @@ ParameterServerManager<TypeKey>::ParameterServerManager(
   }
 }
 
+template <typename TypeKey>
+BufferBag ParameterServerManager<TypeKey>::create_staging_bag() {
+  BufferBag bag{buf_bag_};
+  auto host_blobs_buff{GeneralBuffer2<CudaHostAllocator>::create()};
+  Tensor2<TypeKey> tensor_keys;
+  Tensor2<size_t> tensor_slot_id;
+  host_blobs_buff->reserve({buffer_size_}, &tensor_keys);
+  host_blobs_buff->reserve({buffer_size_}, &tensor_slot_id);
+  host_blobs_buff->reserve({buffer_size_, max_vec_size_}, &(bag.embedding));
+  for (auto& opt_state : bag.opt_states) {
+    host_blobs_buff->reserve({buffer_size_, max_vec_size_}, &opt_state);
+  }
+  host_blobs_buff->allocate();
+  bag.keys = tensor_keys.shrink();
+  bag.slot_id = tensor_slot_id.shrink();
+  return bag;
+}
+
 template class ParameterServerManager<long long>;
 template class ParameterServerManager<unsigned>;
 
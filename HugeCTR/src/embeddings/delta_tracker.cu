@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <embeddings/delta_tracker.hpp>
+#include <utils.hpp>
+
+namespace HugeCTR {
+
+namespace {
+
+constexpr int kBlockSize = 256;
+constexpr size_t kMaxGridSize = 65536;
+constexpr int kBitsPerWord = 32;
+
+size_t grid_size(size_t num_threads) {
+  return std::max<size_t>(1, std::min((num_threads + kBlockSize - 1) / kBlockSize, kMaxGridSize));
+}
+
+template <typename TypeHashKey>
+__global__ void mark_rows_kernel(const TypeHashKey* keys, const size_t* value_index, size_t nnz,
+                                 size_t num_rows, uint32_t* marked, long long* row_keys) {
+  for (size_t i = blockIdx.x * static_cast<size_t>(blockDim.x) + threadIdx.x; i < nnz;
+       i += static_cast<size_t>(gridDim.x) * blockDim.x) {
+    const size_t row = value_index[i];
+    if (row >= num_rows) {
+      continue;
+    }
+    row_keys[row] = static_cast<long long>(keys[i]);
+    // The key is visible to extract_rows_kernel before the mark
+    __threadfence();
+    atomicOr(marked + row / kBitsPerWord, 1u << (row % kBitsPerWord));
+  }
+}
+
+// Takes up to staging_rows marked rows, unmarking each one before its key and vector are read
+__global__ void extract_rows_kernel(uint32_t* marked, size_t num_words, const long long* row_keys,
+                                    size_t staging_rows, size_t* rows, long long* keys,
+                                    unsigned long long* count) {
+  for (size_t w = blockIdx.x * static_cast<size_t>(blockDim.x) + threadIdx.x; w < num_words;
+       w += static_cast<size_t>(gridDim.x) * blockDim.x) {
+    uint32_t word = marked[w];
+    while (word != 0) {
+      const int bit = __ffs(word) - 1;
+      word &= word - 1;
+      const unsigned long long idx = atomicAdd(count, 1ull);
+      if (idx >= staging_rows) {
+        return;
+      }
+      atomicAnd(marked + w, ~(1u << bit));
+      __threadfence();
+      const size_t row = w * kBitsPerWord + bit;
+      rows[idx] = row;
+      keys[idx] = row_keys[row];
+    }
+  }
+}
+
+__global__ void gather_rows_kernel(const size_t* rows, const unsigned long long* count,
+                                   size_t staging_rows, const float* table,
+                                   size_t embedding_vec_size, float* vectors) {
+  const size_t num_rows = min(static_cast<size_t>(*count), staging_rows);
+  for (size_t r = blockIdx.x; r < num_rows; r += gridDim.x) {
+    for (size_t j = threadIdx.x; j < embedding_vec_size; j += blockDim.x) {
+      vectors[r * embedding_vec_size + j] = table[rows[r] * embedding_vec_size + j];
+    }
+  }
+}
+
+}  // namespace
+
+DeltaTracker::DeltaTracker(const int device_id, const cudaStream_t stream,
+                           const float* const table, const size_t num_rows,
+                           const size_t embedding_vec_size, const size_t staging_rows)
+    : device_id_(device_id),
+      stream_(stream),
+      table_(table),
+      num_rows_(num_rows),
+      embedding_vec_size_(embedding_vec_size),
+      staging_rows_(staging_rows) {
+  HCTR_CHECK_HINT(staging_rows_ > 0, "DeltaTracker needs at least one staging row.");
+  CudaDeviceContext context(device_id_);
+  const size_t num_words = (num_rows_ + kBitsPerWord - 1) / kBitsPerWord;
+  HCTR_LIB_THROW(cudaMalloc(&d_marked_, num_words * sizeof(uint32_t)));
+  HCTR_LIB_THROW(cudaMemsetAsync(d_marked_, 0, num_words * sizeof(uint32_t), stream_));
+  HCTR_LIB_THROW(cudaMalloc(&d_row_keys_, num_rows_ * sizeof(long long)));
+  HCTR_LIB_THROW(cudaMalloc(&d_rows_, staging_rows_ * sizeof(size_t)));
+  HCTR_LIB_THROW(cudaMalloc(&d_keys_, staging_rows_ * sizeof(long long)));
+  HCTR_LIB_THROW(cudaMalloc(&d_vectors_, staging_rows_ * embedding_vec_size_ * sizeof(float)));
+  HCTR_LIB_THROW(cudaMalloc(&d_count_, sizeof(unsigned long long)));
+  HCTR_LIB_THROW(cudaMallocHost(&h_keys_, staging_rows_ * sizeof(long long)));
+  HCTR_LIB_THROW(cudaMallocHost(&h_vectors_, staging_rows_ * embedding_vec_size_ * sizeof(float)));
+  HCTR_LIB_THROW(cudaMallocHost(&h_count_, sizeof(unsigned long long)));
+  HCTR_LIB_THROW(cudaStreamCreateWithFlags(&side_stream_, cudaStreamNonBlocking));
+  HCTR_LIB_THROW(cudaEventCreateWithFlags(&recorded_, cudaEventDisableTiming));
+}
+
+DeltaTracker::~DeltaTracker() {
+  CudaDeviceContext context(device_id_);
+  HCTR_LIB_CHECK_(cudaStreamSynchronize(side_stream_));
+  HCTR_LIB_CHECK_(cudaEventDestroy(recorded_));
+  HCTR_LIB_CHECK_(cudaStreamDestroy(side_stream_));
+  HCTR_LIB_CHECK_(cudaFreeHost(h_count_));
+  HCTR_LIB_CHECK_(cudaFreeHost(h_vectors_));
+  HCTR_LIB_CHECK_(cudaFreeHost(h_keys_));
+  HCTR_LIB_CHECK_(cudaFree(d_count_));
+  HCTR_LIB_CHECK_(cudaFree(d_vectors_));
+  HCTR_LIB_CHECK_(cudaFree(d_keys_));
+  HCTR_LIB_CHECK_(cudaFree(d_rows_));
+  HCTR_LIB_CHECK_(cudaFree(d_row_keys_));
+  HCTR_LIB_CHECK_(cudaFree(d_marked_));
+}
+
+template <typename TypeHashKey>
+void DeltaTracker::mark(const TypeHashKey* const keys, const size_t* const value_index,
+                        const size_t nnz) {
+  if (nnz == 0) {
+    return;
+  }
+  mark_rows_kernel<<<grid_size(nnz), kBlockSize, 0, stream_>>>(keys, value_index, nnz, num_rows_,
+                                                                d_marked_, d_row_keys_);
+  HCTR_LIB_THROW(cudaGetLastError());
+}
+
+void DeltaTracker::reset() {
+  CudaDeviceContext context(device_id_);
+  const size_t num_words = (num_rows_ + kBitsPerWord - 1) / kBitsPerWord;
+  HCTR_LIB_THROW(cudaMemsetAsync(d_marked_, 0, num_words * sizeof(uint32_t), stream_));
+}
+
+void DeltaTracker::record() {
+  CudaDeviceContext context(device_id_);
+  HCTR_LIB_THROW(cudaEventRecord(recorded_, stream_));
+}
+
+size_t DeltaTracker::extract() {
+  CudaDeviceContext context(device_id_);
+  HCTR_LIB_THROW(cudaStreamWaitEvent(side_stream_, recorded_, 0));
+  HCTR_LIB_THROW(cudaMemsetAsync(d_count_, 0, sizeof(unsigned long long), side_stream_));
+  const size_t num_words = (num_rows_ + kBitsPerWord - 1) / kBitsPerWord;
+  extract_rows_kernel<<<grid_size(num_words), kBlockSize, 0, side_stream_>>>(
+      d_marked_, num_words, d_row_keys_, staging_rows_, d_rows_, d_keys_, d_count_);
+  gather_rows_kernel<<<std::min(staging_rows_, kMaxGridSize), 128, 0, side_stream_>>>(
+      d_rows_, d_count_, staging_rows_, table_, embedding_vec_size_, d_vectors_);
+  HCTR_LIB_THROW(cudaMemcpyAsync(h_count_, d_count_, sizeof(unsigned long long),
+                                 cudaMemcpyDeviceToHost, side_stream_));
+  HCTR_LIB_THROW(cudaStreamSynchronize(side_stream_));
+
+  const size_t num_rows = std::min(static_cast<size_t>(*h_count_), staging_rows_);
+  HCTR_LIB_THROW(cudaMemcpyAsync(h_keys_, d_keys_, num_rows * sizeof(long long),
+                                 cudaMemcpyDeviceToHost, side_stream_));
+  HCTR_LIB_THROW(cudaMemcpyAsync(h_vectors_, d_vectors_,
+                                 num_rows * embedding_vec_size_ * sizeof(float),
+                                 cudaMemcpyDeviceToHost, side_stream_));
+  HCTR_LIB_THROW(cudaStreamSynchronize(side_stream_));
+  return num_rows;
+}
+
+template void DeltaTracker::mark<unsigned int>(const unsigned int*, const size_t*, size_t);
+template void DeltaTracker::mark<long long>(const long long*, const size_t*, size_t);
+
+}  // namespace HugeCTR
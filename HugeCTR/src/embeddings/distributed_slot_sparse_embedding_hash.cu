@@ -1091,12 +1091,31 @@ void DistributedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::init_em
   }
 }
 
+template <typename TypeHashKey, typename TypeEmbeddingComp>
+bool DistributedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::enable_delta_tracking(
+    size_t staging_rows) {
+  if (delta_trackers_.empty()) {
+    for (size_t id = 0; id < embedding_data_.get_resource_manager().get_local_gpu_count(); id++) {
+      delta_trackers_.push_back(std::make_shared<DeltaTracker>(
+          embedding_data_.get_local_gpu(id).get_device_id(),
+          embedding_data_.get_local_gpu(id).get_stream(), hash_table_value_tensors_[id].get_ptr(),
+          max_vocabulary_size_per_gpu_, embedding_data_.embedding_params_.embedding_vec_size,
+          staging_rows));
+    }
+  }
+  return true;
+}
+
 template <typename TypeHashKey, typename TypeEmbeddingComp>
 void DistributedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::reset() {
   CudaDeviceContext context;
   for (size_t i = 0; i < embedding_data_.get_resource_manager().get_local_gpu_count(); i++) {
     context.set_device(embedding_data_.get_local_gpu(i).get_device_id());
     hash_tables_[i]->clear(embedding_data_.get_local_gpu(i).get_stream());
+    // The rows go to other keys from now on.
+    if (!delta_trackers_.empty()) {
+      delta_trackers_[i]->reset();
+    }
     HugeCTR::UniformGenerator::fill(
         hash_table_value_tensors_[i], -0.05f, 0.05f,
         embedding_data_.get_local_gpu(i).get_sm_count(),
@@ -14,7 +14,10 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <core23/instrumentation.hpp>
 #include <embeddings/embedding_collection.hpp>
+#include <map>
 
 #include "embedding/dense_model_parallel_embedding.hpp"
 #include "embedding/hier_model_parallel_embedding.hpp"
@@ -22,6 +25,28 @@
 
 namespace embedding {
 
+namespace {
+
+// The stages which only run kernels on the local GPU, without any communication. The dense model
+// parallel local reduce is not one of them since it allreduces the hot rows.
+bool is_local_stage(Stage stage) {
+  switch (stage) {
+    case Stage::DPForward:
+    case Stage::MPModelForward:
+    case Stage::DenseMPModelForward:
+    case Stage::DPBackwardIndexCalculation:
+    case Stage::DPLocalReduce:
+    case Stage::MPBackwardIndexCalculation:
+    case Stage::MPLocalReduce:
+    case Stage::DenseMPBackwardIndexCalculation:
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
 EmbeddingCollection::EmbeddingCollection(
     std::shared_ptr<HugeCTR::ResourceManager> resource_manager,
     std::vector<std::shared_ptr<CoreResourceManager>> core,
@@ -32,19 +57,57 @@ EmbeddingCollection::EmbeddingCollection(
       ebc_param_(ebc_param),
       eval_ebc_param_(eval_ebc_param),
       emb_table_param_list_(emb_table_param_list) {
+  if (ebc_param_.sync_free_) {
+    for (auto &grouped_lookup_param : ebc_param_.grouped_lookup_params) {
+      HCTR_CHECK_HINT(
+          grouped_lookup_param.table_placement_strategy == TablePlacementStrategy::DataParallel &&
+              grouped_lookup_param.embedding_type == EmbeddingType::Sparse,
+          "sync_free supports data parallel tables with the sum or average combiner only.");
+    }
+    HCTR_CHECK_HINT(ebc_param_.sort_strategy_ == SortStrategy::Segmented,
+                    "sync_free does not support use_exclusive_keys.");
+    HCTR_CHECK_HINT(ebc_param_.keys_preprocess_strategy_ == KeysPreprocessStrategy::AddOffset,
+                    "sync_free requires static embedding tables.");
+    HCTR_CHECK_HINT(ebc_param_.num_gradient_accumulation_steps_ == 1,
+                    "sync_free does not support num_gradient_accumulation_steps > 1.");
+  }
+  if (ebc_param_.allreduce_strategy_ == AllreduceStrategy::Sparse) {
+    HCTR_CHECK_HINT(!ebc_param_.sync_free_, "sparse_allreduce does not support sync_free.");
+    HCTR_CHECK_HINT(ebc_param_.keys_preprocess_strategy_ == KeysPreprocessStrategy::AddOffset,
+                    "sparse_allreduce requires static embedding tables.");
+    HCTR_CHECK_HINT(ebc_param_.num_gradient_accumulation_steps_ == 1,
+                    "sparse_allreduce does not support num_gradient_accumulation_steps > 1.");
+  }
+  if (ebc_param_.deterministic_) {
+    // The concat combiner of model parallel tables and the sparse allreduce add with atomics.
+    for (auto &grouped_lookup_param : ebc_param_.grouped_lookup_params) {
+      HCTR_CHECK_HINT(grouped_lookup_param.embedding_type == EmbeddingType::Sparse,
+                      "deterministic supports the sum and average combiners only.");
+    }
+    HCTR_CHECK_HINT(ebc_param_.allreduce_strategy_ != AllreduceStrategy::Sparse,
+                    "deterministic does not support sparse_allreduce.");
+  }
+
   for (size_t i = 0; i < emb_table_param_list.size(); ++i) {
     embedding_optimizers_.push_back(emb_table_param_list[i].opt_param);
   }
 
   int num_gpus = resource_manager->get_local_gpu_count();
 
+  std::vector<int> table_id_to_vocabulary_size;
+  for (auto &table_param : emb_table_param_list) {
+    table_id_to_vocabulary_size.push_back(table_param.max_vocabulary_size);
+  }
+
   for (int gpu_id = 0; gpu_id < num_gpus; ++gpu_id) {
     HugeCTR::CudaDeviceContext context(core[gpu_id]->get_device_id());
 
     embedding_tables_.push_back(create_grouped_embedding_tables(resource_manager, core[gpu_id],
                                                                 ebc_param_, emb_table_param_list));
-    embeddings_.push_back(create_grouped_embeddings(core[gpu_id], ebc_param_));
-    eval_embeddings_.push_back(create_grouped_embeddings(core[gpu_id], eval_ebc_param_));
+    embeddings_.push_back(
+        create_grouped_embeddings(core[gpu_id], ebc_param_, table_id_to_vocabulary_size));
+    eval_embeddings_.push_back(
+        create_grouped_embeddings(core[gpu_id], eval_ebc_param_, table_id_to_vocabulary_size));
   }
 
   init_embedding_output_attrs(core);
@@ -122,6 +185,23 @@ void EmbeddingCollection::init_wgrad(std::vector<std::shared_ptr<CoreResourceMan
       }
     }
   }
+
+  if (ebc_param_.num_gradient_accumulation_steps_ > 1) {
+    std::vector<int> table_id_to_vocabulary_size;
+    for (auto &table_param : emb_table_param_list_) {
+      table_id_to_vocabulary_size.push_back(table_param.max_vocabulary_size);
+    }
+    wgrad_accumulators_.resize(num_gpus);
+    num_accumulated_steps_.resize(num_gpus);
+    for (int gpu_id = 0; gpu_id < num_gpus; ++gpu_id) {
+      for (size_t grouped_id = 0; grouped_id < wgrad_list_[gpu_id].size(); ++grouped_id) {
+        wgrad_accumulators_[gpu_id].emplace_back(core[gpu_id], ebc_param_, grouped_id,
+                                                 wgrad_list_[gpu_id][grouped_id],
+                                                 table_id_to_vocabulary_size);
+      }
+      num_accumulated_steps_[gpu_id].assign(wgrad_list_[gpu_id].size(), 0);
+    }
+  }
 }
 
 void EmbeddingCollection::init_peer_buffer(std::vector<std::shared_ptr<CoreResourceManager>> core) {
@@ -223,20 +303,78 @@ void EmbeddingCollection::cache_ddl_output(int gpu_id,
   }
 }
 
+void EmbeddingCollection::run_grouped_stage(Stage stage, int gpu_id,
+                                            const std::vector<size_t> &grouped_ids,
+                                            const std::function<void(size_t)> &run) {
+  // The backward network stages run their kernel before their all-to-all, so deferring the
+  // all-to-alls to the end of one NCCL group keeps them after the kernels they depend on. The
+  // forward ones cannot be merged since each group combines its own all-to-all output right away.
+  bool merge_all2all =
+      (stage == Stage::MPNetworkBackward || stage == Stage::DenseMPNetworkBackward) &&
+      ebc_param_.num_all2all_chunks_ == 1 && grouped_ids.size() > 1;
+  if (merge_all2all) {
+    HugeCTR::CudaDeviceContext context(resource_manager_->get_local_gpu(gpu_id)->get_device_id());
+    HCTR_LIB_THROW(ncclGroupStart());
+    for (size_t grouped_id : grouped_ids) run(grouped_id);
+    HCTR_LIB_THROW(ncclGroupEnd());
+    return;
+  }
+
+  // Only the stages without communication run concurrently. The groups of a table stay on the
+  // same stream since the lookups of dynamic tables may insert.
+  std::map<int, std::vector<size_t>> table_to_grouped_ids;
+  for (size_t grouped_id : grouped_ids) {
+    table_to_grouped_ids[ebc_param_.grouped_lookup_params[grouped_id].grouped_table_idx].push_back(
+        grouped_id);
+  }
+  if (!is_local_stage(stage) || table_to_grouped_ids.size() < 2) {
+    for (size_t grouped_id : grouped_ids) run(grouped_id);
+    return;
+  }
+
+  auto gpu = resource_manager_->get_local_gpu(gpu_id);
+  HugeCTR::CudaDeviceContext context(gpu->get_device_id());
+  const std::string stream_name = gpu->get_current_stream_name();
+  cudaStream_t stream = gpu->get_stream();
+  cudaEvent_t fork_event = gpu->get_event("ebc_fork_" + stream_name);
+  HCTR_LIB_THROW(cudaEventRecord(fork_event, stream));
+  for (auto &[table_id, table_grouped_ids] : table_to_grouped_ids) {
+    const std::string side_stream_name = stream_name + "_ebc_table" + std::to_string(table_id);
+    {
+      HugeCTR::StreamContext stream_context(gpu, side_stream_name);
+      HCTR_LIB_THROW(cudaStreamWaitEvent(gpu->get_stream(), fork_event));
+      for (size_t grouped_id : table_grouped_ids) run(grouped_id);
+    }
+    cudaEvent_t join_event = gpu->get_event("ebc_join_" + side_stream_name);
+    HCTR_LIB_THROW(cudaEventRecord(join_event, gpu->get_stream(side_stream_name)));
+    HCTR_LIB_THROW(cudaStreamWaitEvent(stream, join_event));
+  }
+}
+
+bool EmbeddingCollection::has_stage(Stage stage, bool is_train) const {
+  const auto &embeddings = is_train ? embeddings_[0] : eval_embeddings_[0];
+  return std::any_of(embeddings.begin(), embeddings.end(),
+                     [stage](const auto &embedding) { return embedding->is_valid_stage(stage); });
+}
+
 void EmbeddingCollection::forward_per_gpu(Stage stage, bool is_train, int gpu_id,
                                           const HugeCTR::DataDistributor::Result &input,
                                           core23::Tensor &output_buffer, int batch_size) {
   auto &embeddings = is_train ? embeddings_[gpu_id] : eval_embeddings_[gpu_id];
 
+  std::vector<size_t> grouped_ids;
   for (size_t grouped_id = 0; grouped_id < embeddings.size(); ++grouped_id) {
-    if (!embeddings[grouped_id]->is_valid_stage(stage)) continue;
+    if (embeddings[grouped_id]->is_valid_stage(stage)) grouped_ids.push_back(grouped_id);
+  }
+  run_grouped_stage(stage, gpu_id, grouped_ids, [&](size_t grouped_id) {
+    HCTR_NVTX_RANGE(stage_name(stage));
 
     ILookup *lookup = dynamic_cast<ILookup *>(get_table(gpu_id, grouped_id));
     EmbeddingOutput embedding_output{output_buffer, embedding_output_attrs_[gpu_id][grouped_id]};
 
     embeddings[grouped_id]->forward_per_gpu(stage, input[grouped_id], lookup, embedding_output,
                                             batch_size);
-  }
+  });
 }
 
 void EmbeddingCollection::forward_per_gpu(bool is_train, int gpu_id,
@@ -261,13 +399,17 @@ void EmbeddingCollection::forward_per_gpu(bool is_train, int gpu_id,
 void EmbeddingCollection::backward_per_gpu(Stage stage, int gpu_id,
                                            const HugeCTR::DataDistributor::Result &input,
                                            const core23::Tensor &top_grad, int batch_size) {
+  std::vector<size_t> grouped_ids;
   for (size_t grouped_id = 0; grouped_id < embeddings_[gpu_id].size(); ++grouped_id) {
-    if (!embeddings_[gpu_id][grouped_id]->is_valid_stage(stage)) continue;
+    if (embeddings_[gpu_id][grouped_id]->is_valid_stage(stage)) grouped_ids.push_back(grouped_id);
+  }
+  run_grouped_stage(stage, gpu_id, grouped_ids, [&](size_t grouped_id) {
+    HCTR_NVTX_RANGE(stage_name(stage));
 
     EmbeddingOutput top_grad_buffer{top_grad, embedding_output_attrs_[gpu_id][grouped_id]};
     embeddings_[gpu_id][grouped_id]->backward_per_gpu(stage, input[grouped_id], top_grad_buffer,
                                                       wgrad_list_[gpu_id][grouped_id], batch_size);
-  }
+  });
 }
 
 void EmbeddingCollection::backward_per_gpu(int gpu_id,
@@ -301,8 +443,24 @@ void EmbeddingCollection::update_per_gpu(int gpu_id, embedding::TablePlacementSt
     auto &wgrad = wgrad_list_[gpu_id][grouped_id];
 
     auto table = get_table(gpu_id, grouped_id);
-    table->update(wgrad.unique_keys, wgrad.num_unique_keys, wgrad.table_ids, wgrad.ev_start_indices,
-                  wgrad.data);
+    int num_steps = ebc_param_.num_gradient_accumulation_steps_;
+    if (num_steps == 1) {
+      table->update(wgrad.unique_keys, wgrad.num_unique_keys, wgrad.table_ids,
+                    wgrad.ev_start_indices, wgrad.data);
+      continue;
+    }
+
+    // The merged wgrad is the average over the micro-batches.
+    auto &accumulator = wgrad_accumulators_[gpu_id][grouped_id];
+    accumulator.accumulate(wgrad, 1.f / num_steps);
+    if (++num_accumulated_steps_[gpu_id][grouped_id] < num_steps) continue;
+
+    const auto &accumulated_wgrad = accumulator.get_accumulated_wgrad();
+    table->update(accumulated_wgrad.unique_keys, accumulated_wgrad.num_unique_keys,
+                  accumulated_wgrad.table_ids, accumulated_wgrad.ev_start_indices,
+                  accumulated_wgrad.data);
+    accumulator.clear();
+    num_accumulated_steps_[gpu_id][grouped_id] = 0;
   }
 }
 
@@ -321,4 +479,15 @@ void EmbeddingCollection::set_learning_rate(float lr) {
   }
 }
 
+void EmbeddingCollection::set_learning_rate_scheduler(
+    const HugeCTR::GpuLearningRateSchedulers &lr_scheds) {
+  HCTR_CHECK_HINT(lr_scheds.size() == embedding_tables_.size(),
+                  "need one learning rate scheduler per local GPU");
+  for (size_t gpu_id = 0; gpu_id < embedding_tables_.size(); ++gpu_id) {
+    for (auto &t : embedding_tables_[gpu_id]) {
+      t->set_device_learning_rate(lr_scheds[gpu_id]->get_learning_rate());
+    }
+  }
+}
+
 }  // namespace embedding
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <core23/logger.hpp>
+#include <cstring>
+#include <embeddings/embedding_hot_keys.hpp>
+#include <fstream>
+#include <functional>
+#include <numeric>
+
+namespace HugeCTR {
+
+std::vector<KeyFrequencies> sample_raw_key_frequencies(const std::string &file_name,
+                                                       const RawSampleLayout &layout,
+                                                       int64_t num_samples) {
+  HCTR_CHECK_HINT(layout.key_bytes == 4 || layout.key_bytes == 8,
+                  "key_bytes should be 4 or 8, got ", layout.key_bytes);
+  std::ifstream file(file_name, std::ifstream::binary);
+  HCTR_CHECK_HINT(file.is_open(), "Cannot open ", file_name, " to sample key frequencies.\n");
+
+  const size_t num_slots = layout.nnz_per_slot.size();
+  const size_t label_dense_bytes = (layout.label_dim + layout.dense_dim) * sizeof(int32_t);
+  const size_t num_keys_per_sample =
+      std::accumulate(layout.nnz_per_slot.begin(), layout.nnz_per_slot.end(), size_t{0});
+  const size_t sample_bytes = label_dense_bytes + num_keys_per_sample * layout.key_bytes;
+
+  std::vector<KeyFrequencies> frequencies(num_slots);
+  constexpr int64_t num_samples_per_read = 4096;
+  std::vector<char> buffer(num_samples_per_read * sample_bytes);
+  for (int64_t num_read = 0; num_read < num_samples;) {
+    int64_t num_batch_samples = std::min(num_samples_per_read, num_samples - num_read);
+    file.read(buffer.data(), num_batch_samples * sample_bytes);
+    num_batch_samples = file.gcount() / static_cast<int64_t>(sample_bytes);
+    if (num_batch_samples == 0) break;
+
+    for (int64_t i = 0; i < num_batch_samples; ++i) {
+      const char *keys = buffer.data() + i * sample_bytes + label_dense_bytes;
+      for (size_t slot = 0; slot < num_slots; ++slot) {
+        for (int j = 0; j < layout.nnz_per_slot[slot]; ++j, keys += layout.key_bytes) {
+          int64_t key;
+          if (layout.key_bytes == 4) {
+            uint32_t k;
+            std::memcpy(&k, keys, sizeof(k));
+            key = k;
+          } else {
+            std::memcpy(&key, keys, sizeof(key));
+          }
+          ++frequencies[slot][key];
+        }
+      }
+    }
+    num_read += num_batch_samples;
+  }
+  return frequencies;
+}
+
+std::vector<int64_t> select_hot_keys(const KeyFrequencies &frequencies, int64_t num_iterations,
+                                     int num_gpus, double all_to_all_bandwidth,
+                                     double all_reduce_bandwidth, int64_t max_num_hot_keys) {
+  if (num_gpus < 2 || num_iterations <= 0 || max_num_hot_keys <= 0) return {};
+
+  const double count_threshold = static_cast<double>(num_iterations) * num_gpus *
+                                 all_to_all_bandwidth / all_reduce_bandwidth * num_gpus /
+                                 (num_gpus - 1.);
+
+  std::vector<std::pair<int64_t, int64_t>> candidates;  // (count, key)
+  for (auto &[key, count] : frequencies) {
+    if (static_cast<double>(count) >= count_threshold) candidates.emplace_back(count, key);
+  }
+  if (static_cast<int64_t>(candidates.size()) > max_num_hot_keys) {
+    std::nth_element(candidates.begin(), candidates.begin() + max_num_hot_keys, candidates.end(),
+                     std::greater<>());
+    candidates.resize(max_num_hot_keys);
+  }
+
+  std::vector<int64_t> hot_keys;
+  hot_keys.reserve(candidates.size());
+  for (auto &candidate : candidates) {
+    hot_keys.push_back(candidate.second);
+  }
+  std::sort(hot_keys.begin(), hot_keys.end());
+  return hot_keys;
+}
+
+}  // namespace HugeCTR
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <embeddings/embedding_planner.hpp>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+#include <unordered_set>
+
+namespace HugeCTR {
+
+namespace {
+
+constexpr double kBytesPerElement = sizeof(float);
+
+// Both the forward and backward pass move every pooled embedding vector once.
+double model_parallel_comm_cost(const EmbeddingPlannerTableStats &table,
+                                const EmbeddingPlannerDeviceSpec &spec, int num_shards) {
+  double comm_bytes = 2.0 * spec.global_batch_size * table.ev_size * kBytesPerElement;
+  return comm_bytes / (spec.comm_bandwidth * 1e3) / num_shards;
+}
+
+double model_parallel_cost(const EmbeddingPlannerTableStats &table,
+                           const EmbeddingPlannerDeviceSpec &spec, int num_shards) {
+  double lookup_bytes =
+      spec.global_batch_size * table.keys_per_sample() * table.ev_size * kBytesPerElement;
+  return lookup_bytes / (spec.memory_bandwidth * 1e3) / num_shards +
+         model_parallel_comm_cost(table, spec, num_shards);
+}
+
+// Local lookup plus the dense allreduce of the table gradient, on every GPU.
+double data_parallel_cost(const EmbeddingPlannerTableStats &table,
+                          const EmbeddingPlannerDeviceSpec &spec) {
+  double lookup_bytes = static_cast<double>(spec.global_batch_size) / spec.num_gpus *
+                        table.keys_per_sample() * table.ev_size * kBytesPerElement;
+  double allreduce_bytes = 2.0 * table.vocabulary_size * table.ev_size * kBytesPerElement;
+  return lookup_bytes / (spec.memory_bandwidth * 1e3) +
+         allreduce_bytes / (spec.comm_bandwidth * 1e3);
+}
+
+struct Shard {
+  size_t table_idx;
+  double cost;
+  double comm_cost;
+  int64_t memory;
+};
+
+}  // namespace
+
+double EmbeddingShardPlan::imbalance() const {
+  if (gpu_cost.empty()) return 1.0;
+  double max_cost = *std::max_element(gpu_cost.begin(), gpu_cost.end());
+  double avg_cost = std::accumulate(gpu_cost.begin(), gpu_cost.end(), 0.0) / gpu_cost.size();
+  return avg_cost > 0 ? max_cost / avg_cost : 1.0;
+}
+
+std::string EmbeddingShardPlan::report() const {
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(2);
+  os << "Embedding shard plan for " << shard_matrix.size()
+     << " GPUs, imbalance (max / avg cost): " << imbalance() << "\n";
+  for (size_t gpu_id = 0; gpu_id < shard_matrix.size(); ++gpu_id) {
+    os << "  GPU " << gpu_id << ": cost " << gpu_cost[gpu_id] << " us, memory "
+       << gpu_memory[gpu_id] / static_cast<double>(1 << 30) << " GiB, tables:";
+    for (const auto &name : shard_matrix[gpu_id]) {
+      os << " " << name;
+    }
+    os << "\n";
+  }
+  for (const auto &strategy : shard_strategy) {
+    os << "  " << get_table_place_strategy(strategy) << ":";
+    for (const auto &name : get_table_group_strategy(strategy)) {
+      os << " " << name;
+    }
+    os << "\n";
+  }
+  return os.str();
+}
+
+EmbeddingShardPlan plan_embedding_sharding(const std::vector<EmbeddingPlannerTableStats> &tables,
+                                           const EmbeddingPlannerDeviceSpec &spec) {
+  HCTR_CHECK_HINT(spec.num_gpus >= 1, "num_gpus should be >= 1");
+  HCTR_CHECK_HINT(spec.global_batch_size >= 1, "global_batch_size should be >= 1");
+  HCTR_CHECK_HINT(spec.memory_bandwidth > 0 && spec.comm_bandwidth > 0,
+                  "memory_bandwidth and comm_bandwidth should be > 0");
+  const size_t num_gpus = spec.num_gpus;
+  HCTR_CHECK_HINT(spec.link_cost.empty() || spec.link_cost.size() == num_gpus,
+                  "link_cost should be empty or num_gpus x num_gpus");
+  for (const auto &row : spec.link_cost) {
+    HCTR_CHECK_HINT(row.size() == num_gpus, "link_cost should be num_gpus x num_gpus");
+  }
+  std::unordered_set<std::string> names;
+  for (const auto &table : tables) {
+    HCTR_CHECK_HINT(names.insert(table.name).second, "duplicate table name: ", table.name);
+    HCTR_CHECK_HINT(table.vocabulary_size > 0 && table.ev_size > 0,
+                    "vocabulary_size and ev_size of table ", table.name, " should be > 0");
+  }
+
+  EmbeddingShardPlan plan;
+  plan.shard_matrix.resize(spec.num_gpus);
+  plan.gpu_cost.assign(spec.num_gpus, 0.0);
+  plan.gpu_memory.assign(spec.num_gpus, 0);
+
+  // Replicate the small tables.
+  std::vector<std::string> dp_names;
+  std::vector<size_t> mp_tables;
+  for (size_t i = 0; i < tables.size(); ++i) {
+    if (tables[i].num_bytes() <= spec.max_data_parallel_table_bytes) {
+      dp_names.push_back(tables[i].name);
+      for (int gpu_id = 0; gpu_id < spec.num_gpus; ++gpu_id) {
+        plan.shard_matrix[gpu_id].push_back(tables[i].name);
+        plan.gpu_cost[gpu_id] += data_parallel_cost(tables[i], spec);
+        plan.gpu_memory[gpu_id] += tables[i].num_bytes();
+      }
+    } else {
+      mp_tables.push_back(i);
+    }
+  }
+  int64_t free_memory = spec.memory_bytes_per_gpu - plan.gpu_memory[0];
+  HCTR_CHECK_HINT(mp_tables.empty() || free_memory > 0,
+                  "data parallel tables exceed memory_bytes_per_gpu");
+
+  // Split tables that do not fit on a single GPU, or that would dominate the GPU they are placed
+  // on, row-wise.
+  double target_cost = std::accumulate(plan.gpu_cost.begin(), plan.gpu_cost.end(), 0.0);
+  for (size_t i : mp_tables) {
+    target_cost += model_parallel_cost(tables[i], spec, 1);
+  }
+  target_cost /= spec.num_gpus;
+
+  std::vector<Shard> shards;
+  for (size_t i : mp_tables) {
+    double cost = model_parallel_cost(tables[i], spec, 1);
+    int64_t num_bytes = tables[i].num_bytes();
+    int num_shards = static_cast<int>(std::max<int64_t>(
+        (num_bytes + free_memory - 1) / std::max<int64_t>(free_memory, 1),
+        static_cast<int64_t>(std::ceil(cost / std::max(target_cost, 1e-12)))));
+    num_shards = std::min(std::max(num_shards, 1), spec.num_gpus);
+    for (int s = 0; s < num_shards; ++s) {
+      shards.push_back({i, model_parallel_cost(tables[i], spec, num_shards),
+                        model_parallel_comm_cost(tables[i], spec, num_shards),
+                        (num_bytes + num_shards - 1) / num_shards});
+    }
+  }
+  // Place the shards that are hardest to fit first, in terms of either cost or memory.
+  auto weight = [&](const Shard &shard) {
+    return std::max(shard.cost / std::max(target_cost, 1e-12),
+                    static_cast<double>(shard.memory) / free_memory);
+  };
+  std::stable_sort(shards.begin(), shards.end(), [&](const Shard &lhs, const Shard &rhs) {
+    return weight(lhs) > weight(rhs);
+  });
+
+  // The communication of a shard costs its link cost to the farthest shard of its table, relative
+  // to the cheapest link.
+  double min_link_cost = 0.0;
+  for (int i = 0; i < static_cast<int>(spec.link_cost.size()); ++i) {
+    for (int j = 0; j < spec.num_gpus; ++j) {
+      if (i != j && (min_link_cost == 0.0 || spec.link_cost[i][j] < min_link_cost)) {
+        min_link_cost = spec.link_cost[i][j];
+      }
+    }
+  }
+  auto link_penalty = [&](const Shard &shard, int gpu_id,
+                          const std::vector<std::unordered_set<size_t>> &gpu_tables) {
+    double max_link_cost = min_link_cost;
+    for (int other_gpu = 0; min_link_cost > 0.0 && other_gpu < spec.num_gpus; ++other_gpu) {
+      if (gpu_tables[other_gpu].count(shard.table_idx)) {
+        max_link_cost = std::max(max_link_cost, spec.link_cost[gpu_id][other_gpu]);
+      }
+    }
+    return min_link_cost > 0.0 ? shard.comm_cost * (max_link_cost / min_link_cost - 1.0) : 0.0;
+  };
+
+  // Shards of the same table go to distinct GPUs.
+  std::vector<std::unordered_set<size_t>> gpu_tables(spec.num_gpus);
+  for (const Shard &shard : shards) {
+    int best_gpu = -1;
+    double best_cost = 0.0;
+    for (int gpu_id = 0; gpu_id < spec.num_gpus; ++gpu_id) {
+      if (gpu_tables[gpu_id].count(shard.table_idx) ||
+          plan.gpu_memory[gpu_id] + shard.memory > spec.memory_bytes_per_gpu) {
+        continue;
+      }
+      double cost = plan.gpu_cost[gpu_id] + link_penalty(shard, gpu_id, gpu_tables);
+      if (best_gpu < 0 || cost < best_cost ||
+          (cost == best_cost && plan.gpu_memory[gpu_id] < plan.gpu_memory[best_gpu])) {
+        best_gpu = gpu_id;
+        best_cost = cost;
+      }
+    }
+    if (best_gpu < 0) {
+      HCTR_OWN_THROW(Error_t::OutOfMemory, "plan_embedding_sharding: cannot place table " +
+                                               tables[shard.table_idx].name +
+                                               " within memory_bytes_per_gpu");
+    }
+    plan.gpu_cost[best_gpu] = best_cost + shard.cost;
+    gpu_tables[best_gpu].insert(shard.table_idx);
+    plan.gpu_memory[best_gpu] += shard.memory;
+  }
+
+  // Keep the order of the tables in the shard matrix stable.
+  std::vector<std::string> mp_names;
+  for (size_t i : mp_tables) {
+    mp_names.push_back(tables[i].name);
+    for (int gpu_id = 0; gpu_id < spec.num_gpus; ++gpu_id) {
+      if (gpu_tables[gpu_id].count(i)) {
+        plan.shard_matrix[gpu_id].push_back(tables[i].name);
+      }
+    }
+  }
+  if (!mp_names.empty()) {
+    plan.shard_strategy.emplace_back("mp", mp_names);
+  }
+  if (!dp_names.empty()) {
+    plan.shard_strategy.emplace_back("dp", dp_names);
+  }
+  return plan;
+}
+
+}  // namespace HugeCTR
@@ -43,6 +43,7 @@ BatchIndices<dtype>::BatchIndices(std::vector<Model<dtype>>& models,
     frequent_compression_.emplace_back(max_num_frequent_categories, data_[i], models[i]);
     infrequent_selection_.emplace_back(data_[i], models[i]);
   }
+  stale_.resize(resource_manager_->get_local_gpu_count(), 0);
 }
 
 template <typename dtype>
@@ -55,8 +56,15 @@ void BatchIndices<dtype>::compute(int raw_device_id, size_t batch_size, cudaStre
 
   my_data.data_to_unique_categories(samples, stream);
 
+  recompute_indices(raw_device_id, stream);
+}
+
+template <typename dtype>
+void BatchIndices<dtype>::recompute_indices(int raw_device_id, cudaStream_t stream) {
+  auto& local_gpu = resource_manager_->get_local_gpu(raw_device_id);
   compute_indices(frequent_compression_[raw_device_id], infrequent_selection_[raw_device_id],
                   communication_type_, true, stream, local_gpu->get_sm_count());
+  stale_[raw_device_id] = 0;
 }
 
 template class BatchIndices<uint32_t>;
@@ -57,6 +57,7 @@ Model<dtype>::Model(const Model &model) {
   if (model.h_infrequent_model_table_offsets.size() > 0) {
     h_infrequent_model_table_offsets = model.h_infrequent_model_table_offsets;
   }
+  fixed_infrequent_location = model.fixed_infrequent_location;
 }
 
 template <typename dtype>
@@ -92,10 +93,12 @@ void Model<dtype>::init_params_and_reserve(CommunicationType communication_type_
 
 /// init_model calculates the optimal number of frequent categories
 /// given the calibration of the all-to-all and all-reduce.
+/// A non-zero max_num_frequent caps the number of frequent categories.
 template <typename dtype>
 void Model<dtype>::init_hybrid_model(const CalibrationData &calibration,
                                      Statistics<dtype> &statistics, const Data<dtype> &data,
-                                     Tensor2<dtype> &tmp_categories, cudaStream_t stream) {
+                                     Tensor2<dtype> &tmp_categories, cudaStream_t stream,
+                                     size_t max_num_frequent) {
   dtype *frequent_categories_ptr = tmp_categories.get_ptr();  // tmp_categories.get_ptr();
   // list the top categories sorted by count
   const Tensor2<dtype> &samples = data.samples;
@@ -117,6 +120,10 @@ void Model<dtype>::init_hybrid_model(const CalibrationData &calibration,
   num_frequent = ModelInitializationFunctors<dtype>::calculate_num_frequent_categories(
       communication_type, num_instances, calibration, statistics, data, d_num_frequent.get_ptr(),
       stream);
+  if (max_num_frequent > 0 && static_cast<size_t>(num_frequent) > max_num_frequent) {
+    // keep num_frequent a multiple of num_instances
+    num_frequent = static_cast<dtype>(max_num_frequent - max_num_frequent % num_instances);
+  }
   std::shared_ptr<GeneralBuffer2<CudaAllocator>> buf = GeneralBuffer2<CudaAllocator>::create();
   buf->reserve({(size_t)num_frequent, 1}, &this->frequent_categories);
   buf->allocate();
@@ -132,15 +139,25 @@ void Model<dtype>::init_hybrid_model(const CalibrationData &calibration,
    */
   statistics.calculate_frequent_and_infrequent_categories(
       frequent_categories_ptr, infrequent_categories_ptr, category_location.get_ptr(), num_frequent,
-      num_infrequent, stream);
+      num_infrequent, stream, fixed_infrequent_location);
   HCTR_LIB_THROW(cudaMemcpyAsync(this->frequent_categories.get_ptr(), frequent_categories_ptr,
                                  num_frequent * sizeof(dtype), cudaMemcpyDeviceToDevice, stream));
   /* Calculate frequent and infrequent table offsets */
   statistics.calculate_frequent_model_table_offsets(h_frequent_model_table_offsets,
                                                     frequent_categories_ptr, num_frequent, stream);
-  statistics.calculate_infrequent_model_table_offsets(h_infrequent_model_table_offsets,
-                                                      infrequent_categories_ptr, category_location,
-                                                      global_instance_id, num_infrequent, stream);
+  if (fixed_infrequent_location) {
+    // The slots of this instance are those of the categories c with c % num_instances equal to
+    // its id, in the order of c, including the slots of the frequent categories.
+    h_infrequent_model_table_offsets.resize(h_table_offsets.size());
+    for (size_t i = 0; i < h_table_offsets.size(); i++) {
+      h_infrequent_model_table_offsets[i] =
+          (h_table_offsets[i] + num_instances - 1 - global_instance_id) / num_instances;
+    }
+  } else {
+    statistics.calculate_infrequent_model_table_offsets(
+        h_infrequent_model_table_offsets, infrequent_categories_ptr, category_location,
+        global_instance_id, num_infrequent, stream);
+  }
   // statistics.revoke_temp_storage();
   /* A synchronization is necessary to ensure that the host arrays have been copied */
   HCTR_LIB_THROW(cudaStreamSynchronize(stream));
@@ -93,6 +93,20 @@ static __global__ void calculate_category_location_infrequent(
   }
 }
 
+// The infrequent slot of a category doesn't depend on the frequent categories, so that it is kept
+// when the model is re-calibrated
+template <typename dtype>
+static __global__ void calculate_category_location_infrequent_fixed(
+    const dtype *__restrict__ infrequent_categories, dtype *category_location,
+    size_t num_infrequent, size_t num_models) {
+  size_t tid = static_cast<size_t>(blockIdx.x) * static_cast<size_t>(blockDim.x) + threadIdx.x;
+  if (tid < num_infrequent) {
+    dtype category = infrequent_categories[tid];
+    category_location[2 * (size_t)category] = category % num_models;
+    category_location[2 * (size_t)category + 1] = category / num_models;
+  }
+}
+
 template <typename dtype>
 static __global__ void calculate_infrequent_model_table_offsets(
     const dtype *__restrict__ categories, const dtype *__restrict__ category_location,
@@ -298,7 +312,8 @@ void Statistics<dtype>::sort_categories_by_count(const dtype *samples, size_t nu
 template <typename dtype>
 void Statistics<dtype>::calculate_frequent_and_infrequent_categories(
     dtype *frequent_categories, dtype *infrequent_categories, dtype *category_location,
-    const size_t num_frequent, const size_t num_infrequent, cudaStream_t stream) {
+    const size_t num_frequent, const size_t num_infrequent, cudaStream_t stream,
+    bool fixed_infrequent_location) {
   // Fill with default value1
   constexpr size_t TPB_fill = 256;
   const size_t total_num_categories = num_categories + 1;  // Add NULL category
@@ -359,9 +374,15 @@ void Statistics<dtype>::calculate_frequent_and_infrequent_categories(
 
     constexpr size_t TPB_loc = 256;
     const size_t n_blocks_loc_infreq = (size_t)ceildiv<dtype>(num_infrequent, TPB_loc);
-    statistics_kernels::
-        calculate_category_location_infrequent<<<n_blocks_loc_infreq, TPB_loc, 0, stream>>>(
-            infrequent_categories, category_location, num_infrequent, num_instances);
+    if (fixed_infrequent_location) {
+      statistics_kernels::calculate_category_location_infrequent_fixed<<<n_blocks_loc_infreq,
+                                                                         TPB_loc, 0, stream>>>(
+          infrequent_categories, category_location, num_infrequent, num_instances);
+    } else {
+      statistics_kernels::
+          calculate_category_location_infrequent<<<n_blocks_loc_infreq, TPB_loc, 0, stream>>>(
+              infrequent_categories, category_location, num_infrequent, num_instances);
+    }
     HCTR_LIB_THROW(cudaPeekAtLastError());
   }
 }
@@ -32,6 +32,76 @@
 #include <vector>
 
 namespace HugeCTR {
+
+namespace recalibration_kernels {
+
+/* The staging buffer holds the old frequent vectors, followed by the vectors of the new frequent
+ * categories which were infrequent. Every instance stages the vectors it owns, zeros elsewhere, so
+ * that the staging buffer is complete after an all-reduce. */
+template <typename dtype>
+__global__ void stage_vectors(const dtype* __restrict__ old_category_location,
+                              const dtype* __restrict__ frequent_categories,
+                              const float* __restrict__ frequent_embedding_vectors,
+                              const float* __restrict__ infrequent_embedding_vectors,
+                              float* staging, uint32_t old_num_frequent, uint32_t num_frequent,
+                              uint32_t num_instances, uint32_t instance_id,
+                              uint32_t embedding_vec_size) {
+  for (uint32_t i = blockIdx.x; i < old_num_frequent + num_frequent; i += gridDim.x) {
+    const float* src = nullptr;
+    if (i < old_num_frequent) {
+      // in single-node, only the owner of a frequent category keeps its vector up to date
+      if (i / (old_num_frequent / num_instances) == instance_id) {
+        src = frequent_embedding_vectors + static_cast<size_t>(i) * embedding_vec_size;
+      }
+    } else {
+      const size_t category = frequent_categories[i - old_num_frequent];
+      if (old_category_location[2 * category] == instance_id) {
+        src = infrequent_embedding_vectors +
+              static_cast<size_t>(old_category_location[2 * category + 1]) * embedding_vec_size;
+      }
+    }
+    staging[static_cast<size_t>(i) * embedding_vec_size + threadIdx.x] =
+        src ? src[threadIdx.x] : 0.f;
+  }
+}
+
+/* Writes the vectors of the new frequent categories and of the old frequent categories which
+ * became infrequent in this instance. */
+template <typename dtype>
+__global__ void scatter_vectors(const dtype* __restrict__ old_category_location,
+                                const dtype* __restrict__ category_location,
+                                const dtype* __restrict__ old_frequent_categories,
+                                const dtype* __restrict__ frequent_categories,
+                                const float* __restrict__ staging,
+                                float* frequent_embedding_vectors,
+                                float* infrequent_embedding_vectors, uint32_t old_num_frequent,
+                                uint32_t num_frequent, uint32_t num_instances,
+                                uint32_t instance_id, uint32_t embedding_vec_size) {
+  for (uint32_t i = blockIdx.x; i < old_num_frequent + num_frequent; i += gridDim.x) {
+    float* dst = nullptr;
+    size_t src_row = i;
+    if (i < old_num_frequent) {
+      const size_t category = old_frequent_categories[i];
+      if (category_location[2 * category] == instance_id) {
+        dst = infrequent_embedding_vectors +
+              static_cast<size_t>(category_location[2 * category + 1]) * embedding_vec_size;
+      }
+    } else {
+      const uint32_t frequent_index = i - old_num_frequent;
+      const size_t category = frequent_categories[frequent_index];
+      if (old_category_location[2 * category] == num_instances) {
+        src_row = old_category_location[2 * category + 1];
+      }
+      dst = frequent_embedding_vectors + static_cast<size_t>(frequent_index) * embedding_vec_size;
+    }
+    if (dst) {
+      dst[threadIdx.x] = staging[src_row * embedding_vec_size + threadIdx.x];
+    }
+  }
+}
+
+}  // namespace recalibration_kernels
+
 template <typename dtype, typename emtype>
 HybridSparseEmbedding<dtype, emtype>::HybridSparseEmbedding(
     const SparseTensors<dtype> &train_input_tensors,
@@ -71,6 +141,12 @@ HybridSparseEmbedding<dtype, emtype>::HybridSparseEmbedding(
                      "local_gpu_count_");
     }
 
+    if (embedding_params_.recalibration_interval > 0 && graph_mode_) {
+      HCTR_OWN_THROW(Error_t::WrongInput,
+                     "the hybrid embedding can't be re-calibrated with CUDA graphs, the captured "
+                     "kernels would keep using the initial frequent categories");
+    }
+
     HCTR_LOG_S(INFO, ROOT) << "Using Hybrid Embedding with train batch " << get_batch_size(true)
                            << " and eval batch " << get_batch_size(false) << std::endl;
 
@@ -121,6 +197,7 @@ HybridSparseEmbedding<dtype, emtype>::HybridSparseEmbedding(
       model_.emplace_back(embedding_params_.communication_type,
                           resource_manager_->get_local_gpu(i)->get_global_id(),
                           num_instances_per_node, get_categories_num());
+      model_.back().fixed_infrequent_location = embedding_params_.recalibration_interval > 0;
     }
 
     // 2.3 construct calibration
@@ -433,7 +510,14 @@ void HybridSparseEmbedding<dtype, emtype>::init_model(const SparseTensors<dtype>
   }
   // free statistics_ memory
   // statistics_.clear();
-  data_statistics_.clear();
+  if (embedding_params_.recalibration_interval > 0) {
+    // the wgrad of a grouped all-reduce is sized for the initial frequent categories
+    max_num_frequent_recalibrated_ = grouped_all_reduce_
+                                         ? static_cast<size_t>(model_[0].num_frequent)
+                                         : embedding_params_.max_num_frequent_categories;
+  } else {
+    data_statistics_.clear();
+  }
 
   HCTR_LOG_S(INFO, ROOT) << "Initialized hybrid model with " << model_[0].num_frequent
                          << " frequent categories, probability of being frequent is "
@@ -489,6 +573,97 @@ void HybridSparseEmbedding<dtype, emtype>::setup_buffered_indices(bool is_train,
   }
 }
 
+template <typename dtype, typename emtype>
+void HybridSparseEmbedding<dtype, emtype>::recalibrate() {
+  size_t local_gpu_count = resource_manager_->get_local_gpu_count();
+  const size_t old_num_frequent = model_[0].num_frequent;
+#pragma omp parallel for num_threads(local_gpu_count)
+  for (size_t id = 0; id < local_gpu_count; ++id) {
+    auto &gpu = get_local_gpu(id);
+    CudaDeviceContext context(gpu.get_device_id());
+    auto stream = gpu.get_stream();
+    auto &model = model_[id];
+
+    std::shared_ptr<GeneralBuffer2<CudaAllocator>> buf = GeneralBuffer2<CudaAllocator>::create();
+    Tensor2<dtype> tmp_categories;
+    Tensor2<dtype> old_category_location;
+    buf->reserve({(size_t)statistics_[id].num_categories, 1}, &tmp_categories);
+    buf->reserve({model.category_location.get_num_elements(), 1}, &old_category_location);
+    buf->allocate();
+    HCTR_LIB_THROW(cudaMemcpyAsync(
+        old_category_location.get_ptr(), model.category_location.get_ptr(),
+        model.category_location.get_size_in_bytes(), cudaMemcpyDeviceToDevice, stream));
+    // the old frequent categories stay alive since init_hybrid_model allocates new ones
+    Tensor2<dtype> old_frequent_categories = model.frequent_categories;
+
+    model.init_hybrid_model(calibration_[id], statistics_[id], data_statistics_[id],
+                            tmp_categories, stream, max_num_frequent_recalibrated_);
+
+    const uint32_t num_frequent = model.num_frequent;
+    const uint32_t num_rows = old_num_frequent + num_frequent;
+    auto &frequent_vectors = get_frequent_embedding_data(id).frequent_embedding_vectors_;
+    auto &infrequent_vectors = get_infrequent_embedding_vectors(id);
+    if (num_rows > 0) {
+      std::shared_ptr<GeneralBuffer2<CudaAllocator>> staging_buf =
+          GeneralBuffer2<CudaAllocator>::create();
+      Tensor2<float> staging;
+      staging_buf->reserve({num_rows, get_embedding_vec_size()}, &staging);
+      staging_buf->allocate();
+
+      const int n_blocks = 8 * gpu.get_sm_count();
+      recalibration_kernels::stage_vectors<<<n_blocks, get_embedding_vec_size(), 0, stream>>>(
+          old_category_location.get_ptr(), model.frequent_categories.get_ptr(),
+          frequent_vectors.get_ptr(), infrequent_vectors.get_ptr(), staging.get_ptr(),
+          old_num_frequent, num_frequent, model.num_instances, model.global_instance_id,
+          get_embedding_vec_size());
+      HCTR_LIB_THROW(cudaPeekAtLastError());
+      HCTR_LIB_THROW(ncclAllReduce(staging.get_ptr(), staging.get_ptr(),
+                                   static_cast<size_t>(num_rows) * get_embedding_vec_size(),
+                                   NcclDataType<float>::getType(), ncclSum, gpu.get_nccl(),
+                                   stream));
+      recalibration_kernels::scatter_vectors<<<n_blocks, get_embedding_vec_size(), 0, stream>>>(
+          old_category_location.get_ptr(), model.category_location.get_ptr(),
+          old_frequent_categories.get_ptr(), model.frequent_categories.get_ptr(),
+          staging.get_ptr(), frequent_vectors.get_ptr(), infrequent_vectors.get_ptr(),
+          old_num_frequent, num_frequent, model.num_instances, model.global_instance_id,
+          get_embedding_vec_size());
+      HCTR_LIB_THROW(cudaPeekAtLastError());
+      // the next iteration doesn't wait for this stream, nor may the staging buffer be freed
+      // before the kernels are done
+      HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    }
+  }
+
+  // the indices of the cached batches were computed with the old model
+  for (auto &batch_indices : train_batch_indices_) {
+    batch_indices.invalidate();
+  }
+  for (auto &batch_indices : eval_batch_indices_) {
+    batch_indices.invalidate();
+  }
+
+  if (!grouped_all_reduce_ &&
+      ((embedding_params_.communication_type == CommunicationType::IB_NVLink_Hier) ||
+       (embedding_params_.communication_type == CommunicationType::IB_NVLink))) {
+    resource_manager_->get_ar_comm()->update_size(
+        frequent_embedding_handle_,
+        model_[0].num_frequent * embedding_params_.embedding_vec_size * sizeof(emtype));
+  }
+
+  HCTR_LOG_S(INFO, ROOT) << "Re-calibrated hybrid model with " << model_[0].num_frequent
+                         << " frequent categories (" << old_num_frequent
+                         << " before), probability of being frequent is "
+                         << model_[0].frequent_probability << std::endl;
+}
+
+template <typename dtype, typename emtype>
+void HybridSparseEmbedding<dtype, emtype>::recalibrate_if_due() {
+  const size_t interval = embedding_params_.recalibration_interval;
+  if (interval > 0 && num_train_iterations_ % interval == 0) {
+    recalibrate();
+  }
+}
+
 template <typename dtype, typename emtype>
 void HybridSparseEmbedding<dtype, emtype>::forward(bool is_train) {
   size_t local_gpu_count = resource_manager_->get_local_gpu_count();
@@ -594,6 +769,14 @@ void HybridSparseEmbedding<dtype, emtype>::assign_input_tensors(bool is_train, s
     train_inflight_id_ = inflight_id;
     current_train_batch_size_ = batch_size;
     current_train_batch_cached_ = cached;
+    if (embedding_params_.recalibration_interval > 0) {
+      num_train_iterations_++;
+      // an incomplete batch would count the NULL category
+      record_window_batch_ = batch_size == get_batch_size(true);
+      if (record_window_batch_) {
+        window_slot_ = num_window_batches_++ % embedding_params_.num_iterations_statistics;
+      }
+    }
   } else {
     eval_inflight_id_ = inflight_id;
     current_eval_batch_size_ = batch_size;
@@ -614,10 +797,14 @@ void HybridSparseEmbedding<dtype, emtype>::index_calculation(bool is_train, int
   if (is_train) {
     if (!current_train_batch_cached_) {
       batch_indices.compute(i, current_train_batch_size_, stream);
+    } else if (batch_indices.is_stale(i)) {
+      batch_indices.recompute_indices(i, stream);
     }
   } else {  // eval
     if (!current_eval_batch_cached_) {
       batch_indices.compute(i, current_eval_batch_size_, stream);
+    } else if (batch_indices.is_stale(i)) {
+      batch_indices.recompute_indices(i, stream);
     }
   }
 
@@ -625,6 +812,15 @@ void HybridSparseEmbedding<dtype, emtype>::index_calculation(bool is_train, int
   // Data type and indices
   get_frequent_embedding(i).set_current_indices(&batch_indices.get_frequent(i));
   get_infrequent_embedding(i).set_current_indices(&batch_indices.get_infrequent(i));
+
+  if (is_train && record_window_batch_) {
+    const size_t num_batch_samples =
+        get_batch_size(true) * embedding_params_.slot_size_array.size();
+    HCTR_LIB_THROW(cudaMemcpyAsync(
+        data_statistics_[i].samples.get_ptr() + window_slot_ * num_batch_samples,
+        get_frequent_embedding(i).data_->samples.get_ptr(), num_batch_samples * sizeof(dtype),
+        cudaMemcpyDeviceToDevice, stream));
+  }
 }
 
 template <typename dtype, typename emtype>
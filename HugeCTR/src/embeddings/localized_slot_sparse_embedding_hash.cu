@@ -1313,12 +1313,31 @@ void LocalizedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::init_embe
   return;
 }
 
+template <typename TypeHashKey, typename TypeEmbeddingComp>
+bool LocalizedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::enable_delta_tracking(
+    size_t staging_rows) {
+  if (delta_trackers_.empty()) {
+    for (size_t id = 0; id < embedding_data_.get_resource_manager().get_local_gpu_count(); id++) {
+      delta_trackers_.push_back(std::make_shared<DeltaTracker>(
+          embedding_data_.get_local_gpu(id).get_device_id(),
+          embedding_data_.get_local_gpu(id).get_stream(), hash_table_value_tensors_[id].get_ptr(),
+          max_vocabulary_size_per_gpu_, embedding_data_.embedding_params_.embedding_vec_size,
+          staging_rows));
+    }
+  }
+  return true;
+}
+
 template <typename TypeHashKey, typename TypeEmbeddingComp>
 void LocalizedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::reset() {
   CudaDeviceContext context;
   for (size_t i = 0; i < embedding_data_.get_resource_manager().get_local_gpu_count(); i++) {
     context.set_device(embedding_data_.get_local_gpu(i).get_device_id());
     hash_tables_[i]->clear(embedding_data_.get_local_gpu(i).get_stream());
+    // The rows go to other keys from now on.
+    if (!delta_trackers_.empty()) {
+      delta_trackers_[i]->reset();
+    }
 
     if (slot_size_array_.empty()) {
       HugeCTR::UniformGenerator::fill(
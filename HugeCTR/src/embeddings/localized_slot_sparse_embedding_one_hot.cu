@@ -196,16 +196,6 @@ LocalizedSlotSparseEmbeddingOneHot<TypeHashKey, TypeEmbeddingComp>::
         hash_value_index_tensors_.push_back(tensor);
       }
 
-      // new embedding features reduced by hash table values(results of forward)
-      {
-        Tensor2<TypeEmbeddingComp> tensor;
-        buf->reserve(
-            {embedding_data_.embedding_params_.get_universal_batch_size() * slot_num_per_gpu,
-             embedding_data_.embedding_params_.embedding_vec_size},
-            &tensor);
-        embedding_feature_tensors_.push_back(tensor);
-      }
-
       // new wgrad used by backward
       {
         Tensor2<TypeEmbeddingComp> tensor;
@@ -233,15 +223,8 @@ LocalizedSlotSparseEmbeddingOneHot<TypeHashKey, TypeEmbeddingComp>::
         hash_table_slot_id_tensors_.push_back(tensor);
       }
 
-      // temp tensors for all2all
-      {
-        Tensor2<TypeEmbeddingComp> tensor;
-        buf->reserve({embedding_data_.get_universal_batch_size_per_gpu() *
-                          embedding_data_.embedding_params_.slot_num,
-                      embedding_data_.embedding_params_.embedding_vec_size},
-                     &tensor);
-        all2all_tensors_.push_back(tensor);
-      }
+      // The forward and backward kernels store to and load from the output tensors of the peers
+      // directly, so there is no staging buffer for the all2all. These only back the utest helpers.
       {
         Tensor2<TypeEmbeddingComp> tensor;
         buf->reserve({embedding_data_.embedding_params_.get_universal_batch_size() *
@@ -465,16 +448,6 @@ LocalizedSlotSparseEmbeddingOneHot<TypeHashKey, TypeEmbeddingComp>::
         hash_value_index_tensors_.push_back(tensor);
       }
 
-      // new embedding features reduced by hash table values(results of forward)
-      {
-        Tensor2<TypeEmbeddingComp> tensor;
-        buf->reserve(
-            {embedding_data_.embedding_params_.get_universal_batch_size() * slot_num_per_gpu,
-             embedding_data_.embedding_params_.embedding_vec_size},
-            &tensor);
-        embedding_feature_tensors_.push_back(tensor);
-      }
-
       // new wgrad used by backward
       {
         Tensor2<TypeEmbeddingComp> tensor;
@@ -502,15 +475,8 @@ LocalizedSlotSparseEmbeddingOneHot<TypeHashKey, TypeEmbeddingComp>::
         hash_table_slot_id_tensors_.push_back(tensor);
       }
 
-      // temp tensors for all2all
-      {
-        Tensor2<TypeEmbeddingComp> tensor;
-        buf->reserve({embedding_data_.get_universal_batch_size_per_gpu() *
-                          embedding_data_.embedding_params_.slot_num,
-                      embedding_data_.embedding_params_.embedding_vec_size},
-                     &tensor);
-        all2all_tensors_.push_back(tensor);
-      }
+      // The forward and backward kernels store to and load from the output tensors of the peers
+      // directly, so there is no staging buffer for the all2all. These only back the utest helpers.
       {
         Tensor2<TypeEmbeddingComp> tensor;
         buf->reserve({embedding_data_.embedding_params_.get_universal_batch_size() *
@@ -28,9 +28,20 @@ NetworkExchangeWgrad<T>::NetworkExchangeWgrad(
   auto ar_comm = resource_manager_->get_ar_comm();
   ar_handle_ = ar_comm->register_coll();
 }
+
+template <typename T>
+NetworkExchangeWgrad<T>::~NetworkExchangeWgrad() {
+  for (auto& events : bucket_events_) {
+    for (auto& event : events) {
+      cudaEventDestroy(event);
+    }
+  }
+}
+
 template <typename T>
 void NetworkExchangeWgrad<T>::init_ar_comm(const std::vector<void*>& ptr, size_t sizes) {
   network_wgrad_size_ = sizes;
+  wgrad_ptrs_ = ptr;
   auto ar_comm = resource_manager_->get_ar_comm();
   for (size_t g = 0; g < num_gpus_; g++) {
     HCTR_CHECK_HINT(ptr[g], "buffer does not exist");
@@ -46,10 +57,65 @@ void NetworkExchangeWgrad<T>::update_embed_wgrad_size(size_t size) {
 
 template <typename T>
 void NetworkExchangeWgrad<T>::allreduce(size_t device_id, cudaStream_t stream) {
+  // the buckets were already reduced during the backward pass
+  if (!bucket_handles_.empty()) return;
   auto ar_comm = resource_manager_->get_ar_comm();
   ar_comm->all_reduce(ar_handle_, stream, device_id);
 }
 
+template <typename T>
+void NetworkExchangeWgrad<T>::init_buckets(const std::vector<std::pair<size_t, size_t>>& ranges) {
+  HCTR_CHECK_HINT(wgrad_ptrs_.size() == num_gpus_, "init_ar_comm must be called first");
+  auto ar_comm = resource_manager_->get_ar_comm();
+  for (auto [begin, end] : ranges) {
+    HCTR_CHECK_HINT(begin < end && end <= network_wgrad_size_, "invalid wgrad bucket");
+    auto handle = ar_comm->register_coll();
+    for (size_t g = 0; g < num_gpus_; g++) {
+      ar_comm->set_coll_buf(handle, static_cast<char*>(wgrad_ptrs_[g]) + begin, end - begin, g);
+    }
+    ar_comm->register_coll_buf(handle);
+    bucket_handles_.push_back(handle);
+  }
+
+  bucket_events_.resize(num_gpus_);
+  for (size_t g = 0; g < num_gpus_; g++) {
+    CudaDeviceContext context(resource_manager_->get_local_gpu(g)->get_device_id());
+    bucket_events_[g].resize(ranges.size() + 1);
+    for (auto& event : bucket_events_[g]) {
+      HCTR_LIB_THROW(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+    }
+  }
+}
+
+template <typename T>
+void NetworkExchangeWgrad<T>::allreduce_bucket(size_t bucket, size_t device_id,
+                                               cudaStream_t stream) {
+  auto ar_comm = resource_manager_->get_ar_comm();
+  auto& events = bucket_events_[device_id];
+  cudaStream_t ar_stream = resource_manager_->get_local_gpu(device_id)->get_stream("wgrad_ar", -1);
+
+  HCTR_LIB_THROW(cudaEventRecord(events[bucket], stream));
+  HCTR_LIB_THROW(cudaStreamWaitEvent(ar_stream, events[bucket]));
+  ar_comm->all_reduce(bucket_handles_[bucket], ar_stream, device_id);
+  // Joining the side stream back into stream also keeps a captured backward pass well-formed
+  if (bucket + 1 == bucket_handles_.size()) {
+    HCTR_LIB_THROW(cudaEventRecord(events.back(), ar_stream));
+    HCTR_LIB_THROW(cudaStreamWaitEvent(stream, events.back()));
+  }
+}
+
+template <typename T>
+void NetworkExchangeWgrad<T>::init_shards(const std::vector<void*>& wgrad_ptrs,
+                                          const std::vector<float*>& weight_ptrs,
+                                          size_t num_weights) {
+  HCTR_OWN_THROW(Error_t::IllegalCall, "Network wgrad exchange can't shard the optimizer!");
+}
+
+template <typename T>
+void NetworkExchangeWgrad<T>::all_gather_weights(size_t device_id, cudaStream_t stream) {
+  HCTR_OWN_THROW(Error_t::IllegalCall, "Network wgrad exchange can't shard the optimizer!");
+}
+
 template <typename T>
 GroupedExchangeWgrad<T>::GroupedExchangeWgrad(
     const std::shared_ptr<ResourceManager>& resource_manager)
@@ -83,8 +149,123 @@ void GroupedExchangeWgrad<T>::allreduce(size_t device_id, cudaStream_t stream) {
   ar_comm->all_reduce(ar_handle_, stream, device_id);
 }
 
+template <typename T>
+void GroupedExchangeWgrad<T>::init_buckets(const std::vector<std::pair<size_t, size_t>>& ranges) {
+  HCTR_OWN_THROW(Error_t::IllegalCall, "Grouped wgrad exchange can't split the wgrad buffer!");
+}
+
+template <typename T>
+void GroupedExchangeWgrad<T>::allreduce_bucket(size_t bucket, size_t device_id,
+                                               cudaStream_t stream) {
+  HCTR_OWN_THROW(Error_t::IllegalCall, "Grouped wgrad exchange can't split the wgrad buffer!");
+}
+
+template <typename T>
+void GroupedExchangeWgrad<T>::init_shards(const std::vector<void*>& wgrad_ptrs,
+                                          const std::vector<float*>& weight_ptrs,
+                                          size_t num_weights) {
+  HCTR_OWN_THROW(Error_t::IllegalCall, "Grouped wgrad exchange can't shard the optimizer!");
+}
+
+template <typename T>
+void GroupedExchangeWgrad<T>::all_gather_weights(size_t device_id, cudaStream_t stream) {
+  HCTR_OWN_THROW(Error_t::IllegalCall, "Grouped wgrad exchange can't shard the optimizer!");
+}
+
+template <typename T>
+ShardedExchangeWgrad<T>::ShardedExchangeWgrad(
+    const std::shared_ptr<ResourceManager>& resource_manager)
+    : resource_manager_(resource_manager), num_gpus_(resource_manager->get_local_gpu_count()) {}
+
+template <typename T>
+void ShardedExchangeWgrad<T>::init_ar_comm(const std::vector<void*>& ptr, size_t sizes) {
+  // The wgrads are exchanged through the NCCL communicators of the GPUs, see init_shards
+}
+
+template <typename T>
+void ShardedExchangeWgrad<T>::update_embed_wgrad_size(size_t size) {
+  HCTR_OWN_THROW(Error_t::IllegalCall, "Sharded wgrad exchange can't update embed wgrad size!");
+}
+
+template <typename T>
+void ShardedExchangeWgrad<T>::init_buckets(const std::vector<std::pair<size_t, size_t>>& ranges) {
+  HCTR_OWN_THROW(Error_t::IllegalCall, "Sharded wgrad exchange can't split the wgrad buffer!");
+}
+
+template <typename T>
+void ShardedExchangeWgrad<T>::allreduce_bucket(size_t bucket, size_t device_id,
+                                               cudaStream_t stream) {
+  HCTR_OWN_THROW(Error_t::IllegalCall, "Sharded wgrad exchange can't split the wgrad buffer!");
+}
+
+template <typename T>
+void ShardedExchangeWgrad<T>::init_shards(const std::vector<void*>& wgrad_ptrs,
+                                          const std::vector<float*>& weight_ptrs,
+                                          size_t num_weights) {
+  HCTR_CHECK_HINT(wgrad_ptrs.size() == num_gpus_ && weight_ptrs.size() == num_gpus_,
+                  "one wgrad and weight buffer per GPU is required");
+  HCTR_CHECK_HINT(num_weights >= resource_manager_->get_global_gpu_count(),
+                  "there are fewer dense weights than GPUs to shard them across");
+  wgrad_ptrs_.clear();
+  for (auto ptr : wgrad_ptrs) {
+    HCTR_CHECK_HINT(ptr, "buffer does not exist");
+    wgrad_ptrs_.push_back(static_cast<T*>(ptr));
+  }
+  weight_ptrs_ = weight_ptrs;
+  num_weights_ = num_weights;
+}
+
+template <typename T>
+void ShardedExchangeWgrad<T>::allreduce(size_t device_id, cudaStream_t stream) {
+  const auto& gpu_resource = resource_manager_->get_local_gpu(device_id);
+  const size_t num_ranks = resource_manager_->get_global_gpu_count();
+  T* wgrad = wgrad_ptrs_[device_id];
+  const ncclDataType_t type = NcclDataType<T>::getType();
+
+  // The sums outside of the shard of this GPU are left partial, its optimizer doesn't read them.
+  if (num_weights_ % num_ranks == 0) {
+    const size_t shard_size = num_weights_ / num_ranks;
+    const size_t rank = resource_manager_->get_gpu_global_id_from_local_id(device_id);
+    HCTR_LIB_THROW(ncclReduceScatter(wgrad, wgrad + rank * shard_size, shard_size, type, ncclSum,
+                                     gpu_resource->get_nccl(), stream));
+    return;
+  }
+  // A reduce-scatter needs shards of the same size
+  HCTR_LIB_THROW(ncclGroupStart());
+  for (size_t r = 0; r < num_ranks; r++) {
+    auto [begin, end] = get_weight_shard(num_weights_, r, num_ranks);
+    HCTR_LIB_THROW(ncclReduce(wgrad + begin, wgrad + begin, end - begin, type, ncclSum, r,
+                              gpu_resource->get_nccl(), stream));
+  }
+  HCTR_LIB_THROW(ncclGroupEnd());
+}
+
+template <typename T>
+void ShardedExchangeWgrad<T>::all_gather_weights(size_t device_id, cudaStream_t stream) {
+  const auto& gpu_resource = resource_manager_->get_local_gpu(device_id);
+  const size_t num_ranks = resource_manager_->get_global_gpu_count();
+  float* weight = weight_ptrs_[device_id];
+
+  if (num_weights_ % num_ranks == 0) {
+    const size_t shard_size = num_weights_ / num_ranks;
+    const size_t rank = resource_manager_->get_gpu_global_id_from_local_id(device_id);
+    HCTR_LIB_THROW(ncclAllGather(weight + rank * shard_size, weight, shard_size, ncclFloat32,
+                                 gpu_resource->get_nccl(), stream));
+    return;
+  }
+  HCTR_LIB_THROW(ncclGroupStart());
+  for (size_t r = 0; r < num_ranks; r++) {
+    auto [begin, end] = get_weight_shard(num_weights_, r, num_ranks);
+    HCTR_LIB_THROW(ncclBroadcast(weight + begin, weight + begin, end - begin, ncclFloat32, r,
+                                 gpu_resource->get_nccl(), stream));
+  }
+  HCTR_LIB_THROW(ncclGroupEnd());
+}
+
 template class NetworkExchangeWgrad<__half>;
 template class NetworkExchangeWgrad<float>;
 template class GroupedExchangeWgrad<__half>;
 template class GroupedExchangeWgrad<float>;
+template class ShardedExchangeWgrad<__half>;
+template class ShardedExchangeWgrad<float>;
 }  // namespace HugeCTR
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+
+#include <common.hpp>
+#include <cstdio>
+#include <fstream>
+#include <gemm_algo_cache.hpp>
+#include <initializer_list>
+#include <sstream>
+
+namespace HugeCTR {
+
+namespace {
+
+// The GPU, driver and cuBLASLt an algorithm was picked for
+std::string device_key() {
+  int device_id = 0;
+  HCTR_LIB_THROW(cudaGetDevice(&device_id));
+  cudaDeviceProp prop;
+  HCTR_LIB_THROW(cudaGetDeviceProperties(&prop, device_id));
+  int driver_version = 0;
+  HCTR_LIB_THROW(cudaDriverGetVersion(&driver_version));
+  std::ostringstream key;
+  key << prop.name << " sm" << prop.major << prop.minor << " x" << prop.multiProcessorCount
+      << " driver" << driver_version << " cublasLt" << cublasLtGetVersion();
+  return key.str();
+}
+
+// The attributes of cuBLASLt descriptors have different sizes, which must be passed exactly.
+template <typename Desc, typename Attr, typename GetAttribute>
+int64_t get_attribute(GetAttribute get_attribute_func, Desc desc, Attr attr) {
+  size_t size = 0;
+  HCTR_LIB_THROW(get_attribute_func(desc, attr, nullptr, 0, &size));
+  HCTR_THROW_IF(size > sizeof(int64_t), Error_t::UnspecificError,
+                "Unexpected size of the cuBLASLt attribute ", static_cast<int>(attr), ".");
+  int64_t value = 0;
+  HCTR_LIB_THROW(get_attribute_func(desc, attr, &value, size, &size));
+  return value;
+}
+
+std::string lt_gemm_key(cublasLtMatmulDesc_t op_desc,
+                        std::initializer_list<cublasLtMatrixLayout_t> layouts,
+                        size_t workspace_size) {
+  std::ostringstream key;
+  key << "Lt";
+  for (auto attr : {CUBLASLT_MATMUL_DESC_COMPUTE_TYPE, CUBLASLT_MATMUL_DESC_SCALE_TYPE,
+                    CUBLASLT_MATMUL_DESC_TRANSA, CUBLASLT_MATMUL_DESC_TRANSB,
+                    CUBLASLT_MATMUL_DESC_EPILOGUE}) {
+    key << ' ' << get_attribute(cublasLtMatmulDescGetAttribute, op_desc, attr);
+  }
+  for (auto layout : layouts) {
+    key << " |";
+    for (auto attr : {CUBLASLT_MATRIX_LAYOUT_TYPE, CUBLASLT_MATRIX_LAYOUT_ORDER,
+                      CUBLASLT_MATRIX_LAYOUT_ROWS, CUBLASLT_MATRIX_LAYOUT_COLS,
+                      CUBLASLT_MATRIX_LAYOUT_LD, CUBLASLT_MATRIX_LAYOUT_BATCH_COUNT}) {
+      key << ' ' << get_attribute(cublasLtMatrixLayoutGetAttribute, layout, attr);
+    }
+  }
+  key << " | " << workspace_size;
+  return key.str();
+}
+
+std::string gemm_ex_key(const std::vector<int64_t>& gemm_ex) {
+  std::ostringstream key;
+  key << "GemmEx";
+  for (auto param : gemm_ex) {
+    key << ' ' << param;
+  }
+  return key.str();
+}
+
+std::string to_hex(const void* data, size_t size) {
+  static const char digits[] = "0123456789abcdef";
+  std::string hex;
+  for (size_t i = 0; i < size; i++) {
+    const unsigned char byte = static_cast<const unsigned char*>(data)[i];
+    hex.push_back(digits[byte >> 4]);
+    hex.push_back(digits[byte & 0xf]);
+  }
+  return hex;
+}
+
+bool from_hex(const std::string& hex, void* data, size_t size) {
+  if (hex.size() != 2 * size) {
+    return false;
+  }
+  for (size_t i = 0; i < size; i++) {
+    unsigned int byte = 0;
+    if (std::sscanf(hex.c_str() + 2 * i, "%2x", &byte) != 1) {
+      return false;
+    }
+    static_cast<unsigned char*>(data)[i] = static_cast<unsigned char>(byte);
+  }
+  return true;
+}
+
+}  // namespace
+
+GemmAlgoCache& GemmAlgoCache::get() {
+  static GemmAlgoCache cache;
+  return cache;
+}
+
+void GemmAlgoCache::load(const std::string& path) {
+  std::string entries;
+  {
+    std::ifstream file(path);
+    if (file) {
+      std::ostringstream content;
+      content << file.rdbuf();
+      entries = content.str();
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    enabled_ = true;
+    path_ = path;
+  }
+  deserialize(entries);
+  HCTR_LOG_S(INFO, ROOT) << "Loaded the GEMM algorithms from " << path << std::endl;
+}
+
+void GemmAlgoCache::save() const {
+  const std::string entries = serialize();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!enabled_) {
+    return;
+  }
+  // Other processes may read the file while it is written, so it is written aside and renamed.
+  const std::string tmp_path = path_ + ".tmp" + std::to_string(getpid());
+  {
+    std::ofstream file(tmp_path, std::ios::trunc);
+    HCTR_THROW_IF(!file, Error_t::FileCannotOpen, "Cannot write the GEMM algorithms to ", tmp_path,
+                  ".");
+    file << entries;
+  }
+  HCTR_THROW_IF(std::rename(tmp_path.c_str(), path_.c_str()) != 0, Error_t::FileCannotOpen,
+                "Cannot save the GEMM algorithms to ", path_, ".");
+}
+
+std::string GemmAlgoCache::serialize() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string entries;
+  for (const auto& [key, algo] : entries_) {
+    entries += key + '\t' + algo + '\n';
+  }
+  return entries;
+}
+
+void GemmAlgoCache::deserialize(const std::string& entries) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::istringstream lines(entries);
+  std::string line;
+  while (std::getline(lines, line)) {
+    const size_t tab = line.rfind('\t');
+    if (tab != std::string::npos) {
+      entries_[line.substr(0, tab)] = line.substr(tab + 1);
+    }
+  }
+}
+
+bool GemmAlgoCache::find(const std::string& gemm, void* algo, size_t size) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!enabled_) {
+    return false;
+  }
+  auto it = entries_.find(device_key() + " | " + gemm);
+  return it != entries_.end() && from_hex(it->second, algo, size);
+}
+
+void GemmAlgoCache::insert(const std::string& gemm, const void* algo, size_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (enabled_) {
+    entries_[device_key() + " | " + gemm] = to_hex(algo, size);
+  }
+}
+
+bool GemmAlgoCache::find(cublasLtHandle_t handle, cublasLtMatmulDesc_t op_desc,
+                         cublasLtMatrixLayout_t a_desc, cublasLtMatrixLayout_t b_desc,
+                         cublasLtMatrixLayout_t c_desc, cublasLtMatrixLayout_t d_desc,
+                         size_t workspace_size, cublasLtMatmulAlgo_t* algo) const {
+  if (!enabled_) {
+    return false;
+  }
+  cublasLtMatmulAlgo_t cached_algo;
+  if (!find(lt_gemm_key(op_desc, {a_desc, b_desc, c_desc, d_desc}, workspace_size), &cached_algo,
+            sizeof(cached_algo))) {
+    return false;
+  }
+  cublasLtMatmulHeuristicResult_t result;
+  if (cublasLtMatmulAlgoCheck(handle, op_desc, a_desc, b_desc, c_desc, d_desc, &cached_algo,
+                              &result) != CUBLAS_STATUS_SUCCESS ||
+      result.workspaceSize > workspace_size) {
+    return false;
+  }
+  *algo = cached_algo;
+  return true;
+}
+
+void GemmAlgoCache::insert(cublasLtMatmulDesc_t op_desc, cublasLtMatrixLayout_t a_desc,
+                           cublasLtMatrixLayout_t b_desc, cublasLtMatrixLayout_t c_desc,
+                           cublasLtMatrixLayout_t d_desc, size_t workspace_size,
+                           const cublasLtMatmulAlgo_t& algo) {
+  if (enabled_) {
+    insert(lt_gemm_key(op_desc, {a_desc, b_desc, c_desc, d_desc}, workspace_size), &algo,
+           sizeof(algo));
+  }
+}
+
+bool GemmAlgoCache::find(const std::vector<int64_t>& gemm_ex, cublasGemmAlgo_t* algo) const {
+  if (!enabled_) {
+    return false;
+  }
+  int32_t cached_algo = 0;
+  if (!find(gemm_ex_key(gemm_ex), &cached_algo, sizeof(cached_algo))) {
+    return false;
+  }
+  *algo = static_cast<cublasGemmAlgo_t>(cached_algo);
+  return true;
+}
+
+void GemmAlgoCache::insert(const std::vector<int64_t>& gemm_ex, cublasGemmAlgo_t algo) {
+  if (!enabled_) {
+    return;
+  }
+  const int32_t value = algo;
+  insert(gemm_ex_key(gemm_ex), &value, sizeof(value));
+}
+
+}  // namespace HugeCTR
@@ -24,18 +24,27 @@ namespace HugeCTR {
 namespace {
 
 __global__ void lr_update_kernel(float base_lr, size_t warmup_steps, size_t decay_start,
-                                 size_t decay_steps, float decay_power, float end_lr, size_t* step,
+                                 size_t decay_steps, float decay_power, float end_lr,
+                                 LrPolicy_t policy, float decay_rate, size_t* step,
                                  float* current_lr, float* last_lr) {
   size_t step_val = *step;
   *step = step_val + 1;
   if (step_val < warmup_steps) {
     *current_lr = step_val * base_lr / warmup_steps;
     *last_lr = *current_lr;
+  } else if (policy == LrPolicy_t::step && step_val >= decay_start) {
+    float lr = base_lr * powf(decay_rate, (step_val - decay_start) / decay_steps);
+    *current_lr = lr > end_lr ? lr : end_lr;
+    *last_lr = *current_lr;
   } else if (step_val >= decay_start && step_val < decay_start + decay_steps) {
     size_t decayed_steps = step_val - decay_start;
-    float scale = pow((decay_steps - decayed_steps) / ((float)decay_steps), decay_power);
-    *current_lr = base_lr * scale > end_lr ? base_lr * scale : end_lr;
-    ;
+    if (policy == LrPolicy_t::cosine) {
+      float scale = 0.5f * (1.f + cospif(decayed_steps / (float)decay_steps));
+      *current_lr = end_lr + (base_lr - end_lr) * scale;
+    } else {
+      float scale = pow((decay_steps - decayed_steps) / ((float)decay_steps), decay_power);
+      *current_lr = base_lr * scale > end_lr ? base_lr * scale : end_lr;
+    }
     *last_lr = *current_lr;
   } else {
     if (decay_steps > 0) {
@@ -51,26 +60,33 @@ __global__ void lr_update_kernel(float base_lr, size_t warmup_steps, size_t deca
 GpuLearningRateScheduler::GpuLearningRateScheduler(float base_lr, size_t warmup_steps,
                                                    size_t decay_start, size_t decay_steps,
                                                    float decay_power, float end_lr,
-                                                   const std::shared_ptr<GPUResource>& gpu_resource)
+                                                   const std::shared_ptr<GPUResource>& gpu_resource,
+                                                   LrPolicy_t policy, float decay_rate)
     : base_lr_(base_lr),
       warmup_steps_(warmup_steps),
       decay_start_(decay_start),
       decay_steps_(decay_steps),
       decay_power_(decay_power),
       end_lr_(end_lr),
+      policy_(policy),
+      decay_rate_(decay_rate),
       gpu_resource_(gpu_resource) {
   if (base_lr < 0 || decay_power < 1.0f || end_lr < 0.f) {
     HCTR_OWN_THROW(Error_t::WrongInput, "base_lr < 0 || decay_power < 1.0 || end_lr < 0.f");
   }
+  if (policy == LrPolicy_t::step && (decay_steps == 0 || decay_rate <= 0.f || decay_rate > 1.f)) {
+    HCTR_OWN_THROW(Error_t::WrongInput,
+                   "LrPolicy_t::step needs decay_steps > 0 and decay_rate in (0, 1]");
+  }
 
   CudaDeviceContext context(gpu_resource_->get_device_id());
   HCTR_LIB_THROW(cudaMalloc(&step_, sizeof(size_t)));
   HCTR_LIB_THROW(cudaMalloc(&current_lr_, sizeof(float)));
   HCTR_LIB_THROW(cudaMalloc(&last_lr_, sizeof(float)));
   initialize_array<<<1, 1, 0, gpu_resource_->get_stream()>>>(step_, 1, (size_t)0);
-  lr_update_kernel<<<1, 1, 0, gpu_resource_->get_stream()>>>(base_lr_, warmup_steps_, decay_start_,
-                                                             decay_steps_, decay_power_, end_lr_,
-                                                             step_, current_lr_, last_lr_);
+  lr_update_kernel<<<1, 1, 0, gpu_resource_->get_stream()>>>(
+      base_lr_, warmup_steps_, decay_start_, decay_steps_, decay_power_, end_lr_, policy_,
+      decay_rate_, step_, current_lr_, last_lr_);
 }
 
 GpuLearningRateScheduler::~GpuLearningRateScheduler() {
@@ -81,9 +97,9 @@ GpuLearningRateScheduler::~GpuLearningRateScheduler() {
 
 void GpuLearningRateScheduler::update() {
   CudaDeviceContext context(gpu_resource_->get_device_id());
-  lr_update_kernel<<<1, 1, 0, gpu_resource_->get_stream()>>>(base_lr_, warmup_steps_, decay_start_,
-                                                             decay_steps_, decay_power_, end_lr_,
-                                                             step_, current_lr_, last_lr_);
+  lr_update_kernel<<<1, 1, 0, gpu_resource_->get_stream()>>>(
+      base_lr_, warmup_steps_, decay_start_, decay_steps_, decay_power_, end_lr_, policy_,
+      decay_rate_, step_, current_lr_, last_lr_);
 }
 
 float* GpuLearningRateScheduler::get_learning_rate() const { return current_lr_; }
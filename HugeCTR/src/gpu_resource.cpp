@@ -27,6 +27,7 @@ GPUResource::GPUResource(int device_id, size_t local_id, size_t global_id,
       local_id_(local_id),
       global_id_(global_id),
       stream_name_("default"),
+      replica_uniform_seed_(replica_uniform_seed),
       comm_(comm) {
   CudaDeviceContext context(device_id);
   HCTR_LIB_THROW(
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <core23/logger.hpp>
+#include <hps/admission_filter.hpp>
+
+namespace HugeCTR {
+
+// MurmurHash3 64-bit finalizer.
+static inline uint64_t admission_filter_mix(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+static float default_admission_threshold(const AdmissionPolicy_t policy) {
+  switch (policy) {
+    case AdmissionPolicy_t::Frequency:
+      return 2.f;
+    case AdmissionPolicy_t::Probabilistic:
+      return 0.1f;
+    default:
+      return 0.f;
+  }
+}
+
+template <typename Key>
+AdmissionFilter<Key>::AdmissionFilter(const AdmissionPolicy_t policy, const float threshold,
+                                      const size_t capacity)
+    : policy_{policy},
+      threshold_{threshold > 0 ? threshold : default_admission_threshold(policy)},
+      rng_{std::random_device{}()},
+      doorkeeper_capacity_{std::max<size_t>(capacity, 1024)} {
+  switch (policy_) {
+    case AdmissionPolicy_t::Frequency:
+      sketch_ = std::make_unique<CountMinSketch>(doorkeeper_capacity_, 4);
+      break;
+    case AdmissionPolicy_t::Probabilistic:
+      HCTR_CHECK_HINT(threshold_ <= 1, "Admission probability must be in (0, 1], got %f.\n",
+                      threshold_);
+      break;
+    case AdmissionPolicy_t::Doorkeeper:
+      // ~8 bits per key keep the false positive rate at ~3% with 3 hashes.
+      doorkeeper_bits_.resize((doorkeeper_capacity_ * 8 + 63) / 64);
+      break;
+    default:
+      break;
+  }
+}
+
+template <typename Key>
+bool AdmissionFilter<Key>::admit_key(const Key key) {
+  switch (policy_) {
+    case AdmissionPolicy_t::Frequency:
+      return static_cast<float>(sketch_->add(static_cast<uint64_t>(key))) >= threshold_;
+
+    case AdmissionPolicy_t::Probabilistic:
+      return dist_(rng_) < threshold_;
+
+    case AdmissionPolicy_t::Doorkeeper: {
+      const uint64_t num_bits{doorkeeper_bits_.size() * 64};
+      const uint64_t h1{admission_filter_mix(static_cast<uint64_t>(key))};
+      const uint64_t h2{admission_filter_mix(h1 ^ 0x9e3779b97f4a7c15ULL) | 1};
+      bool seen{true};
+      for (size_t i = 0; i < num_doorkeeper_hashes_; ++i) {
+        const uint64_t bit{(h1 + i * h2) % num_bits};
+        uint64_t& word{doorkeeper_bits_[bit / 64]};
+        const uint64_t mask{1ULL << (bit % 64)};
+        seen &= (word & mask) != 0;
+        word |= mask;
+      }
+      if (seen) {
+        return true;
+      }
+
+      // Start over once the doorkeeper is saturated, so that it keeps tracking recent traffic.
+      if (++num_doorkeeper_keys_ >= doorkeeper_capacity_) {
+        std::fill(doorkeeper_bits_.begin(), doorkeeper_bits_.end(), 0);
+        num_doorkeeper_keys_ = 0;
+      }
+      return false;
+    }
+
+    default:
+      return true;
+  }
+}
+
+template <typename Key>
+size_t AdmissionFilter<Key>::admit(const Key* const keys, const size_t num_keys,
+                                   uint64_t* const admitted_indices) {
+  size_t num_admitted{0};
+  {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < num_keys; ++i) {
+      if (admit_key(keys[i])) {
+        admitted_indices[num_admitted++] = i;
+      }
+    }
+  }
+  num_rejected_keys_ += num_keys - num_admitted;
+  return num_admitted;
+}
+
+template class AdmissionFilter<unsigned int>;
+template class AdmissionFilter<long long>;
+
+}  // namespace HugeCTR
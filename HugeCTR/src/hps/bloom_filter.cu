@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <common.hpp>
+#include <hps/bloom_filter.hpp>
+
+namespace HugeCTR {
+
+// MurmurHash3 64-bit finalizer.
+__device__ __forceinline__ uint64_t bloom_filter_mix(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+// Probe positions are derived through double hashing: bit_i = h1 + i * h2.
+template <typename Key>
+__device__ __forceinline__ void bloom_filter_hashes(const Key key, uint64_t& h1, uint64_t& h2) {
+  h1 = bloom_filter_mix(static_cast<uint64_t>(key));
+  h2 = bloom_filter_mix(h1 ^ 0x9e3779b97f4a7c15ULL) | 1;
+}
+
+template <typename Key>
+__global__ void bloom_filter_insert(uint32_t* const d_bits, const size_t num_words,
+                                    const size_t num_hashes, const Key* const d_keys,
+                                    const size_t num_keys) {
+  const size_t idx = blockIdx.x * blockDim.x + threadIdx.x;
+  if (idx < num_keys) {
+    uint64_t h1, h2;
+    bloom_filter_hashes(d_keys[idx], h1, h2);
+    const uint64_t num_bits = num_words * 32;
+    for (size_t i = 0; i < num_hashes; ++i) {
+      const uint64_t bit = (h1 + i * h2) % num_bits;
+      atomicOr(&d_bits[bit / 32], 1U << (bit % 32));
+    }
+  }
+}
+
+template <typename Key>
+__global__ void bloom_filter_compact(const uint32_t* const d_bits, const size_t num_words,
+                                     const size_t num_hashes, const Key* const d_missing_keys,
+                                     const uint64_t* const d_missing_index, const size_t len,
+                                     float* const d_hit_emb_vec, const float default_value,
+                                     const size_t emb_vec_size, Key* const d_remaining_keys,
+                                     uint64_t* const d_remaining_index,
+                                     size_t* const d_remaining_length) {
+  const size_t idx = blockIdx.x * blockDim.x + threadIdx.x;
+  if (idx < len) {
+    const Key key = d_missing_keys[idx];
+    uint64_t h1, h2;
+    bloom_filter_hashes(key, h1, h2);
+    const uint64_t num_bits = num_words * 32;
+    bool maybe_present = true;
+    for (size_t i = 0; i < num_hashes && maybe_present; ++i) {
+      const uint64_t bit = (h1 + i * h2) % num_bits;
+      maybe_present = d_bits[bit / 32] & (1U << (bit % 32));
+    }
+
+    const uint64_t dst_emb_vec = d_missing_index[idx];
+    if (maybe_present) {
+      const size_t pos = atomicAdd(reinterpret_cast<unsigned long long*>(d_remaining_length), 1ULL);
+      d_remaining_keys[pos] = key;
+      d_remaining_index[pos] = dst_emb_vec;
+    } else {
+      float* const dst = &d_hit_emb_vec[dst_emb_vec * emb_vec_size];
+      for (size_t i = 0; i < emb_vec_size; ++i) {
+        dst[i] = default_value;
+      }
+    }
+  }
+}
+
+template <typename Key>
+BloomFilter<Key>::BloomFilter(const size_t capacity, const size_t bits_per_key,
+                              const size_t num_hashes, const size_t max_query_length)
+    : num_words_{std::max<size_t>((capacity * bits_per_key + 31) / 32, 1024)},
+      num_hashes_{num_hashes},
+      max_query_length_{max_query_length} {
+  HCTR_CHECK(num_hashes_ > 0);
+
+  HCTR_LIB_THROW(cudaMalloc(&d_bits_, num_words_ * sizeof(uint32_t)));
+  HCTR_LIB_THROW(cudaMemset(d_bits_, 0, num_words_ * sizeof(uint32_t)));
+
+  HCTR_LIB_THROW(cudaStreamCreateWithFlags(&insert_stream_, cudaStreamNonBlocking));
+  HCTR_LIB_THROW(cudaMalloc(&d_insert_keys_, insert_batch_size_ * sizeof(Key)));
+
+  const size_t scratch_length{std::max<size_t>(max_query_length_, 1)};
+  HCTR_LIB_THROW(cudaMalloc(&d_remaining_keys_, scratch_length * sizeof(Key)));
+  HCTR_LIB_THROW(cudaMalloc(&d_remaining_index_, scratch_length * sizeof(uint64_t)));
+  HCTR_LIB_THROW(cudaMalloc(&d_remaining_length_, sizeof(size_t)));
+  HCTR_LIB_THROW(cudaMallocHost(&h_remaining_length_, sizeof(size_t)));
+}
+
+template <typename Key>
+BloomFilter<Key>::~BloomFilter() {
+  cudaFreeHost(h_remaining_length_);
+  cudaFree(d_remaining_length_);
+  cudaFree(d_remaining_index_);
+  cudaFree(d_remaining_keys_);
+
+  cudaFree(d_insert_keys_);
+  cudaStreamDestroy(insert_stream_);
+
+  cudaFree(d_bits_);
+}
+
+template <typename Key>
+void BloomFilter<Key>::clear() {
+  const std::lock_guard<std::mutex> lock(insert_mutex_);
+  sealed_.store(false, std::memory_order_release);
+  HCTR_LIB_THROW(cudaMemsetAsync(d_bits_, 0, num_words_ * sizeof(uint32_t), insert_stream_));
+  HCTR_LIB_THROW(cudaStreamSynchronize(insert_stream_));
+}
+
+template <typename Key>
+void BloomFilter<Key>::insert(const Key* const h_keys, const size_t num_keys) {
+  const std::lock_guard<std::mutex> lock(insert_mutex_);
+  for (size_t offset = 0; offset < num_keys; offset += insert_batch_size_) {
+    const size_t batch_size = std::min(num_keys - offset, insert_batch_size_);
+    HCTR_LIB_THROW(cudaMemcpyAsync(d_insert_keys_, &h_keys[offset], batch_size * sizeof(Key),
+                                   cudaMemcpyHostToDevice, insert_stream_));
+    bloom_filter_insert<<<(batch_size - 1) / block_size_ + 1, block_size_, 0, insert_stream_>>>(
+        d_bits_, num_words_, num_hashes_, d_insert_keys_, batch_size);
+    // The staging buffer is reused by the next batch.
+    HCTR_LIB_THROW(cudaStreamSynchronize(insert_stream_));
+  }
+}
+
+template <typename Key>
+size_t BloomFilter<Key>::filter_missing(Key* const d_missing_keys,
+                                        uint64_t* const d_missing_index,
+                                        const size_t missing_length, float* const d_hit_emb_vec,
+                                        const float default_value, const size_t emb_vec_size,
+                                        cudaStream_t stream) {
+  if (missing_length == 0 || !is_sealed()) {
+    return missing_length;
+  }
+  HCTR_CHECK(missing_length <= max_query_length_);
+
+  const std::lock_guard<std::mutex> lock(filter_mutex_);
+  HCTR_LIB_THROW(cudaMemsetAsync(d_remaining_length_, 0, sizeof(size_t), stream));
+  bloom_filter_compact<<<(missing_length - 1) / block_size_ + 1, block_size_, 0, stream>>>(
+      d_bits_, num_words_, num_hashes_, d_missing_keys, d_missing_index, missing_length,
+      d_hit_emb_vec, default_value, emb_vec_size, d_remaining_keys_, d_remaining_index_,
+      d_remaining_length_);
+  HCTR_LIB_THROW(cudaMemcpyAsync(h_remaining_length_, d_remaining_length_, sizeof(size_t),
+                                 cudaMemcpyDeviceToHost, stream));
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+
+  const size_t remaining_length = *h_remaining_length_;
+  if (remaining_length != 0) {
+    HCTR_LIB_THROW(cudaMemcpyAsync(d_missing_keys, d_remaining_keys_,
+                                   remaining_length * sizeof(Key), cudaMemcpyDeviceToDevice,
+                                   stream));
+    HCTR_LIB_THROW(cudaMemcpyAsync(d_missing_index, d_remaining_index_,
+                                   remaining_length * sizeof(uint64_t), cudaMemcpyDeviceToDevice,
+                                   stream));
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  }
+  return remaining_length;
+}
+
+template class BloomFilter<unsigned int>;
+template class BloomFilter<long long>;
+
+}  // namespace HugeCTR
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <hps/cache_capacity_balancer.hpp>
+
+namespace HugeCTR {
+
+CacheGhostList::CacheGhostList(const size_t capacity) : capacity_{std::max<size_t>(capacity, 1)} {}
+
+size_t CacheGhostList::capacity() const {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  return capacity_;
+}
+
+void CacheGhostList::set_capacity(const size_t capacity) {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  capacity_ = std::max<size_t>(capacity, 1);
+  evict_excess();
+}
+
+template <typename TypeHashKey>
+void CacheGhostList::record(const TypeHashKey* const keys, const size_t num_keys) {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t i = 0; i < num_keys; ++i) {
+    const uint64_t key = static_cast<uint64_t>(keys[i]);
+    const auto it = positions_.find(key);
+    if (it != positions_.end()) {
+      ++hits_;
+      keys_.splice(keys_.begin(), keys_, it->second);
+    } else {
+      keys_.push_front(key);
+      positions_.emplace(key, keys_.begin());
+    }
+  }
+  evict_excess();
+}
+
+size_t CacheGhostList::take_hits() {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  const size_t hits = hits_;
+  hits_ = 0;
+  return hits;
+}
+
+void CacheGhostList::evict_excess() {
+  while (keys_.size() > capacity_) {
+    positions_.erase(keys_.back());
+    keys_.pop_back();
+  }
+}
+
+template void CacheGhostList::record(const long long*, size_t);
+template void CacheGhostList::record(const unsigned int*, size_t);
+
+std::vector<size_t> rebalance_cache_sets(const std::vector<size_t>& num_sets,
+                                         const std::vector<size_t>& set_bytes,
+                                         const std::vector<double>& gain_per_byte,
+                                         const double step, const double min_gain_ratio) {
+  std::vector<size_t> new_num_sets{num_sets};
+  const size_t num_tables = num_sets.size();
+  if (num_tables < 2) {
+    return new_num_sets;
+  }
+
+  size_t receiver = 0;
+  for (size_t i = 1; i < num_tables; ++i) {
+    if (gain_per_byte[i] > gain_per_byte[receiver]) {
+      receiver = i;
+    }
+  }
+  if (gain_per_byte[receiver] <= 0) {
+    return new_num_sets;
+  }
+  // Every table keeps at least one set.
+  size_t donor = num_tables;
+  for (size_t i = 0; i < num_tables; ++i) {
+    if (i != receiver && num_sets[i] > 1 &&
+        (donor == num_tables || gain_per_byte[i] < gain_per_byte[donor])) {
+      donor = i;
+    }
+  }
+  if (donor == num_tables || gain_per_byte[receiver] < min_gain_ratio * gain_per_byte[donor]) {
+    return new_num_sets;
+  }
+
+  // The donor frees at least one set of the receiver, and the receiver gets whole sets out of the
+  // freed bytes, so the total never grows.
+  const size_t step_sets =
+      static_cast<size_t>(std::ceil(step * static_cast<double>(num_sets[donor])));
+  const size_t min_donor_sets = (set_bytes[receiver] + set_bytes[donor] - 1) / set_bytes[donor];
+  const size_t donor_sets = std::min(num_sets[donor] - 1, std::max(step_sets, min_donor_sets));
+  const size_t receiver_sets = donor_sets * set_bytes[donor] / set_bytes[receiver];
+  if (receiver_sets == 0) {
+    return new_num_sets;
+  }
+  new_num_sets[donor] -= donor_sets;
+  new_num_sets[receiver] += receiver_sets;
+  return new_num_sets;
+}
+
+}  // namespace HugeCTR
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <core23/logger.hpp>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <hps/cache_key_log.hpp>
+
+namespace HugeCTR {
+
+namespace {
+
+constexpr char cache_key_log_magic[8] = {'H', 'C', 'T', 'R', 'K', 'L', 'G', '\0'};
+constexpr uint32_t cache_key_log_version{1};
+// A longer name is taken for a broken file.
+constexpr uint32_t max_table_name_length{4096};
+
+}  // namespace
+
+template <typename Key>
+CacheKeyLog<Key>::CacheKeyLog(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  HCTR_THROW_IF(!in, Error_t::FileCannotOpen, "Unable to open cache key log '", path, "'.");
+  const auto read = [&in, &path](void* const data, const size_t size) {
+    in.read(static_cast<char*>(data), static_cast<std::streamsize>(size));
+    HCTR_THROW_IF(!in, Error_t::BrokenFile, "Cache key log '", path, "' is truncated.");
+  };
+
+  const uint64_t file_size{std::filesystem::file_size(path)};
+  CacheKeyLogHeader header;
+  read(&header, sizeof(header));
+  HCTR_THROW_IF(std::memcmp(header.magic, cache_key_log_magic, sizeof(cache_key_log_magic)) != 0,
+                Error_t::BrokenFile, "'", path, "' is not a cache key log.");
+  HCTR_THROW_IF(header.version != cache_key_log_version, Error_t::BrokenFile, "Cache key log '",
+                path, "' has the unsupported version ", header.version, ".");
+
+  std::vector<long long> log_keys;
+  for (uint64_t i{0}; i < header.num_tables; ++i) {
+    uint32_t name_length;
+    read(&name_length, sizeof(name_length));
+    HCTR_THROW_IF(name_length > max_table_name_length, Error_t::BrokenFile, "Cache key log '",
+                  path, "' is broken.");
+    std::string table_name(name_length, '\0');
+    read(table_name.data(), name_length);
+    uint64_t num_keys;
+    read(&num_keys, sizeof(num_keys));
+    const uint64_t remaining{file_size - static_cast<uint64_t>(in.tellg())};
+    HCTR_THROW_IF(num_keys > remaining / sizeof(long long), Error_t::BrokenFile,
+                  "Cache key log '", path, "' is truncated.");
+    log_keys.resize(num_keys);
+    read(log_keys.data(), num_keys * sizeof(long long));
+    keys_[table_name].assign(log_keys.begin(), log_keys.end());
+  }
+}
+
+template <typename Key>
+const std::vector<Key>* CacheKeyLog<Key>::keys(const std::string& table_name) const {
+  const auto it{keys_.find(table_name)};
+  return it != keys_.end() ? &it->second : nullptr;
+}
+
+template <typename Key>
+void CacheKeyLog<Key>::write(const std::string& path, const std::vector<std::string>& table_names,
+                             const std::vector<std::vector<Key>>& keys) {
+  HCTR_CHECK(table_names.size() == keys.size());
+  const std::string tmp_path{path + ".tmp." + std::to_string(getpid())};
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    HCTR_THROW_IF(!out, Error_t::FileCannotOpen, "Unable to create '", tmp_path, "'.");
+    const auto write = [&out](const void* const data, const size_t size) {
+      out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    };
+
+    CacheKeyLogHeader header{};
+    std::memcpy(header.magic, cache_key_log_magic, sizeof(cache_key_log_magic));
+    header.version = cache_key_log_version;
+    header.num_tables = table_names.size();
+    write(&header, sizeof(header));
+
+    std::vector<long long> log_keys;
+    for (size_t i{0}; i < table_names.size(); ++i) {
+      const uint32_t name_length{static_cast<uint32_t>(table_names[i].size())};
+      HCTR_CHECK(name_length <= max_table_name_length);
+      write(&name_length, sizeof(name_length));
+      write(table_names[i].data(), name_length);
+      const uint64_t num_keys{keys[i].size()};
+      write(&num_keys, sizeof(num_keys));
+      log_keys.assign(keys[i].begin(), keys[i].end());
+      write(log_keys.data(), num_keys * sizeof(long long));
+    }
+    out.close();
+    if (!out) {
+      std::remove(tmp_path.c_str());
+      HCTR_OWN_THROW(Error_t::UnspecificError, "Unable to write '" + tmp_path + "'.");
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    HCTR_OWN_THROW(Error_t::UnspecificError,
+                   "Unable to replace '" + path + "': " + std::strerror(errno));
+  }
+}
+
+template class CacheKeyLog<unsigned int>;
+template class CacheKeyLog<long long>;
+
+}  // namespace HugeCTR
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <parallel_hashmap/phmap.h>
+
+#include <algorithm>
+#include <core23/instrumentation.hpp>
+#include <cstring>
+#include <future>
+#include <hps/cpu_lookup_session.hpp>
+#include <thread_pool.hpp>
+
+namespace HugeCTR {
+
+CpuLookupSession::CpuLookupSession(const InferenceParams& inference_params,
+                                   const std::shared_ptr<HierParameterServerBase>& parameter_server,
+                                   const std::vector<size_t>& embedding_vec_size_per_table,
+                                   const size_t min_keys_per_partition)
+    : inference_params_{inference_params},
+      parameter_server_{parameter_server},
+      embedding_vec_size_per_table_{embedding_vec_size_per_table},
+      min_keys_per_partition_{std::max<size_t>(min_keys_per_partition, 1)} {
+  HCTR_CHECK_HINT(parameter_server_, "The CPU lookup session needs a parameter server.");
+  // The fused tables are a means to save kernel launches, and are only known to the GPU caches.
+  HCTR_THROW_IF(inference_params_.fuse_embedding_table, Error_t::WrongInput, "Model ",
+                inference_params_.model_name,
+                ": the CPU lookup session does not support fused embedding tables.");
+
+  auto& metrics = MetricsRegistry::get();
+  const std::string labels = "{model=\"" + inference_params_.model_name + "\"}";
+  num_keys_ = &metrics.counter("hps_cpu_lookup_keys" + labels);
+  num_unique_keys_ = &metrics.counter("hps_cpu_lookup_unique_keys" + labels);
+}
+
+void CpuLookupSession::lookup(const void* const h_keys, float* const h_vectors,
+                              const size_t num_keys, const size_t table_id) {
+  HCTR_CHECK_HINT(table_id < embedding_vec_size_per_table_.size(),
+                  "The table id %zu of model %s is out of range.", table_id,
+                  inference_params_.model_name.c_str());
+  if (inference_params_.i64_input_key) {
+    lookup_impl(static_cast<const long long*>(h_keys), h_vectors, num_keys, table_id);
+  } else {
+    lookup_impl(static_cast<const unsigned int*>(h_keys), h_vectors, num_keys, table_id);
+  }
+}
+
+void CpuLookupSession::lookup(const std::vector<const void*>& h_keys_per_table,
+                              const std::vector<float*>& h_vectors_per_table,
+                              const std::vector<size_t>& num_keys_per_table) {
+  HCTR_CHECK_HINT(h_keys_per_table.size() == h_vectors_per_table.size() &&
+                      h_keys_per_table.size() == num_keys_per_table.size(),
+                  "The number of key arrays, vector arrays and key counts must be equal.");
+  for (size_t table_id{0}; table_id < h_keys_per_table.size(); ++table_id) {
+    lookup(h_keys_per_table[table_id], h_vectors_per_table[table_id], num_keys_per_table[table_id],
+           table_id);
+  }
+}
+
+template <typename TypeHashKey>
+void CpuLookupSession::lookup_impl(const TypeHashKey* const h_keys, float* const h_vectors,
+                                   const size_t num_keys, const size_t table_id) {
+  if (!num_keys) {
+    return;
+  }
+  const size_t embedding_size = embedding_vec_size_per_table_[table_id];
+  const std::string& model_name = inference_params_.model_name;
+
+  // Deduplicate the keys, so that the database tiers are queried once per key.
+  std::vector<TypeHashKey> unique_keys;
+  std::vector<size_t> unique_index(num_keys);
+  {
+    phmap::flat_hash_map<TypeHashKey, size_t> key_index;
+    key_index.reserve(num_keys);
+    unique_keys.reserve(num_keys);
+    for (size_t i{0}; i < num_keys; ++i) {
+      const auto res = key_index.try_emplace(h_keys[i], unique_keys.size());
+      if (res.second) {
+        unique_keys.emplace_back(h_keys[i]);
+      }
+      unique_index[i] = res.first->second;
+    }
+  }
+  const size_t num_unique_keys = unique_keys.size();
+
+  // Without duplicates, the vectors are fetched in place.
+  std::vector<float> unique_vectors;
+  float* fetch_vectors = h_vectors;
+  if (num_unique_keys < num_keys) {
+    unique_vectors.resize(num_unique_keys * embedding_size);
+    fetch_vectors = unique_vectors.data();
+  }
+
+  // Partitions of the unique keys, fetched concurrently.
+  const size_t max_num_partitions = std::max<size_t>(ThreadPool::get().size(), 1);
+  const size_t num_partitions =
+      std::min(max_num_partitions,
+               (num_unique_keys + min_keys_per_partition_ - 1) / min_keys_per_partition_);
+  const size_t partition_size = (num_unique_keys + num_partitions - 1) / num_partitions;
+  std::vector<std::future<void>> fetches;
+  fetches.reserve(num_partitions);
+  for (size_t begin{0}; begin < num_unique_keys; begin += partition_size) {
+    const size_t size = std::min(partition_size, num_unique_keys - begin);
+    fetches.emplace_back(parameter_server_->lookup_async(
+        &unique_keys[begin], size, &fetch_vectors[begin * embedding_size], model_name, table_id));
+  }
+  ThreadPool::await(fetches.begin(), fetches.end());
+
+  // Gather the vectors of the duplicates. The row copies are vectorized by the C library.
+  if (fetch_vectors != h_vectors) {
+    const size_t vector_bytes = embedding_size * sizeof(float);
+    for (size_t i{0}; i < num_keys; ++i) {
+      std::memcpy(&h_vectors[i * embedding_size], &fetch_vectors[unique_index[i] * embedding_size],
+                  vector_bytes);
+    }
+  }
+
+  num_keys_->add(num_keys);
+  num_unique_keys_->add(num_unique_keys);
+}
+
+}  // namespace HugeCTR
@@ -14,10 +14,18 @@
  * limitations under the License.
  */
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
 #include <core23/logger.hpp>
+#include <cstring>
 #include <fstream>
+#include <future>
 #include <hps/database_backend.hpp>
 #include <hps/database_backend_detail.hpp>
+#include <memory>
 #include <sstream>
 
 #ifdef HCTR_USE_ROCKS_DB
@@ -30,8 +38,12 @@
 namespace HugeCTR {
 
 template <typename Key>
-DatabaseBackendBase<Key>::DatabaseBackendBase(size_t max_batch_size)
-    : max_batch_size_{max_batch_size} {}
+DatabaseBackendBase<Key>::DatabaseBackendBase(const size_t max_batch_size,
+                                              const size_t load_dump_num_threads,
+                                              const bool load_dump_direct_io)
+    : max_batch_size_{max_batch_size},
+      load_dump_num_threads_{std::max<size_t>(load_dump_num_threads, 1)},
+      load_dump_direct_io_{load_dump_direct_io} {}
 
 template <typename Key>
 size_t DatabaseBackendBase<Key>::contains(const std::string& table_name, const size_t num_keys,
@@ -91,20 +103,24 @@ size_t DatabaseBackendBase<Key>::dump(const std::string& table_name, const std::
 
   switch (format) {
     case DatabaseTableDumpFormat_t::Raw: {
-      std::ofstream file(path, std::ios::binary);
+      {
+        std::ofstream file(path, std::ios::binary);
+        HCTR_CHECK_HINT(file.is_open(), "Cannot create the dump ", path, ".");
 
-      // Write header.
-      static constexpr char magic[] = {'b', 'i', 'n', '\0'};
-      file.write(magic, sizeof(magic));
+        // Write header.
+        static constexpr char magic[] = {'b', 'i', 'n', '\0'};
+        file.write(magic, sizeof(magic));
 
-      const uint32_t version = 1;
-      file.write(reinterpret_cast<const char*>(&version), sizeof(uint32_t));
+        const uint32_t version = 1;
+        file.write(reinterpret_cast<const char*>(&version), sizeof(uint32_t));
 
-      const uint32_t key_size = sizeof(Key);
-      file.write(reinterpret_cast<const char*>(&key_size), sizeof(uint32_t));
+        const uint32_t key_size = sizeof(Key);
+        file.write(reinterpret_cast<const char*>(&key_size), sizeof(uint32_t));
+        HCTR_CHECK(file);
+      }
 
       // Write data.
-      hit_count = dump_bin(table_name, file);
+      hit_count = dump_bin(table_name, path);
     } break;
 
 #ifdef HCTR_USE_ROCKS_DB
@@ -142,71 +158,133 @@ size_t DatabaseBackendBase<Key>::load_dump(const std::string& table_name, const
   }
 }
 
+template <typename Key>
+size_t DatabaseBackendBase<Key>::dump_bin(const std::string& table_name, const std::string& path) {
+  std::ofstream file(path, std::ios::binary | std::ios::app);
+  HCTR_CHECK_HINT(file.is_open(), "Cannot open the dump ", path, ".");
+  const size_t hit_count{dump_bin(table_name, file)};
+  HCTR_CHECK(file);
+  return hit_count;
+}
+
 template <typename Key>
 size_t DatabaseBackendBase<Key>::load_dump_bin(const std::string& table_name,
                                                const std::string& path) {
-  std::ifstream file{path, std::ios::binary};
-  HCTR_CHECK(file.is_open());
+  // O_DIRECT needs the offsets, sizes and buffers of the reads to be aligned.
+  static constexpr size_t alignment{4096};
+
+  int fd{-1};
+  if (load_dump_direct_io_) {
+    fd = open(path.c_str(), O_RDONLY | O_DIRECT);
+    if (fd < 0 && errno == EINVAL) {
+      HCTR_LOG_S(WARNING, WORLD) << "The file system of " << path
+                                 << " does not support O_DIRECT. Reading it buffered." << std::endl;
+    }
+  }
+  const bool direct_io{fd >= 0};
+  if (!direct_io) {
+    fd = open(path.c_str(), O_RDONLY);
+  }
+  HCTR_CHECK_HINT(fd >= 0, "Cannot open the dump ", path, ": ", std::strerror(errno), ".");
+  const std::unique_ptr<int, void (*)(int*)> fd_guard{&fd, [](int* const fd) { close(*fd); }};
+
+  struct stat st;
+  HCTR_CHECK(fstat(fd, &st) == 0);
+  const size_t file_size{static_cast<size_t>(st.st_size)};
+
+  // Reads [offset, offset + size) of the file, and returns where it starts in the buffer.
+  const auto read_range = [&](const size_t offset, const size_t size, std::vector<char>& buffer) {
+    const size_t begin{direct_io ? offset / alignment * alignment : offset};
+    size_t end{offset + size};
+    if (direct_io) {
+      end = std::min((end + alignment - 1) / alignment * alignment, file_size);
+    }
+    // Resized to whole aligned blocks, so that O_DIRECT can also read the tail of the file.
+    buffer.resize((end - begin + alignment - 1) / alignment * alignment + alignment);
+    char* const data{reinterpret_cast<char*>(
+        (reinterpret_cast<uintptr_t>(buffer.data()) + alignment - 1) / alignment * alignment)};
+
+    size_t num_read{0};
+    while (num_read < end - begin) {
+      const size_t num_bytes{direct_io ? (end - begin - num_read + alignment - 1) / alignment *
+                                             alignment
+                                       : end - begin - num_read};
+      const ssize_t ret{
+          pread(fd, data + num_read, num_bytes, static_cast<off_t>(begin + num_read))};
+      if (ret < 0 && errno == EINTR) {
+        continue;
+      }
+      HCTR_CHECK_HINT(ret > 0, "Cannot read the dump ", path, ".");
+      num_read += static_cast<size_t>(ret);
+    }
+    return data + (offset - begin);
+  };
 
   // Parse header.
-  char magic[4];
-  file.read(magic, sizeof(magic));
-  HCTR_CHECK(file);
-  HCTR_CHECK(magic[0] == 'b' && magic[1] == 'i' && magic[2] == 'n' && magic[3] == '\0');
+  static constexpr size_t header_size{4 * sizeof(uint32_t)};
+  HCTR_CHECK(file_size >= header_size - sizeof(uint32_t));
+  if (file_size < header_size) {
+    return 0;
+  }
+  std::vector<char> header_buffer;
+  const char* const header{read_range(0, header_size, header_buffer)};
+  HCTR_CHECK(header[0] == 'b' && header[1] == 'i' && header[2] == 'n' && header[3] == '\0');
 
   uint32_t version;
-  file.read(reinterpret_cast<char*>(&version), sizeof(uint32_t));
-  HCTR_CHECK(file);
+  std::memcpy(&version, header + sizeof(uint32_t), sizeof(uint32_t));
   HCTR_CHECK(version == 1);
 
   uint32_t key_size;
-  file.read(reinterpret_cast<char*>(&key_size), sizeof(uint32_t));
-  HCTR_CHECK(file);
+  std::memcpy(&key_size, header + 2 * sizeof(uint32_t), sizeof(uint32_t));
   HCTR_CHECK(key_size == sizeof(Key));
 
   uint32_t value_size;
-  file.read(reinterpret_cast<char*>(&value_size), sizeof(uint32_t));
-  if (file.eof()) {
+  std::memcpy(&value_size, header + 3 * sizeof(uint32_t), sizeof(uint32_t));
+
+  const size_t pair_size{sizeof(Key) + value_size};
+  const size_t num_pairs{(file_size - header_size) / pair_size};
+  HCTR_CHECK_HINT(num_pairs * pair_size == file_size - header_size, "The dump ", path,
+                  " ends with a truncated key/value pair.");
+  if (num_pairs == 0) {
     return 0;
   }
-  HCTR_CHECK(file);
 
-  size_t hit_count{0};
-  std::vector<Key> keys;
-  keys.reserve(max_batch_size_);
-  std::vector<char> values;
-  values.reserve(max_batch_size_ * value_size);
-
-  std::vector<char> tmp(std::max<size_t>(sizeof(Key), value_size));
-  while (!file.eof()) {
-    // Read key.
-    file.read(tmp.data(), sizeof(Key));
-    if (file.eof()) {
-      break;
-    }
-    HCTR_CHECK(file.good());
-    keys.emplace_back(*reinterpret_cast<Key*>(tmp.data()));
-
-    // Read value.
-    file.read(tmp.data(), value_size);
-    HCTR_CHECK(file.good() || file.eof());
-    values.insert(values.end(), tmp.begin(), tmp.begin() + value_size);
-
-    // Put batch into table.
-    if (keys.size() >= max_batch_size_) {
-      insert(table_name, keys.size(), keys.data(), values.data(), value_size, value_size);
-      hit_count += keys.size();
-      keys.clear();
-      values.clear();
-    }
+  // Each thread reads and inserts a range of whole pairs, one batch at a time. Values are inserted
+  // from the read buffer, with the pair size as stride.
+  const size_t num_batches{(num_pairs + max_batch_size_ - 1) / max_batch_size_};
+  const size_t num_threads{std::min(load_dump_num_threads_, num_batches)};
+  std::vector<std::future<size_t>> tasks;
+  tasks.reserve(num_threads);
+  for (size_t thread_index{0}; thread_index < num_threads; ++thread_index) {
+    tasks.emplace_back(std::async(std::launch::async, [&, thread_index]() {
+      const size_t pairs_begin{num_batches * thread_index / num_threads * max_batch_size_};
+      const size_t pairs_end{
+          std::min(num_batches * (thread_index + 1) / num_threads * max_batch_size_, num_pairs)};
+
+      size_t hit_count{0};
+      std::vector<char> buffer;
+      std::vector<Key> keys;
+      keys.reserve(max_batch_size_);
+      for (size_t p{pairs_begin}; p < pairs_end; p += max_batch_size_) {
+        const size_t batch_size{std::min(pairs_end - p, max_batch_size_)};
+        const char* const pairs{read_range(header_size + p * pair_size, batch_size * pair_size,
+                                           buffer)};
+
+        keys.resize(batch_size);
+        for (size_t i{0}; i < batch_size; ++i) {
+          std::memcpy(&keys[i], pairs + i * pair_size, sizeof(Key));
+        }
+        insert(table_name, batch_size, keys.data(), pairs + sizeof(Key), value_size, pair_size);
+        hit_count += batch_size;
+      }
+      return hit_count;
+    }));
   }
 
-  // Fill remaining KVs into table.
-  if (!keys.empty()) {
-    insert(table_name, keys.size(), keys.data(), values.data(), value_size, value_size);
-    hit_count += keys.size();
+  size_t hit_count{0};
+  for (auto& task : tasks) {
+    hit_count += task.get();
   }
-
   return hit_count;
 }
 
@@ -0,0 +1,583 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef HCTR_USE_RDMA
+
+#include <algorithm>
+#include <core23/logger.hpp>
+#include <cstring>
+#include <exception>
+#include <hps/database_backend_detail.hpp>
+#include <hps/distributed_hash_map_backend.hpp>
+#include <numeric>
+
+// TODO: Remove me!
+#pragma GCC diagnostic error "-Wconversion"
+
+namespace HugeCTR {
+
+namespace {
+
+enum class DistributedHashMapOp : uint32_t {
+  Size,
+  Contains,
+  Insert,
+  Fetch,
+  EvictTable,
+  EvictKeys,
+  FindTables,
+};
+
+/**
+ * A request is this header, the table (or model) name, the keys and the values, each padded to 8
+ * bytes. A response is a uint64_t result, followed by the hit flags and the values of a fetch, or
+ * by the names of a find_tables.
+ */
+struct RequestHeader {
+  DistributedHashMapOp op;
+  uint32_t value_size;
+  uint64_t name_size;
+  uint64_t num_keys;
+  uint64_t value_stride;
+  int64_t time_budget;  // In ns
+};
+
+constexpr size_t pad8(const size_t n) { return (n + 7) & ~size_t{7}; }
+
+/**
+ * Writes the header and the name of a request.
+ *
+ * @return Offset of the keys.
+ */
+size_t write_request(
+    char* const request, const DistributedHashMapOp op, const std::string& name,
+    const size_t num_keys = 0, const uint32_t value_size = 0, const size_t value_stride = 0,
+    const std::chrono::nanoseconds& time_budget = std::chrono::nanoseconds::zero()) {
+  const RequestHeader header{op,       value_size,   name.size(),
+                             num_keys, value_stride, time_budget.count()};
+  std::memcpy(request, &header, sizeof(header));
+  std::memcpy(&request[sizeof(header)], name.data(), name.size());
+  return sizeof(header) + pad8(name.size());
+}
+
+uint64_t read_result(const char* const response) {
+  uint64_t result;
+  std::memcpy(&result, response, sizeof(result));
+  return result;
+}
+
+}  // namespace
+
+template <typename Key>
+DistributedHashMapBackend<Key>::DistributedHashMapBackend(
+    const DistributedHashMapBackendParams& params)
+    : Base(params) {
+  HCTR_THROW_IF(params.hosts.empty(), Error_t::WrongInput, "No hosts to distribute the tables to.");
+  HCTR_THROW_IF(params.rank >= params.hosts.size(), Error_t::WrongInput, "Rank ", params.rank,
+                " is not in the ", params.hosts.size(), " hosts.");
+
+  HashMapBackendParams local_params;
+  local_params.max_batch_size = params.max_batch_size;
+  local_params.num_partitions = params.num_partitions;
+  local_params.overflow_margin = params.overflow_margin;
+  local_params.overflow_policy = params.overflow_policy;
+  local_params.overflow_resolution_target = params.overflow_resolution_target;
+  local_params.allocation_rate = params.allocation_rate;
+  local_params.value_page_size = params.value_page_size;
+  local_params.numa_node = params.numa_node;
+  local_ = std::make_unique<HashMapBackend<Key>>(local_params);
+
+  if (params.hosts.size() > 1) {
+    endpoint_ = std::make_unique<IbvRpcEndpoint>(
+        params.hosts, params.rank, params.ib_device, params.ib_port, params.message_size,
+        std::chrono::seconds(params.connect_timeout),
+        [this](const char* const request, const size_t request_size, char* const response,
+               const size_t max_response_size) {
+          return handle_request_(request, request_size, response, max_response_size);
+        });
+  }
+  HCTR_LOG_S(INFO, WORLD) << "Created distributed database backend, host " << params.rank
+                          << " of " << params.hosts.size() << '.' << std::endl;
+}
+
+template <typename Key>
+size_t DistributedHashMapBackend<Key>::owner_of(const Key key) const {
+  // Rotated, so that the owner does not depend on the partition of the key within its host.
+  return static_cast<size_t>(rotl64(rrxmrrxmsx_0(static_cast<uint64_t>(key)), 32) %
+                             this->params_.hosts.size());
+}
+
+template <typename Key>
+size_t DistributedHashMapBackend<Key>::size(const std::string& table_name) const {
+  const std::vector<size_t> peers{peers_with_keys_({})};
+  std::vector<char> sent(this->params_.hosts.size());
+  size_t num_keys{0};
+  exchange_(
+      peers,
+      [&](const size_t peer, char* const request) -> size_t {
+        return sent[peer]++ ? 0 : write_request(request, DistributedHashMapOp::Size, table_name);
+      },
+      [&]() { num_keys += local_->size(table_name); },
+      [&](size_t, const char* const response) { num_keys += read_result(response); });
+  return num_keys;
+}
+
+template <typename Key>
+size_t DistributedHashMapBackend<Key>::contains(const std::string& table_name,
+                                                const size_t num_keys, const Key* const keys,
+                                                const std::chrono::nanoseconds& time_budget) const {
+  std::vector<size_t> host_offsets;
+  std::vector<size_t> grouped_indices;
+  group_by_owner_(num_keys, nullptr, keys, host_offsets, grouped_indices);
+
+  const size_t rank{this->params_.rank};
+  const std::vector<size_t> peers{peers_with_keys_(host_offsets)};
+  std::vector<size_t> cursors(host_offsets.begin(), host_offsets.end() - 1);
+
+  size_t hit_count{0};
+  exchange_(
+      peers,
+      [&](const size_t peer, char* const request) -> size_t {
+        const size_t remaining{host_offsets[peer + 1] - cursors[peer]};
+        if (remaining == 0) {
+          return 0;
+        }
+        const size_t offset{write_request(request, DistributedHashMapOp::Contains, table_name)};
+        const size_t n{std::min(remaining, (endpoint_->message_size() - offset) / sizeof(Key))};
+        write_request(request, DistributedHashMapOp::Contains, table_name, n, 0, 0, time_budget);
+        Key* const request_keys{reinterpret_cast<Key*>(&request[offset])};
+        for (size_t i{0}; i < n; ++i) {
+          request_keys[i] = keys[grouped_indices[cursors[peer]++]];
+        }
+        return offset + n * sizeof(Key);
+      },
+      [&]() {
+        const size_t n{host_offsets[rank + 1] - host_offsets[rank]};
+        std::vector<Key> local_keys(n);
+        for (size_t i{0}; i < n; ++i) {
+          local_keys[i] = keys[grouped_indices[host_offsets[rank] + i]];
+        }
+        hit_count += local_->contains(table_name, n, local_keys.data(), time_budget);
+      },
+      [&](size_t, const char* const response) { hit_count += read_result(response); });
+  return hit_count;
+}
+
+template <typename Key>
+size_t DistributedHashMapBackend<Key>::insert(const std::string& table_name,
+                                              const size_t num_pairs, const Key* const keys,
+                                              const char* const values, const uint32_t value_size,
+                                              const size_t value_stride) {
+  std::vector<size_t> host_offsets;
+  std::vector<size_t> grouped_indices;
+  group_by_owner_(num_pairs, nullptr, keys, host_offsets, grouped_indices);
+
+  const size_t rank{this->params_.rank};
+  const std::vector<size_t> peers{peers_with_keys_(host_offsets)};
+  std::vector<size_t> cursors(host_offsets.begin(), host_offsets.end() - 1);
+
+  size_t num_inserted{0};
+  exchange_(
+      peers,
+      [&](const size_t peer, char* const request) -> size_t {
+        const size_t remaining{host_offsets[peer + 1] - cursors[peer]};
+        if (remaining == 0) {
+          return 0;
+        }
+        const size_t offset{write_request(request, DistributedHashMapOp::Insert, table_name)};
+        const size_t n{std::min(remaining, (endpoint_->message_size() - offset - 8) /
+                                               (sizeof(Key) + value_size))};
+        HCTR_THROW_IF(n == 0, Error_t::WrongInput, "Message size ", endpoint_->message_size(),
+                      " is too small for values of ", value_size, " bytes.");
+        write_request(request, DistributedHashMapOp::Insert, table_name, n, value_size);
+        Key* const request_keys{reinterpret_cast<Key*>(&request[offset])};
+        char* const request_values{&request[offset + pad8(n * sizeof(Key))]};
+        for (size_t i{0}; i < n; ++i) {
+          const size_t index{grouped_indices[cursors[peer]++]};
+          request_keys[i] = keys[index];
+          std::memcpy(&request_values[i * value_size], &values[index * value_stride], value_size);
+        }
+        return offset + pad8(n * sizeof(Key)) + n * value_size;
+      },
+      [&]() {
+        const size_t n{host_offsets[rank + 1] - host_offsets[rank]};
+        std::vector<Key> local_keys(n);
+        std::vector<char> local_values(n * value_size);
+        for (size_t i{0}; i < n; ++i) {
+          const size_t index{grouped_indices[host_offsets[rank] + i]};
+          local_keys[i] = keys[index];
+          std::memcpy(&local_values[i * value_size], &values[index * value_stride], value_size);
+        }
+        num_inserted += local_->insert(table_name, n, local_keys.data(), local_values.data(),
+                                       value_size, value_size);
+      },
+      [&](size_t, const char* const response) { num_inserted += read_result(response); });
+  return num_inserted;
+}
+
+template <typename Key>
+size_t DistributedHashMapBackend<Key>::fetch(const std::string& table_name, const size_t num_keys,
+                                             const Key* const keys, char* const values,
+                                             const size_t value_stride,
+                                             const DatabaseMissCallback& on_miss,
+                                             const std::chrono::nanoseconds& time_budget) {
+  return fetch_(table_name, num_keys, nullptr, keys, values, value_stride, on_miss, time_budget);
+}
+
+template <typename Key>
+size_t DistributedHashMapBackend<Key>::fetch(const std::string& table_name,
+                                             const size_t num_indices, const size_t* const indices,
+                                             const Key* const keys, char* const values,
+                                             const size_t value_stride,
+                                             const DatabaseMissCallback& on_miss,
+                                             const std::chrono::nanoseconds& time_budget) {
+  return fetch_(table_name, num_indices, indices, keys, values, value_stride, on_miss,
+                time_budget);
+}
+
+template <typename Key>
+size_t DistributedHashMapBackend<Key>::fetch_(const std::string& table_name,
+                                              const size_t num_indices,
+                                              const size_t* const indices, const Key* const keys,
+                                              char* const values, const size_t value_stride,
+                                              const DatabaseMissCallback& on_miss,
+                                              const std::chrono::nanoseconds& time_budget) {
+  const auto begin{std::chrono::high_resolution_clock::now()};
+  std::vector<size_t> host_offsets;
+  std::vector<size_t> grouped_indices;
+  group_by_owner_(num_indices, indices, keys, host_offsets, grouped_indices);
+
+  const size_t rank{this->params_.rank};
+  const std::vector<size_t> peers{peers_with_keys_(host_offsets)};
+  std::vector<size_t> cursors(host_offsets.begin(), host_offsets.end() - 1);
+  std::vector<size_t> chunk_begin(cursors);
+
+  size_t hit_count{0};
+  exchange_(
+      peers,
+      [&](const size_t peer, char* const request) -> size_t {
+        const size_t remaining{host_offsets[peer + 1] - cursors[peer]};
+        if (remaining == 0) {
+          return 0;
+        }
+        std::chrono::nanoseconds remaining_budget{time_budget};
+        if (time_budget != std::chrono::nanoseconds::zero()) {
+          remaining_budget -= std::chrono::high_resolution_clock::now() - begin;
+          if (remaining_budget <= std::chrono::nanoseconds::zero()) {
+            HCTR_LOG_C(WARNING, WORLD, get_name(), " backend; Table ", table_name,
+                       ": Timeout, skipped ", remaining, " keys of host ", peer, "!\n");
+            for (; cursors[peer] != host_offsets[peer + 1]; ++cursors[peer]) {
+              on_miss(grouped_indices[cursors[peer]]);
+            }
+            return 0;
+          }
+        }
+
+        const size_t offset{write_request(request, DistributedHashMapOp::Fetch, table_name)};
+        const size_t message_size{endpoint_->message_size()};
+        const size_t n{std::min({remaining, (message_size - offset) / sizeof(Key),
+                                 (message_size - 16) / (1 + value_stride)})};
+        HCTR_THROW_IF(n == 0, Error_t::WrongInput, "Message size ", message_size,
+                      " is too small for values of ", value_stride, " bytes.");
+        write_request(request, DistributedHashMapOp::Fetch, table_name, n, 0, value_stride,
+                      remaining_budget);
+        Key* const request_keys{reinterpret_cast<Key*>(&request[offset])};
+        chunk_begin[peer] = cursors[peer];
+        for (size_t i{0}; i < n; ++i) {
+          request_keys[i] = keys[grouped_indices[cursors[peer]++]];
+        }
+        return offset + n * sizeof(Key);
+      },
+      [&]() {
+        const size_t n{host_offsets[rank + 1] - host_offsets[rank]};
+        hit_count += local_->fetch(table_name, n, &grouped_indices[host_offsets[rank]], keys,
+                                   values, value_stride, on_miss, time_budget);
+      },
+      [&](const size_t peer, const char* const response) {
+        hit_count += read_result(response);
+        const size_t n{cursors[peer] - chunk_begin[peer]};
+        const char* const hits{&response[sizeof(uint64_t)]};
+        const char* const response_values{&hits[pad8(n)]};
+        for (size_t i{0}; i < n; ++i) {
+          const size_t index{grouped_indices[chunk_begin[peer] + i]};
+          if (hits[i]) {
+            std::memcpy(&values[index * value_stride], &response_values[i * value_stride],
+                        value_stride);
+          } else {
+            on_miss(index);
+          }
+        }
+      });
+  return hit_count;
+}
+
+template <typename Key>
+size_t DistributedHashMapBackend<Key>::evict(const std::string& table_name) {
+  const std::vector<size_t> peers{peers_with_keys_({})};
+  std::vector<char> sent(this->params_.hosts.size());
+  size_t num_deleted{0};
+  exchange_(
+      peers,
+      [&](const size_t peer, char* const request) -> size_t {
+        return sent[peer]++ ? 0
+                            : write_request(request, DistributedHashMapOp::EvictTable, table_name);
+      },
+      [&]() { num_deleted += local_->evict(table_name); },
+      [&](size_t, const char* const response) { num_deleted += read_result(response); });
+  return num_deleted;
+}
+
+template <typename Key>
+size_t DistributedHashMapBackend<Key>::evict(const std::string& table_name, const size_t num_keys,
+                                             const Key* const keys) {
+  std::vector<size_t> host_offsets;
+  std::vector<size_t> grouped_indices;
+  group_by_owner_(num_keys, nullptr, keys, host_offsets, grouped_indices);
+
+  const size_t rank{this->params_.rank};
+  const std::vector<size_t> peers{peers_with_keys_(host_offsets)};
+  std::vector<size_t> cursors(host_offsets.begin(), host_offsets.end() - 1);
+
+  size_t num_deleted{0};
+  exchange_(
+      peers,
+      [&](const size_t peer, char* const request) -> size_t {
+        const size_t remaining{host_offsets[peer + 1] - cursors[peer]};
+        if (remaining == 0) {
+          return 0;
+        }
+        const size_t offset{write_request(request, DistributedHashMapOp::EvictKeys, table_name)};
+        const size_t n{std::min(remaining, (endpoint_->message_size() - offset) / sizeof(Key))};
+        write_request(request, DistributedHashMapOp::EvictKeys, table_name, n);
+        Key* const request_keys{reinterpret_cast<Key*>(&request[offset])};
+        for (size_t i{0}; i < n; ++i) {
+          request_keys[i] = keys[grouped_indices[cursors[peer]++]];
+        }
+        return offset + n * sizeof(Key);
+      },
+      [&]() {
+        const size_t n{host_offsets[rank + 1] - host_offsets[rank]};
+        std::vector<Key> local_keys(n);
+        for (size_t i{0}; i < n; ++i) {
+          local_keys[i] = keys[grouped_indices[host_offsets[rank] + i]];
+        }
+        num_deleted += local_->evict(table_name, n, local_keys.data());
+      },
+      [&](size_t, const char* const response) { num_deleted += read_result(response); });
+  return num_deleted;
+}
+
+template <typename Key>
+std::vector<std::string> DistributedHashMapBackend<Key>::find_tables(
+    const std::string& model_name) {
+  const std::vector<size_t> peers{peers_with_keys_({})};
+  std::vector<char> sent(this->params_.hosts.size());
+  std::vector<std::string> table_names;
+  exchange_(
+      peers,
+      [&](const size_t peer, char* const request) -> size_t {
+        return sent[peer]++ ? 0
+                            : write_request(request, DistributedHashMapOp::FindTables, model_name);
+      },
+      [&]() { table_names = local_->find_tables(model_name); },
+      [&](size_t, const char* const response) {
+        const char* name{&response[sizeof(uint64_t)]};
+        for (uint64_t i{0}; i < read_result(response); ++i) {
+          table_names.emplace_back(name);
+          name += table_names.back().size() + 1;
+        }
+      });
+
+  // A table that is not empty has keys on most hosts.
+  std::sort(table_names.begin(), table_names.end());
+  table_names.erase(std::unique(table_names.begin(), table_names.end()), table_names.end());
+  return table_names;
+}
+
+template <typename Key>
+size_t DistributedHashMapBackend<Key>::dump_bin(const std::string& table_name,
+                                                std::ofstream& file) {
+  return local_->dump_bin(table_name, file);
+}
+
+template <typename Key>
+size_t DistributedHashMapBackend<Key>::dump_bin(const std::string& table_name,
+                                                const std::string& path) {
+  return local_->dump_bin(table_name, path);
+}
+
+#ifdef HCTR_USE_ROCKS_DB
+template <typename Key>
+size_t DistributedHashMapBackend<Key>::dump_sst(const std::string& table_name,
+                                                rocksdb::SstFileWriter& file) {
+  return local_->dump_sst(table_name, file);
+}
+#endif  // HCTR_USE_ROCKS_DB
+
+template <typename Key>
+void DistributedHashMapBackend<Key>::group_by_owner_(const size_t num_indices,
+                                                     const size_t* const indices,
+                                                     const Key* const keys,
+                                                     std::vector<size_t>& host_offsets,
+                                                     std::vector<size_t>& grouped_indices) const {
+  const size_t num_hosts{this->params_.hosts.size()};
+  std::vector<size_t> owners(num_indices);
+  host_offsets.assign(num_hosts + 1, 0);
+  for (size_t j{0}; j < num_indices; ++j) {
+    owners[j] = owner_of(keys[indices ? indices[j] : j]);
+    ++host_offsets[owners[j] + 1];
+  }
+  std::partial_sum(host_offsets.begin(), host_offsets.end(), host_offsets.begin());
+
+  std::vector<size_t> cursors(host_offsets.begin(), host_offsets.end() - 1);
+  grouped_indices.resize(num_indices);
+  for (size_t j{0}; j < num_indices; ++j) {
+    grouped_indices[cursors[owners[j]]++] = indices ? indices[j] : j;
+  }
+}
+
+template <typename Key>
+std::vector<size_t> DistributedHashMapBackend<Key>::peers_with_keys_(
+    const std::vector<size_t>& host_offsets) const {
+  std::vector<size_t> peers;
+  for (size_t peer{0}; peer < this->params_.hosts.size(); ++peer) {
+    if (peer != this->params_.rank &&
+        (host_offsets.empty() || host_offsets[peer + 1] > host_offsets[peer])) {
+      peers.push_back(peer);
+    }
+  }
+  return peers;
+}
+
+template <typename Key>
+void DistributedHashMapBackend<Key>::exchange_(
+    const std::vector<size_t>& peers,
+    const std::function<size_t(size_t peer, char* request)>& make_request,
+    const std::function<void()>& local_work,
+    const std::function<void(size_t peer, const char* response)>& on_response) const {
+  std::vector<std::unique_lock<std::mutex>> locks;
+  locks.reserve(peers.size());
+  for (const size_t peer : peers) {
+    locks.emplace_back(endpoint_->lock(peer));
+  }
+
+  std::exception_ptr local_error;
+  std::vector<size_t> posted;
+  bool first_round{true};
+  do {
+    posted.clear();
+    if (!local_error) {
+      for (const size_t peer : peers) {
+        const size_t request_size{make_request(peer, endpoint_->request_buffer(peer))};
+        if (request_size) {
+          endpoint_->post(peer, request_size);
+          posted.push_back(peer);
+        }
+      }
+    }
+    if (first_round) {
+      first_round = false;
+      try {
+        local_work();
+      } catch (...) {
+        local_error = std::current_exception();
+      }
+    }
+
+    // The responses to the posted requests must be received even if the local work failed.
+    for (const size_t peer : posted) {
+      size_t response_size;
+      const char* const response{endpoint_->wait(peer, &response_size)};
+      if (response_size == 0) {
+        throw DatabaseBackendError(get_name(), peer, "Request failed on host " +
+                                                         this->params_.hosts[peer] + '.');
+      }
+      if (!local_error) {
+        on_response(peer, response);
+      }
+    }
+  } while (!posted.empty());
+
+  if (local_error) {
+    std::rethrow_exception(local_error);
+  }
+}
+
+template <typename Key>
+size_t DistributedHashMapBackend<Key>::handle_request_(const char* const request,
+                                                       const size_t request_size,
+                                                       char* const response,
+                                                       const size_t max_response_size) {
+  RequestHeader header;
+  HCTR_CHECK(request_size >= sizeof(header));
+  std::memcpy(&header, request, sizeof(header));
+  const std::string name(&request[sizeof(header)], header.name_size);
+  const size_t num_keys{header.num_keys};
+  const Key* const keys{
+      reinterpret_cast<const Key*>(&request[sizeof(header) + pad8(header.name_size)])};
+  const char* const values{&reinterpret_cast<const char*>(keys)[pad8(num_keys * sizeof(Key))]};
+  const std::chrono::nanoseconds time_budget{header.time_budget};
+
+  uint64_t result{0};
+  size_t payload_size{0};
+  char* const payload{&response[sizeof(result)]};
+  switch (header.op) {
+    case DistributedHashMapOp::Size:
+      result = local_->size(name);
+      break;
+    case DistributedHashMapOp::Contains:
+      result = local_->contains(name, num_keys, keys, time_budget);
+      break;
+    case DistributedHashMapOp::Insert:
+      result = local_->insert(name, num_keys, keys, values, header.value_size, header.value_size);
+      break;
+    case DistributedHashMapOp::Fetch: {
+      char* const hits{payload};
+      std::fill_n(hits, num_keys, 1);
+      payload_size = pad8(num_keys) + num_keys * header.value_stride;
+      HCTR_CHECK(sizeof(result) + payload_size <= max_response_size);
+      result = local_->fetch(
+          name, num_keys, keys, &hits[pad8(num_keys)], header.value_stride,
+          [hits](const size_t index) { hits[index] = 0; }, time_budget);
+    } break;
+    case DistributedHashMapOp::EvictTable:
+      result = local_->evict(name);
+      break;
+    case DistributedHashMapOp::EvictKeys:
+      result = local_->evict(name, num_keys, keys);
+      break;
+    case DistributedHashMapOp::FindTables:
+      for (const std::string& table_name : local_->find_tables(name)) {
+        HCTR_CHECK(sizeof(result) + payload_size + table_name.size() + 1 <= max_response_size);
+        std::memcpy(&payload[payload_size], table_name.c_str(), table_name.size() + 1);
+        payload_size += table_name.size() + 1;
+        ++result;
+      }
+      break;
+    default:
+      HCTR_OWN_THROW(Error_t::WrongInput,
+                     "Unknown request " + std::to_string(static_cast<uint32_t>(header.op)) + '.');
+  }
+  std::memcpy(response, &result, sizeof(result));
+  return sizeof(result) + payload_size;
+}
+
+template class DistributedHashMapBackend<unsigned int>;
+template class DistributedHashMapBackend<long long>;
+
+}  // namespace HugeCTR
+
+#endif  // HCTR_USE_RDMA
@@ -14,7 +14,12 @@
  * limitations under the License.
  */
 
+#include <unistd.h>
+
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
 #include <hps/embedding_cache.hpp>
 #include <hps/embedding_cache_stoch.hpp>
 #include <hps/hier_parameter_server.hpp>
@@ -57,6 +62,48 @@ static void parameter_server_insert_thread_func_(
   }
 }
 
+// The CUDA IPC handles of a shared cache are exchanged through a file in shared memory. Its name
+// identifies the GPU by PCI bus id, because processes may see it under different ordinals.
+static std::string shared_cache_handle_file(const std::string& model_name, const size_t table_id,
+                                            const int device_id) {
+  char bus_id[32];
+  HCTR_LIB_THROW(cudaDeviceGetPCIBusId(bus_id, sizeof(bus_id), device_id));
+  return "/dev/shm/hps_shared_cache_" + model_name + "_" + std::to_string(table_id) + "_" +
+         bus_id;
+}
+
+static void publish_shared_cache_handles(const std::string& path,
+                                         const gpu_cache::gpu_cache_ipc_handles& handles) {
+  // Readers poll for the file, so it is written aside and renamed into place.
+  const std::string tmp_path = path + ".tmp" + std::to_string(getpid());
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    HCTR_THROW_IF(!file, Error_t::FileCannotOpen, "Cannot write the shared cache handles to ",
+                  tmp_path, ".");
+    file.write(reinterpret_cast<const char*>(&handles), sizeof(handles));
+  }
+  HCTR_THROW_IF(std::rename(tmp_path.c_str(), path.c_str()) != 0, Error_t::FileCannotOpen,
+                "Cannot publish the shared cache handles to ", path, ".");
+}
+
+static gpu_cache::gpu_cache_ipc_handles await_shared_cache_handles(const std::string& path) {
+  const auto timeout = std::chrono::seconds(300);
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  HCTR_LOG_S(INFO, WORLD) << "Waiting for the owner of the shared embedding cache to publish "
+                          << path << std::endl;
+  gpu_cache::gpu_cache_ipc_handles handles;
+  while (true) {
+    std::ifstream file(path, std::ios::binary);
+    if (file && file.read(reinterpret_cast<char*>(&handles), sizeof(handles))) {
+      return handles;
+    }
+    HCTR_THROW_IF(std::chrono::steady_clock::now() > deadline, Error_t::NotInitialized,
+                  "No owner published the shared embedding cache ", path, " within ",
+                  timeout.count(), " seconds.");
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+}
+
 std::shared_ptr<EmbeddingCacheBase> EmbeddingCacheBase::create(
     const InferenceParams& inference_params, const parameter_server_config& ps_config,
     HierParameterServerBase* const parameter_server) {
@@ -120,7 +167,7 @@ EmbeddingCache<TypeHashKey>::EmbeddingCache(const InferenceParams& inference_par
                                             HierParameterServerBase* const parameter_server)
     : EmbeddingCacheBase(),
       parameter_server_(parameter_server),
-      insert_workers_("EC insert",
+      insert_workers_("EC insert", TaskPriority::Refresh,
                       std::max(static_cast<unsigned int>(inference_params.thread_pool_size),
                                std::thread::hardware_concurrency())) {
   // initialize the profiler
@@ -138,6 +185,13 @@ EmbeddingCache<TypeHashKey>::EmbeddingCache(const InferenceParams& inference_par
   cache_config_.cuda_dev_id_ = inference_params.device_id;
   cache_config_.use_gpu_embedding_cache_ = inference_params.use_gpu_embedding_cache;
   cache_config_.use_hctr_cache_implementation = inference_params.use_hctr_cache_implementation;
+  cache_config_.shared_cache_role_ = inference_params.shared_cache_role;
+  HCTR_THROW_IF(cache_config_.shared_cache_role_ != SharedCacheRole_t::Disabled &&
+                    !(cache_config_.use_gpu_embedding_cache_ &&
+                      cache_config_.use_hctr_cache_implementation),
+                Error_t::WrongInput,
+                "Sharing the embedding cache requires use_gpu_embedding_cache and "
+                "use_hctr_cache_implementation.");
   auto b2s = [](const char val) { return val ? "True" : "False"; };
   HCTR_LOG(INFO, ROOT, "Model name: %s\n", inference_params.model_name.c_str());
   HCTR_LOG(INFO, ROOT, "Max batch size: %lu\n", inference_params.max_batchsize);
@@ -148,6 +202,8 @@ EmbeddingCache<TypeHashKey>::EmbeddingCache(const InferenceParams& inference_par
   HCTR_LOG(INFO, ROOT, "Embedding cache type: %s\n",
            hctr_enum_to_c_str(inference_params.embedding_cache_type));
   HCTR_LOG(INFO, ROOT, "Use I64 input key: %s\n", b2s(inference_params.i64_input_key));
+  HCTR_LOG(INFO, ROOT, "Shared cache role: %s\n",
+           hctr_enum_to_c_str(inference_params.shared_cache_role));
   HCTR_LOG(INFO, ROOT, "Configured cache hit rate threshold: %f\n",
            inference_params.hit_rate_threshold);
   HCTR_LOG(INFO, ROOT, "The size of thread pool: %u\n",
@@ -181,44 +237,128 @@ EmbeddingCache<TypeHashKey>::EmbeddingCache(const InferenceParams& inference_par
     }
   }
 
+  auto& metrics = MetricsRegistry::get();
+  for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
+    const std::string labels = "{model=\"" + cache_config_.model_name_ + "\",table=\"" +
+                               cache_config_.embedding_table_name_[i] + "\",device=\"" +
+                               std::to_string(cache_config_.cuda_dev_id_) + "\"}";
+    table_metrics_.push_back({&metrics.counter("hps_embedding_cache_unique_keys" + labels),
+                              &metrics.counter("hps_embedding_cache_missing_keys" + labels),
+                              &metrics.gauge("hps_embedding_cache_hit_rate" + labels)});
+  }
+
   // Query the size of all embedding tables and calculate the size of each embedding cache
   if (cache_config_.use_gpu_embedding_cache_) {
+    const std::vector<size_t>& set_associativity_per_table =
+        inference_params.set_associativity_per_table;
+    HCTR_CHECK_HINT(set_associativity_per_table.empty() ||
+                        set_associativity_per_table.size() == cache_config_.num_emb_table_,
+                    "set_associativity_per_table must provide a value for each embedding table.");
+    cache_config_.set_associativity_.reserve(cache_config_.num_emb_table_);
+    for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
+      size_t set_associativity{SET_ASSOCIATIVITY};
+      if (!set_associativity_per_table.empty()) {
+        set_associativity = set_associativity_per_table[i];
+        HCTR_CHECK_HINT(set_associativity == 2 || set_associativity == 4 || set_associativity == 8,
+                        "Unsupported set associativity %zu for embedding table %zu.",
+                        set_associativity, i);
+        if (!cache_config_.use_hctr_cache_implementation &&
+            set_associativity != SET_ASSOCIATIVITY) {
+          HCTR_LOG(WARNING, ROOT,
+                   "set_associativity_per_table is ignored unless use_hctr_cache_implementation "
+                   "is enabled.\n");
+          set_associativity = SET_ASSOCIATIVITY;
+        }
+      }
+      cache_config_.set_associativity_.emplace_back(set_associativity);
+    }
+
     cache_config_.num_set_in_cache_.reserve(cache_config_.num_emb_table_);
     for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
+      const size_t slabset_size = SLAB_SIZE * cache_config_.set_associativity_[i];
       const size_t row_num = ps_config.embedding_key_count_.at(inference_params.model_name)[i];
       size_t num_feature_in_cache = static_cast<size_t>(
           static_cast<double>(cache_config_.cache_size_percentage_) * static_cast<double>(row_num));
-      if (num_feature_in_cache < SLAB_SIZE * SET_ASSOCIATIVITY) {
-        num_feature_in_cache = SLAB_SIZE * SET_ASSOCIATIVITY;
+      if (num_feature_in_cache < slabset_size) {
+        num_feature_in_cache = slabset_size;
         HCTR_LOG(INFO, ROOT,
                  "The initial size of the embedding cache is smaller than the minimum setting: "
-                 "\"%zu\" and %d will be used as the default embedding cache size.\n",
-                 num_feature_in_cache, SLAB_SIZE * SET_ASSOCIATIVITY);
+                 "\"%zu\" and %zu will be used as the default embedding cache size.\n",
+                 num_feature_in_cache, slabset_size);
       }
-      cache_config_.num_set_in_cache_.emplace_back(
-          (num_feature_in_cache + SLAB_SIZE * SET_ASSOCIATIVITY - 1) /
-          (SLAB_SIZE * SET_ASSOCIATIVITY));
+      cache_config_.num_set_in_cache_.emplace_back((num_feature_in_cache + slabset_size - 1) /
+                                                   slabset_size);
     }
   }
 
   // Construct gpu embedding cache, 1 per embedding table
   if (cache_config_.use_gpu_embedding_cache_) {
-    // This is the only two places to set the cuda context in embedding cache
+    // Besides the table resizes, the only two places to set the cuda context in embedding cache
     CudaDeviceContext dev_restorer;
     dev_restorer.set_device(cache_config_.cuda_dev_id_);
 
     // Allocate resources.
     gpu_emb_caches_.reserve(cache_config_.num_emb_table_);
     for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
+      gpu_emb_caches_.emplace_back(create_table_cache(i, cache_config_.num_set_in_cache_[i]));
       if (cache_config_.use_hctr_cache_implementation) {
-        gpu_emb_caches_.emplace_back(std::make_unique<NVCache>(
-            cache_config_.num_set_in_cache_[i], cache_config_.embedding_vec_size_[i]));
+        HCTR_LOG(INFO, ROOT, "Embedding cache set associativity of table %zu: %zu\n", i,
+                 cache_config_.set_associativity_[i]);
+      }
+    }
+
+    // Replacing the cache of a table would invalidate captured lookups and the handles of the
+    // readers of a shared cache.
+    if (inference_params.cache_rebalance_percentage > 0) {
+      if (cache_config_.shared_cache_role_ != SharedCacheRole_t::Disabled ||
+          inference_params.use_capturable_lookup || !inference_params.background_refresh) {
+        HCTR_LOG(WARNING, ROOT,
+                 "cache_rebalance_percentage is ignored unless background_refresh is enabled, "
+                 "and neither shared_cache_role nor use_capturable_lookup are.\n");
       } else {
-        gpu_emb_caches_.emplace_back(std::make_unique<EmbeddingCacheWrapper<TypeHashKey>>(
-            cache_config_.num_set_in_cache_[i], cache_config_.embedding_vec_size_[i]));
+        rebalance_percentage_ = inference_params.cache_rebalance_percentage;
+        ghost_lists_.reserve(cache_config_.num_emb_table_);
+        for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
+          ghost_lists_.emplace_back(std::make_unique<CacheGhostList>(ghost_list_capacity(i)));
+        }
+        HCTR_LOG(INFO, ROOT, "Rebalance %f of the embedding cache capacity per refresh\n",
+                 rebalance_percentage_);
       }
     }
 
+    if (inference_params.use_bloom_filter) {
+      bloom_filters_.reserve(cache_config_.num_emb_table_);
+      for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
+        bloom_filters_.emplace_back(std::make_unique<BloomFilter<TypeHashKey>>(
+            ps_config.embedding_key_count_.at(inference_params.model_name)[i],
+            BLOOM_FILTER_BITS_PER_KEY_, BLOOM_FILTER_NUM_HASHES_,
+            cache_config_.max_query_len_per_emb_table_[i]));
+        HCTR_LOG(INFO, ROOT, "Bloom filter for table %zu: %zu bits, %zu hashes\n", i,
+                 bloom_filters_.back()->num_bits(), bloom_filters_.back()->num_hashes());
+      }
+    }
+
+    if (inference_params.hot_key_set_size > 0) {
+      hot_key_sets_.reserve(cache_config_.num_emb_table_);
+      for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
+        hot_key_sets_.emplace_back(std::make_unique<HotKeySet<TypeHashKey>>(
+            inference_params.hot_key_set_size, cache_config_.embedding_vec_size_[i],
+            cache_config_.max_query_len_per_emb_table_[i]));
+      }
+      HCTR_LOG(INFO, ROOT, "Always-resident hot keys per table: %zu\n",
+               inference_params.hot_key_set_size);
+    }
+
+    if (inference_params.sync_insert_latency_budget_us > 0) {
+      hit_rate_threshold_controllers_.reserve(cache_config_.num_emb_table_);
+      for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
+        hit_rate_threshold_controllers_.emplace_back(std::make_unique<HitRateThresholdController>(
+            inference_params.hit_rate_threshold, inference_params.sync_insert_latency_budget_us));
+      }
+      HCTR_LOG(INFO, ROOT, "Learn hit rate thresholds with a latency budget of %f us per lookup\n",
+               inference_params.sync_insert_latency_budget_us);
+    }
+
     insert_streams_.reserve(cache_config_.num_emb_table_);
     for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
       cudaStream_t stream;
@@ -226,10 +366,15 @@ EmbeddingCache<TypeHashKey>::EmbeddingCache(const InferenceParams& inference_par
       insert_streams_.push_back(stream);
     }
 
+    // Refreshes run at the lowest stream priority, so that the lookups and the insertions are
+    // scheduled first when both compete for the GPU.
+    int least_priority = 0;
+    int greatest_priority = 0;
+    cudaDeviceGetStreamPriorityRange(&least_priority, &greatest_priority);
     refresh_streams_.reserve(cache_config_.num_emb_table_);
     for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
       cudaStream_t stream;
-      cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking);
+      cudaStreamCreateWithPriority(&stream, cudaStreamNonBlocking, least_priority);
       refresh_streams_.push_back(stream);
     }
   }
@@ -238,7 +383,7 @@ EmbeddingCache<TypeHashKey>::EmbeddingCache(const InferenceParams& inference_par
 template <typename TypeHashKey>
 EmbeddingCache<TypeHashKey>::~EmbeddingCache() {
   if (cache_config_.use_gpu_embedding_cache_) {
-    // This is the only two places to set the cuda context in embedding cache
+    // Besides the table resizes, the only two places to set the cuda context in embedding cache
     CudaDeviceContext dev_restorer;
     dev_restorer.set_device(cache_config_.cuda_dev_id_);
 
@@ -252,10 +397,65 @@ EmbeddingCache<TypeHashKey>::~EmbeddingCache() {
     }
     refresh_streams_.clear();
 
+    // Unpublish the caches before freeing them, so that no new reader attaches to freed memory
+    for (const std::string& path : shared_cache_handle_files_) {
+      std::remove(path.c_str());
+    }
+    shared_cache_handle_files_.clear();
+
+    hot_key_sets_.clear();
+    bloom_filters_.clear();
     gpu_emb_caches_.clear();
   }
 }
 
+template <typename TypeHashKey>
+template <int set_associativity>
+std::unique_ptr<gpu_cache::gpu_cache_api<TypeHashKey>> EmbeddingCache<TypeHashKey>::create_nv_cache(
+    const size_t table_id, const size_t num_set, const size_t emb_vec_size) {
+  if (cache_config_.shared_cache_role_ == SharedCacheRole_t::Disabled) {
+    return std::make_unique<NVCache<set_associativity>>(num_set, emb_vec_size);
+  }
+
+  const std::string path =
+      shared_cache_handle_file(cache_config_.model_name_, table_id, cache_config_.cuda_dev_id_);
+  if (cache_config_.shared_cache_role_ == SharedCacheRole_t::Owner) {
+    auto cache = std::make_unique<NVCache<set_associativity>>(num_set, emb_vec_size);
+    publish_shared_cache_handles(path, cache->ExportIpcHandles());
+    shared_cache_handle_files_.emplace_back(path);
+    HCTR_LOG_S(INFO, WORLD) << "Published the embedding cache of table " << table_id << " to "
+                            << path << std::endl;
+    return cache;
+  }
+
+  const gpu_cache::gpu_cache_ipc_handles handles = await_shared_cache_handles(path);
+  HCTR_THROW_IF(handles.capacity_in_set != num_set || handles.embedding_vec_size != emb_vec_size,
+                Error_t::WrongInput, "The shared embedding cache ", path, " has ",
+                handles.capacity_in_set, " sets of ", handles.embedding_vec_size,
+                "-dimensional vectors, but this process is configured for ", num_set, " sets of ",
+                emb_vec_size, "-dimensional vectors.");
+  HCTR_LOG_S(INFO, WORLD) << "Attached to the shared embedding cache of table " << table_id
+                          << std::endl;
+  return std::make_unique<NVCache<set_associativity>>(handles);
+}
+
+template <typename TypeHashKey>
+std::unique_ptr<gpu_cache::gpu_cache_api<TypeHashKey>>
+EmbeddingCache<TypeHashKey>::create_table_cache(const size_t table_id, const size_t num_set) {
+  const size_t emb_vec_size = cache_config_.embedding_vec_size_[table_id];
+  if (!cache_config_.use_hctr_cache_implementation) {
+    return std::make_unique<EmbeddingCacheWrapper<TypeHashKey>>(num_set, emb_vec_size);
+  }
+  switch (cache_config_.set_associativity_[table_id]) {
+    case 4:
+      return create_nv_cache<4>(table_id, num_set, emb_vec_size);
+    case 8:
+      return create_nv_cache<8>(table_id, num_set, emb_vec_size);
+    default:
+      return create_nv_cache<SET_ASSOCIATIVITY>(table_id, num_set, emb_vec_size);
+  }
+}
+
 template <typename TypeHashKey>
 void EmbeddingCache<TypeHashKey>::lookup(size_t const table_id, float* const d_vectors,
                                          const void* const h_keys, size_t const num_keys,
@@ -356,6 +556,7 @@ void EmbeddingCache<TypeHashKey>::lookup_from_device(size_t const table_id, floa
   if (cache_config_.use_gpu_embedding_cache_) {
     CudaDeviceContext dev_restorer;
     dev_restorer.check_device(cache_config_.cuda_dev_id_);
+    HCTR_NVTX_RANGE("HPS lookup");
     BaseUnit* start = profiler::start();
     // Unique
     static_cast<UniqueOp*>(workspace_handler.unique_op_obj_[table_id])
@@ -374,7 +575,7 @@ void EmbeddingCache<TypeHashKey>::lookup_from_device(size_t const table_id, floa
     const size_t query_length = workspace_handler.h_unique_length_[table_id];
     const size_t task_per_warp_tile = (query_length < 1000000) ? 1 : 32;
     start = profiler::start();
-    gpu_emb_caches_[table_id]->Query(
+    table_cache(table_id)->Query(
         static_cast<TypeHashKey*>(workspace_handler.d_unique_output_embeddingcolumns_[table_id]),
         workspace_handler.h_unique_length_[table_id], workspace_handler.d_hit_emb_vec_[table_id],
         workspace_handler.d_missing_index_[table_id],
@@ -386,6 +587,41 @@ void EmbeddingCache<TypeHashKey>::lookup_from_device(size_t const table_id, floa
     // Set async flag
     HCTR_LIB_THROW(cudaStreamSynchronize(stream));
     ec_profiler_->end(start, "Native Embedding Cache Query API");
+
+    // Hot keys that were evicted from the GPU cache are still resident.
+    if (!hot_key_sets_.empty()) {
+      start = profiler::start();
+      const size_t missing_length = hot_key_sets_[table_id]->filter_missing(
+          static_cast<TypeHashKey*>(workspace_handler.d_missing_embeddingcolumns_[table_id]),
+          workspace_handler.d_missing_index_[table_id],
+          workspace_handler.h_missing_length_[table_id], workspace_handler.d_hit_emb_vec_[table_id],
+          stream);
+      if (missing_length != workspace_handler.h_missing_length_[table_id]) {
+        workspace_handler.h_missing_length_[table_id] = missing_length;
+        HCTR_LIB_THROW(cudaMemcpyAsync(workspace_handler.d_missing_length_ + table_id,
+                                       workspace_handler.h_missing_length_ + table_id,
+                                       sizeof(size_t), cudaMemcpyHostToDevice, stream));
+      }
+      ec_profiler_->end(start, "Resolve the missing keys from the hot key set");
+    }
+
+    // Keys that are unknown to the parameter server are answered with the default value right away.
+    if (!bloom_filters_.empty()) {
+      start = profiler::start();
+      const size_t missing_length = bloom_filters_[table_id]->filter_missing(
+          static_cast<TypeHashKey*>(workspace_handler.d_missing_embeddingcolumns_[table_id]),
+          workspace_handler.d_missing_index_[table_id],
+          workspace_handler.h_missing_length_[table_id], workspace_handler.d_hit_emb_vec_[table_id],
+          cache_config_.default_value_for_each_table[table_id],
+          cache_config_.embedding_vec_size_[table_id], stream);
+      if (missing_length != workspace_handler.h_missing_length_[table_id]) {
+        workspace_handler.h_missing_length_[table_id] = missing_length;
+        HCTR_LIB_THROW(cudaMemcpyAsync(workspace_handler.d_missing_length_ + table_id,
+                                       workspace_handler.h_missing_length_ + table_id,
+                                       sizeof(size_t), cudaMemcpyHostToDevice, stream));
+      }
+      ec_profiler_->end(start, "Filter the missing keys with the Bloom filter");
+    }
     if (workspace_handler.h_unique_length_[table_id] == 0) {
       workspace_handler.h_hit_rate_[table_id] = 1.0;
     } else {
@@ -394,17 +630,43 @@ void EmbeddingCache<TypeHashKey>::lookup_from_device(size_t const table_id, floa
                  static_cast<double>(workspace_handler.h_unique_length_[table_id]));
     }
 
-    bool async_insert_flag{workspace_handler.h_hit_rate_[table_id] >= hit_rate_threshold};
+    // The threshold is either fixed, or learned from the insert costs observed for this table.
+    HitRateThresholdController* const threshold_controller{
+        hit_rate_threshold_controllers_.empty() ? nullptr
+                                                : hit_rate_threshold_controllers_[table_id].get()};
+    float threshold{hit_rate_threshold};
+    if (threshold_controller) {
+      threshold = threshold_controller->threshold();
+      threshold_controller->record_lookup(workspace_handler.h_hit_rate_[table_id],
+                                          workspace_handler.h_missing_length_[table_id]);
+      start = profiler::start(threshold, ProfilerType_t::Occupancy);
+      ec_profiler_->end(start, "The learned hit rate threshold of Embedding Cache",
+                        ProfilerType_t::Occupancy);
+    }
+
+    table_metrics_[table_id].unique_keys->add(workspace_handler.h_unique_length_[table_id]);
+    table_metrics_[table_id].missing_keys->add(workspace_handler.h_missing_length_[table_id]);
+    table_metrics_[table_id].hit_rate->set(workspace_handler.h_hit_rate_[table_id]);
+
+    bool async_insert_flag{workspace_handler.h_hit_rate_[table_id] >= threshold};
     start = profiler::start(workspace_handler.h_hit_rate_[table_id], ProfilerType_t::Occupancy);
     ec_profiler_->end(start, "The hit rate of Embedding Cache", ProfilerType_t::Occupancy);
 
     // Handle the missing keys mode 1: synchronous
     if (!async_insert_flag) {
+      HCTR_NVTX_RANGE("HPS insert missing keys");
       start = profiler::start();
+      Timer insert_timer;
+      insert_timer.start();
       parameter_server_->insert_embedding_cache(table_id, this->shared_from_this(),
                                                 workspace_handler, stream);
       // Wait for memory copy to complete
       HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+      insert_timer.stop();
+      if (threshold_controller) {
+        threshold_controller->record_insert(workspace_handler.h_missing_length_[table_id],
+                                            insert_timer.elapsedMicroseconds());
+      }
       ec_profiler_->end(start, "Missing key synchronization insert into Embedding Cache");
       start = profiler::start();
       merge_emb_vec_async(workspace_handler.d_hit_emb_vec_[table_id],
@@ -440,10 +702,19 @@ void EmbeddingCache<TypeHashKey>::lookup_from_device(size_t const table_id, floa
     // Handle the missing keys, mode 2: synchronous
     if (async_insert_flag) {
       std::lock_guard<std::mutex> lock(mutex_);
-      insert_workers_.submit([this, self(this->shared_from_this()), table_id, memory_block]() {
+      insert_workers_.submit([this, self(this->shared_from_this()), table_id, memory_block,
+                              threshold_controller]() {
+        // The memory block is released by the insert.
+        const size_t num_missing_keys{memory_block->worker_buffer.h_missing_length_[table_id]};
+        Timer insert_timer;
+        insert_timer.start();
         parameter_server_insert_thread_func_<TypeHashKey>(table_id, parameter_server_, self,
                                                           memory_block, insert_streams_[table_id],
                                                           stream_mutex_);
+        insert_timer.stop();
+        if (threshold_controller) {
+          threshold_controller->record_insert(num_missing_keys, insert_timer.elapsedMicroseconds());
+        }
       });
     } else {
       parameter_server_->free_buffer(memory_block);
@@ -455,6 +726,124 @@ void EmbeddingCache<TypeHashKey>::lookup_from_device(size_t const table_id, floa
   }
 }
 
+template <typename TypeHashKey>
+bool EmbeddingCache<TypeHashKey>::lookup_from_device_capturable(size_t const table_id,
+                                                                float* const d_vectors,
+                                                                const void* const d_keys,
+                                                                size_t const num_keys,
+                                                                cudaStream_t stream) {
+  if (!cache_config_.use_gpu_embedding_cache_) {
+    return false;
+  }
+  CudaDeviceContext dev_restorer;
+  dev_restorer.check_device(cache_config_.cuda_dev_id_);
+
+  CapturableLookupContext& context{get_capturable_lookup_context(table_id, stream)};
+  EmbeddingCacheWorkspace& workspace_handler{context.memory_block->worker_buffer};
+
+  // Query without deduplication, so that no length has to be read back. Hits are written into the
+  // output directly, and misses are filled with the default embedding vector.
+  const size_t task_per_warp_tile = (num_keys < 1000000) ? 1 : 32;
+  table_cache(table_id)->Query(
+      static_cast<const TypeHashKey*>(d_keys), num_keys, d_vectors,
+      workspace_handler.d_missing_index_[table_id],
+      static_cast<TypeHashKey*>(workspace_handler.d_missing_embeddingcolumns_[table_id]),
+      workspace_handler.d_missing_length_ + table_id, stream, task_per_warp_tile);
+  if (num_keys == 0) {
+    return true;
+  }
+  fill_default_emb_vec_async(d_vectors, cache_config_.default_value_for_each_table[table_id],
+                             workspace_handler.d_missing_index_[table_id],
+                             workspace_handler.d_missing_length_ + table_id, num_keys,
+                             cache_config_.embedding_vec_size_[table_id], BLOCK_SIZE_, stream);
+
+  // Hand the missing keys to the insert workers through a host node.
+  HCTR_LIB_THROW(cudaMemcpyAsync(workspace_handler.h_missing_length_ + table_id,
+                                 workspace_handler.d_missing_length_ + table_id, sizeof(size_t),
+                                 cudaMemcpyDeviceToHost, stream));
+  HCTR_LIB_THROW(cudaMemcpyAsync(workspace_handler.h_missing_embeddingcolumns_[table_id],
+                                 workspace_handler.d_missing_embeddingcolumns_[table_id],
+                                 num_keys * sizeof(TypeHashKey), cudaMemcpyDeviceToHost, stream));
+  HCTR_LIB_THROW(cudaLaunchHostFunc(stream, capturable_lookup_callback, &context));
+  return true;
+}
+
+template <typename TypeHashKey>
+typename EmbeddingCache<TypeHashKey>::CapturableLookupContext&
+EmbeddingCache<TypeHashKey>::get_capturable_lookup_context(const size_t table_id,
+                                                           cudaStream_t stream) {
+  std::lock_guard<std::mutex> lock(capturable_lookup_mutex_);
+  auto it = capturable_lookup_contexts_.find(stream);
+  if (it == capturable_lookup_contexts_.end()) {
+    // The first lookup on a stream is usually the one being captured. Relax the capture mode, so
+    // that setting up the workspace does not invalidate the capture.
+    cudaStreamCaptureMode capture_mode{cudaStreamCaptureModeRelaxed};
+    HCTR_LIB_THROW(cudaThreadExchangeStreamCaptureMode(&capture_mode));
+    MemoryBlock* memory_block = nullptr;
+    while (memory_block == nullptr) {
+      memory_block = reinterpret_cast<struct MemoryBlock*>(parameter_server_->apply_buffer(
+          cache_config_.model_name_, cache_config_.cuda_dev_id_, CACHE_SPACE_TYPE::WORKER));
+    }
+    HCTR_LIB_THROW(cudaThreadExchangeStreamCaptureMode(&capture_mode));
+
+    std::vector<CapturableLookupContext> contexts;
+    contexts.reserve(cache_config_.num_emb_table_);
+    for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
+      contexts.push_back({this, memory_block, i});
+    }
+    it = capturable_lookup_contexts_.emplace(stream, std::move(contexts)).first;
+  }
+  return it->second[table_id];
+}
+
+template <typename TypeHashKey>
+void CUDART_CB EmbeddingCache<TypeHashKey>::capturable_lookup_callback(void* const user_data) {
+  const CapturableLookupContext& context{*static_cast<CapturableLookupContext*>(user_data)};
+  const EmbeddingCacheWorkspace& workspace_handler{context.memory_block->worker_buffer};
+  const size_t num_missing_keys{workspace_handler.h_missing_length_[context.table_id]};
+  if (num_missing_keys == 0) {
+    return;
+  }
+  const TypeHashKey* const missing_keys{
+      static_cast<TypeHashKey*>(workspace_handler.h_missing_embeddingcolumns_[context.table_id])};
+  context.cache->insert_missing_keys_async(
+      context.table_id, std::vector<TypeHashKey>(missing_keys, missing_keys + num_missing_keys));
+}
+
+template <typename TypeHashKey>
+void EmbeddingCache<TypeHashKey>::insert_missing_keys_async(const size_t table_id,
+                                                            std::vector<TypeHashKey> keys) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  insert_workers_.submit([this, self(this->shared_from_this()), table_id,
+                          keys(std::move(keys))]() mutable {
+    // Keys were not deduplicated by the lookup.
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    MemoryBlock* memory_block = nullptr;
+    while (memory_block == nullptr) {
+      memory_block = reinterpret_cast<struct MemoryBlock*>(parameter_server_->apply_buffer(
+          cache_config_.model_name_, cache_config_.cuda_dev_id_, CACHE_SPACE_TYPE::WORKER));
+    }
+    EmbeddingCacheWorkspace& workspace_handler{memory_block->worker_buffer};
+    try {
+      CudaDeviceContext dev_restorer{cache_config_.cuda_dev_id_};
+      workspace_handler.h_missing_length_[table_id] = keys.size();
+      HCTR_LIB_THROW(cudaMemcpyAsync(workspace_handler.d_missing_embeddingcolumns_[table_id],
+                                     keys.data(), keys.size() * sizeof(TypeHashKey),
+                                     cudaMemcpyHostToDevice, insert_streams_[table_id]));
+    } catch (const std::runtime_error& rt_err) {
+      parameter_server_->free_buffer(memory_block);
+      HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
+      return;
+    }
+    // The memory block is released by the insert.
+    parameter_server_insert_thread_func_<TypeHashKey>(table_id, parameter_server_, self,
+                                                      memory_block, insert_streams_[table_id],
+                                                      stream_mutex_);
+  });
+}
+
 template <typename TypeHashKey>
 void EmbeddingCache<TypeHashKey>::insert(const size_t table_id,
                                          EmbeddingCacheWorkspace& workspace_handler,
@@ -463,10 +852,22 @@ void EmbeddingCache<TypeHashKey>::insert(const size_t table_id,
   if (cache_config_.use_gpu_embedding_cache_) {
     CudaDeviceContext dev_restorer;
     dev_restorer.check_device(cache_config_.cuda_dev_id_);
-    gpu_emb_caches_[table_id]->Replace(
+    table_cache(table_id)->Replace(
         static_cast<TypeHashKey*>(workspace_handler.d_missing_embeddingcolumns_[table_id]),
         workspace_handler.h_missing_length_[table_id],
         workspace_handler.d_missing_emb_vec_[table_id], stream);
+    if (!ghost_lists_.empty()) {
+      ghost_lists_[table_id]->record(
+          static_cast<const TypeHashKey*>(workspace_handler.h_missing_embeddingcolumns_[table_id]),
+          workspace_handler.h_missing_length_[table_id]);
+    }
+    // Keys that keep missing are promoted, so that `Replace` cannot evict them anymore.
+    if (!hot_key_sets_.empty()) {
+      hot_key_sets_[table_id]->record(
+          static_cast<const TypeHashKey*>(workspace_handler.h_missing_embeddingcolumns_[table_id]),
+          workspace_handler.d_missing_emb_vec_[table_id],
+          workspace_handler.h_missing_length_[table_id], stream);
+    }
   }
 }
 
@@ -478,7 +879,7 @@ void EmbeddingCache<TypeHashKey>::init(const size_t table_id,
   if (cache_config_.use_gpu_embedding_cache_) {
     CudaDeviceContext dev_restorer;
     dev_restorer.check_device(cache_config_.cuda_dev_id_);
-    gpu_emb_caches_[table_id]->Replace(
+    table_cache(table_id)->Replace(
         static_cast<TypeHashKey*>(refreshspace_handler.d_refresh_embeddingcolumns_),
         *refreshspace_handler.h_length_, refreshspace_handler.d_refresh_emb_vec_, stream);
   }
@@ -506,8 +907,8 @@ void EmbeddingCache<TypeHashKey>::dump(const size_t table_id, void* const d_keys
     dev_restorer.check_device(cache_config_.cuda_dev_id_);
     // Call GPU cache API
     BaseUnit* start = profiler::start();
-    gpu_emb_caches_[table_id]->Dump(static_cast<TypeHashKey*>(d_keys), d_length, start_index,
-                                    end_index, stream);
+    table_cache(table_id)->Dump(static_cast<TypeHashKey*>(d_keys), d_length, start_index,
+                                end_index, stream);
     ec_profiler_->end(start, "Dump the exist keys from Embedding Cache", ProfilerType_t::Timeliness,
                       stream);
   }
@@ -527,13 +928,39 @@ void EmbeddingCache<TypeHashKey>::refresh(const size_t table_id, const void* con
     dev_restorer.check_device(cache_config_.cuda_dev_id_);
     BaseUnit* start = profiler::start();
     // Call GPU cache API
-    gpu_emb_caches_[table_id]->Update(static_cast<const TypeHashKey*>(d_keys), length,
-                                      static_cast<const float*>(d_vectors), stream, SLAB_SIZE);
+    table_cache(table_id)->Update(static_cast<const TypeHashKey*>(d_keys), length,
+                                  static_cast<const float*>(d_vectors), stream, SLAB_SIZE);
+    if (!hot_key_sets_.empty()) {
+      hot_key_sets_[table_id]->refresh(static_cast<const TypeHashKey*>(d_keys),
+                                       static_cast<const float*>(d_vectors), length, stream);
+    }
     ec_profiler_->end(start, "Refresh/Update exist embedding vector in Embedding cache",
                       ProfilerType_t::Timeliness, stream);
   }
 }
 
+template <typename TypeHashKey>
+void EmbeddingCache<TypeHashKey>::load_from_device(const size_t table_id, const void* const d_keys,
+                                                   const float* const d_vectors,
+                                                   const size_t num_keys, cudaStream_t stream) {
+  HCTR_THROW_IF(!cache_config_.use_gpu_embedding_cache_, Error_t::IllegalCall,
+                "Loading from device requires the GPU embedding cache to be enabled");
+  if (num_keys == 0) {
+    return;
+  }
+  CudaDeviceContext dev_restorer;
+  dev_restorer.check_device(cache_config_.cuda_dev_id_);
+  // Unlike refresh(), the keys missing from the cache are inserted. The rows that do not fit into
+  // the cache are served from the database tiers, which still hold the values of the model files.
+  table_cache(table_id)->Replace(static_cast<const TypeHashKey*>(d_keys), num_keys, d_vectors,
+                                 stream);
+  if (!hot_key_sets_.empty()) {
+    hot_key_sets_[table_id]->refresh(static_cast<const TypeHashKey*>(d_keys), d_vectors, num_keys,
+                                     stream);
+  }
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+}
+
 template <typename TypeHashKey>
 void EmbeddingCache<TypeHashKey>::finalize() {
   if (cache_config_.use_gpu_embedding_cache_) {
@@ -544,7 +971,177 @@ void EmbeddingCache<TypeHashKey>::finalize() {
 
     // Join insert threads
     insert_workers_.await_idle();
+
+    // Return the workspaces of graph-capturable lookups.
+    std::lock_guard<std::mutex> capturable_lookup_lock(capturable_lookup_mutex_);
+    for (auto& stream_contexts : capturable_lookup_contexts_) {
+      parameter_server_->free_buffer(stream_contexts.second.front().memory_block);
+    }
+    capturable_lookup_contexts_.clear();
+  }
+}
+
+template <typename TypeHashKey>
+size_t EmbeddingCache<TypeHashKey>::conflict_evictions(const size_t table_id) {
+  if (!cache_config_.use_gpu_embedding_cache_) {
+    return 0;
+  }
+  CudaDeviceContext dev_restorer{cache_config_.cuda_dev_id_};
+  return table_cache(table_id)->ConflictEvictions(refresh_streams_[table_id]);
+}
+
+template <typename TypeHashKey>
+size_t EmbeddingCache<TypeHashKey>::ghost_list_capacity(const size_t table_id) const {
+  // The ghost list covers the capacity that one rebalancing step moves.
+  const size_t num_keys = SLAB_SIZE * cache_config_.set_associativity_[table_id] *
+                          cache_config_.num_set_in_cache_[table_id];
+  return static_cast<size_t>(rebalance_percentage_ * static_cast<double>(num_keys));
+}
+
+template <typename TypeHashKey>
+void EmbeddingCache<TypeHashKey>::rebalance_capacity() {
+  if (ghost_lists_.empty()) {
+    return;
+  }
+  const size_t num_tables = cache_config_.num_emb_table_;
+  std::vector<size_t> set_bytes(num_tables);
+  std::vector<double> gain_per_byte(num_tables);
+  for (size_t i = 0; i < num_tables; i++) {
+    const size_t row_bytes =
+        sizeof(TypeHashKey) + cache_config_.embedding_vec_size_[i] * sizeof(float);
+    set_bytes[i] = SLAB_SIZE * cache_config_.set_associativity_[i] * row_bytes;
+    gain_per_byte[i] = static_cast<double>(ghost_lists_[i]->take_hits()) /
+                       static_cast<double>(ghost_lists_[i]->capacity() * row_bytes);
+  }
+  const std::vector<size_t> num_sets = rebalance_cache_sets(
+      cache_config_.num_set_in_cache_, set_bytes, gain_per_byte, rebalance_percentage_);
+
+  // Shrink before growing, so that less memory is needed at once.
+  for (const bool shrink : {true, false}) {
+    for (size_t i = 0; i < num_tables; i++) {
+      const size_t old_num_set = cache_config_.num_set_in_cache_[i];
+      if (num_sets[i] != old_num_set && (num_sets[i] < old_num_set) == shrink) {
+        HCTR_LOG_S(INFO, WORLD) << "Resizing the embedding cache of table "
+                                << cache_config_.embedding_table_name_[i] << " of model "
+                                << cache_config_.model_name_ << " on device "
+                                << cache_config_.cuda_dev_id_ << " from " << old_num_set << " to "
+                                << num_sets[i] << " sets." << std::endl;
+        resize_table_cache(i, num_sets[i]);
+      }
+    }
+  }
+}
+
+template <typename TypeHashKey>
+void EmbeddingCache<TypeHashKey>::resize_table_cache(const size_t table_id, const size_t num_set) {
+  CudaDeviceContext dev_restorer{cache_config_.cuda_dev_id_};
+  const std::shared_ptr<gpu_cache::gpu_cache_api<TypeHashKey>> old_cache = table_cache(table_id);
+  std::shared_ptr<gpu_cache::gpu_cache_api<TypeHashKey>> new_cache =
+      create_table_cache(table_id, num_set);
+
+  // Move the keys over like a refresh, with their current values from the parameter server.
+  MemoryBlock* memory_block = nullptr;
+  while (memory_block == nullptr) {
+    memory_block = reinterpret_cast<struct MemoryBlock*>(parameter_server_->apply_buffer(
+        cache_config_.model_name_, cache_config_.cuda_dev_id_, CACHE_SPACE_TYPE::REFRESHER));
+  }
+  EmbeddingCacheRefreshspace& refreshspace = memory_block->refresh_buffer;
+  cudaStream_t stream = refresh_streams_[table_id];
+  const size_t stride_set = cache_config_.num_set_in_refresh_workspace_;
+  const size_t old_num_set = cache_config_.num_set_in_cache_[table_id];
+  try {
+    for (size_t idx_set = 0; idx_set < old_num_set; idx_set += stride_set) {
+      const size_t end_idx = std::min(idx_set + stride_set, old_num_set);
+      old_cache->Dump(static_cast<TypeHashKey*>(refreshspace.d_refresh_embeddingcolumns_),
+                      refreshspace.d_length_, idx_set, end_idx, stream);
+      HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace.h_length_, refreshspace.d_length_,
+                                     sizeof(size_t), cudaMemcpyDeviceToHost, stream));
+      HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+      const size_t length = *refreshspace.h_length_;
+      if (length == 0) {
+        continue;
+      }
+      HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace.h_refresh_embeddingcolumns_,
+                                     refreshspace.d_refresh_embeddingcolumns_,
+                                     length * sizeof(TypeHashKey), cudaMemcpyDeviceToHost, stream));
+      HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+      parameter_server_->lookup(refreshspace.h_refresh_embeddingcolumns_, length,
+                                refreshspace.h_refresh_emb_vec_, cache_config_.model_name_,
+                                table_id);
+      HCTR_LIB_THROW(cudaMemcpyAsync(
+          refreshspace.d_refresh_emb_vec_, refreshspace.h_refresh_emb_vec_,
+          length * cache_config_.embedding_vec_size_[table_id] * sizeof(float),
+          cudaMemcpyHostToDevice, stream));
+      new_cache->Replace(static_cast<const TypeHashKey*>(refreshspace.d_refresh_embeddingcolumns_),
+                         length, refreshspace.d_refresh_emb_vec_, stream);
+      HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    }
+  } catch (...) {
+    parameter_server_->free_buffer(memory_block);
+    throw;
+  }
+  parameter_server_->free_buffer(memory_block);
+
+  // Lookups that still use the old cache keep it alive. Freeing its memory waits for the work that
+  // was queued on it.
+  std::atomic_store(&gpu_emb_caches_[table_id], std::move(new_cache));
+  cache_config_.num_set_in_cache_[table_id] = num_set;
+  ghost_lists_[table_id]->set_capacity(ghost_list_capacity(table_id));
+}
+
+template <typename TypeHashKey>
+void EmbeddingCache<TypeHashKey>::profiler_print() {
+  ec_profiler_->print();
+  if (cache_config_.use_gpu_embedding_cache_) {
+    for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
+      HCTR_LOG(INFO, ROOT, "Embedding cache conflict evictions of table %zu: %zu\n", i,
+               conflict_evictions(i));
+    }
+  }
+}
+
+template <typename TypeHashKey>
+void EmbeddingCache<TypeHashKey>::clear_bloom_filter(const size_t table_id) {
+  if (!bloom_filters_.empty()) {
+    CudaDeviceContext dev_restorer{cache_config_.cuda_dev_id_};
+    bloom_filters_[table_id]->clear();
+  }
+}
+
+template <typename TypeHashKey>
+void EmbeddingCache<TypeHashKey>::insert_bloom_filter(const size_t table_id,
+                                                      const void* const h_keys,
+                                                      const size_t num_keys) {
+  if (!bloom_filters_.empty()) {
+    CudaDeviceContext dev_restorer{cache_config_.cuda_dev_id_};
+    bloom_filters_[table_id]->insert(static_cast<const TypeHashKey*>(h_keys), num_keys);
+  }
+}
+
+template <typename TypeHashKey>
+void EmbeddingCache<TypeHashKey>::seal_bloom_filter(const size_t table_id) {
+  if (!bloom_filters_.empty()) {
+    bloom_filters_[table_id]->seal();
+  }
+}
+
+template <typename TypeHashKey>
+void EmbeddingCache<TypeHashKey>::refresh_hot_keys(const size_t table_id, cudaStream_t stream) {
+  if (hot_key_sets_.empty()) {
+    return;
+  }
+  CudaDeviceContext dev_restorer;
+  dev_restorer.check_device(cache_config_.cuda_dev_id_);
+
+  // Resident keys are not necessarily in the GPU cache, and hence are not covered by `dump`.
+  const std::vector<TypeHashKey> keys = hot_key_sets_[table_id]->keys();
+  if (keys.empty()) {
+    return;
   }
+  std::vector<float> vectors(keys.size() * cache_config_.embedding_vec_size_[table_id]);
+  parameter_server_->lookup(keys.data(), keys.size(), vectors.data(), cache_config_.model_name_,
+                            table_id);
+  hot_key_sets_[table_id]->refresh_from_host(keys.data(), vectors.data(), keys.size(), stream);
 }
 
 template <typename TypeHashKey>
@@ -717,13 +1314,15 @@ EmbeddingCacheRefreshspace EmbeddingCache<TypeHashKey>::create_refreshspace() {
                                                cache_config_.num_set_in_cache_.end());
     const int max_embedding_size = *max_element(cache_config_.embedding_vec_size_.begin(),
                                                 cache_config_.embedding_vec_size_.end());
-    const size_t max_num_keys = (SLAB_SIZE * SET_ASSOCIATIVITY) * max_num_cache_set;
+    const size_t max_set_associativity = *max_element(cache_config_.set_associativity_.begin(),
+                                                      cache_config_.set_associativity_.end());
+    const size_t max_num_keys = (SLAB_SIZE * max_set_associativity) * max_num_cache_set;
     const size_t max_num_key_in_buffer =
-        std::max(float(SLAB_SIZE * SET_ASSOCIATIVITY),
+        std::max(float(SLAB_SIZE * max_set_associativity),
                  cache_config_.cache_refresh_percentage_per_iteration * max_num_keys);
     cache_config_.num_set_in_refresh_workspace_ =
-        (max_num_key_in_buffer + SLAB_SIZE * SET_ASSOCIATIVITY - 1) /
-        (SLAB_SIZE * SET_ASSOCIATIVITY);
+        (max_num_key_in_buffer + SLAB_SIZE * max_set_associativity - 1) /
+        (SLAB_SIZE * max_set_associativity);
 
     CudaDeviceContext dev_restorer;
     dev_restorer.check_device(cache_config_.cuda_dev_id_);
@@ -46,12 +46,17 @@ static void parameter_server_insert_thread_func_2_(
     std::uniform_real_distribution<float> dist;
     float hist = dist(private_data->rd_);
     if (hist > workspace_handler.h_hit_rate_[table_id]) {
-      embedding_cache->Replace(
-          table_id,
-          static_cast<TypeHashKey*>(workspace_handler.h_missing_embeddingcolumns_[table_id]),
-          workspace_handler.h_missing_length_[table_id],
-          workspace_handler.d_missing_emb_vec_[table_id], workspace_handler.h_hit_rate_[table_id],
-          private_data->modify_handle_, private_data->modify_event_, stream);
+      const TypeHashKey* h_keys{
+          static_cast<TypeHashKey*>(workspace_handler.h_missing_embeddingcolumns_[table_id])};
+      const float* d_values{workspace_handler.d_missing_emb_vec_[table_id]};
+      const size_t len{embedding_cache->Admit(table_id, private_data, h_keys,
+                                              workspace_handler.h_missing_length_[table_id],
+                                              d_values, stream)};
+      if (len != 0) {
+        embedding_cache->Replace(table_id, h_keys, len, d_values,
+                                 workspace_handler.h_hit_rate_[table_id],
+                                 private_data->modify_handle_, private_data->modify_event_, stream);
+      }
     }
 
     parameter_server->free_buffer(memory_block);
@@ -67,7 +72,7 @@ EmbeddingCacheStoch<TypeHashKey>::EmbeddingCacheStoch(
     HierParameterServerBase* const parameter_server)
     : EmbeddingCacheBase(),
       parameter_server_(parameter_server),
-      insert_workers_("EC insert",
+      insert_workers_("EC insert", TaskPriority::Refresh,
                       std::min(static_cast<unsigned int>(inference_params.thread_pool_size),
                                std::thread::hardware_concurrency())) {
   auto b2s = [](const char val) { return val ? "True" : "False"; };
@@ -129,6 +134,7 @@ EmbeddingCacheStoch<TypeHashKey>::EmbeddingCacheStoch(
 
   // Query the size of all embedding tables and calculate the size of each embedding cache
   if (cache_config_.use_gpu_embedding_cache_) {
+    cache_config_.set_associativity_.assign(cache_config_.num_emb_table_, SET_ASSOCIATIVITY);
     cache_config_.num_set_in_cache_.reserve(cache_config_.num_emb_table_);
     for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
       const size_t row_num = ps_config.embedding_key_count_.at(inference_params.model_name)[i];
@@ -180,10 +186,14 @@ EmbeddingCacheStoch<TypeHashKey>::EmbeddingCacheStoch(
       insert_streams_.push_back(stream);
     }
 
+    // Refreshes run at the lowest stream priority, so that the lookups are scheduled first.
+    int least_priority = 0;
+    int greatest_priority = 0;
+    cudaDeviceGetStreamPriorityRange(&least_priority, &greatest_priority);
     refresh_streams_.reserve(cache_config_.num_emb_table_);
     for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
       cudaStream_t stream;
-      cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking);
+      cudaStreamCreateWithPriority(&stream, cudaStreamNonBlocking, least_priority);
       refresh_streams_.push_back(stream);
 
       // handle private data
@@ -200,6 +210,23 @@ EmbeddingCacheStoch<TypeHashKey>::EmbeddingCacheStoch(
                                               max_num_key_in_buffer);
       refresh_private_data_.push_back(ref_private_data);
     }
+
+    admission_filters_.resize(cache_config_.num_emb_table_);
+    for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
+      const AdmissionPolicy_t policy{i < inference_params.admission_policy_per_table.size()
+                                         ? inference_params.admission_policy_per_table[i]
+                                         : AdmissionPolicy_t::Disabled};
+      if (policy == AdmissionPolicy_t::Disabled) {
+        continue;
+      }
+      const float threshold{i < inference_params.admission_threshold_per_table.size()
+                                ? inference_params.admission_threshold_per_table[i]
+                                : 0.f};
+      admission_filters_[i] = std::make_unique<AdmissionFilter<TypeHashKey>>(
+          policy, threshold, SLAB_SIZE * SET_ASSOCIATIVITY * cache_config_.num_set_in_cache_[i]);
+      HCTR_LOG(INFO, ROOT, "Admission policy of embedding table %zu: %s, threshold: %f\n", i,
+               hctr_enum_to_c_str(policy), admission_filters_[i]->threshold());
+    }
   }
 }
 template <typename TypeHashKey>
@@ -500,6 +527,35 @@ void EmbeddingCacheStoch<TypeHashKey>::Replace(const size_t table_id, const Type
   }
 }
 
+template <typename TypeHashKey>
+size_t EmbeddingCacheStoch<TypeHashKey>::Admit(const size_t table_id,
+                                               WorkspacePrivateData* const private_data,
+                                               const TypeHashKey*& h_keys, const size_t len,
+                                               const float*& d_values, cudaStream_t stream) {
+  AdmissionFilter<TypeHashKey>* const filter{admission_filters_[table_id].get()};
+  if (!filter || len == 0) {
+    return len;
+  }
+  const size_t num_admitted{filter->admit(h_keys, len, private_data->h_admitted_index_)};
+  if (num_admitted == len || num_admitted == 0) {
+    return num_admitted;
+  }
+
+  // Compact the admitted keys and gather their embedding vectors. Replace is issued on the same
+  // stream, hence there is no need to wait for the gather here.
+  for (size_t i = 0; i < num_admitted; i++) {
+    private_data->h_admitted_keys_[i] = h_keys[private_data->h_admitted_index_[i]];
+  }
+  HCTR_LIB_THROW(cudaMemcpyAsync(private_data->d_admitted_index_, private_data->h_admitted_index_,
+                                 num_admitted * sizeof(uint64_t), cudaMemcpyHostToDevice, stream));
+  decompress_emb_vec_async(d_values, private_data->d_admitted_index_,
+                           private_data->d_admitted_emb_vec_, num_admitted,
+                           cache_config_.embedding_vec_size_[table_id], BLOCK_SIZE_, stream);
+  h_keys = private_data->h_admitted_keys_;
+  d_values = private_data->d_admitted_emb_vec_;
+  return num_admitted;
+}
+
 // insert
 template <typename TypeHashKey>
 void EmbeddingCacheStoch<TypeHashKey>::insert(const size_t table_id,
@@ -690,6 +746,18 @@ EmbeddingCacheWorkspace EmbeddingCacheStoch<TypeHashKey>::create_workspace() {
                                               cache_config_.max_query_len_per_emb_table_[i]);
       gpu_emb_caches_[i]->LookupContextCreate(private_data_ptr->lookup_handle_, nullptr, 0);
       HCTR_LIB_THROW(cudaEventCreate(&private_data_ptr->modify_event_));
+      if (admission_filters_[i]) {
+        const size_t max_query_len = cache_config_.max_query_len_per_emb_table_[i];
+        HCTR_LIB_THROW(cudaHostAlloc(reinterpret_cast<void**>(&private_data_ptr->h_admitted_keys_),
+                                     max_query_len * sizeof(TypeHashKey), cudaHostAllocPortable));
+        HCTR_LIB_THROW(cudaHostAlloc(reinterpret_cast<void**>(&private_data_ptr->h_admitted_index_),
+                                     max_query_len * sizeof(uint64_t), cudaHostAllocPortable));
+        HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void**>(&private_data_ptr->d_admitted_index_),
+                                  max_query_len * sizeof(uint64_t)));
+        HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void**>(&private_data_ptr->d_admitted_emb_vec_),
+                                  max_query_len * cache_config_.embedding_vec_size_[i] *
+                                      sizeof(float)));
+      }
       workspace_handler.private_data_.push_back(private_data_ptr);
     }
   }
@@ -751,6 +819,10 @@ void EmbeddingCacheStoch<TypeHashKey>::destroy_workspace(
       gpu_emb_caches_[i]->LookupContextDestroy(private_data_ptr->lookup_handle_);
       HCTR_LIB_THROW(cudaEventSynchronize(private_data_ptr->modify_event_));
       HCTR_LIB_THROW(cudaEventDestroy(private_data_ptr->modify_event_));
+      HCTR_LIB_THROW(cudaFreeHost(private_data_ptr->h_admitted_keys_));
+      HCTR_LIB_THROW(cudaFreeHost(private_data_ptr->h_admitted_index_));
+      HCTR_LIB_THROW(cudaFree(private_data_ptr->d_admitted_index_));
+      HCTR_LIB_THROW(cudaFree(private_data_ptr->d_admitted_emb_vec_));
       delete private_data_ptr;
     }
   }
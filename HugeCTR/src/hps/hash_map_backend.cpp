@@ -14,14 +14,22 @@
  * limitations under the License.
  */
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
+#include <array>
 #include <atomic>
+#include <cerrno>
 #include <core23/logger.hpp>
 #include <cstring>
 #include <execution>
 #include <hps/hash_map_backend.hpp>
 #include <hps/hash_map_backend_detail.hpp>
 #include <hps/hier_parameter_server_base.hpp>
+#include <malloc.h>
+#include <numeric>
 #include <random>
 
 // TODO: Remove me!
@@ -30,7 +38,11 @@
 namespace HugeCTR {
 
 template <typename Key>
-HashMapBackend<Key>::HashMapBackend(const HashMapBackendParams& params) : Base(params) {
+HashMapBackend<Key>::HashMapBackend(const HashMapBackendParams& params)
+    : Base(params), char_allocator_{params.value_page_size, params.numa_node} {
+  HCTR_THROW_IF(!is_valid_host_page_size(params.value_page_size), Error_t::WrongInput,
+                "The value page size must be 0, 2 MiB or 1 GiB, not ", params.value_page_size,
+                " bytes.");
   HCTR_LOG_C(DEBUG, WORLD, "Created blank database backend in local memory!\n");
 }
 
@@ -38,21 +50,49 @@ template <typename Key>
 size_t HashMapBackend<Key>::size(const std::string& table_name) const {
   const std::shared_lock lock(read_write_guard_);
 
+  const auto& prehashed_it{prehashed_tables_.find(table_name)};
+  const size_t num_prehashed{prehashed_it == prehashed_tables_.end()
+                                 ? 0
+                                 : prehashed_it->second->num_keys()};
+
   // Locate the partitions.
   const auto& tables_it{tables_.find(table_name)};
   if (tables_it == tables_.end()) {
-    return 0;
+    return num_prehashed;
   }
-  const std::vector<Partition>& parts{tables_it->second};
+  const PartitionList& parts{tables_it->second};
 
-  return std::accumulate(parts.begin(), parts.end(), UINT64_C(0),
-                         [](const size_t a, const Partition& b) { return a + b.entries.size(); });
+  return std::accumulate(parts.begin(), parts.end(), num_prehashed,
+                         [](const size_t a, const Partition& b) {
+                           const std::shared_lock part_lock(b.read_write_guard);
+                           return a + b.entries.size();
+                         });
 }
 
 template <typename Key>
 size_t HashMapBackend<Key>::contains(const std::string& table_name, const size_t num_keys,
                                      const Key* const keys,
                                      const std::chrono::nanoseconds& time_budget) const {
+  const std::shared_ptr<const PrehashedTable<Key>> prehashed{find_prehashed_table_(table_name)};
+  if (!prehashed) {
+    return contains_(table_name, num_keys, keys, time_budget);
+  }
+
+  // Only the keys that are not in the pre-hashed table are looked up.
+  std::vector<Key> other_keys;
+  for (const Key* k{keys}; k != &keys[num_keys]; ++k) {
+    if (!prehashed->find(*k)) {
+      other_keys.push_back(*k);
+    }
+  }
+  return num_keys - other_keys.size() +
+         contains_(table_name, other_keys.size(), other_keys.data(), time_budget);
+}
+
+template <typename Key>
+size_t HashMapBackend<Key>::contains_(const std::string& table_name, const size_t num_keys,
+                                      const Key* const keys,
+                                      const std::chrono::nanoseconds& time_budget) const {
   const auto begin{std::chrono::high_resolution_clock::now()};
   const std::shared_lock lock(read_write_guard_);
 
@@ -61,7 +101,7 @@ size_t HashMapBackend<Key>::contains(const std::string& table_name, const size_t
   if (tables_it == tables_.end()) {
     return Base::contains(table_name, num_keys, keys, time_budget);
   }
-  const std::vector<Partition>& parts{tables_it->second};
+  const PartitionList& parts{tables_it->second};
 
   const Key* const keys_end{&keys[num_keys]};
   const size_t num_partitions{parts.size()};
@@ -75,6 +115,7 @@ size_t HashMapBackend<Key>::contains(const std::string& table_name, const size_t
   } else if (num_keys == 1 || num_partitions == 1) {
     const size_t part_index{num_partitions == 1 ? 0 : HCTR_HPS_KEY_TO_PART_INDEX_(*keys)};
     const Partition& part{parts[part_index]};
+    const std::shared_lock part_lock(part.read_write_guard);
 
     // Step through keys batch-by-batch.
     std::chrono::nanoseconds elapsed;
@@ -96,6 +137,7 @@ size_t HashMapBackend<Key>::contains(const std::string& table_name, const size_t
 
     HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
       const Partition& part{parts[part_index]};
+      const std::shared_lock part_lock(part.read_write_guard);
 
       size_t hit_count{0};
 
@@ -132,19 +174,10 @@ size_t HashMapBackend<Key>::insert(const std::string& table_name, const size_t n
                                    const uint32_t value_size, const size_t value_stride) {
   HCTR_CHECK(value_size <= value_stride);
 
-  const std::unique_lock lock(read_write_guard_);
+  std::shared_lock lock(read_write_guard_);
 
   // Locate the partitions, or create them, if they do not exist yet.
-  const auto& tables_it{tables_.try_emplace(table_name).first};
-  std::vector<Partition>& parts{tables_it->second};
-  if (parts.empty()) {
-    HCTR_CHECK(value_size > 0 && value_size <= this->params_.allocation_rate);
-
-    parts.reserve(this->params_.num_partitions);
-    while (parts.size() < this->params_.num_partitions) {
-      parts.emplace_back(value_size, this->params_);
-    }
-  }
+  PartitionList& parts{get_or_create_table_(table_name, value_size, lock)};
 
   const Key* const keys_end{&keys[num_pairs]};
   const size_t num_partitions{parts.size()};
@@ -162,6 +195,8 @@ size_t HashMapBackend<Key>::insert(const std::string& table_name, const size_t n
 
     // Step through batch-by-batch.
     for (const Key* k{keys}; k != keys_end;) {
+      const std::unique_lock part_lock(part.read_write_guard);
+
       // Check overflow condition.
       if (part.entries.size() >= this->params_.overflow_margin) {
         resolve_overflow_(table_name, part_index, part);
@@ -189,6 +224,8 @@ size_t HashMapBackend<Key>::insert(const std::string& table_name, const size_t n
       // Step through batch-by-batch.
       size_t num_batches{0};
       for (const Key* k{keys}; k != keys_end; ++num_batches) {
+        const std::unique_lock part_lock(part.read_write_guard);
+
         // Check overflow condition.
         if (part.entries.size() >= this->params_.overflow_margin) {
           resolve_overflow_(table_name, part_index, part);
@@ -221,6 +258,33 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
                                   const Key* const keys, char* const values,
                                   const size_t value_stride, const DatabaseMissCallback& on_miss,
                                   const std::chrono::nanoseconds& time_budget) {
+  const std::shared_ptr<const PrehashedTable<Key>> prehashed{find_prehashed_table_(table_name)};
+  if (!prehashed) {
+    return fetch_(table_name, num_keys, keys, values, value_stride, on_miss, time_budget);
+  }
+  HCTR_CHECK(prehashed->value_size() <= value_stride);
+
+  // The keys that are not inserted are looked up in the pre-hashed table.
+  std::atomic<size_t> num_prehashed_hits{0};
+  const DatabaseMissCallback on_prehashed_miss{[&](const size_t index) {
+    const char* const value{prehashed->find(keys[index])};
+    if (value) {
+      std::copy_n(value, prehashed->value_size(), &values[index * value_stride]);
+      num_prehashed_hits.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      on_miss(index);
+    }
+  }};
+  const size_t hit_count{
+      fetch_(table_name, num_keys, keys, values, value_stride, on_prehashed_miss, time_budget)};
+  return hit_count + num_prehashed_hits.load(std::memory_order_relaxed);
+}
+
+template <typename Key>
+size_t HashMapBackend<Key>::fetch_(const std::string& table_name, const size_t num_keys,
+                                   const Key* const keys, char* const values,
+                                   const size_t value_stride, const DatabaseMissCallback& on_miss,
+                                   const std::chrono::nanoseconds& time_budget) {
   const auto begin{std::chrono::high_resolution_clock::now()};
   const std::shared_lock lock(read_write_guard_);
 
@@ -229,12 +293,11 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
   if (tables_it == tables_.end()) {
     return Base::fetch(table_name, num_keys, keys, values, value_stride, on_miss, time_budget);
   }
-  std::vector<Partition>& parts{tables_it->second};
+  PartitionList& parts{tables_it->second};
 
   const Key* const keys_end{&keys[num_keys]};
   const size_t num_partitions{parts.size()};
   const size_t max_batch_size{this->params_.max_batch_size};
-  const DatabaseOverflowPolicy_t overflow_policy{this->params_.overflow_policy};
 
   size_t miss_count{0};
   size_t skip_count{0};
@@ -245,6 +308,7 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
     const size_t part_index{num_partitions == 1 ? 0 : HCTR_HPS_KEY_TO_PART_INDEX_(*keys)};
     Partition& part{parts[part_index]};
     HCTR_CHECK(part.value_size <= value_stride);
+    const std::shared_lock part_lock(part.read_write_guard);
 
     // Step through input batch-by-batch.
     std::chrono::nanoseconds elapsed;
@@ -253,7 +317,11 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
 
       const size_t prev_miss_count{miss_count};
       const size_t batch_size{std::min<size_t>(keys_end - k, max_batch_size)};
-      HCTR_HPS_HASH_MAP_FETCH_(SEQUENTIAL_DIRECT);
+      const size_t offset{static_cast<size_t>(k - keys)};
+      miss_count += fetch_batch_(
+          part, batch_size, [offset](const size_t j) { return offset + j; }, keys, values,
+          value_stride, on_miss);
+      k += batch_size;
 
       HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
                  ", batch ", (k - keys - 1) / max_batch_size, ": ",
@@ -261,24 +329,39 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
                  " hits. Time: ", elapsed.count(), " / ", time_budget.count(), " ns.\n");
     }
   } else {
+    // Bucket keys by partition, so that each worker only visits the keys of its own partition.
+    std::vector<size_t> part_offsets;
+    std::vector<size_t> grouped_indices;
+    group_by_partition(num_partitions, num_keys, nullptr, keys, part_offsets, grouped_indices);
+
     std::atomic<size_t> joint_miss_count{0};
     std::atomic<size_t> joint_skip_count{0};
 
     HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+      const size_t* i{&grouped_indices[part_offsets[part_index]]};
+      const size_t* const indices_end{&grouped_indices[part_offsets[part_index + 1]]};
+      if (i == indices_end) {
+        return;
+      }
+
       Partition& part{parts[part_index]};
       HCTR_CHECK(part.value_size <= value_stride);
+      const std::shared_lock part_lock(part.read_write_guard);
 
       size_t miss_count{0};
+      size_t skip_count{0};
 
       // Step through input batch-by-batch.
       std::chrono::nanoseconds elapsed;
-      size_t num_batches{0};
-      for (const Key* k{keys}; k != keys_end; ++num_batches) {
-        HCTR_HPS_DB_CHECK_TIME_BUDGET_(PARALLEL_DIRECT, on_miss);
+      for (size_t num_batches{0}; i != indices_end; ++num_batches) {
+        HCTR_HPS_DB_CHECK_TIME_BUDGET_(SEQUENTIAL_INDIRECT, on_miss);
 
         const size_t prev_miss_count{miss_count};
-        size_t batch_size{0};
-        HCTR_HPS_HASH_MAP_FETCH_(PARALLEL_DIRECT);
+        const size_t batch_size{std::min<size_t>(indices_end - i, max_batch_size)};
+        miss_count += fetch_batch_(
+            part, batch_size, [i](const size_t j) { return i[j]; }, keys, values, value_stride,
+            on_miss);
+        i += batch_size;
 
         HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
                    ", batch ", num_batches, ": ", batch_size - miss_count + prev_miss_count, " / ",
@@ -287,6 +370,7 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
       }
 
       joint_miss_count += miss_count;
+      joint_skip_count += skip_count;
     });
 
     miss_count += joint_miss_count;
@@ -305,6 +389,35 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
                                   char* const values, const size_t value_stride,
                                   const DatabaseMissCallback& on_miss,
                                   const std::chrono::nanoseconds& time_budget) {
+  const std::shared_ptr<const PrehashedTable<Key>> prehashed{find_prehashed_table_(table_name)};
+  if (!prehashed) {
+    return fetch_(table_name, num_indices, indices, keys, values, value_stride, on_miss,
+                  time_budget);
+  }
+  HCTR_CHECK(prehashed->value_size() <= value_stride);
+
+  // The keys that are not inserted are looked up in the pre-hashed table.
+  std::atomic<size_t> num_prehashed_hits{0};
+  const DatabaseMissCallback on_prehashed_miss{[&](const size_t index) {
+    const char* const value{prehashed->find(keys[index])};
+    if (value) {
+      std::copy_n(value, prehashed->value_size(), &values[index * value_stride]);
+      num_prehashed_hits.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      on_miss(index);
+    }
+  }};
+  const size_t hit_count{fetch_(table_name, num_indices, indices, keys, values, value_stride,
+                                on_prehashed_miss, time_budget)};
+  return hit_count + num_prehashed_hits.load(std::memory_order_relaxed);
+}
+
+template <typename Key>
+size_t HashMapBackend<Key>::fetch_(const std::string& table_name, const size_t num_indices,
+                                   const size_t* const indices, const Key* const keys,
+                                   char* const values, const size_t value_stride,
+                                   const DatabaseMissCallback& on_miss,
+                                   const std::chrono::nanoseconds& time_budget) {
   const auto begin{std::chrono::high_resolution_clock::now()};
   const std::shared_lock lock(read_write_guard_);
 
@@ -314,12 +427,11 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
     return Base::fetch(table_name, num_indices, indices, keys, values, value_stride, on_miss,
                        time_budget);
   }
-  std::vector<Partition>& parts{tables_it->second};
+  PartitionList& parts{tables_it->second};
 
   const size_t* const indices_end{&indices[num_indices]};
   const size_t num_partitions{parts.size()};
   const size_t max_batch_size{this->params_.max_batch_size};
-  const DatabaseOverflowPolicy_t overflow_policy{this->params_.overflow_policy};
 
   size_t miss_count{0};
   size_t skip_count{0};
@@ -327,9 +439,10 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
   if (num_indices == 0) {
     // Do nothing ;-).
   } else if (num_indices == 1 || num_partitions == 1) {
-    const size_t part_index{num_partitions == 1 ? 0 : HCTR_HPS_KEY_TO_PART_INDEX_(*keys)};
+    const size_t part_index{num_partitions == 1 ? 0 : HCTR_HPS_KEY_TO_PART_INDEX_(keys[*indices])};
     Partition& part{parts[part_index]};
     HCTR_CHECK(part.value_size <= value_stride);
+    const std::shared_lock part_lock(part.read_write_guard);
 
     // Step through input batch-by-batch.
     std::chrono::nanoseconds elapsed;
@@ -338,7 +451,10 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
 
       const size_t prev_miss_count{miss_count};
       const size_t batch_size{std::min<size_t>(indices_end - i, max_batch_size)};
-      HCTR_HPS_HASH_MAP_FETCH_(SEQUENTIAL_INDIRECT);
+      miss_count += fetch_batch_(
+          part, batch_size, [i](const size_t j) { return i[j]; }, keys, values, value_stride,
+          on_miss);
+      i += batch_size;
 
       HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
                  ", batch ", (i - indices - 1) / max_batch_size, ": ",
@@ -346,24 +462,39 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
                  " hits. Time: ", elapsed.count(), " / ", time_budget.count(), " ns.\n");
     }
   } else {
+    // Bucket keys by partition, so that each worker only visits the keys of its own partition.
+    std::vector<size_t> part_offsets;
+    std::vector<size_t> grouped_indices;
+    group_by_partition(num_partitions, num_indices, indices, keys, part_offsets, grouped_indices);
+
     std::atomic<size_t> joint_miss_count{0};
     std::atomic<size_t> joint_skip_count{0};
 
     HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+      const size_t* i{&grouped_indices[part_offsets[part_index]]};
+      const size_t* const indices_end{&grouped_indices[part_offsets[part_index + 1]]};
+      if (i == indices_end) {
+        return;
+      }
+
       Partition& part{parts[part_index]};
       HCTR_CHECK(part.value_size <= value_stride);
+      const std::shared_lock part_lock(part.read_write_guard);
 
       size_t miss_count{0};
+      size_t skip_count{0};
 
       // Step through input batch-by-batch.
       std::chrono::nanoseconds elapsed;
-      size_t num_batches{0};
-      for (const size_t* i{indices}; i != indices_end; ++num_batches) {
-        HCTR_HPS_DB_CHECK_TIME_BUDGET_(PARALLEL_INDIRECT, on_miss);
+      for (size_t num_batches{0}; i != indices_end; ++num_batches) {
+        HCTR_HPS_DB_CHECK_TIME_BUDGET_(SEQUENTIAL_INDIRECT, on_miss);
 
         const size_t prev_miss_count{miss_count};
-        size_t batch_size{0};
-        HCTR_HPS_HASH_MAP_FETCH_(PARALLEL_INDIRECT);
+        const size_t batch_size{std::min<size_t>(indices_end - i, max_batch_size)};
+        miss_count += fetch_batch_(
+            part, batch_size, [i](const size_t j) { return i[j]; }, keys, values, value_stride,
+            on_miss);
+        i += batch_size;
 
         HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
                    ", batch ", num_batches, ": ", batch_size - miss_count + prev_miss_count, " / ",
@@ -372,6 +503,7 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
       }
 
       joint_miss_count += miss_count;
+      joint_skip_count += skip_count;
     });
 
     miss_count += joint_miss_count;
@@ -388,15 +520,22 @@ template <typename Key>
 size_t HashMapBackend<Key>::evict(const std::string& table_name) {
   const std::unique_lock lock(read_write_guard_);
 
+  // Detach the pre-hashed table.
+  size_t num_deletions{0};
+  const auto& prehashed_it{prehashed_tables_.find(table_name)};
+  if (prehashed_it != prehashed_tables_.end()) {
+    num_deletions += prehashed_it->second->num_keys();
+    prehashed_tables_.erase(prehashed_it);
+  }
+
   // Locate the partitions.
   const auto& tables_it{tables_.find(table_name)};
   if (tables_it == tables_.end()) {
-    return 0;
+    return num_deletions;
   }
-  const std::vector<Partition>& parts{tables_it->second};
+  const PartitionList& parts{tables_it->second};
 
   // Count items and erase.
-  size_t num_deletions{0};
   for (const Partition& part : parts) {
     num_deletions += part.entries.size();
   }
@@ -410,14 +549,14 @@ size_t HashMapBackend<Key>::evict(const std::string& table_name) {
 template <typename Key>
 size_t HashMapBackend<Key>::evict(const std::string& table_name, const size_t num_keys,
                                   const Key* const keys) {
-  const std::unique_lock lock(read_write_guard_);
+  const std::shared_lock lock(read_write_guard_);
 
   // Locate the partitions.
   const auto& tables_it{tables_.find(table_name)};
   if (tables_it == tables_.end()) {
     return 0;
   }
-  std::vector<Partition>& parts{tables_it->second};
+  PartitionList& parts{tables_it->second};
 
   const Key* const keys_end{&keys[num_keys]};
   const size_t num_partitions{parts.size()};
@@ -433,6 +572,8 @@ size_t HashMapBackend<Key>::evict(const std::string& table_name, const size_t nu
 
     // Step through input batch-by-batch.
     for (const Key* k{keys}; k != keys_end;) {
+      const std::unique_lock part_lock(part.read_write_guard);
+
       const size_t batch_size{std::min<size_t>(keys_end - k, max_batch_size)};
       const size_t prev_num_deletions{num_deletions};
       HCTR_HPS_HASH_MAP_EVICT_(SEQUENTIAL_DIRECT);
@@ -452,6 +593,8 @@ size_t HashMapBackend<Key>::evict(const std::string& table_name, const size_t nu
       // Step through input batch-by-batch.
       size_t num_batches{0};
       for (const Key* k{keys}; k != keys_end; ++num_batches) {
+        const std::unique_lock part_lock(part.read_write_guard);
+
         const size_t prev_num_deletions{num_deletions};
         size_t batch_size{0};
         HCTR_HPS_HASH_MAP_EVICT_(PARALLEL_DIRECT);
@@ -484,6 +627,11 @@ std::vector<std::string> HashMapBackend<Key>::find_tables(const std::string& mod
       matches.push_back(pair.first);
     }
   }
+  for (const auto& pair : prehashed_tables_) {
+    if (pair.first.find(tag_prefix) == 0 && tables_.find(pair.first) == tables_.end()) {
+      matches.push_back(pair.first);
+    }
+  }
   return matches;
 }
 
@@ -496,7 +644,7 @@ size_t HashMapBackend<Key>::dump_bin(const std::string& table_name, std::ofstrea
   if (tables_it == tables_.end()) {
     return 0;
   }
-  const std::vector<Partition>& parts{tables_it->second};
+  const PartitionList& parts{tables_it->second};
 
   // Store value size.
   const uint32_t value_size{parts.empty() ? 0 : parts.front().value_size};
@@ -504,11 +652,15 @@ size_t HashMapBackend<Key>::dump_bin(const std::string& table_name, std::ofstrea
 
   // Store values.
   size_t num_entries{0};
+  std::vector<char> value(value_size);
 
   for (const Partition& part : parts) {
+    const std::shared_lock part_lock(part.read_write_guard);
+
     for (const Entry& entry : part.entries) {
       file.write(reinterpret_cast<const char*>(&entry.first), sizeof(Key));
-      file.write(entry.second.value, value_size);
+      part.decode_value(entry.second.value, value.data());
+      file.write(value.data(), value_size);
     }
     num_entries += part.entries.size();
   }
@@ -516,6 +668,86 @@ size_t HashMapBackend<Key>::dump_bin(const std::string& table_name, std::ofstrea
   return num_entries;
 }
 
+template <typename Key>
+size_t HashMapBackend<Key>::dump_bin(const std::string& table_name, const std::string& path) {
+  // Pairs are encoded into buffers of about this size, which are then written at once.
+  static constexpr size_t buffer_size{64 * 1024 * 1024};
+
+  const std::shared_lock lock(read_write_guard_);
+
+  // Locate the partitions.
+  const auto& tables_it{tables_.find(table_name)};
+  if (tables_it == tables_.end()) {
+    return 0;
+  }
+  const PartitionList& parts{tables_it->second};
+
+  std::vector<std::shared_lock<std::shared_mutex>> part_locks;
+  part_locks.reserve(parts.size());
+  for (const Partition& part : parts) {
+    part_locks.emplace_back(part.read_write_guard);
+  }
+
+  const int fd{open(path.c_str(), O_WRONLY)};
+  HCTR_CHECK_HINT(fd >= 0, "Cannot open the dump ", path, ": ", std::strerror(errno), ".");
+  const std::unique_ptr<const int, void (*)(const int*)> fd_guard{
+      &fd, [](const int* const fd) { close(*fd); }};
+
+  // Writes all of [data, data + size) at offset.
+  const auto write_range = [&](const char* const data, const size_t size, const size_t offset) {
+    size_t num_written{0};
+    while (num_written < size) {
+      const ssize_t ret{pwrite(fd, data + num_written, size - num_written,
+                               static_cast<off_t>(offset + num_written))};
+      if (ret < 0 && errno == EINTR) {
+        continue;
+      }
+      HCTR_CHECK_HINT(ret > 0, "Cannot write the dump ", path, ": ", std::strerror(errno), ".");
+      num_written += static_cast<size_t>(ret);
+    }
+  };
+
+  // Store value size, after the header.
+  struct stat st;
+  HCTR_CHECK(fstat(fd, &st) == 0);
+  const size_t header_size{static_cast<size_t>(st.st_size)};
+  const uint32_t value_size{parts.empty() ? 0 : parts.front().value_size};
+  write_range(reinterpret_cast<const char*>(&value_size), sizeof(uint32_t), header_size);
+
+  // Partitions are stored one after another.
+  const size_t pair_size{sizeof(Key) + value_size};
+  std::vector<size_t> part_offsets(parts.size() + 1, header_size + sizeof(uint32_t));
+  for (size_t part_index{0}; part_index < parts.size(); ++part_index) {
+    const size_t part_size{parts[part_index].entries.size() * pair_size};
+    part_offsets[part_index + 1] = part_offsets[part_index] + part_size;
+  }
+  HCTR_CHECK(ftruncate(fd, static_cast<off_t>(part_offsets.back())) == 0);
+
+  // Store values.
+  const size_t num_partitions{parts.size()};
+  HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+    const Partition& part{parts[part_index]};
+
+    std::vector<char> buffer(std::max<size_t>(buffer_size / pair_size, 1) * pair_size);
+    size_t offset{part_offsets[part_index]};
+    char* pair{buffer.data()};
+    for (const Entry& entry : part.entries) {
+      std::memcpy(pair, &entry.first, sizeof(Key));
+      part.decode_value(entry.second.value, pair + sizeof(Key));
+      pair += pair_size;
+
+      if (pair == buffer.data() + buffer.size()) {
+        write_range(buffer.data(), buffer.size(), offset);
+        offset += buffer.size();
+        pair = buffer.data();
+      }
+    }
+    write_range(buffer.data(), static_cast<size_t>(pair - buffer.data()), offset);
+  });
+
+  return (part_offsets.back() - part_offsets.front()) / pair_size;
+}
+
 #ifdef HCTR_USE_ROCKS_DB
 template <typename Key>
 size_t HashMapBackend<Key>::dump_sst(const std::string& table_name, rocksdb::SstFileWriter& file) {
@@ -526,30 +758,38 @@ size_t HashMapBackend<Key>::dump_sst(const std::string& table_name, rocksdb::Sst
   if (tables_it == tables_.end()) {
     return 0;
   }
-  const std::vector<Partition>& parts{tables_it->second};
+  const PartitionList& parts{tables_it->second};
 
-  // Sort keys by value.
-  std::vector<const Entry*> entries;
+  // Entries are referenced directly. Hence, we must keep all partitions locked until we are done.
+  std::vector<std::shared_lock<std::shared_mutex>> part_locks;
+  part_locks.reserve(parts.size());
+  for (const Partition& part : parts) {
+    part_locks.emplace_back(part.read_write_guard);
+  }
+
+  // Sort keys by value. Values are decoded one by one, so we also remember their partition.
+  std::vector<std::pair<const Entry*, const Partition*>> entries;
   entries.reserve(
       std::accumulate(parts.begin(), parts.end(), UINT64_C(0),
                       [](const size_t a, const Partition& b) { return a + b.entries.size(); }));
   for (const Partition& part : parts) {
     for (const Entry& entry : part.entries) {
-      entries.emplace_back(&entry);
+      entries.emplace_back(&entry, &part);
     }
   }
   // TODO: Copy or ref? Chose ref because low memory footprint, but has worse cache locality.
   // Benchmark?
   std::sort(entries.begin(), entries.end(),
-            [](const auto& a, const auto& b) { return a->first < b->first; });
+            [](const auto& a, const auto& b) { return a.first->first < b.first->first; });
 
   // Iterate over pairs and insert.
+  std::vector<char> value(parts.empty() ? 0 : parts.front().value_size);
   rocksdb::Slice k_view{nullptr, sizeof(Key)};
-  rocksdb::Slice v_view{nullptr, parts.empty() ? 0 : parts.front().value_size};
+  rocksdb::Slice v_view{value.data(), value.size()};
 
-  for (const Entry* const entry : entries) {
+  for (const auto& [entry, part] : entries) {
     k_view.data_ = reinterpret_cast<const char*>(&entry->first);
-    v_view.data_ = entry->second.value;
+    part->decode_value(entry->second.value, value.data());
     HCTR_ROCKSDB_CHECK(file.Put(k_view, v_view));
   }
 
@@ -557,6 +797,173 @@ size_t HashMapBackend<Key>::dump_sst(const std::string& table_name, rocksdb::Sst
 }
 #endif  // HCTR_USE_ROCKS_DB
 
+template <typename Key>
+size_t HashMapBackend<Key>::attach_prehashed_table(const std::string& table_name,
+                                                   const std::string& path,
+                                                   const size_t value_size) {
+  auto prehashed{std::make_shared<const PrehashedTable<Key>>(path)};
+  HCTR_THROW_IF(prehashed->value_size() != value_size, Error_t::WrongInput, "Pre-hashed table '",
+                path, "' has ", prehashed->value_size(), " byte values, but table ", table_name,
+                " has ", value_size, " byte values.");
+  const size_t num_keys{prehashed->num_keys()};
+  {
+    const std::unique_lock lock(read_write_guard_);
+    prehashed_tables_[table_name] = std::move(prehashed);
+  }
+
+  HCTR_LOG_C(DEBUG, WORLD, get_name(), " backend; Table ", table_name, ": Attached ", num_keys,
+             " pre-hashed keys from '", path, "'.\n");
+  return num_keys;
+}
+
+template <typename Key>
+std::shared_ptr<const PrehashedTable<Key>> HashMapBackend<Key>::find_prehashed_table_(
+    const std::string& table_name) const {
+  const std::shared_lock lock(read_write_guard_);
+  const auto& it{prehashed_tables_.find(table_name)};
+  return it == prehashed_tables_.end() ? nullptr : it->second;
+}
+
+template <typename Key>
+HashMapBackendMemoryStats HashMapBackend<Key>::memory_stats(const std::string& table_name) const {
+  const std::shared_lock lock(read_write_guard_);
+
+  HashMapBackendMemoryStats stats;
+
+  // Locate the partitions.
+  const auto& tables_it{tables_.find(table_name)};
+  if (tables_it == tables_.end()) {
+    return stats;
+  }
+  const PartitionList& parts{tables_it->second};
+
+  for (const Partition& part : parts) {
+    const std::shared_lock part_lock(part.read_write_guard);
+
+    stats.num_pages += part.value_pages.size();
+    stats.num_slots += part.num_slots();
+    stats.num_free_slots += part.value_slots.size();
+    for (const ValuePage& page : part.value_pages) {
+      stats.num_bytes += page.size();
+    }
+  }
+
+  return stats;
+}
+
+template <typename Key>
+template <typename Indexer>
+size_t HashMapBackend<Key>::fetch_batch_(Partition& part, const size_t batch_size,
+                                         const Indexer& indexer, const Key* const keys,
+                                         char* const values, const size_t value_stride,
+                                         const DatabaseMissCallback& on_miss) {
+  const DatabaseOverflowPolicy_t overflow_policy{this->params_.overflow_policy};
+  const time_t now{overflow_policy == DatabaseOverflowPolicy_t::EvictOldest ? std::time(nullptr)
+                                                                           : 0};
+
+  size_t miss_count{0};
+
+  // Warm up hash map slots for the first window.
+  for (size_t j{0}; j < std::min(fetch_window_size, batch_size); ++j) {
+    part.entries.prefetch(keys[indexer(j)]);
+  }
+
+  std::array<ValuePtr, fetch_window_size> window;
+  for (size_t window_begin{0}; window_begin < batch_size; window_begin += fetch_window_size) {
+    const size_t window_end{std::min(window_begin + fetch_window_size, batch_size)};
+
+    // Prefetch hash map slots for the next window.
+    const size_t next_window_end{std::min(window_end + fetch_window_size, batch_size)};
+    for (size_t j{window_end}; j < next_window_end; ++j) {
+      part.entries.prefetch(keys[indexer(j)]);
+    }
+
+    // Probe the hash map, and prefetch the values of all hits.
+    for (size_t j{window_begin}; j < window_end; ++j) {
+      const auto& it{part.entries.find(keys[indexer(j)])};
+      ValuePtr& value{window[j - window_begin]};
+      if (it != part.entries.end()) {
+        Payload& payload{it->second};
+
+        // Race-conditions here are deliberately ignored because insignificant in practice.
+        switch (overflow_policy) {
+          case DatabaseOverflowPolicy_t::EvictRandom:
+            break;
+          case DatabaseOverflowPolicy_t::EvictLeastUsed:
+            ++payload.access_count;
+            break;
+          case DatabaseOverflowPolicy_t::EvictOldest:
+            payload.last_access = now;
+            break;
+          case DatabaseOverflowPolicy_t::EvictClock:
+            // Only write if not yet set, to avoid dirtying the cache line for hot keys.
+            if (!payload.referenced) {
+              payload.referenced = 1;
+            }
+            break;
+        }
+
+        value = payload.value;
+        __builtin_prefetch(value);
+      } else {
+        value = nullptr;
+      }
+    }
+
+    // Copy values, or decode them if the table is compressed. Source pages are aligned to
+    // `value_page_alignment`, which allows `copy_n` to use aligned vector loads.
+    for (size_t j{window_begin}; j < window_end; ++j) {
+      const size_t index{indexer(j)};
+      const ValuePtr value{window[j - window_begin]};
+      if (value) {
+        part.decode_value(value, &values[index * value_stride]);
+      } else {
+        on_miss(index);
+        ++miss_count;
+      }
+    }
+  }
+
+  return miss_count;
+}
+
+template <typename Key>
+typename HashMapBackend<Key>::PartitionList& HashMapBackend<Key>::get_or_create_table_(
+    const std::string& table_name, const uint32_t value_size,
+    std::shared_lock<std::shared_mutex>& lock) {
+  HCTR_CHECK(lock.owns_lock());
+
+  while (true) {
+    const auto& tables_it{tables_.find(table_name)};
+    if (tables_it != tables_.end()) {
+      return tables_it->second;
+    }
+
+    const DatabaseValueFormat_t value_format{table_value_format(this->params_, table_name)};
+    HCTR_THROW_IF(!is_value_format_applicable(value_format, value_size), Error_t::WrongInput,
+                  "Table ", table_name, " has ", value_size,
+                  " byte values, which cannot be stored as ", value_format, ".");
+
+    // Table does not exist yet. Upgrade to exclusive access and create partitions.
+    lock.unlock();
+    {
+      const std::unique_lock excl_lock(read_write_guard_);
+
+      PartitionList& parts{tables_.try_emplace(table_name).first->second};
+      if (parts.empty()) {
+        HCTR_CHECK(value_size > 0 && value_size <= this->params_.allocation_rate);
+
+        while (parts.size() < this->params_.num_partitions) {
+          parts.emplace_back(value_size, value_format, this->params_);
+        }
+      }
+    }
+    lock.lock();
+
+    // A concurrent `evict` could have removed the table again in the meantime. Hence, we retry.
+  }
+}
+
 template <typename Key>
 size_t HashMapBackend<Key>::resolve_overflow_(const std::string& table_name,
                                               const size_t part_index, Partition& part) {
@@ -682,11 +1089,155 @@ size_t HashMapBackend<Key>::resolve_overflow_(const std::string& table_name,
         }
       }
     } break;
+
+    case DatabaseOverflowPolicy_t::EvictClock: {
+      // Sweep over the partition like a clock hand. Referenced entries get a second chance (i.e.,
+      // we clear their reference bit), while unreferenced entries are evicted. There is no need to
+      // sort, and each entry is visited at most twice. Hence, eviction is O(1) amortized.
+      std::vector<Key> keys;
+      keys.reserve(std::min(part.entries.size(), max_batch_size));
+
+      while (part.entries.size() > this->overflow_resolution_margin_) {
+        const size_t batch_size{std::min<size_t>(
+            part.entries.size() - this->overflow_resolution_margin_, max_batch_size)};
+
+        HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                   " is overflowing (size = ", part.entries.size(), " > ",
+                   this->params_.overflow_margin, "): Attempting to evict ", batch_size,
+                   " UNREFERENCED key/value pairs!\n");
+
+        // Advance clock hand.
+        keys.clear();
+        for (auto& entry : part.entries) {
+          Payload& payload{entry.second};
+          if (payload.referenced) {
+            payload.referenced = 0;
+          } else {
+            keys.emplace_back(entry.first);
+            if (keys.size() >= batch_size) {
+              break;
+            }
+          }
+        }
+
+        // Call erase for all victims.
+        for (const Key& key : keys) {
+          const Key* const k{&key};
+          HCTR_HPS_HASH_MAP_EVICT_K_();
+        }
+      }
+    } break;
+  }
+
+  // Return memory, if the partition became too sparse.
+  const size_t num_slots{part.num_slots()};
+  if (num_slots && static_cast<double>(part.value_slots.size()) >
+                       static_cast<double>(num_slots) * part.compaction_threshold) {
+    const size_t num_released_pages{compact_(part)};
+    if (num_released_pages) {
+      HCTR_LOG_C(DEBUG, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                 ": Compaction released ", num_released_pages, " / ",
+                 num_released_pages + part.value_pages.size(), " value pages.\n");
+    }
   }
 
   return num_deletions;
 }
 
+template <typename Key>
+size_t HashMapBackend<Key>::compact_(Partition& part) {
+  const size_t stride{part.value_stride()};
+  const size_t values_per_page{part.allocation_rate / stride};
+  const size_t num_pages{part.value_pages.size()};
+  const size_t num_required_pages{(part.entries.size() + values_per_page - 1) / values_per_page};
+  if (num_required_pages >= num_pages) {
+    return 0;
+  }
+
+  // Sort pages by address, to allow mapping value pointers back to their page.
+  std::vector<size_t> page_order(num_pages);
+  std::iota(page_order.begin(), page_order.end(), 0);
+  std::sort(page_order.begin(), page_order.end(), [&](const size_t a, const size_t b) {
+    return part.value_pages[a].data() < part.value_pages[b].data();
+  });
+  const auto& page_of{[&](const ValuePtr value) {
+    const auto& it{std::upper_bound(
+        page_order.begin(), page_order.end(), value,
+        [&](const ValuePtr v, const size_t p) { return v < part.value_pages[p].data(); })};
+    HCTR_CHECK(it != page_order.begin());
+    return *std::prev(it);
+  }};
+
+  // Count live values in each page.
+  std::vector<size_t> num_live_values(num_pages);
+  for (const Entry& entry : part.entries) {
+    ++num_live_values[page_of(entry.second.value)];
+  }
+
+  // Keep the fullest pages. All other pages are evacuated.
+  std::vector<size_t> pages_by_load(num_pages);
+  std::iota(pages_by_load.begin(), pages_by_load.end(), 0);
+  std::sort(pages_by_load.begin(), pages_by_load.end(),
+            [&](const size_t a, const size_t b) { return num_live_values[a] > num_live_values[b]; });
+  std::vector<bool> keep_page(num_pages);
+  for (size_t i{0}; i < num_required_pages; ++i) {
+    keep_page[pages_by_load[i]] = true;
+  }
+
+  // Determine occupied slots in the pages that we keep.
+  std::vector<std::vector<bool>> occupied(num_pages);
+  for (size_t p{0}; p < num_pages; ++p) {
+    if (keep_page[p]) {
+      occupied[p].resize(values_per_page);
+    }
+  }
+  for (const Entry& entry : part.entries) {
+    const size_t p{page_of(entry.second.value)};
+    if (keep_page[p]) {
+      occupied[p][static_cast<size_t>(entry.second.value - part.value_pages[p].data()) / stride] =
+          true;
+    }
+  }
+
+  // Rebuild free list from pages that we keep.
+  part.value_slots.clear();
+  for (size_t p{0}; p < num_pages; ++p) {
+    if (keep_page[p]) {
+      for (size_t slot{values_per_page}; slot--;) {
+        if (!occupied[p][slot]) {
+          part.value_slots.emplace_back(&part.value_pages[p][slot * stride]);
+        }
+      }
+    }
+  }
+
+  // Relocate values from evacuated pages.
+  for (auto& entry : part.entries) {
+    Payload& payload{entry.second};
+    if (!keep_page[page_of(payload.value)]) {
+      HCTR_CHECK(!part.value_slots.empty());
+      const ValuePtr value{part.value_slots.back()};
+      part.value_slots.pop_back();
+
+      std::copy_n(payload.value, part.encoded_value_size, value);
+      payload.value = value;
+    }
+  }
+
+  // Release evacuated pages.
+  std::vector<ValuePage> value_pages;
+  value_pages.reserve(num_required_pages);
+  for (size_t p{0}; p < num_pages; ++p) {
+    if (keep_page[p]) {
+      value_pages.emplace_back(std::move(part.value_pages[p]));
+    }
+  }
+  part.value_pages = std::move(value_pages);
+  malloc_trim(0);
+
+  return num_pages - num_required_pages;
+}
+
 template class HashMapBackend<unsigned int>;
 template class HashMapBackend<long long>;
 
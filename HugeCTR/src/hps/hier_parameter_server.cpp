@@ -15,16 +15,25 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <filesystem>
+#include <hps/cache_key_log.hpp>
+#include <hps/distributed_hash_map_backend.hpp>
+#include <hps/embedding_cache.hpp>
 #include <hps/hash_map_backend.hpp>
 #include <hps/hier_parameter_server.hpp>
 #include <hps/kafka_message.hpp>
 #include <hps/modelloader.hpp>
 #include <hps/mp_hash_map_backend.hpp>
+#include <hps/prehashed_table.hpp>
 #include <hps/redis_backend.hpp>
 #include <hps/rocksdb_backend.hpp>
+#include <hps/uvm_table.hpp>
+#include <numeric>
+#include <optional>
 #include <regex>
+#include <string_view>
 
 namespace HugeCTR {
 
@@ -104,6 +113,18 @@ HierParameterServer<TypeHashKey>::HierParameterServer(const parameter_server_con
   // Connect to volatile database.
   {
     const auto& conf = inference_params_array[0].volatile_db;
+
+    // Value formats are configured per embedding table name, and apply to that table of all models.
+    std::unordered_map<std::string, DatabaseValueFormat_t> table_value_formats;
+    for (const auto& [model_name, table_names] : ps_config_.emb_table_name_) {
+      for (const std::string& table_name : table_names) {
+        const auto& it{conf.table_value_formats.find(table_name)};
+        if (it != conf.table_value_formats.end()) {
+          table_value_formats.emplace(make_tag_name(model_name, table_name), it->second);
+        }
+      }
+    }
+
     switch (conf.type) {
       case DatabaseType_t::Disabled:
         break;  // No volatile database.
@@ -119,6 +140,10 @@ HierParameterServer<TypeHashKey>::HierParameterServer(const parameter_server_con
             conf.overflow_resolution_target,
             conf.allocation_rate,
         };
+        params.value_page_size = conf.value_page_size;
+        params.numa_node = conf.numa_node;
+        params.value_format = conf.value_format;
+        params.table_value_formats = table_value_formats;
         volatile_db_ = std::make_unique<HashMapBackend<TypeHashKey>>(params);
       } break;
 
@@ -136,10 +161,39 @@ HierParameterServer<TypeHashKey>::HierParameterServer(const parameter_server_con
             conf.shared_memory_name,
             std::chrono::milliseconds{100},  // heart_beat_frequency
             conf.shared_memory_auto_remove,
+            conf.shared_memory_numa_aware,
         };
+        params.value_format = conf.value_format;
+        params.table_value_formats = table_value_formats;
         volatile_db_ = std::make_unique<MultiProcessHashMapBackend<TypeHashKey>>(params);
       } break;
 
+#ifdef HCTR_USE_RDMA
+      case DatabaseType_t::DistributedHashMap: {
+        HCTR_LOG_S(INFO, WORLD) << "Creating Distributed HashMap CPU database backend..."
+                                << std::endl;
+        DistributedHashMapBackendParams params;
+        params.max_batch_size = conf.max_batch_size;
+        params.num_partitions = conf.num_partitions;
+        params.overflow_margin = conf.overflow_margin;
+        params.overflow_policy = conf.overflow_policy;
+        params.overflow_resolution_target = conf.overflow_resolution_target;
+        params.allocation_rate = conf.allocation_rate;
+        params.value_page_size = conf.value_page_size;
+        params.numa_node = conf.numa_node;
+        std::stringstream hosts(conf.address);
+        for (std::string host; std::getline(hosts, host, ',');) {
+          params.hosts.emplace_back(host);
+        }
+        params.rank = conf.host_rank;
+        params.ib_device = conf.ib_device;
+        params.ib_port = static_cast<uint8_t>(conf.ib_port);
+        params.message_size = conf.message_size;
+        params.connect_timeout = conf.connect_timeout;
+        volatile_db_ = std::make_unique<DistributedHashMapBackend<TypeHashKey>>(params);
+      } break;
+#endif  // HCTR_USE_RDMA
+
 #ifdef HCTR_USE_REDIS
       case DatabaseType_t::RedisCluster: {
         HCTR_LOG_S(INFO, WORLD) << "Creating RedisCluster backend..." << std::endl;
@@ -153,6 +207,7 @@ HierParameterServer<TypeHashKey>::HierParameterServer(const parameter_server_con
             conf.user_name,
             conf.password,
             conf.num_node_connections,
+            conf.max_pipeline_depth,
             conf.enable_tls,
             conf.tls_ca_certificate,
             conf.tls_client_certificate,
@@ -167,6 +222,21 @@ HierParameterServer<TypeHashKey>::HierParameterServer(const parameter_server_con
         HCTR_DIE("Selected backend (volatile_db.type = %d) is not supported!", conf.type);
         break;
     }
+    // Hot keys of a shared database are kept in a near cache, to save the network round trips.
+    if (volatile_db_ && volatile_db_->is_shared() && conf.near_cache_capacity) {
+      HashMapBackendParams params;
+      params.max_batch_size = conf.max_batch_size;
+      params.num_partitions = conf.num_partitions;
+      params.overflow_margin = std::max<size_t>(conf.near_cache_capacity / conf.num_partitions, 1);
+      params.overflow_policy = conf.overflow_policy;
+      params.overflow_resolution_target = conf.overflow_resolution_target;
+      auto near_cache{std::make_unique<NearCacheBackend<TypeHashKey>>(
+          std::move(volatile_db_), params, std::chrono::milliseconds{conf.near_cache_ttl_ms})};
+      near_cache_ = near_cache.get();
+      volatile_db_ = std::move(near_cache);
+      HCTR_LOG_S(INFO, WORLD) << "Volatile DB: near cache capacity = " << conf.near_cache_capacity
+                              << ", TTL = " << conf.near_cache_ttl_ms << " ms" << std::endl;
+    }
     volatile_db_initialize_after_startup_ = conf.initialize_after_startup;
     volatile_db_cache_rate_ = conf.initial_cache_rate;
     volatile_db_cache_missed_embeddings_ = conf.cache_missed_embeddings;
@@ -191,6 +261,9 @@ HierParameterServer<TypeHashKey>::HierParameterServer(const parameter_server_con
             conf.path,
             conf.num_threads,
             conf.read_only,
+            conf.block_cache_size,
+            conf.bloom_filter_bits,
+            conf.use_direct_reads,
         };
         persistent_db_ = std::make_unique<RocksDBBackend<TypeHashKey>>(params);
       } break;
@@ -201,6 +274,7 @@ HierParameterServer<TypeHashKey>::HierParameterServer(const parameter_server_con
         break;
     }
     persistent_db_initialize_after_startup_ = conf.initialize_after_startup;
+    persistent_db_bulk_load_ = conf.bulk_load;
   }
 
   // initialize the profiler
@@ -220,20 +294,69 @@ HierParameterServer<TypeHashKey>::HierParameterServer(const parameter_server_con
 
   // Insert embeddings to embedding cache for each embedding table of each mode
   for (size_t i = 0; i < inference_params_array.size(); i++) {
+    if (inference_params_array[i].deployed_devices.empty()) {
+      continue;
+    }
+    // The readers of a shared embedding cache find it initialized by its owner.
     if ((inference_params_array[i].use_gpu_embedding_cache &&
          inference_params_array[i].cache_refresh_percentage_per_iteration > 0 &&
-         inference_params_array[i].init_ec) ||
+         inference_params_array[i].init_ec &&
+         inference_params_array[i].shared_cache_role != SharedCacheRole_t::Reader) ||
         inference_params_array[i].embedding_cache_type != HugeCTR::EmbeddingCacheType_t::Dynamic) {
       HCTR_LOG_S(INFO, ROOT) << "Initialize the embedding cache by by inserting the same size "
                                 "model file with embedding cache from beginning"
                              << std::endl;
       init_ec(inference_params_array[i], model_cache_map_[inference_params_array[i].model_name]);
     }
+    if (!inference_params_array[i].key_log_warmup_file.empty()) {
+      warm_up_embedding_caches_from_key_log(inference_params_array[i]);
+    }
+  }
+
+  for (const InferenceParams& inference_params : inference_params_array) {
+    if (inference_params.refresh_updated_keys_only) {
+      // Refreshing a subset of the keys would leave the rest of a static table behind.
+      HCTR_THROW_IF(inference_params.embedding_cache_type != EmbeddingCacheType_t::Dynamic ||
+                        inference_params.update_source.type == UpdateSourceType_t::Null,
+                    Error_t::WrongInput, "Model ", inference_params.model_name,
+                    ": refresh_updated_keys_only requires the dynamic embedding cache and an "
+                    "update source.");
+      auto& device_keys = updated_keys_[inference_params.model_name];
+      for (const int device_id : inference_params.deployed_devices) {
+        device_keys[device_id].resize(
+            ps_config_.emb_table_name_[inference_params.model_name].size());
+      }
+    }
+  }
+
+  for (const InferenceParams& inference_params : inference_params_array) {
+    if (!inference_params.key_log_record_file.empty() && !inference_params.background_refresh) {
+      HCTR_LOG_S(WARNING, ROOT) << "Model " << inference_params.model_name
+                                << ": key_log_record_file is only written by the background "
+                                   "refresh, which is disabled."
+                                << std::endl;
+    }
+    if (inference_params.background_refresh) {
+      HCTR_THROW_IF(inference_params.refresh_interval <= 0, Error_t::WrongInput, "Model ",
+                    inference_params.model_name,
+                    ": background_refresh requires a positive refresh_interval.");
+      background_refreshers_.emplace_back(&HierParameterServer::run_background_refresh, this,
+                                          inference_params);
+    }
   }
 }
 
 template <typename TypeHashKey>
 HierParameterServer<TypeHashKey>::~HierParameterServer() {
+  {
+    const std::lock_guard<std::mutex> lock(background_refreshers_mutex_);
+    stop_background_refreshers_ = true;
+  }
+  background_refreshers_cv_.notify_all();
+  for (std::thread& refresher : background_refreshers_) {
+    refresher.join();
+  }
+
   // Await all pending volatile database transactions.
   volatile_db_async_inserter_.await_idle();
 
@@ -246,6 +369,19 @@ HierParameterServer<TypeHashKey>::~HierParameterServer() {
   buffer_pool_->DestoryManagerPool();
 }
 
+namespace {
+
+// Content hash of a chunk of a model file
+size_t hash_chunk(const void* const keys, const size_t keys_size, const void* const vectors,
+                  const size_t vectors_size) {
+  const std::hash<std::string_view> hasher;
+  const size_t keys_hash = hasher({static_cast<const char*>(keys), keys_size});
+  const size_t vectors_hash = hasher({static_cast<const char*>(vectors), vectors_size});
+  return keys_hash ^ (vectors_hash + 0x9e3779b97f4a7c15 + (keys_hash << 6) + (keys_hash >> 2));
+}
+
+}  // namespace
+
 template <typename TypeHashKey>
 void HierParameterServer<TypeHashKey>::update_database_per_model(
     const InferenceParams& inference_params) {
@@ -262,60 +398,151 @@ void HierParameterServer<TypeHashKey>::update_database_per_model(
                          inference_params.model_name +
                          " doesn't match the number of model files in configuration.");
     }
-    // Get raw format model loader
+    const std::string tag_name = make_tag_name(
+        inference_params.model_name, ps_config_.emb_table_name_[inference_params.model_name][j]);
+    const size_t embedding_size = ps_config_.embedding_vec_size_[inference_params.model_name][j];
+    const size_t value_size = embedding_size * sizeof(float);
+    const bool init_volatile_db = volatile_db_ && volatile_db_initialize_after_startup_ &&
+                                  inference_params.embedding_cache_type ==
+                                      HugeCTR::EmbeddingCacheType_t::Dynamic;
+    // Persistent database - by definition - always gets all keys.
+    const bool init_persistent_db = persistent_db_ && persistent_db_initialize_after_startup_ &&
+                                    inference_params.embedding_cache_type ==
+                                        HugeCTR::EmbeddingCacheType_t::Dynamic;
+    if (init_volatile_db) {
+      volatile_db_async_inserter_.await_idle();
+    }
+
+    // A local hash map can attach the pre-hashed image of the model, instead of hashing every key,
+    // see `PrehashedTable`.
+    bool insert_volatile_db = init_volatile_db;
+    if (init_volatile_db && !inference_params.fuse_embedding_table) {
+      auto* const hash_map = dynamic_cast<HashMapBackend<TypeHashKey>*>(volatile_db_.get());
+      const std::string path =
+          PrehashedTable<TypeHashKey>::default_path(inference_params.sparse_model_files[j]);
+      if (hash_map && std::filesystem::exists(path)) {
+        try {
+          hash_map->attach_prehashed_table(tag_name, path, value_size);
+          insert_volatile_db = false;
+        } catch (const std::exception& error) {
+          HCTR_LOG_C(WARNING, WORLD, "Ignoring the pre-hashed table '", path, "': ", error.what(),
+                     '\n');
+        }
+      }
+    }
+
+    // The chunks that a previous version of the model had loaded unchanged are already in the
+    // databases. The volatile database may have evicted some of them, unless it holds them all.
+    LoadedTable previous_table;
+    {
+      const std::lock_guard<std::mutex> lock(loaded_tables_mutex_);
+      const auto it = loaded_tables_.find(tag_name);
+      if (it != loaded_tables_.end()) {
+        previous_table = std::move(it->second);
+        loaded_tables_.erase(it);
+      }
+    }
+    const bool share_volatile_db_chunks =
+        insert_volatile_db && volatile_db_->size(tag_name) >= previous_table.num_keys;
+    LoadedTable loaded_table;
+    size_t num_shared_keys = 0;
+
+    const std::vector<std::string> model_files =
+        inference_params.fuse_embedding_table
+            ? inference_params.fused_sparse_model_files[j]
+            : std::vector<std::string>{inference_params.sparse_model_files[j]};
+
+    // A RocksDB can ingest the whole table as SST files instead, see `RocksDBBulkLoader`.
+    std::function<void(const void*, const void*, size_t)> persistent_insert =
+        [&](const void* keys, const void* vectors, const size_t num_keys) {
+          persistent_db_->insert(tag_name, num_keys, reinterpret_cast<const TypeHashKey*>(keys),
+                                 reinterpret_cast<const char*>(vectors), value_size, value_size);
+        };
+#ifdef HCTR_USE_ROCKS_DB
+    std::unique_ptr<RocksDBBulkLoader<TypeHashKey>> bulk_loader;
+    auto* const rocks_db = init_persistent_db && persistent_db_bulk_load_
+                               ? dynamic_cast<RocksDBBackend<TypeHashKey>*>(persistent_db_.get())
+                               : nullptr;
+    if (rocks_db) {
+      persistent_insert = [&](const void* keys, const void* vectors, const size_t num_keys) {
+        if (!bulk_loader) {
+          bulk_loader = std::make_unique<RocksDBBulkLoader<TypeHashKey>>(
+              *rocks_db, tag_name, rawreader->getkeycount() * model_files.size(), value_size);
+        }
+        bulk_loader->add(num_keys, reinterpret_cast<const TypeHashKey*>(keys),
+                         reinterpret_cast<const char*>(vectors), value_size);
+      };
+    }
+#endif  // HCTR_USE_ROCKS_DB
+
+    // Stream the table chunk by chunk: every chunk goes into both databases at once, while the
+    // model loader reads the next one.
+    auto insert_chunk = [&](const void* keys, const void* vectors, const size_t num_keys) {
+      const size_t chunk_hash = hash_chunk(keys, num_keys * sizeof(TypeHashKey), vectors,
+                                           num_keys * value_size);
+      const size_t chunk_index = loaded_table.chunk_hashes.size();
+      loaded_table.chunk_hashes.emplace_back(chunk_hash);
+      loaded_table.num_keys += num_keys;
+      const bool unchanged = chunk_index < previous_table.chunk_hashes.size() &&
+                             previous_table.chunk_hashes[chunk_index] == chunk_hash;
+      if (unchanged && (!insert_volatile_db || share_volatile_db_chunks)) {
+        num_shared_keys += num_keys;
+        return;
+      }
+
+      std::future<void> volatile_insert;
+      if (insert_volatile_db && !(unchanged && share_volatile_db_chunks)) {
+        volatile_insert = ThreadPool::get().submit([&]() {
+          volatile_db_->insert(tag_name, num_keys, reinterpret_cast<const TypeHashKey*>(keys),
+                               reinterpret_cast<const char*>(vectors), value_size, value_size);
+        });
+      }
+      try {
+        if (init_persistent_db && !unchanged) {
+          persistent_insert(keys, vectors, num_keys);
+        }
+      } catch (...) {
+        if (volatile_insert.valid()) {
+          volatile_insert.wait();
+        }
+        throw;
+      }
+      if (volatile_insert.valid()) {
+        volatile_insert.get();
+      }
+    };
+
     size_t num_key = 0;
-    if (inference_params.fuse_embedding_table) {
-      for (int table_id = 0; table_id < inference_params.fused_sparse_model_files[j].size();
-           table_id++) {
-        rawreader->load(inference_params.embedding_table_names[j],
-                        inference_params.fused_sparse_model_files[j][table_id]);
-        num_key += rawreader->getkeycount();
+    for (const std::string& model_file : model_files) {
+      rawreader->load(inference_params.embedding_table_names[j], model_file);
+      num_key += rawreader->getkeycount();
+      if (insert_volatile_db || init_persistent_db) {
+        rawreader->for_each_chunk(embedding_size, insert_chunk);
       }
-    } else {
-      rawreader->load(inference_params.embedding_table_names[j],
-                      inference_params.sparse_model_files[j]);
-      num_key = rawreader->getkeycount();
     }
+#ifdef HCTR_USE_ROCKS_DB
+    if (bulk_loader) {
+      bulk_loader->finish();
+    }
+#endif  // HCTR_USE_ROCKS_DB
     ps_config_.embedding_key_count_.at(inference_params.model_name).emplace_back(num_key);
-    const std::string tag_name = make_tag_name(
-        inference_params.model_name, ps_config_.emb_table_name_[inference_params.model_name][j]);
-    const size_t embedding_size = ps_config_.embedding_vec_size_[inference_params.model_name][j];
-    // Populate volatile database(s).
-    if (volatile_db_ && volatile_db_initialize_after_startup_ &&
-        inference_params.embedding_cache_type == HugeCTR::EmbeddingCacheType_t::Dynamic) {
+    if (insert_volatile_db || init_persistent_db) {
+      if (num_shared_keys) {
+        HCTR_LOG_S(INFO, WORLD) << "Table: " << tag_name << "; shared " << num_shared_keys << " / "
+                                << num_key << " unchanged embeddings with the previous version."
+                                << std::endl;
+      }
+      const std::lock_guard<std::mutex> lock(loaded_tables_mutex_);
+      loaded_tables_[tag_name] = std::move(loaded_table);
+    }
+
+    if (init_volatile_db) {
       const size_t volatile_capacity = volatile_db_->capacity(tag_name);
       const size_t volatile_cache_amount =
           (num_key <= volatile_capacity)
               ? num_key
               : static_cast<size_t>(
                     volatile_db_cache_rate_ * static_cast<double>(volatile_capacity) + 0.5);
-
-      volatile_db_async_inserter_.await_idle();
-      if (!inference_params.fuse_embedding_table) {
-        for (size_t i = 0; i < rawreader->get_num_iterations(); i++) {
-          std::pair<void*, size_t> key_result = rawreader->getkeys(i);
-          std::pair<void*, size_t> vec_result = rawreader->getvectors(i, embedding_size);
-          volatile_db_->insert(tag_name, key_result.second,
-                               reinterpret_cast<const TypeHashKey*>(key_result.first),
-                               reinterpret_cast<const char*>(vec_result.first),
-                               embedding_size * sizeof(float), embedding_size * sizeof(float));
-        }
-      } else {
-        for (int table_id = 0; table_id < inference_params.fused_sparse_model_files[j].size();
-             table_id++) {
-          rawreader->load(inference_params.embedding_table_names[j],
-                          inference_params.fused_sparse_model_files[j][table_id]);
-          for (size_t i = 0; i < rawreader->get_num_iterations(); i++) {
-            std::pair<void*, size_t> key_result = rawreader->getkeys(i);
-            std::pair<void*, size_t> vec_result = rawreader->getvectors(i, embedding_size);
-            volatile_db_->insert(tag_name, key_result.second,
-                                 reinterpret_cast<const TypeHashKey*>(key_result.first),
-                                 reinterpret_cast<const char*>(vec_result.first),
-                                 embedding_size * sizeof(float), embedding_size * sizeof(float));
-          }
-        }
-      }
-
       HCTR_LOG_S(INFO, WORLD) << "Table: " << tag_name << "; cached " << volatile_cache_amount
                               << " / " << num_key << " embeddings in volatile database ("
                               << volatile_db_->get_name()
@@ -325,41 +552,17 @@ void HierParameterServer<TypeHashKey>::update_database_per_model(
                                   static_cast<double>(volatile_capacity))
                               << "%)." << std::endl;
     }
-
-    // Persistent database - by definition - always gets all keys.
-    if (persistent_db_ && persistent_db_initialize_after_startup_ &&
-        inference_params.embedding_cache_type == HugeCTR::EmbeddingCacheType_t::Dynamic) {
-      if (!inference_params.fuse_embedding_table) {
-        for (size_t i = 0; i < rawreader->get_num_iterations(); i++) {
-          std::pair<void*, size_t> key_result = rawreader->getkeys(i);
-          std::pair<void*, size_t> vec_result = rawreader->getvectors(i, embedding_size);
-          persistent_db_->insert(tag_name, key_result.second,
-                                 reinterpret_cast<const TypeHashKey*>(key_result.first),
-                                 reinterpret_cast<const char*>(vec_result.first),
-                                 embedding_size * sizeof(float), embedding_size * sizeof(float));
-        }
-      } else {
-        for (int table_id = 0; table_id < inference_params.fused_sparse_model_files[j].size();
-             table_id++) {
-          rawreader->load(inference_params.embedding_table_names[j],
-                          inference_params.fused_sparse_model_files[j][table_id]);
-          for (size_t i = 0; i < rawreader->get_num_iterations(); i++) {
-            std::pair<void*, size_t> key_result = rawreader->getkeys(i);
-            std::pair<void*, size_t> vec_result = rawreader->getvectors(i, embedding_size);
-            persistent_db_->insert(tag_name, key_result.second,
-                                   reinterpret_cast<const TypeHashKey*>(key_result.first),
-                                   reinterpret_cast<const char*>(vec_result.first),
-                                   embedding_size * sizeof(float), embedding_size * sizeof(float));
-          }
-        }
-        HCTR_LOG_S(INFO, WORLD) << "Table: " << tag_name << "; cached " << num_key
-                                << " embeddings in persistent database ("
-                                << persistent_db_->get_name() << ")." << std::endl;
-      }
+    if (init_persistent_db) {
+      HCTR_LOG_S(INFO, WORLD) << "Table: " << tag_name << "; cached " << num_key
+                              << " embeddings in persistent database ("
+                              << persistent_db_->get_name() << ")." << std::endl;
     }
   }
   rawreader->delete_table();
 
+  // Embedding caches that already exist for this model must learn about the new keys.
+  refresh_bloom_filters_per_model(inference_params);
+
   // Connect to online update service (if configured).
   // TODO: Maybe need to change the location where this is initialized.
   const char kafka_group_prefix[] = "hps.";
@@ -399,6 +602,21 @@ void HierParameterServer<TypeHashKey>::update_database_per_model(
             inference_params.update_source.max_batch_size,
             inference_params.update_source.failure_backoff_ms,
             inference_params.update_source.max_commit_interval);
+
+        // An update is applied to the shared database by one process of the group above. Every
+        // process must drop the updated keys from its near cache, and has a group of its own.
+        if (near_cache_) {
+          std::ostringstream near_cache_group;
+          near_cache_group << kafka_group_prefix << "near_cache." << host_name << '.' << getpid();
+          near_cache_source_ = std::make_unique<KafkaMessageSource<TypeHashKey>>(
+              inference_params.update_source.brokers, near_cache_group.str(), tag_filters,
+              inference_params.update_source.metadata_refresh_interval_ms,
+              inference_params.update_source.receive_buffer_size,
+              inference_params.update_source.poll_timeout_ms,
+              inference_params.update_source.max_batch_size,
+              inference_params.update_source.failure_backoff_ms,
+              inference_params.update_source.max_commit_interval);
+        }
       }
       // Persistent database updates.
       if (persistent_db_ && !inference_params.persistent_db.update_filters.empty()) {
@@ -431,26 +649,56 @@ void HierParameterServer<TypeHashKey>::update_database_per_model(
 
   HCTR_LOG(DEBUG, WORLD, "Real-time subscribers created!\n");
 
-  // TODO: Update embedding cache!
+  // Both sources receive the same updates, so only one of them writes to the embedding caches and
+  // records the updated keys.
+  const bool volatile_db_tracks_cache = static_cast<bool>(volatile_db_source_);
+  const bool volatile_db_updates_cache =
+      inference_params.update_source.update_embedding_cache && volatile_db_tracks_cache;
+  const bool persistent_db_updates_cache =
+      inference_params.update_source.update_embedding_cache && !volatile_db_tracks_cache;
 
   // Turn on background updates.
   if (volatile_db_source_) {
-    volatile_db_source_->engage([&](const std::string& tag, const size_t num_pairs,
+    volatile_db_source_->engage([&, volatile_db_updates_cache](
+                                    const std::string& tag, const size_t num_pairs,
                                     const TypeHashKey* keys, const char* values,
                                     const size_t value_size) {
       HCTR_LOG_C(TRACE, WORLD, "Volatile DB update for tag: '", tag, "', num_pairs: ", num_pairs,
                  ", value_size: ", value_size, " bytes\n");
       volatile_db_->insert(tag, num_pairs, keys, values, value_size, value_size);
+      update_bloom_filters(tag, num_pairs, keys);
+      if (volatile_db_updates_cache) {
+        update_embedding_caches(tag, num_pairs, keys, values, value_size);
+      }
+      record_updated_keys(tag, num_pairs, keys);
+    });
+  }
+
+  if (near_cache_source_) {
+    near_cache_source_->engage([&](const std::string& tag, const size_t num_pairs,
+                                   const TypeHashKey* keys, const char* values,
+                                   const size_t value_size) {
+      HCTR_LOG_C(TRACE, WORLD, "Near cache invalidation for tag: '", tag,
+                 "', num_pairs: ", num_pairs, '\n');
+      near_cache_->invalidate(tag, num_pairs, keys);
     });
   }
 
   if (persistent_db_source_) {
-    persistent_db_source_->engage([&](const std::string& tag, const size_t num_pairs,
+    persistent_db_source_->engage([&, volatile_db_tracks_cache, persistent_db_updates_cache](
+                                      const std::string& tag, const size_t num_pairs,
                                       const TypeHashKey* keys, const char* values,
                                       const size_t value_size) {
       HCTR_LOG_C(TRACE, WORLD, "Persistent DB update for tag: '", tag, "', num_pairs: ", num_pairs,
                  ", value_size: ", value_size, " bytes\n");
       persistent_db_->insert(tag, num_pairs, keys, values, value_size, value_size);
+      update_bloom_filters(tag, num_pairs, keys);
+      if (persistent_db_updates_cache) {
+        update_embedding_caches(tag, num_pairs, keys, values, value_size);
+      }
+      if (!volatile_db_tracks_cache) {
+        record_updated_keys(tag, num_pairs, keys);
+      }
     });
   }
 }
@@ -468,6 +716,23 @@ void HierParameterServer<TypeHashKey>::init_ec(
   for (size_t j = 0; j < num_tables; j++) {
     const std::string tag_name = make_tag_name(
         inference_params.model_name, ps_config_.emb_table_name_[inference_params.model_name][j]);
+
+    // A static table can copy the pre-hashed image of its model as is, see `PrehashedTable`.
+    std::unique_ptr<PrehashedTable<TypeHashKey>> prehashed_table;
+    if (inference_params.embedding_cache_type == EmbeddingCacheType_t::Static &&
+        !inference_params.fuse_embedding_table && !inference_params.fp8_quant) {
+      const std::string path =
+          PrehashedTable<TypeHashKey>::default_path(inference_params.sparse_model_files[j]);
+      if (std::filesystem::exists(path)) {
+        try {
+          prehashed_table = std::make_unique<PrehashedTable<TypeHashKey>>(path);
+        } catch (const std::exception& error) {
+          HCTR_LOG_C(WARNING, WORLD, "Ignoring the pre-hashed table '", path, "': ", error.what(),
+                     '\n');
+        }
+      }
+    }
+
     for (auto device_id : inference_params.deployed_devices) {
       CudaDeviceContext dev_restorer{device_id};
       HCTR_LOG_S(INFO, ROOT) << "EC initialization on device " << device_id << " for " << tag_name
@@ -488,11 +753,15 @@ void HierParameterServer<TypeHashKey>::init_ec(
         const size_t stride_set =
             std::max(1.0f, floor(cache_config.num_set_in_cache_[j] *
                                  cache_config.cache_refresh_percentage_per_iteration));
-        size_t length = SLAB_SIZE * SET_ASSOCIATIVITY * stride_set;
+        size_t length = SLAB_SIZE * cache_config.set_associativity_[j] * stride_set;
         refreshspace_handler.h_length_ = &length;
         size_t num_iteration = 0;
         std::pair<void*, size_t> key_result;
         std::pair<void*, size_t> vec_result;
+        if (!inference_params.fuse_embedding_table) {
+          rawreader->load(inference_params.embedding_table_names[j],
+                          inference_params.sparse_model_files[j], length);
+        }
         for (size_t idx_set = 0; idx_set + stride_set < cache_config.num_set_in_cache_[j];
              idx_set += stride_set) {
           if (inference_params.fuse_embedding_table) {
@@ -504,8 +773,6 @@ void HierParameterServer<TypeHashKey>::init_ec(
             key_result = rawreader->getkeys(iter_id);
             vec_result = rawreader->getvectors(iter_id, cache_config.embedding_vec_size_[j]);
           } else {
-            rawreader->load(inference_params.embedding_table_names[j],
-                            inference_params.sparse_model_files[j], length);
             // copy the embedding keys from reader to refresh space
             key_result = rawreader->getkeys(idx_set / stride_set);
             vec_result =
@@ -558,11 +825,23 @@ void HierParameterServer<TypeHashKey>::init_ec(
           // Get the total number of keys in non-fused table
           num_emb_keys_per_table.emplace_back(cache_config.num_set_in_cache_[j]);
         }
+        bool prehashed = false;
+        if (prehashed_table &&
+            prehashed_table->value_size() == cache_config.embedding_vec_size_[j] * sizeof(float)) {
+          prehashed = embedding_cache_map[device_id]->init_prehashed(
+              j, prehashed_table->keys(), prehashed_table->rows(), prehashed_table->num_slots(),
+              prehashed_table->values(), prehashed_table->num_rows(), stream);
+          if (prehashed) {
+            HCTR_LOG_S(INFO, ROOT) << "Initialized the embedding table " << j << " with the "
+                                   << prehashed_table->num_keys()
+                                   << " keys of its pre-hashed table." << std::endl;
+          }
+        }
         // Calculate the number of iterations required to initialize ec
         size_t num_iterations = 0;
         // The number of keys that need to be inserted into the cache for each table
         size_t numkeys_in_EC_pertable = 0;
-        for (size_t table_id = 0; table_id < num_fused_tables; table_id++) {
+        for (size_t table_id = 0; !prehashed && table_id < num_fused_tables; table_id++) {
           if (inference_params.fuse_embedding_table) {
             // Get the number of keys in the cache for  the current table
             numkeys_in_EC_pertable = ((float)num_emb_keys_per_table[table_id] / total_emb_keys) *
@@ -595,6 +874,7 @@ void HierParameterServer<TypeHashKey>::init_ec(
             HCTR_LIB_THROW(cudaStreamSynchronize(stream));
           }
         }
+        embedding_cache_map[device_id]->finish_refresh(j, stream);
 
       } else {
         *refreshspace_handler.h_length_ = cache_config.num_set_in_cache_[j];
@@ -636,10 +916,13 @@ template <typename TypeHashKey>
 void HierParameterServer<TypeHashKey>::create_embedding_cache_per_model(
     InferenceParams& inference_params) {
   if (inference_params.deployed_devices.empty()) {
-    HCTR_OWN_THROW(Error_t::WrongInput, "The list of deployed devices is empty.");
-  }
-  if (std::find(inference_params.deployed_devices.begin(), inference_params.deployed_devices.end(),
-                inference_params.device_id) == inference_params.deployed_devices.end()) {
+    // GPU-less serving tiers look the embeddings up in the database tiers, see `CpuLookupSession`.
+    HCTR_LOG_S(INFO, WORLD) << "Model " << inference_params.model_name
+                            << " has no deployed devices and is served from the CPU only."
+                            << std::endl;
+  } else if (std::find(inference_params.deployed_devices.begin(),
+                       inference_params.deployed_devices.end(),
+                       inference_params.device_id) == inference_params.deployed_devices.end()) {
     HCTR_OWN_THROW(Error_t::WrongInput, "The device id is not in the list of deployed devices.");
   }
   std::map<int64_t, std::shared_ptr<EmbeddingCacheBase>> embedding_cache_map;
@@ -648,7 +931,46 @@ void HierParameterServer<TypeHashKey>::create_embedding_cache_per_model(
     inference_params.device_id = device_id;
     embedding_cache_map[device_id] = EmbeddingCacheBase::create(inference_params, ps_config_, this);
   }
-  model_cache_map_[inference_params.model_name] = embedding_cache_map;
+  if (inference_params.shard_uvm_table &&
+      inference_params.embedding_cache_type == EmbeddingCacheType_t::UVM &&
+      !embedding_cache_map.empty()) {
+    std::vector<std::shared_ptr<UvmTable<TypeHashKey>>> shards;
+    for (const auto& [device_id, embedding_cache] : embedding_cache_map) {
+      shards.emplace_back(std::dynamic_pointer_cast<UvmTable<TypeHashKey>>(embedding_cache));
+      HCTR_CHECK_HINT(shards.back(), "The UVM embedding cache of device %d has another key type.",
+                      static_cast<int>(device_id));
+    }
+    UvmTable<TypeHashKey>::connect_shards(shards);
+  }
+  // A new version of a deployed model starts from the keys that the caches of the previous version
+  // hold, so that it does not serve from cold caches after the cutover.
+  std::map<int64_t, std::shared_ptr<EmbeddingCacheBase>> previous_cache_map;
+  {
+    const std::lock_guard<std::mutex> lock(model_cache_map_mutex_);
+    const auto it = model_cache_map_.find(inference_params.model_name);
+    if (it != model_cache_map_.end()) {
+      previous_cache_map = it->second;
+    }
+  }
+  for (const auto& [device_id, embedding_cache] : embedding_cache_map) {
+    const auto it = previous_cache_map.find(device_id);
+    if (it != previous_cache_map.end()) {
+      warm_up_embedding_cache(inference_params.model_name, it->second, embedding_cache);
+    }
+  }
+  {
+    const std::lock_guard<std::mutex> lock(model_cache_map_mutex_);
+    model_cache_map_[inference_params.model_name] = embedding_cache_map;
+
+    auto& miss_coalescers = miss_coalescers_[inference_params.model_name];
+    const size_t num_tables = inference_params.fuse_embedding_table
+                                  ? inference_params.fused_sparse_model_files.size()
+                                  : inference_params.sparse_model_files.size();
+    while (miss_coalescers.size() < num_tables) {
+      miss_coalescers.emplace_back(std::make_shared<MissCoalescer<TypeHashKey>>());
+    }
+  }
+  refresh_bloom_filters_per_model(inference_params);
   memory_pool_config_.num_woker_buffer_size_per_model[inference_params.model_name] =
       inference_params.number_of_worker_buffers_in_pool;
   memory_pool_config_.num_refresh_buffer_size_per_model[inference_params.model_name] =
@@ -663,9 +985,496 @@ void HierParameterServer<TypeHashKey>::create_embedding_cache_per_model(
   }
 }
 
+template <typename TypeHashKey>
+void HierParameterServer<TypeHashKey>::warm_up_embedding_cache(
+    const std::string& model_name, const std::shared_ptr<EmbeddingCacheBase>& old_cache,
+    const std::shared_ptr<EmbeddingCacheBase>& new_cache) {
+  // Only the dynamic caches start out empty. The others are filled from the model files.
+  if (!std::dynamic_pointer_cast<EmbeddingCache<TypeHashKey>>(old_cache) ||
+      !std::dynamic_pointer_cast<EmbeddingCache<TypeHashKey>>(new_cache) ||
+      !old_cache->use_gpu_embedding_cache() || !new_cache->use_gpu_embedding_cache()) {
+    return;
+  }
+  const embedding_cache_config& new_config = new_cache->get_cache_config();
+  if (new_config.shared_cache_role_ == SharedCacheRole_t::Reader ||
+      old_cache->get_cache_config().embedding_vec_size_ != new_config.embedding_vec_size_) {
+    return;
+  }
+  HugeCTR::Timer timer;
+  timer.start();
+
+  CudaDeviceContext dev_restorer{new_cache->get_device_id()};
+  EmbeddingCacheRefreshspace refreshspace = old_cache->create_refreshspace();
+  const embedding_cache_config& old_config = old_cache->get_cache_config();
+  const size_t stride_set = old_config.num_set_in_refresh_workspace_;
+  size_t num_keys = 0;
+  try {
+    for (size_t i = 0; i < old_config.num_emb_table_; i++) {
+      cudaStream_t stream = new_cache->get_refresh_streams()[i];
+      for (size_t idx_set = 0; idx_set < old_config.num_set_in_cache_[i]; idx_set += stride_set) {
+        const size_t end_idx = std::min(idx_set + stride_set, old_config.num_set_in_cache_[i]);
+        old_cache->dump(i, refreshspace.d_refresh_embeddingcolumns_, refreshspace.d_length_,
+                        idx_set, end_idx, stream);
+        HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace.h_length_, refreshspace.d_length_,
+                                       sizeof(size_t), cudaMemcpyDeviceToHost, stream));
+        HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+        const size_t length = *refreshspace.h_length_;
+        if (!length) {
+          continue;
+        }
+        HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace.h_refresh_embeddingcolumns_,
+                                       refreshspace.d_refresh_embeddingcolumns_,
+                                       length * sizeof(TypeHashKey), cudaMemcpyDeviceToHost,
+                                       stream));
+        HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+        // The databases already hold the new version.
+        this->lookup(refreshspace.h_refresh_embeddingcolumns_, length,
+                     refreshspace.h_refresh_emb_vec_, model_name, i);
+        HCTR_LIB_THROW(cudaMemcpyAsync(
+            refreshspace.d_refresh_emb_vec_, refreshspace.h_refresh_emb_vec_,
+            length * new_config.embedding_vec_size_[i] * sizeof(float), cudaMemcpyHostToDevice,
+            stream));
+        new_cache->init(i, refreshspace, stream);
+        HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+        num_keys += length;
+      }
+    }
+  } catch (...) {
+    old_cache->destroy_refreshspace(refreshspace);
+    throw;
+  }
+  old_cache->destroy_refreshspace(refreshspace);
+
+  timer.stop();
+  HCTR_LOG_S(INFO, WORLD) << "Warmed up the embedding cache of model " << model_name
+                          << " on device " << new_cache->get_device_id() << " with " << num_keys
+                          << " keys of the previous version in " << timer.elapsedSeconds()
+                          << "s." << std::endl;
+}
+
+template <typename TypeHashKey>
+void HierParameterServer<TypeHashKey>::warm_up_embedding_caches_from_key_log(
+    const InferenceParams& inference_params) {
+  const std::string& model_name = inference_params.model_name;
+  if (!inference_params.use_gpu_embedding_cache ||
+      inference_params.embedding_cache_type != EmbeddingCacheType_t::Dynamic ||
+      inference_params.shared_cache_role == SharedCacheRole_t::Reader) {
+    HCTR_LOG_S(WARNING, ROOT) << "Model " << model_name
+                              << ": key_log_warmup_file is ignored, only the owners of dynamic GPU "
+                                 "embedding caches are warmed up."
+                              << std::endl;
+    return;
+  }
+  if (!std::filesystem::exists(inference_params.key_log_warmup_file)) {
+    // E.g., the first replica, that no one wrote a log for yet.
+    HCTR_LOG_S(WARNING, ROOT) << "Model " << model_name << ": cache key log "
+                              << inference_params.key_log_warmup_file
+                              << " does not exist, the embedding caches start cold." << std::endl;
+    return;
+  }
+  std::unique_ptr<CacheKeyLog<TypeHashKey>> key_log;
+  try {
+    key_log = std::make_unique<CacheKeyLog<TypeHashKey>>(inference_params.key_log_warmup_file);
+  } catch (const std::exception& error) {
+    HCTR_LOG_S(WARNING, ROOT) << "Model " << model_name << ": cannot read cache key log "
+                              << inference_params.key_log_warmup_file << ", the embedding caches "
+                              << "start cold: " << error.what() << std::endl;
+    return;
+  }
+
+  std::vector<std::shared_ptr<EmbeddingCacheBase>> caches;
+  for (const int device_id : inference_params.deployed_devices) {
+    const std::shared_ptr<EmbeddingCacheBase> embedding_cache =
+        get_embedding_cache(model_name, device_id);
+    if (std::dynamic_pointer_cast<EmbeddingCache<TypeHashKey>>(embedding_cache)) {
+      caches.emplace_back(embedding_cache);
+    }
+  }
+  if (caches.empty()) {
+    return;
+  }
+  HugeCTR::Timer timer;
+  timer.start();
+
+  // The keys of a chunk are looked up from the databases once, and then inserted into the caches
+  // of all devices from the pinned buffers of the first refreshspace.
+  std::vector<EmbeddingCacheRefreshspace> refreshspaces;
+  const auto destroy_refreshspaces = [&]() {
+    for (size_t d = 0; d < refreshspaces.size(); d++) {
+      CudaDeviceContext dev_restorer{caches[d]->get_device_id()};
+      caches[d]->destroy_refreshspace(refreshspaces[d]);
+    }
+  };
+  size_t num_keys = 0;
+  try {
+    for (const std::shared_ptr<EmbeddingCacheBase>& embedding_cache : caches) {
+      CudaDeviceContext dev_restorer{embedding_cache->get_device_id()};
+      refreshspaces.emplace_back(embedding_cache->create_refreshspace());
+    }
+    const embedding_cache_config& cache_config = caches.front()->get_cache_config();
+    const size_t chunk_size = refresh_chunk_size(cache_config);
+    EmbeddingCacheRefreshspace& host_space = refreshspaces.front();
+    for (size_t i = 0; i < cache_config.num_emb_table_; i++) {
+      const std::vector<TypeHashKey>* const keys =
+          key_log->keys(cache_config.embedding_table_name_[i]);
+      if (!keys) {
+        continue;
+      }
+      const size_t vec_size = cache_config.embedding_vec_size_[i];
+      for (size_t offset = 0; offset < keys->size(); offset += chunk_size) {
+        const size_t length = std::min(chunk_size, keys->size() - offset);
+        TypeHashKey* const h_keys =
+            static_cast<TypeHashKey*>(host_space.h_refresh_embeddingcolumns_);
+        std::copy_n(keys->data() + offset, length, h_keys);
+        this->lookup(h_keys, length, host_space.h_refresh_emb_vec_, model_name, i);
+        for (size_t d = 0; d < caches.size(); d++) {
+          CudaDeviceContext dev_restorer{caches[d]->get_device_id()};
+          EmbeddingCacheRefreshspace& refreshspace = refreshspaces[d];
+          cudaStream_t stream = caches[d]->get_refresh_streams()[i];
+          HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace.d_refresh_embeddingcolumns_, h_keys,
+                                         length * sizeof(TypeHashKey), cudaMemcpyHostToDevice,
+                                         stream));
+          HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace.d_refresh_emb_vec_,
+                                         host_space.h_refresh_emb_vec_,
+                                         length * vec_size * sizeof(float),
+                                         cudaMemcpyHostToDevice, stream));
+          *refreshspace.h_length_ = length;
+          caches[d]->init(i, refreshspace, stream);
+          HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+        }
+        num_keys += length;
+      }
+    }
+  } catch (const std::exception& error) {
+    destroy_refreshspaces();
+    HCTR_LOG_S(WARNING, ROOT) << "Model " << model_name << ": warming up the embedding caches from "
+                              << inference_params.key_log_warmup_file
+                              << " stopped after " << num_keys << " keys: " << error.what()
+                              << std::endl;
+    return;
+  }
+  destroy_refreshspaces();
+
+  timer.stop();
+  HCTR_LOG_S(INFO, ROOT) << "Warmed up the embedding caches of model " << model_name << " on "
+                         << caches.size() << " devices with " << num_keys << " keys of "
+                         << inference_params.key_log_warmup_file << " in "
+                         << timer.elapsedSeconds() << "s." << std::endl;
+}
+
+template <typename TypeHashKey>
+void HierParameterServer<TypeHashKey>::write_cache_key_log(const std::string& model_name,
+                                                           const std::string& path) {
+  // The caches of all devices see the same traffic, so the first one stands for the model.
+  std::shared_ptr<EmbeddingCacheBase> embedding_cache;
+  {
+    const std::lock_guard<std::mutex> lock(model_cache_map_mutex_);
+    const auto it = model_cache_map_.find(model_name);
+    HCTR_THROW_IF(it == model_cache_map_.end() || it->second.empty(), Error_t::WrongInput,
+                  "Model ", model_name, " has no embedding cache.");
+    embedding_cache = it->second.begin()->second;
+  }
+  HCTR_THROW_IF(!std::dynamic_pointer_cast<EmbeddingCache<TypeHashKey>>(embedding_cache) ||
+                    !embedding_cache->use_gpu_embedding_cache(),
+                Error_t::WrongInput, "Model ", model_name,
+                ": only dynamic GPU embedding caches can write a cache key log.");
+
+  CudaDeviceContext dev_restorer{embedding_cache->get_device_id()};
+  EmbeddingCacheRefreshspace refreshspace = embedding_cache->create_refreshspace();
+  const embedding_cache_config& cache_config = embedding_cache->get_cache_config();
+  const size_t stride_set = cache_config.num_set_in_refresh_workspace_;
+  std::vector<std::vector<TypeHashKey>> keys(cache_config.num_emb_table_);
+  size_t num_keys = 0;
+  try {
+    for (size_t i = 0; i < cache_config.num_emb_table_; i++) {
+      cudaStream_t stream = embedding_cache->get_refresh_streams()[i];
+      for (size_t idx_set = 0; idx_set < cache_config.num_set_in_cache_[i];
+           idx_set += stride_set) {
+        const size_t end_idx = std::min(idx_set + stride_set, cache_config.num_set_in_cache_[i]);
+        embedding_cache->dump(i, refreshspace.d_refresh_embeddingcolumns_, refreshspace.d_length_,
+                              idx_set, end_idx, stream);
+        HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace.h_length_, refreshspace.d_length_,
+                                       sizeof(size_t), cudaMemcpyDeviceToHost, stream));
+        HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+        const size_t length = *refreshspace.h_length_;
+        if (!length) {
+          continue;
+        }
+        HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace.h_refresh_embeddingcolumns_,
+                                       refreshspace.d_refresh_embeddingcolumns_,
+                                       length * sizeof(TypeHashKey), cudaMemcpyDeviceToHost,
+                                       stream));
+        HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+        const TypeHashKey* const h_keys =
+            static_cast<const TypeHashKey*>(refreshspace.h_refresh_embeddingcolumns_);
+        keys[i].insert(keys[i].end(), h_keys, h_keys + length);
+        num_keys += length;
+      }
+    }
+  } catch (...) {
+    embedding_cache->destroy_refreshspace(refreshspace);
+    throw;
+  }
+  embedding_cache->destroy_refreshspace(refreshspace);
+
+  CacheKeyLog<TypeHashKey>::write(path, cache_config.embedding_table_name_, keys);
+  HCTR_LOG_S(DEBUG, WORLD) << "Wrote " << num_keys << " keys of the embedding cache of model "
+                           << model_name << " to " << path << '.' << std::endl;
+}
+
+template <typename TypeHashKey>
+void HierParameterServer<TypeHashKey>::refresh_bloom_filters_per_model(
+    const InferenceParams& inference_params) {
+  if (!inference_params.use_bloom_filter || !inference_params.use_gpu_embedding_cache ||
+      inference_params.embedding_cache_type != EmbeddingCacheType_t::Dynamic) {
+    return;
+  }
+  std::map<int64_t, std::shared_ptr<EmbeddingCacheBase>> embedding_cache_map;
+  {
+    const std::lock_guard<std::mutex> lock(model_cache_map_mutex_);
+    const auto it = model_cache_map_.find(inference_params.model_name);
+    if (it == model_cache_map_.end()) {
+      return;
+    }
+    embedding_cache_map = it->second;
+  }
+
+  IModelLoader* rawreader =
+      ModelLoader<TypeHashKey, float>::CreateLoader(DatabaseTableDumpFormat_t::Raw);
+  auto insert_keys = [&](const size_t table_id) {
+    for (size_t i = 0; i < rawreader->get_num_iterations(); i++) {
+      const std::pair<void*, size_t> key_result = rawreader->getkeys(i);
+      for (auto& ec : embedding_cache_map) {
+        ec.second->insert_bloom_filter(table_id, key_result.first, key_result.second);
+      }
+    }
+  };
+
+  const size_t num_tables = inference_params.fuse_embedding_table
+                                ? inference_params.fused_sparse_model_files.size()
+                                : inference_params.sparse_model_files.size();
+  for (size_t j = 0; j < num_tables; j++) {
+    for (auto& ec : embedding_cache_map) {
+      ec.second->clear_bloom_filter(j);
+    }
+    if (inference_params.fuse_embedding_table) {
+      for (const std::string& sparse_model_file : inference_params.fused_sparse_model_files[j]) {
+        rawreader->load(inference_params.embedding_table_names[j], sparse_model_file);
+        insert_keys(j);
+      }
+    } else {
+      rawreader->load(inference_params.embedding_table_names[j],
+                      inference_params.sparse_model_files[j]);
+      insert_keys(j);
+    }
+    // Only a filter that has seen all keys can be trusted to reject keys.
+    for (auto& ec : embedding_cache_map) {
+      ec.second->seal_bloom_filter(j);
+    }
+  }
+  rawreader->delete_table();
+
+  HCTR_LOG_S(INFO, WORLD) << "Bloom filters of model " << inference_params.model_name
+                          << " have been rebuilt for " << num_tables << " table(s)." << std::endl;
+}
+
+template <typename TypeHashKey>
+bool HierParameterServer<TypeHashKey>::resolve_tag_name(const std::string& tag_name,
+                                                        std::string& model_name,
+                                                        size_t& table_id) const {
+  // Tags are formatted as "<prefix>.<model_name>.<embedding_table_name>" (see make_tag_name).
+  const size_t model_name_pos = tag_name.find('.');
+  const size_t table_name_pos = tag_name.find('.', model_name_pos + 1);
+  if (model_name_pos == std::string::npos || table_name_pos == std::string::npos) {
+    return false;
+  }
+  model_name = tag_name.substr(model_name_pos + 1, table_name_pos - model_name_pos - 1);
+  const std::string table_name = tag_name.substr(table_name_pos + 1);
+
+  const auto table_names_it = ps_config_.emb_table_name_.find(model_name);
+  if (table_names_it == ps_config_.emb_table_name_.end()) {
+    return false;
+  }
+  const std::vector<std::string>& table_names = table_names_it->second;
+  const auto table_it = std::find(table_names.begin(), table_names.end(), table_name);
+  if (table_it == table_names.end()) {
+    return false;
+  }
+  table_id = static_cast<size_t>(std::distance(table_names.begin(), table_it));
+  return true;
+}
+
+template <typename TypeHashKey>
+void HierParameterServer<TypeHashKey>::update_bloom_filters(const std::string& tag_name,
+                                                            const size_t num_keys,
+                                                            const TypeHashKey* const keys) {
+  std::string model_name;
+  size_t table_id;
+  if (!resolve_tag_name(tag_name, model_name, table_id)) {
+    return;
+  }
+
+  const std::lock_guard<std::mutex> lock(model_cache_map_mutex_);
+  const auto it = model_cache_map_.find(model_name);
+  if (it != model_cache_map_.end()) {
+    for (auto& ec : it->second) {
+      ec.second->insert_bloom_filter(table_id, keys, num_keys);
+    }
+  }
+}
+
+template <typename TypeHashKey>
+void HierParameterServer<TypeHashKey>::update_embedding_caches(const std::string& tag_name,
+                                                               const size_t num_keys,
+                                                               const TypeHashKey* const keys,
+                                                               const char* const values,
+                                                               const size_t value_size) {
+  std::string model_name;
+  size_t table_id;
+  if (!resolve_tag_name(tag_name, model_name, table_id)) {
+    return;
+  }
+
+  std::map<int64_t, std::shared_ptr<EmbeddingCacheBase>> embedding_caches;
+  {
+    const std::lock_guard<std::mutex> lock(model_cache_map_mutex_);
+    const auto caches_it = model_cache_map_.find(model_name);
+    const auto params_it = inference_params_map_.find(model_name);
+    if (!buffer_pool_ || caches_it == model_cache_map_.end() ||
+        params_it == inference_params_map_.end()) {
+      return;
+    }
+    // Only the dynamic cache overwrites rows in place. The readers of a shared cache leave that to
+    // its owner.
+    const InferenceParams& inference_params = params_it->second;
+    if (!inference_params.use_gpu_embedding_cache ||
+        inference_params.embedding_cache_type != EmbeddingCacheType_t::Dynamic ||
+        inference_params.shared_cache_role == SharedCacheRole_t::Reader) {
+      return;
+    }
+    embedding_caches = caches_it->second;
+  }
+
+  for (auto& device_cache : embedding_caches) {
+    const int device_id = static_cast<int>(device_cache.first);
+    const std::shared_ptr<EmbeddingCacheBase>& embedding_cache = device_cache.second;
+    const embedding_cache_config cache_config = embedding_cache->get_cache_config();
+    if (value_size != cache_config.embedding_vec_size_[table_id] * sizeof(float)) {
+      HCTR_LOG_C(WARNING, WORLD, "Update for tag '", tag_name, "' has ", value_size,
+                 " bytes per value, which does not match the embedding cache. Not applied.\n");
+      return;
+    }
+
+    CudaDeviceContext dev_restorer{device_id};
+    cudaStream_t stream = embedding_cache->get_refresh_streams()[table_id];
+    MemoryBlock* memory_block = nullptr;
+    while (memory_block == nullptr) {
+      memory_block = reinterpret_cast<struct MemoryBlock*>(
+          this->apply_buffer(model_name, device_id, CACHE_SPACE_TYPE::REFRESHER));
+    }
+    const EmbeddingCacheRefreshspace& refreshspace_handler = memory_block->refresh_buffer;
+    const size_t chunk_size = refresh_chunk_size(cache_config);
+
+    try {
+      // Overwrite the cached rows chunk by chunk, without dumping the cache. Keys that are not
+      // cached are skipped by the cache.
+      for (size_t offset = 0; offset < num_keys; offset += chunk_size) {
+        const size_t length = std::min(chunk_size, num_keys - offset);
+        HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace_handler.d_refresh_embeddingcolumns_,
+                                       &keys[offset], length * sizeof(TypeHashKey),
+                                       cudaMemcpyHostToDevice, stream));
+        HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace_handler.d_refresh_emb_vec_,
+                                       &values[offset * value_size], length * value_size,
+                                       cudaMemcpyHostToDevice, stream));
+        embedding_cache->refresh(table_id, refreshspace_handler.d_refresh_embeddingcolumns_,
+                                 refreshspace_handler.d_refresh_emb_vec_, length, stream);
+        HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+      }
+    } catch (const std::runtime_error& rt_err) {
+      HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
+    }
+    this->free_buffer(memory_block);
+  }
+}
+
+template <typename TypeHashKey>
+void HierParameterServer<TypeHashKey>::record_updated_keys(const std::string& tag_name,
+                                                           const size_t num_keys,
+                                                           const TypeHashKey* const keys) {
+  std::string model_name;
+  size_t table_id;
+  if (!resolve_tag_name(tag_name, model_name, table_id)) {
+    return;
+  }
+
+  const std::lock_guard<std::mutex> lock(refresh_state_mutex_);
+  const auto it = updated_keys_.find(model_name);
+  if (it != updated_keys_.end()) {
+    for (auto& device_keys : it->second) {
+      device_keys.second[table_id].insert(keys, keys + num_keys);
+    }
+  }
+}
+
+template <typename TypeHashKey>
+void HierParameterServer<TypeHashKey>::run_background_refresh(
+    const InferenceParams& inference_params) {
+  // Sleeps for the given time. False if the parameter server shuts down in the meantime.
+  const auto wait = [this](const float seconds) {
+    std::unique_lock<std::mutex> lock(background_refreshers_mutex_);
+    return !background_refreshers_cv_.wait_for(lock, std::chrono::duration<float>(seconds),
+                                               [this] { return stop_background_refreshers_; });
+  };
+
+  HCTR_LOG_S(INFO, WORLD) << "Refreshing the embedding caches of model "
+                          << inference_params.model_name << " every "
+                          << inference_params.refresh_interval << " s in the background."
+                          << std::endl;
+  if (!wait(inference_params.refresh_delay)) {
+    return;
+  }
+  do {
+    for (const int device_id : inference_params.deployed_devices) {
+      try {
+        CudaDeviceContext dev_restorer{device_id};
+        refresh_embedding_cache(inference_params.model_name, device_id);
+        const std::shared_ptr<EmbeddingCacheBase> embedding_cache =
+            get_embedding_cache(inference_params.model_name, device_id);
+        if (embedding_cache) {
+          embedding_cache->rebalance_capacity();
+        }
+      } catch (const std::exception& error) {
+        HCTR_LOG_S(ERROR, WORLD) << "Background refresh of model " << inference_params.model_name
+                                 << " on device " << device_id << " failed: " << error.what()
+                                 << std::endl;
+      }
+    }
+    if (!inference_params.key_log_record_file.empty()) {
+      try {
+        write_cache_key_log(inference_params.model_name, inference_params.key_log_record_file);
+      } catch (const std::exception& error) {
+        HCTR_LOG_S(ERROR, WORLD) << "Recording the cache key log of model "
+                                 << inference_params.model_name << " failed: " << error.what()
+                                 << std::endl;
+      }
+    }
+  } while (wait(inference_params.refresh_interval));
+}
+
+template <typename TypeHashKey>
+size_t HierParameterServer<TypeHashKey>::refresh_chunk_size(
+    const embedding_cache_config& cache_config) {
+  // The refresh workspace holds at least this many keys (see create_refreshspace).
+  const size_t max_set_associativity = *std::max_element(cache_config.set_associativity_.begin(),
+                                                         cache_config.set_associativity_.end());
+  return std::max<size_t>(cache_config.num_set_in_refresh_workspace_ - 1, 1) * SLAB_SIZE *
+         max_set_associativity;
+}
+
 template <typename TypeHashKey>
 void HierParameterServer<TypeHashKey>::destory_embedding_cache_per_model(
     const std::string& model_name) {
+  const std::lock_guard<std::mutex> lock(model_cache_map_mutex_);
   if (model_cache_map_.find(model_name) != model_cache_map_.end()) {
     for (auto& f : model_cache_map_[model_name]) {
       f.second->finalize();
@@ -673,17 +1482,27 @@ void HierParameterServer<TypeHashKey>::destory_embedding_cache_per_model(
     model_cache_map_.erase(model_name);
   }
   buffer_pool_->DestoryManagerPool(model_name);
+
+  const std::lock_guard<std::mutex> refresh_state_lock(refresh_state_mutex_);
+  refresh_cursors_.erase(model_name);
 }
 
 template <typename TypeHashKey>
 void HierParameterServer<TypeHashKey>::erase_model_from_hps(const std::string& model_name) {
+  const std::lock_guard<std::mutex> lock(loaded_tables_mutex_);
   if (volatile_db_) {
     const std::vector<std::string>& table_names = volatile_db_->find_tables(model_name);
     volatile_db_->evict(table_names);
+    for (const std::string& table_name : table_names) {
+      loaded_tables_.erase(table_name);
+    }
   }
   if (persistent_db_) {
     const std::vector<std::string>& table_names = persistent_db_->find_tables(model_name);
     persistent_db_->evict(table_names);
+    for (const std::string& table_name : table_names) {
+      loaded_tables_.erase(table_name);
+    }
   }
 }
 
@@ -740,7 +1559,8 @@ void HierParameterServer<TypeHashKey>::free_buffer(void* p) {
 template <typename TypeHashKey>
 void HierParameterServer<TypeHashKey>::lookup(const void* const h_keys, const size_t length,
                                               float* const h_vectors, const std::string& model_name,
-                                              const size_t table_id) {
+                                              const size_t table_id,
+                                              const std::chrono::nanoseconds& time_budget) {
   if (!length) {
     return;
   }
@@ -763,73 +1583,119 @@ void HierParameterServer<TypeHashKey>::lookup(const void* const h_keys, const si
   HCTR_LOG_S(TRACE, WORLD) << "Looking up " << length << " embeddings (each with " << embedding_size
                            << " values)..." << std::endl;
 #endif
-  size_t hit_count = 0;
+  std::atomic<size_t> hit_count{0};
 
   DatabaseMissCallback fill_default{[&](const size_t index) {
     std::fill_n(&h_vectors[index * embedding_size], embedding_size, default_vec_value);
   }};
 
+  // Budget left for the next database query. Consistent with `fetch`, `zero` means unlimited. Once
+  // the deadline has passed, an empty optional is returned.
+  const auto remaining_budget{[&]() -> std::optional<std::chrono::nanoseconds> {
+    if (time_budget == std::chrono::nanoseconds::zero()) {
+      return std::chrono::nanoseconds::zero();
+    }
+    const std::chrono::nanoseconds elapsed{std::chrono::high_resolution_clock::now() - start_time};
+    if (elapsed >= time_budget) {
+      return std::nullopt;
+    }
+    return time_budget - elapsed;
+  }};
+
   // If have volatile and persistent database.
   if (volatile_db_ && persistent_db_) {
-    // Do a sequential lookup in the volatile DB, and remember the missing keys.
-    constexpr size_t invalid_index{std::numeric_limits<size_t>::max()};
-    std::vector<size_t> indices(length, invalid_index);
+    const TypeHashKey* const keys{reinterpret_cast<const TypeHashKey*>(h_keys)};
+    std::vector<std::future<void>> pdb_tasks;
+    pdb_tasks.reserve((length + lookup_pipeline_chunk_size - 1) / lookup_pipeline_chunk_size);
+
+    try {
+      for (size_t chunk_begin{}; chunk_begin < length; chunk_begin += lookup_pipeline_chunk_size) {
+        const size_t chunk_size{std::min(length - chunk_begin, lookup_pipeline_chunk_size)};
+
+        // Do a sequential lookup in the volatile DB, and remember the missing keys.
+        constexpr size_t invalid_index{std::numeric_limits<size_t>::max()};
+        auto indices{std::make_shared<std::vector<size_t>>(chunk_size, invalid_index)};
+
+        const std::optional<std::chrono::nanoseconds> vdb_budget{remaining_budget()};
+        if (vdb_budget) {
+          start = profiler::start();
+          hit_count += volatile_db_->fetch(
+              tag_name, chunk_size, &keys[chunk_begin],
+              reinterpret_cast<char*>(&h_vectors[chunk_begin * embedding_size]),
+              expected_value_size,
+              [&](const size_t index) { (*indices)[index] = chunk_begin + index; }, *vdb_budget);
+          hps_profiler->end(start, "Lookup the embedding key from VDB");
+
+          // Compress indices (Erase-remove idiom).
+          indices->erase(std::remove(indices->begin(), indices->end(), invalid_index),
+                         indices->end());
+        } else {
+          std::iota(indices->begin(), indices->end(), chunk_begin);
+        }
+        if (indices->empty()) {
+          continue;
+        }
 
-    start = profiler::start();
-    hit_count += volatile_db_->fetch(tag_name, length, reinterpret_cast<const TypeHashKey*>(h_keys),
-                                     reinterpret_cast<char*>(h_vectors), expected_value_size,
-                                     [&](const size_t index) { indices[index] = index; });
-    hps_profiler->end(start, "Lookup the embedding key from VDB");
+        // Do a sparse lookup in the persisent DB, to fill gaps and set others to default. This runs
+        // in the background, so that the next chunk can be fetched from the volatile DB meanwhile.
+        pdb_tasks.emplace_back(lookup_pipeline_.submit([&, indices]() {
+          const std::optional<std::chrono::nanoseconds> pdb_budget{remaining_budget()};
+          if (pdb_budget) {
+            BaseUnit* const pdb_start = profiler::start();
+            hit_count += persistent_db_->fetch(tag_name, indices->size(), indices->data(), keys,
+                                               reinterpret_cast<char*>(h_vectors),
+                                               expected_value_size, fill_default, *pdb_budget);
+            hps_profiler->end(pdb_start, "Lookup the missing embedding key from the PDB");
+          } else {
+            std::for_each(indices->begin(), indices->end(), fill_default);
+          }
 
-    HCTR_LOG_C(TRACE, WORLD, volatile_db_->get_name(), ": ", hit_count, " hits, ",
-               length - hit_count, " missing!\n");
+          // Elevate KV pairs if desired and possible.
+          if (volatile_db_cache_missed_embeddings_) {
+            // If the layer 0 cache should be optimized as we go, elevate missed keys.
+            auto keys_to_elevate{std::make_shared<std::vector<TypeHashKey>>(indices->size())};
+            auto values_to_elevate{
+                std::make_shared<std::vector<float>>(indices->size() * embedding_size)};
 
-    if (hit_count != length) {
-      // Compress indices (Erase-remove idiom).
-      indices.erase(std::remove(indices.begin(), indices.end(), invalid_index), indices.end());
+            for (size_t i{}; i != indices->size(); ++i) {
+              const size_t index{(*indices)[i]};
 
-      // Do a sparse lookup in the persisent DB, to fill gaps and set others to default.
-      start = profiler::start();
-      hit_count += persistent_db_->fetch(
-          tag_name, indices.size(), indices.data(), reinterpret_cast<const TypeHashKey*>(h_keys),
-          reinterpret_cast<char*>(h_vectors), expected_value_size, fill_default);
-      hps_profiler->end(start, "Lookup the missing embedding key from the PDB");
-
-      HCTR_LOG_C(TRACE, WORLD, persistent_db_->get_name(), ": ", hit_count, " hits, ",
-                 length - hit_count, " still missing!\n");
-
-      // Elevate KV pairs if desired and possible.
-      if (volatile_db_cache_missed_embeddings_) {
-        // If the layer 0 cache should be optimized as we go, elevate missed keys.
-        auto keys_to_elevate{std::make_shared<std::vector<TypeHashKey>>(indices.size())};
-        auto values_to_elevate{
-            std::make_shared<std::vector<float>>(indices.size() * embedding_size)};
-
-        start = profiler::start();
-        for (size_t i{}; i != indices.size(); ++i) {
-          const size_t index{indices[i]};
-
-          (*keys_to_elevate)[i] = reinterpret_cast<const TypeHashKey*>(h_keys)[index];
-          std::copy_n(&h_vectors[index * embedding_size], embedding_size,
-                      &(*values_to_elevate)[i * embedding_size]);
-        }
-        hps_profiler->end(start, "Insert the missing embedding key into the VDB");
-
-        HCTR_LOG_C(DEBUG, WORLD, "Attempting to migrate ", keys_to_elevate->size(),
-                   " embeddings from ", persistent_db_->get_name(), " to ",
-                   volatile_db_->get_name(), ".\n");
-
-        start = profiler::start();
-        volatile_db_async_inserter_.submit([this, tag_name, keys_to_elevate, values_to_elevate,
-                                            expected_value_size, start]() {
-          volatile_db_->insert(tag_name, keys_to_elevate->size(), keys_to_elevate->data(),
-                               reinterpret_cast<char*>(values_to_elevate->data()),
-                               expected_value_size, expected_value_size);
-          hps_profiler->end(
-              start, "Insert the missing embedding key from the PDB into the VDB asynchronously");
+              (*keys_to_elevate)[i] = keys[index];
+              std::copy_n(&h_vectors[index * embedding_size], embedding_size,
+                          &(*values_to_elevate)[i * embedding_size]);
+            }
+
+            HCTR_LOG_C(DEBUG, WORLD, "Attempting to migrate ", keys_to_elevate->size(),
+                       " embeddings from ", persistent_db_->get_name(), " to ",
+                       volatile_db_->get_name(), ".\n");
+
+            BaseUnit* const elevate_start = profiler::start();
+            volatile_db_async_inserter_.submit([this, tag_name, keys_to_elevate, values_to_elevate,
+                                                expected_value_size, elevate_start]() {
+              volatile_db_->insert(tag_name, keys_to_elevate->size(), keys_to_elevate->data(),
+                                   reinterpret_cast<char*>(values_to_elevate->data()),
+                                   expected_value_size, expected_value_size);
+              hps_profiler->end(
+                  elevate_start,
+                  "Insert the missing embedding key from the PDB into the VDB asynchronously");
+            });
+          }
+        }));
+      }
+    } catch (...) {
+      // Background tasks reference the caller's buffers. Hence, must drain them before unwinding.
+      for (auto& task : pdb_tasks) {
+        ThreadPool::help_while([&task]() {
+          return task.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
         });
+        task.wait();
       }
+      throw;
     }
+    ThreadPool::await(pdb_tasks.begin(), pdb_tasks.end());
+
+    HCTR_LOG_C(TRACE, WORLD, volatile_db_->get_name(), " + ", persistent_db_->get_name(), ": ",
+               hit_count.load(), " hits, ", length - hit_count, " missing!\n");
   } else {
     // If any database.
     DatabaseBackendBase<TypeHashKey>* const db =
@@ -837,12 +1703,14 @@ void HierParameterServer<TypeHashKey>::lookup(const void* const h_keys, const si
                      : static_cast<DatabaseBackendBase<TypeHashKey>*>(persistent_db_.get());
     if (db) {
       start = profiler::start();
-      // Do a sequential lookup in the volatile DB, but fill gaps with a default value.
+      // Do a sequential lookup in the volatile DB, but fill gaps with a default value. If already
+      // past the deadline, the minimal budget makes `fetch` default all keys right away.
       hit_count += db->fetch(tag_name, length, reinterpret_cast<const TypeHashKey*>(h_keys),
-                             reinterpret_cast<char*>(h_vectors), expected_value_size, fill_default);
+                             reinterpret_cast<char*>(h_vectors), expected_value_size, fill_default,
+                             remaining_budget().value_or(std::chrono::nanoseconds{1}));
       hps_profiler->end(start, "Lookup the embedding key from default HPS database Backend");
-      HCTR_LOG_C(TRACE, WORLD, db->get_name(), ": ", hit_count, " hits, ", length - hit_count,
-                 " missing!\n");
+      HCTR_LOG_C(TRACE, WORLD, db->get_name(), ": ", hit_count.load(), " hits, ",
+                 length - hit_count, " missing!\n");
     } else {
       // Without a database, set everything to default.
       std::fill_n(h_vectors, length * embedding_size, default_vec_value);
@@ -854,11 +1722,21 @@ void HierParameterServer<TypeHashKey>::lookup(const void* const h_keys, const si
   const auto duration =
       std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
 #ifdef ENABLE_INFERENCE
-  HCTR_LOG_S(TRACE, WORLD) << "Parameter server lookup of " << hit_count << " / " << length
+  HCTR_LOG_S(TRACE, WORLD) << "Parameter server lookup of " << hit_count.load() << " / " << length
                            << " embeddings took " << duration.count() << " us." << std::endl;
 #endif
 }
 
+template <typename TypeHashKey>
+std::future<void> HierParameterServer<TypeHashKey>::lookup_async(
+    const void* const h_keys, const size_t length, float* const h_vectors,
+    const std::string& model_name, const size_t table_id,
+    const std::chrono::nanoseconds& time_budget) {
+  return lookup_async_workers_.submit([=]() {
+    lookup(h_keys, length, h_vectors, model_name, table_id, time_budget);
+  });
+}
+
 template <typename TypeHashKey>
 void HierParameterServer<TypeHashKey>::refresh_embedding_cache(const std::string& model_name,
                                                                const int device_id) {
@@ -867,19 +1745,47 @@ void HierParameterServer<TypeHashKey>::refresh_embedding_cache(const std::string
   HugeCTR::Timer timer_refresh;
 
   std::shared_ptr<EmbeddingCacheBase> embedding_cache = get_embedding_cache(model_name, device_id);
+  if (!embedding_cache) {
+    return;
+  }
   if (!embedding_cache->use_gpu_embedding_cache()) {
     HCTR_LOG(WARNING, WORLD, "GPU embedding cache is not enabled and cannot be refreshed!\n");
     return;
   }
 
   embedding_cache_config cache_config = embedding_cache->get_cache_config();
+  if (cache_config.shared_cache_role_ == SharedCacheRole_t::Reader) {
+    HCTR_LOG(INFO, WORLD, "The shared embedding cache is refreshed by its owner process.\n");
+    return;
+  }
   if (cache_config.cache_refresh_percentage_per_iteration <= 0) {
     HCTR_LOG(WARNING, WORLD,
              "The configuration of cache refresh percentage per iteration must be greater than 0 "
              "to refresh the GPU embedding cache!\n");
     return;
   }
+  float time_budget_ms = 0;
+  bool updated_keys_only = false;
+  {
+    const std::lock_guard<std::mutex> lock(model_cache_map_mutex_);
+    const auto it = inference_params_map_.find(model_name);
+    if (it != inference_params_map_.end()) {
+      time_budget_ms = it->second.refresh_time_budget_ms;
+      updated_keys_only = it->second.refresh_updated_keys_only;
+    }
+  }
   timer_refresh.start();
+
+  // A refresh that exceeds its time budget stops after the current batch, but it always completes
+  // at least one batch so that the refresh makes progress.
+  const auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                            std::chrono::duration<float, std::milli>(time_budget_ms));
+  bool made_progress = false;
+  const auto out_of_time = [&]() {
+    return time_budget_ms > 0 && made_progress && std::chrono::steady_clock::now() >= deadline;
+  };
+
   std::vector<cudaStream_t> streams = embedding_cache->get_refresh_streams();
   // apply the memory block for embedding cache refresh workspace
   MemoryBlock* memory_block = nullptr;
@@ -888,52 +1794,132 @@ void HierParameterServer<TypeHashKey>::refresh_embedding_cache(const std::string
         this->apply_buffer(model_name, device_id, CACHE_SPACE_TYPE::REFRESHER));
   }
   EmbeddingCacheRefreshspace refreshspace_handler = memory_block->refresh_buffer;
-  // Refresh the embedding cache for each table
-  const size_t stride_set = cache_config.num_set_in_refresh_workspace_;
-  HugeCTR::Timer timer;
-  for (size_t i = 0; i < cache_config.num_emb_table_; i++) {
-    for (size_t idx_set = 0; idx_set < cache_config.num_set_in_cache_[i]; idx_set += stride_set) {
-      const size_t end_idx = (idx_set + stride_set > cache_config.num_set_in_cache_[i])
-                                 ? cache_config.num_set_in_cache_[i]
-                                 : idx_set + stride_set;
-      timer.start();
-      embedding_cache->dump(i, refreshspace_handler.d_refresh_embeddingcolumns_,
-                            refreshspace_handler.d_length_, idx_set, end_idx, streams[i]);
-
-      HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace_handler.h_length_, refreshspace_handler.d_length_,
-                                     sizeof(size_t), cudaMemcpyDeviceToHost, streams[i]));
-      HCTR_LIB_THROW(cudaStreamSynchronize(streams[i]));
-      HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace_handler.h_refresh_embeddingcolumns_,
-                                     refreshspace_handler.d_refresh_embeddingcolumns_,
-                                     *refreshspace_handler.h_length_ * sizeof(TypeHashKey),
-                                     cudaMemcpyDeviceToHost, streams[i]));
-      HCTR_LIB_THROW(cudaStreamSynchronize(streams[i]));
-      timer.stop();
-      HCTR_LOG_S(TRACE, ROOT) << "Embedding Cache dumping the number of " << stride_set
-                              << " sets takes: " << timer.elapsedSeconds() << "s" << std::endl;
-      timer.start();
-      this->lookup(
-          reinterpret_cast<const TypeHashKey*>(refreshspace_handler.h_refresh_embeddingcolumns_),
-          *refreshspace_handler.h_length_, refreshspace_handler.h_refresh_emb_vec_, model_name, i);
-      HCTR_LIB_THROW(cudaMemcpyAsync(
-          refreshspace_handler.d_refresh_emb_vec_, refreshspace_handler.h_refresh_emb_vec_,
-          *refreshspace_handler.h_length_ * cache_config.embedding_vec_size_[i] * sizeof(float),
-          cudaMemcpyHostToDevice, streams[i]));
-      HCTR_LIB_THROW(cudaStreamSynchronize(streams[i]));
-      timer.stop();
-      HCTR_LOG_S(TRACE, ROOT) << "Parameter Server looking up the number of "
-                              << *refreshspace_handler.h_length_
-                              << " keys takes: " << timer.elapsedSeconds() << "s" << std::endl;
-      timer.start();
-      embedding_cache->refresh(
-          static_cast<int>(i), refreshspace_handler.d_refresh_embeddingcolumns_,
-          refreshspace_handler.d_refresh_emb_vec_, *refreshspace_handler.h_length_, streams[i]);
-      timer.stop();
-      HCTR_LOG_S(TRACE, ROOT) << "Embedding Cache refreshing the number of "
-                              << *refreshspace_handler.h_length_
-                              << " keys takes: " << timer.elapsedSeconds() << "s" << std::endl;
-      HCTR_LIB_THROW(cudaStreamSynchronize(streams[i]));
+
+  if (updated_keys_only) {
+    // Look up only the keys that the update source delivered since the last refresh. The cache
+    // skips the keys that it does not hold.
+    const size_t chunk_size = refresh_chunk_size(cache_config);
+    for (size_t i = 0; i < cache_config.num_emb_table_ && !out_of_time(); i++) {
+      std::vector<TypeHashKey> keys;
+      {
+        const std::lock_guard<std::mutex> lock(refresh_state_mutex_);
+        auto& pending = updated_keys_[model_name][device_id];
+        if (i < pending.size()) {
+          keys.assign(pending[i].begin(), pending[i].end());
+          pending[i].clear();
+        }
+      }
+      if (keys.empty()) {
+        continue;
+      }
+
+      size_t offset = 0;
+      for (; offset < keys.size() && !out_of_time(); offset += chunk_size) {
+        const size_t length = std::min(chunk_size, keys.size() - offset);
+        TypeHashKey* const h_keys =
+            reinterpret_cast<TypeHashKey*>(refreshspace_handler.h_refresh_embeddingcolumns_);
+        std::copy_n(&keys[offset], length, h_keys);
+        this->lookup(h_keys, length, refreshspace_handler.h_refresh_emb_vec_, model_name, i);
+        HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace_handler.d_refresh_embeddingcolumns_, h_keys,
+                                       length * sizeof(TypeHashKey), cudaMemcpyHostToDevice,
+                                       streams[i]));
+        HCTR_LIB_THROW(cudaMemcpyAsync(
+            refreshspace_handler.d_refresh_emb_vec_, refreshspace_handler.h_refresh_emb_vec_,
+            length * cache_config.embedding_vec_size_[i] * sizeof(float), cudaMemcpyHostToDevice,
+            streams[i]));
+        embedding_cache->refresh(static_cast<int>(i),
+                                 refreshspace_handler.d_refresh_embeddingcolumns_,
+                                 refreshspace_handler.d_refresh_emb_vec_, length, streams[i]);
+        HCTR_LIB_THROW(cudaStreamSynchronize(streams[i]));
+        made_progress = true;
+      }
+      embedding_cache->refresh_hot_keys(i, streams[i]);
+
+      // Hand the keys that are left to the next refresh.
+      if (offset < keys.size()) {
+        const std::lock_guard<std::mutex> lock(refresh_state_mutex_);
+        updated_keys_[model_name][device_id][i].insert(keys.begin() + offset, keys.end());
+      }
+    }
+  } else {
+    // Continue where the previous refresh ran out of time.
+    RefreshCursor cursor;
+    {
+      const std::lock_guard<std::mutex> lock(refresh_state_mutex_);
+      cursor = refresh_cursors_[model_name][device_id];
+    }
+    if (cursor.table_id >= cache_config.num_emb_table_) {
+      cursor = {};
+    }
+
+    // Refresh the embedding cache for each table
+    const size_t stride_set = cache_config.num_set_in_refresh_workspace_;
+    HugeCTR::Timer timer;
+    bool interrupted = false;
+    for (size_t i = cursor.table_id; i < cache_config.num_emb_table_ && !interrupted; i++) {
+      size_t idx_set = (i == cursor.table_id) ? cursor.set_index : 0;
+      for (; idx_set < cache_config.num_set_in_cache_[i]; idx_set += stride_set) {
+        if (out_of_time()) {
+          cursor = {i, idx_set};
+          interrupted = true;
+          break;
+        }
+        const size_t end_idx = (idx_set + stride_set > cache_config.num_set_in_cache_[i])
+                                   ? cache_config.num_set_in_cache_[i]
+                                   : idx_set + stride_set;
+        timer.start();
+        embedding_cache->dump(i, refreshspace_handler.d_refresh_embeddingcolumns_,
+                              refreshspace_handler.d_length_, idx_set, end_idx, streams[i]);
+
+        HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace_handler.h_length_,
+                                       refreshspace_handler.d_length_, sizeof(size_t),
+                                       cudaMemcpyDeviceToHost, streams[i]));
+        HCTR_LIB_THROW(cudaStreamSynchronize(streams[i]));
+        HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace_handler.h_refresh_embeddingcolumns_,
+                                       refreshspace_handler.d_refresh_embeddingcolumns_,
+                                       *refreshspace_handler.h_length_ * sizeof(TypeHashKey),
+                                       cudaMemcpyDeviceToHost, streams[i]));
+        HCTR_LIB_THROW(cudaStreamSynchronize(streams[i]));
+        timer.stop();
+        HCTR_LOG_S(TRACE, ROOT) << "Embedding Cache dumping the number of " << stride_set
+                                << " sets takes: " << timer.elapsedSeconds() << "s" << std::endl;
+        timer.start();
+        this->lookup(
+            reinterpret_cast<const TypeHashKey*>(refreshspace_handler.h_refresh_embeddingcolumns_),
+            *refreshspace_handler.h_length_, refreshspace_handler.h_refresh_emb_vec_, model_name,
+            i);
+        HCTR_LIB_THROW(cudaMemcpyAsync(
+            refreshspace_handler.d_refresh_emb_vec_, refreshspace_handler.h_refresh_emb_vec_,
+            *refreshspace_handler.h_length_ * cache_config.embedding_vec_size_[i] * sizeof(float),
+            cudaMemcpyHostToDevice, streams[i]));
+        HCTR_LIB_THROW(cudaStreamSynchronize(streams[i]));
+        timer.stop();
+        HCTR_LOG_S(TRACE, ROOT) << "Parameter Server looking up the number of "
+                                << *refreshspace_handler.h_length_
+                                << " keys takes: " << timer.elapsedSeconds() << "s" << std::endl;
+        timer.start();
+        embedding_cache->refresh(
+            static_cast<int>(i), refreshspace_handler.d_refresh_embeddingcolumns_,
+            refreshspace_handler.d_refresh_emb_vec_, *refreshspace_handler.h_length_, streams[i]);
+        timer.stop();
+        HCTR_LOG_S(TRACE, ROOT) << "Embedding Cache refreshing the number of "
+                                << *refreshspace_handler.h_length_
+                                << " keys takes: " << timer.elapsedSeconds() << "s" << std::endl;
+        HCTR_LIB_THROW(cudaStreamSynchronize(streams[i]));
+        made_progress = true;
+      }
+      // A table is only complete once all of its sets have been refreshed.
+      if (!interrupted) {
+        embedding_cache->refresh_hot_keys(i, streams[i]);
+        embedding_cache->finish_refresh(i, streams[i]);
+      }
+    }
+    if (!interrupted) {
+      cursor = {};
     }
+
+    const std::lock_guard<std::mutex> lock(refresh_state_mutex_);
+    refresh_cursors_[model_name][device_id] = cursor;
   }
   // apply the memory block for embedding cache refresh workspace
   this->free_buffer(memory_block);
@@ -959,11 +1945,31 @@ void HierParameterServer<TypeHashKey>::insert_embedding_cache(
                       workspace_handler.h_missing_length_[table_id] * sizeof(TypeHashKey),
                       cudaMemcpyDeviceToHost, stream));
 
-  // Query the missing embeddingcolumns from Parameter Server
+  // Query the missing embeddingcolumns from Parameter Server. Keys that are already being fetched
+  // on behalf of another stream are awaited instead of being fetched again.
+  std::shared_ptr<MissCoalescer<TypeHashKey>> miss_coalescer;
+  {
+    const std::lock_guard<std::mutex> lock(model_cache_map_mutex_);
+    const auto it = miss_coalescers_.find(cache_config.model_name_);
+    if (it != miss_coalescers_.end() && table_id < it->second.size()) {
+      miss_coalescer = it->second[table_id];
+    }
+  }
   HCTR_LIB_THROW(cudaStreamSynchronize(stream));
-  this->lookup(workspace_handler.h_missing_embeddingcolumns_[table_id],
-               workspace_handler.h_missing_length_[table_id],
-               workspace_handler.h_missing_emb_vec_[table_id], cache_config.model_name_, table_id);
+  if (miss_coalescer) {
+    miss_coalescer->fetch(
+        static_cast<const TypeHashKey*>(workspace_handler.h_missing_embeddingcolumns_[table_id]),
+        workspace_handler.h_missing_length_[table_id], cache_config.embedding_vec_size_[table_id],
+        workspace_handler.h_missing_emb_vec_[table_id],
+        [&](const TypeHashKey* const keys, const size_t num_keys, float* const vectors) {
+          this->lookup(keys, num_keys, vectors, cache_config.model_name_, table_id);
+        });
+  } else {
+    this->lookup(workspace_handler.h_missing_embeddingcolumns_[table_id],
+                 workspace_handler.h_missing_length_[table_id],
+                 workspace_handler.h_missing_emb_vec_[table_id], cache_config.model_name_,
+                 table_id);
+  }
 
   // Copy missing emb_vec to device
 
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <hps/hit_rate_threshold_controller.hpp>
+
+namespace HugeCTR {
+
+HitRateThresholdController::HitRateThresholdController(const float initial_threshold,
+                                                       const double latency_budget_us,
+                                                       const size_t window,
+                                                       const size_t update_interval)
+    : latency_budget_us_{latency_budget_us},
+      window_{std::max<size_t>(window, 1)},
+      update_interval_{std::max<size_t>(update_interval, 1)},
+      threshold_{initial_threshold} {
+  samples_.reserve(window_);
+}
+
+void HitRateThresholdController::record_lookup(const double hit_rate,
+                                               const size_t num_missing_keys) {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  if (samples_.size() < window_) {
+    samples_.push_back({hit_rate, num_missing_keys});
+  } else {
+    samples_[next_sample_] = {hit_rate, num_missing_keys};
+  }
+  next_sample_ = (next_sample_ + 1) % window_;
+
+  if (++num_lookups_since_update_ >= update_interval_) {
+    num_lookups_since_update_ = 0;
+    update_threshold();
+  }
+}
+
+void HitRateThresholdController::record_insert(const size_t num_keys, const double elapsed_us) {
+  if (num_keys == 0) {
+    return;
+  }
+  const double cost_per_key_us{elapsed_us / static_cast<double>(num_keys)};
+
+  const std::lock_guard<std::mutex> lock(mutex_);
+  if (has_cost_) {
+    cost_per_key_us_ += cost_smoothing_ * (cost_per_key_us - cost_per_key_us_);
+  } else {
+    cost_per_key_us_ = cost_per_key_us;
+    has_cost_ = true;
+  }
+}
+
+void HitRateThresholdController::update_threshold() {
+  if (!has_cost_ || samples_.empty()) {
+    return;
+  }
+
+  // Lookups block in order of increasing hit rate as the threshold grows. Hence, admit the worst
+  // lookups until the summed insert cost would exceed the budget for the entire window.
+  std::vector<Sample> samples{samples_};
+  std::sort(samples.begin(), samples.end(),
+            [](const Sample& a, const Sample& b) { return a.hit_rate < b.hit_rate; });
+
+  const double budget_us{latency_budget_us_ * static_cast<double>(samples.size())};
+  double cost_us{0};
+  float threshold{0};
+  for (const Sample& sample : samples) {
+    cost_us += static_cast<double>(sample.num_missing_keys) * cost_per_key_us_;
+    if (cost_us > budget_us) {
+      break;
+    }
+    // Lookups with this hit rate are below the threshold.
+    threshold = std::nextafter(static_cast<float>(sample.hit_rate), 2.f);
+  }
+  threshold_.store(threshold, std::memory_order_relaxed);
+}
+
+}  // namespace HugeCTR
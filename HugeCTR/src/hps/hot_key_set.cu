@@ -0,0 +1,385 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <common.hpp>
+#include <hps/hot_key_set.hpp>
+
+namespace HugeCTR {
+
+// MurmurHash3 64-bit finalizer.
+static __host__ __device__ __forceinline__ uint64_t hot_key_mix(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+static size_t next_pow2(const size_t n) {
+  size_t p{1};
+  while (p < n) {
+    p <<= 1;
+  }
+  return p;
+}
+
+CountMinSketch::CountMinSketch(const size_t width, const size_t depth)
+    : width_{next_pow2(std::max<size_t>(width, 64))}, depth_{depth}, counters_(width_ * depth_) {
+  HCTR_CHECK(depth_ > 0);
+}
+
+uint32_t CountMinSketch::add(const uint64_t key) {
+  const uint64_t h1{hot_key_mix(key)};
+  const uint64_t h2{hot_key_mix(h1 ^ 0x9e3779b97f4a7c15ULL) | 1};
+
+  uint32_t estimate{UINT32_MAX};
+  for (size_t d = 0; d < depth_; ++d) {
+    uint32_t& counter{counters_[d * width_ + ((h1 + d * h2) & (width_ - 1))]};
+    if (counter != UINT32_MAX) {
+      ++counter;
+    }
+    estimate = std::min(estimate, counter);
+  }
+
+  // Age the sketch, so that formerly popular keys eventually make way for new ones.
+  if (++num_updates_ >= 10 * width_) {
+    for (uint32_t& counter : counters_) {
+      counter >>= 1;
+    }
+    num_updates_ = 0;
+    aged_ = true;
+  }
+  return estimate;
+}
+
+bool CountMinSketch::aged() {
+  const bool aged{aged_};
+  aged_ = false;
+  return aged;
+}
+
+template <typename Key>
+__device__ __forceinline__ uint32_t hot_key_find(const Key* const d_bucket_keys,
+                                                 const uint32_t* const d_bucket_slots,
+                                                 const size_t num_buckets, const Key key) {
+  size_t bucket = hot_key_mix(static_cast<uint64_t>(key)) & (num_buckets - 1);
+  for (uint32_t slot; (slot = d_bucket_slots[bucket]) != UINT32_MAX;
+       bucket = (bucket + 1) & (num_buckets - 1)) {
+    if (d_bucket_keys[bucket] == key) {
+      return slot;
+    }
+  }
+  return UINT32_MAX;
+}
+
+__global__ void hot_key_set_promote(const float* const d_src_vectors,
+                                    const uint32_t* const d_promotions, const size_t len,
+                                    float* const d_vectors, const size_t emb_vec_size) {
+  const size_t idx = blockIdx.x * blockDim.x + threadIdx.x;
+  if (idx < (len * emb_vec_size)) {
+    const size_t promotion = idx / emb_vec_size;
+    const size_t dst_float = idx % emb_vec_size;
+    const size_t src_emb_vec = d_promotions[promotion * 2];
+    const size_t dst_emb_vec = d_promotions[promotion * 2 + 1];
+    d_vectors[dst_emb_vec * emb_vec_size + dst_float] =
+        d_src_vectors[src_emb_vec * emb_vec_size + dst_float];
+  }
+}
+
+template <typename Key>
+__global__ void hot_key_set_compact(const Key* const d_bucket_keys,
+                                    const uint32_t* const d_bucket_slots, const size_t num_buckets,
+                                    const float* const d_vectors, const size_t emb_vec_size,
+                                    const Key* const d_missing_keys,
+                                    const uint64_t* const d_missing_index, const size_t len,
+                                    float* const d_hit_emb_vec, Key* const d_remaining_keys,
+                                    uint64_t* const d_remaining_index,
+                                    size_t* const d_remaining_length) {
+  const size_t idx = blockIdx.x * blockDim.x + threadIdx.x;
+  if (idx < len) {
+    const Key key = d_missing_keys[idx];
+    const uint32_t slot = hot_key_find(d_bucket_keys, d_bucket_slots, num_buckets, key);
+    const uint64_t dst_emb_vec = d_missing_index[idx];
+    if (slot == UINT32_MAX) {
+      const size_t pos = atomicAdd(reinterpret_cast<unsigned long long*>(d_remaining_length), 1ULL);
+      d_remaining_keys[pos] = key;
+      d_remaining_index[pos] = dst_emb_vec;
+    } else {
+      const float* const src = &d_vectors[slot * emb_vec_size];
+      float* const dst = &d_hit_emb_vec[dst_emb_vec * emb_vec_size];
+      for (size_t i = 0; i < emb_vec_size; ++i) {
+        dst[i] = src[i];
+      }
+    }
+  }
+}
+
+template <typename Key>
+__global__ void hot_key_set_refresh(const Key* const d_bucket_keys,
+                                    const uint32_t* const d_bucket_slots, const size_t num_buckets,
+                                    float* const d_vectors, const size_t emb_vec_size,
+                                    const Key* const d_keys, const float* const d_src_vectors,
+                                    const size_t len) {
+  const size_t idx = blockIdx.x * blockDim.x + threadIdx.x;
+  if (idx < len) {
+    const uint32_t slot = hot_key_find(d_bucket_keys, d_bucket_slots, num_buckets, d_keys[idx]);
+    if (slot != UINT32_MAX) {
+      const float* const src = &d_src_vectors[idx * emb_vec_size];
+      float* const dst = &d_vectors[slot * emb_vec_size];
+      for (size_t i = 0; i < emb_vec_size; ++i) {
+        dst[i] = src[i];
+      }
+    }
+  }
+}
+
+template <typename Key>
+HotKeySet<Key>::HotKeySet(const size_t capacity, const size_t emb_vec_size,
+                          const size_t max_query_length)
+    : capacity_{capacity},
+      emb_vec_size_{emb_vec_size},
+      max_query_length_{max_query_length},
+      sketch_{capacity * 64, 4},
+      num_buckets_{next_pow2(capacity * 2)},
+      h_bucket_keys_(num_buckets_),
+      h_bucket_slots_(num_buckets_, empty_slot_) {
+  HCTR_CHECK(capacity_ > 0 && capacity_ < empty_slot_);
+
+  resident_.reserve(capacity_);
+  free_slots_.reserve(capacity_);
+  for (size_t i = capacity_; i--;) {
+    free_slots_.emplace_back(static_cast<uint32_t>(i));
+  }
+
+  HCTR_LIB_THROW(cudaMalloc(&d_bucket_keys_, num_buckets_ * sizeof(Key)));
+  HCTR_LIB_THROW(cudaMalloc(&d_bucket_slots_, num_buckets_ * sizeof(uint32_t)));
+  HCTR_LIB_THROW(cudaMemcpy(d_bucket_slots_, h_bucket_slots_.data(),
+                            num_buckets_ * sizeof(uint32_t), cudaMemcpyHostToDevice));
+  HCTR_LIB_THROW(cudaMalloc(&d_vectors_, capacity_ * emb_vec_size_ * sizeof(float)));
+  HCTR_LIB_THROW(cudaMalloc(&d_promotions_, capacity_ * 2 * sizeof(uint32_t)));
+  HCTR_LIB_THROW(cudaMalloc(&d_staging_keys_, capacity_ * sizeof(Key)));
+  HCTR_LIB_THROW(cudaMalloc(&d_staging_vectors_, capacity_ * emb_vec_size_ * sizeof(float)));
+
+  const size_t scratch_length{std::max<size_t>(max_query_length_, 1)};
+  HCTR_LIB_THROW(cudaMalloc(&d_remaining_keys_, scratch_length * sizeof(Key)));
+  HCTR_LIB_THROW(cudaMalloc(&d_remaining_index_, scratch_length * sizeof(uint64_t)));
+  HCTR_LIB_THROW(cudaMalloc(&d_remaining_length_, sizeof(size_t)));
+  HCTR_LIB_THROW(cudaMallocHost(&h_remaining_length_, sizeof(size_t)));
+}
+
+template <typename Key>
+HotKeySet<Key>::~HotKeySet() {
+  cudaFreeHost(h_remaining_length_);
+  cudaFree(d_remaining_length_);
+  cudaFree(d_remaining_index_);
+  cudaFree(d_remaining_keys_);
+
+  cudaFree(d_staging_vectors_);
+  cudaFree(d_staging_keys_);
+  cudaFree(d_promotions_);
+  cudaFree(d_vectors_);
+  cudaFree(d_bucket_slots_);
+  cudaFree(d_bucket_keys_);
+}
+
+template <typename Key>
+size_t HotKeySet<Key>::size() const {
+  const std::lock_guard<std::mutex> lock(record_mutex_);
+  return resident_.size();
+}
+
+template <typename Key>
+std::vector<Key> HotKeySet<Key>::keys() const {
+  const std::lock_guard<std::mutex> lock(record_mutex_);
+  std::vector<Key> keys;
+  keys.reserve(resident_.size());
+  for (const auto& entry : resident_) {
+    keys.emplace_back(entry.first);
+  }
+  return keys;
+}
+
+template <typename Key>
+void HotKeySet<Key>::record(const Key* const h_keys, const float* const d_vectors,
+                            const size_t num_keys, cudaStream_t stream) {
+  const std::lock_guard<std::mutex> lock(record_mutex_);
+
+  // slot -> index of the source vector in `d_vectors`
+  std::unordered_map<uint32_t, uint32_t> promotions;
+  for (size_t i = 0; i < num_keys; ++i) {
+    const Key& key{h_keys[i]};
+    const uint32_t count{sketch_.add(static_cast<uint64_t>(key))};
+    if (sketch_.aged()) {
+      for (auto& entry : resident_) {
+        entry.second.count >>= 1;
+      }
+      min_count_ >>= 1;
+    }
+
+    const auto it{resident_.find(key)};
+    if (it != resident_.end()) {
+      it->second.count = std::max(it->second.count, count);
+      continue;
+    }
+    if (count < promotion_threshold_) {
+      continue;
+    }
+
+    uint32_t slot;
+    if (!free_slots_.empty()) {
+      slot = free_slots_.back();
+      free_slots_.pop_back();
+      min_count_ = resident_.empty() ? count : std::min(min_count_, count);
+    } else {
+      if (count <= min_count_) {
+        continue;
+      }
+      // Evict the coldest resident key.
+      auto victim{resident_.begin()};
+      for (auto candidate = resident_.begin(); candidate != resident_.end(); ++candidate) {
+        if (candidate->second.count < victim->second.count) {
+          victim = candidate;
+        }
+      }
+      if (victim->second.count >= count) {
+        min_count_ = victim->second.count;
+        continue;
+      }
+      slot = victim->second.slot;
+      resident_.erase(victim);
+
+      min_count_ = count;
+      for (const auto& entry : resident_) {
+        min_count_ = std::min(min_count_, entry.second.count);
+      }
+    }
+    resident_.emplace(key, Entry{count, slot});
+    promotions[slot] = static_cast<uint32_t>(i);
+  }
+  if (promotions.empty()) {
+    return;
+  }
+
+  std::vector<uint32_t> h_promotions;
+  h_promotions.reserve(promotions.size() * 2);
+  for (const auto& promotion : promotions) {
+    h_promotions.emplace_back(promotion.second);
+    h_promotions.emplace_back(promotion.first);
+  }
+
+  std::fill(h_bucket_slots_.begin(), h_bucket_slots_.end(), empty_slot_);
+  for (const auto& entry : resident_) {
+    size_t bucket = hot_key_mix(static_cast<uint64_t>(entry.first)) & (num_buckets_ - 1);
+    while (h_bucket_slots_[bucket] != empty_slot_) {
+      bucket = (bucket + 1) & (num_buckets_ - 1);
+    }
+    h_bucket_keys_[bucket] = entry.first;
+    h_bucket_slots_[bucket] = entry.second.slot;
+  }
+
+  // Slots of evicted keys are reused. Hence, lookups must not overlap this update.
+  const std::unique_lock<std::shared_mutex> device_lock(device_mutex_);
+  HCTR_LIB_THROW(cudaMemcpyAsync(d_promotions_, h_promotions.data(),
+                                 h_promotions.size() * sizeof(uint32_t), cudaMemcpyHostToDevice,
+                                 stream));
+  const size_t promotions_in_float{promotions.size() * emb_vec_size_};
+  hot_key_set_promote<<<(promotions_in_float - 1) / block_size_ + 1, block_size_, 0, stream>>>(
+      d_vectors, d_promotions_, promotions.size(), d_vectors_, emb_vec_size_);
+  HCTR_LIB_THROW(cudaMemcpyAsync(d_bucket_keys_, h_bucket_keys_.data(), num_buckets_ * sizeof(Key),
+                                 cudaMemcpyHostToDevice, stream));
+  HCTR_LIB_THROW(cudaMemcpyAsync(d_bucket_slots_, h_bucket_slots_.data(),
+                                 num_buckets_ * sizeof(uint32_t), cudaMemcpyHostToDevice, stream));
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+}
+
+template <typename Key>
+size_t HotKeySet<Key>::filter_missing(Key* const d_missing_keys, uint64_t* const d_missing_index,
+                                      const size_t missing_length, float* const d_hit_emb_vec,
+                                      cudaStream_t stream) {
+  if (missing_length == 0 || size() == 0) {
+    return missing_length;
+  }
+  HCTR_CHECK(missing_length <= max_query_length_);
+
+  const std::lock_guard<std::mutex> lock(filter_mutex_);
+  {
+    const std::shared_lock<std::shared_mutex> device_lock(device_mutex_);
+    HCTR_LIB_THROW(cudaMemsetAsync(d_remaining_length_, 0, sizeof(size_t), stream));
+    hot_key_set_compact<<<(missing_length - 1) / block_size_ + 1, block_size_, 0, stream>>>(
+        d_bucket_keys_, d_bucket_slots_, num_buckets_, d_vectors_, emb_vec_size_, d_missing_keys,
+        d_missing_index, missing_length, d_hit_emb_vec, d_remaining_keys_, d_remaining_index_,
+        d_remaining_length_);
+    HCTR_LIB_THROW(cudaMemcpyAsync(h_remaining_length_, d_remaining_length_, sizeof(size_t),
+                                   cudaMemcpyDeviceToHost, stream));
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  }
+
+  const size_t remaining_length = *h_remaining_length_;
+  if (remaining_length != missing_length) {
+    HCTR_LIB_THROW(cudaMemcpyAsync(d_missing_keys, d_remaining_keys_,
+                                   remaining_length * sizeof(Key), cudaMemcpyDeviceToDevice,
+                                   stream));
+    HCTR_LIB_THROW(cudaMemcpyAsync(d_missing_index, d_remaining_index_,
+                                   remaining_length * sizeof(uint64_t), cudaMemcpyDeviceToDevice,
+                                   stream));
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  }
+  return remaining_length;
+}
+
+template <typename Key>
+void HotKeySet<Key>::refresh(const Key* const d_keys, const float* const d_vectors,
+                             const size_t length, cudaStream_t stream) {
+  if (length == 0 || size() == 0) {
+    return;
+  }
+
+  const std::unique_lock<std::shared_mutex> device_lock(device_mutex_);
+  hot_key_set_refresh<<<(length - 1) / block_size_ + 1, block_size_, 0, stream>>>(
+      d_bucket_keys_, d_bucket_slots_, num_buckets_, d_vectors_, emb_vec_size_, d_keys, d_vectors,
+      length);
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+}
+
+template <typename Key>
+void HotKeySet<Key>::refresh_from_host(const Key* const h_keys, const float* const h_vectors,
+                                       const size_t length, cudaStream_t stream) {
+  HCTR_CHECK(length <= capacity_);
+  if (length == 0) {
+    return;
+  }
+
+  // The staging buffers are shared with concurrent refreshes.
+  const std::lock_guard<std::mutex> lock(record_mutex_);
+  HCTR_LIB_THROW(cudaMemcpyAsync(d_staging_keys_, h_keys, length * sizeof(Key),
+                                 cudaMemcpyHostToDevice, stream));
+  HCTR_LIB_THROW(cudaMemcpyAsync(d_staging_vectors_, h_vectors,
+                                 length * emb_vec_size_ * sizeof(float), cudaMemcpyHostToDevice,
+                                 stream));
+
+  const std::unique_lock<std::shared_mutex> device_lock(device_mutex_);
+  hot_key_set_refresh<<<(length - 1) / block_size_ + 1, block_size_, 0, stream>>>(
+      d_bucket_keys_, d_bucket_slots_, num_buckets_, d_vectors_, emb_vec_size_, d_staging_keys_,
+      d_staging_vectors_, length);
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+}
+
+template class HotKeySet<unsigned int>;
+template class HotKeySet<long long>;
+
+}  // namespace HugeCTR
@@ -90,18 +90,19 @@ DataType toScalarType(const DLDataType& dtype) {
 }
 
 HPSTensor fromDLPack(const DLManagedTensor* src) {
-  HPSTensor* hpstensor(new HPSTensor);
+  HPSTensor hpstensor;
   DeviceType device = getATenDevice(src->dl_tensor.device);
   DataType stype = toScalarType(src->dl_tensor.dtype);
-  hpstensor->data = src->dl_tensor.data;
-  hpstensor->device = device;
-  hpstensor->type = stype;
-  hpstensor->device_id = src->dl_tensor.device.device_id;
-  hpstensor->strides = src->dl_tensor.strides;
-  hpstensor->shape = src->dl_tensor.shape;
-  hpstensor->ndim = src->dl_tensor.ndim;
+  hpstensor.data = src->dl_tensor.data;
+  hpstensor.device = device;
+  hpstensor.type = stype;
+  hpstensor.device_id = src->dl_tensor.device.device_id;
+  hpstensor.strides = src->dl_tensor.strides;
+  hpstensor.shape = src->dl_tensor.shape;
+  hpstensor.ndim = src->dl_tensor.ndim;
+  hpstensor.byte_offset = src->dl_tensor.byte_offset;
 
-  return *hpstensor;
+  return hpstensor;
 }
 
 }  // namespace HugeCTR
\ No newline at end of file
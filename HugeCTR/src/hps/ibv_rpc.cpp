@@ -0,0 +1,517 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef HCTR_USE_RDMA
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <common.hpp>
+#include <core23/logger.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <hps/ibv_rpc.hpp>
+
+namespace HugeCTR {
+
+namespace {
+
+constexpr size_t kBufferAlignment = 4096;
+
+std::pair<std::string, std::string> split_address(const std::string& address) {
+  const size_t colon{address.rfind(':')};
+  HCTR_THROW_IF(colon == std::string::npos, Error_t::WrongInput, "Host '", address,
+                "' has no port, expected host:port.");
+  return {address.substr(0, colon), address.substr(colon + 1)};
+}
+
+void send_all(const int fd, const void* const data, const size_t size) {
+  for (size_t sent{0}; sent < size;) {
+    const ssize_t n{send(fd, static_cast<const char*>(data) + sent, size - sent, MSG_NOSIGNAL)};
+    HCTR_THROW_IF(n <= 0, Error_t::UnspecificError, "Lost the connection: ", strerror(errno));
+    sent += static_cast<size_t>(n);
+  }
+}
+
+void recv_all(const int fd, void* const data, const size_t size) {
+  for (size_t received{0}; received < size;) {
+    const ssize_t n{recv(fd, static_cast<char*>(data) + received, size - received, 0)};
+    HCTR_THROW_IF(n <= 0, Error_t::UnspecificError, "Lost the connection: ", strerror(errno));
+    received += static_cast<size_t>(n);
+  }
+}
+
+int listen_on(const std::string& port, const size_t backlog) {
+  addrinfo hints{};
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = AI_PASSIVE;
+  addrinfo* info;
+  HCTR_THROW_IF(getaddrinfo(nullptr, port.c_str(), &hints, &info) != 0, Error_t::WrongInput,
+                "Invalid port ", port, '.');
+  const int fd{socket(info->ai_family, info->ai_socktype, info->ai_protocol)};
+  const int yes{1};
+  const bool ok{fd >= 0 && setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes)) == 0 &&
+                bind(fd, info->ai_addr, info->ai_addrlen) == 0 &&
+                listen(fd, static_cast<int>(backlog)) == 0};
+  freeaddrinfo(info);
+  if (!ok) {
+    const int error{errno};
+    if (fd >= 0) {
+      close(fd);
+    }
+    HCTR_OWN_THROW(Error_t::UnspecificError,
+                   "Cannot listen on port " + port + ": " + strerror(error));
+  }
+  return fd;
+}
+
+// Retries until the peer listens, it may be started after this host.
+int connect_to(const std::string& address, const std::chrono::steady_clock::time_point deadline) {
+  const auto [host, port] = split_address(address);
+  addrinfo hints{};
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  while (true) {
+    addrinfo* info;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &info) == 0) {
+      const int fd{socket(info->ai_family, info->ai_socktype, info->ai_protocol)};
+      const bool ok{fd >= 0 && connect(fd, info->ai_addr, info->ai_addrlen) == 0};
+      freeaddrinfo(info);
+      if (ok) {
+        const int yes{1};
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        return fd;
+      }
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+    HCTR_THROW_IF(std::chrono::steady_clock::now() > deadline, Error_t::UnspecificError,
+                  "Cannot connect to ", address, '.');
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+}
+
+// Uses the same environment variables as the IbvProxy.
+uint8_t env_uint8(const char* const name) {
+  const char* const value{getenv(name)};
+  return value ? static_cast<uint8_t>(atoi(value)) : 0;
+}
+
+}  // namespace
+
+IbvRpcEndpoint::IbvRpcEndpoint(const std::vector<std::string>& hosts, const size_t rank,
+                               const std::string& ib_device, const uint8_t ib_port,
+                               const size_t message_size,
+                               const std::chrono::seconds connect_timeout, Handler handler)
+    : num_hosts_{hosts.size()},
+      rank_{rank},
+      ib_port_{ib_port},
+      message_size_{message_size},
+      handler_{std::move(handler)},
+      peers_{std::make_unique<Peer[]>(hosts.size())} {
+  HCTR_THROW_IF(rank_ >= num_hosts_, Error_t::WrongInput, "Rank ", rank_, " is not in the ",
+                num_hosts_, " hosts.");
+  open_device(ib_device);
+  server_send_cq_ = ibv_create_cq(context_, static_cast<int>(num_hosts_), nullptr, nullptr, 0);
+  server_recv_cq_ = ibv_create_cq(context_, static_cast<int>(num_hosts_), nullptr, nullptr, 0);
+  int listen_fd{-1};
+  try {
+    HCTR_THROW_IF(!server_send_cq_ || !server_recv_cq_, Error_t::UnspecificError,
+                  "Unable to create completion queue.");
+    listen_fd = listen_on(split_address(hosts[rank_]).second, num_hosts_);
+  } catch (...) {
+    release();
+    throw;
+  }
+
+  // The peers connect to this host while it connects to them.
+  const auto deadline{std::chrono::steady_clock::now() + connect_timeout};
+  std::exception_ptr accept_error;
+  std::thread acceptor([&]() {
+    try {
+      accept_peers(listen_fd, deadline);
+    } catch (...) {
+      accept_error = std::current_exception();
+    }
+  });
+
+  std::exception_ptr connect_error;
+  try {
+    for (size_t peer{0}; peer < num_hosts_; ++peer) {
+      if (peer == rank_) {
+        continue;
+      }
+      Peer& p{peers_[peer]};
+      p.client_cq = ibv_create_cq(context_, 2, nullptr, nullptr, 0);
+      HCTR_THROW_IF(!p.client_cq, Error_t::UnspecificError, "Unable to create completion queue.");
+      create_connection(p.client, p.client_cq, p.client_cq);
+
+      const int fd{connect_to(hosts[peer], deadline)};
+      QpInfo remote;
+      try {
+        const QpInfo local{local_qp_info(p.client)};
+        send_all(fd, &local, sizeof(local));
+        recv_all(fd, &remote, sizeof(remote));
+      } catch (...) {
+        close(fd);
+        throw;
+      }
+      close(fd);
+      connect_qp(p.client, remote);
+    }
+  } catch (...) {
+    connect_error = std::current_exception();
+  }
+  acceptor.join();
+  close(listen_fd);
+  if (connect_error || accept_error) {
+    release();
+    std::rethrow_exception(connect_error ? connect_error : accept_error);
+  }
+
+  server_thread_ = std::thread(&IbvRpcEndpoint::server_loop, this);
+  HCTR_LOG_S(INFO, WORLD) << "Connected to " << num_hosts_ - 1 << " hosts over " << ib_device
+                          << ':' << static_cast<int>(ib_port_) << '.' << std::endl;
+}
+
+IbvRpcEndpoint::~IbvRpcEndpoint() {
+  stop_ = true;
+  server_thread_.join();
+  release();
+}
+
+void IbvRpcEndpoint::post(const size_t peer, const size_t request_size) {
+  HCTR_CHECK(request_size <= message_size_);
+  Peer& p{peers_[peer]};
+  // The response may arrive before the completion of the send.
+  post_recv(p.client, peer);
+  post_send(p.client, request_size, peer);
+}
+
+const char* IbvRpcEndpoint::wait(const size_t peer, size_t* const response_size) {
+  Peer& p{peers_[peer]};
+  bool sent{false};
+  bool received{false};
+  while (!sent || !received) {
+    ibv_wc wc;
+    const int n{ibv_poll_cq(p.client_cq, 1, &wc)};
+    HCTR_THROW_IF(n < 0, Error_t::UnspecificError, "Unable to poll the completion queue.");
+    if (n == 0) {
+      continue;
+    }
+    HCTR_THROW_IF(wc.status != IBV_WC_SUCCESS, Error_t::UnspecificError, "Request to host ", peer,
+                  " failed: ", ibv_wc_status_str(wc.status), '.');
+    if (wc.opcode == IBV_WC_RECV) {
+      *response_size = wc.byte_len;
+      received = true;
+    } else {
+      sent = true;
+    }
+  }
+  return p.client.recv_buffer;
+}
+
+void IbvRpcEndpoint::open_device(const std::string& ib_device) {
+  int num_devices{0};
+  ibv_device** const devices{ibv_get_device_list(&num_devices)};
+  HCTR_THROW_IF(!devices, Error_t::UnspecificError, "Can't get ib device list.");
+
+  // Find the ibv device that matches the configured device name and open it.
+  for (int d{0}; d < num_devices; ++d) {
+    const char* const dev_name{ibv_get_device_name(devices[d])};
+    if (dev_name && ib_device == dev_name) {
+      context_ = ibv_open_device(devices[d]);
+      break;
+    }
+  }
+  ibv_free_device_list(devices);
+  HCTR_THROW_IF(!context_, Error_t::WrongInput, "Unable to open ib device ", ib_device, '.');
+
+  pd_ = ibv_alloc_pd(context_);
+  if (!pd_) {
+    ibv_close_device(context_);
+    HCTR_OWN_THROW(Error_t::UnspecificError,
+                   "Unable to alloc protection domain for dev " + ib_device + '.');
+  }
+}
+
+void IbvRpcEndpoint::create_connection(Connection& connection, ibv_cq* const send_cq,
+                                       ibv_cq* const recv_cq) {
+  ibv_qp_init_attr qp_init_attr;
+  memset(&qp_init_attr, 0, sizeof(ibv_qp_init_attr));
+  qp_init_attr.send_cq = send_cq;
+  qp_init_attr.recv_cq = recv_cq;
+  qp_init_attr.qp_type = IBV_QPT_RC;
+  qp_init_attr.cap.max_send_wr = 1;
+  qp_init_attr.cap.max_recv_wr = 1;
+  qp_init_attr.cap.max_send_sge = 1;
+  qp_init_attr.cap.max_recv_sge = 1;
+  qp_init_attr.cap.max_inline_data = 0;
+  connection.qp = ibv_create_qp(pd_, &qp_init_attr);
+  HCTR_THROW_IF(!connection.qp, Error_t::UnspecificError, "Unable to create qp.");
+
+  ibv_qp_attr qp_attr;
+  memset(&qp_attr, 0, sizeof(ibv_qp_attr));
+  qp_attr.qp_state = IBV_QPS_INIT;
+  qp_attr.pkey_index = 0;
+  qp_attr.port_num = ib_port_;
+  qp_attr.qp_access_flags = 0;
+  HCTR_THROW_IF(ibv_modify_qp(connection.qp, &qp_attr,
+                              IBV_QP_STATE | IBV_QP_PKEY_INDEX | IBV_QP_PORT |
+                                  IBV_QP_ACCESS_FLAGS) != 0,
+                Error_t::UnspecificError, "Unable to modify QP access attributes.");
+
+  for (char** buffer : {&connection.send_buffer, &connection.recv_buffer}) {
+    void* ptr;
+    HCTR_THROW_IF(posix_memalign(&ptr, kBufferAlignment, message_size_) != 0,
+                  Error_t::OutOfMemory, "Unable to allocate ", message_size_, " bytes.");
+    *buffer = static_cast<char*>(ptr);
+  }
+  connection.send_mr = ibv_reg_mr(pd_, connection.send_buffer, message_size_, 0);
+  connection.recv_mr =
+      ibv_reg_mr(pd_, connection.recv_buffer, message_size_, IBV_ACCESS_LOCAL_WRITE);
+  HCTR_THROW_IF(!connection.send_mr || !connection.recv_mr, Error_t::UnspecificError,
+                "Unable to register the message buffers.");
+}
+
+IbvRpcEndpoint::QpInfo IbvRpcEndpoint::local_qp_info(const Connection& connection) const {
+  ibv_port_attr port_attr;
+  HCTR_THROW_IF(ibv_query_port(context_, ib_port_, &port_attr) != 0, Error_t::UnspecificError,
+                "Unable to query port for port info.");
+
+  QpInfo info{};
+  info.rank = static_cast<uint32_t>(rank_);
+  info.ib_port = ib_port_;
+  info.lid = port_attr.lid;
+  info.qpn = connection.qp->qp_num;
+  info.mtu = port_attr.active_mtu;
+  if (port_attr.link_layer == IBV_LINK_LAYER_ETHERNET) {
+    ibv_gid gid;
+    HCTR_THROW_IF(ibv_query_gid(context_, ib_port_, env_uint8("HUGECTR_ROCE_GID"), &gid) != 0,
+                  Error_t::UnspecificError, "Unable to query gid info.");
+    info.spn = gid.global.subnet_prefix;
+    info.iid = gid.global.interface_id;
+    info.is_roce = 1;
+  }
+  return info;
+}
+
+void IbvRpcEndpoint::connect_qp(const Connection& connection, QpInfo remote) const {
+  const QpInfo local{local_qp_info(connection)};
+
+  // Move to RTR state, with the smaller MTU of both sides.
+  {
+    ibv_qp_attr qp_attr;
+    memset(&qp_attr, 0, sizeof(ibv_qp_attr));
+    qp_attr.qp_state = IBV_QPS_RTR;
+    qp_attr.path_mtu = std::min(remote.mtu, local.mtu);
+    qp_attr.dest_qp_num = remote.qpn;
+    qp_attr.rq_psn = 0;
+    qp_attr.max_dest_rd_atomic = 1;
+    qp_attr.min_rnr_timer = 12;
+    qp_attr.ah_attr.sl = 0;
+    qp_attr.ah_attr.src_path_bits = 0;
+    qp_attr.ah_attr.port_num = remote.ib_port;
+    qp_attr.ah_attr.dlid = static_cast<uint16_t>(remote.lid);
+    qp_attr.ah_attr.is_global = 0;
+    if (remote.is_roce == 1) {
+      qp_attr.ah_attr.is_global = 1;
+      qp_attr.ah_attr.grh.dgid.global.subnet_prefix = remote.spn;
+      qp_attr.ah_attr.grh.dgid.global.interface_id = remote.iid;
+      qp_attr.ah_attr.grh.flow_label = 0;
+      qp_attr.ah_attr.grh.sgid_index = env_uint8("HUGECTR_ROCE_GID");
+      qp_attr.ah_attr.grh.hop_limit = 255;
+      qp_attr.ah_attr.grh.traffic_class = env_uint8("HUGECTR_ROCE_TC");
+    }
+    HCTR_THROW_IF(ibv_modify_qp(connection.qp, &qp_attr,
+                                IBV_QP_STATE | IBV_QP_AV | IBV_QP_PATH_MTU | IBV_QP_DEST_QPN |
+                                    IBV_QP_RQ_PSN | IBV_QP_MAX_DEST_RD_ATOMIC |
+                                    IBV_QP_MIN_RNR_TIMER) != 0,
+                  Error_t::UnspecificError, "Modify QP failed RTR state.");
+  }
+
+  // Move to RTS state
+  {
+    ibv_qp_attr qp_attr;
+    memset(&qp_attr, 0, sizeof(ibv_qp_attr));
+    qp_attr.qp_state = IBV_QPS_RTS;
+    qp_attr.timeout = 14;
+    qp_attr.retry_cnt = 7;
+    qp_attr.rnr_retry = 7;
+    qp_attr.sq_psn = 0;
+    qp_attr.max_rd_atomic = 1;
+    HCTR_THROW_IF(ibv_modify_qp(connection.qp, &qp_attr,
+                                IBV_QP_STATE | IBV_QP_TIMEOUT | IBV_QP_RETRY_CNT |
+                                    IBV_QP_RNR_RETRY | IBV_QP_SQ_PSN |
+                                    IBV_QP_MAX_QP_RD_ATOMIC) != 0,
+                  Error_t::UnspecificError, "Modify QP failed RTS state.");
+  }
+}
+
+void IbvRpcEndpoint::post_recv(Connection& connection, const uint64_t wr_id) {
+  ibv_sge sge;
+  sge.addr = reinterpret_cast<uintptr_t>(connection.recv_buffer);
+  sge.length = static_cast<uint32_t>(message_size_);
+  sge.lkey = connection.recv_mr->lkey;
+
+  ibv_recv_wr wr;
+  memset(&wr, 0, sizeof(ibv_recv_wr));
+  wr.wr_id = wr_id;
+  wr.sg_list = &sge;
+  wr.num_sge = 1;
+  ibv_recv_wr* bad_wr;
+  HCTR_THROW_IF(ibv_post_recv(connection.qp, &wr, &bad_wr) != 0, Error_t::UnspecificError,
+                "ibv_post_recv failed.");
+}
+
+void IbvRpcEndpoint::post_send(Connection& connection, const size_t size, const uint64_t wr_id) {
+  ibv_sge sge;
+  sge.addr = reinterpret_cast<uintptr_t>(connection.send_buffer);
+  sge.length = static_cast<uint32_t>(size);
+  sge.lkey = connection.send_mr->lkey;
+
+  ibv_send_wr wr;
+  memset(&wr, 0, sizeof(ibv_send_wr));
+  wr.wr_id = wr_id;
+  wr.sg_list = &sge;
+  wr.num_sge = size ? 1 : 0;
+  wr.opcode = IBV_WR_SEND;
+  wr.send_flags = IBV_SEND_SIGNALED;
+  ibv_send_wr* bad_wr;
+  HCTR_THROW_IF(ibv_post_send(connection.qp, &wr, &bad_wr) != 0, Error_t::UnspecificError,
+                "ibv_post_send failed.");
+}
+
+void IbvRpcEndpoint::destroy_connection(Connection& connection) {
+  if (connection.qp) {
+    ibv_destroy_qp(connection.qp);
+  }
+  for (ibv_mr* mr : {connection.send_mr, connection.recv_mr}) {
+    if (mr) {
+      ibv_dereg_mr(mr);
+    }
+  }
+  free(connection.send_buffer);
+  free(connection.recv_buffer);
+  connection = Connection{};
+}
+
+void IbvRpcEndpoint::release() {
+  for (size_t peer{0}; peer < num_hosts_; ++peer) {
+    destroy_connection(peers_[peer].client);
+    destroy_connection(peers_[peer].server);
+    if (peers_[peer].client_cq) {
+      ibv_destroy_cq(peers_[peer].client_cq);
+    }
+  }
+  for (ibv_cq* cq : {server_send_cq_, server_recv_cq_}) {
+    if (cq) {
+      ibv_destroy_cq(cq);
+    }
+  }
+  ibv_dealloc_pd(pd_);
+  ibv_close_device(context_);
+}
+
+void IbvRpcEndpoint::accept_peers(const int listen_fd,
+                                  const std::chrono::steady_clock::time_point deadline) {
+  for (size_t num_accepted{0}; num_accepted < num_hosts_ - 1;) {
+    const auto timeout{std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now())};
+    HCTR_THROW_IF(timeout.count() <= 0, Error_t::UnspecificError, "Only ", num_accepted, " of ",
+                  num_hosts_ - 1, " hosts connected in time.");
+    pollfd pfd{listen_fd, POLLIN, 0};
+    if (poll(&pfd, 1, static_cast<int>(timeout.count())) <= 0) {
+      continue;
+    }
+    const int fd{accept(listen_fd, nullptr, nullptr)};
+    if (fd < 0) {
+      continue;
+    }
+    try {
+      QpInfo remote;
+      recv_all(fd, &remote, sizeof(remote));
+      HCTR_THROW_IF(remote.rank >= num_hosts_ || remote.rank == rank_ ||
+                        peers_[remote.rank].server.qp,
+                    Error_t::WrongInput, "Unexpected connection of host ", remote.rank, '.');
+      Connection& connection{peers_[remote.rank].server};
+      create_connection(connection, server_send_cq_, server_recv_cq_);
+      // Ready for the first request before the peer knows the QP.
+      post_recv(connection, remote.rank);
+      connect_qp(connection, remote);
+      const QpInfo local{local_qp_info(connection)};
+      send_all(fd, &local, sizeof(local));
+    } catch (...) {
+      close(fd);
+      throw;
+    }
+    close(fd);
+    ++num_accepted;
+  }
+}
+
+void IbvRpcEndpoint::server_loop() {
+  while (!stop_) {
+    ibv_wc wc;
+    const int n{ibv_poll_cq(server_recv_cq_, 1, &wc)};
+    if (n == 0) {
+      std::this_thread::yield();
+      continue;
+    }
+    if (n < 0 || wc.status != IBV_WC_SUCCESS) {
+      HCTR_LOG_S(ERROR, WORLD) << "Receiving a request failed: "
+                               << (n < 0 ? "poll error" : ibv_wc_status_str(wc.status))
+                               << std::endl;
+      continue;
+    }
+
+    const size_t peer{wc.wr_id};
+    Connection& connection{peers_[peer].server};
+    size_t response_size{0};
+    try {
+      response_size =
+          handler_(connection.recv_buffer, wc.byte_len, connection.send_buffer, message_size_);
+    } catch (const std::exception& error) {
+      HCTR_LOG_S(ERROR, WORLD) << "Request of host " << peer << " failed: " << error.what()
+                               << std::endl;
+    }
+    try {
+      // The peer sends the next request only after this response.
+      post_recv(connection, peer);
+      post_send(connection, response_size, peer);
+      int m{0};
+      while ((m = ibv_poll_cq(server_send_cq_, 1, &wc)) == 0) {
+      }
+      if (m < 0 || wc.status != IBV_WC_SUCCESS) {
+        HCTR_LOG_S(ERROR, WORLD) << "Responding to host " << peer << " failed." << std::endl;
+      }
+    } catch (const std::exception& error) {
+      HCTR_LOG_S(ERROR, WORLD) << error.what() << std::endl;
+    }
+  }
+}
+
+}  // namespace HugeCTR
+
+#endif  // HCTR_USE_RDMA
@@ -36,19 +36,28 @@ bool VolatileDatabaseParams::operator==(const VolatileDatabaseParams& p) const {
          // Backend specific.
          address == p.address && user_name == p.user_name && password == p.password &&
          num_partitions == p.num_partitions && allocation_rate == p.allocation_rate &&
+         value_page_size == p.value_page_size && numa_node == p.numa_node &&
          shared_memory_size == p.shared_memory_size && shared_memory_name == p.shared_memory_name &&
          shared_memory_auto_remove == p.shared_memory_auto_remove &&
-         num_node_connections == p.num_node_connections && max_batch_size == p.max_batch_size &&
+         shared_memory_numa_aware == p.shared_memory_numa_aware && host_rank == p.host_rank &&
+         ib_device == p.ib_device && ib_port == p.ib_port && message_size == p.message_size &&
+         connect_timeout == p.connect_timeout &&
+         num_node_connections == p.num_node_connections &&
+         max_pipeline_depth == p.max_pipeline_depth && max_batch_size == p.max_batch_size &&
          enable_tls == p.enable_tls && tls_ca_certificate == p.tls_ca_certificate &&
          tls_client_certificate == p.tls_client_certificate && tls_client_key == p.tls_client_key &&
          tls_server_name_identification == p.tls_server_name_identification &&
          // Overflow handling related.
          overflow_margin == p.overflow_margin && overflow_policy == p.overflow_policy &&
          overflow_resolution_target == p.overflow_resolution_target &&
+         // Value storage related.
+         value_format == p.value_format && table_value_formats == p.table_value_formats &&
          // Caching behavior related.
          initialize_after_startup == p.initialize_after_startup &&
          initial_cache_rate == p.initial_cache_rate &&
          cache_missed_embeddings == p.cache_missed_embeddings &&
+         near_cache_capacity == p.near_cache_capacity &&
+         near_cache_ttl_ms == p.near_cache_ttl_ms &&
          // Real-time update mechanism related.
          update_filters == p.update_filters;
 }
@@ -60,9 +69,10 @@ bool PersistentDatabaseParams::operator==(const PersistentDatabaseParams& p) con
   return type == p.type &&
          // Backend specific.
          path == p.path && num_threads == p.num_threads && read_only == p.read_only &&
-         max_batch_size == p.max_batch_size &&
+         max_batch_size == p.max_batch_size && block_cache_size == p.block_cache_size &&
+         bloom_filter_bits == p.bloom_filter_bits && use_direct_reads == p.use_direct_reads &&
          // Caching behavior related.
-         initialize_after_startup == p.initialize_after_startup &&
+         initialize_after_startup == p.initialize_after_startup && bulk_load == p.bulk_load &&
          // Real-time update mechanism related.
          update_filters == p.update_filters;
 }
@@ -76,7 +86,8 @@ bool UpdateSourceParams::operator==(const UpdateSourceParams& p) const {
          brokers == p.brokers && metadata_refresh_interval_ms == p.metadata_refresh_interval_ms &&
          receive_buffer_size == p.receive_buffer_size && poll_timeout_ms == p.poll_timeout_ms &&
          max_batch_size == p.max_batch_size && failure_backoff_ms == p.failure_backoff_ms &&
-         max_commit_interval == p.max_commit_interval;
+         max_commit_interval == p.max_commit_interval &&
+         update_embedding_cache == p.update_embedding_cache;
 }
 bool UpdateSourceParams::operator!=(const UpdateSourceParams& p) const { return !operator==(p); }
 
@@ -138,8 +149,12 @@ PersistentDatabaseParams::PersistentDatabaseParams(const DatabaseType_t type,
                                                    const std::string& path,
                                                    const size_t num_threads, const bool read_only,
                                                    const size_t max_batch_size,
+                                                   const size_t block_cache_size,
+                                                   const size_t bloom_filter_bits,
+                                                   const bool use_direct_reads,
                                                    // Caching behavior related.
                                                    const bool initialize_after_startup,
+                                                   const bool bulk_load,
                                                    // Real-time update mechanism related.
                                                    const std::vector<std::string>& update_filters)
     : type(type),
@@ -148,8 +163,12 @@ PersistentDatabaseParams::PersistentDatabaseParams(const DatabaseType_t type,
       num_threads(num_threads),
       read_only(read_only),
       max_batch_size(max_batch_size),
+      block_cache_size(block_cache_size),
+      bloom_filter_bits(bloom_filter_bits),
+      use_direct_reads(use_direct_reads),
       // Caching behavior related.
       initialize_after_startup{initialize_after_startup},
+      bulk_load{bulk_load},
       // Real-time update mechanism related.
       update_filters(update_filters) {}
 
@@ -160,7 +179,8 @@ UpdateSourceParams::UpdateSourceParams(const UpdateSourceType_t type,
                                        const size_t receive_buffer_size,
                                        const size_t poll_timeout_ms, const size_t max_batch_size,
                                        const size_t failure_backoff_ms,
-                                       const size_t max_commit_interval)
+                                       const size_t max_commit_interval,
+                                       const bool update_embedding_cache)
     : type(type),
       // Backend specific.
       brokers(brokers),
@@ -169,7 +189,8 @@ UpdateSourceParams::UpdateSourceParams(const UpdateSourceType_t type,
       poll_timeout_ms(poll_timeout_ms),
       max_batch_size(max_batch_size),
       failure_backoff_ms(failure_backoff_ms),
-      max_commit_interval(max_commit_interval) {}
+      max_commit_interval(max_commit_interval),
+      update_embedding_cache(update_embedding_cache) {}
 
 InferenceParams::InferenceParams(
     const std::string& model_name, const size_t max_batchsize, const float hit_rate_threshold,
@@ -193,7 +214,15 @@ InferenceParams::InferenceParams(
     const size_t label_dim, const size_t slot_num, const std::string& non_trainable_params_file,
     bool use_static_table, EmbeddingCacheType_t embedding_cache_type, bool use_context_stream,
     bool fuse_embedding_table, bool use_hctr_cache_implementation, bool init_ec,
-    bool enable_pagelock, bool fp8_quant)
+    bool enable_pagelock, bool fp8_quant, bool use_bloom_filter, size_t hot_key_set_size,
+    const std::vector<size_t>& set_associativity_per_table, bool shard_uvm_table,
+    size_t uvm_table_staging_buffers, float sync_insert_latency_budget_us,
+    const std::vector<AdmissionPolicy_t>& admission_policy_per_table,
+    const std::vector<float>& admission_threshold_per_table, bool use_capturable_lookup,
+    SharedCacheRole_t shared_cache_role, float refresh_time_budget_ms,
+    bool refresh_updated_keys_only, bool background_refresh, float lookup_batching_window_us,
+    size_t lookup_batching_max_keys, float cache_rebalance_percentage,
+    const std::string& key_log_warmup_file, const std::string& key_log_record_file)
     : model_name(model_name),
       max_batchsize(max_batchsize),
       hit_rate_threshold(hit_rate_threshold),
@@ -235,7 +264,25 @@ InferenceParams::InferenceParams(
       use_hctr_cache_implementation(use_hctr_cache_implementation),
       init_ec(init_ec),
       enable_pagelock(enable_pagelock),
-      fp8_quant(fp8_quant) {
+      fp8_quant(fp8_quant),
+      use_bloom_filter(use_bloom_filter),
+      hot_key_set_size(hot_key_set_size),
+      set_associativity_per_table(set_associativity_per_table),
+      shard_uvm_table(shard_uvm_table),
+      uvm_table_staging_buffers(uvm_table_staging_buffers),
+      sync_insert_latency_budget_us(sync_insert_latency_budget_us),
+      admission_policy_per_table(admission_policy_per_table),
+      admission_threshold_per_table(admission_threshold_per_table),
+      use_capturable_lookup(use_capturable_lookup),
+      shared_cache_role(shared_cache_role),
+      refresh_time_budget_ms(refresh_time_budget_ms),
+      refresh_updated_keys_only(refresh_updated_keys_only),
+      background_refresh(background_refresh),
+      lookup_batching_window_us(lookup_batching_window_us),
+      lookup_batching_max_keys(lookup_batching_max_keys),
+      cache_rebalance_percentage(cache_rebalance_percentage),
+      key_log_warmup_file(key_log_warmup_file),
+      key_log_record_file(key_log_record_file) {
   // this code path is only used by hps python interface!
   if (this->default_value_for_each_table.size() != this->sparse_model_files.size()) {
     HCTR_LOG(
@@ -283,6 +330,15 @@ void parameter_server_config::fuse_embedding_table_in_json_config(nlohmann::json
     auto maxnum_catfeature_query_per_table_per_sample =
         get_json(model, "maxnum_catfeature_query_per_table_per_sample");
     auto default_value_for_each_table = get_json(model, "default_value_for_each_table");
+    const bool has_set_associativity =
+        model.find("set_associativity_per_table") != model.end() &&
+        get_json(model, "set_associativity_per_table").size() == sparse_files.size();
+    const bool has_admission_policy =
+        model.find("admission_policy_per_table") != model.end() &&
+        get_json(model, "admission_policy_per_table").size() == sparse_files.size();
+    const bool has_admission_threshold =
+        model.find("admission_threshold_per_table") != model.end() &&
+        get_json(model, "admission_threshold_per_table").size() == sparse_files.size();
     auto number_of_worker_buffers_in_pool =
         get_value_from_json_soft<int>(model, "num_of_worker_buffer_in_pool", 1);
 
@@ -345,6 +401,47 @@ void parameter_server_config::fuse_embedding_table_in_json_config(nlohmann::json
       }
     }
 
+    // Fused tables use the highest associativity requested for any of their original tables.
+    std::vector<size_t> set_associativity_for_fused_tables;
+    if (has_set_associativity) {
+      auto set_associativity_per_table = get_json(model, "set_associativity_per_table");
+      for (size_t fused_id{0}; fused_id < num_fused_tables; ++fused_id) {
+        size_t set_associativity_for_current_fused_table{0};
+        for (auto id : fused_table_id_to_original_table_id_map[fused_id]) {
+          set_associativity_for_current_fused_table =
+              std::max(set_associativity_for_current_fused_table,
+                       set_associativity_per_table[id].get<size_t>());
+        }
+        set_associativity_for_fused_tables.emplace_back(set_associativity_for_current_fused_table);
+      }
+    }
+
+    // Fused tables use the admission settings of their first original table.
+    auto fuse_admission_setting = [&](const std::string& key) {
+      auto setting_per_table = get_json(model, key);
+      nlohmann::json setting_for_fused_tables = nlohmann::json::array();
+      for (size_t fused_id{0}; fused_id < num_fused_tables; ++fused_id) {
+        const auto& original_ids = fused_table_id_to_original_table_id_map[fused_id];
+        for (auto id : original_ids) {
+          if (setting_per_table[id] != setting_per_table[original_ids.front()]) {
+            HCTR_LOG(WARNING, ROOT, "Inconsistent %s for tables to be fused\n", key.c_str());
+            break;
+          }
+        }
+        setting_for_fused_tables.push_back(setting_per_table[original_ids.front()]);
+      }
+      return setting_for_fused_tables;
+    };
+    nlohmann::json admission_policy_for_fused_tables;
+    if (has_admission_policy) {
+      admission_policy_for_fused_tables = fuse_admission_setting("admission_policy_per_table");
+    }
+    nlohmann::json admission_threshold_for_fused_tables;
+    if (has_admission_threshold) {
+      admission_threshold_for_fused_tables =
+          fuse_admission_setting("admission_threshold_per_table");
+    }
+
     model["sparse_files"] = sparse_files_for_fused_tables;
     model["embedding_table_names"] = emb_table_names_for_fused_tables;
     model["embedding_vecsize_per_table"] = emb_vec_size_for_fused_tables;
@@ -355,6 +452,15 @@ void parameter_server_config::fuse_embedding_table_in_json_config(nlohmann::json
     if (sparse_files.size() == default_value_for_each_table.size()) {
       model["default_value_for_each_table"] = default_value_for_fused_tables;
     }
+    if (has_set_associativity) {
+      model["set_associativity_per_table"] = set_associativity_for_fused_tables;
+    }
+    if (has_admission_policy) {
+      model["admission_policy_per_table"] = admission_policy_for_fused_tables;
+    }
+    if (has_admission_threshold) {
+      model["admission_threshold_per_table"] = admission_threshold_for_fused_tables;
+    }
 
     original_table_id_to_fused_table_id_map_for_all_models[model_name] =
         original_table_id_to_fused_table_id_map;
@@ -405,6 +511,8 @@ void parameter_server_config::init(const std::string& hps_json_config_file) {
         get_value_from_json_soft(update_source, "failure_backoff_ms", params.failure_backoff_ms);
     params.max_commit_interval =
         get_value_from_json_soft(update_source, "max_commit_interval", params.max_commit_interval);
+    params.update_embedding_cache = get_value_from_json_soft(
+        update_source, "update_embedding_cache", params.update_embedding_cache);
   }
 
   // Persistent database parameters.
@@ -422,6 +530,16 @@ void parameter_server_config::init(const std::string& hps_json_config_file) {
     params.max_batch_size =
         get_value_from_json_soft(persistent_db, "max_batch_size", params.max_batch_size);
 
+    params.block_cache_size =
+        get_value_from_json_soft(persistent_db, "block_cache_size", params.block_cache_size);
+    params.bloom_filter_bits =
+        get_value_from_json_soft(persistent_db, "bloom_filter_bits", params.bloom_filter_bits);
+    params.use_direct_reads =
+        get_value_from_json_soft(persistent_db, "use_direct_reads", params.use_direct_reads);
+
+    // Caching behavior related.
+    params.bulk_load = get_value_from_json_soft(persistent_db, "bulk_load", params.bulk_load);
+
     if (persistent_db.find("update_filters") != persistent_db.end()) {
       params.update_filters.clear();
       auto update_filters = get_json(persistent_db, "update_filters");
@@ -450,6 +568,9 @@ void parameter_server_config::init(const std::string& hps_json_config_file) {
 
     params.allocation_rate =
         get_value_from_json_soft(volatile_db, "allocation_rate", params.allocation_rate);
+    params.value_page_size =
+        get_value_from_json_soft(volatile_db, "value_page_size", params.value_page_size);
+    params.numa_node = get_value_from_json_soft(volatile_db, "numa_node", params.numa_node);
 
     params.shared_memory_size =
         get_value_from_json_soft(volatile_db, "shared_memory_size", params.shared_memory_size);
@@ -457,9 +578,21 @@ void parameter_server_config::init(const std::string& hps_json_config_file) {
         get_value_from_json_soft(volatile_db, "shared_memory_name", params.shared_memory_name);
     params.shared_memory_auto_remove = get_value_from_json_soft(
         volatile_db, "shared_memory_auto_remove", params.shared_memory_auto_remove);
+    params.shared_memory_numa_aware = get_value_from_json_soft(
+        volatile_db, "shared_memory_numa_aware", params.shared_memory_numa_aware);
+
+    params.host_rank = get_value_from_json_soft(volatile_db, "host_rank", params.host_rank);
+    params.ib_device = get_value_from_json_soft(volatile_db, "ib_device", params.ib_device);
+    params.ib_port = get_value_from_json_soft(volatile_db, "ib_port", params.ib_port);
+    params.message_size =
+        get_value_from_json_soft(volatile_db, "message_size", params.message_size);
+    params.connect_timeout =
+        get_value_from_json_soft(volatile_db, "connect_timeout", params.connect_timeout);
 
     params.num_node_connections =
         get_value_from_json_soft(volatile_db, "num_node_connections", params.num_node_connections);
+    params.max_pipeline_depth =
+        get_value_from_json_soft(volatile_db, "max_pipeline_depth", params.max_pipeline_depth);
 
     params.max_batch_size =
         get_value_from_json_soft(volatile_db, "max_batch_size", params.max_batch_size);
@@ -482,12 +615,26 @@ void parameter_server_config::init(const std::string& hps_json_config_file) {
     params.overflow_resolution_target = get_value_from_json_soft(
         volatile_db, "overflow_resolution_target", params.overflow_resolution_target);
 
+    // Value storage related.
+    params.value_format = get_hps_value_format(volatile_db, "value_format", params.value_format);
+    if (volatile_db.find("table_value_formats") != volatile_db.end()) {
+      const nlohmann::json& formats{get_json(volatile_db, "table_value_formats")};
+      for (auto it{formats.begin()}; it != formats.end(); ++it) {
+        params.table_value_formats[it.key()] =
+            get_hps_value_format(formats, it.key(), params.value_format);
+      }
+    }
+
     // Caching behavior related.
     params.initial_cache_rate =
         get_value_from_json_soft(volatile_db, "initial_cache_rate", params.initial_cache_rate);
 
     params.cache_missed_embeddings = get_value_from_json_soft(
         volatile_db, "cache_missed_embeddings", params.cache_missed_embeddings);
+    params.near_cache_capacity =
+        get_value_from_json_soft(volatile_db, "near_cache_capacity", params.near_cache_capacity);
+    params.near_cache_ttl_ms =
+        get_value_from_json_soft(volatile_db, "near_cache_ttl_ms", params.near_cache_ttl_ms);
 
     // Real-time update mechanism related.
     if (volatile_db.find("update_filters") != volatile_db.end()) {
@@ -561,7 +708,10 @@ void parameter_server_config::init(const std::string& hps_json_config_file) {
         params.deployed_devices.emplace_back(deployed_device_list[device_index].get<int>());
       }
     }
-    params.device_id = params.deployed_devices.back();
+    // An empty list serves the model from the CPU only, see `CpuLookupSession`.
+    if (!params.deployed_devices.empty()) {
+      params.device_id = params.deployed_devices.back();
+    }
 
     // [12] maxnum_catfeature_query_per_table_per_sample -> std::vector<int>
     auto maxnum_catfeature_query_per_table_per_sample =
@@ -672,6 +822,74 @@ void parameter_server_config::init(const std::string& hps_json_config_file) {
     params.enable_pagelock = get_value_from_json_soft<bool>(model, "enable_pagelock", false);
     // [27] fp8_quant -> bool
     params.fp8_quant = get_value_from_json_soft<bool>(model, "fp8_quant", false);
+    // [28] use_bloom_filter -> bool
+    params.use_bloom_filter = get_value_from_json_soft<bool>(model, "use_bloom_filter", false);
+    // [29] hot_key_set_size -> size_t
+    params.hot_key_set_size = get_value_from_json_soft<size_t>(model, "hot_key_set_size", 0);
+    // [30] set_associativity_per_table -> std::vector<size_t>
+    params.set_associativity_per_table.clear();
+    if (model.find("set_associativity_per_table") != model.end()) {
+      auto set_associativity_per_table = get_json(model, "set_associativity_per_table");
+      if (set_associativity_per_table.is_array()) {
+        for (size_t assoc_index = 0; assoc_index < set_associativity_per_table.size();
+             ++assoc_index) {
+          params.set_associativity_per_table.emplace_back(
+              set_associativity_per_table[assoc_index].get<size_t>());
+        }
+      }
+    }
+    // [31] shard_uvm_table -> bool
+    params.shard_uvm_table = get_value_from_json_soft<bool>(model, "shard_uvm_table", false);
+    // [32] uvm_table_staging_buffers -> size_t
+    params.uvm_table_staging_buffers =
+        get_value_from_json_soft<size_t>(model, "uvm_table_staging_buffers", 2);
+    // [33] sync_insert_latency_budget_us -> float
+    params.sync_insert_latency_budget_us =
+        get_value_from_json_soft<float>(model, "sync_insert_latency_budget_us", 0);
+    // [34] admission_policy_per_table -> std::vector<AdmissionPolicy_t>
+    params.admission_policy_per_table =
+        get_hps_admission_policies(model, "admission_policy_per_table", AdmissionPolicy_t::Disabled);
+    // [35] admission_threshold_per_table -> std::vector<float>
+    params.admission_threshold_per_table.clear();
+    if (model.find("admission_threshold_per_table") != model.end()) {
+      auto admission_threshold_per_table = get_json(model, "admission_threshold_per_table");
+      if (admission_threshold_per_table.is_array()) {
+        for (size_t threshold_index = 0; threshold_index < admission_threshold_per_table.size();
+             ++threshold_index) {
+          params.admission_threshold_per_table.emplace_back(
+              admission_threshold_per_table[threshold_index].get<float>());
+        }
+      }
+    }
+    // [36] use_capturable_lookup -> bool
+    params.use_capturable_lookup =
+        get_value_from_json_soft<bool>(model, "use_capturable_lookup", false);
+    // [37] shared_cache_role -> SharedCacheRole_t
+    params.shared_cache_role =
+        get_hps_shared_cache_role(model, "shared_cache_role", SharedCacheRole_t::Disabled);
+    // [38] refresh_time_budget_ms -> float
+    params.refresh_time_budget_ms =
+        get_value_from_json_soft<float>(model, "refresh_time_budget_ms", 0);
+    // [39] refresh_updated_keys_only -> bool
+    params.refresh_updated_keys_only =
+        get_value_from_json_soft<bool>(model, "refresh_updated_keys_only", false);
+    // [40] background_refresh -> bool
+    params.background_refresh = get_value_from_json_soft<bool>(model, "background_refresh", false);
+    // [41] lookup_batching_window_us -> float
+    params.lookup_batching_window_us =
+        get_value_from_json_soft<float>(model, "lookup_batching_window_us", 0);
+    // [42] lookup_batching_max_keys -> size_t
+    params.lookup_batching_max_keys =
+        get_value_from_json_soft<size_t>(model, "lookup_batching_max_keys", 0);
+    // [43] cache_rebalance_percentage -> float
+    params.cache_rebalance_percentage =
+        get_value_from_json_soft<float>(model, "cache_rebalance_percentage", 0);
+    // [44] key_log_warmup_file -> std::string
+    params.key_log_warmup_file =
+        get_value_from_json_soft<std::string>(model, "key_log_warmup_file", "");
+    // [45] key_log_record_file -> std::string
+    params.key_log_record_file =
+        get_value_from_json_soft<std::string>(model, "key_log_record_file", "");
 
     params.volatile_db = volatile_db_params;
     params.persistent_db = persistent_db_params;
@@ -884,6 +1102,14 @@ DatabaseType_t get_hps_database_type(const nlohmann::json& json, const std::stri
       return enum_value;
     }
 
+  enum_value = DatabaseType_t::DistributedHashMap;
+  names = {hctr_enum_to_c_str(enum_value), "distributed_hashmap", "distributed_hash",
+           "distributed_map"};
+  for (const char* name : names)
+    if (tmp == name) {
+      return enum_value;
+    }
+
   enum_value = DatabaseType_t::RedisCluster;
   names = {hctr_enum_to_c_str(enum_value), "redis"};
   for (const char* name : names)
@@ -959,6 +1185,47 @@ EmbeddingCacheType_t get_hps_embeddingcache_type(const nlohmann::json& json, con
   return default_value;
 }
 
+std::vector<AdmissionPolicy_t> get_hps_admission_policies(const nlohmann::json& json,
+                                                          const std::string& key,
+                                                          const AdmissionPolicy_t default_value) {
+  std::vector<AdmissionPolicy_t> policies;
+  if (json.find(key) == json.end()) {
+    return policies;
+  }
+  const nlohmann::json& names = get_json(json, key);
+  HCTR_CHECK_HINT(names.is_array(), "\"%s\" must be a list of admission policies.\n", key.c_str());
+
+  for (const auto& name : names) {
+    const std::string tmp = name.get<std::string>();
+    AdmissionPolicy_t enum_value = default_value;
+    for (const AdmissionPolicy_t policy :
+         {AdmissionPolicy_t::Disabled, AdmissionPolicy_t::Frequency, AdmissionPolicy_t::Probabilistic,
+          AdmissionPolicy_t::Doorkeeper}) {
+      if (hctr_enum_to_c_str(policy) == tmp) {
+        enum_value = policy;
+      }
+    }
+    policies.emplace_back(enum_value);
+  }
+  return policies;
+}
+
+SharedCacheRole_t get_hps_shared_cache_role(const nlohmann::json& json, const std::string& key,
+                                            const SharedCacheRole_t default_value) {
+  if (json.find(key) == json.end()) {
+    return default_value;
+  }
+  const std::string tmp = get_value_from_json<std::string>(json, key);
+  for (const SharedCacheRole_t role : {SharedCacheRole_t::Disabled, SharedCacheRole_t::Owner}) {
+    if (hctr_enum_to_c_str(role) == tmp) {
+      return role;
+    }
+  }
+  HCTR_THROW_IF(hctr_enum_to_c_str(SharedCacheRole_t::Reader) != tmp, Error_t::WrongInput,
+                "Unknown shared cache role \"", tmp, "\".");
+  return SharedCacheRole_t::Reader;
+}
+
 DatabaseOverflowPolicy_t get_hps_overflow_policy(const nlohmann::json& json, const std::string& key,
                                                  const DatabaseOverflowPolicy_t default_value) {
   if (json.find(key) == json.end()) {
@@ -989,7 +1256,50 @@ DatabaseOverflowPolicy_t get_hps_overflow_policy(const nlohmann::json& json, con
       return enum_value;
     }
 
+  enum_value = DatabaseOverflowPolicy_t::EvictClock;
+  names = {hctr_enum_to_c_str(enum_value), "clock"};
+  for (const char* name : names)
+    if (tmp == name) {
+      return enum_value;
+    }
+
   return default_value;
 }
 
+DatabaseValueFormat_t get_hps_value_format(const nlohmann::json& json, const std::string& key,
+                                           const DatabaseValueFormat_t default_value) {
+  if (json.find(key) == json.end()) {
+    return default_value;
+  }
+  std::string tmp = get_value_from_json<std::string>(json, key);
+  DatabaseValueFormat_t enum_value;
+  std::unordered_set<const char*> names;
+
+  enum_value = DatabaseValueFormat_t::Float32;
+  names = {hctr_enum_to_c_str(enum_value), "fp32"};
+  for (const char* name : names)
+    if (tmp == name) {
+      return enum_value;
+    }
+
+  enum_value = DatabaseValueFormat_t::Float16;
+  names = {hctr_enum_to_c_str(enum_value), "fp16"};
+  for (const char* name : names)
+    if (tmp == name) {
+      return enum_value;
+    }
+
+  enum_value = DatabaseValueFormat_t::BFloat16;
+  names = {hctr_enum_to_c_str(enum_value), "bf16"};
+  for (const char* name : names)
+    if (tmp == name) {
+      return enum_value;
+    }
+
+  enum_value = DatabaseValueFormat_t::FP8;
+  HCTR_THROW_IF(tmp != hctr_enum_to_c_str(enum_value) && tmp != "fp8", Error_t::WrongInput,
+                "Unknown value format \"", tmp, "\".");
+  return enum_value;
+}
+
 }  // namespace HugeCTR
@@ -47,6 +47,21 @@ __global__ void fill_default_emb_vec(float* d_output_emb_vec, const float defaul
   }
 }
 
+// Same as fill_default_emb_vec, but the number of missing keys is only known on the device
+__global__ void fill_default_emb_vec_device_len(float* d_output_emb_vec,
+                                                const float default_emb_vec,
+                                                const uint64_t* d_missing_index,
+                                                const size_t* d_missing_len,
+                                                const size_t emb_vec_size) {
+  const size_t idx = blockIdx.x * blockDim.x + threadIdx.x;
+  if (idx < (*d_missing_len * emb_vec_size)) {
+    size_t src_emb_vec = idx / emb_vec_size;
+    size_t dst_emb_vec = d_missing_index[src_emb_vec];
+    size_t dst_float = idx % emb_vec_size;
+    d_output_emb_vec[dst_emb_vec * emb_vec_size + dst_float] = default_emb_vec;
+  }
+}
+
 // Kernels to decompress the value buffer
 __global__ void decompress_emb_vec(const float* d_src_emb_vec, const uint64_t* d_src_index,
                                    float* d_dst_emb_vec, const size_t len,
@@ -84,6 +99,21 @@ void fill_default_emb_vec_async(float* d_vals_merge_dst_ptr, const float default
       d_vals_merge_dst_ptr, default_emb_vec, d_missing_index_ptr, missing_len, emb_vec_size);
 }
 
+void fill_default_emb_vec_async(float* d_vals_merge_dst_ptr, const float default_emb_vec,
+                                const uint64_t* d_missing_index_ptr,
+                                const size_t* d_missing_len_ptr, const size_t max_missing_len,
+                                const size_t emb_vec_size, const size_t BLOCK_SIZE,
+                                cudaStream_t stream) {
+  if (max_missing_len == 0) {
+    return;
+  }
+  size_t max_missing_len_in_float = max_missing_len * emb_vec_size;
+  fill_default_emb_vec_device_len<<<((max_missing_len_in_float - 1) / BLOCK_SIZE) + 1, BLOCK_SIZE,
+                                    0, stream>>>(d_vals_merge_dst_ptr, default_emb_vec,
+                                                 d_missing_index_ptr, d_missing_len_ptr,
+                                                 emb_vec_size);
+}
+
 void decompress_emb_vec_async(const float* d_unique_src_ptr, const uint64_t* d_unique_index_ptr,
                               float* d_decompress_dst_ptr, const size_t decompress_len,
                               const size_t emb_vec_size, const size_t BLOCK_SIZE,
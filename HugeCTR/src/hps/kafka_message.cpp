@@ -16,10 +16,13 @@
 
 #include <parallel_hashmap/phmap.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <hps/database_backend.hpp>
 #include <hps/database_backend_detail.hpp>
 #include <hps/kafka_message.hpp>
+#include <hps/quantize.hpp>
 #include <vector>
 
 // TODO: Remove me!
@@ -68,6 +71,96 @@ const size_t HCTR_KAFKA_ERROR_STRING_LENGTH = 512;
 const uint32_t HCTR_KAFKA_VALUE_PREFIX =
     (uint32_t)('H') | ((uint32_t)('C') << 8) | ((uint32_t)('T') << 16) | ((uint32_t)('R') << 24);
 
+// Messages with values in reduced precision carry a different prefix. The value size in their
+// header still refers to the fp32 values, which the consumer restores.
+const uint32_t HCTR_KAFKA_FP16_VALUE_PREFIX =
+    (uint32_t)('H') | ((uint32_t)('C') << 8) | ((uint32_t)('T') << 16) | ((uint32_t)('h') << 24);
+const uint32_t HCTR_KAFKA_FP8_VALUE_PREFIX =
+    (uint32_t)('H') | ((uint32_t)('C') << 8) | ((uint32_t)('T') << 16) | ((uint32_t)('8') << 24);
+
+uint32_t kafka_value_prefix(const std::string& value_precision) {
+  if (value_precision == "fp32") {
+    return HCTR_KAFKA_VALUE_PREFIX;
+  } else if (value_precision == "fp16") {
+    return HCTR_KAFKA_FP16_VALUE_PREFIX;
+  }
+  HCTR_THROW_IF(value_precision != "fp8", Error_t::WrongInput,
+                "Unsupported Kafka value precision '", value_precision,
+                "'. Must be fp32, fp16 or fp8.");
+  return HCTR_KAFKA_FP8_VALUE_PREFIX;
+}
+
+bool is_kafka_value_prefix(const uint32_t prefix) {
+  return prefix == HCTR_KAFKA_VALUE_PREFIX || prefix == HCTR_KAFKA_FP16_VALUE_PREFIX ||
+         prefix == HCTR_KAFKA_FP8_VALUE_PREFIX;
+}
+
+/**
+ * Size of a value on the wire.
+ *
+ * @param prefix Message prefix, which determines the encoding.
+ * @param value_size Size of the fp32 value in bytes.
+ */
+size_t kafka_encoded_value_size(const uint32_t prefix, const uint32_t value_size) {
+  const size_t num_elements = value_size / sizeof(float);
+  if (prefix == HCTR_KAFKA_FP16_VALUE_PREFIX) {
+    return num_elements * sizeof(__half);
+  } else if (prefix == HCTR_KAFKA_FP8_VALUE_PREFIX) {
+    return sizeof(float) + num_elements * sizeof(__nv_fp8_e4m3);
+  }
+  return value_size;
+}
+
+void kafka_encode_value(const uint32_t prefix, const char* const value, const uint32_t value_size,
+                        char* const out) {
+  if (prefix == HCTR_KAFKA_VALUE_PREFIX) {
+    std::copy_n(value, value_size, out);
+    return;
+  }
+  const float* const src = reinterpret_cast<const float*>(value);
+  const size_t num_elements = value_size / sizeof(float);
+  if (prefix == HCTR_KAFKA_FP16_VALUE_PREFIX) {
+    __half* const dst = reinterpret_cast<__half*>(out);
+    for (size_t i = 0; i < num_elements; ++i) {
+      dst[i] = __float2half(src[i]);
+    }
+  } else {
+    // Scaled per value like the FP8 embedding tables (see quantize.cu).
+    float amax = 0.f;
+    for (size_t i = 0; i < num_elements; ++i) {
+      amax = std::max(amax, std::abs(src[i]));
+    }
+    const float scale = std::max(amax / FP8_E4M3_MAX, 1.f / (FP8_E4M3_MAX * CLAMP));
+    *reinterpret_cast<float*>(out) = scale;
+    __nv_fp8_e4m3* const dst = reinterpret_cast<__nv_fp8_e4m3*>(&out[sizeof(float)]);
+    for (size_t i = 0; i < num_elements; ++i) {
+      dst[i] = __nv_fp8_e4m3(src[i] / scale);
+    }
+  }
+}
+
+void kafka_decode_value(const uint32_t prefix, const char* const in, const uint32_t value_size,
+                        char* const value) {
+  if (prefix == HCTR_KAFKA_VALUE_PREFIX) {
+    std::copy_n(in, value_size, value);
+    return;
+  }
+  float* const dst = reinterpret_cast<float*>(value);
+  const size_t num_elements = value_size / sizeof(float);
+  if (prefix == HCTR_KAFKA_FP16_VALUE_PREFIX) {
+    const __half* const src = reinterpret_cast<const __half*>(in);
+    for (size_t i = 0; i < num_elements; ++i) {
+      dst[i] = __half2float(src[i]);
+    }
+  } else {
+    const float scale = *reinterpret_cast<const float*>(in);
+    const __nv_fp8_e4m3* const src = reinterpret_cast<const __nv_fp8_e4m3*>(&in[sizeof(float)]);
+    for (size_t i = 0; i < num_elements; ++i) {
+      dst[i] = static_cast<float>(src[i]) * scale;
+    }
+  }
+}
+
 void kafka_conf_set_and_check(rd_kafka_conf_t* const conf, const char* const key,
                               const char* const value) {
   char error[HCTR_KAFKA_ERROR_STRING_LENGTH];
@@ -113,7 +206,9 @@ struct KafkaMessageDeleter {
 
 template <typename Key>
 KafkaMessageSink<Key>::KafkaMessageSink(const KafkaMessageSinkParams& params)
-    : Base(params), send_buffer_memory_(params.num_send_buffers * params.send_buffer_size) {
+    : Base(params),
+      value_prefix_(kafka_value_prefix(params.value_precision)),
+      send_buffer_memory_(params.num_send_buffers * params.send_buffer_size) {
   HCTR_CHECK(params.send_buffer_size >= 1024 && params.num_send_buffers > 0);
 
   // Create send buffers.
@@ -123,7 +218,7 @@ KafkaMessageSink<Key>::KafkaMessageSink(const KafkaMessageSinkParams& params)
   for (auto it = send_buffer_memory_.begin(); it != send_buffer_memory_.end();
        it += params.send_buffer_size) {
     char* send_buffer = &(*it);
-    *reinterpret_cast<uint32_t*>(send_buffer) = HCTR_KAFKA_VALUE_PREFIX;
+    *reinterpret_cast<uint32_t*>(send_buffer) = value_prefix_;
     send_buffers_.push_back(send_buffer);
   }
   HCTR_CHECK(send_buffers_.size() == params.num_send_buffers);
@@ -153,8 +248,11 @@ KafkaMessageSink<Key>::KafkaMessageSink(const KafkaMessageSinkParams& params)
   kafka_conf_set_and_check(conf, "queue.buffering.max.messages", 64 * 1024);  // Default: 100'000
   kafka_conf_set_and_check(conf, "queue.buffering.max.kbytes",
                            1 * 1024 * 1024);                       // Default: 1'048'576
-  kafka_conf_set_and_check(conf, "queue.buffering.max.ms", 100);   // Default: 5
-  kafka_conf_set_and_check(conf, "compression.codec", "none");     // Default: none
+  kafka_conf_set_and_check(conf, "queue.buffering.max.ms", params.linger_ms);  // Default: 5
+  kafka_conf_set_and_check(conf, "compression.codec", params.compression_codec);  // Default: none
+  if (params.compression_level >= 0) {
+    kafka_conf_set_and_check(conf, "compression.level", params.compression_level);  // Default: -1
+  }
   kafka_conf_set_and_check(conf, "batch.num.messages", 8 * 1024);  // Default: 10'000
   kafka_conf_set_and_check(conf, "batch.size", 64 * 1024 * 1024);  // Default: 1'000'000
   rd_kafka_conf_set_dr_msg_cb(
@@ -211,8 +309,12 @@ KafkaMessageSink<Key>::~KafkaMessageSink() {
 template <typename Key>
 void KafkaMessageSink<Key>::post(const std::string& tag, size_t num_pairs, const Key* const keys,
                                  const char* values, const uint32_t value_size) {
+  HCTR_CHECK_HINT(value_prefix_ == HCTR_KAFKA_VALUE_PREFIX || value_size % sizeof(float) == 0,
+                  "Kafka values can only be sent in reduced precision if they are float vectors.");
+
   // Make sure there enough space to store at least one key-value pair.
-  const size_t key_value_size = sizeof(Key) + value_size;
+  const size_t encoded_value_size = kafka_encoded_value_size(value_prefix_, value_size);
+  const size_t key_value_size = sizeof(Key) + encoded_value_size;
   HCTR_CHECK(sizeof(uint32_t) * 2 + key_value_size <= this->params_.send_buffer_size);
 
   // Get topic, or create if it doesn't exist yet.
@@ -239,8 +341,8 @@ void KafkaMessageSink<Key>::post(const std::string& tag, size_t num_pairs, const
     // Append key & value.
     *reinterpret_cast<Key*>(&payload[p_length]) = *keys;
     p_length += sizeof(Key);
-    std::copy_n(values, value_size, &payload[p_length]);
-    p_length += value_size;
+    kafka_encode_value(value_prefix_, values, value_size, &payload[p_length]);
+    p_length += encoded_value_size;
 
     // Produce Kafka message.
     blocking_produce(topic, payload, p_length, part_index);
@@ -277,8 +379,9 @@ void KafkaMessageSink<Key>::post(const std::string& tag, size_t num_pairs, const
         // Append key & value.
         *reinterpret_cast<Key*>(&payload[p_length]) = *k;
         p_length += sizeof(Key);
-        std::copy_n(&values[(k - keys) * value_size], value_size, &payload[p_length]);
-        p_length += value_size;
+        kafka_encode_value(value_prefix_, &values[(k - keys) * value_size], value_size,
+                           &payload[p_length]);
+        p_length += encoded_value_size;
       }
 
       // Sent any unsent payload.
@@ -341,10 +444,8 @@ char* KafkaMessageSink<Key>::acquire_send_buffer(uint32_t value_size) {
   char* send_buffer;
   {
     std::unique_lock<std::mutex> lock(send_buffer_barrier_);
-    if (send_buffers_.empty()) {
-      // HCTR_LOG(DEBUG, WORLD, "Awaiting buffer availability...\n");
-      send_buffer_semaphore_.wait(lock);
-    }
+    // HCTR_LOG(DEBUG, WORLD, "Awaiting buffer availability...\n");
+    send_buffer_semaphore_.wait(lock, [this] { return !send_buffers_.empty(); });
     send_buffer = send_buffers_.back();
     send_buffers_.pop_back();
     // HCTR_LOG_C(DEBUG, WORLD, "Borrowed buffer ", send_buffers_.size(), ".\n");
@@ -408,14 +509,15 @@ void KafkaMessageSink<Key>::on_delivered(const rd_kafka_message_t& msg) {
     num_delivered_failure_++;
   } else {
     num_delivered_success_++;
+  }
 
-    // Return send buffer back to the pool.
-    {
-      std::unique_lock<std::mutex> lock(send_buffer_barrier_);
-      send_buffers_.push_back(reinterpret_cast<char*>(msg.payload));
-    }
-    send_buffer_semaphore_.notify_one();
+  // Return send buffer back to the pool. Failed messages must return it as well, or the pool
+  // would shrink until post() blocks forever.
+  {
+    std::unique_lock<std::mutex> lock(send_buffer_barrier_);
+    send_buffers_.push_back(reinterpret_cast<char*>(msg.payload));
   }
+  send_buffer_semaphore_.notify_one();
 }
 
 template class KafkaMessageSink<unsigned int>;
@@ -554,6 +656,7 @@ struct KafkaReceiveBuffer final {
   uint32_t value_size;
   std::vector<Key> keys;
   std::vector<char> values;
+  phmap::flat_hash_map<Key, size_t> key_index;  // position of each key in `keys`.
   size_t msg_count = 0;  // messages processed since last commit.
   std::unique_ptr<rd_kafka_topic_partition_list_t, KafkaTopicPartitionListDeleter> next_offsets{
       rd_kafka_topic_partition_list_new(1)};
@@ -563,6 +666,7 @@ struct KafkaReceiveBuffer final {
       : value_size{_value_size} {
     keys.reserve(max_batch_size);
     values.reserve(_value_size * max_batch_size);
+    key_index.reserve(max_batch_size);
   }
 };
 
@@ -601,6 +705,7 @@ void KafkaMessageSource<Key>::run(std::function<Callback> callback) {
     num_keys_delivered_ += buf.keys.size();
     buf.keys.clear();
     buf.values.clear();
+    buf.key_index.clear();
     return true;
   };
 
@@ -710,7 +815,8 @@ void KafkaMessageSource<Key>::run(std::function<Callback> callback) {
     // Parse header.
     const char* p = static_cast<char*>(msg->payload);
     const char* const p_end = &p[msg->len];
-    if (*reinterpret_cast<const uint32_t*>(p) != HCTR_KAFKA_VALUE_PREFIX) {
+    const uint32_t prefix = *reinterpret_cast<const uint32_t*>(p);
+    if (!is_kafka_value_prefix(prefix)) {
       HCTR_LOG(WARNING, WORLD,
                "Kafka message header contains unexpected values. Message discarded!\n");
       continue;
@@ -718,6 +824,7 @@ void KafkaMessageSource<Key>::run(std::function<Callback> callback) {
     p += sizeof(uint32_t);
     const uint32_t value_size = *reinterpret_cast<const uint32_t*>(p);
     p += sizeof(uint32_t);
+    const size_t encoded_value_size = kafka_encoded_value_size(prefix, value_size);
 
     // If this is just a beacon.
     if (p == p_end) {
@@ -743,14 +850,24 @@ void KafkaMessageSource<Key>::run(std::function<Callback> callback) {
       buf.value_size = value_size;
     }
 
-    // Copy data to receive buffer.
+    // Copy data to receive buffer. A later update of a key that is still buffered replaces the
+    // buffered value, so that each delivery carries every key at most once.
     while (p != p_end) {
-      buf.keys.push_back(*reinterpret_cast<const Key*>(p));
+      const Key key = *reinterpret_cast<const Key*>(p);
       p += sizeof(Key);
 
-      const char* const p_next = &p[value_size];
-      buf.values.insert(buf.values.end(), p, p_next);
-      p = p_next;
+      const auto result = buf.key_index.try_emplace(key, buf.keys.size());
+      char* value;
+      if (result.second) {
+        buf.keys.push_back(key);
+        buf.values.resize(buf.values.size() + value_size);
+        value = &buf.values[buf.values.size() - value_size];
+      } else {
+        value = &buf.values[result.first->second * value_size];
+        ++num_keys_coalesced_;
+      }
+      kafka_decode_value(prefix, p, value_size, value);
+      p = &p[encoded_value_size];
 
       // Deliver directly if receive buffer is full.
       if (buf.keys.size() >= max_batch_size_) {
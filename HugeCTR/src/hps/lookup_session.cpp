@@ -32,7 +32,7 @@ LookupSession::LookupSession(const InferenceParams& inference_params,
     : LookupSessionBase(),
       embedding_cache_(embedding_cache),
       inference_params_(inference_params),
-      table_fusion_thread_pool_("table fusion",
+      table_fusion_thread_pool_("table fusion", TaskPriority::Lookup,
                                 inference_params.original_table_id_to_fused_table_id_map.size()) {
   try {
     auto b2s = [](const char val) { return val ? "True" : "False"; };
@@ -96,6 +96,39 @@ LookupSession::LookupSession(const InferenceParams& inference_params,
         vec_buffer_for_each_fused_table_.push_back(current_vec_buffer);
       }
     }
+    if (inference_params_.lookup_batching_window_us > 0) {
+      if (inference_params_.fuse_embedding_table) {
+        HCTR_LOG_S(WARNING, WORLD) << "Lookup batching does not support fused embedding tables "
+                                      "and is disabled for "
+                                   << inference_params_.model_name << "." << std::endl;
+      } else {
+        size_t key_size_in_byte =
+            inference_params_.i64_input_key ? sizeof(long long) : sizeof(unsigned int);
+        open_batch_per_table_.resize(num_tables);
+        for (size_t table_id{0}; table_id < num_tables; ++table_id) {
+          size_t max_num_keys = inference_params_.lookup_batching_max_keys;
+          if (max_num_keys == 0) {
+            max_num_keys = inference_params_.max_batchsize *
+                           inference_params_.maxnum_catfeature_query_per_table_per_sample[table_id];
+          }
+          size_t emb_vec_size = inference_params_.embedding_vecsize_per_table[table_id];
+          void* key_buffer;
+          float* vec_buffer;
+          HCTR_LIB_THROW(cudaMalloc(&key_buffer, max_num_keys * key_size_in_byte));
+          HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void**>(&vec_buffer),
+                                    max_num_keys * emb_vec_size * sizeof(float)));
+          batch_run_mutex_per_table_.emplace_back(std::make_unique<std::mutex>());
+          batch_max_keys_per_table_.push_back(max_num_keys);
+          batch_key_buffer_per_table_.push_back(key_buffer);
+          batch_vec_buffer_per_table_.push_back(vec_buffer);
+        }
+        auto& metrics = MetricsRegistry::get();
+        const std::string labels = "{model=\"" + inference_params_.model_name + "\",device=\"" +
+                                   std::to_string(inference_params_.device_id) + "\"}";
+        num_batches_ = &metrics.counter("hps_lookup_batches" + labels);
+        num_batched_requests_ = &metrics.counter("hps_lookup_batched_requests" + labels);
+      }
+    }
 
   } catch (const std::runtime_error& rt_err) {
     HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
@@ -117,6 +150,8 @@ LookupSession::~LookupSession() {
       vec_buffer_for_each_fused_table_[fused_id] = nullptr;
     }
   }
+  for (void* key_buffer : batch_key_buffer_per_table_) HCTR_LIB_CHECK_(cudaFree(key_buffer));
+  for (float* vec_buffer : batch_vec_buffer_per_table_) HCTR_LIB_CHECK_(cudaFree(vec_buffer));
 }
 
 void LookupSession::lookup_with_table_fusion_impl(const void* keys, float* d_vectors,
@@ -235,6 +270,118 @@ void LookupSession::lookup_with_table_fusion_impl(const void* keys, float* d_vec
   }
 }
 
+void LookupSession::lookup_from_device_batched(const void* d_keys, float* d_vectors,
+                                               size_t num_keys, size_t table_id,
+                                               cudaStream_t stream) {
+  CudaDeviceContext dev_restorer;
+  dev_restorer.set_device(inference_params_.device_id);
+  // Without a stream of the caller, its keys are ready already.
+  cudaEvent_t keys_ready = nullptr;
+  if (stream) {
+    HCTR_LIB_THROW(cudaEventCreateWithFlags(&keys_ready, cudaEventDisableTiming));
+    HCTR_LIB_THROW(cudaEventRecord(keys_ready, stream));
+  }
+
+  std::shared_ptr<LookupBatch> batch;
+  bool is_leader = false;
+  {
+    std::unique_lock lock(batching_mutex_);
+    const size_t max_num_keys = batch_max_keys_per_table_[table_id];
+    auto close_open_batch = [this, table_id] {
+      open_batch_per_table_[table_id]->closed = true;
+      open_batch_per_table_[table_id].reset();
+      batching_cv_.notify_all();
+    };
+    if (open_batch_per_table_[table_id] &&
+        open_batch_per_table_[table_id]->total_num_keys + num_keys > max_num_keys) {
+      close_open_batch();
+    }
+    if (!open_batch_per_table_[table_id]) {
+      open_batch_per_table_[table_id] = std::make_shared<LookupBatch>();
+      is_leader = true;
+    }
+    batch = open_batch_per_table_[table_id];
+    batch->d_keys.push_back(d_keys);
+    batch->d_vectors.push_back(d_vectors);
+    batch->num_keys.push_back(num_keys);
+    batch->keys_ready.push_back(keys_ready);
+    batch->total_num_keys += num_keys;
+    if (batch->total_num_keys >= max_num_keys) {
+      close_open_batch();
+    }
+
+    if (is_leader) {
+      const std::chrono::duration<float, std::micro> window(
+          inference_params_.lookup_batching_window_us);
+      batching_cv_.wait_for(lock, window, [&batch] { return batch->closed; });
+      if (!batch->closed) {
+        close_open_batch();
+      }
+    }
+  }
+
+  if (is_leader) {
+    {
+      std::lock_guard run_lock(*batch_run_mutex_per_table_[table_id]);
+      try {
+        run_lookup_batch(*batch, table_id);
+      } catch (...) {
+        batch->error = std::current_exception();
+      }
+    }
+    std::lock_guard lock(batching_mutex_);
+    batch->done = true;
+    batching_cv_.notify_all();
+  } else {
+    std::unique_lock lock(batching_mutex_);
+    batching_cv_.wait(lock, [&batch] { return batch->done; });
+  }
+  if (keys_ready) {
+    HCTR_LIB_THROW(cudaEventDestroy(keys_ready));
+  }
+  if (batch->error) {
+    std::rethrow_exception(batch->error);
+  }
+}
+
+void LookupSession::run_lookup_batch(LookupBatch& batch, size_t table_id) {
+  cudaStream_t stream = lookup_streams_[table_id];
+  for (cudaEvent_t keys_ready : batch.keys_ready) {
+    if (keys_ready) {
+      HCTR_LIB_THROW(cudaStreamWaitEvent(stream, keys_ready, 0));
+    }
+  }
+  num_batches_->add(1);
+  num_batched_requests_->add(batch.num_keys.size());
+
+  if (batch.num_keys.size() == 1) {
+    lookup_from_device_impl(batch.d_keys[0], batch.d_vectors[0], batch.num_keys[0], table_id,
+                            stream);
+  } else {
+    const size_t key_size_in_byte =
+        inference_params_.i64_input_key ? sizeof(long long) : sizeof(unsigned int);
+    const size_t emb_vec_size = inference_params_.embedding_vecsize_per_table[table_id];
+    char* key_buffer = reinterpret_cast<char*>(batch_key_buffer_per_table_[table_id]);
+    float* vec_buffer = batch_vec_buffer_per_table_[table_id];
+    size_t offset = 0;
+    for (size_t i{0}; i < batch.num_keys.size(); ++i) {
+      HCTR_LIB_THROW(cudaMemcpyAsync(key_buffer + offset * key_size_in_byte, batch.d_keys[i],
+                                     batch.num_keys[i] * key_size_in_byte,
+                                     cudaMemcpyDeviceToDevice, stream));
+      offset += batch.num_keys[i];
+    }
+    lookup_from_device_impl(key_buffer, vec_buffer, batch.total_num_keys, table_id, stream);
+    offset = 0;
+    for (size_t i{0}; i < batch.num_keys.size(); ++i) {
+      HCTR_LIB_THROW(cudaMemcpyAsync(batch.d_vectors[i], vec_buffer + offset * emb_vec_size,
+                                     batch.num_keys[i] * emb_vec_size * sizeof(float),
+                                     cudaMemcpyDeviceToDevice, stream));
+      offset += batch.num_keys[i];
+    }
+  }
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+}
+
 void LookupSession::lookup_from_device_impl(const void* d_keys, float* d_vectors, size_t num_keys,
                                             size_t table_id, cudaStream_t stream) {
   CudaDeviceContext dev_restorer;
@@ -330,11 +477,30 @@ void LookupSession::lookup_from_device(const void* d_keys, float* d_vectors, siz
                                        size_t table_id, cudaStream_t stream) {
   if (inference_params_.fuse_embedding_table) {
     this->lookup_with_table_fusion_impl(d_keys, d_vectors, num_keys, table_id, true, stream);
+  } else if (!open_batch_per_table_.empty()) {
+    this->lookup_from_device_batched(d_keys, d_vectors, num_keys, table_id, stream);
   } else {
     this->lookup_from_device_impl(d_keys, d_vectors, num_keys, table_id, stream);
   }
 }
 
+void LookupSession::lookup_from_device_capturable(const void* d_keys, float* d_vectors,
+                                                  size_t num_keys, size_t table_id,
+                                                  cudaStream_t stream) {
+  if (inference_params_.fuse_embedding_table) {
+    HCTR_OWN_THROW(Error_t::WrongInput,
+                   "Graph-capturable lookups do not support fused embedding tables.");
+  }
+  CudaDeviceContext dev_restorer;
+  dev_restorer.set_device(inference_params_.device_id);
+  if (!embedding_cache_->lookup_from_device_capturable(table_id, d_vectors, d_keys, num_keys,
+                                                       stream)) {
+    HCTR_OWN_THROW(Error_t::WrongInput,
+                   "The embedding cache of model " + inference_params_.model_name +
+                       " does not support graph-capturable lookups.");
+  }
+}
+
 void LookupSession::lookup_from_device(const void* const d_keys, float* const d_vectors,
                                        const size_t num_keys, const size_t table_id) {
   const auto begin = std::chrono::high_resolution_clock::now();
@@ -345,6 +511,8 @@ void LookupSession::lookup_from_device(const void* const d_keys, float* const d_
     this->lookup_with_table_fusion_impl(d_keys, d_vectors, num_keys, table_id, true,
                                         lookup_streams_[fused_table_id]);
     HCTR_LIB_THROW(cudaStreamSynchronize(lookup_streams_[fused_table_id]));
+  } else if (!open_batch_per_table_.empty()) {
+    this->lookup_from_device_batched(d_keys, d_vectors, num_keys, table_id, nullptr);
   } else {
     this->lookup_from_device_impl(d_keys, d_vectors, num_keys, table_id, lookup_streams_[table_id]);
     HCTR_LIB_THROW(cudaStreamSynchronize(lookup_streams_[table_id]));
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <hps/miss_coalescer.hpp>
+#include <tuple>
+
+namespace HugeCTR {
+
+template <typename Key>
+void MissCoalescer<Key>::fetch(const Key* const keys, const size_t num_keys,
+                               const size_t emb_vec_size, float* const vectors,
+                               const FetchFunction& fetch) {
+  const auto flight{std::make_shared<Flight>()};
+  std::vector<Key> owned_keys;
+  std::vector<size_t> owned_indices;
+  std::vector<std::tuple<size_t, std::shared_ptr<Flight>, size_t>> awaited;
+
+  // Claim all keys that nobody else is fetching at the moment.
+  {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < num_keys; ++i) {
+      const auto res{in_flight_.try_emplace(keys[i], flight, owned_keys.size())};
+      if (res.second) {
+        owned_keys.emplace_back(keys[i]);
+        owned_indices.emplace_back(i);
+      } else {
+        awaited.emplace_back(i, res.first->second.first, res.first->second.second);
+      }
+    }
+    num_coalesced_keys_ += awaited.size();
+  }
+
+  // Fetch the claimed keys and publish them. This never waits for other callers, which precludes
+  // deadlocks between overlapping batches.
+  if (!owned_keys.empty()) {
+    flight->vectors.resize(owned_keys.size() * emb_vec_size);
+    auto release_claims = [&]() {
+      const std::lock_guard<std::mutex> lock(mutex_);
+      for (const Key& k : owned_keys) {
+        in_flight_.erase(k);
+      }
+    };
+    try {
+      fetch(owned_keys.data(), owned_keys.size(), flight->vectors.data());
+    } catch (...) {
+      release_claims();
+      flight->done.set_exception(std::current_exception());
+      throw;
+    }
+    release_claims();
+    flight->done.set_value();
+
+    for (size_t i = 0; i < owned_indices.size(); ++i) {
+      std::copy_n(&flight->vectors[i * emb_vec_size], emb_vec_size,
+                  &vectors[owned_indices[i] * emb_vec_size]);
+    }
+  }
+
+  // Collect the keys fetched on our behalf.
+  for (const auto& [index, other_flight, other_index] : awaited) {
+    other_flight->result.get();
+    std::copy_n(&other_flight->vectors[other_index * emb_vec_size], emb_vec_size,
+                &vectors[index * emb_vec_size]);
+  }
+}
+
+template class MissCoalescer<unsigned int>;
+template class MissCoalescer<long long>;
+
+}  // namespace HugeCTR
@@ -19,6 +19,7 @@
 #include <hps/inference_utils.hpp>
 #include <hps/modelloader.hpp>
 #include <parser.hpp>
+#include <thread_pool.hpp>
 #include <unordered_set>
 #include <utils.hpp>
 
@@ -76,6 +77,9 @@ void RawModelLoader<TKey, TValue>::load_emb(const std::string& table_name,
   const std::string emb_file_prefix = path + "/";
   const std::string key_file = emb_file_prefix + "key";
   const std::string vec_file = emb_file_prefix + "emb_vector";
+  HCTR_CHECK_HINT(!std::filesystem::exists(emb_file_prefix + "quant_scale"),
+                  "The vectors of %s are quantized to fp8, which fused tables do not support.",
+                  path.c_str());
 
   auto fs = FileSystemBuilder::build_unique_by_path(path);
   const size_t key_file_size_in_byte = fs->get_file_size(key_file);
@@ -132,13 +136,15 @@ void RawModelLoader<TKey, TValue>::load(const std::string& table_name, const std
   const std::string key_file = emb_file_prefix + "key";
   const std::string vec_file = emb_file_prefix + "emb_vector";
   const std::string meta_file = emb_file_prefix + "meta";
+  const std::string scale_file = emb_file_prefix + "quant_scale";
 
   fs_ = FileSystemBuilder::build_unique_by_path(path);
   const size_t key_file_size_in_byte = fs_->get_file_size(key_file);
   const size_t vec_file_size_in_byte = fs_->get_file_size(vec_file);
 
+  prequantized_ = std::filesystem::exists(scale_file);
   const size_t key_size_in_byte = sizeof(long long);
-  const size_t vec_size_in_byte = sizeof(float);
+  const size_t vec_size_in_byte = prequantized_ ? sizeof(__nv_fp8_e4m3) : sizeof(float);
 
   if (key_file_size_in_byte == 0) {
     HCTR_OWN_THROW(Error_t::WrongInput, "Error: embeddings key file is empty");
@@ -155,6 +161,10 @@ void RawModelLoader<TKey, TValue>::load(const std::string& table_name, const std
 
   const size_t num_key = key_file_size_in_byte / key_size_in_byte;
   embedding_table_->total_key_count = num_key;
+  if (prequantized_ && fs_->get_file_size(scale_file) != num_key * sizeof(float)) {
+    HCTR_OWN_THROW(Error_t::WrongInput,
+                   "Error: embeddings scale file size does not match embedding key file size");
+  }
 
   if (std::filesystem::exists(meta_file)) {
     const size_t meta_file_size_in_byte = fs_->get_file_size(meta_file);
@@ -179,17 +189,19 @@ void RawModelLoader<TKey, TValue>::load(const std::string& table_name, const std
   // The default value for the number of iterations
   num_iterations = 10;
   if (key_num_per_iteration == 0) {
-    // todo: The number of iterations can be calculated based on the maximum memory size configured
-    // by the user
-    key_iteration =
-        num_key % num_iterations == 0 ? num_key / num_iterations : 1 + num_key / num_iterations;
+    // A tenth of the table, but never more vectors than max_iteration_vector_bytes_, so that huge
+    // tables are not materialized in host memory.
+    const size_t vector_bytes_per_key = std::max<size_t>(vec_file_size_in_byte / num_key, 1);
+    key_iteration = std::min(
+        num_key % num_iterations == 0 ? num_key / num_iterations : 1 + num_key / num_iterations,
+        std::max<size_t>(max_iteration_vector_bytes_ / vector_bytes_per_key, 1));
   } else {
     key_iteration =
         fp8_quant ? std::min(size_t(2048), key_num_per_iteration) : key_num_per_iteration;
   }
   num_iterations =
       num_key % key_iteration == 0 ? num_key / key_iteration : (num_key / key_iteration) + 1;
-  if (fp8_quant) {
+  if (fp8_quant && !prequantized_) {
     quantizer_ = std::make_shared<HugeCTR::Quantize<float, __nv_fp8_e4m3>>(false, false);
   }
 }
@@ -215,6 +227,9 @@ void* RawModelLoader<TKey, TValue>::getkeys() {
 template <typename TKey, typename TValue>
 void RawModelLoader<TKey, TValue>::get_cache_uvm(size_t iteration, size_t emb_size,
                                                  size_t cache_capacity) {
+  HCTR_CHECK_HINT(!prequantized_,
+                  "The vectors of %s are quantized to fp8, which only static caches support.",
+                  embedding_folder_path.c_str());
   embedding_table_->cache_capacity = cache_capacity;
   const std::string key_file = embedding_folder_path + "/" + "key";
   const std::string vec_file = embedding_folder_path + "/" + "emb_vector";
@@ -324,6 +339,19 @@ std::pair<void*, size_t> RawModelLoader<TKey, TValue>::getvectors(size_t iterati
     iteration_reading_amount =
         embedding_table_->total_key_count * emb_size - iteration * key_iteration * emb_size;
   }
+  HCTR_CHECK_HINT(!prequantized_ || fp8_quant,
+                  "The vectors of %s are quantized to fp8, which requires fp8_quant.",
+                  embedding_folder_path.c_str());
+  if (prequantized_) {
+    const std::string scale_file = embedding_folder_path + "/" + "quant_scale";
+    fs_->read(vec_file, embedding_table_->d_vec_quant,
+              iteration_reading_amount * sizeof(__nv_fp8_e4m3),
+              key_iteration * emb_size * iteration * sizeof(__nv_fp8_e4m3));
+    fs_->read(scale_file, embedding_table_->quant_scales_,
+              iteration_reading_amount / emb_size * sizeof(float),
+              key_iteration * iteration * sizeof(float));
+    return std::make_pair(embedding_table_->d_vec_quant, iteration_reading_amount);
+  }
   fs_->read(vec_file, embedding_table_->vectors.data(), iteration_reading_amount * sizeof(TValue),
             key_iteration * emb_size * iteration * sizeof(TValue));
   if (fp8_quant) {
@@ -336,6 +364,68 @@ std::pair<void*, size_t> RawModelLoader<TKey, TValue>::getvectors(size_t iterati
   return std::make_pair(embedding_table_->vectors.data(), iteration_reading_amount);
 }
 
+template <typename TKey, typename TValue>
+size_t RawModelLoader<TKey, TValue>::read_iteration_(size_t iteration, size_t emb_size,
+                                                     std::vector<TKey>& keys,
+                                                     std::vector<TValue>& vectors) const {
+  HCTR_CHECK_HINT(!prequantized_,
+                  "The vectors of %s are quantized to fp8, which only static caches support.",
+                  embedding_folder_path.c_str());
+  const size_t first_key = iteration * key_iteration;
+  const size_t num_keys = std::min(key_iteration, embedding_table_->total_key_count - first_key);
+  keys.resize(num_keys);
+  vectors.resize(num_keys * emb_size);
+
+  const std::string key_file = embedding_folder_path + "/" + "key";
+  const std::string vec_file = embedding_folder_path + "/" + "emb_vector";
+  if (std::is_same<TKey, long long>::value) {
+    fs_->read(key_file, keys.data(), num_keys * sizeof(TKey), first_key * sizeof(TKey));
+  } else {
+    std::vector<long long> i64_key_vec(num_keys);
+    fs_->read(key_file, i64_key_vec.data(), num_keys * sizeof(long long),
+              first_key * sizeof(long long));
+    std::transform(i64_key_vec.begin(), i64_key_vec.end(), keys.begin(),
+                   [](long long key) { return static_cast<unsigned>(key); });
+  }
+  fs_->read(vec_file, vectors.data(), vectors.size() * sizeof(TValue),
+            first_key * emb_size * sizeof(TValue));
+  return num_keys;
+}
+
+template <typename TKey, typename TValue>
+void RawModelLoader<TKey, TValue>::for_each_chunk(size_t emb_size, const ChunkConsumer& consume) {
+  // Double buffered: the next chunk is read in the background while the current one is consumed.
+  std::vector<TKey> keys[2];
+  std::vector<TValue> vectors[2];
+  size_t num_keys[2] = {0, 0};
+  if (num_iterations == 0) {
+    return;
+  }
+  num_keys[0] = read_iteration_(0, emb_size, keys[0], vectors[0]);
+  for (size_t i = 0; i < num_iterations; i++) {
+    const size_t current = i % 2;
+    const size_t next = 1 - current;
+    std::future<void> read_next;
+    if (i + 1 < num_iterations) {
+      read_next = ThreadPool::get().submit([&, i, next]() {
+        num_keys[next] = read_iteration_(i + 1, emb_size, keys[next], vectors[next]);
+      });
+    }
+    try {
+      consume(keys[current].data(), vectors[current].data(), num_keys[current]);
+    } catch (...) {
+      // The read references the buffers, which must outlive it.
+      if (read_next.valid()) {
+        read_next.wait();
+      }
+      throw;
+    }
+    if (read_next.valid()) {
+      read_next.get();
+    }
+  }
+}
+
 template <typename TKey, typename TValue>
 void* RawModelLoader<TKey, TValue>::getvectors() {
   return embedding_table_->vectors.data();
@@ -18,16 +18,33 @@
 #include <boost/interprocess/sync/sharable_lock.hpp>
 #include <boost/utility/string_view.hpp>
 #include <core23/logger.hpp>
+#include <cstring>
 #include <hps/hash_map_backend_detail.hpp>
 #include <hps/hier_parameter_server_base.hpp>
 #include <hps/mp_hash_map_backend.hpp>
+#include <numa.h>
+#include <numaif.h>
 #include <random>
+#include <sched.h>
+#include <unistd.h>
 
 // TODO: Remove me!
 #pragma GCC diagnostic error "-Wconversion"
 
 namespace HugeCTR {
 
+/**
+ * @return The NUMA node of the CPU that the calling thread is running on, or -1 if unknown.
+ */
+inline int current_numa_node() {
+  static const bool has_numa{numa_available() >= 0};
+  if (!has_numa) {
+    return -1;
+  }
+  const int cpu{sched_getcpu()};
+  return cpu < 0 ? -1 : numa_node_of_cpu(cpu);
+}
+
 template <typename Key>
 MultiProcessHashMapBackend<Key>::MultiProcessHashMapBackend(
     const MultiProcessHashMapBackendParams& params)
@@ -218,9 +235,16 @@ size_t MultiProcessHashMapBackend<Key>::insert(const std::string& table_name,
   if (parts.empty()) {
     HCTR_CHECK(value_size > 0 && value_size <= this->params_.allocation_rate);
 
+    const DatabaseValueFormat_t value_format{table_value_format(this->params_, table_name)};
+    if (!is_value_format_applicable(value_format, value_size)) {
+      sm_->tables.erase(tables_it);
+      HCTR_OWN_THROW(Error_t::WrongInput, "Table ", table_name, " has ", value_size,
+                     " byte values, which cannot be stored as ", value_format, ".");
+    }
+
     parts.reserve(this->params_.num_partitions);
     while (parts.size() < this->params_.num_partitions) {
-      parts.emplace_back(value_size, this->params_, sm_segment_);
+      parts.emplace_back(value_size, value_format, this->params_, sm_segment_);
     }
   }
 
@@ -255,6 +279,8 @@ size_t MultiProcessHashMapBackend<Key>::insert(const std::string& table_name,
                  num_inserts - prev_num_inserts, " + updated ",
                  batch_size - num_inserts + prev_num_inserts, " = ", batch_size, " entries.\n");
     }
+
+    place_partition_(table_name, part_index, part);
   } else {
     std::atomic<size_t> joint_num_inserts{0};
 
@@ -284,6 +310,7 @@ size_t MultiProcessHashMapBackend<Key>::insert(const std::string& table_name,
                    " entries.\n");
       }
 
+      place_partition_(table_name, part_index, part);
       joint_num_inserts += num_inserts;
     });
 
@@ -315,6 +342,7 @@ size_t MultiProcessHashMapBackend<Key>::fetch(const std::string& table_name, con
   const Key* const keys_end{&keys[num_keys]};
   const size_t num_partitions{parts.size()};
   const size_t max_batch_size{this->params_.max_batch_size};
+  const int numa_node{this->params_.numa_aware ? current_numa_node() : -1};
 
   size_t miss_count{0};
   size_t skip_count{0};
@@ -341,6 +369,8 @@ size_t MultiProcessHashMapBackend<Key>::fetch(const std::string& table_name, con
                  batch_size - miss_count + prev_miss_count, " / ", batch_size,
                  " hits. Time: ", elapsed.count(), " / ", time_budget.count(), " ns.\n");
     }
+
+    record_numa_access_(part, numa_node, num_keys - skip_count);
   } else {
     std::atomic<size_t> joint_miss_count{0};
     std::atomic<size_t> joint_skip_count{0};
@@ -351,6 +381,7 @@ size_t MultiProcessHashMapBackend<Key>::fetch(const std::string& table_name, con
       const DatabaseOverflowPolicy_t overflow_policy{part.overflow_policy};
 
       size_t miss_count{0};
+      size_t num_accesses{0};
 
       // Step through input batch-by-batch.
       std::chrono::nanoseconds elapsed;
@@ -361,6 +392,7 @@ size_t MultiProcessHashMapBackend<Key>::fetch(const std::string& table_name, con
         const size_t prev_miss_count{miss_count};
         size_t batch_size{0};
         HCTR_HPS_HASH_MAP_FETCH_(PARALLEL_DIRECT);
+        num_accesses += batch_size;
 
         HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
                    ", batch ", num_batches, ": ", batch_size - miss_count + prev_miss_count, " / ",
@@ -368,6 +400,7 @@ size_t MultiProcessHashMapBackend<Key>::fetch(const std::string& table_name, con
                    " ns.\n");
       }
 
+      record_numa_access_(part, numa_node, num_accesses);
       joint_miss_count += miss_count;
     });
 
@@ -402,6 +435,7 @@ size_t MultiProcessHashMapBackend<Key>::fetch(const std::string& table_name,
   const size_t* const indices_end{&indices[num_indices]};
   const size_t num_partitions{parts.size()};
   const size_t max_batch_size{this->params_.max_batch_size};
+  const int numa_node{this->params_.numa_aware ? current_numa_node() : -1};
 
   size_t miss_count{0};
   size_t skip_count{0};
@@ -428,6 +462,8 @@ size_t MultiProcessHashMapBackend<Key>::fetch(const std::string& table_name,
                  batch_size - miss_count + prev_miss_count, " / ", batch_size,
                  " hits. Time: ", elapsed.count(), " / ", time_budget.count(), " ns.\n");
     }
+
+    record_numa_access_(part, numa_node, num_indices - skip_count);
   } else {
     std::atomic<size_t> joint_miss_count{0};
     std::atomic<size_t> joint_skip_count{0};
@@ -438,6 +474,7 @@ size_t MultiProcessHashMapBackend<Key>::fetch(const std::string& table_name,
       const DatabaseOverflowPolicy_t overflow_policy{part.overflow_policy};
 
       size_t miss_count{0};
+      size_t num_accesses{0};
 
       // Step through input batch-by-batch.
       std::chrono::nanoseconds elapsed;
@@ -448,6 +485,7 @@ size_t MultiProcessHashMapBackend<Key>::fetch(const std::string& table_name,
         const size_t prev_miss_count{miss_count};
         size_t batch_size{0};
         HCTR_HPS_HASH_MAP_FETCH_(PARALLEL_INDIRECT);
+        num_accesses += batch_size;
 
         HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
                    ", batch ", num_batches, ": ", batch_size - miss_count + prev_miss_count, " / ",
@@ -455,6 +493,7 @@ size_t MultiProcessHashMapBackend<Key>::fetch(const std::string& table_name,
                    " ns.\n");
       }
 
+      record_numa_access_(part, numa_node, num_accesses);
       joint_miss_count += miss_count;
     });
 
@@ -590,11 +629,13 @@ size_t MultiProcessHashMapBackend<Key>::dump_bin(const std::string& table_name,
 
   // Store values.
   size_t num_entries{0};
+  std::vector<char> value(value_size);
 
   for (const Partition& part : parts) {
     for (const Entry& entry : part.entries) {
       file.write(reinterpret_cast<const char*>(&entry.first), sizeof(Key));
-      file.write(entry.second.value.get(), value_size);
+      part.decode_value(entry.second.value, value.data());
+      file.write(value.data(), value_size);
     }
     num_entries += part.entries.size();
   }
@@ -615,28 +656,29 @@ size_t MultiProcessHashMapBackend<Key>::dump_sst(const std::string& table_name,
   }
   const SharedVector<Partition>& parts{tables_it->second};
 
-  // Sort keys by value.
-  std::vector<const Entry*> entries;
+  // Sort keys by value. Values are decoded one by one, so we also remember their partition.
+  std::vector<std::pair<const Entry*, const Partition*>> entries;
   entries.reserve(
       std::accumulate(parts.begin(), parts.end(), UINT64_C(0),
                       [](const size_t a, const Partition& b) { return a + b.entries.size(); }));
   for (const Partition& part : parts) {
     for (const Entry& entry : part.entries) {
-      entries.emplace_back(&entry);
+      entries.emplace_back(&entry, &part);
     }
   }
   // TODO: Copy or ref? Chose ref because low memory footprint, but has worse cache locality.
   // Benchmark?
   std::sort(entries.begin(), entries.end(),
-            [](const auto& a, const auto& b) { return a->first < b->first; });
+            [](const auto& a, const auto& b) { return a.first->first < b.first->first; });
 
   // Iterate over pairs and insert.
+  std::vector<char> value(parts.empty() ? 0 : parts.front().value_size);
   rocksdb::Slice k_view{nullptr, sizeof(Key)};
-  rocksdb::Slice v_view{nullptr, parts.empty() ? 0 : parts.front().value_size};
+  rocksdb::Slice v_view{value.data(), value.size()};
 
-  for (const Entry* const entry : entries) {
+  for (const auto& [entry, part] : entries) {
     k_view.data_ = reinterpret_cast<const char*>(&entry->first);
-    v_view.data_ = entry->second.value.get();
+    part->decode_value(entry->second.value, value.data());
     HCTR_ROCKSDB_CHECK(file.Put(k_view, v_view));
   }
 
@@ -644,6 +686,28 @@ size_t MultiProcessHashMapBackend<Key>::dump_sst(const std::string& table_name,
 }
 #endif  // HCTR_USE_ROCKS_DB
 
+template <typename Key>
+MultiProcessHashMapBackendNumaStats MultiProcessHashMapBackend<Key>::numa_stats(
+    const std::string& table_name) const {
+  const boost::interprocess::sharable_lock lock(sm_->read_write_guard);
+
+  MultiProcessHashMapBackendNumaStats stats;
+
+  // Locate the partitions.
+  const auto& tables_it{sm_->tables.find({table_name.c_str(), char_allocator_})};
+  if (tables_it == sm_->tables.end()) {
+    return stats;
+  }
+  const SharedVector<Partition>& parts{tables_it->second};
+
+  for (const Partition& part : parts) {
+    stats.num_local_accesses += __atomic_load_n(&part.num_local_accesses, __ATOMIC_RELAXED);
+    stats.num_remote_accesses += __atomic_load_n(&part.num_remote_accesses, __ATOMIC_RELAXED);
+    stats.num_unplaced_accesses += __atomic_load_n(&part.num_unplaced_accesses, __ATOMIC_RELAXED);
+  }
+  return stats;
+}
+
 template <typename Key>
 size_t MultiProcessHashMapBackend<Key>::resolve_overflow_(const std::string& table_name,
                                                           const size_t part_index,
@@ -767,11 +831,110 @@ size_t MultiProcessHashMapBackend<Key>::resolve_overflow_(const std::string& tab
         }
       }
     } break;
+
+    case DatabaseOverflowPolicy_t::EvictClock: {
+      // Sweep over the partition like a clock hand. Referenced entries get a second chance (i.e.,
+      // we clear their reference bit), while unreferenced entries are evicted. There is no need to
+      // sort, and each entry is visited at most twice. Hence, eviction is O(1) amortized.
+      std::vector<Key> keys;
+      keys.reserve(std::min(part.entries.size(), max_batch_size));
+
+      while (part.entries.size() > this->overflow_resolution_margin_) {
+        const size_t batch_size{std::min<size_t>(
+            part.entries.size() - this->overflow_resolution_margin_, max_batch_size)};
+
+        HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                   " is overflowing (size = ", part.entries.size(), " > ", part.overflow_margin,
+                   "): Attempting to evict ", batch_size, " UNREFERENCED key/value pairs!\n");
+
+        // Advance clock hand.
+        keys.clear();
+        for (auto& entry : part.entries) {
+          Payload& payload{entry.second};
+          if (payload.referenced) {
+            payload.referenced = 0;
+          } else {
+            keys.emplace_back(entry.first);
+            if (keys.size() >= batch_size) {
+              break;
+            }
+          }
+        }
+
+        // Call erase for all victims.
+        for (const Key& key : keys) {
+          const Key* const k{&key};
+          HCTR_HPS_HASH_MAP_EVICT_K_();
+        }
+      }
+    } break;
   }
 
   return num_deletions;
 }
 
+template <typename Key>
+void MultiProcessHashMapBackend<Key>::record_numa_access_(Partition& part, const int numa_node,
+                                                          const size_t num_accesses) const {
+  if (numa_node < 0 || static_cast<size_t>(numa_node) >= max_numa_nodes || !num_accesses) {
+    return;
+  }
+
+  // Only a shared lock is held. Hence, other processes may update the counters concurrently.
+  __atomic_fetch_add(&part.num_node_accesses[numa_node], num_accesses, __ATOMIC_RELAXED);
+  if (part.numa_node < 0) {
+    __atomic_fetch_add(&part.num_unplaced_accesses, num_accesses, __ATOMIC_RELAXED);
+  } else if (part.numa_node == numa_node) {
+    __atomic_fetch_add(&part.num_local_accesses, num_accesses, __ATOMIC_RELAXED);
+  } else {
+    __atomic_fetch_add(&part.num_remote_accesses, num_accesses, __ATOMIC_RELAXED);
+  }
+}
+
+template <typename Key>
+void MultiProcessHashMapBackend<Key>::place_partition_(const std::string& table_name,
+                                                       const size_t part_index, Partition& part) {
+  if (!this->params_.numa_aware) {
+    return;
+  }
+
+  // Find the node that accesses this partition most often.
+  const uint64_t* const max_it{
+      std::max_element(std::begin(part.num_node_accesses), std::end(part.num_node_accesses))};
+  if (!*max_it) {
+    // Nobody looked up anything yet. Rely on the OS' first touch policy.
+    return;
+  }
+  const int numa_node{static_cast<int>(max_it - part.num_node_accesses)};
+
+  // If the partition has a new home, migrate all pages. Else, only bind pages allocated since.
+  const bool migrate{numa_node != part.numa_node};
+  static const uintptr_t page_size{static_cast<uintptr_t>(sysconf(_SC_PAGESIZE))};
+  const unsigned long node_mask{1UL << numa_node};
+
+  for (size_t i{migrate ? 0 : part.num_placed_pages}; i < part.value_pages.size(); ++i) {
+    ValuePage& value_page{part.value_pages[i]};
+
+    const uintptr_t first{reinterpret_cast<uintptr_t>(value_page.data()) & ~(page_size - 1)};
+    const uintptr_t last{reinterpret_cast<uintptr_t>(value_page.data() + value_page.size())};
+    const unsigned long length{(last - first + page_size - 1) & ~(page_size - 1)};
+    if (mbind(reinterpret_cast<void*>(first), length, MPOL_PREFERRED, &node_mask,
+              sizeof(node_mask) * 8, migrate ? MPOL_MF_MOVE : 0)) {
+      HCTR_LOG_C(DEBUG, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                 ": Unable to place value page ", i, " on NUMA node ", numa_node, ": ",
+                 std::strerror(errno), ".\n");
+    }
+  }
+
+  if (migrate) {
+    HCTR_LOG_C(DEBUG, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+               ": Moved ", part.value_pages.size(), " value pages from NUMA node ",
+               part.numa_node, " to ", numa_node, ".\n");
+  }
+  part.numa_node = numa_node;
+  part.num_placed_pages = part.value_pages.size();
+}
+
 template class MultiProcessHashMapBackend<unsigned int>;
 template class MultiProcessHashMapBackend<long long>;
 
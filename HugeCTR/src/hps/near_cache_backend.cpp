@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <core23/logger.hpp>
+#include <hps/near_cache_backend.hpp>
+#include <limits>
+
+// TODO: Remove me!
+#pragma GCC diagnostic error "-Wconversion"
+
+namespace HugeCTR {
+
+template <typename Key>
+NearCacheBackend<Key>::NearCacheBackend(std::unique_ptr<Base> backend,
+                                        const HashMapBackendParams& near_cache_params,
+                                        const std::chrono::milliseconds& ttl)
+    : Base(near_cache_params.max_batch_size, near_cache_params.load_dump_num_threads,
+           near_cache_params.load_dump_direct_io),
+      backend_{std::move(backend)},
+      near_cache_{std::make_unique<HashMapBackend<Key>>(near_cache_params)},
+      ttl_{ttl},
+      name_{std::string("NearCache(") + backend_->get_name() + ")"},
+      next_expiry_{(std::chrono::steady_clock::now() + ttl_).time_since_epoch().count()} {
+  HCTR_CHECK_HINT(backend_, "The near cache needs a backend.");
+
+  auto& metrics = MetricsRegistry::get();
+  const std::string labels = "{backend=\"" + std::string(backend_->get_name()) + "\"}";
+  num_hits_ = &metrics.counter("hps_near_cache_hits" + labels);
+  num_misses_ = &metrics.counter("hps_near_cache_misses" + labels);
+}
+
+template <typename Key>
+size_t NearCacheBackend<Key>::contains(const std::string& table_name, const size_t num_keys,
+                                       const Key* const keys,
+                                       const std::chrono::nanoseconds& time_budget) const {
+  return backend_->contains(table_name, num_keys, keys, time_budget);
+}
+
+template <typename Key>
+size_t NearCacheBackend<Key>::insert(const std::string& table_name, const size_t num_pairs,
+                                     const Key* const keys, const char* const values,
+                                     const uint32_t value_size, const size_t value_stride) {
+  const size_t num_inserted{
+      backend_->insert(table_name, num_pairs, keys, values, value_size, value_stride)};
+  invalidate(table_name, num_pairs, keys);
+  return num_inserted;
+}
+
+template <typename Key>
+size_t NearCacheBackend<Key>::fetch(const std::string& table_name, const size_t num_keys,
+                                    const Key* const keys, char* const values,
+                                    const size_t value_stride, const DatabaseMissCallback& on_miss,
+                                    const std::chrono::nanoseconds& time_budget) {
+  expire_();
+
+  // Remember the keys that are not in the near cache.
+  constexpr size_t invalid_index{std::numeric_limits<size_t>::max()};
+  std::vector<size_t> indices(num_keys, invalid_index);
+  const size_t hit_count{near_cache_->fetch(
+      table_name, num_keys, keys, values, value_stride,
+      [&](const size_t index) { indices[index] = index; }, time_budget)};
+  indices.erase(std::remove(indices.begin(), indices.end(), invalid_index), indices.end());
+  num_hits_->add(hit_count);
+
+  return hit_count + fetch_from_backend_(table_name, indices, keys, values, value_stride, on_miss,
+                                         time_budget);
+}
+
+template <typename Key>
+size_t NearCacheBackend<Key>::fetch(const std::string& table_name, const size_t num_indices,
+                                    const size_t* const indices, const Key* const keys,
+                                    char* const values, const size_t value_stride,
+                                    const DatabaseMissCallback& on_miss,
+                                    const std::chrono::nanoseconds& time_budget) {
+  expire_();
+
+  // Remember the keys that are not in the near cache. The misses of different partitions are
+  // reported concurrently.
+  std::vector<size_t> missing_indices;
+  std::mutex missing_indices_guard;
+  const size_t hit_count{near_cache_->fetch(
+      table_name, num_indices, indices, keys, values, value_stride,
+      [&](const size_t index) {
+        const std::lock_guard lock(missing_indices_guard);
+        missing_indices.emplace_back(index);
+      },
+      time_budget)};
+  num_hits_->add(hit_count);
+
+  return hit_count + fetch_from_backend_(table_name, missing_indices, keys, values, value_stride,
+                                         on_miss, time_budget);
+}
+
+template <typename Key>
+size_t NearCacheBackend<Key>::fetch_from_backend_(
+    const std::string& table_name, const std::vector<size_t>& indices, const Key* const keys,
+    char* const values, const size_t value_stride, const DatabaseMissCallback& on_miss,
+    const std::chrono::nanoseconds& time_budget) {
+  if (indices.empty()) {
+    return 0;
+  }
+  num_misses_->add(indices.size());
+
+  // Keys that the backend does not have either are not cached, so that they are looked up in the
+  // next tier every time.
+  std::unordered_set<size_t> missing_indices;
+  std::mutex missing_indices_guard;
+  const size_t hit_count{backend_->fetch(
+      table_name, indices.size(), indices.data(), keys, values, value_stride,
+      [&](const size_t index) {
+        {
+          const std::lock_guard lock(missing_indices_guard);
+          missing_indices.emplace(index);
+        }
+        on_miss(index);
+      },
+      time_budget)};
+  if (!hit_count) {
+    return 0;
+  }
+
+  std::vector<Key> found_keys;
+  std::vector<char> found_values;
+  found_keys.reserve(hit_count);
+  found_values.reserve(hit_count * value_stride);
+  for (const size_t index : indices) {
+    if (!missing_indices.count(index)) {
+      found_keys.emplace_back(keys[index]);
+      const char* const value{&values[index * value_stride]};
+      found_values.insert(found_values.end(), value, &value[value_stride]);
+    }
+  }
+  {
+    const std::lock_guard lock(tables_guard_);
+    tables_.emplace(table_name);
+  }
+  near_cache_->insert(table_name, found_keys.size(), found_keys.data(), found_values.data(),
+                      static_cast<uint32_t>(value_stride), value_stride);
+  return hit_count;
+}
+
+template <typename Key>
+size_t NearCacheBackend<Key>::evict(const std::string& table_name) {
+  {
+    const std::lock_guard lock(tables_guard_);
+    tables_.erase(table_name);
+  }
+  near_cache_->evict(table_name);
+  return backend_->evict(table_name);
+}
+
+template <typename Key>
+size_t NearCacheBackend<Key>::evict(const std::string& table_name, const size_t num_keys,
+                                    const Key* const keys) {
+  const size_t num_deleted{backend_->evict(table_name, num_keys, keys)};
+  invalidate(table_name, num_keys, keys);
+  return num_deleted;
+}
+
+template <typename Key>
+size_t NearCacheBackend<Key>::invalidate(const std::string& table_name, const size_t num_keys,
+                                         const Key* const keys) {
+  return near_cache_->evict(table_name, num_keys, keys);
+}
+
+template <typename Key>
+void NearCacheBackend<Key>::expire_() {
+  if (ttl_ == std::chrono::nanoseconds::zero()) {
+    return;
+  }
+  const auto now{std::chrono::steady_clock::now().time_since_epoch().count()};
+  auto next_expiry{next_expiry_.load(std::memory_order_relaxed)};
+  if (now < next_expiry) {
+    return;
+  }
+  // Only one of the concurrent lookups drops the entries.
+  const auto ttl{std::chrono::duration_cast<std::chrono::steady_clock::duration>(ttl_)};
+  if (!next_expiry_.compare_exchange_strong(next_expiry, now + ttl.count())) {
+    return;
+  }
+
+  std::vector<std::string> table_names;
+  {
+    const std::lock_guard lock(tables_guard_);
+    table_names.assign(tables_.begin(), tables_.end());
+    tables_.clear();
+  }
+  size_t num_deleted{0};
+  for (const std::string& table_name : table_names) {
+    num_deleted += near_cache_->evict(table_name);
+  }
+  HCTR_LOG_C(DEBUG, WORLD, get_name(), " backend; Expired ", num_deleted, " entries of ",
+             table_names.size(), " tables.\n");
+}
+
+template class NearCacheBackend<unsigned int>;
+template class NearCacheBackend<long long>;
+
+}  // namespace HugeCTR
@@ -45,4 +45,23 @@ void Facade::forward(const char* model_name, int32_t table_id, int32_t global_re
                            emb_vec_size, d_keys, d_vectors, i64_input_tensor, context_stream);
 }
 
+void Facade::forward(const char* model_name, int32_t global_replica_id,
+                     const std::vector<size_t>& num_keys, const std::vector<size_t>& emb_vec_sizes,
+                     const std::vector<const void*>& d_keys, const std::vector<void*>& d_vectors,
+                     bool i64_input_tensor, cudaStream_t context_stream) {
+  lookup_manager_->forward(std::string(model_name), global_replica_id, num_keys, emb_vec_sizes,
+                           d_keys, d_vectors, i64_input_tensor, context_stream);
+}
+
+bool Facade::is_stream_ordered(const char* model_name) const {
+  return lookup_manager_->is_stream_ordered(std::string(model_name));
+}
+
+void Facade::update(const char* model_name, int32_t table_id, int32_t global_replica_id,
+                    size_t num_keys, size_t emb_vec_size, const void* d_keys,
+                    const float* d_vectors, bool i64_input_tensor, cudaStream_t context_stream) {
+  lookup_manager_->update(std::string(model_name), table_id, global_replica_id, num_keys,
+                          emb_vec_size, d_keys, d_vectors, i64_input_tensor, context_stream);
+}
+
 }  // namespace HierarchicalParameterServer
\ No newline at end of file
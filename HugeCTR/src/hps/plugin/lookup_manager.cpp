@@ -69,7 +69,10 @@ void LookupManager::forward(const std::string& model_name, int32_t table_id,
   auto lookup_session =
       lookup_session_map_.find(model_name)->second.find(global_replica_id)->second;
   auto inference_params = lookup_session->get_inference_params();
-  if (inference_params.use_context_stream) {
+  if (inference_params.use_capturable_lookup) {
+    lookup_session->lookup_from_device_capturable(
+        values_ptr, reinterpret_cast<float*>(emb_vector_ptr), num_keys, table_id, context_stream);
+  } else if (inference_params.use_context_stream) {
     lookup_session->lookup_from_device(values_ptr, reinterpret_cast<float*>(emb_vector_ptr),
                                        num_keys, table_id, context_stream);
   } else {
@@ -79,6 +82,78 @@ void LookupManager::forward(const std::string& model_name, int32_t table_id,
   }
 }
 
+void LookupManager::forward(const std::string& model_name, int32_t global_replica_id,
+                            const std::vector<size_t>& num_keys_per_table,
+                            const std::vector<size_t>& emb_vec_size_per_table,
+                            const std::vector<const void*>& values_ptrs,
+                            const std::vector<void*>& emb_vector_ptrs, bool i64_input_tensor,
+                            cudaStream_t context_stream) {
+  const size_t num_tables = values_ptrs.size();
+  HCTR_CHECK_HINT(num_keys_per_table.size() == num_tables &&
+                      emb_vec_size_per_table.size() == num_tables &&
+                      emb_vector_ptrs.size() == num_tables,
+                  "The keys, the sizes and the outputs must be given for every table");
+  for (size_t table_id = 0; table_id < num_tables; ++table_id) {
+    if (!forward_check(model_name, static_cast<int32_t>(table_id), global_replica_id,
+                       num_keys_per_table[table_id], emb_vec_size_per_table[table_id],
+                       i64_input_tensor)) {
+      return;
+    }
+  }
+  auto lookup_session =
+      lookup_session_map_.find(model_name)->second.find(global_replica_id)->second;
+  auto inference_params = lookup_session->get_inference_params();
+  std::vector<float*> d_vectors_per_table;
+  for (void* ptr : emb_vector_ptrs) {
+    d_vectors_per_table.push_back(reinterpret_cast<float*>(ptr));
+  }
+
+  // The capturable lookup must stay on the context stream, so the tables go one by one.
+  if (inference_params.use_capturable_lookup) {
+    for (size_t table_id = 0; table_id < num_tables; ++table_id) {
+      lookup_session->lookup_from_device_capturable(
+          values_ptrs[table_id], d_vectors_per_table[table_id], num_keys_per_table[table_id],
+          table_id, context_stream);
+    }
+    return;
+  }
+  // As for a single table, the context stream is not handed over to the streams of the session.
+  if (inference_params.use_context_stream) {
+    for (size_t table_id = 0; table_id < num_tables; ++table_id) {
+      lookup_session->lookup_from_device(values_ptrs[table_id], d_vectors_per_table[table_id],
+                                         num_keys_per_table[table_id], table_id, context_stream);
+    }
+    return;
+  }
+  // The multi-table lookup runs on the streams of the session and returns once they are done.
+  HCTR_LIB_THROW(cudaStreamSynchronize(context_stream));
+  lookup_session->lookup_from_device(values_ptrs, d_vectors_per_table, num_keys_per_table);
+}
+
+void LookupManager::update(const std::string& model_name, int32_t table_id,
+                           int32_t global_replica_id, size_t num_keys, size_t emb_vec_size,
+                           const void* d_keys, const float* d_vectors, bool i64_input_tensor,
+                           cudaStream_t context_stream) {
+  // The number of rows of a table is not bounded by the lookup batch, so it is not checked here.
+  HCTR_THROW_IF(
+      !forward_check(model_name, table_id, global_replica_id, 0, emb_vec_size, i64_input_tensor),
+      Error_t::WrongInput, "Cannot update table ", table_id, " of model ", model_name);
+  auto lookup_session =
+      lookup_session_map_.find(model_name)->second.find(global_replica_id)->second;
+  HCTR_THROW_IF(lookup_session->get_inference_params().fuse_embedding_table, Error_t::WrongInput,
+                "Tables cannot be updated from device when fuse_embedding_table is enabled");
+  auto embedding_cache = parameter_server_->get_embedding_cache(model_name, global_replica_id);
+  embedding_cache->load_from_device(table_id, d_keys, d_vectors, num_keys, context_stream);
+}
+
+bool LookupManager::is_stream_ordered(const std::string& model_name) const {
+  const auto it = lookup_session_map_.find(model_name);
+  if (it == lookup_session_map_.end() || it->second.empty()) {
+    return false;
+  }
+  return it->second.begin()->second->get_inference_params().use_capturable_lookup;
+}
+
 bool LookupManager::init_check(parameter_server_config& ps_config, int32_t global_batch_size,
                                const int32_t num_replicas_in_sync, pluginType_t plugin_type) const {
   switch (plugin_type) {
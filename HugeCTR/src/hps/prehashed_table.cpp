@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cuda_runtime.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <core23/logger.hpp>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <hash_functions.cuh>
+#include <hps/prehashed_table.hpp>
+#include <limits>
+#include <vector>
+
+namespace HugeCTR {
+
+namespace {
+
+constexpr char prehashed_table_magic[8] = {'H', 'C', 'T', 'R', 'P', 'H', 'T', '\0'};
+constexpr uint32_t prehashed_table_version{1};
+constexpr uint64_t prehashed_table_alignment{4096};
+
+inline uint64_t align_section(const uint64_t offset) {
+  return (offset + prehashed_table_alignment - 1) / prehashed_table_alignment *
+         prehashed_table_alignment;
+}
+
+/**
+ * Walks the probe sequence of gpu_cache::StaticHashTable: the groups of 16 slots at 0, 16, 48,
+ * 96, ... slots after the group of the hash. Tables are filled in this order, so the walk can stop
+ * at the first empty slot.
+ *
+ * @return The slot of the key, or the first empty slot, or num_slots if there is neither.
+ */
+template <typename Key>
+uint64_t probe(const Key* const keys, const uint64_t num_slots, const Key key) {
+  constexpr uint64_t group_size{PrehashedTable<Key>::group_size};
+  const uint64_t mask{num_slots - 1};
+  uint64_t group{static_cast<uint64_t>(MurmurHash3_32<Key>::hash(key)) & mask & ~(group_size - 1)};
+  for (uint64_t step{0}; step < num_slots / group_size; ++step) {
+    for (uint64_t slot{group}; slot < group + group_size; ++slot) {
+      if (keys[slot] == key || keys[slot] == PrehashedTable<Key>::empty_key) {
+        return slot;
+      }
+    }
+    group = (group + group_size * (step + 1)) & mask;
+  }
+  return num_slots;
+}
+
+}  // namespace
+
+template <typename Key>
+PrehashedTable<Key>::PrehashedTable(const std::string& path) {
+  const int fd{open(path.c_str(), O_RDONLY)};
+  HCTR_THROW_IF(fd < 0, Error_t::FileCannotOpen, "Unable to open pre-hashed table '", path,
+                "': ", std::strerror(errno));
+  struct stat file_stat;
+  const bool stat_failed{fstat(fd, &file_stat) != 0};
+  if (!stat_failed && file_stat.st_size > 0) {
+    size_ = static_cast<size_t>(file_stat.st_size);
+    data_ = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  HCTR_THROW_IF(stat_failed || !data_ || data_ == MAP_FAILED, Error_t::FileCannotOpen,
+                "Unable to map pre-hashed table '", path, "'.");
+  // Lookups hit random pages, reading ahead would only pollute the page cache.
+  madvise(data_, size_, MADV_RANDOM);
+
+  const char* const bytes{static_cast<const char*>(data_)};
+  header_ = reinterpret_cast<const PrehashedTableHeader*>(bytes);
+  const char* error{nullptr};
+  if (size_ < sizeof(PrehashedTableHeader) ||
+      std::memcmp(header_->magic, prehashed_table_magic, sizeof(prehashed_table_magic)) != 0) {
+    error = "not a pre-hashed table";
+  } else if (header_->version != prehashed_table_version) {
+    error = "unsupported version";
+  } else if (header_->key_size != sizeof(Key)) {
+    error = "wrong key size";
+  } else if (header_->num_slots < group_size ||
+             (header_->num_slots & (header_->num_slots - 1)) != 0) {
+    error = "the number of slots is not a power of 2";
+  } else if (header_->keys_offset + (header_->num_slots + 1) * sizeof(Key) > size_ ||
+             header_->rows_offset + (header_->num_slots + 1) * sizeof(uint32_t) > size_ ||
+             header_->values_offset + header_->num_rows * header_->value_size > size_) {
+    error = "truncated";
+  }
+  if (error) {
+    munmap(data_, size_);
+    HCTR_OWN_THROW(Error_t::BrokenFile,
+                   "Pre-hashed table '" + path + "' is invalid: " + std::string(error) + ".");
+  }
+  keys_ = reinterpret_cast<const Key*>(bytes + header_->keys_offset);
+  rows_ = reinterpret_cast<const uint32_t*>(bytes + header_->rows_offset);
+  values_ = bytes + header_->values_offset;
+}
+
+template <typename Key>
+PrehashedTable<Key>::~PrehashedTable() {
+  munmap(data_, size_);
+}
+
+template <typename Key>
+const char* PrehashedTable<Key>::find(const Key key) const {
+  // The extra slot holds the empty key, if the table contains it.
+  uint64_t slot{num_slots()};
+  if (key != empty_key) {
+    slot = probe(keys_, num_slots(), key);
+    if (slot == num_slots()) {
+      return nullptr;
+    }
+  }
+  if (keys_[slot] != key) {
+    return nullptr;
+  }
+  return &values_[static_cast<size_t>(rows_[slot]) * value_size()];
+}
+
+template <typename Key>
+std::string PrehashedTable<Key>::default_path(const std::string& model_path) {
+  return model_path + "/prehashed_table";
+}
+
+template <typename Key>
+size_t PrehashedTable<Key>::num_slots_for(const size_t capacity) {
+  size_t num_slots{group_size};
+  while (num_slots < capacity * 2) {
+    num_slots *= 2;
+  }
+  return num_slots;
+}
+
+template <typename Key>
+void PrehashedTable<Key>::write(const std::string& model_path, const std::string& path,
+                                const size_t capacity) {
+  const std::string key_file{model_path + "/key"};
+  const std::string vec_file{model_path + "/emb_vector"};
+  const std::string out_file{path.empty() ? default_path(model_path) : path};
+
+  // The raw model always stores 64 bit keys.
+  const size_t num_rows{std::filesystem::file_size(key_file) / sizeof(long long)};
+  const size_t vec_file_size{std::filesystem::file_size(vec_file)};
+  HCTR_THROW_IF(num_rows == 0 || vec_file_size % num_rows != 0, Error_t::WrongInput,
+                "The raw model '", model_path, "' is empty or its files do not match.");
+  HCTR_THROW_IF(num_rows > std::numeric_limits<uint32_t>::max() || capacity > UINT32_MAX,
+                Error_t::OutOfBound, "A pre-hashed table holds fewer than 2^32 keys.");
+  HCTR_THROW_IF(capacity != 0 && capacity < num_rows, Error_t::WrongInput,
+                "The capacity is smaller than the number of rows of '", model_path, "'.");
+
+  PrehashedTableHeader header{};
+  std::memcpy(header.magic, prehashed_table_magic, sizeof(prehashed_table_magic));
+  header.version = prehashed_table_version;
+  header.key_size = sizeof(Key);
+  header.value_size = vec_file_size / num_rows;
+  header.num_rows = num_rows;
+  header.num_slots = num_slots_for(capacity ? capacity : num_rows);
+  header.keys_offset = align_section(sizeof(PrehashedTableHeader));
+  header.rows_offset = align_section(header.keys_offset + (header.num_slots + 1) * sizeof(Key));
+  header.values_offset =
+      align_section(header.rows_offset + (header.num_slots + 1) * sizeof(uint32_t));
+
+  // Place the keys like gpu_cache::StaticHashTable::insert. The extra slot is 0 while the table
+  // does not contain the empty key.
+  std::vector<Key> keys(header.num_slots + 1, empty_key);
+  std::vector<uint32_t> rows(header.num_slots + 1, 0);
+  keys[header.num_slots] = 0;
+  {
+    std::ifstream key_stream(key_file, std::ios::binary);
+    std::vector<long long> chunk(1 << 20);
+    for (size_t row{0}; row < num_rows;) {
+      const size_t chunk_size{std::min(chunk.size(), num_rows - row)};
+      key_stream.read(reinterpret_cast<char*>(chunk.data()), chunk_size * sizeof(long long));
+      HCTR_THROW_IF(!key_stream, Error_t::BrokenFile, "Unable to read '", key_file, "'.");
+      for (size_t i{0}; i < chunk_size; ++i, ++row) {
+        const Key key{static_cast<Key>(chunk[i])};
+        uint64_t slot{header.num_slots};
+        if (key != empty_key) {
+          slot = probe(keys.data(), header.num_slots, key);
+          HCTR_CHECK(slot != header.num_slots);
+        }
+        if (keys[slot] == key) {
+          continue;
+        }
+        keys[slot] = key;
+        rows[slot] = static_cast<uint32_t>(row);
+        header.num_keys++;
+      }
+    }
+  }
+
+  std::ofstream out(out_file, std::ios::binary | std::ios::trunc);
+  HCTR_THROW_IF(!out, Error_t::FileCannotOpen, "Unable to create '", out_file, "'.");
+  auto write_section = [&out](const uint64_t offset, const void* const data, const size_t size) {
+    out.seekp(static_cast<std::streamoff>(offset));
+    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+  };
+  write_section(0, &header, sizeof(header));
+  write_section(header.keys_offset, keys.data(), keys.size() * sizeof(Key));
+  write_section(header.rows_offset, rows.data(), rows.size() * sizeof(uint32_t));
+
+  // The values are the rows of the raw model, as they are.
+  std::ifstream vec_stream(vec_file, std::ios::binary);
+  std::vector<char> chunk(64 << 20);
+  out.seekp(static_cast<std::streamoff>(header.values_offset));
+  for (size_t offset{0}; offset < vec_file_size;) {
+    const size_t chunk_size{std::min(chunk.size(), vec_file_size - offset)};
+    vec_stream.read(chunk.data(), static_cast<std::streamsize>(chunk_size));
+    HCTR_THROW_IF(!vec_stream, Error_t::BrokenFile, "Unable to read '", vec_file, "'.");
+    out.write(chunk.data(), static_cast<std::streamsize>(chunk_size));
+    offset += chunk_size;
+  }
+  out.close();
+  HCTR_THROW_IF(!out, Error_t::UnspecificError, "Unable to write '", out_file, "'.");
+
+  HCTR_LOG_S(INFO, WORLD) << "Wrote pre-hashed table " << out_file << ": " << header.num_keys
+                          << " keys in " << header.num_slots << " slots." << std::endl;
+}
+
+template class PrehashedTable<unsigned int>;
+template class PrehashedTable<long long>;
+
+}  // namespace HugeCTR
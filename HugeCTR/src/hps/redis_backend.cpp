@@ -76,6 +76,7 @@ RedisClusterBackend<Key>::RedisClusterBackend(const RedisClusterBackendParams& p
     : Base(params) {
   HCTR_CHECK(params.num_node_connections > 0);
   HCTR_CHECK(params.num_partitions >= params.num_node_connections);
+  HCTR_CHECK(params.max_pipeline_depth > 0);
 
   // Put together cluster configuration.
   sw::redis::ConnectionOptions options;
@@ -175,7 +176,8 @@ size_t RedisClusterBackend<Key>::contains(const std::string& table_name, const s
 
       // Step through keys batch-by-batch.
       std::chrono::nanoseconds elapsed;
-      for (const Key* k{keys}; k != keys_end;) {
+      size_t num_batches{0};
+      for (const Key* k{keys}; k != keys_end; num_batches += batch_offsets.size()) {
         HCTR_HPS_DB_CHECK_TIME_BUDGET_(SEQUENTIAL_DIRECT, nullptr);
 
         const size_t hit_count_prev{hit_count};
@@ -328,6 +330,7 @@ size_t RedisClusterBackend<Key>::fetch(const std::string& table_name, const size
 
   const Key* const keys_end{&keys[num_keys]};
   const size_t max_batch_size{this->params_.max_batch_size};
+  const size_t max_pipeline_depth{this->params_.max_pipeline_depth};
   const size_t num_partitions{this->params_.num_partitions};
 
   size_t miss_count{0};
@@ -342,24 +345,32 @@ size_t RedisClusterBackend<Key>::fetch(const std::string& table_name, const size
       HCTR_DEFINE_REDIS_VALUE_HKEY_();
 
       std::shared_ptr<std::vector<Key>> touched_keys;
-      HCTR_HPS_REDIS_FETCH_DEFINE_V_VIEWS();
       std::vector<sw::redis::StringView> k_views;
-      k_views.reserve(std::min(num_keys, max_batch_size));
+      k_views.reserve(std::min(num_keys, max_batch_size * max_pipeline_depth));
+      std::vector<size_t> batch_offsets;
+      batch_offsets.reserve(max_pipeline_depth);
+      sw::redis::Pipeline pipe{redis_->pipeline(hkey_v, false)};
 
-      // Step through input batch-by-batch.
+      // Step through input, sending up to `max_pipeline_depth` batches per round-trip.
       std::chrono::nanoseconds elapsed;
-      for (const Key* k{keys}; k != keys_end;) {
+      size_t num_batches{0};
+      for (const Key* k{keys}; k != keys_end; num_batches += batch_offsets.size()) {
         HCTR_HPS_DB_CHECK_TIME_BUDGET_(SEQUENTIAL_DIRECT, on_miss);
 
         const size_t prev_miss_count{miss_count};
-        const size_t batch_size{std::min<size_t>(keys_end - k, max_batch_size)};
-        if (!HCTR_HPS_REDIS_FETCH_(SEQUENTIAL_DIRECT)) {
+        k_views.clear();
+        batch_offsets.clear();
+        while (k != keys_end && batch_offsets.size() < max_pipeline_depth) {
+          const size_t batch_size{std::min<size_t>(keys_end - k, max_batch_size)};
+          HCTR_HPS_REDIS_FETCH_QUEUE_(SEQUENTIAL_DIRECT);
+        }
+        if (batch_offsets.empty() || !HCTR_HPS_REDIS_FETCH_EXEC_()) {
           break;
         }
 
         HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
-                   ", batch ", (k - keys - 1) / max_batch_size, ": ",
-                   batch_size - miss_count + prev_miss_count, " / ", batch_size,
+                   ", batches ", num_batches, "-", num_batches + batch_offsets.size() - 1, ": ",
+                   k_views.size() - miss_count + prev_miss_count, " / ", k_views.size(),
                    " hits. Time: ", elapsed.count(), " / ", time_budget.count(), " ns.\n");
 
         // Refresh metadata if required.
@@ -379,26 +390,35 @@ size_t RedisClusterBackend<Key>::fetch(const std::string& table_name, const size
         HCTR_DEFINE_REDIS_VALUE_HKEY_();
 
         std::shared_ptr<std::vector<Key>> touched_keys;
-        HCTR_HPS_REDIS_FETCH_DEFINE_V_VIEWS();
         std::vector<sw::redis::StringView> k_views;
-        k_views.reserve(std::min(num_keys / num_partitions, max_batch_size));
+        k_views.reserve(std::min(num_keys / num_partitions, max_batch_size * max_pipeline_depth));
+        std::vector<size_t> batch_offsets;
+        batch_offsets.reserve(max_pipeline_depth);
+        sw::redis::Pipeline pipe{redis_->pipeline(hkey_v, false)};
 
-        // Step through input batch-by-batch.
+        // Step through input, sending up to `max_pipeline_depth` batches per round-trip.
         std::chrono::nanoseconds elapsed;
         size_t num_batches{0};
-        for (const Key* k{keys}; k != keys_end; ++num_batches) {
+        for (const Key* k{keys}; k != keys_end; num_batches += batch_offsets.size()) {
           HCTR_HPS_DB_CHECK_TIME_BUDGET_(PARALLEL_DIRECT, on_miss);
 
           const size_t prev_miss_count{miss_count};
-          size_t batch_size{0};
-          if (!HCTR_HPS_REDIS_FETCH_(PARALLEL_DIRECT)) {
+          k_views.clear();
+          batch_offsets.clear();
+          while (batch_offsets.size() < max_pipeline_depth) {
+            size_t batch_size{0};
+            if (!HCTR_HPS_REDIS_FETCH_QUEUE_(PARALLEL_DIRECT)) {
+              break;
+            }
+          }
+          if (batch_offsets.empty() || !HCTR_HPS_REDIS_FETCH_EXEC_()) {
             break;
           }
 
           HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
-                     ", batch ", num_batches, ": ", batch_size - miss_count + prev_miss_count,
-                     " / ", batch_size, " hits. Time: ", elapsed.count(), " / ",
-                     time_budget.count(), " ns.\n");
+                     ", batches ", num_batches, "-", num_batches + batch_offsets.size() - 1, ": ",
+                     k_views.size() - miss_count + prev_miss_count, " / ", k_views.size(),
+                     " hits. Time: ", elapsed.count(), " / ", time_budget.count(), " ns.\n");
         }
 
         // Refresh metadata if required.
@@ -430,6 +450,7 @@ size_t RedisClusterBackend<Key>::fetch(const std::string& table_name, const size
 
   const size_t* const indices_end{&indices[num_indices]};
   const size_t max_batch_size{this->params_.max_batch_size};
+  const size_t max_pipeline_depth{this->params_.max_pipeline_depth};
   const size_t num_partitions{this->params_.num_partitions};
 
   size_t miss_count{0};
@@ -444,24 +465,32 @@ size_t RedisClusterBackend<Key>::fetch(const std::string& table_name, const size
       HCTR_DEFINE_REDIS_VALUE_HKEY_();
 
       std::shared_ptr<std::vector<Key>> touched_keys;
-      HCTR_HPS_REDIS_FETCH_DEFINE_V_VIEWS();
       std::vector<sw::redis::StringView> k_views;
-      k_views.reserve(std::min(num_indices, max_batch_size));
+      k_views.reserve(std::min(num_indices, max_batch_size * max_pipeline_depth));
+      std::vector<size_t> batch_offsets;
+      batch_offsets.reserve(max_pipeline_depth);
+      sw::redis::Pipeline pipe{redis_->pipeline(hkey_v, false)};
 
-      // Step through input batch-by-batch.
+      // Step through input, sending up to `max_pipeline_depth` batches per round-trip.
       std::chrono::nanoseconds elapsed;
-      for (const size_t* i{indices}; i != indices_end;) {
+      size_t num_batches{0};
+      for (const size_t* i{indices}; i != indices_end; num_batches += batch_offsets.size()) {
         HCTR_HPS_DB_CHECK_TIME_BUDGET_(SEQUENTIAL_INDIRECT, on_miss);
 
         const size_t prev_miss_count{miss_count};
-        const size_t batch_size{std::min<size_t>(indices_end - i, max_batch_size)};
-        if (!HCTR_HPS_REDIS_FETCH_(SEQUENTIAL_INDIRECT)) {
+        k_views.clear();
+        batch_offsets.clear();
+        while (i != indices_end && batch_offsets.size() < max_pipeline_depth) {
+          const size_t batch_size{std::min<size_t>(indices_end - i, max_batch_size)};
+          HCTR_HPS_REDIS_FETCH_QUEUE_(SEQUENTIAL_INDIRECT);
+        }
+        if (batch_offsets.empty() || !HCTR_HPS_REDIS_FETCH_EXEC_()) {
           break;
         }
 
         HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
-                   ", batch ", (i - indices - 1) / max_batch_size, ": ",
-                   batch_size - miss_count + prev_miss_count, " / ", batch_size,
+                   ", batches ", num_batches, "-", num_batches + batch_offsets.size() - 1, ": ",
+                   k_views.size() - miss_count + prev_miss_count, " / ", k_views.size(),
                    " hits. Time: ", elapsed.count(), " / ", time_budget.count(), " ns.\n");
       }
 
@@ -481,27 +510,37 @@ size_t RedisClusterBackend<Key>::fetch(const std::string& table_name, const size
         HCTR_DEFINE_REDIS_VALUE_HKEY_();
 
         std::shared_ptr<std::vector<Key>> touched_keys;
-        HCTR_HPS_REDIS_FETCH_DEFINE_V_VIEWS();
         std::vector<sw::redis::StringView> k_views;
-        k_views.reserve(std::min(num_indices / num_partitions, max_batch_size));
+        k_views.reserve(
+            std::min(num_indices / num_partitions, max_batch_size * max_pipeline_depth));
+        std::vector<size_t> batch_offsets;
+        batch_offsets.reserve(max_pipeline_depth);
+        sw::redis::Pipeline pipe{redis_->pipeline(hkey_v, false)};
 
-        // Step through input batch-by-batch.
+        // Step through input, sending up to `max_pipeline_depth` batches per round-trip.
         std::chrono::nanoseconds elapsed;
         size_t num_batches{0};
-        for (const size_t* i{indices}; i != indices_end; ++num_batches) {
+        for (const size_t* i{indices}; i != indices_end; num_batches += batch_offsets.size()) {
           HCTR_HPS_DB_CHECK_TIME_BUDGET_(PARALLEL_INDIRECT, on_miss);
 
           // Assemble query.
           const size_t prev_miss_count{miss_count};
-          size_t batch_size{0};
-          if (!HCTR_HPS_REDIS_FETCH_(PARALLEL_INDIRECT)) {
+          k_views.clear();
+          batch_offsets.clear();
+          while (batch_offsets.size() < max_pipeline_depth) {
+            size_t batch_size{0};
+            if (!HCTR_HPS_REDIS_FETCH_QUEUE_(PARALLEL_INDIRECT)) {
+              break;
+            }
+          }
+          if (batch_offsets.empty() || !HCTR_HPS_REDIS_FETCH_EXEC_()) {
             break;
           }
 
           HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
-                     ", batch ", num_batches, ": ", batch_size - miss_count + prev_miss_count,
-                     " / ", batch_size, " hits. Time: ", elapsed.count(), " / ",
-                     time_budget.count(), " ns.\n");
+                     ", batches ", num_batches, "-", num_batches + batch_offsets.size() - 1, ": ",
+                     k_views.size() - miss_count + prev_miss_count, " / ", k_views.size(),
+                     " hits. Time: ", elapsed.count(), " / ", time_budget.count(), " ns.\n");
         }
 
         // Refresh metadata if required.
@@ -954,6 +993,68 @@ void RedisClusterBackend<Key>::resolve_overflow_(const std::string& table_name,
         }
       }
     } break;
+
+    case DatabaseOverflowPolicy_t::EvictClock: {
+      // Fetch keys and reference bits.
+      std::vector<std::pair<Key, long long>> keys_metas;
+      keys_metas.reserve(part_size);
+      redis_->hgetall(hkey_m, RedisKeyAccumulatorVectorInserter<Key>(keys_metas));
+
+      part_size = keys_metas.size();
+      if (part_size <= this->overflow_resolution_margin_) {
+        HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                   ": Overflow was already resolved by another process.\n");
+        return;
+      }
+
+      // Sweep like a clock hand. Unreferenced keys are evicted first (in the order Redis returned
+      // them). Referenced keys get a second chance. No sorting required.
+      std::stable_partition(keys_metas.begin(), keys_metas.end(),
+                            [](const auto& km) { return km.second == 0; });
+
+      // Delete entries in batches until overflow condition is no longer fulfilled.
+      auto km_it{keys_metas.begin()};
+      {
+        std::vector<sw::redis::StringView> k_views;
+        k_views.reserve(std::min(part_size, max_batch_size));
+
+        while (km_it != keys_metas.end()) {
+          const size_t batch_size{std::min<size_t>(
+              std::min<size_t>(keys_metas.end() - km_it,
+                               part_size - this->overflow_resolution_margin_),
+              max_batch_size)};
+
+          HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                     " (size = ", part_size, "). Attempting to evict ", batch_size,
+                     " UNREFERENCED key/value pairs.\n");
+
+          // Assemble and launch query.
+          k_views.clear();
+          for (const auto batch_end{km_it + batch_size}; km_it != batch_end; ++km_it) {
+            k_views.emplace_back(reinterpret_cast<const char*>(&km_it->first), sizeof(Key));
+          }
+          delete_batch(k_views);
+          if (part_size <= this->overflow_resolution_margin_) {
+            break;
+          }
+        }
+      }
+
+      // Clear reference bits of all survivors.
+      if (km_it != keys_metas.end()) {
+        auto touched_keys{std::make_shared<std::vector<Key>>()};
+        touched_keys->reserve(keys_metas.end() - km_it);
+        for (; km_it != keys_metas.end(); ++km_it) {
+          if (km_it->second) {
+            touched_keys->emplace_back(km_it->first);
+          }
+        }
+
+        background_worker_.submit([this, table_name, part_index, touched_keys]() {
+          refresh_metadata_lfu_set_(table_name, part_index, *touched_keys, 0);
+        });
+      }
+    } break;
   }
 
   HCTR_LOG_C(DEBUG, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
@@ -1068,6 +1169,12 @@ void RedisClusterBackend<Key>::queue_metadata_refresh_(const std::string& table_
         refresh_metadata_lru_(table_name, part_index, *keys, now);
       });
     } break;
+
+    case DatabaseOverflowPolicy_t::EvictClock: {
+      background_worker_.submit([this, table_name, part_index, keys]() {
+        refresh_metadata_lfu_set_(table_name, part_index, *keys, 1);
+      });
+    } break;
   }
 }
 
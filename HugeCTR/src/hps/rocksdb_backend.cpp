@@ -14,7 +14,11 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <atomic>
 #include <core23/logger.hpp>
+#include <cstring>
+#include <fstream>
 #include <hps/hier_parameter_server_base.hpp>
 #include <hps/rocksdb_backend.hpp>
 #include <hps/rocksdb_backend_detail.hpp>
@@ -31,18 +35,37 @@ RocksDBBackend<Key>::RocksDBBackend(const RocksDBBackendParams& params)
     : Base(params), db_{nullptr} {
   HCTR_LOG(INFO, WORLD, "Connecting to RocksDB database...\n");
 
+  // Tables share one block cache. Otherwise, the settings mirror `OptimizeForPointLookup`.
+  rocksdb::BlockBasedTableOptions table_options;
+  table_options.data_block_index_type = rocksdb::BlockBasedTableOptions::kDataBlockBinaryAndHash;
+  table_options.data_block_hash_table_util_ratio = 0.75;
+  if (this->params_.bloom_filter_bits) {
+    table_options.filter_policy.reset(
+        rocksdb::NewBloomFilterPolicy(static_cast<double>(this->params_.bloom_filter_bits)));
+  }
+  if (this->params_.block_cache_size) {
+    table_options.block_cache = rocksdb::NewLRUCache(this->params_.block_cache_size);
+  } else {
+    table_options.no_block_cache = true;
+  }
+  const std::shared_ptr<rocksdb::TableFactory> table_factory{
+      rocksdb::NewBlockBasedTableFactory(table_options)};
+
   // Basic behavior.
   rocksdb::Options options;
   options.create_if_missing = true;
   options.manual_wal_flush = true;
+  options.use_direct_reads = this->params_.use_direct_reads;
   options.OptimizeForPointLookup(8);
   options.OptimizeLevelStyleCompaction();
+  options.table_factory = table_factory;
   HCTR_CHECK(this->params_.num_threads <= std::numeric_limits<int>::max());
   options.IncreaseParallelism(static_cast<int>(this->params_.num_threads));
 
   // Configure various behaviors and options used in later operations.
   column_family_options_.OptimizeForPointLookup(8);
   column_family_options_.OptimizeLevelStyleCompaction();
+  column_family_options_.table_factory = table_factory;
   // Need to tune: read_options_.readahead_size
   // Need to tune: read_options_.verify_checksums
   write_options_.sync = false;
@@ -140,9 +163,9 @@ size_t RocksDBBackend<Key>::contains(const std::string& table_name, const size_t
   size_t hit_count{0};
   size_t skip_count{0};
 
-  std::vector<rocksdb::ColumnFamilyHandle*> col_handles;
-  std::vector<std::string> v_views;
   std::vector<rocksdb::Slice> k_views;
+  std::vector<rocksdb::PinnableSlice> v_views;
+  std::vector<rocksdb::Status> statuses;
   k_views.reserve(std::min(num_keys, this->params_.max_batch_size));
 
   // Step through keys batch-by-batch.
@@ -158,16 +181,16 @@ size_t RocksDBBackend<Key>::contains(const std::string& table_name, const size_t
           k_views.clear();
           HCTR_HPS_DB_APPLY_(SEQUENTIAL_DIRECT,
                              k_views.emplace_back(reinterpret_cast<const char*>(k), sizeof(Key)));
-          col_handles.resize(k_views.size(), ch);
 
-          v_views.clear();
-          v_views.reserve(col_handles.size());
-          const std::vector<rocksdb::Status>& statuses{
-              db_->MultiGet(read_options_, col_handles, k_views, &v_views)};
+          v_views.resize(k_views.size());
+          statuses.resize(k_views.size());
+          db_->MultiGet(read_options_, ch, k_views.size(), k_views.data(), v_views.data(),
+                        statuses.data());
 
           for (size_t idx{0}; idx < batch_size; ++idx) {
             const rocksdb::Status& s{statuses[idx]};
             if (s.ok()) {
+              v_views[idx].Reset();
               ++hit_count;
             } else if (!s.IsNotFound()) {
               HCTR_ROCKSDB_CHECK(s);
@@ -248,9 +271,9 @@ size_t RocksDBBackend<Key>::fetch(const std::string& table_name, const size_t nu
   size_t miss_count{0};
   size_t skip_count{0};
 
-  std::vector<rocksdb::ColumnFamilyHandle*> col_handles;
-  std::vector<std::string> v_views;
   std::vector<rocksdb::Slice> k_views;
+  std::vector<rocksdb::PinnableSlice> v_views;
+  std::vector<rocksdb::Status> statuses;
   k_views.reserve(std::min(num_keys, this->params_.max_batch_size));
 
   // Step through input batch-by-batch.
@@ -295,9 +318,9 @@ size_t RocksDBBackend<Key>::fetch(const std::string& table_name, const size_t nu
   size_t miss_count{0};
   size_t skip_count{0};
 
-  std::vector<rocksdb::ColumnFamilyHandle*> col_handles;
-  std::vector<std::string> v_views;
   std::vector<rocksdb::Slice> k_views;
+  std::vector<rocksdb::PinnableSlice> v_views;
+  std::vector<rocksdb::Status> statuses;
   k_views.reserve(std::min(num_indices, this->params_.max_batch_size));
 
   std::chrono::nanoseconds elapsed;
@@ -462,6 +485,191 @@ size_t RocksDBBackend<Key>::load_dump_sst(const std::string& table_name, const s
 template class RocksDBBackend<unsigned int>;
 template class RocksDBBackend<long long>;
 
+namespace {
+
+// RocksDB compares keys bytewise, and the keys are stored in host byte order. This yields an
+// integer that sorts like the bytes of `key`, with the first byte in the most significant bits.
+template <typename Key>
+inline uint64_t bytewise_order(const Key key) {
+  const auto* const bytes{reinterpret_cast<const unsigned char*>(&key)};
+  uint64_t order{0};
+  for (size_t i{0}; i < sizeof(Key); ++i) {
+    order = (order << 8) | bytes[i];
+  }
+  return order << (8 * (sizeof(uint64_t) - sizeof(Key)));
+}
+
+}  // namespace
+
+template <typename Key>
+RocksDBBulkLoader<Key>::RocksDBBulkLoader(RocksDBBackend<Key>& db, const std::string& table_name,
+                                          const size_t num_pairs_hint, const uint32_t value_size)
+    : db_{db},
+      table_name_{table_name},
+      value_size_{value_size},
+      dir_{std::filesystem::path(db.params_.path) / ("bulk_load." + table_name)},
+      ch_{db.get_or_create_column_handle_(table_name)},
+      workers_{"rocksdb bulk load", db.params_.num_threads} {
+  HCTR_CHECK_HINT(!db_.params_.read_only, "Cannot bulk load into a read-only RocksDB.");
+
+  // The ranges split the first 2 bytes of the keys.
+  const size_t num_bytes{num_pairs_hint * (sizeof(Key) + value_size_)};
+  const size_t file_size{std::max<size_t>(db_.params_.bulk_load_file_size, 1)};
+  num_ranges_ = std::min<size_t>(std::max<size_t>((num_bytes + file_size - 1) / file_size, 1),
+                                 size_t{1} << 16);
+  range_sizes_.resize(num_ranges_);
+
+  std::filesystem::remove_all(dir_);
+  std::filesystem::create_directories(dir_);
+  enable_auto_compactions_(false);
+}
+
+template <typename Key>
+RocksDBBulkLoader<Key>::~RocksDBBulkLoader() {
+  std::error_code error;
+  std::filesystem::remove_all(dir_, error);
+  if (!finished_) {
+    try {
+      enable_auto_compactions_(true);
+    } catch (const std::exception& error) {
+      HCTR_LOG_C(ERROR, WORLD, "RocksDB ", db_.params_.path, ": ", error.what(), '\n');
+    }
+  }
+}
+
+template <typename Key>
+void RocksDBBulkLoader<Key>::add(const size_t num_pairs, const Key* const keys,
+                                 const char* const values, const size_t value_stride) {
+  HCTR_CHECK(!finished_);
+  const size_t record_size{sizeof(Key) + value_size_};
+
+  // Group the pairs by range (counting sort).
+  std::vector<size_t> ranges(num_pairs);
+  std::vector<size_t> range_offsets(num_ranges_ + 1);
+  for (size_t i{0}; i < num_pairs; ++i) {
+    ranges[i] = range_of_(keys[i]);
+    ++range_offsets[ranges[i] + 1];
+  }
+  for (size_t range{0}; range < num_ranges_; ++range) {
+    range_offsets[range + 1] += range_offsets[range];
+  }
+  std::vector<char> records(num_pairs * record_size);
+  {
+    std::vector<size_t> positions(range_offsets.begin(), range_offsets.end() - 1);
+    for (size_t i{0}; i < num_pairs; ++i) {
+      char* const record{&records[positions[ranges[i]]++ * record_size]};
+      std::memcpy(record, &keys[i], sizeof(Key));
+      std::memcpy(&record[sizeof(Key)], &values[i * value_stride], value_size_);
+    }
+  }
+
+  // Append them to the files of the ranges.
+  std::vector<std::future<void>> tasks;
+  for (size_t range{0}; range < num_ranges_; ++range) {
+    const size_t begin{range_offsets[range]};
+    const size_t end{range_offsets[range + 1]};
+    if (begin == end) {
+      continue;
+    }
+    range_sizes_[range] += end - begin;
+    tasks.emplace_back(workers_.submit([&, range, begin, end]() {
+      std::ofstream file(range_path_(range), std::ios::binary | std::ios::app);
+      HCTR_THROW_IF(!file.is_open(), Error_t::FileCannotOpen, "Cannot write to ",
+                    range_path_(range).string(), ".");
+      file.write(&records[begin * record_size],
+                 static_cast<std::streamsize>((end - begin) * record_size));
+      HCTR_THROW_IF(!file.good(), Error_t::BrokenFile, "Cannot write to ",
+                    range_path_(range).string(), ".");
+    }));
+  }
+  ThreadPool::await(tasks.begin(), tasks.end());
+}
+
+template <typename Key>
+size_t RocksDBBulkLoader<Key>::finish() {
+  HCTR_CHECK(!finished_);
+  const size_t record_size{sizeof(Key) + value_size_};
+
+  // Sort the ranges, and write them to SST files. A key added several times keeps its last value.
+  std::vector<std::string> sst_paths;
+  std::vector<std::future<void>> tasks;
+  std::atomic<size_t> num_keys{0};
+  for (size_t range{0}; range < num_ranges_; ++range) {
+    if (!range_sizes_[range]) {
+      continue;
+    }
+    sst_paths.emplace_back((dir_ / (std::to_string(range) + ".sst")).string());
+    tasks.emplace_back(workers_.submit([&, range, sst_path = sst_paths.back()]() {
+      const size_t num_records{range_sizes_[range]};
+      std::vector<char> records(num_records * record_size);
+      {
+        std::ifstream file(range_path_(range), std::ios::binary);
+        file.read(records.data(), static_cast<std::streamsize>(records.size()));
+        HCTR_THROW_IF(!file.good(), Error_t::BrokenFile, "Cannot read from ",
+                      range_path_(range).string(), ".");
+      }
+      std::filesystem::remove(range_path_(range));
+
+      std::vector<std::pair<uint64_t, size_t>> order(num_records);
+      for (size_t i{0}; i < num_records; ++i) {
+        Key key;
+        std::memcpy(&key, &records[i * record_size], sizeof(Key));
+        order[i] = {bytewise_order(key), i};
+      }
+      std::sort(order.begin(), order.end());
+
+      const rocksdb::Options options{rocksdb::DBOptions(), db_.column_family_options_};
+      rocksdb::SstFileWriter file{rocksdb::EnvOptions(), options};
+      HCTR_ROCKSDB_CHECK(file.Open(sst_path));
+      size_t num_range_keys{0};
+      for (size_t i{0}; i < num_records; ++i) {
+        if (i + 1 < num_records && order[i + 1].first == order[i].first) {
+          continue;
+        }
+        const char* const record{&records[order[i].second * record_size]};
+        HCTR_ROCKSDB_CHECK(file.Put({record, sizeof(Key)}, {&record[sizeof(Key)], value_size_}));
+        ++num_range_keys;
+      }
+      HCTR_ROCKSDB_CHECK(file.Finish());
+      num_keys += num_range_keys;
+    }));
+  }
+  ThreadPool::await(tasks.begin(), tasks.end());
+
+  // The ranges do not overlap, so that all files are ingested at once.
+  if (!sst_paths.empty()) {
+    rocksdb::IngestExternalFileOptions ingest_file_options{db_.ingest_file_options_};
+    ingest_file_options.move_files = true;
+    HCTR_ROCKSDB_CHECK(db_.db_->IngestExternalFile(ch_, sst_paths, ingest_file_options));
+  }
+  enable_auto_compactions_(true);
+  finished_ = true;
+
+  HCTR_LOG_C(INFO, WORLD, db_.get_name(), " backend; Table ", table_name_, ": Bulk loaded ",
+             num_keys.load(), " keys from ", sst_paths.size(), " SST files.\n");
+  return num_keys;
+}
+
+template <typename Key>
+size_t RocksDBBulkLoader<Key>::range_of_(const Key key) const {
+  return static_cast<size_t>((bytewise_order(key) >> 48) * num_ranges_ >> 16);
+}
+
+template <typename Key>
+std::filesystem::path RocksDBBulkLoader<Key>::range_path_(const size_t range) const {
+  return dir_ / (std::to_string(range) + ".pairs");
+}
+
+template <typename Key>
+void RocksDBBulkLoader<Key>::enable_auto_compactions_(const bool enable) {
+  HCTR_ROCKSDB_CHECK(db_.db_->SetOptions(
+      ch_, {{"disable_auto_compactions",
+             enable && !db_.column_family_options_.disable_auto_compactions ? "false" : "true"}}));
+}
+
+template class RocksDBBulkLoader<unsigned int>;
+template class RocksDBBulkLoader<long long>;
+
 #endif  // HCTR_USE_ROCKS_DB
 
 }  // namespace HugeCTR
\ No newline at end of file
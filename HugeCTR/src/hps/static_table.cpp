@@ -21,6 +21,7 @@
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <type_traits>
 #include <utils.hpp>
 
 namespace HugeCTR {
@@ -56,6 +57,8 @@ StaticTable<TypeHashKey, TypeEmbVec>::StaticTable(const InferenceParams& inferen
            inference_params.number_of_refresh_buffers_in_pool);
   HCTR_LOG(INFO, ROOT, "The refresh percentage : %f\n",
            inference_params.cache_refresh_percentage_per_iteration);
+  HCTR_LOG(INFO, ROOT, "Embedding vectors in host memory: %s\n",
+           b2s(inference_params.enable_pagelock));
 
   // initialize the profiler
   ec_profiler_ = std::make_unique<profiler>(ProfilerTarget_t::EC);
@@ -93,6 +96,8 @@ StaticTable<TypeHashKey, TypeEmbVec>::StaticTable(const InferenceParams& inferen
         cache_config_.default_value_for_each_table[i], inference_params.enable_pagelock));
     cache_config_.num_set_in_cache_.push_back(num_row);
   }
+  table_initialized_.resize(cache_config_.num_emb_table_, false);
+  building_generation_.resize(cache_config_.num_emb_table_, false);
 
   const size_t max_num_keys =
       *max_element(cache_config_.num_set_in_cache_.begin(), cache_config_.num_set_in_cache_.end());
@@ -316,9 +321,9 @@ void StaticTable<TypeHashKey, TypeEmbVec>::init(const size_t table_id,
   dev_restorer.check_device(cache_config_.cuda_dev_id_);
   HCTR_LIB_THROW(cudaMemcpyAsync(d_insert_keys_buffer_, h_refresh_embeddingcolumns_,
                                  sizeof(TypeHashKey) * h_length_, cudaMemcpyHostToDevice, stream));
-  static_tables_[table_id]->Add(static_cast<TypeHashKey*>(d_insert_keys_buffer_), h_length_,
-                                reinterpret_cast<TypeEmbVec*>(h_refresh_emb_vec_), h_quant_scales,
-                                stream);
+  add_to_table(table_id, static_cast<TypeHashKey*>(d_insert_keys_buffer_),
+               reinterpret_cast<TypeEmbVec*>(h_refresh_emb_vec_), h_quant_scales, h_length_,
+               stream);
   HCTR_LIB_THROW(cudaStreamSynchronize(stream));
 }
 
@@ -328,10 +333,68 @@ void StaticTable<TypeHashKey, TypeEmbVec>::refresh(const size_t table_id, const
                                                    cudaStream_t stream) {
   CudaDeviceContext dev_restorer;
   dev_restorer.check_device(cache_config_.cuda_dev_id_);
-  static_tables_[table_id]->Clear(stream);
-  static_tables_[table_id]->Init(static_cast<const TypeHashKey*>(d_keys), length,
-                                 static_cast<const TypeEmbVec*>(d_vectors), stream);
-  /*  */
+  add_to_table(table_id, static_cast<const TypeHashKey*>(d_keys),
+               static_cast<const TypeEmbVec*>(d_vectors), nullptr, length, stream);
+}
+
+template <typename TypeHashKey, typename TypeEmbVec>
+void StaticTable<TypeHashKey, TypeEmbVec>::add_to_table(const size_t table_id,
+                                                        const TypeHashKey* const d_keys,
+                                                        const TypeEmbVec* const vectors,
+                                                        const float* const quant_scales,
+                                                        const size_t length, cudaStream_t stream) {
+  if (!table_initialized_[table_id]) {
+    static_tables_[table_id]->Add(d_keys, length, vectors, quant_scales, stream);
+    return;
+  }
+  // The table is serving lookups. Build the new contents next to it, instead of clearing it.
+  if (!building_generation_[table_id]) {
+    static_tables_[table_id]->BeginGeneration();
+    building_generation_[table_id] = true;
+  }
+  static_tables_[table_id]->AddToGeneration(d_keys, length, vectors, quant_scales, stream);
+}
+
+template <typename TypeHashKey, typename TypeEmbVec>
+bool StaticTable<TypeHashKey, TypeEmbVec>::init_prehashed(
+    const size_t table_id, const void* const keys, const uint32_t* const rows,
+    const size_t num_slots, const void* const vectors, const size_t num_rows,
+    cudaStream_t stream) {
+  // Quantized tables need scales, which the image does not have.
+  if constexpr (!std::is_same_v<TypeEmbVec, float>) {
+    return false;
+  } else {
+    CudaDeviceContext dev_restorer;
+    dev_restorer.check_device(cache_config_.cuda_dev_id_);
+    const auto* const table_keys = static_cast<const TypeHashKey*>(keys);
+    const auto* const table_vectors = static_cast<const TypeEmbVec*>(vectors);
+    bool loaded;
+    if (!table_initialized_[table_id]) {
+      loaded = static_tables_[table_id]->Load(table_keys, rows, num_slots, table_vectors,
+                                              num_rows, stream);
+    } else {
+      loaded = static_tables_[table_id]->LoadGeneration(table_keys, rows, num_slots,
+                                                        table_vectors, num_rows, stream);
+      building_generation_[table_id] = building_generation_[table_id] || loaded;
+    }
+    // The image is memory-mapped, and may be unmapped once this returns.
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    return loaded;
+  }
+}
+
+template <typename TypeHashKey, typename TypeEmbVec>
+void StaticTable<TypeHashKey, TypeEmbVec>::finish_refresh(const size_t table_id,
+                                                          cudaStream_t stream) {
+  CudaDeviceContext dev_restorer;
+  dev_restorer.check_device(cache_config_.cuda_dev_id_);
+  if (building_generation_[table_id]) {
+    static_tables_[table_id]->CommitGeneration(stream);
+    building_generation_[table_id] = false;
+    HCTR_LOG(INFO, ROOT, "Swapped in a new generation of static embedding table %zu.\n", table_id);
+  }
+  table_initialized_[table_id] = true;
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
 }
 
 template <typename TypeHashKey, typename TypeEmbVec>
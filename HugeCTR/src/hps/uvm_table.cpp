@@ -79,15 +79,25 @@ UvmTable<TypeHashKey>::UvmTable(const InferenceParams &inference_params,
   CudaDeviceContext dev_restorer;
   dev_restorer.set_device(cache_config_.cuda_dev_id_);
 
+  // If sharded, each device holds only its share of the keys in device memory, and all other keys
+  // in host memory.
+  const size_t num_shards =
+      inference_params.shard_uvm_table ? inference_params.deployed_devices.size() : 1;
+  HCTR_LOG(INFO, ROOT, "Number of UVM table shards: %zu\n", num_shards);
+  HCTR_CHECK_HINT(inference_params.uvm_table_staging_buffers > 0,
+                  "The UVM table needs at least one staging buffer.");
+
   // Allocate resources.
   for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
     const size_t num_row = ps_config.embedding_key_count_.at(inference_params.model_name)[i];
+    const size_t num_device_row = num_row * cache_config_.cache_size_percentage_;
+    const size_t num_host_row = num_row - std::min(num_device_row, num_row / num_shards);
     uvm_tables_.emplace_back(std::make_unique<Cache>(
-        num_row * cache_config_.cache_size_percentage_,
-        num_row - num_row * cache_config_.cache_size_percentage_,
+        num_device_row, num_host_row,
         inference_params.max_batchsize *
             inference_params.maxnum_catfeature_query_per_table_per_sample[i],
-        cache_config_.embedding_vec_size_[i]));
+        cache_config_.embedding_vec_size_[i], 0.0f,
+        static_cast<int>(inference_params.uvm_table_staging_buffers)));
     cache_config_.num_set_in_cache_.push_back(num_row);
   }
 
@@ -98,6 +108,24 @@ UvmTable<TypeHashKey>::UvmTable(const InferenceParams &inference_params,
   }
 }
 
+template <typename TypeHashKey>
+void UvmTable<TypeHashKey>::connect_shards(const std::vector<std::shared_ptr<UvmTable>> &shards) {
+  if (shards.size() < 2) {
+    return;
+  }
+  const size_t num_tables = shards.front()->cache_config_.num_emb_table_;
+  for (size_t i = 0; i < num_tables; i++) {
+    std::vector<Cache *> tables;
+    for (const auto &shard : shards) {
+      HCTR_CHECK(shard->cache_config_.num_emb_table_ == num_tables);
+      tables.emplace_back(shard->uvm_tables_[i].get());
+    }
+    Cache::connect_shards(tables);
+  }
+  HCTR_LOG(INFO, ROOT, "Sharded %zu UVM embedding tables of model %s across %zu devices.\n",
+           num_tables, shards.front()->cache_config_.model_name_.c_str(), shards.size());
+}
+
 template <typename TypeHashKey>
 void UvmTable<TypeHashKey>::lookup(size_t table_id, float *d_vectors, const void *h_keys,
                                    size_t num_keys, float hit_rate_threshold, cudaStream_t stream) {
@@ -163,9 +191,29 @@ void UvmTable<TypeHashKey>::lookup_from_device(size_t table_id, float *d_vectors
   CudaDeviceContext dev_restorer;
   dev_restorer.check_device(cache_config_.cuda_dev_id_);
 
+  // Batches repeat the same keys many times over (e.g. the user features of every candidate).
+  // Deduplicate them, so that each vector is gathered from host memory only once.
+  BaseUnit *start = profiler::start();
+  UniqueOp *const unique_op{static_cast<UniqueOp *>(workspace_handler.unique_op_obj_[table_id])};
+  unique_op->unique(static_cast<TypeHashKey *>(workspace_handler.d_embeddingcolumns_[table_id]),
+                    num_keys, workspace_handler.d_unique_output_index_[table_id],
+                    static_cast<TypeHashKey *>(
+                        workspace_handler.d_unique_output_embeddingcolumns_[table_id]),
+                    workspace_handler.d_unique_length_ + table_id, stream);
+  HCTR_LIB_THROW(cudaMemcpyAsync(workspace_handler.h_unique_length_ + table_id,
+                                 workspace_handler.d_unique_length_ + table_id, sizeof(size_t),
+                                 cudaMemcpyDeviceToHost, stream));
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  ec_profiler_->end(start, "Deduplicate the input embedding key for UVM Embedding Cache");
+
   uvm_tables_[table_id]->query(
-      static_cast<TypeHashKey *>(workspace_handler.d_embeddingcolumns_[table_id]), num_keys,
-      d_vectors, stream);
+      static_cast<TypeHashKey *>(workspace_handler.d_unique_output_embeddingcolumns_[table_id]),
+      workspace_handler.h_unique_length_[table_id], workspace_handler.d_hit_emb_vec_[table_id],
+      stream);
+  decompress_emb_vec_async(workspace_handler.d_hit_emb_vec_[table_id],
+                           workspace_handler.d_unique_output_index_[table_id], d_vectors, num_keys,
+                           cache_config_.embedding_vec_size_[table_id], BLOCK_SIZE_, stream);
+  unique_op->clear(stream);
 }
 
 template <typename TypeHashKey>
@@ -235,6 +283,10 @@ EmbeddingCacheWorkspace UvmTable<TypeHashKey>::create_workspace() {
                               cache_config_.max_query_len_per_emb_table_[i] *
                                   cache_config_.embedding_vec_size_[i] * sizeof(float)));
     workspace_handler.d_missing_emb_vec_.push_back(d_missing_emb_vec);
+
+    const size_t capacity = static_cast<size_t>(cache_config_.max_query_len_per_emb_table_[i] /
+                                                UNIQUE_OP_LOAD_FACTOR);
+    workspace_handler.unique_op_obj_.push_back(new UniqueOp(capacity));
   }
   HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void **>(&workspace_handler.d_missing_length_),
                             cache_config_.num_emb_table_ * sizeof(size_t)));
@@ -338,6 +390,8 @@ void UvmTable<TypeHashKey>::destroy_workspace(EmbeddingCacheWorkspace &workspace
     workspace_handler.d_missing_index_[i] = nullptr;
     HCTR_LIB_THROW(cudaFree(workspace_handler.d_missing_emb_vec_[i]));
     workspace_handler.d_missing_emb_vec_[i] = nullptr;
+    delete static_cast<UniqueOp *>(workspace_handler.unique_op_obj_[i]);
+    workspace_handler.unique_op_obj_[i] = nullptr;
   }
 
   HCTR_LIB_THROW(cudaFree(workspace_handler.d_unique_length_));
@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <hps/value_codec.hpp>
+
+namespace HugeCTR {
+
+// The conversions are branch-free per element where possible, so that the compiler can vectorize
+// the loops for whatever instruction set the build targets.
+
+namespace {
+
+constexpr float fp8_e4m3_max{448.f};
+constexpr float fp8_min_scale{1.f / (fp8_e4m3_max * 512.f)};
+
+inline uint32_t float_bits(const float f) {
+  uint32_t u;
+  std::memcpy(&u, &f, sizeof(float));
+  return u;
+}
+
+inline float bits_float(const uint32_t u) {
+  float f;
+  std::memcpy(&f, &u, sizeof(float));
+  return f;
+}
+
+inline uint16_t float_to_half(const float f) {
+  uint32_t u{float_bits(f)};
+  const uint32_t sign{u & 0x80000000U};
+  u ^= sign;
+
+  uint32_t h;
+  if (u >= 0x47800000U) {
+    // Too large for half (-> inf), inf or NaN (-> quiet NaN).
+    h = u > 0x7f800000U ? 0x7e00U : 0x7c00U;
+  } else if (u < 0x38800000U) {
+    // Subnormal or zero. Adding 0.5 lets the FPU round the mantissa.
+    h = float_bits(bits_float(u) + 0.5f) - 0x3f000000U;
+  } else {
+    // Normal. Rebias the exponent and round to nearest even.
+    const uint32_t mant_odd{(u >> 13) & 1};
+    u += 0xc8000fffU + mant_odd;
+    h = u >> 13;
+  }
+  return static_cast<uint16_t>(h | (sign >> 16));
+}
+
+inline float half_to_float(const uint16_t h) {
+  const uint32_t sign{static_cast<uint32_t>(h & 0x8000U) << 16};
+  const uint32_t em{h & 0x7fffU};
+
+  uint32_t u;
+  if (em >= 0x7c00U) {
+    u = 0x7f800000U | ((em & 0x3ffU) << 13);
+  } else if (em < 0x400U) {
+    u = float_bits(static_cast<float>(em) * 5.9604644775390625e-8f);  // em * 2^-24
+  } else {
+    u = (em << 13) + 0x38000000U;
+  }
+  return bits_float(u | sign);
+}
+
+inline uint16_t float_to_bfloat16(const float f) {
+  const uint32_t u{float_bits(f)};
+  if ((u & 0x7fffffffU) > 0x7f800000U) {
+    return static_cast<uint16_t>((u >> 16) | 0x40U);  // Keep NaNs quiet.
+  }
+  return static_cast<uint16_t>((u + 0x7fffU + ((u >> 16) & 1)) >> 16);
+}
+
+inline float bfloat16_to_float(const uint16_t b) {
+  return bits_float(static_cast<uint32_t>(b) << 16);
+}
+
+// Expects a finite `f` with `|f| <= fp8_e4m3_max`.
+inline uint8_t float_to_fp8_e4m3(const float f) {
+  const uint32_t u{float_bits(f)};
+  const uint8_t sign{static_cast<uint8_t>((u >> 24) & 0x80U)};
+  const float a{bits_float(u & 0x7fffffffU)};
+
+  uint32_t code;
+  if (a < 0.015625f) {
+    // Subnormal, in steps of 2^-9. Rounding up to 8 yields the smallest normal.
+    code = static_cast<uint32_t>(std::nearbyint(a * 512.f));
+  } else {
+    // Normal. Round the mantissa to 3 bits (nearest even) and rebias the exponent.
+    uint32_t v{float_bits(a)};
+    v += 0x7ffffU + ((v >> 20) & 1);
+    code = (((v >> 23) - 120) << 3) | ((v >> 20) & 7);
+    code = std::min(code, 0x7eU);
+  }
+  return static_cast<uint8_t>(code | sign);
+}
+
+struct FP8E4M3Table final {
+  std::array<float, 256> values;
+
+  FP8E4M3Table() {
+    for (size_t code{0}; code < values.size(); ++code) {
+      const int exponent{static_cast<int>((code >> 3) & 15)};
+      const int mantissa{static_cast<int>(code & 7)};
+      float v;
+      if (exponent == 15 && mantissa == 7) {
+        v = std::nanf("");
+      } else if (exponent == 0) {
+        v = std::ldexp(static_cast<float>(mantissa), -9);
+      } else {
+        v = std::ldexp(static_cast<float>(8 + mantissa), exponent - 10);
+      }
+      values[code] = (code & 0x80) ? -v : v;
+    }
+  }
+};
+
+const FP8E4M3Table fp8_e4m3_table;
+
+}  // namespace
+
+size_t encoded_value_size(const DatabaseValueFormat_t format, const size_t value_size) {
+  const size_t n{value_size / sizeof(float)};
+  switch (format) {
+    case DatabaseValueFormat_t::Float32:
+      break;
+    case DatabaseValueFormat_t::Float16:
+    case DatabaseValueFormat_t::BFloat16:
+      return n * sizeof(uint16_t);
+    case DatabaseValueFormat_t::FP8:
+      return sizeof(float) + n;
+  }
+  return value_size;
+}
+
+void encode_value(const DatabaseValueFormat_t format, const char* const value,
+                  const size_t value_size, char* const encoded) {
+  const size_t n{value_size / sizeof(float)};
+  switch (format) {
+    case DatabaseValueFormat_t::Float32: {
+      std::copy_n(value, value_size, encoded);
+    } break;
+    case DatabaseValueFormat_t::Float16: {
+      for (size_t i{0}; i < n; ++i) {
+        float f;
+        std::memcpy(&f, &value[i * sizeof(float)], sizeof(float));
+        const uint16_t h{float_to_half(f)};
+        std::memcpy(&encoded[i * sizeof(uint16_t)], &h, sizeof(uint16_t));
+      }
+    } break;
+    case DatabaseValueFormat_t::BFloat16: {
+      for (size_t i{0}; i < n; ++i) {
+        float f;
+        std::memcpy(&f, &value[i * sizeof(float)], sizeof(float));
+        const uint16_t b{float_to_bfloat16(f)};
+        std::memcpy(&encoded[i * sizeof(uint16_t)], &b, sizeof(uint16_t));
+      }
+    } break;
+    case DatabaseValueFormat_t::FP8: {
+      float amax{0};
+      for (size_t i{0}; i < n; ++i) {
+        float f;
+        std::memcpy(&f, &value[i * sizeof(float)], sizeof(float));
+        amax = std::max(amax, std::fabs(f));
+      }
+      const float scale{std::max(amax / fp8_e4m3_max, fp8_min_scale)};
+      std::memcpy(encoded, &scale, sizeof(float));
+
+      const float inv_scale{1.f / scale};
+      uint8_t* const codes{reinterpret_cast<uint8_t*>(&encoded[sizeof(float)])};
+      for (size_t i{0}; i < n; ++i) {
+        float f;
+        std::memcpy(&f, &value[i * sizeof(float)], sizeof(float));
+        codes[i] = float_to_fp8_e4m3(std::clamp(f * inv_scale, -fp8_e4m3_max, fp8_e4m3_max));
+      }
+    } break;
+  }
+}
+
+void decode_value(const DatabaseValueFormat_t format, const char* const encoded,
+                  const size_t value_size, char* const value) {
+  const size_t n{value_size / sizeof(float)};
+  switch (format) {
+    case DatabaseValueFormat_t::Float32: {
+      std::copy_n(encoded, value_size, value);
+    } break;
+    case DatabaseValueFormat_t::Float16: {
+      for (size_t i{0}; i < n; ++i) {
+        uint16_t h;
+        std::memcpy(&h, &encoded[i * sizeof(uint16_t)], sizeof(uint16_t));
+        const float f{half_to_float(h)};
+        std::memcpy(&value[i * sizeof(float)], &f, sizeof(float));
+      }
+    } break;
+    case DatabaseValueFormat_t::BFloat16: {
+      for (size_t i{0}; i < n; ++i) {
+        uint16_t b;
+        std::memcpy(&b, &encoded[i * sizeof(uint16_t)], sizeof(uint16_t));
+        const float f{bfloat16_to_float(b)};
+        std::memcpy(&value[i * sizeof(float)], &f, sizeof(float));
+      }
+    } break;
+    case DatabaseValueFormat_t::FP8: {
+      float scale;
+      std::memcpy(&scale, encoded, sizeof(float));
+
+      const uint8_t* const codes{reinterpret_cast<const uint8_t*>(&encoded[sizeof(float)])};
+      for (size_t i{0}; i < n; ++i) {
+        const float f{fp8_e4m3_table.values[codes[i]] * scale};
+        std::memcpy(&value[i * sizeof(float)], &f, sizeof(float));
+      }
+    } break;
+  }
+}
+
+}  // namespace HugeCTR
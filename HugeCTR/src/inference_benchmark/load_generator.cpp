@@ -0,0 +1,372 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <argparse/argparse.hpp>
+#include <atomic>
+#include <common.hpp>
+#include <core23/logger.hpp>
+#include <fstream>
+#include <hps/hier_parameter_server.hpp>
+#include <hps/inference_utils.hpp>
+#include <hps/kafka_message.hpp>
+#include <hps/lookup_session.hpp>
+#include <inference_benchmark/workload.hpp>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <utils.hpp>
+#include <vector>
+
+using namespace HugeCTR;
+
+using Key = long long;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+/**
+ * One Triton model instance: a lookup session on one GPU, driven by one thread.
+ */
+struct Client {
+  std::shared_ptr<LookupSessionBase> session;
+  std::vector<float*> d_vectors_per_table;
+  // Pre-generated requests, so that the key generation is not part of the latency.
+  std::vector<std::vector<std::vector<Key>>> requests;
+  LatencyStats latency;  // From the scheduled arrival to the completion of a request.
+  LatencyStats service;  // From the start to the completion of a request.
+};
+
+template <typename T>
+std::vector<T> per_table(const std::vector<T>& values, const size_t num_tables) {
+  std::vector<T> expanded(values);
+  expanded.resize(num_tables, values.back());
+  return expanded;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  argparse::ArgumentParser args("HPS_Load_Generator");
+
+  args.add_argument("--config").help("The path of the HPS json configuration file").required();
+
+  args.add_argument("--model")
+      .help("The model to query, the first model of the configuration by default")
+      .default_value<std::string>("");
+
+  args.add_argument("--clients")
+      .help("Number of concurrent clients, each with its own lookup session and thread")
+      .default_value<size_t>(4)
+      .scan<'u', size_t>();
+
+  args.add_argument("--rate")
+      .help("Requests per second of all clients together (open loop), 0 = closed loop")
+      .default_value<double>(0.)
+      .scan<'g', double>();
+
+  args.add_argument("--duration")
+      .help("Measured seconds")
+      .default_value<double>(10.)
+      .scan<'g', double>();
+
+  args.add_argument("--warmup")
+      .help("Seconds before the measurement starts")
+      .default_value<double>(2.)
+      .scan<'g', double>();
+
+  args.add_argument("--table_size")
+      .help("The number of keys in each embedding table, the last value applies to the rest")
+      .nargs(1, 64)
+      .default_value<std::vector<size_t>>({100000})
+      .scan<'u', size_t>();
+
+  args.add_argument("--num_key")
+      .help("The number of keys per request for each embedding table")
+      .nargs(1, 64)
+      .default_value<std::vector<size_t>>({1000})
+      .scan<'u', size_t>();
+
+  args.add_argument("--zipf_theta")
+      .help("Skew of the key popularity in [0, 1) for each embedding table, 0 = uniform")
+      .nargs(1, 64)
+      .default_value<std::vector<double>>({0.99})
+      .scan<'g', double>();
+
+  args.add_argument("--num_requests")
+      .help("Number of pre-generated requests per client, which are sent round-robin")
+      .default_value<size_t>(64)
+      .scan<'u', size_t>();
+
+  args.add_argument("--refresh_interval_ms")
+      .help("Refreshes the embedding caches in the background every N ms, 0 = off")
+      .default_value<size_t>(0)
+      .scan<'u', size_t>();
+
+  args.add_argument("--kafka_broker")
+      .help("Kafka broker for the background updates")
+      .default_value<std::string>("127.0.0.1:9092");
+
+  args.add_argument("--kafka_update_rate")
+      .help(
+          "Keys per second sent to Kafka in the background, 0 = off. The HPS applies them if its "
+          "configuration has an update source")
+      .default_value<size_t>(0)
+      .scan<'u', size_t>();
+
+  args.add_argument("--seed")
+      .help("Seed for the random number generator")
+      .default_value<uint64_t>(4711)
+      .scan<'u', uint64_t>();
+
+  args.add_argument("--json_output")
+      .help("Writes the results to this JSON file")
+      .default_value<std::string>("");
+
+  try {
+    args.parse_args(argc, argv);
+  } catch (const std::runtime_error& err) {
+    std::cerr << err.what() << std::endl;
+    std::cout << args;
+    return 1;
+  }
+
+  const auto num_clients = args.get<size_t>("--clients");
+  const auto rate = args.get<double>("--rate");
+  const auto duration = args.get<double>("--duration");
+  const auto warmup = args.get<double>("--warmup");
+  const auto num_requests = args.get<size_t>("--num_requests");
+  const std::chrono::milliseconds refresh_interval{args.get<size_t>("--refresh_interval_ms")};
+  const auto kafka_update_rate = args.get<size_t>("--kafka_update_rate");
+  const auto seed = args.get<uint64_t>("--seed");
+  const auto json_output = args.get<std::string>("--json_output");
+  HCTR_CHECK_HINT(num_clients > 0 && num_requests > 0, "Need at least one client and request!");
+
+  parameter_server_config ps_config{args.get<std::string>("--config")};
+  std::string model_name = args.get<std::string>("--model");
+  if (model_name.empty()) {
+    model_name = ps_config.inference_params_array.at(0).model_name;
+  }
+  const std::optional<size_t> model_id = ps_config.find_model_id(model_name);
+  HCTR_CHECK_HINT(model_id, "The model '", model_name, "' is not in the configuration!");
+  InferenceParams inference_params = ps_config.inference_params_array[*model_id];
+  HCTR_CHECK_HINT(inference_params.i64_input_key, "The load generator requires int64 keys!");
+
+  const std::vector<std::string>& table_names = ps_config.emb_table_name_.at(model_name);
+  const std::vector<size_t>& embedding_sizes = ps_config.embedding_vec_size_.at(model_name);
+  const size_t num_tables = table_names.size();
+  const auto table_sizes = per_table(args.get<std::vector<size_t>>("--table_size"), num_tables);
+  const auto num_keys = per_table(args.get<std::vector<size_t>>("--num_key"), num_tables);
+  const auto zipf_thetas = per_table(args.get<std::vector<double>>("--zipf_theta"), num_tables);
+
+  HCTR_LOG_S(INFO, WORLD) << "Preparing key distributions..." << std::endl;
+  std::vector<KeyGenerator> key_generators;
+  for (size_t t = 0; t < num_tables; ++t) {
+    HCTR_CHECK_HINT(zipf_thetas[t] >= 0 && zipf_thetas[t] < 1, "zipf_theta must be in [0, 1)!");
+    key_generators.emplace_back(table_sizes[t], zipf_thetas[t]);
+  }
+
+  const auto parameter_server = HierParameterServerBase::create(ps_config);
+
+  // Spread the clients over the GPUs of the model, like Triton model instances.
+  std::vector<Client> clients(num_clients);
+  std::mt19937_64 gen(seed);
+  for (size_t c = 0; c < num_clients; ++c) {
+    Client& client = clients[c];
+    const int device_id =
+        inference_params.deployed_devices[c % inference_params.deployed_devices.size()];
+    inference_params.device_id = device_id;
+    client.session = LookupSessionBase::create(
+        inference_params, parameter_server->get_embedding_cache(model_name, device_id));
+
+    CudaDeviceContext context(device_id);
+    client.d_vectors_per_table.resize(num_tables);
+    for (size_t t = 0; t < num_tables; ++t) {
+      HCTR_LIB_THROW(cudaMalloc(&client.d_vectors_per_table[t],
+                                num_keys[t] * embedding_sizes[t] * sizeof(float)));
+    }
+
+    client.requests.resize(num_requests);
+    for (auto& request : client.requests) {
+      request.resize(num_tables);
+      for (size_t t = 0; t < num_tables; ++t) {
+        request[t].resize(num_keys[t]);
+        for (Key& key : request[t]) {
+          key = static_cast<Key>(key_generators[t](gen));
+        }
+      }
+    }
+  }
+
+  std::atomic<bool> stop{false};
+
+  // Background cache refreshes.
+  std::thread refresher;
+  if (refresh_interval.count() > 0) {
+    refresher = std::thread([&]() {
+      while (!stop) {
+        for (const int device_id : inference_params.deployed_devices) {
+          parameter_server->refresh_embedding_cache(model_name, device_id);
+        }
+        std::this_thread::sleep_for(refresh_interval);
+      }
+    });
+  }
+
+  // Background updates through Kafka.
+  std::unique_ptr<KafkaMessageSink<Key>> kafka_sink;
+  std::thread kafka_producer;
+  if (kafka_update_rate > 0) {
+    KafkaMessageSinkParams sink_params;
+    sink_params.brokers = args.get<std::string>("--kafka_broker");
+    kafka_sink = std::make_unique<KafkaMessageSink<Key>>(sink_params);
+    kafka_producer = std::thread([&]() {
+      std::mt19937_64 gen(seed + num_clients);
+      std::uniform_real_distribution<float> value_dist(-1.f, 1.f);
+      std::vector<Key> keys(std::min<size_t>(kafka_update_rate, 1024));
+      const auto interval = std::chrono::nanoseconds(static_cast<int64_t>(
+          1e9 * static_cast<double>(keys.size()) / static_cast<double>(kafka_update_rate)));
+      auto next = Clock::now();
+      for (size_t t = 0; !stop; t = (t + 1) % num_tables) {
+        std::vector<float> values(keys.size() * embedding_sizes[t]);
+        for (Key& key : keys) {
+          key = static_cast<Key>(key_generators[t](gen));
+        }
+        for (float& value : values) {
+          value = value_dist(gen);
+        }
+        kafka_sink->post(HierParameterServerBase::make_tag_name(model_name, table_names[t]),
+                         keys.size(), keys.data(), reinterpret_cast<const char*>(values.data()),
+                         static_cast<uint32_t>(embedding_sizes[t] * sizeof(float)));
+        next += interval;
+        std::this_thread::sleep_until(next);
+      }
+      kafka_sink->flush();
+    });
+  }
+
+  HCTR_LOG_S(INFO, WORLD) << "Sending requests of " << num_clients << " clients for "
+                          << warmup + duration << " s ("
+                          << (rate > 0 ? "open loop" : "closed loop") << ")..." << std::endl;
+  const auto begin = Clock::now();
+  const auto measure_begin =
+      begin + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(warmup));
+  const auto end = measure_begin + std::chrono::duration_cast<Clock::duration>(
+                                       std::chrono::duration<double>(duration));
+  const size_t total_keys = std::accumulate(num_keys.begin(), num_keys.end(), size_t{0});
+  std::vector<std::thread> threads;
+  for (size_t c = 0; c < num_clients; ++c) {
+    threads.emplace_back([&, c]() {
+      Client& client = clients[c];
+      // Poisson arrivals, every client sends its share of the rate.
+      std::mt19937_64 gen(seed + c);
+      std::exponential_distribution<double> inter_arrival(rate > 0 ? rate / num_clients : 1.);
+      std::vector<const void*> h_keys_per_table(num_tables);
+      auto arrival = begin;
+      for (size_t i = 0;; ++i) {
+        if (rate > 0) {
+          arrival += std::chrono::duration_cast<Clock::duration>(
+              std::chrono::duration<double>(inter_arrival(gen)));
+          std::this_thread::sleep_until(arrival);
+        } else {
+          arrival = Clock::now();
+        }
+        if (arrival >= end) {
+          break;
+        }
+
+        const auto& request = client.requests[i % num_requests];
+        for (size_t t = 0; t < num_tables; ++t) {
+          h_keys_per_table[t] = request[t].data();
+        }
+        const auto start = Clock::now();
+        client.session->lookup(h_keys_per_table, client.d_vectors_per_table, num_keys);
+        const auto done = Clock::now();
+
+        if (arrival >= measure_begin) {
+          client.latency.record(done - arrival, total_keys);
+          client.service.record(done - start, total_keys);
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  const double seconds = std::chrono::duration<double>(Clock::now() - measure_begin).count();
+
+  stop = true;
+  if (refresher.joinable()) {
+    refresher.join();
+  }
+  if (kafka_producer.joinable()) {
+    kafka_producer.join();
+  }
+
+  LatencyStats latency;
+  LatencyStats service;
+  for (Client& client : clients) {
+    latency.merge(client.latency);
+    service.merge(client.service);
+    for (float* const d_vectors : client.d_vectors_per_table) {
+      HCTR_LIB_CHECK_(cudaFree(d_vectors));
+    }
+  }
+  latency.finalize();
+  service.finalize();
+
+  const auto report = [&](const char* const name, const LatencyStats& stats) {
+    HCTR_LOG_S(INFO, WORLD) << name << ": requests = " << stats.num_ops() << std::fixed
+                            << std::setprecision(1)
+                            << ", requests/s = " << stats.num_ops() / seconds
+                            << ", keys/s = " << stats.num_keys() / seconds
+                            << ", mean = " << stats.mean() << " us, p50 = " << stats.percentile(50)
+                            << " us, p99 = " << stats.percentile(99)
+                            << " us, p999 = " << stats.percentile(99.9)
+                            << " us, max = " << stats.percentile(100) << " us" << std::endl;
+  };
+  std::cout << "*** Measurement Results ***" << std::endl;
+  report("Latency", latency);
+  report("Service time", service);
+
+  if (!json_output.empty()) {
+    nlohmann::json results;
+    results["model"] = model_name;
+    results["config"] = {
+        {"clients", num_clients},
+        {"rate", rate},
+        {"duration", duration},
+        {"warmup", warmup},
+        {"table_size", table_sizes},
+        {"num_key", num_keys},
+        {"zipf_theta", zipf_thetas},
+        {"refresh_interval_ms", refresh_interval.count()},
+        {"kafka_update_rate", kafka_update_rate},
+    };
+    results["seconds"] = seconds;
+    results["latency"] = latency.to_json(seconds);
+    results["service_time"] = service.to_json(seconds);
+    std::ofstream file(json_output);
+    file << results.dump(2) << std::endl;
+    HCTR_LOG_S(INFO, WORLD) << "Results written to " << json_output << std::endl;
+  }
+
+  return 0;
+}
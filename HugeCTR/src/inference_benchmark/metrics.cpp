@@ -135,7 +135,7 @@ HPS_Metrics::HPS_Metrics(const std::string& hps_json_config_file, metrics_argues
     : ps_config_{hps_json_config_file} {
   metrics_config_ = metrics_config;
   initialize();
-  refresh_thread_ = new ThreadPool("EC refresh", 16);
+  refresh_thread_ = new ThreadPool("EC refresh", TaskPriority::Refresh, 16);
   profile = new profiler();
 }
 
@@ -0,0 +1,372 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <core23/logger.hpp>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <io/caching_filesystem.hpp>
+#include <sstream>
+
+namespace HugeCTR {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr const char* kLockSuffix = ".lock";
+constexpr const char* kTempInfix = ".tmp.";
+// Ranged reads of a download, the remote file systems read at most an int at once
+constexpr size_t kChunkSize = size_t{8} << 20;
+constexpr size_t kChunksInFlight = 4;
+
+/**
+ * @brief Exclusive flock() of a lock file, which also excludes the other threads of the process
+ * since every instance opens the file anew.
+ */
+class FileLock {
+ public:
+  explicit FileLock(const std::string& path) : fd_(open(path.c_str(), O_RDWR | O_CREAT, 0644)) {
+    HCTR_CHECK_HINT(fd_ >= 0, "Cannot open the lock file ", path);
+    HCTR_CHECK_HINT(flock(fd_, LOCK_EX) == 0, "Cannot lock ", path);
+  }
+  FileLock(const FileLock&) = delete;
+  FileLock& operator=(const FileLock&) = delete;
+  ~FileLock() {
+    flock(fd_, LOCK_UN);
+    close(fd_);
+  }
+
+ private:
+  int fd_;
+};
+
+// 64-bit FNV-1a
+uint64_t hash_path(const std::string& path) {
+  uint64_t hash = 14695981039346656037ull;
+  for (const char c : path) {
+    hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+  }
+  return hash;
+}
+
+// Cached files are named after the hash of the remote path and the file size.
+std::string cache_path(const std::string& cache_dir, const std::string& path, size_t size) {
+  std::stringstream name;
+  name << std::hex << hash_path(path) << std::dec << '-' << size;
+  return (fs::path(cache_dir) / name.str()).string();
+}
+
+bool is_cached_file(const fs::directory_entry& entry) {
+  const std::string name = entry.path().filename().string();
+  return name.front() != '.' && name.find(kTempInfix) == std::string::npos &&
+         !(name.size() > 5 && name.compare(name.size() - 5, 5, kLockSuffix) == 0);
+}
+
+}  // namespace
+
+CachingFileSystem::CachingFileSystem(std::unique_ptr<FileSystem> remote,
+                                     const std::string& cache_dir, const size_t capacity,
+                                     const int prefetch_depth, const bool evict_after_read)
+    : remote_(std::move(remote)),
+      cache_dir_(cache_dir),
+      capacity_(capacity),
+      evict_after_read_(evict_after_read) {
+  HCTR_CHECK_HINT(remote_, "No file system to cache.");
+  HCTR_CHECK_HINT(prefetch_depth > 0, "prefetch_depth must be positive, got ", prefetch_depth);
+  std::error_code ec;
+  fs::create_directories(cache_dir_, ec);
+  HCTR_CHECK_HINT(fs::is_directory(cache_dir_), "Cannot create the cache directory ", cache_dir_);
+  for (int i = 0; i < prefetch_depth; i++) {
+    prefetch_threads_.emplace_back(&CachingFileSystem::prefetch_loop, this);
+  }
+}
+
+CachingFileSystem::~CachingFileSystem() {
+  {
+    std::lock_guard<std::mutex> lock(prefetch_mutex_);
+    stop_ = true;
+  }
+  prefetch_cv_.notify_all();
+  for (auto& thread : prefetch_threads_) {
+    thread.join();
+  }
+}
+
+size_t CachingFileSystem::get_file_size(const std::string& path) const {
+  {
+    std::lock_guard<std::mutex> lock(sizes_mutex_);
+    const auto it = sizes_.find(path);
+    if (it != sizes_.end()) {
+      return it->second;
+    }
+  }
+  const size_t size = remote_->get_file_size(path);
+  std::lock_guard<std::mutex> lock(sizes_mutex_);
+  sizes_[path] = size;
+  return size;
+}
+
+void CachingFileSystem::create_dir(const std::string& path) { remote_->create_dir(path); }
+
+void CachingFileSystem::delete_file(const std::string& path) {
+  forget(path);
+  remote_->delete_file(path);
+}
+
+void CachingFileSystem::fetch(const std::string& source_path, const std::string& target_path) {
+  const std::string local_path = ensure_cached(source_path);
+  if (local_path.empty()) {
+    remote_->fetch(source_path, target_path);
+    return;
+  }
+  std::error_code ec;
+  fs::copy_file(local_path, target_path, fs::copy_options::overwrite_existing, ec);
+  if (ec) {  // Evicted meanwhile
+    remote_->fetch(source_path, target_path);
+  }
+}
+
+void CachingFileSystem::upload(const std::string& source_path, const std::string& target_path) {
+  forget(target_path);
+  remote_->upload(source_path, target_path);
+}
+
+int CachingFileSystem::write(const std::string& path, const void* const data,
+                             const size_t data_size, const bool overwrite) {
+  forget(path);
+  return remote_->write(path, data, data_size, overwrite);
+}
+
+int CachingFileSystem::read(const std::string& path, void* const buffer, const size_t buffer_size,
+                            const size_t offset) {
+  if (is_prefetching(path)) {
+    std::error_code ec;
+    if (!fs::exists(cache_path(cache_dir_, path, get_file_size(path)), ec)) {
+      // Not downloaded yet, read the range instead of waiting for the whole file.
+      return remote_->read(path, buffer, buffer_size, offset);
+    }
+  }
+  const std::string local_path = ensure_cached(path);
+  const int fd = local_path.empty() ? -1 : open(local_path.c_str(), O_RDONLY);
+  if (fd < 0) {  // Does not fit the cache, or evicted meanwhile
+    return remote_->read(path, buffer, buffer_size, offset);
+  }
+  size_t bytes_read = 0;
+  ssize_t ret = 1;
+  while (bytes_read < buffer_size && ret > 0) {
+    ret = pread(fd, static_cast<char*>(buffer) + bytes_read, buffer_size - bytes_read,
+                offset + bytes_read);
+    bytes_read += std::max<ssize_t>(ret, 0);
+  }
+  close(fd);
+  HCTR_CHECK_HINT(ret >= 0, "Cannot read the cached file ", local_path);
+  return bytes_read;
+}
+
+void CachingFileSystem::copy(const std::string& source_path, const std::string& target_path) {
+  forget(target_path);
+  remote_->copy(source_path, target_path);
+}
+
+void CachingFileSystem::batch_fetch(const std::string& source_dir, const std::string& target_dir) {
+  remote_->batch_fetch(source_dir, target_dir);
+}
+
+void CachingFileSystem::batch_upload(const std::string& source_dir,
+                                     const std::string& target_dir) {
+  remote_->batch_upload(source_dir, target_dir);
+}
+
+void CachingFileSystem::prefetch(const std::vector<std::string>& paths) {
+  {
+    std::lock_guard<std::mutex> lock(prefetch_mutex_);
+    for (const auto& path : paths) {
+      if (downloading_.count(path) == 0 &&
+          std::find(prefetch_queue_.begin(), prefetch_queue_.end(), path) ==
+              prefetch_queue_.end()) {
+        prefetch_queue_.push_back(path);
+      }
+    }
+  }
+  prefetch_cv_.notify_all();
+}
+
+void CachingFileSystem::release(const std::string& path) {
+  {
+    std::lock_guard<std::mutex> lock(prefetch_mutex_);
+    prefetch_queue_.erase(std::remove(prefetch_queue_.begin(), prefetch_queue_.end(), path),
+                          prefetch_queue_.end());
+  }
+  if (evict_after_read_) {
+    forget(path);
+  }
+}
+
+std::string CachingFileSystem::ensure_cached(const std::string& path) {
+  const size_t size = get_file_size(path);
+  if (capacity_ > 0 && size > capacity_) {
+    return {};
+  }
+  const std::string local_path = cache_path(cache_dir_, path, size);
+
+  std::error_code ec;
+  if (!fs::exists(local_path, ec)) {
+    FileLock lock(local_path + kLockSuffix);
+    // Another thread or process may have downloaded it while this one waited for the lock.
+    if (!fs::exists(local_path, ec)) {
+      evict(size);
+      std::stringstream temp_path;
+      temp_path << local_path << kTempInfix << getpid() << '.'
+                << std::hash<std::thread::id>{}(std::this_thread::get_id());
+      try {
+        download(path, size, temp_path.str());
+        fs::rename(temp_path.str(), local_path);
+      } catch (...) {
+        fs::remove(temp_path.str(), ec);
+        throw;
+      }
+      HCTR_LOG_S(DEBUG, WORLD) << "Cached " << path << " as " << local_path << std::endl;
+    }
+    fs::remove(local_path + kLockSuffix, ec);
+  }
+  // The mtime of a cached file is its last read.
+  fs::last_write_time(local_path, fs::file_time_type::clock::now(), ec);
+  return local_path;
+}
+
+void CachingFileSystem::download(const std::string& path, const size_t size,
+                                 const std::string& local_path) {
+  const int fd = open(local_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  HCTR_CHECK_HINT(fd >= 0, "Cannot create ", local_path);
+  std::vector<std::vector<char>> chunks(kChunksInFlight);
+  std::vector<std::future<int>> reads(kChunksInFlight);
+  try {
+    for (size_t first = 0; first < size; first += kChunkSize * kChunksInFlight) {
+      size_t num_chunks = 0;
+      for (size_t offset = first; offset < size && num_chunks < kChunksInFlight;
+           offset += kChunkSize, num_chunks++) {
+        chunks[num_chunks].resize(std::min(kChunkSize, size - offset));
+        reads[num_chunks] = remote_->read_async(path, chunks[num_chunks].data(),
+                                                chunks[num_chunks].size(), offset);
+      }
+      for (size_t i = 0; i < num_chunks; i++) {
+        const int bytes_read = reads[i].get();
+        HCTR_CHECK_HINT(bytes_read == static_cast<int>(chunks[i].size()), "Cannot read ",
+                        chunks[i].size(), " bytes of ", path, ", got ", bytes_read);
+        const size_t offset = first + i * kChunkSize;
+        for (size_t written = 0; written < chunks[i].size();) {
+          const ssize_t ret = pwrite(fd, chunks[i].data() + written, chunks[i].size() - written,
+                                     offset + written);
+          HCTR_CHECK_HINT(ret > 0, "Cannot write ", local_path);
+          written += ret;
+        }
+      }
+    }
+  } catch (...) {
+    // Wait for the reads still writing to the chunks before they are freed.
+    for (auto& read : reads) {
+      if (read.valid()) {
+        read.wait();
+      }
+    }
+    close(fd);
+    throw;
+  }
+  close(fd);
+}
+
+bool CachingFileSystem::is_prefetching(const std::string& path) {
+  std::lock_guard<std::mutex> lock(prefetch_mutex_);
+  return downloading_.count(path) > 0 ||
+         std::find(prefetch_queue_.begin(), prefetch_queue_.end(), path) != prefetch_queue_.end();
+}
+
+void CachingFileSystem::evict(const size_t incoming_size) {
+  if (capacity_ == 0) {
+    return;
+  }
+  FileLock lock((fs::path(cache_dir_) / kLockSuffix).string());
+
+  struct CachedFile {
+    fs::path path;
+    fs::file_time_type last_read;
+    size_t size;
+  };
+  std::vector<CachedFile> files;
+  size_t total_size = 0;
+  std::error_code ec;
+  for (const auto& entry : fs::directory_iterator(cache_dir_, ec)) {
+    if (!is_cached_file(entry)) {
+      continue;
+    }
+    CachedFile file{entry.path(), entry.last_write_time(ec), entry.file_size(ec)};
+    if (!ec) {
+      total_size += file.size;
+      files.push_back(std::move(file));
+    }
+  }
+  std::sort(files.begin(), files.end(), [](const CachedFile& a, const CachedFile& b) {
+    return a.last_read < b.last_read;
+  });
+  for (const auto& file : files) {
+    if (total_size + incoming_size <= capacity_) {
+      break;
+    }
+    if (fs::remove(file.path, ec)) {
+      total_size -= file.size;
+    }
+  }
+}
+
+void CachingFileSystem::forget(const std::string& path) {
+  std::lock_guard<std::mutex> lock(sizes_mutex_);
+  const auto it = sizes_.find(path);
+  if (it == sizes_.end()) {
+    return;
+  }
+  std::error_code ec;
+  fs::remove(cache_path(cache_dir_, path, it->second), ec);
+  sizes_.erase(it);
+}
+
+void CachingFileSystem::prefetch_loop() {
+  std::unique_lock<std::mutex> lock(prefetch_mutex_);
+  while (true) {
+    prefetch_cv_.wait(lock, [this] { return stop_ || !prefetch_queue_.empty(); });
+    if (stop_) {
+      return;
+    }
+    const std::string path = std::move(prefetch_queue_.front());
+    prefetch_queue_.pop_front();
+    downloading_.insert(path);
+    lock.unlock();
+    try {
+      ensure_cached(path);
+    } catch (const std::exception& e) {
+      HCTR_LOG_S(WARNING, WORLD) << "Cannot prefetch " << path << ": " << e.what() << std::endl;
+    }
+    lock.lock();
+    downloading_.erase(path);
+  }
+}
+
+}  // namespace HugeCTR
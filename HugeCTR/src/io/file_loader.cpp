@@ -18,6 +18,7 @@
 #include <sys/mman.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <io/file_loader.hpp>
 
 namespace HugeCTR {
@@ -66,7 +67,7 @@ Error_t FileLoader::load(const std::string& file_name) noexcept {
     return err;
   }
   if (use_mmap_) {
-    fd_ = open(cur_file_name_.c_str(), O_RDONLY, 0);
+    fd_ = ::open(cur_file_name_.c_str(), O_RDONLY, 0);
     if (fd_ == -1) {
       HCTR_LOG_S(ERROR, WORLD) << "Error open file for read " << HCTR_LOCATION() << std::endl;
       return Error_t::BrokenFile;
@@ -93,9 +94,65 @@ Error_t FileLoader::load(const std::string& file_name) noexcept {
   }
 }
 
+Error_t FileLoader::open(const std::string& file_name) noexcept {
+  Error_t err = set_file(file_name);
+  if (err != Error_t::Success) {
+    HCTR_LOG_S(ERROR, WORLD) << "Error open file for read " << HCTR_LOCATION() << std::endl;
+    return err;
+  }
+  if (use_mmap_) {
+    fd_ = ::open(cur_file_name_.c_str(), O_RDONLY, 0);
+    if (fd_ == -1) {
+      HCTR_LOG_S(ERROR, WORLD) << "Error open file for read " << HCTR_LOCATION() << std::endl;
+      return Error_t::BrokenFile;
+    }
+  }
+  return Error_t::Success;
+}
+
+long long FileLoader::read(char* data, size_t size, size_t offset) noexcept {
+  size = offset < cur_file_size_ ? std::min(size, cur_file_size_ - offset) : 0;
+  size_t bytes_read = 0;
+  while (bytes_read < size) {
+    // the remote file systems return an int
+    size_t chunk_size = std::min(size - bytes_read, size_t{1} << 30);
+    long long ret;
+    if (use_mmap_) {
+      ret = pread(fd_, data + bytes_read, chunk_size, offset + bytes_read);
+    } else {
+      ret = file_system_->read(cur_file_name_, data + bytes_read, chunk_size, offset + bytes_read);
+    }
+    if (ret < 0) {
+      HCTR_LOG_S(ERROR, WORLD) << "Error reading " << cur_file_name_ << ' ' << HCTR_LOCATION()
+                               << std::endl;
+      return -1;
+    }
+    if (ret == 0) {
+      break;
+    }
+    bytes_read += ret;
+  }
+  return bytes_read;
+}
+
+void FileLoader::prefetch(const std::vector<std::string>& file_names) {
+  if (file_system_) {
+    file_system_->prefetch(file_names);
+  }
+}
+
+void FileLoader::release(const std::string& file_name) {
+  if (file_system_) {
+    file_system_->release(file_name);
+  }
+}
+
 void FileLoader::clean() {
   if (use_mmap_ && fd_ != -1) {
-    munmap(data_, cur_file_size_);
+    if (data_ != nullptr) {
+      munmap(data_, cur_file_size_);
+      data_ = nullptr;
+    }
     close(fd_);
     fd_ = -1;
   } else if (!use_mmap_ && data_ != nullptr) {
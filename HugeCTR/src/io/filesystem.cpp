@@ -15,6 +15,7 @@
  */
 
 #include <core23/logger.hpp>
+#include <io/caching_filesystem.hpp>
 #include <io/filesystem.hpp>
 #include <io/gcs_filesystem.hpp>
 #include <io/hadoop_filesystem.hpp>
@@ -83,6 +84,15 @@ FileSystem* FileSystemBuilder::build_by_path(const std::string& file_path) {
 
 FileSystem* FileSystemBuilder::build_by_data_source_params(
     const DataSourceParams& data_source_params) {
+  if (data_source_params.type != FileSystemType_t::Local &&
+      !data_source_params.cache_dir.empty()) {
+    DataSourceParams remote_params = data_source_params;
+    remote_params.cache_dir.clear();
+    return new CachingFileSystem{
+        std::unique_ptr<FileSystem>{build_by_data_source_params(remote_params)},
+        data_source_params.cache_dir, data_source_params.cache_capacity,
+        data_source_params.prefetch_depth, data_source_params.evict_after_read};
+  }
   switch (data_source_params.type) {
     case FileSystemType_t::Local:
       return new LocalFileSystem{};
@@ -22,12 +22,16 @@
 #include <core23/logger.hpp>
 #include <fstream>
 #include <io/gcs_filesystem.hpp>
+#include <io/io_utils.hpp>
+#include <numeric>
 #include <string_view>
 
 namespace HugeCTR {
 
 #ifdef ENABLE_GCS
 auto constexpr kUploadBufferSize = 256 * 1024;
+// Max number of source objects of a compose request
+auto constexpr kMaxComposeSources = 32;
 
 namespace gcs = google::cloud::storage;
 
@@ -134,7 +138,9 @@ google::cloud::Options ToGoogleCloudOptions(const GCSConfigs& configs) {
   return options;
 }
 
-GCSFileSystem::GCSFileSystem(const GCSConfigs& configs) {
+GCSFileSystem::GCSFileSystem(const GCSConfigs& configs)
+    : part_size_(configs.part_size), max_concurrency_(configs.max_concurrency) {
+  HCTR_CHECK_HINT(part_size_ > 0, "The GCS part_size must be positive.");
   client_ = std::make_unique<gcs::Client>(ToGoogleCloudOptions(configs));
 }
 
@@ -167,6 +173,12 @@ void GCSFileSystem::fetch(const std::string& source_path, const std::string& tar
   GCSPath source_gcs_path = GCSPath::FromString(source_path);
   HCTR_CHECK_HINT(source_gcs_path.has_bucket_and_object(),
                   "The source GCS path does not contain bucket or key information.");
+  const size_t size = get_file_size(source_path);
+  if (size > part_size_) {
+    auto target = IOUtils::map_file_for_write(target_path, size);
+    read(source_path, target.get(), size, 0);
+    return;
+  }
   google::cloud::Status status =
       client_->DownloadToFile(source_gcs_path.bucket, source_gcs_path.object, target_path);
   HCTR_CHECK_HINT(status.ok(), "Failed to download the file from GCS.");
@@ -176,6 +188,12 @@ void GCSFileSystem::upload(const std::string& source_path, const std::string& ta
   GCSPath target_gcs_path = GCSPath::FromString(target_path);
   HCTR_CHECK_HINT(target_gcs_path.has_bucket_and_object(),
                   "This destination GCS path does not contain bucket or key information.");
+  size_t size;
+  auto source = IOUtils::map_file_for_read(source_path, &size);
+  if (size > part_size_) {
+    write(target_path, source.get(), size, true);
+    return;
+  }
   google::cloud::StatusOr<gcs::ObjectMetadata> object_metadata =
       client_->UploadFile(source_path, target_gcs_path.bucket, target_gcs_path.object,
                           gcs::IfGenerationMatch(0), gcs::NewResumableUploadSession());
@@ -187,6 +205,11 @@ int GCSFileSystem::write(const std::string& path, const void* const data, const
   GCSPath gcs_path = GCSPath::FromString(path);
   HCTR_CHECK_HINT(gcs_path.has_bucket_and_object(),
                   "This GCS path does not contain bucket or key information.");
+  if (data_size > part_size_) {
+    composite_write(gcs_path, data, data_size);
+    HCTR_LOG_S(DEBUG, WORLD) << "Successfully write to GCS location:  " << path << std::endl;
+    return data_size;
+  }
   gcs::ObjectWriteStream stream =
       client_->WriteObject(gcs_path.bucket, gcs_path.object, gcs::NewResumableUploadSession(),
                            gcs::AutoFinalizeEnabled());
@@ -200,14 +223,91 @@ int GCSFileSystem::write(const std::string& path, const void* const data, const
   return data_size;
 }
 
+/**
+ * @brief GCS has no multipart upload, a large object is uploaded as parallel composite upload:
+ * the parts are uploaded in parallel as temporary objects, composed into the object, at most
+ * kMaxComposeSources at a time, and deleted.
+ */
+void GCSFileSystem::composite_write(const GCSPath& gcs_path, const void* const data,
+                                    const size_t data_size) {
+  const size_t num_parts = (data_size + part_size_ - 1) / part_size_;
+  std::vector<gcs::ComposeSourceObject> parts(num_parts);
+  std::vector<char> uploaded(num_parts, false);  // Not vector<bool>, set by several threads
+  auto delete_parts = [&] {
+    IOUtils::parallel_for(num_parts, max_concurrency_, [&](size_t i) {
+      if (!uploaded[i]) {
+        return;
+      }
+      google::cloud::Status status = client_->DeleteObject(
+          gcs_path.bucket, parts[i].object_name, gcs::Generation(*parts[i].generation));
+      if (!status.ok()) {
+        HCTR_LOG_S(WARNING, WORLD) << "Cannot delete the temporary GCS object "
+                                   << parts[i].object_name << std::endl;
+      }
+    });
+  };
+
+  try {
+    IOUtils::parallel_for(num_parts, max_concurrency_, [&](size_t i) {
+      const size_t offset = i * part_size_;
+      const size_t nbytes = std::min(part_size_, data_size - offset);
+      const std::string part_object = gcs_path.object + ".part-" + std::to_string(i);
+      google::cloud::StatusOr<gcs::ObjectMetadata> part_metadata = client_->InsertObject(
+          gcs_path.bucket, part_object,
+          std::string(static_cast<const char*>(data) + offset, nbytes));
+      HCTR_CHECK_HINT(part_metadata.ok(), "Failed to upload a part to GCS.");
+      parts[i] = {part_object, part_metadata->generation(), {}};
+      uploaded[i] = true;
+    });
+
+    // The object is the first source of every compose but the first one.
+    for (size_t begin = 0; begin < num_parts;) {
+      std::vector<gcs::ComposeSourceObject> sources;
+      if (begin > 0) {
+        sources.push_back({gcs_path.object, {}, {}});
+      }
+      const size_t end = std::min(num_parts, begin + kMaxComposeSources - sources.size());
+      sources.insert(sources.end(), parts.begin() + begin, parts.begin() + end);
+      google::cloud::StatusOr<gcs::ObjectMetadata> object_metadata =
+          client_->ComposeObject(gcs_path.bucket, sources, gcs_path.object);
+      HCTR_CHECK_HINT(object_metadata.ok(), "Failed to compose the parts of a GCS object.");
+      begin = end;
+    }
+  } catch (...) {
+    delete_parts();
+    throw;
+  }
+  delete_parts();
+}
+
 int GCSFileSystem::read(const std::string& path, void* const buffer, const size_t buffer_size,
                         const size_t offset) {
   GCSPath gcs_path = GCSPath::FromString(path);
   HCTR_CHECK_HINT(gcs_path.has_bucket_and_object(),
                   "This GCS path does not contain bucket or key information.");
+  if (buffer_size <= part_size_) {
+    return read_range(gcs_path, buffer, buffer_size, offset);
+  }
+  const size_t content_length = get_file_size(path);
+  const size_t nbytes =
+      offset < content_length ? std::min(buffer_size, content_length - offset) : 0;
+
+  // Ranged reads of part_size bytes, up to max_concurrency of them in flight.
+  const size_t num_parts = (nbytes + part_size_ - 1) / part_size_;
+  std::vector<size_t> part_nbytes(num_parts);
+  IOUtils::parallel_for(num_parts, max_concurrency_, [&](size_t i) {
+    const size_t part_offset = i * part_size_;
+    part_nbytes[i] = read_range(gcs_path, static_cast<char*>(buffer) + part_offset,
+                                std::min(part_size_, nbytes - part_offset), offset + part_offset);
+  });
+  return std::accumulate(part_nbytes.begin(), part_nbytes.end(), size_t{0});
+}
+
+size_t GCSFileSystem::read_range(const GCSPath& gcs_path, void* const buffer, const size_t nbytes,
+                                 const size_t offset) {
   gcs::ObjectReadStream stream = client_->ReadObject(gcs_path.bucket, gcs_path.object,
-                                                     gcs::ReadRange(offset, offset + buffer_size));
-  stream.read(reinterpret_cast<char*>(buffer), buffer_size);
+                                                     gcs::ReadRange(offset, offset + nbytes));
+  stream.read(reinterpret_cast<char*>(buffer), nbytes);
   stream.Close();
   HCTR_CHECK_HINT(!stream.IsOpen(), "Failed to read from GCS.");
   return stream.gcount();
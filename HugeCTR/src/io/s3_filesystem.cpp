@@ -19,21 +19,29 @@
 #include <aws/core/auth/AWSCredentialsProviderChain.h>
 #include <aws/core/utils/logging/ConsoleLogSystem.h>
 #include <aws/core/utils/stream/PreallocatedStreamBuf.h>
+#include <aws/s3/model/AbortMultipartUploadRequest.h>
+#include <aws/s3/model/CompleteMultipartUploadRequest.h>
+#include <aws/s3/model/CompletedMultipartUpload.h>
+#include <aws/s3/model/CompletedPart.h>
 #include <aws/s3/model/CopyObjectRequest.h>
 #include <aws/s3/model/CreateBucketRequest.h>
+#include <aws/s3/model/CreateMultipartUploadRequest.h>
 #include <aws/s3/model/DeleteBucketRequest.h>
 #include <aws/s3/model/DeleteObjectRequest.h>
 #include <aws/s3/model/DeleteObjectsRequest.h>
 #include <aws/s3/model/GetObjectRequest.h>
 #include <aws/s3/model/HeadObjectRequest.h>
 #include <aws/s3/model/PutObjectRequest.h>
+#include <aws/s3/model/UploadPartRequest.h>
 #endif
 
 #include <core23/logger.hpp>
 #include <fstream>
+#include <io/io_utils.hpp>
 #include <io/s3_filesystem.hpp>
 #include <io/s3_utils.hpp>
 #include <nlohmann/json.hpp>
+#include <numeric>
 
 namespace HugeCTR {
 
@@ -77,6 +85,12 @@ void S3Configs::set_all_from_json(const std::string& path) {
   std::string fs_type = (std::string)config.find("fs_type").value();
   HCTR_CHECK_HINT(fs_type == "S3", "Not a valid S3 configuration file.");
   // TODO: parse more configs
+  if (config.contains("part_size")) {
+    part_size = config["part_size"].get<size_t>();
+  }
+  if (config.contains("max_concurrency")) {
+    max_concurrency = config["max_concurrency"].get<int>();
+  }
   file_stream.close();
   return;
 }
@@ -125,6 +139,8 @@ std::unique_ptr<Aws::S3::S3Client> S3ClientBuilder::build_s3client() {
     client_configs_.connectTimeoutMs = static_cast<long>(ceil(configs_.connect_timeout * 1000));
   }
   client_configs_.endpointOverride = S3Utils::to_aws_string(configs_.endpoint_override);
+  client_configs_.maxConnections =
+      std::max(client_configs_.maxConnections, static_cast<unsigned>(configs_.max_concurrency));
   if (configs_.scheme == "http") {
     client_configs_.scheme = Aws::Http::Scheme::HTTP;
   } else if (configs_.scheme == "https") {
@@ -150,7 +166,10 @@ Aws::IOStreamFactory AwsWriteableStreamFactory(void* data, size_t nbytes) {
   return [=]() { return Aws::New<StringViewStream>("", data, nbytes); };
 }
 
-S3FileSystem::S3FileSystem(const S3Configs& configs) {
+S3FileSystem::S3FileSystem(const S3Configs& configs)
+    : part_size_(configs.part_size), max_concurrency_(configs.max_concurrency) {
+  // Parts of a multipart upload but the last one take at least 5 MiB.
+  HCTR_CHECK_HINT(part_size_ >= (5 << 20), "The S3 part_size must be at least 5 MiB.");
   try {
     std::call_once(sdk_is_running, start_aws_sdk);
   } catch (const std::runtime_error& rt_err) {
@@ -200,13 +219,15 @@ void S3FileSystem::delete_file(const std::string& path) {
 }
 
 void S3FileSystem::fetch(const std::string& source_path, const std::string& target_path) {
-  // TODO
-  HCTR_DIE("Not implemented yet!");
+  const size_t size = get_file_size(source_path);
+  auto target = IOUtils::map_file_for_write(target_path, size);
+  read(source_path, target.get(), size, 0);
 }
 
 void S3FileSystem::upload(const std::string& source_path, const std::string& target_path) {
-  // TODO
-  HCTR_DIE("Not implemented yet!");
+  size_t size;
+  auto source = IOUtils::map_file_for_read(source_path, &size);
+  write(target_path, source.get(), size, true);
 }
 
 int S3FileSystem::write(const std::string& path, const void* const data, const size_t data_size,
@@ -214,6 +235,11 @@ int S3FileSystem::write(const std::string& path, const void* const data, const s
   S3Path s3_path = S3Path::FromString(path);
   HCTR_CHECK_HINT(s3_path.has_bucket_and_key(),
                   "This S3 path does not contain bucket or key information.");
+  if (data_size > part_size_) {
+    multipart_write(s3_path, data, data_size);
+    HCTR_LOG_S(DEBUG, WORLD) << "Successfully write to AWS S3 location:  " << path << std::endl;
+    return data_size;
+  }
   Aws::S3::Model::PutObjectRequest request;
   request.SetBucket(S3Utils::to_aws_string(s3_path.bucket));
   request.SetKey(S3Utils::to_aws_string(s3_path.key));
@@ -230,11 +256,78 @@ int S3FileSystem::write(const std::string& path, const void* const data, const s
   return data_size;
 }
 
+void S3FileSystem::multipart_write(const S3Path& s3_path, const void* const data,
+                                   const size_t data_size) {
+  const Aws::String bucket = S3Utils::to_aws_string(s3_path.bucket);
+  const Aws::String key = S3Utils::to_aws_string(s3_path.key);
+  const size_t num_parts = (data_size + part_size_ - 1) / part_size_;
+  HCTR_CHECK_HINT(num_parts <= 10000, "An S3 multipart upload takes up to 10000 parts.");
+
+  Aws::S3::Model::CreateMultipartUploadRequest create_request;
+  create_request.SetBucket(bucket);
+  create_request.SetKey(key);
+  auto create_outcome = client_->CreateMultipartUpload(create_request);
+  HCTR_CHECK_HINT(create_outcome.IsSuccess(), "Failed to start the multipart upload to S3.");
+  const Aws::String upload_id = create_outcome.GetResult().GetUploadId();
+
+  // The parts are uploaded in parallel, each from its slice of data.
+  Aws::Vector<Aws::S3::Model::CompletedPart> parts(num_parts);
+  try {
+    IOUtils::parallel_for(num_parts, max_concurrency_, [&](size_t i) {
+      const size_t offset = i * part_size_;
+      const size_t nbytes = std::min(part_size_, data_size - offset);
+      Aws::S3::Model::UploadPartRequest request;
+      request.SetBucket(bucket);
+      request.SetKey(key);
+      request.SetUploadId(upload_id);
+      request.SetPartNumber(static_cast<int>(i + 1));
+      request.SetContentLength(nbytes);
+      request.SetBody(Aws::MakeShared<StringViewStream>(
+          "UploadPartInputStream", static_cast<const char*>(data) + offset, nbytes));
+      auto outcome = client_->UploadPart(request);
+      HCTR_CHECK_HINT(outcome.IsSuccess(), "Failed to upload a part to S3.");
+      parts[i].SetPartNumber(static_cast<int>(i + 1));
+      parts[i].SetETag(outcome.GetResult().GetETag());
+    });
+  } catch (...) {
+    Aws::S3::Model::AbortMultipartUploadRequest abort_request;
+    abort_request.SetBucket(bucket);
+    abort_request.SetKey(key);
+    abort_request.SetUploadId(upload_id);
+    client_->AbortMultipartUpload(abort_request);
+    throw;
+  }
+
+  Aws::S3::Model::CompletedMultipartUpload completed_upload;
+  completed_upload.SetParts(std::move(parts));
+  Aws::S3::Model::CompleteMultipartUploadRequest complete_request;
+  complete_request.SetBucket(bucket);
+  complete_request.SetKey(key);
+  complete_request.SetUploadId(upload_id);
+  complete_request.SetMultipartUpload(std::move(completed_upload));
+  auto outcome = client_->CompleteMultipartUpload(complete_request);
+  HCTR_CHECK_HINT(outcome.IsSuccess(), "Failed to complete the multipart upload to S3.");
+}
+
 int S3FileSystem::read(const std::string& path, void* const buffer, const size_t buffer_size,
                        const size_t offset) {
   size_t content_length = get_file_size(path);
-  size_t nbytes = std::min(buffer_size, content_length - offset);
+  size_t nbytes = offset < content_length ? std::min(buffer_size, content_length - offset) : 0;
   S3Path s3_path = S3Path::FromString(path);
+
+  // Ranged GETs of part_size bytes, up to max_concurrency of them in flight.
+  const size_t num_parts = (nbytes + part_size_ - 1) / part_size_;
+  std::vector<size_t> part_nbytes(num_parts);
+  IOUtils::parallel_for(num_parts, max_concurrency_, [&](size_t i) {
+    const size_t part_offset = i * part_size_;
+    part_nbytes[i] = read_range(s3_path, static_cast<char*>(buffer) + part_offset,
+                                std::min(part_size_, nbytes - part_offset), offset + part_offset);
+  });
+  return std::accumulate(part_nbytes.begin(), part_nbytes.end(), size_t{0});
+}
+
+size_t S3FileSystem::read_range(const S3Path& s3_path, void* const buffer, const size_t nbytes,
+                                const size_t offset) {
   Aws::S3::Model::GetObjectRequest get_request;
   get_request.SetBucket(S3Utils::to_aws_string(s3_path.bucket));
   get_request.SetKey(S3Utils::to_aws_string(s3_path.key));
@@ -244,9 +337,7 @@ int S3FileSystem::read(const std::string& path, void* const buffer, const size_t
   get_request.SetResponseStreamFactory(AwsWriteableStreamFactory(buffer, nbytes));
   Aws::S3::Model::GetObjectOutcome outcome = client_->GetObject(get_request);
   HCTR_CHECK_HINT(outcome.IsSuccess(), "Failed to read the file.");
-  Aws::S3::Model::GetObjectResult result = std::move(outcome).GetResultWithOwnership();
-  auto& stream = result.GetBody();
-  return stream.gcount();
+  return outcome.GetResult().GetContentLength();
 }
 
 void S3FileSystem::copy(const std::string& source_path, const std::string& target_path) {
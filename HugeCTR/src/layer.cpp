@@ -29,4 +29,17 @@ Layer::Layer(const std::vector<core23::Tensor>& input_tensors,
 
 void Layer::init_params(const curandGenerator_t& generator) { return; }
 
+double Layer::get_bytes(bool fprop) const {
+  double bytes = 0.0;
+  for (const auto& tensor : input_tensors_) {
+    bytes += tensor.empty() ? 0 : tensor.num_bytes();
+  }
+  for (const auto& tensor : output_tensors_) {
+    bytes += tensor.empty() ? 0 : tensor.num_bytes();
+  }
+  // The bprop reads the gradients of the outputs and the inputs, and writes the gradients of the
+  // inputs.
+  return fprop ? bytes : 2.0 * bytes;
+}
+
 }  // namespace HugeCTR
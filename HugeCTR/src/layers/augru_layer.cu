@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <layers/augru_layer.hpp>
+#include <linalg/reduce.cuh>
+#include <utils.cuh>
+#include <utils.hpp>
+#include <vector>
+
+namespace HugeCTR {
+
+namespace {
+
+constexpr int kMaxThreads = 1024;
+
+// Attention score of step t of sample b, zero past the sequence length
+__device__ __forceinline__ float step_attention(const float* att, const float* seq_lens, int b,
+                                                int t, int seq_len) {
+  if (seq_lens != nullptr && t >= static_cast<int>(seq_lens[b])) {
+    return 0.0f;
+  }
+  return att[b * seq_len + t];
+}
+
+__device__ __forceinline__ float sigmoid(float x) { return 1.0f / (1.0f + expf(-x)); }
+
+__global__ void augru_cell_fprop_kernel(const float* gates_x, const float* gates_h,
+                                        const float* bias, const float* att,
+                                        const float* seq_lens, const float* h_prev, float* gates,
+                                        float* h, int t, int batch_size, int seq_len,
+                                        int hidden_size) {
+  const int gate_size = 3 * hidden_size;
+  for (int idx = blockIdx.x * blockDim.x + threadIdx.x; idx < batch_size * hidden_size;
+       idx += blockDim.x * gridDim.x) {
+    const int b = idx / hidden_size;
+    const int j = idx % hidden_size;
+    const float* gx = gates_x + (static_cast<int64_t>(b) * seq_len + t) * gate_size;
+    const float* gh = gates_h + b * gate_size;
+
+    const float u = sigmoid(gx[j] + gh[j] + bias[j]);
+    const float r = sigmoid(gx[hidden_size + j] + gh[hidden_size + j] + bias[hidden_size + j]);
+    const float c =
+        tanhf(gx[2 * hidden_size + j] + r * gh[2 * hidden_size + j] + bias[2 * hidden_size + j]);
+    const float au = step_attention(att, seq_lens, b, t, seq_len) * u;
+
+    float* g = gates + b * gate_size;
+    g[j] = u;
+    g[hidden_size + j] = r;
+    g[2 * hidden_size + j] = c;
+    h[idx] = (1.0f - au) * h_prev[idx] + au * c;
+  }
+}
+
+// One block per sample, the attention gradient is reduced over the hidden units of the block.
+// gates_x and gates_h are overwritten by the gradients of the pre-activations, dh by the part of
+// the gradient of h_prev that does not go through U.
+__global__ void augru_cell_bprop_kernel(float* gates_x, float* gates_h, const float* gates,
+                                        float* att, const float* seq_lens, const float* h_prev,
+                                        float* dh, int t, int batch_size, int seq_len,
+                                        int hidden_size) {
+  const int b = blockIdx.x;
+  const int gate_size = 3 * hidden_size;
+  const float a = step_attention(att, seq_lens, b, t, seq_len);
+  float* dgx = gates_x + (static_cast<int64_t>(b) * seq_len + t) * gate_size;
+  float* dgh = gates_h + b * gate_size;
+  const float* g = gates + b * gate_size;
+  h_prev += b * hidden_size;
+  dh += b * hidden_size;
+
+  float da = 0.0f;
+  for (int j = threadIdx.x; j < hidden_size; j += blockDim.x) {
+    const float u = g[j];
+    const float r = g[hidden_size + j];
+    const float c = g[2 * hidden_size + j];
+    const float hc = dgh[2 * hidden_size + j];  // h_prev U_c
+    const float grad = dh[j];
+
+    const float dau = grad * (c - h_prev[j]);
+    da += dau * u;
+    const float dc = grad * a * u * (1.0f - c * c);
+    const float du = dau * a * u * (1.0f - u);
+    const float dr = dc * hc * r * (1.0f - r);
+
+    dgx[j] = du;
+    dgx[hidden_size + j] = dr;
+    dgx[2 * hidden_size + j] = dc;
+    dgh[j] = du;
+    dgh[hidden_size + j] = dr;
+    dgh[2 * hidden_size + j] = dc * r;
+    dh[j] = grad * (1.0f - a * u);
+  }
+
+  // every thread has read its attention score before the block reduction syncs
+  da = blockReduceSum(da);
+  if (threadIdx.x == 0) {
+    const bool valid = seq_lens == nullptr || t < static_cast<int>(seq_lens[b]);
+    att[b * seq_len + t] = valid ? da : 0.0f;
+  }
+}
+
+// C(m, n) = op(A) * op(B) + beta * C in row major
+void gemm(cublasHandle_t handle, bool trans_a, bool trans_b, int64_t m, int64_t n, int64_t k,
+          const float* a, const float* b, float beta, float* c) {
+  const float alpha = 1.0f;
+  HCTR_LIB_THROW(cublasGemmEx(handle, trans_b ? CUBLAS_OP_T : CUBLAS_OP_N,
+                              trans_a ? CUBLAS_OP_T : CUBLAS_OP_N, n, m, k, &alpha, b, CUDA_R_32F,
+                              trans_b ? k : n, a, CUDA_R_32F, trans_a ? m : k, &beta, c,
+                              CUDA_R_32F, n, CUBLAS_COMPUTE_32F, CUBLAS_GEMM_DEFAULT));
+}
+
+}  // namespace
+
+AUGRULayer<float>::AUGRULayer(const std::vector<core23::Tensor>& in_tensors,
+                              const core23::Tensor& out_tensor,
+                              const std::shared_ptr<GPUResource>& gpu_resource,
+                              std::vector<Initializer_t> initializer_types)
+    : TrainableLayer<float>(in_tensors, {out_tensor}, gpu_resource, initializer_types) {
+  try {
+    if (in_tensors.size() != 2 && in_tensors.size() != 3) {
+      HCTR_OWN_THROW(Error_t::WrongInput,
+                     "AUGRULayer needs the sequence, the attention scores and optionally the "
+                     "sequence lengths");
+    }
+    const auto& in_shape = in_tensors[0].shape();
+    if (in_shape.dims() != 3) {
+      HCTR_OWN_THROW(Error_t::WrongInput, "AUGRULayer input must be 3D");
+    }
+    batch_size_ = in_shape.size(0);
+    seq_len_ = in_shape.size(1);
+    vector_size_ = in_shape.size(2);
+    hidden_size_ = out_tensor.shape().size(out_tensor.shape().dims() - 1);
+
+    if (in_tensors[1].num_elements() != batch_size_ * seq_len_) {
+      HCTR_OWN_THROW(Error_t::WrongInput,
+                     "AUGRULayer needs one attention score per step of each sample");
+    }
+    if (in_tensors.size() == 3 && in_tensors[2].num_elements() != batch_size_) {
+      HCTR_OWN_THROW(Error_t::WrongInput, "AUGRULayer needs one sequence length per sample");
+    }
+    if (out_tensor.num_elements() != batch_size_ * hidden_size_) {
+      HCTR_OWN_THROW(Error_t::WrongInput, "AUGRULayer output must be (batch_size, hidden_size)");
+    }
+
+    const int64_t gate_size = 3 * hidden_size_;
+    // W, U and b
+    this->set_weight(0, {vector_size_, gate_size});
+    this->set_weight(1, {hidden_size_, gate_size});
+    this->set_weight(2, {1, gate_size});
+    this->set_wgrad(0, {vector_size_, gate_size});
+    this->set_wgrad(1, {hidden_size_, gate_size});
+    this->set_wgrad(2, {1, gate_size});
+
+    core23::BufferParams blobs_buffer_params = {};
+    blobs_buffer_params.channel = GetBlobsBufferChannel();
+    core23::TensorParams tensor_params =
+        core23::TensorParams()
+            .data_type(core23::ScalarType::Float)
+            .device(core23::Device(core23::DeviceType::GPU, gpu_resource->get_device_id()))
+            .buffer_params(blobs_buffer_params);
+
+    gates_x_ = core23::Tensor(tensor_params.shape({batch_size_ * seq_len_, gate_size}));
+    gates_h_ = core23::Tensor(tensor_params.shape({seq_len_, batch_size_, gate_size}));
+    gates_ = core23::Tensor(tensor_params.shape({seq_len_, batch_size_, gate_size}));
+    hiddens_ = core23::Tensor(tensor_params.shape({seq_len_ + 1, batch_size_, hidden_size_}));
+    dh_ = core23::Tensor(tensor_params.shape({batch_size_, hidden_size_}));
+  } catch (const std::runtime_error& rt_err) {
+    HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
+    throw;
+  }
+}
+
+void AUGRULayer<float>::fprop(bool is_train) {
+  CudaDeviceContext context(get_device_id());
+  const auto& stream = get_gpu().get_stream();
+  const auto& handle = get_gpu().get_cublas_handle();
+
+  const float* w = this->get_weight(0).data<float>();
+  const float* u = this->get_weight(1).data<float>();
+  const float* bias = this->get_weight(2).data<float>();
+  const float* in = input_tensors_[0].data<float>();
+  const float* att = input_tensors_[1].data<float>();
+  const float* seq_lens = input_tensors_.size() == 3 ? input_tensors_[2].data<float>() : nullptr;
+  float* out = output_tensors_[0].data<float>();
+
+  const int64_t gate_size = 3 * hidden_size_;
+  const int64_t step_hidden = batch_size_ * hidden_size_;
+  const int64_t step_gates = batch_size_ * gate_size;
+  float* gates_x = gates_x_.data<float>();
+  float* gates_h = gates_h_.data<float>();
+  float* gates = gates_.data<float>();
+  float* hiddens = hiddens_.data<float>();
+
+  // the input projection of every step at once
+  gemm(handle, false, false, batch_size_ * seq_len_, gate_size, vector_size_, in, w, 0.0f,
+       gates_x);
+  HCTR_LIB_THROW(cudaMemsetAsync(hiddens, 0, step_hidden * sizeof(float), stream));
+
+  const int block_size = std::min(step_hidden, static_cast<int64_t>(kMaxThreads));
+  const int grid_size = (step_hidden - 1) / block_size + 1;
+  for (int64_t t = 0; t < seq_len_; t++) {
+    const float* h_prev = hiddens + t * step_hidden;
+    gemm(handle, false, false, batch_size_, gate_size, hidden_size_, h_prev, u, 0.0f,
+         gates_h + t * step_gates);
+    augru_cell_fprop_kernel<<<grid_size, block_size, 0, stream>>>(
+        gates_x, gates_h + t * step_gates, bias, att, seq_lens, h_prev, gates + t * step_gates,
+        hiddens + (t + 1) * step_hidden, t, batch_size_, seq_len_, hidden_size_);
+  }
+  HCTR_LIB_THROW(cudaMemcpyAsync(out, hiddens + seq_len_ * step_hidden,
+                                 step_hidden * sizeof(float), cudaMemcpyDeviceToDevice, stream));
+}
+
+void AUGRULayer<float>::bprop() {
+  CudaDeviceContext context(get_device_id());
+  const auto& stream = get_gpu().get_stream();
+  const auto& handle = get_gpu().get_cublas_handle();
+
+  const float* w = this->get_weight(0).data<float>();
+  const float* u = this->get_weight(1).data<float>();
+  float* w_grad = this->get_wgrad(0).data<float>();
+  float* u_grad = this->get_wgrad(1).data<float>();
+  float* bias_grad = this->get_wgrad(2).data<float>();
+  float* in = input_tensors_[0].data<float>();
+  float* att = input_tensors_[1].data<float>();
+  const float* seq_lens = input_tensors_.size() == 3 ? input_tensors_[2].data<float>() : nullptr;
+  const float* out = output_tensors_[0].data<float>();
+
+  const int64_t gate_size = 3 * hidden_size_;
+  const int64_t step_hidden = batch_size_ * hidden_size_;
+  const int64_t step_gates = batch_size_ * gate_size;
+  float* gates_x = gates_x_.data<float>();
+  float* gates_h = gates_h_.data<float>();
+  const float* gates = gates_.data<float>();
+  const float* hiddens = hiddens_.data<float>();
+  float* dh = dh_.data<float>();
+
+  HCTR_LIB_THROW(cudaMemcpyAsync(dh, out, step_hidden * sizeof(float), cudaMemcpyDeviceToDevice,
+                                 stream));
+  const int block_size =
+      std::min((hidden_size_ + 31) / 32 * 32, static_cast<int64_t>(kMaxThreads));
+  for (int64_t t = seq_len_ - 1; t >= 0; t--) {
+    augru_cell_bprop_kernel<<<batch_size_, block_size, 0, stream>>>(
+        gates_x, gates_h + t * step_gates, gates + t * step_gates, att, seq_lens,
+        hiddens + t * step_hidden, dh, t, batch_size_, seq_len_, hidden_size_);
+    // dh_{t-1} += dgates_h U^T
+    gemm(handle, false, true, batch_size_, hidden_size_, gate_size, gates_h + t * step_gates, u,
+         1.0f, dh);
+  }
+
+  // the weight gradients of all the steps at once
+  gemm(handle, true, false, hidden_size_, gate_size, seq_len_ * batch_size_, hiddens, gates_h,
+       0.0f, u_grad);
+  gemm(handle, true, false, vector_size_, gate_size, batch_size_ * seq_len_, in, gates_x, 0.0f,
+       w_grad);
+  MLCommon::LinAlg::reduce(bias_grad, gates_x, batch_size_ * seq_len_, gate_size, float(0), false,
+                           true, stream, true);
+  // the input is no longer needed once its weight gradient is computed
+  gemm(handle, false, true, batch_size_ * seq_len_, vector_size_, gate_size, gates_x, w, 0.0f,
+       in);
+}
+
+std::unique_ptr<DataSimulator> AUGRULayer<float>::get_default_initializer(const int index) {
+  if (index < 0 || index > 2) {
+    HCTR_OWN_THROW(Error_t::OutOfBound, "index != {0, 1, 2}.");
+  }
+  const float limit = 1.0f / sqrtf(static_cast<float>(hidden_size_));
+  return std::make_unique<UniformDataSimulator>(-1 * limit, limit);
+}
+
+template class AUGRULayer<float>;
+
+}  // namespace HugeCTR
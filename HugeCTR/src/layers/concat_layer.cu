@@ -14,7 +14,9 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <common.hpp>
+#include <core23/tensor_operations.hpp>
 #include <layers/concat_layer.hpp>
 #include <network_buffer_channels.hpp>
 #include <utils.hpp>
@@ -23,23 +25,32 @@ namespace HugeCTR {
 
 namespace {
 
+// blockIdx.y picks the input, so that all of them are copied in a single launch, and the threads
+// of a block span the rows of a narrow input instead of idling past its width.
 template <typename T>
-__global__ void concat_fwd_kernel(T* out, const int2 out_dim, T* in, const int2 in_dim,
-                                  int offset) {
-  for (int mi = blockIdx.x; mi < in_dim.x; mi += gridDim.x) {
-    for (int ni = threadIdx.x; ni < in_dim.y; ni += blockDim.x) {
-      out[mi * out_dim.y + offset + ni] = in[mi * in_dim.y + ni];
-    }
+__global__ void concat_fwd_kernel(T* out, const int2 out_dim, T* const* ins, const int* offsets) {
+  const int offset = offsets[blockIdx.y];
+  const int width = offsets[blockIdx.y + 1] - offset;
+  const T* in = ins[blockIdx.y];
+  for (int idx = blockIdx.x * blockDim.x + threadIdx.x; idx < out_dim.x * width;
+       idx += blockDim.x * gridDim.x) {
+    const int mi = idx / width;
+    const int ni = idx - mi * width;
+    out[mi * out_dim.y + offset + ni] = in[idx];
   }
 }
 
 template <typename T>
-__global__ void concat_bwd_kernel(T* out, const int2 out_dim, T* in, const int2 in_dim,
-                                  int offset) {
-  for (int mi = blockIdx.x; mi < in_dim.x; mi += gridDim.x) {
-    for (int ni = threadIdx.x; ni < in_dim.y; ni += blockDim.x) {
-      in[mi * in_dim.y + ni] = out[mi * out_dim.y + offset + ni];
-    }
+__global__ void concat_bwd_kernel(const T* out, const int2 out_dim, T* const* ins,
+                                  const int* offsets) {
+  const int offset = offsets[blockIdx.y];
+  const int width = offsets[blockIdx.y + 1] - offset;
+  T* in = ins[blockIdx.y];
+  for (int idx = blockIdx.x * blockDim.x + threadIdx.x; idx < out_dim.x * width;
+       idx += blockDim.x * gridDim.x) {
+    const int mi = idx / width;
+    const int ni = idx - mi * width;
+    in[idx] = out[mi * out_dim.y + offset + ni];
   }
 }
 
@@ -72,6 +83,7 @@ ConcatLayer<T>::ConcatLayer(const std::vector<core23::Tensor>& input_tensors,
         height = cur_in_shape.size(0);
       }
       new_width += cur_in_shape.size(1);
+      max_width_ = std::max(max_width_, static_cast<int>(cur_in_shape.size(1)));
     }
     core23::BufferParams buf_p{.channel = GetBlobsBufferChannel()};
 
@@ -84,51 +96,59 @@ ConcatLayer<T>::ConcatLayer(const std::vector<core23::Tensor>& input_tensors,
   }
 }
 
+template <typename T>
+void ConcatLayer<T>::initialize() {
+  CudaDeviceContext context(get_device_id());
+
+  core23::Device device(core23::DeviceType::GPU, get_device_id());
+  const int64_t n_input_tensors = input_tensors_.size();
+  input_tensor_ptrs_ = core23::Tensor(core23::TensorParams()
+                                          .shape({n_input_tensors})
+                                          .data_type(core23::ScalarType::Pointer)
+                                          .device(device));
+  offsets_ = core23::Tensor(core23::TensorParams()
+                                .shape({n_input_tensors + 1})
+                                .data_type(core23::ScalarType::Int32)
+                                .device(device));
+  std::vector<void*> ptr_cpu;
+  std::vector<int32_t> offsets_cpu(1, 0);
+  // the input tensors must be allocated before initialize() is called
+  for (auto& input_tensor : input_tensors_) {
+    ptr_cpu.push_back(input_tensor.data());
+    offsets_cpu.push_back(offsets_cpu.back() + static_cast<int32_t>(input_tensor.shape().size(1)));
+  }
+  core23::copy_async(input_tensor_ptrs_, ptr_cpu, get_gpu().get_stream());
+  core23::copy_async(offsets_, offsets_cpu, get_gpu().get_stream());
+}
+
 template <typename T>
 void ConcatLayer<T>::fprop(bool is_train) {
   CudaDeviceContext context(get_device_id());
-  auto stream = get_gpu().get_stream();
 
-  int n_input_tensors = input_tensors_.size();
-  int block_size = 256;
-  int n_blocks = get_gpu().get_sm_count() * 8;
   auto& output_tensor = output_tensors_[0];
-  T* out = output_tensor.data<T>();
   const int2 out_dim = {static_cast<int>(output_tensor.shape().size(0)),
                         static_cast<int>(output_tensor.shape().size(1))};
-  int offset = 0;
-  for (auto& input_tensor : input_tensors_) {
-    T* in = input_tensor.data<T>();
-    const int2 in_dim = {static_cast<int>(input_tensor.shape().size(0)),
-                         static_cast<int>(input_tensor.shape().size(1))};
-
-    concat_fwd_kernel<<<n_blocks, block_size, 0, stream>>>(out, out_dim, in, in_dim, offset);
-    offset += in_dim.y;
-  }
+  const int block_size = 256;
+  const int n_blocks = get_gpu().get_sm_count() * 8;
+  const dim3 grid_size(std::min((out_dim.x * max_width_ - 1) / block_size + 1, n_blocks),
+                       input_tensors_.size());
+  concat_fwd_kernel<<<grid_size, block_size, 0, get_gpu().get_stream()>>>(
+      output_tensor.data<T>(), out_dim, input_tensor_ptrs_.data<T*>(), offsets_.data<int>());
 }
 
 template <typename T>
 void ConcatLayer<T>::bprop() {
   CudaDeviceContext context(get_device_id());
-  auto stream = get_gpu().get_stream();
 
-  int block_size = 256;
-  int n_blocks = get_gpu().get_sm_count() * 8;
   auto& output_tensor = output_tensors_[0];
-  T* out = output_tensor.data<T>();
   const int2 out_dim = {static_cast<int>(output_tensor.shape().size(0)),
                         static_cast<int>(output_tensor.shape().size(1))};
-  int grid_size = std::min(out_dim.x, n_blocks);
-  int offset = 0;
-  for (std::size_t i = 0; i < input_tensors_.size(); i++) {
-    auto& input_tensor = input_tensors_[i];
-    T* in = input_tensor.data<T>();
-    const int2 in_dim = {static_cast<int>(input_tensor.shape().size(0)),
-                         static_cast<int>(input_tensor.shape().size(1))};
-
-    concat_bwd_kernel<<<grid_size, block_size, 0, stream>>>(out, out_dim, in, in_dim, offset);
-    offset += in_dim.y;
-  }
+  const int block_size = 256;
+  const int n_blocks = get_gpu().get_sm_count() * 8;
+  const dim3 grid_size(std::min((out_dim.x * max_width_ - 1) / block_size + 1, n_blocks),
+                       input_tensors_.size());
+  concat_bwd_kernel<<<grid_size, block_size, 0, get_gpu().get_stream()>>>(
+      output_tensor.data<T>(), out_dim, input_tensor_ptrs_.data<T*>(), offsets_.data<int>());
 }
 
 template class ConcatLayer<float>;
@@ -14,12 +14,15 @@
  * limitations under the License.
  */
 
+#include <curand_kernel.h>
+
 #include <HugeCTR/include/utils.hpp>
 #include <algorithm>
 #include <cstdio>
 #include <ctime>
 #include <functional>
 #include <layers/dropout_layer.hpp>
+#include <layers/dropout_mask.cuh>
 #include <network_buffer_channels.hpp>
 #include <prims/linalg/binary_op.cuh>
 #include <utils.cuh>
@@ -27,13 +30,55 @@
 
 namespace HugeCTR {
 
+namespace {
+
+constexpr int kRecomputeBlockSize = 256;
+
+__global__ void next_iteration_kernel(int64_t* iteration) { ++*iteration; }
+
+// Every thread draws the mask of a group of 4 consecutive elements, so that bprop draws the same
+// mask as fprop.
+template <typename T>
+__global__ void recompute_dropout_kernel(const T* __restrict__ in, T* __restrict__ out, size_t n,
+                                         float rate, float scale, unsigned long long seed,
+                                         const int64_t* iteration) {
+  const int64_t iter = *iteration;
+  for (size_t group = blockIdx.x * blockDim.x + threadIdx.x; group * 4 < n;
+       group += blockDim.x * gridDim.x) {
+    const float4 rand = dropout_uniform4(seed, group, iter);
+    const float keep[4] = {rand.x, rand.y, rand.z, rand.w};
+#pragma unroll
+    for (int k = 0; k < 4; k++) {
+      const size_t idx = group * 4 + k;
+      if (idx < n) {
+        const float x = TypeConvertFunc<float, T>::convert(in[idx]);
+        out[idx] = TypeConvertFunc<T, float>::convert(keep[k] > rate ? x * scale : 0.f);
+      }
+    }
+  }
+}
+
+template <typename T>
+void recompute_dropout(const T* in, T* out, size_t n, float rate, float scale,
+                       unsigned long long seed, const int64_t* iteration, cudaStream_t stream) {
+  const size_t num_groups = (n + 3) / 4;
+  const size_t grid = std::min<size_t>((num_groups + kRecomputeBlockSize - 1) / kRecomputeBlockSize,
+                                       65535);
+  recompute_dropout_kernel<<<grid, kRecomputeBlockSize, 0, stream>>>(in, out, n, rate, scale, seed,
+                                                                     iteration);
+}
+
+}  // namespace
+
 template <typename T>
 DropoutLayer<T>::DropoutLayer(const core23::Tensor& input_tensor,
                               const core23::Tensor& output_tensor, float rate,
-                              const std::shared_ptr<GPUResource>& gpu_resource)
+                              const std::shared_ptr<GPUResource>& gpu_resource, bool recompute)
     : Layer({input_tensor}, {output_tensor}, gpu_resource),
       rate_(rate),
-      scale_(1.0 / (1.0 - rate)) {
+      scale_(1.0 / (1.0 - rate)),
+      recompute_(recompute),
+      seed_(gpu_resource->get_global_id()) {
   assert(input_tensors_[0].num_elements() == output_tensors_[0].num_elements());
   assert(rate_ > 0.f && rate_ < 1.f);
 
@@ -61,10 +106,18 @@ DropoutLayer<T>::DropoutLayer(const core23::Tensor& input_tensor,
   HCTR_LIB_THROW(cudnnDropoutGetReserveSpaceSize(in_out_desc_, &reserveSpaceSizeInBytes_));
   core23::BufferParams buf_p{.channel = GetBlobsBufferChannel()};
 
-  noise_mask_ = core23::Tensor(input_tensors_[0]
-                                   .my_params()
-                                   .shape({1, static_cast<int64_t>(reserveSpaceSizeInBytes_)})
-                                   .buffer_params(buf_p));
+  if (recompute_) {
+    iteration_ = core23::Tensor(core23::TensorParams()
+                                    .data_type(core23::ScalarType::Int64)
+                                    .shape({1})
+                                    .device(input_tensors_[0].device())
+                                    .buffer_params(buf_p));
+  } else {
+    noise_mask_ = core23::Tensor(input_tensors_[0]
+                                     .my_params()
+                                     .shape({1, static_cast<int64_t>(reserveSpaceSizeInBytes_)})
+                                     .buffer_params(buf_p));
+  }
 
   HCTR_LIB_THROW(cudaMalloc(&cudnn_status_, size_in_bytes));
 
@@ -83,11 +136,26 @@ DropoutLayer<T>::~DropoutLayer() {
   }
 }
 
+template <typename T>
+void DropoutLayer<T>::initialize() {
+  if (recompute_) {
+    CudaDeviceContext context(get_device_id());
+    HCTR_LIB_THROW(
+        cudaMemsetAsync(iteration_.data(), 0, iteration_.num_bytes(), get_gpu().get_stream()));
+  }
+}
+
 template <typename T>
 void DropoutLayer<T>::fprop(bool is_train) {
   CudaDeviceContext context(get_device_id());
 
-  if (is_train) {
+  if (is_train && recompute_) {
+    int64_t* iteration = iteration_.data<int64_t>();
+    next_iteration_kernel<<<1, 1, 0, get_gpu().get_stream()>>>(iteration);
+    recompute_dropout(input_tensors_[0].data<T>(), output_tensors_[0].data<T>(),
+                      input_tensors_[0].num_elements(), rate_, scale_, seed_, iteration,
+                      get_gpu().get_stream());
+  } else if (is_train) {
     HCTR_LIB_THROW(cudnnDropoutForward(
         get_gpu().get_cudnn_handle(), dropout_descriptor_, in_out_desc_, input_tensors_[0].data(),
         in_out_desc_, output_tensors_[0].data(), noise_mask_.data(), reserveSpaceSizeInBytes_));
@@ -101,6 +169,12 @@ void DropoutLayer<T>::fprop(bool is_train) {
 template <typename T>
 void DropoutLayer<T>::bprop() {
   CudaDeviceContext context(get_device_id());
+  if (recompute_) {
+    recompute_dropout(output_tensors_[0].data<T>(), input_tensors_[0].data<T>(),
+                      output_tensors_[0].num_elements(), rate_, scale_, seed_,
+                      iteration_.data<int64_t>(), get_gpu().get_stream());
+    return;
+  }
   HCTR_LIB_THROW(cudnnDropoutBackward(
       get_gpu().get_cudnn_handle(), dropout_descriptor_, in_out_desc_, output_tensors_[0].data(),
       in_out_desc_, input_tensors_[0].data(), noise_mask_.data(), reserveSpaceSizeInBytes_));
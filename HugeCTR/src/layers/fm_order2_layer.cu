@@ -14,97 +14,96 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <layers/fm_order2_layer.hpp>
+#include <layers/functors/vector_pack.cuh>
 #include <utils.hpp>
 
 namespace HugeCTR {
 
 namespace {
 
-__global__ void fm_order2_kernel(const float* in, float* out, int batch_size, int slot_num,
-                                 int emb_vec_size) {
-  int tid = threadIdx.x;
-  int bid = blockIdx.x;
+constexpr int kBlockSize = 256;
+constexpr int64_t kMaxGridSize = 65536;
 
-  if (tid < emb_vec_size && bid < batch_size) {
-    float emb_sum = 0.0f;
-    float emb_sum_square = 0.0f;
-    float emb_square_sum = 0.0f;
-    int offset = bid * slot_num * emb_vec_size + tid;
-
-    for (int i = 0; i < slot_num; i++) {
-      int index = offset + i * emb_vec_size;
-      float temp = in[index];
-      emb_sum += temp;
-      emb_square_sum += temp * temp;
-    }
-    emb_sum_square = emb_sum * emb_sum;
-
-    out[bid * emb_vec_size + tid] = 0.5f * (emb_sum_square - emb_square_sum);
-  }
+int64_t grid_size(int64_t num_threads) {
+  return std::min((num_threads + kBlockSize - 1) / kBlockSize, kMaxGridSize);
 }
 
-__global__ void fm_order2_kernel(const __half* in, __half* out, int batch_size, int slot_num,
-                                 int emb_vec_size) {
-  int tid = threadIdx.x;
-  int bid = blockIdx.x;
-
-  if (tid < emb_vec_size && bid < batch_size) {
-    __half emb_sum = __float2half(0.0f);
-    __half emb_sum_square = __float2half(0.0f);
-    __half emb_square_sum = __float2half(0.0f);
-    int offset = bid * slot_num * emb_vec_size + tid;
-
-    for (int i = 0; i < slot_num; i++) {
-      int index = offset + i * emb_vec_size;
-      __half temp = in[index];
-      emb_sum += temp;
-      emb_square_sum += temp * temp;
+// One thread per pack of the embedding vector of a sample, so a block covers several samples and
+// the loads of a slot are coalesced. The sum and the sum of squares are accumulated in float.
+template <typename T, int N>
+__global__ void fm_order2_kernel(const T* __restrict__ in, T* __restrict__ out, int batch_size,
+                                 int slot_num, int vec_packs) {
+  using PackT = Pack<T, N>;
+  const PackT* in_packs = reinterpret_cast<const PackT*>(in);
+  PackT* out_packs = reinterpret_cast<PackT*>(out);
+  const int64_t num_packs = static_cast<int64_t>(batch_size) * vec_packs;
+  for (int64_t idx = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x; idx < num_packs;
+       idx += static_cast<int64_t>(gridDim.x) * blockDim.x) {
+    const int64_t bid = idx / vec_packs;
+    const PackT* src = in_packs + bid * slot_num * vec_packs + (idx - bid * vec_packs);
+    float emb_sum[N];
+    float emb_square_sum[N];
+#pragma unroll
+    for (int k = 0; k < N; k++) {
+      emb_sum[k] = 0.0f;
+      emb_square_sum[k] = 0.0f;
     }
-    emb_sum_square = emb_sum * emb_sum;
-
-    out[bid * emb_vec_size + tid] = __float2half(0.5f) * (emb_sum_square - emb_square_sum);
-  }
-}
-
-__global__ void fm_order2_dgrad_kernel(const float* in, const float* top_grad, float* dgrad,
-                                       int batch_size, int slot_num, int emb_vec_size) {
-  int tid = threadIdx.x;
-  int bid = blockIdx.x;
-
-  if (tid < emb_vec_size && bid < batch_size) {
-    float emb_sum = 0.0f;
-    int offset = bid * slot_num * emb_vec_size + tid;
-
     for (int i = 0; i < slot_num; i++) {
-      int index = offset + i * emb_vec_size;
-      emb_sum += in[index];
+      const PackT pack = src[i * vec_packs];
+#pragma unroll
+      for (int k = 0; k < N; k++) {
+        const float temp = static_cast<float>(pack.data[k]);
+        emb_sum[k] += temp;
+        emb_square_sum[k] += temp * temp;
+      }
     }
-    float tgrad = top_grad[bid * emb_vec_size + tid];
-    for (int i = 0; i < slot_num; i++) {
-      int index = offset + i * emb_vec_size;
-      dgrad[index] = tgrad * (emb_sum - in[index]);
+    PackT result;
+#pragma unroll
+    for (int k = 0; k < N; k++) {
+      result.data[k] = static_cast<T>(0.5f * (emb_sum[k] * emb_sum[k] - emb_square_sum[k]));
     }
+    out_packs[idx] = result;
   }
 }
 
-__global__ void fm_order2_dgrad_kernel(const __half* in, const __half* top_grad, __half* dgrad,
-                                       int batch_size, int slot_num, int emb_vec_size) {
-  int tid = threadIdx.x;
-  int bid = blockIdx.x;
-
-  if (tid < emb_vec_size && bid < batch_size) {
-    __half emb_sum = __float2half(0.0f);
-    int offset = bid * slot_num * emb_vec_size + tid;
-
+// dgrad may alias in: each thread reads an element before it overwrites it
+template <typename T, int N>
+__global__ void fm_order2_dgrad_kernel(const T* in, const T* __restrict__ top_grad, T* dgrad,
+                                       int batch_size, int slot_num, int vec_packs) {
+  using PackT = Pack<T, N>;
+  const PackT* in_packs = reinterpret_cast<const PackT*>(in);
+  const PackT* top_grad_packs = reinterpret_cast<const PackT*>(top_grad);
+  PackT* dgrad_packs = reinterpret_cast<PackT*>(dgrad);
+  const int64_t num_packs = static_cast<int64_t>(batch_size) * vec_packs;
+  for (int64_t idx = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x; idx < num_packs;
+       idx += static_cast<int64_t>(gridDim.x) * blockDim.x) {
+    const int64_t bid = idx / vec_packs;
+    const int64_t offset = bid * slot_num * vec_packs + (idx - bid * vec_packs);
+    float emb_sum[N];
+#pragma unroll
+    for (int k = 0; k < N; k++) {
+      emb_sum[k] = 0.0f;
+    }
     for (int i = 0; i < slot_num; i++) {
-      int index = offset + i * emb_vec_size;
-      emb_sum += in[index];
+      const PackT pack = in_packs[offset + i * vec_packs];
+#pragma unroll
+      for (int k = 0; k < N; k++) {
+        emb_sum[k] += static_cast<float>(pack.data[k]);
+      }
     }
-    __half tgrad = top_grad[bid * emb_vec_size + tid];
+    const PackT tgrad = top_grad_packs[idx];
     for (int i = 0; i < slot_num; i++) {
-      int index = offset + i * emb_vec_size;
-      dgrad[index] = tgrad * (emb_sum - in[index]);
+      const int64_t index = offset + i * vec_packs;
+      const PackT pack = in_packs[index];
+      PackT result;
+#pragma unroll
+      for (int k = 0; k < N; k++) {
+        result.data[k] = static_cast<T>(static_cast<float>(tgrad.data[k]) *
+                                        (emb_sum[k] - static_cast<float>(pack.data[k])));
+      }
+      dgrad_packs[index] = result;
     }
   }
 }
@@ -143,10 +142,13 @@ void FmOrder2Layer<T>::fprop(bool is_train) {
   const auto* in = input_tensors_[0].data<T>();
   auto* out = output_tensors_[0].data<T>();
 
-  dim3 blockSize(embedding_vec_size_, 1, 1);
-  dim3 grdiSize(batch_size_, 1, 1);
-  fm_order2_kernel<<<grdiSize, blockSize, 0, get_gpu().get_stream()>>>(
-      in, out, batch_size_, slot_num_, embedding_vec_size_);
+  dispatch_pack_size<T>(pack_size<T>(embedding_vec_size_, {in, out}), [&](auto pack) {
+    constexpr int N = decltype(pack)::value;
+    const int vec_packs = embedding_vec_size_ / N;
+    fm_order2_kernel<T, N>
+        <<<grid_size(static_cast<int64_t>(batch_size_) * vec_packs), kBlockSize, 0,
+           get_gpu().get_stream()>>>(in, out, batch_size_, slot_num_, vec_packs);
+  });
 }
 
 template <typename T>
@@ -156,13 +158,16 @@ void FmOrder2Layer<T>::bprop() {
   auto* in = input_tensors_[0].data<T>();
   const auto* out = output_tensors_[0].data<T>();
 
-  dim3 blockSize(embedding_vec_size_, 1, 1);
-  dim3 gridSize(batch_size_, 1, 1);
-  fm_order2_dgrad_kernel<<<gridSize, blockSize, 0, get_gpu().get_stream()>>>(in,
-                                                                             out,  // top_grad
-                                                                             in,   // dgrad
-                                                                             batch_size_, slot_num_,
-                                                                             embedding_vec_size_);
+  dispatch_pack_size<T>(pack_size<T>(embedding_vec_size_, {in, out}), [&](auto pack) {
+    constexpr int N = decltype(pack)::value;
+    const int vec_packs = embedding_vec_size_ / N;
+    fm_order2_dgrad_kernel<T, N>
+        <<<grid_size(static_cast<int64_t>(batch_size_) * vec_packs), kBlockSize, 0,
+           get_gpu().get_stream()>>>(in,
+                                     out,  // top_grad
+                                     in,   // dgrad
+                                     batch_size_, slot_num_, vec_packs);
+  });
 }
 
 template class FmOrder2Layer<float>;
@@ -15,6 +15,7 @@
  */
 
 #include <layers/fully_connected_layer.hpp>
+#include <layers/functors/single_output_fc_functors.hpp>
 #include <linalg/matrix_vector_op.cuh>
 #include <linalg/reduce.cuh>
 #include <utils.cuh>
@@ -92,6 +93,22 @@ FullyConnectedLayer<float>::FullyConnectedLayer(const core23::Tensor& in_tensor,
     this->set_wgrad(0, weight_dim);
     this->set_wgrad(1, bias_dim);
 
+    if (output_size == 1) {
+      core23::BufferParams blobs_buffer_params = {};
+      blobs_buffer_params.channel = GetBlobsBufferChannel();
+      core23::Device device(core23::DeviceType::GPU, gpu_resource->get_device_id());
+      single_output_partials_ =
+          core23::Tensor(core23::TensorParams()
+                             .data_type(core23::ScalarType::Float)
+                             .shape({single_output_fc_partials_size(input_size)})
+                             .device(device)
+                             .buffer_params(blobs_buffer_params));
+      single_output_counter_ = core23::Tensor(core23::TensorParams()
+                                                  .data_type(core23::ScalarType::UInt32)
+                                                  .shape({1})
+                                                  .device(device)
+                                                  .buffer_params(blobs_buffer_params));
+    }
   } catch (const std::runtime_error& rt_err) {
     HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
     throw;
@@ -120,6 +137,12 @@ void FullyConnectedLayer<float>::fprop(bool is_train) {
     in_batch_size = in_batch_size * in_tensor_dim.size(idx);
   }
 
+  if (output_size == 1) {
+    single_output_fc_fprop(in, weight, bias, out, in_batch_size, input_size,
+                           get_gpu().get_stream());
+    return;
+  }
+
   float alpha = 1.0f, beta = 0.0f;
 
   const cublasComputeType_t compute_type =
@@ -155,6 +178,14 @@ void FullyConnectedLayer<float>::bprop() {
     in_batch_size = in_batch_size * in_tensor_dim.size(idx);
   }
 
+  if (output_size == 1) {
+    single_output_fc_bprop(in, weight, out, wgrad, bias_grad, true,
+                           single_output_partials_.data<float>(),
+                           single_output_counter_.data<unsigned int>(), in_batch_size, input_size,
+                           get_gpu().get_stream());
+    return;
+  }
+
   float alpha = 1.0f, beta_w = 1.0f, beta_x = 0.0f;
 
   const cublasComputeType_t compute_type =
@@ -174,7 +205,20 @@ void FullyConnectedLayer<float>::bprop() {
                            get_gpu().get_stream(), true);
 }
 
+void FullyConnectedLayer<float>::initialize() {
+  if (single_output_counter_.empty()) {
+    return;
+  }
+  CudaDeviceContext context(get_device_id());
+  HCTR_LIB_THROW(cudaMemsetAsync(single_output_counter_.data(), 0,
+                                 single_output_counter_.num_bytes(), get_gpu().get_stream()));
+}
+
 void FullyConnectedLayer<float>::search_algorithm() {
+  // The single output kernels do not use cuBLAS
+  if (!single_output_counter_.empty()) {
+    return;
+  }
   // Set to the CUDA device where this layer assigned to
   CudaDeviceContext context(get_device_id());
 
@@ -15,6 +15,7 @@
  */
 
 #include <layers/fully_connected_layer_half.hpp>
+#include <layers/functors/single_output_fc_functors.hpp>
 #include <utils.cuh>
 #include <utils.hpp>
 
@@ -68,6 +69,20 @@ FullyConnectedLayer<__half>::FullyConnectedLayer(const core23::Tensor& bottom_te
                                         .shape(identity_dim)
                                         .device(device)
                                         .buffer_params(blobs_buffer_params));
+
+  if (output_size == 1) {
+    single_output_partials_ =
+        core23::Tensor(core23::TensorParams()
+                           .data_type(core23::ScalarType::Float)
+                           .shape({single_output_fc_partials_size(input_size)})
+                           .device(device)
+                           .buffer_params(blobs_buffer_params));
+    single_output_counter_ = core23::Tensor(core23::TensorParams()
+                                                .data_type(core23::ScalarType::UInt32)
+                                                .shape({1})
+                                                .device(device)
+                                                .buffer_params(blobs_buffer_params));
+  }
 }
 
 void FullyConnectedLayer<__half>::fprop(bool is_train) {
@@ -91,6 +106,12 @@ void FullyConnectedLayer<__half>::fprop(bool is_train) {
     in_batch_size = in_batch_size * bottom_tensor_dim.size(idx);
   }
 
+  if (output_size == 1) {
+    single_output_fc_fprop(bottom, kernel, bias, top, in_batch_size, input_size,
+                           get_gpu().get_stream());
+    return;
+  }
+
   const float alpha = 1.0f;
   const float beta_b = 0.0f;
   const float beta_k = 1.0f;
@@ -128,6 +149,15 @@ void FullyConnectedLayer<__half>::bprop() {
     in_batch_size = in_batch_size * bottom_tensor_dim.size(idx);
   }
 
+  if (output_size == 1) {
+    // The bias gradient is overwritten, as by the GEMM with beta_b = 0
+    single_output_fc_bprop(bottom, kernel, top, kernel_grad, bias_grad, false,
+                           single_output_partials_.data<float>(),
+                           single_output_counter_.data<unsigned int>(), in_batch_size, input_size,
+                           get_gpu().get_stream());
+    return;
+  }
+
   const float alpha = 1.0f;
   const float beta_b = 0.0f;
   const float beta_k = 1.0f;
@@ -161,9 +191,17 @@ void FullyConnectedLayer<__half>::initialize() {
   // Initialize identity vector
   initialize_array<<<(m - 1) / 1024 + 1, 1024, 0, get_gpu().get_stream()>>>(identity, m,
                                                                             __float2half(1.0f));
+  if (!single_output_counter_.empty()) {
+    HCTR_LIB_THROW(cudaMemsetAsync(single_output_counter_.data(), 0,
+                                   single_output_counter_.num_bytes(), get_gpu().get_stream()));
+  }
 }
 
 void FullyConnectedLayer<__half>::search_algorithm() {
+  // The single output kernels do not use cuBLAS
+  if (!single_output_counter_.empty()) {
+    return;
+  }
   // Set to the CUDA device where this layer assigned to
   CudaDeviceContext context(get_device_id());
 
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <layers/functors/fp8_scaling_functors.hpp>
+#include <utils.cuh>
+
+namespace HugeCTR {
+
+namespace {
+
+constexpr int kTransposeTile = 32;
+constexpr int kTransposeRows = 8;
+
+// The bit patterns of non-negative floats are ordered like the floats themselves.
+__device__ __forceinline__ void atomic_max_non_negative(float* address, float val) {
+  atomicMax(reinterpret_cast<int*>(address), __float_as_int(val));
+}
+
+// Records the amax of a warp, every lane holds a partial amax.
+__device__ __forceinline__ void record_amax(float* amax, float local_amax) {
+  local_amax = warpReduceMax(local_amax);
+  if (amax != nullptr && threadIdx.x % warpSize == 0) {
+    atomic_max_non_negative(amax, local_amax);
+  }
+}
+
+__global__ void fp8_init_scale_kernel(float* amax_history, float* scale, float* scale_inv,
+                                      int history_len) {
+  for (int i = threadIdx.x; i < history_len; i += blockDim.x) {
+    amax_history[i] = 0.f;
+  }
+  if (threadIdx.x == 0) {
+    *scale = 1.f;
+    *scale_inv = 1.f;
+  }
+}
+
+// Launched with a single warp
+template <typename Fp8>
+__global__ void fp8_update_scale_kernel(float* amax_history, float* scale, float* scale_inv,
+                                        int history_len, int slot) {
+  float amax = 0.f;
+  for (int i = threadIdx.x; i < history_len; i += warpSize) {
+    if (i != slot) {
+      amax = fmaxf(amax, amax_history[i]);
+    }
+  }
+  amax = warpReduceMax(amax);
+  if (threadIdx.x == 0) {
+    // Keeps the previous scale until a finite amax has been seen
+    if (amax > 0.f && isfinite(amax)) {
+      const float s = Fp8Format<Fp8>::max / amax;
+      *scale = s;
+      *scale_inv = 1.f / s;
+    }
+    amax_history[slot] = 0.f;
+  }
+}
+
+template <typename T, typename Fp8>
+__global__ void fp8_quantize_kernel(const T* __restrict__ in, Fp8* __restrict__ out, size_t n,
+                                    const float* scale, float* amax) {
+  const float s = *scale;
+  float local_amax = 0.f;
+  for (size_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
+    const float x = TypeConvertFunc<float, T>::convert(in[i]);
+    local_amax = fmaxf(local_amax, fabsf(x));
+    out[i] = Fp8(x * s);
+  }
+  record_amax(amax, local_amax);
+}
+
+// A block of kTransposeTile x kTransposeRows threads quantizes a kTransposeTile^2 tile
+template <typename T, typename Fp8>
+__global__ void fp8_quantize_transpose_kernel(const T* __restrict__ in, Fp8* __restrict__ out,
+                                              Fp8* __restrict__ out_t, size_t rows, size_t cols,
+                                              const float* scale, float* amax) {
+  __shared__ Fp8 tile[kTransposeTile][kTransposeTile + 1];
+  const float s = *scale;
+  float local_amax = 0.f;
+
+  const size_t col = blockIdx.x * kTransposeTile + threadIdx.x;
+  for (int r = threadIdx.y; r < kTransposeTile; r += kTransposeRows) {
+    const size_t row = blockIdx.y * kTransposeTile + r;
+    if (row < rows && col < cols) {
+      const float x = TypeConvertFunc<float, T>::convert(in[row * cols + col]);
+      local_amax = fmaxf(local_amax, fabsf(x));
+      const Fp8 q(x * s);
+      out[row * cols + col] = q;
+      tile[r][threadIdx.x] = q;
+    }
+  }
+  __syncthreads();
+
+  const size_t t_col = blockIdx.y * kTransposeTile + threadIdx.x;
+  for (int r = threadIdx.y; r < kTransposeTile; r += kTransposeRows) {
+    const size_t t_row = blockIdx.x * kTransposeTile + r;
+    if (t_row < cols && t_col < rows) {
+      out_t[t_row * rows + t_col] = tile[threadIdx.x][r];
+    }
+  }
+  record_amax(amax, local_amax);
+}
+
+}  // namespace
+
+void Fp8TensorScale::set_buffer(float* buffer, int len) {
+  amax_history = buffer;
+  scale = buffer + len;
+  scale_inv = buffer + len + 1;
+  history_len = len;
+}
+
+void fp8_init_scale(const Fp8TensorScale& scale, cudaStream_t stream) {
+  fp8_init_scale_kernel<<<1, 32, 0, stream>>>(scale.amax_history, scale.scale, scale.scale_inv,
+                                              scale.history_len);
+}
+
+template <typename T, typename Fp8>
+void fp8_quantize(const T* in, Fp8* out, Fp8* out_t, size_t rows, size_t cols,
+                  const Fp8TensorScale& scale, int64_t step, bool update_scale,
+                  cudaStream_t stream) {
+  float* amax = nullptr;
+  if (update_scale) {
+    const int slot = static_cast<int>(step % scale.history_len);
+    fp8_update_scale_kernel<Fp8><<<1, 32, 0, stream>>>(scale.amax_history, scale.scale,
+                                                       scale.scale_inv, scale.history_len, slot);
+    amax = scale.amax_history + slot;
+  }
+
+  if (out_t != nullptr) {
+    const dim3 block(kTransposeTile, kTransposeRows);
+    const dim3 grid((cols + kTransposeTile - 1) / kTransposeTile,
+                    (rows + kTransposeTile - 1) / kTransposeTile);
+    fp8_quantize_transpose_kernel<<<grid, block, 0, stream>>>(in, out, out_t, rows, cols,
+                                                              scale.scale, amax);
+  } else {
+    const size_t n = rows * cols;
+    const size_t block = 256;
+    const size_t grid = std::min<size_t>((n + block - 1) / block, 4096);
+    fp8_quantize_kernel<<<grid, block, 0, stream>>>(in, out, n, scale.scale, amax);
+  }
+}
+
+template void fp8_quantize<float, __nv_fp8_e4m3>(const float*, __nv_fp8_e4m3*, __nv_fp8_e4m3*,
+                                                 size_t, size_t, const Fp8TensorScale&, int64_t,
+                                                 bool, cudaStream_t);
+template void fp8_quantize<float, __nv_fp8_e5m2>(const float*, __nv_fp8_e5m2*, __nv_fp8_e5m2*,
+                                                 size_t, size_t, const Fp8TensorScale&, int64_t,
+                                                 bool, cudaStream_t);
+template void fp8_quantize<__half, __nv_fp8_e4m3>(const __half*, __nv_fp8_e4m3*, __nv_fp8_e4m3*,
+                                                  size_t, size_t, const Fp8TensorScale&, int64_t,
+                                                  bool, cudaStream_t);
+template void fp8_quantize<__half, __nv_fp8_e5m2>(const __half*, __nv_fp8_e5m2*, __nv_fp8_e5m2*,
+                                                  size_t, size_t, const Fp8TensorScale&, int64_t,
+                                                  bool, cudaStream_t);
+
+}  // namespace HugeCTR
@@ -42,6 +42,31 @@ void CublasFusedFCLayerDesc<T>::set_bprop_attr(T* dbias_bottom_ptr, T* dbias_top
                                   dbias_bottom_ptr, mask_in_ptr);
 }
 
+template <typename T>
+void CublasFusedFCLayerDesc<T>::set_fp8_fprop_attr(const T* bias_ptr, Activation_t act,
+                                                   size_t batch_size, size_t bottom_size,
+                                                   size_t top_size,
+                                                   const Fp8FCLayerBuffers& fp8_buffers) {
+  // top^T = kernel_t^T * bottom^T in column-major
+  fprop_desc.set_fp8_attr(top_size, batch_size, bottom_size, Fp8Format<__nv_fp8_e4m3>::data_type,
+                          Fp8Format<__nv_fp8_e4m3>::data_type, fp8_buffers.kernel_scale.scale_inv,
+                          fp8_buffers.bottom_scale.scale_inv, bias_ptr, act);
+}
+
+template <typename T>
+void CublasFusedFCLayerDesc<T>::set_fp8_bprop_attr(T* dbias_top_ptr, size_t batch_size,
+                                                   size_t bottom_size, size_t top_size,
+                                                   const Fp8FCLayerBuffers& fp8_buffers) {
+  bprop_wgrad_desc.set_bprop_attr({batch_size, bottom_size}, {batch_size, top_size}, CUBLAS_OP_T,
+                                  CUBLAS_OP_N, CUBLASLT_ORDER_ROW, false, dbias_top_ptr, nullptr);
+  // bottom_bprop^T = kernel^T * grad_top^T in column-major
+  bprop_dgrad_desc.set_fp8_attr(bottom_size, batch_size, top_size,
+                                Fp8Format<__nv_fp8_e4m3>::data_type,
+                                Fp8Format<__nv_fp8_e5m2>::data_type,
+                                fp8_buffers.kernel_scale.scale_inv,
+                                fp8_buffers.grad_scale.scale_inv);
+}
+
 template <typename T>
 void CublasFusedFCLayerAlgo<T>::set_fprop_algo(const CublasFusedFCLayerDesc<T>& cublas_layer_desc,
                                                cublasLtHandle_t cublaslt_handle) {
@@ -120,6 +145,28 @@ __global__ void reverse_relu_kernel_not_aligned(float* dRelu, const float* mask,
 }
 }  // namespace
 
+template <typename T>
+void FusedFCLayerFunctors<T>::reverse_relu(const T* mask_aux, size_t mask_aux_size,
+                                           const T* train_top, T* grad_top, cudaStream_t stream) {
+  if constexpr (std::is_same<T, float>::value) {
+    if (mask_aux_size % 2 == 0) {
+      reverse_relu_kernel<<<(mask_aux_size / 2 - 1) / 1024 + 1, 1024, 0, stream>>>(
+          grad_top, mask_aux, train_top, mask_aux_size);
+    } else {
+      reverse_relu_kernel_not_aligned<<<(mask_aux_size - 1) / 1024 + 1, 1024, 0, stream>>>(
+          grad_top, mask_aux, train_top, mask_aux_size);
+    }
+  } else {
+    if (mask_aux_size % 4 == 0) {
+      reverse_relu_kernel<<<(mask_aux_size / 4 - 1) / 1024 + 1, 1024, 0, stream>>>(
+          grad_top, mask_aux, train_top, mask_aux_size);
+    } else {
+      reverse_relu_kernel_not_aligned<<<(mask_aux_size - 1) / 1024 + 1, 1024, 0, stream>>>(
+          grad_top, mask_aux, train_top, mask_aux_size);
+    }
+  }
+}
+
 template <typename T>
 void FusedFCLayerFunctors<T>::bprop(const T* kernel, const T* bottom, const T* train_top,
                                     const T* mask_aux, size_t mask_aux_size, T* grad_top,
@@ -130,23 +177,7 @@ void FusedFCLayerFunctors<T>::bprop(const T* kernel, const T* bottom, const T* t
                                     cudaStream_t overlap_stream, cudaEvent_t& event_overlap,
                                     bool async_wgrad, bool skip_dgrad) {
   if (mask_aux != nullptr) {
-    if constexpr (std::is_same<T, float>::value) {
-      if (mask_aux_size % 2 == 0) {
-        reverse_relu_kernel<<<(mask_aux_size / 2 - 1) / 1024 + 1, 1024, 0, stream>>>(
-            grad_top, mask_aux, train_top, mask_aux_size);
-      } else {
-        reverse_relu_kernel_not_aligned<<<(mask_aux_size - 1) / 1024 + 1, 1024, 0, stream>>>(
-            grad_top, mask_aux, train_top, mask_aux_size);
-      }
-    } else {
-      if (mask_aux_size % 4 == 0) {
-        reverse_relu_kernel<<<(mask_aux_size / 4 - 1) / 1024 + 1, 1024, 0, stream>>>(
-            grad_top, mask_aux, train_top, mask_aux_size);
-      } else {
-        reverse_relu_kernel_not_aligned<<<(mask_aux_size - 1) / 1024 + 1, 1024, 0, stream>>>(
-            grad_top, mask_aux, train_top, mask_aux_size);
-      }
-    }
+    reverse_relu(mask_aux, mask_aux_size, train_top, grad_top, stream);
   }
 
   // wait for dact
@@ -166,6 +197,60 @@ void FusedFCLayerFunctors<T>::bprop(const T* kernel, const T* bottom, const T* t
   }
 }
 
+template <typename T>
+void FusedFCLayerFunctors<T>::fprop_fp8(const T* kernel, const T* bottom, T* top,
+                                        const Fp8FCLayerBuffers& fp8_buffers, size_t batch_size,
+                                        size_t bottom_size, size_t top_size, int64_t step,
+                                        bool is_train,
+                                        const CublasFusedFCLayerDesc<T>& cublas_layer_desc,
+                                        const CublasFusedFCLayerAlgo<T>& cublas_layer_algo,
+                                        cublasLtHandle_t cublaslt_handle, cudaStream_t stream) {
+  // The kernel is kept as is for dgrad, fprop needs its transpose.
+  fp8_quantize(kernel, fp8_buffers.kernel, fp8_buffers.kernel_t, bottom_size, top_size,
+               fp8_buffers.kernel_scale, step, is_train, stream);
+  fp8_quantize(bottom, fp8_buffers.bottom, static_cast<__nv_fp8_e4m3*>(nullptr), batch_size,
+               bottom_size, fp8_buffers.bottom_scale, step, is_train, stream);
+  gemm_functor_(1.0f, static_cast<const void*>(fp8_buffers.kernel_t),
+                static_cast<const void*>(fp8_buffers.bottom), 0.0f, top, top,
+                cublas_layer_desc.fprop_desc, cublas_layer_algo.fprop_algo, cublaslt_handle,
+                stream);
+}
+
+template <typename T>
+void FusedFCLayerFunctors<T>::bprop_fp8(const T* bottom, const T* train_top, const T* mask_aux,
+                                        size_t mask_aux_size, T* grad_top, T* bottom_bprop,
+                                        T* kernel_grad, const Fp8FCLayerBuffers& fp8_buffers,
+                                        size_t batch_size, size_t top_size, int64_t step,
+                                        const CublasFusedFCLayerDesc<T>& cublas_layer_desc,
+                                        const CublasFusedFCLayerAlgo<T>& cublas_layer_algo,
+                                        cublasLtHandle_t cublaslt_handle, cudaStream_t stream,
+                                        cudaStream_t overlap_stream, cudaEvent_t& event_overlap,
+                                        bool async_wgrad, bool skip_dgrad) {
+  if (mask_aux != nullptr) {
+    reverse_relu(mask_aux, mask_aux_size, train_top, grad_top, stream);
+  }
+
+  // wait for dact
+  if (async_wgrad) {
+    HCTR_LIB_THROW(cudaEventRecord(event_overlap, stream));
+    HCTR_LIB_THROW(cudaStreamWaitEvent(overlap_stream, event_overlap));
+  }
+
+  gemm_functor_(1.0f, bottom, grad_top, 1.0f, kernel_grad, kernel_grad,
+                cublas_layer_desc.bprop_wgrad_desc, cublas_layer_algo.bprop_wgrad_algo,
+                cublaslt_handle, async_wgrad ? overlap_stream : stream);
+
+  if (!skip_dgrad) {
+    fp8_quantize(static_cast<const T*>(grad_top), fp8_buffers.grad_top,
+                 static_cast<__nv_fp8_e5m2*>(nullptr), batch_size, top_size,
+                 fp8_buffers.grad_scale, step, true, stream);
+    gemm_functor_(1.0f, static_cast<const void*>(fp8_buffers.kernel),
+                  static_cast<const void*>(fp8_buffers.grad_top), 0.0f, bottom_bprop,
+                  bottom_bprop, cublas_layer_desc.bprop_dgrad_desc,
+                  cublas_layer_algo.bprop_dgrad_algo, cublaslt_handle, stream);
+  }
+}
+
 template <typename T>
 void FusedFCLayerFunctors<T>::search_algorithm(T* bottom, T* top, T* kernel, size_t batch_size,
                                                size_t input_size, size_t output_size,
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <gemm_algo_cache.hpp>
 #include <layers/functors/fused_gemm_functors.hpp>
 
 namespace HugeCTR {
@@ -163,6 +164,50 @@ void CublasDesc<T>::set_bprop_attr(std::vector<size_t> dims_a, std::vector<size_
                                             cublas_cols_c, cublas_rows_c));
 }
 
+template <typename T>
+void CublasDesc<T>::set_fp8_attr(size_t m, size_t n, size_t k, cudaDataType type_a,
+                                 cudaDataType type_b, const float* a_scale_inv,
+                                 const float* b_scale_inv, const T* bias_ptr, Activation_t act) {
+  row_major = false;
+  HCTR_LIB_THROW(cublasLtMatmulDescCreate(&cublas_op_desc, CUBLAS_COMPUTE_32F, CUDA_R_32F));
+
+  cublasOperation_t op_a = CUBLAS_OP_T;
+  cublasOperation_t op_b = CUBLAS_OP_N;
+  HCTR_LIB_THROW(cublasLtMatmulDescSetAttribute(cublas_op_desc, CUBLASLT_MATMUL_DESC_TRANSA, &op_a,
+                                                sizeof(op_a)));
+  HCTR_LIB_THROW(cublasLtMatmulDescSetAttribute(cublas_op_desc, CUBLASLT_MATMUL_DESC_TRANSB, &op_b,
+                                                sizeof(op_b)));
+
+  // The ReLU mask (RELU_AUX) epilogues are not available for fp8 inputs.
+  if (act == Activation_t::Relu) {
+    epilogue = bias_ptr == nullptr ? CUBLASLT_EPILOGUE_RELU : CUBLASLT_EPILOGUE_RELU_BIAS;
+  } else {
+    epilogue = bias_ptr == nullptr ? CUBLASLT_EPILOGUE_DEFAULT : CUBLASLT_EPILOGUE_BIAS;
+  }
+  HCTR_LIB_THROW(cublasLtMatmulDescSetAttribute(cublas_op_desc, CUBLASLT_MATMUL_DESC_EPILOGUE,
+                                                &epilogue, sizeof(epilogue)));
+  if (bias_ptr != nullptr) {
+    HCTR_LIB_THROW(cublasLtMatmulDescSetAttribute(cublas_op_desc, CUBLASLT_MATMUL_DESC_BIAS_POINTER,
+                                                  &bias_ptr, sizeof(bias_ptr)));
+  }
+  HCTR_LIB_THROW(cublasLtMatmulDescSetAttribute(
+      cublas_op_desc, CUBLASLT_MATMUL_DESC_A_SCALE_POINTER, &a_scale_inv, sizeof(a_scale_inv)));
+  HCTR_LIB_THROW(cublasLtMatmulDescSetAttribute(
+      cublas_op_desc, CUBLASLT_MATMUL_DESC_B_SCALE_POINTER, &b_scale_inv, sizeof(b_scale_inv)));
+
+  uint32_t pointer_mode = CUBLASLT_POINTER_MODE_HOST;
+  HCTR_LIB_THROW(cublasLtMatmulDescSetAttribute(cublas_op_desc, CUBLASLT_MATMUL_DESC_POINTER_MODE,
+                                                &pointer_mode, sizeof(pointer_mode)));
+
+  cudaDataType data_type = CUDA_R_32F;
+  if constexpr (std::is_same<T, __half>::value) {
+    data_type = CUDA_R_16F;
+  }
+  HCTR_LIB_THROW(cublasLtMatrixLayoutCreate(&cublas_mat_a_desc, type_a, k, m, k));
+  HCTR_LIB_THROW(cublasLtMatrixLayoutCreate(&cublas_mat_b_desc, type_b, k, n, k));
+  HCTR_LIB_THROW(cublasLtMatrixLayoutCreate(&cublas_mat_c_desc, data_type, m, n, m));
+}
+
 template <typename T>
 CublasDesc<T>::~CublasDesc() {
   cublasLtMatmulDescDestroy(cublas_op_desc);
@@ -217,6 +262,12 @@ void CublasAlgo<T>::search_algorithm(const float alpha, const T* mat_a, const T*
   if (!initialized) {
     init_algorithm(cublas_desc, cublaslt_handle);
   }
+  auto& algo_cache = GemmAlgoCache::get();
+  if (algo_cache.find(cublaslt_handle, cublas_desc.cublas_op_desc, cublas_desc.cublas_mat_a_desc,
+                      cublas_desc.cublas_mat_b_desc, cublas_desc.cublas_mat_c_desc,
+                      cublas_desc.cublas_mat_c_desc, cublaslt_workspace_size, &algo)) {
+    return;
+  }
   const size_t repeat_num = 100;
   const int max_algo_count = 16;
 
@@ -260,6 +311,9 @@ void CublasAlgo<T>::search_algorithm(const float alpha, const T* mat_a, const T*
       algo = heuristic_result[algoIdx].algo;
     }
   }
+  algo_cache.insert(cublas_desc.cublas_op_desc, cublas_desc.cublas_mat_a_desc,
+                    cublas_desc.cublas_mat_b_desc, cublas_desc.cublas_mat_c_desc,
+                    cublas_desc.cublas_mat_c_desc, cublaslt_workspace_size, algo);
 
   HCTR_LIB_THROW(cudaEventDestroy(start));
   HCTR_LIB_THROW(cudaEventDestroy(stop));
@@ -286,4 +340,16 @@ void GemmFunctor<T>::operator()(const float alpha, const T* mat_a, const T* mat_
       cublas_algo.cublaslt_workspace_size, stream));
 }
 
+template <typename T>
+void GemmFunctor<T>::operator()(const float alpha, const void* mat_a, const void* mat_b,
+                                const float beta, const T* mat_c, T* mat_d,
+                                const CublasDesc<T>& cublas_desc, const CublasAlgo<T>& cublas_algo,
+                                cublasLtHandle_t cublaslt_handle, cudaStream_t stream) {
+  HCTR_LIB_THROW(cublasLtMatmul(
+      cublaslt_handle, cublas_desc.cublas_op_desc, &alpha, mat_a, cublas_desc.cublas_mat_a_desc,
+      mat_b, cublas_desc.cublas_mat_b_desc, &beta, mat_c, cublas_desc.cublas_mat_c_desc, mat_d,
+      cublas_desc.cublas_mat_c_desc, &cublas_algo.algo, cublas_algo.cublaslt_workspace,
+      cublas_algo.cublaslt_workspace_size, stream));
+}
+
 }  // namespace HugeCTR
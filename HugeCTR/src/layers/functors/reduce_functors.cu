@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cuda_fp16.h>
+
+#include <algorithm>
+#include <layers/functors/reduce_functors.hpp>
+#include <layers/functors/vector_pack.cuh>
+#include <utils.cuh>
+
+namespace HugeCTR {
+
+namespace {
+
+constexpr int kBlockSize = 256;
+constexpr int kWarpSize = 32;
+constexpr int64_t kMaxGridSize = 65536;
+// Rows of at least this many packs are reduced by a block rather than by a warp
+constexpr int64_t kMinPacksPerBlockRow = 1024;
+
+int64_t grid_size(int64_t num_threads) {
+  return std::min((num_threads + kBlockSize - 1) / kBlockSize, kMaxGridSize);
+}
+
+// One thread per pack of columns, looping over the reduced axis
+template <typename T, int N>
+__global__ void reduce_columns_kernel(const T* __restrict__ input, T* __restrict__ output,
+                                      int64_t outer, int64_t reduce_size, int64_t inner_packs,
+                                      float scale) {
+  using PackT = Pack<T, N>;
+  const PackT* in = reinterpret_cast<const PackT*>(input);
+  PackT* out = reinterpret_cast<PackT*>(output);
+  const int64_t num_packs = outer * inner_packs;
+  for (int64_t idx = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x; idx < num_packs;
+       idx += static_cast<int64_t>(gridDim.x) * blockDim.x) {
+    const int64_t o = idx / inner_packs;
+    const PackT* src = in + o * reduce_size * inner_packs + (idx - o * inner_packs);
+    float acc[N];
+#pragma unroll
+    for (int k = 0; k < N; k++) {
+      acc[k] = 0.0f;
+    }
+    for (int64_t r = 0; r < reduce_size; r++) {
+      const PackT pack = src[r * inner_packs];
+#pragma unroll
+      for (int k = 0; k < N; k++) {
+        acc[k] += static_cast<float>(pack.data[k]);
+      }
+    }
+    PackT result;
+#pragma unroll
+    for (int k = 0; k < N; k++) {
+      result.data[k] = static_cast<T>(acc[k] * scale);
+    }
+    out[idx] = result;
+  }
+}
+
+// One warp per contiguous row
+template <typename T, int N>
+__global__ void reduce_rows_warp_kernel(const T* __restrict__ input, T* __restrict__ output,
+                                        int64_t rows, int64_t row_packs, float scale) {
+  using PackT = Pack<T, N>;
+  const PackT* in = reinterpret_cast<const PackT*>(input);
+  const int lane = threadIdx.x % kWarpSize;
+  const int64_t num_warps = static_cast<int64_t>(gridDim.x) * blockDim.x / kWarpSize;
+  for (int64_t row = (blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x) / kWarpSize;
+       row < rows; row += num_warps) {
+    float acc = 0.0f;
+    for (int64_t j = lane; j < row_packs; j += kWarpSize) {
+      const PackT pack = in[row * row_packs + j];
+#pragma unroll
+      for (int k = 0; k < N; k++) {
+        acc += static_cast<float>(pack.data[k]);
+      }
+    }
+    acc = warpReduceSum(acc);
+    if (lane == 0) {
+      output[row] = static_cast<T>(acc * scale);
+    }
+  }
+}
+
+// One block per contiguous row, for the long ones
+template <typename T, int N>
+__global__ void reduce_rows_block_kernel(const T* __restrict__ input, T* __restrict__ output,
+                                         int64_t rows, int64_t row_packs, float scale) {
+  using PackT = Pack<T, N>;
+  const PackT* in = reinterpret_cast<const PackT*>(input);
+  for (int64_t row = blockIdx.x; row < rows; row += gridDim.x) {
+    float acc = 0.0f;
+    for (int64_t j = threadIdx.x; j < row_packs; j += blockDim.x) {
+      const PackT pack = in[row * row_packs + j];
+#pragma unroll
+      for (int k = 0; k < N; k++) {
+        acc += static_cast<float>(pack.data[k]);
+      }
+    }
+    acc = blockReduceSum(acc);
+    if (threadIdx.x == 0) {
+      output[row] = static_cast<T>(acc * scale);
+    }
+    // The shared memory of blockReduceSum is reused by the next row
+    __syncthreads();
+  }
+}
+
+// One thread per pack of columns of the gradient
+template <typename T, int N>
+__global__ void broadcast_columns_kernel(const T* __restrict__ top_grad, T* __restrict__ dgrad,
+                                         int64_t outer, int64_t reduce_size, int64_t inner_packs,
+                                         float scale) {
+  using PackT = Pack<T, N>;
+  const PackT* top = reinterpret_cast<const PackT*>(top_grad);
+  PackT* out = reinterpret_cast<PackT*>(dgrad);
+  const int64_t num_packs = outer * reduce_size * inner_packs;
+  for (int64_t idx = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x; idx < num_packs;
+       idx += static_cast<int64_t>(gridDim.x) * blockDim.x) {
+    const int64_t o = idx / (reduce_size * inner_packs);
+    PackT pack = top[o * inner_packs + idx % inner_packs];
+#pragma unroll
+    for (int k = 0; k < N; k++) {
+      pack.data[k] = static_cast<T>(static_cast<float>(pack.data[k]) * scale);
+    }
+    out[idx] = pack;
+  }
+}
+
+// One thread per pack of a contiguous row of the gradient
+template <typename T, int N>
+__global__ void broadcast_rows_kernel(const T* __restrict__ top_grad, T* __restrict__ dgrad,
+                                      int64_t rows, int64_t row_packs, float scale) {
+  using PackT = Pack<T, N>;
+  PackT* out = reinterpret_cast<PackT*>(dgrad);
+  const int64_t num_packs = rows * row_packs;
+  for (int64_t idx = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x; idx < num_packs;
+       idx += static_cast<int64_t>(gridDim.x) * blockDim.x) {
+    const T grad = static_cast<T>(static_cast<float>(top_grad[idx / row_packs]) * scale);
+    PackT pack;
+#pragma unroll
+    for (int k = 0; k < N; k++) {
+      pack.data[k] = grad;
+    }
+    out[idx] = pack;
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void reduce_fprop(const T* input, T* output, int64_t outer, int64_t reduce_size, int64_t inner,
+                  bool mean, cudaStream_t stream) {
+  const float scale = mean ? 1.0f / reduce_size : 1.0f;
+  if (inner == 1) {
+    dispatch_pack_size<T>(pack_size<T>(reduce_size, {input}), [&](auto pack) {
+      constexpr int N = decltype(pack)::value;
+      const int64_t row_packs = reduce_size / N;
+      if (row_packs >= kMinPacksPerBlockRow) {
+        reduce_rows_block_kernel<T, N><<<std::min(outer, kMaxGridSize), kBlockSize, 0, stream>>>(
+            input, output, outer, row_packs, scale);
+      } else {
+        reduce_rows_warp_kernel<T, N><<<grid_size(outer * kWarpSize), kBlockSize, 0, stream>>>(
+            input, output, outer, row_packs, scale);
+      }
+    });
+    return;
+  }
+  dispatch_pack_size<T>(pack_size<T>(inner, {input, output}), [&](auto pack) {
+    constexpr int N = decltype(pack)::value;
+    reduce_columns_kernel<T, N><<<grid_size(outer * inner / N), kBlockSize, 0, stream>>>(
+        input, output, outer, reduce_size, inner / N, scale);
+  });
+}
+
+template <typename T>
+void reduce_bprop(const T* top_grad, T* dgrad, int64_t outer, int64_t reduce_size, int64_t inner,
+                  bool mean, cudaStream_t stream) {
+  const float scale = mean ? 1.0f / reduce_size : 1.0f;
+  if (inner == 1) {
+    dispatch_pack_size<T>(pack_size<T>(reduce_size, {dgrad}), [&](auto pack) {
+      constexpr int N = decltype(pack)::value;
+      broadcast_rows_kernel<T, N><<<grid_size(outer * reduce_size / N), kBlockSize, 0, stream>>>(
+          top_grad, dgrad, outer, reduce_size / N, scale);
+    });
+    return;
+  }
+  dispatch_pack_size<T>(pack_size<T>(inner, {top_grad, dgrad}), [&](auto pack) {
+    constexpr int N = decltype(pack)::value;
+    broadcast_columns_kernel<T, N>
+        <<<grid_size(outer * reduce_size * inner / N), kBlockSize, 0, stream>>>(
+            top_grad, dgrad, outer, reduce_size, inner / N, scale);
+  });
+}
+
+template void reduce_fprop<float>(const float*, float*, int64_t, int64_t, int64_t, bool,
+                                  cudaStream_t);
+template void reduce_fprop<__half>(const __half*, __half*, int64_t, int64_t, int64_t, bool,
+                                   cudaStream_t);
+template void reduce_bprop<float>(const float*, float*, int64_t, int64_t, int64_t, bool,
+                                  cudaStream_t);
+template void reduce_bprop<__half>(const __half*, __half*, int64_t, int64_t, int64_t, bool,
+                                   cudaStream_t);
+
+}  // namespace HugeCTR
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cuda_fp16.h>
+
+#include <algorithm>
+#include <layers/functors/sequence_reduce_functors.hpp>
+
+namespace HugeCTR {
+
+namespace {
+
+constexpr int kMaxThreads = 256;
+
+// Number of valid steps of sample b, clamped to [0, max_seq_len]
+template <typename T>
+__device__ __forceinline__ int valid_steps(const T* seq_lens, int64_t b, int64_t max_seq_len) {
+  int len = static_cast<int>(static_cast<float>(seq_lens[b]));
+  return min(max(len, 0), static_cast<int>(max_seq_len));
+}
+
+// One block per sample, the threads of a block stride over the vector
+template <typename T>
+__global__ void sequence_reduce_kernel(const T* input, const T* seq_lens, T* output,
+                                       int64_t max_seq_len, int64_t vector_size, bool mean) {
+  const int64_t b = blockIdx.x;
+  const int len = valid_steps(seq_lens, b, max_seq_len);
+  const float scale = mean && len > 0 ? 1.0f / len : 1.0f;
+  input += b * max_seq_len * vector_size;
+  for (int64_t i = threadIdx.x; i < vector_size; i += blockDim.x) {
+    float sum = 0.0f;
+    for (int t = 0; t < len; t++) {
+      sum += static_cast<float>(input[t * vector_size + i]);
+    }
+    output[b * vector_size + i] = static_cast<T>(sum * scale);
+  }
+}
+
+template <typename T>
+__global__ void sequence_reduce_dgrad_kernel(const T* top_grad, const T* seq_lens, T* dgrad,
+                                             int64_t max_seq_len, int64_t vector_size, bool mean) {
+  const int64_t b = blockIdx.x;
+  const int len = valid_steps(seq_lens, b, max_seq_len);
+  const float scale = mean && len > 0 ? 1.0f / len : 1.0f;
+  dgrad += b * max_seq_len * vector_size;
+  for (int64_t i = threadIdx.x; i < vector_size; i += blockDim.x) {
+    const T grad = static_cast<T>(static_cast<float>(top_grad[b * vector_size + i]) * scale);
+    for (int t = 0; t < max_seq_len; t++) {
+      dgrad[t * vector_size + i] = t < len ? grad : T(0.0f);
+    }
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void sequence_reduce_fprop(const T* input, const T* seq_lens, T* output, int64_t batch_size,
+                           int64_t max_seq_len, int64_t vector_size, bool mean,
+                           cudaStream_t stream) {
+  const int block_size = std::min(vector_size, static_cast<int64_t>(kMaxThreads));
+  sequence_reduce_kernel<<<batch_size, block_size, 0, stream>>>(input, seq_lens, output,
+                                                                max_seq_len, vector_size, mean);
+}
+
+template <typename T>
+void sequence_reduce_bprop(const T* top_grad, const T* seq_lens, T* dgrad, int64_t batch_size,
+                           int64_t max_seq_len, int64_t vector_size, bool mean,
+                           cudaStream_t stream) {
+  const int block_size = std::min(vector_size, static_cast<int64_t>(kMaxThreads));
+  sequence_reduce_dgrad_kernel<<<batch_size, block_size, 0, stream>>>(
+      top_grad, seq_lens, dgrad, max_seq_len, vector_size, mean);
+}
+
+template void sequence_reduce_fprop<float>(const float*, const float*, float*, int64_t, int64_t,
+                                           int64_t, bool, cudaStream_t);
+template void sequence_reduce_fprop<__half>(const __half*, const __half*, __half*, int64_t,
+                                            int64_t, int64_t, bool, cudaStream_t);
+template void sequence_reduce_bprop<float>(const float*, const float*, float*, int64_t, int64_t,
+                                           int64_t, bool, cudaStream_t);
+template void sequence_reduce_bprop<__half>(const __half*, const __half*, __half*, int64_t,
+                                            int64_t, int64_t, bool, cudaStream_t);
+
+}  // namespace HugeCTR
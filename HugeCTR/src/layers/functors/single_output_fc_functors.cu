@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_fp16.h>
+
+#include <algorithm>
+#include <layers/functors/single_output_fc_functors.hpp>
+#include <utils.cuh>
+
+namespace HugeCTR {
+
+namespace {
+
+constexpr int kBlockSize = 256;
+constexpr int kWarpSize = 32;
+constexpr int64_t kMaxGridSize = 65536;
+// Blocks of the backward kernel, each one leaving a row of partial sums
+constexpr int64_t kMaxBpropBlocks = 128;
+
+int64_t grid_size(int64_t num_threads) {
+  return std::max<int64_t>(1, std::min((num_threads + kBlockSize - 1) / kBlockSize, kMaxGridSize));
+}
+
+// One warp per row
+template <typename T>
+__global__ void single_output_fc_fprop_kernel(const T* __restrict__ bottom,
+                                              const T* __restrict__ weight,
+                                              const T* __restrict__ bias, T* __restrict__ top,
+                                              int64_t batch_size, int64_t input_size) {
+  const int lane = threadIdx.x % kWarpSize;
+  const int64_t num_warps = static_cast<int64_t>(gridDim.x) * blockDim.x / kWarpSize;
+  const float b = static_cast<float>(bias[0]);
+  for (int64_t row = (blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x) / kWarpSize;
+       row < batch_size; row += num_warps) {
+    float acc = 0.0f;
+    for (int64_t k = lane; k < input_size; k += kWarpSize) {
+      acc += static_cast<float>(bottom[row * input_size + k]) * static_cast<float>(weight[k]);
+    }
+    acc = warpReduceSum(acc);
+    if (lane == 0) {
+      top[row] = static_cast<T>(acc + b);
+    }
+  }
+}
+
+// Each block takes the rows blockIdx.x, blockIdx.x + gridDim.x, ... and each thread some columns,
+// so that the rows are read and written with coalesced accesses
+template <typename T>
+__global__ void single_output_fc_bprop_kernel(T* __restrict__ bottom, const T* __restrict__ weight,
+                                              const T* __restrict__ top_grad,
+                                              T* __restrict__ wgrad, T* __restrict__ bias_grad,
+                                              bool accumulate_bias, float* partials,
+                                              unsigned int* counter, int64_t batch_size,
+                                              int64_t input_size) {
+  float* block_partials = partials + blockIdx.x * (input_size + 1);
+  for (int64_t k = threadIdx.x; k < input_size; k += blockDim.x) {
+    const float w = static_cast<float>(weight[k]);
+    float acc = 0.0f;
+    for (int64_t row = blockIdx.x; row < batch_size; row += gridDim.x) {
+      const float dy = static_cast<float>(top_grad[row]);
+      const int64_t idx = row * input_size + k;
+      acc += static_cast<float>(bottom[idx]) * dy;
+      bottom[idx] = static_cast<T>(dy * w);
+    }
+    block_partials[k] = acc;
+  }
+  float bias_acc = 0.0f;
+  for (int64_t row = blockIdx.x + static_cast<int64_t>(threadIdx.x) * gridDim.x; row < batch_size;
+       row += static_cast<int64_t>(blockDim.x) * gridDim.x) {
+    bias_acc += static_cast<float>(top_grad[row]);
+  }
+  bias_acc = blockReduceSum(bias_acc);
+  if (threadIdx.x == 0) {
+    block_partials[input_size] = bias_acc;
+  }
+
+  // The partials of this block are visible to the last one before it counts this block
+  __threadfence();
+  __shared__ bool is_last;
+  __syncthreads();
+  if (threadIdx.x == 0) {
+    is_last = atomicAdd(counter, 1u) == gridDim.x - 1;
+  }
+  __syncthreads();
+  if (!is_last) {
+    return;
+  }
+  for (int64_t k = threadIdx.x; k <= input_size; k += blockDim.x) {
+    float sum = 0.0f;
+    for (unsigned int b = 0; b < gridDim.x; b++) {
+      sum += __ldcg(partials + b * (input_size + 1) + k);
+    }
+    if (k < input_size) {
+      wgrad[k] = static_cast<T>(static_cast<float>(wgrad[k]) + sum);
+    } else {
+      bias_grad[0] =
+          static_cast<T>(accumulate_bias ? static_cast<float>(bias_grad[0]) + sum : sum);
+    }
+  }
+  if (threadIdx.x == 0) {
+    *counter = 0;
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void single_output_fc_fprop(const T* bottom, const T* weight, const T* bias, T* top,
+                            int64_t batch_size, int64_t input_size, cudaStream_t stream) {
+  single_output_fc_fprop_kernel<T><<<grid_size(batch_size * kWarpSize), kBlockSize, 0, stream>>>(
+      bottom, weight, bias, top, batch_size, input_size);
+}
+
+template <typename T>
+void single_output_fc_bprop(T* bottom, const T* weight, const T* top_grad, T* wgrad, T* bias_grad,
+                            bool accumulate_bias, float* partials, unsigned int* counter,
+                            int64_t batch_size, int64_t input_size, cudaStream_t stream) {
+  const int64_t num_blocks = std::max<int64_t>(1, std::min(batch_size, kMaxBpropBlocks));
+  single_output_fc_bprop_kernel<T><<<num_blocks, kBlockSize, 0, stream>>>(
+      bottom, weight, top_grad, wgrad, bias_grad, accumulate_bias, partials, counter, batch_size,
+      input_size);
+}
+
+int64_t single_output_fc_partials_size(int64_t input_size) {
+  return kMaxBpropBlocks * (input_size + 1);
+}
+
+template void single_output_fc_fprop<float>(const float*, const float*, const float*, float*,
+                                            int64_t, int64_t, cudaStream_t);
+template void single_output_fc_fprop<__half>(const __half*, const __half*, const __half*, __half*,
+                                             int64_t, int64_t, cudaStream_t);
+template void single_output_fc_bprop<float>(float*, const float*, const float*, float*, float*,
+                                            bool, float*, unsigned int*, int64_t, int64_t,
+                                            cudaStream_t);
+template void single_output_fc_bprop<__half>(__half*, const __half*, const __half*, __half*,
+                                             __half*, bool, float*, unsigned int*, int64_t,
+                                             int64_t, cudaStream_t);
+
+}  // namespace HugeCTR
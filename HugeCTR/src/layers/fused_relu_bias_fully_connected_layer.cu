@@ -16,6 +16,7 @@
 
 #include <common.hpp>
 #include <cstdio>
+#include <gemm_algo_cache.hpp>
 #include <layers/fused_relu_bias_fully_connected_layer.hpp>
 #include <linalg/reduce.cuh>
 #include <utils.cuh>
@@ -508,7 +509,12 @@ void FusedReluBiasFullyConnectedLayer::search_algorithm() {
     HCTR_LIB_THROW(CUBLAS_STATUS_NOT_SUPPORTED);
   }
 
-  for (int algoIdx = 0; algoIdx < algo_count; algoIdx++) {
+  // The algorithms found in the cache are taken as they are
+  auto& algo_cache = GemmAlgoCache::get();
+  const bool falgo_k_cached = algo_cache.find(
+      get_gpu().get_cublaslt_handle(), cublas_op_desc_, cublas_kernel_desc_, cublas_bottom_desc_,
+      cublas_top_desc_, cublas_top_desc_, cublaslt_workspace_size_, &falgo_k_);
+  for (int algoIdx = 0; !falgo_k_cached && algoIdx < algo_count; algoIdx++) {
     cublasStatus_t status = CUBLAS_STATUS_SUCCESS;
 
     const float alpha = 1.0f;
@@ -547,6 +553,9 @@ void FusedReluBiasFullyConnectedLayer::search_algorithm() {
     }
   }
 
+  algo_cache.insert(cublas_op_desc_, cublas_kernel_desc_, cublas_bottom_desc_, cublas_top_desc_,
+                    cublas_top_desc_, cublaslt_workspace_size_, falgo_k_);
+
   // dRelu in backward pass
   // Reset shortestTime
   shortestTime = std::numeric_limits<float>::max();
@@ -561,7 +570,11 @@ void FusedReluBiasFullyConnectedLayer::search_algorithm() {
     HCTR_LIB_THROW(CUBLAS_STATUS_NOT_SUPPORTED);
   }
 
-  for (int algoIdx = 0; algoIdx < algo_count_dRelu; algoIdx++) {
+  const bool balgo_dRelu_cached = algo_cache.find(
+      get_gpu().get_cublaslt_handle(), cublas_op_desc_bprop_, cublas_kernel_desc_,
+      cublas_dRelu_top_desc_, cublas_dRelu_bottom_desc_, cublas_dRelu_bottom_desc_,
+      cublaslt_workspace_size_, &balgo_dRelu_);
+  for (int algoIdx = 0; !balgo_dRelu_cached && algoIdx < algo_count_dRelu; algoIdx++) {
     cublasStatus_t status = CUBLAS_STATUS_SUCCESS;
 
     const float alpha = 1.0f;
@@ -593,6 +606,10 @@ void FusedReluBiasFullyConnectedLayer::search_algorithm() {
     }
   }
 
+  algo_cache.insert(cublas_op_desc_bprop_, cublas_kernel_desc_, cublas_dRelu_top_desc_,
+                    cublas_dRelu_bottom_desc_, cublas_dRelu_bottom_desc_, cublaslt_workspace_size_,
+                    balgo_dRelu_);
+
   // wgrad in backward pass
   // Reset shortestTime
   shortestTime = std::numeric_limits<float>::max();
@@ -607,7 +624,11 @@ void FusedReluBiasFullyConnectedLayer::search_algorithm() {
     HCTR_LIB_THROW(CUBLAS_STATUS_NOT_SUPPORTED);
   }
 
-  for (int algoIdx = 0; algoIdx < algo_count_wgrad; algoIdx++) {
+  const bool balgo_wgrad_cached = algo_cache.find(
+      get_gpu().get_cublaslt_handle(), cublas_op_desc_wgrad_, cublas_dRelu_top_desc_,
+      cublas_dRelu_bottom_desc_, cublas_kernel_desc_, cublas_kernel_desc_,
+      cublaslt_workspace_size_, &balgo_wgrad_);
+  for (int algoIdx = 0; !balgo_wgrad_cached && algoIdx < algo_count_wgrad; algoIdx++) {
     cublasStatus_t status = CUBLAS_STATUS_SUCCESS;
 
     const float alpha = 1.0f;
@@ -641,6 +662,10 @@ void FusedReluBiasFullyConnectedLayer::search_algorithm() {
     }
   }
 
+  algo_cache.insert(cublas_op_desc_wgrad_, cublas_dRelu_top_desc_, cublas_dRelu_bottom_desc_,
+                    cublas_kernel_desc_, cublas_kernel_desc_, cublaslt_workspace_size_,
+                    balgo_wgrad_);
+
   // Reset shortestTime
   shortestTime = std::numeric_limits<float>::max();
 
@@ -649,7 +674,10 @@ void FusedReluBiasFullyConnectedLayer::search_algorithm() {
   const cublasGemmAlgo_t endAlgo = CUBLAS_GEMM_ALGO15_TENSOR_OP;
 
   // Search all the algorithm for balgo_k_
-  for (int testAlgo = startAlgo; testAlgo <= endAlgo; testAlgo++) {
+  const std::vector<int64_t> balgo_k_gemm = {
+      CUBLAS_OP_N, CUBLAS_OP_T, output_size, input_size, batch_size, CUDA_R_16F, CUDA_R_32F};
+  const bool balgo_k_cached = algo_cache.find(balgo_k_gemm, &balgo_k_);
+  for (int testAlgo = startAlgo; !balgo_k_cached && testAlgo <= endAlgo; testAlgo++) {
     cublasStatus_t status = CUBLAS_STATUS_SUCCESS;
 
     const float alpha = 1.0f;
@@ -682,12 +710,16 @@ void FusedReluBiasFullyConnectedLayer::search_algorithm() {
       balgo_k_ = static_cast<cublasGemmAlgo_t>(testAlgo);
     }
   }
+  algo_cache.insert(balgo_k_gemm, balgo_k_);
 
   // Reset shortestTime
   shortestTime = std::numeric_limits<float>::max();
 
   // Search all the algorithm for balgo_b_
-  for (int testAlgo = startAlgo; testAlgo <= endAlgo; testAlgo++) {
+  const std::vector<int64_t> balgo_b_gemm = {
+      CUBLAS_OP_N, CUBLAS_OP_N, output_size, 1, batch_size, CUDA_R_16F, CUDA_R_32F};
+  const bool balgo_b_cached = algo_cache.find(balgo_b_gemm, &balgo_b_);
+  for (int testAlgo = startAlgo; !balgo_b_cached && testAlgo <= endAlgo; testAlgo++) {
     cublasStatus_t status = CUBLAS_STATUS_SUCCESS;
 
     const float alpha = 1.0f;
@@ -718,11 +750,15 @@ void FusedReluBiasFullyConnectedLayer::search_algorithm() {
       balgo_b_ = static_cast<cublasGemmAlgo_t>(testAlgo);
     }
   }
+  algo_cache.insert(balgo_b_gemm, balgo_b_);
   // Reset shortestTime
   shortestTime = std::numeric_limits<float>::max();
 
   // Search all the algorithm for balgo_x_
-  for (int testAlgo = startAlgo; testAlgo <= endAlgo; testAlgo++) {
+  const std::vector<int64_t> balgo_x_gemm = {
+      CUBLAS_OP_T, CUBLAS_OP_N, input_size, batch_size, output_size, CUDA_R_16F, CUDA_R_32F};
+  const bool balgo_x_cached = algo_cache.find(balgo_x_gemm, &balgo_x_);
+  for (int testAlgo = startAlgo; !balgo_x_cached && testAlgo <= endAlgo; testAlgo++) {
     cublasStatus_t status = CUBLAS_STATUS_SUCCESS;
 
     const __half alpha = 1.0f;
@@ -754,6 +790,7 @@ void FusedReluBiasFullyConnectedLayer::search_algorithm() {
       balgo_x_ = static_cast<cublasGemmAlgo_t>(testAlgo);
     }
   }
+  algo_cache.insert(balgo_x_gemm, balgo_x_);
 
   // Print selection information
   // HCTR_LOG(INFO, WORLD, "The algorithm selection for falgo_k_, balgo_k_, balgo_x_ are: %d, %d and
@@ -0,0 +1,364 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_fp16.h>
+
+#include <algorithm>
+#include <layers/functors/reduce_functors.hpp>
+#include <layers/grouped_mlp_layer.hpp>
+#include <network_buffer_channels.hpp>
+#include <type_traits>
+#include <utils.cuh>
+#include <utils.hpp>
+
+namespace HugeCTR {
+
+namespace {
+
+constexpr int kBlockSize = 256;
+constexpr int64_t kMaxGridSize = 65536;
+
+// The arrays of one layer, each one holding a pointer per tower
+enum PointerArray {
+  kKernel,
+  kBias,
+  kBottom,
+  kTop,
+  kAct,   // ReLU outputs read by the dReLU
+  kGrad,  // Gradients w.r.t. the top
+  kKernelGrad,
+  kBiasGrad,
+  kBottomGrad,
+  kOnes,
+  kNumPointerArrays
+};
+
+// blockIdx.y of the kernels below is the tower
+dim3 tower_grid(int64_t num_elements, int64_t num_towers) {
+  const int64_t num_blocks = (num_elements + kBlockSize - 1) / kBlockSize;
+  return dim3(std::max<int64_t>(1, std::min(num_blocks, kMaxGridSize / num_towers)), num_towers);
+}
+
+template <typename T>
+__global__ void bias_act_kernel(T* const* tops, const T* const* biases, T* const* masks,
+                                int64_t num_elements, int64_t num_output, bool relu) {
+  T* top = tops[blockIdx.y];
+  const T* bias = biases ? biases[blockIdx.y] : nullptr;
+  T* mask = masks ? masks[blockIdx.y] : nullptr;
+  for (int64_t idx = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x;
+       idx < num_elements; idx += static_cast<int64_t>(gridDim.x) * blockDim.x) {
+    float value = static_cast<float>(top[idx]);
+    if (bias) {
+      value += static_cast<float>(bias[idx % num_output]);
+    }
+    if (relu && value < 0.0f) {
+      value = 0.0f;
+    }
+    const T out = static_cast<T>(value);
+    top[idx] = out;
+    if (mask) {
+      mask[idx] = out;
+    }
+  }
+}
+
+template <typename T>
+__global__ void drelu_kernel(T* const* grads, const T* const* acts, int64_t num_elements) {
+  T* grad = grads[blockIdx.y];
+  const T* act = acts[blockIdx.y];
+  for (int64_t idx = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x;
+       idx < num_elements; idx += static_cast<int64_t>(gridDim.x) * blockDim.x) {
+    if (!(static_cast<float>(act[idx]) > 0.0f)) {
+      grad[idx] = static_cast<T>(0.0f);
+    }
+  }
+}
+
+// C[b] = A[b] * B[b] + beta * C[b] for every tower b, column major as cuBLAS
+template <typename T>
+void batched_gemm(cublasHandle_t handle, cublasOperation_t trans_a, cublasOperation_t trans_b,
+                  int64_t m, int64_t n, int64_t k, void** a, int64_t lda, void** b, int64_t ldb,
+                  float beta, void** c, int64_t ldc, int64_t batch_count,
+                  bool enable_tf32_compute) {
+  constexpr bool is_half = std::is_same<T, __half>::value;
+  const cudaDataType_t data_type = is_half ? CUDA_R_16F : CUDA_R_32F;
+  const cublasComputeType_t compute_type =
+      enable_tf32_compute && !is_half ? CUBLAS_COMPUTE_32F_FAST_TF32 : CUBLAS_COMPUTE_32F;
+  const cublasGemmAlgo_t algo = is_half ? CUBLAS_GEMM_DEFAULT_TENSOR_OP : CUBLAS_GEMM_DEFAULT;
+  const float alpha = 1.0f;
+  HCTR_LIB_THROW(cublasGemmBatchedEx(handle, trans_a, trans_b, m, n, k, &alpha, a, data_type, lda,
+                                     b, data_type, ldb, &beta, c, data_type, ldc, batch_count,
+                                     compute_type, algo));
+}
+
+}  // namespace
+
+template <typename T>
+GroupedMLPLayer<T>::GroupedMLPLayer(const std::vector<core23::Tensor>& bottom_tensors,
+                                    const std::vector<core23::Tensor>& top_tensors,
+                                    const std::vector<int64_t>& num_outputs,
+                                    const std::shared_ptr<GPUResource>& gpu_resource,
+                                    const std::vector<Activation_t>& acts,
+                                    const std::vector<bool>& use_bias,
+                                    std::vector<Initializer_t> initializer_types,
+                                    bool skip_head_dgrad, bool enable_tf32_compute)
+    : TrainableLayer<T>(bottom_tensors, top_tensors, gpu_resource, initializer_types),
+      num_towers_(top_tensors.size()),
+      num_outputs_(num_outputs),
+      acts_(acts),
+      use_bias_(use_bias),
+      skip_head_dgrad_(skip_head_dgrad),
+      enable_tf32_compute_(enable_tf32_compute) {
+  const int64_t num_layers = num_outputs_.size();
+  HCTR_CHECK_HINT(num_layers > 0 && acts_.size() == num_outputs_.size() &&
+                      use_bias_.size() == num_outputs_.size(),
+                  "GroupedMLPLayer needs an activation and a bias flag per layer");
+  for (auto act : acts_) {
+    HCTR_CHECK_HINT(act == Activation_t::Relu || act == Activation_t::None,
+                    "GroupedMLPLayer only supports the Relu and None activations");
+  }
+  HCTR_CHECK_HINT(num_towers_ > 0 && num_towers_ <= 65535,
+                  "GroupedMLPLayer needs between 1 and 65535 towers");
+  HCTR_CHECK_HINT(bottom_tensors.size() == 1 || bottom_tensors.size() == top_tensors.size(),
+                  "GroupedMLPLayer needs an input per tower or a shared one");
+  const core23::Shape bottom_shape = bottom_tensors[0].shape();
+  HCTR_CHECK_HINT(bottom_shape.dims() == 2, "The inputs of GroupedMLPLayer must be 2D");
+  for (const auto& bottom_tensor : bottom_tensors) {
+    HCTR_CHECK_HINT(bottom_tensor.shape() == bottom_shape,
+                    "The inputs of GroupedMLPLayer must have the same shape");
+  }
+  batch_size_ = bottom_shape.size(0);
+  input_size_ = bottom_shape.size(1);
+  const core23::Shape top_shape({batch_size_, num_outputs_.back()});
+  for (const auto& top_tensor : top_tensors) {
+    HCTR_CHECK_HINT(top_tensor.shape() == top_shape,
+                    "The outputs of GroupedMLPLayer must be (batch_size, num_outputs.back())");
+  }
+
+  // Tower by tower, the kernel and the bias of each layer
+  for (int64_t t = 0; t < num_towers_; t++) {
+    for (int64_t i = 0; i < num_layers; i++) {
+      const int64_t index = 2 * (t * num_layers + i);
+      core23::Shape kernel_dim = {i == 0 ? input_size_ : num_outputs_[i - 1], num_outputs_[i]};
+      core23::Shape bias_dim = {1, num_outputs_[i]};
+      this->set_weight(index, kernel_dim);
+      this->set_weight(index + 1, bias_dim);
+      this->set_wgrad(index, kernel_dim);
+      this->set_wgrad(index + 1, bias_dim);
+    }
+  }
+
+  core23::BufferParams blobs_buffer_params = {};
+  blobs_buffer_params.channel = GetBlobsBufferChannel();
+  core23::Device device(core23::DeviceType::GPU, gpu_resource->get_device_id());
+  auto make_tensor = [&](core23::DataType data_type, const core23::Shape& shape) {
+    return core23::Tensor(core23::TensorParams()
+                              .data_type(data_type)
+                              .shape(shape)
+                              .device(device)
+                              .buffer_params(blobs_buffer_params));
+  };
+  const core23::DataType data_type = core23::ToScalarType<T>::value;
+  train_tensors_.resize(num_layers - 1);
+  dact_tensors_.resize(num_layers - 1);
+  for (int64_t i = 0; i < num_layers - 1; i++) {
+    for (int64_t t = 0; t < num_towers_; t++) {
+      train_tensors_[i].push_back(make_tensor(data_type, {batch_size_, num_outputs_[i]}));
+      if (acts_[i] == Activation_t::Relu) {
+        dact_tensors_[i].push_back(make_tensor(data_type, {batch_size_, num_outputs_[i]}));
+      }
+    }
+  }
+  if (acts_.back() == Activation_t::Relu) {
+    for (int64_t t = 0; t < num_towers_; t++) {
+      mask_tensors_.push_back(make_tensor(data_type, top_shape));
+    }
+  }
+  if (bottom_tensors.size() == 1 && num_towers_ > 1 && !skip_head_dgrad_) {
+    shared_dgrad_tensor_ = make_tensor(data_type, {num_towers_, batch_size_, input_size_});
+  }
+  ones_tensor_ = make_tensor(data_type, {batch_size_});
+  pointer_tensor_ =
+      make_tensor(core23::ScalarType::UInt64, {num_layers * kNumPointerArrays * num_towers_});
+}
+
+template <typename T>
+void** GroupedMLPLayer<T>::get_pointer_array(int64_t layer, int array) {
+  return static_cast<void**>(pointer_tensor_.data()) +
+         (layer * kNumPointerArrays + array) * num_towers_;
+}
+
+template <typename T>
+void GroupedMLPLayer<T>::initialize() {
+  CudaDeviceContext context(this->get_device_id());
+
+  const int64_t num_layers = num_outputs_.size();
+  const bool shared_bottom = this->input_tensors_.size() == 1 && num_towers_ > 1;
+  auto top_of = [&](int64_t i, int64_t t) {
+    return i == num_layers - 1 ? this->output_tensors_[t].data() : train_tensors_[i][t].data();
+  };
+  // The gradients of the ReLU layers go to their own tensors, which keeps the activations
+  auto grad_of = [&](int64_t i, int64_t t) {
+    return i < num_layers - 1 && acts_[i] == Activation_t::Relu ? dact_tensors_[i][t].data()
+                                                                 : top_of(i, t);
+  };
+
+  std::vector<void*> h_pointers(num_layers * kNumPointerArrays * num_towers_, nullptr);
+  for (int64_t i = 0; i < num_layers; i++) {
+    for (int64_t t = 0; t < num_towers_; t++) {
+      auto set = [&](int array, void* ptr) {
+        h_pointers[(i * kNumPointerArrays + array) * num_towers_ + t] = ptr;
+      };
+      const int64_t index = 2 * (t * num_layers + i);
+      set(kKernel, this->get_weight(index).data());
+      set(kBias, this->get_weight(index + 1).data());
+      set(kBottom, i == 0 ? this->input_tensors_[shared_bottom ? 0 : t].data()
+                          : train_tensors_[i - 1][t].data());
+      set(kTop, top_of(i, t));
+      if (acts_[i] == Activation_t::Relu) {
+        set(kAct, i == num_layers - 1 ? mask_tensors_[t].data() : train_tensors_[i][t].data());
+      }
+      set(kGrad, grad_of(i, t));
+      set(kKernelGrad, this->get_wgrad(index).data());
+      set(kBiasGrad, this->get_wgrad(index + 1).data());
+      if (i > 0) {
+        set(kBottomGrad, grad_of(i - 1, t));
+      } else if (!shared_bottom) {
+        set(kBottomGrad, this->input_tensors_[t].data());
+      } else if (!shared_dgrad_tensor_.empty()) {
+        set(kBottomGrad, shared_dgrad_tensor_.data<T>() + t * batch_size_ * input_size_);
+      }
+      set(kOnes, ones_tensor_.data());
+    }
+  }
+  HCTR_LIB_THROW(cudaMemcpy(pointer_tensor_.data(), h_pointers.data(),
+                            h_pointers.size() * sizeof(void*), cudaMemcpyHostToDevice));
+  initialize_array<<<(batch_size_ - 1) / 1024 + 1, 1024, 0, this->get_gpu().get_stream()>>>(
+      ones_tensor_.data<T>(), batch_size_, T(1.0f));
+}
+
+template <typename T>
+void GroupedMLPLayer<T>::fprop(bool is_train) {
+  CudaDeviceContext context(this->get_device_id());
+
+  const auto cublas_handle = this->get_gpu().get_cublas_handle();
+  const auto stream = this->get_gpu().get_stream();
+  const int64_t num_layers = num_outputs_.size();
+  for (int64_t i = 0; i < num_layers; i++) {
+    const int64_t bottom_size = i == 0 ? input_size_ : num_outputs_[i - 1];
+    const int64_t top_size = num_outputs_[i];
+    batched_gemm<T>(cublas_handle, CUBLAS_OP_N, CUBLAS_OP_N, top_size, batch_size_, bottom_size,
+                    get_pointer_array(i, kKernel), top_size, get_pointer_array(i, kBottom),
+                    bottom_size, 0.0f, get_pointer_array(i, kTop), top_size, num_towers_,
+                    enable_tf32_compute_);
+
+    const bool relu = acts_[i] == Activation_t::Relu;
+    if (use_bias_[i] || relu) {
+      const int64_t num_elements = batch_size_ * top_size;
+      // The ReLU outputs of the last layer are kept for the dReLU
+      T* const* masks = relu && i == num_layers - 1
+                            ? reinterpret_cast<T* const*>(get_pointer_array(i, kAct))
+                            : nullptr;
+      const T* const* biases =
+          use_bias_[i] ? reinterpret_cast<const T* const*>(get_pointer_array(i, kBias)) : nullptr;
+      bias_act_kernel<T><<<tower_grid(num_elements, num_towers_), kBlockSize, 0, stream>>>(
+          reinterpret_cast<T* const*>(get_pointer_array(i, kTop)), biases, masks, num_elements,
+          top_size, relu);
+    }
+  }
+}
+
+template <typename T>
+void GroupedMLPLayer<T>::bprop() {
+  CudaDeviceContext context(this->get_device_id());
+
+  const auto cublas_handle = this->get_gpu().get_cublas_handle();
+  const auto stream = this->get_gpu().get_stream();
+  const int64_t num_layers = num_outputs_.size();
+  for (int64_t i = num_layers - 1; i >= 0; i--) {
+    const int64_t bottom_size = i == 0 ? input_size_ : num_outputs_[i - 1];
+    const int64_t top_size = num_outputs_[i];
+    void** grads = get_pointer_array(i, kGrad);
+
+    if (acts_[i] == Activation_t::Relu) {
+      const int64_t num_elements = batch_size_ * top_size;
+      drelu_kernel<T><<<tower_grid(num_elements, num_towers_), kBlockSize, 0, stream>>>(
+          reinterpret_cast<T* const*>(grads),
+          reinterpret_cast<const T* const*>(get_pointer_array(i, kAct)), num_elements);
+    }
+    // The bias gradients are overwritten, the kernel ones accumulated, as in MLPLayer
+    if (use_bias_[i]) {
+      batched_gemm<T>(cublas_handle, CUBLAS_OP_N, CUBLAS_OP_N, top_size, 1, batch_size_, grads,
+                      top_size, get_pointer_array(i, kOnes), batch_size_, 0.0f,
+                      get_pointer_array(i, kBiasGrad), top_size, num_towers_,
+                      enable_tf32_compute_);
+    }
+    batched_gemm<T>(cublas_handle, CUBLAS_OP_N, CUBLAS_OP_T, top_size, bottom_size, batch_size_,
+                    grads, top_size, get_pointer_array(i, kBottom), bottom_size, 1.0f,
+                    get_pointer_array(i, kKernelGrad), top_size, num_towers_,
+                    enable_tf32_compute_);
+    if (i > 0 || !skip_head_dgrad_) {
+      batched_gemm<T>(cublas_handle, CUBLAS_OP_T, CUBLAS_OP_N, bottom_size, batch_size_, top_size,
+                      get_pointer_array(i, kKernel), top_size, grads, top_size, 0.0f,
+                      get_pointer_array(i, kBottomGrad), bottom_size, num_towers_,
+                      enable_tf32_compute_);
+    }
+  }
+
+  if (!shared_dgrad_tensor_.empty()) {
+    reduce_fprop(shared_dgrad_tensor_.data<T>(), this->input_tensors_[0].template data<T>(), 1,
+                 num_towers_, batch_size_ * input_size_, false, stream);
+  }
+}
+
+template <typename T>
+std::unique_ptr<DataSimulator> GroupedMLPLayer<T>::get_uniform_initializer(const int index) {
+  const int64_t i = index / 2 % num_outputs_.size();
+  const int64_t bottom_dim = i == 0 ? input_size_ : num_outputs_[i - 1];
+  float limit = sqrt(1.0f / bottom_dim);
+  return std::make_unique<UniformDataSimulator>(-1 * limit, limit);
+}
+
+template <typename T>
+std::unique_ptr<DataSimulator> GroupedMLPLayer<T>::get_xavier_uniform_initializer(
+    const int index) {
+  const int64_t i = index / 2 % num_outputs_.size();
+  const int64_t bottom_dim = i == 0 ? input_size_ : num_outputs_[i - 1];
+  // fan_avg for the kernels, fan_out for the biases
+  auto fan_mode = index % 2 ? data_simu::Mode_t::Fan_out : data_simu::Mode_t::Fan_avg;
+  return std::make_unique<VarianceScalingSimulator>(
+      1.f, fan_mode, data_simu::Distribution_t::Uniform, bottom_dim, num_outputs_[i]);
+}
+
+template <typename T>
+std::unique_ptr<DataSimulator> GroupedMLPLayer<T>::get_xavier_norm_initializer(const int index) {
+  const int64_t i = index / 2 % num_outputs_.size();
+  const int64_t bottom_dim = i == 0 ? input_size_ : num_outputs_[i - 1];
+  auto fan_mode = index % 2 ? data_simu::Mode_t::Fan_out : data_simu::Mode_t::Fan_avg;
+  return std::make_unique<VarianceScalingSimulator>(1.f, fan_mode, data_simu::Distribution_t::Norm,
+                                                    bottom_dim, num_outputs_[i]);
+}
+
+template <typename T>
+std::unique_ptr<DataSimulator> GroupedMLPLayer<T>::get_default_initializer(const int index) {
+  return this->get_uniform_initializer(index);
+}
+
+template class GroupedMLPLayer<float>;
+template class GroupedMLPLayer<__half>;
+
+}  // namespace HugeCTR
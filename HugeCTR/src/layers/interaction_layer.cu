@@ -20,10 +20,12 @@
 #include <device_launch_parameters.h>
 #include <mma.h>
 
+#include <algorithm>
 #include <common.hpp>
 #include <layers/interaction_layer.hpp>
 #include <network_buffer_channels.hpp>
 #include <type_traits>
+#include <utils.cuh>
 #include <utils.hpp>
 
 namespace HugeCTR {
@@ -755,6 +757,280 @@ inline void dotBasedInteractBwd(void *upstream_grad, void *bottom_mlp_grad, void
   }
 }
 
+// Generic kernels, for any number of rows and any num_cols multiple of 8. A block per sample: the
+// sample is staged once in shared memory, row 0 from the bottom MLP output and the other rows from
+// the embeddings, both read in place, then the warps share the 16x16 tiles of the result.
+static constexpr uint kGenericWarpsPerBlock = 4;
+static constexpr uint kGenericThreads = kGenericWarpsPerBlock * 32;
+static constexpr uint kGenericTileDim = 16;
+static constexpr uint kGenericSkew = 8;
+static constexpr uint kGenericAccElemsPerWarp = kGenericTileDim * kGenericTileDim;
+
+struct GenericInteractShape {
+  uint num_rows_after_padding;
+  uint num_cols_after_padding;
+  uint input_stride;
+  uint ugrad_stride;
+  size_t fwd_smem_bytes;
+  size_t bwd_smem_bytes;
+
+  template <typename T>
+  static GenericInteractShape create(uint num_rows, uint num_cols) {
+    GenericInteractShape shape;
+    shape.num_rows_after_padding =
+        (num_rows + kGenericTileDim - 1) / kGenericTileDim * kGenericTileDim;
+    shape.num_cols_after_padding =
+        (num_cols + kGenericTileDim - 1) / kGenericTileDim * kGenericTileDim;
+    shape.input_stride = shape.num_cols_after_padding + kGenericSkew;
+    shape.ugrad_stride = shape.num_rows_after_padding + kGenericSkew;
+    const size_t input_bytes = sizeof(T) * shape.num_rows_after_padding * shape.input_stride;
+    const size_t ugrad_bytes = sizeof(T) * shape.num_rows_after_padding * shape.ugrad_stride;
+    const size_t acc_bytes = sizeof(float) * kGenericWarpsPerBlock * kGenericAccElemsPerWarp;
+    shape.fwd_smem_bytes = input_bytes + acc_bytes;
+    shape.bwd_smem_bytes = input_bytes + ugrad_bytes + acc_bytes;
+    return shape;
+  }
+};
+
+// Stages the rows of a sample, zero padded, with 16-byte accesses
+template <typename T>
+__device__ __forceinline__ void load_interaction_input(T *smem_in, const T *bottom_mlp_input,
+                                                       const T *emb_input, uint sample_id,
+                                                       uint num_rows, uint num_cols,
+                                                       uint num_rows_after_padding,
+                                                       uint num_cols_after_padding,
+                                                       uint input_stride) {
+  constexpr uint kElemsPerVec = sizeof(int4) / sizeof(T);
+  const uint vecs_per_row = num_cols_after_padding / kElemsPerVec;
+  for (uint idx = threadIdx.x; idx < num_rows_after_padding * vecs_per_row; idx += blockDim.x) {
+    const uint row = idx / vecs_per_row;
+    const uint vec = idx % vecs_per_row;
+    int4 val = make_int4(0, 0, 0, 0);
+    if (row < num_rows && vec * kElemsPerVec < num_cols) {
+      const T *src = row == 0 ? bottom_mlp_input + static_cast<size_t>(sample_id) * num_cols
+                              : emb_input + (static_cast<size_t>(sample_id) * (num_rows - 1) +
+                                             row - 1) * num_cols;
+      val = reinterpret_cast<const int4 *>(src)[vec];
+    }
+    reinterpret_cast<int4 *>(smem_in + row * input_stride)[vec] = val;
+  }
+}
+
+template <typename T>
+__launch_bounds__(kGenericThreads) __global__
+    void dotBasedInteractFwdKernelGeneric(const T *__restrict bottom_mlp_input,
+                                          const T *__restrict emb_input, T *__restrict output,
+                                          uint num_rows, uint num_cols,
+                                          uint num_rows_after_padding,
+                                          uint num_cols_after_padding, uint input_stride,
+                                          uint output_size) {
+#if __CUDA_ARCH__ >= 700 || !defined(__CUDA_ARCH__)
+  extern __shared__ __align__(32) char shmem_generic[];
+  const uint sample_id = blockIdx.x;
+  const uint warp_id = threadIdx.x / 32;
+  const uint lane_id = threadIdx.x % 32;
+  T *smem_in = reinterpret_cast<T *>(shmem_generic);
+  float *smem_acc = reinterpret_cast<float *>(smem_in + num_rows_after_padding * input_stride) +
+                    warp_id * kGenericAccElemsPerWarp;
+
+  load_interaction_input(smem_in, bottom_mlp_input, emb_input, sample_id, num_rows, num_cols,
+                         num_rows_after_padding, num_cols_after_padding, input_stride);
+  __syncthreads();
+
+  T *gmem_output = output + static_cast<size_t>(output_size) * sample_id;
+  for (uint col = threadIdx.x; col < num_cols; col += blockDim.x) {
+    gmem_output[col] = smem_in[col];
+  }
+  T *gmem_interact_output = gmem_output + num_cols;
+
+  // the lower triangle of the num_row_tiles x num_row_tiles tiles, tile t is (ti, tj) with
+  // t = ti * (ti + 1) / 2 + tj
+  const uint num_row_tiles = num_rows_after_padding / kGenericTileDim;
+  const uint num_k_steps = num_cols_after_padding / kGenericTileDim;
+  const uint num_tiles = num_row_tiles * (num_row_tiles + 1) / 2;
+  for (uint t = warp_id; t < num_tiles; t += kGenericWarpsPerBlock) {
+    uint ti = static_cast<uint>((sqrtf(8.0f * t + 1.0f) - 1.0f) * 0.5f);
+    while (ti * (ti + 1) / 2 > t) {
+      ti--;
+    }
+    while ((ti + 1) * (ti + 2) / 2 <= t) {
+      ti++;
+    }
+    const uint tj = t - ti * (ti + 1) / 2;
+
+    nvcuda::wmma::fragment<nvcuda::wmma::accumulator, kGenericTileDim, kGenericTileDim,
+                           kGenericTileDim, float>
+        acc;
+    nvcuda::wmma::fill_fragment(acc, 0);
+    for (uint k_step = 0; k_step < num_k_steps; k_step++) {
+      nvcuda::wmma::fragment<nvcuda::wmma::matrix_a, kGenericTileDim, kGenericTileDim,
+                             kGenericTileDim, T, nvcuda::wmma::row_major>
+          a;
+      nvcuda::wmma::fragment<nvcuda::wmma::matrix_b, kGenericTileDim, kGenericTileDim,
+                             kGenericTileDim, T, nvcuda::wmma::col_major>
+          b;
+      const uint k_offset = k_step * kGenericTileDim;
+      nvcuda::wmma::load_matrix_sync(
+          a, smem_in + ti * kGenericTileDim * input_stride + k_offset, input_stride);
+      nvcuda::wmma::load_matrix_sync(
+          b, smem_in + tj * kGenericTileDim * input_stride + k_offset, input_stride);
+      nvcuda::wmma::mma_sync(acc, a, b, acc);
+    }
+    nvcuda::wmma::store_matrix_sync(smem_acc, acc, kGenericTileDim, nvcuda::wmma::mem_row_major);
+    __syncwarp();
+    for (uint e = lane_id; e < kGenericAccElemsPerWarp; e += 32) {
+      const uint i = ti * kGenericTileDim + e / kGenericTileDim;
+      const uint j = tj * kGenericTileDim + e % kGenericTileDim;
+      if (j < i && i < num_rows) {
+        gmem_interact_output[((i * (i - 1)) >> 1) + j] =
+            TypeConvertFunc<T, float>::convert(smem_acc[e]);
+      }
+    }
+    __syncwarp();
+  }
+  // Padding
+  if (threadIdx.x == 0) {
+    gmem_output[output_size - 1] = TypeConvertFunc<T, float>::convert(0.0f);
+  }
+#else
+#warning "dotBasedInteractFwdKernelGeneric is not supported for SM < 70 (or __CUDA_ARCH__ < 700)"
+#endif
+}
+
+// input_grad = (ugrad + ugrad^T) x input, where ugrad is the num_rows x num_rows matrix of the
+// upstream interaction gradients. The gradients are written in place of the inputs.
+template <typename T>
+__launch_bounds__(kGenericThreads) __global__
+    void dotBasedInteractBwdKernelGeneric(const T *__restrict upstream_grad,
+                                          T *__restrict bottom_mlp_grad, T *__restrict emb_grad,
+                                          uint num_rows, uint num_cols,
+                                          uint num_rows_after_padding,
+                                          uint num_cols_after_padding, uint input_stride,
+                                          uint ugrad_stride, uint output_size) {
+#if __CUDA_ARCH__ >= 700 || !defined(__CUDA_ARCH__)
+  extern __shared__ __align__(32) char shmem_generic[];
+  const uint sample_id = blockIdx.x;
+  const uint warp_id = threadIdx.x / 32;
+  const uint lane_id = threadIdx.x % 32;
+  T *smem_in = reinterpret_cast<T *>(shmem_generic);
+  T *smem_ugrad = smem_in + num_rows_after_padding * input_stride;
+  float *smem_acc = reinterpret_cast<float *>(smem_ugrad + num_rows_after_padding * ugrad_stride) +
+                    warp_id * kGenericAccElemsPerWarp;
+
+  load_interaction_input(smem_in, bottom_mlp_grad, emb_grad, sample_id, num_rows, num_cols,
+                         num_rows_after_padding, num_cols_after_padding, input_stride);
+  const T *gmem_ugrad = upstream_grad + static_cast<size_t>(output_size) * sample_id;
+  const T *gmem_interact_ugrad = gmem_ugrad + num_cols;
+  for (uint idx = threadIdx.x; idx < num_rows_after_padding * num_rows_after_padding;
+       idx += blockDim.x) {
+    const uint i = idx / num_rows_after_padding;
+    const uint j = idx % num_rows_after_padding;
+    T val = TypeConvertFunc<T, float>::convert(0.0f);
+    if (i < num_rows && j < num_rows && i != j) {
+      const uint hi = max(i, j);
+      const uint lo = min(i, j);
+      val = gmem_interact_ugrad[((hi * (hi - 1)) >> 1) + lo];
+    }
+    smem_ugrad[i * ugrad_stride + j] = val;
+  }
+  __syncthreads();
+
+  const uint num_row_tiles = num_rows_after_padding / kGenericTileDim;
+  const uint num_col_tiles = num_cols_after_padding / kGenericTileDim;
+  for (uint t = warp_id; t < num_row_tiles * num_col_tiles; t += kGenericWarpsPerBlock) {
+    const uint ti = t / num_col_tiles;
+    const uint tc = t % num_col_tiles;
+    nvcuda::wmma::fragment<nvcuda::wmma::accumulator, kGenericTileDim, kGenericTileDim,
+                           kGenericTileDim, float>
+        acc;
+    nvcuda::wmma::fill_fragment(acc, 0);
+    for (uint k_step = 0; k_step < num_row_tiles; k_step++) {
+      nvcuda::wmma::fragment<nvcuda::wmma::matrix_a, kGenericTileDim, kGenericTileDim,
+                             kGenericTileDim, T, nvcuda::wmma::row_major>
+          a;
+      nvcuda::wmma::fragment<nvcuda::wmma::matrix_b, kGenericTileDim, kGenericTileDim,
+                             kGenericTileDim, T, nvcuda::wmma::row_major>
+          b;
+      const uint k_offset = k_step * kGenericTileDim;
+      nvcuda::wmma::load_matrix_sync(
+          a, smem_ugrad + ti * kGenericTileDim * ugrad_stride + k_offset, ugrad_stride);
+      nvcuda::wmma::load_matrix_sync(
+          b, smem_in + k_offset * input_stride + tc * kGenericTileDim, input_stride);
+      nvcuda::wmma::mma_sync(acc, a, b, acc);
+    }
+    nvcuda::wmma::store_matrix_sync(smem_acc, acc, kGenericTileDim, nvcuda::wmma::mem_row_major);
+    __syncwarp();
+    for (uint e = lane_id; e < kGenericAccElemsPerWarp; e += 32) {
+      const uint row = ti * kGenericTileDim + e / kGenericTileDim;
+      const uint col = tc * kGenericTileDim + e % kGenericTileDim;
+      if (row < num_rows && col < num_cols) {
+        if (row == 0) {
+          // the bottom MLP output is also copied to the output
+          const float grad = smem_acc[e] + TypeConvertFunc<float, T>::convert(gmem_ugrad[col]);
+          bottom_mlp_grad[static_cast<size_t>(sample_id) * num_cols + col] =
+              TypeConvertFunc<T, float>::convert(grad);
+        } else {
+          emb_grad[(static_cast<size_t>(sample_id) * (num_rows - 1) + row - 1) * num_cols + col] =
+              TypeConvertFunc<T, float>::convert(smem_acc[e]);
+        }
+      }
+    }
+    __syncwarp();
+  }
+#else
+#warning "dotBasedInteractBwdKernelGeneric is not supported for SM < 70 (or __CUDA_ARCH__ < 700)"
+#endif
+}
+
+template <typename KernelT>
+void set_generic_interact_smem(KernelT kernel, size_t smem_bytes) {
+  // dynamic shared memory above 48 KB has to be opted in
+  if (smem_bytes > 48 * 1024) {
+    HCTR_LIB_THROW(cudaFuncSetAttribute(kernel, cudaFuncAttributeMaxDynamicSharedMemorySize,
+                                        static_cast<int>(smem_bytes)));
+  }
+}
+
+template <typename T>
+bool generic_interact_fits(uint num_rows, uint num_cols, int device_id) {
+  if (num_cols % 8) {
+    return false;
+  }
+  int max_smem = 0;
+  HCTR_LIB_THROW(
+      cudaDeviceGetAttribute(&max_smem, cudaDevAttrMaxSharedMemoryPerBlockOptin, device_id));
+  auto shape = GenericInteractShape::create<T>(num_rows, num_cols);
+  return std::max(shape.fwd_smem_bytes, shape.bwd_smem_bytes) <= static_cast<size_t>(max_smem);
+}
+
+template <typename T>
+void dotBasedInteractFwdGeneric(const void *bottom_mlp_input, const void *emb_input, void *output,
+                                uint batch_size, uint num_rows, uint num_cols,
+                                cudaStream_t stream) {
+  auto shape = GenericInteractShape::create<T>(num_rows, num_cols);
+  uint output_size = num_cols + (num_rows * (num_rows - 1) >> 1) + 1;
+  set_generic_interact_smem(dotBasedInteractFwdKernelGeneric<T>, shape.fwd_smem_bytes);
+  dotBasedInteractFwdKernelGeneric<T>
+      <<<batch_size, kGenericThreads, shape.fwd_smem_bytes, stream>>>(
+          (const T *)bottom_mlp_input, (const T *)emb_input, (T *)output, num_rows, num_cols,
+          shape.num_rows_after_padding, shape.num_cols_after_padding, shape.input_stride,
+          output_size);
+}
+
+template <typename T>
+void dotBasedInteractBwdGeneric(const void *upstream_grad, void *bottom_mlp_grad, void *emb_grad,
+                                uint batch_size, uint num_rows, uint num_cols,
+                                cudaStream_t stream) {
+  auto shape = GenericInteractShape::create<T>(num_rows, num_cols);
+  uint output_size = num_cols + (num_rows * (num_rows - 1) >> 1) + 1;
+  set_generic_interact_smem(dotBasedInteractBwdKernelGeneric<T>, shape.bwd_smem_bytes);
+  dotBasedInteractBwdKernelGeneric<T>
+      <<<batch_size, kGenericThreads, shape.bwd_smem_bytes, stream>>>(
+          (const T *)upstream_grad, (T *)bottom_mlp_grad, (T *)emb_grad, num_rows, num_cols,
+          shape.num_rows_after_padding, shape.num_cols_after_padding, shape.input_stride,
+          shape.ugrad_stride, output_size);
+}
+
 template <typename T>
 __global__ void concat_kernel(bool forward, T *out, T *in_mlp, T *in_emb, const int h,
                               const int out_w, const int in_w, const int n_emb) {
@@ -983,8 +1259,14 @@ void InteractionLayer<T>::init(const core23::Tensor &input_bottom_mlp_tensor,
     auto tensor_params = input_bottom_mlp_tensor.my_params().buffer_params(buf_p);
 
     auto n_ins = 1 + second_input_shape.size(1);
+    auto in_w = first_input_shape.size(1);
+    // the fp16 tiled kernels are limited to 31 embeddings of up to 128 elements, larger inputs use
+    // the generic tensor core kernels when their shared memory fits and cuBLAS otherwise
+    bool uses_tiled_kernels = n_ins < n_ins_knob && in_w <= 128;
+    use_generic_kernels_ = std::is_same<T, __half>::value && !uses_tiled_kernels &&
+                           generic_interact_fits<T>(n_ins, in_w, gpu_resource->get_device_id());
     if (std::is_same<T, __half>::value == false ||
-        ((n_ins > 31) && (std::is_same<T, __half>::value))) {
+        (!uses_tiled_kernels && !use_generic_kernels_)) {
       auto concat_shape_width =
           first_input_shape.size(1) + second_input_shape.size(1) * second_input_shape.size(2);
       core23::Shape concat_shape = {first_input_shape.size(0), concat_shape_width};
@@ -1123,8 +1405,13 @@ void InteractionLayer<__half>::fprop(bool is_train) {
   const int in_w = input_tensors_[0].size(1);
   const int n_emb = input_tensors_[1].size(1);
   const int n_ins = 1 + n_emb;
+  if (use_generic_kernels_) {
+    dotBasedInteractFwdGeneric<__half>(in_mlp, in_emb, output, h, n_ins, in_w,
+                                       get_gpu().get_stream());
+    return;
+  }
   // use optimized fused kernel when num_emb + 1 < 33
-  if (n_ins >= n_ins_knob) {
+  if (n_ins >= n_ins_knob || in_w > 128) {
     this->fprop_generic(is_train);
     return;
   }
@@ -1229,7 +1516,12 @@ void InteractionLayer<__half>::bprop() {
   const int n_emb = input_tensors_[1].size(1);
   const int n_ins = 1 + n_emb;
   const int in_w = input_tensors_[0].size(1);
-  if (n_ins >= n_ins_knob) {
+  if (use_generic_kernels_) {
+    dotBasedInteractBwdGeneric<__half>(up_grad, mlp_grad, emb_grad, h, n_ins, in_w,
+                                       get_gpu().get_stream());
+    return;
+  }
+  if (n_ins >= n_ins_knob || in_w > 128) {
     this->bprop_generic();
     return;
   }
@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <layers/dropout_mask.cuh>
 #include <layers/layer_norm_layer.hpp>
 #include <string>
 #include <utils.cuh>
@@ -39,52 +40,170 @@ namespace {
 template <typename T>
 using ToStringType = typename std::conditional<std::is_same<T, __half>::value, float, T>::type;
 
-template <typename T>
-__global__ void layer_norm_kernel(T* out, const T* __restrict input, T* result_var, T* result_mean,
-                                  const T* __restrict gamma, const T* __restrict beta, int batch,
-                                  int hidden_dim, double eps) {
+// Running (count, mean, M2) triple of Welford's algorithm, kept in fp32 for every input type.
+struct WelfordStats {
+  float count;
+  float mean;
+  float m2;
+};
+
+__device__ __forceinline__ void welford_update(WelfordStats& stats, float val) {
+  stats.count += 1.0f;
+  float delta = val - stats.mean;
+  stats.mean += delta / stats.count;
+  stats.m2 += delta * (val - stats.mean);
+}
+
+__device__ __forceinline__ void welford_combine(WelfordStats& stats, const WelfordStats& other) {
+  if (other.count == 0.0f) return;
+  float count = stats.count + other.count;
+  float delta = other.mean - stats.mean;
+  float other_ratio = other.count / count;
+  stats.mean += delta * other_ratio;
+  stats.m2 += other.m2 + delta * delta * stats.count * other_ratio;
+  stats.count = count;
+}
+
+__device__ __forceinline__ void warp_welford_reduce(WelfordStats& stats) {
+  for (int offset = WARP_SIZE / 2; offset > 0; offset >>= 1) {
+    WelfordStats other;
+    other.count = __shfl_xor_sync(FINAL_MASK, stats.count, offset);
+    other.mean = __shfl_xor_sync(FINAL_MASK, stats.mean, offset);
+    other.m2 = __shfl_xor_sync(FINAL_MASK, stats.m2, offset);
+    welford_combine(stats, other);
+  }
+}
+
+// Merges the per-thread partial stats of a block and broadcasts mean and (var + eps) to all threads
+__device__ __forceinline__ void block_welford_reduce(WelfordStats stats, double eps, float& mean,
+                                                     float& variance) {
+  __shared__ WelfordStats s_stats[MAX_WARP_NUM];
   __shared__ float s_mean;
   __shared__ float s_variance;
 
-  float mean = 0.0f;
-  float t_mean = 0.0f;
-  float variance = 0.0f;
-  float t_variance = 0.0f;
-
-  float local_out = 0.0f;
-  for (int idx = threadIdx.x; idx < hidden_dim; idx += blockDim.x) {
-    local_out = static_cast<float>(input[blockIdx.x * hidden_dim + idx]);
-    mean += local_out;
+  const int lane = threadIdx.x % WARP_SIZE;
+  const int wid = threadIdx.x / WARP_SIZE;
+  warp_welford_reduce(stats);
+  if (blockDim.x > WARP_SIZE) {
+    if (lane == 0) s_stats[wid] = stats;
+    __syncthreads();
+    const int warp_num = (blockDim.x + WARP_SIZE - 1) / WARP_SIZE;
+    stats = lane < warp_num ? s_stats[lane] : WelfordStats{0.0f, 0.0f, 0.0f};
+    warp_welford_reduce(stats);
+  }
+  if (threadIdx.x == 0) {
+    s_mean = stats.mean;
+    s_variance = stats.m2 / stats.count + eps;  // get epsilon
   }
-  t_mean = blockDim.x <= 32 ? warpReduceSum<float>(mean) : blockReduceSum<float>(mean);
-  if (threadIdx.x == 0) s_mean = t_mean / hidden_dim;
   __syncthreads();
+  mean = s_mean;
+  variance = s_variance;
+}
+
+__device__ __forceinline__ float apply_relu(float val, bool relu) {
+  return relu && val < 0.0f ? 0.0f : val;
+}
+
+// Dropout fused after the activation, none if iteration is null
+struct FusedDropout {
+  float rate;
+  float scale;
+  unsigned long long seed;
+  const int64_t* iteration;
+};
 
-  float tmp = 0.0f;
+__device__ __forceinline__ int64_t load_iteration(const FusedDropout& dropout) {
+  return dropout.iteration ? *dropout.iteration : 0;
+}
+
+// idx is the index of the element in the whole output
+__device__ __forceinline__ float fused_dropout_factor(const FusedDropout& dropout,
+                                                      int64_t iteration, size_t idx) {
+  return dropout.iteration
+             ? dropout_factor(dropout.seed, idx, iteration, dropout.rate, dropout.scale)
+             : 1.0f;
+}
+
+__global__ void next_iteration_kernel(int64_t* iteration) { ++*iteration; }
+
+// Single pass over the row for the statistics, a second one to write the (activated) output
+template <typename T>
+__global__ void layer_norm_kernel(T* out, const T* __restrict input, T* result_var, T* result_mean,
+                                  const T* __restrict gamma, const T* __restrict beta, int batch,
+                                  int hidden_dim, double eps, bool relu, FusedDropout dropout) {
+  const size_t row_offset = static_cast<size_t>(blockIdx.x) * hidden_dim;
+  input += blockIdx.x * hidden_dim;
+  out += blockIdx.x * hidden_dim;
+
+  WelfordStats stats{0.0f, 0.0f, 0.0f};
   for (int idx = threadIdx.x; idx < hidden_dim; idx += blockDim.x) {
-    local_out = static_cast<float>(input[blockIdx.x * hidden_dim + idx]);
-    variance += (local_out - s_mean) * (local_out - s_mean);
+    welford_update(stats, static_cast<float>(input[idx]));
   }
-  t_variance = blockDim.x <= 32 ? warpReduceSum<float>(variance) : blockReduceSum<float>(variance);
-  if (threadIdx.x == 0) s_variance = t_variance / hidden_dim + eps;  // get epsilon
-  __syncthreads();
+  float mean, variance;
+  block_welford_reduce(stats, eps, mean, variance);
 
-  result_mean[blockIdx.x] = static_cast<T>(s_mean);
-  result_var[blockIdx.x] = static_cast<T>(s_variance);
+  if (threadIdx.x == 0) {
+    result_mean[blockIdx.x] = static_cast<T>(mean);
+    result_var[blockIdx.x] = static_cast<T>(variance);
+  }
 
+  const float rstd = rsqrtf(variance);
+  const int64_t iteration = load_iteration(dropout);
   for (int idx = threadIdx.x; idx < hidden_dim; idx += blockDim.x) {
-    local_out = static_cast<float>(input[blockIdx.x * hidden_dim + idx]);
-    out[blockIdx.x * hidden_dim + idx] =
-        static_cast<T>(((local_out - s_mean) * rsqrtf(s_variance)) * (float)(__ldg(&gamma[idx])) +
-                       (float)(__ldg(&beta[idx])));
+    float val = (static_cast<float>(input[idx]) - mean) * rstd * (float)(__ldg(&gamma[idx])) +
+                (float)(__ldg(&beta[idx]));
+    out[idx] = static_cast<T>(apply_relu(val, relu) *
+                              fused_dropout_factor(dropout, iteration, row_offset + idx));
+  }
+}
+
+// half2 variant of layer_norm_kernel, used when hidden_dim is even
+__global__ void layer_norm_half2_kernel(__half* out, const __half* __restrict input,
+                                        __half* result_var, __half* result_mean,
+                                        const __half* __restrict gamma,
+                                        const __half* __restrict beta, int batch, int hidden_dim,
+                                        double eps, bool relu, FusedDropout dropout) {
+  const int row_stride = hidden_dim / 2;
+  const size_t row_offset = static_cast<size_t>(blockIdx.x) * hidden_dim;
+  const half2* input_h = reinterpret_cast<const half2*>(input) + blockIdx.x * row_stride;
+  half2* out_h = reinterpret_cast<half2*>(out) + blockIdx.x * row_stride;
+  const half2* gamma_h = reinterpret_cast<const half2*>(gamma);
+  const half2* beta_h = reinterpret_cast<const half2*>(beta);
+
+  WelfordStats stats{0.0f, 0.0f, 0.0f};
+  for (int idx = threadIdx.x; idx < row_stride; idx += blockDim.x) {
+    float2 val = __half22float2(input_h[idx]);
+    welford_update(stats, val.x);
+    welford_update(stats, val.y);
+  }
+  float mean, variance;
+  block_welford_reduce(stats, eps, mean, variance);
+
+  if (threadIdx.x == 0) {
+    result_mean[blockIdx.x] = __float2half(mean);
+    result_var[blockIdx.x] = __float2half(variance);
+  }
+
+  const float rstd = rsqrtf(variance);
+  const int64_t iteration = load_iteration(dropout);
+  for (int idx = threadIdx.x; idx < row_stride; idx += blockDim.x) {
+    float2 val = __half22float2(input_h[idx]);
+    float2 g = __half22float2(__ldg(&gamma_h[idx]));
+    float2 b = __half22float2(__ldg(&beta_h[idx]));
+    val.x = apply_relu((val.x - mean) * rstd * g.x + b.x, relu) *
+            fused_dropout_factor(dropout, iteration, row_offset + 2 * idx);
+    val.y = apply_relu((val.y - mean) * rstd * g.y + b.y, relu) *
+            fused_dropout_factor(dropout, iteration, row_offset + 2 * idx + 1);
+    out_h[idx] = __float22half2_rn(val);
   }
 }
 
 template <typename T>
 __global__ void layer_norm_backward1(const T* __restrict__ out_grad, const T* __restrict__ X_data,
                                      const T* __restrict__ vars, const T* __restrict__ means,
+                                     const T* __restrict__ gamma, const T* __restrict__ beta,
                                      T* __restrict__ gamma_grad, T* __restrict__ betta_grad,
-                                     int batch, int hidden_dim) {
+                                     int batch, int hidden_dim, bool relu, FusedDropout dropout) {
   __shared__ float betta_buffer[TILE_DIM][TILE_DIM + 1];
   __shared__ float gamma_buffer[TILE_DIM][TILE_DIM + 1];
 
@@ -100,14 +219,23 @@ __global__ void layer_norm_backward1(const T* __restrict__ out_grad, const T* __
 
   float betta_tmp = 0;
   float gamma_tmp = 0;
+  const int64_t iteration = load_iteration(dropout);
+  float gamma_reg = 0.0f;
+  float beta_reg = 0.0f;
+  if (relu && idx < hidden_dim) {
+    gamma_reg = (float)gamma[idx];
+    beta_reg = (float)beta[idx];
+  }
   for (int r = threadIdx.y; r < batch; r += TILE_DIM) {
     float grad = 0.0f;
     float val = 0.0f;
     if (idx < hidden_dim) {
-      grad = (float)out_grad[offset];
+      grad = (float)out_grad[offset] * fused_dropout_factor(dropout, iteration, offset);
       val = (float)X_data[offset];
     }
     val = (val - (float)means[r]) * rsqrtf((float)vars[r]);
+    // the pre-activation output is recomputed to mask the gradient of the fused ReLU
+    if (relu && val * gamma_reg + beta_reg <= 0.0f) grad = 0.0f;
     betta_tmp += grad;
     gamma_tmp += (val * grad);
     offset += y_stride;
@@ -135,8 +263,9 @@ __global__ void layer_norm_backward1(const T* __restrict__ out_grad, const T* __
   }
 }
 template <typename T>
-__global__ void layer_norm_backward2(const T* out_grad, T* X_vals, const T* gamma, const T* vars,
-                                     const T* means, T* inp_grad, int hidden_dim) {
+__global__ void layer_norm_backward2(const T* out_grad, T* X_vals, const T* gamma, const T* beta,
+                                     const T* vars, const T* means, T* inp_grad, int hidden_dim,
+                                     bool relu, FusedDropout dropout) {
   int iteration_stride = blockDim.x;
   int iterations = hidden_dim / iteration_stride;
 
@@ -154,25 +283,27 @@ __global__ void layer_norm_backward2(const T* out_grad, T* X_vals, const T* gamm
   X_vals += (row * hidden_dim);
   inp_grad += (row * hidden_dim);
 
+  float var_reg = vars[row];
+  float mean_reg = means[row];
+  const int64_t iteration = load_iteration(dropout);
+  const size_t row_offset = static_cast<size_t>(row) * hidden_dim;
+
   float vals_arr[MAX_NUM_STRIDE];
   int high_index = iterations * iteration_stride + id;
+  // to cope with the case when hidden_dim cannot be divided by iteration_stride
+  if ((high_index) < hidden_dim) iterations++;
 #pragma unroll
   for (int i = 0; i < iterations; i++) {
-    float gamma_reg = gamma[i * iteration_stride + id];
-    vals_arr[i] = out_grad[i * iteration_stride + id];
-    vals_arr[i] *= gamma_reg;
-  }
-  // to cope with the case when hidden_dim cannot be divided by iteration_stride
-  if ((high_index) < hidden_dim) {
-    float gamma_reg = gamma[high_index];
-    vals_arr[iterations] = out_grad[high_index];
-    vals_arr[iterations] *= gamma_reg;
-    iterations++;
+    int pos = i * iteration_stride + id;
+    float gamma_reg = gamma[pos];
+    float grad = (float)out_grad[pos] * fused_dropout_factor(dropout, iteration, row_offset + pos);
+    if (relu) {
+      float val = (X_vals[pos] - mean_reg) * rsqrtf(var_reg) * gamma_reg + (float)beta[pos];
+      if (val <= 0.0f) grad = 0.0f;
+    }
+    vals_arr[i] = grad * gamma_reg;
   }
 
-  float var_reg = vars[row];
-  float mean_reg = means[row];
-
   float sum = 0;
   float xu[MAX_NUM_STRIDE];
   for (int i = 0; i < iterations; i++) {
@@ -237,8 +368,9 @@ __global__ void layer_norm_backward2(const T* out_grad, T* X_vals, const T* gamm
 
 template <>
 __global__ void layer_norm_backward2(const __half* out_grad, __half* X_vals, const __half* gamma,
-                                     const __half* vars, const __half* means, __half* inp_grad,
-                                     int hidden_dim) {
+                                     const __half* beta, const __half* vars, const __half* means,
+                                     __half* inp_grad, int hidden_dim, bool relu,
+                                     FusedDropout dropout) {
   int row_stride = hidden_dim / 2;
   int iteration_stride = blockDim.x;
   int iterations = row_stride / iteration_stride;
@@ -265,21 +397,36 @@ __global__ void layer_norm_backward2(const __half* out_grad, __half* X_vals, con
   vals_hat_h += (row * row_stride);
 
   const half2* gamma_h = reinterpret_cast<const half2*>(gamma);
+  const half2* beta_h = reinterpret_cast<const half2*>(beta);
+  half mean_h = means[row];
+  half var_h = vars[row];
+  const float mean_f = __half2float(mean_h);
+  const float rstd_f = rsqrtf(__half2float(var_h));
+  const int64_t iteration = load_iteration(dropout);
+  const size_t row_offset = static_cast<size_t>(row) * hidden_dim;
+
   int high_index = iterations * iteration_stride + id;
+  if ((high_index) < row_stride) iterations++;
 #pragma unroll
   for (int i = 0; i < iterations; i++) {
-    half2 gamma_reg = gamma_h[i * iteration_stride + id];
-    vals_arr[i] = out_grad_h[i * iteration_stride + id];
+    int pos = i * iteration_stride + id;
+    half2 gamma_reg = gamma_h[pos];
+    vals_arr[i] = out_grad_h[pos];
+    if (relu || dropout.iteration) {
+      float2 grad = __half22float2(vals_arr[i]);
+      if (relu) {
+        float2 x = __half22float2(vals_hat_h[pos]);
+        float2 g = __half22float2(gamma_reg);
+        float2 b = __half22float2(beta_h[pos]);
+        if ((x.x - mean_f) * rstd_f * g.x + b.x <= 0.0f) grad.x = 0.0f;
+        if ((x.y - mean_f) * rstd_f * g.y + b.y <= 0.0f) grad.y = 0.0f;
+      }
+      grad.x *= fused_dropout_factor(dropout, iteration, row_offset + 2 * pos);
+      grad.y *= fused_dropout_factor(dropout, iteration, row_offset + 2 * pos + 1);
+      vals_arr[i] = __float22half2_rn(grad);
+    }
     vals_arr[i] *= gamma_reg;  // out_grad * gamma
   }
-  if ((high_index) < row_stride) {
-    half2 gamma_reg = gamma_h[high_index];
-    vals_arr[iterations] = out_grad_h[high_index];
-    vals_arr[iterations] *= gamma_reg;  // out_grad * gamma
-    iterations++;
-  }
-  half mean_h = means[row];
-  half var_h = vars[row];
   half2 var_reg = __halves2half2(var_h, var_h);
   half2 mean_reg = __halves2half2(mean_h, mean_h);
   half2 xu[MAX_NUM_STRIDE];
@@ -367,7 +514,9 @@ LayerNormLayer<T>::LayerNormLayer(const core23::Tensor& in_tensor, const core23:
                                   const Params& params,
                                   const std::shared_ptr<GPUResource>& gpu_resource,
                                   std::vector<Initializer_t> initializer_types)
-    : Base({in_tensor}, {out_tensor}, gpu_resource, initializer_types), params_(params) {
+    : Base({in_tensor}, {out_tensor}, gpu_resource, initializer_types),
+      params_(params),
+      dropout_seed_(gpu_resource->get_global_id()) {
   CudaDeviceContext context(this->get_device_id());
   const auto& in_tensor_dim = in_tensor.shape();
   const auto& out_tensor_dim = out_tensor.shape();
@@ -423,6 +572,26 @@ LayerNormLayer<T>::LayerNormLayer(const core23::Tensor& in_tensor, const core23:
                                         .shape(mean_dim)
                                         .device(device)
                                         .buffer_params(blobs_buffer_params));
+
+  if (params_.dropout_rate < 0.f || params_.dropout_rate >= 1.f) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "The fused dropout rate should be in [0, 1)");
+  }
+  if (params_.dropout_rate > 0.f) {
+    dropout_iteration_ = core23::Tensor(core23::TensorParams()
+                                            .data_type(core23::ScalarType::Int64)
+                                            .shape({1})
+                                            .device(device)
+                                            .buffer_params(blobs_buffer_params));
+  }
+}
+
+template <typename T>
+void LayerNormLayer<T>::initialize() {
+  if (params_.dropout_rate > 0.f) {
+    CudaDeviceContext context(this->get_device_id());
+    HCTR_LIB_THROW(cudaMemsetAsync(dropout_iteration_.data(), 0, dropout_iteration_.num_bytes(),
+                                   this->get_gpu().get_stream()));
+  }
 }
 
 template <typename T>
@@ -448,11 +617,32 @@ void LayerNormLayer<T>::fprop(bool is_train) {
   for (int64_t idx = 0; idx < in_tensor_dim.dims() - 1; idx++) {
     batch = batch * in_tensor_dim.size(idx);
   }
-  dim3 block_size(min(hidden_dim, static_cast<int64_t>(MAX_THREADS)), 1, 1);
+  // the stats are merged with full-warp shuffles, so the block is rounded up to whole warps
+  const bool vectorized = std::is_same<T, __half>::value && hidden_dim % 2 == 0;
+  const int64_t row_stride = vectorized ? hidden_dim / 2 : hidden_dim;
+  const int64_t block_threads = (row_stride + WARP_SIZE - 1) / WARP_SIZE * WARP_SIZE;
+  dim3 block_size(min(block_threads, static_cast<int64_t>(MAX_THREADS)), 1, 1);
   dim3 grid_size(batch, 1, 1);
+  const bool relu = params_.act == Activation_t::Relu;
+  FusedDropout dropout{params_.dropout_rate, 1.f / (1.f - params_.dropout_rate), dropout_seed_,
+                       nullptr};
+  if (is_train && params_.dropout_rate > 0.f) {
+    int64_t* iteration = dropout_iteration_.data<int64_t>();
+    next_iteration_kernel<<<1, 1, 0, this->get_gpu().get_stream()>>>(iteration);
+    dropout.iteration = iteration;
+  }
 
-  layer_norm_kernel<<<grid_size, block_size, 0, this->get_gpu().get_stream()>>>(
-      out, in, result_save_var, result_save_mean, gamma, beta, batch, hidden_dim, params_.eps);
+  if (vectorized) {
+    layer_norm_half2_kernel<<<grid_size, block_size, 0, this->get_gpu().get_stream()>>>(
+        reinterpret_cast<__half*>(out), reinterpret_cast<const __half*>(in),
+        reinterpret_cast<__half*>(result_save_var), reinterpret_cast<__half*>(result_save_mean),
+        reinterpret_cast<const __half*>(gamma), reinterpret_cast<const __half*>(beta), batch,
+        hidden_dim, params_.eps, relu, dropout);
+  } else {
+    layer_norm_kernel<<<grid_size, block_size, 0, this->get_gpu().get_stream()>>>(
+        out, in, result_save_var, result_save_mean, gamma, beta, batch, hidden_dim, params_.eps,
+        relu, dropout);
+  }
 }
 
 template <typename T>
@@ -469,6 +659,7 @@ void LayerNormLayer<T>::bprop() {
   T* out = out_tensor.data<T>();
 
   T* gamma = gamma_.data<T>();
+  T* beta = beta_.data<T>();
 
   T* gamma_grad = gamma_grad_.data<T>();
   T* beta_grad = beta_grad_.data<T>();
@@ -483,17 +674,23 @@ void LayerNormLayer<T>::bprop() {
     batch = batch * in_tensor_dim.size(idx);
   }
 
+  const bool relu = params_.act == Activation_t::Relu;
+  // bprop follows a training fprop, so the mask of its iteration is regenerated
+  const FusedDropout dropout{
+      params_.dropout_rate, 1.f / (1.f - params_.dropout_rate), dropout_seed_,
+      params_.dropout_rate > 0.f ? dropout_iteration_.data<int64_t>() : nullptr};
   dim3 grid_dim1(max(hidden_dim / TILE_DIM, static_cast<int64_t>(1)));
   dim3 block_dim1(TILE_DIM, TILE_DIM);
   layer_norm_backward1<<<grid_dim1, block_dim1, 0, this->get_gpu().get_stream()>>>(
-      out, in, result_save_var, result_save_mean, gamma_grad, beta_grad, batch, hidden_dim);
+      out, in, result_save_var, result_save_mean, gamma, beta, gamma_grad, beta_grad, batch,
+      hidden_dim, relu, dropout);
 
   dim3 grid_dim2(batch);
   int64_t blockDimx = hidden_dim < 32 ? hidden_dim : ((hidden_dim >> 5) << 5);
   dim3 block_dim2(min(blockDimx, static_cast<int64_t>(MAX_THREADS)));
 
   layer_norm_backward2<<<grid_dim2, block_dim2, 0, this->get_gpu().get_stream()>>>(
-      out, in, gamma, result_save_var, result_save_mean, in, hidden_dim);
+      out, in, gamma, beta, result_save_var, result_save_mean, in, hidden_dim, relu, dropout);
 }
 
 template <typename T>
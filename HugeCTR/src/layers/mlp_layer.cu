@@ -19,6 +19,12 @@
 
 namespace HugeCTR {
 
+namespace {
+
+constexpr int FP8_AMAX_HISTORY_LEN = 16;
+
+}  // namespace
+
 template class MLPLayer<float>;
 template class MLPLayer<__half>;
 
@@ -29,7 +35,8 @@ MLPLayer<T>::MLPLayer(const std::vector<core23::Tensor>& bottom_tensors,
                       const std::shared_ptr<GPUResource>& gpu_resource,
                       const std::vector<Activation_t>& acts, const std::vector<bool>& use_bias,
                       std::vector<Initializer_t> initializer_types, bool skip_head_dgrad,
-                      bool async_wgrad, bool fuse_wb, bool enable_tf32_compute)
+                      bool async_wgrad, bool fuse_wb, bool enable_tf32_compute,
+                      bool enable_fp8)
     : TrainableLayer<T>(bottom_tensors, top_tensors, gpu_resource, initializer_types),
       num_outputs_(num_outputs),
       acts_(acts),
@@ -38,7 +45,13 @@ MLPLayer<T>::MLPLayer(const std::vector<core23::Tensor>& bottom_tensors,
       async_wgrad_(async_wgrad),
       fuse_wb_(fuse_wb),
       enable_tf32_compute_(enable_tf32_compute),
+      enable_fp8_(enable_fp8),
       event_overlap_created_(false) {
+  if (enable_fp8_) {
+    HCTR_CHECK_HINT((std::is_same<T, __half>::value), "The fp8 MLP needs mixed precision");
+    HCTR_CHECK_HINT(gpu_resource->get_cc_major() * 10 + gpu_resource->get_cc_minor() >= 89,
+                    "The fp8 MLP needs a GPU of compute capability 8.9 or higher");
+  }
   int num_layers = num_outputs.size();
   train_tensors_.resize(num_layers);
   mask_tensors_.resize(num_layers);
@@ -46,6 +59,12 @@ MLPLayer<T>::MLPLayer(const std::vector<core23::Tensor>& bottom_tensors,
   dact_tensors_.resize(num_layers);
   layer_desc_.resize(num_layers);
   layer_algo_.resize(num_layers);
+  if (enable_fp8_) {
+    fp8_operand_tensors_.resize(num_layers);
+    fp8_scale_tensors_.resize(num_layers);
+    dgrad_tensors_.resize(num_layers);
+    fp8_buffers_.resize(num_layers);
+  }
 
   for (int i = 0; i < num_layers; i++) {
     const auto& bottom_tensor_dim =
@@ -73,6 +92,25 @@ MLPLayer<T>::MLPLayer(const std::vector<core23::Tensor>& bottom_tensors,
     buffer_params.channel = GetBlobsBufferChannel();
     core23::Device device(core23::DeviceType::GPU, gpu_resource->get_device_id());
 
+    if (enable_fp8_) {
+      HCTR_CHECK_HINT(batch_size % 16 == 0 && input_size % 16 == 0 && output_size % 16 == 0,
+                      "The fp8 MLP needs a batch size and layer sizes that are multiples of 16");
+      // The operands are multiples of 256 bytes, each of them stays aligned.
+      int64_t num_operand_bytes = batch_size * input_size + 2 * input_size * output_size +
+                                  batch_size * output_size;
+      fp8_operand_tensors_[i] = core23::Tensor(core23::TensorParams()
+                                                   .data_type(core23::ScalarType::UInt8)
+                                                   .shape({num_operand_bytes})
+                                                   .device(device)
+                                                   .buffer_params(buffer_params));
+      int64_t num_scale_elements = 3 * Fp8TensorScale::num_elements(FP8_AMAX_HISTORY_LEN);
+      fp8_scale_tensors_[i] = core23::Tensor(core23::TensorParams()
+                                                 .data_type(core23::ScalarType::Float)
+                                                 .shape({num_scale_elements})
+                                                 .device(device)
+                                                 .buffer_params(buffer_params));
+    }
+
     if (i != num_layers - 1) {
       core23::Shape shape({train_in_tensor.shape().size(0), num_output});
       auto data_type = core23::ToScalarType<T>::value;
@@ -80,7 +118,9 @@ MLPLayer<T>::MLPLayer(const std::vector<core23::Tensor>& bottom_tensors,
           core23::TensorParams().data_type(data_type).shape(shape).device(device).buffer_params(
               buffer_params));
       if (acts_[i] == Activation_t::Relu) {
-        mask_tensors_[i] = core23::Tensor(
+        // The fp8 fprop has no ReLU mask, the dReLU uses the activations.
+        auto& tensor = enable_fp8_ ? dgrad_tensors_[i] : mask_tensors_[i];
+        tensor = core23::Tensor(
             core23::TensorParams().data_type(data_type).shape(shape).device(device).buffer_params(
                 buffer_params));
         dact_tensors_[i] = core23::Tensor(
@@ -104,7 +144,7 @@ MLPLayer<T>::MLPLayer(const std::vector<core23::Tensor>& bottom_tensors,
       }
     }
 
-    output_mask_[i] = (acts_[i] == Activation_t::Relu) && (i != num_layers - 1);
+    output_mask_[i] = (acts_[i] == Activation_t::Relu) && (i != num_layers - 1) && !enable_fp8_;
   }
 }
 
@@ -112,13 +152,26 @@ template <typename T>
 void MLPLayer<T>::fprop(bool is_train) {
   CudaDeviceContext context(this->get_device_id());
   int num_layers = num_outputs_.size();
+  if (enable_fp8_ && is_train) {
+    fp8_step_++;
+  }
   for (int i = 0; i < num_layers; i++) {
     const T* kernel = kernels_[i].data<T>();
     const T* bottom =
         i == 0 ? this->input_tensors_[0].template data<T>() : train_tensors_[i - 1].data<T>();
     T* top_fprop = train_tensors_[i].data<T>();
-    layer_functors_.fprop(kernel, bottom, top_fprop, layer_desc_[i], layer_algo_[i],
-                          this->get_gpu().get_cublaslt_handle(), this->get_gpu().get_stream());
+    if (enable_fp8_) {
+      const auto& bottom_tensor_dim =
+          i == 0 ? this->input_tensors_[0].shape() : train_tensors_[i - 1].shape();
+      layer_functors_.fprop_fp8(kernel, bottom, top_fprop, fp8_buffers_[i],
+                                bottom_tensor_dim.size(0), bottom_tensor_dim.size(1),
+                                num_outputs_[i], fp8_step_, is_train, layer_desc_[i],
+                                layer_algo_[i], this->get_gpu().get_cublaslt_handle(),
+                                this->get_gpu().get_stream());
+    } else {
+      layer_functors_.fprop(kernel, bottom, top_fprop, layer_desc_[i], layer_algo_[i],
+                            this->get_gpu().get_cublaslt_handle(), this->get_gpu().get_stream());
+    }
     if (i == num_layers - 1 && acts_[i] == Activation_t::Relu) {
       T* mask_out = mask_tensors_[i].data<T>();
       int64_t len = train_tensors_[i].num_elements();
@@ -146,6 +199,11 @@ void MLPLayer<T>::bprop() {
     const T* mask_top = (i == num_layers - 1 && acts_[i] == Activation_t::Relu)
                             ? mask_tensors_[i].data<T>()
                             : nullptr;
+    // In fp8, the other ReLU layers get the raw gradient and are masked by their activations.
+    if (enable_fp8_ && i != num_layers - 1 && acts_[i] == Activation_t::Relu) {
+      mask_top = train_tensors_[i].data<T>();
+      train_top = dgrad_tensors_[i].data<T>();
+    }
 
     T* grad_top =
         acts_[i] == Activation_t::None ? train_tensors_[i].data<T>() : dact_tensors_[i].data<T>();
@@ -155,8 +213,12 @@ void MLPLayer<T>::bprop() {
     bool enable_async_wgrad = async_wgrad_;
     T* bottom_bprop = nullptr;
     if (i != 0) {
-      bottom_bprop = acts_[i - 1] == Activation_t::None ? train_tensors_[i - 1].data<T>()
-                                                        : dact_tensors_[i - 1].data<T>();
+      if (acts_[i - 1] == Activation_t::None) {
+        bottom_bprop = train_tensors_[i - 1].data<T>();
+      } else {
+        bottom_bprop =
+            enable_fp8_ ? dgrad_tensors_[i - 1].data<T>() : dact_tensors_[i - 1].data<T>();
+      }
     } else {
       if (this->input_tensors_.size() == 1) {
         // train_in_tensor
@@ -166,11 +228,21 @@ void MLPLayer<T>::bprop() {
         bottom_bprop = this->input_tensors_[1].template data<T>();
       }
     }
-    layer_functors_.bprop(kernel, bottom, train_top, mask_top, batch_size * top_size, grad_top,
-                          bottom_bprop, kernel_grad, layer_desc_[i], layer_algo_[i],
-                          this->get_gpu().get_cublaslt_handle(), this->get_gpu().get_stream(),
-                          this->get_gpu().get_comp_overlap_stream(), event_overlap_,
-                          enable_async_wgrad, i == 0 ? skip_head_dgrad_ : false);
+    if (enable_fp8_) {
+      layer_functors_.bprop_fp8(bottom, train_top, mask_top, batch_size * top_size, grad_top,
+                                bottom_bprop, kernel_grad, fp8_buffers_[i], batch_size, top_size,
+                                fp8_step_, layer_desc_[i], layer_algo_[i],
+                                this->get_gpu().get_cublaslt_handle(),
+                                this->get_gpu().get_stream(),
+                                this->get_gpu().get_comp_overlap_stream(), event_overlap_,
+                                enable_async_wgrad, i == 0 ? skip_head_dgrad_ : false);
+    } else {
+      layer_functors_.bprop(kernel, bottom, train_top, mask_top, batch_size * top_size, grad_top,
+                            bottom_bprop, kernel_grad, layer_desc_[i], layer_algo_[i],
+                            this->get_gpu().get_cublaslt_handle(), this->get_gpu().get_stream(),
+                            this->get_gpu().get_comp_overlap_stream(), event_overlap_,
+                            enable_async_wgrad, i == 0 ? skip_head_dgrad_ : false);
+    }
   }
 
   if (async_wgrad_) {
@@ -199,6 +271,37 @@ void MLPLayer<T>::initialize() {
       bias_ptr = biases_[i].data<T>();
     }
 
+    if (enable_fp8_) {
+      auto& fp8_buffers = fp8_buffers_[i];
+      uint8_t* operands = fp8_operand_tensors_[i].data<uint8_t>();
+      fp8_buffers.bottom = reinterpret_cast<__nv_fp8_e4m3*>(operands);
+      operands += batch_size * input_size;
+      fp8_buffers.kernel = reinterpret_cast<__nv_fp8_e4m3*>(operands);
+      operands += input_size * output_size;
+      fp8_buffers.kernel_t = reinterpret_cast<__nv_fp8_e4m3*>(operands);
+      operands += input_size * output_size;
+      fp8_buffers.grad_top = reinterpret_cast<__nv_fp8_e5m2*>(operands);
+
+      float* scales = fp8_scale_tensors_[i].data<float>();
+      const size_t scale_size = Fp8TensorScale::num_elements(FP8_AMAX_HISTORY_LEN);
+      Fp8TensorScale* tensor_scales[] = {&fp8_buffers.bottom_scale, &fp8_buffers.kernel_scale,
+                                         &fp8_buffers.grad_scale};
+      for (auto tensor_scale : tensor_scales) {
+        tensor_scale->set_buffer(scales, FP8_AMAX_HISTORY_LEN);
+        fp8_init_scale(*tensor_scale, this->get_gpu().get_stream());
+        scales += scale_size;
+      }
+
+      T* dbias_top_ptr = use_bias_[i] ? db_tensors_[i].data<T>() : nullptr;
+      layer_desc_[i].set_fp8_fprop_attr(bias_ptr, acts_[i], batch_size, input_size, output_size,
+                                        fp8_buffers);
+      layer_desc_[i].set_fp8_bprop_attr(dbias_top_ptr, batch_size, input_size, output_size,
+                                        fp8_buffers);
+      layer_algo_[i].set_fprop_algo(layer_desc_[i], this->get_gpu().get_cublaslt_handle());
+      layer_algo_[i].set_bprop_algo(layer_desc_[i], this->get_gpu().get_cublaslt_handle());
+      continue;
+    }
+
     T* mask_out_ptr = nullptr;
     bool output_mask = output_mask_[i];
     if (output_mask) {
@@ -236,6 +339,10 @@ void MLPLayer<T>::initialize() {
 
 template <typename T>
 void MLPLayer<T>::search_algorithm() {
+  // The fp8 GEMMs keep the algorithms of the cuBLASLt heuristic.
+  if (enable_fp8_) {
+    return;
+  }
   CudaDeviceContext context(this->get_device_id());
   int num_layers = num_outputs_.size();
   for (int i = 0; i < num_layers; i++) {
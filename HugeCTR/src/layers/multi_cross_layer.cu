@@ -83,11 +83,12 @@ __global__ void vector_fma3_align8(T* __restrict__ pout, const T* __restrict__ p
   if (gtid < len) pout[gtid] += pvec_a[gtid] * pvec_b[gtid];
 }
 // out0 = a * b
-// out1 += a * c
+// out1 = (accumulate ? out1 : 0) + a * c (+ a if add_a)
 template <typename T, int VecLen = 1, int SHT = 0>
 __global__ void vector_mul_fma3_align(T* __restrict__ pout0, T* __restrict__ pout1,
                                       const T* __restrict__ pvec_a, const T* __restrict__ pvec_b,
-                                      const T* __restrict__ pvec_c, const int len) {
+                                      const T* __restrict__ pvec_c, const int len,
+                                      const bool accumulate, const bool add_a) {
   const int gtid = (blockDim.x * blockIdx.x + threadIdx.x) << SHT;
   if (gtid >= len) {
     return;
@@ -107,13 +108,16 @@ __global__ void vector_mul_fma3_align(T* __restrict__ pout0, T* __restrict__ pou
     regA[i] = pA[i];
     regB[i] = pB[i];
     regC[i] = pC[i];
-    acc[i] = out1[i];
+    acc[i] = accumulate ? out1[i] : T(0.f);
   }
 // mul & fma
 #pragma unroll
   for (int i = 0; i < VecLen; i++) {
     mul[i] = regA[i] * regB[i];
     acc[i] += regA[i] * regC[i];
+    if (add_a) {
+      acc[i] += regA[i];
+    }
   }
 // store
 #pragma unroll
@@ -123,11 +127,12 @@ __global__ void vector_mul_fma3_align(T* __restrict__ pout0, T* __restrict__ pou
   }
 }
 // out0 = a * b
-// out1 += a * c
+// out1 = (accumulate ? out1 : 0) + a * c (+ a if add_a)
 template <>
 __global__ void vector_mul_fma3_align<__half, 8, 3>(
     __half* __restrict__ pout0, __half* __restrict__ pout1, const __half* __restrict__ pvec_a,
-    const __half* __restrict__ pvec_b, const __half* __restrict__ pvec_c, const int len) {
+    const __half* __restrict__ pvec_b, const __half* __restrict__ pvec_c, const int len,
+    const bool accumulate, const bool add_a) {
   const int start = (blockDim.x * blockIdx.x + threadIdx.x) << 3;
   if (start >= len) {
     return;
@@ -142,7 +147,8 @@ __global__ void vector_mul_fma3_align<__half, 8, 3>(
     a_8 = *reinterpret_cast<const float4*>(pvec_a + gtid);
     b_8 = *reinterpret_cast<const float4*>(pvec_b + gtid);
     c_8 = *reinterpret_cast<const float4*>(pvec_c + gtid);
-    acc_8 = *reinterpret_cast<const float4*>(pout1 + gtid);
+    acc_8 = accumulate ? *reinterpret_cast<const float4*>(pout1 + gtid)
+                       : make_float4(0.f, 0.f, 0.f, 0.f);
     // mul
     out0[0] = __hmul2(*reinterpret_cast<half2*>(&a_8.x), *reinterpret_cast<half2*>(&b_8.x));
     out0[1] = __hmul2(*reinterpret_cast<half2*>(&a_8.y), *reinterpret_cast<half2*>(&b_8.y));
@@ -158,6 +164,12 @@ __global__ void vector_mul_fma3_align<__half, 8, 3>(
                       *reinterpret_cast<half2*>(&acc_8.z));
     out1[3] = __hfma2(*reinterpret_cast<half2*>(&a_8.w), *reinterpret_cast<half2*>(&c_8.w),
                       *reinterpret_cast<half2*>(&acc_8.w));
+    if (add_a) {
+      out1[0] = __hadd2(out1[0], *reinterpret_cast<half2*>(&a_8.x));
+      out1[1] = __hadd2(out1[1], *reinterpret_cast<half2*>(&a_8.y));
+      out1[2] = __hadd2(out1[2], *reinterpret_cast<half2*>(&a_8.z));
+      out1[3] = __hadd2(out1[3], *reinterpret_cast<half2*>(&a_8.w));
+    }
     // store
     *out1_ptr = out1;
   }
@@ -218,6 +230,25 @@ __global__ void vector_fma3_align8(__half* __restrict__ pout, const __half* __re
   // store
   *out_ptr = d_8;
 }
+/**
+ * One DCNv1 cross layer after its gemv: out = x0 .* h + x + b
+ * @param out: hxw
+ * @param x0, x: hxw
+ * @param h: hx1
+ * @param bias: 1xw
+ */
+template <typename T>
+__global__ void cross_layer_output_kernel(T* __restrict__ out, const T* __restrict__ x0,
+                                          const T* __restrict__ x, const T* __restrict__ h,
+                                          const T* __restrict__ bias, int rows, int cols) {
+  const int len = rows * cols;
+  for (int tid = blockDim.x * blockIdx.x + threadIdx.x; tid < len;
+       tid += blockDim.x * gridDim.x) {
+    const int row = tid / cols;
+    const int col = tid - row * cols;
+    out[tid] = x0[tid] * h[row] + x[tid] + bias[col];
+  }
+}
 /**
  * compute dot product for each pair of the rows in the two matrix,
  */
@@ -348,24 +379,20 @@ void row_scaling(core23::Tensor& o_mat, const core23::Tensor& mat, const core23:
       pout, pmat, pvec, h, w, false, true, [] __device__(T a, T b) { return a * b; }, stream);
 }
 
+// out = x0 .* h + x + bias, see cross_layer_output_kernel
 template <typename T>
-void matrix_vec_add(core23::Tensor& o_mat, const core23::Tensor& mat, const core23::Tensor& vec,
-                    cudaStream_t stream) {
-  T* pout = o_mat.data<T>();
-  const T* pmat = mat.data<T>();
-  const T* pvec = vec.data<T>();
-
-  const auto& dim = o_mat.shape();
-  const auto& idim = mat.shape();
-  assert(dim.dims() == 2 && idim.dims() == 2 && dim.size(1) == vec.shape().size(1) &&
-         vec.shape().size(0) == 1);
-  assert(idim.size(0) == dim.size(0) && idim.size(1) == dim.size(1));
-
-  const int h = dim.size(0);
-  const int w = dim.size(1);
+void cross_layer_output(core23::Tensor& out, const core23::Tensor& x0, const core23::Tensor& x,
+                        const core23::Tensor& h, const core23::Tensor& bias, cudaStream_t stream) {
+  const auto& dim = out.shape();
+  assert(dim.dims() == 2 && x0.shape() == dim && x.shape() == dim &&
+         h.shape().size(0) == dim.size(0) && bias.shape().size(1) == dim.size(1));
 
-  MLCommon::LinAlg::matrixVectorOp(
-      pout, pmat, pvec, h, w, false, false, [] __device__(T a, T b) { return a + b; }, stream);
+  const int h_dim = dim.size(0);
+  const int w_dim = dim.size(1);
+  const int BLOCK_DIM = 256;
+  const int GRID_DIM = calc_grid(h_dim * w_dim, BLOCK_DIM);
+  cross_layer_output_kernel<<<GRID_DIM, BLOCK_DIM, 0, stream>>>(
+      out.data<T>(), x0.data<T>(), x.data<T>(), h.data<T>(), bias.data<T>(), h_dim, w_dim);
 }
 
 template <typename T>
@@ -390,7 +417,8 @@ void matrix_add(core23::Tensor& out_mat, const core23::Tensor& mat_a, const core
 
 template <typename T>
 void fused_mul_fma3(core23::Tensor& Y0, core23::Tensor& Y1, const core23::Tensor& A,
-                    const core23::Tensor& B, const core23::Tensor& C, cudaStream_t stream) {
+                    const core23::Tensor& B, const core23::Tensor& C, bool accumulate, bool add_a,
+                    cudaStream_t stream) {
   const T* pmat_a = A.data<T>();
   const T* pmat_b = B.data<T>();
   const T* pmat_c = C.data<T>();
@@ -416,10 +444,12 @@ void fused_mul_fma3(core23::Tensor& Y0, core23::Tensor& Y1, const core23::Tensor
   if (len % 8 == 0 && std::is_same<T, __half>::value) {
     GRID_DIM = (len / 8 + BLOCK_DIM - 1) / BLOCK_DIM;
     vector_mul_fma3_align<T, 8, 3>
-        <<<GRID_DIM, BLOCK_DIM, 0, stream>>>(pmat_o0, pmat_o1, pmat_a, pmat_b, pmat_c, len);
+        <<<GRID_DIM, BLOCK_DIM, 0, stream>>>(pmat_o0, pmat_o1, pmat_a, pmat_b, pmat_c, len,
+                                             accumulate, add_a);
   } else {
     vector_mul_fma3_align<T>
-        <<<GRID_DIM, BLOCK_DIM, 0, stream>>>(pmat_o0, pmat_o1, pmat_a, pmat_b, pmat_c, len);
+        <<<GRID_DIM, BLOCK_DIM, 0, stream>>>(pmat_o0, pmat_o1, pmat_a, pmat_b, pmat_c, len,
+                                             accumulate, add_a);
   }
 }
 // perform out_mat = mat_a * mat_b + mat_c
@@ -592,10 +622,9 @@ void MultiCrossForwardFunctor<T>::operator()(cudaStream_t stream, cublasHandle_t
     // layer_hidden_tensors[i] is a row vector
     matrix_vec_mul<T>(layer_hidden_tensors[i], i == 0 ? input_tensor : layer_output_tensors[i - 1],
                       kernel_tensors[i], cublas_handle, stream);
-    row_scaling<T>(layer_output_tensors[i], input_tensor, layer_hidden_tensors[i], stream);
-    matrix_add<T>(layer_output_tensors[i], layer_output_tensors[i],
-                  i == 0 ? input_tensor : layer_output_tensors[i - 1], stream);
-    matrix_vec_add<T>(layer_output_tensors[i], layer_output_tensors[i], bias_tensors[i], stream);
+    cross_layer_output<T>(layer_output_tensors[i], input_tensor,
+                          i == 0 ? input_tensor : layer_output_tensors[i - 1],
+                          layer_hidden_tensors[i], bias_tensors[i], stream);
   }
 }
 
@@ -739,7 +768,7 @@ void MultiCrossBackwardFunctorv2<T>::operator()(
     const std::vector<core23::Tensor>& layer_hidden_tensors,
     std::vector<core23::Tensor>& kernel_output_tensors, std::vector<core23::Tensor>& grad_tensors,
     std::vector<core23::Tensor>& bias_output_tensors, std::vector<core23::Tensor>& XU_tensors,
-    core23::Tensor accum_dx_tensor_, std::vector<core23::Tensor> bprop_bottoms, int num_layers,
+    core23::Tensor& accum_dx_tensor, std::vector<core23::Tensor>& bprop_bottoms, int num_layers,
     const std::vector<CublasDesc<T>>& xu_descr_, const std::vector<CublasDesc<T>>& xuvb_descr_,
     const std::vector<CublasDesc<T>>& du_descrs_bprop_,
     const std::vector<CublasDesc<T>>& dhidden_descrs_bprop_,
@@ -747,7 +776,6 @@ void MultiCrossBackwardFunctorv2<T>::operator()(
     const std::vector<CublasAlgo<T>>& xuvb_bprop_algo_,
     const std::vector<CublasAlgo<T>>& du_bprop_algos_,
     const std::vector<CublasAlgo<T>>& dhidden_bprop_algos_, cublasLtHandle_t cublaslt_handle) {
-  cudaMemsetAsync(accum_dx_tensor_.data(), 0, accum_dx_tensor_.num_bytes(), dgrad_stream);
   auto batchsize = input_tensor.shape()[0];
   auto projection_dim = kernel_tensors[0].shape()[1];
   auto vec_length = input_tensor.shape()[1];
@@ -757,8 +785,10 @@ void MultiCrossBackwardFunctorv2<T>::operator()(
   for (int i = num_layers - 1; i >= 0; i--) {
     // S0 = dY_i .* X , shape: (batchsize, w)
     // dX += dY_i .* H , shape: (batchsize, w)
-    fused_mul_fma3<T>(bprop_bottoms[2 * i], accum_dx_tensor_, grad_tensors[i + 1], input_tensor,
-                      layer_hidden_tensors[i], dgrad_stream);
+    // The top layer initializes dX and the bottom one adds the residual gradient dY_0 to it, so
+    // that the last dgrad GEMM produces the input gradient without a memset and a final add.
+    fused_mul_fma3<T>(bprop_bottoms[2 * i], accum_dx_tensor, grad_tensors[i + 1], input_tensor,
+                      layer_hidden_tensors[i], i != num_layers - 1, i == 0, dgrad_stream);
 
     {
       if (async_wgrad) {
@@ -795,16 +825,16 @@ void MultiCrossBackwardFunctorv2<T>::operator()(
       }
 
       // 4 dY_{i-1} = S1 * U^T + dY_{i} shape: (batchsize, w)
+      // dX = S1 * U^T + (dX + dY_0) for the bottom layer
       mat_a = bprop_bottoms[1 + 2 * i].data<T>();
       mat_b = kernel_tensors[i * 2].data<T>();
-      mat_c = grad_tensors[i + 1].data<T>();
+      mat_c = i == 0 ? accum_dx_tensor.data<T>() : grad_tensors[i + 1].data<T>();
       T* mat_d = grad_tensors[i].data<T>();
       // gemm: mat_d = mat_a * mat_b + mat_c
       this->gemm_functor_(1.0f, mat_a, mat_b, 1.0f, mat_c, mat_d, dhidden_descrs_bprop_[i],
                           dhidden_bprop_algos_[i], cublaslt_handle, dgrad_stream);
     }
   }
-  matrix_add<T>(grad_tensors[0], accum_dx_tensor_, grad_tensors[0], dgrad_stream);
   if (async_wgrad) {
     HCTR_LIB_THROW(cudaEventRecord(event_overlap, wgrad_stream));
     HCTR_LIB_THROW(cudaStreamWaitEvent(dgrad_stream, event_overlap));
@@ -904,6 +934,16 @@ MultiCrossLayer<T>::MultiCrossLayer(const std::vector<core23::Tensor>& in_tensor
       }
     }
 
+    const int num_params = this->projection_dim_ ? 3 : 2;
+    for (int i = 0; i < num_layers; i++) {
+      for (int j = 0; j < num_params - 1; j++) {
+        kernel_tensors_.push_back(this->get_weight(num_params * i + j));
+        kernel_grad_tensors_.push_back(this->get_wgrad(num_params * i + j));
+      }
+      bias_tensors_.push_back(this->get_weight(num_params * i + num_params - 1));
+      bias_grad_tensors_.push_back(this->get_wgrad(num_params * i + num_params - 1));
+    }
+
     in_tensors_ = in_tensors;
     out_tensors_ = out_tensors;
     // setup blobs
@@ -927,6 +967,7 @@ MultiCrossLayer<T>::MultiCrossLayer(const std::vector<core23::Tensor>& in_tensor
     }
     // output
     activation_tensors_.push_back(out_tensor);
+    output_tensors_.assign(activation_tensors_.begin() + 1, activation_tensors_.end());
     accum_dx_tensor_ = core23::Tensor(core23::TensorParams()
                                           .data_type(core23::ToScalarType<T>::value)
                                           .shape(blob_dim)
@@ -1023,37 +1064,16 @@ MultiCrossLayer<T>::MultiCrossLayer(const std::vector<core23::Tensor>& in_tensor
 template <typename T>
 void MultiCrossLayer<T>::fprop(bool is_train) {
   CudaDeviceContext context(this->get_device_id());
-  std::vector<core23::Tensor> kernel_tensors;
-  std::vector<core23::Tensor> bias_tensors;
-  std::vector<core23::Tensor> output_tensors;
-  std::vector<core23::Tensor> hidden_tensors;
-
-  if (this->projection_dim_) {
-    for (int i = 0; i < num_layers_; i++) {
-      kernel_tensors.push_back(this->get_weight(3 * i));
-      kernel_tensors.push_back(this->get_weight(3 * i + 1));
-      bias_tensors.push_back(this->get_weight(3 * i + 2));
-    }
-  } else {
-    for (int i = 0; i < num_layers_; i++) {
-      kernel_tensors.push_back(this->get_weight(2 * i));
-      bias_tensors.push_back(this->get_weight(2 * i + 1));
-    }
-  }
-  for (int i = 0; i < num_layers_; i++) {
-    output_tensors.push_back(activation_tensors_[i + 1]);
-    hidden_tensors.push_back(hidden_tensors_[i]);
-  }
   if (this->projection_dim_ == 0) {
     // dcn v1
     MultiCrossForwardFunctor<T>()(this->get_gpu().get_stream(), this->get_gpu().get_cublas_handle(),
-                                  activation_tensors_[0], kernel_tensors, bias_tensors,
-                                  output_tensors, hidden_tensors, num_layers_);
+                                  activation_tensors_[0], kernel_tensors_, bias_tensors_,
+                                  output_tensors_, hidden_tensors_, num_layers_);
   } else {
     // dcn v2
     this->dcnv2_forward_functor_(this->get_gpu().get_stream(), activation_tensors_[0],
-                                 kernel_tensors, bias_tensors, XU_tensors_, output_tensors,
-                                 hidden_tensors, num_layers_, xu_descrs_fprop_, xuvb_descrs_fprop_,
+                                 kernel_tensors_, bias_tensors_, XU_tensors_, output_tensors_,
+                                 hidden_tensors_, num_layers_, xu_descrs_fprop_, xuvb_descrs_fprop_,
                                  xu_fprop_algos_, xuvb_fprop_algos_,
                                  this->get_gpu().get_cublaslt_handle());
   }
@@ -1062,52 +1082,19 @@ void MultiCrossLayer<T>::fprop(bool is_train) {
 template <typename T>
 void MultiCrossLayer<T>::bprop() {
   CudaDeviceContext context(this->get_device_id());
-  std::vector<core23::Tensor> kernel_tensors;
-  std::vector<core23::Tensor> kernel_output_tensors;
-  std::vector<core23::Tensor> bias_output_tensors;
-  std::vector<core23::Tensor> forward_output_tensors;
-  std::vector<core23::Tensor> forward_hidden_tensors;
-  // dcnv2
-  if (this->projection_dim_) {
-    for (int i = 0; i < num_layers_; i++) {
-      // U
-      kernel_tensors.push_back(this->get_weight(3 * i));
-      // V
-      kernel_tensors.push_back(this->get_weight(3 * i + 1));
-      // dU
-      kernel_output_tensors.push_back(this->get_wgrad(3 * i));
-      // dV
-      kernel_output_tensors.push_back(this->get_wgrad(3 * i + 1));
-      // db
-      bias_output_tensors.push_back(this->get_wgrad(3 * i + 2));
-      // intermediate output
-      forward_hidden_tensors.push_back(hidden_tensors_[i]);
-    }
-  } else {
-    for (int i = 0; i < num_layers_; i++) {
-      kernel_tensors.push_back(this->get_weight(2 * i));
-      kernel_output_tensors.push_back(this->get_wgrad(2 * i));
-      bias_output_tensors.push_back(this->get_wgrad(2 * i + 1));
-      forward_hidden_tensors.push_back(hidden_tensors_[i]);
-    }
-  }
-
-  for (int i = 0; i < num_layers_ - 1; i++) {
-    forward_output_tensors.push_back(activation_tensors_[i + 1]);
-  }
   if (this->projection_dim_ == 0) {
     // dcn v1
     MultiCrossBackwardFunctor<T>()(this->get_gpu().get_stream(), activation_tensors_[0],
-                                   kernel_tensors, forward_output_tensors, forward_hidden_tensors,
+                                   kernel_tensors_, output_tensors_, hidden_tensors_,
                                    activation_tensors_[num_layers_], activation_tensors_[0],
-                                   kernel_output_tensors, bias_output_tensors, tmp_vec_tensor_,
+                                   kernel_grad_tensors_, bias_grad_tensors_, tmp_vec_tensor_,
                                    tmp_mat_tensors_, num_layers_);
   } else {
     // dcn v2
     this->dcnv2_backward_functor_(
         this->get_gpu().get_stream(), this->wgrad_stream_, this->async_wgrad_, this->event_fork_,
-        activation_tensors_[0], kernel_tensors, forward_output_tensors, forward_hidden_tensors,
-        kernel_output_tensors, this->dgrads_, bias_output_tensors, this->XU_tensors_,
+        activation_tensors_[0], kernel_tensors_, output_tensors_, hidden_tensors_,
+        kernel_grad_tensors_, this->dgrads_, bias_grad_tensors_, this->XU_tensors_,
         accum_dx_tensor_, bprop_bottom_, num_layers_, xu_descrs_bprop_, xuvb_descrs_bprop_,
         du_descrs_bprop_, dhidden_descrs_bprop_, xu_bprop_algos_, xuvb_bprop_algos_,
         du_bprop_algos_, dhidden_bprop_algos_, this->get_gpu().get_cublaslt_handle());
@@ -154,17 +154,425 @@ __global__ void transpose_V(T* v_buf, const T* V, const int batch_size, const in
   float input_V = V[d0 * d0_stride + d1 * d1_stride + d2 * d2_stride + d3];
   v_buf[d0 * d0_out_stride + d1 * d1_out_stride + d2 * d2_out_stride + d3] = input_V;
 }
+namespace {
+
+// Tiling of the fused attention. A block has kFusedWarps warps, Q, K, V and the output are read
+// in their [batch_size, seq_len, head_num * size_per_head] layout, so no transpose is needed.
+constexpr int kFusedWarps = 4;
+constexpr int kFusedThreads = kFusedWarps * 32;
+constexpr int kFusedKeyTile = 32;     // a key per lane
+constexpr int kFpropQueryTile = 16;   // 4 query rows per warp
+constexpr int kBpropQueryTile = 8;    // 2 query rows per warp in the dQ kernel
+constexpr int kBpropKeyTile = 16;     // 4 keys per warp in the dK, dV kernel
+constexpr int kBpropRowTile = 16;     // rows of Q, dO staged at once in the dK, dV kernel
+constexpr float kMaskValue = 10000.0f;  // same as MaskedSoftmaxLayer
+
+// mask is [batch_size, 1, seq_from, seq_to], 1 keeps the score
+template <typename T>
+__device__ __forceinline__ float attention_mask(const T* mask, int b, int row, int key,
+                                                int seq_from, int seq_to) {
+  if (mask == nullptr) {
+    return 0.0f;
+  }
+  const int64_t offset = (static_cast<int64_t>(b) * seq_from + row) * seq_to + key;
+  const float mask_val = static_cast<float>(mask[offset]);
+  return (1.0f - mask_val) * kMaskValue;
+}
+
+template <typename T, int ROW_PITCH>
+__device__ __forceinline__ void load_head_tile(float (*tile)[ROW_PITCH], const T* in, int b, int h,
+                                               int row_begin, int num_rows, int seq_len,
+                                               int head_num, int size_per_head, int head_dim) {
+  const int hidden_dim = head_num * size_per_head;
+  for (int idx = threadIdx.x; idx < num_rows * head_dim; idx += blockDim.x) {
+    const int r = idx / head_dim;
+    const int d = idx % head_dim;
+    const int row = row_begin + r;
+    const int64_t offset =
+        (static_cast<int64_t>(b) * seq_len + row) * hidden_dim + h * size_per_head + d;
+    tile[r][d] = (row < seq_len && d < size_per_head) ? static_cast<float>(in[offset]) : 0.0f;
+  }
+}
+
+// grid = (ceil(seq_from / kFpropQueryTile), batch_size * head_num), block = kFusedThreads
+// HEAD_DIM is size_per_head rounded up to a multiple of 32, lane owns dims lane + 32 * i
+template <typename T, int HEAD_DIM>
+__global__ void fused_attention_fprop_kernel(T* out, float* lse, const T* query, const T* key,
+                                             const T* value, const T* mask, int head_num,
+                                             int seq_from, int seq_to, int size_per_head,
+                                             float scale) {
+  constexpr int DIMS_PER_LANE = HEAD_DIM / 32;
+  constexpr int ROWS_PER_WARP = kFpropQueryTile / kFusedWarps;
+  __shared__ float s_query[kFpropQueryTile][HEAD_DIM];
+  __shared__ float s_key[kFusedKeyTile][HEAD_DIM + 1];  // padded, a lane reads a row
+  __shared__ float s_value[kFusedKeyTile][HEAD_DIM];
+
+  const int b = blockIdx.y / head_num;
+  const int h = blockIdx.y % head_num;
+  const int warp = threadIdx.x / 32;
+  const int lane = threadIdx.x % 32;
+  const int row_begin = blockIdx.x * kFpropQueryTile;
+
+  load_head_tile(s_query, query, b, h, row_begin, kFpropQueryTile, seq_from, head_num,
+                 size_per_head, HEAD_DIM);
+
+  float row_max[ROWS_PER_WARP];
+  float row_sum[ROWS_PER_WARP];
+  float acc[ROWS_PER_WARP][DIMS_PER_LANE];
+#pragma unroll
+  for (int r = 0; r < ROWS_PER_WARP; r++) {
+    row_max[r] = -INFINITY;
+    row_sum[r] = 0.0f;
+#pragma unroll
+    for (int i = 0; i < DIMS_PER_LANE; i++) {
+      acc[r][i] = 0.0f;
+    }
+  }
+
+  for (int key_begin = 0; key_begin < seq_to; key_begin += kFusedKeyTile) {
+    __syncthreads();
+    load_head_tile(s_key, key, b, h, key_begin, kFusedKeyTile, seq_to, head_num, size_per_head,
+                   HEAD_DIM);
+    load_head_tile(s_value, value, b, h, key_begin, kFusedKeyTile, seq_to, head_num,
+                   size_per_head, HEAD_DIM);
+    __syncthreads();
+
+    const int key_id = key_begin + lane;
+#pragma unroll
+    for (int r = 0; r < ROWS_PER_WARP; r++) {
+      const int local_row = warp * ROWS_PER_WARP + r;
+      const int row = row_begin + local_row;
+      float score = -INFINITY;
+      if (key_id < seq_to) {
+        float dot = 0.0f;
+#pragma unroll 8
+        for (int d = 0; d < HEAD_DIM; d++) {
+          dot += s_query[local_row][d] * s_key[lane][d];
+        }
+        score = dot * scale;
+        if (row < seq_from) {
+          score -= attention_mask(mask, b, row, key_id, seq_from, seq_to);
+        }
+      }
+      // online softmax, rescale what was accumulated with the previous max
+      const float new_max = fmaxf(row_max[r], warpReduceMax(score));
+      const float p = __expf(score - new_max);
+      const float correction = __expf(row_max[r] - new_max);
+      row_sum[r] = row_sum[r] * correction + warpReduceSum(p);
+      row_max[r] = new_max;
+#pragma unroll
+      for (int i = 0; i < DIMS_PER_LANE; i++) {
+        acc[r][i] *= correction;
+      }
+      for (int j = 0; j < kFusedKeyTile; j++) {
+        const float p_j = __shfl_sync(0xffffffff, p, j);
+#pragma unroll
+        for (int i = 0; i < DIMS_PER_LANE; i++) {
+          acc[r][i] += p_j * s_value[j][lane + 32 * i];
+        }
+      }
+    }
+  }
+
+  const int hidden_dim = head_num * size_per_head;
+#pragma unroll
+  for (int r = 0; r < ROWS_PER_WARP; r++) {
+    const int row = row_begin + warp * ROWS_PER_WARP + r;
+    if (row >= seq_from) {
+      continue;
+    }
+    const float inv_sum = 1.0f / row_sum[r];
+#pragma unroll
+    for (int i = 0; i < DIMS_PER_LANE; i++) {
+      const int d = lane + 32 * i;
+      if (d < size_per_head) {
+        out[(static_cast<int64_t>(b) * seq_from + row) * hidden_dim + h * size_per_head + d] =
+            static_cast<T>(acc[r][i] * inv_sum);
+      }
+    }
+    if (lane == 0) {
+      lse[static_cast<int64_t>(blockIdx.y) * seq_from + row] = row_max[r] + logf(row_sum[r]);
+    }
+  }
+}
+
+// delta = rowsum(dO * O) of every (batch, head, row), a warp per row
+template <typename T>
+__global__ void fused_attention_delta_kernel(float* delta, const T* d_out, const T* out,
+                                             int batch_size, int head_num, int seq_from,
+                                             int size_per_head) {
+  const int64_t num_rows = static_cast<int64_t>(batch_size) * head_num * seq_from;
+  const int64_t warp_id = (static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x) / 32;
+  const int lane = threadIdx.x % 32;
+  if (warp_id >= num_rows) {
+    return;
+  }
+  // warp_id is ((b * head_num) + h) * seq_from + row
+  const int row = warp_id % seq_from;
+  const int64_t bh = warp_id / seq_from;
+  const int h = bh % head_num;
+  const int64_t b = bh / head_num;
+  const int64_t offset = (b * seq_from + row) * head_num * size_per_head + h * size_per_head;
+  float sum = 0.0f;
+  for (int d = lane; d < size_per_head; d += 32) {
+    sum += static_cast<float>(d_out[offset + d]) * static_cast<float>(out[offset + d]);
+  }
+  sum = warpReduceSum(sum);
+  if (lane == 0) {
+    delta[warp_id] = sum;
+  }
+}
+
+// dQ = scale * dS K, with dS = P * (dP - delta) and dP = dO V^T, P recomputed from lse.
+// grid = (ceil(seq_from / kBpropQueryTile), batch_size * head_num), block = kFusedThreads
+template <typename T, int HEAD_DIM>
+__global__ void fused_attention_dq_kernel(T* query_grad, const T* query, const T* key,
+                                          const T* value, const T* d_out, const T* mask,
+                                          const float* lse, const float* delta, int head_num,
+                                          int seq_from, int seq_to, int size_per_head,
+                                          float scale) {
+  constexpr int DIMS_PER_LANE = HEAD_DIM / 32;
+  constexpr int ROWS_PER_WARP = kBpropQueryTile / kFusedWarps;
+  __shared__ float s_query[kBpropQueryTile][HEAD_DIM];
+  __shared__ float s_d_out[kBpropQueryTile][HEAD_DIM];
+  __shared__ float s_key[kFusedKeyTile][HEAD_DIM + 1];
+  __shared__ float s_value[kFusedKeyTile][HEAD_DIM + 1];
+
+  const int b = blockIdx.y / head_num;
+  const int h = blockIdx.y % head_num;
+  const int warp = threadIdx.x / 32;
+  const int lane = threadIdx.x % 32;
+  const int row_begin = blockIdx.x * kBpropQueryTile;
+
+  load_head_tile(s_query, query, b, h, row_begin, kBpropQueryTile, seq_from, head_num,
+                 size_per_head, HEAD_DIM);
+  load_head_tile(s_d_out, d_out, b, h, row_begin, kBpropQueryTile, seq_from, head_num,
+                 size_per_head, HEAD_DIM);
+
+  float row_lse[ROWS_PER_WARP];
+  float row_delta[ROWS_PER_WARP];
+  float acc[ROWS_PER_WARP][DIMS_PER_LANE];
+#pragma unroll
+  for (int r = 0; r < ROWS_PER_WARP; r++) {
+    const int row = row_begin + warp * ROWS_PER_WARP + r;
+    const int64_t row_offset = static_cast<int64_t>(blockIdx.y) * seq_from + row;
+    row_lse[r] = row < seq_from ? lse[row_offset] : 0.0f;
+    row_delta[r] = row < seq_from ? delta[row_offset] : 0.0f;
+#pragma unroll
+    for (int i = 0; i < DIMS_PER_LANE; i++) {
+      acc[r][i] = 0.0f;
+    }
+  }
+
+  for (int key_begin = 0; key_begin < seq_to; key_begin += kFusedKeyTile) {
+    __syncthreads();
+    load_head_tile(s_key, key, b, h, key_begin, kFusedKeyTile, seq_to, head_num, size_per_head,
+                   HEAD_DIM);
+    load_head_tile(s_value, value, b, h, key_begin, kFusedKeyTile, seq_to, head_num,
+                   size_per_head, HEAD_DIM);
+    __syncthreads();
+
+    const int key_id = key_begin + lane;
+#pragma unroll
+    for (int r = 0; r < ROWS_PER_WARP; r++) {
+      const int local_row = warp * ROWS_PER_WARP + r;
+      const int row = row_begin + local_row;
+      float score_grad = 0.0f;
+      if (key_id < seq_to && row < seq_from) {
+        float dot = 0.0f;
+        float prob_grad = 0.0f;
+#pragma unroll 8
+        for (int d = 0; d < HEAD_DIM; d++) {
+          dot += s_query[local_row][d] * s_key[lane][d];
+          prob_grad += s_d_out[local_row][d] * s_value[lane][d];
+        }
+        const float score = dot * scale - attention_mask(mask, b, row, key_id, seq_from, seq_to);
+        const float p = __expf(score - row_lse[r]);
+        score_grad = p * (prob_grad - row_delta[r]);
+      }
+      for (int j = 0; j < kFusedKeyTile; j++) {
+        const float ds_j = __shfl_sync(0xffffffff, score_grad, j);
+#pragma unroll
+        for (int i = 0; i < DIMS_PER_LANE; i++) {
+          acc[r][i] += ds_j * s_key[j][lane + 32 * i];
+        }
+      }
+    }
+  }
+
+  const int hidden_dim = head_num * size_per_head;
+#pragma unroll
+  for (int r = 0; r < ROWS_PER_WARP; r++) {
+    const int row = row_begin + warp * ROWS_PER_WARP + r;
+    if (row >= seq_from) {
+      continue;
+    }
+#pragma unroll
+    for (int i = 0; i < DIMS_PER_LANE; i++) {
+      const int d = lane + 32 * i;
+      if (d < size_per_head) {
+        query_grad[(static_cast<int64_t>(b) * seq_from + row) * hidden_dim + h * size_per_head +
+                   d] = static_cast<T>(acc[r][i] * scale);
+      }
+    }
+  }
+}
+
+// dV = P^T dO, dK = scale * dS^T Q. A warp owns kBpropKeyTile / kFusedWarps keys and keeps them
+// and their gradients in registers while it walks over all the query rows.
+// grid = (ceil(seq_to / kBpropKeyTile), batch_size * head_num), block = kFusedThreads
+// key_grad, value_grad may alias key, value, a block only reads the rows it writes.
+template <typename T, int HEAD_DIM>
+__global__ void fused_attention_dkdv_kernel(T* key_grad, T* value_grad, const T* query,
+                                            const T* key, const T* value, const T* d_out,
+                                            const T* mask, const float* lse, const float* delta,
+                                            int head_num, int seq_from, int seq_to,
+                                            int size_per_head, float scale) {
+  constexpr int DIMS_PER_LANE = HEAD_DIM / 32;
+  constexpr int KEYS_PER_WARP = kBpropKeyTile / kFusedWarps;
+  __shared__ float s_query[kBpropRowTile][HEAD_DIM];
+  __shared__ float s_d_out[kBpropRowTile][HEAD_DIM];
+  __shared__ float s_lse[kBpropRowTile];
+  __shared__ float s_delta[kBpropRowTile];
+
+  const int b = blockIdx.y / head_num;
+  const int h = blockIdx.y % head_num;
+  const int warp = threadIdx.x / 32;
+  const int lane = threadIdx.x % 32;
+  const int key_begin = blockIdx.x * kBpropKeyTile + warp * KEYS_PER_WARP;
+  const int hidden_dim = head_num * size_per_head;
+
+  float key_reg[KEYS_PER_WARP][DIMS_PER_LANE];
+  float value_reg[KEYS_PER_WARP][DIMS_PER_LANE];
+  float key_acc[KEYS_PER_WARP][DIMS_PER_LANE];
+  float value_acc[KEYS_PER_WARP][DIMS_PER_LANE];
+#pragma unroll
+  for (int c = 0; c < KEYS_PER_WARP; c++) {
+    const int key_id = key_begin + c;
+#pragma unroll
+    for (int i = 0; i < DIMS_PER_LANE; i++) {
+      const int d = lane + 32 * i;
+      const int64_t offset =
+          (static_cast<int64_t>(b) * seq_to + key_id) * hidden_dim + h * size_per_head + d;
+      const bool valid = key_id < seq_to && d < size_per_head;
+      key_reg[c][i] = valid ? static_cast<float>(key[offset]) : 0.0f;
+      value_reg[c][i] = valid ? static_cast<float>(value[offset]) : 0.0f;
+      key_acc[c][i] = 0.0f;
+      value_acc[c][i] = 0.0f;
+    }
+  }
+
+  for (int row_begin = 0; row_begin < seq_from; row_begin += kBpropRowTile) {
+    __syncthreads();
+    load_head_tile(s_query, query, b, h, row_begin, kBpropRowTile, seq_from, head_num,
+                   size_per_head, HEAD_DIM);
+    load_head_tile(s_d_out, d_out, b, h, row_begin, kBpropRowTile, seq_from, head_num,
+                   size_per_head, HEAD_DIM);
+    if (threadIdx.x < kBpropRowTile && row_begin + threadIdx.x < seq_from) {
+      const int64_t row_offset = static_cast<int64_t>(blockIdx.y) * seq_from + row_begin +
+                                 threadIdx.x;
+      s_lse[threadIdx.x] = lse[row_offset];
+      s_delta[threadIdx.x] = delta[row_offset];
+    }
+    __syncthreads();
+
+    const int num_rows = min(kBpropRowTile, seq_from - row_begin);
+    for (int r = 0; r < num_rows; r++) {
+      const int row = row_begin + r;
+#pragma unroll
+      for (int c = 0; c < KEYS_PER_WARP; c++) {
+        float dot = 0.0f;
+        float prob_grad = 0.0f;
+#pragma unroll
+        for (int i = 0; i < DIMS_PER_LANE; i++) {
+          dot += s_query[r][lane + 32 * i] * key_reg[c][i];
+          prob_grad += s_d_out[r][lane + 32 * i] * value_reg[c][i];
+        }
+        dot = warpReduceSum(dot);
+        prob_grad = warpReduceSum(prob_grad);
+        const int key_id = key_begin + c;
+        float p = 0.0f;
+        if (key_id < seq_to) {
+          const float score =
+              dot * scale - attention_mask(mask, b, row, key_id, seq_from, seq_to);
+          p = __expf(score - s_lse[r]);
+        }
+        const float score_grad = p * (prob_grad - s_delta[r]);
+#pragma unroll
+        for (int i = 0; i < DIMS_PER_LANE; i++) {
+          value_acc[c][i] += p * s_d_out[r][lane + 32 * i];
+          key_acc[c][i] += score_grad * s_query[r][lane + 32 * i];
+        }
+      }
+    }
+  }
+
+#pragma unroll
+  for (int c = 0; c < KEYS_PER_WARP; c++) {
+    const int key_id = key_begin + c;
+    if (key_id >= seq_to) {
+      continue;
+    }
+#pragma unroll
+    for (int i = 0; i < DIMS_PER_LANE; i++) {
+      const int d = lane + 32 * i;
+      if (d < size_per_head) {
+        const int64_t offset =
+            (static_cast<int64_t>(b) * seq_to + key_id) * hidden_dim + h * size_per_head + d;
+        key_grad[offset] = static_cast<T>(key_acc[c][i] * scale);
+        value_grad[offset] = static_cast<T>(value_acc[c][i]);
+      }
+    }
+  }
+}
+
+template <typename T, int HEAD_DIM>
+void fused_attention_fprop(T* out, float* lse, const T* query, const T* key, const T* value,
+                           const T* mask, int batch_size, int head_num, int seq_from, int seq_to,
+                           int size_per_head, cudaStream_t stream) {
+  const float scale = 1.0f / sqrtf(static_cast<float>(size_per_head));
+  dim3 grid((seq_from + kFpropQueryTile - 1) / kFpropQueryTile, batch_size * head_num);
+  fused_attention_fprop_kernel<T, HEAD_DIM><<<grid, kFusedThreads, 0, stream>>>(
+      out, lse, query, key, value, mask, head_num, seq_from, seq_to, size_per_head, scale);
+}
+
+// The query, key and value gradients are written in place of query, key and value, so dQ, which
+// needs the original keys and values, runs first and dK, dV read the saved query_copy.
+template <typename T, int HEAD_DIM>
+void fused_attention_bprop(T* query, T* key, T* value, const T* query_copy, const T* d_out,
+                           const T* out, const T* mask, const float* lse, float* delta,
+                           int batch_size, int head_num, int seq_from, int seq_to,
+                           int size_per_head, cudaStream_t stream) {
+  const float scale = 1.0f / sqrtf(static_cast<float>(size_per_head));
+  const int64_t num_rows = static_cast<int64_t>(batch_size) * head_num * seq_from;
+  const int rows_per_block = kFusedThreads / 32;
+  const int delta_blocks = (num_rows + rows_per_block - 1) / rows_per_block;
+  fused_attention_delta_kernel<<<delta_blocks, kFusedThreads, 0, stream>>>(
+      delta, d_out, out, batch_size, head_num, seq_from, size_per_head);
+  dim3 dq_grid((seq_from + kBpropQueryTile - 1) / kBpropQueryTile, batch_size * head_num);
+  fused_attention_dq_kernel<T, HEAD_DIM><<<dq_grid, kFusedThreads, 0, stream>>>(
+      query, query_copy, key, value, d_out, mask, lse, delta, head_num, seq_from, seq_to,
+      size_per_head, scale);
+  dim3 dkdv_grid((seq_to + kBpropKeyTile - 1) / kBpropKeyTile, batch_size * head_num);
+  fused_attention_dkdv_kernel<T, HEAD_DIM><<<dkdv_grid, kFusedThreads, 0, stream>>>(
+      key, value, query_copy, key, value, d_out, mask, lse, delta, head_num, seq_from, seq_to,
+      size_per_head, scale);
+}
+
+}  // namespace
+
 // input is q, k, v, mask
 template <typename T>
 MultiHeadAttentionLayer<T>::MultiHeadAttentionLayer(
     const std::vector<core23::Tensor>& input_tensors, std::vector<core23::Tensor>& output_tensors,
     int num_attention_heads, bool transpose_b, const std::shared_ptr<GPUResource>& gpu_resource,
-    bool use_mixed_precision, bool enable_tf32_compute)
+    bool use_mixed_precision, bool enable_tf32_compute, bool fused_attention)
     : Layer(input_tensors, {}, gpu_resource),
       use_mixed_precision_(use_mixed_precision),
       enable_tf32_compute_(enable_tf32_compute),
       num_(input_tensors_.size()),
-      dims_(input_tensors_[0].dims()) {
+      dims_(input_tensors_[0].dims()),
+      fused_attention_(fused_attention) {
   try {
     // k always is the gemm K
     int64_t m = 0, k = 0, h = 0, b = 0, size_per_head = 0;
@@ -213,6 +621,24 @@ MultiHeadAttentionLayer<T>::MultiHeadAttentionLayer(
     core23::Shape score_shape = {b, h, m, k};
     core23::Shape from_shape = {b, h, m, size_per_head};
     core23::Shape to_shape = {b, h, k, size_per_head};
+    if (fused_attention_) {
+      HCTR_CHECK_HINT(size_per_head <= 128,
+                      "Fused attention supports up to 128 hidden units per head");
+      if (input_tensors.size() == 4) {
+        HCTR_CHECK_HINT(input_tensors[3].num_elements() == b * m * k,
+                        "The mask should be [batch_size, 1, seq_from, seq_to]");
+      }
+      output_tensors.emplace_back(common_tensor_params.shape({b, m, size_per_head * h}));
+      output_tensors_ = output_tensors;
+      // copies of the query and of the output, both are overwritten before the backward
+      query_buf_tensor_ = core23::Tensor(common_tensor_params.shape(q_shape));
+      attention_out_4d_ = core23::Tensor(common_tensor_params.shape(q_shape));
+      auto stats_params =
+          common_tensor_params.data_type(core23::ScalarType::Float).shape({b, h, m});
+      softmax_lse_tensor_ = core23::Tensor(stats_params);
+      softmax_delta_tensor_ = core23::Tensor(stats_params);
+      return;
+    }
     attention_score_4d_ = core23::Tensor(common_tensor_params.shape(score_shape));
     attention_softmax_4d_ = core23::Tensor(common_tensor_params.shape(score_shape));
     attention_out_4d_ = core23::Tensor(common_tensor_params.shape(from_shape));
@@ -245,6 +671,10 @@ MultiHeadAttentionLayer<T>::MultiHeadAttentionLayer(
 
 template <typename T>
 void MultiHeadAttentionLayer<T>::fprop(bool is_train) {
+  if (fused_attention_) {
+    fused_fprop(is_train);
+    return;
+  }
   CudaDeviceContext context(get_device_id());
   T* query = input_tensors_[0].data<T>();
   T* key = input_tensors_[1].data<T>();
@@ -373,6 +803,10 @@ void MultiHeadAttentionLayer<T>::fprop(bool is_train) {
 
 template <typename T>
 void MultiHeadAttentionLayer<T>::bprop() {
+  if (fused_attention_) {
+    fused_bprop();
+    return;
+  }
   CudaDeviceContext context(get_device_id());
   T* query = input_tensors_[0].data<T>();
   T* key = input_tensors_[1].data<T>();
@@ -513,6 +947,78 @@ void MultiHeadAttentionLayer<T>::bprop() {
   }
 }
 
+template <typename T>
+void MultiHeadAttentionLayer<T>::fused_fprop(bool is_train) {
+  CudaDeviceContext context(get_device_id());
+  const T* query = input_tensors_[0].data<T>();
+  const T* key = input_tensors_[1].data<T>();
+  const T* value = input_tensors_[2].data<T>();
+  const T* mask = input_tensors_.size() == 4 ? input_tensors_[3].data<T>() : nullptr;
+  T* attention_out = output_tensors_[0].data<T>();
+  float* lse = softmax_lse_tensor_.data<float>();
+
+  const int batch_size = input_tensors_[0].size(0);
+  const int from_seq_len = input_tensors_[0].size(dims_ - 2);
+  const int to_seq_len = input_tensors_[1].size(dims_ - 2);
+  const int size_per_head = input_tensors_[0].size(dims_ - 1) / num_head_;
+  auto stream = get_gpu().get_stream();
+
+  if (size_per_head <= 32) {
+    fused_attention_fprop<T, 32>(attention_out, lse, query, key, value, mask, batch_size,
+                                 num_head_, from_seq_len, to_seq_len, size_per_head, stream);
+  } else if (size_per_head <= 64) {
+    fused_attention_fprop<T, 64>(attention_out, lse, query, key, value, mask, batch_size,
+                                 num_head_, from_seq_len, to_seq_len, size_per_head, stream);
+  } else {
+    fused_attention_fprop<T, 128>(attention_out, lse, query, key, value, mask, batch_size,
+                                  num_head_, from_seq_len, to_seq_len, size_per_head, stream);
+  }
+  HCTR_LIB_THROW(cudaGetLastError());
+  // the output is replaced with its gradient before bprop()
+  if (is_train) {
+    HCTR_LIB_THROW(cudaMemcpyAsync(attention_out_4d_.data(), attention_out,
+                                   output_tensors_[0].num_bytes(), cudaMemcpyDeviceToDevice,
+                                   stream));
+  }
+}
+
+template <typename T>
+void MultiHeadAttentionLayer<T>::fused_bprop() {
+  CudaDeviceContext context(get_device_id());
+  T* query = input_tensors_[0].data<T>();
+  T* key = input_tensors_[1].data<T>();
+  T* value = input_tensors_[2].data<T>();
+  const T* mask = input_tensors_.size() == 4 ? input_tensors_[3].data<T>() : nullptr;
+  const T* d_out = output_tensors_[0].data<T>();
+  const T* out = attention_out_4d_.data<T>();
+  T* query_copy = query_buf_tensor_.data<T>();
+  const float* lse = softmax_lse_tensor_.data<float>();
+  float* delta = softmax_delta_tensor_.data<float>();
+
+  const int batch_size = input_tensors_[0].size(0);
+  const int from_seq_len = input_tensors_[0].size(dims_ - 2);
+  const int to_seq_len = input_tensors_[1].size(dims_ - 2);
+  const int size_per_head = input_tensors_[0].size(dims_ - 1) / num_head_;
+  auto stream = get_gpu().get_stream();
+
+  HCTR_LIB_THROW(cudaMemcpyAsync(query_copy, query, input_tensors_[0].num_bytes(),
+                                 cudaMemcpyDeviceToDevice, stream));
+  if (size_per_head <= 32) {
+    fused_attention_bprop<T, 32>(query, key, value, query_copy, d_out, out, mask, lse, delta,
+                                 batch_size, num_head_, from_seq_len, to_seq_len, size_per_head,
+                                 stream);
+  } else if (size_per_head <= 64) {
+    fused_attention_bprop<T, 64>(query, key, value, query_copy, d_out, out, mask, lse, delta,
+                                 batch_size, num_head_, from_seq_len, to_seq_len, size_per_head,
+                                 stream);
+  } else {
+    fused_attention_bprop<T, 128>(query, key, value, query_copy, d_out, out, mask, lse, delta,
+                                  batch_size, num_head_, from_seq_len, to_seq_len, size_per_head,
+                                  stream);
+  }
+  HCTR_LIB_THROW(cudaGetLastError());
+}
+
 template class MultiHeadAttentionLayer<float>;
 template class MultiHeadAttentionLayer<__half>;
 
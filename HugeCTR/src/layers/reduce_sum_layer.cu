@@ -16,105 +16,31 @@
 
 #include <algorithm>
 #include <functional>
+#include <layers/functors/reduce_functors.hpp>
+#include <layers/functors/sequence_reduce_functors.hpp>
 #include <layers/reduce_sum_layer.hpp>
 #include <network_buffer_channels.hpp>
-#include <utils.cuh>
 #include <utils.hpp>
 
 namespace HugeCTR {
 
 namespace {
 
-template <size_t length, typename T>
-__device__ int array_length(T (&arr)[length]) {
-  return length;
-}
-
-// this kernel can support dims_size=1/2/3
-template <typename T, typename... Args>
-__global__ void reduce_sum_kernel(const T* input, T* output, int axis, Args... args) {
-  size_t in_dims[] = {args...};
-  int dims_size = array_length(in_dims);
-  T local_sum = 0.0f;
-
-  if (axis == 0) {  // block_num = dim1 * dim2, do dim0 number of elements reduction in one block
-    if (dims_size == 1) {  // dims_size == 1
-      for (int tid = threadIdx.x; tid < in_dims[0]; tid += blockDim.x) {
-        local_sum += input[tid];
-      }
-    } else if (dims_size == 2) {  // dims_size == 2
-      for (int tid = threadIdx.x; tid < in_dims[0]; tid += blockDim.x) {
-        local_sum += input[tid * in_dims[1] + blockIdx.x];
-      }
-    } else if (dims_size == 3) {  // dims_size == 3
-      for (int tid = threadIdx.x; tid < in_dims[0]; tid += blockDim.x) {
-        local_sum += input[tid * (in_dims[1] * in_dims[2]) + blockIdx.x];
-      }
-    }
-  } else if (axis ==
-             1) {  // block_num = dim0 * dim2, do dim1 number of elements reduction in one block
-    if (dims_size == 2) {  // dims_size == 2
-      for (int tid = threadIdx.x; tid < in_dims[1]; tid += blockDim.x) {
-        local_sum += input[blockIdx.x * in_dims[1] + tid];
-      }
-    } else if (dims_size == 3) {  // dims_size == 3
-      for (int tid = threadIdx.x; tid < in_dims[1]; tid += blockDim.x) {
-        local_sum += input[blockIdx.x / in_dims[2] * (in_dims[1] * in_dims[2]) + tid * in_dims[2] +
-                           blockIdx.x % in_dims[2]];
-      }
-    }
-  } else if (axis ==
-             2) {  // block_num = dim0 * dim1, do dim2 number of elements reduction in one block
-    for (int tid = threadIdx.x; tid < in_dims[2]; tid += blockDim.x) {
-      local_sum += input[blockIdx.x * in_dims[2] + tid];
-    }
-  }
-
-  local_sum = blockReduceSum(local_sum);
-  if (threadIdx.x == 0) {
-    output[blockIdx.x] = local_sum;
+// The number of elements before and after the axis, the outer and inner sizes of reduce_fprop
+int64_t outer_size(const core23::Shape& shape, int axis) {
+  int64_t size = 1;
+  for (int i = 0; i < axis; i++) {
+    size *= shape.size(i);
   }
+  return size;
 }
 
-template <typename T, typename... Args>
-__global__ void reduce_sum_dgrad_kernel(const T* top_grad, T* dgrad, int axis, Args... args) {
-  int tid = blockIdx.x * blockDim.x + threadIdx.x;
-  size_t in_dims[] = {args...};
-  int dims_size = array_length(in_dims);
-
-  if (axis == 0) {
-    if (dims_size == 1) {  // dims_size == 1
-      if (tid < in_dims[0]) {
-        dgrad[tid] = top_grad[0];
-      }
-    } else if (dims_size == 2) {  // dims_size == 2
-      if (tid < (in_dims[0] * in_dims[1])) {
-        dgrad[tid] = top_grad[tid % in_dims[1]];
-      }
-    } else if (dims_size == 3) {  // dims_size == 3
-      if (tid < (in_dims[0] * in_dims[1] * in_dims[2])) {
-        int dim1_index = tid % (in_dims[1] * in_dims[2]) / in_dims[2];
-        int dim2_index = tid % in_dims[2];
-        dgrad[tid] = top_grad[dim1_index * in_dims[2] + dim2_index];
-      }
-    }
-  } else if (axis == 1) {
-    if (dims_size == 2) {  // dims_size == 2
-      if (tid < (in_dims[0] * in_dims[1])) {
-        dgrad[tid] = top_grad[tid / in_dims[1]];
-      }
-    } else if (dims_size == 3) {  // dims_size == 3
-      if (tid < (in_dims[0] * in_dims[1] * in_dims[2])) {
-        int dim0_index = tid / (in_dims[1] * in_dims[2]);
-        int dim2_index = tid % in_dims[2];
-        dgrad[tid] = top_grad[dim0_index * in_dims[2] + dim2_index];
-      }
-    }
-  } else if (axis == 2) {
-    int dim0_index = tid / (in_dims[1] * in_dims[2]);
-    int dim1_index = tid % (in_dims[1] * in_dims[2]) / in_dims[2];
-    dgrad[tid] = top_grad[dim0_index * in_dims[1] + dim1_index];
+int64_t inner_size(const core23::Shape& shape, int axis) {
+  int64_t size = 1;
+  for (int i = axis + 1; i < shape.dims(); i++) {
+    size *= shape.size(i);
   }
+  return size;
 }
 
 }  // end of namespace
@@ -151,30 +77,55 @@ ReduceSumLayer<T>::ReduceSumLayer(const core23::Tensor& input_tensor, core23::Te
   }
 }
 
+template <typename T>
+ReduceSumLayer<T>::ReduceSumLayer(const core23::Tensor& input_tensor,
+                                  const core23::Tensor& seq_len_tensor,
+                                  core23::Tensor& output_tensor, int axis,
+                                  const std::shared_ptr<GPUResource>& gpu_resource)
+    : Layer({input_tensor, seq_len_tensor}, {}, gpu_resource), axis_(axis) {
+  try {
+    const auto& in_shape = input_tensor.shape();
+    if (in_shape.dims() != 3) {
+      HCTR_OWN_THROW(Error_t::WrongInput,
+                     "The input must be 3D (batch_size, max_seq_len, vector_size) with lengths");
+    }
+    if (axis != 1) {
+      HCTR_OWN_THROW(Error_t::WrongInput, "Only the sequence axis 1 can be reduced with lengths");
+    }
+    if (seq_len_tensor.num_elements() != in_shape.size(0)) {
+      HCTR_OWN_THROW(Error_t::WrongInput, "The sequence lengths must be (batch_size, 1)");
+    }
+    if (seq_len_tensor.data_type() != input_tensor.data_type()) {
+      HCTR_OWN_THROW(Error_t::WrongInput,
+                     "The sequence lengths must have the same data type as the input");
+    }
+
+    core23::Shape out_shape({in_shape.size(0), 1, in_shape.size(2)});
+    core23::BufferParams buf_p{.channel = GetBlobsBufferChannel()};
+
+    output_tensor = core23::Tensor(input_tensor.my_params().shape(out_shape).buffer_params(buf_p));
+    output_tensors_.push_back(output_tensor);
+  } catch (const std::runtime_error& rt_err) {
+    HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
+    throw;
+  }
+}
+
 template <typename T>
 void ReduceSumLayer<T>::fprop(bool is_train) {
   CudaDeviceContext context(get_device_id());
   auto* input = input_tensors_[0].data<T>();
   auto* output = output_tensors_[0].data<T>();
   auto in_shape = input_tensors_[0].shape();
-  auto out_shape = output_tensors_[0].shape();
-
-  auto block_num = out_shape.size();
-
-  dim3 blockSize(256, 1, 1);
-  dim3 gridSize(block_num, 1, 1);
-  if (in_shape.dims() == 1) {
-    reduce_sum_kernel<<<gridSize, blockSize, 0, get_gpu().get_stream()>>>(
-        input, output, axis_, static_cast<size_t>(in_shape.size(0)));
-  } else if (in_shape.dims() == 2) {
-    reduce_sum_kernel<<<gridSize, blockSize, 0, get_gpu().get_stream()>>>(
-        input, output, axis_, static_cast<size_t>(in_shape.size(0)),
-        static_cast<size_t>(in_shape.size(1)));
-  } else if (in_shape.dims() == 3) {
-    reduce_sum_kernel<<<gridSize, blockSize, 0, get_gpu().get_stream()>>>(
-        input, output, axis_, static_cast<size_t>(in_shape.size(0)),
-        static_cast<size_t>(in_shape.size(1)), static_cast<size_t>(in_shape.size(2)));
+
+  if (input_tensors_.size() == 2) {
+    sequence_reduce_fprop(input, input_tensors_[1].data<T>(), output, in_shape.size(0),
+                          in_shape.size(1), in_shape.size(2), false, get_gpu().get_stream());
+    return;
   }
+
+  reduce_fprop(input, output, outer_size(in_shape, axis_), in_shape.size(axis_),
+               inner_size(in_shape, axis_), false, get_gpu().get_stream());
 }
 
 template <typename T>
@@ -185,22 +136,14 @@ void ReduceSumLayer<T>::bprop() {
   auto* output = output_tensors_[0].data<T>();
   auto in_shape = input_tensors_[0].shape();
 
-  auto size = in_shape.size();
-
-  dim3 blockSize(256, 1, 1);
-  dim3 gridSize((size + blockSize.x - 1) / blockSize.x, 1, 1);
-  if (in_shape.dims() == 1) {
-    reduce_sum_dgrad_kernel<<<gridSize, blockSize, 0, get_gpu().get_stream()>>>(
-        output, input, axis_, static_cast<size_t>(in_shape.size(0)));
-  } else if (in_shape.dims() == 2) {
-    reduce_sum_dgrad_kernel<<<gridSize, blockSize, 0, get_gpu().get_stream()>>>(
-        output, input, axis_, static_cast<size_t>(in_shape.size(0)),
-        static_cast<size_t>(in_shape.size(1)));
-  } else if (in_shape.dims() == 3) {
-    reduce_sum_dgrad_kernel<<<gridSize, blockSize, 0, get_gpu().get_stream()>>>(
-        output, input, axis_, static_cast<size_t>(in_shape.size(0)),
-        static_cast<size_t>(in_shape.size(1)), static_cast<size_t>(in_shape.size(2)));
+  if (input_tensors_.size() == 2) {
+    sequence_reduce_bprop(output, input_tensors_[1].data<T>(), input, in_shape.size(0),
+                          in_shape.size(1), in_shape.size(2), false, get_gpu().get_stream());
+    return;
   }
+
+  reduce_bprop(output, input, outer_size(in_shape, axis_), in_shape.size(axis_),
+               inner_size(in_shape, axis_), false, get_gpu().get_stream());
 }
 
 template class ReduceSumLayer<float>;
@@ -14,7 +14,9 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <common.hpp>
+#include <core23/tensor_operations.hpp>
 #include <cstdint>
 #include <layers/slice_layer.hpp>
 #include <network_buffer_channels.hpp>
@@ -24,26 +26,53 @@ namespace HugeCTR {
 
 namespace {
 
+// blockIdx.y picks the output, so that all the slices are gathered in a single launch.
+// slices[i] is the first column and the width of the i-th output.
 template <typename T>
-__global__ void slice_fwd_kernel(T* const __restrict__ out, const T* const __restrict__ in,
-                                 const int2 in_dim, const int2 slice) {
-  for (int mi = blockIdx.x; mi < in_dim.x; mi += gridDim.x) {
-    for (int ni = threadIdx.x; ni < slice.y; ni += blockDim.x) {
-      out[mi * slice.y + ni] = in[mi * in_dim.y + slice.x + ni];
-    }
+__global__ void slice_fwd_kernel(T* const* outs, const T* const __restrict__ in, const int2 in_dim,
+                                 const int2* slices) {
+  const int2 slice = slices[blockIdx.y];
+  T* out = outs[blockIdx.y];
+  for (int idx = blockIdx.x * blockDim.x + threadIdx.x; idx < in_dim.x * slice.y;
+       idx += blockDim.x * gridDim.x) {
+    const int mi = idx / slice.y;
+    const int ni = idx - mi * slice.y;
+    out[idx] = in[mi * in_dim.y + slice.x + ni];
   }
 }
 
+// Every input element sums the slices covering it, so overlapping ranges need neither atomics nor
+// zeroing the input gradient first.
 template <typename T>
-__global__ void slice_bwd_kernel(const T* const __restrict__ out, T* const __restrict__ in,
-                                 const int2 in_dim, const int2 slice) {
-  for (int mi = blockIdx.x; mi < in_dim.x; mi += gridDim.x) {
-    for (int ni = threadIdx.x; ni < slice.y; ni += blockDim.x) {
-      in[mi * in_dim.y + slice.x + ni] += out[mi * slice.y + ni];
+__global__ void slice_bwd_kernel(T* const* outs, T* const __restrict__ in, const int2 in_dim,
+                                 const int2* slices, int num_slices) {
+  for (int idx = blockIdx.x * blockDim.x + threadIdx.x; idx < in_dim.x * in_dim.y;
+       idx += blockDim.x * gridDim.x) {
+    const int mi = idx / in_dim.y;
+    const int ni = idx - mi * in_dim.y;
+    T sum = T(0);
+    for (int i = 0; i < num_slices; i++) {
+      const int2 slice = slices[i];
+      if (ni >= slice.x && ni < slice.x + slice.y) {
+        sum += outs[i][mi * slice.y + ni - slice.x];
+      }
     }
+    in[idx] = sum;
   }
 }
 
+// The input as a 2D (height, width) matrix
+int2 get_in_dim(const core23::Tensor& input_tensor) {
+  auto in_shape = input_tensor.shape();
+  auto dims = in_shape.dims();
+  int height = 1;
+  for (auto i = 0; i < dims - 1; i++) {
+    height = height * in_shape.size(i);
+  }
+  int width = in_shape.size(dims - 1);
+  return {height, width};
+}
+
 }  // anonymous namespace
 
 template <typename T>
@@ -103,56 +132,62 @@ SliceLayer<T>::SliceLayer(const core23::Tensor& input_tensor,
 }
 
 template <typename T>
-void SliceLayer<T>::fprop(bool is_train) {
+void SliceLayer<T>::initialize() {
   CudaDeviceContext context(get_device_id());
-  auto stream = get_gpu().get_stream();
 
-  int block_size = 256;
-  int n_blocks = get_gpu().get_sm_count() * 4;
-  T* in = input_tensors_[0].data<T>();
-  auto in_shape = input_tensors_[0].shape();
-  auto dims = in_shape.dims();
-  int height = 1;
-  for (auto i = 0; i < dims - 1; i++) {
-    height = height * in_shape.size(i);
+  core23::Device device(core23::DeviceType::GPU, get_device_id());
+  const int64_t n_output_tensors = output_tensors_.size();
+  output_tensor_ptrs_ = core23::Tensor(core23::TensorParams()
+                                           .shape({n_output_tensors})
+                                           .data_type(core23::ScalarType::Pointer)
+                                           .device(device));
+  slices_ = core23::Tensor(core23::TensorParams()
+                               .shape({n_output_tensors, 2})
+                               .data_type(core23::ScalarType::Int32)
+                               .device(device));
+  std::vector<void*> ptr_cpu;
+  std::vector<int32_t> slices_cpu;
+  // the output tensors must be allocated before initialize() is called
+  for (size_t i = 0; i < output_tensors_.size(); i++) {
+    auto& output_tensor = output_tensors_[i];
+    ptr_cpu.push_back(output_tensor.data());
+    slices_cpu.push_back(slices_start_[i]);
+    slices_cpu.push_back(static_cast<int32_t>(output_tensor.size(output_tensor.dims() - 1)));
   }
-  int width = in_shape.size(dims - 1);
-  int2 in_dim = {static_cast<int>(height), static_cast<int>(width)};
-  int grid_size = std::min(in_dim.x, n_blocks);
-  for (std::size_t i = 0; i < output_tensors_.size(); i++) {
-    core23::Tensor& output_tensor = output_tensors_[i];
-    T* out = output_tensor.data<T>();
-    int2 slice = {slices_start_[i], static_cast<int>(output_tensor.size(dims - 1))};
-
-    slice_fwd_kernel<<<grid_size, block_size, 0, stream>>>(out, in, in_dim, slice);
+  core23::copy_async(output_tensor_ptrs_, ptr_cpu, get_gpu().get_stream());
+  core23::copy_async(slices_, slices_cpu, get_gpu().get_stream());
+}
+
+template <typename T>
+void SliceLayer<T>::fprop(bool is_train) {
+  CudaDeviceContext context(get_device_id());
+
+  const int2 in_dim = get_in_dim(input_tensors_[0]);
+  int max_width = 0;
+  for (auto& output_tensor : output_tensors_) {
+    max_width = std::max(max_width, static_cast<int>(output_tensor.size(output_tensor.dims() - 1)));
   }
+  const int block_size = 256;
+  const int n_blocks = get_gpu().get_sm_count() * 4;
+  const dim3 grid_size(std::min((in_dim.x * max_width - 1) / block_size + 1, n_blocks),
+                       output_tensors_.size());
+  slice_fwd_kernel<<<grid_size, block_size, 0, get_gpu().get_stream()>>>(
+      output_tensor_ptrs_.data<T*>(), input_tensors_[0].data<T>(), in_dim,
+      reinterpret_cast<const int2*>(slices_.data<int>()));
 }
 
 template <typename T>
 void SliceLayer<T>::bprop() {
   CudaDeviceContext context(get_device_id());
-  auto stream = get_gpu().get_stream();
 
-  int block_size = 256;
-  int n_blocks = get_gpu().get_sm_count() * 4;
-  T* in = input_tensors_[0].data<T>();
-  auto in_shape = input_tensors_[0].shape();
-  auto dims = in_shape.dims();
-  int height = 1;
-  for (auto i = 0; i < dims - 1; i++) {
-    height = height * in_shape.size(i);
-  }
-  int width = in_shape.size(dims - 1);
-  int2 in_dim = {static_cast<int>(height), static_cast<int>(width)};
-  int grid_size = std::min(in_dim.x, n_blocks);
-  initialize_array<<<n_blocks, block_size, 0, stream>>>(in, in_dim.x * in_dim.y, T(0));
-  for (std::size_t i = 0; i < output_tensors_.size(); i++) {
-    core23::Tensor& output_tensor = output_tensors_[i];
-    T* out = output_tensor.data<T>();
-    int2 slice = {slices_start_[i], static_cast<int>(output_tensor.size(dims - 1))};
-
-    slice_bwd_kernel<<<grid_size, block_size, 0, stream>>>(out, in, in_dim, slice);
-  }
+  const int2 in_dim = get_in_dim(input_tensors_[0]);
+  const int block_size = 256;
+  const int n_blocks = get_gpu().get_sm_count() * 4;
+  const int grid_size = std::min((in_dim.x * in_dim.y - 1) / block_size + 1, n_blocks);
+  slice_bwd_kernel<<<grid_size, block_size, 0, get_gpu().get_stream()>>>(
+      output_tensor_ptrs_.data<T*>(), input_tensors_[0].data<T>(), in_dim,
+      reinterpret_cast<const int2*>(slices_.data<int>()),
+      static_cast<int>(output_tensors_.size()));
 }
 
 template class SliceLayer<float>;
@@ -131,6 +131,16 @@ void Loss<T>::regularizer_initialize_wgrad(bool is_train) {
   }
 }
 
+template <typename T>
+RegularizationGrad Loss<T>::regularizer_fuse_into_optimizer() {
+  return regularizer_->fuse_into_optimizer(total_gpu_count_);
+}
+
+template <typename T>
+float Loss<T>::regularizer_compute_deferred_rterm() {
+  return regularizer_->compute_deferred_rterm();
+}
+
 template <typename T>
 CrossEntropyLoss<T>::CrossEntropyLoss(const core23::Tensor &label_tensor,
                                       const core23::Tensor &input_tensor,
@@ -391,6 +401,181 @@ MultiCrossEntropyLoss<T>::MultiCrossEntropyLoss(
                             cudaMemcpyHostToDevice));
 }
 
+IFusedLoss::~IFusedLoss() {}
+
+// Every block of the grid's row blockIdx.y computes the samples of one task like
+// BinaryCrossEntropy_Kernel. The last block of a task to finish writes its loss, and the last task
+// to finish writes the sum over the tasks, so that no memset is needed before the launch: both
+// the running sums and the counters are reset by the blocks that consume them.
+template <typename T>
+__global__ void FusedBinaryCrossEntropy_Kernel(
+    T *const *inputs, const float *const *labels, float *const *losses,
+    const float *label_weights, unsigned int *block_counters, float *partial_losses,
+    unsigned int *task_counter, float *total_loss, int num_tasks, float scaler, int batch_size,
+    int current_batch_size, int total_gpu_count, float rterm, bool is_train,
+    bool gen_loss_summary) {
+  const int task = blockIdx.y;
+  const int tid = blockIdx.x * blockDim.x + threadIdx.x;
+  T *input = inputs[task];
+  float val = 0.0f;
+  if (tid < current_batch_size) {
+    const float x = input[tid];
+    const float y = labels[task][tid];
+    if (x >= 0) {
+      float exp_neg_x = exp(-x);
+      input[tid] = is_train ? ((1 - y) - exp_neg_x / (1 + exp_neg_x)) * scaler /
+                                  (float)current_batch_size / total_gpu_count
+                            : 1 / (1 + exp_neg_x);
+      val = x * (1 - y) + log(1 + exp_neg_x);
+    } else {
+      float exp_x = exp(x);
+      input[tid] = is_train ? (-y + exp_x / (1 + exp_x)) * scaler / (float)current_batch_size /
+                                  total_gpu_count
+                            : exp_x / (exp_x + 1);
+      val = -x * y + log(1 + exp_x);
+    }
+  } else if (is_train && tid < batch_size) {
+    input[tid] = 0.0f;
+  }
+  if (false == gen_loss_summary) return;
+  float ret = blockReduceSum(val) * label_weights[task];
+  if (threadIdx.x == 0) {
+    atomicAdd(&partial_losses[task], ret / current_batch_size);
+    __threadfence();
+    // atomicInc wraps around to 0 on the last block, which is thus ready for the next call
+    if (atomicInc(&block_counters[task], gridDim.x - 1) == gridDim.x - 1) {
+      const float task_loss = atomicExch(&partial_losses[task], 0.0f) + rterm;
+      *losses[task] = task_loss;
+      atomicAdd(&partial_losses[num_tasks], task_loss);
+      __threadfence();
+      if (atomicInc(task_counter, num_tasks - 1) == num_tasks - 1) {
+        *total_loss = atomicExch(&partial_losses[num_tasks], 0.0f);
+      }
+    }
+  }
+}
+
+template <typename T>
+FusedBinaryCrossEntropyLoss<T>::FusedBinaryCrossEntropyLoss(
+    const std::vector<BinaryCrossEntropyLoss<T> *> &losses)
+    : losses_(losses) {
+  if (losses_.empty()) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "There is no loss to fuse");
+  }
+  Loss<T> *first = losses_[0];
+  gpu_resource_ = first->gpu_resource_;
+  batch_size_ = first->get_input_tensors(true)[0].shape().size(0);
+  total_gpu_count_ = first->total_gpu_count_;
+  scaler_ = first->scaler_;
+  gen_loss_summary_ = first->gen_loss_summary_;
+  for (Loss<T> *loss : losses_) {
+    if (loss->get_input_tensors(true)[0].shape().size(0) != batch_size_ ||
+        loss->get_device_id() != first->get_device_id() ||
+        loss->total_gpu_count_ != total_gpu_count_ || loss->scaler_ != scaler_ ||
+        loss->gen_loss_summary_ != gen_loss_summary_) {
+      HCTR_OWN_THROW(Error_t::WrongInput, "The fused losses must only differ by their tensors");
+    }
+  }
+
+  core23::BufferParams blobs_buffer_params = {};
+  blobs_buffer_params.channel = core23::GetRandomBufferChannel();
+  core23::Device device(core23::DeviceType::GPU, gpu_resource_->get_device_id());
+  auto make_tensor = [&](core23::DataType data_type, int64_t size) {
+    return core23::Tensor(core23::TensorParams()
+                              .data_type(data_type)
+                              .shape({size})
+                              .device(device)
+                              .buffer_params(blobs_buffer_params));
+  };
+  const int64_t num_tasks = losses_.size();
+  inputs_ = make_tensor(core23::ScalarType::UInt64, num_tasks);
+  labels_ = make_tensor(core23::ScalarType::UInt64, num_tasks);
+  losses_ptrs_ = make_tensor(core23::ScalarType::UInt64, num_tasks);
+  label_weights_ = make_tensor(core23::ScalarType::Float, num_tasks);
+  block_counters_ = make_tensor(core23::ScalarType::UInt32, num_tasks);
+  partial_losses_ = make_tensor(core23::ScalarType::Float, num_tasks + 1);
+  task_counter_ = make_tensor(core23::ScalarType::UInt32, 1);
+  total_loss_ = make_tensor(core23::ScalarType::Float, 1);
+}
+
+template <typename T>
+void FusedBinaryCrossEntropyLoss<T>::upload_params() {
+  const size_t num_tasks = losses_.size();
+  std::vector<uint64_t> h_inputs(num_tasks);
+  std::vector<uint64_t> h_labels(num_tasks);
+  std::vector<uint64_t> h_losses(num_tasks);
+  std::vector<float> h_label_weights(num_tasks);
+  for (size_t i = 0; i < num_tasks; ++i) {
+    Loss<T> *loss = losses_[i];
+    h_inputs[i] = reinterpret_cast<uint64_t>(loss->get_input_tensors(true)[0].template data<T>());
+    h_labels[i] =
+        reinterpret_cast<uint64_t>(loss->get_label_tensors(true)[0].template data<float>());
+    h_losses[i] = reinterpret_cast<uint64_t>(loss->get_loss_tensors()[0].template data<float>());
+    h_label_weights[i] = loss->get_label_weight();
+  }
+
+  CudaDeviceContext context(gpu_resource_->get_device_id());
+  HCTR_LIB_THROW(cudaMemcpy(inputs_.data(), h_inputs.data(), inputs_.num_bytes(),
+                            cudaMemcpyHostToDevice));
+  HCTR_LIB_THROW(cudaMemcpy(labels_.data(), h_labels.data(), labels_.num_bytes(),
+                            cudaMemcpyHostToDevice));
+  HCTR_LIB_THROW(cudaMemcpy(losses_ptrs_.data(), h_losses.data(), losses_ptrs_.num_bytes(),
+                            cudaMemcpyHostToDevice));
+  HCTR_LIB_THROW(cudaMemcpy(label_weights_.data(), h_label_weights.data(),
+                            label_weights_.num_bytes(), cudaMemcpyHostToDevice));
+  HCTR_LIB_THROW(cudaMemset(block_counters_.data(), 0, block_counters_.num_bytes()));
+  HCTR_LIB_THROW(cudaMemset(partial_losses_.data(), 0, partial_losses_.num_bytes()));
+  HCTR_LIB_THROW(cudaMemset(task_counter_.data(), 0, task_counter_.num_bytes()));
+  HCTR_LIB_THROW(cudaMemset(total_loss_.data(), 0, total_loss_.num_bytes()));
+  params_uploaded_ = true;
+}
+
+// Note: current_batchsize here is the batchsize on this device
+template <typename T>
+void FusedBinaryCrossEntropyLoss<T>::compute(bool is_train, long long current_batchsize,
+                                             float rterm) {
+  if (current_batchsize > batch_size_ || current_batchsize < 0) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "current_batchsize > batch_size || current_batchsize < 0");
+  }
+  if (!params_uploaded_) {
+    upload_params();
+  }
+  if (current_batchsize == 0 && !is_train) {
+    return;
+  }
+
+  const int num_tasks = losses_.size();
+  const int block_size = 512;
+  const dim3 grid_size((batch_size_ + block_size - 1) / block_size, num_tasks);
+  // like BinaryCrossEntropyLoss, the losses are left as they are if there is no sample
+  const bool gen_loss_summary = gen_loss_summary_ && current_batchsize > 0;
+  FusedBinaryCrossEntropy_Kernel<<<grid_size, block_size, 0, gpu_resource_->get_stream()>>>(
+      reinterpret_cast<T *const *>(inputs_.data()),
+      reinterpret_cast<const float *const *>(labels_.data()),
+      reinterpret_cast<float *const *>(losses_ptrs_.data()),
+      label_weights_.data<float>(), block_counters_.data<unsigned int>(),
+      partial_losses_.data<float>(), task_counter_.data<unsigned int>(), total_loss_.data<float>(),
+      num_tasks, scaler_, batch_size_, current_batchsize, total_gpu_count_, rterm, is_train,
+      gen_loss_summary);
+}
+
+template <typename T>
+std::unique_ptr<IFusedLoss> create_fused_loss(
+    const std::map<std::string, std::unique_ptr<ILoss>> &losses) {
+  if (losses.size() < 2) {
+    return nullptr;
+  }
+  std::vector<BinaryCrossEntropyLoss<T> *> bce_losses;
+  for (auto &pair : losses) {
+    auto bce_loss = dynamic_cast<BinaryCrossEntropyLoss<T> *>(pair.second.get());
+    if (bce_loss == nullptr) {
+      return nullptr;
+    }
+    bce_losses.push_back(bce_loss);
+  }
+  return std::make_unique<FusedBinaryCrossEntropyLoss<T>>(bce_losses);
+}
+
 template class Loss<__half>;
 template class Loss<float>;
 template class MultiCrossEntropyLoss<__half>;
@@ -399,5 +584,11 @@ template class CrossEntropyLoss<__half>;
 template class CrossEntropyLoss<float>;
 template class BinaryCrossEntropyLoss<__half>;
 template class BinaryCrossEntropyLoss<float>;
+template class FusedBinaryCrossEntropyLoss<__half>;
+template class FusedBinaryCrossEntropyLoss<float>;
+template std::unique_ptr<IFusedLoss> create_fused_loss<__half>(
+    const std::map<std::string, std::unique_ptr<ILoss>> &losses);
+template std::unique_ptr<IFusedLoss> create_fused_loss<float>(
+    const std::map<std::string, std::unique_ptr<ILoss>> &losses);
 
 }  // namespace HugeCTR
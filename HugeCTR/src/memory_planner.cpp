@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <core23/logger.hpp>
+#include <iomanip>
+#include <memory_planner.hpp>
+#include <sstream>
+#include <utils.hpp>
+
+namespace HugeCTR {
+
+namespace {
+
+// Kept free for what grows during the first steps, e.g., the workspaces of cuBLAS and NCCL, and
+// for fragmentation.
+constexpr double kHeadroomFraction = 0.05;
+constexpr size_t kMinHeadroomBytes = size_t{512} << 20;
+
+double to_mib(const double bytes) { return bytes / (1 << 20); }
+
+}  // namespace
+
+MemoryPlanner::MemoryPlanner(const std::shared_ptr<ResourceManager>& resource_manager)
+    : resource_manager_(resource_manager) {}
+
+std::vector<size_t> MemoryPlanner::free_bytes(std::vector<size_t>* total_bytes) const {
+  std::vector<size_t> free;
+  for (size_t i = 0; i < resource_manager_->get_local_gpu_count(); i++) {
+    CudaDeviceContext context(resource_manager_->get_local_gpu(i)->get_device_id());
+    // The stream-ordered allocations are done once the device is idle.
+    HCTR_LIB_THROW(cudaDeviceSynchronize());
+    size_t gpu_free = 0, gpu_total = 0;
+    HCTR_LIB_THROW(cudaMemGetInfo(&gpu_free, &gpu_total));
+    free.push_back(gpu_free);
+    if (total_bytes) {
+      total_bytes->push_back(gpu_total);
+    }
+  }
+  return free;
+}
+
+void MemoryPlanner::begin() { free_at_begin_ = free_bytes(); }
+
+void MemoryPlanner::end(const std::string& name, const std::vector<size_t>& fixed_bytes) {
+  HCTR_THROW_IF(free_at_begin_.empty(), Error_t::IllegalCall,
+                "MemoryPlanner::end is called without begin");
+  const std::vector<size_t> free = free_bytes();
+  const size_t num_gpus = free.size();
+
+  auto it = parts_.find(name);
+  if (it == parts_.end()) {
+    part_names_.push_back(name);
+    it = parts_.emplace(name, Part{std::vector<size_t>(num_gpus, 0),
+                                   std::vector<size_t>(num_gpus, 0)})
+             .first;
+  }
+  Part& part = it->second;
+  for (size_t i = 0; i < num_gpus; i++) {
+    // Memory freed meanwhile, e.g., by a temporary, does not count.
+    const size_t bytes = free_at_begin_[i] > free[i] ? free_at_begin_[i] - free[i] : 0;
+    part.total_bytes[i] += bytes;
+    part.fixed_bytes[i] += std::min(bytes, i < fixed_bytes.size() ? fixed_bytes[i] : 0);
+  }
+  free_at_begin_.clear();
+}
+
+void MemoryPlanner::end(const std::string& name, const bool scales_with_batch) {
+  const size_t num_gpus = resource_manager_->get_local_gpu_count();
+  end(name, std::vector<size_t>(num_gpus, scales_with_batch ? 0 : SIZE_MAX));
+}
+
+size_t MemoryPlanner::tightest_gpu(const std::vector<size_t>& free) const {
+  return std::min_element(free.begin(), free.end()) - free.begin();
+}
+
+size_t MemoryPlanner::headroom(const size_t total_bytes) const {
+  return std::max(static_cast<size_t>(total_bytes * kHeadroomFraction), kMinHeadroomBytes);
+}
+
+long long MemoryPlanner::max_batchsize(const long long batchsize) const {
+  std::vector<size_t> total;
+  const std::vector<size_t> free = free_bytes(&total);
+  const size_t gpu = tightest_gpu(free);
+
+  double scaled = 0;
+  for (const auto& [name, part] : parts_) {
+    scaled += part.total_bytes[gpu] - part.fixed_bytes[gpu];
+  }
+  if (scaled <= 0) {
+    return batchsize;
+  }
+  const double spare = static_cast<double>(free[gpu]) - headroom(total[gpu]);
+  const long long num_gpus = resource_manager_->get_global_gpu_count();
+  const double batchsize_per_gpu = static_cast<double>(batchsize) / num_gpus;
+  const double max_batchsize_per_gpu = batchsize_per_gpu * (scaled + spare) / scaled;
+  return std::max(static_cast<long long>(max_batchsize_per_gpu), 0LL) * num_gpus;
+}
+
+std::string MemoryPlanner::report(const long long batchsize,
+                                  const std::vector<RowType>& row_types) const {
+  std::ostringstream os;
+  std::vector<size_t> total;
+  const std::vector<size_t> free = free_bytes(&total);
+  const size_t gpu = tightest_gpu(free);
+
+  os << "GPU memory plan of GPU " << resource_manager_->get_local_gpu(gpu)->get_device_id()
+     << ", which has the least free memory, in MiB" << std::endl;
+  os << std::left << std::setw(40) << "Part" << std::setw(20) << "Total" << std::setw(20)
+     << "Fixed" << std::setw(20) << "Scales with batch" << std::endl;
+  os << std::fixed << std::setprecision(1);
+  size_t sum_total = 0, sum_fixed = 0;
+  for (const std::string& name : part_names_) {
+    const Part& part = parts_.at(name);
+    const size_t part_total = part.total_bytes[gpu];
+    const size_t part_fixed = part.fixed_bytes[gpu];
+    os << std::left << std::setw(40) << name << std::setw(20) << to_mib(part_total)
+       << std::setw(20) << to_mib(part_fixed) << std::setw(20) << to_mib(part_total - part_fixed)
+       << std::endl;
+    sum_total += part_total;
+    sum_fixed += part_fixed;
+  }
+  os << std::left << std::setw(40) << "Sum" << std::setw(20) << to_mib(sum_total) << std::setw(20)
+     << to_mib(sum_fixed) << std::setw(20) << to_mib(sum_total - sum_fixed) << std::endl;
+  const size_t gpu_headroom = headroom(total[gpu]);
+  os << std::left << std::setw(40) << "Free" << to_mib(free[gpu]) << std::endl;
+  os << std::left << std::setw(40) << "Headroom" << to_mib(gpu_headroom) << std::endl;
+
+  const long long max_batch = max_batchsize(batchsize);
+  os << "Largest batch size that fits: " << max_batch << " (current: " << batchsize << ")"
+     << std::endl;
+  if (free[gpu] < gpu_headroom) {
+    os << "The free memory is below the headroom, the training may run out of memory"
+       << std::endl;
+    return os.str();
+  }
+  const size_t spare = free[gpu] - gpu_headroom;
+  for (const RowType& row_type : row_types) {
+    os << "Embedding rows of size " << row_type.ev_size
+       << " that fit at the current batch size: " << spare / row_type.bytes_per_row
+       << " per GPU" << std::endl;
+  }
+  return os.str();
+}
+
+}  // namespace HugeCTR
@@ -16,10 +16,13 @@
 
 #include <omp.h>
 
+#include <algorithm>
+#include <cmath>
 #include <core23/buffer_channel_helpers.hpp>
 #include <cub/cub.cuh>
 #include <diagnose.hpp>
 #include <general_buffer2.hpp>
+#include <limits>
 #include <metrics.hpp>
 #include <network_buffer_channels.hpp>
 #include <utils.cuh>
@@ -337,6 +340,10 @@ ncclDataType_t get_nccl_type<float>() {
   return ncclFloat32;
 }
 template <>
+ncclDataType_t get_nccl_type<double>() {
+  return ncclFloat64;
+}
+template <>
 ncclDataType_t get_nccl_type<__half>() {
   return ncclFloat16;
 }
@@ -426,6 +433,7 @@ void get_raw_metric_as_host_float_tensor(Core23RawMetricMap metric_map, RawType
 
 std::unique_ptr<Metric> Metric::Create(const Type type, bool use_mixed_precision,
                                        int batch_size_eval, int n_batches, int label_dim,
+                                       int top_k, int candidates_per_query,
                                        const std::shared_ptr<ResourceManager>& resource_manager) {
   std::unique_ptr<Metric> ret;
   switch (type) {
@@ -436,6 +444,13 @@ std::unique_ptr<Metric> Metric::Create(const Type type, bool use_mixed_precision
         ret.reset(new AUC<float>(batch_size_eval, n_batches, label_dim, resource_manager));
       }
       break;
+    case Type::StreamingAUC:
+      if (use_mixed_precision) {
+        ret.reset(new StreamingAUC<__half>(batch_size_eval, label_dim, resource_manager));
+      } else {
+        ret.reset(new StreamingAUC<float>(batch_size_eval, label_dim, resource_manager));
+      }
+      break;
     case Type::AverageLoss:
       ret.reset(new AverageLoss<float>(resource_manager));
       break;
@@ -452,6 +467,17 @@ std::unique_ptr<Metric> Metric::Create(const Type type, bool use_mixed_precision
     case Type::SMAPE:
       ret.reset(new SMAPE<float>(batch_size_eval, resource_manager));
       break;
+    case Type::QueryHitRate:
+    case Type::QueryNDCG:
+    case Type::QueryMRR:
+      if (use_mixed_precision) {
+        ret.reset(new QueryMetric<__half>(type, batch_size_eval, top_k, candidates_per_query,
+                                          resource_manager));
+      } else {
+        ret.reset(new QueryMetric<float>(type, batch_size_eval, top_k, candidates_per_query,
+                                         resource_manager));
+      }
+      break;
   }
   return ret;
 }
@@ -459,15 +485,21 @@ std::unique_ptr<Metric> Metric::Create(const Type type, bool use_mixed_precision
 Metric::Metric() : current_batch_size_(0) {}
 Metric::~Metric() {}
 
+__global__ void accumulate_loss_kernel(const float* loss, float* loss_sum) { *loss_sum += *loss; }
+
 template <typename T>
 AverageLoss<T>::AverageLoss(const std::shared_ptr<ResourceManager>& resource_manager)
     : Metric(),
       resource_manager_(resource_manager),
+      loss_sum_(std::vector<float*>(resource_manager->get_local_gpu_count(), nullptr)),
       loss_local_(std::vector<float*>(resource_manager->get_local_gpu_count(), nullptr)),
-      loss_global_(0.0f),
-      n_batches_(0) {
+      n_batches_(0),
+      n_nets_(1) {
   for (size_t local_gpu_id = 0; local_gpu_id < resource_manager_->get_local_gpu_count();
        ++local_gpu_id) {
+    CudaDeviceContext context(resource_manager_->get_local_gpu(local_gpu_id)->get_device_id());
+    HCTR_LIB_THROW(cudaMalloc((void**)&loss_sum_[local_gpu_id], sizeof(float)));
+    HCTR_LIB_THROW(cudaMemset(loss_sum_[local_gpu_id], 0, sizeof(float)));
     HCTR_LIB_THROW(cudaMallocHost((void**)&loss_local_[local_gpu_id], sizeof(float)));
   }
 }
@@ -476,34 +508,42 @@ template <typename T>
 AverageLoss<T>::~AverageLoss() {
   for (size_t local_gpu_id = 0; local_gpu_id < resource_manager_->get_local_gpu_count();
        ++local_gpu_id) {
+    CudaDeviceContext context(resource_manager_->get_local_gpu(local_gpu_id)->get_device_id());
+    HCTR_LIB_CHECK_(cudaFree(loss_sum_[local_gpu_id]));
     HCTR_LIB_CHECK_(cudaFreeHost(loss_local_[local_gpu_id]));
   }
 }
 
 template <typename T>
 void AverageLoss<T>::local_reduce(int local_gpu_id, Core23RawMetricMap raw_metrics) {
-  // HCTR_LOG_S(DEBUG, WORLD) << "Called local reduce" << std::endl;
   core23::Tensor loss_tensor = raw_metrics[RawType::Loss];
   const auto& local_gpu = resource_manager_->get_local_gpu(local_gpu_id);
-  auto& stream = local_gpu->get_stream();
   CudaDeviceContext context(local_gpu->get_device_id());
-  HCTR_LIB_THROW(cudaMemcpy(loss_local_[local_gpu_id], loss_tensor.data(), sizeof(float),
-                            cudaMemcpyDeviceToHost));
+  // Summed on the device, so that the batches do not wait for the host
+  accumulate_loss_kernel<<<1, 1, 0, local_gpu->get_stream()>>>(loss_tensor.data<float>(),
+                                                              loss_sum_[local_gpu_id]);
 }
 
 template <typename T>
 void AverageLoss<T>::global_reduce(int n_nets) {
-  float loss_inter = 0.0f;
-  for (auto& ptr_loss_local : loss_local_) {
-    loss_inter += *ptr_loss_local;
-  }
-  loss_global_ += loss_inter / n_nets / resource_manager_->get_num_process();
+  n_nets_ = n_nets;
   n_batches_++;
 }
 
 template <typename T>
 float AverageLoss<T>::finalize_metric() {
-  float ret = loss_global_;
+  float ret = 0.0f;
+  for (size_t local_gpu_id = 0; local_gpu_id < loss_sum_.size(); ++local_gpu_id) {
+    const auto& local_gpu = resource_manager_->get_local_gpu(local_gpu_id);
+    CudaDeviceContext context(local_gpu->get_device_id());
+    auto stream = local_gpu->get_stream();
+    HCTR_LIB_THROW(cudaMemcpyAsync(loss_local_[local_gpu_id], loss_sum_[local_gpu_id],
+                                   sizeof(float), cudaMemcpyDeviceToHost, stream));
+    HCTR_LIB_THROW(cudaMemsetAsync(loss_sum_[local_gpu_id], 0, sizeof(float), stream));
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    ret += *loss_local_[local_gpu_id];
+  }
+  ret = ret / n_nets_ / resource_manager_->get_num_process();
 #ifdef ENABLE_MPI
   if (resource_manager_->get_num_process() > 1) {
     float loss_reduced = 0.0f;
@@ -516,7 +556,6 @@ float AverageLoss<T>::finalize_metric() {
       ret = ret / n_batches_;
     }
   }
-  loss_global_ = 0.0f;
   n_batches_ = 0;
 
   return ret;
@@ -1241,6 +1280,336 @@ void AUC<T>::run_finalize_step(float* d_preds, float* d_labels, int local_id,
   }
 }
 
+template <typename T>
+__global__ void streaming_auc_histogram_kernel(const T* preds, const float* labels,
+                                               int num_elems, int num_classes, int num_bins,
+                                               unsigned long long* neg_bins,
+                                               unsigned long long* pos_bins) {
+  for (int i = blockIdx.x * blockDim.x + threadIdx.x; i < num_elems;
+       i += blockDim.x * gridDim.x) {
+    float pred = TypeConvertFunc<float, T>::convert(preds[i]);
+    int bin = min(max(static_cast<int>(pred * num_bins), 0), num_bins - 1);
+    int class_id = i % num_classes;
+    unsigned long long* bins = labels[i] > 0.5f ? pos_bins : neg_bins;
+    atomicAdd(bins + class_id * num_bins + bin, 1ull);
+  }
+}
+
+namespace {
+
+// Walks the bins from the highest predictions, a pair within a bin counts half
+float histogram_auc(const unsigned long long* neg, const unsigned long long* pos, int num_bins,
+                    double& num_pos, double& num_neg) {
+  num_pos = 0.0;
+  num_neg = 0.0;
+  double area = 0.0;
+  for (int bin = num_bins - 1; bin >= 0; bin--) {
+    area += neg[bin] * (num_pos + 0.5 * pos[bin]);
+    num_pos += pos[bin];
+    num_neg += neg[bin];
+  }
+  return (num_pos > 0 && num_neg > 0) ? area / (num_pos * num_neg) : 0.0f;
+}
+
+}  // namespace
+
+template <typename T>
+StreamingAUC<T>::StreamingAUC(int batch_size_per_gpu, int label_dim,
+                              const std::shared_ptr<ResourceManager>& resource_manager)
+    : Metric(),
+      num_classes_(label_dim),
+      resource_manager_(resource_manager),
+      batch_size_per_gpu_(batch_size_per_gpu),
+      num_local_gpus_(resource_manager_->get_local_gpu_count()),
+      bins_(num_local_gpus_),
+      interim_bins_(num_local_gpus_, nullptr),
+      per_class_aucs_(num_classes_, 0.0f) {
+  for (int i = 0; i < num_local_gpus_; i++) {
+    int device_id = resource_manager_->get_local_gpu(i)->get_device_id();
+    CudaDeviceContext context(device_id);
+    HCTR_LIB_THROW(cudaMalloc((void**)(&bins_[i]), num_bin_bytes()));
+    HCTR_LIB_THROW(cudaMemset(bins_[i], 0, num_bin_bytes()));
+  }
+}
+
+template <typename T>
+StreamingAUC<T>::~StreamingAUC() {
+  for (int i = 0; i < num_local_gpus_; i++) {
+    int device_id = resource_manager_->get_local_gpu(i)->get_device_id();
+    CudaDeviceContext context(device_id);
+    HCTR_LIB_CHECK_(cudaFree(bins_[i]));
+    if (interim_bins_[i]) {
+      HCTR_LIB_CHECK_(cudaFree(interim_bins_[i]));
+    }
+  }
+}
+
+template <typename T>
+void StreamingAUC<T>::local_reduce(int local_gpu_id, Core23RawMetricMap raw_metrics) {
+  const auto& local_gpu = resource_manager_->get_local_gpu(local_gpu_id);
+  CudaDeviceContext context(local_gpu->get_device_id());
+
+  int global_device_id = local_gpu->get_global_id();
+  int num_valid_samples =
+      get_num_valid_samples(global_device_id, current_batch_size_, batch_size_per_gpu_);
+
+  auto pred_tensor = raw_metrics[RawType::Pred];
+  auto label_tensor = raw_metrics[RawType::Label];
+
+  size_t class_bins = num_classes_ * num_bins_;
+  dim3 grid(local_gpu->get_sm_count() * 2, 1, 1);
+  dim3 block(1024, 1, 1);
+  streaming_auc_histogram_kernel<T><<<grid, block, 0, local_gpu->get_stream()>>>(
+      pred_tensor.data<PredType>(), label_tensor.data<LabelType>(),
+      num_valid_samples * num_classes_, num_classes_, num_bins_, bins_[local_gpu_id],
+      bins_[local_gpu_id] + class_bins);
+}
+
+template <typename T>
+void StreamingAUC<T>::global_reduce(int n_nets) {}
+
+template <typename T>
+float StreamingAUC<T>::finalize_metric() {
+  // Only the histograms are reduced, across all the GPUs
+  size_t num_bins_total = 2 * num_classes_ * num_bins_;
+#pragma omp parallel num_threads(num_local_gpus_)
+  {
+    int local_id = omp_get_thread_num();
+    auto gpu_resource = resource_manager_->get_local_gpu(local_id).get();
+    CudaDeviceContext context(gpu_resource->get_device_id());
+    auto stream = gpu_resource->get_stream();
+    metric_comm::allreduce(bins_[local_id], bins_[local_id], num_bins_total, gpu_resource, stream);
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  }
+
+  std::vector<unsigned long long> h_bins(num_bins_total);
+  {
+    CudaDeviceContext context(resource_manager_->get_local_gpu(0)->get_device_id());
+    HCTR_LIB_THROW(
+        cudaMemcpy(h_bins.data(), bins_[0], num_bin_bytes(), cudaMemcpyDeviceToHost));
+  }
+  for (int i = 0; i < num_local_gpus_; i++) {
+    CudaDeviceContext context(resource_manager_->get_local_gpu(i)->get_device_id());
+    HCTR_LIB_THROW(cudaMemset(bins_[i], 0, num_bin_bytes()));
+  }
+
+  float result = 0.0f;
+  for (size_t class_id = 0; class_id < num_classes_; class_id++) {
+    const unsigned long long* neg = h_bins.data() + class_id * num_bins_;
+    const unsigned long long* pos = neg + num_classes_ * num_bins_;
+    double num_pos, num_neg;
+    float class_auc = histogram_auc(neg, pos, num_bins_, num_pos, num_neg);
+    per_class_aucs_[class_id] = class_auc;
+    result += class_auc;
+  }
+  return result / num_classes_;
+}
+
+template <typename T>
+float StreamingAUC<T>::get_confidence_half_width() {
+  // The histograms are reduced into scratch bins, so that the reduction goes on
+  size_t num_bins_total = 2 * num_classes_ * num_bins_;
+#pragma omp parallel num_threads(num_local_gpus_)
+  {
+    int local_id = omp_get_thread_num();
+    auto gpu_resource = resource_manager_->get_local_gpu(local_id).get();
+    CudaDeviceContext context(gpu_resource->get_device_id());
+    auto stream = gpu_resource->get_stream();
+    if (!interim_bins_[local_id]) {
+      HCTR_LIB_THROW(cudaMalloc((void**)(&interim_bins_[local_id]), num_bin_bytes()));
+    }
+    metric_comm::allreduce(bins_[local_id], interim_bins_[local_id], num_bins_total, gpu_resource,
+                           stream);
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  }
+
+  std::vector<unsigned long long> h_bins(num_bins_total);
+  {
+    CudaDeviceContext context(resource_manager_->get_local_gpu(0)->get_device_id());
+    HCTR_LIB_THROW(
+        cudaMemcpy(h_bins.data(), interim_bins_[0], num_bin_bytes(), cudaMemcpyDeviceToHost));
+  }
+
+  // The standard error of Hanley and McNeil (1982), the widest of all classes
+  float half_width = 0.0f;
+  for (size_t class_id = 0; class_id < num_classes_; class_id++) {
+    const unsigned long long* neg = h_bins.data() + class_id * num_bins_;
+    const unsigned long long* pos = neg + num_classes_ * num_bins_;
+    double num_pos, num_neg;
+    double auc = histogram_auc(neg, pos, num_bins_, num_pos, num_neg);
+    if (num_pos == 0 || num_neg == 0) {
+      return std::numeric_limits<float>::infinity();
+    }
+    double q1 = auc / (2.0 - auc);
+    double q2 = 2.0 * auc * auc / (1.0 + auc);
+    double variance = (auc * (1.0 - auc) + (num_pos - 1.0) * (q1 - auc * auc) +
+                       (num_neg - 1.0) * (q2 - auc * auc)) /
+                      (num_pos * num_neg);
+    half_width = std::max(half_width, static_cast<float>(1.96 * std::sqrt(std::max(variance, 0.))));
+  }
+  return half_width;
+}
+
+constexpr int kQueryBlockSize = 256;
+
+// One block per query, see QueryMetric
+template <typename T>
+__global__ void query_metric_kernel(const T* preds, const float* labels, int num_queries,
+                                    int candidates_per_query, int top_k, double* sums) {
+  using BlockReduce = cub::BlockReduce<int, kQueryBlockSize>;
+  __shared__ typename BlockReduce::TempStorage temp_storage;
+
+  for (int query = blockIdx.x; query < num_queries; query += gridDim.x) {
+    const T* query_preds = preds + static_cast<int64_t>(query) * candidates_per_query;
+    const float* query_labels = labels + static_cast<int64_t>(query) * candidates_per_query;
+    int best_rank = candidates_per_query;
+    float dcg = 0.0f;
+    float ideal_dcg = 0.0f;
+    for (int i = 0; i < candidates_per_query; i++) {
+      const float label = query_labels[i];
+      if (label <= 0.0f) {
+        continue;
+      }
+      // The rank of the relevant candidate i, and its rank in the ideal order
+      const float pred = TypeConvertFunc<float, T>::convert(query_preds[i]);
+      int above = 0;
+      int ideal_above = 0;
+      for (int j = threadIdx.x; j < candidates_per_query; j += blockDim.x) {
+        const float other_pred = TypeConvertFunc<float, T>::convert(query_preds[j]);
+        const float other_label = query_labels[j];
+        above += other_pred > pred || (other_pred == pred && j < i);
+        ideal_above += other_label > label || (other_label == label && j < i);
+      }
+      const int rank = BlockReduce(temp_storage).Sum(above);
+      __syncthreads();
+      const int ideal_rank = BlockReduce(temp_storage).Sum(ideal_above);
+      __syncthreads();
+      if (threadIdx.x == 0) {
+        best_rank = min(best_rank, rank);
+        if (rank < top_k) {
+          dcg += label / log2f(rank + 2.0f);
+        }
+        if (ideal_rank < top_k) {
+          ideal_dcg += label / log2f(ideal_rank + 2.0f);
+        }
+      }
+    }
+    // The ideal DCG is positive if and only if the query has a relevant candidate
+    if (threadIdx.x == 0 && ideal_dcg > 0.0f) {
+      atomicAdd(sums, 1.0);
+      atomicAdd(sums + 1, best_rank < top_k ? 1.0 : 0.0);
+      atomicAdd(sums + 2, 1.0 / (best_rank + 1));
+      atomicAdd(sums + 3, static_cast<double>(dcg / ideal_dcg));
+    }
+  }
+}
+
+template <typename T>
+QueryMetric<T>::QueryMetric(Type type, int batch_size_per_gpu, int top_k,
+                            int candidates_per_query,
+                            const std::shared_ptr<ResourceManager>& resource_manager)
+    : Metric(),
+      type_(type),
+      top_k_(top_k),
+      candidates_per_query_(candidates_per_query),
+      resource_manager_(resource_manager),
+      batch_size_per_gpu_(batch_size_per_gpu),
+      num_local_gpus_(resource_manager_->get_local_gpu_count()),
+      sums_(num_local_gpus_) {
+  HCTR_THROW_IF(candidates_per_query_ <= 0, Error_t::WrongInput,
+                "The query metrics need eval_candidates_per_query to be set");
+  HCTR_THROW_IF(batch_size_per_gpu_ % candidates_per_query_ != 0, Error_t::WrongInput,
+                "The evaluation batch size per GPU, ", batch_size_per_gpu_,
+                ", must be a multiple of eval_candidates_per_query, ", candidates_per_query_,
+                ", so that no query is split across GPUs");
+  HCTR_THROW_IF(top_k_ <= 0, Error_t::WrongInput, "eval_top_k must be positive");
+  for (int i = 0; i < num_local_gpus_; i++) {
+    CudaDeviceContext context(resource_manager_->get_local_gpu(i)->get_device_id());
+    HCTR_LIB_THROW(cudaMalloc((void**)(&sums_[i]), num_sums_ * sizeof(double)));
+    HCTR_LIB_THROW(cudaMemset(sums_[i], 0, num_sums_ * sizeof(double)));
+  }
+}
+
+template <typename T>
+QueryMetric<T>::~QueryMetric() {
+  for (int i = 0; i < num_local_gpus_; i++) {
+    CudaDeviceContext context(resource_manager_->get_local_gpu(i)->get_device_id());
+    HCTR_LIB_CHECK_(cudaFree(sums_[i]));
+  }
+}
+
+template <typename T>
+std::string QueryMetric<T>::name() const {
+  switch (type_) {
+    case Type::QueryHitRate:
+      return "HitRate@" + std::to_string(top_k_);
+    case Type::QueryNDCG:
+      return "NDCG@" + std::to_string(top_k_);
+    default:
+      return "MRR";
+  }
+}
+
+template <typename T>
+void QueryMetric<T>::local_reduce(int local_gpu_id, Core23RawMetricMap raw_metrics) {
+  const auto& local_gpu = resource_manager_->get_local_gpu(local_gpu_id);
+  CudaDeviceContext context(local_gpu->get_device_id());
+
+  int global_device_id = local_gpu->get_global_id();
+  int num_valid_samples =
+      get_num_valid_samples(global_device_id, current_batch_size_, batch_size_per_gpu_);
+  // The candidates of an incomplete query at the end of the dataset are dropped
+  int num_queries = num_valid_samples / candidates_per_query_;
+  if (num_queries == 0) {
+    return;
+  }
+
+  auto pred_tensor = raw_metrics[RawType::Pred];
+  auto label_tensor = raw_metrics[RawType::Label];
+
+  dim3 grid(std::min(num_queries, static_cast<int>(local_gpu->get_sm_count()) * 8), 1, 1);
+  dim3 block(kQueryBlockSize, 1, 1);
+  query_metric_kernel<T><<<grid, block, 0, local_gpu->get_stream()>>>(
+      pred_tensor.data<PredType>(), label_tensor.data<LabelType>(), num_queries,
+      candidates_per_query_, top_k_, sums_[local_gpu_id]);
+}
+
+template <typename T>
+float QueryMetric<T>::finalize_metric() {
+#pragma omp parallel num_threads(num_local_gpus_)
+  {
+    int local_id = omp_get_thread_num();
+    auto gpu_resource = resource_manager_->get_local_gpu(local_id).get();
+    CudaDeviceContext context(gpu_resource->get_device_id());
+    auto stream = gpu_resource->get_stream();
+    metric_comm::allreduce(sums_[local_id], sums_[local_id], num_sums_, gpu_resource, stream);
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  }
+
+  double h_sums[num_sums_];
+  {
+    CudaDeviceContext context(resource_manager_->get_local_gpu(0)->get_device_id());
+    HCTR_LIB_THROW(cudaMemcpy(h_sums, sums_[0], sizeof(h_sums), cudaMemcpyDeviceToHost));
+  }
+  for (int i = 0; i < num_local_gpus_; i++) {
+    CudaDeviceContext context(resource_manager_->get_local_gpu(i)->get_device_id());
+    HCTR_LIB_THROW(cudaMemset(sums_[i], 0, sizeof(h_sums)));
+  }
+
+  const double num_queries = h_sums[0];
+  if (num_queries == 0.0) {
+    return 0.0f;
+  }
+  switch (type_) {
+    case Type::QueryHitRate:
+      return h_sums[1] / num_queries;
+    case Type::QueryNDCG:
+      return h_sums[3] / num_queries;
+    default:
+      return h_sums[2] / num_queries;
+  }
+}
+
 __global__ void scale_labels_kernel(float* labels, float* scaled_labels, size_t offset,
                                     size_t num_samples) {
   size_t base = blockIdx.x * blockDim.x + threadIdx.x;
@@ -1715,10 +2084,6 @@ HitRate<T>::HitRate(int batch_size_per_gpu,
       num_local_gpus_(resource_manager_->get_local_gpu_count()),
       checked_count_(resource_manager_->get_local_gpu_count()),
       hit_count_(resource_manager_->get_local_gpu_count()),
-      checked_local_(std::vector<int>(resource_manager->get_local_gpu_count(), 0)),
-      hits_local_(std::vector<int>(resource_manager->get_local_gpu_count(), 0)),
-      hits_global_(0),
-      checked_global_(0),
       n_batches_(0) {
   for (int i = 0; i < num_local_gpus_; i++) {
     int device_id = resource_manager_->get_local_gpu(i)->get_device_id();
@@ -1726,6 +2091,8 @@ HitRate<T>::HitRate(int batch_size_per_gpu,
 
     HCTR_LIB_THROW(cudaMalloc((void**)(&(checked_count_[i])), sizeof(int)));
     HCTR_LIB_THROW(cudaMalloc((void**)(&(hit_count_[i])), sizeof(int)));
+    HCTR_LIB_THROW(cudaMemset(checked_count_[i], 0, sizeof(int)));
+    HCTR_LIB_THROW(cudaMemset(hit_count_[i], 0, sizeof(int)));
   }
 }
 
@@ -1772,34 +2139,36 @@ void HitRate<T>::local_reduce(int local_gpu_id, Core23RawMetricMap raw_metrics)
   dim3 grid(160, 1, 1);
   dim3 block(1024, 1, 1);
 
-  HCTR_LIB_THROW(
-      cudaMemsetAsync(checked_count_[local_gpu_id], 0, sizeof(int), local_gpu->get_stream()));
-  HCTR_LIB_THROW(
-      cudaMemsetAsync(hit_count_[local_gpu_id], 0, sizeof(int), local_gpu->get_stream()));
-
+  // The counts are summed over the batches on the device, and only read by finalize_metric()
   collect_hits<T><<<grid, block, 0, local_gpu->get_stream()>>>(
       pred_tensor.data<T>(), label_tensor.data<T>(), num_valid_samples,
       checked_count_[local_gpu_id], hit_count_[local_gpu_id]);
-  int checked_host = 0;
-  int hits_host = 0;
-  HCTR_LIB_THROW(cudaMemcpyAsync(&checked_host, checked_count_[local_gpu_id], sizeof(int),
-                                 cudaMemcpyDeviceToHost, local_gpu->get_stream()));
-  checked_local_[local_gpu_id] = checked_host;
-  HCTR_LIB_THROW(cudaMemcpyAsync(&hits_host, hit_count_[local_gpu_id], sizeof(int),
-                                 cudaMemcpyDeviceToHost, local_gpu->get_stream()));
-  hits_local_[local_gpu_id] = hits_host;
 }
 
 template <typename T>
 void HitRate<T>::global_reduce(int n_nets) {
+  n_batches_++;
+}
+
+template <typename T>
+float HitRate<T>::finalize_metric() {
   int checked_inter = 0;
   int hits_inter = 0;
-
-  for (auto& hits_local : hits_local_) {
-    hits_inter += hits_local;
-  }
-  for (auto& checked_local : checked_local_) {
-    checked_inter += checked_local;
+  for (int i = 0; i < num_local_gpus_; i++) {
+    const auto& local_gpu = resource_manager_->get_local_gpu(i);
+    CudaDeviceContext context(local_gpu->get_device_id());
+    auto stream = local_gpu->get_stream();
+    int checked_host = 0;
+    int hits_host = 0;
+    HCTR_LIB_THROW(cudaMemcpyAsync(&checked_host, checked_count_[i], sizeof(int),
+                                   cudaMemcpyDeviceToHost, stream));
+    HCTR_LIB_THROW(
+        cudaMemcpyAsync(&hits_host, hit_count_[i], sizeof(int), cudaMemcpyDeviceToHost, stream));
+    HCTR_LIB_THROW(cudaMemsetAsync(checked_count_[i], 0, sizeof(int), stream));
+    HCTR_LIB_THROW(cudaMemsetAsync(hit_count_[i], 0, sizeof(int), stream));
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    checked_inter += checked_host;
+    hits_inter += hits_host;
   }
 
 #ifdef ENABLE_MPI
@@ -1814,32 +2183,16 @@ void HitRate<T>::global_reduce(int n_nets) {
   }
 #endif
 
-  hits_global_ += hits_inter;
-  checked_global_ += checked_inter;
-
-  n_batches_++;
-}
-
-template <typename T>
-float HitRate<T>::finalize_metric() {
   float ret = 0.0f;
   if (resource_manager_->is_master_process()) {
     if (n_batches_) {
-      ret = ((float)hits_global_) / (float)(checked_global_);
+      ret = ((float)hits_inter) / (float)(checked_inter);
     }
   }
 #ifdef ENABLE_MPI
   HCTR_MPI_THROW(MPI_Barrier(MPI_COMM_WORLD));
   HCTR_MPI_THROW(MPI_Bcast(&ret, 1, MPI_FLOAT, 0, MPI_COMM_WORLD));
 #endif
-  hits_global_ = 0;
-  checked_global_ = 0;
-  for (auto& hits_local : hits_local_) {
-    hits_local = 0;
-  }
-  for (auto& checked_local : checked_local_) {
-    checked_local = 0;
-  }
   n_batches_ = 0;
   return ret;
 }
@@ -1852,15 +2205,13 @@ SMAPE<T>::SMAPE(int batch_size_per_gpu, const std::shared_ptr<ResourceManager>&
       resource_manager_(resource_manager),
       num_local_gpus_(resource_manager_->get_local_gpu_count()),
       error_(resource_manager_->get_local_gpu_count()),
-      checked_local_(std::vector<int>(resource_manager->get_local_gpu_count(), 0)),
-      error_local_(std::vector<float>(resource_manager->get_local_gpu_count(), 0)),
-      checked_global_(0),
-      error_global_(0),
+      checked_local_(std::vector<long long>(resource_manager->get_local_gpu_count(), 0)),
       n_batches_(0) {
   for (int i = 0; i < num_local_gpus_; i++) {
     int device_id = resource_manager_->get_local_gpu(i)->get_device_id();
     CudaDeviceContext context(device_id);
     HCTR_LIB_THROW(cudaMalloc((void**)(&(error_[i])), sizeof(float)));
+    HCTR_LIB_THROW(cudaMemset(error_[i], 0, sizeof(float)));
   }
 }
 
@@ -1903,66 +2254,58 @@ void SMAPE<T>::local_reduce(int local_gpu_id, Core23RawMetricMap raw_metrics) {
   dim3 grid(160, 1, 1);
   dim3 block(1024, 1, 1);
 
-  cudaMemsetAsync(error_[local_gpu_id], 0, sizeof(float), local_gpu->get_stream());
+  // The error is summed over the batches on the device, and only read by finalize_metric()
   collect_error<T><<<grid, block, 0, local_gpu->get_stream()>>>(
       pred_tensor.data<T>(), label_tensor.data<T>(), num_valid_samples, error_[local_gpu_id]);
-
-  checked_local_[local_gpu_id] = num_valid_samples;
-  HCTR_LIB_THROW(cudaMemcpyAsync(&error_local_[local_gpu_id], error_[local_gpu_id], sizeof(float),
-                                 cudaMemcpyDeviceToHost, local_gpu->get_stream()));
+  checked_local_[local_gpu_id] += num_valid_samples;
 }
 
 template <typename T>
 void SMAPE<T>::global_reduce(int n_nets) {
-  int checked_inter = 0;
-  float error_inter = 0;
+  n_batches_++;
+}
 
-  for (auto& error_local : error_local_) {
-    error_inter += error_local;
-  }
-  for (auto& checked_local : checked_local_) {
-    checked_inter += checked_local;
+template <typename T>
+float SMAPE<T>::finalize_metric() {
+  long long checked_inter = 0;
+  float error_inter = 0;
+  for (int i = 0; i < num_local_gpus_; i++) {
+    const auto& local_gpu = resource_manager_->get_local_gpu(i);
+    CudaDeviceContext context(local_gpu->get_device_id());
+    auto stream = local_gpu->get_stream();
+    float error_host = 0;
+    HCTR_LIB_THROW(
+        cudaMemcpyAsync(&error_host, error_[i], sizeof(float), cudaMemcpyDeviceToHost, stream));
+    HCTR_LIB_THROW(cudaMemsetAsync(error_[i], 0, sizeof(float), stream));
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    error_inter += error_host;
+    checked_inter += checked_local_[i];
+    checked_local_[i] = 0;
   }
 
 #ifdef ENABLE_MPI
   if (resource_manager_->get_num_process() > 1) {
     float error_reduced = 0;
-    int checked_reduced = 0;
+    long long checked_reduced = 0;
     HCTR_MPI_THROW(
         MPI_Reduce(&error_inter, &error_reduced, 1, MPI_FLOAT, MPI_SUM, 0, MPI_COMM_WORLD));
-    HCTR_MPI_THROW(
-        MPI_Reduce(&checked_inter, &checked_reduced, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD));
+    HCTR_MPI_THROW(MPI_Reduce(&checked_inter, &checked_reduced, 1, MPI_LONG_LONG, MPI_SUM, 0,
+                              MPI_COMM_WORLD));
     error_inter = error_reduced;
     checked_inter = checked_reduced;
   }
 #endif
 
-  error_global_ += error_inter;
-  checked_global_ += checked_inter;
-
-  n_batches_++;
-}
-
-template <typename T>
-float SMAPE<T>::finalize_metric() {
   float ret = 0.0f;
   if (resource_manager_->is_master_process()) {
     if (n_batches_) {
-      ret = ((float)error_global_) / (float)(checked_global_);
+      ret = ((float)error_inter) / (float)(checked_inter);
     }
   }
 #ifdef ENABLE_MPI
   HCTR_MPI_THROW(MPI_Barrier(MPI_COMM_WORLD));
   HCTR_MPI_THROW(MPI_Bcast(&ret, 1, MPI_FLOAT, 0, MPI_COMM_WORLD));
 #endif
-  error_global_ = 0;
-  checked_global_ = 0;
-  for (auto& error_local : error_local_) {
-    error_local = 0;
-  }
-  for (auto& checked_local : checked_local_) {
-    checked_local = 0;
-  }
   n_batches_ = 0;
   return ret;
 }
@@ -2148,6 +2491,10 @@ void ReallocBuffer<T, U>::release_mmap_memory() {
 template class AverageLoss<float>;
 template class AUC<float>;
 template class AUC<__half>;
+template class StreamingAUC<float>;
+template class StreamingAUC<__half>;
+template class QueryMetric<float>;
+template class QueryMetric<__half>;
 template class HitRate<float>;
 
 }  // namespace metrics
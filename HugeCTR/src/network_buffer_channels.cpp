@@ -28,6 +28,8 @@ static std::unordered_map<NetworkBufferChannelType, std::string> g_type_to_name
     {NetworkBufferChannelType::WgradHalf, "WGH"}, {NetworkBufferChannelType::OptState, "OPT"},
 };
 
+static int64_t g_activation_step = -1;
+
 }  // namespace
 std::string SetNetworkBufferChannel(NetworkBufferChannelType type, const std::string& new_name) {
   if (g_type_to_name.find(type) == g_type_to_name.end()) {
@@ -69,4 +71,12 @@ core23::BufferChannel GetOptStateBufferChannnel() {
   return GetNetworkBufferChannel(NetworkBufferChannelType::OptState);
 }
 
+int64_t SetActivationStep(int64_t step) {
+  auto original = g_activation_step;
+  g_activation_step = step;
+  return original;
+}
+
+int64_t GetActivationStep() { return g_activation_step; }
+
 }  // namespace HugeCTR
@@ -38,9 +38,11 @@ template <typename T>
 std::unique_ptr<Optimizer> Optimizer::Create(
     const OptParams& params, std::vector<core23::Tensor> weight_tensors,
     std::vector<core23::Tensor> weight_half_tensors, std::vector<core23::Tensor> wgrad_tensors,
-    const float scaler, const std::shared_ptr<GPUResource>& gpu_resource, bool use_mixed_precision)
-
-{
+    const float scaler, const std::shared_ptr<GPUResource>& gpu_resource, bool use_mixed_precision,
+    std::optional<WeightShard> shard) {
+  if (shard && params.optimizer != Optimizer_t::Adam && params.optimizer != Optimizer_t::LazyAdam) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "Only the Adam optimizer can be sharded");
+  }
   WeightTensors weight_tensor_container(weight_tensors,
                                         {static_cast<int64_t>(weight_tensors.size())});
   WgradTensors<T> wgrad_tensor_container(wgrad_tensors,
@@ -56,16 +58,20 @@ std::unique_ptr<Optimizer> Optimizer::Create(
                                      lr, beta, lambda1, lambda2, scaler));
     } break;
 
-    case Optimizer_t::Adam: {
+    // The row-wise states of these only pay off for embedding tables, whose rows are sparsely
+    // updated. Dense weights are updated element-wise.
+    case Optimizer_t::Adam:
+    case Optimizer_t::LazyAdam: {
       auto lr = params.lr;
       auto beta1 = params.hyperparams.adam.beta1;
       auto beta2 = params.hyperparams.adam.beta2;
       auto epsilon = params.hyperparams.adam.epsilon;
       ret.reset(new AdamOptimizer<T>(weight_tensor_container, wgrad_tensor_container, gpu_resource,
-                                     lr, beta1, beta2, epsilon, scaler));
+                                     lr, beta1, beta2, epsilon, scaler, shard));
     } break;
 
-    case Optimizer_t::AdaGrad: {
+    case Optimizer_t::AdaGrad:
+    case Optimizer_t::RowWiseAdaGrad: {
       auto lr = params.lr;
       auto initial_accu_value = params.hyperparams.adagrad.initial_accu_value;
       auto epsilon = params.hyperparams.adagrad.epsilon;
@@ -106,11 +112,13 @@ std::unique_ptr<Optimizer> Optimizer::Create(
 template std::unique_ptr<Optimizer> Optimizer::Create<float>(
     const OptParams& params, std::vector<core23::Tensor> weight_tensors,
     std::vector<core23::Tensor> weight_half_tensors, std::vector<core23::Tensor> wgrad_tensors,
-    const float scaler, const std::shared_ptr<GPUResource>& gpu_resource, bool use_mixed_precision);
+    const float scaler, const std::shared_ptr<GPUResource>& gpu_resource, bool use_mixed_precision,
+    std::optional<WeightShard> shard);
 
 template std::unique_ptr<Optimizer> Optimizer::Create<__half>(
     const OptParams& params, std::vector<core23::Tensor> weight_tensors,
     std::vector<core23::Tensor> weight_half_tensors, std::vector<core23::Tensor> wgrad_tensors,
-    const float scaler, const std::shared_ptr<GPUResource>& gpu_resource, bool use_mixed_precision);
+    const float scaler, const std::shared_ptr<GPUResource>& gpu_resource, bool use_mixed_precision,
+    std::optional<WeightShard> shard);
 
 }  // end namespace HugeCTR
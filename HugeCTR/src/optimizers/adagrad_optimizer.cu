@@ -24,7 +24,8 @@ namespace {
 
 template <typename T>
 __global__ void ada_grad_update4_kernel(size_t len, float* weight, const T* wgrad, float* sum,
-                                        float lr, const float epsilon, float scaler) {
+                                        RegularizationGrad regularization, float lr,
+                                        const float epsilon, float scaler) {
   size_t num_threads_in_grid = static_cast<size_t>(gridDim.x) * blockDim.x;
   constexpr int group_size = 4;
   using T4 = typename std::conditional<(sizeof(T) == 4), float4, float2>::type;
@@ -32,11 +33,15 @@ __global__ void ada_grad_update4_kernel(size_t len, float* weight, const T* wgra
 
   for (size_t i = static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x; i < new_len;
        i += num_threads_in_grid) {
+    float4 weight_group = *reinterpret_cast<float4*>(weight + i * group_size);
+    float* weight_ = reinterpret_cast<float*>(&weight_group);
     T4 gi_group = *reinterpret_cast<const T4*>(wgrad + i * group_size);
     float gi[group_size];
 #pragma unroll group_size
     for (int j = 0; j < group_size; j++) {
-      gi[j] = TypeConvertFunc<float, T>::convert(reinterpret_cast<T*>(&gi_group)[j]) / scaler;
+      gi[j] = (TypeConvertFunc<float, T>::convert(reinterpret_cast<T*>(&gi_group)[j]) +
+               regularization(weight_[j])) /
+              scaler;
     }
 
     float4 accum_group = *reinterpret_cast<float4*>(sum + i * group_size);
@@ -52,8 +57,6 @@ __global__ void ada_grad_update4_kernel(size_t len, float* weight, const T* wgra
       std_[j] = epsilon + sqrtf(accum_[j]);
     }
 
-    float4 weight_group = *reinterpret_cast<float4*>(weight + i * group_size);
-    float* weight_ = reinterpret_cast<float*>(&weight_group);
 #pragma unroll group_size
     for (int j = 0; j < group_size; j++) {
       weight_[j] -= lr * gi[j] / std_[j];
@@ -65,7 +68,7 @@ __global__ void ada_grad_update4_kernel(size_t len, float* weight, const T* wgra
 
   size_t i = static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x + new_len * group_size;
   if (i < len) {
-    float gi = TypeConvertFunc<float, T>::convert(wgrad[i]) / scaler;
+    float gi = (TypeConvertFunc<float, T>::convert(wgrad[i]) + regularization(weight[i])) / scaler;
     float accum_ = sum[i];
     accum_ += gi * gi;
     float std_ = epsilon + sqrtf(accum_);
@@ -75,11 +78,12 @@ __global__ void ada_grad_update4_kernel(size_t len, float* weight, const T* wgra
 }
 
 template <typename T>
-__global__ void ada_grad_update_kernel(int len, float* weight, const T* wgrad, float* sum, float lr,
+__global__ void ada_grad_update_kernel(int len, float* weight, const T* wgrad, float* sum,
+                                       RegularizationGrad regularization, float lr,
                                        const float epsilon, float scaler) {
   const int i = blockIdx.x * blockDim.x + threadIdx.x;
   if (i < len) {
-    float gi = TypeConvertFunc<float, T>::convert(wgrad[i]) / scaler;
+    float gi = (TypeConvertFunc<float, T>::convert(wgrad[i]) + regularization(weight[i])) / scaler;
     float accum_ = sum[i];
     accum_ += gi * gi;
     float std_ = epsilon + sqrtf(accum_);
@@ -132,11 +136,11 @@ void AdaGradOptimizer<T>::update() {
     auto max_thread_per_sm = gpu_resource_->get_max_thread_per_sm();
     size_t grid_dim = num_sms * max_thread_per_sm / block_dim;
     ada_grad_update4_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
-        len, weight, wgrad, accum, lr_, epsilon_, scaler_);
+        len, weight, wgrad, accum, regularization_grad_, lr_, epsilon_, scaler_);
   } else {
     size_t grid_dim = (len - 1) / block_dim + 1;
     ada_grad_update_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
-        len, weight, wgrad, accum, lr_, epsilon_, scaler_);
+        len, weight, wgrad, accum, regularization_grad_, lr_, epsilon_, scaler_);
   }
 }
 
@@ -26,11 +26,11 @@ namespace {
 
 template <typename T>
 __global__ void adam_update_kernel(int len, float* weight, float* m, float* v, const T* wgrad,
-                                   float alpha_t, float beta1, float beta2, float epsilon,
-                                   float scaler) {
+                                   RegularizationGrad regularization, float alpha_t, float beta1,
+                                   float beta2, float epsilon, float scaler) {
   const int i = blockIdx.x * blockDim.x + threadIdx.x;
   if (i < len) {
-    float gi = TypeConvertFunc<float, T>::convert(wgrad[i]) / scaler;
+    float gi = (TypeConvertFunc<float, T>::convert(wgrad[i]) + regularization(weight[i])) / scaler;
     float mi = beta1 * m[i] + (1.f - beta1) * gi;
     float vi = beta2 * v[i] + (1.f - beta2) * gi * gi;
     m[i] = mi;
@@ -46,18 +46,22 @@ AdamOptimizer<T>::AdamOptimizer(std::optional<WeightTensors> weight_tensors,
                                 std::optional<WgradTensors<T>> wgrad_tensors,
                                 const std::shared_ptr<GPUResource>& gpu_resource,
                                 float learning_rate, float beta1, float beta2, float epsilon,
-                                float scaler)
+                                float scaler, std::optional<WeightShard> shard)
     : Optimizer(weight_tensors, gpu_resource, learning_rate, scaler),
       wgrad_tensors_(wgrad_tensors),
+      shard_(shard.value_or(WeightShard(0, weight_tensors_->flatten().size(0)))),
       t_(0),
       beta1_(beta1),
       beta2_(beta2),
       epsilon_(epsilon) {
+  HCTR_CHECK_HINT(0 <= shard_.first && shard_.first <= shard_.second &&
+                      shard_.second <= weight_tensors_->flatten().size(0),
+                  "invalid weight shard");
   core23::TensorParams tensor_params =
       core23::TensorParams()
           .device(core23::Device(core23::DeviceType::GPU, gpu_resource->get_device_id()))
           .data_type(core23::ScalarType::Float)
-          .shape(core23::Shape({weight_tensors_->flatten().size(0)}))
+          .shape(core23::Shape({shard_.second - shard_.first}))
           .buffer_channel(GetOptStateBufferChannnel());
 
   m_tensor_ = core23::Tensor(tensor_params);
@@ -83,17 +87,17 @@ void AdamOptimizer<T>::update() {
 
   auto flat_weight_tensor = weight_tensors_->flatten();
   auto flat_wgrad_tensor = wgrad_tensors_->flatten();
-  float* weight = flat_weight_tensor.data();
-  const T* wgrad = flat_wgrad_tensor.data();
+  float* weight = flat_weight_tensor.data() + shard_.first;
+  const T* wgrad = flat_wgrad_tensor.data() + shard_.first;
 
-  auto len = flat_weight_tensor.size(0);
+  auto len = shard_.second - shard_.first;
   const size_t grid_dim = (len - 1) / block_dim + 1;
 
   float* m = m_tensor_.data<float>();
   float* v = v_tensor_.data<float>();
 
   adam_update_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
-      len, weight, m, v, wgrad, alpha_t, beta1_, beta2_, epsilon_, scaler_);
+      len, weight, m, v, wgrad, regularization_grad_, alpha_t, beta1_, beta2_, epsilon_, scaler_);
 }
 
 template class AdamOptimizer<float>;
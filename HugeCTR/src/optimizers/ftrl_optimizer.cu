@@ -26,11 +26,11 @@ namespace {
 
 template <typename T>
 __global__ void ftrl_update_kernel(int len, float* weight, float* z, float* n, const T* wgrad,
-                                   float alpha, float beta, float lambda1, float lambda2,
-                                   float scaler) {
+                                   RegularizationGrad regularization, float alpha, float beta,
+                                   float lambda1, float lambda2, float scaler) {
   const int i = blockIdx.x * blockDim.x + threadIdx.x;
   if (i < len) {
-    float gi = TypeConvertFunc<float, T>::convert(wgrad[i]) / scaler;
+    float gi = (TypeConvertFunc<float, T>::convert(wgrad[i]) + regularization(weight[i])) / scaler;
     float ni_new = n[i] + gi * gi;
     float zi =
         z[i] + gi + (sqrtf(n[i] + FLT_EPSILON) - sqrtf(ni_new + FLT_EPSILON)) * weight[i] / alpha;
@@ -90,7 +90,8 @@ void FtrlOptimizer<T>::update() {
   float* z = z_tensor_.data<float>();
   float* n = n_tensor_.data<float>();
   ftrl_update_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
-      len, weight, z, n, wgrad, lr_, beta_, lambda1_, lambda2_ + beta_ / lr_, scaler_);
+      len, weight, z, n, wgrad, regularization_grad_, lr_, beta_, lambda1_, lambda2_ + beta_ / lr_,
+      scaler_);
 }
 
 template class FtrlOptimizer<float>;
@@ -25,11 +25,12 @@ namespace {
 
 template <typename T>
 __global__ void momentum_sgd_update_kernel(int len, float* weight, float* momentum, const T* wgrad,
-                                           float lr, float momentum_factor, float scaler) {
+                                           RegularizationGrad regularization, float lr,
+                                           float momentum_factor, float scaler) {
   int idx = blockDim.x * blockIdx.x + threadIdx.x;
   if (idx < len) {
-    float mv = momentum_factor * momentum[idx] -
-               lr * TypeConvertFunc<float, T>::convert(wgrad[idx]) / scaler;
+    float gi = TypeConvertFunc<float, T>::convert(wgrad[idx]) + regularization(weight[idx]);
+    float mv = momentum_factor * momentum[idx] - lr * gi / scaler;
     momentum[idx] = mv;
     weight[idx] += mv;
   }
@@ -78,7 +79,7 @@ void MomentumSGDOptimizer<T>::update() {
 
   float* momentum = momentum_tensor_.data<float>();
   momentum_sgd_update_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
-      len, weight, momentum, wgrad, lr_, momentum_factor_, scaler_);
+      len, weight, momentum, wgrad, regularization_grad_, lr_, momentum_factor_, scaler_);
 }
 
 template class MomentumSGDOptimizer<float>;
@@ -25,11 +25,13 @@ namespace {
 
 template <typename T>
 __global__ void nesterov_update_kernel(int len, float* weight, float* accum, const T* wgrad,
-                                       float lr, float mu, float scaler) {
+                                       RegularizationGrad regularization, float lr, float mu,
+                                       float scaler) {
   const int i = blockIdx.x * blockDim.x + threadIdx.x;
   if (i < len) {
+    float gi = TypeConvertFunc<float, T>::convert(wgrad[i]) + regularization(weight[i]);
     float accum_old = accum[i];
-    float accum_new = mu * accum_old - lr * TypeConvertFunc<float, T>::convert(wgrad[i]) / scaler;
+    float accum_new = mu * accum_old - lr * gi / scaler;
     accum[i] = accum_new;
     weight[i] += (-mu * accum_old + (1.f + mu) * accum_new);
   }
@@ -75,7 +77,7 @@ void NesterovOptimizer<T>::update() {
   float* accum = accum_tensor_.data<float>();
   const size_t grid_dim = (len - 1) / block_dim + 1;
   nesterov_update_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
-      len, weight, accum, wgrad, lr_, mu_, scaler_);
+      len, weight, accum, wgrad, regularization_grad_, lr_, mu_, scaler_);
 }
 
 template class NesterovOptimizer<float>;
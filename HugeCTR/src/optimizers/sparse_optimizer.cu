@@ -91,6 +91,14 @@ EmbeddingOptimizer<TypeHashKey, TypeEmbeddingComp>::EmbeddingOptimizer(
                  &hash_value_flag_sumed_tensors_);
   }
   { buf->reserve({1, 1}, &hash_value_index_count_counter_tensors_); }
+  if (param.opt_params.fused_update) {
+    // A batch has at most one unique row per key, and at most every row of the table
+    size_t max_num_unique_rows =
+        std::min(param.get_batch_size(true) * param.max_feature_num, max_vocabulary_size_per_gpu_);
+    buf->reserve({max_vocabulary_size_per_gpu_}, &row_unique_index_tensors_);
+    buf->reserve({max_num_unique_rows}, &unique_rows_tensors_);
+    buf->reserve({max_num_unique_rows, param.embedding_vec_size}, &unique_wgrad_tensors_);
+  }
   {
     // cal the temp storage bytes for CUB radix sort
     size_t size = 0;
@@ -165,10 +173,23 @@ void EmbeddingOptimizer<TypeHashKey, TypeEmbeddingComp>::initialize(const GPURes
     default:
       throw std::runtime_error("[HCDEBUG][ERROR] Runtime error: Invalid optimizer type\n");
   }
+
+  if (param.opt_params.fused_update) {
+    // Every row starts out without a unique index, and is reset to that by the update
+    HCTR_LIB_THROW(cudaMemsetAsync(row_unique_index_tensors_.get_ptr(), 0xFF,
+                                   row_unique_index_tensors_.get_size_in_bytes(),
+                                   local_gpu.get_stream()));
+    HCTR_LIB_THROW(cudaMemsetAsync(unique_wgrad_tensors_.get_ptr(), 0,
+                                   unique_wgrad_tensors_.get_size_in_bytes(),
+                                   local_gpu.get_stream()));
+  }
 }
 
 namespace {
 
+constexpr uint32_t kNoUniqueIndex = 0xFFFFFFFFu;
+constexpr uint32_t kClaimedUniqueIndex = 0xFFFFFFFEu;
+
 __global__ void value_count_kernel_2(int nnz, const uint32_t *new_hash_value_flag,
                                      const uint32_t *hash_value_flag_sumed,
                                      uint32_t *hash_value_index_index, uint32_t *counter) {
@@ -603,6 +624,166 @@ __global__ void opt_sgd_atomic_kernel(int nnz, int embedding_vec_size, float lr_
   }
 }
 
+// Fused update, step 1: the first key of every row claims the next unique index for it
+__global__ void fused_unique_rows_kernel(size_t nnz, const size_t *hash_value_index,
+                                         uint32_t *row_unique_index, size_t *unique_rows,
+                                         uint32_t *num_unique_rows) {
+  CUDA_1D_KERNEL_LOOP_T(size_t, key_id, nnz) {
+    const size_t row_index = hash_value_index[key_id];
+    if (atomicCAS(&row_unique_index[row_index], kNoUniqueIndex, kClaimedUniqueIndex) ==
+        kNoUniqueIndex) {
+      const uint32_t unique_index = atomicAdd(num_unique_rows, 1u);
+      unique_rows[unique_index] = row_index;
+      row_unique_index[row_index] = unique_index;
+    }
+  }
+}
+
+// Fused update, step 2: sum the gradients of every key into its unique row
+template <typename TypeKey, typename TypeEmbeddingComp>
+__global__ void fused_aggregate_wgrad_kernel(size_t nnz, int embedding_vec_size,
+                                             const TypeKey *sample_id,
+                                             const size_t *hash_value_index,
+                                             const uint32_t *row_unique_index,
+                                             const TypeEmbeddingComp *wgrad, float *unique_wgrad) {
+  int tid = threadIdx.x;
+
+  if (tid < embedding_vec_size) {
+    for (size_t key_id = blockIdx.x; key_id < nnz; key_id += gridDim.x) {
+      const size_t unique_index = row_unique_index[hash_value_index[key_id]];
+      const size_t sample_index = sample_id[key_id];
+      atomicAdd(&unique_wgrad[unique_index * embedding_vec_size + tid],
+                TypeConvertFunc<float, TypeEmbeddingComp>::convert(
+                    wgrad[sample_index * embedding_vec_size + tid]));
+    }
+  }
+}
+
+// Fused update, step 3: the optimizers, they update their state of one element and return the
+// weight difference. Same math as the local (and lazy global) kernels above.
+template <typename TypeEmbeddingComp>
+struct FusedAdamOp {
+  AdamOptHyperParams adam;
+  TypeEmbeddingComp *m_ptr;
+  TypeEmbeddingComp *v_ptr;
+  float alpha_t;
+
+  __device__ __forceinline__ float operator()(size_t feature_index, float gi) const {
+    float mi =
+        adam.beta1 * TypeConvertFunc<float, TypeEmbeddingComp>::convert(m_ptr[feature_index]) +
+        (1.0f - adam.beta1) * gi;
+    float vi =
+        adam.beta2 * TypeConvertFunc<float, TypeEmbeddingComp>::convert(v_ptr[feature_index]) +
+        (1.0f - adam.beta2) * gi * gi;
+    m_ptr[feature_index] = TypeConvertFunc<TypeEmbeddingComp, float>::convert(mi);
+    v_ptr[feature_index] = TypeConvertFunc<TypeEmbeddingComp, float>::convert(vi);
+    return -alpha_t * mi / (sqrtf(vi) + adam.epsilon);
+  }
+};
+
+template <typename TypeEmbeddingComp>
+struct FusedLazyAdamOp {
+  AdamOptHyperParams adam;
+  uint64_t *prev_time_ptr;
+  TypeEmbeddingComp *m_ptr;
+  TypeEmbeddingComp *v_ptr;
+  float alpha_t_common;
+  uint64_t times;
+
+  __device__ __forceinline__ float operator()(size_t feature_index, float gi) const {
+    uint64_t prev_time = prev_time_ptr[feature_index];
+    prev_time_ptr[feature_index] = times;
+    uint64_t skipped = times - prev_time;
+    float beta1_pow_skipped = powf(adam.beta1, skipped);
+    float alpha_t = alpha_t_common * sqrtf(1.0f - powf(adam.beta2, prev_time)) /
+                    (1.0f - powf(adam.beta1, prev_time)) * (1.0f - beta1_pow_skipped);
+    float mi = TypeConvertFunc<float, TypeEmbeddingComp>::convert(m_ptr[feature_index]);
+    float vi = TypeConvertFunc<float, TypeEmbeddingComp>::convert(v_ptr[feature_index]);
+    float weight_diff = -alpha_t * mi / (sqrtf(vi) + adam.epsilon);
+
+    mi = beta1_pow_skipped * mi + (1.0f - adam.beta1) * gi;
+    vi = powf(adam.beta2, skipped) * vi + (1.0f - adam.beta2) * gi * gi;
+    m_ptr[feature_index] = TypeConvertFunc<TypeEmbeddingComp, float>::convert(mi);
+    v_ptr[feature_index] = TypeConvertFunc<TypeEmbeddingComp, float>::convert(vi);
+    return weight_diff;
+  }
+};
+
+template <typename TypeEmbeddingComp>
+struct FusedAdaGradOp {
+  float lr;
+  AdaGradOptHyperParams adagrad;
+  TypeEmbeddingComp *accum_ptr;
+
+  __device__ __forceinline__ float operator()(size_t feature_index, float gi) const {
+    float accum =
+        TypeConvertFunc<float, TypeEmbeddingComp>::convert(accum_ptr[feature_index]) + gi * gi;
+    accum_ptr[feature_index] = TypeConvertFunc<TypeEmbeddingComp, float>::convert(accum);
+    return -lr * gi / (sqrtf(accum) + adagrad.epsilon);
+  }
+};
+
+template <typename TypeEmbeddingComp>
+struct FusedMomentumSGDOp {
+  float lr;
+  MomentumSGDOptHyperParams momentum;
+  TypeEmbeddingComp *momentum_ptr;
+
+  __device__ __forceinline__ float operator()(size_t feature_index, float gi) const {
+    float mo = momentum.factor *
+                   TypeConvertFunc<float, TypeEmbeddingComp>::convert(momentum_ptr[feature_index]) -
+               lr * gi;
+    momentum_ptr[feature_index] = TypeConvertFunc<TypeEmbeddingComp, float>::convert(mo);
+    return mo;
+  }
+};
+
+template <typename TypeEmbeddingComp>
+struct FusedNesterovOp {
+  float lr;
+  NesterovOptHyperParams nesterov;
+  TypeEmbeddingComp *accm_ptr;
+
+  __device__ __forceinline__ float operator()(size_t feature_index, float gi) const {
+    float accm_old = TypeConvertFunc<float, TypeEmbeddingComp>::convert(accm_ptr[feature_index]);
+    float accm_new = nesterov.mu * accm_old - lr * gi;
+    accm_ptr[feature_index] = TypeConvertFunc<TypeEmbeddingComp, float>::convert(accm_new);
+    return -nesterov.mu * accm_old + (1.0f + nesterov.mu) * accm_new;
+  }
+};
+
+struct FusedSGDOp {
+  float lr;
+
+  __device__ __forceinline__ float operator()(size_t, float gi) const { return -lr * gi; }
+};
+
+// The number of unique rows is read on the device, the grid strides over them. The aggregated
+// gradients and the unique indices are reset for the next batch on the way.
+template <typename UpdateOp>
+__global__ void fused_update_kernel(const uint32_t *num_unique_rows, int embedding_vec_size,
+                                    const size_t *unique_rows, uint32_t *row_unique_index,
+                                    float *unique_wgrad, float *hash_table_value, float scaler,
+                                    UpdateOp op) {
+  int tid = threadIdx.x;
+  const uint32_t num_rows = *num_unique_rows;
+
+  for (uint32_t unique_index = blockIdx.x; unique_index < num_rows; unique_index += gridDim.x) {
+    const size_t row_index = unique_rows[unique_index];
+    if (tid < embedding_vec_size) {
+      float &wgrad = unique_wgrad[static_cast<size_t>(unique_index) * embedding_vec_size + tid];
+      const float gi = wgrad / scaler;
+      wgrad = 0.f;
+
+      size_t feature_index = row_index * embedding_vec_size + tid;
+      hash_table_value[feature_index] += op(feature_index, gi);
+    }
+    if (tid == 0) {
+      row_unique_index[row_index] = kNoUniqueIndex;
+    }
+  }
+}
+
 }  // namespace
 
 // update embedding table: including several steps as below,
@@ -642,6 +823,15 @@ void EmbeddingOptimizer<TypeHashKey, TypeEmbeddingComp>::update(
 
   size_t block_size, grid_size;
 
+  // The fused update handles the optimizers that only touch the rows of the batch
+  const Optimizer_t optimizer = opt_params.optimizer;
+  const bool fused_update =
+      opt_params.fused_update &&
+      (opt_params.update_type == Update_t::Local ||
+       (opt_params.update_type == Update_t::LazyGlobal && optimizer == Optimizer_t::Adam) ||
+       (opt_params.update_type == Update_t::Global &&
+        (optimizer == Optimizer_t::AdaGrad || optimizer == Optimizer_t::SGD)));
+
   try {
     // step1: expand sample IDs
     block_size = 64;
@@ -658,6 +848,63 @@ void EmbeddingOptimizer<TypeHashKey, TypeEmbeddingComp>::update(
       opt_sgd_atomic_kernel<<<grid_size, block_size, 0, stream>>>(
           nnz, embedding_vec_size, lr_scale, hash_value_index.get_ptr(), sample_id.get_ptr(),
           wgrad.get_ptr(), hash_table_value.get_ptr());
+    } else if (fused_update) {
+      // Sort-free: the gradients are summed into one row per unique hash_value_index with
+      // atomics, then one kernel applies the optimizer to the unique rows
+      uint32_t *num_unique_rows = hash_value_index_count_counter.get_ptr();
+      HCTR_LIB_THROW(cudaMemsetAsync(num_unique_rows, 0, sizeof(uint32_t), stream));
+
+      block_size = 256;
+      grid_size = min(sm_count * 8, (max(1ul, nnz) - 1) / block_size + 1);
+      fused_unique_rows_kernel<<<grid_size, block_size, 0, stream>>>(
+          nnz, hash_value_index.get_ptr(), row_unique_index_tensors_.get_ptr(),
+          unique_rows_tensors_.get_ptr(), num_unique_rows);
+
+      block_size = embedding_vec_size;
+      grid_size = min(max(1ul, nnz), sm_count * 32);
+      fused_aggregate_wgrad_kernel<<<grid_size, block_size, 0, stream>>>(
+          nnz, embedding_vec_size, sample_id.get_ptr(), hash_value_index.get_ptr(),
+          row_unique_index_tensors_.get_ptr(), wgrad.get_ptr(), unique_wgrad_tensors_.get_ptr());
+
+      auto launch_update = [&](auto op) {
+        fused_update_kernel<<<grid_size, block_size, 0, stream>>>(
+            num_unique_rows, embedding_vec_size, unique_rows_tensors_.get_ptr(),
+            row_unique_index_tensors_.get_ptr(), unique_wgrad_tensors_.get_ptr(),
+            hash_table_value.get_ptr(), opt_params.scaler, op);
+      };
+      const auto &hyperparams = opt_params.hyperparams;
+      switch (opt_params.optimizer) {
+        case Optimizer_t::Adam:
+          if (opt_params.update_type == Update_t::LazyGlobal) {
+            launch_update(FusedLazyAdamOp<TypeEmbeddingComp>{
+                hyperparams.adam, opt_tensor.opt_prev_time_tensors_.get_ptr(),
+                opt_tensor.opt_m_tensors_.get_ptr(), opt_tensor.opt_v_tensors_.get_ptr(),
+                opt_params.lr / (1.0f - hyperparams.adam.beta1), hyperparams.adam.times});
+          } else {
+            launch_update(FusedAdamOp<TypeEmbeddingComp>{
+                hyperparams.adam, opt_tensor.opt_m_tensors_.get_ptr(),
+                opt_tensor.opt_v_tensors_.get_ptr(), opt_params.lr * hyperparams.adam.bias()});
+          }
+          break;
+        case Optimizer_t::AdaGrad:
+          launch_update(FusedAdaGradOp<TypeEmbeddingComp>{opt_params.lr, hyperparams.adagrad,
+                                                          opt_tensor.opt_accm_tensors_.get_ptr()});
+          break;
+        case Optimizer_t::MomentumSGD:
+          launch_update(FusedMomentumSGDOp<TypeEmbeddingComp>{
+              opt_params.lr, hyperparams.momentum, opt_tensor.opt_momentum_tensors_.get_ptr()});
+          break;
+        case Optimizer_t::Nesterov:
+          launch_update(FusedNesterovOp<TypeEmbeddingComp>{
+              opt_params.lr, hyperparams.nesterov, opt_tensor.opt_accm_tensors_.get_ptr()});
+          break;
+        case Optimizer_t::SGD:
+          launch_update(FusedSGDOp{opt_params.lr});
+          break;
+        default:
+          HCTR_OWN_THROW(Error_t::WrongInput, "Error: Invalid opitimizer type");
+      }
+      HCTR_LIB_THROW(cudaPeekAtLastError());
     } else {
       // step3: sort by hash_value_index
       int end_bit = static_cast<int>(log2(static_cast<float>(max_vocabulary_size_per_gpu))) + 1;
@@ -64,11 +64,13 @@ std::unique_ptr<LearningRateScheduler> get_learning_rate_scheduler(
       break;
 
     case Optimizer_t::Adam:
+    case Optimizer_t::LazyAdam:
       j_hparam = get_json(j_optimizer, "adam_hparam");
       lr = get_value_from_json<float>(j_hparam, "learning_rate");
       break;
 
     case Optimizer_t::AdaGrad:
+    case Optimizer_t::RowWiseAdaGrad:
       j_hparam = get_json(j_optimizer, "adagrad_hparam");
       lr = get_value_from_json<float>(j_hparam, "learning_rate");
       break;
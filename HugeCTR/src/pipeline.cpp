@@ -16,6 +16,9 @@
 
 #include <unistd.h>
 
+#include <algorithm>
+#include <core23/instrumentation.hpp>
+#include <map>
 #include <pipeline.hpp>
 
 namespace HugeCTR {
@@ -84,6 +87,7 @@ void StreamContextScheduleable::run(std::shared_ptr<GPUResource> gpu, bool use_g
   CudaDeviceContext context{gpu->get_device_id()};
 
   auto [current_stream_name, priority] = get_stream_name(gpu);
+  HCTR_NVTX_RANGE("Scheduleable " + current_stream_name);
   StreamContext stream_context{gpu, current_stream_name, priority};
   cudaStream_t stream = gpu->get_stream();
   if (schedule_event_.has_value()) {
@@ -128,11 +132,207 @@ void GraphScheduleable::run(std::shared_ptr<GPUResource> gpu, bool use_graph) {
   graph_.exec(stream);
 }
 
+DependencyScheduleable::DependencyScheduleable(std::shared_ptr<Scheduleable> scheduleable,
+                                               const std::string &stream_name, int priority)
+    : scheduleable_(std::move(scheduleable)), stream_name_(stream_name), priority_(priority) {}
+
+DependencyScheduleable::~DependencyScheduleable() {
+  if (completion_event_) {
+    cudaEventDestroy(completion_event_.value());
+  }
+}
+
+cudaEvent_t DependencyScheduleable::record_done() {
+  if (!completion_event_) {
+    cudaEvent_t event;
+    HCTR_LIB_THROW(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+    completion_event_ = event;
+  }
+  return completion_event_.value();
+}
+
+void DependencyScheduleable::init(std::shared_ptr<GPUResource> gpu) {
+  CudaDeviceContext context{gpu->get_device_id()};
+
+  StreamContext stream_context{gpu, gpu->get_current_stream_name() + stream_name_, priority_};
+  if (scheduleable_) scheduleable_->init(gpu);
+}
+
+void DependencyScheduleable::run(std::shared_ptr<GPUResource> gpu, bool use_graph) {
+  CudaDeviceContext context{gpu->get_device_id()};
+
+  std::string current_stream_name = gpu->get_current_stream_name() + stream_name_;
+  HCTR_NVTX_RANGE("Scheduleable " + current_stream_name);
+  StreamContext stream_context{gpu, current_stream_name, priority_};
+  cudaStream_t stream = gpu->get_stream();
+  for (cudaEvent_t event : wait_events_) {
+    HCTR_LIB_THROW(cudaStreamWaitEvent(stream, event));
+  }
+  if (scheduleable_) scheduleable_->run(gpu, use_graph);
+  if (completion_event_.has_value()) {
+    HCTR_LIB_THROW(cudaEventRecord(completion_event_.value(), stream));
+  }
+}
+
+namespace {
+
+// Indices of the nodes each node has to wait for, from the buffers they read and write
+std::vector<std::vector<size_t>> get_predecessors(const std::vector<PipelineNode> &nodes) {
+  std::vector<std::vector<size_t>> predecessors(nodes.size());
+  std::map<std::string, size_t> last_writer;
+  std::map<std::string, std::vector<size_t>> readers;
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    auto &pred = predecessors[i];
+    for (auto &input : nodes[i].inputs) {
+      if (auto it = last_writer.find(input); it != last_writer.end()) pred.push_back(it->second);
+    }
+    for (auto &output : nodes[i].outputs) {
+      if (auto it = last_writer.find(output); it != last_writer.end()) pred.push_back(it->second);
+      pred.insert(pred.end(), readers[output].begin(), readers[output].end());
+    }
+    std::sort(pred.begin(), pred.end());
+    pred.erase(std::unique(pred.begin(), pred.end()), pred.end());
+    pred.erase(std::remove(pred.begin(), pred.end(), i), pred.end());
+
+    for (auto &input : nodes[i].inputs) {
+      readers[input].push_back(i);
+    }
+    for (auto &output : nodes[i].outputs) {
+      last_writer[output] = i;
+      readers[output].clear();
+    }
+  }
+  return predecessors;
+}
+
+}  // namespace
+
+Pipeline::Pipeline(const std::string &stream_name, std::shared_ptr<GPUResource> gpu_resource,
+                   const std::vector<PipelineNode> &nodes, bool capture_as_one_graph)
+    : stream_name_(stream_name),
+      gpu_resource_(std::move(gpu_resource)),
+      capture_as_one_graph_(capture_as_one_graph) {
+  const size_t num_nodes = nodes.size();
+  const auto predecessors = get_predecessors(nodes);
+
+  // ancestors[i][j]: node j has to finish before node i
+  std::vector<std::vector<bool>> ancestors(num_nodes, std::vector<bool>(num_nodes, false));
+  // depth[i] / height[i]: the number of nodes on the longest path ending / starting at node i
+  std::vector<size_t> depth(num_nodes, 1), height(num_nodes, 1);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    for (size_t p : predecessors[i]) {
+      ancestors[i][p] = true;
+      for (size_t j = 0; j < p; ++j) {
+        if (ancestors[p][j]) ancestors[i][j] = true;
+      }
+      depth[i] = std::max(depth[i], depth[p] + 1);
+    }
+  }
+  for (size_t i = num_nodes; i-- > 0;) {
+    for (size_t p : predecessors[i]) {
+      height[p] = std::max(height[p], height[i] + 1);
+    }
+  }
+  size_t critical_length = 0;
+  for (size_t i = 0; i < num_nodes; ++i) {
+    critical_length = std::max(critical_length, depth[i] + height[i] - 1);
+  }
+  auto is_critical = [&](size_t i) { return depth[i] + height[i] - 1 == critical_length; };
+
+  // Stream 0 is the stream of the pipeline. A node goes to the stream of its deepest predecessor
+  // if that one is the last node on its stream, then to any stream whose last node it depends on,
+  // otherwise to a new stream.
+  std::vector<size_t> stream_of(num_nodes);
+  std::vector<std::optional<size_t>> stream_tail(1);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    std::vector<size_t> pred = predecessors[i];
+    std::stable_sort(pred.begin(), pred.end(), [&](size_t a, size_t b) {
+      return std::make_pair(is_critical(a), depth[a]) > std::make_pair(is_critical(b), depth[b]);
+    });
+    std::optional<size_t> stream;
+    for (size_t p : pred) {
+      if (stream_tail[stream_of[p]] == p) {
+        stream = stream_of[p];
+        break;
+      }
+    }
+    for (size_t s = 0; !stream && s < stream_tail.size(); ++s) {
+      if (!stream_tail[s] || ancestors[i][stream_tail[s].value()]) stream = s;
+    }
+    if (!stream) {
+      stream = stream_tail.size();
+      stream_tail.emplace_back();
+    }
+    stream_of[i] = stream.value();
+    stream_tail[stream_of[i]] = i;
+  }
+
+  const size_t num_streams = stream_tail.size();
+  std::vector<int> stream_priority(num_streams, 0);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    if (stream_of[i] != 0 && is_critical(i)) stream_priority[stream_of[i]] = -1;
+  }
+
+  std::vector<std::shared_ptr<DependencyScheduleable>> scheduled;
+  for (size_t i = 0; i < num_nodes; ++i) {
+    const size_t s = stream_of[i];
+    scheduled.push_back(std::make_shared<DependencyScheduleable>(
+        nodes[i].scheduleable, s == 0 ? "" : "_dag" + std::to_string(s), stream_priority[s]));
+  }
+
+  // Events are only needed across streams, and only for the last predecessor on each stream
+  // which the previous node on the same stream does not already depend on.
+  auto fork = std::make_shared<DependencyScheduleable>(nullptr, "", 0);
+  bool need_fork = false;
+  std::vector<std::optional<size_t>> last_on_stream(num_streams);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    const size_t s = stream_of[i];
+    const auto &prev = last_on_stream[s];
+    std::vector<std::optional<size_t>> wait_on(num_streams);
+    for (size_t p : predecessors[i]) {
+      if (stream_of[p] == s) continue;
+      if (prev && (prev == p || ancestors[prev.value()][p])) continue;
+      wait_on[stream_of[p]] = std::max(wait_on[stream_of[p]].value_or(0), p);
+    }
+    bool waits = false;
+    for (auto &p : wait_on) {
+      if (!p) continue;
+      scheduled[i]->wait(scheduled[p.value()]->record_done());
+      waits = true;
+    }
+    // The first node of a side stream forks it from the stream of the pipeline
+    if (s != 0 && !last_on_stream[s] && !waits) {
+      scheduled[i]->wait(fork->record_done());
+      need_fork = true;
+    }
+    last_on_stream[s] = i;
+  }
+
+  if (need_fork) scheduleable_list_.push_back(fork);
+  scheduleable_list_.insert(scheduleable_list_.end(), scheduled.begin(), scheduled.end());
+
+  // All the side streams join the stream of the pipeline at the end
+  if (num_streams > 1) {
+    auto join = std::make_shared<DependencyScheduleable>(nullptr, "", 0);
+    for (size_t s = 1; s < num_streams; ++s) {
+      join->wait(scheduled[stream_tail[s].value()]->record_done());
+    }
+    scheduleable_list_.push_back(join);
+  }
+
+  StreamContext stream_context(gpu_resource_, stream_name_);
+  for (auto &scheduleable : scheduleable_list_) {
+    scheduleable->init(gpu_resource_);
+  }
+}
+
 Pipeline::Pipeline(const std::string &stream_name, std::shared_ptr<GPUResource> gpu_resource,
-                   const std::vector<std::shared_ptr<Scheduleable>> &scheduleable_list)
+                   const std::vector<std::shared_ptr<Scheduleable>> &scheduleable_list,
+                   bool capture_as_one_graph)
     : stream_name_(stream_name),
       gpu_resource_(std::move(gpu_resource)),
-      scheduleable_list_(scheduleable_list) {
+      scheduleable_list_(scheduleable_list),
+      capture_as_one_graph_(capture_as_one_graph) {
   StreamContext stream_context(gpu_resource_, stream_name_);
   for (auto &scheduleable : scheduleable_list_) {
     scheduleable->init(gpu_resource_);
@@ -140,6 +340,7 @@ Pipeline::Pipeline(const std::string &stream_name, std::shared_ptr<GPUResource>
 }
 
 void Pipeline::run() {
+  HCTR_NVTX_RANGE("Pipeline " + stream_name_);
   StreamContext stream_context(gpu_resource_, stream_name_);
   for (auto &scheduleable : scheduleable_list_) {
     scheduleable->run(gpu_resource_, false);
@@ -147,7 +348,26 @@ void Pipeline::run() {
 }
 
 void Pipeline::run_graph() {
+  HCTR_NVTX_RANGE("Pipeline " + stream_name_);
   StreamContext stream_context(gpu_resource_, stream_name_);
+  if (capture_as_one_graph_) {
+    auto do_it = [this](cudaStream_t) {
+      for (auto &scheduleable : scheduleable_list_) {
+        scheduleable->run(gpu_resource_, false);
+      }
+    };
+    cudaStream_t stream = gpu_resource_->get_stream();
+    if (!graph_.initialized) {
+      graph_.capture(do_it, stream);
+#ifdef ENABLE_MPI
+#pragma omp master
+      MPI_Barrier(MPI_COMM_WORLD);
+#endif
+#pragma omp barrier
+    }
+    graph_.exec(stream);
+    return;
+  }
   for (auto &scheduleable : scheduleable_list_) {
     scheduleable->run(gpu_resource_, true);
   }
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cuda_fp16.h>
+
+#include <algorithm>
+#include <core23/logger.hpp>
+#include <prediction_writer.hpp>
+#include <utils.hpp>
+
+namespace HugeCTR {
+
+namespace metrics {
+
+PredictionWriter::PredictionWriter(const std::string& output_prefix,
+                                   const bool use_mixed_precision, const int batch_size_per_gpu,
+                                   const int label_dim,
+                                   const std::shared_ptr<ResourceManager>& resource_manager)
+    : Metric(),
+      resource_manager_(resource_manager),
+      use_mixed_precision_(use_mixed_precision),
+      batch_size_per_gpu_(batch_size_per_gpu),
+      label_dim_(label_dim),
+      d_preds_(resource_manager->get_local_gpu_count(), nullptr),
+      slots_(resource_manager->get_local_gpu_count()),
+      num_submitted_batches_(resource_manager->get_local_gpu_count(), 0) {
+  const size_t buffer_size = static_cast<size_t>(batch_size_per_gpu_) * label_dim_ * sizeof(float);
+  for (size_t i = 0; i < resource_manager_->get_local_gpu_count(); i++) {
+    CudaDeviceContext context(resource_manager_->get_local_gpu(i)->get_device_id());
+    if (use_mixed_precision_) {
+      HCTR_LIB_THROW(cudaMalloc(&d_preds_[i], buffer_size));
+    }
+    for (size_t j = 0; j < num_slots_; j++) {
+      Slot slot{nullptr, 0, nullptr};
+      HCTR_LIB_THROW(cudaMallocHost(&slot.h_preds, buffer_size));
+      HCTR_LIB_THROW(cudaEventCreateWithFlags(&slot.ready, cudaEventDisableTiming));
+      slots_[i].push_back(slot);
+    }
+  }
+
+  const std::string rank = std::to_string(resource_manager_->get_process_id());
+  for (int k = 0; k < label_dim_; k++) {
+    const std::string path = output_prefix + "_" + rank + "_pred" + std::to_string(k) + ".bin";
+    files_.emplace_back(path, std::ios::binary | std::ios::trunc);
+    HCTR_THROW_IF(!files_.back().is_open(), Error_t::FileCannotOpen, "Cannot open ", path,
+                  " for writing");
+  }
+  column_.resize(batch_size_per_gpu_);
+
+  writer_ = std::thread(&PredictionWriter::write_loop_, this);
+}
+
+PredictionWriter::~PredictionWriter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    terminate_ = true;
+  }
+  cv_.notify_all();
+  writer_.join();
+
+  for (size_t i = 0; i < slots_.size(); i++) {
+    CudaDeviceContext context(resource_manager_->get_local_gpu(i)->get_device_id());
+    for (Slot& slot : slots_[i]) {
+      HCTR_LIB_CHECK_(cudaEventDestroy(slot.ready));
+      HCTR_LIB_CHECK_(cudaFreeHost(slot.h_preds));
+    }
+    if (d_preds_[i]) {
+      HCTR_LIB_CHECK_(cudaFree(d_preds_[i]));
+    }
+  }
+}
+
+void PredictionWriter::local_reduce(const int local_gpu_id, Core23RawMetricMap raw_metrics) {
+  const auto& gpu = resource_manager_->get_local_gpu(local_gpu_id);
+  CudaDeviceContext context(gpu->get_device_id());
+  const int remaining =
+      current_batch_size_ - static_cast<int>(gpu->get_global_id()) * batch_size_per_gpu_;
+  const size_t num_samples = std::max(std::min(remaining, batch_size_per_gpu_), 0);
+
+  // Wait for the writer, if the batch that used the same buffer has not been written yet.
+  const size_t batch = num_submitted_batches_[local_gpu_id];
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] { return num_written_batches_ + num_slots_ > batch || error_; });
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+  }
+
+  Slot& slot = slots_[local_gpu_id][batch % num_slots_];
+  const size_t num_elements = num_samples * label_dim_;
+  const core23::Tensor& pred_tensor = raw_metrics[RawType::Pred];
+  const auto stream = gpu->get_stream();
+  const float* d_preds = nullptr;
+  if (use_mixed_precision_) {
+    convert_array_on_device(d_preds_[local_gpu_id], pred_tensor.data<__half>(), num_elements,
+                            stream);
+    d_preds = d_preds_[local_gpu_id];
+  } else {
+    d_preds = pred_tensor.data<float>();
+  }
+  HCTR_LIB_THROW(cudaMemcpyAsync(slot.h_preds, d_preds, num_elements * sizeof(float),
+                                 cudaMemcpyDeviceToHost, stream));
+  HCTR_LIB_THROW(cudaEventRecord(slot.ready, stream));
+  slot.num_samples = num_samples;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++num_submitted_batches_[local_gpu_id];
+  }
+  cv_.notify_all();
+}
+
+size_t PredictionWriter::flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [&] { return !is_batch_submitted_(num_written_batches_) || error_; });
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+  for (auto& file : files_) {
+    file.flush();
+  }
+  return num_written_samples_;
+}
+
+bool PredictionWriter::is_batch_submitted_(const size_t batch) const {
+  return std::all_of(num_submitted_batches_.begin(), num_submitted_batches_.end(),
+                     [batch](const size_t num_batches) { return num_batches > batch; });
+}
+
+void PredictionWriter::write_loop_() {
+  try {
+    while (true) {
+      size_t batch;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return terminate_ || is_batch_submitted_(num_written_batches_); });
+        if (!is_batch_submitted_(num_written_batches_)) {
+          return;
+        }
+        batch = num_written_batches_;
+      }
+
+      // The samples of a batch are written in the order of the local GPUs.
+      size_t num_samples = 0;
+      for (size_t i = 0; i < slots_.size(); i++) {
+        const Slot& slot = slots_[i][batch % num_slots_];
+        HCTR_LIB_THROW(cudaEventSynchronize(slot.ready));
+        for (int k = 0; k < label_dim_; k++) {
+          for (size_t j = 0; j < slot.num_samples; j++) {
+            column_[j] = slot.h_preds[j * label_dim_ + k];
+          }
+          files_[k].write(reinterpret_cast<const char*>(column_.data()),
+                          slot.num_samples * sizeof(float));
+          HCTR_THROW_IF(!files_[k], Error_t::FileCannotOpen, "Cannot write the predictions");
+        }
+        num_samples += slot.num_samples;
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++num_written_batches_;
+        num_written_samples_ += num_samples;
+      }
+      cv_.notify_all();
+    }
+  } catch (const std::exception& err) {
+    HCTR_LOG_S(ERROR, WORLD) << err.what() << std::endl;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      error_ = std::current_exception();
+    }
+    cv_.notify_all();
+  }
+}
+
+}  // namespace metrics
+
+}  // namespace HugeCTR
@@ -13,6 +13,9 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <core23/allocator_factory.hpp>
+#include <core23/buffer_factory.hpp>
+#include <core23/buffer_params.hpp>
 #include <core23_network.hpp>
 #include <layer.hpp>
 #include <layers/add_layer.hpp>
@@ -59,6 +62,7 @@
 #include <regularizers/l1_regularizer.hpp>
 #include <regularizers/l2_regularizer.hpp>
 #include <regularizers/no_regularizer.hpp>
+#include <set>
 #include <unordered_map>
 #ifdef ENABLE_MPI
 #include <mpi.h>
@@ -146,6 +150,8 @@ void save_graph_to_json(nlohmann::json& layer_config_array,
           sparse_embedding_params[i].hybrid_embedding_param.max_all_to_all_bandwidth;
       sparse_hparam_config["efficiency_bandwidth_ratio"] =
           sparse_embedding_params[i].hybrid_embedding_param.efficiency_bandwidth_ratio;
+      sparse_hparam_config["recalibration_interval"] =
+          sparse_embedding_params[i].hybrid_embedding_param.recalibration_interval;
       sparse_hparam_config["communication_type"] =
           HE_COMM_TYPE_TO_STRING[sparse_embedding_params[i]
                                      .hybrid_embedding_param.communication_type];
@@ -161,6 +167,7 @@ void save_graph_to_json(nlohmann::json& layer_config_array,
             ? "Global"
             : (embedding_opt_params_list[i]->update_type == Update_t::Local ? "Local"
                                                                             : "LazyGlobal");
+    optimizer_config["fused_update"] = embedding_opt_params_list[i]->fused_update;
     switch (embedding_opt_params_list[i]->optimizer) {
       case Optimizer_t::Ftrl:
         optimizer_config["type"] = "Ftrl";
@@ -262,6 +269,9 @@ void save_graph_to_json(nlohmann::json& layer_config_array,
           ln_param_config["beta_init"] =
               INITIALIZER_TYPE_TO_STRING[dense_layer_params[i].beta_init_type];
         }
+        if (!dense_layer_params[i].acts.empty()) {
+          ln_param_config["activation"] = FC_ACTIVATION_TO_STRING[dense_layer_params[i].acts[0]];
+        }
         layer_config["ln_param"] = ln_param_config;
         break;
       }
@@ -283,6 +293,7 @@ void save_graph_to_json(nlohmann::json& layer_config_array,
       case Layer_t::MultiHeadAttention: {
         layer_config["num_attention_heads"] = dense_layer_params[i].num_attention_heads;
         layer_config["transpose_b"] = dense_layer_params[i].transpose_b;
+        layer_config["fused_attention"] = dense_layer_params[i].fused_attention;
         break;
       }
       case Layer_t::FusedInnerProduct: {
@@ -301,7 +312,8 @@ void save_graph_to_json(nlohmann::json& layer_config_array,
         layer_config["fc_param"] = fc_param_config;
         break;
       }
-      case Layer_t::MLP: {
+      case Layer_t::MLP:
+      case Layer_t::GroupedMLP: {
         nlohmann::json mlp_param_config;
         mlp_param_config["num_output"] = dense_layer_params[i].num_output;
         mlp_param_config["num_outputs"] = dense_layer_params[i].num_outputs;
@@ -416,6 +428,20 @@ void save_graph_to_json(nlohmann::json& layer_config_array,
         layer_config["gru_param"] = gru_param_config;
         break;
       }
+      case Layer_t::AUGRU: {
+        nlohmann::json augru_param_config;
+        augru_param_config["num_output"] = dense_layer_params[i].num_output;
+        if (dense_layer_params[i].weight_init_type != Initializer_t::Default) {
+          augru_param_config["weight_init"] =
+              INITIALIZER_TYPE_TO_STRING[dense_layer_params[i].weight_init_type];
+        }
+        if (dense_layer_params[i].bias_init_type != Initializer_t::Default) {
+          augru_param_config["bias_init"] =
+              INITIALIZER_TYPE_TO_STRING[dense_layer_params[i].bias_init_type];
+        }
+        layer_config["augru_param"] = augru_param_config;
+        break;
+      }
       case Layer_t::PReLU_Dice: {
         nlohmann::json prelu_dice_param_config;
         prelu_dice_param_config["alpha"] = dense_layer_params[i].elu_alpha;
@@ -530,6 +556,15 @@ DenseLayer get_dense_layer_from_json(const nlohmann::json& j_dense_layer) {
           HCTR_OWN_THROW(Error_t::WrongInput, "No such initializer: " + beta_init_name);
         }
       }
+      if (has_key_(j_ln_hparam, "activation")) {
+        const auto act_name = get_value_from_json<std::string>(j_ln_hparam, "activation");
+        Activation_t act_type;
+        if (find_item_in_map(act_type, act_name, ACTIVATION_TYPE_MAP)) {
+          dense_layer.acts = {act_type};
+        } else {
+          HCTR_OWN_THROW(Error_t::WrongInput, "No such activation: " + act_name);
+        }
+      }
       break;
     }
     case Layer_t::Dropout: {
@@ -595,7 +630,8 @@ DenseLayer get_dense_layer_from_json(const nlohmann::json& j_dense_layer) {
       dense_layer.num_output = output;
       break;
     }
-    case Layer_t::MLP: {
+    case Layer_t::MLP:
+    case Layer_t::GroupedMLP: {
       auto j_mlp_param = get_json(j_dense_layer, "mlp_param");
       if (has_key_(j_mlp_param, "weight_init")) {
         const auto weight_init_name = get_value_from_json<std::string>(j_mlp_param, "weight_init");
@@ -713,6 +749,12 @@ DenseLayer get_dense_layer_from_json(const nlohmann::json& j_dense_layer) {
       } else {
         dense_layer.transpose_b = false;
       }
+      auto fused_attention_it = j_dense_layer.find("fused_attention");
+      if (fused_attention_it != j_dense_layer.end()) {
+        dense_layer.fused_attention = fused_attention_it->get<bool>();
+      } else {
+        dense_layer.fused_attention = false;
+      }
       break;
     }
     case Layer_t::MultiCross: {
@@ -826,6 +868,30 @@ DenseLayer get_dense_layer_from_json(const nlohmann::json& j_dense_layer) {
       dense_layer.vector_size = vector_size;
       break;
     }
+    case Layer_t::AUGRU: {
+      auto j_augru_param = get_json(j_dense_layer, "augru_param");
+      if (has_key_(j_augru_param, "weight_init")) {
+        const auto weight_init_name =
+            get_value_from_json<std::string>(j_augru_param, "weight_init");
+        Initializer_t weight_init_type;
+        if (find_item_in_map(weight_init_type, weight_init_name, INITIALIZER_TYPE_MAP)) {
+          dense_layer.weight_init_type = weight_init_type;
+        } else {
+          HCTR_OWN_THROW(Error_t::WrongInput, "No such initializer: " + weight_init_name);
+        }
+      }
+      if (has_key_(j_augru_param, "bias_init")) {
+        const auto bias_init_name = get_value_from_json<std::string>(j_augru_param, "bias_init");
+        Initializer_t bias_init_type;
+        if (find_item_in_map(bias_init_type, bias_init_name, INITIALIZER_TYPE_MAP)) {
+          dense_layer.bias_init_type = bias_init_type;
+        } else {
+          HCTR_OWN_THROW(Error_t::WrongInput, "No such initializer: " + bias_init_name);
+        }
+      }
+      dense_layer.num_output = get_value_from_json<int>(j_augru_param, "num_output");
+      break;
+    }
     case Layer_t::PReLU_Dice: {
       auto j_prelu_dice_hparam = get_json(j_dense_layer, "prelu_dice_param");
       auto alpha = get_value_from_json<float>(j_prelu_dice_hparam, "elu_alpha");
@@ -987,13 +1053,34 @@ void Model::add_dense_layers(std::vector<DenseLayer>& dense_layers) {
     }
   };
   std::unordered_map<NetworkBufferChannelType, std::string> original_channel;
-  const std::unordered_map<NetworkBufferChannelType, std::string> new_channel = {
-      {NetworkBufferChannelType::Blobs, "EVAL_BLOBS"},
+  std::unordered_map<NetworkBufferChannelType, std::string> new_channel = {
       {NetworkBufferChannelType::WeightHalf, "EVAL_WEIGHT_HALF"},
       {NetworkBufferChannelType::Weight, "EVAL_WEIGHT"},
       {NetworkBufferChannelType::Wgrad, "EVAL_WGRAD"},
       {NetworkBufferChannelType::WgradHalf, "EVAL_WGRAD_HALF"},
   };
+  //! The eval layers are built from the same layers as the train ones, so their weights are views
+  //! of the train weights instead of copies. Their wgrads are never written.
+  for (auto& [type, name] : new_channel) {
+    core23::MirrorBufferChannel(name, GetNetworkBufferChannel(type));
+  }
+
+  //! The train and eval layer outputs are live in different steps of a shared, aliased Blobs
+  //! buffer. It is created upfront, since the first tensor of a channel decides the kind of buffer.
+  std::vector<std::shared_ptr<core23::Buffer>> shared_blobs_buffers;
+  if (solver_.share_eval_activations) {
+    core23::BufferParams blobs_buffer_params;
+    blobs_buffer_params.channel = GetBlobsBufferChannel();
+    blobs_buffer_params.aliased = true;
+    for (size_t i = 0; i < resource_manager_->get_local_gpu_count(); i++) {
+      core23::Device device(core23::DeviceType::GPU,
+                            resource_manager_->get_local_gpu(i)->get_device_id());
+      shared_blobs_buffers.push_back(core23::GetBuffer(
+          blobs_buffer_params, device, core23::GetAllocator(core23::AllocatorParams(), device)));
+    }
+  } else {
+    new_channel.emplace(NetworkBufferChannelType::Blobs, "EVAL_BLOBS");
+  }
 
   //! Embeddings and Train layers should use default channels;
   //! set new buffer channel for eval layers
@@ -1001,14 +1088,17 @@ void Model::add_dense_layers(std::vector<DenseLayer>& dense_layers) {
     auto original = SetNetworkBufferChannel(it->first, it->second);
     original_channel.emplace(std::make_pair(it->first, original));
   }
+  auto original_step = SetActivationStep(solver_.share_eval_activations ? 1 : -1);
   add_dense_layers_op(false);
 
   //! Restore the channel
   for (auto it = original_channel.begin(); it != original_channel.end(); it++) {
     SetNetworkBufferChannel(it->first, it->second);
   }
+  SetActivationStep(solver_.share_eval_activations ? 0 : -1);
 
   add_dense_layers_op(true);
+  SetActivationStep(original_step);
 }
 
 void calculate_tensor_dimensions(std::map<std::string, std::vector<int>>& tensor_shape_info_raw,
@@ -1092,6 +1182,15 @@ void calculate_tensor_dimensions(std::map<std::string, std::vector<int>>& tensor
       }
       break;
     }
+    case Layer_t::GroupedMLP: {
+      int batch_size = tensor_shape_info_raw[dense_layer.bottom_names[0]][0];
+      int num_output = dense_layer.num_outputs.back();
+      for (const auto& top_name : dense_layer.top_names) {
+        tensor_shape_info_raw.insert(
+            std::make_pair(top_name, std::vector<int>{batch_size, num_output}));
+      }
+      break;
+    }
     case Layer_t::FusedInnerProduct: {
       int batch_size = tensor_shape_info_raw[dense_layer.bottom_names[0]][0];
       int num_output = dense_layer.num_output;
@@ -1293,6 +1392,13 @@ void calculate_tensor_dimensions(std::map<std::string, std::vector<int>>& tensor
           std::make_pair(dense_layer.top_names[0], std::vector<int>{batch_size, num_output}));
       break;
     }
+    case Layer_t::AUGRU: {
+      int batch_size = tensor_shape_info_raw[dense_layer.bottom_names[0]][0];
+      int num_output = dense_layer.num_output;
+      tensor_shape_info_raw.insert(
+          std::make_pair(dense_layer.top_names[0], std::vector<int>{batch_size, num_output}));
+      break;
+    }
     case Layer_t::MatrixMultiply: {
       auto& dim1 = tensor_shape_info_raw[dense_layer.bottom_names[0]];
       auto& dim2 = tensor_shape_info_raw[dense_layer.bottom_names[1]];
@@ -1366,4 +1472,152 @@ void calculate_tensor_dimensions(std::map<std::string, std::vector<int>>& tensor
   }  // end of switch
 }
 
+namespace {
+
+// The layers a fusion chain can start from
+bool is_gemm_layer(const DenseLayer& dense_layer) {
+  return dense_layer.layer_type == Layer_t::InnerProduct || dense_layer.layer_type == Layer_t::MLP;
+}
+
+// The equivalent MLP of an InnerProduct or MLP layer, with explicit acts and biases per layer
+DenseLayer to_mlp_layer(const DenseLayer& dense_layer) {
+  DenseLayer mlp_layer = dense_layer;
+  if (dense_layer.layer_type == Layer_t::InnerProduct) {
+    mlp_layer.layer_type = Layer_t::MLP;
+    mlp_layer.num_outputs = {dense_layer.num_output};
+    mlp_layer.acts = {Activation_t::None};
+    mlp_layer.biases = {true};
+    // Keeps the kernel initialization of FullyConnectedLayer, the MLP default is uniform
+    if (mlp_layer.weight_init_type == Initializer_t::Default) {
+      mlp_layer.weight_init_type = Initializer_t::XavierNorm;
+    }
+  } else {
+    if (mlp_layer.acts.empty()) {
+      mlp_layer.acts.assign(mlp_layer.num_outputs.size(), dense_layer.act_type);
+    }
+    if (mlp_layer.biases.empty()) {
+      mlp_layer.biases.assign(mlp_layer.num_outputs.size(), dense_layer.use_bias);
+    }
+  }
+  return mlp_layer;
+}
+
+bool same_compute_config(const DenseLayerComputeConfig& a, const DenseLayerComputeConfig& b) {
+  return a.async_wgrad == b.async_wgrad && a.fuse_wb == b.fuse_wb && a.enable_fp8 == b.enable_fp8;
+}
+
+// Whether consumer can be merged into producer, an MLP or a LayerNorm whose only output only
+// feeds consumer. A Dropout is only merged into a LayerNorm when it recomputes its mask, since the
+// fused one keeps no mask either.
+bool can_fuse(const DenseLayer& producer, const DenseLayer& consumer) {
+  if (consumer.bottom_names.size() != 1 || consumer.top_names.size() != 1) {
+    return false;
+  }
+  switch (consumer.layer_type) {
+    case Layer_t::ReLU:
+      return producer.acts.empty() || producer.acts.back() == Activation_t::None;
+    case Layer_t::Dropout:
+      return producer.layer_type == Layer_t::LayerNorm && producer.fused_dropout_rate == 0.f &&
+             consumer.compute_config.recompute;
+    case Layer_t::InnerProduct:
+    case Layer_t::MLP: {
+      if (producer.layer_type != Layer_t::MLP) {
+        return false;
+      }
+      const DenseLayer next = to_mlp_layer(consumer);
+      return next.weight_init_type == producer.weight_init_type &&
+             next.bias_init_type == producer.bias_init_type &&
+             same_compute_config(next.compute_config, producer.compute_config);
+    }
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+void fuse_dense_layers(std::vector<DenseLayer>& dense_layers,
+                       const std::map<std::string, std::vector<int>>& tensor_shape_info_raw) {
+  std::map<std::string, unsigned int> tensor_usage;
+  // Logits of the BinaryCrossEntropyLoss layers
+  std::set<std::string> logits;
+  for (auto& dense_layer : dense_layers) {
+    for (auto& bottom_name : dense_layer.bottom_names) {
+      analyze_tensor(tensor_usage, bottom_name);
+    }
+    if (dense_layer.layer_type == Layer_t::BinaryCrossEntropyLoss) {
+      logits.insert(dense_layer.bottom_names[0]);
+    }
+  }
+
+  std::vector<DenseLayer> fused_layers;
+  // top tensor name -> index in fused_layers of the layer producing it
+  std::map<std::string, size_t> producers;
+  for (auto& dense_layer : dense_layers) {
+    if (dense_layer.bottom_names.size() == 1) {
+      const auto& bottom_name = dense_layer.bottom_names[0];
+      auto it = producers.find(bottom_name);
+      if (it != producers.end() && tensor_usage[bottom_name] == 1) {
+        const size_t producer_index = it->second;
+        DenseLayer producer = fused_layers[producer_index];
+        if (is_gemm_layer(producer)) {
+          producer = to_mlp_layer(producer);
+        }
+        // A GEMM is only merged into the layer right before it, so that no other layer's weights
+        // move after its own ones
+        bool adjacent = producer_index == fused_layers.size() - 1;
+        bool elementwise = dense_layer.layer_type == Layer_t::ReLU ||
+                           dense_layer.layer_type == Layer_t::Dropout;
+        // The InnerProduct computing a logit keeps the single output kernels of
+        // FullyConnectedLayer, which are faster than a GEMM of the MLP with one column
+        bool logit_head = dense_layer.layer_type == Layer_t::InnerProduct &&
+                          dense_layer.num_output == 1 && logits.count(dense_layer.top_names[0]);
+        if (can_fuse(producer, dense_layer) && (adjacent || elementwise) && !logit_head) {
+          HCTR_LOG(INFO, ROOT, "Fuse %s layer on tensor %s into the preceding %s layer\n",
+                   LAYER_TYPE_TO_STRING[dense_layer.layer_type].c_str(), bottom_name.c_str(),
+                   LAYER_TYPE_TO_STRING[producer.layer_type].c_str());
+          if (dense_layer.layer_type == Layer_t::ReLU) {
+            if (producer.acts.empty()) {
+              producer.acts = {Activation_t::Relu};
+            } else {
+              producer.acts.back() = Activation_t::Relu;
+            }
+          } else if (dense_layer.layer_type == Layer_t::Dropout) {
+            // the dropout commutes with a ReLU fused behind it
+            producer.fused_dropout_rate = dense_layer.dropout_rate;
+          } else {
+            const DenseLayer next = to_mlp_layer(dense_layer);
+            producer.num_outputs.insert(producer.num_outputs.end(), next.num_outputs.begin(),
+                                        next.num_outputs.end());
+            producer.acts.insert(producer.acts.end(), next.acts.begin(), next.acts.end());
+            producer.biases.insert(producer.biases.end(), next.biases.begin(),
+                                   next.biases.end());
+            producer.num_output = producer.num_outputs.back();
+          }
+          producer.top_names = dense_layer.top_names;
+          fused_layers[producer_index] = producer;
+          producers.erase(it);
+          producers[producer.top_names[0]] = producer_index;
+          continue;
+        }
+      }
+    }
+
+    fused_layers.push_back(dense_layer);
+    // Only 2D single input/output GEMM layers can become an MLP
+    if (is_gemm_layer(dense_layer) && dense_layer.bottom_names.size() == 1 &&
+        dense_layer.top_names.size() == 1) {
+      const auto shape = tensor_shape_info_raw.find(dense_layer.bottom_names[0]);
+      if (shape != tensor_shape_info_raw.end() && shape->second.size() == 2) {
+        producers[dense_layer.top_names[0]] = fused_layers.size() - 1;
+      }
+    }
+    // A LayerNorm can absorb the ReLU and the Dropout behind it
+    if (dense_layer.layer_type == Layer_t::LayerNorm) {
+      producers[dense_layer.top_names[0]] = fused_layers.size() - 1;
+    }
+  }
+  dense_layers.swap(fused_layers);
+}
+
 }  // namespace HugeCTR
@@ -19,6 +19,7 @@
 #include <core23_wrapper.hpp>
 #include <layer.hpp>
 #include <layers/add_layer.hpp>
+#include <layers/augru_layer.hpp>
 #include <layers/batch_norm_layer.hpp>
 #include <layers/cast_layer.hpp>
 #include <layers/concat_3d_layer.hpp>
@@ -33,6 +34,7 @@
 #include <layers/fused_relu_bias_fully_connected_layer.hpp>
 #include <layers/fused_reshape_concat_general_layer.hpp>
 #include <layers/fused_reshape_concat_layer.hpp>
+#include <layers/grouped_mlp_layer.hpp>
 #include <layers/gru_layer.hpp>
 #include <layers/interaction_layer.hpp>
 #include <layers/layer_norm_layer.hpp>
@@ -148,6 +150,12 @@ void add_dense_layer_impl(DenseLayer& dense_layer, std::vector<TensorEntity>& te
           .device(core23::Device(core23::DeviceType::GPU, gpu_resource->get_device_id()))
           .data_type(use_mixed_precision ? core23::ScalarType::Half : core23::ScalarType::Float)
           .buffer_channel(GetBlobsBufferChannel());
+  // The losses are read after the step, e.g. by get_current_loss(), so they stay live throughout
+  const core23::TensorParams loss_tensor_params =
+      tensor_params.shape({1, 1}).data_type(core23::ScalarType::Float);
+  if (const int64_t step = GetActivationStep(); step >= 0) {
+    tensor_params = tensor_params.live_range(step, step);
+  }
 
   std::vector<TensorEntity> output_tensor_entities;
   auto input_output_info = get_input_tensors_and_output_names(
@@ -176,13 +184,17 @@ void add_dense_layer_impl(DenseLayer& dense_layer, std::vector<TensorEntity>& te
       output_tensor_entities.push_back({input_output_info.output_names[0], ln_out_tensor});
       std::vector<Initializer_t> initializer_types{dense_layer.gamma_init_type,
                                                    dense_layer.beta_init_type};
+      const Activation_t act =
+          dense_layer.acts.empty() ? Activation_t::None : dense_layer.acts[0];
 
       if (use_mixed_precision) {
-        LayerNormLayer<__half>::Params params = {dense_layer.eps};
+        LayerNormLayer<__half>::Params params = {dense_layer.eps, act,
+                                                 dense_layer.fused_dropout_rate};
         layers.emplace_back(new LayerNormLayer<__half>(ln_in_tensor, ln_out_tensor, params,
                                                        gpu_resource, initializer_types));
       } else {
-        LayerNormLayer<float>::Params params = {dense_layer.eps};
+        LayerNormLayer<float>::Params params = {dense_layer.eps, act,
+                                                dense_layer.fused_dropout_rate};
         layers.emplace_back(new LayerNormLayer<float>(ln_in_tensor, ln_out_tensor, params,
                                                       gpu_resource, initializer_types));
       }
@@ -204,7 +216,7 @@ void add_dense_layer_impl(DenseLayer& dense_layer, std::vector<TensorEntity>& te
 
       auto& input_tensor = input_output_info.input_tensors[0];
       auto& label_tensor = input_output_info.input_tensors[1];
-      core23::Tensor loss_tensor(tensor_params.shape({1, 1}).data_type(core23::ScalarType::Float));
+      core23::Tensor loss_tensor(loss_tensor_params);
 
       std::unique_ptr<ILoss> new_loss;
       if (use_mixed_precision) {
@@ -262,7 +274,7 @@ void add_dense_layer_impl(DenseLayer& dense_layer, std::vector<TensorEntity>& te
 
       auto& input_tensor = input_output_info.input_tensors[0];
       auto& label_tensor = input_output_info.input_tensors[1];
-      core23::Tensor loss_tensor(tensor_params.shape({1, 1}).data_type(core23::ScalarType::Float));
+      core23::Tensor loss_tensor(loss_tensor_params);
 
       std::unique_ptr<ILoss> new_loss;
       if (use_mixed_precision) {
@@ -283,11 +295,12 @@ void add_dense_layer_impl(DenseLayer& dense_layer, std::vector<TensorEntity>& te
       auto& in_tensor = input_output_info.input_tensors[0];
       core23::Tensor out_tensor(tensor_params.shape(in_tensor.shape()));
       [[maybe_unused]] float rate = dense_layer.dropout_rate;
+      bool recompute = dense_layer.compute_config.recompute;
       std::unique_ptr<Layer> layer;
       if (use_mixed_precision) {
-        layer.reset(new DropoutLayer<__half>(in_tensor, out_tensor, rate, gpu_resource));
+        layer.reset(new DropoutLayer<__half>(in_tensor, out_tensor, rate, gpu_resource, recompute));
       } else {
-        layer.reset(new DropoutLayer<float>(in_tensor, out_tensor, rate, gpu_resource));
+        layer.reset(new DropoutLayer<float>(in_tensor, out_tensor, rate, gpu_resource, recompute));
       }
       layers.emplace_back(std::move(layer));
       output_tensor_entities.push_back({input_output_info.output_names[0], out_tensor});
@@ -376,12 +389,14 @@ void add_dense_layer_impl(DenseLayer& dense_layer, std::vector<TensorEntity>& te
         layers.emplace_back(new MLPLayer<__half>(
             in_tensors, train_out_tensors, num_outputs, gpu_resource, acts, biases,
             initializer_types, skip_dgrad, dense_layer.compute_config.async_wgrad,
-            dense_layer.compute_config.fuse_wb, enable_tf32_compute));
+            dense_layer.compute_config.fuse_wb, enable_tf32_compute,
+            dense_layer.compute_config.enable_fp8));
       } else {
         layers.emplace_back(new MLPLayer<float>(
             in_tensors, train_out_tensors, num_outputs, gpu_resource, acts, biases,
             initializer_types, skip_dgrad, dense_layer.compute_config.async_wgrad,
-            dense_layer.compute_config.fuse_wb, enable_tf32_compute));
+            dense_layer.compute_config.fuse_wb, enable_tf32_compute,
+            dense_layer.compute_config.enable_fp8));
       }
 
       if (output_size == 1) {
@@ -389,6 +404,53 @@ void add_dense_layer_impl(DenseLayer& dense_layer, std::vector<TensorEntity>& te
       }
       break;
     }
+    case Layer_t::GroupedMLP: {
+      std::vector<Initializer_t> initializer_types{dense_layer.weight_init_type,
+                                                   dense_layer.bias_init_type};
+      std::vector<int64_t> num_outputs(dense_layer.num_outputs.begin(),
+                                       dense_layer.num_outputs.end());
+      if (num_outputs.empty()) {
+        HCTR_OWN_THROW(Error_t::WrongInput, "GroupedMLP layer needs num_outputs.");
+      }
+      std::vector<Activation_t> acts(num_outputs.size(), dense_layer.act_type);
+      if (!dense_layer.acts.empty()) {
+        if (acts.size() != dense_layer.acts.size()) {
+          HCTR_OWN_THROW(Error_t::WrongInput,
+                         "The number of activations should be equal to the number of layers.");
+        }
+        acts = dense_layer.acts;
+      }
+      std::vector<bool> biases(num_outputs.size(), dense_layer.use_bias);
+      if (!dense_layer.biases.empty()) {
+        if (biases.size() != dense_layer.biases.size()) {
+          HCTR_OWN_THROW(Error_t::WrongInput,
+                         "The number of biases should be equal to the number of layers.");
+        }
+        biases = dense_layer.biases;
+      }
+
+      // One output per tower
+      auto& in_tensors = input_output_info.input_tensors;
+      int64_t batch_size = in_tensors[0].shape().size(0);
+      std::vector<core23::Tensor> out_tensors;
+      for (size_t t = 0; t < input_output_info.output_names.size(); t++) {
+        out_tensors.emplace_back(tensor_params.shape({batch_size, num_outputs.back()}));
+      }
+      if (use_mixed_precision) {
+        layers.emplace_back(new GroupedMLPLayer<__half>(in_tensors, out_tensors, num_outputs,
+                                                        gpu_resource, acts, biases,
+                                                        initializer_types, skip_dgrad));
+      } else {
+        layers.emplace_back(new GroupedMLPLayer<float>(in_tensors, out_tensors, num_outputs,
+                                                       gpu_resource, acts, biases,
+                                                       initializer_types, skip_dgrad,
+                                                       enable_tf32_compute));
+      }
+      for (size_t t = 0; t < out_tensors.size(); t++) {
+        output_tensor_entities.push_back({input_output_info.output_names[t], out_tensors[t]});
+      }
+      break;
+    }
     case Layer_t::FusedInnerProduct: {
       std::vector<Initializer_t> initializer_types{dense_layer.weight_init_type,
                                                    dense_layer.bias_init_type};
@@ -516,6 +578,7 @@ void add_dense_layer_impl(DenseLayer& dense_layer, std::vector<TensorEntity>& te
       }
       [[maybe_unused]] auto num_attention_heads = dense_layer.num_attention_heads;
       [[maybe_unused]] auto transpose_b = dense_layer.transpose_b;
+      bool fused_attention = dense_layer.fused_attention;
 
       auto& in_tensors = input_output_info.input_tensors;
       if (in_tensors[0].shape().dims() != 3 || in_tensors[1].shape().dims() != 3 ||
@@ -526,11 +589,11 @@ void add_dense_layer_impl(DenseLayer& dense_layer, std::vector<TensorEntity>& te
       if (use_mixed_precision) {
         layers.emplace_back(new MultiHeadAttentionLayer<__half>(
             in_tensors, out_tensors, num_attention_heads, transpose_b, gpu_resource,
-            use_mixed_precision, enable_tf32_compute));
+            use_mixed_precision, enable_tf32_compute, fused_attention));
       } else {
         layers.emplace_back(new MultiHeadAttentionLayer<float>(
             in_tensors, out_tensors, num_attention_heads, transpose_b, gpu_resource,
-            use_mixed_precision, enable_tf32_compute));
+            use_mixed_precision, enable_tf32_compute, fused_attention));
       }
 
       for (size_t i = 0; i < out_tensors.size(); i++) {
@@ -625,7 +688,7 @@ void add_dense_layer_impl(DenseLayer& dense_layer, std::vector<TensorEntity>& te
 
       auto& input_tensor = input_output_info.input_tensors[0];
       auto& label_tensor = input_output_info.input_tensors[1];
-      core23::Tensor loss_tensor(tensor_params.shape({1, 1}).data_type(core23::ScalarType::Float));
+      core23::Tensor loss_tensor(loss_tensor_params);
 
       std::unique_ptr<ILoss> new_loss;
       if (use_mixed_precision) {
@@ -807,21 +870,38 @@ void add_dense_layer_impl(DenseLayer& dense_layer, std::vector<TensorEntity>& te
     }
     case Layer_t::ReduceSum: {
       int axis = dense_layer.axis;
-      auto& in_tensor = input_output_info.input_tensors[0];
+      auto& in_tensors = input_output_info.input_tensors;
       core23::Tensor out_tensor;
-      if (use_mixed_precision) {
-        layers.emplace_back(new ReduceSumLayer<__half>(in_tensor, out_tensor, axis, gpu_resource));
+      // An optional second bottom holds the sequence lengths, as fed to SequenceMask
+      if (in_tensors.size() == 2) {
+        if (use_mixed_precision) {
+          layers.emplace_back(new ReduceSumLayer<__half>(in_tensors[0], in_tensors[1], out_tensor,
+                                                         axis, gpu_resource));
+        } else {
+          layers.emplace_back(new ReduceSumLayer<float>(in_tensors[0], in_tensors[1], out_tensor,
+                                                        axis, gpu_resource));
+        }
+      } else if (use_mixed_precision) {
+        layers.emplace_back(
+            new ReduceSumLayer<__half>(in_tensors[0], out_tensor, axis, gpu_resource));
       } else {
-        layers.emplace_back(new ReduceSumLayer<float>(in_tensor, out_tensor, axis, gpu_resource));
+        layers.emplace_back(
+            new ReduceSumLayer<float>(in_tensors[0], out_tensor, axis, gpu_resource));
       }
       output_tensor_entities.push_back({input_output_info.output_names[0], out_tensor});
       break;
     }
     case Layer_t::ReduceMean: {
       int axis = dense_layer.axis;
-      auto& in_tensor = input_output_info.input_tensors[0];
+      auto& in_tensors = input_output_info.input_tensors;
       core23::Tensor out_tensor;
-      layers.emplace_back(new ReduceMeanLayer<float>(in_tensor, out_tensor, axis, gpu_resource));
+      if (in_tensors.size() == 2) {
+        layers.emplace_back(new ReduceMeanLayer<float>(in_tensors[0], in_tensors[1], out_tensor,
+                                                       axis, gpu_resource));
+      } else {
+        layers.emplace_back(
+            new ReduceMeanLayer<float>(in_tensors[0], out_tensor, axis, gpu_resource));
+      }
       output_tensor_entities.push_back({input_output_info.output_names[0], out_tensor});
       break;
     }
@@ -844,6 +924,19 @@ void add_dense_layer_impl(DenseLayer& dense_layer, std::vector<TensorEntity>& te
       output_tensor_entities.push_back({input_output_info.output_names[0], gru_out_tensor});
       break;
     }
+    case Layer_t::AUGRU: {
+      // W and U use the weight initializer, b the bias one
+      std::vector<Initializer_t> initializer_types{
+          dense_layer.weight_init_type, dense_layer.weight_init_type, dense_layer.bias_init_type};
+      auto& in_tensors = input_output_info.input_tensors;
+      int64_t num_output = dense_layer.num_output;
+      core23::Tensor augru_out_tensor(
+          tensor_params.shape({in_tensors[0].shape().size(0), num_output}));
+      layers.emplace_back(
+          new AUGRULayer<float>(in_tensors, augru_out_tensor, gpu_resource, initializer_types));
+      output_tensor_entities.push_back({input_output_info.output_names[0], augru_out_tensor});
+      break;
+    }
     case Layer_t::MatrixMultiply: {
       auto& in_tensors = input_output_info.input_tensors;
       core23::Tensor out_tensor;
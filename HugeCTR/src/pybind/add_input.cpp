@@ -158,6 +158,14 @@ void add_input(Input& input, DataReaderParams& reader_params,
       int num_threads = reader_params.async_param.num_threads;
       int num_batches_per_thread = reader_params.async_param.num_batches_per_thread;
       bool shuffle = reader_params.async_param.shuffle;
+      IOBackend_t io_backend = reader_params.async_param.io_backend;
+      int shuffle_block_size = reader_params.async_param.shuffle_block_size;
+      bool variable_length = reader_params.async_param.variable_length;
+      DataCache_t train_data_cache = reader_params.async_param.train_data_cache;
+      bool compressed = reader_params.async_param.compressed;
+      const auto& transforms = reader_params.async_param.transforms;
+      auto synthetic = reader_params.async_param.synthetic;
+      HCTR_CHECK_HINT(shuffle_block_size >= 0, "shuffle_block_size should be >= 0");
       int cache_eval_data = reader_params.cache_eval_data;
       bool schedule_h2d = false;
 
@@ -176,8 +184,61 @@ void add_input(Input& input, DataReaderParams& reader_params,
                              << num_batches_per_thread << std::endl;
       HCTR_LOG_S(INFO, ROOT) << "Multi-Hot AsyncDataReader: shuffle = " << (shuffle ? "ON" : "OFF")
                              << std::endl;
+      if (shuffle && shuffle_block_size > 0) {
+        HCTR_LOG_S(INFO, ROOT) << "Multi-Hot AsyncDataReader: shuffle_block_size = "
+                               << shuffle_block_size << std::endl;
+      }
+      if (variable_length) {
+        HCTR_LOG_S(INFO, ROOT) << "Multi-Hot AsyncDataReader: variable_length = ON" << std::endl;
+      }
+      if (compressed) {
+        HCTR_LOG_S(INFO, ROOT) << "Multi-Hot AsyncDataReader: compressed = ON" << std::endl;
+      }
+      if (synthetic) {
+        if (!repeat_dataset) {
+          HCTR_OWN_THROW(Error_t::WrongInput,
+                         "Synthetic data has no epochs, please set repeat_dataset as true");
+        }
+        if (synthetic->slot_size_array.empty()) {
+          synthetic->slot_size_array = reader_params.slot_size_array;
+        }
+        HCTR_LOG_S(INFO, ROOT) << "Multi-Hot AsyncDataReader: synthetic = ON, no files are read"
+                               << std::endl;
+      }
+      const bool int64_file_keys =
+          reader_params.async_param.int64_file_keys && !std::is_same_v<TypeKey, long long>;
+      if (int64_file_keys) {
+        // Every slot has to fit in 32 bits, by its size or by a modulo transform
+        const int num_slots = input.data_reader_sparse_param_array[0].slot_num;
+        HCTR_CHECK_HINT(static_cast<int>(reader_params.slot_size_array.size()) == num_slots,
+                        "int64_file_keys needs the slot_size_array of the ", num_slots,
+                        " slots to narrow the keys to 32 bits.\n");
+        for (int slot = 0; slot < num_slots; slot++) {
+          long long range = reader_params.slot_size_array[slot];
+          for (const auto& transform : transforms) {
+            if (transform.type == DataTransform_t::Modulo && transform.index == slot) {
+              range = transform.modulo;
+            }
+          }
+          HCTR_CHECK_HINT(range > 0 && range <= (1ll << 32), "The keys of slot ", slot,
+                          " do not fit in 32 bits, please set i64_input_key=True.\n");
+        }
+        HCTR_LOG_S(INFO, ROOT)
+            << "Multi-Hot AsyncDataReader: int64_file_keys = ON, the keys are narrowed to 32 bits"
+            << std::endl;
+      }
+      if (train_data_cache != DataCache_t::Off) {
+        HCTR_LOG_S(INFO, ROOT) << "Multi-Hot AsyncDataReader: train_data_cache = "
+                               << (train_data_cache == DataCache_t::Device ? "Device" : "Host")
+                               << std::endl;
+      }
       HCTR_LOG_S(INFO, ROOT) << "Multi-Hot AsyncDataReader: schedule_h2d = "
                              << (schedule_h2d ? "ON" : "OFF") << std::endl;
+      HCTR_LOG_S(INFO, ROOT) << "Multi-Hot AsyncDataReader: io_backend = "
+                             << (io_backend == IOBackend_t::AIO   ? "AIO"
+                                 : io_backend == IOBackend_t::GDS ? "GDS"
+                                                                  : "io_uring")
+                             << std::endl;
 
       MultiHot::FileSource file_source;
       file_source.name = source_data;
@@ -186,13 +247,21 @@ void add_input(Input& input, DataReaderParams& reader_params,
       train_data_reader.reset(new MultiHot::AsyncDataReader<TypeKey>(
           {file_source}, resource_manager, batch_size, num_threads, num_batches_per_thread,
           input.data_reader_sparse_param_array, total_label_dim, dense_dim, use_mixed_precision,
-          shuffle, schedule_h2d, is_float_dense));
+          shuffle, schedule_h2d, is_float_dense, io_backend, shuffle_block_size, variable_length,
+          train_data_cache, compressed, transforms, synthetic,
+          reader_params.async_param.key_profile_file, int64_file_keys));
 
+      // The evaluation draws other samples of the same distribution
+      if (synthetic) {
+        synthetic->seed += 1;
+      }
       file_source.name = eval_source;
       evaluate_data_reader.reset(new MultiHot::AsyncDataReader<TypeKey>(
           {file_source}, resource_manager, batch_size_eval, num_threads,
           eval_num_batches_per_thread, input.data_reader_sparse_param_array, total_label_dim,
-          dense_dim, use_mixed_precision, false, schedule_h2d, is_float_dense));
+          dense_dim, use_mixed_precision, false, schedule_h2d, is_float_dense, io_backend, 0,
+          variable_length, DataCache_t::Off, compressed, transforms, synthetic, std::string(),
+          int64_file_keys));
 
     } else {  // use original one-hot async reader
       bool is_float_dense = reader_params.async_param.is_dense_float;
@@ -223,6 +292,7 @@ void add_input(Input& input, DataReaderParams& reader_params,
       int io_depth = reader_params.async_param.io_depth;
       int io_alignment = reader_params.async_param.io_alignment;
       bool shuffle = reader_params.async_param.shuffle;
+      bool striped_upload = reader_params.async_param.striped_upload;
 
       // Could be different if eval and train datasets are on different storage systems
       int max_logical_sector_size =
@@ -282,6 +352,8 @@ void add_input(Input& input, DataReaderParams& reader_params,
       HCTR_LOG_S(INFO, ROOT) << "AsyncReader: io_depth = " << io_depth << std::endl;
       HCTR_LOG_S(INFO, ROOT) << "AsyncReader: io_alignment = " << io_alignment << std::endl;
       HCTR_LOG_S(INFO, ROOT) << "AsyncReader: shuffle = " << (shuffle ? "ON" : "OFF") << std::endl;
+      HCTR_LOG_S(INFO, ROOT) << "AsyncReader: striped_upload = " << (striped_upload ? "ON" : "OFF")
+                             << std::endl;
       HCTR_LOG_S(INFO, ROOT) << "AsyncReader: num_iterations_statistics = "
                              << num_iterations_statistics << std::endl;
 
@@ -289,7 +361,7 @@ void add_input(Input& input, DataReaderParams& reader_params,
       train_data_reader.reset(new AsyncReader<TypeKey>(
           source_data, batch_size, total_label_dim, dense_dim, input.data_reader_sparse_param_array,
           use_mixed_precision, resource_manager, num_threads, num_batches_per_thread, io_block_size,
-          io_depth, io_alignment, shuffle, wait_for_gpu_idle, aligned_type));
+          io_depth, io_alignment, shuffle, wait_for_gpu_idle, aligned_type, striped_upload));
 
       // If we want to cache eval, make sure we have enough buffers
       auto eval_num_batches_per_thread = num_batches_per_thread;
@@ -307,7 +379,7 @@ void add_input(Input& input, DataReaderParams& reader_params,
           eval_source, batch_size_eval, total_label_dim, dense_dim,
           input.data_reader_sparse_param_array, use_mixed_precision, resource_manager, num_threads,
           eval_num_batches_per_thread, io_block_size * 8, io_depth, io_alignment, false, false,
-          aligned_type));
+          aligned_type, striped_upload));
 
       init_data_reader.reset(new AsyncReader<TypeKey>(
           source_data, num_iterations_statistics * batch_size, total_label_dim, dense_dim,
@@ -458,6 +530,11 @@ void add_input(Input& input, DataReaderParams& reader_params,
     }
     switch (format) {
       case DataReaderType_t::Norm: {
+        if (reader_params.parse_on_device) {
+          HCTR_LOG(WARNING, ROOT,
+                   "parse_on_device is only supported by the Raw reader, the Norm reader parses "
+                   "on the host\n");
+        }
         bool start_right_now = repeat_dataset;
         train_data_reader->create_drwg_norm(source_data, check_type, start_right_now);
         evaluate_data_reader->create_drwg_norm(eval_source, check_type, start_right_now);
@@ -465,9 +542,9 @@ void add_input(Input& input, DataReaderParams& reader_params,
       }
       case DataReaderType_t::Raw: {
         train_data_reader->create_drwg_raw(source_data, num_samples, float_label_dense,
-                                           false /*true*/, false);
+                                           false /*true*/, false, reader_params.parse_on_device);
         evaluate_data_reader->create_drwg_raw(eval_source, eval_num_samples, float_label_dense,
-                                              false, false);
+                                              false, false, reader_params.parse_on_device);
         break;
       }
       case DataReaderType_t::Parquet: {
@@ -75,6 +75,8 @@ SparseEmbedding get_sparse_embedding_from_json(const nlohmann::json& j_sparse_em
     auto optimizer_type_name = get_value_from_json<std::string>(j_optimizer, "type");
     auto update_type_name = get_value_from_json<std::string>(j_optimizer, "update_type");
     embedding_opt_params->initialized = true;
+    embedding_opt_params->fused_update =
+        get_value_from_json_soft<bool>(j_optimizer, "fused_update", false);
     if (!find_item_in_map(embedding_opt_params->optimizer, optimizer_type_name,
                           OPTIMIZER_TYPE_MAP)) {
       HCTR_OWN_THROW(Error_t::WrongInput, "No such optimizer: " + optimizer_type_name);
@@ -95,7 +97,8 @@ SparseEmbedding get_sparse_embedding_from_json(const nlohmann::json& j_sparse_em
         embedding_opt_params->hyperparams = hyperparams;
       } break;
 
-      case Optimizer_t::Adam: {
+      case Optimizer_t::Adam:
+      case Optimizer_t::LazyAdam: {
         auto j_optimizer_hparam = get_json(j_optimizer, "adam_hparam");
         auto beta1 = get_value_from_json<float>(j_optimizer_hparam, "beta1");
         auto beta2 = get_value_from_json<float>(j_optimizer_hparam, "beta2");
@@ -106,7 +109,8 @@ SparseEmbedding get_sparse_embedding_from_json(const nlohmann::json& j_sparse_em
         embedding_opt_params->hyperparams = hyperparams;
       } break;
 
-      case Optimizer_t::AdaGrad: {
+      case Optimizer_t::AdaGrad:
+      case Optimizer_t::RowWiseAdaGrad: {
         auto j_optimizer_hparam = get_json(j_optimizer, "adagrad_hparam");
         auto initial_accu_value =
             get_value_from_json<float>(j_optimizer_hparam, "initial_accu_value");
@@ -155,6 +159,8 @@ SparseEmbedding get_sparse_embedding_from_json(const nlohmann::json& j_sparse_em
       get_value_from_json_soft<double>(j_hparam, "max_all_to_all_bandwidth", 1.9e11);
   hybrid_embedding_param.efficiency_bandwidth_ratio =
       get_value_from_json_soft<double>(j_hparam, "efficiency_bandwidth_ratio", 1.0);
+  hybrid_embedding_param.recalibration_interval =
+      get_value_from_json_soft<size_t>(j_hparam, "recalibration_interval", 0);
   std::string communication_type_string =
       get_value_from_json_soft<std::string>(j_hparam, "communication_type", "IB_NVLink");
   std::string hybrid_embedding_type_string =
@@ -254,6 +260,10 @@ void add_sparse_embedding(SparseEmbedding& sparse_embedding,
       break;
     }
     case Embedding_t::HybridSparseEmbedding: {
+      HCTR_THROW_IF(!grouped_all_reduce &&
+                        !std::dynamic_pointer_cast<NetworkExchangeWgrad<TypeFP>>(exchange_wgrad),
+                    Error_t::WrongInput,
+                    "HybridSparseEmbedding cannot be used with shard_dense_optimizer.");
       auto& embed_wgrad_buff =
           (grouped_all_reduce)
               ? std::dynamic_pointer_cast<GroupedExchangeWgrad<TypeFP>>(exchange_wgrad)
@@ -277,7 +287,8 @@ void add_sparse_embedding(SparseEmbedding& sparse_embedding,
           sparse_embedding.hybrid_embedding_param.max_all_to_all_bandwidth,  // TBD
           sparse_embedding.hybrid_embedding_param.efficiency_bandwidth_ratio,
           sparse_embedding.hybrid_embedding_param.hybrid_embedding_type,
-          embedding_opt_params};
+          embedding_opt_params,
+          sparse_embedding.hybrid_embedding_param.recalibration_interval};
       embeddings.emplace_back(new HybridSparseEmbedding<TypeKey, TypeFP>(
           core_helper::convert_sparse_tensors23_to_sparse_tensors<TypeKey>(
               sparse_input.train_sparse_tensors),
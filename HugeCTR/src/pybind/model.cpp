@@ -18,17 +18,24 @@
 
 #include <algorithm>
 #include <core/hctr_impl/hctr_backend.hpp>
+#include <core23/instrumentation.hpp>
 #include <core23/logger.hpp>
 #include <core23/mpi_init_service.hpp>
 #include <core23_helper.hpp>
 #include <core23_network.hpp>
 #include <data_readers/async_reader/async_reader_adapter.hpp>
 #include <data_readers/multi_hot/async_data_reader.hpp>
+#include <embedding/operators/row_sharding.hpp>
+#include <embeddings/delta_tracker.hpp>
+#include <embeddings/embedding_hot_keys.hpp>
 #include <embeddings/hybrid_sparse_embedding.hpp>
 #include <fstream>
+#include <gemm_algo_cache.hpp>
 #include <iomanip>
 #include <iterator>
 #include <network_buffer_channels.hpp>
+#include <network_helpers.hpp>
+#include <prediction_writer.hpp>
 #include <pybind/model.hpp>
 #include <resource_managers/resource_manager_ext.hpp>
 #include <sstream>
@@ -38,6 +45,9 @@ namespace HugeCTR {
 
 namespace {
 
+// Rows of a table copied to the host at once by the incremental model stream
+constexpr size_t kDeltaStagingRows = 65536;
+
 /**
  * check if device is available.
  * lowest available CC is min_major.min_minor
@@ -115,6 +125,16 @@ static void check_device(int device_id, int min_major, int min_minor) {
   return;
 }
 
+// The bytes of a row of an embedding table of the embedding collection with its optimizer states.
+static size_t embedding_row_bytes(const embedding::EmbeddingTableParam& table_param,
+                                  size_t ev_size) {
+  const OptParams& opt_param = table_param.opt_param;
+  const size_t opt_state_size = table_param.fp16_opt_state ? sizeof(__half) : sizeof(float);
+  return ev_size * sizeof(float) +
+         ev_size * opt_param.num_parameters_per_weight() * opt_state_size +
+         opt_param.num_parameters_per_row() * sizeof(float);
+}
+
 template <typename TypeKey>
 auto load_key_files(std::vector<std::string> const& key_files) {
   std::vector<TypeKey> keys_vec;
@@ -138,20 +158,24 @@ auto load_key_files(std::vector<std::string> const& key_files) {
 
 EmbeddingTrainingCacheParams::EmbeddingTrainingCacheParams(
     std::vector<TrainPSType_t>& _ps_types, std::vector<std::string>& _sparse_models,
-    std::vector<std::string>& _local_paths, std::vector<HMemCacheConfig>& _hmem_cache_configs)
+    std::vector<std::string>& _local_paths, std::vector<HMemCacheConfig>& _hmem_cache_configs,
+    bool _async_tiering)
     : use_embedding_training_cache(true),
       ps_types(_ps_types),
       sparse_models(_sparse_models),
       local_paths(_local_paths),
-      hmem_cache_configs(_hmem_cache_configs) {}
+      hmem_cache_configs(_hmem_cache_configs),
+      async_tiering(_async_tiering) {}
 
 EmbeddingTrainingCacheParams::EmbeddingTrainingCacheParams()
-    : use_embedding_training_cache(false) {}
+    : use_embedding_training_cache(false), async_tiering(false) {}
 
-DenseLayerComputeConfig::DenseLayerComputeConfig() : async_wgrad(false), fuse_wb(false){};
+DenseLayerComputeConfig::DenseLayerComputeConfig()
+    : async_wgrad(false), fuse_wb(false), enable_fp8(false), recompute(false){};
 
-DenseLayerComputeConfig::DenseLayerComputeConfig(bool async_wgrad, bool fuse_wb)
-    : async_wgrad(async_wgrad), fuse_wb(fuse_wb){};
+DenseLayerComputeConfig::DenseLayerComputeConfig(bool async_wgrad, bool fuse_wb, bool enable_fp8,
+                                                 bool recompute)
+    : async_wgrad(async_wgrad), fuse_wb(fuse_wb), enable_fp8(enable_fp8), recompute(recompute){};
 
 DataReaderParams::DataReaderParams(DataReaderType_t data_reader_type,
                                    std::vector<std::string> source, std::vector<std::string> keyset,
@@ -160,7 +184,7 @@ DataReaderParams::DataReaderParams(DataReaderType_t data_reader_type,
                                    bool float_label_dense, bool read_file_sequentially,
                                    int num_workers, std::vector<long long>& slot_size_array,
                                    const DataSourceParams& data_source_params,
-                                   const AsyncParam& async_param)
+                                   const AsyncParam& async_param, bool parse_on_device)
     : data_reader_type(data_reader_type),
       source(source),
       keyset(keyset),
@@ -174,7 +198,8 @@ DataReaderParams::DataReaderParams(DataReaderType_t data_reader_type,
       num_workers(num_workers),
       slot_size_array(slot_size_array),
       data_source_params(data_source_params),
-      async_param(async_param) {}
+      async_param(async_param),
+      parse_on_device(parse_on_device) {}
 
 DataReaderParams::DataReaderParams(DataReaderType_t data_reader_type, std::string source,
                                    std::string keyset, std::string eval_source, Check_t check_type,
@@ -183,7 +208,7 @@ DataReaderParams::DataReaderParams(DataReaderType_t data_reader_type, std::strin
                                    bool read_file_sequentially, int num_workers,
                                    std::vector<long long>& slot_size_array,
                                    const DataSourceParams& data_source_params,
-                                   const AsyncParam& async_param)
+                                   const AsyncParam& async_param, bool parse_on_device)
     : data_reader_type(data_reader_type),
       eval_source(eval_source),
       check_type(check_type),
@@ -195,7 +220,8 @@ DataReaderParams::DataReaderParams(DataReaderType_t data_reader_type, std::strin
       num_workers(num_workers),
       slot_size_array(slot_size_array),
       data_source_params(data_source_params),
-      async_param(async_param) {
+      async_param(async_param),
+      parse_on_device(parse_on_device) {
   this->source.push_back(source);
   this->keyset.push_back(keyset);
 }
@@ -296,7 +322,7 @@ DenseLayer::DenseLayer(
     Activation_t act_type, std::vector<size_t> num_outputs, bool use_bias,
     std::vector<Activation_t> acts, std::vector<bool> biases,
     DenseLayerComputeConfig compute_config, const std::vector<int64_t>& reshape_out_dimension,
-    int dim, const std::vector<int64_t>& index)
+    int dim, const std::vector<int64_t>& index, bool fused_attention)
     : layer_type(layer_type),
       bottom_names(bottom_names),
       top_names(top_names),
@@ -327,6 +353,7 @@ DenseLayer::DenseLayer(
       max_sequence_len_to(max_sequence_len_to),
       num_attention_heads(num_attention_heads),
       transpose_b(transpose_b),
+      fused_attention(fused_attention),
       target_weight_vec(target_weight_vec),
       use_regularizer(use_regularizer),
       regularizer_type(regularizer_type),
@@ -367,6 +394,7 @@ void init_optimizer_params(OptParams& opt_params, const Solver& solver,
   opt_params.lr = solver.lr;
   opt_params.update_type = opt_params_py->update_type;
   opt_params.scaler = solver.scaler;
+  opt_params.fused_update = opt_params_py->fused_update;
   opt_params.hyperparams.ftrl.beta = opt_params_py->hyperparams.ftrl.beta;
   opt_params.hyperparams.ftrl.lambda1 = opt_params_py->hyperparams.ftrl.lambda1;
   opt_params.hyperparams.ftrl.lambda2 = opt_params_py->hyperparams.ftrl.lambda2;
@@ -385,12 +413,13 @@ void init_learning_rate_scheduler(std::shared_ptr<LearningRateScheduler>& lr_sch
                                   const Solver& solver, GpuLearningRateSchedulers& gpu_lr_sches,
                                   const std::shared_ptr<ResourceManager>& resource_manager) {
   lr_sch.reset(new LearningRateScheduler(solver.lr, solver.warmup_steps, solver.decay_start,
-                                         solver.decay_steps, solver.decay_power, solver.end_lr));
+                                         solver.decay_steps, solver.decay_power, solver.end_lr,
+                                         solver.lr_policy, solver.decay_rate));
   for (size_t i = 0; i < resource_manager->get_local_gpu_count(); i++) {
     auto& gpu_resource = resource_manager->get_local_gpu(i);
     gpu_lr_sches.emplace_back(new GpuLearningRateScheduler(
         solver.lr, solver.warmup_steps, solver.decay_start, solver.decay_steps, solver.decay_power,
-        solver.end_lr, gpu_resource));
+        solver.end_lr, gpu_resource, solver.lr_policy, solver.decay_rate));
   }
 }
 
@@ -399,7 +428,13 @@ void init_exchange_wgrad(const std::shared_ptr<ResourceManager>& resource_manage
   HCTR_LOG(INFO, ROOT, "Using All-reduce algorithm: %s\n",
            ALLREDUCE_ALGO_TO_STRING[solver.all_reduce_algo].c_str());
   resource_manager->set_ar_comm(solver.all_reduce_algo, solver.use_mixed_precision);
-  if (solver.grouped_all_reduce) {
+  if (solver.shard_dense_optimizer && resource_manager->get_global_gpu_count() > 1) {
+    if (solver.use_mixed_precision) {
+      exchange_wgrad = std::make_shared<ShardedExchangeWgrad<__half>>(resource_manager);
+    } else {
+      exchange_wgrad = std::make_shared<ShardedExchangeWgrad<float>>(resource_manager);
+    }
+  } else if (solver.grouped_all_reduce) {
     if (solver.use_mixed_precision) {
       exchange_wgrad = std::make_shared<GroupedExchangeWgrad<__half>>(resource_manager);
     } else {
@@ -442,7 +477,12 @@ Model::Model(const Solver& solver, const DataReaderParams& reader_params,
   } else {
     HCTR_LOG(INFO, ROOT, "Initialize model: %s\n", solver_.model_name.c_str());
   }
+  if (solver_.all_reduce_algo == AllReduceAlgo::AUTO) {
+    // Let NCCL reduce in the network (CollNet/SHARP) where it can, unless set explicitly
+    setenv("NCCL_COLLNET_ENABLE", "1", 0);
+  }
   resource_manager_ = ResourceManagerExt::create(solver.vvgpu, solver.seed, solver.device_layout);
+  memory_planner_ = std::make_unique<MemoryPlanner>(resource_manager_);
 
   embedding_para_io_ = std::shared_ptr<embedding::EmbeddingParameterIO>(
       new embedding::EmbeddingParameterIO(resource_manager_));
@@ -461,9 +501,11 @@ Model::Model(const Solver& solver, const DataReaderParams& reader_params,
     HCTR_OWN_THROW(Error_t::WrongInput,
                    " The data source for training and evaluation should be specified");
   }
-  if (etc_params_->use_embedding_training_cache && solver_.kafka_brokers.length()) {
+  if (solver_.kafka_brokers.length()) {
     KafkaMessageSinkParams params;
     params.brokers = solver_.kafka_brokers;
+    params.compression_codec = solver_.kafka_compression_codec;
+    params.value_precision = solver_.kafka_value_precision;
     message_sink_ = std::make_shared<KafkaMessageSink<long long>>(params);
   }
   if (etc_params_->use_embedding_training_cache && solver_.repeat_dataset) {
@@ -494,6 +536,11 @@ Model::Model(const Solver& solver, const DataReaderParams& reader_params,
 }
 
 Model::~Model() {
+  wait_for_dense_checkpoint_();
+  wait_for_incremental_model_stream_();
+  if (dense_checkpoint_buffer_) {
+    HCTR_LIB_CHECK_(cudaFreeHost(dense_checkpoint_buffer_));
+  }
   for (auto device : resource_manager_->get_local_gpu_device_id_list()) {
     CudaDeviceContext context(device);
     HCTR_LIB_CHECK_(cudaDeviceSynchronize());
@@ -645,6 +692,7 @@ void Model::add(Input& input) {
   for (unsigned int i = 0; i < input.data_reader_sparse_param_array.size(); i++) {
     activate_tensor(tensor_active_, input.data_reader_sparse_param_array[i].top_name);
   }
+  memory_planner_->begin();
   if (solver_.i64_input_key) {
     add_input<long long>(input, reader_params_, sparse_input_map_64_, train_tensor_entities_list_,
                          evaluate_tensor_entities_list_, train_data_reader_, evaluate_data_reader_,
@@ -660,6 +708,7 @@ void Model::add(Input& input) {
                             solver_.repeat_dataset, solver_.train_intra_iteration_overlap,
                             solver_.num_iterations_statistics, resource_manager_);
   }
+  memory_planner_->end("Data readers", true);
 
   if (solver_.use_embedding_collection and solver_.train_inter_iteration_overlap) {
     create_copy_ops_for_network_input(input.dense_name, label_name, true);
@@ -713,6 +762,9 @@ void Model::add(SparseEmbedding& sparse_embedding) {
     sparse_embedding.embedding_opt_params = opt_params_py_;
     sparse_embedding.initialize_max_vocabulary_size_per_gpu();
   }
+  HCTR_CHECK_HINT(
+      OptParams::num_parameters_per_row(sparse_embedding.embedding_opt_params->optimizer) == 0,
+      "The row-wise optimizers are only supported by the embedding collection.");
   sparse_embedding.max_vocabulary_size_global =
       sparse_embedding.max_vocabulary_size_per_gpu * resource_manager_->get_global_gpu_count();
   sparse_embedding_params_.push_back(sparse_embedding);
@@ -729,6 +781,7 @@ void Model::add(SparseEmbedding& sparse_embedding) {
 
   embedding_opt_params_list_.push_back(sparse_embedding.embedding_opt_params);
   init_optimizer_params(embedding_opt_params, solver_, sparse_embedding.embedding_opt_params);
+  memory_planner_->begin();
   if (solver_.i64_input_key && !solver_.use_mixed_precision) {
     add_sparse_embedding<long long, float>(
         sparse_embedding, sparse_input_map_64_, train_tensor_entities_list_,
@@ -754,6 +807,8 @@ void Model::add(SparseEmbedding& sparse_embedding) {
         solver_.batchsize_eval, embedding_opt_params, exchange_wgrad_, solver_.use_cuda_graph,
         solver_.grouped_all_reduce, solver_.num_iterations_statistics, gpu_lr_sches_);
   }
+  // Dominated by the tables of workspace_size_per_gpu_in_mb.
+  memory_planner_->end("Sparse embeddings", false);
   embeddings_map_.insert(
       std::make_pair(sparse_embedding.sparse_embedding_name, embeddings_.back()));
   embedding_dependent_tensors_.insert(sparse_embedding.sparse_embedding_name);
@@ -874,6 +929,92 @@ std::vector<int> get_table_id_to_vocabulary_size(
   return table_id_to_vocabulary_size;
 }
 
+std::vector<std::vector<int64_t>> Model::create_table_hot_keys_(
+    const EmbeddingCollectionConfig& ebc_config, const TableNameToIDDict& table_name_to_id_dict,
+    const std::vector<std::vector<int>>& shard_matrix) {
+  std::vector<std::vector<int64_t>> table_hot_keys(table_name_to_id_dict.size());
+  auto hybrid_table_names = get_hybrid_table_names_from_ebc_config(ebc_config);
+  if (hybrid_table_names.empty()) return table_hot_keys;
+
+  HCTR_CHECK_HINT(reader_params_.data_reader_type == DataReaderType_t::RawAsync &&
+                      !reader_params_.source.empty() && !input_params_.empty(),
+                  "Hybrid table placement samples the key frequencies from the RawAsync training "
+                  "data, please use the RawAsync reader.\n");
+
+  // Slot layout of the training data, see add(Input&).
+  const Input& input = input_params_.back();
+  RawSampleLayout layout;
+  layout.label_dim = 0;
+  for (auto& [name, dim] : input.labels_) {
+    layout.label_dim += dim;
+  }
+  layout.dense_dim = input.dense_dim;
+  std::unordered_map<std::string, int> slot_name_to_id;
+  for (auto& p : input.data_reader_sparse_param_array) {
+    slot_name_to_id[p.top_name] = static_cast<int>(layout.nnz_per_slot.size());
+    layout.nnz_per_slot.push_back(p.nnz_per_slot[0]);
+  }
+  layout.key_bytes = reader_params_.async_param.multi_hot_reader &&
+                             (solver_.i64_input_key || reader_params_.async_param.int64_file_keys)
+                         ? 8
+                         : 4;
+
+  const int64_t num_iterations = static_cast<int64_t>(solver_.num_iterations_statistics);
+  auto slot_frequencies = sample_raw_key_frequencies(reader_params_.source[0], layout,
+                                                     num_iterations * solver_.batchsize);
+
+  const int num_total_gpus = resource_manager_->get_global_gpu_count();
+  for (auto& table_name : hybrid_table_names) {
+    HCTR_CHECK_HINT(table_name_to_id_dict.find(table_name) != table_name_to_id_dict.end(),
+                    "Hybrid table ", table_name, " is not in the embedding collection.\n");
+    int table_id = table_name_to_id_dict.at(table_name);
+    for (int gpu_id = 0; gpu_id < num_total_gpus; ++gpu_id) {
+      HCTR_CHECK_HINT(shard_matrix[gpu_id][table_id] == 1, "Hybrid table ", table_name,
+                      " should be placed on all GPUs.\n");
+    }
+    int64_t vocabulary_size = 0;
+    bool hash_keys = false;
+    for (auto& table_config : ebc_config.emb_table_config_list_) {
+      if (table_config.name != table_name) continue;
+      vocabulary_size = table_config.table_param.max_vocabulary_size;
+      hash_keys = table_config.table_param.hash_keys;
+      HCTR_CHECK_HINT(vocabulary_size > 0, "Hybrid table ", table_name,
+                      " should be a static table with max_vocabulary_size > 0.\n");
+      HCTR_CHECK_HINT(!table_config.table_param.fp16_opt_state, "Hybrid table ", table_name,
+                      " does not support fp16_opt_state.\n");
+    }
+
+    KeyFrequencies frequencies;
+    for (size_t lookup_id = 0; lookup_id < ebc_config.lookup_configs_.size(); ++lookup_id) {
+      auto& [lookup_table_name, lookup_param] = ebc_config.lookup_configs_[lookup_id];
+      if (lookup_table_name != table_name) continue;
+      // Only the sparse all-to-all of concat lookups shrinks when hot keys stay local.
+      HCTR_CHECK_HINT(lookup_param.combiner == embedding::Combiner::Concat, "Hybrid table ",
+                      table_name, " only supports concat lookups.\n");
+      auto slot_iter = slot_name_to_id.find(ebc_config.bottom_names_[lookup_id]);
+      HCTR_CHECK_HINT(slot_iter != slot_name_to_id.end(), "The input of hybrid table ",
+                      table_name, " should be a sparse input.\n");
+      for (auto& [key, count] : slot_frequencies[slot_iter->second]) {
+        if (hash_keys) {
+          frequencies[static_cast<int64_t>(embedding::hash_key_to_row(key, vocabulary_size))] +=
+              count;
+        } else if (key >= 0 && key < vocabulary_size) {
+          frequencies[key] += count;
+        }
+      }
+    }
+
+    auto hot_keys = select_hot_keys(frequencies, num_iterations, num_total_gpus,
+                                    ebc_config.hybrid_all_to_all_bandwidth_,
+                                    ebc_config.hybrid_all_reduce_bandwidth_,
+                                    ebc_config.hybrid_max_num_hot_rows_);
+    HCTR_LOG_S(INFO, ROOT) << "Hybrid table " << table_name << ": " << hot_keys.size()
+                           << " hot rows are replicated on all GPUs" << std::endl;
+    table_hot_keys[table_id] = std::move(hot_keys);
+  }
+  return table_hot_keys;
+}
+
 void Model::add(const EmbeddingCollectionConfig& ebc_config) {
   TableNameToIDDict table_name_to_id_dict =
       create_table_name_to_id_dict_from_ebc_config(ebc_config);
@@ -928,7 +1069,9 @@ void Model::add(const EmbeddingCollectionConfig& ebc_config) {
   auto emb_table_list = create_table_params_from_ebc_config(table_name_to_id_dict, ebc_config);
   for (auto& p : emb_table_list) {
     if (p.opt_param.optimizer == Optimizer_t::NOT_INITIALIZED) {
+      const float lr_multiplier = p.opt_param.lr_multiplier;
       p.opt_param = opt_params_;
+      p.opt_param.lr_multiplier = lr_multiplier;
     }
   }
 
@@ -972,6 +1115,23 @@ void Model::add(const EmbeddingCollectionConfig& ebc_config) {
                                                      ebc_config.keys_preprocess_strategy_,
                                                      ebc_config.allreduce_strategy_,
                                                      ebc_config.comm_strategy_};
+  ebc_param.num_all2all_chunks_ = ebc_config.num_all2all_chunks_;
+  eval_ebc_param.num_all2all_chunks_ = ebc_config.num_all2all_chunks_;
+  ebc_param.num_gradient_accumulation_steps_ = ebc_config.num_gradient_accumulation_steps_;
+  ebc_param.all2all_compression_ = ebc_config.all2all_compression_;
+  eval_ebc_param.all2all_compression_ = ebc_config.all2all_compression_;
+  ebc_param.unique_keys_before_all2all_ = ebc_config.unique_keys_before_all2all_;
+  eval_ebc_param.unique_keys_before_all2all_ = ebc_config.unique_keys_before_all2all_;
+  ebc_param.sync_free_ = ebc_config.sync_free_;
+  eval_ebc_param.sync_free_ = ebc_config.sync_free_;
+  ebc_param.deterministic_ = ebc_config.deterministic_;
+  eval_ebc_param.deterministic_ = ebc_config.deterministic_;
+  ebc_param.table_shard_row_offsets_ =
+      create_table_shard_row_offsets_from_ebc_config(table_name_to_id_dict, ebc_config);
+  eval_ebc_param.table_shard_row_offsets_ = ebc_param.table_shard_row_offsets_;
+  ebc_param.table_hot_keys_ =
+      create_table_hot_keys_(ebc_config, table_name_to_id_dict, shard_matrix);
+  eval_ebc_param.table_hot_keys_ = ebc_param.table_hot_keys_;
 
   std::vector<std::shared_ptr<core::CoreResourceManager>> core_list;
 
@@ -980,8 +1140,23 @@ void Model::add(const EmbeddingCollectionConfig& ebc_config) {
         std::make_shared<hctr_internal::HCTRCoreResourceManager>(resource_manager_, local_gpu_id);
     core_list.push_back(core_resource_manager);
   }
+  memory_planner_->begin();
   ebc_list_.push_back(std::make_unique<embedding::EmbeddingCollection>(
       resource_manager_, core_list, ebc_param, eval_ebc_param, emb_table_list, exchange_wgrad_));
+  std::vector<size_t> table_bytes(num_local_gpus, 0);
+  for (int local_gpu_id = 0; local_gpu_id < num_local_gpus; ++local_gpu_id) {
+    for (const auto& table : ebc_list_.back()->embedding_tables_[local_gpu_id]) {
+      const std::vector<int> table_ids = table->table_ids();
+      const std::vector<int> ev_sizes = table->table_evsize();
+      const std::vector<size_t> capacities = table->capacity_per_table();
+      for (size_t i = 0; i < table_ids.size(); ++i) {
+        const size_t num_rows = capacities[i] / std::max(ev_sizes[i], 1);
+        table_bytes[local_gpu_id] +=
+            num_rows * embedding_row_bytes(emb_table_list[table_ids[i]], ev_sizes[i]);
+      }
+    }
+  }
+  memory_planner_->end("Embedding collections", table_bytes);
   embedding_para_io_->add_embedding_collection((ebc_list_[ebc_list_.size() - 1]).get());
 
   auto prepare_ebc_input = [&](auto& sparse_input_map, bool is_longlong) {
@@ -1033,6 +1208,7 @@ void Model::add(const EmbeddingCollectionConfig& ebc_config) {
   }
 
   // activate_ebc_output_tensor
+  memory_planner_->begin();
   size_t batch_size_per_gpu = solver_.batchsize / num_total_gpus;
   size_t eval_batch_size_per_gpu = solver_.batchsize_eval / num_total_gpus;
   if (ebc_param.output_layout_ == embedding::EmbeddingLayout::FeatureMajor) {
@@ -1124,6 +1300,7 @@ void Model::add(const EmbeddingCollectionConfig& ebc_config) {
   train_data_distributor_ = std::make_shared<DataDistributor>(core_list, ebc_param, emb_table_list);
   eval_data_distributor_ =
       std::make_shared<DataDistributor>(core_list, eval_ebc_param, emb_table_list);
+  memory_planner_->end("Data distributors", true);
 }
 
 void Model::pre_add_dense_layer(DenseLayer& dense_layer) {
@@ -1207,6 +1384,9 @@ void Model::add(GroupDenseLayer& group_dense_layer) {
 
 void Model::graph_analysis() {
   HCTR_LOG(INFO, ROOT, "Graph analysis to resolve tensor dependency\n");
+  if (solver_.fuse_dense_layers) {
+    fuse_dense_layers(dense_layer_params_raw_, tensor_shape_info_raw_);
+  }
   std::map<std::string, unsigned int> tensor_usage;
   std::map<std::string, DenseLayer> tensor_slice_layer;
   std::map<std::string, unsigned int> tensor_slice_index;
@@ -1277,6 +1457,7 @@ void Model::compile() {
   HCTR_PRINT(INFO,
              "===================================================Model "
              "Compile===================================================\n");
+  memory_planner_->begin();
   build_networks();
 
   // TODO: this is a WAR; need to find a way to remove the preallocation
@@ -1295,6 +1476,30 @@ void Model::compile() {
     HCTR_LOG_S(DEBUG, ROOT) << "Nothing to preallocate" << std::endl;
   }
   initialize();
+  // Without the embedding training cache, the tables stay on the GPUs and the rows that the
+  // training updates are tracked there to stream them into Kafka.
+  if (message_sink_ && !etc_params_->use_embedding_training_cache) {
+    for (size_t i = 0; i < embeddings_.size(); i++) {
+      if (!embeddings_[i]->enable_delta_tracking(kDeltaStagingRows)) {
+        HCTR_LOG_S(WARNING, ROOT) << "The updates of "
+                                  << sparse_embedding_params_[i].sparse_embedding_name
+                                  << " cannot be streamed into Kafka." << std::endl;
+      }
+    }
+  }
+  // The weights, their gradients and the optimizer states do not depend on the batch size.
+  const size_t num_weights = networks_[0]->get_params_num();
+  const size_t num_weight_shards =
+      dense_shards_.empty() ? 1 : resource_manager_->get_global_gpu_count();
+  const size_t num_opt_states =
+      OptParams::num_parameters_per_weight(opt_params_.optimizer) * num_weights / num_weight_shards;
+  const size_t weight_bytes =
+      num_weights * (solver_.use_mixed_precision ? sizeof(float) + 2 * sizeof(__half)
+                                                 : 2 * sizeof(float)) +
+      num_opt_states * sizeof(float);
+  memory_planner_->end(
+      "Dense networks",
+      std::vector<size_t>(resource_manager_->get_local_gpu_count(), weight_bytes));
   create_metrics();
   create_pipelines();
 }
@@ -1328,6 +1533,49 @@ void Model::load_dense_optimizer_states(const std::string& dense_opt_states_file
   load_opt_states_for_dense_(dense_opt_states_file);
 }
 
+void Model::recover() {
+  if (!buff_allocated_) {
+    HCTR_OWN_THROW(Error_t::IllegalCall, "Cannot recover before calling Model.compile()");
+  }
+  wait_for_dense_checkpoint_();
+  resource_manager_->recreate_nccl_comms();
+
+  // Only the master process keeps the pinned snapshot, the others receive it.
+  const size_t weights_size = networks_[0]->get_params_num() * sizeof(float);
+  const size_t snapshot_size = weights_size + networks_[0]->get_opt_states_size_in_byte();
+  int has_snapshot = dense_checkpoint_buffer_ != nullptr;
+#ifdef ENABLE_MPI
+  HCTR_MPI_THROW(MPI_Bcast(&has_snapshot, 1, MPI_INT, resource_manager_->get_master_process_id(),
+                           MPI_COMM_WORLD));
+#endif
+  if (!has_snapshot) {
+    HCTR_LOG_S(WARNING, ROOT) << "No async checkpoint to recover the dense model from, reload the "
+                                 "last snapshot files if the replicas may have diverged"
+                              << std::endl;
+    return;
+  }
+#ifdef ENABLE_MPI
+  if (!dense_checkpoint_buffer_) {
+    CudaCPUDeviceContext context(networks_[0]->get_device_id());
+    HCTR_LIB_THROW(cudaMallocHost(&dense_checkpoint_buffer_, snapshot_size));
+    dense_checkpoint_buffer_size_ = snapshot_size;
+  }
+  // MPI counts are ints
+  constexpr size_t max_count = 1ul << 30;
+  for (size_t offset = 0; offset < snapshot_size; offset += max_count) {
+    HCTR_MPI_THROW(MPI_Bcast(dense_checkpoint_buffer_ + offset,
+                             static_cast<int>(std::min(max_count, snapshot_size - offset)),
+                             MPI_BYTE, resource_manager_->get_master_process_id(),
+                             MPI_COMM_WORLD));
+  }
+#endif
+  for (auto& network : networks_) {
+    network->upload_params_to_device(reinterpret_cast<float*>(dense_checkpoint_buffer_));
+    network->upload_opt_states_to_device(dense_checkpoint_buffer_ + weights_size);
+  }
+  HCTR_LOG_S(INFO, ROOT) << "Recovered the dense model from the last async checkpoint" << std::endl;
+}
+
 void Model::load_sparse_optimizer_states(const std::vector<std::string>& sparse_opt_states_files) {
   if (!buff_allocated_) {
     HCTR_OWN_THROW(Error_t::IllegalCall,
@@ -1472,27 +1720,17 @@ void Model::embedding_load(const std::string& path, const std::vector<std::strin
                      "can not find table_id in model table_ids,please check your input");
     }
 
+    // Every local GPU gets the keys that its filter selects, the files are read once.
+    std::vector<embeddingFilter> key_selects;
+    std::vector<size_t> target_local_gpu_ids;
     if (target_placement == embedding::TablePlacementStrategy::DataParallel) {
-      auto tmp_filter = [=](size_t key) { return true; };
-      core23::Tensor keys;
-      core23::Tensor embedding_weights;
-      auto& target_key_type = tmp_ebc_param.key_type;
-      auto& target_value_type = tmp_ebc_param.emb_type;
-      embedding_para_io_->load_embedding_weight(tmp_epi, file_table_id, keys, embedding_weights,
-                                                tmp_filter, core_list[0], target_key_type,
-                                                target_value_type);
       for (size_t local_gpu_id = 0; local_gpu_id < num_local_gpus; ++local_gpu_id) {
-        HugeCTR::CudaDeviceContext context(core_list[local_gpu_id]->get_device_id());
-        auto& grouped_table =
-            tmp_embedding_collection->embedding_tables_[local_gpu_id][target_grouped_id];
-        grouped_table->load_by_id(&keys, &embedding_weights, model_table_id);
+        key_selects.push_back([=](size_t key) { return true; });
+        target_local_gpu_ids.push_back(local_gpu_id);
       }
     } else if (target_placement == embedding::TablePlacementStrategy::ModelParallel) {
       for (size_t local_gpu_id = 0; local_gpu_id < num_local_gpus; ++local_gpu_id) {
-        HugeCTR::CudaDeviceContext context(core_list[local_gpu_id]->get_device_id());
         size_t global_id = resource_manager_->get_gpu_global_id_from_local_id(local_gpu_id);
-        auto& target_key_type = tmp_ebc_param.key_type;
-        auto& target_value_type = tmp_ebc_param.emb_type;
         std::vector<int> shard_gpu_list;
         for (int gpu_id = 0; gpu_id < num_total_gpus; ++gpu_id) {
           HCTR_CHECK_HINT(model_table_id < static_cast<int>(tmp_shard_matrix[gpu_id].size()),
@@ -1509,26 +1747,46 @@ void Model::embedding_load(const std::string& path, const std::vector<std::strin
         }
         int shard_id = static_cast<int>(std::distance(shard_gpu_list.begin(), find_shard_id_iter));
 
-        auto tmp_filter = [=](size_t key) { return key % num_shards == shard_id; };
-        core23::Tensor keys;
-        core23::Tensor embedding_weights;
-        embedding_para_io_->load_embedding_weight(tmp_epi, file_table_id, keys, embedding_weights,
-                                                  tmp_filter, core_list[0], target_key_type,
-                                                  target_value_type);
-        auto& grouped_table =
-            tmp_embedding_collection->embedding_tables_[local_gpu_id][target_grouped_id];
-        grouped_table->load_by_id(&keys, &embedding_weights, model_table_id);
+        const int64_t* row_offsets = tmp_ebc_param.get_table_shard_row_offsets(model_table_id);
+        // Hot rows of hybrid tables are replicated on every GPU.
+        const std::vector<int64_t>* hot_keys =
+            tmp_ebc_param.get_table_num_hot_keys(model_table_id) > 0
+                ? &tmp_ebc_param.table_hot_keys_[model_table_id]
+                : nullptr;
+        auto tmp_filter = [=](size_t key) {
+          if (hot_keys != nullptr &&
+              std::binary_search(hot_keys->begin(), hot_keys->end(), static_cast<int64_t>(key))) {
+            return true;
+          }
+          return embedding::row_shard_id(key, row_offsets, num_shards) == shard_id;
+        };
+        key_selects.push_back(tmp_filter);
+        target_local_gpu_ids.push_back(local_gpu_id);
       }
     } else {
       HCTR_OWN_THROW(Error_t::UnspecificError, "unsupported parallel mode");
     }
+    if (key_selects.empty()) continue;
+
+    auto load_chunk = [&](size_t filter_id, core23::Tensor& keys,
+                          core23::Tensor& embedding_weights) {
+      size_t local_gpu_id = target_local_gpu_ids[filter_id];
+      HugeCTR::CudaDeviceContext context(core_list[local_gpu_id]->get_device_id());
+      auto& grouped_table =
+          tmp_embedding_collection->embedding_tables_[local_gpu_id][target_grouped_id];
+      grouped_table->load_by_id(&keys, &embedding_weights, model_table_id);
+    };
+    embedding_para_io_->load_embedding_weight_in_chunks(tmp_epi, file_table_id, key_selects,
+                                                        load_chunk, tmp_ebc_param.key_type,
+                                                        tmp_ebc_param.emb_type);
   }
 }
 
-void Model::embedding_dump(const std::string& path, const std::vector<std::string>& table_names) {
+void Model::embedding_dump(const std::string& path, const std::vector<std::string>& table_names,
+                           bool incremental) {
   std::vector<struct embedding::EmbeddingParameterInfo> epis;
 
-  embedding_para_io_->get_parameter_info_from_model(path, epis);
+  embedding_para_io_->get_parameter_info_from_model(path, epis, incremental);
   std::map<int, std::vector<int>> table_ids;
 
   if (!table_names.empty()) {
@@ -1567,6 +1825,37 @@ void Model::embedding_dump(const std::string& path, const std::vector<std::strin
   }
 }
 
+void Model::embedding_export(const std::string& path, const std::vector<std::string>& table_names,
+                             int min_update_count, float min_l2_norm, bool fp8_quant) {
+  std::vector<struct embedding::EmbeddingParameterInfo> epis;
+  embedding_para_io_->get_parameter_info_from_model(path, epis);
+
+  std::vector<std::string> export_table_names = table_names;
+  if (export_table_names.empty()) {
+    for (auto& [name, id_pair] : ebc_name_to_global_id_dict_) {
+      export_table_names.push_back(name);
+    }
+  } else {
+    check_table_name_correct(ebc_name_to_global_id_dict_, table_names);
+  }
+  // The table ids and names of every embedding collection
+  std::map<int, std::pair<std::vector<int>, std::vector<std::string>>> tables;
+  for (auto& name : export_table_names) {
+    auto& [embedding_collection_id, table_id] = ebc_name_to_global_id_dict_.at(name);
+    tables[embedding_collection_id].first.push_back(table_id);
+    tables[embedding_collection_id].second.push_back(name);
+  }
+
+  embedding::EmbeddingExportParams params;
+  params.min_update_count = min_update_count;
+  params.min_l2_norm = min_l2_norm;
+  params.fp8_quant = fp8_quant;
+  for (auto& [cid, ids_and_names] : tables) {
+    embedding_para_io_->export_embedding_weight(path, epis[cid], ids_and_names.first,
+                                                ids_and_names.second, params);
+  }
+}
+
 void Model::summary() {
   if (!graph_finalized_) {
     graph_analysis();
@@ -1635,6 +1924,23 @@ void Model::summary() {
            "---------------------------------"
         << std::endl;
   }
+
+  if (buff_allocated_ && !memory_planner_->empty()) {
+    std::vector<MemoryPlanner::RowType> row_types;
+    for (const auto& ebc : ebc_list_) {
+      for (const auto& table_param : ebc->emb_table_param_list_) {
+        const MemoryPlanner::RowType row_type{
+            table_param.ev_size, embedding_row_bytes(table_param, table_param.ev_size)};
+        if (std::none_of(row_types.begin(), row_types.end(), [&](const auto& other) {
+              return other.ev_size == row_type.ev_size &&
+                     other.bytes_per_row == row_type.bytes_per_row;
+            })) {
+          row_types.push_back(row_type);
+        }
+      }
+    }
+    log << memory_planner_->report(solver_.batchsize, row_types);
+  }
 }
 
 void Model::set_source(std::vector<std::string> source, std::vector<std::string> keyset,
@@ -1674,6 +1980,10 @@ void Model::set_source(std::string source, std::string eval_source) {
   reader_params_.eval_source.assign(eval_source);
 }
 
+// The AUC metrics, whose target accuracy is the threshold of their metrics_spec entry
+const std::map<std::string, metrics::Type> AUC_METRIC_TYPES = {
+    {"AUC", metrics::Type::AUC}, {"StreamingAUC", metrics::Type::StreamingAUC}};
+
 void print_class_aucs(std::vector<float> class_aucs) {
   if (class_aucs.size() > 1) {
     HCTR_LOG_S(INFO, ROOT) << "Evaluation, AUC: {";
@@ -1688,7 +1998,7 @@ void print_class_aucs(std::vector<float> class_aucs) {
 }
 
 void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, int snapshot,
-                std::string snapshot_prefix) {
+                std::string snapshot_prefix, int profile_iterations, std::string profile_path) {
   if (!buff_allocated_) {
     HCTR_OWN_THROW(Error_t::IllegalCall,
                    "Cannot start the training process "
@@ -1706,6 +2016,9 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
                    "be created first");
   }
   high_level_eval_ = true;
+  if (profile_iterations > 0) {
+    start_profiling_(profile_iterations, profile_path);
+  }
 
   HugeCTR::Timer timer;
   HugeCTR::Timer timer_train;
@@ -1794,6 +2107,7 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
         graph_.is_first_train_batch_ = true;
         graph_.is_last_train_batch_ = true;
         data_reader_train_status_ = this->train();
+        end_profiled_iteration_();
         if (display > 0 && (iter + 1) % display == 0) {
           timer_train.stop();
           float loss = 0;
@@ -1818,15 +2132,21 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
           this->check_overflow();
           this->copy_weights_for_evaluation();
           batches = 0;
+          bool eval_auc_tight = false;
           timer_eval.start();
           while (data_reader_eval_status_) {
             if (solver_.max_eval_batches == 0 || batches >= solver_.max_eval_batches) {
               break;
             }
             graph_.is_first_eval_batch_ = (batches == 0);
-            graph_.is_last_eval_batch_ = (batches == solver_.max_eval_batches - 1);
+            graph_.is_last_eval_batch_ =
+                (batches == solver_.max_eval_batches - 1) || eval_auc_tight;
             data_reader_eval_status_ = this->eval();
             batches++;
+            if (eval_auc_tight) {
+              break;
+            }
+            eval_auc_tight = is_eval_auc_within_tolerance(batches);
           }
           if (!data_reader_eval_status_) {
             data_reader_eval->set_source(reader_params_.eval_source);
@@ -1839,9 +2159,10 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
             metric_id++;
             HCTR_LOG_S(INFO, ROOT)
                 << "Evaluation, " << eval_metric.first << ": " << eval_metric.second << std::endl;
-            if (!eval_metric.first.compare("AUC")) {
+            auto auc_type = AUC_METRIC_TYPES.find(eval_metric.first);
+            if (auc_type != AUC_METRIC_TYPES.end()) {
               print_class_aucs(metrics_[metric_id - 1]->get_per_class_metric());
-              const auto auc_threshold = solver_.metrics_spec[HugeCTR::metrics::Type::AUC];
+              const auto auc_threshold = solver_.metrics_spec[auc_type->second];
               if (eval_metric.second > auc_threshold) {
                 timer.stop();
                 HCTR_LOG(INFO, ROOT,
@@ -1853,11 +2174,12 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
                          auc_threshold, e, num_epochs, iter, solver_.batchsize,
                          timer.elapsedSeconds(),
                          float(iter) * solver_.batchsize / timer.elapsedSeconds());
+                wait_for_dense_checkpoint_();
                 return;
               }
             }
           }
-          HCTR_LOG_S(INFO, ROOT) << "Eval Time for " << solver_.max_eval_batches
+          HCTR_LOG_S(INFO, ROOT) << "Eval Time for " << batches
                                  << " iters: " << timer_eval.elapsedSeconds() << "s" << std::endl;
         }
         if (snapshot > 0 && (iter + 1) % snapshot == 0 && iter != 0) {
@@ -1896,6 +2218,12 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
         data_reader_train->set_source(reader_params_.source[f]);
         data_reader_train_status_ = true;
         embedding_training_cache->update(reader_params_.keyset[f]);
+        // Reads the next pass from the parameter servers while this one trains
+        if (f + 1 < reader_params_.source.size()) {
+          embedding_training_cache->prefetch(reader_params_.keyset[f + 1]);
+        } else if (e + 1 < etc_epochs) {
+          embedding_training_cache->prefetch(reader_params_.keyset[0]);
+        }
         do {
           float lr = 0;
           if (!this->use_gpu_learning_rate_scheduling()) {
@@ -1905,6 +2233,7 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
           graph_.is_first_train_batch_ = true;
           graph_.is_last_train_batch_ = true;
           data_reader_train_status_ = this->train();
+          end_profiled_iteration_();
           if (display > 0 && (iter + 1) % display == 0) {
             timer_train.stop();
             float loss = 0;
@@ -1929,15 +2258,21 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
             this->check_overflow();
             this->copy_weights_for_evaluation();
             batches = 0;
+            bool eval_auc_tight = false;
             timer_eval.start();
             while (data_reader_eval_status_) {
               if (solver_.max_eval_batches == 0 || batches >= solver_.max_eval_batches) {
                 break;
               }
               graph_.is_first_eval_batch_ = (batches == 0);
-              graph_.is_last_eval_batch_ = (batches == solver_.max_eval_batches - 1);
+              graph_.is_last_eval_batch_ =
+                  (batches == solver_.max_eval_batches - 1) || eval_auc_tight;
               data_reader_eval_status_ = this->eval();
               batches++;
+              if (eval_auc_tight) {
+                break;
+              }
+              eval_auc_tight = is_eval_auc_within_tolerance(batches);
             }
             if (!data_reader_eval_status_) {
               data_reader_eval->set_source(reader_params_.eval_source);
@@ -1950,11 +2285,11 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
               metric_id++;
               HCTR_LOG_S(INFO, ROOT)
                   << "Evaluation, " << eval_metric.first << ": " << eval_metric.second << std::endl;
-              if (!eval_metric.first.compare("AUC")) {
+              if (AUC_METRIC_TYPES.count(eval_metric.first)) {
                 print_class_aucs(metrics_[metric_id - 1]->get_per_class_metric());
               }
             }
-            HCTR_LOG_S(INFO, ROOT) << "Eval Time for " << solver_.max_eval_batches
+            HCTR_LOG_S(INFO, ROOT) << "Eval Time for " << batches
                                    << " iters: " << timer_eval.elapsedSeconds() << "s" << std::endl;
           }
           iter++;
@@ -1984,6 +2319,7 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
       graph_.is_first_train_batch_ = (iter == 0);
       graph_.is_last_train_batch_ = (iter == max_iter - 1);
       this->train();
+      end_profiled_iteration_();
       if (display > 0 && (iter + 1) % display == 0) {
         timer_train.stop();
         float loss = 0.0f;
@@ -2007,7 +2343,7 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
         timer_train.start();
       }
       if (eval_interval > 0 && (iter + 1) % eval_interval == 0) {
-        if (solver_.all_reduce_algo == AllReduceAlgo::NCCL) {
+        if (solver_.all_reduce_algo != AllReduceAlgo::ONESHOT) {
 #pragma omp parallel num_threads(number_of_networks())
           {
             size_t id = omp_get_thread_num();
@@ -2024,10 +2360,18 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
         for (auto tc : training_callbacks_) {
           tc->on_eval_start(iter);
         }
-        for (int batches = 0; batches < solver_.max_eval_batches; batches++) {
+        int batches = 0;
+        bool eval_auc_tight = false;
+        while (batches < solver_.max_eval_batches) {
           graph_.is_first_eval_batch_ = (batches == 0);
-          graph_.is_last_eval_batch_ = (batches == solver_.max_eval_batches - 1);
+          graph_.is_last_eval_batch_ = (batches == solver_.max_eval_batches - 1) || eval_auc_tight;
           this->eval();
+          batches++;
+          if (eval_auc_tight) {
+            break;
+          }
+          // The batch after the AUC is tight is the last one, to end the prefetching
+          eval_auc_tight = is_eval_auc_within_tolerance(batches);
         }
         auto eval_metrics = this->get_eval_metrics();
         std::map<std::string, float> eval_results;
@@ -2042,6 +2386,7 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
           for (auto tc : training_callbacks_) {
             tc->on_training_end(iter);
           }
+          wait_for_dense_checkpoint_();
           return;
         }
         size_t metric_id = 0;
@@ -2053,9 +2398,10 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
             HCTR_LOG_ARGS(timer_log.elapsedMilliseconds(), "eval_accuracy", eval_metric.second,
                           float(iter) / max_iter, iter);
           }
-          if (!eval_metric.first.compare("AUC")) {
+          auto auc_type = AUC_METRIC_TYPES.find(eval_metric.first);
+          if (auc_type != AUC_METRIC_TYPES.end()) {
             print_class_aucs(metrics_[metric_id - 1]->get_per_class_metric());
-            const auto auc_threshold = solver_.metrics_spec[HugeCTR::metrics::Type::AUC];
+            const auto auc_threshold = solver_.metrics_spec[auc_type->second];
             if (eval_metric.second > auc_threshold) {
               timer.stop();
               if (solver_.perf_logging) {
@@ -2075,12 +2421,13 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
                        "records/s.\n",
                        auc_threshold, iter, max_iter, solver_.batchsize, timer.elapsedSeconds(),
                        float(iter) * solver_.batchsize / timer.elapsedSeconds());
+              wait_for_dense_checkpoint_();
               return;
             }
           }
         }
         timer_eval.stop();
-        HCTR_LOG_S(INFO, ROOT) << "Eval Time for " << solver_.max_eval_batches
+        HCTR_LOG_S(INFO, ROOT) << "Eval Time for " << batches
                                << " iters: " << timer_eval.elapsedSeconds() << "s" << std::endl;
         if (solver_.perf_logging) {
           HCTR_LOG_ARGS(timer_log.elapsedMilliseconds(), "eval_stop",
@@ -2109,14 +2456,182 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
              max_iter, solver_.batchsize, timer.elapsedSeconds());
 
   }  // end if else
+  wait_for_dense_checkpoint_();
   high_level_eval_ = false;
 }
+void Model::init_wgrad_buckets_(const std::vector<void*>& wgrad_buffer_ptrs,
+                                size_t wgrad_buffer_size) {
+  if (solver_.grouped_all_reduce || solver_.all_reduce_algo != AllReduceAlgo::NCCL) {
+    HCTR_LOG(WARNING, ROOT,
+             "allreduce_bucket_size_mb is only supported by the ungrouped NCCL allreduce, the "
+             "dense wgrads are allreduced at once.\n");
+    return;
+  }
+  const size_t bucket_size = static_cast<size_t>(solver_.allreduce_bucket_size_mb * 1024 * 1024);
+
+  // The wgrads of a bucket are ready once the bprop of its last layer in backward order is done.
+  // Each bucket is closed once it holds bucket_size bytes.
+  struct Bucket {
+    size_t begin, end;
+    size_t trigger;  // index in train_layers_
+  };
+  auto get_buckets = [&](size_t g) {
+    auto& layers = networks_[g]->train_layers_;
+    const char* base = static_cast<const char*>(wgrad_buffer_ptrs[g]);
+    std::vector<Bucket> buckets;
+    std::optional<Bucket> bucket;
+    for (size_t i = layers.size(); i-- > 0;) {
+      auto wgrads = solver_.use_mixed_precision ? get_layer_wgrads<__half>(layers[i].get())
+                                                : get_layer_wgrads<float>(layers[i].get());
+      for (auto& wgrad : wgrads) {
+        const char* ptr = static_cast<const char*>(wgrad.data());
+        if (ptr < base || ptr + wgrad.num_bytes() > base + wgrad_buffer_size) {
+          return std::vector<Bucket>();
+        }
+        size_t begin = ptr - base;
+        size_t end = begin + wgrad.num_bytes();
+        if (!bucket) bucket = Bucket{begin, end, i};
+        bucket->begin = std::min(bucket->begin, begin);
+        bucket->end = std::max(bucket->end, end);
+        bucket->trigger = i;
+      }
+      if (bucket && bucket->end - bucket->begin >= bucket_size) {
+        buckets.push_back(bucket.value());
+        bucket.reset();
+      }
+    }
+    if (bucket) buckets.push_back(bucket.value());
+    return buckets;
+  };
+
+  auto buckets = get_buckets(0);
+  // The buckets have to be laid out backwards in the buffer and alike on every GPU, so that
+  // widening each of them up to the next one covers the whole buffer.
+  bool valid = !buckets.empty();
+  for (size_t b = 1; valid && b < buckets.size(); b++) {
+    valid = buckets[b].end <= buckets[b - 1].begin;
+  }
+  for (size_t g = 1; valid && g < networks_.size(); g++) {
+    auto gpu_buckets = get_buckets(g);
+    valid = gpu_buckets.size() == buckets.size() &&
+            std::equal(buckets.begin(), buckets.end(), gpu_buckets.begin(),
+                       [](const Bucket& a, const Bucket& b) {
+                         return a.begin == b.begin && a.end == b.end && a.trigger == b.trigger;
+                       });
+  }
+  if (!valid) {
+    HCTR_LOG(WARNING, ROOT,
+             "The dense wgrads are not laid out in layer order, they are allreduced at once.\n");
+    return;
+  }
+
+  std::vector<std::pair<size_t, size_t>> ranges;
+  for (size_t b = 0; b < buckets.size(); b++) {
+    size_t begin = b + 1 == buckets.size() ? 0 : buckets[b].begin;
+    size_t end = b == 0 ? wgrad_buffer_size : ranges.back().first;
+    ranges.emplace_back(begin, end);
+  }
+  exchange_wgrad_->init_buckets(ranges);
+
+  for (size_t g = 0; g < networks_.size(); g++) {
+    for (size_t b = 0; b < buckets.size(); b++) {
+      networks_[g]->set_bprop_hook(networks_[g]->train_layers_[buckets[b].trigger].get(), [=] {
+        auto& gpu_resource = resource_manager_->get_local_gpu(g);
+        exchange_wgrad_->allreduce_bucket(b, g, gpu_resource->get_stream());
+      });
+    }
+  }
+  HCTR_LOG(INFO, ROOT, "The dense wgrads are allreduced in %zu buckets during bprop.\n",
+           buckets.size());
+}
+
 void Model::exchange_wgrad(size_t device_id) {
   auto& gpu_resource = resource_manager_->get_local_gpu(device_id);
   CudaCPUDeviceContext context(gpu_resource->get_device_id());
   if (resource_manager_->get_global_gpu_count() > 1) {
-    exchange_wgrad_->allreduce(device_id, gpu_resource->get_stream());
+    profile_(device_id, "dense wgrad allreduce", StepProfiler::Kind::Communication, [&] {
+      exchange_wgrad_->allreduce(device_id, gpu_resource->get_stream());
+    });
+  }
+}
+
+bool Model::train_with_cuda_graph() const {
+  return solver_.use_cuda_graph && !(profiler_ && profiler_->active());
+}
+
+void Model::start_profiling_(const int num_iterations, const std::string& path) {
+  // The hybrid embedding decides whether its reader runs in a graph when the pipeline is created
+  HCTR_THROW_IF(solver_.use_cuda_graph && !solver_.use_embedding_collection &&
+                    is_scheduled_datareader() && is_scheduled_embedding(),
+                Error_t::WrongInput, "Profiling the hybrid embedding needs use_cuda_graph=False");
+  profiler_ = std::make_unique<StepProfiler>(resource_manager_, num_iterations,
+                                             solver_.use_mixed_precision);
+  profile_path_ = path;
+  for (auto& network : networks_) {
+    network->set_profiler(profiler_.get());
+  }
+  HCTR_LOG_S(INFO, ROOT) << "Profiling the first " << num_iterations << " training iterations"
+                         << (solver_.use_cuda_graph ? ", without CUDA graphs" : "") << std::endl;
+}
+
+void Model::end_profiled_iteration_() {
+  if (!profiler_ || !profiler_->active()) {
+    return;
+  }
+  profiler_->end_iteration();
+  if (profiler_->active()) {
+    return;
+  }
+
+  for (auto& network : networks_) {
+    network->set_profiler(nullptr);
+  }
+  HCTR_LOG_S(INFO, ROOT) << profiler_->report();
+  if (!profile_path_.empty()) {
+    std::string path = profile_path_;
+    if (resource_manager_->get_num_process() > 1) {
+      path += "." + std::to_string(resource_manager_->get_process_id());
+    }
+    profiler_->write_json(path);
+    HCTR_LOG_S(INFO, WORLD) << "Wrote the profile to " << path << std::endl;
+  }
+}
+
+void Model::profile_(const size_t local_id, const std::string& name, const StepProfiler::Kind kind,
+                     const std::function<void()>& work) {
+  if (profiler_ && profiler_->active()) {
+    profiler_->time(local_id, name, kind, work);
+  } else {
+    work();
+  }
+}
+
+void Model::profile_ebc_stage_(const size_t local_id, const size_t ebc_id,
+                               const embedding::Stage stage, const std::function<void()>& work) {
+  if (!profiler_ || !profiler_->active() || !ebc_list_[ebc_id]->has_stage(stage, true)) {
+    work();
+    return;
+  }
+  bool communication = false;
+  switch (stage) {
+    case embedding::Stage::DPAllreduce:
+    case embedding::Stage::DenseDPAllReduce:
+    case embedding::Stage::HierMPNetworkForward:
+    case embedding::Stage::HierMPNetworkBackward:
+    case embedding::Stage::MPNetworkdForward:
+    case embedding::Stage::MPNetworkBackward:
+    case embedding::Stage::DenseMPNetworkForward:
+    case embedding::Stage::DenseMPNetworkBackward:
+      communication = true;
+      break;
+    default:
+      break;
   }
+  const std::string name =
+      "embedding collection " + std::to_string(ebc_id) + " " + embedding::stage_name(stage);
+  profiler_->time(local_id, name,
+                  communication ? StepProfiler::Kind::Communication : StepProfiler::Kind::Embedding,
+                  work);
 }
 
 bool Model::skip_prefetch_in_last_batch(bool is_train) {
@@ -2154,6 +2669,9 @@ long long Model::read_a_batch(bool is_train) {
 }
 
 bool Model::train() {
+  HCTR_NVTX_RANGE("Model::train");
+  static auto& num_iterations = MetricsRegistry::get().counter("train_iterations");
+  num_iterations.add(1);
   try {
     if (train_data_reader_->is_started() == false) {
       HCTR_OWN_THROW(Error_t::IllegalCall,
@@ -2181,7 +2699,7 @@ bool Model::train() {
       return false;
     }
 
-    if (solver_.all_reduce_algo == AllReduceAlgo::NCCL and
+    if (solver_.all_reduce_algo != AllReduceAlgo::ONESHOT and
         train_data_reader_->current_batch_incomplete()) {
 #pragma omp parallel num_threads(number_of_networks())
       {
@@ -2191,6 +2709,10 @@ bool Model::train() {
       }
     }
     this->check_overflow();
+    if (solver_.share_eval_activations) {
+      // The eval metrics may still read the eval outputs, which the train outputs overwrite
+      wait_for_eval_metrics();
+    }
 
     if (solver_.use_embedding_collection) {
       train_pipeline_with_ebc();
@@ -2212,7 +2734,7 @@ bool Model::train() {
     {
       size_t id = omp_get_thread_num();
       CudaCPUDeviceContext ctx(resource_manager_->get_local_gpu(id)->get_device_id());
-      if (solver_.use_cuda_graph && !train_data_reader_->current_batch_incomplete()) {
+      if (train_with_cuda_graph() && !train_data_reader_->current_batch_incomplete()) {
         graph_.train_pipeline_[id].run_graph();
       } else {
         graph_.train_pipeline_[id].run();
@@ -2248,6 +2770,7 @@ bool Model::train() {
 }
 
 bool Model::eval() {
+  HCTR_NVTX_RANGE("Model::eval");
   try {
     if (evaluate_data_reader_ == nullptr) return true;
     if (evaluate_data_reader_->is_started() == false) {
@@ -2307,7 +2830,32 @@ bool Model::eval() {
   }
 }  // namespace HugeCTR
 
+void Model::wait_for_eval_metrics() {
+  for (size_t id = 0; id < resource_manager_->get_local_gpu_count(); id++) {
+    auto gpu = resource_manager_->get_local_gpu(id);
+    CudaDeviceContext ctx(gpu->get_device_id());
+    HCTR_LIB_THROW(cudaStreamWaitEvent(gpu->get_stream(), gpu->get_event("eval_metrics_done")));
+  }
+}
+
+bool Model::is_eval_auc_within_tolerance(int num_eval_batches) {
+  // Only checked after a power of two of batches, as it syncs all the GPUs
+  if (solver_.eval_auc_tolerance <= 0.f || num_eval_batches < 8 ||
+      (num_eval_batches & (num_eval_batches - 1)) != 0) {
+    return false;
+  }
+  wait_for_eval_metrics();
+  for (auto& metric : metrics_) {
+    float half_width = metric->get_confidence_half_width();
+    if (half_width >= 0.f) {
+      return half_width <= solver_.eval_auc_tolerance;
+    }
+  }
+  return false;
+}
+
 std::vector<std::pair<std::string, float>> Model::get_eval_metrics() {
+  wait_for_eval_metrics();
   std::vector<std::pair<std::string, float>> metrics;
   for (auto& metric : metrics_) {
     metrics.push_back(std::make_pair(metric->name(), metric->finalize_metric()));
@@ -2315,6 +2863,67 @@ std::vector<std::pair<std::string, float>> Model::get_eval_metrics() {
   return metrics;
 }
 
+size_t Model::predict(const std::string& output_prefix, const int max_batches) {
+  if (!buff_allocated_) {
+    HCTR_OWN_THROW(Error_t::IllegalCall, "Cannot predict before calling Model.compile()");
+  }
+  HCTR_THROW_IF(evaluate_data_reader_ == nullptr, Error_t::IllegalCall,
+                "Set the evaluation source before calling Model.predict()");
+  HCTR_THROW_IF(solver_.repeat_dataset && max_batches <= 0, Error_t::WrongInput,
+                "Require max_batches>0 under non-epoch mode");
+  if (!evaluate_data_reader_->is_started()) {
+    evaluate_data_reader_->start();
+  }
+  high_level_eval_ = true;
+  this->check_overflow();
+  this->copy_weights_for_evaluation();
+  // The metrics of an earlier evaluation may still be reduced on the side streams.
+  wait_for_eval_metrics();
+
+  // The writer takes the place of the metrics, so that every evaluation pipeline feeds it.
+  metrics::Metrics metrics;
+  metrics.emplace_back(std::make_unique<metrics::PredictionWriter>(
+      output_prefix, solver_.use_mixed_precision,
+      solver_.batchsize_eval / resource_manager_->get_global_gpu_count(), get_label_dim_(),
+      resource_manager_));
+  auto& writer = static_cast<metrics::PredictionWriter&>(*metrics.front());
+  metrics_.swap(metrics);
+
+  HugeCTR::Timer timer;
+  timer.start();
+  size_t num_samples = 0;
+  try {
+    if (!solver_.repeat_dataset && !data_reader_eval_status_) {
+      evaluate_data_reader_->set_source(reader_params_.eval_source);
+      data_reader_eval_status_ = true;
+    }
+    bool status = true;
+    int batches = 0;
+    while (status && (max_batches <= 0 || batches < max_batches)) {
+      graph_.is_first_eval_batch_ = (batches == 0);
+      graph_.is_last_eval_batch_ = (batches == max_batches - 1);
+      status = this->eval();
+      batches++;
+    }
+    // Start over with the next call, once the source has been read to the end.
+    if (!status) {
+      evaluate_data_reader_->set_source(reader_params_.eval_source);
+    }
+    wait_for_eval_metrics();
+    num_samples = writer.flush();
+  } catch (...) {
+    metrics_.swap(metrics);
+    throw;
+  }
+  metrics_.swap(metrics);
+  timer.stop();
+
+  HCTR_LOG_S(INFO, WORLD) << "Predicted " << num_samples << " samples in "
+                          << timer.elapsedSeconds() << "s, written to " << output_prefix << "_"
+                          << resource_manager_->get_process_id() << "_pred*.bin" << std::endl;
+  return num_samples;
+}
+
 Error_t Model::get_current_loss(float* loss) {
   try {
     float loss_sum = 0.f;
@@ -2386,14 +2995,96 @@ void Model::copy_weights_for_evaluation() {
   op(networks_);
 }
 
+std::vector<float> Model::gather_sharded_dense_opt_states_() {
+  const size_t num_weights = networks_[0]->get_params_num();
+  const size_t num_states = networks_[0]->optimizer_->get_opt_state_tensors().size();
+  std::vector<float> opt_states(num_states * num_weights, 0.f);
+  for (size_t g = 0; g < networks_.size(); g++) {
+    const auto [begin, end] = dense_shards_[g];
+    const size_t shard_size = end - begin;
+    std::vector<float> shard_states(num_states * shard_size);
+    networks_[g]->download_opt_states_to_host(reinterpret_cast<char*>(shard_states.data()));
+    for (size_t state = 0; state < num_states; state++) {
+      std::copy_n(shard_states.begin() + state * shard_size, shard_size,
+                  opt_states.begin() + state * num_weights + begin);
+    }
+  }
+#ifdef ENABLE_MPI
+  // The shards don't overlap and the rest is zero, so their sum puts them together. MPI counts are
+  // ints.
+  const int root = resource_manager_->get_master_process_id();
+  constexpr size_t max_count = 1ul << 30;
+  for (size_t offset = 0; offset < opt_states.size(); offset += max_count) {
+    const int count = static_cast<int>(std::min(max_count, opt_states.size() - offset));
+    float* data = opt_states.data() + offset;
+    if (resource_manager_->is_master_process()) {
+      HCTR_MPI_THROW(
+          MPI_Reduce(MPI_IN_PLACE, data, count, MPI_FLOAT, MPI_SUM, root, MPI_COMM_WORLD));
+    } else {
+      HCTR_MPI_THROW(MPI_Reduce(data, nullptr, count, MPI_FLOAT, MPI_SUM, root, MPI_COMM_WORLD));
+    }
+  }
+#endif
+  return opt_states;
+}
+
 Error_t Model::download_dense_params_to_files_(std::string weights_file,
                                                std::string dense_opt_states_file) {
   try {
-    if (resource_manager_->is_master_process()) {
+    std::vector<float> sharded_opt_states;
+    if (!dense_shards_.empty()) {
+      sharded_opt_states = gather_sharded_dense_opt_states_();
+    }
+    if (resource_manager_->is_master_process() && solver_.async_checkpoint) {
+      wait_for_dense_checkpoint_();
+
+      // Only the copy to the pinned snapshot blocks the training, the files are written by the
+      // background writer, the weights and the optimizer states in parallel.
+      auto& network = networks_[0];
+      const size_t weights_size = network->get_params_num() * sizeof(float);
+      const size_t opt_states_size = network->get_opt_states_size_in_byte();
+      if (dense_checkpoint_buffer_size_ < weights_size + opt_states_size) {
+        CudaCPUDeviceContext context(network->get_device_id());
+        if (dense_checkpoint_buffer_) {
+          HCTR_LIB_THROW(cudaFreeHost(dense_checkpoint_buffer_));
+        }
+        HCTR_LIB_THROW(cudaMallocHost(&dense_checkpoint_buffer_, weights_size + opt_states_size));
+        dense_checkpoint_buffer_size_ = weights_size + opt_states_size;
+      }
+      char* h_weights = dense_checkpoint_buffer_;
+      char* h_opt_states = dense_checkpoint_buffer_ + weights_size;
+      network->download_params_to_host(reinterpret_cast<float*>(h_weights));
+      network->download_opt_states_to_host(h_opt_states);
+      std::string no_trained_params = network->get_no_trained_params_in_string();
+
+      dense_checkpoint_writer_ = std::async(std::launch::async, [=]() {
+        auto opt_states_writer = std::async(std::launch::async, [=]() {
+          auto fs = FileSystemBuilder::build_unique_by_path(dense_opt_states_file);
+          fs->write(dense_opt_states_file, h_opt_states, opt_states_size, true);
+          HCTR_LOG(INFO, ROOT, "Dumping dense optimizer states to file, successful\n");
+        });
+        auto fs = FileSystemBuilder::build_unique_by_path(weights_file);
+        fs->write(weights_file, h_weights, weights_size, true);
+        HCTR_LOG(INFO, ROOT, "Dumping dense weights to file, successful\n");
+        if (no_trained_params.length() != 0) {
+          std::string ntp_file = weights_file + ".ntp.json";
+          auto ntp_fs = FileSystemBuilder::build_unique_by_path(ntp_file);
+          ntp_fs->write(ntp_file, no_trained_params.c_str(), no_trained_params.length(), true);
+          HCTR_LOG(INFO, ROOT, "Dumping untrainable weights to file, successful\n");
+        }
+        opt_states_writer.get();
+      });
+    } else if (resource_manager_->is_master_process()) {
       auto op = [&](auto& network) {
         network->download_params_to_host(weights_file);
         HCTR_LOG(INFO, ROOT, "Dumping dense weights to file, successful\n");
-        network->download_opt_states_to_host(dense_opt_states_file);
+        if (dense_shards_.empty()) {
+          network->download_opt_states_to_host(dense_opt_states_file);
+        } else {
+          auto fs = FileSystemBuilder::build_unique_by_path(dense_opt_states_file);
+          fs->write(dense_opt_states_file, sharded_opt_states.data(),
+                    sharded_opt_states.size() * sizeof(float), true);
+        }
         HCTR_LOG(INFO, ROOT, "Dumping dense optimizer states to file, successful\n");
         std::string no_trained_params = network->get_no_trained_params_in_string();
         if (no_trained_params.length() != 0) {
@@ -2416,6 +3107,17 @@ Error_t Model::download_dense_params_to_files_(std::string weights_file,
   return Error_t::Success;
 }
 
+void Model::wait_for_dense_checkpoint_() {
+  if (!dense_checkpoint_writer_.valid()) {
+    return;
+  }
+  try {
+    dense_checkpoint_writer_.get();
+  } catch (const std::exception& err) {
+    HCTR_LOG_S(ERROR, WORLD) << "Writing the dense snapshot failed: " << err.what() << std::endl;
+  }
+}
+
 Error_t Model::download_sparse_params_to_files_(
     const std::vector<std::string>& embedding_files,
     const std::vector<std::string>& sparse_opt_state_files) {
@@ -2455,7 +3157,8 @@ std::shared_ptr<EmbeddingTrainingCache> Model::create_embedding_training_cache_(
   try {
     return std::shared_ptr<EmbeddingTrainingCache>(new EmbeddingTrainingCache(
         ps_types, embeddings_, sparse_embedding_files, resource_manager_,
-        solver_.use_mixed_precision, solver_.i64_input_key, local_paths, hmem_cache_configs));
+        solver_.use_mixed_precision, solver_.i64_input_key, local_paths, hmem_cache_configs,
+        etc_params_->async_tiering));
   } catch (const std::exception& err) {
     Logger::get().print(err);
     throw;
@@ -2464,16 +3167,35 @@ std::shared_ptr<EmbeddingTrainingCache> Model::create_embedding_training_cache_(
 
 Error_t Model::load_opt_states_for_dense_(const std::string& dense_opt_states_file) {
   try {
-    auto op = [&dense_opt_states_file](auto& networks) {
-      size_t opt_states_size_in_byte = networks[0]->get_opt_states_size_in_byte();
+    auto op = [&](auto& networks) {
+      // The file has the unsharded layout, each GPU takes its shard of every state
+      const size_t num_weights = networks[0]->get_params_num();
+      size_t opt_states_size_in_byte =
+          dense_shards_.empty()
+              ? networks[0]->get_opt_states_size_in_byte()
+              : networks[0]->optimizer_->get_opt_state_tensors().size() * num_weights *
+                    sizeof(float);
       std::unique_ptr<char[]> opt_states(new char[opt_states_size_in_byte]());
 
       auto fs = FileSystemBuilder::build_unique_by_path(dense_opt_states_file);
       fs->read(dense_opt_states_file, opt_states.get(), fs->get_file_size(dense_opt_states_file),
                0);
       HCTR_LOG_S(INFO, ROOT) << "Loading dense opt states: " << dense_opt_states_file << std::endl;
-      for (auto& network : networks) {
-        network->upload_opt_states_to_device(opt_states.get());
+      for (size_t g = 0; g < networks.size(); g++) {
+        if (dense_shards_.empty()) {
+          networks[g]->upload_opt_states_to_device(opt_states.get());
+          continue;
+        }
+        const auto [begin, end] = dense_shards_[g];
+        const size_t shard_size = end - begin;
+        const size_t num_states = opt_states_size_in_byte / sizeof(float) / num_weights;
+        const float* states = reinterpret_cast<const float*>(opt_states.get());
+        std::vector<float> shard_states(num_states * shard_size);
+        for (size_t state = 0; state < num_states; state++) {
+          std::copy_n(states + state * num_weights + begin, shard_size,
+                      shard_states.begin() + state * shard_size);
+        }
+        networks[g]->upload_opt_states_to_device(reinterpret_cast<char*>(shard_states.data()));
       }
     };
 
@@ -2612,7 +3334,8 @@ std::vector<std::pair<std::vector<long long>, std::vector<float>>>& Model::get_i
 
 void Model::dump_incremental_model_2kafka() {
   if (!etc_params_->use_embedding_training_cache) {
-    HCTR_OWN_THROW(Error_t::IllegalCall, "Get incremental is only supported in ETC");
+    stream_incremental_model_2kafka_();
+    return;
   }
   if (set_source_flag_) {
     etc_params_->incremental_keyset_files.insert(etc_params_->incremental_keyset_files.end(),
@@ -2653,6 +3376,53 @@ void Model::dump_incremental_model_2kafka() {
   message_sink_->flush();
 }
 
+void Model::stream_incremental_model_2kafka_() {
+  HCTR_THROW_IF(!message_sink_, Error_t::IllegalCall,
+                "Set kafka_brokers in the solver to dump the incremental model into Kafka.");
+  // One push at a time, the previous one is usually done by now.
+  wait_for_incremental_model_stream_();
+
+  std::vector<std::pair<std::string, std::shared_ptr<DeltaTracker>>> trackers;
+  for (size_t i = 0; i < embeddings_.size(); i++) {
+    const std::string tag = HierParameterServerBase::make_tag_name(
+        solver_.model_name, sparse_embedding_params_[i].sparse_embedding_name);
+    for (const auto& tracker : embeddings_[i]->get_delta_trackers()) {
+      // Includes the updates of the iterations issued so far.
+      tracker->record();
+      trackers.emplace_back(tag, tracker);
+    }
+  }
+  incremental_model_stream_ = std::async(std::launch::async, [this, trackers]() {
+    for (const auto& [tag, tracker] : trackers) {
+      size_t num_pairs = 0, total_pairs = 0;
+      do {
+        num_pairs = tracker->extract();
+        if (num_pairs > 0) {
+          message_sink_->post(tag, num_pairs, tracker->keys(),
+                              reinterpret_cast<const char*>(tracker->vectors()),
+                              tracker->get_embedding_vec_size() * sizeof(float));
+        }
+        total_pairs += num_pairs;
+      } while (num_pairs == tracker->get_staging_rows());
+      HCTR_LOG_S(DEBUG, WORLD) << "Streamed " << total_pairs << " updated rows of " << tag
+                               << " into kafka" << std::endl;
+    }
+    message_sink_->flush();
+  });
+}
+
+void Model::wait_for_incremental_model_stream_() {
+  if (!incremental_model_stream_.valid()) {
+    return;
+  }
+  try {
+    incremental_model_stream_.get();
+  } catch (const std::exception& err) {
+    HCTR_LOG_S(ERROR, WORLD) << "Streaming the incremental model failed: " << err.what()
+                             << std::endl;
+  }
+}
+
 std::tuple<size_t, size_t, std::vector<size_t>, int> Model::get_tensor_info_by_name(
     const std::string& tensor_name, Tensor_t tensor_type) {
   const auto& tensor_entries_list =
@@ -2735,8 +3505,21 @@ void Model::create_networks() {
 }
 
 void Model::build_networks() {
+  const size_t num_global_gpus = resource_manager_->get_global_gpu_count();
+  if (solver_.shard_dense_optimizer && num_global_gpus > 1) {
+    const size_t num_weights = networks_[0]->get_params_num();
+    for (size_t i = 0; i < resource_manager_->get_local_gpu_count(); i++) {
+      auto [begin, end] = get_weight_shard(
+          num_weights, resource_manager_->get_gpu_global_id_from_local_id(i), num_global_gpus);
+      dense_shards_.emplace_back(begin, end);
+    }
+    HCTR_LOG_S(INFO, ROOT) << "The dense optimizer states of " << num_weights
+                           << " weights are sharded across " << num_global_gpus << " GPUs"
+                           << std::endl;
+  }
   for (size_t i = 0; i < resource_manager_->get_local_gpu_count(); i++) {
-    networks_[i]->create_and_set_optimizer(opt_params_);
+    networks_[i]->create_and_set_optimizer(
+        opt_params_, dense_shards_.empty() ? std::nullopt : std::make_optional(dense_shards_[i]));
   }
   auto aligned_size = 16 * resource_manager_->get_local_gpu_count();
   core23::BufferParams bp{.channel = solver_.use_mixed_precision ? GetWgradHalfBufferChannel()
@@ -2758,6 +3541,47 @@ void Model::build_networks() {
   buff_allocated_ = true;
 }
 
+void Model::search_algorithm_with_cache_() {
+  auto& algo_cache = GemmAlgoCache::get();
+  algo_cache.load(solver_.algorithm_search_cache);
+  const bool broadcast =
+      solver_.broadcast_algorithm_search && resource_manager_->get_num_process() > 1;
+  const bool is_master = resource_manager_->is_master_process();
+
+  auto search = [this](size_t id) {
+    networks_[id]->search_algorithm();
+    HCTR_LIB_THROW(cudaStreamSynchronize(resource_manager_->get_local_gpu(id)->get_stream()));
+  };
+  // The first GPU searches alone, so that the other GPUs of the same kind take its algorithms from
+  // the cache. With a broadcast, the other processes take those of the master process.
+  if (!broadcast || is_master) {
+    search(0);
+  }
+#ifdef ENABLE_MPI
+  if (broadcast) {
+    std::string entries = algo_cache.serialize();
+    uint64_t num_bytes = entries.size();
+    HCTR_MPI_THROW(MPI_Bcast(&num_bytes, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD));
+    entries.resize(num_bytes);
+    HCTR_MPI_THROW(MPI_Bcast(entries.data(), num_bytes, MPI_CHAR, 0, MPI_COMM_WORLD));
+    if (!is_master) {
+      algo_cache.deserialize(entries);
+      search(0);
+    }
+  }
+#endif
+#pragma omp parallel num_threads(number_of_networks())
+  {
+    size_t id = omp_get_thread_num();
+    if (id != 0) {
+      search(id);
+    }
+  }
+  if (is_master) {
+    algo_cache.save();
+  }
+}
+
 void Model::initialize() {
 #ifndef DATA_READING_TEST
 
@@ -2765,11 +3589,14 @@ void Model::initialize() {
   {
     size_t id = omp_get_thread_num();
     networks_[id]->initialize();
-    if (solver_.use_algorithm_search) {
+    if (solver_.use_algorithm_search && solver_.algorithm_search_cache.empty()) {
       networks_[id]->search_algorithm();
     }
     HCTR_LIB_THROW(cudaStreamSynchronize(resource_manager_->get_local_gpu(id)->get_stream()));
   }
+  if (solver_.use_algorithm_search && !solver_.algorithm_search_cache.empty()) {
+    search_algorithm_with_cache_();
+  }
 
   int num_gpus = resource_manager_->get_local_gpu_count();
   std::vector<void*> wgrad_buffer_ptrs;
@@ -2786,6 +3613,28 @@ void Model::initialize() {
     wgrad_buffer_ptrs.push_back(ptr_);
   }
   exchange_wgrad_->init_ar_comm(wgrad_buffer_ptrs, wgrad_buffer_size);
+  if (!dense_shards_.empty()) {
+    // Each GPU only updates its shard of the weights, so the other shards are copied from their
+    // GPUs right after the update.
+    std::vector<void*> wgrad_ptrs;
+    std::vector<float*> weight_ptrs;
+    for (auto& network : networks_) {
+      wgrad_ptrs.push_back(solver_.use_mixed_precision
+                               ? static_cast<void*>(network->wgrad_tensor_half_->flatten().data())
+                               : static_cast<void*>(network->wgrad_tensor_->flatten().data()));
+      weight_ptrs.push_back(network->train_weight_tensor_->flatten().data());
+    }
+    exchange_wgrad_->init_shards(wgrad_ptrs, weight_ptrs, networks_[0]->get_params_num());
+    for (size_t g = 0; g < networks_.size(); g++) {
+      networks_[g]->set_update_hook([=] {
+        auto& gpu_resource = resource_manager_->get_local_gpu(g);
+        exchange_wgrad_->all_gather_weights(g, gpu_resource->get_stream());
+      });
+    }
+  } else if (solver_.allreduce_bucket_size_mb > 0 &&
+             resource_manager_->get_global_gpu_count() > 1) {
+    init_wgrad_buckets_(wgrad_buffer_ptrs, wgrad_buffer_size);
+  }
 #endif
   init_params_for_dense_();
   if (solver_.perf_logging) {
@@ -2804,8 +3653,7 @@ void Model::initialize() {
                                    etc_params_->local_paths, etc_params_->hmem_cache_configs);
   }
 }  // namespace HugeCTR
-void Model::create_metrics() {
-  int num_total_gpus = resource_manager_->get_global_gpu_count();
+int Model::get_label_dim_() const {
   int label_dim = input_params_[0].labels_.begin()->second;
   if (input_params_[0].labels_.size() > 1) {
     auto labs = input_params_[0].labels_;
@@ -2814,18 +3662,32 @@ void Model::create_metrics() {
                                   return previous + p.second;
                                 });
   }
+  return label_dim;
+}
+
+void Model::create_metrics() {
+  int num_total_gpus = resource_manager_->get_global_gpu_count();
+  int label_dim = get_label_dim_();
 
   auto num_metrics = [&]() { return networks_[0]->get_raw_metrics_all().size(); };
   for (const auto& metric : solver_.metrics_spec) {
     // Only AUC is currently supported for models with more than one loss layer
-    if ((metric.first != metrics::Type::AUC) && num_metrics() > 1) {
-      HCTR_OWN_THROW(Error_t::WrongInput,
-                     "Metrics besides AUC are not supported for multi-task models.");
+    if ((metric.first != metrics::Type::AUC) && (metric.first != metrics::Type::StreamingAUC) &&
+        num_metrics() > 1) {
+      HCTR_OWN_THROW(
+          Error_t::WrongInput,
+          "Metrics besides AUC and StreamingAUC are not supported for multi-task models.");
     }
 
     metrics_.emplace_back(std::move(metrics::Metric::Create(
         metric.first, solver_.use_mixed_precision, solver_.batchsize_eval / num_total_gpus,
-        solver_.max_eval_batches, label_dim, resource_manager_)));
+        solver_.max_eval_batches, label_dim, solver_.eval_top_k, solver_.eval_candidates_per_query,
+        resource_manager_)));
+  }
+  if (solver_.eval_auc_tolerance > 0.f &&
+      !solver_.metrics_spec.count(metrics::Type::StreamingAUC)) {
+    HCTR_LOG(WARNING, ROOT,
+             "eval_auc_tolerance is ignored: only StreamingAUC bounds its confidence interval.\n");
   }
 }
 
@@ -2838,6 +3700,24 @@ void Model::create_pipelines() {
     }
   }
 
+  if (solver_.gpu_learning_rate_scheduling) {
+    HCTR_CHECK_HINT(solver_.use_embedding_collection,
+                    "gpu_learning_rate_scheduling requires use_embedding_collection");
+    for (size_t i = 0; i < networks_.size(); i++) {
+      HCTR_CHECK_HINT(networks_[i]->optimizer_->get_optimizer_type() == Optimizer_t::SGD,
+                      "gpu_learning_rate_scheduling requires the SGD optimizer for the dense "
+                      "network");
+      if (is_dense_trainable_) {
+        networks_[i]->set_learning_rate_scheduler(gpu_lr_sches_[i]);
+      } else {
+        networks_[i]->set_learning_rate(0.f);
+      }
+    }
+    for (auto& ebc : ebc_list_) {
+      ebc->set_learning_rate_scheduler(gpu_lr_sches_);
+    }
+  }
+
   if (is_scheduled_datareader() && is_scheduled_embedding()) {
     // will create pipeline for sparse embedding and dense network
     create_train_pipeline(networks_);
@@ -2974,6 +3854,7 @@ void Model::create_pipelines() {
     resource_manager_->set_ready_to_transfer();
   }
 #endif
+  resource_manager_->get_ar_comm()->select_backends();
 }
 
 size_t Model::number_of_networks() const { return networks_.size(); }
@@ -41,9 +41,9 @@ void Model::create_train_network_pipeline(std::vector<std::shared_ptr<NetworkTyp
 
     auto BNET_input_ready_wait = std::make_shared<StreamContextScheduleable>([=] {
       auto stream = gpu_resource->get_stream();
-      scheduled_reader->stream_wait_dense_tensors(
-          stream, local_id,
-          solver_.use_cuda_graph && !scheduled_reader->current_batch_incomplete());
+      const bool from_graph =
+          train_with_cuda_graph() && !scheduled_reader->current_batch_incomplete();
+      scheduled_reader->stream_wait_dense_tensors(stream, local_id, from_graph);
     });
 
     auto network_forward_and_backward = std::make_shared<StreamContextScheduleable>([=] {
@@ -202,8 +202,13 @@ void Model::create_train_pipeline(std::vector<std::shared_ptr<NetworkType>>& net
       long long current_batchsize_per_device =
           scheduled_reader->get_current_batchsize_per_device(local_id);
 
-      networks[local_id]->train_losses_.begin()->second->compute(
-          is_train, current_batchsize_per_device, rterm);
+      if (networks[local_id]->train_fused_loss_) {
+        networks[local_id]->train_fused_loss_->compute(is_train, current_batchsize_per_device,
+                                                       rterm);
+      } else {
+        networks[local_id]->train_losses_.begin()->second->compute(
+            is_train, current_batchsize_per_device, rterm);
+      }
     });
 
     auto top_network_bprop = std::make_shared<StreamContextScheduleable>(
@@ -388,6 +393,9 @@ void Model::train_pipeline(size_t current_batch_size) {
     HCTR_LIB_THROW(cudaStreamWaitEvent(resource_manager_->get_local_gpu(id)->get_stream(),
                                        train_sync_back_event));
   }
+
+  // the default streams wait for the iteration above, on which the re-calibration runs
+  scheduled_embedding->recalibrate_if_due();
 }
 
 template <typename NetworkType>
@@ -451,8 +459,18 @@ void Model::create_evaluate_pipeline(std::vector<std::shared_ptr<NetworkType>>&
         auto metric_map = networks[local_id]->get_raw_metrics_all().begin()->second;
         metric->local_reduce(local_id, metric_map);
       }
+      // the labels and the dense features of the next batch can be copied now
+      auto stream = gpu_resource->get_stream();
+      scheduled_reader->schedule_d2d_here(stream, local_id, false);
+      HCTR_LIB_THROW(cudaEventRecord(gpu_resource->get_event("eval_metrics_done"), stream));
     });
 
+    // The metrics are accumulated on a side stream, behind the embedding of the next batch. The
+    // next network_eval overwrites the predictions, so it waits for them.
+    cal_metrics->set_stream("eval_metrics");
+    cal_metrics->wait_event({network_eval->record_done()});
+    network_eval->wait_event({cal_metrics->record_done()});
+
     std::vector<std::shared_ptr<Scheduleable>> scheduleable_list = {
         iteration_strat,
         BNET_input_ready_wait,
@@ -554,6 +572,29 @@ template <typename NetworkType>
 void Model::create_train_pipeline_with_ebc(std::vector<std::shared_ptr<NetworkType>>& networks) {
   bool is_train = true;
   bool use_graph = solver_.use_cuda_graph;
+  bool lookahead = solver_.train_embedding_lookahead;
+  HCTR_CHECK_HINT(!lookahead || solver_.train_inter_iteration_overlap,
+                  "train_embedding_lookahead requires train_inter_iteration_overlap.");
+
+  // With sync-free embedding collections the embedding does not need the host, and the whole
+  // step is captured. The pointers of the input keys are uploaded before each replay.
+  bool all_sync_free = !ebc_list_.empty();
+  for (auto& ebc : ebc_list_) {
+    all_sync_free = all_sync_free && ebc->ebc_param_.sync_free_;
+  }
+  capture_train_step_ = false;
+  if (use_graph && all_sync_free) {
+    if (!solver_.gpu_learning_rate_scheduling) {
+      HCTR_LOG_S(WARNING, ROOT) << "The training step is not captured as one CUDA graph: "
+                                << "sync_free needs gpu_learning_rate_scheduling." << std::endl;
+    } else if (solver_.train_inter_iteration_overlap) {
+      HCTR_LOG_S(WARNING, ROOT) << "The training step is not captured as one CUDA graph: "
+                                << "sync_free does not support train_inter_iteration_overlap."
+                                << std::endl;
+    } else {
+      capture_train_step_ = true;
+    }
+  }
 
   graph_.train_pipeline_.resize(resource_manager_->get_local_gpu_count());
 
@@ -567,17 +608,22 @@ void Model::create_train_pipeline_with_ebc(std::vector<std::shared_ptr<NetworkTy
     auto distribute_data = std::make_shared<StreamContextScheduleable>([=] {
       if (skip_prefetch_in_last_batch(is_train)) return;
 
-      if (is_scheduled_datareader()) {
+      if (capture_train_step_) {
+        // prepare_train_ddl_input() already ran before the graph
+        train_data_distributor_->distribute_prepared(local_id, train_ddl_output_[local_id]);
+      } else if (is_scheduled_datareader()) {
         if (auto reader =
                 dynamic_cast<MultiHot::AsyncDataReader<uint32_t>*>(train_data_reader_.get())) {
           train_data_distributor_->distribute(
-              local_id, reader->get_current_sparse_values()[local_id], {},
-              train_ddl_output_[local_id], train_data_reader_->get_current_batchsize());
+              local_id, reader->get_current_sparse_values()[local_id],
+              reader->get_current_sparse_bucket_ranges()[local_id], train_ddl_output_[local_id],
+              train_data_reader_->get_current_batchsize());
         } else if (auto reader = dynamic_cast<MultiHot::AsyncDataReader<long long>*>(
                        train_data_reader_.get())) {
           train_data_distributor_->distribute(
-              local_id, reader->get_current_sparse_values()[local_id], {},
-              train_ddl_output_[local_id], train_data_reader_->get_current_batchsize());
+              local_id, reader->get_current_sparse_values()[local_id],
+              reader->get_current_sparse_bucket_ranges()[local_id], train_ddl_output_[local_id],
+              train_data_reader_->get_current_batchsize());
         }
 
       } else {
@@ -591,16 +637,21 @@ void Model::create_train_pipeline_with_ebc(std::vector<std::shared_ptr<NetworkTy
                                               : train_ddl_output_[local_id];
 
     auto ebc_forward = [=, &ddl_output](embedding::Stage stage) {
-      for (auto& ebc : ebc_list_) {
-        ebc->forward_per_gpu(stage, is_train, local_id, ddl_output, train_ebc_outptut_[local_id],
-                             train_data_reader_->get_full_batchsize());
+      for (size_t i = 0; i < ebc_list_.size(); i++) {
+        profile_ebc_stage_(local_id, i, stage, [&] {
+          ebc_list_[i]->forward_per_gpu(stage, is_train, local_id, ddl_output,
+                                        train_ebc_outptut_[local_id],
+                                        train_data_reader_->get_full_batchsize());
+        });
       }
     };
 
     auto ebc_backward = [=, &ddl_output](embedding::Stage stage) {
-      for (auto& ebc : ebc_list_) {
-        ebc->backward_per_gpu(stage, local_id, ddl_output, train_ebc_outptut_[local_id],
-                              train_data_reader_->get_full_batchsize());
+      for (size_t i = 0; i < ebc_list_.size(); i++) {
+        profile_ebc_stage_(local_id, i, stage, [&] {
+          ebc_list_[i]->backward_per_gpu(stage, local_id, ddl_output, train_ebc_outptut_[local_id],
+                                         train_data_reader_->get_full_batchsize());
+        });
       }
     };
 
@@ -635,8 +686,12 @@ void Model::create_train_pipeline_with_ebc(std::vector<std::shared_ptr<NetworkTy
     });
 
     auto ebc_mp_update = std::make_shared<StreamContextScheduleable>([=]() {
-      for (auto& ebc : ebc_list_) {
-        ebc->update_per_gpu(local_id, embedding::TablePlacementStrategy::ModelParallel);
+      for (size_t i = 0; i < ebc_list_.size(); i++) {
+        profile_(local_id, "embedding collection " + std::to_string(i) + " MPUpdate",
+                 StepProfiler::Kind::Optimizer, [&] {
+                   ebc_list_[i]->update_per_gpu(local_id,
+                                                embedding::TablePlacementStrategy::ModelParallel);
+                 });
       }
     });
 
@@ -653,8 +708,12 @@ void Model::create_train_pipeline_with_ebc(std::vector<std::shared_ptr<NetworkTy
         [=]() { ebc_backward(embedding::Stage::DPAllreduce); });
 
     auto ebc_dp_update = std::make_shared<StreamContextScheduleable>([=]() {
-      for (auto& ebc : ebc_list_) {
-        ebc->update_per_gpu(local_id, embedding::TablePlacementStrategy::DataParallel);
+      for (size_t i = 0; i < ebc_list_.size(); i++) {
+        profile_(local_id, "embedding collection " + std::to_string(i) + " DPUpdate",
+                 StepProfiler::Kind::Optimizer, [&] {
+                   ebc_list_[i]->update_per_gpu(local_id,
+                                                embedding::TablePlacementStrategy::DataParallel);
+                 });
       }
     });
 
@@ -685,8 +744,13 @@ void Model::create_train_pipeline_with_ebc(std::vector<std::shared_ptr<NetworkTy
               : train_data_reader_->get_full_batchsize() /
                     resource_manager_->get_global_gpu_count();
 
-      networks[local_id]->train_losses_.begin()->second->compute(
-          is_train, current_batchsize_per_device, rterm);
+      if (networks[local_id]->train_fused_loss_) {
+        networks[local_id]->train_fused_loss_->compute(is_train, current_batchsize_per_device,
+                                                       rterm);
+      } else {
+        networks[local_id]->train_losses_.begin()->second->compute(
+            is_train, current_batchsize_per_device, rterm);
+      }
     });
 
     auto top_network_bprop = std::make_shared<StreamContextScheduleable>(
@@ -708,6 +772,14 @@ void Model::create_train_pipeline_with_ebc(std::vector<std::shared_ptr<NetworkTy
 
     auto sync_back = std::make_shared<StreamContextScheduleable>([] {});
 
+    // Advances the learning rate that the updates read from device memory. It precedes every
+    // update of the iteration and follows every update of the previous one through sync_back.
+    auto lr_sched_update = std::make_shared<StreamContextScheduleable>([=] {
+      if (solver_.gpu_learning_rate_scheduling) {
+        gpu_lr_sches_[local_id]->update();
+      }
+    });
+
     if (solver_.train_intra_iteration_overlap) {
       std::string dp_stream = "dp";
       ebc_dp_forward->set_stream(dp_stream);
@@ -723,15 +795,18 @@ void Model::create_train_pipeline_with_ebc(std::vector<std::shared_ptr<NetworkTy
       ebc_mp_local_reduce->set_stream(mp_stream);
       ebc_mp_update->set_stream(mp_stream);
 
-      // dp_emb_forward, bmlp_fprop wait for mp_emb_model_forward
-      auto done_mp_model_forward = ebc_mp_model_forward->record_done();
-      ebc_dp_forward->wait_event({done_mp_model_forward});
-      bottom_network_fprop->wait_event({done_mp_model_forward}, use_graph);
-
-      // tmlp_fprop wait for embedding
-      auto done_mp_network_forward = ebc_mp_network_forward->record_done();
-      auto done_dp_forward = ebc_dp_forward->record_done();
-      top_network_fprop->wait_event({done_dp_forward, done_mp_network_forward}, use_graph);
+      // With lookahead the embedding forward already ran in the previous iteration
+      if (!lookahead) {
+        // dp_emb_forward, bmlp_fprop wait for mp_emb_model_forward
+        auto done_mp_model_forward = ebc_mp_model_forward->record_done();
+        ebc_dp_forward->wait_event({done_mp_model_forward});
+        bottom_network_fprop->wait_event({done_mp_model_forward}, use_graph);
+
+        // tmlp_fprop wait for embedding
+        auto done_mp_network_forward = ebc_mp_network_forward->record_done();
+        auto done_dp_forward = ebc_dp_forward->record_done();
+        top_network_fprop->wait_event({done_dp_forward, done_mp_network_forward}, use_graph);
+      }
 
       // mp_emb_bck, dp_emb_bck wait for tmlp bprop
       auto done_top_network_bprop = top_network_bprop->record_done(use_graph);
@@ -759,6 +834,7 @@ void Model::create_train_pipeline_with_ebc(std::vector<std::shared_ptr<NetworkTy
 
     if (!solver_.train_inter_iteration_overlap) {
       std::vector<std::shared_ptr<Scheduleable>> scheduleable_list = {
+          lr_sched_update,
           distribute_data,
           ebc_mp_model_forward,
           ebc_mp_network_forward,
@@ -779,15 +855,74 @@ void Model::create_train_pipeline_with_ebc(std::vector<std::shared_ptr<NetworkTy
       auto done_distribute_data = distribute_data->record_done();
       ebc_mp_model_forward->wait_event({done_distribute_data});
 
+      graph_.train_pipeline_[local_id] =
+          Pipeline{"default", gpu_resource, scheduleable_list, capture_train_step_};
+    } else if (lookahead) {
+      // The cache and the forward of the next batch run on a side stream once the embedding
+      // update of this batch is done, hidden behind the dense allreduce and update. The next
+      // iteration then starts with the dense network.
+      auto ebc_lookahead_forward = std::make_shared<StreamContextScheduleable>([=, &ddl_output] {
+        if (skip_prefetch_in_last_batch(is_train)) return;
+
+        std::swap(ddl_output, train_ddl_output_[local_id]);
+        ebc_forward(embedding::Stage::MPModelForward);
+        ebc_forward(embedding::Stage::HierMPModelForward);
+        ebc_forward(embedding::Stage::DenseMPModelForward);
+        ebc_forward(embedding::Stage::MPNetworkdForward);
+        ebc_forward(embedding::Stage::HierMPNetworkForward);
+        ebc_forward(embedding::Stage::DenseMPNetworkForward);
+        ebc_forward(embedding::Stage::DPForward);
+      });
+
+      auto wait_lookahead_forward = std::make_shared<StreamContextScheduleable>([] {});
+
+      auto copy_next_iter_network_input = std::make_shared<StreamContextScheduleable>([=]() {
+        if (skip_prefetch_in_last_batch(is_train)) return;
+
+        graph_.train_copy_ops_[local_id]->run();
+        graph_.train_copy_ops_[local_id + resource_manager_->get_local_gpu_count()]->run();
+      });
+
+      std::vector<std::shared_ptr<Scheduleable>> scheduleable_list = {
+          lr_sched_update,
+          wait_lookahead_forward,
+          network_graph,
+          ebc_mp_backward_index_calculation,
+          ebc_dp_backward_index_calculation,
+          distribute_data,
+          ebc_mp_network_backward,
+          ebc_dp_local_reduce,
+          network_exchange_wgrad,
+          ebc_dp_allreduce,
+          update_params,
+          ebc_mp_local_reduce,
+          ebc_mp_update,
+          ebc_dp_update,
+          ebc_lookahead_forward,
+          sync_back,
+          copy_next_iter_network_input,
+      };
+
+      ebc_lookahead_forward->set_stream("lookahead");
+      auto done_lookahead_forward = ebc_lookahead_forward->record_done();
+      wait_lookahead_forward->wait_event({done_lookahead_forward});
+
+      // the next batch is distributed once the cache of this one is taken
+      distribute_data->set_absolute_stream("prefetch");
+      distribute_data->wait_event({done_lookahead_forward});
+
+      auto done_distribute_data = distribute_data->record_done();
+      auto done_ebc_mp_update = ebc_mp_update->record_done();
+      auto done_ebc_dp_update = ebc_dp_update->record_done();
+      ebc_lookahead_forward->wait_event(
+          {done_distribute_data, done_ebc_mp_update, done_ebc_dp_update});
       graph_.train_pipeline_[local_id] = Pipeline{"default", gpu_resource, scheduleable_list};
     } else {
-      auto ebc_cache_train_ddl_output =
-          std::make_shared<StreamContextScheduleable>([=, &ddl_output] {
-            for (auto& ebc : ebc_list_) {
-              ebc->cache_ddl_output(local_id, train_ddl_output_[local_id], ddl_output,
-                                    train_data_reader_->get_full_batchsize());
-            }
-          });
+      // The next batch is distributed into the other output during this iteration, the outputs
+      // trade places at its start instead of being copied on the critical path. The distribution
+      // waits for the swap, which is after every reader of the output it gets.
+      auto ebc_cache_train_ddl_output = std::make_shared<StreamContextScheduleable>(
+          [=, &ddl_output] { std::swap(ddl_output, train_ddl_output_[local_id]); });
 
       auto copy_next_iter_network_input = std::make_shared<StreamContextScheduleable>([=]() {
         if (skip_prefetch_in_last_batch(is_train)) return;
@@ -797,6 +932,7 @@ void Model::create_train_pipeline_with_ebc(std::vector<std::shared_ptr<NetworkTy
       });
 
       std::vector<std::shared_ptr<Scheduleable>> scheduleable_list = {
+          lr_sched_update,
           ebc_cache_train_ddl_output,
           ebc_mp_model_forward,
           ebc_mp_network_forward,
@@ -841,14 +977,16 @@ void Model::train_pipeline_with_ebc() {
       if (is_scheduled_datareader()) {
         if (auto reader =
                 dynamic_cast<MultiHot::AsyncDataReader<uint32_t>*>(train_data_reader_.get())) {
-          train_data_distributor_->distribute(id, reader->get_current_sparse_values()[id], {},
-                                              train_ddl_output_[id],
-                                              train_data_reader_->get_full_batchsize());
+          train_data_distributor_->distribute(
+              id, reader->get_current_sparse_values()[id],
+              reader->get_current_sparse_bucket_ranges()[id], train_ddl_output_[id],
+              train_data_reader_->get_full_batchsize());
         } else if (auto reader = dynamic_cast<MultiHot::AsyncDataReader<long long>*>(
                        train_data_reader_.get())) {
-          train_data_distributor_->distribute(id, reader->get_current_sparse_values()[id], {},
-                                              train_ddl_output_[id],
-                                              train_data_reader_->get_full_batchsize());
+          train_data_distributor_->distribute(
+              id, reader->get_current_sparse_values()[id],
+              reader->get_current_sparse_bucket_ranges()[id], train_ddl_output_[id],
+              train_data_reader_->get_full_batchsize());
         }
       } else {
         HCTR_OWN_THROW(HugeCTR::Error_t::WrongInput,
@@ -857,6 +995,15 @@ void Model::train_pipeline_with_ebc() {
       graph_.train_copy_ops_[id]->run();
       graph_.train_copy_ops_[id + resource_manager_->get_local_gpu_count()]->run();
 
+      // The pipeline expects the embedding forward of its batch to be done already
+      if (solver_.train_embedding_lookahead) {
+        std::swap(train_ddl_output_[id], cache_train_ddl_output_[id]);
+        for (auto& ebc : ebc_list_) {
+          ebc->forward_per_gpu(true, id, cache_train_ddl_output_[id], train_ebc_outptut_[id],
+                               train_data_reader_->get_full_batchsize());
+        }
+      }
+
       HCTR_LIB_THROW(cudaStreamSynchronize(resource_manager_->get_local_gpu(id)->get_stream()));
     }
 
@@ -868,7 +1015,7 @@ void Model::train_pipeline_with_ebc() {
     }
   }
 
-  const bool use_graph = solver_.use_cuda_graph && !train_data_reader_->current_batch_incomplete();
+  const bool use_graph = train_with_cuda_graph() && !train_data_reader_->current_batch_incomplete();
 
 #pragma omp parallel num_threads(resource_manager_->get_local_gpu_count())
   {
@@ -876,6 +1023,9 @@ void Model::train_pipeline_with_ebc() {
     auto device_id = resource_manager_->get_local_gpu(id)->get_device_id();
     CudaCPUDeviceContext context(device_id);
 
+    if (capture_train_step_) {
+      prepare_train_ddl_input(id);
+    }
     if (use_graph) {
       graph_.train_pipeline_[id].run_graph();
     } else {
@@ -884,6 +1034,25 @@ void Model::train_pipeline_with_ebc() {
   }
 }
 
+void Model::prepare_train_ddl_input(int local_id) {
+  StreamContext stream_context(resource_manager_->get_local_gpu(local_id), "default");
+  if (auto reader = dynamic_cast<MultiHot::AsyncDataReader<uint32_t>*>(train_data_reader_.get())) {
+    train_data_distributor_->prepare_input(
+        local_id, reader->get_current_sparse_values()[local_id],
+        reader->get_current_sparse_bucket_ranges()[local_id], train_ddl_output_[local_id],
+        train_data_reader_->get_current_batchsize());
+  } else if (auto reader =
+                 dynamic_cast<MultiHot::AsyncDataReader<long long>*>(train_data_reader_.get())) {
+    train_data_distributor_->prepare_input(
+        local_id, reader->get_current_sparse_values()[local_id],
+        reader->get_current_sparse_bucket_ranges()[local_id], train_ddl_output_[local_id],
+        train_data_reader_->get_current_batchsize());
+  } else {
+    HCTR_OWN_THROW(HugeCTR::Error_t::WrongInput,
+                   "embedding collection can only be used with AsyncMultiHot DataReader.");
+  }
+}
+
 template <typename NetworkType>
 void Model::create_evaluate_pipeline_with_ebc(std::vector<std::shared_ptr<NetworkType>>& networks) {
   bool is_train = false;
@@ -902,13 +1071,15 @@ void Model::create_evaluate_pipeline_with_ebc(std::vector<std::shared_ptr<Networ
         if (auto reader =
                 dynamic_cast<MultiHot::AsyncDataReader<uint32_t>*>(evaluate_data_reader_.get())) {
           eval_data_distributor_->distribute(
-              local_id, reader->get_current_sparse_values()[local_id], {},
-              evaluate_ddl_output_[local_id], evaluate_data_reader_->get_current_batchsize());
+              local_id, reader->get_current_sparse_values()[local_id],
+              reader->get_current_sparse_bucket_ranges()[local_id], evaluate_ddl_output_[local_id],
+              evaluate_data_reader_->get_current_batchsize());
         } else if (auto reader = dynamic_cast<MultiHot::AsyncDataReader<long long>*>(
                        evaluate_data_reader_.get())) {
           eval_data_distributor_->distribute(
-              local_id, reader->get_current_sparse_values()[local_id], {},
-              evaluate_ddl_output_[local_id], evaluate_data_reader_->get_current_batchsize());
+              local_id, reader->get_current_sparse_values()[local_id],
+              reader->get_current_sparse_bucket_ranges()[local_id], evaluate_ddl_output_[local_id],
+              evaluate_data_reader_->get_current_batchsize());
         }
       } else {
         HCTR_OWN_THROW(HugeCTR::Error_t::WrongInput,
@@ -966,13 +1137,8 @@ void Model::create_evaluate_pipeline_with_ebc(std::vector<std::shared_ptr<Networ
                    {eval_data_distribute, ebc_mp_model_forward, ebc_mp_network_forward,
                     ebc_dp_forward, network_graph, cal_metrics}};
     } else {
-      auto ebc_cache_eval_ddl_output =
-          std::make_shared<StreamContextScheduleable>([=, &ddl_output] {
-            for (auto& ebc : ebc_list_) {
-              ebc->cache_ddl_output(local_id, evaluate_ddl_output_[local_id], ddl_output,
-                                    evaluate_data_reader_->get_full_batchsize());
-            }
-          });
+      auto ebc_cache_eval_ddl_output = std::make_shared<StreamContextScheduleable>(
+          [=, &ddl_output] { std::swap(ddl_output, evaluate_ddl_output_[local_id]); });
 
       auto copy_next_iter_network_input = std::make_shared<StreamContextScheduleable>([=]() {
         if (skip_prefetch_in_last_batch(is_train)) return;
@@ -1024,14 +1190,16 @@ void Model::evaluate_pipeline_with_ebc() {
       if (is_scheduled_datareader()) {
         if (auto reader =
                 dynamic_cast<MultiHot::AsyncDataReader<uint32_t>*>(evaluate_data_reader_.get())) {
-          eval_data_distributor_->distribute(id, reader->get_current_sparse_values()[id], {},
-                                             evaluate_ddl_output_[id],
-                                             evaluate_data_reader_->get_current_batchsize());
+          eval_data_distributor_->distribute(
+              id, reader->get_current_sparse_values()[id],
+              reader->get_current_sparse_bucket_ranges()[id], evaluate_ddl_output_[id],
+              evaluate_data_reader_->get_current_batchsize());
         } else if (auto reader = dynamic_cast<MultiHot::AsyncDataReader<long long>*>(
                        evaluate_data_reader_.get())) {
-          eval_data_distributor_->distribute(id, reader->get_current_sparse_values()[id], {},
-                                             evaluate_ddl_output_[id],
-                                             evaluate_data_reader_->get_current_batchsize());
+          eval_data_distributor_->distribute(
+              id, reader->get_current_sparse_values()[id],
+              reader->get_current_sparse_bucket_ranges()[id], evaluate_ddl_output_[id],
+              evaluate_data_reader_->get_current_batchsize());
         }
 
       } else {
@@ -32,7 +32,9 @@ Regularizer<T>::Regularizer(std::optional<WeightTensors> weight_tensors,
 template <typename T>
 void Regularizer<T>::compute_rterm() {
   CudaDeviceContext context(get_device_id());
-  if (weight_tensors_) {
+  if (fused_) {
+    h_rterm_ = 0.f;
+  } else if (weight_tensors_) {
     // core23 branch
     auto flat_weight_tensor = weight_tensors_->flatten();
     const float* weight = flat_weight_tensor.data();
@@ -56,7 +58,34 @@ void Regularizer<T>::initialize_wgrad() {
   const float* weight = flat_weight_tensor.data();
   T* wgrad = flat_wgrad_tensor.data();
   auto num_elements = flat_weight_tensor.size(0);
-  do_initialize_wgrad(weight, wgrad, num_elements, get_gpu().get_stream());
+  if (fused_) {
+    // the optimizer adds the gradient of the term, the weights are not read here
+    HCTR_LIB_THROW(cudaMemsetAsync(wgrad, 0, num_elements * sizeof(T), get_gpu().get_stream()));
+  } else {
+    do_initialize_wgrad(weight, wgrad, num_elements, get_gpu().get_stream());
+  }
+}
+
+template <typename T>
+RegularizationGrad Regularizer<T>::fuse_into_optimizer(int num_replicas) {
+  fused_ = true;
+  // each replica added the gradient to its wgrads before they were summed up
+  RegularizationGrad grad = do_get_grad();
+  grad.l1 *= num_replicas;
+  grad.l2 *= num_replicas;
+  return grad;
+}
+
+template <typename T>
+float Regularizer<T>::compute_deferred_rterm() {
+  if (!fused_ || !weight_tensors_) {
+    return 0.f;
+  }
+  CudaDeviceContext context(get_device_id());
+  auto flat_weight_tensor = weight_tensors_->flatten();
+  float rterm = 0.f;
+  do_compute_rterm(flat_weight_tensor.data(), &rterm, flat_weight_tensor.size(0));
+  return rterm;
 }
 
 template class Regularizer<float>;
@@ -55,6 +55,11 @@ void L1Regularizer<T>::do_initialize_wgrad(const float* weight, T* wgrad, int nu
                                  lambda_, Regularizer<T>::get_gpu().get_sm_count(), stream);
 }
 
+template <typename T>
+RegularizationGrad L1Regularizer<T>::do_get_grad() const {
+  return {lambda_ / Regularizer<T>::get_batch_size(), 0.f};
+}
+
 template class L1Regularizer<__half>;
 template class L1Regularizer<float>;
 
@@ -53,6 +53,11 @@ void L2Regularizer<T>::do_initialize_wgrad(const float* weight, T* wgrad, int nu
                                  lambda_, Regularizer<T>::get_gpu().get_sm_count(), stream);
 }
 
+template <typename T>
+RegularizationGrad L2Regularizer<T>::do_get_grad() const {
+  return {0.f, lambda_ / Regularizer<T>::get_batch_size()};
+}
+
 template class L2Regularizer<__half>;
 template class L2Regularizer<float>;
 
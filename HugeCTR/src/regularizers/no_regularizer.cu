@@ -37,6 +37,11 @@ void NoRegularizer<T>::do_initialize_wgrad(const float* weight, T* wgrad, int nu
   HCTR_LIB_THROW(cudaMemsetAsync(wgrad, 0, num_elements * sizeof(T), stream));
 }
 
+template <typename T>
+RegularizationGrad NoRegularizer<T>::do_get_grad() const {
+  return {};
+}
+
 template class NoRegularizer<__half>;
 template class NoRegularizer<float>;
 
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cuda_runtime.h>
+#include <nvml.h>
+
+#include <algorithm>
+#include <common.hpp>
+#include <core23/logger.hpp>
+#include <iomanip>
+#include <resource_managers/gpu_topology.hpp>
+#include <sstream>
+
+namespace HugeCTR {
+
+namespace {
+
+// Approximate GB/s per direction of one NVLink and of the PCIe paths between two GPUs
+constexpr double kNVLinkBandwidth = 25.;
+constexpr double kPCIeSwitchBandwidth = 20.;
+constexpr double kPCIeHostBridgeBandwidth = 12.;
+constexpr double kCrossSocketBandwidth = 8.;
+
+GpuLinkType pcie_link_type(nvmlGpuTopologyLevel_t level) {
+  switch (level) {
+    case NVML_TOPOLOGY_INTERNAL:
+    case NVML_TOPOLOGY_SINGLE:
+    case NVML_TOPOLOGY_MULTIPLE:
+      return GpuLinkType::PCIeSwitch;
+    case NVML_TOPOLOGY_HOSTBRIDGE:
+      return GpuLinkType::PCIeHostBridge;
+    case NVML_TOPOLOGY_NODE:
+      return GpuLinkType::CPU;
+    default:
+      return GpuLinkType::CrossSocket;
+  }
+}
+
+const char* link_name(GpuLinkType link_type) {
+  switch (link_type) {
+    case GpuLinkType::Self:
+      return "X";
+    case GpuLinkType::NVLink:
+      return "NV";
+    case GpuLinkType::PCIeSwitch:
+      return "PIX";
+    case GpuLinkType::PCIeHostBridge:
+      return "PHB";
+    case GpuLinkType::CPU:
+      return "NODE";
+    default:
+      return "SYS";
+  }
+}
+
+bool same_pci_device(const nvmlPciInfo_t& a, const nvmlPciInfo_t& b) {
+  return a.domain == b.domain && a.bus == b.bus && a.device == b.device;
+}
+
+}  // namespace
+
+double gpu_link_cost(GpuLinkType link_type, int nvlink_count) {
+  switch (link_type) {
+    case GpuLinkType::Self:
+      return 0.;
+    case GpuLinkType::NVLink:
+      return 1. / (kNVLinkBandwidth * std::max(nvlink_count, 1));
+    case GpuLinkType::PCIeSwitch:
+      return 1. / kPCIeSwitchBandwidth;
+    case GpuLinkType::PCIeHostBridge:
+    case GpuLinkType::CPU:
+      return 1. / kPCIeHostBridgeBandwidth;
+    default:
+      return 1. / kCrossSocketBandwidth;
+  }
+}
+
+GpuTopology GpuTopology::discover(const std::vector<int>& device_list) {
+  const size_t num_gpus = device_list.size();
+  HCTR_LIB_THROW(nvmlInit_v2());
+
+  constexpr int pci_id_len = 16;
+  char pci_id[pci_id_len];
+  std::vector<nvmlDevice_t> handles(num_gpus);
+  std::vector<nvmlPciInfo_t> pci_infos(num_gpus);
+  for (size_t i = 0; i < num_gpus; ++i) {
+    HCTR_LIB_THROW(cudaDeviceGetPCIBusId(pci_id, pci_id_len, device_list[i]));
+    HCTR_LIB_THROW(nvmlDeviceGetHandleByPciBusId_v2(pci_id, &handles[i]));
+    HCTR_LIB_THROW(nvmlDeviceGetPciInfo_v3(handles[i], &pci_infos[i]));
+  }
+
+  // Active NVLinks of every GPU: those to another GPU are direct, the others go to NVSwitches.
+  std::vector<std::vector<int>> direct_links(num_gpus, std::vector<int>(num_gpus, 0));
+  std::vector<int> switch_links(num_gpus, 0);
+  for (size_t i = 0; i < num_gpus; ++i) {
+    for (unsigned int link = 0; link < NVML_NVLINK_MAX_LINKS; ++link) {
+      nvmlEnableState_t state;
+      nvmlPciInfo_t remote;
+      // Not supported without NVLink
+      if (nvmlDeviceGetNvLinkState(handles[i], link, &state) != NVML_SUCCESS ||
+          state != NVML_FEATURE_ENABLED ||
+          nvmlDeviceGetNvLinkRemotePciInfo_v2(handles[i], link, &remote) != NVML_SUCCESS) {
+        continue;
+      }
+      bool to_gpu = false;
+      for (size_t j = 0; j < num_gpus; ++j) {
+        if (j != i && same_pci_device(remote, pci_infos[j])) {
+          ++direct_links[i][j];
+          to_gpu = true;
+        }
+      }
+      switch_links[i] += !to_gpu;
+    }
+  }
+
+  GpuTopology topology;
+  topology.device_list = device_list;
+  topology.link_type.assign(num_gpus, std::vector<GpuLinkType>(num_gpus, GpuLinkType::Self));
+  topology.nvlink_count.assign(num_gpus, std::vector<int>(num_gpus, 0));
+  topology.cost.assign(num_gpus, std::vector<double>(num_gpus, 0.));
+  for (size_t i = 0; i < num_gpus; ++i) {
+    for (size_t j = 0; j < num_gpus; ++j) {
+      if (i == j) {
+        continue;
+      }
+      // GPUs in different partitions of an NVSwitch have NVLinks but no NVLink P2P.
+      nvmlGpuP2PStatus_t p2p_status;
+      const bool nvlink_p2p =
+          nvmlDeviceGetP2PStatus(handles[i], handles[j], NVML_P2P_CAPS_INDEX_NVLINK,
+                                 &p2p_status) == NVML_SUCCESS &&
+          p2p_status == NVML_P2P_STATUS_OK;
+      if (direct_links[i][j] > 0) {
+        topology.link_type[i][j] = GpuLinkType::NVLink;
+        topology.nvlink_count[i][j] = direct_links[i][j];
+      } else if (nvlink_p2p && switch_links[i] > 0 && switch_links[j] > 0) {
+        topology.link_type[i][j] = GpuLinkType::NVLink;
+        topology.nvlink_count[i][j] = std::min(switch_links[i], switch_links[j]);
+      } else {
+        nvmlGpuTopologyLevel_t level;
+        HCTR_LIB_THROW(nvmlDeviceGetTopologyCommonAncestor(handles[i], handles[j], &level));
+        topology.link_type[i][j] = pcie_link_type(level);
+      }
+      topology.cost[i][j] = gpu_link_cost(topology.link_type[i][j], topology.nvlink_count[i][j]);
+    }
+  }
+  HCTR_LIB_THROW(nvmlShutdown());
+  return topology;
+}
+
+std::string GpuTopology::report() const {
+  std::ostringstream os;
+  os << "GPU topology (NV# = # NVLinks, PIX = PCIe switch, PHB = PCIe host bridge, NODE = CPU, "
+        "SYS = cross socket):"
+     << std::endl
+     << std::setw(8) << "";
+  for (int device_id : device_list) {
+    os << std::setw(6) << ("GPU" + std::to_string(device_id));
+  }
+  os << std::endl;
+  for (size_t i = 0; i < device_list.size(); ++i) {
+    os << std::setw(8) << ("GPU" + std::to_string(device_list[i]));
+    for (size_t j = 0; j < device_list.size(); ++j) {
+      std::string name = link_name(link_type[i][j]);
+      if (link_type[i][j] == GpuLinkType::NVLink) {
+        name += std::to_string(nvlink_count[i][j]);
+      }
+      os << std::setw(6) << name;
+    }
+    os << std::endl;
+  }
+  return os.str();
+}
+
+}  // namespace HugeCTR
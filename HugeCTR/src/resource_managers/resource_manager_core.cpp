@@ -164,24 +164,7 @@ ResourceManagerCore::ResourceManagerCore(int num_process, int process_id, Device
 
   cpu_resource_.reset(new CPUResource(replica_uniform_seed, local_replica_variant_seeds));
 
-  CudaDeviceContext context;
-  std::vector<ncclComm_t> comms(local_gpu_count);
-#ifdef ENABLE_MPI
-  ncclUniqueId nid;
-  if (process_id_ == 0) HCTR_LIB_THROW(ncclGetUniqueId(&nid));
-  HCTR_MPI_THROW(MPI_Bcast((void*)&nid, sizeof(nid), MPI_BYTE, 0, MPI_COMM_WORLD));
-
-  HCTR_LIB_THROW(ncclGroupStart());
-  for (size_t i = 0; i < local_gpu_count; i++) {
-    context.set_device(local_gpu_device_id_list[i]);
-    HCTR_LIB_THROW(
-        ncclCommInitRank(&comms[i], global_gpu_count, nid, device_map_.get_global_id(i)));
-  }
-  HCTR_LIB_THROW(ncclGroupEnd());
-#else
-  HCTR_LIB_THROW(ncclCommInitAll(comms.data(), local_gpu_device_id_list.size(),
-                                 local_gpu_device_id_list.data()));
-#endif
+  std::vector<ncclComm_t> comms = create_nccl_comms();
 
   gpu_resources_.resize(local_gpu_count);
 #pragma omp parallel num_threads(local_gpu_count)
@@ -201,6 +184,8 @@ ResourceManagerCore::ResourceManagerCore(int num_process, int process_id, Device
   if (all_p2p_enabled() == false) {
     HCTR_LOG_S(WARNING, ROOT) << "Peer-to-peer access cannot be fully enabled." << std::endl;
   }
+  gpu_topology_ = GpuTopology::discover(local_gpu_device_id_list);
+  HCTR_LOG_S(INFO, ROOT) << gpu_topology_.report();
 
   all2all_warmup();
 
@@ -210,6 +195,50 @@ ResourceManagerCore::ResourceManagerCore(int num_process, int process_id, Device
   // HCTR_LOG(INFO, WORLD, "ResourceManagerCore ctor getCurrentDeviceId after rmm_init %d\n",
   // dev_id);
 }
+std::vector<ncclComm_t> ResourceManagerCore::create_nccl_comms() {
+  const auto& local_gpu_device_id_list = get_local_gpu_device_id_list();
+  const size_t local_gpu_count = local_gpu_device_id_list.size();
+
+  CudaDeviceContext context;
+  std::vector<ncclComm_t> comms(local_gpu_count);
+#ifdef ENABLE_MPI
+  ncclUniqueId nid;
+  if (process_id_ == 0) HCTR_LIB_THROW(ncclGetUniqueId(&nid));
+  HCTR_MPI_THROW(MPI_Bcast((void*)&nid, sizeof(nid), MPI_BYTE, 0, MPI_COMM_WORLD));
+
+  HCTR_LIB_THROW(ncclGroupStart());
+  for (size_t i = 0; i < local_gpu_count; i++) {
+    context.set_device(local_gpu_device_id_list[i]);
+    HCTR_LIB_THROW(
+        ncclCommInitRank(&comms[i], get_global_gpu_count(), nid, device_map_.get_global_id(i)));
+  }
+  HCTR_LIB_THROW(ncclGroupEnd());
+#else
+  HCTR_LIB_THROW(ncclCommInitAll(comms.data(), local_gpu_device_id_list.size(),
+                                 local_gpu_device_id_list.data()));
+#endif
+  return comms;
+}
+
+void ResourceManagerCore::recreate_nccl_comms() {
+  const auto& local_gpu_device_id_list = get_local_gpu_device_id_list();
+  CudaDeviceContext context;
+  // Unlike ncclCommDestroy, ncclCommAbort does not wait for the pending operations, which may
+  // never complete after a failure, and it releases the kernels blocked in them.
+  for (size_t i = 0; i < gpu_resources_.size(); i++) {
+    context.set_device(local_gpu_device_id_list[i]);
+    HCTR_LIB_THROW(ncclCommAbort(gpu_resources_[i]->get_nccl()));
+    HCTR_LIB_THROW(cudaDeviceSynchronize());
+  }
+
+  std::vector<ncclComm_t> comms = create_nccl_comms();
+  for (size_t i = 0; i < gpu_resources_.size(); i++) {
+    gpu_resources_[i]->set_nccl(comms[i]);
+  }
+  all2all_warmup();
+  HCTR_LOG_S(INFO, ROOT) << "Recreated the NCCL communicators" << std::endl;
+}
+
 ResourceManagerCore::~ResourceManagerCore() {
   if (original_device_resource_.empty()) {
     return;
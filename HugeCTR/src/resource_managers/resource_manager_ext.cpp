@@ -62,7 +62,7 @@ void ResourceManagerExt::set_ar_comm(AllReduceAlgo algo, bool use_mixed_precisio
   int num_process = get_num_process();
 #ifdef ENABLE_MPI
   IbComm* ib_comm_ptr = nullptr;
-  if (algo == AllReduceAlgo::ONESHOT) {
+  if (algo == AllReduceAlgo::ONESHOT || algo == AllReduceAlgo::AUTO) {
     init_ib_comm();
     ib_comm_ptr = ib_comm_.get();
   }
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <step_profiler.hpp>
+#include <utils.hpp>
+
+namespace HugeCTR {
+
+namespace {
+
+// The dense FLOPs per SM and cycle, of FP32 and of the FP16 Tensor Cores with FP32 accumulation.
+double flops_per_sm_per_cycle(const int major, const int minor, const bool use_mixed_precision) {
+  const int arch = major * 10 + minor;
+  if (!use_mixed_precision) {
+    return arch == 86 || arch == 87 || arch >= 89 ? 256.0 : 128.0;
+  }
+  if (arch >= 90) {
+    return 4096.0;
+  } else if (arch >= 86) {
+    return 512.0;
+  } else if (arch >= 80) {
+    return 2048.0;
+  } else if (arch >= 70) {
+    return 1024.0;
+  }
+  return 256.0;
+}
+
+const char* kind_name(const StepProfiler::Kind kind) {
+  switch (kind) {
+    case StepProfiler::Kind::Layer:
+      return "layer";
+    case StepProfiler::Kind::Embedding:
+      return "embedding";
+    case StepProfiler::Kind::Communication:
+      return "communication";
+    case StepProfiler::Kind::Optimizer:
+      return "optimizer";
+  }
+  return "";
+}
+
+}  // namespace
+
+StepProfiler::StepProfiler(const std::shared_ptr<ResourceManager>& resource_manager,
+                           const int num_iterations, const bool use_mixed_precision,
+                           const double peak_tflops, const double peak_gbps)
+    : resource_manager_(resource_manager),
+      num_iterations_(num_iterations),
+      events_(resource_manager->get_local_gpu_count()),
+      num_used_events_(resource_manager->get_local_gpu_count(), 0),
+      timings_(resource_manager->get_local_gpu_count()),
+      parts_(resource_manager->get_local_gpu_count()) {
+  HCTR_THROW_IF(num_iterations_ <= 0, Error_t::WrongInput,
+                "The number of iterations to profile must be positive");
+
+  const int device_id = resource_manager_->get_local_gpu(0)->get_device_id();
+  int major = 0, minor = 0, num_sms = 0, clock_khz = 0, memory_clock_khz = 0, bus_width = 0;
+  HCTR_LIB_THROW(cudaDeviceGetAttribute(&major, cudaDevAttrComputeCapabilityMajor, device_id));
+  HCTR_LIB_THROW(cudaDeviceGetAttribute(&minor, cudaDevAttrComputeCapabilityMinor, device_id));
+  HCTR_LIB_THROW(cudaDeviceGetAttribute(&num_sms, cudaDevAttrMultiProcessorCount, device_id));
+  HCTR_LIB_THROW(cudaDeviceGetAttribute(&clock_khz, cudaDevAttrClockRate, device_id));
+  HCTR_LIB_THROW(cudaDeviceGetAttribute(&memory_clock_khz, cudaDevAttrMemoryClockRate, device_id));
+  HCTR_LIB_THROW(cudaDeviceGetAttribute(&bus_width, cudaDevAttrGlobalMemoryBusWidth, device_id));
+
+  peak_flops_ = peak_tflops > 0.0 ? peak_tflops * 1e12
+                                  : num_sms * clock_khz * 1e3 *
+                                        flops_per_sm_per_cycle(major, minor, use_mixed_precision);
+  // Double data rate
+  peak_bytes_per_second_ =
+      peak_gbps > 0.0 ? peak_gbps * 1e9 : 2.0 * memory_clock_khz * 1e3 * bus_width / 8.0;
+}
+
+StepProfiler::~StepProfiler() {
+  for (size_t i = 0; i < events_.size(); i++) {
+    CudaDeviceContext context(resource_manager_->get_local_gpu(i)->get_device_id());
+    for (cudaEvent_t event : events_[i]) {
+      HCTR_LIB_CHECK_(cudaEventDestroy(event));
+    }
+  }
+}
+
+cudaEvent_t StepProfiler::next_event(const size_t local_gpu_id) {
+  auto& events = events_[local_gpu_id];
+  if (num_used_events_[local_gpu_id] == events.size()) {
+    cudaEvent_t event;
+    HCTR_LIB_THROW(cudaEventCreate(&event));
+    events.push_back(event);
+  }
+  return events[num_used_events_[local_gpu_id]++];
+}
+
+void StepProfiler::time(const size_t local_gpu_id, const std::string& name, const Kind kind,
+                        const std::function<void()>& work, const double flops,
+                        const double bytes) {
+  const auto& gpu = resource_manager_->get_local_gpu(local_gpu_id);
+  CudaDeviceContext context(gpu->get_device_id());
+  const cudaStream_t stream = gpu->get_stream();
+  Timing timing{name, kind, flops, bytes, next_event(local_gpu_id), next_event(local_gpu_id)};
+  HCTR_LIB_THROW(cudaEventRecord(timing.start, stream));
+  work();
+  HCTR_LIB_THROW(cudaEventRecord(timing.stop, stream));
+  timings_[local_gpu_id].push_back(std::move(timing));
+}
+
+void StepProfiler::end_iteration() {
+  if (!active()) {
+    return;
+  }
+  for (size_t i = 0; i < timings_.size(); i++) {
+    CudaDeviceContext context(resource_manager_->get_local_gpu(i)->get_device_id());
+    for (const Timing& timing : timings_[i]) {
+      HCTR_LIB_THROW(cudaEventSynchronize(timing.stop));
+      float milliseconds = 0.f;
+      HCTR_LIB_THROW(cudaEventElapsedTime(&milliseconds, timing.start, timing.stop));
+      Part& part = parts_[i].emplace(timing.name, Part{timing.kind}).first->second;
+      part.num_calls++;
+      part.milliseconds += milliseconds;
+      part.flops += timing.flops;
+      part.bytes += timing.bytes;
+    }
+    timings_[i].clear();
+    num_used_events_[i] = 0;
+  }
+  num_timed_iterations_++;
+}
+
+std::vector<StepProfiler::Row> StepProfiler::rows() const {
+  std::map<std::string, Part> sum;
+  for (const auto& gpu_parts : parts_) {
+    for (const auto& [name, part] : gpu_parts) {
+      Part& total = sum.emplace(name, Part{part.kind}).first->second;
+      total.num_calls += part.num_calls;
+      total.milliseconds += part.milliseconds;
+      total.flops += part.flops;
+      total.bytes += part.bytes;
+    }
+  }
+
+  const double num_samples = static_cast<double>(std::max(num_timed_iterations_, 1)) *
+                             resource_manager_->get_local_gpu_count();
+  const double ridge_point = peak_flops_ / peak_bytes_per_second_;
+  std::vector<Row> rows;
+  for (const auto& [name, part] : sum) {
+    Row row{name, part.kind, part.milliseconds / num_samples, part.flops / num_samples,
+            part.bytes / num_samples};
+    const double seconds = part.milliseconds * 1e-3;
+    row.tflops = seconds > 0.0 ? part.flops / seconds * 1e-12 : 0.0;
+    row.gbps = seconds > 0.0 ? part.bytes / seconds * 1e-9 : 0.0;
+    if (part.flops == 0.0 && part.bytes == 0.0) {
+      row.bound = "-";
+      row.peak_fraction = 0.0;
+    } else if (part.bytes > 0.0 && part.flops / part.bytes < ridge_point) {
+      row.bound = "memory";
+      row.peak_fraction = row.gbps * 1e9 / peak_bytes_per_second_;
+    } else {
+      row.bound = "compute";
+      row.peak_fraction = row.tflops * 1e12 / peak_flops_;
+    }
+    rows.push_back(row);
+  }
+  std::sort(rows.begin(), rows.end(),
+            [](const Row& a, const Row& b) { return a.milliseconds > b.milliseconds; });
+  return rows;
+}
+
+std::string StepProfiler::report() const {
+  const std::vector<Row> parts = rows();
+  double total_milliseconds = 0.0;
+  for (const Row& row : parts) {
+    total_milliseconds += row.milliseconds;
+  }
+
+  std::ostringstream os;
+  os << "Profile of " << num_timed_iterations_ << " iterations, per iteration and GPU, against "
+     << std::fixed << std::setprecision(1) << peak_flops_ * 1e-12 << " TFLOP/s and "
+     << peak_bytes_per_second_ * 1e-9 << " GB/s" << std::endl;
+  os << std::left << std::setw(6) << "Rank" << std::setw(56) << "Part" << std::setw(15) << "Kind"
+     << std::setw(12) << "Time(ms)" << std::setw(10) << "Share(%)" << std::setw(10) << "TFLOP/s"
+     << std::setw(10) << "GB/s" << std::setw(10) << "Bound" << std::setw(10) << "Peak(%)"
+     << std::endl;
+  for (size_t i = 0; i < parts.size(); i++) {
+    const Row& row = parts[i];
+    const double share =
+        total_milliseconds > 0.0 ? 100.0 * row.milliseconds / total_milliseconds : 0.0;
+    os << std::left << std::setw(6) << i + 1 << std::setw(56) << row.name << std::setw(15)
+       << kind_name(row.kind) << std::setprecision(3) << std::setw(12) << row.milliseconds
+       << std::setprecision(1) << std::setw(10) << share << std::setw(10) << row.tflops
+       << std::setw(10) << row.gbps << std::setw(10) << row.bound << std::setw(10)
+       << 100.0 * row.peak_fraction << std::endl;
+  }
+  os << std::left << std::setw(6) << "" << std::setw(71) << "Sum" << std::setprecision(3)
+     << total_milliseconds << std::endl;
+  return os.str();
+}
+
+void StepProfiler::write_json(const std::string& path) const {
+  nlohmann::json json;
+  json["iterations"] = num_timed_iterations_;
+  json["peak_tflops"] = peak_flops_ * 1e-12;
+  json["peak_gbps"] = peak_bytes_per_second_ * 1e-9;
+  json["parts"] = nlohmann::json::array();
+  for (const Row& row : rows()) {
+    json["parts"].push_back({{"name", row.name},
+                             {"kind", kind_name(row.kind)},
+                             {"milliseconds", row.milliseconds},
+                             {"flops", row.flops},
+                             {"bytes", row.bytes},
+                             {"tflops", row.tflops},
+                             {"gbps", row.gbps},
+                             {"bound", row.bound},
+                             {"peak_fraction", row.peak_fraction}});
+  }
+
+  std::ofstream file(path);
+  HCTR_THROW_IF(!file.is_open(), Error_t::FileCannotOpen, "Cannot open ", path, " for writing");
+  file << json.dump(2) << std::endl;
+}
+
+}  // namespace HugeCTR
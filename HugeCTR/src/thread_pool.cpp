@@ -14,13 +14,224 @@
  * limitations under the License.
  */
 
+#include <glob.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <array>
 #include <core23/logger.hpp>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <numeric>
+#include <sstream>
 #include <thread_pool.hpp>
 
 namespace HugeCTR {
 
+namespace {
+
+// The NUMA node of the process-wide worker running this thread, -1 on other threads
+thread_local int worker_node = -1;
+
+std::vector<int> parse_cpu_list(const std::string& list) {
+  std::vector<int> cpus;
+  std::istringstream is(list);
+  std::string range;
+  while (std::getline(is, range, ',')) {
+    if (range.empty()) {
+      continue;
+    }
+    const size_t dash = range.find('-');
+    const int first = std::stoi(range.substr(0, dash));
+    const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+    for (int cpu = first; cpu <= last; ++cpu) {
+      cpus.emplace_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+/**
+ * The workers the shares of all pools run their tasks on. There is a queue per NUMA node and
+ * priority, a worker serves the priorities from the highest down, and within a priority its own
+ * node before the others.
+ * The instance is never destroyed, so that pools in static storage can outlive it; the detached
+ * workers end with the process.
+ */
+class SharedWorkers final {
+ public:
+  HCTR_DISALLOW_COPY_AND_MOVE(SharedWorkers);
+
+  static SharedWorkers& get() {
+    static SharedWorkers* const instance = new SharedWorkers();
+    return *instance;
+  }
+
+  void push(const TaskPriority priority, std::function<void()> task) {
+    int node = worker_node;
+    if (node < 0) {
+      const int cpu = sched_getcpu();
+      node = cpu >= 0 && static_cast<size_t>(cpu) < cpu_nodes_.size() ? cpu_nodes_[cpu] : 0;
+    }
+    {
+      Node& n = *nodes_[node];
+      std::lock_guard<std::mutex> lock(n.barrier);
+      n.queues[static_cast<size_t>(priority)].emplace_back(std::move(task));
+      num_pending_++;
+    }
+    {
+      std::lock_guard<std::mutex> lock(sleep_barrier_);
+    }
+    submit_semaphore_.notify_one();
+  }
+
+  // Runs one queued task in the calling thread, false if there was none
+  bool run_one(const int node) {
+    std::function<void()> task;
+    if (!pop_(node, task)) {
+      return false;
+    }
+    task();
+    return true;
+  }
+
+ private:
+  struct Node {
+    std::vector<int> cpus;
+    std::mutex barrier;
+    std::array<std::deque<std::function<void()>>, 3> queues;
+  };
+  std::vector<std::unique_ptr<Node>> nodes_;
+  std::vector<int> cpu_nodes_;  // NUMA node of every CPU
+
+  std::atomic<size_t> num_pending_{0};
+  std::mutex sleep_barrier_;
+  std::condition_variable submit_semaphore_;
+
+  SharedWorkers() {
+    // The CPUs this process may run on, grouped by NUMA node.
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+      for (size_t cpu = 0; cpu < std::thread::hardware_concurrency(); ++cpu) {
+        CPU_SET(cpu, &allowed);
+      }
+    }
+    glob_t node_dirs;
+    if (glob("/sys/devices/system/node/node[0-9]*/cpulist", 0, nullptr, &node_dirs) == 0) {
+      for (size_t i = 0; i < node_dirs.gl_pathc; ++i) {
+        std::ifstream is(node_dirs.gl_pathv[i]);
+        std::string list;
+        std::getline(is, list);
+        add_node_(parse_cpu_list(list), allowed);
+      }
+    }
+    globfree(&node_dirs);
+    if (nodes_.empty()) {
+      std::vector<int> cpus(CPU_SETSIZE);
+      std::iota(cpus.begin(), cpus.end(), 0);
+      add_node_(cpus, allowed);
+    }
+    if (nodes_.empty()) {
+      nodes_.emplace_back(std::make_unique<Node>());
+    }
+
+    // The workers are dealt to the CPUs in node order.
+    std::vector<std::pair<int, int>> node_cpus;
+    for (size_t node = 0; node < nodes_.size(); ++node) {
+      for (const int cpu : nodes_[node]->cpus) {
+        node_cpus.emplace_back(node, cpu);
+      }
+    }
+    size_t num_workers = std::max<size_t>(node_cpus.size(), 1);
+    if (const char* num_workers_str = getenv("HCTR_DEFAULT_CONCURRENCY")) {
+      num_workers = std::max<size_t>(std::stoull(num_workers_str), 1);
+    }
+    const char* affinity_str = getenv("HCTR_THREAD_AFFINITY");
+    const std::string affinity = affinity_str ? affinity_str : "numa";
+    if (affinity != "numa" && affinity != "core" && affinity != "none") {
+      HCTR_OWN_THROW(Error_t::WrongInput,
+                     "HCTR_THREAD_AFFINITY must be 'numa', 'core' or 'none', not '" + affinity +
+                         "'!");
+    }
+    for (size_t i = 0; i < num_workers; ++i) {
+      const std::pair<int, int> node_cpu =
+          node_cpus.empty() ? std::make_pair(0, -1) : node_cpus[i % node_cpus.size()];
+      std::thread(&SharedWorkers::run_, this, i, node_cpu.first, node_cpu.second, affinity)
+          .detach();
+    }
+  }
+
+  void add_node_(const std::vector<int>& cpus, const cpu_set_t& allowed) {
+    auto node = std::make_unique<Node>();
+    for (const int cpu : cpus) {
+      if (cpu >= 0 && cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) {
+        node->cpus.emplace_back(cpu);
+        if (static_cast<size_t>(cpu) >= cpu_nodes_.size()) {
+          cpu_nodes_.resize(cpu + 1, 0);
+        }
+        cpu_nodes_[cpu] = nodes_.size();
+      }
+    }
+    if (!node->cpus.empty()) {
+      nodes_.emplace_back(std::move(node));
+    }
+  }
+
+  bool pop_(const int node, std::function<void()>& task) {
+    if (num_pending_ == 0) {
+      return false;
+    }
+    for (size_t priority = 3; priority-- > 0;) {
+      for (size_t i = 0; i < nodes_.size(); ++i) {
+        Node& n = *nodes_[(node + i) % nodes_.size()];
+        std::lock_guard<std::mutex> lock(n.barrier);
+        auto& queue = n.queues[priority];
+        if (!queue.empty()) {
+          task = std::move(queue.front());
+          queue.pop_front();
+          num_pending_--;
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  void run_(const size_t thread_index, const int node, const int cpu, const std::string affinity) {
+    Logger::set_thread_name("worker #" + std::to_string(thread_index));
+    worker_node = node;
+    if (cpu >= 0 && affinity != "none") {
+      cpu_set_t cpus;
+      CPU_ZERO(&cpus);
+      if (affinity == "core") {
+        CPU_SET(cpu, &cpus);
+      } else {
+        for (const int node_cpu : nodes_[node]->cpus) {
+          CPU_SET(node_cpu, &cpus);
+        }
+      }
+      if (sched_setaffinity(0, sizeof(cpus), &cpus) != 0) {
+        HCTR_LOG_S(WARNING, WORLD) << "Unable to set the CPU affinity of worker #" << thread_index
+                                   << std::endl;
+      }
+    }
+
+    while (true) {
+      std::function<void()> task;
+      if (pop_(node, task)) {
+        task();
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(sleep_barrier_);
+      submit_semaphore_.wait(lock, [this]() { return num_pending_ != 0; });
+    }
+  }
+};
+
+}  // namespace
+
 ThreadPool::ThreadPool(const std::string& name) : ThreadPool(name, 0) {}
 
 ThreadPool::ThreadPool(const std::string& name, size_t num_workers) : name_(name) {
@@ -43,7 +254,23 @@ ThreadPool::ThreadPool(const std::string& name, size_t num_workers) : name_(name
   await_idle();
 }
 
+ThreadPool::ThreadPool(const std::string& name, const TaskPriority priority,
+                       const size_t max_concurrency)
+    : name_(name), shared_(true), priority_(priority), max_concurrency_(max_concurrency) {
+  // Start the process-wide workers if this is the first share.
+  SharedWorkers::get();
+}
+
 ThreadPool::~ThreadPool() {
+  if (shared_) {
+    // Drop the queued tasks, and wait for the running ones.
+    std::unique_lock<std::mutex> lock(barrier_);
+    terminate_ = true;
+    packages_.clear();
+    idle_semaphore_.wait(lock, [this]() { return num_running_ == 0; });
+    return;
+  }
+
   // Momentarily request exclusive access, and set terminate condition.
   {
     std::lock_guard<std::mutex> lock(barrier_);
@@ -60,10 +287,20 @@ ThreadPool::~ThreadPool() {
 bool ThreadPool::idle() const {
   // Momentarily request exclusive access, and read out the idle status.
   std::lock_guard<std::mutex> lock(barrier_);
+  if (shared_) {
+    return num_running_ == 0 && packages_.empty();
+  }
   return num_idle_workers_ == workers_.size() && packages_.empty();
 }
 
 void ThreadPool::await_idle() const {
+  if (shared_) {
+    help_while([this]() { return !idle(); });
+    std::unique_lock<std::mutex> lock(barrier_);
+    idle_semaphore_.wait(lock, [this]() { return num_running_ == 0 && packages_.empty(); });
+    return;
+  }
+
   // Momentarily request exclusive access.
   std::unique_lock<std::mutex> lock(barrier_);
 
@@ -87,7 +324,16 @@ std::future<void> ThreadPool::submit(std::function<void()> task) {
       HCTR_OWN_THROW(Error_t::IllegalCall,
                      "Attempted to submit work to an already terminated ThreadPool!");
     }
-    packages_.emplace_back(std::move(package));
+    if (shared_ && (max_concurrency_ == 0 || num_running_ < max_concurrency_)) {
+      num_running_++;
+    } else {
+      packages_.emplace_back(std::move(package));
+      package = {};
+    }
+  }
+  if (package.valid()) {
+    dispatch_(std::move(package));
+    return result;
   }
 
   // Wake up a worker.
@@ -100,10 +346,49 @@ ThreadPool& ThreadPool::get() {
   // Lazy init of default thread-pool on first call to this function..
   static std::unique_ptr<ThreadPool> default_pool;
   static std::once_flag semaphore;
-  std::call_once(semaphore, []() { default_pool = std::make_unique<ThreadPool>("default"); });
+  std::call_once(semaphore, []() {
+    default_pool = std::make_unique<ThreadPool>("default", TaskPriority::Refresh);
+  });
   return *default_pool.get();
 }
 
+void ThreadPool::help_while(const std::function<bool()>& pending) {
+  if (worker_node < 0) {
+    return;
+  }
+  SharedWorkers& workers = SharedWorkers::get();
+  while (pending()) {
+    if (!workers.run_one(worker_node)) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+void ThreadPool::dispatch_(std::packaged_task<void()> package) {
+  auto shared_package = std::make_shared<std::packaged_task<void()>>(std::move(package));
+  SharedWorkers::get().push(priority_, [this, shared_package]() {
+    (*shared_package)();
+    finished_();
+  });
+}
+
+void ThreadPool::finished_() {
+  std::packaged_task<void()> package;
+  {
+    std::lock_guard<std::mutex> lock(barrier_);
+    if (packages_.empty()) {
+      num_running_--;
+      if (num_running_ == 0) {
+        idle_semaphore_.notify_all();
+      }
+      return;
+    }
+    package = std::move(packages_.front());
+    packages_.pop_front();
+  }
+  dispatch_(std::move(package));
+}
+
 void ThreadPool::run_(const size_t thread_index) {
   if (name_ != "") {
     Logger::set_thread_name(name_ + " #" + std::to_string(thread_index));
@@ -43,6 +43,8 @@ template void convert_array_on_device<float, __half>(__half *, const float *, si
                                                      const cudaStream_t &);
 template void convert_array_on_device<__half, float>(float *, const __half *, size_t,
                                                      const cudaStream_t &);
+template void convert_array_on_device<float, __nv_bfloat16>(__nv_bfloat16 *, const float *, size_t,
+                                                            const cudaStream_t &);
 
 template <typename TypeKey>
 void data_to_unique_categories(TypeKey *value, const TypeKey *rowoffset,
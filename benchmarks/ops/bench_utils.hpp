@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <cuda_runtime.h>
+
+#include <algorithm>
+#include <common.hpp>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace HugeCTR {
+
+namespace bench {
+
+template <typename T>
+class DeviceArray {
+ public:
+  explicit DeviceArray(size_t size) : size_(size) {
+    HCTR_LIB_THROW(cudaMalloc(&data_, std::max<size_t>(size, 1) * sizeof(T)));
+  }
+  DeviceArray(const DeviceArray&) = delete;
+  DeviceArray& operator=(const DeviceArray&) = delete;
+  ~DeviceArray() { cudaFree(data_); }
+
+  void upload(const std::vector<T>& host) {
+    HCTR_LIB_THROW(
+        cudaMemcpy(data_, host.data(), host.size() * sizeof(T), cudaMemcpyHostToDevice));
+  }
+
+  T* get() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  T* data_ = nullptr;
+  size_t size_;
+};
+
+// num_keys keys drawn uniformly from [0, num_distinct), so that a batch carries duplicates.
+template <typename KeyType>
+std::vector<KeyType> random_keys(size_t num_keys, size_t num_distinct, unsigned seed = 2023) {
+  std::mt19937_64 gen(seed);
+  std::uniform_int_distribution<uint64_t> dist(0, num_distinct - 1);
+  std::vector<KeyType> keys(num_keys);
+  for (auto& key : keys) key = static_cast<KeyType>(dist(gen));
+  return keys;
+}
+
+// The keys [0, num_keys) in a random order.
+template <typename KeyType>
+std::vector<KeyType> shuffled_keys(size_t num_keys, unsigned seed = 2023) {
+  std::vector<KeyType> keys(num_keys);
+  std::iota(keys.begin(), keys.end(), KeyType{0});
+  std::shuffle(keys.begin(), keys.end(), std::mt19937_64(seed));
+  return keys;
+}
+
+/**
+ * Times every iteration with CUDA events on the given stream, so the benchmarks must be
+ * registered with UseManualTime(). The host launch overhead is included, the time the host
+ * spends outside of the op is not.
+ */
+template <typename Op>
+void run_on_stream(benchmark::State& state, cudaStream_t stream, Op&& op) {
+  cudaEvent_t start, stop;
+  HCTR_LIB_THROW(cudaEventCreate(&start));
+  HCTR_LIB_THROW(cudaEventCreate(&stop));
+  // One untimed run, to take lazy allocations and algorithm selection out of the numbers
+  op();
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  for (auto _ : state) {
+    HCTR_LIB_THROW(cudaEventRecord(start, stream));
+    op();
+    HCTR_LIB_THROW(cudaEventRecord(stop, stream));
+    HCTR_LIB_THROW(cudaEventSynchronize(stop));
+    float elapsed_ms = 0.f;
+    HCTR_LIB_THROW(cudaEventElapsedTime(&elapsed_ms, start, stop));
+    state.SetIterationTime(elapsed_ms / 1000.);
+  }
+  HCTR_LIB_THROW(cudaEventDestroy(start));
+  HCTR_LIB_THROW(cudaEventDestroy(stop));
+}
+
+// items_per_iteration and bytes_per_iteration show up as items_per_second and bytes_per_second.
+inline void set_throughput(benchmark::State& state, int64_t items_per_iteration,
+                           int64_t bytes_per_iteration) {
+  state.SetItemsProcessed(state.iterations() * items_per_iteration);
+  state.SetBytesProcessed(state.iterations() * bytes_per_iteration);
+}
+
+}  // namespace bench
+
+}  // namespace HugeCTR
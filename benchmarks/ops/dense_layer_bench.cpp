@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <cuda_fp16.h>
+
+#include <bench_utils.hpp>
+#include <core23/data_type_helpers.cuh>
+#include <core23/tensor.hpp>
+#include <gpu_resource.hpp>
+#include <layers/interaction_layer.hpp>
+#include <layers/mlp_layer.hpp>
+#include <layers/multi_cross_layer.hpp>
+#include <memory>
+#include <network_buffer_channels.hpp>
+#include <vector>
+
+namespace {
+
+using namespace HugeCTR;
+using namespace HugeCTR::bench;
+
+std::shared_ptr<GPUResource> make_gpu_resource() {
+  return std::make_shared<GPUResource>(0, 0, 0, 2023, 2023, nullptr);
+}
+
+template <typename T>
+core23::Tensor make_tensor(const core23::Shape& shape) {
+  core23::BufferParams buffer_params = {};
+  buffer_params.channel = GetBlobsBufferChannel();
+  return core23::Tensor(core23::TensorParams(shape)
+                        .data_type(core23::ToScalarType<T>::value)
+                        .buffer_params(buffer_params));
+}
+
+/**
+ * Times fprop(false) when `train` is false, fprop(true) followed by bprop() otherwise.
+ * The inputs are zeroed here rather than when they are created, because touching a tensor
+ * allocates its buffer and the layer still has to subscribe its own tensors to it.
+ */
+void run_layer(benchmark::State& state, Layer& layer, GPUResource& gpu_resource, bool train,
+               const std::vector<core23::Tensor>& inputs) {
+  for (auto input : inputs) {
+    HCTR_LIB_THROW(cudaMemset(input.data(), 0, input.num_bytes()));
+  }
+  layer.initialize();
+  layer.search_algorithm();
+  run_on_stream(state, gpu_resource.get_stream(), [&] {
+    layer.fprop(train);
+    if (train) layer.bprop();
+  });
+}
+
+// Arguments: batch size, number of embeddings, embedding vector size, train.
+template <typename T>
+void BM_InteractionLayer(benchmark::State& state) {
+  const int64_t batch_size = state.range(0);
+  const int64_t num_embeddings = state.range(1);
+  const int64_t emb_vec_size = state.range(2);
+  const bool train = state.range(3);
+
+  auto gpu_resource = make_gpu_resource();
+  auto bottom_mlp = make_tensor<T>({batch_size, emb_vec_size});
+  auto bottom_emb = make_tensor<T>({batch_size, num_embeddings, emb_vec_size});
+  core23::Tensor top;
+  InteractionLayer<T> layer(bottom_mlp, bottom_emb, top, gpu_resource, true, false);
+  run_layer(state, layer, *gpu_resource, train, {bottom_mlp, bottom_emb});
+
+  const int64_t num_features = num_embeddings + 1;
+  // One batched Gram matrix per sample, every pair of features is a dot product
+  const int64_t flops = 2 * batch_size * num_features * num_features * emb_vec_size;
+  set_throughput(state, batch_size,
+                 (bottom_mlp.num_bytes() + bottom_emb.num_bytes() + top.num_bytes()));
+  state.counters["FLOPS"] = benchmark::Counter(
+      static_cast<double>(flops * (train ? 3 : 1)) * state.iterations(),
+      benchmark::Counter::kIsRate);
+}
+
+// Arguments: batch size, input width, number of cross layers, projection dim, train.
+// A projection dim of 0 selects the DCNv1 layer, which has no GEMM.
+template <typename T>
+void BM_MultiCrossLayer(benchmark::State& state) {
+  const int64_t batch_size = state.range(0);
+  const int64_t width = state.range(1);
+  const int num_layers = static_cast<int>(state.range(2));
+  const int64_t projection_dim = state.range(3);
+  const bool train = state.range(4);
+
+  auto gpu_resource = make_gpu_resource();
+  auto input = make_tensor<T>({batch_size, width});
+  auto output = make_tensor<T>({batch_size, width});
+  MultiCrossLayer<T> layer({input}, {output}, gpu_resource, num_layers, projection_dim, {},
+                           false, false);
+  run_layer(state, layer, *gpu_resource, train, {input});
+
+  const int64_t gemm_flops = projection_dim ? 2 * 2 * batch_size * width * projection_dim
+                                            : 2 * batch_size * width;
+  set_throughput(state, batch_size, input.num_bytes() + output.num_bytes());
+  state.counters["FLOPS"] = benchmark::Counter(
+      static_cast<double>(num_layers * gemm_flops * (train ? 3 : 1)) * state.iterations(),
+      benchmark::Counter::kIsRate);
+}
+
+// Arguments: batch size, input width, train, fuse_wb.
+// The layer stack is the DLRM top MLP, the bias and activation are fused into the GEMMs.
+template <typename T>
+void BM_MLPLayer(benchmark::State& state) {
+  const int64_t batch_size = state.range(0);
+  const int64_t input_dim = state.range(1);
+  const bool train = state.range(2);
+  const bool fuse_wb = state.range(3);
+  const std::vector<int64_t> num_outputs = {1024, 1024, 512, 256, 1};
+
+  auto gpu_resource = make_gpu_resource();
+  auto input = make_tensor<T>({batch_size, input_dim});
+  auto output = make_tensor<T>({batch_size, num_outputs.back()});
+  std::vector<Activation_t> acts(num_outputs.size(), Activation_t::Relu);
+  acts.back() = Activation_t::None;
+  std::vector<bool> use_bias(num_outputs.size(), true);
+  MLPLayer<T> layer({input}, {output}, num_outputs, gpu_resource, acts, use_bias,
+                    std::vector<Initializer_t>(), false, false, fuse_wb, false);
+  run_layer(state, layer, *gpu_resource, train, {input});
+
+  int64_t flops = 0;
+  int64_t fan_in = input_dim;
+  for (auto fan_out : num_outputs) {
+    flops += 2 * batch_size * fan_in * fan_out;
+    fan_in = fan_out;
+  }
+  set_throughput(state, batch_size, input.num_bytes() + output.num_bytes());
+  state.counters["FLOPS"] =
+      benchmark::Counter(static_cast<double>(flops * (train ? 3 : 1)) * state.iterations(),
+                         benchmark::Counter::kIsRate);
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_InteractionLayer, __half)
+    ->ArgNames({"batch", "num_emb", "emb_vec_size", "train"})
+    ->ArgsProduct({{1024, 8192, 65536}, {26}, {128}, {0, 1}})
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_InteractionLayer, float)
+    ->ArgNames({"batch", "num_emb", "emb_vec_size", "train"})
+    ->ArgsProduct({{1024, 8192, 65536}, {26}, {128}, {0, 1}})
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_MultiCrossLayer, __half)
+    ->ArgNames({"batch", "width", "layers", "proj_dim", "train"})
+    ->ArgsProduct({{1024, 8192, 65536}, {512, 1024}, {3}, {0, 256}, {0, 1}})
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_MultiCrossLayer, float)
+    ->ArgNames({"batch", "width", "layers", "proj_dim", "train"})
+    ->ArgsProduct({{1024, 8192, 65536}, {512, 1024}, {3}, {0, 256}, {0, 1}})
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_MLPLayer, __half)
+    ->ArgNames({"batch", "input_dim", "train", "fuse_wb"})
+    ->ArgsProduct({{1024, 8192, 65536}, {479}, {0, 1}, {0, 1}})
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_MLPLayer, float)
+    ->ArgNames({"batch", "input_dim", "train", "fuse_wb"})
+    ->ArgsProduct({{1024, 8192, 65536}, {479}, {0, 1}, {0}})
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
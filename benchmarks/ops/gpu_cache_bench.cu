@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <bench_utils.hpp>
+#include <limits>
+#include <nv_gpu_cache.hpp>
+#include <static_table.hpp>
+
+namespace {
+
+using namespace HugeCTR::bench;
+
+using KeyType = long long;
+
+template <int SetAssociativity>
+using Cache = gpu_cache::gpu_cache<KeyType, uint64_t, std::numeric_limits<KeyType>::max(),
+                                   SetAssociativity, SLAB_SIZE>;
+
+// Number of sets for a cache that holds `num_keys` keys when it is fully occupied
+template <int SetAssociativity>
+size_t capacity_in_set(size_t num_keys) {
+  constexpr size_t keys_per_set = SetAssociativity * SLAB_SIZE;
+  return (num_keys + keys_per_set - 1) / keys_per_set;
+}
+
+/**
+ * Arguments: keys per query, embedding vector size, hit rate in percent.
+ * The cache is filled with the keys [0, num_keys), the queried keys are drawn so that the
+ * requested fraction of them is resident.
+ */
+template <int SetAssociativity>
+void BM_GpuCacheQuery(benchmark::State& state) {
+  const size_t num_keys = state.range(0);
+  const size_t emb_vec_size = state.range(1);
+  const double hit_rate = state.range(2) / 100.;
+
+  cudaStream_t stream;
+  HCTR_LIB_THROW(cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking));
+  {
+    Cache<SetAssociativity> cache(capacity_in_set<SetAssociativity>(2 * num_keys), emb_vec_size);
+    DeviceArray<KeyType> d_keys(num_keys);
+    DeviceArray<float> d_values(num_keys * emb_vec_size);
+    DeviceArray<uint64_t> d_missing_index(num_keys);
+    DeviceArray<KeyType> d_missing_keys(num_keys);
+    DeviceArray<size_t> d_missing_len(1);
+
+    d_keys.upload(shuffled_keys<KeyType>(num_keys));
+    cache.Replace(d_keys.get(), num_keys, d_values.get(), stream);
+
+    // Misses are keys beyond the resident range
+    auto h_keys = random_keys<KeyType>(num_keys, num_keys);
+    std::mt19937_64 gen(7);
+    std::bernoulli_distribution hit(hit_rate);
+    for (auto& key : h_keys) {
+      if (!hit(gen)) key += num_keys;
+    }
+    d_keys.upload(h_keys);
+
+    run_on_stream(state, stream, [&] {
+      cache.Query(d_keys.get(), num_keys, d_values.get(), d_missing_index.get(),
+                  d_missing_keys.get(), d_missing_len.get(), stream);
+    });
+    set_throughput(state, num_keys, num_keys * (sizeof(KeyType) + emb_vec_size * sizeof(float)));
+  }
+  HCTR_LIB_THROW(cudaStreamDestroy(stream));
+}
+
+/**
+ * Arguments: keys per replace, embedding vector size.
+ * Every iteration inserts keys that are not resident, into a cache that holds a quarter of the
+ * key space, so the numbers include the eviction path.
+ */
+template <int SetAssociativity>
+void BM_GpuCacheReplace(benchmark::State& state) {
+  const size_t num_keys = state.range(0);
+  const size_t emb_vec_size = state.range(1);
+  constexpr size_t num_batches = 8;
+
+  cudaStream_t stream;
+  HCTR_LIB_THROW(cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking));
+  {
+    Cache<SetAssociativity> cache(capacity_in_set<SetAssociativity>(2 * num_keys), emb_vec_size);
+    DeviceArray<KeyType> d_keys(num_batches * num_keys);
+    DeviceArray<float> d_values(num_keys * emb_vec_size);
+    d_keys.upload(shuffled_keys<KeyType>(num_batches * num_keys));
+
+    size_t batch = 0;
+    run_on_stream(state, stream, [&] {
+      cache.Replace(d_keys.get() + batch * num_keys, num_keys, d_values.get(), stream);
+      batch = (batch + 1) % num_batches;
+    });
+    set_throughput(state, num_keys, num_keys * (sizeof(KeyType) + emb_vec_size * sizeof(float)));
+  }
+  HCTR_LIB_THROW(cudaStreamDestroy(stream));
+}
+
+/**
+ * Arguments: number of keys in the table, keys per query, embedding vector size.
+ */
+void BM_StaticTableQuery(benchmark::State& state) {
+  const size_t table_size = state.range(0);
+  const size_t num_keys = state.range(1);
+  const size_t emb_vec_size = state.range(2);
+
+  cudaStream_t stream;
+  HCTR_LIB_THROW(cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking));
+  {
+    gpu_cache::static_table<KeyType, float, float> table(table_size, emb_vec_size);
+    DeviceArray<KeyType> d_table_keys(table_size);
+    DeviceArray<float> d_table_values(table_size * emb_vec_size);
+    d_table_keys.upload(shuffled_keys<KeyType>(table_size));
+    HCTR_LIB_THROW(cudaMemsetAsync(d_table_values.get(), 0,
+                                   table_size * emb_vec_size * sizeof(float), stream));
+    table.Init(d_table_keys.get(), table_size, d_table_values.get(), stream);
+
+    DeviceArray<KeyType> d_keys(num_keys);
+    DeviceArray<float> d_values(num_keys * emb_vec_size);
+    d_keys.upload(random_keys<KeyType>(num_keys, table_size));
+
+    run_on_stream(state, stream,
+                  [&] { table.Query(d_keys.get(), num_keys, d_values.get(), stream); });
+    set_throughput(state, num_keys, num_keys * (sizeof(KeyType) + emb_vec_size * sizeof(float)));
+  }
+  HCTR_LIB_THROW(cudaStreamDestroy(stream));
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_GpuCacheQuery, SET_ASSOCIATIVITY)
+    ->ArgNames({"keys", "emb_vec_size", "hit_pct"})
+    ->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 20, 32), {16, 64, 128}, {50, 100}})
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_GpuCacheQuery, 8)
+    ->ArgNames({"keys", "emb_vec_size", "hit_pct"})
+    ->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 20, 32), {64}, {50, 100}})
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_GpuCacheReplace, SET_ASSOCIATIVITY)
+    ->ArgNames({"keys", "emb_vec_size"})
+    ->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 20, 32), {16, 64, 128}})
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StaticTableQuery)
+    ->ArgNames({"table_size", "keys", "emb_vec_size"})
+    ->ArgsProduct({{1 << 20, 1 << 24}, benchmark::CreateRange(1 << 10, 1 << 20, 32), {16, 128}})
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
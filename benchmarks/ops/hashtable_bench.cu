@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <bench_utils.hpp>
+#include <hashtable/bucketed_hash_map.cuh>
+#include <hashtable/cudf/concurrent_unordered_map.cuh>
+#include <limits>
+#include <memory>
+
+namespace {
+
+using namespace HugeCTR::bench;
+
+using KeyType = long long;
+using ValType = size_t;
+using LegacyMap = concurrent_unordered_map<KeyType, ValType, std::numeric_limits<KeyType>::max()>;
+using BucketedMap = HugeCTR::BucketedHashMap<KeyType, ValType>;
+
+// The kernels the legacy nv_hashtable launched on the cudf map, one thread per key
+template <typename ValueType>
+struct ReplaceOp {
+  __host__ __device__ ValueType operator()(ValueType new_value, ValueType) { return new_value; }
+};
+
+__global__ void legacy_get_insert(LegacyMap* map, const KeyType* keys, ValType* vals, size_t len,
+                                  size_t* counter) {
+  const size_t i = blockIdx.x * blockDim.x + threadIdx.x;
+  if (i < len) {
+    vals[i] = map->get_insert(keys[i], ReplaceOp<ValType>(), counter)->second;
+  }
+}
+
+__global__ void legacy_find(LegacyMap* map, const KeyType* keys, ValType* vals, size_t len) {
+  const size_t i = blockIdx.x * blockDim.x + threadIdx.x;
+  if (i < len) {
+    auto it = map->find(keys[i]);
+    vals[i] = it != map->end() ? it->second : std::numeric_limits<ValType>::max();
+  }
+}
+
+/**
+ * Arguments: number of keys, load factor of the table in percent after the insertion.
+ * Both maps are sized for the same number of pairs: the legacy map gets one slot per pair, the
+ * bucketed map rounds up to whole buckets.
+ */
+template <bool kBucketed, bool kInsert>
+void BM_HashTable(benchmark::State& state) {
+  const size_t num_keys = state.range(0);
+  const size_t num_slots = num_keys * 100 / state.range(1);
+  constexpr unsigned int block_size = 256;
+
+  cudaStream_t stream;
+  HCTR_LIB_THROW(cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking));
+  {
+    DeviceArray<KeyType> d_keys(num_keys);
+    DeviceArray<ValType> d_vals(num_keys);
+    DeviceArray<size_t> d_counter(1);
+    d_keys.upload(shuffled_keys<KeyType>(num_keys));
+
+    std::unique_ptr<LegacyMap> legacy;
+    std::unique_ptr<BucketedMap> bucketed;
+    if constexpr (kBucketed) {
+      bucketed = std::make_unique<BucketedMap>(num_slots);
+    } else {
+      legacy = std::make_unique<LegacyMap>(num_slots, std::numeric_limits<ValType>::max());
+    }
+    auto get_insert = [&] {
+      if constexpr (kBucketed) {
+        bucketed->find_or_insert(d_keys.get(), d_vals.get(), num_keys, d_counter.get(), stream);
+      } else {
+        legacy_get_insert<<<(num_keys + block_size - 1) / block_size, block_size, 0, stream>>>(
+            legacy.get(), d_keys.get(), d_vals.get(), num_keys, d_counter.get());
+      }
+    };
+    auto clear = [&] {
+      HCTR_LIB_THROW(cudaMemsetAsync(d_counter.get(), 0, sizeof(size_t), stream));
+      if constexpr (kBucketed) {
+        bucketed->clear(stream);
+      } else {
+        legacy->clear_async(stream);
+      }
+    };
+
+    if constexpr (kInsert) {
+      // The table is cleared in every iteration, so that every key is inserted
+      run_on_stream(state, stream, [&] {
+        clear();
+        get_insert();
+      });
+    } else {
+      clear();
+      get_insert();
+      run_on_stream(state, stream, [&] {
+        if constexpr (kBucketed) {
+          bucketed->find(d_keys.get(), d_vals.get(), num_keys, stream);
+        } else {
+          legacy_find<<<(num_keys + block_size - 1) / block_size, block_size, 0, stream>>>(
+              legacy.get(), d_keys.get(), d_vals.get(), num_keys);
+        }
+      });
+    }
+    set_throughput(state, num_keys, num_keys * (sizeof(KeyType) + sizeof(ValType)));
+  }
+  HCTR_LIB_THROW(cudaStreamDestroy(stream));
+}
+
+void HashTableArgs(benchmark::internal::Benchmark* bench) {
+  bench->ArgNames({"keys", "load_pct"})
+      ->ArgsProduct({benchmark::CreateRange(1 << 16, 1 << 24, 16), {50, 75, 85}})
+      ->UseManualTime()
+      ->Unit(benchmark::kMicrosecond);
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_HashTable, false, true)->Name("BM_LegacyGetInsert")->Apply(HashTableArgs);
+BENCHMARK_TEMPLATE(BM_HashTable, true, true)->Name("BM_BucketedGetInsert")->Apply(HashTableArgs);
+BENCHMARK_TEMPLATE(BM_HashTable, false, false)->Name("BM_LegacyFind")->Apply(HashTableArgs);
+BENCHMARK_TEMPLATE(BM_HashTable, true, false)->Name("BM_BucketedFind")->Apply(HashTableArgs);
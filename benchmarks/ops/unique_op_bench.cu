@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <bench_utils.hpp>
+#include <hps/unique_op/unique_op.hpp>
+#include <limits>
+
+namespace {
+
+using namespace HugeCTR::bench;
+
+using KeyType = long long;
+using UniqueOp =
+    HugeCTR::unique_op::unique_op<KeyType, uint64_t, std::numeric_limits<KeyType>::max(),
+                                  std::numeric_limits<uint64_t>::max()>;
+
+/**
+ * Arguments: number of keys, percentage of distinct keys.
+ * The op is cleared after every call, like the embedding cache does between lookups.
+ */
+void BM_UniqueOp(benchmark::State& state) {
+  const size_t num_keys = state.range(0);
+  const size_t num_distinct = std::max<size_t>(num_keys * state.range(1) / 100, 1);
+
+  cudaStream_t stream;
+  HCTR_LIB_THROW(cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking));
+  {
+    // Sized like the embedding cache sizes its unique op
+    UniqueOp op(static_cast<size_t>(num_keys / UNIQUE_OP_LOAD_FACTOR));
+    DeviceArray<KeyType> d_keys(num_keys);
+    DeviceArray<uint64_t> d_output_index(num_keys);
+    DeviceArray<KeyType> d_unique_keys(num_keys);
+    DeviceArray<size_t> d_output_counter(1);
+    d_keys.upload(random_keys<KeyType>(num_keys, num_distinct));
+
+    run_on_stream(state, stream, [&] {
+      op.unique(d_keys.get(), num_keys, d_output_index.get(), d_unique_keys.get(),
+                d_output_counter.get(), stream);
+      op.clear(stream);
+    });
+    set_throughput(state, num_keys, num_keys * (2 * sizeof(KeyType) + sizeof(uint64_t)));
+  }
+  HCTR_LIB_THROW(cudaStreamDestroy(stream));
+}
+
+}  // namespace
+
+BENCHMARK(BM_UniqueOp)
+    ->ArgNames({"keys", "distinct_pct"})
+    ->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 22, 16), {1, 10, 100}})
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
@@ -47,6 +47,9 @@ class gpu_cache_api {
   // Dump API, i.e. dump some slabsets' keys from the cache
   virtual void Dump(key_type* d_keys, size_t* d_dump_counter, const size_t start_set_index,
                     const size_t end_set_index, cudaStream_t stream) = 0;
+
+  // Number of entries evicted by Replace because their slabset was fully occupied (if supported)
+  virtual size_t ConflictEvictions(cudaStream_t stream) { return 0; }
 };
 
 }  // namespace gpu_cache
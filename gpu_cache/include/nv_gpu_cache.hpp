@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <cuda_bf16.h>
 #include <nv_util.h>
 
 #include <cstdio>
@@ -45,17 +46,39 @@ struct slab_set {
   static_slab<key_type, warp_size> set_[set_associativity];
 };
 
+// CUDA IPC handles of the device memory of a gpu_cache, so that other processes on the same GPU
+// can attach to the cache instead of allocating their own
+struct gpu_cache_ipc_handles {
+  cudaIpcMemHandle_t keys;
+  cudaIpcMemHandle_t vals;
+  cudaIpcMemHandle_t quant_scales;
+  cudaIpcMemHandle_t slot_counter;
+  cudaIpcMemHandle_t conflict_evictions;
+  cudaIpcMemHandle_t global_counter;
+  cudaIpcMemHandle_t set_mutex;
+  size_t capacity_in_set;
+  size_t embedding_vec_size;
+  bool has_quant_scales;
+};
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 // GPU Cache
+// The embedding vectors are exchanged as float, but can be stored as value_type (float, __half,
+// __nv_bfloat16 or __nv_fp8_e4m3) to fit more slots into the same amount of device memory. FP8
+// vectors are kept with a per-vector scale. Reduced precision storage requires libcu++.
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
           int warp_size, typename set_hasher = MurmurHash3_32<key_type>,
-          typename slab_hasher = Mod_Hash<key_type, size_t>>
+          typename slab_hasher = Mod_Hash<key_type, size_t>, typename value_type = float>
 class gpu_cache : public gpu_cache_api<key_type> {
  public:
   // Ctor
   gpu_cache(const size_t capacity_in_set, const size_t embedding_vec_size);
 
+  // Ctor, attaches to the cache exported by another process. The attached cache shares the slots,
+  // counters and set locks of the exporting cache, which must outlive it.
+  explicit gpu_cache(const gpu_cache_ipc_handles& handles);
+
   // Dtor
   ~gpu_cache();
 
@@ -76,6 +99,12 @@ class gpu_cache : public gpu_cache_api<key_type> {
   void Dump(key_type* d_keys, size_t* d_dump_counter, const size_t start_set_index,
             const size_t end_set_index, cudaStream_t stream) override;
 
+  // Number of Replace evictions that were caused by a fully occupied slabset
+  size_t ConflictEvictions(cudaStream_t stream) override;
+
+  // Export the device memory of the cache to other processes on the same GPU
+  gpu_cache_ipc_handles ExportIpcHandles() const;
+
  public:
   using slabset = slab_set<set_associativity, key_type, warp_size>;
 #ifdef LIBCUDACXX_VERSION
@@ -88,8 +117,11 @@ class gpu_cache : public gpu_cache_api<key_type> {
 
   // Cache data
   slabset* keys_;
-  float* vals_;
+  value_type* vals_;
+  // Per-slot dequantization scales (FP8 value types only)
+  float* quant_scales_;
   ref_counter_type* slot_counter_;
+  size_t* conflict_evictions_;
 
   // Global counter
 #ifdef LIBCUDACXX_VERSION
@@ -107,6 +139,9 @@ class gpu_cache : public gpu_cache_api<key_type> {
   // Embedding vector size
   size_t embedding_vec_size_;
 
+  // Whether the device memory is owned by this cache, or attached from another process
+  bool owner_ = true;
+
 #ifdef LIBCUDACXX_VERSION
   // Array of mutex to protect (sub-)warp-level data structure, each mutex protect 1 slab set
   mutex* set_mutex_;
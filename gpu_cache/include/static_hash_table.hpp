@@ -61,6 +61,14 @@ class StaticHashTable {
   void insert(const key_type *keys, const value_type *values, size_type num_keys,
               cudaStream_t stream = 0, const float *quant_scales = nullptr);
 
+  // Replaces the content with a table hashed ahead of time in the layout of this one: num_slots + 1
+  // keys and indices, the last pair holding the empty key, and the values in index order. The
+  // arrays can be in host or device memory. Returns false, leaving the table untouched, if the
+  // layout does not match: group_size 16, MurmurHash3_32, num_slots == key_capacity() and
+  // num_values <= capacity().
+  bool load(const key_type *keys, const size_type *indices, int64_t num_slots,
+            const value_type *values, size_type num_values, cudaStream_t stream = 0);
+
   void lookup(const key_type *keys, out_value_type *values, int num_keys,
               out_value_type default_value = 0, cudaStream_t stream = 0);
 
@@ -75,7 +83,11 @@ class StaticHashTable {
   int value_dim_;
 
   int64_t size_;
+  // With enable_pagelock, the values are in host memory, read by the lookup kernel with zero-copy
+  // loads, while the keys and indices stay in device memory. The values are pinned, or allocated
+  // by the system on a coherent CPU-GPU link.
   bool enable_pagelock;
+  bool system_allocated_values_ = false;
   hasher hash_;
 };
 }  // namespace gpu_cache
\ No newline at end of file
@@ -19,8 +19,11 @@
 #include <cuda_fp8.h>
 #include <nv_util.h>
 
+#include <atomic>
 #include <cstdio>
 #include <limits>
+#include <memory>
+#include <shared_mutex>
 #include <static_hash_table.hpp>
 
 namespace gpu_cache {
@@ -35,7 +38,7 @@ class static_table {
                const out_value_type default_value = 0, bool enable_pagelock = false);
 
   // Dtor
-  ~static_table(){};
+  ~static_table();
 
   // Query API, i.e. A single read from the cache
   void Query(const key_type* d_keys, const size_t len, out_value_type* d_values,
@@ -50,8 +53,44 @@ class static_table {
 
   void Clear(cudaStream_t stream);
 
+  // Replaces the content with a table hashed ahead of time, see StaticHashTable::load(). Returns
+  // false if its layout does not match.
+  bool Load(const key_type* keys, const uint32_t* indices, const int64_t num_slots,
+            const value_type* values, const size_t len, cudaStream_t stream);
+
+  // Generation API, i.e. Build the next version of the table while the current one keeps serving
+  // queries. BeginGeneration() starts an empty shadow table, AddToGeneration() fills it on a
+  // low-priority stream, and CommitGeneration() makes it the table that serves all queries issued
+  // afterwards. Calls have to be serialized by the caller.
+  void BeginGeneration();
+
+  void AddToGeneration(const key_type* d_keys, const size_t len, const value_type* d_values,
+                       const float* d_quant_scales, cudaStream_t stream);
+
+  // Load() into the generation being built, in place of AddToGeneration().
+  bool LoadGeneration(const key_type* keys, const uint32_t* indices, const int64_t num_slots,
+                      const value_type* values, const size_t len, cudaStream_t stream);
+
+  void CommitGeneration(cudaStream_t stream);
+
  private:
-  StaticHashTable<key_type, value_type, out_value_type> static_hash_table_;
+  using hash_table_type = StaticHashTable<key_type, value_type, out_value_type>;
+
+  hash_table_type static_hash_table_;
+  // The table that serves queries. The other one (allocated on first use) receives the next
+  // generation.
+  std::atomic<hash_table_type*> active_table_;
+  std::unique_ptr<hash_table_type> shadow_hash_table_;
+  std::shared_mutex active_table_mutex_;
+  bool enable_pagelock_;
+
+  // Low-priority stream to build generations on. Queries wait for `ready_event_`, which is
+  // recorded at the commit of the generation that they read from.
+  cudaStream_t generation_stream_;
+  cudaEvent_t input_event_;
+  cudaEvent_t ready_event_;
+
+  hash_table_type* staged_table();
   // Embedding vector size
   size_t embedding_vec_size_;
   size_t table_size_;
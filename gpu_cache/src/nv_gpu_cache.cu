@@ -45,6 +45,64 @@ __forceinline__ __device__ void warp_tile_copy(const size_t lane_idx,
     d_dst[i] = d_src[i];
   }
 }
+
+// Largest magnitude representable by an FP8 value type
+template <typename value_type>
+__forceinline__ __device__ constexpr float fp8_max_value() {
+  return std::is_same<value_type, __nv_fp8_e5m2>::value ? 57344.f : 448.f;
+}
+
+// Read an embedding vector from the cache storage and convert it to float
+template <int warp_size, typename value_type>
+__forceinline__ __device__ void warp_tile_load(const size_t lane_idx,
+                                               const size_t emb_vec_size_in_float, float* d_dst,
+                                               const value_type* d_src, const float* quant_scales,
+                                               const size_t slot_index) {
+  if constexpr (nv::is_fp8<value_type>::value) {
+    const float scale = quant_scales[slot_index];
+#pragma unroll
+    for (size_t i = lane_idx; i < emb_vec_size_in_float; i += warp_size) {
+      d_dst[i] = float(d_src[i]) * scale;
+    }
+  } else {
+#pragma unroll
+    for (size_t i = lane_idx; i < emb_vec_size_in_float; i += warp_size) {
+      d_dst[i] = float(d_src[i]);
+    }
+  }
+}
+
+// Write a float embedding vector to the cache storage. FP8 vectors are stored together with a
+// per-vector scale that maps their largest magnitude onto the largest representable value
+template <int warp_size, typename value_type>
+__forceinline__ __device__ void warp_tile_store(const cg::thread_block_tile<warp_size>& warp_tile,
+                                                const size_t lane_idx,
+                                                const size_t emb_vec_size_in_float,
+                                                value_type* d_dst, float* quant_scales,
+                                                const size_t slot_index, const float* d_src) {
+  if constexpr (nv::is_fp8<value_type>::value) {
+    float abs_max = 0.f;
+    for (size_t i = lane_idx; i < emb_vec_size_in_float; i += warp_size) {
+      abs_max = fmaxf(abs_max, fabsf(d_src[i]));
+    }
+    for (int offset = warp_size / 2; offset > 0; offset /= 2) {
+      abs_max = fmaxf(abs_max, warp_tile.shfl_xor(abs_max, offset));
+    }
+    const float scale = abs_max > 0.f ? abs_max / fp8_max_value<value_type>() : 1.f;
+    if (lane_idx == 0) {
+      quant_scales[slot_index] = scale;
+    }
+#pragma unroll
+    for (size_t i = lane_idx; i < emb_vec_size_in_float; i += warp_size) {
+      d_dst[i] = value_type(d_src[i] / scale);
+    }
+  } else {
+#pragma unroll
+    for (size_t i = lane_idx; i < emb_vec_size_in_float; i += warp_size) {
+      d_dst[i] = value_type(d_src[i]);
+    }
+  }
+}
 #else
 template <int warp_size>
 __forceinline__ __device__ void warp_tile_copy(const size_t lane_idx,
@@ -83,6 +141,86 @@ __forceinline__ __device__ void warp_unlock_mutex(const cg::thread_block_tile<wa
     set_mutex.release();
   }
 }
+
+// Replace does not lock the slabset. Instead, a (sub-)warp claims the slot that it writes by
+// setting the busy flag of the slot counter through CAS. Readers and other writers skip busy
+// slots. On release, the slot counter receives a new, unique access time (epoch), so readers can
+// detect that a slot has been rewritten while they were copying its value.
+template <typename ref_counter_type>
+__forceinline__ __device__ constexpr ref_counter_type slot_busy_flag() {
+  return ref_counter_type{1} << (sizeof(ref_counter_type) * 8 - 1);
+}
+
+template <typename ref_counter_type>
+__forceinline__ __device__ ref_counter_type load_slot_counter(ref_counter_type* slot_counter) {
+  const ref_counter_type val = *reinterpret_cast<volatile ref_counter_type*>(slot_counter);
+  __threadfence();
+  return val;
+}
+
+template <typename key_type>
+__forceinline__ __device__ key_type load_slot_key(const key_type* slot_key) {
+  return *reinterpret_cast<const volatile key_type*>(slot_key);
+}
+
+// Atomically replace the slot counter if nobody modified it since it was read as expected_val
+template <typename ref_counter_type>
+__forceinline__ __device__ bool cas_slot_counter(ref_counter_type* slot_counter,
+                                                 const ref_counter_type expected_val,
+                                                 const ref_counter_type new_val) {
+  static_assert(sizeof(ref_counter_type) == sizeof(unsigned long long),
+                "The lock-free replacement requires a 64-bit ref_counter_type.");
+  return atomicCAS(reinterpret_cast<unsigned long long*>(slot_counter),
+                   static_cast<unsigned long long>(expected_val),
+                   static_cast<unsigned long long>(new_val)) ==
+         static_cast<unsigned long long>(expected_val);
+}
+
+// Try to claim a slot whose counter has been read as expected_val
+template <typename ref_counter_type>
+__forceinline__ __device__ bool try_claim_slot(ref_counter_type* slot_counter,
+                                               const ref_counter_type expected_val) {
+  if (expected_val & slot_busy_flag<ref_counter_type>()) {
+    return false;
+  }
+  return cas_slot_counter(slot_counter, expected_val,
+                          expected_val | slot_busy_flag<ref_counter_type>());
+}
+
+// Claim a slot, waiting for concurrent writers to finish. Returns the previous slot counter
+template <typename ref_counter_type>
+__forceinline__ __device__ ref_counter_type claim_slot(ref_counter_type* slot_counter) {
+  ref_counter_type val;
+  do {
+    val = load_slot_counter(slot_counter);
+  } while (!try_claim_slot(slot_counter, val));
+  return val;
+}
+
+// Publish the writes to a claimed slot and clear its busy flag
+template <typename ref_counter_type>
+__forceinline__ __device__ void release_slot(ref_counter_type* slot_counter,
+                                             const ref_counter_type new_val) {
+  __threadfence();
+  atomicExch(reinterpret_cast<unsigned long long*>(slot_counter),
+             static_cast<unsigned long long>(new_val));
+}
+
+// Check whether any slot of the slabset other than (own_slab, own_slot) holds the key. Writers
+// store the key into their claimed slot before checking, so out of two (sub-)warps that insert
+// the same key concurrently, at least one will see the other
+template <typename key_type, typename slabset, int set_associativity, int warp_size>
+__forceinline__ __device__ bool warp_find_duplicate(
+    const cg::thread_block_tile<warp_size>& warp_tile, slabset* keys, const size_t set,
+    const key_type key, const size_t own_slab, const size_t own_slot) {
+  const size_t lane_idx = warp_tile.thread_rank();
+  bool found = false;
+  for (size_t slab = 0; slab < set_associativity; slab++) {
+    const key_type read_key = load_slot_key(&keys[set].set_[slab].slab_[lane_idx]);
+    found |= read_key == key && (slab != own_slab || lane_idx != own_slot);
+  }
+  return warp_tile.ballot(found) != 0;
+}
 #else
 // Will be called by multiple thread_block_tile((sub-)warp) on the same mutex
 // Expect only one thread_block_tile return to execute critical section at any time
@@ -243,13 +381,14 @@ __global__ void update_kernel_overflow_ignore(ref_counter_type* global_counter,
 // Also update locality information for touched slot
 template <typename key_type, typename ref_counter_type, typename atomic_ref_counter_type,
           typename slabset, typename set_hasher, typename slab_hasher, typename mutex,
-          key_type empty_key, int set_associativity, int warp_size>
+          key_type empty_key, int set_associativity, int warp_size, typename value_type>
 __global__ void get_kernel(const key_type* d_keys, const size_t len, float* d_values,
                            const size_t embedding_vec_size, uint64_t* d_missing_index,
                            key_type* d_missing_keys, size_t* d_missing_len,
                            const atomic_ref_counter_type* global_counter,
                            ref_counter_type* slot_counter, const size_t capacity_in_set,
-                           const slabset* keys, const float* vals, mutex* set_mutex,
+                           const slabset* keys, const value_type* vals,
+                           const float* quant_scales, mutex* set_mutex,
                            const size_t task_per_warp_tile) {
   // Lane(thread) ID within a warp_tile
   cg::thread_block_tile<warp_size> warp_tile =
@@ -324,7 +463,7 @@ __global__ void get_kernel(const key_type* d_keys, const size_t len, float* d_va
       }
 
       // The warp_tile read out the slab
-      key_type read_key = keys[next_set].set_[next_slab].slab_[lane_idx];
+      key_type read_key = load_slot_key(&keys[next_set].set_[next_slab].slab_[lane_idx]);
 
       // Compare the slab data with the target key
       int found_lane = __ffs(warp_tile.ballot(read_key == next_key)) - 1;
@@ -332,14 +471,47 @@ __global__ void get_kernel(const key_type* d_keys, const size_t len, float* d_va
       // If found, mark hit task, copy the founded data, the task is completed
       if (found_lane >= 0) {
         size_t found_offset = (next_set * set_associativity + next_slab) * warp_size + found_lane;
+
+        // Replace may rewrite the slot concurrently. The copy is only valid if the slot was not
+        // busy before and its counter did not change while copying
+        ref_counter_type slot_counter_val;
+        bool valid;
         if (lane_idx == (size_t)next_lane) {
-          slot_counter[found_offset] = global_counter->load(cuda::std::memory_order_relaxed);
-          active = false;
+          slot_counter_val = load_slot_counter(slot_counter + found_offset);
+          valid = !(slot_counter_val & slot_busy_flag<ref_counter_type>()) &&
+                  load_slot_key(&keys[next_set].set_[next_slab].slab_[found_lane]) == next_key;
+        }
+        valid = warp_tile.shfl(valid, next_lane);
+
+        if (valid) {
+          warp_tile_load<warp_size>(lane_idx, embedding_vec_size,
+                                    d_values + next_idx * embedding_vec_size,
+                                    vals + found_offset * embedding_vec_size, quant_scales,
+                                    found_offset);
+          __threadfence();
+          warp_tile.sync();
+
+          // Refresh the slot, which also validates the copy
+          if (lane_idx == (size_t)next_lane) {
+            const ref_counter_type now = global_counter->load(cuda::std::memory_order_relaxed);
+            valid = cas_slot_counter(slot_counter + found_offset, slot_counter_val,
+                                     now > slot_counter_val ? now : slot_counter_val);
+          }
+          valid = warp_tile.shfl(valid, next_lane);
         }
 
-        warp_tile_copy<warp_size>(lane_idx, embedding_vec_size,
-                                  d_values + next_idx * embedding_vec_size,
-                                  vals + found_offset * embedding_vec_size);
+        // The slot has been replaced in the meantime, report the key as missing
+        if (!valid) {
+          if (lane_idx == warp_missing_counter) {
+            missing_key = next_key;
+            missing_index = next_idx;
+          }
+          warp_missing_counter++;
+        }
+
+        if (lane_idx == (size_t)next_lane) {
+          active = false;
+        }
 
         active_mask = warp_tile.ballot(active);
         break;
@@ -533,17 +705,20 @@ __global__ void get_kernel(const key_type* d_keys, const size_t len, float* d_va
 
 #ifdef LIBCUDACXX_VERSION
 // Kernel to insert or replace the <k,v> pairs into the cache
-template <typename key_type, typename slabset, typename ref_counter_type, typename mutex,
+// Lock-free: each (sub-)warp claims the slot that it writes through CAS on the slot counter, so
+// replacements into the same slabset from different (sub-)warps do not serialize. If the claim
+// fails, the probing of the slabset starts over
+template <typename key_type, typename slabset, typename ref_counter_type,
           typename atomic_ref_counter_type, typename set_hasher, typename slab_hasher,
           key_type empty_key, int set_associativity, int warp_size,
           ref_counter_type max_ref_counter_type = std::numeric_limits<ref_counter_type>::max(),
-          size_t max_slab_distance = std::numeric_limits<size_t>::max()>
+          size_t max_slab_distance = std::numeric_limits<size_t>::max(), typename value_type>
 __global__ void insert_replace_kernel(const key_type* d_keys, const float* d_values,
                                       const size_t embedding_vec_size, const size_t len,
-                                      slabset* keys, float* vals, ref_counter_type* slot_counter,
-                                      mutex* set_mutex,
-                                      const atomic_ref_counter_type* global_counter,
-                                      const size_t capacity_in_set,
+                                      slabset* keys, value_type* vals, float* quant_scales,
+                                      ref_counter_type* slot_counter,
+                                      atomic_ref_counter_type* global_counter,
+                                      size_t* conflict_evictions, const size_t capacity_in_set,
                                       const size_t task_per_warp_tile) {
   // Lane(thread) ID within a warp_tile
   cg::thread_block_tile<warp_size> warp_tile =
@@ -582,7 +757,7 @@ __global__ void insert_replace_kernel(const key_type* d_keys, const float* d_val
     size_t next_idx = warp_tile.shfl(key_idx, next_lane);
     size_t next_set = warp_tile.shfl(src_set, next_lane);
     size_t next_slab = warp_tile.shfl(src_slab, next_lane);
-    size_t first_slab = next_slab;
+    const size_t first_slab = next_slab;
 
     // Counter to record how many slab have been searched
     size_t counter = 0;
@@ -596,8 +771,13 @@ __global__ void insert_replace_kernel(const key_type* d_keys, const float* d_val
     // Working queue before task started
     const unsigned old_active_mask = active_mask;
 
-    // Lock the slabset before operating the slabset
-    warp_lock_mutex<mutex, warp_size>(warp_tile, set_mutex[next_set]);
+    // Another (sub-)warp won the race for a slot. Probe the slabset again
+    auto restart = [&]() {
+      counter = 0;
+      next_slab = first_slab;
+      min_slot_counter_val = max_ref_counter_type;
+      slab_distance = max_slab_distance;
+    };
 
     // The warp-level inner loop: finish a single task in the work queue
     while (active_mask == old_active_mask) {
@@ -613,18 +793,53 @@ __global__ void insert_replace_kernel(const key_type* d_keys, const float* d_val
         size_t slot_index =
             (next_set * set_associativity + target_slab) * warp_size + slot_distance;
 
+        // Claim the LR slot (fails if all slots are busy or the LR slot changed meanwhile)
+        bool claimed;
+        if (lane_idx == (size_t)next_lane) {
+          claimed = try_claim_slot(slot_counter + slot_index, min_slot_counter_val);
+        }
+        claimed = warp_tile.shfl(claimed, next_lane);
+        if (!claimed) {
+          restart();
+          continue;
+        }
+
         // Replace the LR slot
+        key_type evicted_key;
         if (lane_idx == (size_t)next_lane) {
+          evicted_key = keys[next_set].set_[target_slab].slab_[slot_distance];
           keys[next_set].set_[target_slab].slab_[slot_distance] = key;
-          slot_counter[slot_index] = global_counter->load(cuda::std::memory_order_relaxed);
+          __threadfence();
+        }
+        warp_tile.sync();
+
+        // Another (sub-)warp inserted the same key concurrently, undo the replacement
+        if (warp_find_duplicate<key_type, slabset, set_associativity, warp_size>(
+                warp_tile, keys, next_set, next_key, target_slab, slot_distance)) {
+          if (lane_idx == (size_t)next_lane) {
+            keys[next_set].set_[target_slab].slab_[slot_distance] = evicted_key;
+            release_slot(slot_counter + slot_index, min_slot_counter_val);
+            active = false;
+          }
+
+          active_mask = warp_tile.ballot(active);
+          break;
         }
 
-        warp_tile_copy<warp_size>(lane_idx, embedding_vec_size,
-                                  vals + slot_index * embedding_vec_size,
-                                  d_values + next_idx * embedding_vec_size);
+        if (lane_idx == (size_t)next_lane) {
+          atomicAdd(conflict_evictions, 1);
+        }
 
-        // Replace complete, mark this task completed
+        warp_tile_store<warp_size>(warp_tile, lane_idx, embedding_vec_size,
+                                   vals + slot_index * embedding_vec_size, quant_scales,
+                                   slot_index, d_values + next_idx * embedding_vec_size);
+        __threadfence();
+        warp_tile.sync();
+
+        // Replace complete, publish the slot with a new epoch, mark this task completed
         if (lane_idx == (size_t)next_lane) {
+          release_slot(slot_counter + slot_index,
+                       global_counter->fetch_add(1, cuda::std::memory_order_relaxed) + 1);
           active = false;
         }
 
@@ -633,17 +848,21 @@ __global__ void insert_replace_kernel(const key_type* d_keys, const float* d_val
       }
 
       // The warp_tile read out the slab
-      key_type read_key = keys[next_set].set_[next_slab].slab_[lane_idx];
+      key_type read_key = load_slot_key(&keys[next_set].set_[next_slab].slab_[lane_idx]);
 
       // Compare the slab data with the target key
       int found_lane = __ffs(warp_tile.ballot(read_key == next_key)) - 1;
 
       // If found target key, the insertion/replace is no longer needed.
-      // Refresh the slot, the task is completed
+      // Refresh the slot (best effort), the task is completed
       if (found_lane >= 0) {
         size_t found_offset = (next_set * set_associativity + next_slab) * warp_size + found_lane;
         if (lane_idx == (size_t)next_lane) {
-          slot_counter[found_offset] = global_counter->load(cuda::std::memory_order_relaxed);
+          const ref_counter_type slot_counter_val = load_slot_counter(slot_counter + found_offset);
+          const ref_counter_type now = global_counter->load(cuda::std::memory_order_relaxed);
+          if (!(slot_counter_val & slot_busy_flag<ref_counter_type>()) && now > slot_counter_val) {
+            cas_slot_counter(slot_counter + found_offset, slot_counter_val, now);
+          }
           active = false;
         }
 
@@ -652,21 +871,55 @@ __global__ void insert_replace_kernel(const key_type* d_keys, const float* d_val
       }
 
       // Compare the slab data with empty key.
-      // If found empty key, do insertion,the task is complete
+      // If found empty key, claim the slot and do insertion, the task is complete
       found_lane = __ffs(warp_tile.ballot(read_key == empty_key)) - 1;
       if (found_lane >= 0) {
         size_t found_offset = (next_set * set_associativity + next_slab) * warp_size + found_lane;
 
+        ref_counter_type slot_counter_val;
+        bool claimed;
         if (lane_idx == (size_t)next_lane) {
-          keys[next_set].set_[next_slab].slab_[found_lane] = key;
-          slot_counter[found_offset] = global_counter->load(cuda::std::memory_order_relaxed);
+          slot_counter_val = load_slot_counter(slot_counter + found_offset);
+          claimed = try_claim_slot(slot_counter + found_offset, slot_counter_val);
+          // Another (sub-)warp filled the slot before we could claim it
+          if (claimed &&
+              load_slot_key(&keys[next_set].set_[next_slab].slab_[found_lane]) != empty_key) {
+            release_slot(slot_counter + found_offset, slot_counter_val);
+            claimed = false;
+          }
+          if (claimed) {
+            keys[next_set].set_[next_slab].slab_[found_lane] = key;
+            __threadfence();
+          }
+        }
+        claimed = warp_tile.shfl(claimed, next_lane);
+        if (!claimed) {
+          restart();
+          continue;
         }
 
-        warp_tile_copy<warp_size>(lane_idx, embedding_vec_size,
-                                  vals + found_offset * embedding_vec_size,
-                                  d_values + next_idx * embedding_vec_size);
+        // Another (sub-)warp inserted the same key concurrently, undo the insertion
+        if (warp_find_duplicate<key_type, slabset, set_associativity, warp_size>(
+                warp_tile, keys, next_set, next_key, next_slab, found_lane)) {
+          if (lane_idx == (size_t)next_lane) {
+            keys[next_set].set_[next_slab].slab_[found_lane] = empty_key;
+            release_slot(slot_counter + found_offset, slot_counter_val);
+            active = false;
+          }
+
+          active_mask = warp_tile.ballot(active);
+          break;
+        }
+
+        warp_tile_store<warp_size>(warp_tile, lane_idx, embedding_vec_size,
+                                   vals + found_offset * embedding_vec_size, quant_scales,
+                                   found_offset, d_values + next_idx * embedding_vec_size);
+        __threadfence();
+        warp_tile.sync();
 
         if (lane_idx == (size_t)next_lane) {
+          release_slot(slot_counter + found_offset,
+                       global_counter->fetch_add(1, cuda::std::memory_order_relaxed) + 1);
           active = false;
         }
 
@@ -676,8 +929,8 @@ __global__ void insert_replace_kernel(const key_type* d_keys, const float* d_val
 
       // If no target or unused slot found in this slab,
       // Refresh LR info, continue probing
-      ref_counter_type read_slot_counter =
-          slot_counter[(next_set * set_associativity + next_slab) * warp_size + lane_idx];
+      ref_counter_type read_slot_counter = load_slot_counter(
+          slot_counter + (next_set * set_associativity + next_slab) * warp_size + lane_idx);
       if (read_slot_counter < min_slot_counter_val) {
         min_slot_counter_val = read_slot_counter;
         slab_distance = counter;
@@ -686,9 +939,6 @@ __global__ void insert_replace_kernel(const key_type* d_keys, const float* d_val
       counter++;
       next_slab = (next_slab + 1) % set_associativity;
     }
-
-    // Unlock the slabset after operating the slabset
-    warp_unlock_mutex<mutex, warp_size>(warp_tile, set_mutex[next_set]);
   }
 }
 #else
@@ -702,7 +952,7 @@ __global__ void insert_replace_kernel(const key_type* d_keys, const float* d_val
                                       volatile slabset* keys, volatile float* vals,
                                       volatile ref_counter_type* slot_counter,
                                       volatile int* set_mutex, ref_counter_type* global_counter,
-                                      const size_t capacity_in_set,
+                                      size_t* conflict_evictions, const size_t capacity_in_set,
                                       const size_t task_per_warp_tile) {
   // Lane(thread) ID within a warp_tile
   cg::thread_block_tile<warp_size> warp_tile =
@@ -776,6 +1026,7 @@ __global__ void insert_replace_kernel(const key_type* d_keys, const float* d_val
         if (lane_idx == (size_t)next_lane) {
           ((volatile key_type*)(keys[next_set].set_[target_slab].slab_))[slot_distance] = key;
           slot_counter[slot_index] = atomicAdd(global_counter, 0);
+          atomicAdd(conflict_evictions, 1);
         }
 
         warp_tile_copy<warp_size>(lane_idx, embedding_vec_size,
@@ -856,10 +1107,12 @@ __global__ void insert_replace_kernel(const key_type* d_keys, const float* d_val
 // Kernel to update the existing keys in the cache
 // Will not change the locality information
 template <typename key_type, typename slabset, typename set_hasher, typename slab_hasher,
-          typename mutex, key_type empty_key, int set_associativity, int warp_size>
+          typename mutex, typename ref_counter_type, key_type empty_key, int set_associativity,
+          int warp_size, typename value_type>
 __global__ void update_kernel(const key_type* d_keys, const size_t len, const float* d_values,
                               const size_t embedding_vec_size, const size_t capacity_in_set,
-                              const slabset* keys, float* vals, mutex* set_mutex,
+                              slabset* keys, value_type* vals, float* quant_scales,
+                              ref_counter_type* slot_counter, mutex* set_mutex,
                               const size_t task_per_warp_tile) {
   // Lane(thread) ID within a warp_tile
   cg::thread_block_tile<warp_size> warp_tile =
@@ -922,7 +1175,7 @@ __global__ void update_kernel(const key_type* d_keys, const size_t len, const fl
       }
 
       // The warp_tile read out the slab
-      key_type read_key = keys[next_set].set_[next_slab].slab_[lane_idx];
+      key_type read_key = load_slot_key(&keys[next_set].set_[next_slab].slab_[lane_idx]);
 
       // Compare the slab data with the target key
       int found_lane = __ffs(warp_tile.ballot(read_key == next_key)) - 1;
@@ -930,13 +1183,35 @@ __global__ void update_kernel(const key_type* d_keys, const size_t len, const fl
       // If found, mark hit task, update the value, the task is completed
       if (found_lane >= 0) {
         size_t found_offset = (next_set * set_associativity + next_slab) * warp_size + found_lane;
+
+        // Replace does not hold the set mutex. Claim the slot, so that it is neither evicted nor
+        // read while being updated
+        ref_counter_type slot_counter_val;
+        bool claimed;
         if (lane_idx == (size_t)next_lane) {
-          active = false;
+          slot_counter_val = claim_slot(slot_counter + found_offset);
+          claimed = load_slot_key(&keys[next_set].set_[next_slab].slab_[found_lane]) == next_key;
+          if (!claimed) {
+            release_slot(slot_counter + found_offset, slot_counter_val);
+          }
+        }
+        claimed = warp_tile.shfl(claimed, next_lane);
+
+        // The key has been evicted before the slot could be claimed, the task is completed
+        if (claimed) {
+          warp_tile_store<warp_size>(warp_tile, lane_idx, embedding_vec_size,
+                                     vals + found_offset * embedding_vec_size, quant_scales,
+                                     found_offset, d_values + next_idx * embedding_vec_size);
+          __threadfence();
+          warp_tile.sync();
+          if (lane_idx == (size_t)next_lane) {
+            release_slot(slot_counter + found_offset, slot_counter_val);
+          }
         }
 
-        warp_tile_copy<warp_size>(lane_idx, embedding_vec_size,
-                                  vals + found_offset * embedding_vec_size,
-                                  d_values + next_idx * embedding_vec_size);
+        if (lane_idx == (size_t)next_lane) {
+          active = false;
+        }
 
         active_mask = warp_tile.ballot(active);
         break;
@@ -1229,9 +1504,10 @@ __global__ void dump_kernel(key_type* d_keys, size_t* d_dump_counter, volatile s
 
 #ifdef LIBCUDACXX_VERSION
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
-          int warp_size, typename set_hasher, typename slab_hasher>
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
 gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
-          slab_hasher>::gpu_cache(const size_t capacity_in_set, const size_t embedding_vec_size)
+          slab_hasher, value_type>::gpu_cache(const size_t capacity_in_set,
+                                              const size_t embedding_vec_size)
     : capacity_in_set_(capacity_in_set), embedding_vec_size_(embedding_vec_size) {
   // Check parameter
   if (capacity_in_set_ == 0) {
@@ -1260,8 +1536,14 @@ gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, s
 
   // Allocate GPU memory for cache
   CUDA_CHECK(cudaMalloc((void**)&keys_, sizeof(slabset) * capacity_in_set_));
-  CUDA_CHECK(cudaMalloc((void**)&vals_, sizeof(float) * embedding_vec_size_ * num_slot_));
+  CUDA_CHECK(cudaMalloc((void**)&vals_, sizeof(value_type) * embedding_vec_size_ * num_slot_));
+  quant_scales_ = nullptr;
+  if (nv::is_fp8<value_type>::value) {
+    CUDA_CHECK(cudaMalloc((void**)&quant_scales_, sizeof(float) * num_slot_));
+  }
   CUDA_CHECK(cudaMalloc((void**)&slot_counter_, sizeof(ref_counter_type) * num_slot_));
+  CUDA_CHECK(cudaMalloc((void**)&conflict_evictions_, sizeof(size_t)));
+  CUDA_CHECK(cudaMemset(conflict_evictions_, 0, sizeof(size_t)));
   CUDA_CHECK(cudaMalloc((void**)&global_counter_, sizeof(atomic_ref_counter_type)));
 
   // Allocate GPU memory for set mutex
@@ -1277,10 +1559,13 @@ gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, s
 }
 #else
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
-          int warp_size, typename set_hasher, typename slab_hasher>
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
 gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
-          slab_hasher>::gpu_cache(const size_t capacity_in_set, const size_t embedding_vec_size)
+          slab_hasher, value_type>::gpu_cache(const size_t capacity_in_set,
+                                              const size_t embedding_vec_size)
     : capacity_in_set_(capacity_in_set), embedding_vec_size_(embedding_vec_size) {
+  static_assert(std::is_same<value_type, float>::value,
+                "Reduced precision value storage requires libcu++.");
   // Check parameter
   if (capacity_in_set_ == 0) {
     printf("Error: Invalid value for capacity_in_set.\n");
@@ -1308,8 +1593,11 @@ gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, s
 
   // Allocate GPU memory for cache
   CUDA_CHECK(cudaMalloc((void**)&keys_, sizeof(slabset) * capacity_in_set_));
-  CUDA_CHECK(cudaMalloc((void**)&vals_, sizeof(float) * embedding_vec_size_ * num_slot_));
+  CUDA_CHECK(cudaMalloc((void**)&vals_, sizeof(value_type) * embedding_vec_size_ * num_slot_));
+  quant_scales_ = nullptr;
   CUDA_CHECK(cudaMalloc((void**)&slot_counter_, sizeof(ref_counter_type) * num_slot_));
+  CUDA_CHECK(cudaMalloc((void**)&conflict_evictions_, sizeof(size_t)));
+  CUDA_CHECK(cudaMemset(conflict_evictions_, 0, sizeof(size_t)));
   CUDA_CHECK(cudaMalloc((void**)&global_counter_, sizeof(ref_counter_type)));
 
   // Allocate GPU memory for set mutex
@@ -1325,17 +1613,79 @@ gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, s
 }
 #endif
 
+template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
+gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
+          slab_hasher, value_type>::gpu_cache(const gpu_cache_ipc_handles& handles)
+    : capacity_in_set_(handles.capacity_in_set),
+      embedding_vec_size_(handles.embedding_vec_size),
+      owner_(false) {
+  // Get the current CUDA dev
+  CUDA_CHECK(cudaGetDevice(&dev_));
+
+  // Calculate # of slot
+  num_slot_ = capacity_in_set_ * set_associativity * warp_size;
+
+  // Map the GPU memory of the exporting cache. The cache is already initialized by its owner.
+  const unsigned int flags = cudaIpcMemLazyEnablePeerAccess;
+  CUDA_CHECK(cudaIpcOpenMemHandle((void**)&keys_, handles.keys, flags));
+  CUDA_CHECK(cudaIpcOpenMemHandle((void**)&vals_, handles.vals, flags));
+  quant_scales_ = nullptr;
+  if (handles.has_quant_scales) {
+    CUDA_CHECK(cudaIpcOpenMemHandle((void**)&quant_scales_, handles.quant_scales, flags));
+  }
+  CUDA_CHECK(cudaIpcOpenMemHandle((void**)&slot_counter_, handles.slot_counter, flags));
+  CUDA_CHECK(cudaIpcOpenMemHandle((void**)&conflict_evictions_, handles.conflict_evictions, flags));
+  CUDA_CHECK(cudaIpcOpenMemHandle((void**)&global_counter_, handles.global_counter, flags));
+  CUDA_CHECK(cudaIpcOpenMemHandle((void**)&set_mutex_, handles.set_mutex, flags));
+}
+
+template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
+gpu_cache_ipc_handles gpu_cache<key_type, ref_counter_type, empty_key, set_associativity,
+                                warp_size, set_hasher, slab_hasher,
+                                value_type>::ExportIpcHandles() const {
+  gpu_cache_ipc_handles handles{};
+  CUDA_CHECK(cudaIpcGetMemHandle(&handles.keys, keys_));
+  CUDA_CHECK(cudaIpcGetMemHandle(&handles.vals, vals_));
+  if (quant_scales_) {
+    CUDA_CHECK(cudaIpcGetMemHandle(&handles.quant_scales, quant_scales_));
+  }
+  CUDA_CHECK(cudaIpcGetMemHandle(&handles.slot_counter, slot_counter_));
+  CUDA_CHECK(cudaIpcGetMemHandle(&handles.conflict_evictions, conflict_evictions_));
+  CUDA_CHECK(cudaIpcGetMemHandle(&handles.global_counter, global_counter_));
+  CUDA_CHECK(cudaIpcGetMemHandle(&handles.set_mutex, set_mutex_));
+  handles.capacity_in_set = capacity_in_set_;
+  handles.embedding_vec_size = embedding_vec_size_;
+  handles.has_quant_scales = quant_scales_ != nullptr;
+  return handles;
+}
+
 #ifdef LIBCUDACXX_VERSION
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
-          int warp_size, typename set_hasher, typename slab_hasher>
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
 gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
-          slab_hasher>::~gpu_cache() {
+          slab_hasher, value_type>::~gpu_cache() {
   // Device Restorer
   nv::CudaDeviceRestorer dev_restorer;
 
   // Check device
   dev_restorer.check_device(dev_);
 
+  // Unmap the GPU memory of an attached cache, its owner destructs and frees it
+  if (!owner_) {
+    CUDA_CHECK(cudaIpcCloseMemHandle(keys_));
+    CUDA_CHECK(cudaIpcCloseMemHandle(vals_));
+    if (quant_scales_) {
+      CUDA_CHECK(cudaIpcCloseMemHandle(quant_scales_));
+    }
+    CUDA_CHECK(cudaIpcCloseMemHandle(slot_counter_));
+    CUDA_CHECK(cudaIpcCloseMemHandle(conflict_evictions_));
+    CUDA_CHECK(cudaIpcCloseMemHandle(global_counter_));
+    CUDA_CHECK(cudaIpcCloseMemHandle(set_mutex_));
+    return;
+  }
+
   // Destruct CUDA std object
   destruct_kernel<<<((capacity_in_set_ - 1) / BLOCK_SIZE_) + 1, BLOCK_SIZE_>>>(
       global_counter_, set_mutex_, capacity_in_set_);
@@ -1345,26 +1695,45 @@ gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, s
   // Free GPU memory for cache
   CUDA_CHECK(cudaFree(keys_));
   CUDA_CHECK(cudaFree(vals_));
+  if (quant_scales_) {
+    CUDA_CHECK(cudaFree(quant_scales_));
+  }
   CUDA_CHECK(cudaFree(slot_counter_));
+  CUDA_CHECK(cudaFree(conflict_evictions_));
   CUDA_CHECK(cudaFree(global_counter_));
   // Free GPU memory for set mutex
   CUDA_CHECK(cudaFree(set_mutex_));
 }
 #else
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
-          int warp_size, typename set_hasher, typename slab_hasher>
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
 gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
-          slab_hasher>::~gpu_cache() noexcept(false) {
+          slab_hasher, value_type>::~gpu_cache() noexcept(false) {
   // Device Restorer
   nv::CudaDeviceRestorer dev_restorer;
 
   // Check device
   dev_restorer.check_device(dev_);
 
+  // Unmap the GPU memory of an attached cache, its owner destructs and frees it
+  if (!owner_) {
+    CUDA_CHECK(cudaIpcCloseMemHandle(keys_));
+    CUDA_CHECK(cudaIpcCloseMemHandle(vals_));
+    if (quant_scales_) {
+      CUDA_CHECK(cudaIpcCloseMemHandle(quant_scales_));
+    }
+    CUDA_CHECK(cudaIpcCloseMemHandle(slot_counter_));
+    CUDA_CHECK(cudaIpcCloseMemHandle(conflict_evictions_));
+    CUDA_CHECK(cudaIpcCloseMemHandle(global_counter_));
+    CUDA_CHECK(cudaIpcCloseMemHandle(set_mutex_));
+    return;
+  }
+
   // Free GPU memory for cache
   CUDA_CHECK(cudaFree(keys_));
   CUDA_CHECK(cudaFree(vals_));
   CUDA_CHECK(cudaFree(slot_counter_));
+  CUDA_CHECK(cudaFree(conflict_evictions_));
   CUDA_CHECK(cudaFree(global_counter_));
   // Free GPU memory for set mutex
   CUDA_CHECK(cudaFree(set_mutex_));
@@ -1373,12 +1742,13 @@ gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, s
 
 #ifdef LIBCUDACXX_VERSION
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
-          int warp_size, typename set_hasher, typename slab_hasher>
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
 void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
-               slab_hasher>::Query(const key_type* d_keys, const size_t len, float* d_values,
-                                   uint64_t* d_missing_index, key_type* d_missing_keys,
-                                   size_t* d_missing_len, cudaStream_t stream,
-                                   const size_t task_per_warp_tile) {
+               slab_hasher, value_type>::Query(const key_type* d_keys, const size_t len,
+                                               float* d_values, uint64_t* d_missing_index,
+                                               key_type* d_missing_keys, size_t* d_missing_len,
+                                               cudaStream_t stream,
+                                               const size_t task_per_warp_tile) {
   // Device Restorer
   nv::CudaDeviceRestorer dev_restorer;
   // Check device
@@ -1403,7 +1773,7 @@ void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_si
   get_kernel<key_type, ref_counter_type, atomic_ref_counter_type, slabset, set_hasher, slab_hasher,
              mutex, empty_key, set_associativity, warp_size><<<grid_size, BLOCK_SIZE_, 0, stream>>>(
       d_keys, len, d_values, embedding_vec_size_, d_missing_index, d_missing_keys, d_missing_len,
-      global_counter_, slot_counter_, capacity_in_set_, keys_, vals_, set_mutex_,
+      global_counter_, slot_counter_, capacity_in_set_, keys_, vals_, quant_scales_, set_mutex_,
       task_per_warp_tile);
 
   // Check for GPU error before return
@@ -1411,12 +1781,13 @@ void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_si
 }
 #else
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
-          int warp_size, typename set_hasher, typename slab_hasher>
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
 void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
-               slab_hasher>::Query(const key_type* d_keys, const size_t len, float* d_values,
-                                   uint64_t* d_missing_index, key_type* d_missing_keys,
-                                   size_t* d_missing_len, cudaStream_t stream,
-                                   const size_t task_per_warp_tile) {
+               slab_hasher, value_type>::Query(const key_type* d_keys, const size_t len,
+                                               float* d_values, uint64_t* d_missing_index,
+                                               key_type* d_missing_keys, size_t* d_missing_len,
+                                               cudaStream_t stream,
+                                               const size_t task_per_warp_tile) {
   // Device Restorer
   nv::CudaDeviceRestorer dev_restorer;
   // Check device
@@ -1451,11 +1822,11 @@ void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_si
 
 #ifdef LIBCUDACXX_VERSION
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
-          int warp_size, typename set_hasher, typename slab_hasher>
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
 void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
-               slab_hasher>::Replace(const key_type* d_keys, const size_t len,
-                                     const float* d_values, cudaStream_t stream,
-                                     const size_t task_per_warp_tile) {
+               slab_hasher, value_type>::Replace(const key_type* d_keys, const size_t len,
+                                                 const float* d_values, cudaStream_t stream,
+                                                 const size_t task_per_warp_tile) {
   // Check if it is a valid replacement
   if (len == 0) {
     return;
@@ -1470,22 +1841,23 @@ void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_si
   // Then replace the <k,v> pairs into the cache
   const size_t keys_per_block = (BLOCK_SIZE_ / warp_size) * task_per_warp_tile;
   const size_t grid_size = ((len - 1) / keys_per_block) + 1;
-  insert_replace_kernel<key_type, slabset, ref_counter_type, mutex, atomic_ref_counter_type,
-                        set_hasher, slab_hasher, empty_key, set_associativity, warp_size>
+  insert_replace_kernel<key_type, slabset, ref_counter_type, atomic_ref_counter_type, set_hasher,
+                        slab_hasher, empty_key, set_associativity, warp_size>
       <<<grid_size, BLOCK_SIZE_, 0, stream>>>(d_keys, d_values, embedding_vec_size_, len, keys_,
-                                              vals_, slot_counter_, set_mutex_, global_counter_,
-                                              capacity_in_set_, task_per_warp_tile);
+                                              vals_, quant_scales_, slot_counter_, global_counter_,
+                                              conflict_evictions_, capacity_in_set_,
+                                              task_per_warp_tile);
 
   // Check for GPU error before return
   CUDA_CHECK(cudaGetLastError());
 }
 #else
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
-          int warp_size, typename set_hasher, typename slab_hasher>
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
 void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
-               slab_hasher>::Replace(const key_type* d_keys, const size_t len,
-                                     const float* d_values, cudaStream_t stream,
-                                     const size_t task_per_warp_tile) {
+               slab_hasher, value_type>::Replace(const key_type* d_keys, const size_t len,
+                                                 const float* d_values, cudaStream_t stream,
+                                                 const size_t task_per_warp_tile) {
   // Check if it is a valid replacement
   if (len == 0) {
     return;
@@ -1503,7 +1875,7 @@ void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_si
   insert_replace_kernel<key_type, slabset, ref_counter_type, set_hasher, slab_hasher, empty_key,
                         set_associativity, warp_size><<<grid_size, BLOCK_SIZE_, 0, stream>>>(
       d_keys, d_values, embedding_vec_size_, len, keys_, vals_, slot_counter_, set_mutex_,
-      global_counter_, capacity_in_set_, task_per_warp_tile);
+      global_counter_, conflict_evictions_, capacity_in_set_, task_per_warp_tile);
 
   // Check for GPU error before return
   CUDA_CHECK(cudaGetLastError());
@@ -1512,10 +1884,11 @@ void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_si
 
 #ifdef LIBCUDACXX_VERSION
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
-          int warp_size, typename set_hasher, typename slab_hasher>
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
 void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
-               slab_hasher>::Update(const key_type* d_keys, const size_t len, const float* d_values,
-                                    cudaStream_t stream, const size_t task_per_warp_tile) {
+               slab_hasher, value_type>::Update(const key_type* d_keys, const size_t len,
+                                                const float* d_values, cudaStream_t stream,
+                                                const size_t task_per_warp_tile) {
   // Check if it is a valid update request
   if (len == 0) {
     return;
@@ -1529,20 +1902,21 @@ void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_si
   // Update the value of input keys that are existed in the cache
   const size_t keys_per_block = (BLOCK_SIZE_ / warp_size) * task_per_warp_tile;
   const size_t grid_size = ((len - 1) / keys_per_block) + 1;
-  update_kernel<key_type, slabset, set_hasher, slab_hasher, mutex, empty_key, set_associativity,
-                warp_size><<<grid_size, BLOCK_SIZE_, 0, stream>>>(
-      d_keys, len, d_values, embedding_vec_size_, capacity_in_set_, keys_, vals_, set_mutex_,
-      task_per_warp_tile);
+  update_kernel<key_type, slabset, set_hasher, slab_hasher, mutex, ref_counter_type, empty_key,
+                set_associativity, warp_size><<<grid_size, BLOCK_SIZE_, 0, stream>>>(
+      d_keys, len, d_values, embedding_vec_size_, capacity_in_set_, keys_, vals_, quant_scales_,
+      slot_counter_, set_mutex_, task_per_warp_tile);
 
   // Check for GPU error before return
   CUDA_CHECK(cudaGetLastError());
 }
 #else
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
-          int warp_size, typename set_hasher, typename slab_hasher>
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
 void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
-               slab_hasher>::Update(const key_type* d_keys, const size_t len, const float* d_values,
-                                    cudaStream_t stream, const size_t task_per_warp_tile) {
+               slab_hasher, value_type>::Update(const key_type* d_keys, const size_t len,
+                                                const float* d_values, cudaStream_t stream,
+                                                const size_t task_per_warp_tile) {
   // Check if it is a valid update request
   if (len == 0) {
     return;
@@ -1568,11 +1942,11 @@ void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_si
 
 #ifdef LIBCUDACXX_VERSION
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
-          int warp_size, typename set_hasher, typename slab_hasher>
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
 void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
-               slab_hasher>::Dump(key_type* d_keys, size_t* d_dump_counter,
-                                  const size_t start_set_index, const size_t end_set_index,
-                                  cudaStream_t stream) {
+               slab_hasher, value_type>::Dump(key_type* d_keys, size_t* d_dump_counter,
+                                              const size_t start_set_index,
+                                              const size_t end_set_index, cudaStream_t stream) {
   // Check if it is a valid dump request
   if (start_set_index >= capacity_in_set_) {
     printf("Error: Invalid value for start_set_index. Nothing dumped.\n");
@@ -1603,11 +1977,11 @@ void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_si
 }
 #else
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
-          int warp_size, typename set_hasher, typename slab_hasher>
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
 void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
-               slab_hasher>::Dump(key_type* d_keys, size_t* d_dump_counter,
-                                  const size_t start_set_index, const size_t end_set_index,
-                                  cudaStream_t stream) {
+               slab_hasher, value_type>::Dump(key_type* d_keys, size_t* d_dump_counter,
+                                              const size_t start_set_index,
+                                              const size_t end_set_index, cudaStream_t stream) {
   // Check if it is a valid dump request
   if (start_set_index >= capacity_in_set_) {
     printf("Error: Invalid value for start_set_index. Nothing dumped.\n");
@@ -1638,8 +2012,46 @@ void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_si
 }
 #endif
 
+template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
+size_t gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
+                 slab_hasher, value_type>::ConflictEvictions(cudaStream_t stream) {
+  // Device Restorer
+  nv::CudaDeviceRestorer dev_restorer;
+  // Check device
+  dev_restorer.check_device(dev_);
+
+  size_t conflict_evictions;
+  CUDA_CHECK(cudaMemcpyAsync(&conflict_evictions, conflict_evictions_, sizeof(size_t),
+                             cudaMemcpyDeviceToHost, stream));
+  CUDA_CHECK(cudaStreamSynchronize(stream));
+  return conflict_evictions;
+}
+
 template class gpu_cache<unsigned int, uint64_t, std::numeric_limits<unsigned int>::max(),
                          SET_ASSOCIATIVITY, SLAB_SIZE>;
 template class gpu_cache<long long, uint64_t, std::numeric_limits<long long>::max(),
                          SET_ASSOCIATIVITY, SLAB_SIZE>;
+// Higher associativities for tables that suffer from set conflicts
+template class gpu_cache<unsigned int, uint64_t, std::numeric_limits<unsigned int>::max(), 4,
+                         SLAB_SIZE>;
+template class gpu_cache<unsigned int, uint64_t, std::numeric_limits<unsigned int>::max(), 8,
+                         SLAB_SIZE>;
+template class gpu_cache<long long, uint64_t, std::numeric_limits<long long>::max(), 4,
+                         SLAB_SIZE>;
+template class gpu_cache<long long, uint64_t, std::numeric_limits<long long>::max(), 8,
+                         SLAB_SIZE>;
+#ifdef LIBCUDACXX_VERSION
+#define GPU_CACHE_INSTANTIATE_VALUE_TYPE(key_type, value_type)                                  \
+  template class gpu_cache<key_type, uint64_t, std::numeric_limits<key_type>::max(),            \
+                           SET_ASSOCIATIVITY, SLAB_SIZE, MurmurHash3_32<key_type>,              \
+                           Mod_Hash<key_type, size_t>, value_type>;
+GPU_CACHE_INSTANTIATE_VALUE_TYPE(unsigned int, __half)
+GPU_CACHE_INSTANTIATE_VALUE_TYPE(unsigned int, __nv_bfloat16)
+GPU_CACHE_INSTANTIATE_VALUE_TYPE(unsigned int, __nv_fp8_e4m3)
+GPU_CACHE_INSTANTIATE_VALUE_TYPE(long long, __half)
+GPU_CACHE_INSTANTIATE_VALUE_TYPE(long long, __nv_bfloat16)
+GPU_CACHE_INSTANTIATE_VALUE_TYPE(long long, __nv_fp8_e4m3)
+#undef GPU_CACHE_INSTANTIATE_VALUE_TYPE
+#endif
 }  // namespace gpu_cache
@@ -22,12 +22,14 @@
 #include <sys/mman.h>
 
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <iomanip>
 #include <iostream>
 #include <limits>
 #include <memory>
 #include <static_hash_table.hpp>
+#include <type_traits>
 
 namespace gpu_cache {
 
@@ -252,6 +254,40 @@ __forceinline__ __device__ void warp_tile_copy(const size_t lane_idx,
   }
 }
 
+// Copies the rows of a warp at once: each lane loads its float4 of all the rows before storing
+// any, so that the loads of the rows are in flight together. This hides the latency of the rows
+// in host memory, read across PCIe or C2C, which would otherwise add up row by row.
+template <int warp_size, int num_rows, typename size_type>
+__forceinline__ __device__ void warp_gather_rows(const int lane_idx, const int value_dim,
+                                                 const size_type (&indices)[num_rows],
+                                                 const int num_valid_rows, const float *values,
+                                                 float *output, const float default_value,
+                                                 const size_type invalid_index) {
+  const int vec4_per_row = value_dim / 4;
+  const float4 default_vec4 = make_float4(default_value, default_value, default_value,
+                                          default_value);
+  for (int base = 0; base < vec4_per_row; base += warp_size) {
+    const int col = base + lane_idx;
+    float4 buf[num_rows];
+#pragma unroll
+    for (int i = 0; i < num_rows; i++) {
+      if (i < num_valid_rows && col < vec4_per_row) {
+        buf[i] = indices[i] == invalid_index
+                     ? default_vec4
+                     : __ldg(reinterpret_cast<const float4 *>(
+                                 values + static_cast<size_t>(value_dim) * indices[i]) +
+                             col);
+      }
+    }
+#pragma unroll
+    for (int i = 0; i < num_rows; i++) {
+      if (i < num_valid_rows && col < vec4_per_row) {
+        reinterpret_cast<float4 *>(output + static_cast<size_t>(value_dim) * i)[col] = buf[i];
+      }
+    }
+  }
+}
+
 template <unsigned int tile_size, unsigned int group_size, typename key_type, typename value_type,
           typename out_value_type, typename size_type, typename hasher>
 __global__ void LookupKernel(key_type *table_keys, size_type *table_indices, float *quant_scales_,
@@ -262,6 +298,7 @@ __global__ void LookupKernel(key_type *table_keys, size_type *table_indices, flo
   static_assert(tile_size <= group_size, "tile_size cannot be larger than group_size");
   constexpr int WARP_SIZE = 32;
   static_assert(WARP_SIZE % tile_size == 0, "tile_size must be divisible by warp_size");
+  constexpr int ROWS_PER_WARP = WARP_SIZE / tile_size;
 
   auto grid = cooperative_groups::this_grid();
   auto block = cooperative_groups::this_thread_block();
@@ -284,7 +321,22 @@ __global__ void LookupKernel(key_type *table_keys, size_type *table_indices, flo
         slot = lookup<group_size>(table_keys, capacity, key, hash, tile, empty_key, invalid_slot);
       }
     }
-    for (int i = 0; i < WARP_SIZE / tile_size; i++) {
+    if constexpr (std::is_same_v<value_type, float> && std::is_same_v<out_value_type, float>) {
+      if (value_dim % 4 == 0 && (size_t)values % 16 == 0 && (size_t)output % 16 == 0) {
+        const int first_key_num = warp_tile.shfl(key_num, 0);
+        size_type indices[ROWS_PER_WARP];
+#pragma unroll
+        for (int i = 0; i < ROWS_PER_WARP; i++) {
+          const size_type slot_to_read = warp_tile.shfl(slot, i * tile_size);
+          indices[i] = slot_to_read == invalid_slot ? invalid_slot : table_indices[slot_to_read];
+        }
+        warp_gather_rows<WARP_SIZE, ROWS_PER_WARP>(
+            warp_tile.thread_rank(), value_dim, indices, num_keys - first_key_num, values,
+            output + (size_t)value_dim * first_key_num, default_value, invalid_slot);
+        continue;
+      }
+    }
+    for (int i = 0; i < ROWS_PER_WARP; i++) {
       auto slot_to_read = warp_tile.shfl(slot, i * tile_size);
       int idx_to_write = warp_tile.shfl(key_num, 0) + i;
       if (idx_to_write >= num_keys) break;
@@ -377,8 +429,25 @@ StaticHashTable<key_type, value_type, out_value_type, tile_size, group_size,
   }
 #else
   if (enable_pagelock) {
-    CUDA_CHECK(
-        cudaHostAlloc(&table_values_, sizeof(value_type) * num_values, cudaHostAllocPortable));
+    // On a coherent CPU-GPU link, e.g. Grace Hopper C2C, the GPU reads plain host memory through
+    // the host page tables, so that a table much larger than HBM needs not be pinned.
+    int device_id, host_page_tables;
+    CUDA_CHECK(cudaGetDevice(&device_id));
+    CUDA_CHECK(cudaDeviceGetAttribute(
+        &host_page_tables, cudaDevAttrPageableMemoryAccessUsesHostPageTables, device_id));
+    if (host_page_tables) {
+      constexpr size_t page_size = 4096;
+      const size_t n = (sizeof(value_type) * num_values + page_size - 1) / page_size * page_size;
+      table_values_ = static_cast<value_type *>(std::aligned_alloc(page_size, n));
+      if (!table_values_) {
+        printf("Error: host allocation of the embedding vectors failed!\n");
+        std::abort();
+      }
+      system_allocated_values_ = true;
+    } else {
+      CUDA_CHECK(
+          cudaHostAlloc(&table_values_, sizeof(value_type) * num_values, cudaHostAllocPortable));
+    }
   } else {
     CUDA_CHECK(cudaMalloc(&table_values_, sizeof(value_type) * num_values));
   }
@@ -424,6 +493,30 @@ void StaticHashTable<key_type, value_type, out_value_type, tile_size, group_size
   size_ += num_keys;
 }
 
+template <typename key_type, typename value_type, typename out_value_type, unsigned int tile_size,
+          unsigned int group_size, typename hasher>
+bool StaticHashTable<key_type, value_type, out_value_type, tile_size, group_size, hasher>::load(
+    const key_type *keys, const size_type *indices, int64_t num_slots, const value_type *values,
+    size_type num_values, cudaStream_t stream) {
+  if constexpr (group_size != 16 || !std::is_same_v<hasher, MurmurHash3_32<key_type>> ||
+                nv::is_fp8<value_type>::value) {
+    return false;
+  } else {
+    if (num_slots != key_capacity_ || num_values > value_capacity_) {
+      return false;
+    }
+    CUDA_CHECK(cudaMemcpyAsync(table_keys_, keys, sizeof(key_type) * (key_capacity_ + 1),
+                               cudaMemcpyDefault, stream));
+    CUDA_CHECK(cudaMemcpyAsync(table_indices_, indices, sizeof(size_type) * (key_capacity_ + 1),
+                               cudaMemcpyDefault, stream));
+    CUDA_CHECK(cudaMemcpyAsync(table_values_, values,
+                               sizeof(value_type) * static_cast<size_t>(num_values) * value_dim_,
+                               cudaMemcpyDefault, stream));
+    size_ = num_values;
+    return true;
+  }
+}
+
 template <typename key_type, typename value_type, typename out_value_type, unsigned int tile_size,
           unsigned int group_size, typename hasher>
 void StaticHashTable<key_type, value_type, out_value_type, tile_size, group_size, hasher>::clear(
@@ -459,11 +552,13 @@ StaticHashTable<key_type, value_type, out_value_type, tile_size, group_size,
 #else
   if constexpr (nv::is_fp8<value_type>::value) {
     CUDA_CHECK(cudaFree(quant_scales_));
+  }
+  if (system_allocated_values_) {
+    std::free(table_values_);
+  } else if (enable_pagelock) {
+    CUDA_CHECK(cudaFreeHost(table_values_));
   } else {
-    if (enable_pagelock)
-      CUDA_CHECK(cudaFreeHost(table_values_))
-    else
-      CUDA_CHECK(cudaFree(table_values_));
+    CUDA_CHECK(cudaFree(table_values_));
   }
 #endif
 }
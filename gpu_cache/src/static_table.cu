@@ -31,19 +31,39 @@ static_table<key_type, value_type, out_value_type>::static_table(const size_t ta
     : table_size_(table_size),
       embedding_vec_size_(embedding_vec_size),
       default_value_(default_value),
-      static_hash_table_(table_size, embedding_vec_size, enable_pagelock) {
+      static_hash_table_(table_size, embedding_vec_size, enable_pagelock),
+      active_table_(&static_hash_table_),
+      enable_pagelock_(enable_pagelock) {
+  int least_priority, greatest_priority;
+  CUDA_CHECK(cudaDeviceGetStreamPriorityRange(&least_priority, &greatest_priority));
+  CUDA_CHECK(
+      cudaStreamCreateWithPriority(&generation_stream_, cudaStreamNonBlocking, least_priority));
+  CUDA_CHECK(cudaEventCreateWithFlags(&input_event_, cudaEventDisableTiming));
+  CUDA_CHECK(cudaEventCreateWithFlags(&ready_event_, cudaEventDisableTiming));
   if (embedding_vec_size_ == 0) {
     printf("Error: Invalid value for embedding_vec_size.\n");
     return;
   }
 }
 
+template <typename key_type, typename value_type, typename out_value_type>
+static_table<key_type, value_type, out_value_type>::~static_table() {
+  CUDA_CHECK(cudaEventDestroy(ready_event_));
+  CUDA_CHECK(cudaEventDestroy(input_event_));
+  CUDA_CHECK(cudaStreamDestroy(generation_stream_));
+}
+
 template <typename key_type, typename value_type, typename out_value_type>
 void static_table<key_type, value_type, out_value_type>::Query(const key_type* d_keys,
                                                                const size_t len,
                                                                out_value_type* d_values,
                                                                cudaStream_t stream) {
-  static_hash_table_.lookup(d_keys, d_values, len, default_value_, stream);
+  // lookup() synchronizes the stream. So, once CommitGeneration() holds the lock exclusively, no
+  // query reads from the previous generation anymore.
+  std::shared_lock<std::shared_mutex> lock(active_table_mutex_);
+  CUDA_CHECK(cudaStreamWaitEvent(stream, ready_event_));
+  active_table_.load(std::memory_order_acquire)
+      ->lookup(d_keys, d_values, len, default_value_, stream);
 }
 
 template <typename key_type, typename value_type, typename out_value_type>
@@ -51,7 +71,7 @@ void static_table<key_type, value_type, out_value_type>::Init(const key_type* d_
                                                               const size_t len,
                                                               const value_type* d_values,
                                                               cudaStream_t stream) {
-  static_hash_table_.insert(d_keys, d_values, len, stream);
+  active_table_.load(std::memory_order_acquire)->insert(d_keys, d_values, len, stream);
 }
 
 template <typename key_type, typename value_type, typename out_value_type>
@@ -60,12 +80,76 @@ void static_table<key_type, value_type, out_value_type>::Add(const key_type* d_k
                                                              const value_type* d_values,
                                                              const float* d_quant_scales,
                                                              cudaStream_t stream) {
-  static_hash_table_.insert(d_keys, d_values, len, stream, d_quant_scales);
+  active_table_.load(std::memory_order_acquire)
+      ->insert(d_keys, d_values, len, stream, d_quant_scales);
 }
 
 template <typename key_type, typename value_type, typename out_value_type>
 void static_table<key_type, value_type, out_value_type>::Clear(cudaStream_t stream) {
-  static_hash_table_.clear(stream);
+  active_table_.load(std::memory_order_acquire)->clear(stream);
+}
+
+template <typename key_type, typename value_type, typename out_value_type>
+bool static_table<key_type, value_type, out_value_type>::Load(const key_type* keys,
+                                                              const uint32_t* indices,
+                                                              const int64_t num_slots,
+                                                              const value_type* values,
+                                                              const size_t len,
+                                                              cudaStream_t stream) {
+  return active_table_.load(std::memory_order_acquire)
+      ->load(keys, indices, num_slots, values, len, stream);
+}
+
+template <typename key_type, typename value_type, typename out_value_type>
+typename static_table<key_type, value_type, out_value_type>::hash_table_type*
+static_table<key_type, value_type, out_value_type>::staged_table() {
+  if (!shadow_hash_table_) {
+    shadow_hash_table_ =
+        std::make_unique<hash_table_type>(table_size_, embedding_vec_size_, enable_pagelock_);
+  }
+  hash_table_type* const active_table = active_table_.load(std::memory_order_acquire);
+  return active_table == &static_hash_table_ ? shadow_hash_table_.get() : &static_hash_table_;
+}
+
+template <typename key_type, typename value_type, typename out_value_type>
+void static_table<key_type, value_type, out_value_type>::BeginGeneration() {
+  staged_table()->clear(generation_stream_);
+}
+
+template <typename key_type, typename value_type, typename out_value_type>
+void static_table<key_type, value_type, out_value_type>::AddToGeneration(
+    const key_type* d_keys, const size_t len, const value_type* d_values,
+    const float* d_quant_scales, cudaStream_t stream) {
+  // The inputs are produced on `stream`, and must not be reused before they were consumed.
+  CUDA_CHECK(cudaEventRecord(input_event_, stream));
+  CUDA_CHECK(cudaStreamWaitEvent(generation_stream_, input_event_));
+  staged_table()->insert(d_keys, d_values, len, generation_stream_, d_quant_scales);
+  CUDA_CHECK(cudaEventRecord(input_event_, generation_stream_));
+  CUDA_CHECK(cudaStreamWaitEvent(stream, input_event_));
+}
+
+template <typename key_type, typename value_type, typename out_value_type>
+bool static_table<key_type, value_type, out_value_type>::LoadGeneration(
+    const key_type* keys, const uint32_t* indices, const int64_t num_slots,
+    const value_type* values, const size_t len, cudaStream_t stream) {
+  CUDA_CHECK(cudaEventRecord(input_event_, stream));
+  CUDA_CHECK(cudaStreamWaitEvent(generation_stream_, input_event_));
+  const bool loaded =
+      staged_table()->load(keys, indices, num_slots, values, len, generation_stream_);
+  CUDA_CHECK(cudaEventRecord(input_event_, generation_stream_));
+  CUDA_CHECK(cudaStreamWaitEvent(stream, input_event_));
+  return loaded;
+}
+
+template <typename key_type, typename value_type, typename out_value_type>
+void static_table<key_type, value_type, out_value_type>::CommitGeneration(cudaStream_t stream) {
+  hash_table_type* const table = staged_table();
+  {
+    std::unique_lock<std::shared_mutex> lock(active_table_mutex_);
+    CUDA_CHECK(cudaEventRecord(ready_event_, generation_stream_));
+    active_table_.store(table, std::memory_order_release);
+  }
+  CUDA_CHECK(cudaStreamWaitEvent(stream, ready_event_));
 }
 
 template class static_table<unsigned int, float, float>;
@@ -35,6 +35,17 @@ __host__ __device__ key_type hash(key_type key) {
   return key;
 }
 
+// Owner of a key in a sharded table. The key is mixed first, because it also selects the set
+// through `hash(key) % num_sets`.
+template <typename key_type>
+__host__ __device__ int shard_of(const key_type key, const int num_shards) {
+  uint64_t h = static_cast<uint64_t>(key);
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  return static_cast<int>(h % num_shards);
+}
+
 template <typename key_type>
 __global__ void hash_add_kernel(const key_type* new_keys, const int num_keys, key_type* keys,
                                 const int num_sets, int* set_sizes, const int max_set_size,
@@ -273,6 +284,48 @@ __global__ void distribute_vectors_kernel(const index_type* positions, const siz
   }
 }
 
+// Looks up the keys that missed the local device table in the device tables of the other shards,
+// which are accessed through peer access. Keys that are not found there are compacted into
+// `remaining_keys`.
+template <typename key_type, typename vec_type>
+__global__ void query_shards_kernel(const key_type* missing_keys, const int* missing_positions,
+                                    const int* missing_count, key_type* const* shard_keys,
+                                    vec_type* const* shard_vectors, const size_t* shard_num_sets,
+                                    const int shard_id, const int num_shards, const int vec_size,
+                                    vec_type* output_vectors, key_type* remaining_keys,
+                                    int* remaining_positions, int* remaining_count) {
+  constexpr int warp_size = 32;
+
+  auto block = cg::this_thread_block();
+  auto tile = cg::tiled_partition<warp_size>(block);
+
+  const int num_keys = *missing_count;
+  const size_t num_tiles = (size_t)gridDim.x * blockDim.x / warp_size;
+  for (size_t i = ((size_t)blockIdx.x * blockDim.x + threadIdx.x) / warp_size; i < num_keys;
+       i += num_tiles) {
+    const key_type key = missing_keys[i];
+    const int shard = shard_of(key, num_shards);
+    size_t idx_set = 0;
+    int existed = 0;
+    if (shard != shard_id) {
+      idx_set = hash(key) % shard_num_sets[shard];
+      existed = tile.ballot(tile.thread_rank() < set_size &&
+                            shard_keys[shard][idx_set * set_size + tile.thread_rank()] == key);
+    }
+    if (existed) {
+      const size_t src_lane = __ffs(existed) - 1;
+      const size_t idx_vec = shard_num_sets[shard] * src_lane + idx_set;
+      warp_tile_copy<warp_size>(tile.thread_rank(), vec_size,
+                                output_vectors + (size_t)missing_positions[i] * vec_size,
+                                shard_vectors[shard] + idx_vec * vec_size);
+    } else if (tile.thread_rank() == 0) {
+      const int pos = atomicAdd(remaining_count, 1);
+      remaining_keys[pos] = key;
+      remaining_positions[pos] = missing_positions[i];
+    }
+  }
+}
+
 }  // namespace
 
 namespace gpu_cache {
@@ -280,15 +333,19 @@ template <typename key_type, typename index_type, typename vec_type>
 UvmTable<key_type, index_type, vec_type>::UvmTable(const size_t device_table_capacity,
                                                    const size_t host_table_capacity,
                                                    const int max_batch_size, const int vec_size,
-                                                   const vec_type default_value)
+                                                   const vec_type default_value,
+                                                   const int num_stages)
     : max_batch_size_(std::max(100000, max_batch_size)),
       vec_size_(vec_size),
+      num_stages_(std::max(1, num_stages)),
+      stage_size_((max_batch_size_ - 1) / num_stages_ + 1),
       num_set_((device_table_capacity - 1) / set_size + 1),
       num_host_set_((host_table_capacity - 1) / set_size + 1),
       table_capacity_(num_set_ * set_size),
       default_vector_(vec_size, default_value),
       device_table_(device_table_capacity, set_size, max_batch_size_),
       host_table_(host_table_capacity * 1.1, set_size, max_batch_size_) {
+  CUDA_CHECK(cudaGetDevice(&device_id_));
   CUDA_CHECK(cudaMalloc(&d_keys_buffer_, sizeof(key_type) * max_batch_size_));
   CUDA_CHECK(cudaMalloc(&d_vectors_buffer_, sizeof(vec_type) * max_batch_size_ * vec_size_));
   CUDA_CHECK(cudaMalloc(&d_vectors_, sizeof(vec_type) * device_table_.capacity * vec_size_));
@@ -300,17 +357,24 @@ UvmTable<key_type, index_type, vec_type>::UvmTable(const size_t device_table_cap
   CUDA_CHECK(cudaMalloc(&d_missing_positions_, sizeof(int) * max_batch_size_));
   CUDA_CHECK(cudaMalloc(&d_missing_count_, sizeof(int)));
   CUDA_CHECK(cudaMemset(d_missing_count_, 0, sizeof(int)));
+  CUDA_CHECK(cudaMallocHost(&h_missing_count_, sizeof(int)));
   CUDA_CHECK(cudaStreamCreate(&query_stream_));
-  for (int i = 0; i < num_buffers_; i++) {
-    int batch_size_per_buffer = ceil(1.0 * max_batch_size_ / num_buffers_);
-    CUDA_CHECK(
-        cudaMallocHost(&h_cpy_buffers_[i], sizeof(vec_type) * batch_size_per_buffer * vec_size));
-    CUDA_CHECK(cudaMalloc(&d_cpy_buffers_[i], sizeof(vec_type) * batch_size_per_buffer * vec_size));
+  CUDA_CHECK(cudaStreamCreate(&read_stream_));
+  h_cpy_buffers_.resize(num_stages_);
+  d_cpy_buffers_.resize(num_stages_);
+  cpy_streams_.resize(num_stages_);
+  cpy_events_.resize(num_stages_);
+  for (int i = 0; i < num_stages_; i++) {
+    CUDA_CHECK(cudaMallocHost(&h_cpy_buffers_[i], sizeof(vec_type) * stage_size_ * vec_size));
+    CUDA_CHECK(cudaMalloc(&d_cpy_buffers_[i], sizeof(vec_type) * stage_size_ * vec_size));
     CUDA_CHECK(cudaStreamCreate(&cpy_streams_[i]));
-    CUDA_CHECK(cudaEventCreate(&cpy_events_[i]));
+    CUDA_CHECK(cudaEventCreateWithFlags(&cpy_events_[i], cudaEventDisableTiming));
   }
   CUDA_CHECK(cudaMallocHost(&h_missing_keys_, sizeof(key_type) * max_batch_size_));
   CUDA_CHECK(cudaEventCreate(&query_event_));
+  CUDA_CHECK(cudaEventCreateWithFlags(&read_event_, cudaEventDisableTiming));
+  CUDA_CHECK(cudaEventCreateWithFlags(&count_event_, cudaEventDisableTiming));
+  CUDA_CHECK(cudaEventCreateWithFlags(&index_event_, cudaEventDisableTiming));
   h_vectors_.resize(host_table_.capacity * vec_size_);
 }
 
@@ -319,11 +383,29 @@ void UvmTable<key_type, index_type, vec_type>::add(const key_type* h_keys,
                                                    const vec_type* h_vectors,
                                                    const size_t num_keys) {
   std::vector<key_type> h_missing_keys;
-  size_t num_batches = (num_keys - 1) / max_batch_size_ + 1;
+
+  // When sharded, only the owned keys are placed into device memory. All other keys are kept in
+  // host memory, so that they can still be served if their owner ran out of device memory.
+  const key_type* h_device_keys = h_keys;
+  size_t num_device_keys = num_keys;
+  std::vector<key_type> h_owned_keys;
+  if (num_shards_ > 1) {
+    for (size_t i = 0; i < num_keys; i++) {
+      if (shard_of(h_keys[i], num_shards_) == shard_id_) {
+        h_owned_keys.push_back(h_keys[i]);
+      } else {
+        h_missing_keys.push_back(h_keys[i]);
+      }
+    }
+    h_device_keys = h_owned_keys.data();
+    num_device_keys = h_owned_keys.size();
+  }
+
+  size_t num_batches = num_device_keys ? (num_device_keys - 1) / max_batch_size_ + 1 : 0;
   for (size_t i = 0; i < num_batches; i++) {
     size_t this_batch_size =
-        i != num_batches - 1 ? max_batch_size_ : num_keys - i * max_batch_size_;
-    CUDA_CHECK(cudaMemcpy(d_keys_buffer_, h_keys + i * max_batch_size_,
+        i != num_batches - 1 ? max_batch_size_ : num_device_keys - i * max_batch_size_;
+    CUDA_CHECK(cudaMemcpy(d_keys_buffer_, h_device_keys + i * max_batch_size_,
                           sizeof(*d_keys_buffer_) * this_batch_size, cudaMemcpyHostToDevice));
     CUDA_CHECK(cudaMemset(d_missing_count_, 0, sizeof(*d_missing_count_)));
     device_table_.add(d_keys_buffer_, this_batch_size, d_missing_keys_, d_missing_count_, 0);
@@ -423,46 +505,70 @@ void UvmTable<key_type, index_type, vec_type>::query(const key_type* d_keys, con
   if (!num_keys) return;
   CUDA_CHECK(cudaEventRecord(query_event_, stream));
   CUDA_CHECK(cudaStreamWaitEvent(query_stream_, query_event_));
+  // The buffers of the previous query must have been consumed before they are overwritten.
+  CUDA_CHECK(cudaStreamWaitEvent(query_stream_, read_event_));
+  for (int i = 0; i < num_stages_; i++) {
+    CUDA_CHECK(cudaStreamWaitEvent(query_stream_, cpy_events_[i]));
+  }
 
-  static_assert(num_buffers_ >= 2);
   device_table_.query(d_keys, num_keys, d_output_indices_, d_missing_keys_, d_missing_positions_,
                       d_missing_count_, query_stream_);
 
+  // Resolve the keys owned by other shards from their device memory first.
+  key_type* missing_keys = d_missing_keys_;
+  int* missing_positions = d_missing_positions_;
+  int* missing_count = d_missing_count_;
+  if (num_shards_ > 1) {
+    CUDA_CHECK(cudaMemsetAsync(d_shard_missing_count_, 0, sizeof(*d_shard_missing_count_),
+                               query_stream_));
+    query_shards_kernel<<<128, block_size, 0, query_stream_>>>(
+        d_missing_keys_, d_missing_positions_, d_missing_count_, d_shard_keys_, d_shard_vectors_,
+        d_shard_num_sets_, shard_id_, num_shards_, vec_size_, d_vectors, d_shard_missing_keys_,
+        d_shard_missing_positions_, d_shard_missing_count_);
+    CUDA_CHECK(cudaMemsetAsync(d_missing_count_, 0, sizeof(*d_missing_count_), query_stream_));
+    missing_keys = d_shard_missing_keys_;
+    missing_positions = d_shard_missing_positions_;
+    missing_count = d_shard_missing_count_;
+  }
   CUDA_CHECK(cudaEventRecord(query_event_, query_stream_));
-  CUDA_CHECK(cudaStreamWaitEvent(cpy_streams_[0], query_event_));
-
-  int num_missing_keys;
-  CUDA_CHECK(cudaMemcpyAsync(&num_missing_keys, d_missing_count_, sizeof(*d_missing_count_),
-                             cudaMemcpyDeviceToHost, cpy_streams_[0]));
-
-  host_table_.query(d_missing_keys_, d_missing_count_, d_output_host_indices_, query_stream_);
-  CUDA_CHECK(cudaStreamSynchronize(cpy_streams_[0]));
-
-  CUDA_CHECK(cudaMemsetAsync(d_missing_count_, 0, sizeof(*d_missing_count_), query_stream_));
 
+  // Gather the device-resident vectors while the host-resident ones are being resolved.
+  CUDA_CHECK(cudaStreamWaitEvent(read_stream_, query_event_));
+  read_vectors_kernel<<<(num_keys - 1) / block_size + 1, block_size, 0, read_stream_>>>(
+      d_output_indices_, num_keys, d_vectors_, vec_size_, d_vectors);
+  CUDA_CHECK(cudaEventRecord(read_event_, read_stream_));
+  CUDA_CHECK(cudaStreamWaitEvent(stream, read_event_));
+
+  CUDA_CHECK(cudaMemcpyAsync(h_missing_count_, missing_count, sizeof(*missing_count),
+                             cudaMemcpyDeviceToHost, query_stream_));
+  CUDA_CHECK(cudaEventRecord(count_event_, query_stream_));
+  host_table_.query(missing_keys, missing_count, d_output_host_indices_, query_stream_);
+  CUDA_CHECK(cudaMemsetAsync(missing_count, 0, sizeof(*missing_count), query_stream_));
+
+  CUDA_CHECK(cudaEventSynchronize(count_event_));
+  const int num_missing_keys = *h_missing_count_;
+  if (!num_missing_keys) return;
   CUDA_CHECK(cudaMemcpyAsync(h_output_host_indices_, d_output_host_indices_,
                              sizeof(index_type) * num_missing_keys, cudaMemcpyDeviceToHost,
                              query_stream_));
-
-  CUDA_CHECK(cudaMemcpyAsync(h_missing_keys_, d_missing_keys_, sizeof(key_type) * num_missing_keys,
-                             cudaMemcpyDeviceToHost, cpy_streams_[0]));
-
-  read_vectors_kernel<<<(num_keys - 1) / block_size + 1, block_size, 0, cpy_streams_[1]>>>(
-      d_output_indices_, num_keys, d_vectors_, vec_size_, d_vectors);
-
-  CUDA_CHECK(cudaStreamSynchronize(query_stream_));
-  CUDA_CHECK(cudaStreamSynchronize(cpy_streams_[0]));
-
-  int num_keys_per_buffer = ceil(1.0 * num_missing_keys / num_buffers_);
-
-  for (int buffer_num = 0; buffer_num < num_buffers_; buffer_num++) {
-    int num_keys_this_buffer = buffer_num != num_buffers_ - 1
-                                   ? num_keys_per_buffer
-                                   : num_missing_keys - num_keys_per_buffer * buffer_num;
-    if (!num_keys_this_buffer) break;
-#pragma omp parallel for num_threads(8)
-    for (size_t i = 0; i < static_cast<size_t>(num_keys_this_buffer); i++) {
-      size_t idx_key = buffer_num * num_keys_per_buffer + i;
+  CUDA_CHECK(cudaMemcpyAsync(h_missing_keys_, missing_keys, sizeof(key_type) * num_missing_keys,
+                             cudaMemcpyDeviceToHost, query_stream_));
+  CUDA_CHECK(cudaEventRecord(index_event_, query_stream_));
+  CUDA_CHECK(cudaEventSynchronize(index_event_));
+
+  // Gather the host-resident vectors through the staging ring. A stage is refilled as soon as its
+  // previous upload has completed, while the other stages are still being uploaded or distributed.
+  const int num_chunks = (num_missing_keys - 1) / stage_size_ + 1;
+  for (int chunk = 0; chunk < num_chunks; chunk++) {
+    const int stage = chunk % num_stages_;
+    const int first_key = chunk * stage_size_;
+    const int num_keys_this_chunk = std::min(stage_size_, num_missing_keys - first_key);
+
+    CUDA_CHECK(cudaEventSynchronize(cpy_events_[stage]));
+    vec_type* const h_cpy_buffer = h_cpy_buffers_[stage];
+#pragma omp parallel for num_threads(num_gather_threads_)
+    for (size_t i = 0; i < static_cast<size_t>(num_keys_this_chunk); i++) {
+      size_t idx_key = first_key + i;
       index_type index = h_output_host_indices_[idx_key];
       if (index == std::numeric_limits<index_type>::max()) {
         key_type key = h_missing_keys_[idx_key];
@@ -472,26 +578,85 @@ void UvmTable<key_type, index_type, vec_type>::query(const key_type* d_keys, con
         }
       }
       if (index != std::numeric_limits<index_type>::max()) {
-        memcpy(h_cpy_buffers_[buffer_num] + i * vec_size_, h_vectors_.data() + index * vec_size_,
+        memcpy(h_cpy_buffer + i * vec_size_, h_vectors_.data() + index * vec_size_,
                sizeof(vec_type) * vec_size_);
       } else {
-        memcpy(h_cpy_buffers_[buffer_num] + i * vec_size_, default_vector_.data(),
-               sizeof(vec_type) * vec_size_);
+        memcpy(h_cpy_buffer + i * vec_size_, default_vector_.data(), sizeof(vec_type) * vec_size_);
       }
     }
-    CUDA_CHECK(cudaMemcpyAsync(d_cpy_buffers_[buffer_num], h_cpy_buffers_[buffer_num],
-                               sizeof(vec_type) * num_keys_this_buffer * vec_size_,
-                               cudaMemcpyHostToDevice, cpy_streams_[buffer_num]));
 
-    distribute_vectors_kernel<<<(num_keys_this_buffer - 1) / block_size + 1, block_size, 0,
-                                cpy_streams_[buffer_num]>>>(
-        d_missing_positions_ + buffer_num * num_keys_per_buffer, num_keys_this_buffer,
-        d_cpy_buffers_[buffer_num], vec_size_, d_vectors);
+    CUDA_CHECK(cudaStreamWaitEvent(cpy_streams_[stage], query_event_));
+    CUDA_CHECK(cudaMemcpyAsync(d_cpy_buffers_[stage], h_cpy_buffer,
+                               sizeof(vec_type) * num_keys_this_chunk * vec_size_,
+                               cudaMemcpyHostToDevice, cpy_streams_[stage]));
+    distribute_vectors_kernel<<<(num_keys_this_chunk - 1) / block_size + 1, block_size, 0,
+                                cpy_streams_[stage]>>>(missing_positions + first_key,
+                                                       num_keys_this_chunk, d_cpy_buffers_[stage],
+                                                       vec_size_, d_vectors);
+    CUDA_CHECK(cudaEventRecord(cpy_events_[stage], cpy_streams_[stage]));
+    CUDA_CHECK(cudaStreamWaitEvent(stream, cpy_events_[stage]));
+  }
+}
+
+template <typename key_type, typename index_type, typename vec_type>
+void UvmTable<key_type, index_type, vec_type>::connect_shards(
+    const std::vector<UvmTable*>& shards) {
+  const int num_shards = static_cast<int>(shards.size());
+  if (num_shards < 2) {
+    return;
+  }
+
+  std::vector<key_type*> h_shard_keys;
+  std::vector<vec_type*> h_shard_vectors;
+  std::vector<size_t> h_shard_num_sets;
+  for (const UvmTable* shard : shards) {
+    if (shard->num_shards_ != 1) {
+      throw std::runtime_error(std::string(__FILE__) + ":" + std::to_string(__LINE__) +
+                               ": Runtime Error: The table is already sharded");
+    }
+    h_shard_keys.push_back(shard->device_table_.keys);
+    h_shard_vectors.push_back(shard->d_vectors_);
+    h_shard_num_sets.push_back(shard->device_table_.num_sets);
   }
 
-  for (int i = 0; i < num_buffers_; i++) {
-    CUDA_CHECK(cudaEventRecord(cpy_events_[i], cpy_streams_[i]));
-    CUDA_CHECK(cudaStreamWaitEvent(stream, cpy_events_[i]));
+  nv::CudaDeviceRestorer dev_restorer;
+  for (int i = 0; i < num_shards; i++) {
+    UvmTable& table = *shards[i];
+    CUDA_CHECK(cudaSetDevice(table.device_id_));
+    for (const UvmTable* peer : shards) {
+      if (peer->device_id_ == table.device_id_) {
+        continue;
+      }
+      int can_access_peer;
+      CUDA_CHECK(cudaDeviceCanAccessPeer(&can_access_peer, table.device_id_, peer->device_id_));
+      if (!can_access_peer) {
+        throw std::runtime_error(std::string(__FILE__) + ":" + std::to_string(__LINE__) +
+                                 ": Runtime Error: Device " + std::to_string(table.device_id_) +
+                                 " cannot access device " + std::to_string(peer->device_id_));
+      }
+      const cudaError_t err = cudaDeviceEnablePeerAccess(peer->device_id_, 0);
+      if (err == cudaErrorPeerAccessAlreadyEnabled) {
+        // Clear the sticky error.
+        cudaGetLastError();
+      } else {
+        CUDA_CHECK(err);
+      }
+    }
+
+    table.shard_id_ = i;
+    table.num_shards_ = num_shards;
+    CUDA_CHECK(cudaMalloc(&table.d_shard_keys_, sizeof(key_type*) * num_shards));
+    CUDA_CHECK(cudaMemcpy(table.d_shard_keys_, h_shard_keys.data(), sizeof(key_type*) * num_shards,
+                          cudaMemcpyHostToDevice));
+    CUDA_CHECK(cudaMalloc(&table.d_shard_vectors_, sizeof(vec_type*) * num_shards));
+    CUDA_CHECK(cudaMemcpy(table.d_shard_vectors_, h_shard_vectors.data(),
+                          sizeof(vec_type*) * num_shards, cudaMemcpyHostToDevice));
+    CUDA_CHECK(cudaMalloc(&table.d_shard_num_sets_, sizeof(size_t) * num_shards));
+    CUDA_CHECK(cudaMemcpy(table.d_shard_num_sets_, h_shard_num_sets.data(),
+                          sizeof(size_t) * num_shards, cudaMemcpyHostToDevice));
+    CUDA_CHECK(cudaMalloc(&table.d_shard_missing_keys_, sizeof(key_type) * table.max_batch_size_));
+    CUDA_CHECK(cudaMalloc(&table.d_shard_missing_positions_, sizeof(int) * table.max_batch_size_));
+    CUDA_CHECK(cudaMalloc(&table.d_shard_missing_count_, sizeof(int)));
   }
 }
 
@@ -515,16 +680,28 @@ UvmTable<key_type, index_type, vec_type>::~UvmTable() {
   CUDA_CHECK(cudaFree(d_missing_positions_));
   CUDA_CHECK(cudaFree(d_missing_count_));
   CUDA_CHECK(cudaFreeHost(h_missing_keys_));
+  CUDA_CHECK(cudaFreeHost(h_missing_count_));
 
   CUDA_CHECK(cudaStreamDestroy(query_stream_));
   CUDA_CHECK(cudaEventDestroy(query_event_));
+  CUDA_CHECK(cudaStreamDestroy(read_stream_));
+  CUDA_CHECK(cudaEventDestroy(read_event_));
+  CUDA_CHECK(cudaEventDestroy(count_event_));
+  CUDA_CHECK(cudaEventDestroy(index_event_));
 
-  for (int i = 0; i < num_buffers_; i++) {
+  for (int i = 0; i < num_stages_; i++) {
     CUDA_CHECK(cudaFreeHost(h_cpy_buffers_[i]));
     CUDA_CHECK(cudaFree(d_cpy_buffers_[i]));
     CUDA_CHECK(cudaStreamDestroy(cpy_streams_[i]));
     CUDA_CHECK(cudaEventDestroy(cpy_events_[i]));
   }
+
+  CUDA_CHECK(cudaFree(d_shard_keys_));
+  CUDA_CHECK(cudaFree(d_shard_vectors_));
+  CUDA_CHECK(cudaFree(d_shard_num_sets_));
+  CUDA_CHECK(cudaFree(d_shard_missing_keys_));
+  CUDA_CHECK(cudaFree(d_shard_missing_positions_));
+  CUDA_CHECK(cudaFree(d_shard_missing_count_));
 }
 
 template <typename key_type, typename index_type>
@@ -18,7 +18,8 @@ print("[INFO] %s is imported" % __name__)
 
 from hierarchical_parameter_server.core._version import __version__
 from hierarchical_parameter_server.core.initialize import Init
-from hierarchical_parameter_server.core.lookup_layer import LookupLayer
+from hierarchical_parameter_server.core.lookup_layer import LookupLayer, MultiTableLookupLayer
 from hierarchical_parameter_server.core.sparse_lookup_layer import SparseLookupLayer
+from hierarchical_parameter_server.core.update import Update
 
 __all__ = [item for item in dir() if not item.startswith("__")]
@@ -115,3 +115,93 @@ class LookupLayer(tf.keras.layers.Layer):
         output_shape = ids.get_shape() + self.emb_vec_size
         emb_vector.set_shape(output_shape)
         return emb_vector
+
+
+class MultiTableLookupLayer(tf.keras.layers.Layer):
+    """
+    Abbreviated as ``hps.MultiTableLookupLayer(*args, **kwargs)``.
+
+    This is a wrapper class for the HPS lookup of all the embedding tables of a model
+    in one op. It gives the same results as one ``LookupLayer`` per table, but the
+    tables are queried concurrently, and together if they are fused, which saves the
+    per-op overhead of models with many tables.
+
+    Parameters
+    ----------
+    model_name: str
+            The name of the model that has embedding tables.
+    emb_vec_sizes: List[int]
+            The embedding vector size of every embedding table of the model,
+            in the order of the table indices.
+    emb_vec_dtype:
+            The data type of embedding vectors which must be ``tf.float32``.
+    ps_config_file: str
+            The JSON configuration file for HPS initialization.
+    global_batch_size: int
+            The global batch size for HPS that is deployed on multiple GPUs.
+
+    Examples
+    --------
+    .. code-block:: python
+
+        import hierarchical_parameter_server as hps
+
+        lookup_layer = hps.MultiTableLookupLayer(model_name = args.model_name,
+                                                 emb_vec_sizes = [16, 32],
+                                                 emb_vec_dtype = tf.float32,
+                                                 ps_config_file = args.ps_config_file,
+                                                 global_batch_size = args.global_batch_size)
+
+        @tf.function
+        def _infer_step(inputs_table0, inputs_table1):
+            embedding_vectors = lookup_layer([inputs_table0, inputs_table1])
+            ...
+    """
+
+    def __init__(
+        self,
+        model_name,
+        emb_vec_sizes,
+        emb_vec_dtype,
+        ps_config_file="",
+        global_batch_size=1,
+        **kwargs
+    ):
+        super(MultiTableLookupLayer, self).__init__(**kwargs)
+        self.model_name = model_name
+        self.emb_vec_sizes = emb_vec_sizes
+        self.emb_vec_dtype = emb_vec_dtype
+        self.ps_config_file = ps_config_file
+        self.global_batch_size = global_batch_size
+
+    def call(self, ids_list, max_norm=None):
+        """
+        The forward logic of this wrapper class.
+
+        Parameters
+        ----------
+        ids_list:
+                The keys of every table, in the order of the table indices. The supported
+                data types are ``tf.int32`` and ``tf.int64``.
+        max_norm:
+            if not ``None``, each embedding is clipped if its l2-norm is larger
+            than this value.
+
+        Returns
+        -------
+        emb_vectors: List of ``tf.Tensor`` of float32
+                the embedding vectors for the input keys of every table. The shape of
+                the i-th one is *ids_list[i].get_shape() + emb_vec_sizes[i]*.
+        """
+        emb_vectors = lookup_ops.multi_table_lookup(
+            ids_list=ids_list,
+            model_name=self.model_name,
+            emb_vec_sizes=self.emb_vec_sizes,
+            emb_vec_dtype=self.emb_vec_dtype,
+            ps_config_file=self.ps_config_file,
+            global_batch_size=self.global_batch_size,
+            max_norm=max_norm,
+        )
+        for emb_vector, ids, emb_vec_size in zip(emb_vectors, ids_list, self.emb_vec_sizes):
+            emb_vector.set_shape(ids.get_shape() + emb_vec_size)
+        return emb_vectors
@@ -157,3 +157,32 @@ def lookup(
     )
     ret = clip(embeddings, ids, max_norm)
     return array_ops.identity(ret)
+
+
+def multi_table_lookup(
+    ids_list,
+    model_name,
+    emb_vec_sizes,
+    emb_vec_dtype,
+    ps_config_file,
+    global_batch_size,
+    max_norm,
+):
+    """
+    This function is a wrapper of HPS's lookup forward propagation of all the tables of a model.
+    """
+    # Lazy initialization of hps
+    status = Init(ps_config_file=ps_config_file, global_batch_size=global_batch_size)
+    global_replica_id = get_global_replica_id(_get_comm_tool())
+    embeddings_list = hps_lib.multi_table_lookup(
+        values=ids_list,
+        global_replica_id=global_replica_id,
+        model_name=model_name,
+        emb_vec_sizes=emb_vec_sizes,
+        dtype=emb_vec_dtype,
+        init_status=status,
+    )
+    return [
+        array_ops.identity(clip(embeddings, ids, max_norm))
+        for embeddings, ids in zip(embeddings_list, ids_list)
+    ]
@@ -0,0 +1,96 @@
+"""
+ Copyright (c) 2023, NVIDIA CORPORATION.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+"""
+
+from hierarchical_parameter_server import Init
+from hierarchical_parameter_server import hps_lib
+from hierarchical_parameter_server.core.lookup_ops import get_global_replica_id, _get_comm_tool
+from tensorflow.python.framework import ops
+
+
+def Update(
+    keys,
+    vectors,
+    model_name,
+    table_id,
+    ps_config_file,
+    global_batch_size,
+):
+    """
+    Abbreviated as ``hps.Update(keys, vectors, ...)``.
+
+    This function writes the rows of an embedding table that a model in the same process holds
+    into HPS, e.g. after some steps of training. The rows are copied into the GPU embedding
+    cache of HPS, so they can be looked up right away, without dumping the table to the sparse
+    model files and loading it again.
+
+    What happens to the table depends on its HPS configuration:
+
+    * With the static table (``"embedding_cache_type": "static"``) or the UVM table,
+      the rows become the new contents of the table, so all of them must be given.
+    * With the dynamic GPU embedding cache, the rows are inserted into the cache. The rows that
+      do not fit into the cache are still served from the database tiers, which keep the values
+      of the sparse model files, so set ``gpucacheper`` to hold the whole table.
+
+    Tables fused by ``fuse_embedding_table`` cannot be updated this way.
+
+    .. code-block:: python
+
+        import hierarchical_parameter_server as hps
+        from sparse_operation_kit import experiment as sok
+
+        # A table trained on this GPU, e.g. a sok.Variable on a single GPU, whose keys are
+        # its row indices. The rows go from device to device.
+        keys = tf.range(variable.shape[0], dtype=tf.int64)
+        hps.Update(keys, variable, "demo_model", 0, ps_config_file, global_batch_size)
+
+        # A sok.DynamicVariable is exported to host first, its rows are copied to the GPU
+        keys, vectors = sok.export(dynamic_variable)
+        hps.Update(keys, vectors, "demo_model", 1, ps_config_file, global_batch_size)
+
+    Parameters
+    ----------
+    keys: tf.Tensor
+            The 1-D keys of the rows, of the key type configured for HPS.
+    vectors: tf.Tensor
+            The float32 rows, of shape ``[len(keys), embedding_vecsize]``.
+    model_name: str
+            The name of the model in the HPS configuration.
+    table_id: int
+            The index of the table in the model.
+    ps_config_file: str
+            The JSON configuration file for HPS initialization.
+    global_batch_size: int
+            The global batch size for HPS that is deployed on multiple GPUs.
+
+    Returns
+    -------
+    status: str
+            On success, the function returns string with the value ``OK``.
+    """
+    # Lazy initialization of hps
+    status = Init(ps_config_file=ps_config_file, global_batch_size=global_batch_size)
+    global_replica_id = get_global_replica_id(_get_comm_tool())
+    # The keys and the rows are read on the GPU of this replica
+    keys = ops.convert_to_tensor(keys)
+    vectors = ops.convert_to_tensor(vectors)
+    return hps_lib.update(
+        keys=keys,
+        vectors=vectors,
+        global_replica_id=global_replica_id,
+        model_name=model_name,
+        table_id=table_id,
+        init_status=status,
+    )
@@ -55,4 +55,6 @@ if lib_file is None:
     raise FileNotFoundError("Could not find %s" % lib_name)
 hps_ops = load_library.load_op_library(lib_file)
 lookup = hps_ops.lookup
+multi_table_lookup = hps_ops.multi_table_lookup
 init = hps_ops.init
+update = hps_ops.update
@@ -91,6 +91,11 @@ class Lookup : public AsyncOpKernel {
       }
       done();
     };
+    // Lookups that only enqueue work on the compute stream of TF do not block, and need no thread.
+    if (Facade::instance()->is_stream_ordered(model_name_.c_str())) {
+      work_func();
+      return;
+    }
     thread_pool_.submit(work_func);
   }
 
@@ -162,4 +167,113 @@ class Lookup : public OpKernel {
 REGISTER_KERNEL_BUILDER(Name("Lookup").Device(DEVICE_GPU).HostMemory("global_replica_id"),
                         Lookup<GPUDevice>);
 
+namespace {
+
+// Looks up all the tables of the model with one call to HPS, shared by both kernel flavors.
+void compute_multi_table_lookup(OpKernelContext *ctx, const std::string &model_name,
+                                const std::vector<int32> &emb_vec_sizes) {
+  cudaStream_t gpu_stream = AsGpuStreamValue(ctx->op_device_context()->stream());
+
+  Tensor const *status_tensor = nullptr;
+  OP_REQUIRES_OK(ctx, ctx->input("init_status", &status_tensor));
+  std::string init_status = status_tensor->flat<tstring>()(0);
+  OP_REQUIRES(ctx, init_status == "OK",
+              errors::Aborted("hierarchical parameter server is not initialized."));
+
+  OpInputList values_list;
+  OP_REQUIRES_OK(ctx, ctx->input_list("values", &values_list));
+  OP_REQUIRES(ctx, values_list.size() == static_cast<int>(emb_vec_sizes.size()),
+              errors::InvalidArgument("emb_vec_sizes must have one entry per table."));
+
+  Tensor const *global_replica_id_tensor = nullptr;
+  OP_REQUIRES_OK(ctx, ctx->input("global_replica_id", &global_replica_id_tensor));
+  const int32_t global_replica_id_value = global_replica_id_tensor->scalar<int32_t>()();
+
+  OpOutputList emb_vectors_list;
+  OP_REQUIRES_OK(ctx, ctx->output_list("emb_vectors", &emb_vectors_list));
+
+  std::vector<size_t> num_keys;
+  std::vector<size_t> emb_vec_size_per_table;
+  std::vector<const void *> values_ptrs;
+  std::vector<void *> emb_vector_ptrs;
+  for (int i = 0; i < values_list.size(); ++i) {
+    const Tensor &values_tensor = values_list[i];
+    Tensor *emb_vector_tensor = nullptr;
+    TensorShape emb_vector_tensor_shape = values_tensor.shape();
+    emb_vector_tensor_shape.AppendShape({emb_vec_sizes[i]});
+    OP_REQUIRES_OK(ctx,
+                   emb_vectors_list.allocate(i, emb_vector_tensor_shape, &emb_vector_tensor));
+
+    num_keys.push_back(static_cast<size_t>(values_tensor.NumElements()));
+    emb_vec_size_per_table.push_back(static_cast<size_t>(emb_vec_sizes[i]));
+    values_ptrs.push_back(values_tensor.data());
+    emb_vector_ptrs.push_back(emb_vector_tensor->data());
+  }
+
+  try {
+    bool i64_input_tensor = DT_INT64 == values_list[0].dtype();
+    Facade::instance()->forward(model_name.c_str(), global_replica_id_value, num_keys,
+                                emb_vec_size_per_table, values_ptrs, emb_vector_ptrs,
+                                i64_input_tensor, gpu_stream);
+  } catch (std::exception const &error) {
+    ctx->SetStatus(errors::Aborted(error.what()));
+  }
+}
+
+}  // namespace
+
+#ifdef HPS_ASYNC_OP
+template <typename Device>
+class MultiTableLookup : public AsyncOpKernel {
+ public:
+  explicit MultiTableLookup(OpKernelConstruction *ctx)
+      : AsyncOpKernel(ctx), thread_pool_("", 1) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("model_name", &model_name_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("emb_vec_sizes", &emb_vec_sizes_));
+  }
+
+  void ComputeAsync(OpKernelContext *ctx, DoneCallback done) override {
+    auto work_func = [this, ctx, done]() {
+      auto stream = ctx->op_device_context()->stream();
+      ScopedActivateExecutorContext scoped_activation{stream->parent()};
+      compute_multi_table_lookup(ctx, model_name_, emb_vec_sizes_);
+      done();
+    };
+    if (Facade::instance()->is_stream_ordered(model_name_.c_str())) {
+      work_func();
+      return;
+    }
+    thread_pool_.submit(work_func);
+  }
+
+ private:
+  std::string model_name_;
+  std::vector<tensorflow::int32> emb_vec_sizes_;
+  HugeCTR::ThreadPool thread_pool_;
+};
+
+#else
+template <typename Device>
+class MultiTableLookup : public OpKernel {
+ public:
+  explicit MultiTableLookup(OpKernelConstruction *ctx) : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("model_name", &model_name_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("emb_vec_sizes", &emb_vec_sizes_));
+  }
+
+  void Compute(OpKernelContext *ctx) override {
+    compute_multi_table_lookup(ctx, model_name_, emb_vec_sizes_);
+  }
+
+  bool IsExpensive() override { return true; }
+
+ private:
+  std::string model_name_;
+  std::vector<tensorflow::int32> emb_vec_sizes_;
+};
+#endif
+
+REGISTER_KERNEL_BUILDER(Name("MultiTableLookup").Device(DEVICE_GPU).HostMemory("global_replica_id"),
+                        MultiTableLookup<GPUDevice>);
+
 }  // namespace tensorflow
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <tensorflow/core/framework/op_kernel.h>
+#ifndef TF_GE_211
+#include <tensorflow/stream_executor/gpu/gpu_stream.h>
+#else
+#include <tensorflow/compiler/xla/stream_executor/gpu/gpu_stream.h>
+#endif
+
+#include <hps/plugin/facade.hpp>
+
+namespace tensorflow {
+
+using GPUDevice = Eigen::GpuDevice;
+using namespace HierarchicalParameterServer;
+using namespace stream_executor::gpu;
+
+// Writes the rows of a table that a model in this process holds on the GPU into HPS, so that the
+// lookups see them without exporting and reloading the sparse model files.
+template <typename Device>
+class Update : public OpKernel {
+ public:
+  explicit Update(OpKernelConstruction *ctx) : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("model_name", &model_name_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("table_id", &table_id_));
+  }
+
+  void Compute(OpKernelContext *ctx) override {
+    cudaStream_t gpu_stream = AsGpuStreamValue(ctx->op_device_context()->stream());
+
+    Tensor const *status_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("init_status", &status_tensor));
+    std::string init_status = status_tensor->flat<tstring>()(0);
+    OP_REQUIRES(ctx, init_status == "OK",
+                errors::Aborted("hierarchical parameter server is not initialized."));
+
+    Tensor const *keys_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("keys", &keys_tensor));
+    Tensor const *vectors_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("vectors", &vectors_tensor));
+    OP_REQUIRES(ctx, keys_tensor->dim_size(0) == vectors_tensor->dim_size(0),
+                errors::InvalidArgument("keys and vectors must have the same number of rows."));
+
+    Tensor const *global_replica_id_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("global_replica_id", &global_replica_id_tensor));
+    const int32_t global_replica_id_value = global_replica_id_tensor->scalar<int32_t>()();
+
+    try {
+      size_t num_keys = static_cast<size_t>(keys_tensor->NumElements());
+      size_t emb_vec_size = static_cast<size_t>(vectors_tensor->dim_size(1));
+      bool i64_input_tensor = DT_INT64 == keys_tensor->dtype();
+      Facade::instance()->update(model_name_.c_str(), table_id_, global_replica_id_value,
+                                 num_keys, emb_vec_size, keys_tensor->data(),
+                                 vectors_tensor->flat<float>().data(), i64_input_tensor,
+                                 gpu_stream);
+    } catch (std::exception const &error) {
+      ctx->SetStatus(errors::Aborted(error.what()));
+      return;
+    }
+
+    Tensor *status = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output(0, {}, &status));
+    status->flat<tstring>()(0) = "OK";
+  }
+
+ private:
+  std::string model_name_;
+  tensorflow::int32 table_id_;
+};
+
+REGISTER_KERNEL_BUILDER(Name("Update")
+                            .Device(DEVICE_GPU)
+                            .HostMemory("global_replica_id")
+                            .HostMemory("status"),
+                        Update<GPUDevice>);
+
+}  // namespace tensorflow
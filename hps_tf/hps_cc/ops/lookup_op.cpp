@@ -50,3 +50,41 @@ REGISTER_OP("Lookup")
       return OkStatus();
 #endif
     });
+
+REGISTER_OP("MultiTableLookup")
+    .Input("values: N * value_dtype")
+    .Input("global_replica_id: int32")
+    .Output("emb_vectors: N * dtype")
+    .Attr("N: int >= 1")
+    .Attr("value_dtype: {int32, int64}")
+    .Attr("model_name: string")
+    .Attr("emb_vec_sizes: list(int)")
+    .Attr("dtype: {float32}")
+    .Input("init_status: status_dtype")
+    .Attr("status_dtype: {string}")
+    .SetShapeFn([](InferenceContext* ctx) {
+      int num_tables = 0;
+      TF_RETURN_IF_ERROR(ctx->GetAttr("N", &num_tables));
+      std::vector<int> emb_vec_sizes;
+      TF_RETURN_IF_ERROR(ctx->GetAttr("emb_vec_sizes", &emb_vec_sizes));
+      if (static_cast<int>(emb_vec_sizes.size()) != num_tables) {
+        return errors::InvalidArgument("emb_vec_sizes must have one entry per table.");
+      }
+
+      ShapeHandle global_replica_id_shape = ctx->input(num_tables);
+      if (1 != ctx->Value(ctx->NumElements(global_replica_id_shape))) {
+        return errors::InvalidArgument("global_replica_id must be a scalar.");
+      }
+
+      for (int i = 0; i < num_tables; ++i) {
+        ShapeHandle output_shape;
+        TF_RETURN_IF_ERROR(
+            ctx->Concatenate(ctx->input(i), ctx->Vector(emb_vec_sizes[i]), &output_shape));
+        ctx->set_output(i, output_shape);
+      }
+#ifndef TF_GE_211
+      return Status::OK();
+#else
+      return OkStatus();
+#endif
+    });
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <tensorflow/core/framework/common_shape_fns.h>
+#include <tensorflow/core/framework/op.h>
+#include <tensorflow/core/framework/shape_inference.h>
+
+using namespace tensorflow;
+using namespace tensorflow::shape_inference;
+
+REGISTER_OP("Update")
+    .Input("keys: key_dtype")
+    .Input("vectors: dtype")
+    .Input("global_replica_id: int32")
+    .Output("status: string")
+    .Attr("key_dtype: {int32, int64}")
+    .Attr("model_name: string")
+    .Attr("table_id: int")
+    .Attr("dtype: {float32}")
+    .Input("init_status: status_dtype")
+    .Attr("status_dtype: {string}")
+    .SetShapeFn([](InferenceContext* ctx) {
+      ShapeHandle keys_shape;
+      TF_RETURN_IF_ERROR(ctx->WithRank(ctx->input(0), 1, &keys_shape));
+      ShapeHandle vectors_shape;
+      TF_RETURN_IF_ERROR(ctx->WithRank(ctx->input(1), 2, &vectors_shape));
+      DimensionHandle unused;
+      TF_RETURN_IF_ERROR(
+          ctx->Merge(ctx->Dim(keys_shape, 0), ctx->Dim(vectors_shape, 0), &unused));
+
+      ShapeHandle input_shape_2 = ctx->input(2);
+      DimensionHandle input_num_elem_2 = ctx->NumElements(input_shape_2);
+      if (1 != ctx->Value(input_num_elem_2)) {
+        return errors::InvalidArgument("global_replica_id must be a scalar.");
+      }
+      ctx->set_output(0, ctx->Scalar());
+#ifndef TF_GE_211
+      return Status::OK();
+#else
+      return OkStatus();
+#endif
+    });
@@ -212,3 +212,35 @@ class TestHPS:
                             )
                             flag = tf.reduce_all(tf.equal(embeddings, embeddings_gt))
                             assert True == flag
+
+    def test_update(cls):
+        model_name = "foo"
+        table_id = 0
+        emb_vec_size = hps_config["models"][0]["embedding_vecsize_per_table"][table_id]
+        keys = np.arange(1000, dtype=np.int32)
+        vectors = np.random.random((len(keys), emb_vec_size)).astype(np.float32)
+        status = hps.Update(
+            keys=tf.constant(keys),
+            vectors=tf.constant(vectors),
+            model_name=model_name,
+            table_id=table_id,
+            ps_config_file=args["ps_config_file"],
+            global_batch_size=args["global_batch_size"],
+        )
+        assert "OK" == status
+        cls.embedding_tables[model_name][table_id][keys] = vectors
+
+        lookup_layer = hps.LookupLayer(
+            model_name=model_name,
+            table_id=table_id,
+            emb_vec_size=emb_vec_size,
+            emb_vec_dtype=tf.float32,
+        )
+        # Both the updated and the untouched rows are looked up
+        dense_keys = _generate_dense_keys(args["global_batch_size"], [0, 2000], 10)
+        embeddings = lookup_layer(ids=dense_keys)
+        embeddings_gt = tf.nn.embedding_lookup(
+            params=cls.embedding_tables[model_name][table_id], ids=dense_keys
+        )
+        flag = tf.reduce_all(tf.equal(embeddings, embeddings_gt))
+        assert True == flag
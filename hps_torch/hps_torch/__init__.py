@@ -16,6 +16,6 @@
 
 print("[INFO] %s is imported" % __name__)
 
-from hps_torch.lookup_layer import LookupLayer
+from hps_torch.lookup_layer import LookupLayer, MultiTableLookupLayer
 
 __all__ = [item for item in dir() if not item.startswith("__")]
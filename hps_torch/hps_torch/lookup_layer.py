@@ -16,6 +16,7 @@
 
 import torch
 import os
+from typing import List
 
 install_path = os.path.abspath(os.path.join(os.path.dirname(__file__), "lib/libhps_torch.so"))
 torch.ops.load_library(install_path)
@@ -79,3 +80,61 @@ class LookupLayer(torch.nn.Module):
             keys, self.ps_config_file, self.model_name, self.table_id, self.emb_vec_size
         )
         return vectors
+
+
+class MultiTableLookupLayer(torch.nn.Module):
+    """
+    Abbreviated as ``hps_torch.MultiTableLookupLayer(*args, **kwargs)``.
+
+    This is a wrapper class for the HPS lookup of all the embedding tables of a model
+    in one op. It gives the same results as one ``LookupLayer`` per table, but the
+    tables are queried concurrently, and together if they are fused, which saves the
+    per-op overhead of models with many tables.
+
+    Parameters
+    ----------
+    ps_config_file: str
+            The JSON configuration file for HPS initialization.
+    model_name: str
+            The name of the model that has embedding tables.
+    emb_vec_sizes: List[int]
+            The embedding vector size of every embedding table of the model,
+            in the order of the table indices.
+
+    Examples
+    --------
+    .. code-block:: python
+        import torch
+        import hps_torch
+        lookup_layer = hps_torch.MultiTableLookupLayer(ps_config_file = args.ps_config_file,
+                                                       model_name = args.model_name,
+                                                       emb_vec_sizes = [16, 32])
+        keys = [torch.randint(0, 100, (16, 10), dtype=torch.int64).cuda(),
+                torch.randint(0, 100, (16, 3), dtype=torch.int64).cuda()]
+        vectors = lookup_layer(keys)
+    """
+
+    def __init__(self, ps_config_file: str, model_name: str, emb_vec_sizes: List[int]):
+        super().__init__()
+        self.ps_config_file = ps_config_file
+        self.model_name = model_name
+        self.emb_vec_sizes = emb_vec_sizes
+
+    def forward(self, keys: List[torch.Tensor]) -> List[torch.Tensor]:
+        """
+        The forward logic of this wrapper class.
+
+        Parameters
+        ----------
+        keys:
+                The keys of every table, in the order of the table indices. The supported
+                data types are ``torch.int32`` and ``torch.int64``.
+
+        Returns
+        -------
+        vectors: List of ``torch.Tensor`` of float32
+                the embedding vectors for the input keys of every table.
+        """
+        return torch.ops.hps_torch.hps_embedding_lookup_multi(
+            keys, self.ps_config_file, self.model_name, self.emb_vec_sizes
+        )
@@ -54,4 +54,47 @@ Tensor hps_embedding_lookup(const Tensor& input, const std::string& ps_config_fi
   return output;
 }
 
-TORCH_LIBRARY(hps_torch, m) { m.def("hps_embedding_lookup", &hps_embedding_lookup); }
\ No newline at end of file
+std::vector<Tensor> hps_embedding_lookup_multi(const std::vector<Tensor>& inputs,
+                                               const std::string& ps_config_file,
+                                               const std::string& model_name,
+                                               const std::vector<int64_t>& emb_vec_sizes) {
+  AT_ASSERTM(!inputs.empty(), "inputs must hold the keys of every table");
+  AT_ASSERTM(inputs.size() == emb_vec_sizes.size(),
+             "inputs and emb_vec_sizes must have one entry per table");
+  at::DeviceGuard guard(inputs[0].device());
+  Facade::instance()->init(ps_config_file.c_str(), pluginType_t::TENSORFLOW);
+
+  const int64_t device_id = inputs[0].device().index();
+  const bool i64_input_key = torch::kInt64 == inputs[0].dtype();
+  std::vector<Tensor> outputs;
+  std::vector<size_t> num_keys;
+  std::vector<size_t> vec_sizes;
+  std::vector<const void*> d_keys;
+  std::vector<void*> d_vectors;
+  for (size_t table_id = 0; table_id < inputs.size(); ++table_id) {
+    const Tensor& input = inputs[table_id];
+    AT_ASSERTM(input.is_contiguous(), "input tensor has to be contiguous");
+    AT_ASSERTM(input.is_cuda() && input.device().index() == device_id,
+               "inputs must be CUDA tensors on the same device");
+    AT_ASSERTM(input.dtype() == inputs[0].dtype(), "inputs must have the same dtype");
+
+    const int64_t batch_size = input.size(0);
+    const int64_t num_query = input.size(1);
+    outputs.push_back(at::zeros({batch_size, num_query, emb_vec_sizes[table_id]},
+                                input.options().dtype(at::kFloat)));
+    num_keys.push_back(batch_size * num_query);
+    vec_sizes.push_back(emb_vec_sizes[table_id]);
+    d_keys.push_back(input.data_ptr());
+    d_vectors.push_back(outputs.back().data_ptr<float>());
+  }
+
+  auto stream = at::cuda::getCurrentCUDAStream();
+  Facade::instance()->forward(model_name.c_str(), device_id, num_keys, vec_sizes, d_keys,
+                              d_vectors, i64_input_key, stream);
+  return outputs;
+}
+
+TORCH_LIBRARY(hps_torch, m) {
+  m.def("hps_embedding_lookup", &hps_embedding_lookup);
+  m.def("hps_embedding_lookup_multi", &hps_embedding_lookup_multi);
+}
\ No newline at end of file
@@ -140,3 +140,27 @@ def test_hps():
     mse = np.mean(diff * diff)
     assert mse <= 1e-6
     print(f"HPS Torch Plugin embedding lookup with table fusion, MSE: {mse} ")
+
+
+def test_hps_multi_table():
+    embedding_table = set_up_model_files()
+    lookup_layer = hps_torch.MultiTableLookupLayer(
+        f"{NUM_TABLES}_table.json", f"{NUM_TABLES}_table", [EMB_VEC_SIZE] * NUM_TABLES
+    )
+
+    inputs = [
+        torch.randint(
+            i * VOCAB_SIZE,
+            (i + 1) * VOCAB_SIZE,
+            (MAX_BATCH_SIZE, NUM_QUERY_KEY),
+            dtype=torch.int64,
+        ).cuda()
+        for i in range(NUM_TABLES)
+    ]
+    preds = lookup_layer(inputs)
+    assert len(preds) == NUM_TABLES
+    for i in range(NUM_TABLES):
+        diff = preds[i].cpu().numpy() - embedding_table[inputs[i].cpu().numpy()]
+        mse = np.mean(diff * diff)
+        assert mse <= 1e-6
+        print(f"HPS Torch Plugin multi-table embedding lookup, table {i}, MSE: {mse} ")
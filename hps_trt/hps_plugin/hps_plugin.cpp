@@ -15,10 +15,14 @@
  */
 
 #include <NvInfer.h>
+#include <cuda_bf16.h>
+#include <cuda_fp16.h>
 
 #include <hps_trt/hps_plugin/hps_plugin.hpp>
 #include <hps_trt/hps_plugin/trt_plugin_utils.hpp>
+#include <algorithm>
 #include <utility>
+#include <utils.hpp>
 
 using namespace nvinfer1;
 using nvinfer1::plugin::HpsPlugin;
@@ -31,13 +35,60 @@ std::vector<PluginField> HpsPluginCreator::mPluginAttributes;
 
 REGISTER_TENSORRT_PLUGIN(HpsPluginCreator);
 
+namespace {
+
+bool is_supported_output_type(const DataType type) {
+  switch (type) {
+    case DataType::kFLOAT:
+    case DataType::kHALF:
+#if NV_TENSORRT_MAJOR >= 9
+    case DataType::kBF16:
+#endif
+      return true;
+    default:
+      return false;
+  }
+}
+
+size_t output_type_size(const DataType type) {
+  return type == DataType::kFLOAT ? sizeof(float) : sizeof(__half);
+}
+
+// The lookup sessions produce fp32 vectors, which are narrowed into the output type here.
+void convert_vectors(const DataType type, void* const d_out, const float* const d_in,
+                     const size_t num_elements, const cudaStream_t stream) {
+  switch (type) {
+    case DataType::kHALF:
+      HugeCTR::convert_array_on_device(static_cast<__half*>(d_out), d_in, num_elements, stream);
+      break;
+#if NV_TENSORRT_MAJOR >= 9
+    case DataType::kBF16:
+      HugeCTR::convert_array_on_device(static_cast<__nv_bfloat16*>(d_out), d_in, num_elements,
+                                       stream);
+      break;
+#endif
+    default:
+      HCTR_LIB_THROW(cudaMemcpyAsync(d_out, d_in, num_elements * sizeof(float),
+                                     cudaMemcpyDeviceToDevice, stream));
+      break;
+  }
+}
+
+}  // namespace
+
 HpsPlugin::HpsPlugin(std::string name, std::string ps_config_file, std::string model_name,
-                     int32_t table_id, int32_t emb_vec_size)
+                     int32_t table_id, int32_t emb_vec_size, int32_t candidate_broadcast,
+                     DataType output_type)
     : mLayerName(std::move(name)),
       ps_config_file(std::move(ps_config_file)),
       model_name(std::move(model_name)),
       table_id(table_id),
-      emb_vec_size(emb_vec_size) {}
+      emb_vec_size(emb_vec_size),
+      candidate_broadcast(candidate_broadcast),
+      mVecType(output_type) {
+  HCTR_CHECK_HINT(is_supported_output_type(mVecType),
+                  "The output type of the HPS plugin should be float32, float16 or bfloat16");
+}
 
 HpsPlugin::HpsPlugin(std::string name, const void* data, size_t length)
     : mLayerName(std::move(name)) {
@@ -56,6 +107,10 @@ HpsPlugin::HpsPlugin(std::string name, const void* data, size_t length)
   mVecType = read<DataType>(d);
   mInputVolume = read<size_t>(d);
   mOutputVolume = read<size_t>(d);
+  // Engines serialized before the broadcast mode was added end here.
+  if (d < a + length) {
+    candidate_broadcast = read<int32_t>(d);
+  }
   HCTR_CHECK_HINT(d == (a + length), "The size for reading serialized data is not correct");
 }
 
@@ -70,11 +125,12 @@ int HpsPlugin::getNbOutputs() const noexcept { return 1; }
 DimsExprs HpsPlugin::getOutputDimensions(int32_t outputIndex, DimsExprs const* inputs,
                                          int32_t nbInputs, IExprBuilder& exprBuilder) noexcept {
   try {
-    HCTR_CHECK_HINT(nbInputs == 1, "The number of inputs should be 1");
+    HCTR_CHECK_HINT(nbInputs == (candidate_broadcast ? 2 : 1), "The number of inputs should be ",
+                    candidate_broadcast ? 2 : 1);
     HCTR_CHECK_HINT(inputs[0].nbDims == 2, "The dimensions of inputs[0] should be 2");
     DimsExprs ret;
     ret.nbDims = 3;
-    ret.d[0] = inputs[0].d[0];
+    ret.d[0] = candidate_broadcast ? inputs[1].d[0] : inputs[0].d[0];
     ret.d[1] = inputs[0].d[1];
     ret.d[2] = exprBuilder.constant(emb_vec_size);
     return ret;
@@ -86,17 +142,30 @@ DimsExprs HpsPlugin::getOutputDimensions(int32_t outputIndex, DimsExprs const* i
 
 DataType HpsPlugin::getOutputDataType(int32_t index, nvinfer1::DataType const* inputTypes,
                                       int32_t nbInputs) const noexcept {
-  return DataType::kFLOAT;
+  return mVecType;
 }
 
 size_t HpsPlugin::getWorkspaceSize(PluginTensorDesc const* inputs, int32_t nbInputs,
                                    PluginTensorDesc const* outputs,
                                    int32_t nbOutputs) const noexcept {
-  return 0;
+  // TensorRT asks for the workspace with the largest dimensions of each optimization profile, so
+  // the scratch space follows the profile rather than the max_batchsize of the HPS configuration.
+  const size_t num_lookup_elements =
+      static_cast<size_t>(inputs[0].dims.d[0]) * inputs[0].dims.d[1] * emb_vec_size;
+  size_t size = 0;
+  // The fp32 vectors are looked up here, unless they can be written into the output directly.
+  if (candidate_broadcast || mVecType != DataType::kFLOAT) {
+    size += num_lookup_elements * sizeof(float);
+  }
+  // The request-level vectors in the output type, before being broadcast into the output.
+  if (candidate_broadcast && mVecType != DataType::kFLOAT) {
+    size += num_lookup_elements * output_type_size(mVecType);
+  }
+  return size;
 }
 
 size_t HpsPlugin::getSerializationSize() const noexcept {
-  return 4 * sizeof(int32_t) + 2 * sizeof(DataType) + 2 * sizeof(size_t) + ps_config_file.size() +
+  return 5 * sizeof(int32_t) + 2 * sizeof(DataType) + 2 * sizeof(size_t) + ps_config_file.size() +
          model_name.size();
 }
 
@@ -110,10 +179,14 @@ bool HpsPlugin::supportsFormatCombination(int32_t pos, const PluginTensorDesc* i
     PluginTensorDesc const& input = inOut[0];
     return (input.type == mKeyType) && (input.format == TensorFormat::kLINEAR);
   }
-  if (pos == 1) {
-    const PluginTensorDesc& output = inOut[1];
+  if (pos == nbInputs) {
+    const PluginTensorDesc& output = inOut[nbInputs];
     return (output.type == mVecType) && (output.format == TensorFormat::kLINEAR);
   }
+  if (pos == 1) {
+    // Only the shape of the candidate input is used.
+    return inOut[1].format == TensorFormat::kLINEAR;
+  }
   return false;
 }
 
@@ -131,8 +204,53 @@ int32_t HpsPlugin::enqueue(PluginTensorDesc const* inputDesc, PluginTensorDesc c
     int32_t device_id;
     HCTR_LIB_THROW(cudaGetDevice(&device_id));
     bool i64_input_key = !(inputDesc->type == DataType::kINT32);
-    Facade::instance()->forward(model_name.c_str(), table_id, device_id, num_elements, emb_vec_size,
-                                inputs[0], outputs[0], i64_input_key, stream);
+    const size_t num_vector_elements = num_elements * emb_vec_size;
+    if (!candidate_broadcast) {
+      if (mVecType == DataType::kFLOAT) {
+        Facade::instance()->forward(model_name.c_str(), table_id, device_id, num_elements,
+                                    emb_vec_size, inputs[0], outputs[0], i64_input_key, stream);
+        return 0;
+      }
+      float* const d_vectors = static_cast<float*>(workspace);
+      Facade::instance()->forward(model_name.c_str(), table_id, device_id, num_elements,
+                                  emb_vec_size, inputs[0], d_vectors, i64_input_key, stream);
+      convert_vectors(mVecType, outputs[0], d_vectors, num_vector_elements, stream);
+      return 0;
+    }
+
+    const size_t num_requests = inputDesc[0].dims.d[0];
+    const size_t num_candidates = inputDesc[1].dims.d[0];
+    HCTR_CHECK_HINT(num_requests > 0 && num_candidates % num_requests == 0,
+                    "The number of candidates (", num_candidates,
+                    ") should be a multiple of the number of requests (", num_requests, ")");
+    float* const d_request_vectors = static_cast<float*>(workspace);
+    Facade::instance()->forward(model_name.c_str(), table_id, device_id, num_elements,
+                                emb_vec_size, inputs[0], d_request_vectors, i64_input_key, stream);
+    // Narrow the request rows once, instead of every broadcast copy of them.
+    void* d_converted_vectors = d_request_vectors;
+    if (mVecType != DataType::kFLOAT) {
+      d_converted_vectors = d_request_vectors + num_vector_elements;
+      convert_vectors(mVecType, d_converted_vectors, d_request_vectors, num_vector_elements,
+                      stream);
+    }
+
+    // Broadcast each request row with log2(N / R) doubling copies, instead of N / R copies.
+    const size_t row_bytes =
+        num_elements / num_requests * emb_vec_size * output_type_size(mVecType);
+    const size_t candidates_per_request = num_candidates / num_requests;
+    const char* const d_rows = static_cast<const char*>(d_converted_vectors);
+    char* const d_output = static_cast<char*>(outputs[0]);
+    for (size_t r = 0; r < num_requests; r++) {
+      char* const dst = d_output + r * candidates_per_request * row_bytes;
+      HCTR_LIB_THROW(cudaMemcpyAsync(dst, d_rows + r * row_bytes, row_bytes,
+                                     cudaMemcpyDeviceToDevice, stream));
+      for (size_t filled = 1; filled < candidates_per_request;) {
+        const size_t count = std::min(filled, candidates_per_request - filled);
+        HCTR_LIB_THROW(cudaMemcpyAsync(dst + filled * row_bytes, dst, count * row_bytes,
+                                       cudaMemcpyDeviceToDevice, stream));
+        filled += count;
+      }
+    }
     return 0;
   } catch (const std::exception& err) {
     HCTR_LOG_S(ERROR, WORLD) << err.what() << std::endl;
@@ -157,13 +275,15 @@ void HpsPlugin::serialize(void* buffer) const noexcept {
   write(d, mVecType);
   write(d, mInputVolume);
   write(d, mOutputVolume);
+  write(d, candidate_broadcast);
 
   HCTR_CHECK_HINT(d == a + getSerializationSize(), "The serialization size does not match");
 }
 
 IPluginV2DynamicExt* HpsPlugin::clone() const noexcept {
   try {
-    HpsPlugin* ret = new HpsPlugin(mLayerName, ps_config_file, model_name, table_id, emb_vec_size);
+    HpsPlugin* ret = new HpsPlugin(mLayerName, ps_config_file, model_name, table_id, emb_vec_size,
+                                   candidate_broadcast, mVecType);
     ret->mInputVolume = mInputVolume;
     ret->mOutputVolume = mOutputVolume;
     ret->setPluginNamespace(mNamespace.c_str());
@@ -180,6 +300,9 @@ HpsPluginCreator::HpsPluginCreator() {
   mPluginAttributes.emplace_back(PluginField("model_name", nullptr, PluginFieldType::kCHAR, 1));
   mPluginAttributes.emplace_back(PluginField("table_id", nullptr, PluginFieldType::kINT32, 1));
   mPluginAttributes.emplace_back(PluginField("emb_vec_size", nullptr, PluginFieldType::kINT32, 1));
+  mPluginAttributes.emplace_back(
+      PluginField("candidate_broadcast", nullptr, PluginFieldType::kINT32, 1));
+  mPluginAttributes.emplace_back(PluginField("output_dtype", nullptr, PluginFieldType::kINT32, 1));
 
   mFC.nbFields = mPluginAttributes.size();
   mFC.fields = mPluginAttributes.data();
@@ -194,13 +317,15 @@ const PluginFieldCollection* HpsPluginCreator::getFieldNames() noexcept { return
 IPluginV2DynamicExt* HpsPluginCreator::createPlugin(const char* name,
                                                     const PluginFieldCollection* fc) noexcept {
   try {
-    int32_t table_id{0}, emb_vec_size{0};
+    int32_t table_id{0}, emb_vec_size{0}, candidate_broadcast{0};
+    DataType output_type{DataType::kFLOAT};
     std::string model_name, ps_config_file;
     const PluginField* fields = fc->fields;
 
     validateRequiredAttributesExist({"ps_config_file", "model_name", "table_id", "emb_vec_size"},
                                     fc);
-    HCTR_CHECK_HINT(fc->nbFields == 4, "The number of fields for HPS plugin should 4");
+    HCTR_CHECK_HINT(fc->nbFields >= 4 && fc->nbFields <= 6,
+                    "The number of fields for HPS plugin should be 4, 5 or 6");
 
     for (int32_t i = 0; i < fc->nbFields; i++) {
       if (strcmp(fields[i].name, "ps_config_file") == 0) {
@@ -216,10 +341,18 @@ IPluginV2DynamicExt* HpsPluginCreator::createPlugin(const char* name,
       } else if (strcmp(fields[i].name, "emb_vec_size") == 0) {
         HCTR_CHECK_HINT(fields[i].type == PluginFieldType::kINT32, "emb_vec_size should be INT32");
         emb_vec_size = *(static_cast<const int32_t*>(fields[i].data));
+      } else if (strcmp(fields[i].name, "candidate_broadcast") == 0) {
+        HCTR_CHECK_HINT(fields[i].type == PluginFieldType::kINT32,
+                        "candidate_broadcast should be INT32");
+        candidate_broadcast = *(static_cast<const int32_t*>(fields[i].data));
+      } else if (strcmp(fields[i].name, "output_dtype") == 0) {
+        HCTR_CHECK_HINT(fields[i].type == PluginFieldType::kINT32, "output_dtype should be INT32");
+        output_type = static_cast<DataType>(*(static_cast<const int32_t*>(fields[i].data)));
       }
     }
     Facade::instance()->init(ps_config_file.c_str(), pluginType_t::TENSORRT);
-    return new HpsPlugin(name, ps_config_file, model_name, table_id, emb_vec_size);
+    return new HpsPlugin(name, ps_config_file, model_name, table_id, emb_vec_size,
+                         candidate_broadcast, output_type);
   } catch (const std::exception& err) {
     HCTR_LOG_S(ERROR, WORLD) << err.what() << std::endl;
   }
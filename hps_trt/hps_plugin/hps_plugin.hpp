@@ -35,8 +35,19 @@ namespace plugin {
 
 class HpsPlugin : public IPluginV2DynamicExt {
  public:
+  /**
+   * With `candidate_broadcast`, the plugin takes a second input, whose first dimension is the
+   * number of candidates N. The keys of the first input are request-level features, e.g. the user
+   * features of a ranking request, of shape [R, k] with R dividing N. They are looked up once, and
+   * each of the R rows is broadcast to N / R consecutive candidates of the [N, k, emb_vec_size]
+   * output.
+   *
+   * The embedding vectors are written as \p output_type , which is `kFLOAT`, `kHALF` or `kBF16`,
+   * so that fp16 networks do not need a cast layer after the plugin.
+   */
   HpsPlugin(std::string plugin_layer_name, std::string ps_config_file, std::string model_name,
-            int32_t table_id, int32_t emb_vec_size);
+            int32_t table_id, int32_t emb_vec_size, int32_t candidate_broadcast = 0,
+            DataType output_type = DataType::kFLOAT);
 
   HpsPlugin(std::string plugin_layer_name, const void* data, size_t length);
 
@@ -95,6 +106,7 @@ class HpsPlugin : public IPluginV2DynamicExt {
   std::string model_name;
   int32_t table_id;
   int32_t emb_vec_size;
+  int32_t candidate_broadcast{0};
   DataType mKeyType{DataType::kINT32};
   DataType mVecType{DataType::kFLOAT};
   size_t mInputVolume{0};
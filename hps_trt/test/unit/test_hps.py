@@ -129,7 +129,14 @@ def create_hps_plugin_creator():
     return hps_plugin_creator
 
 
-def create_hps_plugin(hps_plugin_creator, model_name, table_id, embedding_vec_size):
+def create_hps_plugin(
+    hps_plugin_creator,
+    model_name,
+    table_id,
+    embedding_vec_size,
+    candidate_broadcast=None,
+    output_dtype=None,
+):
     ps_config_file = trt.PluginField(
         "ps_config_file",
         np.array([args["ps_config_file"] + "\0"], dtype=np.string_),
@@ -144,7 +151,24 @@ def create_hps_plugin(hps_plugin_creator, model_name, table_id, embedding_vec_si
     emb_vec_size = trt.PluginField(
         "emb_vec_size", np.array([embedding_vec_size], dtype=np.int32), trt.PluginFieldType.INT32
     )
-    params = trt.PluginFieldCollection([ps_config_file, model_name, table_id, emb_vec_size])
+    fields = [ps_config_file, model_name, table_id, emb_vec_size]
+    if candidate_broadcast is not None:
+        fields.append(
+            trt.PluginField(
+                "candidate_broadcast",
+                np.array([candidate_broadcast], dtype=np.int32),
+                trt.PluginFieldType.INT32,
+            )
+        )
+    if output_dtype is not None:
+        fields.append(
+            trt.PluginField(
+                "output_dtype",
+                np.array([int(output_dtype)], dtype=np.int32),
+                trt.PluginFieldType.INT32,
+            )
+        )
+    params = trt.PluginFieldCollection(fields)
     hps_plugin = hps_plugin_creator.create_plugin(name="hps", field_collection=params)
     return hps_plugin
 
@@ -296,3 +320,107 @@ class TestHPS:
             print(mse1)
             print(mse2)
             assert mse1 <= 1e-6 and mse2 <= 1e-6
+
+    def test_build_engine3(self):
+        plugin4 = create_hps_plugin(self.hps_plugin_creator, "foo", 0, 16, candidate_broadcast=1)
+        with trt.Builder(TRT_LOGGER) as builder, builder.create_network(
+            EXPLICIT_BATCH
+        ) as network, builder.create_builder_config() as builder_config:
+            user_tensor = network.add_input(name="user", dtype=trt.int32, shape=(-1, 10))
+            item_tensor = network.add_input(name="item", dtype=trt.int32, shape=(-1, 1))
+            broadcast_hps_layer = network.add_plugin_v2(
+                inputs=[user_tensor, item_tensor], plugin=plugin4
+            )
+            broadcast_hps_layer.name = "broadcast_hps_layer"
+            broadcast_hps_layer.set_output_type(0, trt.float32)
+            broadcast_hps_layer.get_output(0).name = "output_3"
+            network.mark_output(broadcast_hps_layer.get_output(0))
+
+            profile = builder.create_optimization_profile()
+            profile.set_shape("user", (1, 10), (2, 10), (16, 10))
+            profile.set_shape("item", (1, 1), (256, 1), (1024, 1))
+            builder_config.add_optimization_profile(profile)
+
+            engine = builder.build_serialized_network(network, builder_config)
+            assert engine
+            with open("foo_broadcast.trt", "wb") as fout:
+                fout.write(engine)
+
+    def test_execute_engine3(self):
+        engine = load_engine("foo_broadcast.trt")
+
+        NUM_REQUESTS = 2
+        NUM_CANDIDATES = 200
+        KEY_DTYPE = np.int32
+        TARGET_DTYPE = np.float32
+        context = engine.create_execution_context()
+        context.set_input_shape("user", (NUM_REQUESTS, 10))
+        context.set_input_shape("item", (NUM_CANDIDATES, 1))
+
+        h_user = np.random.randint(30000, size=(NUM_REQUESTS, 10)).astype(KEY_DTYPE)
+        h_item = np.zeros((NUM_CANDIDATES, 1), dtype=KEY_DTYPE)
+        h_output = np.empty([NUM_CANDIDATES, 10, 16], dtype=TARGET_DTYPE)
+        d_user = cuda.mem_alloc(h_user.nbytes)
+        d_item = cuda.mem_alloc(h_item.nbytes)
+        d_output = cuda.mem_alloc(h_output.nbytes)
+        bindings = [int(d_user), int(d_item), int(d_output)]
+        stream = cuda.Stream()
+
+        cuda.memcpy_htod_async(d_user, h_user, stream)
+        cuda.memcpy_htod_async(d_item, h_item, stream)
+        context.execute_async_v2(bindings, stream.handle)
+        cuda.memcpy_dtoh_async(h_output, d_output, stream)
+        stream.synchronize()
+
+        # Each request row is repeated for its consecutive candidates.
+        ground_truth = np.repeat(
+            self.embedding_tables["foo"][0][h_user], NUM_CANDIDATES // NUM_REQUESTS, axis=0
+        )
+        diff = h_output.flatten() - ground_truth.flatten()
+        assert np.mean(diff * diff) <= 1e-6
+
+    def test_build_engine4(self):
+        plugin5 = create_hps_plugin(self.hps_plugin_creator, "foo", 0, 16, output_dtype=trt.float16)
+        with trt.Builder(TRT_LOGGER) as builder, builder.create_network(
+            EXPLICIT_BATCH
+        ) as network, builder.create_builder_config() as builder_config:
+            input_tensor = network.add_input(name="input", dtype=trt.int32, shape=(-1, 10))
+            half_hps_layer = network.add_plugin_v2(inputs=[input_tensor], plugin=plugin5)
+            half_hps_layer.name = "half_hps_layer"
+            half_hps_layer.set_output_type(0, trt.float16)
+            half_hps_layer.get_output(0).name = "output_4"
+            network.mark_output(half_hps_layer.get_output(0))
+
+            profile = builder.create_optimization_profile()
+            profile.set_shape("input", (1, 10), (64, 10), (256, 10))
+            builder_config.add_optimization_profile(profile)
+
+            engine = builder.build_serialized_network(network, builder_config)
+            assert engine
+            with open("foo_half.trt", "wb") as fout:
+                fout.write(engine)
+
+    def test_execute_engine4(self):
+        engine = load_engine("foo_half.trt")
+
+        BATCH_SIZE = 256
+        KEY_DTYPE = np.int32
+        TARGET_DTYPE = np.float16
+        context = engine.create_execution_context()
+        context.set_input_shape("input", (BATCH_SIZE, 10))
+
+        h_input = np.random.randint(30000, size=(BATCH_SIZE, 10)).astype(KEY_DTYPE)
+        h_output = np.empty([BATCH_SIZE, 10, 16], dtype=TARGET_DTYPE)
+        d_input = cuda.mem_alloc(h_input.nbytes)
+        d_output = cuda.mem_alloc(h_output.nbytes)
+        bindings = [int(d_input), int(d_output)]
+        stream = cuda.Stream()
+
+        cuda.memcpy_htod_async(d_input, h_input, stream)
+        context.execute_async_v2(bindings, stream.handle)
+        cuda.memcpy_dtoh_async(h_output, d_output, stream)
+        stream.synchronize()
+
+        ground_truth = self.embedding_tables["foo"][0][h_input]
+        diff = h_output.astype(np.float32).flatten() - ground_truth.flatten()
+        assert np.mean(diff * diff) <= 1e-6
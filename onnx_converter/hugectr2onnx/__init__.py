@@ -14,6 +14,6 @@
  limitations under the License.
 """
 
-__all__ = ["converter", "graph_builder", "hugectr_loader"]
+__all__ = ["converter", "graph_builder", "hugectr_loader", "external_data"]
 
-from hugectr2onnx import graph_builder, hugectr_loader, converter
+from hugectr2onnx import graph_builder, hugectr_loader, converter, external_data
@@ -16,7 +16,9 @@
 
 from hugectr2onnx.hugectr_loader import HugeCTRLoader, LayerParams
 from hugectr2onnx.graph_builder import GraphBuilder
+from hugectr2onnx.external_data import ExternalDataWriter
 import argparse
+import os
 
 
 def convert(
@@ -27,6 +29,8 @@ def convert(
     sparse_models=None,
     ntp_file=None,
     graph_name="hugectr",
+    external_data=False,
+    num_threads=None,
 ):
     """Convert a HugeCTR model to an ONNX model
     Args:
@@ -37,9 +41,20 @@ def convert(
         sparse_models: the files of the sparse embeddings for the HugeCTR model (optional)
         ntp_file: the file of the non-trainable parameters for the HugeCTR model (optional)
         graph_name: the graph name for the ONNX model (optional)
+        external_data: whether to stream the sparse embeddings from the mapped sparse model files
+            to ONNX external data files next to the ONNX model, instead of reading them into
+            memory as initializers (optional)
+        num_threads: the number of threads that write the external data (optional)
     """
-    loader = HugeCTRLoader(graph_config, dense_model, convert_embedding, sparse_models, ntp_file)
-    builder = GraphBuilder(convert_embedding)
+    loader = HugeCTRLoader(
+        graph_config, dense_model, convert_embedding, sparse_models, ntp_file, external_data
+    )
+    external_data_writer = None
+    if external_data:
+        model_dir = os.path.dirname(os.path.abspath(onnx_model_path))
+        prefix = os.path.splitext(os.path.basename(onnx_model_path))[0]
+        external_data_writer = ExternalDataWriter(model_dir, prefix, num_threads)
+    builder = GraphBuilder(convert_embedding, external_data_writer)
     for _ in range(loader.layers):
         layer_params, weights_dict, dimensions = loader.load_layer()
         print(f"[HUGECTR2ONNX][INFO]: Converting {layer_params.layer_type} layer to ONNX")
@@ -67,6 +82,17 @@ if __name__ == "__main__":
     parser.add_argument(
         "--graph_name", type=str, default="hugectr", help="Graph name for the ONNX model (optional)"
     )
+    parser.add_argument(
+        "--external_data",
+        action="store_true",
+        help="Stream sparse embeddings to ONNX external data files (optional)",
+    )
+    parser.add_argument(
+        "--num_threads",
+        type=int,
+        default=None,
+        help="Number of threads that write the external data (optional)",
+    )
     args = parser.parse_args()
     print(args)
     convert(
@@ -77,4 +103,6 @@ if __name__ == "__main__":
         args.sparse_models,
         args.ntp_file,
         args.graph_name,
+        args.external_data,
+        args.num_threads,
     )
@@ -0,0 +1,96 @@
+"""
+ Copyright (c) 2023, NVIDIA CORPORATION.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+"""
+
+from concurrent.futures import ThreadPoolExecutor
+from onnx import TensorProto
+import numpy as np
+import onnx
+import os
+
+
+class ExternalDataWriter(object):
+    def __init__(self, model_dir, prefix, num_threads=None, chunk_bytes=64 << 20):
+        """Create ExternalDataWriter, which writes initializers as ONNX external data
+        Args:
+            model_dir: str, directory of the ONNX model, the external data files are written there
+            prefix: str, prefix of the external data file names
+            num_threads: int, number of threads that write the chunks (optional)
+            chunk_bytes: int, bytes of a chunk (optional)
+        Every tensor is written to its own file. The file is created at its full size, with zeros,
+        then the blocks of rows are copied into it in chunks by a thread pool, so that only a few
+        chunks are in memory at a time. os.pwrite releases the GIL, the chunks are written in
+        parallel.
+        """
+        self.__model_dir = model_dir
+        self.__prefix = prefix
+        self.__num_threads = num_threads if num_threads else min(32, (os.cpu_count() or 1) + 4)
+        self.__chunk_bytes = chunk_bytes
+
+    def write(self, name, shape, dtype, blocks):
+        """Write a tensor as external data
+        Args:
+            name: str, initializer name
+            shape: tuple, tensor shape
+            dtype: numpy dtype of the tensor
+            blocks: List[(int, np.ndarray)], the arrays, memory mapped or not, copied to the rows
+                    starting at the given row; the other rows are zeros
+        Returns:
+            TensorProto that refers to the external data
+        """
+        dtype = np.dtype(dtype)
+        row_bytes = int(np.prod(shape[1:], dtype=np.int64)) * dtype.itemsize if shape else 0
+        num_bytes = int(np.prod(shape, dtype=np.int64)) * dtype.itemsize
+        location = "{}.{}.bin".format(self.__prefix, name)
+        path = os.path.join(self.__model_dir, location)
+
+        with open(path, "wb") as file:
+            file.truncate(num_bytes)
+        fd = os.open(path, os.O_WRONLY)
+        try:
+            rows_per_chunk = max(1, self.__chunk_bytes // max(1, row_bytes))
+
+            def write_chunk(array, begin, end, offset):
+                data = np.ascontiguousarray(array[begin:end], dtype=dtype).tobytes()
+                written = 0
+                while written < len(data):
+                    written += os.pwrite(fd, data[written:], offset + written)
+
+            with ThreadPoolExecutor(max_workers=self.__num_threads) as executor:
+                futures = []
+                for first_row, array in blocks:
+                    for begin in range(0, len(array), rows_per_chunk):
+                        end = min(begin + rows_per_chunk, len(array))
+                        offset = (first_row + begin) * row_bytes
+                        futures.append(executor.submit(write_chunk, array, begin, end, offset))
+                for future in futures:
+                    future.result()
+        finally:
+            os.close(fd)
+
+        tensor = TensorProto()
+        tensor.name = name
+        tensor.data_type = onnx.mapping.NP_TYPE_TO_TENSOR_TYPE[dtype]
+        tensor.dims.extend(shape)
+        tensor.data_location = TensorProto.EXTERNAL
+        for key, value in (("location", location), ("offset", "0"), ("length", str(num_bytes))):
+            entry = tensor.external_data.add()
+            entry.key = key
+            entry.value = value
+        return tensor
+
+    def write_array(self, name, array):
+        """Write a numpy array as external data"""
+        return self.write(name, array.shape, array.dtype, [(0, array)])
@@ -21,12 +21,16 @@ import onnx
 
 
 class GraphBuilder(object):
-    def __init__(self, convert_embedding):
+    def __init__(self, convert_embedding, external_data_writer=None):
         """Create GraphBuilder
         Args:
             convert_embedding: boolean, whether converting sparse embedding models to ONNX
+            external_data_writer: ExternalDataWriter, writes the embedding tables and the key to
+                                  indice hash as external data if not None (optional)
         """
         self.__convert_embeddding = convert_embedding
+        self.__external_data_writer = external_data_writer
+        self.__hps_references = {}
         self.__nodes = []
         self.__initializers = []
         self.__inputs = []
@@ -76,33 +80,55 @@ class GraphBuilder(object):
             self.__key_to_indice_hash_all_tables = weights_dict["key_to_indice_hash_all_tables"]
             key_to_indice_hash_all_tables = weights_dict["key_to_indice_hash_all_tables"]
             key_to_indice_hash_all_tables_name = "key_to_indice_hash_all_tables"
-            self.__initializers.append(
-                helper.make_tensor(
-                    name=key_to_indice_hash_all_tables_name,
-                    data_type=onnx.mapping.NP_TYPE_TO_TENSOR_TYPE[
-                        key_to_indice_hash_all_tables.dtype
-                    ],
-                    dims=key_to_indice_hash_all_tables.shape,
-                    vals=key_to_indice_hash_all_tables.flatten(),
+            # The hash is finalized in create_graph, the external data is only written there
+            if self.__external_data_writer is not None:
+                self.__initializers.append(
+                    helper.make_tensor(
+                        name=key_to_indice_hash_all_tables_name,
+                        data_type=TensorProto.INT64,
+                        dims=[0],
+                        vals=[],
+                    )
+                )
+            else:
+                self.__initializers.append(
+                    helper.make_tensor(
+                        name=key_to_indice_hash_all_tables_name,
+                        data_type=onnx.mapping.NP_TYPE_TO_TENSOR_TYPE[
+                            key_to_indice_hash_all_tables.dtype
+                        ],
+                        dims=key_to_indice_hash_all_tables.shape,
+                        vals=key_to_indice_hash_all_tables.flatten(),
+                    )
                 )
-            )
         elif (
             layer_type == "DistributedSlotSparseEmbeddingHash"
             or layer_type == "LocalizedSlotSparseEmbeddingHash"
         ):
             if self.__convert_embeddding:
-                embedding_table = weights_dict["embedding_table"]
                 embedding_table_name = layer_params.top_names[0] + "_embedding_table"
                 indice_name = layer_params.top_names[0] + "_indice"
                 embedding_feature_name = layer_params.top_names[0] + "_embedding_feature"
-                self.__initializers.append(
-                    helper.make_tensor(
-                        name=embedding_table_name,
-                        data_type=onnx.mapping.NP_TYPE_TO_TENSOR_TYPE[embedding_table.dtype],
-                        dims=embedding_table.shape,
-                        vals=embedding_table.flatten(),
+                if "sparse_model_file" in weights_dict:
+                    # indice 0 is reserved for default values of non-exisiting keys
+                    self.__initializers.append(
+                        self.__external_data_writer.write(
+                            embedding_table_name,
+                            weights_dict["embedding_table_shape"],
+                            np.float32,
+                            [(1, weights_dict["sparse_model_file"].vectors)],
+                        )
+                    )
+                else:
+                    embedding_table = weights_dict["embedding_table"]
+                    self.__initializers.append(
+                        helper.make_tensor(
+                            name=embedding_table_name,
+                            data_type=onnx.mapping.NP_TYPE_TO_TENSOR_TYPE[embedding_table.dtype],
+                            dims=embedding_table.shape,
+                            vals=embedding_table.flatten(),
+                        )
                     )
-                )
                 self.__nodes.append(
                     helper.make_node(
                         op_type="Gather",
@@ -141,6 +167,8 @@ class GraphBuilder(object):
                         ],
                     )
                 )
+                if "sparse_model" in weights_dict:
+                    self.__hps_references[layer_params.top_names[0]] = weights_dict["sparse_model"]
         elif layer_type == "Add":
             for i in range(len(layer_params.bottom_names) - 1):
                 x_name = (
@@ -1501,9 +1529,14 @@ class GraphBuilder(object):
 
     def create_graph(self, name="hugectr_graph"):
         # Finalize key to indice hash
-        key_to_indice_tensor = numpy_helper.from_array(
-            self.__key_to_indice_hash_all_tables, "key_to_indice_hash_all_tables"
-        )
+        if self.__external_data_writer is not None:
+            key_to_indice_tensor = self.__external_data_writer.write_array(
+                "key_to_indice_hash_all_tables", self.__key_to_indice_hash_all_tables
+            )
+        else:
+            key_to_indice_tensor = numpy_helper.from_array(
+                self.__key_to_indice_hash_all_tables, "key_to_indice_hash_all_tables"
+            )
         self.__initializers[0].CopyFrom(key_to_indice_tensor)
         # Create the graph (GraphProto)
         self.__graph_def = helper.make_graph(
@@ -1515,6 +1548,15 @@ class GraphBuilder(object):
         model_def = helper.make_model(self.__graph_def)
         model_def.opset_import[0].version = op_version
         model_def.ir_version = ir_version
+        # The embedding inputs of the graph that can be looked up by HPS in the sparse models
+        if self.__hps_references:
+            helper.set_model_props(
+                model_def,
+                {
+                    "hugectr.sparse_model." + name: sparse_model
+                    for name, sparse_model in self.__hps_references.items()
+                },
+            )
         onnx.checker.check_model(model_def)
         print("[HUGECTR2ONNX][INFO]: The model is checked!")
         onnx.save(model_def, model_path)
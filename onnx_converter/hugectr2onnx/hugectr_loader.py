@@ -65,6 +65,32 @@ def get_tensor_names(clause):
         return []
 
 
+class SparseModelFile(object):
+    def __init__(self, path, embedding_vec_size):
+        """Map the keys and embedding vectors of a sparse model folder
+        Args:
+            path: str, sparse model folder, with the files key and emb_vector
+            embedding_vec_size: int, embedding vector size
+        The files are memory mapped rather than read, the vectors are paged in as they are used.
+        """
+        self.path = path
+        keys = np.memmap(os.path.join(path, "key"), dtype=np.int64, mode="r")
+        vectors = np.memmap(os.path.join(path, "emb_vector"), dtype=np.float32, mode="r")
+        self.num_keys = min(keys.shape[0], vectors.shape[0] // embedding_vec_size)
+        self.keys = keys[: self.num_keys]
+        self.vectors = vectors[: self.num_keys * embedding_vec_size].reshape(
+            self.num_keys, embedding_vec_size
+        )
+
+    def fill_key_to_indice(self, key_to_indice, first_indice, chunk_size=1 << 24):
+        """Map the i-th key to the indice first_indice + i, one chunk of keys at a time"""
+        for begin in range(0, self.num_keys, chunk_size):
+            end = min(begin + chunk_size, self.num_keys)
+            key_to_indice[self.keys[begin:end]] = np.arange(
+                first_indice + begin, first_indice + end, dtype=np.int64
+            )
+
+
 class LayerParams(object):
     def __init__(self):
         """Create LayerParams for HugeCTR"""
@@ -112,7 +138,13 @@ class LayerParams(object):
 
 class HugeCTRLoader(object):
     def __init__(
-        self, graph_config, dense_model, convert_embedding=False, sparse_models=None, ntp_file=None
+        self,
+        graph_config,
+        dense_model,
+        convert_embedding=False,
+        sparse_models=None,
+        ntp_file=None,
+        streaming=False,
     ):
         """Create HugeCTRLoader
         Args:
@@ -121,11 +153,14 @@ class HugeCTRLoader(object):
             convert_embedding: boolean, whether converting sparse embedding models to ONNX
             sparse_models: List[str], sparse model files
             ntp_file: str, file that stores non-trainable parameters
+            streaming: boolean, whether to pass the mapped sparse model files to the graph builder
+                       instead of embedding tables read into memory
         """
         self.__graph_config = graph_config
         self.__dense_model = dense_model
         self.__convert_embeddding = convert_embedding
         self.__sparse_models = sparse_models
+        self.__streaming = streaming
         self.__ntp_file = ntp_file
         self.__layers_config = json.load(open(graph_config, "rb"))["layers"]
         self.__layers = len(self.__layers_config)
@@ -213,34 +248,30 @@ class HugeCTRLoader(object):
                 max_vocab_size_global = layer_config["sparse_embedding_hparam"][
                     "max_vocabulary_size_global"
                 ]
-                # indice 0 is reserved for default values of non-exisiting keys
-                embedding_table = np.zeros(
-                    shape=(max_vocab_size_global + 1, embedding_vec_size), dtype=np.float32
+                sparse_model_file = SparseModelFile(
+                    self.__sparse_models[self.__embedding_counter], embedding_vec_size
                 )
-                with open(
-                    self.__sparse_models[self.__embedding_counter] + "/key", "rb"
-                ) as key_file, open(
-                    self.__sparse_models[self.__embedding_counter] + "/emb_vector", "rb"
-                ) as vec_file:
-                    try:
-                        # indice 0 is reserved for default values of non-exisiting keys
-                        indice = 1
-                        while True:
-                            key_buffer = key_file.read(8)
-                            vec_buffer = vec_file.read(4 * embedding_vec_size)
-                            if len(key_buffer) == 0 or len(vec_buffer) == 0:
-                                break
-                            key = struct.unpack("q", key_buffer)[0]
-                            values = struct.unpack(str(embedding_vec_size) + "f", vec_buffer)
-                            self.key_to_indice_hash_all_tables[key] = indice
-                            embedding_table[indice] = values
-                            indice += 1
-                    except BaseException as error:
-                        print(error)
-                layer_weights_dict["embedding_table"] = embedding_table
+                # indice 0 is reserved for default values of non-exisiting keys
+                sparse_model_file.fill_key_to_indice(self.key_to_indice_hash_all_tables, 1)
+                embedding_table_shape = (max_vocab_size_global + 1, embedding_vec_size)
+                if self.__streaming:
+                    layer_weights_dict["sparse_model_file"] = sparse_model_file
+                    layer_weights_dict["embedding_table_shape"] = embedding_table_shape
+                else:
+                    embedding_table = np.zeros(shape=embedding_table_shape, dtype=np.float32)
+                    embedding_table[1 : sparse_model_file.num_keys + 1] = sparse_model_file.vectors
+                    layer_weights_dict["embedding_table"] = embedding_table
                 self.__embedding_counter += 1
             else:
                 print("Skip sparse embedding layers in converted ONNX model")
+                # The sparse model can still be served by HPS next to the ONNX model
+                if self.__sparse_models is not None and self.__embedding_counter < len(
+                    self.__sparse_models
+                ):
+                    layer_weights_dict["sparse_model"] = self.__sparse_models[
+                        self.__embedding_counter
+                    ]
+                    self.__embedding_counter += 1
         elif layer_type == "Add":
             self.__dimensions[layer_config["top"]] = self.__dimensions[layer_config["bottom"][0]]
         elif layer_type == "BatchNorm":
@@ -78,4 +78,126 @@ template class LookupLauncher<int32_t, float>;
 template class LookupLauncher<int64_t, __half>;
 template class LookupLauncher<int32_t, __half>;
 
+template <typename KeyType, typename OffsetType, typename DataType>
+__global__ static void FusedLookupCombineKernel(
+    LookupCombineTask<KeyType, OffsetType, DataType> *task, size_t num_tasks) {
+  for (size_t i = 0; i < num_tasks; ++i) {
+    const float *input = reinterpret_cast<const float *>(task[i].input);
+    const KeyType *key = reinterpret_cast<const KeyType *>(task[i].key);
+    const OffsetType *row_split = reinterpret_cast<const OffsetType *>(task[i].row_split);
+    int32_t dimension = task[i].dimension;
+    int32_t combiner = task[i].combiner;
+    DataType *output = reinterpret_cast<DataType *>(task[i].output);
+
+    size_t thread_cnt = blockDim.x * gridDim.x;
+    size_t thread_idx = blockDim.x * blockIdx.x + threadIdx.x;
+    size_t items = static_cast<size_t>(task[i].batch_size) * dimension;
+    for (size_t j = thread_idx; j < items; j += thread_cnt) {
+      size_t sample = j / dimension;
+      size_t col = j % dimension;
+      OffsetType start = row_split[sample];
+      OffsetType end = row_split[sample + 1];
+      float sum = 0.0f;
+      for (OffsetType k = start; k < end; ++k) {
+        sum += input[static_cast<size_t>(key[k]) * dimension + col];
+      }
+      if (combiner == 1 && end > start) {
+        sum /= static_cast<float>(end - start);
+      }
+      output[j] = sum;
+    }
+  }
+}
+
+template <typename KeyType, typename OffsetType, typename DataType>
+__global__ static void FusedLookupCombineGradKernel(
+    LookupCombineTask<KeyType, OffsetType, DataType> *task, size_t num_tasks) {
+  for (size_t i = 0; i < num_tasks; ++i) {
+    const DataType *input = reinterpret_cast<const DataType *>(task[i].input);
+    const OffsetType *row_split = reinterpret_cast<const OffsetType *>(task[i].row_split);
+    int32_t dimension = task[i].dimension;
+    int32_t batch_size = task[i].batch_size;
+    int32_t combiner = task[i].combiner;
+    float *output = reinterpret_cast<float *>(task[i].output);
+
+    size_t thread_cnt = blockDim.x * gridDim.x;
+    size_t thread_idx = blockDim.x * blockIdx.x + threadIdx.x;
+    size_t items = static_cast<size_t>(task[i].num_keys) * dimension;
+    for (size_t j = thread_idx; j < items; j += thread_cnt) {
+      OffsetType k = static_cast<OffsetType>(j / dimension);
+      size_t col = j % dimension;
+
+      // The sample of key k is the last one whose row_split is not greater than k
+      int32_t lo = 0;
+      int32_t hi = batch_size;
+      while (hi - lo > 1) {
+        int32_t mid = (lo + hi) / 2;
+        if (row_split[mid] <= k) {
+          lo = mid;
+        } else {
+          hi = mid;
+        }
+      }
+      float grad = static_cast<float>(input[static_cast<size_t>(lo) * dimension + col]);
+      if (combiner == 1) {
+        grad /= static_cast<float>(row_split[lo + 1] - row_split[lo]);
+      }
+      output[j] = grad;
+    }
+  }
+}
+
+template <typename KeyType, typename OffsetType, typename DataType>
+LookupCombineLauncher<KeyType, OffsetType, DataType>::LookupCombineLauncher()
+    : num_tasks_(0), d_tasks_(nullptr) {
+  int device;
+  CUDACHECK(cudaGetDevice(&device));
+  CUDACHECK(cudaDeviceGetAttribute(&sm_count_, cudaDevAttrMultiProcessorCount, device));
+}
+
+template <typename KeyType, typename OffsetType, typename DataType>
+LookupCombineLauncher<KeyType, OffsetType, DataType>::~LookupCombineLauncher() {
+  if (d_tasks_) {
+    CUDACHECK(cudaFree(d_tasks_));
+    d_tasks_ = nullptr;
+  }
+}
+
+template <typename KeyType, typename OffsetType, typename DataType>
+void LookupCombineLauncher<KeyType, OffsetType, DataType>::initialize(size_t num_tasks) {
+  if (d_tasks_) return;
+  num_tasks_ = num_tasks;
+  CUDACHECK(cudaMalloc(&d_tasks_,
+                       sizeof(LookupCombineTask<KeyType, OffsetType, DataType>) * num_tasks));
+}
+
+template <typename KeyType, typename OffsetType, typename DataType>
+void LookupCombineLauncher<KeyType, OffsetType, DataType>::forward(
+    std::vector<LookupCombineTask<KeyType, OffsetType, DataType>> &h_tasks, cudaStream_t stream) {
+  size_t size = sizeof(LookupCombineTask<KeyType, OffsetType, DataType>) * h_tasks.size();
+  CUDACHECK(cudaMemcpyAsync(d_tasks_, h_tasks.data(), size, cudaMemcpyHostToDevice, stream));
+  FusedLookupCombineKernel<KeyType, OffsetType, DataType>
+      <<<2 * sm_count_, 1024ul, 0, stream>>>(d_tasks_, num_tasks_);
+  CUDACHECK(cudaGetLastError());
+}
+
+template <typename KeyType, typename OffsetType, typename DataType>
+void LookupCombineLauncher<KeyType, OffsetType, DataType>::backward(
+    std::vector<LookupCombineTask<KeyType, OffsetType, DataType>> &h_tasks, cudaStream_t stream) {
+  size_t size = sizeof(LookupCombineTask<KeyType, OffsetType, DataType>) * h_tasks.size();
+  CUDACHECK(cudaMemcpyAsync(d_tasks_, h_tasks.data(), size, cudaMemcpyHostToDevice, stream));
+  FusedLookupCombineGradKernel<KeyType, OffsetType, DataType>
+      <<<2 * sm_count_, 1024ul, 0, stream>>>(d_tasks_, num_tasks_);
+  CUDACHECK(cudaGetLastError());
+}
+
+template class LookupCombineLauncher<int64_t, int64_t, float>;
+template class LookupCombineLauncher<int32_t, int64_t, float>;
+template class LookupCombineLauncher<int64_t, int32_t, float>;
+template class LookupCombineLauncher<int32_t, int32_t, float>;
+template class LookupCombineLauncher<int64_t, int64_t, __half>;
+template class LookupCombineLauncher<int32_t, int64_t, __half>;
+template class LookupCombineLauncher<int64_t, int32_t, __half>;
+template class LookupCombineLauncher<int32_t, int32_t, __half>;
+
 }  // namespace sok
@@ -47,6 +47,42 @@ class LookupLauncher {
   int sm_count_;
 };
 
+// One table of a fused lookup + combiner. The keys of sample b are key[row_split[b],
+// row_split[b + 1]), so the shapes of all the outputs are known from the input shapes.
+template <typename KeyType, typename OffsetType, typename DataType>
+struct LookupCombineTask {
+  const void *input;  // forward: the embedding table, backward: the gradient of the output
+  const void *key;
+  const void *row_split;
+  int32_t dimension;
+  int32_t batch_size;
+  int32_t num_keys;
+  int32_t combiner;  // 0: sum, 1: mean
+  void *output;      // forward: [batch_size, dimension], backward: [num_keys, dimension]
+};
+
+template <typename KeyType, typename OffsetType, typename DataType>
+class LookupCombineLauncher {
+ public:
+  LookupCombineLauncher();
+  ~LookupCombineLauncher();
+
+  void initialize(size_t num_tasks);
+
+  void forward(std::vector<LookupCombineTask<KeyType, OffsetType, DataType>> &h_tasks,
+               cudaStream_t stream = 0);
+
+  // Writes the gradient of every key, the rows are not reduced by key.
+  void backward(std::vector<LookupCombineTask<KeyType, OffsetType, DataType>> &h_tasks,
+                cudaStream_t stream = 0);
+
+ private:
+  size_t num_tasks_;
+  LookupCombineTask<KeyType, OffsetType, DataType> *d_tasks_;
+
+  int sm_count_;
+};
+
 }  // namespace sok
 
 #endif
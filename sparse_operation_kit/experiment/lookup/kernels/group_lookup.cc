@@ -15,6 +15,7 @@
  */
 
 // clang-format off
+#include <string>
 #include <vector>
 
 #include <cuda_fp16.h>
@@ -125,4 +126,167 @@ REGISTER_GPU_KERNELS(int32_t, int32_t, Eigen::half, __half);
 
 #undef REGISTER_GPU_KERNELS
 
+template <typename KeyType, typename OffsetType, typename DType>
+class GroupLookupCombineBase : public OpKernel {
+ public:
+  explicit GroupLookupCombineBase(OpKernelConstruction* ctx) : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("N", &N_));
+    std::vector<std::string> combiners;
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("combiners", &combiners));
+    OP_REQUIRES(ctx, combiners.size() == static_cast<size_t>(N_),
+                errors::InvalidArgument("len(combiners) != N."));
+
+    tasks_.resize(N_);
+    for (int i = 0; i < N_; ++i) {
+      if (combiners[i] == "sum") {
+        tasks_[i].combiner = 0;
+      } else if (combiners[i] == "mean") {
+        tasks_[i].combiner = 1;
+      } else {
+        OP_REQUIRES(ctx, false,
+                    errors::InvalidArgument("Unsupported combiner: ", combiners[i],
+                                            ", only sum and mean are supported."));
+      }
+    }
+    launcher_.initialize(N_);
+  }
+
+ protected:
+  // Sets the keys and the row splits of tasks_[i] from the inputs N + i and 2 * N + i
+  void set_keys(OpKernelContext* ctx, int i) {
+    const Tensor& indices = ctx->input(N_ + i);
+    const Tensor& row_splits = ctx->input(2 * N_ + i);
+    OP_REQUIRES(ctx, row_splits.NumElements() >= 1,
+                errors::InvalidArgument("row_splits must have at least one element."));
+    tasks_[i].key = indices.data();
+    tasks_[i].num_keys = indices.NumElements();
+    tasks_[i].row_split = row_splits.data();
+    tasks_[i].batch_size = row_splits.NumElements() - 1;
+  }
+
+  // The number of single lookup operations
+  int N_;
+  std::vector<sok::LookupCombineTask<KeyType, OffsetType, DType>> tasks_;
+  sok::LookupCombineLauncher<KeyType, OffsetType, DType> launcher_;
+};
+
+template <typename KeyType, typename OffsetType, typename DType>
+class GroupLookupCombineOp : public GroupLookupCombineBase<KeyType, OffsetType, DType> {
+ public:
+  explicit GroupLookupCombineOp(OpKernelConstruction* ctx)
+      : GroupLookupCombineBase<KeyType, OffsetType, DType>(ctx) {}
+
+  void Compute(OpKernelContext* ctx) override {
+    std::vector<tf_shared_lock> locks;
+    for (int i = 0; i < this->N_; ++i) {
+      auto handle = HandleFromInput(ctx, i);
+      auto dtypes_and_shapes = handle.dtypes_and_shapes();
+      auto shape = dtypes_and_shapes[0].shape;
+      OP_REQUIRES(ctx, dtypes_and_shapes[0].dtype == DataType::DT_FLOAT,
+                  errors::InvalidArgument("Type of variable must be float."));
+      this->tasks_[i].dimension = shape.dim_size(1);
+
+      core::RefCountPtr<Var> var;
+      OP_REQUIRES_OK(ctx, LookupResource(ctx, handle, &var));
+      const float* input = var->tensor()->flat<float>().data();
+      bool is_unique = true;
+      for (int j = 0; j < i; ++j) {
+        if (input == this->tasks_[j].input) {
+          is_unique = false;
+          break;
+        }
+      }
+      if (is_unique) {
+        tf_shared_lock lock(*var->mu());
+        locks.push_back(std::move(lock));
+      }
+      this->tasks_[i].input = input;
+
+      this->set_keys(ctx, i);
+      if (!ctx->status().ok()) return;
+
+      Tensor* output = nullptr;
+      OP_REQUIRES_OK(ctx, ctx->allocate_output(
+                              i, {this->tasks_[i].batch_size, shape.dim_size(1)}, &output));
+      this->tasks_[i].output = output->data();
+    }
+
+    auto device_ctx = ctx->op_device_context();
+    OP_REQUIRES(ctx, device_ctx != nullptr, errors::Aborted("No valid device context."));
+    auto stream = stream_executor::gpu::AsGpuStreamValue(device_ctx->stream());
+
+    this->launcher_.forward(this->tasks_, stream);
+  }
+};
+
+template <typename KeyType, typename OffsetType, typename DType>
+class GroupLookupCombineGradOp : public GroupLookupCombineBase<KeyType, OffsetType, DType> {
+ public:
+  explicit GroupLookupCombineGradOp(OpKernelConstruction* ctx)
+      : GroupLookupCombineBase<KeyType, OffsetType, DType>(ctx) {}
+
+  void Compute(OpKernelContext* ctx) override {
+    for (int i = 0; i < this->N_; ++i) {
+      const Tensor& top_grad = ctx->input(i);
+      OP_REQUIRES(ctx, top_grad.dims() == 2,
+                  errors::InvalidArgument("Rank of top_grads must be 2."));
+      this->tasks_[i].input = top_grad.data();
+      this->tasks_[i].dimension = top_grad.dim_size(1);
+
+      this->set_keys(ctx, i);
+      if (!ctx->status().ok()) return;
+      OP_REQUIRES(ctx, top_grad.dim_size(0) == this->tasks_[i].batch_size,
+                  errors::InvalidArgument("top_grads and row_splits disagree on batch size."));
+
+      Tensor* grad = nullptr;
+      OP_REQUIRES_OK(ctx, ctx->allocate_output(
+                              i, {this->tasks_[i].num_keys, top_grad.dim_size(1)}, &grad));
+      this->tasks_[i].output = grad->data();
+    }
+
+    auto device_ctx = ctx->op_device_context();
+    OP_REQUIRES(ctx, device_ctx != nullptr, errors::Aborted("No valid device context."));
+    auto stream = stream_executor::gpu::AsGpuStreamValue(device_ctx->stream());
+
+    this->launcher_.backward(this->tasks_, stream);
+  }
+};
+
+#define REGISTER_GPU_KERNELS(key_type_tf, key_type, offset_type_tf, offset_type, dtype_tf, dtype) \
+  REGISTER_KERNEL_BUILDER(Name("GroupLookupCombine")                                              \
+                              .Device(DEVICE_GPU)                                                 \
+                              .HostMemory("handles")                                              \
+                              .TypeConstraint<key_type_tf>("Tindices")                            \
+                              .TypeConstraint<offset_type_tf>("Toffsets")                         \
+                              .TypeConstraint<dtype_tf>("dtype"),                                 \
+                          GroupLookupCombineOp<key_type, offset_type, dtype>)                     \
+  REGISTER_KERNEL_BUILDER(Name("GroupLookupCombineGrad")                                          \
+                              .Device(DEVICE_GPU)                                                 \
+                              .TypeConstraint<key_type_tf>("Tindices")                            \
+                              .TypeConstraint<offset_type_tf>("Toffsets")                         \
+                              .TypeConstraint<dtype_tf>("dtype"),                                 \
+                          GroupLookupCombineGradOp<key_type, offset_type, dtype>)
+
+#if TF_VERSION_MAJOR == 1
+REGISTER_GPU_KERNELS(int64, int64_t, int64, int64_t, float, float);
+REGISTER_GPU_KERNELS(int32, int32_t, int64, int64_t, float, float);
+REGISTER_GPU_KERNELS(int64, int64_t, int32, int32_t, float, float);
+REGISTER_GPU_KERNELS(int32, int32_t, int32, int32_t, float, float);
+REGISTER_GPU_KERNELS(int64, int64_t, int64, int64_t, Eigen::half, __half);
+REGISTER_GPU_KERNELS(int32, int32_t, int64, int64_t, Eigen::half, __half);
+REGISTER_GPU_KERNELS(int64, int64_t, int32, int32_t, Eigen::half, __half);
+REGISTER_GPU_KERNELS(int32, int32_t, int32, int32_t, Eigen::half, __half);
+#else
+REGISTER_GPU_KERNELS(int64_t, int64_t, int64_t, int64_t, float, float);
+REGISTER_GPU_KERNELS(int32_t, int32_t, int64_t, int64_t, float, float);
+REGISTER_GPU_KERNELS(int64_t, int64_t, int32_t, int32_t, float, float);
+REGISTER_GPU_KERNELS(int32_t, int32_t, int32_t, int32_t, float, float);
+REGISTER_GPU_KERNELS(int64_t, int64_t, int64_t, int64_t, Eigen::half, __half);
+REGISTER_GPU_KERNELS(int32_t, int32_t, int64_t, int64_t, Eigen::half, __half);
+REGISTER_GPU_KERNELS(int64_t, int64_t, int32_t, int32_t, Eigen::half, __half);
+REGISTER_GPU_KERNELS(int32_t, int32_t, int32_t, int32_t, Eigen::half, __half);
+#endif
+
+#undef REGISTER_GPU_KERNELS
+
 }  // namespace tensorflow
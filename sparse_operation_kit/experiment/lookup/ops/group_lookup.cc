@@ -50,4 +50,64 @@ REGISTER_OP("GroupLookup")
       return sok_tsl_status();
     });
 
+// Fused tf.nn.embedding_lookup_sparse of N tables on single GPU. Every output shape follows from
+// the input shapes, so the op needs no shape computed at run time.
+REGISTER_OP("GroupLookupCombine")
+    .Input("handles: N * resource")
+    .Input("indices: N * Tindices")
+    .Input("row_splits: N * Toffsets")
+    .Output("outputs: N * dtype")
+    .Attr("N: int")
+    .Attr("combiners: list(string)")
+    .Attr("Tindices: {int32, int64} = DT_INT64")
+    .Attr("Toffsets: {int32, int64} = DT_INT64")
+    .Attr("dtype: {float32, float16} = DT_FLOAT")
+    .SetShapeFn([](InferenceContext* c) {
+      int N;
+      TF_RETURN_IF_ERROR(c->GetAttr("N", &N));
+      for (int i = 0; i < N; ++i) {
+        // rank(handle) should be 2
+        auto handle_shapes_and_types = c->input_handle_shapes_and_types(i);
+        auto handle_shape = (*handle_shapes_and_types)[0].shape;
+        ShapeHandle unused;
+        TF_RETURN_IF_ERROR(c->WithRank(handle_shape, 2, &unused));
+
+        // rank(indices) and rank(row_splits) should be 1
+        TF_RETURN_IF_ERROR(c->WithRank(c->input(N + i), 1, &unused));
+        ShapeHandle row_splits_shape;
+        TF_RETURN_IF_ERROR(c->WithRank(c->input(2 * N + i), 1, &row_splits_shape));
+
+        // output shape: (row_splits.shape[0] - 1, handle.shape[1])
+        shape_inference::DimensionHandle batch_size;
+        TF_RETURN_IF_ERROR(c->Subtract(c->Dim(row_splits_shape, 0), 1, &batch_size));
+        c->set_output(i, c->Matrix(batch_size, c->Dim(handle_shape, 1)));
+      }
+      return sok_tsl_status();
+    });
+
+REGISTER_OP("GroupLookupCombineGrad")
+    .Input("top_grads: N * dtype")
+    .Input("indices: N * Tindices")
+    .Input("row_splits: N * Toffsets")
+    .Output("grads: N * float")
+    .Attr("N: int")
+    .Attr("combiners: list(string)")
+    .Attr("Tindices: {int32, int64} = DT_INT64")
+    .Attr("Toffsets: {int32, int64} = DT_INT64")
+    .Attr("dtype: {float32, float16} = DT_FLOAT")
+    .SetShapeFn([](InferenceContext* c) {
+      int N;
+      TF_RETURN_IF_ERROR(c->GetAttr("N", &N));
+      for (int i = 0; i < N; ++i) {
+        ShapeHandle top_grad_shape;
+        TF_RETURN_IF_ERROR(c->WithRank(c->input(i), 2, &top_grad_shape));
+        ShapeHandle indices_shape;
+        TF_RETURN_IF_ERROR(c->WithRank(c->input(N + i), 1, &indices_shape));
+
+        // grads shape: (indices.shape[0], top_grad.shape[1]), one row per key
+        c->set_output(i, c->Matrix(c->Dim(indices_shape, 0), c->Dim(top_grad_shape, 1)));
+      }
+      return sok_tsl_status();
+    });
+
 }  // namespace tensorflow
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <cstring>
 #include <random>
 
 #include "common/check.h"
@@ -137,6 +139,14 @@ __global__ void generate_normal_kernel(curandState* state, T** result, bool* d_f
   }
 }
 
+template <typename T>
+__global__ void row_pointers_kernel(T* values, size_t dim, size_t num_embedding, T** result) {
+  for (size_t i = static_cast<size_t>(blockDim.x) * blockIdx.x + threadIdx.x; i < num_embedding;
+       i += static_cast<size_t>(blockDim.x) * gridDim.x) {
+    result[i] = values + i * dim;
+  }
+}
+
 static void set_curand_states(curandState** states, cudaStream_t stream = 0) {
   int device;
   CUDACHECK(cudaGetDevice(&device));
@@ -172,12 +182,13 @@ HKVVariable<KeyType, ValueType>::HKVVariable(int64_t dimension, int64_t initial_
                                              size_t max_hbm_for_vectors, size_t max_bucket_size,
                                              float max_load_factor, int block_size, int device_id,
                                              bool io_by_cpu, const std::string& evict_strategy,
-                                             cudaStream_t stream)
+                                             bool spill_to_host, cudaStream_t stream)
     : dimension_(dimension),
       initial_capacity_(initial_capacity),
       initializer_(initializer),
       stream_(stream),
-      curand_states_(nullptr) {
+      curand_states_(nullptr),
+      spill_to_host_(spill_to_host) {
   if (dimension_ <= 0) {
     throw std::invalid_argument("dimension must > 0 but got " + std::to_string(dimension));
   }
@@ -199,6 +210,12 @@ HKVVariable<KeyType, ValueType>::HKVVariable(int64_t dimension, int64_t initial_
   hkv_table_option_.evict_strategy = hkv_evict_strategy;
 
   hkv_table_->init(hkv_table_option_);
+
+  if (spill_to_host_) {
+    CUDACHECK(cudaStreamCreateWithFlags(&spill_stream_, cudaStreamNonBlocking));
+    CUDACHECK(cudaEventCreateWithFlags(&spill_event_, cudaEventDisableTiming));
+    CUDACHECK(cudaEventCreateWithFlags(&prefetch_event_, cudaEventDisableTiming));
+  }
 }
 
 template <typename KeyType, typename ValueType>
@@ -206,11 +223,25 @@ HKVVariable<KeyType, ValueType>::~HKVVariable() {
   if (curand_states_) {
     CUDACHECK(cudaFree(curand_states_));
   }
+  if (spill_to_host_) {
+    if (prefetched_rows_.valid()) {
+      prefetched_rows_.wait();
+    }
+    wait_for_spill();
+    CUDACHECK(cudaFree(d_evicted_keys_));
+    CUDACHECK(cudaFree(d_evicted_values_));
+    CUDACHECK(cudaFreeHost(h_evicted_keys_));
+    CUDACHECK(cudaFreeHost(h_evicted_values_));
+    CUDACHECK(cudaFreeHost(h_prefetch_keys_));
+    CUDACHECK(cudaEventDestroy(prefetch_event_));
+    CUDACHECK(cudaEventDestroy(spill_event_));
+    CUDACHECK(cudaStreamDestroy(spill_stream_));
+  }
 }
 
 template <typename KeyType, typename ValueType>
 int64_t HKVVariable<KeyType, ValueType>::rows() {
-  return hkv_table_->size(stream_);
+  return hkv_table_->size(stream_) + num_host_rows();
 }
 
 template <typename KeyType, typename ValueType>
@@ -221,14 +252,14 @@ int64_t HKVVariable<KeyType, ValueType>::cols() {
 template <typename KeyType, typename ValueType>
 void HKVVariable<KeyType, ValueType>::eXport(KeyType* keys, ValueType* values,
                                              cudaStream_t stream) {
-  int64_t num_keys = rows();
+  int64_t num_device_keys = hkv_table_->size(stream);
   int64_t dim = cols();
 
   // `keys` and `values` are pointers of host memory
   KeyType* d_keys;
-  CUDACHECK(cudaMallocManaged(&d_keys, sizeof(KeyType) * num_keys));
+  CUDACHECK(cudaMallocManaged(&d_keys, sizeof(KeyType) * num_device_keys));
   ValueType* d_values;
-  CUDACHECK(cudaMallocManaged(&d_values, sizeof(ValueType) * num_keys * dim));
+  CUDACHECK(cudaMallocManaged(&d_values, sizeof(ValueType) * num_device_keys * dim));
 
   // KeyType* d_keys;
   // CUDACHECK(cudaMalloc(&d_keys, sizeof(KeyType) * num_keys));
@@ -239,13 +270,26 @@ void HKVVariable<KeyType, ValueType>::eXport(KeyType* keys, ValueType* values,
   CUDACHECK(cudaStreamSynchronize(stream));
 
   // clang-format off
-  std::memcpy(keys, d_keys, sizeof(KeyType) * num_keys);
-  std::memcpy(values, d_values, sizeof(ValueType) * num_keys * dim);
+  std::memcpy(keys, d_keys, sizeof(KeyType) * num_device_keys);
+  std::memcpy(values, d_values, sizeof(ValueType) * num_device_keys * dim);
   //CUDACHECK(cudaMemcpy(keys, d_keys, sizeof(KeyType) * num_keys,cudaMemcpyDeviceToHost));
   //CUDACHECK(cudaMemcpy(values, d_values, sizeof(ValueType) * num_keys * dim,cudaMemcpyDeviceToHost));
   //  clang-format on
   CUDACHECK(cudaFree(d_keys));
   CUDACHECK(cudaFree(d_values));
+
+  // The rows spilled to host memory follow the ones in HKV.
+  if (spill_to_host_) {
+    wait_for_spill();
+    std::lock_guard<std::mutex> lock(host_mutex_);
+    size_t i = num_device_keys;
+    for (const auto& key_row : host_index_) {
+      keys[i] = key_row.first;
+      std::memcpy(values + i * dim, host_values_.data() + key_row.second * dim,
+                  sizeof(ValueType) * dim);
+      i++;
+    }
+  }
 }
 
 template <typename KeyType, typename ValueType>
@@ -272,7 +316,11 @@ void HKVVariable<KeyType, ValueType>::assign(const KeyType* keys, const ValueTyp
   //CUDACHECK(cudaStreamSynchronize(stream));
   std::memcpy(d_keys, keys, sizeof(KeyType) * num_keys);
   std::memcpy(d_values, values, sizeof(ValueType) * num_keys * dim);
-  hkv_table_->insert_or_assign(num_keys, d_keys, d_values, nullptr, stream);
+  if (spill_to_host_) {
+    insert_and_spill(d_keys, d_values, num_keys, stream);
+  } else {
+    hkv_table_->insert_or_assign(num_keys, d_keys, d_values, nullptr, stream);
+  }
 
   CUDACHECK(cudaStreamSynchronize(stream));
   CUDACHECK(cudaFree(d_keys));
@@ -305,7 +353,15 @@ void HKVVariable<KeyType, ValueType>::lookup(const KeyType* keys, ValueType* val
     }
   }
 
-  hkv_table_->find_or_insert(num_keys, keys, values, nullptr, stream);
+  if (spill_to_host_) {
+    // The found rows overwrite the initial values, and the rows evicted by the insertion of the
+    // others are spilled.
+    restore_from_host(keys, num_keys, stream);
+    hkv_table_->find(num_keys, keys, values, d_found, nullptr, stream);
+    insert_and_spill(keys, values, num_keys, stream);
+  } else {
+    hkv_table_->find_or_insert(num_keys, keys, values, nullptr, stream);
+  }
   CUDACHECK(cudaFree(d_found));
 }
 
@@ -315,9 +371,20 @@ void HKVVariable<KeyType, ValueType>::lookup(const KeyType* keys, ValueType** va
   bool* d_found;
   CUDACHECK(cudaMalloc(&d_found, num_keys * sizeof(bool)));
   CUDACHECK(cudaMemset(d_found, 0, num_keys * sizeof(bool)));
-  hkv_table_->find_or_insert(num_keys, keys, values, d_found, nullptr, stream);
-  //CUDACHECK(cudaStreamSynchronize(stream));
   int64_t dim = cols();
+  ValueType* d_values = nullptr;
+  if (spill_to_host_ && num_keys > 0) {
+    // Initialize the missing rows in a buffer of our own, and insert them before handing out the
+    // pointers, so that the rows that they evict are spilled instead of dropped.
+    restore_from_host(keys, num_keys, stream);
+    CUDACHECK(cudaMalloc(&d_values, sizeof(ValueType) * num_keys * dim));
+    hkv_table_->find(num_keys, keys, d_values, d_found, nullptr, stream);
+    row_pointers_kernel<<<(num_keys - 1) / 1024 + 1, 1024, 0, stream>>>(d_values, dim, num_keys,
+                                                                         values);
+  } else {
+    hkv_table_->find_or_insert(num_keys, keys, values, d_found, nullptr, stream);
+  }
+  //CUDACHECK(cudaStreamSynchronize(stream));
   uint32_t block_dim = max(dim, static_cast<int64_t>(32));
   uint32_t grid_dim = SM_NUM*(NTHREAD_PER_SM/block_dim);
   if (num_keys<grid_dim) grid_dim = num_keys;
@@ -337,6 +404,11 @@ void HKVVariable<KeyType, ValueType>::lookup(const KeyType* keys, ValueType** va
     }
   }
 
+  if (d_values) {
+    insert_and_spill(keys, d_values, num_keys, stream);
+    hkv_table_->find_or_insert(num_keys, keys, values, d_found, nullptr, stream);
+    CUDACHECK(cudaFree(d_values));
+  }
   //CUDACHECK(cudaStreamSynchronize(stream));
   CUDACHECK(cudaFree(d_found));
 }
@@ -369,5 +441,171 @@ void HKVVariable<KeyType, ValueType>::scatter_update(const KeyType* keys, const
   CUDACHECK(cudaStreamSynchronize(stream));
 }
 
+template <typename KeyType, typename ValueType>
+void HKVVariable<KeyType, ValueType>::prefetch(const KeyType* keys, size_t num_keys,
+                                               cudaStream_t stream) {
+  if (!spill_to_host_ || num_keys == 0) {
+    return;
+  }
+  // Only one batch is prefetched at a time.
+  if (prefetched_rows_.valid()) {
+    upload_host_rows(prefetched_rows_.get(), stream);
+  }
+
+  if (prefetch_capacity_ < num_keys) {
+    CUDACHECK(cudaFreeHost(h_prefetch_keys_));
+    CUDACHECK(cudaMallocHost(&h_prefetch_keys_, sizeof(KeyType) * num_keys));
+    prefetch_capacity_ = num_keys;
+  }
+  // Ordered after the spills in flight, so that the rows that they store are found.
+  CUDACHECK(cudaEventRecord(prefetch_event_, stream));
+  CUDACHECK(cudaStreamWaitEvent(spill_stream_, prefetch_event_));
+  CUDACHECK(cudaMemcpyAsync(h_prefetch_keys_, keys, sizeof(KeyType) * num_keys,
+                            cudaMemcpyDeviceToHost, spill_stream_));
+  CUDACHECK(cudaEventRecord(prefetch_event_, spill_stream_));
+
+  int device;
+  CUDACHECK(cudaGetDevice(&device));
+  prefetched_rows_ = std::async(std::launch::async, [this, device, num_keys]() {
+    CUDACHECK(cudaSetDevice(device));
+    CUDACHECK(cudaEventSynchronize(prefetch_event_));
+    return take_host_rows(std::vector<KeyType>(h_prefetch_keys_, h_prefetch_keys_ + num_keys));
+  });
+}
+
+template <typename KeyType, typename ValueType>
+void HKVVariable<KeyType, ValueType>::insert_and_spill(const KeyType* keys,
+                                                       const ValueType* values, size_t num_keys,
+                                                       cudaStream_t stream) {
+  if (num_keys == 0) {
+    return;
+  }
+  // The staging buffers are reused once the previous spill has been stored.
+  wait_for_spill();
+  const size_t dim = cols();
+  if (evicted_capacity_ < num_keys) {
+    CUDACHECK(cudaFree(d_evicted_keys_));
+    CUDACHECK(cudaFree(d_evicted_values_));
+    CUDACHECK(cudaFreeHost(h_evicted_keys_));
+    CUDACHECK(cudaFreeHost(h_evicted_values_));
+    CUDACHECK(cudaMalloc(&d_evicted_keys_, sizeof(KeyType) * num_keys));
+    CUDACHECK(cudaMalloc(&d_evicted_values_, sizeof(ValueType) * num_keys * dim));
+    CUDACHECK(cudaMallocHost(&h_evicted_keys_, sizeof(KeyType) * num_keys));
+    CUDACHECK(cudaMallocHost(&h_evicted_values_, sizeof(ValueType) * num_keys * dim));
+    evicted_capacity_ = num_keys;
+  }
+
+  num_evicted_ = hkv_table_->insert_and_evict(num_keys, keys, values, nullptr, d_evicted_keys_,
+                                              d_evicted_values_, nullptr, stream);
+  if (num_evicted_ == 0) {
+    return;
+  }
+  CUDACHECK(cudaEventRecord(spill_event_, stream));
+  CUDACHECK(cudaStreamWaitEvent(spill_stream_, spill_event_));
+  CUDACHECK(cudaMemcpyAsync(h_evicted_keys_, d_evicted_keys_, sizeof(KeyType) * num_evicted_,
+                            cudaMemcpyDeviceToHost, spill_stream_));
+  CUDACHECK(cudaMemcpyAsync(h_evicted_values_, d_evicted_values_,
+                            sizeof(ValueType) * num_evicted_ * dim, cudaMemcpyDeviceToHost,
+                            spill_stream_));
+  CUDACHECK(cudaLaunchHostFunc(spill_stream_, store_spilled_rows, this));
+  CUDACHECK(cudaEventRecord(spill_event_, spill_stream_));
+}
+
+template <typename KeyType, typename ValueType>
+void CUDART_CB HKVVariable<KeyType, ValueType>::store_spilled_rows(void* user_data) {
+  auto* const self = static_cast<HKVVariable*>(user_data);
+  const size_t dim = self->dimension_;
+  std::lock_guard<std::mutex> lock(self->host_mutex_);
+  for (size_t i = 0; i < self->num_evicted_; i++) {
+    auto result = self->host_index_.emplace(self->h_evicted_keys_[i], 0);
+    auto it = result.first;
+    if (result.second) {
+      if (self->free_host_rows_.empty()) {
+        it->second = self->host_values_.size() / dim;
+        self->host_values_.resize(self->host_values_.size() + dim);
+      } else {
+        it->second = self->free_host_rows_.back();
+        self->free_host_rows_.pop_back();
+      }
+    }
+    std::memcpy(self->host_values_.data() + it->second * dim, self->h_evicted_values_ + i * dim,
+                sizeof(ValueType) * dim);
+  }
+}
+
+template <typename KeyType, typename ValueType>
+typename HKVVariable<KeyType, ValueType>::HostRows HKVVariable<KeyType, ValueType>::take_host_rows(
+    const std::vector<KeyType>& keys) {
+  const size_t dim = dimension_;
+  HostRows rows;
+  std::lock_guard<std::mutex> lock(host_mutex_);
+  for (const KeyType key : keys) {
+    auto it = host_index_.find(key);
+    if (it == host_index_.end()) {
+      continue;
+    }
+    const ValueType* const row = host_values_.data() + it->second * dim;
+    rows.keys.push_back(key);
+    rows.values.insert(rows.values.end(), row, row + dim);
+    free_host_rows_.push_back(it->second);
+    host_index_.erase(it);
+  }
+  return rows;
+}
+
+template <typename KeyType, typename ValueType>
+void HKVVariable<KeyType, ValueType>::upload_host_rows(const HostRows& rows, cudaStream_t stream) {
+  if (rows.keys.empty()) {
+    return;
+  }
+  KeyType* d_keys;
+  CUDACHECK(cudaMalloc(&d_keys, sizeof(KeyType) * rows.keys.size()));
+  ValueType* d_values;
+  CUDACHECK(cudaMalloc(&d_values, sizeof(ValueType) * rows.values.size()));
+  CUDACHECK(cudaMemcpyAsync(d_keys, rows.keys.data(), sizeof(KeyType) * rows.keys.size(),
+                            cudaMemcpyHostToDevice, stream));
+  CUDACHECK(cudaMemcpyAsync(d_values, rows.values.data(), sizeof(ValueType) * rows.values.size(),
+                            cudaMemcpyHostToDevice, stream));
+  insert_and_spill(d_keys, d_values, rows.keys.size(), stream);
+  CUDACHECK(cudaStreamSynchronize(stream));
+  CUDACHECK(cudaFree(d_keys));
+  CUDACHECK(cudaFree(d_values));
+}
+
+template <typename KeyType, typename ValueType>
+void HKVVariable<KeyType, ValueType>::restore_from_host(const KeyType* keys, size_t num_keys,
+                                                        cudaStream_t stream) {
+  if (prefetched_rows_.valid()) {
+    upload_host_rows(prefetched_rows_.get(), stream);
+  }
+  // The rows spilled by the previous batch must have been stored before they are searched.
+  wait_for_spill();
+  if (num_keys == 0 || num_host_rows() == 0) {
+    return;
+  }
+  std::vector<KeyType> h_keys(num_keys);
+  CUDACHECK(cudaMemcpyAsync(h_keys.data(), keys, sizeof(KeyType) * num_keys,
+                            cudaMemcpyDeviceToHost, stream));
+  CUDACHECK(cudaStreamSynchronize(stream));
+  upload_host_rows(take_host_rows(h_keys), stream);
+}
+
+template <typename KeyType, typename ValueType>
+void HKVVariable<KeyType, ValueType>::wait_for_spill() {
+  if (spill_event_) {
+    CUDACHECK(cudaEventSynchronize(spill_event_));
+  }
+}
+
+template <typename KeyType, typename ValueType>
+size_t HKVVariable<KeyType, ValueType>::num_host_rows() {
+  if (!spill_to_host_) {
+    return 0;
+  }
+  wait_for_spill();
+  std::lock_guard<std::mutex> lock(host_mutex_);
+  return host_index_.size();
+}
+
 template class HKVVariable<int64_t, float>;
 }  // namespace sok
@@ -19,7 +19,11 @@
 
 #include <curand_kernel.h>
 
+#include <future>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "merlin_hashtable.cuh"
 #include "variable/impl/variable_base.h"
@@ -33,7 +37,7 @@ class HKVVariable : public VariableBase<KeyType, ValueType> {
               size_t max_capacity = 0, size_t max_hbm_for_vectors = 0, size_t max_bucket_size = 128,
               float max_load_factor = 0.5f, int block_size = 128, int device_id = 0,
               bool io_by_cpu = false, const std::string &evict_strategy = "kLru",
-              cudaStream_t stream = 0);
+              bool spill_to_host = false, cudaStream_t stream = 0);
 
   ~HKVVariable() override;
   int64_t rows() override;
@@ -51,6 +55,7 @@ class HKVVariable : public VariableBase<KeyType, ValueType> {
                    cudaStream_t stream = 0) override;
   void scatter_update(const KeyType *keys, const ValueType *values, size_t num_keys,
                       cudaStream_t stream = 0) override;
+  void prefetch(const KeyType *keys, size_t num_keys, cudaStream_t stream = 0) override;
 
  private:
   using HKVTable = nv::merlin::HashTable<KeyType, ValueType, uint64_t>;
@@ -62,6 +67,46 @@ class HKVVariable : public VariableBase<KeyType, ValueType> {
   std::string initializer_;
   curandState *curand_states_;
   cudaStream_t stream_;
+
+  // With `spill_to_host`, the rows that HKV evicts are kept in host memory instead of being
+  // dropped, and are inserted back when their keys are looked up again.
+  //
+  // 1. Evictions are copied to pinned memory on `spill_stream_`, and stored into `host_index_` by a
+  //    host function, so the compute stream does not wait for them.
+  // 2. `prefetch` gathers the spilled rows of the next batch on a worker thread, while the current
+  //    batch is being trained. The next lookup only uploads them.
+  bool spill_to_host_;
+  cudaStream_t spill_stream_ = nullptr;
+  cudaEvent_t spill_event_ = nullptr;
+  KeyType *d_evicted_keys_ = nullptr;
+  ValueType *d_evicted_values_ = nullptr;
+  KeyType *h_evicted_keys_ = nullptr;
+  ValueType *h_evicted_values_ = nullptr;
+  size_t evicted_capacity_ = 0;
+  size_t num_evicted_ = 0;
+  cudaEvent_t prefetch_event_ = nullptr;
+  KeyType *h_prefetch_keys_ = nullptr;
+  size_t prefetch_capacity_ = 0;
+
+  std::mutex host_mutex_;
+  std::unordered_map<KeyType, size_t> host_index_;  // key -> row of `host_values_`
+  std::vector<ValueType> host_values_;
+  std::vector<size_t> free_host_rows_;
+
+  struct HostRows {
+    std::vector<KeyType> keys;
+    std::vector<ValueType> values;
+  };
+  std::future<HostRows> prefetched_rows_;
+
+  void insert_and_spill(const KeyType *keys, const ValueType *values, size_t num_keys,
+                        cudaStream_t stream);
+  void restore_from_host(const KeyType *keys, size_t num_keys, cudaStream_t stream);
+  void upload_host_rows(const HostRows &rows, cudaStream_t stream);
+  HostRows take_host_rows(const std::vector<KeyType> &keys);
+  void wait_for_spill();
+  static void CUDART_CB store_spilled_rows(void *user_data);
+  size_t num_host_rows();
 };
 
 }  // namespace sok
@@ -77,9 +77,14 @@ std::shared_ptr<VariableBase<KeyType, ValueType>> VariableFactory::create(
     if (evict_strategy_it != config_json.end()) {
       evict_strategy = io_by_cpu_it->get<std::string>();
     }
+    bool spill_to_host = false;  ///< Keep the evicted rows in host memory instead of dropping them.
+    auto spill_to_host_it = config_json.find("spill_to_host");
+    if (spill_to_host_it != config_json.end()) {
+      spill_to_host = spill_to_host_it->get<bool>();
+    }
     return std::make_shared<HKVVariable<KeyType, ValueType>>(
         cols, init_capacity, initializer, max_capacity, max_hbm_for_vectors, max_bucket_size,
-        max_load_factor, block_size, device_id, io_by_cpu, evict_strategy, stream);
+        max_load_factor, block_size, device_id, io_by_cpu, evict_strategy, spill_to_host, stream);
   }
 }
 template <>
@@ -43,6 +43,10 @@ class VariableBase {
                            cudaStream_t stream = 0) = 0;
   virtual void scatter_update(const KeyType *keys, const ValueType *values, size_t num_keys,
                               cudaStream_t stream = 0) = 0;
+
+  // Hint that `keys` are looked up soon. Backends with a slower storage tier may start moving
+  // their rows into device memory.
+  virtual void prefetch(const KeyType *keys, size_t num_keys, cudaStream_t stream = 0) {}
 };
 
 class VariableFactory {
@@ -95,6 +95,13 @@ void DummyVar<KeyType, ValueType>::ScatterUpdate(const void* keys, const void* v
                        num_keys, stream);
 }
 
+template <typename KeyType, typename ValueType>
+void DummyVar<KeyType, ValueType>::Prefetch(const void* keys, size_t num_keys,
+                                            cudaStream_t stream) {
+  check_var();
+  var_->prefetch(static_cast<const KeyType*>(keys), num_keys, stream);
+}
+
 // explicit instance the template
 template class DummyVar<int32_t, float>;
 template class DummyVar<int64_t, float>;
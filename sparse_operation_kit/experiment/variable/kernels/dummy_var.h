@@ -58,6 +58,7 @@ class DummyVar : public ResourceBase {
   void SparseRead(const void *keys, void *values, size_t num_keys, cudaStream_t stream);
   void ScatterAdd(const void *keys, const void *values, size_t num_keys, cudaStream_t stream);
   void ScatterUpdate(const void *keys, const void *values, size_t num_keys, cudaStream_t stream);
+  void Prefetch(const void *keys, size_t num_keys, cudaStream_t stream);
 
   inline std::shared_ptr<sok::VariableBase<KeyType, ValueType>> get_var() { return var_; }
 
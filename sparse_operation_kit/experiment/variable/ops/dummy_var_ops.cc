@@ -113,4 +113,16 @@ REGISTER_OP("DummyVarScatterUpdate")
     .Attr("dtype: {float32}")
     .SetShapeFn(DummyVarScatterShapeFn);
 
+REGISTER_OP("DummyVarPrefetch")
+    .Input("resource: resource")
+    .Input("indices: key_type")
+    .Attr("key_type: {int32, int64}")
+    .Attr("dtype: {float32}")
+    .SetShapeFn([](InferenceContext* c) {
+      // rank(indices) should == 1
+      ShapeHandle indices_shape;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 1, &indices_shape));
+      return sok_tsl_status();
+    });
+
 }  // namespace tensorflow
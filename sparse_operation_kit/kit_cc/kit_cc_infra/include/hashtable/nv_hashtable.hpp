@@ -25,14 +25,13 @@ template <typename KeyType, typename ValType>
 class HashTableContainer;
 
 /**
- * The HashTable class is wrapped by cudf library for hash table operations on single GPU.
- * In this class, we implement the GPU version of the common used operations of hash table,
- * such as insert() / get() / set() / dump()...
+ * The HashTable class wraps a BucketedHashMap (see HugeCTR's hashtable/bucketed_hash_map.cuh) for
+ * hash table operations on single GPU. In this class, we implement the GPU version of the common
+ * used operations of hash table, such as insert() / get() / set() / dump()...
+ * std::numeric_limits<KeyType>::max() is reserved and cannot be used as a key.
  */
 template <typename KeyType, typename ValType>
 class HashTable {
-  const KeyType empty_key = std::numeric_limits<KeyType>::max();
-
  public:
   /**
    * The constructor of HashTable.
@@ -161,15 +160,12 @@ class HashTable {
   void clear(cudaStream_t stream);
 
  private:
-  static const int BLOCK_SIZE_ =
-      256; /**< The block size of the CUDA kernels. The default value is 256. */
-
-  const float LOAD_FACTOR = 0.75f;
+  // Probing whole buckets keeps the probe sequences short at a higher load than per-slot probing
+  const float LOAD_FACTOR = 0.85f;
 
   const size_t capacity_;
 
-  HashTableContainer<KeyType, ValType>* container_; /**< The object of the Table class which is
-       defined in the concurrent_unordered_map class. */
+  HashTableContainer<KeyType, ValType>* container_; /**< The BucketedHashMap holding the pairs. */
 
   // Counter for value index
   size_t* d_counter_; /**< The device counter for value index. */
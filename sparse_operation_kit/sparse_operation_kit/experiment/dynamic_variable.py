@@ -50,6 +50,9 @@ class DynamicVariable(ResourceVariable):
         a string to specify to use DET or HKV as the backend.
         If use HKV as the backend, only support tf.int64 as key_type
         If use HKV as the backend, please set init_capacity and max_capacity value equal to 2 powers.
+        If use HKV as the backend, pass ``spill_to_host=True`` to keep the rows evicted
+        from the GPU in host memory instead of dropping them. They are inserted back
+        when their keys are looked up again, see ``prefetch``.
 
     key_type: dtype
         specify the data type of indices. Unlike the static variable of
@@ -320,6 +323,21 @@ class DynamicVariable(ResourceVariable):
             ops.convert_to_tensor(sparse_delta.values, self.dtype),
         )
 
+    def prefetch(self, indices, name=None):
+        """
+        Hint that ``indices`` are looked up by a later step. With the HKV backend
+        and ``spill_to_host=True``, the rows of ``indices`` that were spilled to
+        host memory are gathered in the background, and the next lookup only
+        uploads them. Otherwise, this is a no-op.
+        """
+        if self.is_static():
+            return
+        if indices.dtype == tf.int32:
+            indices = tf.cast(indices, tf.int64)
+        return dynamic_variable_ops.dummy_var_prefetch(
+            self._dummy_handle, indices, dtype=self._handle_dtype
+        )
+
     # -------------------------------------------------------------------------
     # Methods not supported both in static mode and dynamic mode
     # -------------------------------------------------------------------------
@@ -82,6 +82,44 @@ def _GroupLookupGrad(op, *top_grads):
     return grads
 
 
+def group_lookup_combine(params, sp_ids, combiners, dtype=None, name=None):
+    # Fused-version of tf.nn.embedding_lookup_sparse on single GPU. The lookup and the combiner
+    # run in one op whose output shapes are known at graph construction, so the dense model
+    # around it is not split by run-time shapes when it is clustered by XLA.
+    with ops.name_scope("GroupLookupCombine" if name is None else name) as name:
+        for param in params:
+            variable_accessed(param)
+        handles = [param.handle for param in params]
+        indices = []
+        row_splits = []
+        for sp_id in sp_ids:
+            if isinstance(sp_id, tf.SparseTensor):
+                sp_id = tf.RaggedTensor.from_sparse(sp_id)
+            indices.append(sp_id.values)
+            row_splits.append(sp_id.row_splits)
+        outputs = raw_ops.group_lookup_combine(
+            handles, indices, row_splits, combiners=combiners, dtype=dtype
+        )
+    return outputs
+
+
+@tf.RegisterGradient("GroupLookupCombine")
+def _GroupLookupCombineGrad(op, *top_grads):
+    N = op.get_attr("N")
+    handles = op.inputs[:N]
+    indices = op.inputs[N : 2 * N]
+    row_splits = op.inputs[2 * N :]
+    # One gradient row per key, its shape is the shape of the indices
+    values = raw_ops.group_lookup_combine_grad(
+        top_grads, indices, row_splits, combiners=op.get_attr("combiners")
+    )
+    grads = []
+    for i in range(N):
+        grads.append(tf.IndexedSlices(values[i], indices[i], variable_shape(handles[i])))
+    grads += [None] * (2 * N)
+    return grads
+
+
 @tf.RegisterGradient("Reorder")
 def _ReorderGrad(op, grad):
     indices = op.inputs[1]
@@ -407,6 +445,12 @@ def lookup_sparse_impl(params, sp_ids, sp_weights=None, combiners=None):
     row_lengths = []
     sp_weight_value = []
     use_sp_weight = False if len(sp_weights) == 0 else True
+
+    # On single GPU nothing is exchanged between the steps below, so the whole lookup is done by
+    # one fused op.
+    if num_gpus() == 1 and isResourceVariable(params[0]) and not use_sp_weight:
+        return group_lookup_combine(params, sp_ids, combiners)
+
     # first collect keys from Ragged tensors
     # keys means lookup key
     # every element in row_lengths meas number of lookup keys in a table for a sample
@@ -514,6 +558,11 @@ def lookup_sparse(params, sp_ids, sp_weights=None, combiners=None):
         - It can accept multiple params and multiple sp_ids to do fused lookup at once,
           which brings performance benefits.
 
+    On single GPU, when the params are *sok.Variable* and ``sp_weights`` is not given,
+    the lookup and the combiner are done by a single op whose output shapes are known
+    statically, so the dense model around it can be clustered by XLA without shape
+    dependent recompilation.
+
     Parameters
     ----------
     params: list, tuple
@@ -0,0 +1,73 @@
+"""
+ Copyright (c) 2022, NVIDIA CORPORATION.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+"""
+
+import numpy as np
+import tensorflow as tf
+from sparse_operation_kit import experiment as sok
+
+
+def test():
+    handle = sok.raw_ops.dummy_var_handle(
+        shared_name="Var_0", shape=[None, 8], key_type=tf.int64, dtype=tf.float32
+    )
+    # The table holds 128 rows, the others are spilled to host memory.
+    sok.raw_ops.dummy_var_initialize(
+        handle,
+        initializer=[2.71828],
+        var_type="hybrid",
+        unique_name="",
+        key_type=tf.int64,
+        dtype=tf.float32,
+        config='{"init_capacity":128,"max_capacity":128,"max_bucket_size":128,'
+        '"spill_to_host":true}',
+    )
+    num_keys = 1024
+    with tf.device("CPU"):
+        indices = tf.convert_to_tensor(np.arange(num_keys), dtype=tf.int64)
+        values = tf.convert_to_tensor(
+            np.arange(num_keys * 8).reshape(num_keys, 8), dtype=tf.float32
+        )
+    sok.raw_ops.dummy_var_assign(handle, indices, values)
+    shape = sok.raw_ops.dummy_var_shape(handle)
+    assert shape[0] == num_keys
+
+    # No row is lost, wherever it lives.
+    exported_indices, exported_values = sok.raw_ops.dummy_var_export(
+        handle, key_type=tf.int64, dtype=tf.float32
+    )
+    expected = tf.gather(values, exported_indices)
+    assert tf.reduce_mean((exported_values - expected) ** 2) < 1e-8
+
+    # Spilled rows are restored by the lookup, with or without a prefetch.
+    for start in [0, 512]:
+        batch = tf.convert_to_tensor(np.arange(start, start + 64), dtype=tf.int64)
+        if start:
+            sok.raw_ops.dummy_var_prefetch(handle, batch, dtype=tf.float32)
+        embedding_vector = sok.raw_ops.dummy_var_sparse_read(handle, batch)
+        err = tf.reduce_mean((embedding_vector - tf.gather(values, batch)) ** 2)
+        assert err < 1e-8
+    shape = sok.raw_ops.dummy_var_shape(handle)
+    assert shape[0] == num_keys
+
+
+if __name__ == "__main__":
+    op_name = "dummy_var_prefetch"
+    if not hasattr(sok.raw_ops, op_name):
+        raise RuntimeError("There is no op called " + op_name)
+
+    test()
+
+    print("[SOK INFO] Test of %s passed." % (op_name))
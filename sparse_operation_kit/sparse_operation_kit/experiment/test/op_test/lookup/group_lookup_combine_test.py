@@ -0,0 +1,70 @@
+"""
+ Copyright (c) 2022, NVIDIA CORPORATION.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+"""
+
+import numpy as np
+import tensorflow as tf
+from sparse_operation_kit import experiment as sok
+from sparse_operation_kit.experiment.lookup import group_lookup_combine
+
+
+def test():
+    v1 = tf.Variable(np.arange(12).reshape(3, 4), dtype=tf.float32)
+    v2 = tf.Variable(np.arange(15).reshape(5, 3), dtype=tf.float32)
+    # The second sample of indices2 has no key
+    indices1 = tf.RaggedTensor.from_row_splits(
+        tf.convert_to_tensor([0, 1, 2], dtype=tf.int64), tf.convert_to_tensor([0, 2, 3])
+    )
+    indices2 = tf.RaggedTensor.from_row_splits(
+        tf.convert_to_tensor([1, 3, 4], dtype=tf.int64), tf.convert_to_tensor([0, 3, 3])
+    )
+
+    with tf.GradientTape() as tape:
+        outputs = group_lookup_combine([v1, v2], [indices1, indices2], ["sum", "mean"])
+        loss = tf.reduce_sum(outputs[0]) + 2.0 * tf.reduce_sum(outputs[1])
+
+    assert len(outputs) == 2
+    # The output shapes are known without running the op
+    assert outputs[0].shape.as_list() == [2, 4]
+    assert outputs[1].shape.as_list() == [2, 3]
+
+    output = [[4.0, 6.0, 8.0, 10.0], [8.0, 9.0, 10.0, 11.0]]
+    err = tf.reduce_mean((outputs[0] - output) ** 2)
+    assert err < 1e-8
+
+    output = [[8.0, 9.0, 10.0], [0.0, 0.0, 0.0]]
+    err = tf.reduce_mean((outputs[1] - output) ** 2)
+    assert err < 1e-8
+
+    grads = tape.gradient(loss, [v1, v2])
+    grad = tf.convert_to_tensor(grads[0])
+    err = tf.reduce_mean((grad - np.ones([3, 4])) ** 2)
+    assert err < 1e-8
+
+    grad = tf.convert_to_tensor(grads[1])
+    expected = np.zeros([5, 3])
+    expected[[1, 3, 4]] = 2.0 / 3.0
+    err = tf.reduce_mean((grad - expected) ** 2)
+    assert err < 1e-8
+
+
+if __name__ == "__main__":
+    op_name = "group_lookup_combine"
+    if not hasattr(sok.raw_ops, op_name):
+        raise RuntimeError("There is no op called " + op_name)
+
+    test()
+
+    print("[SOK INFO] Test of %s passed." % (op_name))
@@ -16,6 +16,7 @@ python dummy_var_scatter_add_test.py
 python dummy_var_scatter_add_hkv_test.py
 python dummy_var_scatter_update_test.py
 python dummy_var_scatter_update_hkv_test.py
+python dummy_var_prefetch_hkv_test.py
 cd ..
 
 # -------- embedding collection -------------- #
@@ -34,4 +35,5 @@ python dist_select_test.py
 python reorder_test.py
 python gather_ex_test.py
 python group_lookup_test.py
+python group_lookup_combine_test.py
 cd ..
@@ -196,6 +196,37 @@ def hps_dlpack(model_name, embedding_file_list, data_file, enable_cache):
             )
         )
 
+    print("************Look up asynchronously from pytorch dlpack on GPU")
+    stream = torch.cuda.Stream(device=device)
+    key1 = torch.tensor(cat_input[0:2], dtype=torch.int64, device=device)
+    out1 = torch.empty((1, 2), dtype=torch.float32, device=device)
+    out2 = torch.empty((1, 26 * 16), dtype=torch.float32, device=device)
+    event = hps.lookup_async(
+        torch.utils.dlpack.to_dlpack(key),
+        torch.utils.dlpack.to_dlpack(out2),
+        "hps_demo",
+        1,
+        stream.cuda_stream,
+    )
+    event.synchronize()
+    event = hps.lookup_batch_async(
+        [torch.utils.dlpack.to_dlpack(key1), torch.utils.dlpack.to_dlpack(key)],
+        [torch.utils.dlpack.to_dlpack(out1), torch.utils.dlpack.to_dlpack(out)],
+        "hps_demo",
+        [0, 1],
+        stream.cuda_stream,
+    )
+    event.wait(torch.cuda.current_stream(device).cuda_stream)
+    diff = (out2.cpu() - embedding2.reshape(1, 26 * 16)).abs().max()
+    diff = max(diff, (out.cpu() - embedding2.reshape(1, 26 * 16)).abs().max())
+    diff = max(diff, (out1.cpu() - embedding1.reshape(1, 2 * 1)).abs().max())
+    if not event.query() or diff > 1e-3:
+        raise RuntimeError(
+            "Asynchronous pytorch dlpack lookups differ from native HPS lookup api: {}".format(diff)
+        )
+    else:
+        print("Asynchronous pytorch dlpack lookups are consistent with native HPS lookup api")
+
     # 5. Look up from tf dlpack
     print("[HUGECTR][INFO] Look up from dlpack for Tensorflow tensor test")
     from tensorflow.python.dlpack import dlpack
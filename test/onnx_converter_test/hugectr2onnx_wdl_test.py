@@ -31,8 +31,11 @@ def hugectr2onnx_wdl_test(
     onnx_model_path,
     model_name,
     ground_truth,
+    external_data=False,
 ):
-    hugectr2onnx.converter.convert(onnx_model_path, graph_config, dense_model, True, sparse_models)
+    hugectr2onnx.converter.convert(
+        onnx_model_path, graph_config, dense_model, True, sparse_models, external_data=external_data
+    )
     label, dense, wide_data, deep_data = read_samples_for_wdl(
         data_file, batch_size * num_batches, slot_num=28
     )
@@ -68,3 +71,18 @@ if __name__ == "__main__":
         "wdl",
         "/onnx_converter/hugectr_models/wdl_preds.npy",
     )
+    hugectr2onnx_wdl_test(
+        64,
+        100,
+        "./wdl_data_parquet/val/0.9598d8cc5a1e4f85ae31f8068cb47fbb.parquet",
+        "/onnx_converter/graph_files/wdl.json",
+        "/onnx_converter/hugectr_models/wdl_dense_2000.model",
+        [
+            "/onnx_converter/hugectr_models/wdl0_sparse_2000.model",
+            "/onnx_converter/hugectr_models/wdl1_sparse_2000.model",
+        ],
+        "/onnx_converter/onnx_models/wdl_external.onnx",
+        "wdl",
+        "/onnx_converter/hugectr_models/wdl_preds.npy",
+        external_data=True,
+    )
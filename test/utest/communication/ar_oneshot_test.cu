@@ -103,7 +103,8 @@ bool compare_values(T a, T b) {
 template <typename TypeEmbeddingComp>
 struct arTest {
  public:
-  arTest(const std::vector<int>& device_list, size_t max_size)
+  arTest(const std::vector<int>& device_list, size_t max_size,
+         AllReduceAlgo algo = AllReduceAlgo::ONESHOT)
       : num_gpus_(device_list.size()), max_size_(max_size) {
     max_elems_ = max_size_ / sizeof(TypeEmbeddingComp);
 
@@ -117,7 +118,7 @@ struct arTest {
     }
 
     resource_manager_ = ResourceManagerExt::create(vvgpu, 0, DeviceMap::LOCAL_FIRST);
-    resource_manager_->set_ar_comm(AllReduceAlgo::ONESHOT, use_mixed_precision_);
+    resource_manager_->set_ar_comm(algo, use_mixed_precision_);
     ar_comm_ = resource_manager_->get_ar_comm();
     init_buffers();
   }
@@ -227,6 +228,7 @@ struct arTest {
       }
       ar_comm_->register_coll_buf(handle);
     }
+    ar_comm_->select_backends();
   }
 
   void stream_sync_all() {
@@ -333,6 +335,13 @@ void test_ar_comm(const std::vector<int>& device_list) {
   test.test();
 }
 
+template <typename TypeEmbeddingComp>
+void test_ar_comm_auto(const std::vector<int>& device_list) {
+  const size_t MAX_SIZE = 64 * 1024 * 1024;
+  arTest<TypeEmbeddingComp> test(device_list, MAX_SIZE, AllReduceAlgo::AUTO);
+  test.test();
+}
+
 template <typename TypeEmbeddingComp>
 void test_ar_comm_perf(const std::vector<int>& device_list) {
   const size_t MAX_SIZE = 64 * 1024 * 1024;
@@ -346,6 +355,9 @@ TEST(ar_oneshot_test, half_8gpu) { test_ar_comm<__half>({0, 1, 2, 3, 4, 5, 6, 7}
 TEST(ar_oneshot_test, float_2gpu) { test_ar_comm<float>({0, 1}); }
 TEST(ar_oneshot_test, float_4gpu) { test_ar_comm<float>({0, 1, 2, 3}); }
 TEST(ar_oneshot_test, float_8gpu) { test_ar_comm<float>({0, 1, 2, 3, 4, 5, 6, 7}); }
+TEST(ar_auto_test, half_2gpu) { test_ar_comm_auto<__half>({0, 1}); }
+TEST(ar_auto_test, float_2gpu) { test_ar_comm_auto<float>({0, 1}); }
+TEST(ar_auto_test, float_8gpu) { test_ar_comm_auto<float>({0, 1, 2, 3, 4, 5, 6, 7}); }
 TEST(ar_oneshot_perf, float_2gpu) { test_ar_comm_perf<float>({0, 1}); }
 TEST(ar_oneshot_perf, float_4gpu) { test_ar_comm_perf<float>({0, 1, 2, 3}); }
 TEST(ar_oneshot_perf, float_8gpu) { test_ar_comm_perf<float>({0, 1, 2, 3, 4, 5, 6, 7}); }
@@ -124,3 +124,29 @@ TEST(test_core23, allocator_managed_cuda) {
   Device device(DeviceType::UNIFIED, 0);
   test_impl(my_allocator_params, device);
 }
+
+TEST(test_core23, allocator_huge_page_host) {
+  AllocatorParams my_allocator_params = g_allocator_params;
+  Device device(DeviceType::CPU);
+  // Falls back to transparent huge pages if no 2 MiB pages are reserved
+  my_allocator_params.host_page_size = 2 * 1024 * 1024;
+  my_allocator_params.numa_node = 0;
+  test_impl(my_allocator_params, device);
+
+  auto allocator = GetAllocator(my_allocator_params, device);
+  const int64_t num_bytes = 3 * 1024 * 1024;
+  auto ptr = allocator->allocate(num_bytes);
+  EXPECT_EQ(reinterpret_cast<intptr_t>(ptr) % my_allocator_params.host_page_size, 0);
+  // The pages are registered with CUDA, so the copy runs from pinned memory
+  void* d_ptr;
+  HCTR_LIB_THROW(cudaMalloc(&d_ptr, num_bytes));
+  HCTR_LIB_THROW(cudaMemcpy(d_ptr, ptr, num_bytes, cudaMemcpyHostToDevice));
+  unsigned int flags = 0;
+  HCTR_LIB_THROW(cudaHostGetFlags(&flags, ptr));
+  EXPECT_TRUE(flags & cudaHostAllocPortable);
+  HCTR_LIB_THROW(cudaFree(d_ptr));
+  allocator->deallocate(ptr);
+
+  my_allocator_params.host_page_size = 4096;
+  EXPECT_THROW(GetAllocator(my_allocator_params, device), HugeCTR::core23::RuntimeError);
+}
@@ -187,3 +187,87 @@ TEST(test_core23, single_confederal_buffer_gpu_pool) {
   my_buffer_params.unitary = false;
   single_buffer_test_impl(my_buffer_params, my_allocator_params, device);
 }
+
+TEST(test_core23, single_aliasing_buffer_gpu_simple) {
+  Device device(DeviceType::GPU, 0);
+  AllocatorParams my_allocator_params = g_allocator_params;
+  BufferParams my_buffer_params = g_buffer_params;
+  my_buffer_params.aliased = true;
+  single_buffer_test_impl(my_buffer_params, my_allocator_params, device);
+}
+
+TEST(test_core23, single_aliasing_buffer_live_ranges) {
+  Device device(DeviceType::GPU, 0);
+  BufferParams my_buffer_params = g_buffer_params;
+  my_buffer_params.channel = GetRandomBufferChannel();
+  my_buffer_params.aliased = true;
+  auto buffer =
+      GetBuffer(my_buffer_params, device, std::move(GetAllocator(g_allocator_params, device)));
+
+  // A chain of layers: each activation is produced at step i and last consumed at step i + 1
+  constexpr int64_t num_bytes = 1024;
+  std::vector<std::shared_ptr<DummyBufferClient>> buffer_clients(4);
+  for (int64_t i = 0; i < static_cast<int64_t>(buffer_clients.size()); i++) {
+    buffer_clients[i].reset(new DummyBufferClient());
+    BufferRequirements requirements = {
+        .num_bytes = num_bytes, .alignment = 256, .first_use = i, .last_use = i + 1};
+    EXPECT_NO_THROW(buffer->subscribe(buffer_clients[i].get(), requirements));
+  }
+  // Two regions suffice, because only neighbouring activations are live at the same time
+  EXPECT_EQ(buffer->reserved_size(), 2 * num_bytes);
+
+  for (size_t i = 0; i + 1 < buffer_clients.size(); i++) {
+    EXPECT_NE(buffer_clients[i]->data(), buffer_clients[i + 1]->data());
+  }
+  EXPECT_EQ(buffer_clients[0]->data(), buffer_clients[2]->data());
+  EXPECT_EQ(buffer_clients[1]->data(), buffer_clients[3]->data());
+}
+
+TEST(test_core23, mirrored_buffer_views_source) {
+  Device device(DeviceType::GPU, 0);
+  BufferParams source_params = g_buffer_params;
+  source_params.channel = "MIRRORED_BUFFER_TEST_SOURCE";
+  BufferParams mirror_params = g_buffer_params;
+  mirror_params.channel = "MIRRORED_BUFFER_TEST_MIRROR";
+  MirrorBufferChannel(mirror_params.channel, source_params.channel);
+
+  // The mirror is created first, like the eval layers before the train layers
+  auto mirror =
+      GetBuffer(mirror_params, device, std::move(GetAllocator(g_allocator_params, device)));
+  auto source =
+      GetBuffer(source_params, device, std::move(GetAllocator(g_allocator_params, device)));
+
+  std::array<int64_t, 3> sizes = {100, 4, 1024};
+  std::vector<std::shared_ptr<DummyBufferClient>> source_clients, mirror_clients;
+  for (auto num_bytes : sizes) {
+    BufferRequirements requirements = {.num_bytes = num_bytes, .alignment = 16};
+    mirror_clients.emplace_back(new DummyBufferClient());
+    EXPECT_NO_THROW(mirror->subscribe(mirror_clients.back().get(), requirements));
+    source_clients.emplace_back(new DummyBufferClient());
+    EXPECT_NO_THROW(source->subscribe(source_clients.back().get(), requirements));
+  }
+  for (size_t i = 0; i < sizes.size(); i++) {
+    EXPECT_EQ(mirror_clients[i]->data(), source_clients[i]->data());
+  }
+}
+
+TEST(test_core23, mirrored_buffer_mismatch) {
+  Device device(DeviceType::GPU, 0);
+  BufferParams source_params = g_buffer_params;
+  source_params.channel = "MIRRORED_BUFFER_MISMATCH_TEST_SOURCE";
+  BufferParams mirror_params = g_buffer_params;
+  mirror_params.channel = "MIRRORED_BUFFER_MISMATCH_TEST_MIRROR";
+  MirrorBufferChannel(mirror_params.channel, source_params.channel);
+
+  auto mirror =
+      GetBuffer(mirror_params, device, std::move(GetAllocator(g_allocator_params, device)));
+  auto source =
+      GetBuffer(source_params, device, std::move(GetAllocator(g_allocator_params, device)));
+  DummyBufferClient mirror_client, source_client;
+  EXPECT_NO_THROW(mirror->subscribe(&mirror_client, {.num_bytes = 256, .alignment = 16}));
+  EXPECT_NO_THROW(source->subscribe(&source_client, {.num_bytes = 512, .alignment = 16}));
+
+  // A different layout gets its own memory
+  EXPECT_NE(mirror_client.data(), nullptr);
+  EXPECT_NE(mirror_client.data(), source_client.data());
+}
@@ -54,5 +54,8 @@ void test_impl() {
 
 TEST(test_core23, data_type_float_test) { test_impl<ScalarType::Float, ScalarType::Double>(); }
 TEST(test_core23, data_type_half_test) { test_impl<ScalarType::Half, ScalarType::Double>(); }
+TEST(test_core23, data_type_bfloat16_test) {
+  test_impl<ScalarType::BFloat16, ScalarType::Half>();
+}
 TEST(test_core23, data_type_int8_test) { test_impl<ScalarType::Int8, ScalarType::Int64>(); }
 TEST(test_core23, data_type_int32_test) { test_impl<ScalarType::Int32, ScalarType::Int64>(); }
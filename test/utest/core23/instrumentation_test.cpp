@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <core23/instrumentation.hpp>
+#include <core23/logger.hpp>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace HugeCTR;
+
+TEST(instrumentation, counters_and_gauges) {
+  auto& registry = MetricsRegistry::get();
+  auto& counter = registry.counter("test_counter");
+  EXPECT_EQ(&counter, &registry.counter("test_counter"));
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&counter] {
+      for (int i = 0; i < 1000; ++i) counter.add(2);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  registry.gauge("test_gauge{table=\"a\"}").set(0.5);
+  registry.gauge("test_gauge{table=\"b\"}").set(0.25);
+
+  auto values = registry.snapshot();
+  EXPECT_EQ(values.at("test_counter"), 8000.);
+  EXPECT_EQ(values.at("test_gauge{table=\"a\"}"), 0.5);
+
+  std::string text = registry.to_prometheus();
+  EXPECT_NE(text.find("# TYPE hugectr_test_counter counter\nhugectr_test_counter 8000\n"),
+            std::string::npos);
+  // The labeled gauges share one TYPE line
+  EXPECT_NE(text.find("# TYPE hugectr_test_gauge gauge\nhugectr_test_gauge{table=\"a\"} 0.5\n"
+                      "hugectr_test_gauge{table=\"b\"} 0.25\n"),
+            std::string::npos);
+
+  registry.reset();
+  EXPECT_EQ(counter.value(), 0u);
+  EXPECT_EQ(registry.snapshot().at("test_gauge{table=\"b\"}"), 0.);
+}
+
+TEST(instrumentation, nvtx_range) {
+  HCTR_NVTX_RANGE("outer");
+  { HCTR_NVTX_RANGE(std::string("inner")); }
+}
+
+}  // namespace
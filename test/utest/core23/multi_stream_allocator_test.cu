@@ -19,6 +19,7 @@
 #include <core23/allocator_factory.hpp>
 #include <core23/allocator_params.hpp>
 #include <core23/cuda_stream.hpp>
+#include <core23/details/caching_cuda_allocator.hpp>
 #include <core23/details/pool_cuda_allocator.hpp>
 #include <core23/logger.hpp>
 #include <core23/low_level_primitives.hpp>
@@ -36,7 +37,7 @@ constexpr size_t NUM_ITERS = 8;
 constexpr int64_t NUM_ELEMENTS = 1024 * 1024;
 constexpr int64_t NUM_BYTES = NUM_ELEMENTS * sizeof(size_t);
 
-void multi_stream_allocator_test_impl() {
+void multi_stream_allocator_test_impl(const AllocatorParams::CustomFactory& factory) {
   AllocatorParams allocator_params;
   Device device(DeviceType::GPU, 0);
 
@@ -59,11 +60,7 @@ void multi_stream_allocator_test_impl() {
     }
   }
 
-  // TODO: change this line after introducing the ResourceManager
-  allocator_params.custom_factory = [](const AllocatorParams& params,
-                                       const Device& device) -> std::unique_ptr<Allocator> {
-    return std::unique_ptr<Allocator>(new PoolCUDAAllocator(device));
-  };
+  allocator_params.custom_factory = factory;
   auto pool_allocator = GetAllocator(allocator_params, device);
   std::vector<CUDAStream> stream_vector;
   for (size_t sid = 0; sid < NUM_STREAMS; sid++) {
@@ -103,4 +100,48 @@ void multi_stream_allocator_test_impl() {
 
 }  // namespace
 
-TEST(test_core23, multi_stream_allocator_cuda_pool) { multi_stream_allocator_test_impl(); }
+TEST(test_core23, multi_stream_allocator_cuda_pool) {
+  // TODO: change this line after introducing the ResourceManager
+  multi_stream_allocator_test_impl(
+      [](const AllocatorParams& params, const Device& device) -> std::unique_ptr<Allocator> {
+        return std::unique_ptr<Allocator>(new PoolCUDAAllocator(device));
+      });
+}
+
+TEST(test_core23, multi_stream_allocator_caching) {
+  multi_stream_allocator_test_impl(AllocatorParams::caching_allocator_factory);
+}
+
+TEST(test_core23, caching_allocator_reuse) {
+  Device device(DeviceType::GPU, 0);
+  CachingCUDAAllocator::empty_cache(device);
+  const auto before = CachingCUDAAllocator::stats(device);
+
+  AllocatorParams allocator_params;
+  allocator_params.custom_factory = AllocatorParams::caching_allocator_factory;
+  auto allocator = GetAllocator(allocator_params, device);
+  auto stream0 = CUDAStream(cudaStreamDefault);
+  auto stream1 = CUDAStream(cudaStreamDefault);
+
+  // The block freed on a stream is handed out again on the same stream
+  void* ptr0 = allocator->allocate(NUM_BYTES, stream0);
+  allocator->deallocate(ptr0, stream0);
+  void* ptr1 = allocator->allocate(NUM_BYTES - 100, stream0);
+  EXPECT_EQ(ptr0, ptr1);
+  allocator->deallocate(ptr1, stream0);
+
+  // and on another stream, once it has waited for the first one
+  void* ptr2 = allocator->allocate(NUM_BYTES - 100, stream1);
+  EXPECT_EQ(ptr0, ptr2);
+
+  auto after = CachingCUDAAllocator::stats(device);
+  EXPECT_EQ(after.num_cache_misses - before.num_cache_misses, 1);
+  EXPECT_EQ(after.num_cache_hits - before.num_cache_hits, 2);
+  EXPECT_EQ(after.num_cross_stream_hits - before.num_cross_stream_hits, 1);
+  EXPECT_GT(after.fragmentation(), 0.);
+
+  allocator->deallocate(ptr2, stream1);
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+  CachingCUDAAllocator::empty_cache(device);
+  EXPECT_EQ(CachingCUDAAllocator::stats(device).cached_bytes, 0);
+}
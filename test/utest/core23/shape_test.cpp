@@ -50,6 +50,32 @@ void test_impl() {
   EXPECT_FALSE(shape2 == shape4);
 }
 
+// Shapes beyond the inline dimensions spill to the heap and behave the same
+void test_many_dims_impl() {
+  const int64_t dims = Shape::kInlineDims + 2;
+  Shape shape(dims);
+  for (int64_t dim = 0; dim < dims; dim++) {
+    shape.set(dim, dim + 1);
+  }
+  EXPECT_TRUE(shape.dims() == dims);
+  EXPECT_TRUE(shape.size(dims - 1) == dims);
+
+  Shape copy = shape;
+  copy[0] = 7;
+  EXPECT_TRUE(shape.size(0) == 1);
+  EXPECT_TRUE(copy.size(0) == 7);
+  copy = Shape({2, 3});
+  EXPECT_TRUE(copy.dims() == 2);
+  EXPECT_TRUE(copy.size() == 6);
+  copy = shape;
+  EXPECT_TRUE(copy == shape);
+
+  EXPECT_THROW(shape.size(dims), std::out_of_range);
+  EXPECT_THROW(Shape({1, 2}).size(-1), std::out_of_range);
+  EXPECT_TRUE(Shape().size(3) == 0);
+}
+
 }  // namespace
 
 TEST(test_core23, shape_test) { test_impl(); }
+TEST(test_core23, shape_many_dims_test) { test_many_dims_impl(); }
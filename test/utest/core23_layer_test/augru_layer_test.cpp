@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <core23/tensor_container.hpp>
+#include <layers/augru_layer.hpp>
+#include <utest/test_utils.hpp>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+constexpr float eps = 1e-3f;
+
+float sigmoid(float x) { return 1.0f / (1.0f + expf(-x)); }
+
+struct AUGRUReference {
+  int64_t batch_size, seq_len, vector_size, hidden_size;
+  std::vector<float> gates;    // (seq_len, batch_size, 3 * hidden_size): u, r, c
+  std::vector<float> hc;       // (seq_len, batch_size, hidden_size): h_prev U_c
+  std::vector<float> hiddens;  // (seq_len + 1, batch_size, hidden_size)
+
+  float attention(const float* att, const float* seq_lens, int64_t b, int64_t t) const {
+    if (seq_lens && t >= static_cast<int64_t>(seq_lens[b])) {
+      return 0.0f;
+    }
+    return att[b * seq_len + t];
+  }
+
+  void fprop(const float* x, const float* att, const float* seq_lens, const float* w,
+             const float* u, const float* bias, float* out) {
+    const int64_t gate_size = 3 * hidden_size;
+    gates.assign(seq_len * batch_size * gate_size, 0.0f);
+    hc.assign(seq_len * batch_size * hidden_size, 0.0f);
+    hiddens.assign((seq_len + 1) * batch_size * hidden_size, 0.0f);
+    for (int64_t t = 0; t < seq_len; t++) {
+      for (int64_t b = 0; b < batch_size; b++) {
+        const float* x_t = x + (b * seq_len + t) * vector_size;
+        const float* h_prev = &hiddens[(t * batch_size + b) * hidden_size];
+        float* h = &hiddens[((t + 1) * batch_size + b) * hidden_size];
+        float* g = &gates[(t * batch_size + b) * gate_size];
+        const float a = attention(att, seq_lens, b, t);
+        for (int64_t j = 0; j < hidden_size; j++) {
+          float pre[3], rec[3];
+          for (int k = 0; k < 3; k++) {
+            pre[k] = bias[k * hidden_size + j];
+            rec[k] = 0.0f;
+            for (int64_t i = 0; i < vector_size; i++) {
+              pre[k] += x_t[i] * w[i * gate_size + k * hidden_size + j];
+            }
+            for (int64_t i = 0; i < hidden_size; i++) {
+              rec[k] += h_prev[i] * u[i * gate_size + k * hidden_size + j];
+            }
+          }
+          const float ug = sigmoid(pre[0] + rec[0]);
+          const float rg = sigmoid(pre[1] + rec[1]);
+          const float cg = tanhf(pre[2] + rg * rec[2]);
+          g[j] = ug;
+          g[hidden_size + j] = rg;
+          g[2 * hidden_size + j] = cg;
+          hc[(t * batch_size + b) * hidden_size + j] = rec[2];
+          h[j] = (1.0f - a * ug) * h_prev[j] + a * ug * cg;
+        }
+      }
+    }
+    std::copy(hiddens.begin() + seq_len * batch_size * hidden_size, hiddens.end(), out);
+  }
+
+  void bprop(const float* dout, const float* x, const float* att, const float* seq_lens,
+             const float* w, const float* u, float* dx, float* datt, float* dw, float* du,
+             float* dbias) {
+    const int64_t gate_size = 3 * hidden_size;
+    std::vector<float> dh(dout, dout + batch_size * hidden_size);
+    std::vector<float> dgx(batch_size * seq_len * gate_size, 0.0f);
+    std::fill(dw, dw + vector_size * gate_size, 0.0f);
+    std::fill(du, du + hidden_size * gate_size, 0.0f);
+    std::fill(dbias, dbias + gate_size, 0.0f);
+    for (int64_t t = seq_len - 1; t >= 0; t--) {
+      std::vector<float> dh_prev(batch_size * hidden_size, 0.0f);
+      for (int64_t b = 0; b < batch_size; b++) {
+        const float* h_prev = &hiddens[(t * batch_size + b) * hidden_size];
+        const float* g = &gates[(t * batch_size + b) * gate_size];
+        const float a = attention(att, seq_lens, b, t);
+        float* dg = &dgx[(b * seq_len + t) * gate_size];
+        std::vector<float> dgh(gate_size);
+        float da = 0.0f;
+        for (int64_t j = 0; j < hidden_size; j++) {
+          const float ug = g[j], rg = g[hidden_size + j], cg = g[2 * hidden_size + j];
+          const float grad = dh[b * hidden_size + j];
+          da += grad * (cg - h_prev[j]) * ug;
+          const float dc = grad * a * ug * (1.0f - cg * cg);
+          const float dug = grad * (cg - h_prev[j]) * a * ug * (1.0f - ug);
+          const float dr = dc * hc[(t * batch_size + b) * hidden_size + j] * rg * (1.0f - rg);
+          dg[j] = dug;
+          dg[hidden_size + j] = dr;
+          dg[2 * hidden_size + j] = dc;
+          dgh[j] = dug;
+          dgh[hidden_size + j] = dr;
+          dgh[2 * hidden_size + j] = dc * rg;
+          dh_prev[b * hidden_size + j] += grad * (1.0f - a * ug);
+        }
+        const bool valid = !seq_lens || t < static_cast<int64_t>(seq_lens[b]);
+        datt[b * seq_len + t] = valid ? da : 0.0f;
+        for (int64_t i = 0; i < hidden_size; i++) {
+          for (int64_t k = 0; k < gate_size; k++) {
+            dh_prev[b * hidden_size + i] += dgh[k] * u[i * gate_size + k];
+            du[i * gate_size + k] += h_prev[i] * dgh[k];
+          }
+        }
+      }
+      dh.swap(dh_prev);
+    }
+    for (int64_t row = 0; row < batch_size * seq_len; row++) {
+      const float* dg = &dgx[row * gate_size];
+      for (int64_t k = 0; k < gate_size; k++) {
+        dbias[k] += dg[k];
+        for (int64_t i = 0; i < vector_size; i++) {
+          dw[i * gate_size + k] += x[row * vector_size + i] * dg[k];
+        }
+      }
+      for (int64_t i = 0; i < vector_size; i++) {
+        float sum = 0.0f;
+        for (int64_t k = 0; k < gate_size; k++) {
+          sum += dg[k] * w[i * gate_size + k];
+        }
+        dx[row * vector_size + i] = sum;
+      }
+    }
+  }
+};
+
+void augru_layer_test(int64_t batch_size, int64_t seq_len, int64_t vector_size,
+                      int64_t hidden_size, bool use_seq_lens) {
+  core23::BufferParams blobs_buffer_params = {};
+  blobs_buffer_params.channel = GetBlobsBufferChannel();
+  core23::TensorParams tensor_params = core23::TensorParams()
+                                           .data_type(core23::ScalarType::Float)
+                                           .buffer_params(blobs_buffer_params);
+
+  std::vector<core23::Tensor> in_tensors{
+      core23::Tensor(tensor_params.shape({batch_size, seq_len, vector_size})),
+      core23::Tensor(tensor_params.shape({batch_size, seq_len}))};
+  if (use_seq_lens) {
+    in_tensors.emplace_back(tensor_params.shape({batch_size, 1}));
+  }
+  core23::Tensor out_tensor(tensor_params.shape({batch_size, hidden_size}));
+
+  AUGRULayer<float> augru_layer(in_tensors, out_tensor, test::get_default_gpu());
+
+  auto weights = augru_layer.get_weights();
+  auto weights_grad = augru_layer.get_wgrads();
+  core23::TensorContainer<float, 1, 1> weights_container(std::move(weights),
+                                                         {static_cast<int64_t>(weights.size())});
+  core23::TensorContainer<float, 1, 1> weights_grad_container(
+      std::move(weights_grad), {static_cast<int64_t>(weights_grad.size())});
+
+  const int64_t gate_size = 3 * hidden_size;
+  const int64_t in_len = batch_size * seq_len * vector_size;
+  const int64_t att_len = batch_size * seq_len;
+  const int64_t out_len = batch_size * hidden_size;
+  std::vector<float> h_in(in_len), h_att(att_len), h_seq_lens(batch_size), h_out(out_len);
+  std::vector<float> h_w(vector_size * gate_size), h_u(hidden_size * gate_size), h_b(gate_size);
+
+  test::UniformDataSimulator simulator;
+  simulator.fill(h_in.data(), in_len, -1.0f, 1.0f);
+  simulator.fill(h_att.data(), att_len, 0.0f, 1.0f);
+  simulator.fill(h_w.data(), h_w.size(), -0.5f, 0.5f);
+  simulator.fill(h_u.data(), h_u.size(), -0.5f, 0.5f);
+  simulator.fill(h_b.data(), h_b.size(), -0.5f, 0.5f);
+  for (int64_t b = 0; b < batch_size; b++) {
+    h_seq_lens[b] = static_cast<float>(1 + b % seq_len);
+  }
+
+  HCTR_LIB_THROW(cudaMemcpy(in_tensors[0].data(), h_in.data(), in_len * sizeof(float),
+                            cudaMemcpyHostToDevice));
+  HCTR_LIB_THROW(cudaMemcpy(in_tensors[1].data(), h_att.data(), att_len * sizeof(float),
+                            cudaMemcpyHostToDevice));
+  if (use_seq_lens) {
+    HCTR_LIB_THROW(cudaMemcpy(in_tensors[2].data(), h_seq_lens.data(), batch_size * sizeof(float),
+                              cudaMemcpyHostToDevice));
+  }
+  HCTR_LIB_THROW(cudaMemcpy(weights_container[0].data(), h_w.data(), h_w.size() * sizeof(float),
+                            cudaMemcpyHostToDevice));
+  HCTR_LIB_THROW(cudaMemcpy(weights_container[1].data(), h_u.data(), h_u.size() * sizeof(float),
+                            cudaMemcpyHostToDevice));
+  HCTR_LIB_THROW(cudaMemcpy(weights_container[2].data(), h_b.data(), h_b.size() * sizeof(float),
+                            cudaMemcpyHostToDevice));
+
+  // fprop
+  AUGRUReference reference{batch_size, seq_len, vector_size, hidden_size};
+  std::vector<float> expected_out(out_len);
+  reference.fprop(h_in.data(), h_att.data(), use_seq_lens ? h_seq_lens.data() : nullptr,
+                  h_w.data(), h_u.data(), h_b.data(), expected_out.data());
+
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+  augru_layer.fprop(true);
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+  HCTR_LIB_THROW(cudaMemcpy(h_out.data(), out_tensor.data(), out_len * sizeof(float),
+                            cudaMemcpyDeviceToHost));
+  ASSERT_TRUE(test::compare_array_approx<float>(h_out.data(), expected_out.data(), out_len, eps));
+
+  // bprop
+  std::vector<float> h_dout(out_len);
+  simulator.fill(h_dout.data(), out_len, -1.0f, 1.0f);
+  std::vector<float> expected_dx(in_len), expected_datt(att_len), expected_dw(h_w.size()),
+      expected_du(h_u.size()), expected_db(gate_size);
+  reference.bprop(h_dout.data(), h_in.data(), h_att.data(),
+                  use_seq_lens ? h_seq_lens.data() : nullptr, h_w.data(), h_u.data(),
+                  expected_dx.data(), expected_datt.data(), expected_dw.data(),
+                  expected_du.data(), expected_db.data());
+
+  HCTR_LIB_THROW(cudaMemcpy(out_tensor.data(), h_dout.data(), out_len * sizeof(float),
+                            cudaMemcpyHostToDevice));
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+  augru_layer.bprop();
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+
+  std::vector<float> h_dx(in_len), h_datt(att_len), h_dw(h_w.size()), h_du(h_u.size()),
+      h_db(gate_size);
+  HCTR_LIB_THROW(cudaMemcpy(h_dx.data(), in_tensors[0].data(), in_len * sizeof(float),
+                            cudaMemcpyDeviceToHost));
+  HCTR_LIB_THROW(cudaMemcpy(h_datt.data(), in_tensors[1].data(), att_len * sizeof(float),
+                            cudaMemcpyDeviceToHost));
+  HCTR_LIB_THROW(cudaMemcpy(h_dw.data(), weights_grad_container[0].data(),
+                            h_dw.size() * sizeof(float), cudaMemcpyDeviceToHost));
+  HCTR_LIB_THROW(cudaMemcpy(h_du.data(), weights_grad_container[1].data(),
+                            h_du.size() * sizeof(float), cudaMemcpyDeviceToHost));
+  HCTR_LIB_THROW(cudaMemcpy(h_db.data(), weights_grad_container[2].data(),
+                            h_db.size() * sizeof(float), cudaMemcpyDeviceToHost));
+
+  ASSERT_TRUE(test::compare_array_approx<float>(h_dx.data(), expected_dx.data(), in_len, eps));
+  ASSERT_TRUE(
+      test::compare_array_approx<float>(h_datt.data(), expected_datt.data(), att_len, eps));
+  ASSERT_TRUE(
+      test::compare_array_approx<float>(h_dw.data(), expected_dw.data(), h_dw.size(), eps));
+  ASSERT_TRUE(
+      test::compare_array_approx<float>(h_du.data(), expected_du.data(), h_du.size(), eps));
+  ASSERT_TRUE(test::compare_array_approx<float>(h_db.data(), expected_db.data(), gate_size, eps));
+}
+
+}  // namespace
+
+TEST(augru_layer, fp32_4x5x8x16) { augru_layer_test(4, 5, 8, 16, false); }
+TEST(augru_layer, fp32_16x20x18x36) { augru_layer_test(16, 20, 18, 36, false); }
+TEST(augru_layer, fp32_seq_lens_16x20x18x36) { augru_layer_test(16, 20, 18, 36, true); }
+TEST(augru_layer, fp32_seq_lens_32x10x64x100) { augru_layer_test(32, 10, 64, 100, true); }
@@ -35,7 +35,7 @@ const float eps = 1e-6;
 const float thr = 0.95f;
 
 template <typename T>
-void dropout_test(int64_t dim0, int64_t dim1, float rate) {
+void dropout_test(int64_t dim0, int64_t dim1, float rate, bool recompute = false) {
   constexpr bool use_mixed_precision = std::is_same_v<T, __half>;
 
   auto device = core23::Device::current();
@@ -53,7 +53,9 @@ void dropout_test(int64_t dim0, int64_t dim1, float rate) {
   core23::Tensor bottom_tensor(tensor_params);
   core23::Tensor top_tensor(tensor_params);
 
-  DropoutLayer<T> dropout_layer(bottom_tensor, top_tensor, rate, test::get_default_gpu());
+  DropoutLayer<T> dropout_layer(bottom_tensor, top_tensor, rate, test::get_default_gpu(),
+                                recompute);
+  dropout_layer.initialize();
 
   std::vector<T> h_bottom(len);
   test::normal_sync_cpu(h_bottom.data(), h_bottom.size(), 0.f, 1.f, generator);
@@ -99,6 +101,15 @@ void dropout_test(int64_t dim0, int64_t dim1, float rate) {
   p = (cnt_zero_bprop < ref_zero_cnt) ? ref_zero_cnt : cnt_zero_bprop;
   c = (cnt_zero_bprop < ref_zero_cnt) ? cnt_zero_bprop : ref_zero_cnt;
   ASSERT_TRUE(c / p > thr);
+
+  // The recomputed mask of bprop should be the one of fprop
+  if (recompute) {
+    for (int i = 0; i < len; i++) {
+      const bool dropped_fprop = std::abs(__half2float(h_top[i]) - 0.f) < eps;
+      const bool dropped_bprop = std::abs(__half2float(h_bottom[i]) - 0.f) < eps;
+      ASSERT_TRUE(!dropped_fprop || dropped_bprop);
+    }
+  }
 }
 
 TEST(dropout_layer, fp32_2048x1024_25) { dropout_test<float>(2048, 1024, 0.25); }
@@ -117,4 +128,8 @@ TEST(dropout_layer, fp16_2048x1024_75) { dropout_test<__half>(2048, 1024, 0.75);
 
 TEST(dropout_layer, fp16_2048x1024_99) { dropout_test<__half>(2048, 1024, 0.99); }
 
+TEST(dropout_layer, fp32_2048x1024_50_recompute) { dropout_test<float>(2048, 1024, 0.50, true); }
+
+TEST(dropout_layer, fp16_2048x1024_50_recompute) { dropout_test<__half>(2048, 1024, 0.50, true); }
+
 }  // end namespace
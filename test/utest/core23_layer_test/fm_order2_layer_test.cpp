@@ -187,5 +187,7 @@ void fm_order2_test(int64_t batch_size, int64_t slot_num, int64_t emb_vec_size)
 
 TEST(fm_order2_layer, fp32_4x2x32) { fm_order2_test<float>(4, 2, 32); }
 TEST(fm_order2_layer, fp32_4096x10x64) { fm_order2_test<float>(4096, 10, 64); }
+TEST(fm_order2_layer, fp32_4x3x7) { fm_order2_test<float>(4, 3, 7); }
 TEST(fm_order2_layer, fp16_4x2x32) { fm_order2_test<__half>(4, 2, 32); }
 TEST(fm_order2_layer, fp16_4096x10x64) { fm_order2_test<__half>(4096, 10, 64); }
+TEST(fm_order2_layer, fp16_4096x10x18) { fm_order2_test<__half>(4096, 10, 18); }
@@ -266,6 +266,7 @@ TEST(fully_connected_layer, fp32_1024x1024x1024) { fully_connected_layer_test(10
 // TEST(fully_connected_layer, fp32_1024x1x1024) { fully_connected_layer_test(1024, 1, 1024); }
 // TEST(fully_connected_layer, fp32_1024x1024x1) { fully_connected_layer_test(1024, 1024, 1); }
 TEST(fully_connected_layer, fp32_1x1x1) { fully_connected_layer_test(1, 1, 1); }
+TEST(fully_connected_layer, fp32_4093x1x479) { fully_connected_layer_test(4093, 1, 479); }
 // TEST(fully_connected_layer, fp32_256x512x1024) { fully_connected_layer_test(256, 512, 1024); }
 TEST(fully_connected_layer, fp32_251x511x1023) { fully_connected_layer_test(251, 511, 1023); }
 TEST(fully_connected_layer, fp32_512x4x512x256) { fully_connected_layer_test_3d(512, 4, 512, 256); }
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <layers/grouped_mlp_layer.hpp>
+#include <network_buffer_channels.hpp>
+#include <random>
+#include <utest/test_utils.hpp>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+const float eps = 1e-3f;
+
+void expect_near(const std::vector<float>& expected, const core23::Tensor& tensor,
+                 const char* what) {
+  std::vector<float> actual(tensor.num_elements());
+  HCTR_LIB_THROW(cudaMemcpy(actual.data(), tensor.data(), actual.size() * sizeof(float),
+                            cudaMemcpyDeviceToHost));
+  ASSERT_EQ(actual.size(), expected.size()) << what;
+  for (size_t i = 0; i < actual.size(); i++) {
+    ASSERT_NEAR(actual[i], expected[i], eps * std::max(1.0f, std::abs(expected[i])))
+        << what << " at " << i;
+  }
+}
+
+void upload(const std::vector<float>& h_data, const core23::Tensor& tensor) {
+  HCTR_LIB_THROW(cudaMemcpy(tensor.data(), h_data.data(), h_data.size() * sizeof(float),
+                            cudaMemcpyHostToDevice));
+}
+
+void grouped_mlp_layer_test(int64_t num_towers, int64_t batch_size, int64_t input_size,
+                            const std::vector<int64_t>& num_outputs,
+                            const std::vector<Activation_t>& acts, bool shared_bottom) {
+  const int64_t num_layers = num_outputs.size();
+  core23::BufferParams blobs_buffer_params = {};
+  blobs_buffer_params.channel = GetBlobsBufferChannel();
+  auto make_tensor = [&](int64_t rows, int64_t cols) {
+    return core23::Tensor(core23::TensorParams()
+                              .data_type(core23::ScalarType::Float)
+                              .shape({rows, cols})
+                              .buffer_params(blobs_buffer_params));
+  };
+  std::vector<core23::Tensor> bottom_tensors, top_tensors;
+  for (int64_t t = 0; t < (shared_bottom ? 1 : num_towers); t++) {
+    bottom_tensors.push_back(make_tensor(batch_size, input_size));
+  }
+  for (int64_t t = 0; t < num_towers; t++) {
+    top_tensors.push_back(make_tensor(batch_size, num_outputs.back()));
+  }
+  GroupedMLPLayer<float> layer(bottom_tensors, top_tensors, num_outputs, test::get_default_gpu(),
+                               acts, std::vector<bool>(num_layers, true));
+  layer.initialize();
+
+  std::mt19937 gen(424242);
+  std::uniform_real_distribution<float> dis(-1.0f, 1.0f);
+  auto random_vector = [&](size_t size) {
+    std::vector<float> v(size);
+    for (auto& x : v) {
+      x = dis(gen);
+    }
+    return v;
+  };
+
+  // The weights are ordered tower by tower, kernel and bias of each layer
+  auto weights = layer.get_weights();
+  auto wgrads = layer.get_wgrads();
+  std::vector<std::vector<float>> h_weights;
+  for (size_t i = 0; i < weights.size(); i++) {
+    h_weights.push_back(random_vector(weights[i].num_elements()));
+    upload(h_weights.back(), weights[i]);
+    upload(std::vector<float>(wgrads[i].num_elements(), 0.0f), wgrads[i]);
+  }
+  std::vector<std::vector<float>> h_bottoms;
+  for (auto& bottom_tensor : bottom_tensors) {
+    h_bottoms.push_back(random_vector(bottom_tensor.num_elements()));
+    upload(h_bottoms.back(), bottom_tensor);
+  }
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+
+  // h_acts[t][i] is the output of layer i of tower t
+  std::vector<std::vector<std::vector<float>>> h_acts(num_towers);
+  for (int64_t t = 0; t < num_towers; t++) {
+    const std::vector<float>* x = &h_bottoms[shared_bottom ? 0 : t];
+    for (int64_t i = 0; i < num_layers; i++) {
+      const int64_t k = i == 0 ? input_size : num_outputs[i - 1];
+      const int64_t n = num_outputs[i];
+      const auto& kernel = h_weights[2 * (t * num_layers + i)];
+      const auto& bias = h_weights[2 * (t * num_layers + i) + 1];
+      std::vector<float> y(batch_size * n);
+      for (int64_t r = 0; r < batch_size; r++) {
+        for (int64_t j = 0; j < n; j++) {
+          float sum = bias[j];
+          for (int64_t kk = 0; kk < k; kk++) {
+            sum += (*x)[r * k + kk] * kernel[kk * n + j];
+          }
+          y[r * n + j] = acts[i] == Activation_t::Relu ? std::max(sum, 0.0f) : sum;
+        }
+      }
+      h_acts[t].push_back(std::move(y));
+      x = &h_acts[t].back();
+    }
+  }
+
+  layer.fprop(true);
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+  for (int64_t t = 0; t < num_towers; t++) {
+    expect_near(h_acts[t].back(), top_tensors[t], "top");
+  }
+
+  std::vector<std::vector<float>> h_wgrads(weights.size());
+  std::vector<std::vector<float>> h_bottom_grads(
+      bottom_tensors.size(), std::vector<float>(batch_size * input_size, 0.0f));
+  for (int64_t t = 0; t < num_towers; t++) {
+    std::vector<float> grad = random_vector(batch_size * num_outputs.back());
+    upload(grad, top_tensors[t]);
+    for (int64_t i = num_layers - 1; i >= 0; i--) {
+      const int64_t k = i == 0 ? input_size : num_outputs[i - 1];
+      const int64_t n = num_outputs[i];
+      const auto& x = i == 0 ? h_bottoms[shared_bottom ? 0 : t] : h_acts[t][i - 1];
+      const auto& kernel = h_weights[2 * (t * num_layers + i)];
+      if (acts[i] == Activation_t::Relu) {
+        for (size_t idx = 0; idx < grad.size(); idx++) {
+          if (h_acts[t][i][idx] <= 0.0f) {
+            grad[idx] = 0.0f;
+          }
+        }
+      }
+      std::vector<float> kernel_grad(k * n, 0.0f), bias_grad(n, 0.0f), dx(batch_size * k, 0.0f);
+      for (int64_t r = 0; r < batch_size; r++) {
+        for (int64_t j = 0; j < n; j++) {
+          const float g = grad[r * n + j];
+          bias_grad[j] += g;
+          for (int64_t kk = 0; kk < k; kk++) {
+            kernel_grad[kk * n + j] += x[r * k + kk] * g;
+            dx[r * k + kk] += g * kernel[kk * n + j];
+          }
+        }
+      }
+      h_wgrads[2 * (t * num_layers + i)] = std::move(kernel_grad);
+      h_wgrads[2 * (t * num_layers + i) + 1] = std::move(bias_grad);
+      grad = std::move(dx);
+    }
+    auto& bottom_grad = h_bottom_grads[shared_bottom ? 0 : t];
+    for (size_t idx = 0; idx < grad.size(); idx++) {
+      bottom_grad[idx] += grad[idx];
+    }
+  }
+
+  layer.bprop();
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+  for (size_t i = 0; i < wgrads.size(); i++) {
+    expect_near(h_wgrads[i], wgrads[i], i % 2 ? "bias_grad" : "kernel_grad");
+  }
+  for (size_t t = 0; t < bottom_tensors.size(); t++) {
+    expect_near(h_bottom_grads[t], bottom_tensors[t], "bottom_grad");
+  }
+}
+
+TEST(grouped_mlp_layer, fp32_4x64x48_separate_inputs) {
+  grouped_mlp_layer_test(4, 64, 48, {32, 16, 1},
+                         {Activation_t::Relu, Activation_t::Relu, Activation_t::None}, false);
+}
+TEST(grouped_mlp_layer, fp32_12x128x40_shared_input) {
+  grouped_mlp_layer_test(12, 128, 40, {64, 8}, {Activation_t::Relu, Activation_t::Relu}, true);
+}
+
+}  // namespace
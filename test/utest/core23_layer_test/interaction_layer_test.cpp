@@ -325,3 +325,19 @@ TEST(interaction_layer, fp16_512x8643) {
   }
   interaction_layer_test<__half>(512, 130, 128);
 }
+TEST(interaction_layer, fp16_256x2336) {
+  int major = 0;
+  cudaDeviceGetAttribute(&major, cudaDevAttrComputeCapabilityMajor, 0);
+  if (major < 7) {
+    GTEST_SKIP();
+  }
+  interaction_layer_test<__half>(256, 64, 256);
+}
+TEST(interaction_layer, fp16_128x1854) {
+  int major = 0;
+  cudaDeviceGetAttribute(&major, cudaDevAttrComputeCapabilityMajor, 0);
+  if (major < 7) {
+    GTEST_SKIP();
+  }
+  interaction_layer_test<__half>(128, 60, 24);
+}
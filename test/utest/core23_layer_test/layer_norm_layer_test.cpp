@@ -16,6 +16,7 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <core23/tensor_container.hpp>
 #include <layers/layer_norm_layer.hpp>
 #include <utest/test_utils.hpp>
@@ -200,7 +201,8 @@ void layer_norm_bprop_cpu<__half>(const __half* gamma, const __half* out, __half
 }
 
 template <typename T>
-void layer_norm_test(core23::Shape dims) {
+void layer_norm_test(core23::Shape dims, Activation_t act = Activation_t::None,
+                     float dropout_rate = 0.f) {
   core23::BufferParams blobs_buffer_params = {};
   blobs_buffer_params.channel = GetBlobsBufferChannel();
 
@@ -214,8 +216,9 @@ void layer_norm_test(core23::Shape dims) {
                                                  .shape(dims)
                                                  .buffer_params(blobs_buffer_params));
 
-  typename LayerNormLayer<T>::Params params = {eps};
+  typename LayerNormLayer<T>::Params params = {eps, act, dropout_rate};
   LayerNormLayer<T> layer_norm_layer(in_tensor, out_tensor, params, test::get_default_gpu());
+  layer_norm_layer.initialize();
 
   const auto& in_tensor_dim = dims;
   int64_t batch_size = 1;
@@ -245,6 +248,8 @@ void layer_norm_test(core23::Shape dims) {
   std::unique_ptr<T[]> h_in(new T[len]);
   std::unique_ptr<T[]> h_out(new T[len]);
   std::unique_ptr<T[]> h_expected(new T[len]);
+  std::unique_ptr<T[]> h_out_grad(new T[len]);
+  std::unique_ptr<bool[]> h_relu_mask(new bool[len]);
 
   test::GaussianDataSimulator simulator(0.0, 1.0);
 
@@ -275,6 +280,12 @@ void layer_norm_test(core23::Shape dims) {
 
   layer_norm_fprop_cpu<T>(h_gamma.get(), h_beta.get(), h_in.get(), h_expected.get(), batch_size,
                           num_feature);
+  for (int64_t i = 0; i < len; i++) {
+    h_relu_mask[i] = act != Activation_t::Relu || static_cast<float>(h_expected[i]) > 0.0f;
+    if (!h_relu_mask[i]) {
+      h_expected[i] = 0.0f;
+    }
+  }
 
   HCTR_LIB_THROW(cudaMemcpy(d_in, h_in.get(), len * sizeof(T), cudaMemcpyHostToDevice));
 
@@ -284,13 +295,37 @@ void layer_norm_test(core23::Shape dims) {
 
   HCTR_LIB_THROW(cudaMemcpy(h_out.get(), d_out, len * sizeof(T), cudaMemcpyDeviceToHost));
 
+  // The fused dropout mask is read back from the output: a kept element is scaled, a dropped one is
+  // 0, and both masks are applied to the gradient
+  std::unique_ptr<float[]> h_dropout_factor(new float[len]);
+  if (dropout_rate > 0.f) {
+    const float scale = 1.f / (1.f - dropout_rate);
+    int64_t num_dropped = 0;
+    for (int64_t i = 0; i < len; i++) {
+      const bool dropped = static_cast<float>(h_expected[i]) != 0.0f &&
+                           static_cast<float>(h_out[i]) == 0.0f;
+      num_dropped += dropped;
+      h_dropout_factor[i] = dropped ? 0.0f : scale;
+      h_expected[i] = static_cast<float>(h_expected[i]) * h_dropout_factor[i];
+    }
+    const float nonzero = act == Activation_t::Relu ? 0.5f : 1.0f;
+    ASSERT_NEAR(static_cast<float>(num_dropped) / len, dropout_rate * nonzero, 0.05f);
+  } else {
+    std::fill(h_dropout_factor.get(), h_dropout_factor.get() + len, 1.0f);
+  }
+
   ASSERT_TRUE(test::compare_array_approx<T>(h_out.get(), h_expected.get(), len, Eps<T>::value()));
 
   simulator.fill(h_out.get(), len);
+  // the gradients of the fused ReLU and dropout are applied before the LayerNorm one
+  for (int64_t i = 0; i < len; i++) {
+    h_out_grad[i] = h_relu_mask[i] ? T(static_cast<float>(h_out[i]) * h_dropout_factor[i])
+                                   : T(0.0f);
+  }
 
   HCTR_LIB_THROW(cudaMemcpy(h_expected.get(), d_in, len * sizeof(T), cudaMemcpyDeviceToHost));
 
-  layer_norm_bprop_cpu<T>(h_gamma.get(), h_out.get(), h_expected.get(), h_gamma_grad.get(),
+  layer_norm_bprop_cpu<T>(h_gamma.get(), h_out_grad.get(), h_expected.get(), h_gamma_grad.get(),
                           h_beta_grad.get(), batch_size, num_feature);
 
   HCTR_LIB_THROW(cudaMemcpy(d_out, h_out.get(), len * sizeof(T), cudaMemcpyHostToDevice));
@@ -338,6 +373,26 @@ TEST(layer_norm_layer, fp16_2x1024) {
   core23::Shape dims{2, 1024};
   layer_norm_test<__half>(dims);
 }
+TEST(layer_norm_layer, fp32_relu_4x1000) {
+  core23::Shape dims{4, 1000};
+  layer_norm_test<float>(dims, Activation_t::Relu);
+}
+TEST(layer_norm_layer, fp16_relu_4x10x512) {
+  core23::Shape dims{4, 10, 512};
+  layer_norm_test<__half>(dims, Activation_t::Relu);
+}
+TEST(layer_norm_layer, fp32_dropout_4x1024) {
+  core23::Shape dims{4, 1024};
+  layer_norm_test<float>(dims, Activation_t::None, 0.5f);
+}
+TEST(layer_norm_layer, fp32_relu_dropout_8x1000) {
+  core23::Shape dims{8, 1000};
+  layer_norm_test<float>(dims, Activation_t::Relu, 0.25f);
+}
+TEST(layer_norm_layer, fp16_relu_dropout_4x10x512) {
+  core23::Shape dims{4, 10, 512};
+  layer_norm_test<__half>(dims, Activation_t::Relu, 0.5f);
+}
 /*TEST(layer_norm_layer, fp16_2x1024x20x512) {
   core23::Shape dims{1, 4, 1, 768};
   layer_norm_test<__half>(dims);
@@ -649,3 +649,99 @@ TEST(mlp_test_tf32_perf, all) {
   mlp_test<float>(network, mlp_num_outputs, use_relu, use_bias, use_fuse_wb, true, input_dim,
                   batch_size, perf_config_set);
 };
+
+static void fill_tensor(core23::Tensor& tensor, test::GaussianDataSimulator& simulator) {
+  std::vector<__half> h_data(tensor.num_elements());
+  simulator.fill(h_data.data(), h_data.size());
+  HCTR_LIB_THROW(cudaMemcpy(tensor.data(), h_data.data(), tensor.num_bytes(),
+                            cudaMemcpyHostToDevice));
+}
+
+// Relative L2 error of out against ref
+static float relative_error(core23::Tensor& ref, core23::Tensor& out) {
+  std::vector<__half> h_ref(ref.num_elements()), h_out(out.num_elements());
+  HCTR_LIB_THROW(cudaMemcpy(h_ref.data(), ref.data(), ref.num_bytes(), cudaMemcpyDeviceToHost));
+  HCTR_LIB_THROW(cudaMemcpy(h_out.data(), out.data(), out.num_bytes(), cudaMemcpyDeviceToHost));
+  double diff = 0.0, norm = 0.0;
+  for (size_t i = 0; i < h_ref.size(); i++) {
+    const double r = __half2float(h_ref[i]);
+    const double o = __half2float(h_out[i]);
+    diff += (r - o) * (r - o);
+    norm += r * r;
+  }
+  return std::sqrt(diff / std::max(norm, 1e-12));
+}
+
+// Runs the same MLP in fp16 and fp8, the fp8 results should match up to the fp8 rounding.
+static void mlp_fp8_test(const std::vector<int64_t>& num_outputs, int64_t input_dim,
+                         int64_t batch_size) {
+  std::shared_ptr<GPUResource> gpu_resource = test::get_default_gpu();
+  if (gpu_resource->get_cc_major() * 10 + gpu_resource->get_cc_minor() < 89) {
+    GTEST_SKIP() << "fp8 GEMMs need a GPU of compute capability 8.9 or higher";
+  }
+
+  core23::BufferParams buffer_params = {};
+  buffer_params.channel = GetBlobsBufferChannel();
+  auto tensor_params =
+      core23::TensorParams().data_type(core23::ScalarType::Half).buffer_params(buffer_params);
+
+  std::vector<Activation_t> acts(num_outputs.size(), Activation_t::Relu);
+  acts.back() = Activation_t::None;
+  std::vector<bool> biases(num_outputs.size(), true);
+
+  std::vector<core23::Tensor> inputs, outputs;
+  std::vector<std::unique_ptr<MLPLayer<__half>>> mlps;
+  for (bool enable_fp8 : {false, true}) {
+    inputs.emplace_back(tensor_params.shape({batch_size, input_dim}));
+    outputs.emplace_back(tensor_params.shape({batch_size, num_outputs.back()}));
+    mlps.emplace_back(new MLPLayer<__half>({inputs.back()}, {outputs.back()}, num_outputs,
+                                           gpu_resource, acts, biases,
+                                           std::vector<Initializer_t>(), false, false, false,
+                                           false, enable_fp8));
+    mlps.back()->initialize();
+  }
+
+  test::GaussianDataSimulator simulator(0.0f, 1.0f);
+  test::GaussianDataSimulator weight_simulator(0.0f, 1.0f / std::sqrt(input_dim));
+  for (size_t i = 0; i < num_outputs.size(); i++) {
+    fill_tensor(mlps[0]->get_kernel(i), weight_simulator);
+    fill_tensor(mlps[0]->get_bias(i), weight_simulator);
+    HCTR_LIB_THROW(cudaMemcpy(mlps[1]->get_kernel(i).data(), mlps[0]->get_kernel(i).data(),
+                              mlps[0]->get_kernel(i).num_bytes(), cudaMemcpyDeviceToDevice));
+    HCTR_LIB_THROW(cudaMemcpy(mlps[1]->get_bias(i).data(), mlps[0]->get_bias(i).data(),
+                              mlps[0]->get_bias(i).num_bytes(), cudaMemcpyDeviceToDevice));
+    for (auto& mlp : mlps) {
+      HCTR_LIB_THROW(cudaMemset(mlp->get_kernel_grad(i).data(), 0,
+                                mlp->get_kernel_grad(i).num_bytes()));
+    }
+  }
+
+  // A few iterations, so that the delayed scales come from the amax histories
+  for (int iter = 0; iter < 4; iter++) {
+    fill_tensor(inputs[0], simulator);
+    HCTR_LIB_THROW(cudaMemcpy(inputs[1].data(), inputs[0].data(), inputs[0].num_bytes(),
+                              cudaMemcpyDeviceToDevice));
+    for (auto& mlp : mlps) {
+      mlp->fprop(true);
+    }
+    HCTR_LIB_THROW(cudaDeviceSynchronize());
+    EXPECT_LT(relative_error(outputs[0], outputs[1]), 0.1f) << "fprop of iteration " << iter;
+
+    fill_tensor(outputs[0], simulator);
+    HCTR_LIB_THROW(cudaMemcpy(outputs[1].data(), outputs[0].data(), outputs[0].num_bytes(),
+                              cudaMemcpyDeviceToDevice));
+    for (auto& mlp : mlps) {
+      mlp->bprop();
+    }
+    HCTR_LIB_THROW(cudaDeviceSynchronize());
+    EXPECT_LT(relative_error(inputs[0], inputs[1]), 0.1f) << "dgrad of iteration " << iter;
+  }
+  for (size_t i = 0; i < num_outputs.size(); i++) {
+    EXPECT_LT(relative_error(mlps[0]->get_kernel_grad(i), mlps[1]->get_kernel_grad(i)), 0.1f)
+        << "wgrad of layer " << i;
+    EXPECT_LT(relative_error(mlps[0]->get_bias_grad(i), mlps[1]->get_bias_grad(i)), 0.1f)
+        << "bgrad of layer " << i;
+  }
+}
+
+TEST(mlp_test_fp8, all) { mlp_fp8_test({512, 256, 128}, 256, 256); };
@@ -204,3 +204,5 @@ TEST(reduce_mean_layer, fp32_2x3x4_0) { reduce_mean_test<float>(2, 3, 4, 0); }
 TEST(reduce_mean_layer, fp32_2x3x4_1) { reduce_mean_test<float>(2, 3, 4, 1); }
 TEST(reduce_mean_layer, fp32_2x3x4_2) { reduce_mean_test<float>(2, 3, 4, 2); }
 TEST(reduce_mean_layer, fp32_40960x39x1_1) { reduce_mean_test<float>(40960, 39, 1, 1); }
+TEST(reduce_mean_layer, fp32_64x26x16_1) { reduce_mean_test<float>(64, 26, 16, 1); }
+TEST(reduce_mean_layer, fp32_16x3x4100_2) { reduce_mean_test<float>(16, 3, 4100, 2); }
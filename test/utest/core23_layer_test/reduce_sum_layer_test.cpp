@@ -206,6 +206,89 @@ void reduce_sum_test(int64_t batch_size, int64_t slot_num, int64_t embedding_vec
                                             Eps<T>()));  // compare dgrad
 }
 
+template <typename T>
+void reduce_sum_seq_len_test(int64_t batch_size, int64_t max_seq_len, int64_t embedding_vec_size) {
+  constexpr bool use_mixed_precision = std::is_same_v<T, __half>;
+
+  auto device = core23::Device::current();
+  core23::CURANDGenerator generator(core23::DeviceType::CPU);
+  core23::TensorParams tensor_params =
+      core23::TensorParams()
+          .device(device)
+          .data_type(use_mixed_precision ? core23::ScalarType::Half : core23::ScalarType::Float)
+          .buffer_channel(core23::GetRandomBufferChannel());
+
+  core23::Shape in_shape = {batch_size, max_seq_len, embedding_vec_size};
+
+  core23::Tensor bottom_tensor(tensor_params.shape(in_shape));
+  core23::Tensor seq_len_tensor(tensor_params.shape({batch_size, 1}));
+  core23::Tensor top_tensor;
+
+  ReduceSumLayer<T> reduce_sum_layer(bottom_tensor, seq_len_tensor, top_tensor, 1,
+                                     test::get_default_gpu());
+
+  reduce_sum_layer.initialize();
+
+  auto in_size = in_shape.size();
+  auto out_size = top_tensor.shape().size();
+
+  std::vector<T> h_bottom(in_size);
+  std::vector<T> h_seq_len(batch_size);
+  std::vector<T> h_top(out_size);
+  std::vector<T> h_cpu_top(out_size, 0.0f);
+  std::vector<T> h_gpu_dgrad(in_size);
+  std::vector<T> h_cpu_dgrad(in_size);
+
+  test::normal_sync_cpu(h_bottom.data(), h_bottom.size(), 0.f, 1.f, generator);
+  for (int64_t b = 0; b < batch_size; b++) {
+    h_seq_len[b] = static_cast<float>(b % (max_seq_len + 1));
+  }
+
+  core23::copy_sync(bottom_tensor.data(), h_bottom.data(), bottom_tensor.num_bytes(),
+                    bottom_tensor.device(), core23::DeviceType::CPU);
+  core23::copy_sync(seq_len_tensor.data(), h_seq_len.data(), seq_len_tensor.num_bytes(),
+                    seq_len_tensor.device(), core23::DeviceType::CPU);
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+  reduce_sum_layer.fprop(true);
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+  core23::copy_sync(h_top.data(), top_tensor.data(), top_tensor.num_bytes(),
+                    core23::DeviceType::CPU, top_tensor.device());
+
+  for (int64_t b = 0; b < batch_size; b++) {
+    int64_t len = static_cast<int64_t>(static_cast<float>(h_seq_len[b]));
+    for (int64_t k = 0; k < embedding_vec_size; k++) {
+      float sum = 0.0f;
+      for (int64_t j = 0; j < len; j++) {
+        sum += static_cast<float>(h_bottom[(b * max_seq_len + j) * embedding_vec_size + k]);
+      }
+      h_cpu_top[b * embedding_vec_size + k] = sum;
+    }
+  }
+  ASSERT_TRUE(test::compare_array_approx<T>(h_top.data(), h_cpu_top.data(), out_size, Eps<T>()));
+
+  // bprop: the padded steps get no gradient
+  test::normal_sync_cpu(h_top.data(), h_top.size(), 0.f, 1.f, generator);
+  core23::copy_sync(top_tensor.data(), h_top.data(), top_tensor.num_bytes(), top_tensor.device(),
+                    core23::DeviceType::CPU);
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+  reduce_sum_layer.bprop();
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+  core23::copy_sync(h_gpu_dgrad.data(), bottom_tensor.data(), bottom_tensor.num_bytes(),
+                    core23::DeviceType::CPU, bottom_tensor.device());
+
+  for (int64_t b = 0; b < batch_size; b++) {
+    int64_t len = static_cast<int64_t>(static_cast<float>(h_seq_len[b]));
+    for (int64_t j = 0; j < max_seq_len; j++) {
+      for (int64_t k = 0; k < embedding_vec_size; k++) {
+        h_cpu_dgrad[(b * max_seq_len + j) * embedding_vec_size + k] =
+            j < len ? h_top[b * embedding_vec_size + k] : T(0.0f);
+      }
+    }
+  }
+  ASSERT_TRUE(test::compare_array_approx<T>(h_cpu_dgrad.data(), h_gpu_dgrad.data(), in_size,
+                                            Eps<T>()));
+}
+
 }  // namespace
 
 TEST(reduce_sum_layer, fp32_2x3x4_0) { reduce_sum_test<float>(2, 3, 4, 0); }
@@ -213,7 +296,12 @@ TEST(reduce_sum_layer, fp32_2x3x4_1) { reduce_sum_test<float>(2, 3, 4, 1); }
 TEST(reduce_sum_layer, fp32_2x3x4_2) { reduce_sum_test<float>(2, 3, 4, 2); }
 TEST(reduce_sum_layer, fp32_23x100x18_1) { reduce_sum_test<float>(23, 100, 18, 1); }
 TEST(reduce_sum_layer, fp32_40960x39x1_1) { reduce_sum_test<float>(40960, 39, 1, 1); }
+TEST(reduce_sum_layer, fp32_3x7x5_2) { reduce_sum_test<float>(3, 7, 5, 2); }
 TEST(reduce_sum_layer, fp16_2x3x4_0) { reduce_sum_test<__half>(2, 3, 4, 0); }
 TEST(reduce_sum_layer, fp16_2x3x4_1) { reduce_sum_test<__half>(2, 3, 4, 1); }
 TEST(reduce_sum_layer, fp16_2x3x4_2) { reduce_sum_test<__half>(2, 3, 4, 2); }
 TEST(reduce_sum_layer, fp16_40960x39x1_1) { reduce_sum_test<__half>(40960, 39, 1, 1); }
+TEST(reduce_sum_layer, fp16_64x26x16_1) { reduce_sum_test<__half>(64, 26, 16, 1); }
+TEST(reduce_sum_layer, fp32_seq_len_23x100x18) { reduce_sum_seq_len_test<float>(23, 100, 18); }
+TEST(reduce_sum_layer, fp32_seq_len_1024x50x300) { reduce_sum_seq_len_test<float>(1024, 50, 300); }
+TEST(reduce_sum_layer, fp16_seq_len_23x10x18) { reduce_sum_seq_len_test<__half>(23, 10, 18); }
@@ -77,7 +77,8 @@ void test_data_distributor(const std::vector<int>& device_list,
                            const std::vector<LookupParam>& lookup_params,
                            const std::vector<std::vector<int>>& shard_matrix,
                            const std::vector<GroupedTableParam>& grouped_emb_params,
-                           bool incomplete_batch = false) {
+                           bool incomplete_batch = false, bool fixed_hotness = false,
+                           bool hash_keys = false) {
   static_assert(
       std::disjunction<std::is_same<key_t, uint32_t>, std::is_same<key_t, long long>>::value);
 
@@ -116,8 +117,15 @@ void test_data_distributor(const std::vector<int>& device_list,
   for (int id = 0; id < num_table; ++id) {
     EmbeddingTableParam table_param{
         id, table_max_vocabulary_list[id], table_ev_size_list[id], {}, {}};
+    table_param.hash_keys = hash_keys;
     table_param_list.push_back(std::move(table_param));
   }
+  // The key that the embedding gets for an input key
+  auto table_key = [&](int lookup_id, key_t key) {
+    if (!hash_keys) return key;
+    int table_id = lookup_params[lookup_id].table_id;
+    return static_cast<key_t>(hash_key_to_row(key, table_max_vocabulary_list[table_id]));
+  };
 
   HugeCTR::DataDistributor distributor(core_list, ebc_param, table_param_list);
 
@@ -174,7 +182,8 @@ void test_data_distributor(const std::vector<int>& device_list,
       //      core23::copy_sync(d_bucket_range, h_bucket_range);
 
       dp_keys[gpu_id].push_back(d_keys);
-      dp_bucket_range[gpu_id].push_back(d_bucket_range);
+      // Without bucket ranges every sample has max_hotness keys
+      if (!fixed_hotness) dp_bucket_range[gpu_id].push_back(d_bucket_range);
     }
   }
 
@@ -229,7 +238,7 @@ void test_data_distributor(const std::vector<int>& device_list,
               if (ebc_param.has_table_shard(gpu_id, group_id, lookup_id)) {
                 for (int i = 0;
                      i < ebc_param.lookup_params[lookup_id].max_hotness * num_valid_samples; ++i) {
-                  expected_keys.push_back(i);
+                  expected_keys.push_back(table_key(lookup_id, i));
                 }
                 num_shards++;
               }
@@ -290,7 +299,8 @@ void test_data_distributor(const std::vector<int>& device_list,
                 std::vector<key_t> expected_keys;
                 for (int i = 0; i < current_batch_size * lookup_params[lookup_id].max_hotness;
                      ++i) {
-                  key_t key = i % (batch_size_per_dev * lookup_params[lookup_id].max_hotness);
+                  key_t key = table_key(
+                      lookup_id, i % (batch_size_per_dev * lookup_params[lookup_id].max_hotness));
                   if (key % num_shards == this_gpu_shard_id) {
                     expected_keys.push_back(key);
                   }
@@ -323,6 +333,29 @@ void test_data_distributor(const std::vector<int>& device_list,
           }
 
         } break;
+        case (embedding::EmbeddingType::Dense): {
+          if (!fixed_hotness) break;
+          // --- check the destination buckets of the keys of this gpu, lookup by lookup
+          auto& mp_input = group_result.dense_compression_input.model_parallel_compression_input;
+          std::vector<offset_t> expected_bucket_ids;
+          int hotness_offset = 0;
+          for (int lookup_id : ebc_param.grouped_lookup_params[group_id].lookup_ids) {
+            int max_hotness = lookup_params[lookup_id].max_hotness;
+            for (int sample_id = 0; sample_id < num_valid_samples; ++sample_id) {
+              for (int hotness_id = 0; hotness_id < max_hotness; ++hotness_id) {
+                expected_bucket_ids.push_back(sample_id +
+                                              (hotness_offset + hotness_id) * batch_size_per_dev);
+              }
+            }
+            hotness_offset += max_hotness;
+          }
+          ASSERT_EQ(mp_input.num_network_reverse_idx, expected_bucket_ids.size());
+
+          std::vector<offset_t> result_bucket_ids(mp_input.network_dst_bucket_ids.num_elements());
+          core23::copy_sync(result_bucket_ids, mp_input.network_dst_bucket_ids);
+          result_bucket_ids.resize(expected_bucket_ids.size());
+          ASSERT_EQ(result_bucket_ids, expected_bucket_ids);
+        } break;
         default:
           break;
       }
@@ -378,6 +411,16 @@ TEST(data_distributor, dense_mp_plan0) {
   test_data_distributor<uint32_t, uint32_t>(device_list, dense_lookup_params, shard_matrix,
                                             grouped_emb_params);
 }
+
+TEST(data_distributor, dense_mp_plan0_fixed_hotness) {
+  test_data_distributor<uint32_t, uint32_t>(device_list, dense_lookup_params, shard_matrix,
+                                            grouped_emb_params, false, true);
+}
+
+TEST(data_distributor, dense_mp_plan0_fixed_hotness_incomplete_batch) {
+  test_data_distributor<uint32_t, uint32_t>(device_list, dense_lookup_params, shard_matrix,
+                                            grouped_emb_params, true, true);
+}
 }  // namespace dense_mp
 
 namespace dense_dp {
@@ -422,4 +465,9 @@ TEST(data_distributor, dp_and_mp_plan0_uint32_incomplete_batch) {
                                             grouped_emb_params, true);
 }
 
+TEST(data_distributor, dp_and_mp_plan0_uint32_hash_keys) {
+  test_data_distributor<uint32_t, uint32_t>(device_list, lookup_params0, shard_matrix,
+                                            grouped_emb_params, false, false, true);
+}
+
 }  // namespace dp_and_mp
\ No newline at end of file
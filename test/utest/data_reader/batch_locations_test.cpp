@@ -16,7 +16,10 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <data_readers/multi_hot/compressed_format.hpp>
 #include <data_readers/multi_hot/detail/batch_locations.hpp>
+#include <data_readers/multi_hot/detail/file_batch_locations.hpp>
 
 using namespace HugeCTR;
 
@@ -190,4 +193,188 @@ TEST(static_batch_locations, multiple_threads_sharded) {
       }
     }
   }
-}
\ No newline at end of file
+}
+TEST(static_batch_locations, block_shuffle) {
+  size_t sample_size_bytes = 12;
+  size_t batch_size_bytes = 40 * sample_size_bytes;
+  size_t block_size_bytes = 8 * sample_size_bytes;
+  size_t start_offset = 0;
+  size_t end_offset = 1003 * sample_size_bytes;  // partial last batch and block
+  size_t num_shards = 2;
+  size_t alignment = 20 * sample_size_bytes;
+
+  BatchLocations locations(batch_size_bytes, start_offset, end_offset, true, 1234,
+                           block_size_bytes);
+  size_t num_batches = locations.count();
+  ASSERT_EQ(num_batches, 26);
+
+  auto sharded_locations = locations.shard(num_shards, alignment);
+  ASSERT_EQ(sharded_locations.size(), num_shards);
+  ASSERT_EQ(sharded_locations[0]->get_max_segments(), 4);
+
+  std::vector<std::vector<FileSegment>> epoch_segments;
+  for (size_t epoch = 0; epoch < 3; ++epoch) {
+    std::vector<FileSegment> segments;
+    std::vector<BatchForwardIterator> iterators;
+    for (auto& shard_locations : sharded_locations) {
+      shard_locations->set_epoch(epoch);
+      iterators.push_back(shard_locations->begin());
+    }
+    for (size_t batch = 0; batch < num_batches; ++batch) {
+      for (auto& it : iterators) {
+        auto location = *it;
+        it++;
+        ASSERT_EQ(location.i, batch);
+        size_t size = 0;
+        for (auto& segment : location.segments) {
+          ASSERT_EQ(segment.offset % sample_size_bytes, 0);
+          ASSERT_LE(segment.offset + segment.size, end_offset);
+          size += segment.size;
+          segments.push_back(segment);
+        }
+        ASSERT_EQ(size, location.shard_size_bytes);
+        ASSERT_LE(location.segments.size(), sharded_locations[0]->get_max_segments());
+      }
+    }
+
+    // Every sample of the file is read exactly once per epoch
+    std::vector<int> num_reads(end_offset / sample_size_bytes, 0);
+    for (auto& segment : segments) {
+      for (size_t offset = segment.offset; offset < segment.offset + segment.size;
+           offset += sample_size_bytes) {
+        num_reads[offset / sample_size_bytes]++;
+      }
+    }
+    ASSERT_EQ(std::count(num_reads.begin(), num_reads.end(), 1), num_reads.size());
+    epoch_segments.push_back(segments);
+  }
+
+  auto same_order = [](const std::vector<FileSegment>& a, const std::vector<FileSegment>& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](auto& x, auto& y) {
+      return x.offset == y.offset && x.size == y.size;
+    });
+  };
+  ASSERT_FALSE(same_order(epoch_segments[0], epoch_segments[1]));
+  ASSERT_FALSE(same_order(epoch_segments[1], epoch_segments[2]));
+
+  // The order only depends on the seed and the epoch
+  BatchLocations other(batch_size_bytes, start_offset, end_offset, true, 1234, block_size_bytes);
+  auto other_shard = other.shard(num_shards, alignment);
+  other_shard[0]->set_epoch(1);
+  auto location = *other_shard[0]->begin();
+  auto it = sharded_locations[0]->begin();
+  sharded_locations[0]->set_epoch(1);
+  ASSERT_TRUE(same_order(location.segments, (*it).segments));
+}
+
+TEST(variable_batch_locations, sharded) {
+  const std::string file_name = "variable_batch_locations.bin";
+  size_t num_samples = 103;  // partial last batch and record
+  size_t samples_per_record = 4;
+  size_t batch_size = 16;
+  size_t num_shards = 2;
+  {
+    VarLenFileWriter writer(file_name, samples_per_record, 1, 2, 2, sizeof(long long));
+    for (size_t i = 0; i < num_samples; ++i) {
+      int32_t label_dense[3] = {0, 1, 2};
+      writer.append(label_dense, {std::vector<int64_t>(i % 5, 1), std::vector<int64_t>(1, 2)});
+    }
+  }
+
+  auto footer = read_var_len_footer(file_name);
+  ASSERT_EQ(footer.num_samples, num_samples);
+  ASSERT_EQ(footer.num_records, 26);
+  auto index = read_var_len_index(file_name, footer);
+  std::remove(file_name.c_str());
+
+  VariableBatchLocations locations(footer, index, batch_size);
+  size_t num_batches = locations.count();
+  ASSERT_EQ(num_batches, 7);
+  ASSERT_THROW(locations.shard(8, 0), std::invalid_argument);
+
+  auto sharded_locations = locations.shard(num_shards, 0);
+  ASSERT_EQ(sharded_locations.size(), num_shards);
+  std::vector<BatchForwardIterator> iterators;
+  for (auto& shard_locations : sharded_locations) {
+    iterators.push_back(shard_locations->begin());
+  }
+
+  size_t expected_offset = 0;
+  size_t total_samples = 0;
+  for (size_t batch = 0; batch < num_batches; ++batch) {
+    size_t batch_samples = 0;
+    for (size_t shard = 0; shard < num_shards; ++shard) {
+      auto location = *iterators[shard];
+      iterators[shard]++;
+      ASSERT_EQ(location.i, batch);
+      ASSERT_LE(location.shard_size_bytes, sharded_locations[shard]->get_batch_size_bytes());
+      ASSERT_LE(location.shard_num_samples, batch_size / num_shards);
+      if (location.shard_num_samples > 0) {
+        ASSERT_EQ(location.offset, expected_offset);
+      }
+      expected_offset += location.shard_size_bytes;
+      batch_samples += location.shard_num_samples;
+    }
+    ASSERT_EQ(batch_samples, std::min(batch_size, num_samples - total_samples));
+    total_samples += batch_samples;
+  }
+  ASSERT_EQ(total_samples, num_samples);
+  ASSERT_EQ(expected_offset, index.back());
+}
+
+TEST(variable_batch_locations, batch_size_not_multiple_of_record) {
+  VarLenFileFooter footer{VAR_LEN_MAGIC, 12, 3, 4, 1, 0, 1, 4, 0};
+  ASSERT_THROW(VariableBatchLocations(footer, {0, 64, 128, 192}, 6), std::invalid_argument);
+}
+
+TEST(variable_batch_locations, compressed_chunks) {
+  const std::string file_name = "compressed_batch_locations.bin";
+  size_t num_samples = 70;
+  size_t samples_per_chunk = 8;
+  size_t sample_size_bytes = 12;
+  std::vector<uint64_t> index(1, 0);
+  {
+    // The payloads are not valid LZ4, only the layout is read on the host
+    std::ofstream file(file_name, std::ofstream::binary);
+    for (size_t sample = 0; sample < num_samples; sample += samples_per_chunk) {
+      size_t n = std::min(samples_per_chunk, num_samples - sample);
+      CompressedChunkHeader header{n + 3, n * sample_size_bytes};
+      std::vector<char> payload((sizeof(header) + header.compressed_bytes + 7) / 8 * 8 -
+                                sizeof(header));
+      file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      file.write(payload.data(), payload.size());
+      index.push_back(index.back() + sizeof(header) + payload.size());
+    }
+    CompressedFileFooter footer{COMPRESSED_MAGIC, num_samples, index.size() - 1,
+                                static_cast<uint32_t>(samples_per_chunk),
+                                static_cast<uint32_t>(sample_size_bytes)};
+    file.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(uint64_t));
+    file.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+  }
+
+  auto footer = read_compressed_footer(file_name);
+  ASSERT_EQ(footer.num_chunks, 9);
+  ASSERT_EQ(read_compressed_index(file_name, footer), index);
+  std::remove(file_name.c_str());
+  ASSERT_THROW(read_compressed_footer(file_name), std::runtime_error);
+
+  VariableBatchLocations locations(footer.num_samples, footer.samples_per_chunk, index, 32);
+  ASSERT_EQ(locations.count(), 3);
+  auto sharded_locations = locations.shard(2, 0);
+  std::vector<BatchForwardIterator> iterators;
+  for (auto& shard_locations : sharded_locations) {
+    auto it = shard_locations->begin();
+    it++;
+    it++;
+    iterators.push_back(it);
+  }
+  // The last batch is the last chunk of 6 samples, the second shard is empty
+  auto location = *iterators[0];
+  ASSERT_EQ(location.shard_num_samples, 6);
+  ASSERT_EQ(location.batch_num_samples, 6);
+  ASSERT_EQ(location.offset, index[8]);
+  ASSERT_EQ(location.shard_size_bytes, index[9] - index[8]);
+  location = *iterators[1];
+  ASSERT_EQ(location.shard_num_samples, 0);
+  ASSERT_EQ(location.shard_size_bytes, 0);
+}
@@ -19,6 +19,7 @@
 
 #include <common.hpp>
 #include <cstdio>
+#include <cstring>
 #include <data_readers/async_reader/async_reader.hpp>
 #include <fstream>
 #include <functional>
@@ -32,7 +33,8 @@
 using namespace HugeCTR;
 
 void reader_test(std::vector<int> device_list, size_t file_size, size_t batch_size, int num_threads,
-                 int batches_per_thread, int io_block_size, int io_depth, int wait_time_us) {
+                 int batches_per_thread, int io_block_size, int io_depth, int wait_time_us,
+                 bool striped_upload = false) {
   const std::string fname = "__tmp_test.dat";
   char* ref_data;
   char* read_data;
@@ -64,7 +66,8 @@ void reader_test(std::vector<int> device_list, size_t file_size, size_t batch_si
   }
 
   AsyncReaderImpl reader_impl(fname, batch_size, resource_manager.get(), num_threads,
-                              batches_per_thread, io_block_size, io_depth, 4096);
+                              batches_per_thread, io_block_size, io_depth, 4096, false, false,
+                              striped_upload);
 
   reader_impl.load_async();
 
@@ -76,6 +79,14 @@ void reader_test(std::vector<int> device_list, size_t file_size, size_t batch_si
     if (sz > 0) {
       HCTR_LIB_THROW(
           cudaMemcpy(read_data + total_sz, desc.dev_data[0], sz, cudaMemcpyDeviceToDevice));
+      // Every GPU gets the whole batch
+      std::vector<char> peer_data(sz);
+      for (size_t dev = 1; dev < desc.dev_data.size(); dev++) {
+        HCTR_LIB_THROW(
+            cudaMemcpy(peer_data.data(), desc.dev_data[dev], sz, cudaMemcpyDeviceToHost));
+        ASSERT_EQ(memcmp(peer_data.data(), read_data + total_sz, sz), 0)
+            << "GPU " << dev << " differs in the batch at " << total_sz;
+      }
       total_sz += sz;
       usleep(wait_time_us);
       reader_impl.finalize_batch();
@@ -125,3 +136,13 @@ TEST(reader_test, test17) {
 TEST(reader_test, test18) {
   reader_test({0, 1, 2, 3, 4, 5, 6, 7}, 18012516, 38720, 8, 4, 4096 * 2, 2, 2000);
 }
+TEST(reader_test, striped_upload1) { reader_test({0, 1}, 100, 20, 2, 1, 4096 * 2, 1, 0, true); }
+TEST(reader_test, striped_upload2) {
+  reader_test({0, 1}, 101256, 1000, 2, 4, 4096 * 2, 2, 100, true);
+}
+TEST(reader_test, striped_upload3) {
+  reader_test({0, 1, 2, 3}, 100980, 1980, 4, 4, 4096 * 2, 2, 1000, true);
+}
+TEST(reader_test, striped_upload4) {
+  reader_test({0, 1, 2, 3, 4, 5, 6, 7}, 8012516, 38720, 8, 4, 4096 * 2, 2, 0, true);
+}
@@ -50,7 +50,8 @@ struct DensePreprocess {
   float operator()(float value) { return float_label_dense ? value : log(value + 1.f); }
 };
 
-void data_reader_worker_raw_test_impl(bool float_label_dense, bool repeat) {
+void data_reader_worker_raw_test_impl(bool float_label_dense, bool repeat,
+                                      bool parse_on_device = false) {
   std::vector<T> generated_sparse_data;
   std::vector<float> generated_dense_data;
   std::vector<float> generated_label_data;
@@ -102,7 +103,7 @@ void data_reader_worker_raw_test_impl(bool float_label_dense, bool repeat) {
 
   std::shared_ptr<std::atomic<bool>> loop_flag = std::make_shared<std::atomic<bool>>(1);
   DataReaderWorkerRaw<T> data_reader(0, 1, local_gpu, loop_flag, thread_buffer, file_offset_list,
-                                     repeat, params, float_label_dense);
+                                     repeat, params, float_label_dense, parse_on_device);
 
   int round = (num_samples - 1) / batchsize + 1;
 
@@ -165,7 +166,8 @@ void data_reader_worker_raw_test_impl(bool float_label_dense, bool repeat) {
 }
 
 void data_reader_raw_test_impl(const std::vector<int> &device_list, int num_threads,
-                               bool float_label_dense, bool repeat, bool use_mixed_precision) {
+                               bool float_label_dense, bool repeat, bool use_mixed_precision,
+                               bool parse_on_device = false) {
   // data generation
   std::vector<T> generated_sparse_data;
   std::vector<float> generated_dense_data;
@@ -193,7 +195,8 @@ void data_reader_raw_test_impl(const std::vector<int> &device_list, int num_thre
   DataReader<T> data_reader(batchsize, label_dim, dense_dim, params, resource_manager, repeat,
                             num_threads, use_mixed_precision);
 
-  data_reader.create_drwg_raw(file_name, num_samples, float_label_dense, false, true);
+  data_reader.create_drwg_raw(file_name, num_samples, float_label_dense, false, true,
+                              parse_on_device);
   int round = (num_samples - 1) / batchsize + 1;
 
   size_t batch_size_start_idx = resource_manager->get_gpu_global_id_from_local_id(0);
@@ -337,3 +340,19 @@ TEST(data_reader_raw_half, int_test_1) { data_reader_raw_test_impl({0}, 1, false
 TEST(data_reader_raw_half, int_test_2) { data_reader_raw_test_impl({0}, 2, false, true, true); }
 TEST(data_reader_raw_half, int_test_3) { data_reader_raw_test_impl({0, 1}, 2, false, true, true); }
 TEST(data_reader_raw_half, int_test_4) { data_reader_raw_test_impl({0, 1}, 4, false, true, true); }
+
+TEST(data_reader_raw_device_parse, data_reader_worker_raw_float_test) {
+  data_reader_worker_raw_test_impl(true, true, true);
+}
+TEST(data_reader_raw_device_parse, data_reader_worker_raw_int_test) {
+  data_reader_worker_raw_test_impl(false, true, true);
+}
+TEST(data_reader_raw_device_parse, float_test_1) {
+  data_reader_raw_test_impl({0}, 1, true, true, false, true);
+}
+TEST(data_reader_raw_device_parse, float_test_4) {
+  data_reader_raw_test_impl({0, 1}, 4, true, true, false, true);
+}
+TEST(data_reader_raw_device_parse, half_test_4) {
+  data_reader_raw_test_impl({0, 1}, 4, true, true, true, true);
+}
@@ -17,15 +17,21 @@
 #include <gtest/gtest.h>
 #include <omp.h>
 
+#include <algorithm>
+#include <cmath>
 #include <common.hpp>
 #include <cstdio>
 #include <data_readers/multi_hot/async_data_reader.hpp>
+#include <data_readers/multi_hot/key_frequency_sketch.hpp>
 #include <embeddings/hybrid_embedding/utils.hpp>
 #include <filesystem>
 #include <fstream>
 #include <functional>
 #include <general_buffer2.hpp>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <random>
 #include <resource_managers/resource_manager_ext.hpp>
 #include <sstream>
 #include <type_traits>
@@ -44,7 +50,8 @@ void async_data_reader_test(std::vector<int> device_list, size_t batch_size,
                             int num_threads_per_device, int batches_per_thread, int label_dim,
                             int dense_dim, int sparse_dim, int num_passes, int seed,
                             bool incomplete_batch = false, bool schedule_uploads = false,
-                            bool shuffle = false) {
+                            bool shuffle = false, IOBackend_t io_backend = IOBackend_t::AIO,
+                            DataCache_t data_cache = DataCache_t::Off) {
   srand(seed);
   HCTR_LIB_THROW(nvmlInit_v2());
 
@@ -127,7 +134,8 @@ void async_data_reader_test(std::vector<int> device_list, size_t batch_size,
 
   DataReaderType data_reader({source}, resource_manager, batch_size, num_threads_per_device,
                              batches_per_thread, params, label_dim, dense_dim, mixed_precision,
-                             shuffle, schedule_uploads, is_dense_float);
+                             shuffle, schedule_uploads, is_dense_float, io_backend, 0, false,
+                             data_cache);
 
   auto label_tensors = data_reader.get_label_tensor23s();
   auto dense_tensors = data_reader.get_dense_tensor23s();
@@ -233,7 +241,172 @@ TEST(async_data_reader_test, gpu_1x_multi_threaded) {
 TEST(async_data_reader_test, gpu_1x_multiple_batches_per_thread) {
   async_data_reader_test<uint32_t>({0}, 100, 4, 4, 2, 3, 5, 1, global_seed += 128);
 }
+#ifdef ENABLE_IO_URING
+TEST(async_data_reader_test, gpu_1x_io_uring) {
+  async_data_reader_test<uint32_t>({0}, 100, 4, 4, 2, 3, 5, 1, global_seed += 128, false, false,
+                                   false, IOBackend_t::IOUring);
+}
+#endif
+#ifdef ENABLE_GDS
+TEST(async_data_reader_test, gpu_1x_gds) {
+  async_data_reader_test<uint32_t>({0}, 100, 4, 4, 2, 3, 5, 1, global_seed += 128, false, false,
+                                   false, IOBackend_t::GDS);
+}
+#endif
+TEST(async_data_reader_test, gpu_1x_device_cache) {
+  async_data_reader_test<uint32_t>({0}, 100, 4, 4, 2, 3, 5, 3, global_seed += 128, false, false,
+                                   false, IOBackend_t::AIO, DataCache_t::Device);
+}
+TEST(async_data_reader_test, gpu_1x_host_cache) {
+  async_data_reader_test<uint32_t>({0}, 100, 4, 4, 2, 3, 5, 3, global_seed += 128, false, false,
+                                   false, IOBackend_t::AIO, DataCache_t::Host);
+}
 TEST(async_data_reader_test, gpu_8x_incomplete_batch) {
   async_data_reader_test<uint32_t>({0, 1, 2, 3, 4, 5, 6, 7}, 128, 1, 1, 2, 3, 5, 1,
                                    global_seed += 128, true);
-}
\ No newline at end of file
+}
+template <typename dtype>
+void synthetic_data_reader_test(std::vector<int> device_list, size_t batch_size,
+                                Distribution_t distribution, float unique_key_ratio) {
+  const int label_dim = 1, dense_dim = 13, sparse_dim = 4;
+  const std::vector<int> multi_hot_sizes{1, 3, 1, 2};
+  const std::vector<long long> slot_size_array{10, 1000, 100000, 1ll << 31};
+  const size_t num_steps = 8;
+
+  std::vector<std::vector<int>> vvgpu;
+  vvgpu.push_back(device_list);
+  const auto resource_manager = ResourceManagerExt::create(vvgpu, 424242);
+  const size_t local_gpu_count = resource_manager->get_local_gpu_count();
+
+  std::vector<DataReaderSparseParam> params{
+      DataReaderSparseParam("dummy", multi_hot_sizes, true, sparse_dim)};
+  FileSource source;  // never opened
+  source.name = "__synthetic.dat";
+  source.slot_id = 0;
+  const SyntheticDataParam synthetic(distribution, PowerLaw_t::Short, 0.f, unique_key_ratio,
+                                     slot_size_array, 1234);
+
+  AsyncDataReader<dtype> data_reader({source}, resource_manager, batch_size, 1, 1, params,
+                                     label_dim, dense_dim, false, false, false, true,
+                                     IOBackend_t::AIO, 0, false, DataCache_t::Off, false, {},
+                                     synthetic);
+  auto label_tensors = data_reader.get_label_tensor23s();
+  data_reader.start();
+
+  std::vector<std::map<dtype, size_t>> key_counts(sparse_dim);
+  for (size_t step = 0; step < num_steps; step++) {
+    ASSERT_EQ(data_reader.read_a_batch_to_device(), batch_size);
+    auto sparse_tensors = data_reader.get_current_sparse_values();
+    for (size_t id = 0; id < local_gpu_count; id++) {
+      CudaDeviceContext context(resource_manager->get_local_gpu(id)->get_device_id());
+      std::vector<float> labels;
+      core23::copy_sync(labels, label_tensors[id]);
+      for (float label : labels) {
+        ASSERT_TRUE(label == 0.f || label == 1.f);
+      }
+      for (int slot = 0; slot < sparse_dim; ++slot) {
+        std::vector<dtype> keys;
+        core23::copy_sync(keys, sparse_tensors[id][slot]);
+        for (dtype key : keys) {
+          ASSERT_LT(static_cast<long long>(key), slot_size_array[slot]);
+          key_counts[slot][key]++;
+        }
+      }
+    }
+  }
+
+  // Every step draws from the same pool of keys
+  for (int slot = 0; slot < sparse_dim; ++slot) {
+    const auto pool_size = std::min<long long>(
+        std::ceil(unique_key_ratio * batch_size * multi_hot_sizes[slot]), slot_size_array[slot]);
+    EXPECT_LE(key_counts[slot].size(), pool_size);
+    if (distribution == Distribution_t::PowerLaw && pool_size > 1) {
+      // Rank 0 is key 0 and the most frequent one
+      const auto hottest =
+          std::max_element(key_counts[slot].begin(), key_counts[slot].end(),
+                           [](const auto& a, const auto& b) { return a.second < b.second; });
+      EXPECT_EQ(hottest->first, dtype{0});
+    }
+  }
+}
+
+TEST(async_data_reader_test, gpu_1x_synthetic_uniform) {
+  synthetic_data_reader_test<uint32_t>({0}, 1024, Distribution_t::Uniform, 0.5f);
+}
+TEST(async_data_reader_test, gpu_1x_synthetic_power_law_long_long) {
+  synthetic_data_reader_test<long long>({0}, 1024, Distribution_t::PowerLaw, 0.1f);
+}
+TEST(async_data_reader_test, gpu_2x_synthetic_power_law) {
+  synthetic_data_reader_test<uint32_t>({0, 1}, 1024, Distribution_t::PowerLaw, 0.1f);
+}
+
+template <typename dtype>
+void key_frequency_sketch_test(size_t num_distinct) {
+  // Slot 0: key k occurs num_distinct / (k + 1) times, slot 1: every key once
+  std::vector<std::vector<dtype>> h_keys(2);
+  for (size_t k = 0; k < num_distinct; k++) {
+    h_keys[0].insert(h_keys[0].end(), std::max<size_t>(num_distinct / (k + 1), 1), dtype(k));
+    h_keys[1].push_back(dtype(k * 7919));
+  }
+  std::mt19937 gen(global_seed);
+  std::shuffle(h_keys[0].begin(), h_keys[0].end(), gen);
+  const std::vector<int> hotness{static_cast<int>(h_keys[0].size() / num_distinct) + 1, 1};
+  h_keys[0].resize(num_distinct * hotness[0], std::numeric_limits<dtype>::max());
+
+  HCTR_LIB_THROW(cudaSetDevice(0));
+  std::vector<dtype*> d_keys(2);
+  for (size_t slot = 0; slot < 2; slot++) {
+    HCTR_LIB_THROW(cudaMalloc(&d_keys[slot], h_keys[slot].size() * sizeof(dtype)));
+    HCTR_LIB_THROW(cudaMemcpy(d_keys[slot], h_keys[slot].data(),
+                              h_keys[slot].size() * sizeof(dtype), cudaMemcpyHostToDevice));
+  }
+  dtype** d_slot_keys;
+  int* d_hotness;
+  HCTR_LIB_THROW(cudaMalloc(&d_slot_keys, 2 * sizeof(dtype*)));
+  HCTR_LIB_THROW(cudaMalloc(&d_hotness, 2 * sizeof(int)));
+  HCTR_LIB_THROW(
+      cudaMemcpy(d_slot_keys, d_keys.data(), 2 * sizeof(dtype*), cudaMemcpyHostToDevice));
+  HCTR_LIB_THROW(cudaMemcpy(d_hotness, hotness.data(), 2 * sizeof(int), cudaMemcpyHostToDevice));
+
+  // Two GPUs' worth of sketches, each seeing every key once, merged like the reader does
+  KeyFrequencySketch<dtype> sketch_a(2, 0), sketch_b(2, 0);
+  sketch_a.add(d_slot_keys, d_hotness, hotness[0], num_distinct, 0);
+  sketch_b.add(d_slot_keys, d_hotness, hotness[0], num_distinct, 0);
+  auto merged = sketch_a.to_host();
+  merged.merge(sketch_b.to_host());
+  const auto profiles = merged.profile(10);
+
+  std::map<dtype, uint64_t> counts;
+  for (dtype key : h_keys[0]) {
+    counts[key] += 2;
+  }
+  EXPECT_EQ(profiles[0].num_keys, 2 * h_keys[0].size());
+  EXPECT_EQ(profiles[1].num_keys, 2 * num_distinct);
+  // The padding key is one more distinct key of slot 0
+  EXPECT_NEAR(profiles[0].cardinality, num_distinct + 1, 0.05 * num_distinct);
+  EXPECT_NEAR(profiles[1].cardinality, num_distinct, 0.05 * num_distinct);
+
+  ASSERT_EQ(profiles[0].top_keys.size(), 10u);
+  for (size_t rank = 0; rank < 10; rank++) {
+    EXPECT_EQ(profiles[0].top_keys[rank].first, static_cast<long long>(rank));
+    EXPECT_GE(profiles[0].top_keys[rank].second, counts[dtype(rank)]);
+  }
+  EXPECT_NEAR(profiles[0].power_law_alpha, 1.0, 0.1);
+
+  const std::string fname = "__tmp_key_profile.json";
+  write_key_profile(fname, profiles);
+  std::ifstream file(fname);
+  EXPECT_TRUE(file.good());
+  std::remove(fname.c_str());
+
+  for (auto ptr : d_keys) {
+    cudaFree(ptr);
+  }
+  cudaFree(d_slot_keys);
+  cudaFree(d_hotness);
+}
+
+TEST(async_data_reader_test, key_frequency_sketch) { key_frequency_sketch_test<uint32_t>(100000); }
+TEST(async_data_reader_test, key_frequency_sketch_long_long) {
+  key_frequency_sketch_test<long long>(100000);
+}
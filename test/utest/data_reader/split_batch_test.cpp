@@ -204,3 +204,93 @@ typedef ::testing::Types<std::tuple<float, unsigned int>, std::tuple<__half, uns
 
 REGISTER_TYPED_TEST_CASE_P(SplitBatchFixture, split_feat_major_one_hot, split_feat_major_multi_hot);
 INSTANTIATE_TYPED_TEST_CASE_P(SplitBatchTests, SplitBatchFixture, SplitTypes);
+
+class SplitTransformsTest : public SplitBatchFixture<std::tuple<float, unsigned int>> {};
+
+TEST_F(SplitTransformsTest, split_feat_major_transforms) {
+  std::vector<int> nnz_per_slot(sparse_dim, 1);
+  this->init_sparse_data(nnz_per_slot);
+
+  // dense feature 0 is log(1 + 3) ~= 1.39, bucket 1 of {1, 1.5}, slot 0 is 16 mod 5
+  std::vector<int> dense_ops(dense_dim, -1);
+  dense_ops[0] = static_cast<int>(DataTransform_t::Bucketize);
+  std::vector<int> boundary_offsets(dense_dim + 1, 2);
+  boundary_offsets[0] = 0;
+  std::vector<float> boundaries{1.f, 1.5f};
+  std::vector<long long> key_modulo(sparse_dim, 0);
+  key_modulo[0] = 5;
+
+  auto make_tensor = [](const auto& h_vec, core23::ScalarType type) {
+    core23::Tensor tensor(
+        core23::TensorParams().shape({static_cast<int64_t>(h_vec.size())}).data_type(type));
+    HCTR_LIB_THROW(
+        cudaMemcpy(tensor.data(), h_vec.data(), tensor.num_bytes(), cudaMemcpyHostToDevice));
+    return tensor;
+  };
+  auto dense_ops_tensor = make_tensor(dense_ops, core23::ScalarType::Int32);
+  auto boundary_offsets_tensor = make_tensor(boundary_offsets, core23::ScalarType::Int32);
+  auto boundaries_tensor = make_tensor(boundaries, core23::ScalarType::Float);
+  auto key_modulo_tensor = make_tensor(key_modulo, core23::ScalarType::LongLong);
+  SplitTransforms transforms;
+  transforms.dense_ops = dense_ops_tensor.data<int>();
+  transforms.boundary_offsets = boundary_offsets_tensor.data<int>();
+  transforms.boundaries = boundaries_tensor.data<float>();
+  transforms.key_modulo = key_modulo_tensor.data<long long>();
+
+  split_3_way_feat_major<float, unsigned int>(
+      this->label_tensor, this->dense_tensor, this->sparse_tensor_ptrs, this->label_dense_sparse,
+      this->bucket_id_tensor, this->bucket_position_tensor, this->max_hotness_tensor, NULL, false,
+      transforms);
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+
+  this->check_label();
+
+  std::vector<float> dense(batch_size * dense_dim);
+  HCTR_LIB_THROW(cudaMemcpy(dense.data(), this->dense_tensor.data(), dense.size() * sizeof(float),
+                            cudaMemcpyDeviceToHost));
+  std::vector<unsigned int> slot0(batch_size), slot1(batch_size);
+  HCTR_LIB_THROW(cudaMemcpy(slot0.data(), this->sparse_tensors[0].data(),
+                            slot0.size() * sizeof(unsigned int), cudaMemcpyDeviceToHost));
+  HCTR_LIB_THROW(cudaMemcpy(slot1.data(), this->sparse_tensors[1].data(),
+                            slot1.size() * sizeof(unsigned int), cudaMemcpyDeviceToHost));
+  for (int64_t i = 0; i < batch_size; ++i) {
+    EXPECT_EQ(dense[i * dense_dim], 1.f);
+    EXPECT_FLOAT_EQ(dense[i * dense_dim + 1], logf(label_dim + 2 + 1.f));
+    EXPECT_EQ(slot0[i], (label_dim + dense_dim + 1) % 5);
+    EXPECT_EQ(slot1[i], label_dim + dense_dim + 2);
+  }
+}
+
+class SplitNarrowKeysTest : public SplitBatchFixture<std::tuple<float, unsigned int>> {};
+
+TEST_F(SplitNarrowKeysTest, split_feat_major_int64_file_keys) {
+  std::vector<int> nnz_per_slot(sparse_dim, 1);
+  this->init_sparse_data(nnz_per_slot);
+
+  // The samples store 64-bit keys, two columns per key with the low half first
+  const int64_t sample_size_int = label_dim + dense_dim + 2 * sparse_dim;
+  this->label_dense_sparse = core23::Tensor(core23::TensorParams()
+                                                .shape({batch_size, sample_size_int})
+                                                .data_type(core23::ScalarType::Int32));
+  std::vector<int> batch(batch_size * sample_size_int);
+  for (size_t i = 0; i < batch.size(); ++i) batch[i] = (i % sample_size_int) + 1;
+  HCTR_LIB_THROW(cudaMemcpy(this->label_dense_sparse.data(), batch.data(),
+                            batch.size() * sizeof(int), cudaMemcpyHostToDevice));
+
+  split_3_way_feat_major<float, unsigned int>(
+      this->label_tensor, this->dense_tensor, this->sparse_tensor_ptrs, this->label_dense_sparse,
+      this->bucket_id_tensor, this->bucket_position_tensor, this->max_hotness_tensor, NULL, false,
+      SplitTransforms(), true);
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+
+  this->check_label();
+  this->check_dense();
+  for (int64_t slot = 0; slot < sparse_dim; ++slot) {
+    std::vector<unsigned int> keys(batch_size);
+    HCTR_LIB_THROW(cudaMemcpy(keys.data(), this->sparse_tensors[slot].data(),
+                              keys.size() * sizeof(unsigned int), cudaMemcpyDeviceToHost));
+    for (int64_t i = 0; i < batch_size; ++i) {
+      EXPECT_EQ(keys[i], label_dim + dense_dim + 2 * slot + 1);
+    }
+  }
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <embeddings/delta_tracker.hpp>
+#include <map>
+#include <random>
+#include <utils.hpp>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+template <typename TypeHashKey>
+void delta_tracker_test(size_t num_rows, size_t embedding_vec_size, size_t nnz,
+                        size_t staging_rows) {
+  CudaDeviceContext context(0);
+  cudaStream_t stream;
+  HCTR_LIB_THROW(cudaStreamCreate(&stream));
+
+  std::vector<float> h_table(num_rows * embedding_vec_size);
+  for (size_t i = 0; i < h_table.size(); i++) {
+    h_table[i] = static_cast<float>(i);
+  }
+  // Batches hit the same rows several times, row r holds key 1000 + r
+  std::mt19937 gen(424242);
+  std::uniform_int_distribution<size_t> dis_row(0, num_rows - 1);
+  std::vector<size_t> h_value_index(nnz);
+  std::vector<TypeHashKey> h_keys(nnz);
+  std::map<long long, size_t> expected;  // key -> row
+  for (size_t i = 0; i < nnz; i++) {
+    h_value_index[i] = dis_row(gen) / 2;
+    h_keys[i] = static_cast<TypeHashKey>(1000 + h_value_index[i]);
+    expected[1000 + h_value_index[i]] = h_value_index[i];
+  }
+
+  float* d_table;
+  size_t* d_value_index;
+  TypeHashKey* d_keys;
+  HCTR_LIB_THROW(cudaMalloc(&d_table, h_table.size() * sizeof(float)));
+  HCTR_LIB_THROW(cudaMalloc(&d_value_index, nnz * sizeof(size_t)));
+  HCTR_LIB_THROW(cudaMalloc(&d_keys, nnz * sizeof(TypeHashKey)));
+  HCTR_LIB_THROW(cudaMemcpy(d_table, h_table.data(), h_table.size() * sizeof(float),
+                            cudaMemcpyHostToDevice));
+  HCTR_LIB_THROW(cudaMemcpy(d_value_index, h_value_index.data(), nnz * sizeof(size_t),
+                            cudaMemcpyHostToDevice));
+  HCTR_LIB_THROW(
+      cudaMemcpy(d_keys, h_keys.data(), nnz * sizeof(TypeHashKey), cudaMemcpyHostToDevice));
+
+  {
+    DeltaTracker tracker(0, stream, d_table, num_rows, embedding_vec_size, staging_rows);
+    // Two batches of the same rows are extracted once
+    tracker.mark(d_keys, d_value_index, nnz / 2);
+    tracker.mark(d_keys, d_value_index, nnz);
+    tracker.record();
+
+    std::map<long long, std::vector<float>> extracted;
+    size_t num_pairs;
+    do {
+      num_pairs = tracker.extract();
+      ASSERT_LE(num_pairs, staging_rows);
+      for (size_t i = 0; i < num_pairs; i++) {
+        const long long key = tracker.keys()[i];
+        EXPECT_EQ(extracted.count(key), 0u) << "key " << key << " extracted twice";
+        extracted[key].assign(tracker.vectors() + i * embedding_vec_size,
+                              tracker.vectors() + (i + 1) * embedding_vec_size);
+      }
+    } while (num_pairs == staging_rows);
+
+    ASSERT_EQ(extracted.size(), expected.size());
+    for (const auto& [key, row] : expected) {
+      ASSERT_EQ(extracted.count(key), 1u) << "key " << key << " not extracted";
+      for (size_t j = 0; j < embedding_vec_size; j++) {
+        EXPECT_EQ(extracted[key][j], h_table[row * embedding_vec_size + j]);
+      }
+    }
+
+    // Nothing is left, until the rows are marked again
+    tracker.record();
+    EXPECT_EQ(tracker.extract(), 0u);
+    tracker.mark(d_keys, d_value_index, 1);
+    tracker.record();
+    ASSERT_EQ(tracker.extract(), 1u);
+    EXPECT_EQ(tracker.keys()[0], static_cast<long long>(h_keys[0]));
+
+    tracker.mark(d_keys, d_value_index, nnz);
+    tracker.reset();
+    tracker.record();
+    EXPECT_EQ(tracker.extract(), 0u);
+  }
+
+  HCTR_LIB_THROW(cudaFree(d_keys));
+  HCTR_LIB_THROW(cudaFree(d_value_index));
+  HCTR_LIB_THROW(cudaFree(d_table));
+  HCTR_LIB_THROW(cudaStreamDestroy(stream));
+}
+
+TEST(delta_tracker, i64_1000x16_single_round) {
+  delta_tracker_test<long long>(1000, 16, 4096, 1000);
+}
+TEST(delta_tracker, u32_100000x128_several_rounds) {
+  delta_tracker_test<unsigned int>(100000, 128, 200000, 4096);
+}
+
+}  // namespace
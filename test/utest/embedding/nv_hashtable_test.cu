@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <hashtable/bucketed_hash_map.cuh>
+#include <hashtable/nv_hashtable.hpp>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+template <typename T>
+class DeviceVector {
+ public:
+  explicit DeviceVector(size_t size) : size_(size) {
+    HCTR_LIB_THROW(
+        cudaMalloc(reinterpret_cast<void**>(&ptr_), std::max<size_t>(size, 1) * sizeof(T)));
+  }
+  explicit DeviceVector(const std::vector<T>& host) : DeviceVector(host.size()) {
+    HCTR_LIB_THROW(cudaMemcpy(ptr_, host.data(), size_ * sizeof(T), cudaMemcpyHostToDevice));
+  }
+  ~DeviceVector() { cudaFree(ptr_); }
+
+  T* get() const { return ptr_; }
+  std::vector<T> to_host(size_t size) const {
+    std::vector<T> host(size);
+    HCTR_LIB_THROW(cudaMemcpy(host.data(), ptr_, size * sizeof(T), cudaMemcpyDeviceToHost));
+    return host;
+  }
+  std::vector<T> to_host() const { return to_host(size_); }
+
+ private:
+  T* ptr_ = nullptr;
+  size_t size_;
+};
+
+// Random keys with ~50% duplicates, drawn from the whole key range except the reserved max
+template <typename KeyType>
+std::vector<KeyType> random_keys(size_t len, size_t num_unique) {
+  std::mt19937_64 gen(42);
+  std::uniform_int_distribution<KeyType> dist(std::numeric_limits<KeyType>::min(),
+                                              std::numeric_limits<KeyType>::max() - 1);
+  std::vector<KeyType> uniques(num_unique);
+  std::generate(uniques.begin(), uniques.end(), [&] { return dist(gen); });
+  std::vector<KeyType> keys(len);
+  std::uniform_int_distribution<size_t> pick(0, num_unique - 1);
+  std::generate(keys.begin(), keys.end(), [&] { return uniques[pick(gen)]; });
+  return keys;
+}
+
+template <typename KeyType>
+void get_insert_test(size_t capacity, size_t len) {
+  using ValType = size_t;
+  const auto h_keys = random_keys<KeyType>(len, len / 2);
+  const std::unordered_set<KeyType> uniques(h_keys.begin(), h_keys.end());
+
+  HashTable<KeyType, ValType> table(capacity);
+  cudaStream_t stream = 0;
+  DeviceVector<KeyType> d_keys(h_keys);
+  DeviceVector<ValType> d_vals(len);
+  table.get_insert(d_keys.get(), d_vals.get(), len, stream);
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+
+  // Every unique key gets one value, and the values are 0..num_unique-1
+  const auto h_vals = d_vals.to_host();
+  std::unordered_map<KeyType, ValType> assigned;
+  for (size_t i = 0; i < len; ++i) {
+    auto [it, inserted] = assigned.emplace(h_keys[i], h_vals[i]);
+    ASSERT_EQ(it->second, h_vals[i]);
+  }
+  std::unordered_set<ValType> values;
+  for (auto& [key, value] : assigned) {
+    ASSERT_LT(value, uniques.size());
+    values.insert(value);
+  }
+  EXPECT_EQ(values.size(), uniques.size());
+  EXPECT_EQ(table.get_value_head(stream), uniques.size());
+  EXPECT_EQ(table.get_size(stream), uniques.size());
+
+  // get returns the same values, get_mark marks the missing keys
+  DeviceVector<ValType> d_found(len);
+  table.get(d_keys.get(), d_found.get(), len, stream);
+  EXPECT_EQ(d_found.to_host(), h_vals);
+
+  std::vector<KeyType> h_missing;
+  for (KeyType key = 0; h_missing.size() < 16; ++key) {
+    if (!uniques.count(key)) h_missing.push_back(key);
+  }
+  DeviceVector<KeyType> d_missing(h_missing);
+  DeviceVector<ValType> d_marks(h_missing.size());
+  table.get_mark(d_missing.get(), d_marks.get(), h_missing.size(), stream);
+  for (auto mark : d_marks.to_host()) {
+    EXPECT_EQ(mark, std::numeric_limits<ValType>::max());
+  }
+
+  // dump returns every pair exactly once
+  DeviceVector<KeyType> d_dump_keys(capacity);
+  DeviceVector<ValType> d_dump_vals(capacity);
+  DeviceVector<size_t> d_dump_counter(1);
+  table.dump(d_dump_keys.get(), d_dump_vals.get(), d_dump_counter.get(), stream);
+  const size_t num_dumped = d_dump_counter.to_host()[0];
+  ASSERT_EQ(num_dumped, uniques.size());
+  const auto h_dump_keys = d_dump_keys.to_host(num_dumped);
+  const auto h_dump_vals = d_dump_vals.to_host(num_dumped);
+  for (size_t i = 0; i < num_dumped; ++i) {
+    EXPECT_EQ(assigned.at(h_dump_keys[i]), h_dump_vals[i]);
+  }
+
+  table.clear(stream);
+  EXPECT_EQ(table.get_size(stream), 0u);
+  EXPECT_EQ(table.get_value_head(stream), 0u);
+}
+
+template <typename KeyType>
+void erase_test(size_t len) {
+  using ValType = size_t;
+  std::vector<KeyType> h_keys(len);
+  std::iota(h_keys.begin(), h_keys.end(), KeyType{0});
+  std::vector<ValType> h_vals(len);
+  std::iota(h_vals.begin(), h_vals.end(), ValType{100});
+
+  BucketedHashMap<KeyType, ValType> map(2 * len);
+  cudaStream_t stream = 0;
+  DeviceVector<KeyType> d_keys(h_keys);
+  DeviceVector<ValType> d_vals(h_vals);
+  map.insert_or_assign(d_keys.get(), d_vals.get(), len, stream);
+
+  // Erase the even keys
+  std::vector<KeyType> h_erased;
+  for (size_t i = 0; i < len; i += 2) h_erased.push_back(h_keys[i]);
+  DeviceVector<KeyType> d_erased(h_erased);
+  map.erase(d_erased.get(), h_erased.size(), stream);
+
+  DeviceVector<size_t> d_size(1);
+  map.size(d_size.get(), stream);
+  EXPECT_EQ(d_size.to_host()[0], len - h_erased.size());
+
+  DeviceVector<ValType> d_found(len);
+  map.find(d_keys.get(), d_found.get(), len, stream);
+  const auto h_found = d_found.to_host();
+  for (size_t i = 0; i < len; ++i) {
+    EXPECT_EQ(h_found[i], i % 2 ? h_vals[i] : std::numeric_limits<ValType>::max());
+  }
+}
+
+}  // namespace
+
+TEST(nv_hashtable_test, get_insert_long_long) { get_insert_test<long long>(1 << 20, 1 << 20); }
+TEST(nv_hashtable_test, get_insert_unsigned) { get_insert_test<unsigned int>(1 << 20, 1 << 20); }
+TEST(nv_hashtable_test, get_insert_full_load) { get_insert_test<long long>(1 << 19, 1 << 20); }
+TEST(nv_hashtable_test, erase_long_long) { erase_test<long long>(100000); }
+TEST(nv_hashtable_test, erase_unsigned) { erase_test<unsigned int>(100000); }
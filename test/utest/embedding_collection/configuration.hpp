@@ -70,6 +70,15 @@ static std::vector<EmbeddingConfiguration> tiny_embedding{
     {19, {1}, 1000000, 16},
 };
 
+// The deterministic wgrad reduction does not support the concat combiner of model parallel tables.
+// The tiny vocabularies make some keys span several partial reductions.
+static std::vector<EmbeddingConfiguration> tiny_sum_embedding{
+    {1, {1, 10}, 10000, 8, Combiner::Sum},
+    {2, {1, 10}, 10, 16, Combiner::Sum},
+    {4, {1}, 10, 8, Combiner::Sum},
+    {2, {1}, 100000, 16, Combiner::Sum},
+};
+
 static std::vector<EmbeddingConfiguration> small_embedding{
     {5, {1, 30}, 10000, 16, Combiner::Sum},
     {3, {1, 30}, 4000000, 32, Combiner::Sum},
@@ -330,12 +339,14 @@ struct EmbeddingCollectionOption {
   embedding::SortStrategy sort_strategy;
   embedding::AllreduceStrategy allreduce_strategy;
   embedding::CommunicationStrategy comm_strategy;
+  bool deterministic = false;
 };
 std::ostream &operator<<(std::ostream &os, const EmbeddingCollectionOption &p) {
   os << "\n\tinput_layout:" << p.input_layout << "\n\toutput_layout:" << p.output_layout
      << "\n\tkeys_preprocess_strategy:" << p.keys_preprocess_strategy
      << "\n\tsort_strategy:" << p.sort_strategy << "\n\tallreduce_strategy:" << p.allreduce_strategy
-     << "\n\tcomm_strategy:" << p.comm_strategy << std::endl;
+     << "\n\tcomm_strategy:" << p.comm_strategy << "\n\tdeterministic:" << p.deterministic
+     << std::endl;
   return os;
 }
 
@@ -406,6 +417,10 @@ std::vector<Configuration> get_ebc_single_node_utest_configuration() {
           embedding::EmbeddingLayout::FeatureMajor, embedding::EmbeddingLayout::FeatureMajor,
           embedding::KeysPreprocessStrategy::AddOffset, embedding::SortStrategy::Segmented,
           embedding::AllreduceStrategy::Dense, embedding::CommunicationStrategy::Uniform},
+      EmbeddingCollectionOption{
+          embedding::EmbeddingLayout::FeatureMajor, embedding::EmbeddingLayout::FeatureMajor,
+          embedding::KeysPreprocessStrategy::AddOffset, embedding::SortStrategy::Segmented,
+          embedding::AllreduceStrategy::Sparse, embedding::CommunicationStrategy::Uniform},
   };
 
   std::vector<Configuration> configurations{
@@ -440,6 +455,41 @@ std::vector<Configuration> get_ebc_single_node_utest_configuration() {
   return configurations;
 }
 
+std::vector<Configuration> get_ebc_deterministic_utest_configuration() {
+  std::vector<EmbeddingCollectionOption> options{
+      EmbeddingCollectionOption{
+          embedding::EmbeddingLayout::FeatureMajor, embedding::EmbeddingLayout::FeatureMajor,
+          embedding::KeysPreprocessStrategy::AddOffset, embedding::SortStrategy::Radix,
+          embedding::AllreduceStrategy::Dense, embedding::CommunicationStrategy::Uniform, true},
+      EmbeddingCollectionOption{
+          embedding::EmbeddingLayout::FeatureMajor, embedding::EmbeddingLayout::BatchMajor,
+          embedding::KeysPreprocessStrategy::AddOffset, embedding::SortStrategy::Segmented,
+          embedding::AllreduceStrategy::Dense, embedding::CommunicationStrategy::Uniform, true},
+  };
+
+  std::vector<Configuration> configurations{
+      Configuration{
+          .embedding_config = tiny_sum_embedding,
+          .opt = sgd_opt,
+          .shard_configuration = sharding::table_wise_sharding(single_node, tiny_sum_embedding),
+          .runtime_configuration = single_node,
+          .input_data_configuration = synthetic_uniform_dataset,
+          .options = options,
+          .reference_check = true,
+      },
+      Configuration{
+          .embedding_config = tiny_sum_embedding,
+          .opt = sgd_opt,
+          .shard_configuration = sharding::hybrid_sharding(single_node, tiny_sum_embedding),
+          .runtime_configuration = single_node,
+          .input_data_configuration = synthetic_uniform_dataset,
+          .options = options,
+          .reference_check = true,
+      },
+  };
+  return configurations;
+}
+
 std::vector<Configuration> get_ebc_two_node_utest_configuration() {
   std::vector<EmbeddingCollectionOption> options{
       EmbeddingCollectionOption{
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <core/hctr_impl/hctr_backend.hpp>
+#include <embedding_storage/dynamic_embedding.hpp>
+#include <resource_managers/resource_manager_ext.hpp>
+
+using namespace embedding;
+
+namespace {
+
+using Key = int64_t;
+
+constexpr int ev_size = 4;
+
+class DynamicEmbeddingEvictionTest {
+ public:
+  explicit DynamicEmbeddingEvictionTest(const DynamicEvictionParams& eviction_param) {
+    const std::vector<int> device_list{0};
+    HugeCTR::CudaDeviceContext context(0);
+    resource_manager_ = HugeCTR::ResourceManagerExt::create({device_list}, 0);
+    core_ = std::make_shared<hctr_internal::HCTRCoreResourceManager>(resource_manager_, 0);
+
+    const HugeCTR::OptParams opt_params{HugeCTR::Optimizer_t::SGD, 0.1f, {},
+                                        HugeCTR::Update_t::Local, 1.f};
+    table_params_ = {{0, -1, ev_size, opt_params, {}, false, eviction_param}};
+    const std::vector<LookupParam> lookup_params{{0, 0, Combiner::Sum, 8, ev_size}};
+
+    const EmbeddingCollectionParam ebc_param{
+        1,
+        1,
+        lookup_params,
+        {{1}},
+        {{TablePlacementStrategy::ModelParallel, {0}}},
+        16,
+        core23::ToScalarType<Key>::value,
+        core23::ToScalarType<uint32_t>::value,
+        core23::ToScalarType<uint32_t>::value,
+        core23::ToScalarType<float>::value,
+        core23::ToScalarType<float>::value,
+        EmbeddingLayout::BatchMajor,
+        EmbeddingLayout::FeatureMajor,
+        embedding::SortStrategy::Radix,
+        KeysPreprocessStrategy::None,
+        AllreduceStrategy::Dense,
+        CommunicationStrategy::Uniform};
+
+    table_ = std::make_unique<DynamicEmbeddingTable>(*resource_manager_->get_local_gpu(0), core_,
+                                                     table_params_, ebc_param, 0,
+                                                     table_params_[0].opt_param);
+  }
+
+  // Returns the looked up vectors.
+  std::vector<std::vector<float>> lookup(const std::vector<Key>& keys) {
+    auto keys_buf = make_tensor(keys, core23::ToScalarType<Key>::value);
+    auto id_space_offsets_buf =
+        make_tensor(std::vector<uint32_t>{0, static_cast<uint32_t>(keys.size())},
+                    core23::ScalarType::UInt32);
+    auto id_spaces_buf = make_tensor(std::vector<int32_t>{0}, core23::ScalarType::Int32);
+    auto evs_buf = core23::init_tensor_list<float>(keys.size(), 0);
+
+    table_->lookup(keys_buf, keys.size(), id_space_offsets_buf, 2, id_spaces_buf, evs_buf);
+
+    std::vector<float*> ev_ptrs(keys.size());
+    HCTR_LIB_THROW(cudaMemcpy(ev_ptrs.data(), evs_buf.data(), sizeof(float*) * keys.size(),
+                              cudaMemcpyDeviceToHost));
+    std::vector<std::vector<float>> evs;
+    for (float* ev_ptr : ev_ptrs) {
+      std::vector<float> ev(ev_size);
+      HCTR_LIB_THROW(
+          cudaMemcpy(ev.data(), ev_ptr, sizeof(float) * ev_size, cudaMemcpyDeviceToHost));
+      evs.push_back(ev);
+    }
+    return evs;
+  }
+
+  // One step, with a gradient of 1 for every key.
+  void update(const std::vector<Key>& unique_keys) {
+    const size_t num_keys = unique_keys.size();
+    std::vector<uint32_t> ev_start_indices(num_keys + 1);
+    for (size_t i = 0; i <= num_keys; ++i) {
+      ev_start_indices[i] = i * ev_size;
+    }
+    auto keys_buf = make_tensor(unique_keys.empty() ? std::vector<Key>{0} : unique_keys,
+                                core23::ToScalarType<Key>::value);
+    auto num_keys_buf =
+        make_tensor(std::vector<uint64_t>{num_keys}, core23::ScalarType::UInt64);
+    auto table_ids_buf =
+        make_tensor(std::vector<int32_t>(std::max<size_t>(num_keys, 1), 0),
+                    core23::ScalarType::Int32);
+    auto ev_start_indices_buf = make_tensor(ev_start_indices, core23::ScalarType::UInt32);
+    auto wgrad_buf = make_tensor(std::vector<float>(std::max<size_t>(num_keys, 1) * ev_size, 1.f),
+                                 core23::ScalarType::Float);
+
+    table_->update(keys_buf, num_keys_buf, table_ids_buf, ev_start_indices_buf, wgrad_buf);
+  }
+
+  size_t key_num() const { return table_->key_num(); }
+
+ private:
+  core23::Device device() const { return core23::Device(core23::DeviceType::GPU, 0); }
+
+  template <typename T>
+  core23::Tensor make_tensor(const std::vector<T>& values, core23::DataType data_type) {
+    core23::TensorParams params = core23::TensorParams().device(device());
+    auto tensor = core23::Tensor(
+        params.shape({static_cast<int64_t>(values.size())}).data_type(data_type));
+    core23::copy_sync(tensor, values);
+    return tensor;
+  }
+
+  std::shared_ptr<HugeCTR::ResourceManager> resource_manager_;
+  std::shared_ptr<CoreResourceManager> core_;
+  std::vector<EmbeddingTableParam> table_params_;
+  std::unique_ptr<DynamicEmbeddingTable> table_;
+};
+
+}  // namespace
+
+TEST(dynamic_embedding_table, ttl_eviction) {
+  DynamicEmbeddingEvictionTest test({2, 0, 0, 1});
+
+  test.lookup({1, 2, 3});
+  test.update({1, 2, 3});
+  EXPECT_EQ(test.key_num(), 3);
+
+  // Key 3 keeps being looked up, keys 1 and 2 expire after 2 steps without lookups.
+  for (int step = 0; step < 3; ++step) {
+    test.lookup({3});
+    test.update({3});
+  }
+  EXPECT_EQ(test.key_num(), 1);
+}
+
+TEST(dynamic_embedding_table, frequency_eviction) {
+  DynamicEmbeddingEvictionTest test({0, 2, 0, 2});
+
+  test.lookup({1, 2});
+  test.update({1, 2});
+  test.lookup({2});
+  test.update({2});
+
+  // Key 1 was looked up once since the last scan.
+  EXPECT_EQ(test.key_num(), 1);
+}
+
+TEST(dynamic_embedding_table, admission) {
+  DynamicEmbeddingEvictionTest test({0, 0, 2, 1000});
+
+  // The first lookup of a key does not create its row and looks up zeros.
+  for (const auto& ev : test.lookup({1, 2, 3})) {
+    EXPECT_EQ(ev, std::vector<float>(ev_size, 0.f));
+  }
+  test.update({1, 2, 3});
+  EXPECT_EQ(test.key_num(), 0);
+
+  // The second one does, and only the admitted keys are updated.
+  test.lookup({1, 2});
+  EXPECT_EQ(test.key_num(), 2);
+  test.update({1, 2, 3});
+  EXPECT_EQ(test.key_num(), 2);
+}
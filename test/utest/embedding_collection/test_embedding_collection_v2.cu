@@ -319,6 +319,7 @@ void embedding_collection_e2e(const Configuration &config) {
                             batch_size, key_type, index_type, offset_type, emb_type, wgrad_type,
                             input_layout, output_layout, sort_strategy, keys_preprocess_strategy,
                             allreduce_strategy, comm_strategy);
+    ebc_params.back().deterministic_ = option.deterministic;
   }
 
   HCTR_LOG(INFO, ROOT, "start preparing host data\n");
@@ -509,6 +510,12 @@ TEST(test_embedding_collection, utest_1node) {
   }
 }
 
+TEST(test_embedding_collection, utest_1node_deterministic) {
+  for (auto &config : get_ebc_deterministic_utest_configuration()) {
+    embedding_collection_e2e<uint32_t, uint32_t, uint32_t, float>(config);
+  }
+}
+
 TEST(test_embedding_collection, utest_2node) {
   for (auto &config : get_ebc_two_node_utest_configuration()) {
     embedding_collection_e2e<uint32_t, uint32_t, uint32_t, float>(config);
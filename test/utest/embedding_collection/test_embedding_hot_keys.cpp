@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <embeddings/embedding_hot_keys.hpp>
+#include <fstream>
+
+using namespace HugeCTR;
+
+TEST(test_embedding_hot_keys, selects_keys_above_threshold) {
+  // 4 GPUs, equal bandwidths: threshold = 10 iterations * 4 * 4 / 3 ~= 53.3 occurrences.
+  KeyFrequencies frequencies{{1, 1000}, {2, 54}, {3, 53}, {4, 1}};
+  auto hot_keys = select_hot_keys(frequencies, 10, 4, 1.0, 1.0, 100);
+  EXPECT_EQ(hot_keys, (std::vector<int64_t>{1, 2}));
+
+  // A faster allreduce makes more keys hot.
+  hot_keys = select_hot_keys(frequencies, 10, 4, 1.0, 10.0, 100);
+  EXPECT_EQ(hot_keys, (std::vector<int64_t>{1, 2, 3}));
+}
+
+TEST(test_embedding_hot_keys, keeps_most_frequent_keys) {
+  KeyFrequencies frequencies;
+  for (int64_t key = 0; key < 100; ++key) {
+    frequencies[key] = 1000 + key;
+  }
+  auto hot_keys = select_hot_keys(frequencies, 1, 2, 1.0, 1.0, 3);
+  EXPECT_EQ(hot_keys, (std::vector<int64_t>{97, 98, 99}));
+}
+
+TEST(test_embedding_hot_keys, no_hot_keys_on_single_gpu) {
+  KeyFrequencies frequencies{{1, 1000}};
+  EXPECT_TRUE(select_hot_keys(frequencies, 1, 1, 1.0, 1.0, 100).empty());
+}
+
+TEST(test_embedding_hot_keys, samples_raw_file) {
+  const std::string file_name = "test_embedding_hot_keys.raw";
+  RawSampleLayout layout{1, 2, {1, 2}, 8};
+  {
+    std::ofstream file(file_name, std::ofstream::binary);
+    for (int64_t i = 0; i < 10; ++i) {
+      int32_t label_dense[3] = {0, 1, 2};
+      int64_t keys[3] = {i % 2, 100, 200 + i};
+      file.write(reinterpret_cast<const char *>(label_dense), sizeof(label_dense));
+      file.write(reinterpret_cast<const char *>(keys), sizeof(keys));
+    }
+  }
+
+  auto frequencies = sample_raw_key_frequencies(file_name, layout, 8);
+  ASSERT_EQ(frequencies.size(), 2);
+  EXPECT_EQ(frequencies[0].size(), 2);
+  EXPECT_EQ(frequencies[0][0], 4);
+  EXPECT_EQ(frequencies[0][1], 4);
+  EXPECT_EQ(frequencies[1][100], 8);
+  EXPECT_EQ(frequencies[1].size(), 9);
+
+  // Stops at the end of the file.
+  frequencies = sample_raw_key_frequencies(file_name, layout, 1000);
+  EXPECT_EQ(frequencies[1][100], 10);
+  std::remove(file_name.c_str());
+}
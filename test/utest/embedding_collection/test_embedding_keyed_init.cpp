@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <core/hctr_impl/hctr_backend.hpp>
+#include <embedding/operators/keys_to_indices.hpp>
+#include <embedding_storage/dynamic_embedding.hpp>
+#include <embedding_storage/ragged_static_embedding.hpp>
+#include <map>
+#include <resource_managers/resource_manager_ext.hpp>
+
+using namespace embedding;
+
+namespace {
+
+using Key = int64_t;
+
+constexpr int ev_size = 8;
+constexpr float up_bound = 0.1f;
+
+class KeyedInitTest {
+ public:
+  explicit KeyedInitTest(int max_vocabulary_size) {
+    const std::vector<int> device_list{0};
+    HugeCTR::CudaDeviceContext context(0);
+    resource_manager_ = HugeCTR::ResourceManagerExt::create({device_list}, 0);
+    core_ = std::make_shared<hctr_internal::HCTRCoreResourceManager>(resource_manager_, 0);
+
+    const HugeCTR::OptParams opt_params{HugeCTR::Optimizer_t::SGD, 0.1f, {},
+                                        HugeCTR::Update_t::Local, 1.f};
+    table_params_ = {{0, max_vocabulary_size, ev_size, opt_params,
+                      InitParams(ev_size, HugeCTR::Initializer_t::Uniform, up_bound)}};
+    const std::vector<LookupParam> lookup_params{{0, 0, Combiner::Sum, 8, ev_size}};
+
+    ebc_param_ = std::make_unique<EmbeddingCollectionParam>(
+        1, 1, lookup_params, std::vector<std::vector<int>>{{1}},
+        std::vector<GroupedTableParam>{{TablePlacementStrategy::ModelParallel, {0}}}, 16,
+        core23::ToScalarType<Key>::value, core23::ToScalarType<uint32_t>::value,
+        core23::ToScalarType<uint32_t>::value, core23::ToScalarType<float>::value,
+        core23::ToScalarType<float>::value, EmbeddingLayout::BatchMajor,
+        EmbeddingLayout::FeatureMajor, embedding::SortStrategy::Radix,
+        KeysPreprocessStrategy::None, AllreduceStrategy::Dense, CommunicationStrategy::Uniform);
+
+    if (max_vocabulary_size > 0) {
+      table_ = std::make_unique<RaggedStaticEmbeddingTable>(
+          *resource_manager_->get_local_gpu(0), core_, table_params_, *ebc_param_, 0, opt_params);
+    } else {
+      table_ = std::make_unique<DynamicEmbeddingTable>(*resource_manager_->get_local_gpu(0), core_,
+                                                       table_params_, *ebc_param_, 0, opt_params);
+    }
+  }
+
+  // Returns the looked up vectors by key.
+  std::map<Key, std::vector<float>> lookup(const std::vector<Key>& keys) {
+    auto keys_buf = make_tensor(keys, core23::ToScalarType<Key>::value);
+    auto id_space_offsets_buf =
+        make_tensor(std::vector<uint32_t>{0, static_cast<uint32_t>(keys.size())},
+                    core23::ScalarType::UInt32);
+    auto id_spaces_buf = make_tensor(std::vector<int32_t>{0}, core23::ScalarType::Int32);
+    auto evs_buf = core23::init_tensor_list<float>(keys.size(), 0);
+
+    if (table_params_[0].max_vocabulary_size > 0) {
+      KeysToIndicesConverter converter(core_, table_params_, *ebc_param_, 0);
+      converter.convert(keys_buf, keys.size(), id_space_offsets_buf, id_spaces_buf);
+    }
+    table_->lookup(keys_buf, keys.size(), id_space_offsets_buf, 2, id_spaces_buf, evs_buf);
+    HCTR_LIB_THROW(cudaStreamSynchronize(core_->get_local_gpu()->get_stream()));
+
+    std::vector<float*> ev_ptrs(keys.size());
+    HCTR_LIB_THROW(cudaMemcpy(ev_ptrs.data(), evs_buf.data(), sizeof(float*) * keys.size(),
+                              cudaMemcpyDeviceToHost));
+    std::map<Key, std::vector<float>> evs;
+    for (size_t i = 0; i < keys.size(); ++i) {
+      std::vector<float> ev(ev_size);
+      HCTR_LIB_THROW(
+          cudaMemcpy(ev.data(), ev_ptrs[i], sizeof(float) * ev_size, cudaMemcpyDeviceToHost));
+      evs[keys[i]] = ev;
+    }
+    return evs;
+  }
+
+ private:
+  template <typename T>
+  core23::Tensor make_tensor(const std::vector<T>& values, core23::DataType data_type) {
+    core23::TensorParams params =
+        core23::TensorParams().device(core23::Device(core23::DeviceType::GPU, 0));
+    auto tensor = core23::Tensor(
+        params.shape({static_cast<int64_t>(values.size())}).data_type(data_type));
+    core23::copy_sync(tensor, values);
+    return tensor;
+  }
+
+  std::shared_ptr<HugeCTR::ResourceManager> resource_manager_;
+  std::shared_ptr<CoreResourceManager> core_;
+  std::vector<EmbeddingTableParam> table_params_;
+  std::unique_ptr<EmbeddingCollectionParam> ebc_param_;
+  std::unique_ptr<IGroupedEmbeddingTable> table_;
+};
+
+}  // namespace
+
+TEST(keyed_init, dynamic_rows_do_not_depend_on_lookup_order) {
+  KeyedInitTest first(-1), second(-1);
+  const auto first_evs = first.lookup({3, 700, 42});
+  const auto second_evs = second.lookup({42, 999, 3, 700});
+
+  for (const auto& [key, ev] : first_evs) {
+    EXPECT_EQ(ev, second_evs.at(key)) << "key " << key;
+    for (float v : ev) {
+      EXPECT_GT(v, -up_bound);
+      EXPECT_LE(v, up_bound);
+    }
+  }
+  EXPECT_NE(first_evs.at(3), first_evs.at(42));
+}
+
+TEST(keyed_init, static_rows_match_dynamic_rows) {
+  KeyedInitTest static_table(1000), dynamic_table(-1);
+  const std::vector<Key> keys{0, 3, 42, 700, 999};
+  EXPECT_EQ(static_table.lookup(keys), dynamic_table.lookup(keys));
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <embeddings/embedding_planner.hpp>
+#include <set>
+
+using namespace HugeCTR;
+
+namespace {
+
+int count_gpus_with_table(const EmbeddingShardPlan &plan, const std::string &name) {
+  int count = 0;
+  for (const auto &gpu_tables : plan.shard_matrix) {
+    count += std::count(gpu_tables.begin(), gpu_tables.end(), name);
+  }
+  return count;
+}
+
+}  // namespace
+
+TEST(test_embedding_planner, balances_equal_tables) {
+  std::vector<EmbeddingPlannerTableStats> tables;
+  for (int i = 0; i < 8; ++i) {
+    tables.emplace_back("t" + std::to_string(i), 1000000, 64, 1);
+  }
+  EmbeddingPlannerDeviceSpec spec{4, 8192, int64_t{16} << 30, 2000, 200};
+  auto plan = plan_embedding_sharding(tables, spec);
+
+  ASSERT_EQ(plan.shard_matrix.size(), 4);
+  for (const auto &gpu_tables : plan.shard_matrix) {
+    EXPECT_EQ(gpu_tables.size(), 2);
+  }
+  for (const auto &table : tables) {
+    EXPECT_EQ(count_gpus_with_table(plan, table.name), 1);
+  }
+  EXPECT_NEAR(plan.imbalance(), 1.0, 1e-9);
+  ASSERT_EQ(plan.shard_strategy.size(), 1);
+  EXPECT_EQ(get_table_place_strategy(plan.shard_strategy[0]), "mp");
+}
+
+TEST(test_embedding_planner, replicates_small_tables) {
+  std::vector<EmbeddingPlannerTableStats> tables{{"small", 1000, 16, 1}};
+  for (int i = 0; i < 4; ++i) {
+    tables.emplace_back("large" + std::to_string(i), 10000000, 64, 1);
+  }
+  EmbeddingPlannerDeviceSpec spec{4, 8192, int64_t{16} << 30, 2000, 200, 1 << 20};
+  auto plan = plan_embedding_sharding(tables, spec);
+
+  EXPECT_EQ(count_gpus_with_table(plan, "small"), 4);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(count_gpus_with_table(plan, "large" + std::to_string(i)), 1);
+  }
+  std::set<std::string> strategies;
+  for (const auto &strategy : plan.shard_strategy) {
+    strategies.insert(get_table_place_strategy(strategy));
+  }
+  EXPECT_EQ(strategies, (std::set<std::string>{"mp", "dp"}));
+}
+
+TEST(test_embedding_planner, splits_huge_tables_row_wise) {
+  // 4 GiB of weights + 4 GiB of optimizer states, 3 GiB per GPU.
+  std::vector<EmbeddingPlannerTableStats> tables{{"huge", 1 << 24, 64, 1}, {"t0", 1000, 64, 1}};
+  EmbeddingPlannerDeviceSpec spec{4, 8192, int64_t{3} << 30, 2000, 200};
+  auto plan = plan_embedding_sharding(tables, spec);
+
+  EXPECT_EQ(count_gpus_with_table(plan, "huge"), 3);
+  for (int64_t memory : plan.gpu_memory) {
+    EXPECT_LE(memory, spec.memory_bytes_per_gpu);
+  }
+  EXPECT_FALSE(plan.report().empty());
+}
+
+TEST(test_embedding_planner, throws_if_tables_do_not_fit) {
+  std::vector<EmbeddingPlannerTableStats> tables{{"huge", 1 << 24, 64, 1}};
+  EmbeddingPlannerDeviceSpec spec{2, 8192, int64_t{1} << 30, 2000, 200};
+  EXPECT_ANY_THROW(plan_embedding_sharding(tables, spec));
+}
+
+TEST(test_embedding_planner, keeps_shards_on_nvlink_pairs) {
+  // 8 GiB with the optimizer states, 5 GiB per GPU, so 2 shards. The small tables go first, to
+  // GPUs 0 to 2, then the first shard to GPU 3.
+  std::vector<EmbeddingPlannerTableStats> tables{
+      {"huge", 1 << 24, 64, 1}, {"t0", 1000, 64, 1}, {"t1", 1000, 64, 1}, {"t2", 1000, 64, 1}};
+  // GPUs 0 and 2, and 1 and 3, are NVLink pairs, the other pairs are on PCIe.
+  const double nv = 1. / 50, pcie = 1. / 12;
+  std::vector<std::vector<double>> link_cost{
+      {0, pcie, nv, pcie}, {pcie, 0, pcie, nv}, {nv, pcie, 0, pcie}, {pcie, nv, pcie, 0}};
+  EmbeddingPlannerDeviceSpec spec{4, 8192, int64_t{5} << 30, 2000, 200, 0, link_cost};
+  auto plan = plan_embedding_sharding(tables, spec);
+
+  std::vector<int> gpus;
+  for (int gpu_id = 0; gpu_id < 4; ++gpu_id) {
+    if (std::count(plan.shard_matrix[gpu_id].begin(), plan.shard_matrix[gpu_id].end(), "huge")) {
+      gpus.push_back(gpu_id);
+    }
+  }
+  // The second shard goes to the NVLink peer of GPU 3 rather than to GPU 0.
+  EXPECT_EQ(gpus, (std::vector<int>{1, 3}));
+}
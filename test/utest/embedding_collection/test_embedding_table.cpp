@@ -143,10 +143,119 @@ void test_embedding_table(int device_id, int table_type) {
   delete embedding_table;
 }
 
+template <typename key_t, typename index_t>
+void test_ragged_static_embedding_table_dirty_rows(int device_id) {
+  std::vector<int> device_list{device_id};
+  HugeCTR::CudaDeviceContext context(device_id);
+  auto resource_manager = HugeCTR::ResourceManagerExt::create({device_list}, 0);
+  auto core = std::make_shared<hctr_internal::HCTRCoreResourceManager>(resource_manager, 0);
+
+  auto key_type = HugeCTR::core23::ToScalarType<key_t>::value;
+  auto index_type = HugeCTR::core23::ToScalarType<index_t>::value;
+
+  EmbeddingCollectionParam ebc_param{static_cast<int>(table_param_list.size()),
+                                     static_cast<int>(lookup_params.size()),
+                                     lookup_params,
+                                     shard_matrix,
+                                     grouped_emb_params,
+                                     universal_batch_size,
+                                     key_type,
+                                     index_type,
+                                     HugeCTR::core23::ToScalarType<uint32_t>::value,
+                                     HugeCTR::core23::ToScalarType<float>::value,
+                                     HugeCTR::core23::ToScalarType<float>::value,
+                                     EmbeddingLayout::BatchMajor,
+                                     EmbeddingLayout::FeatureMajor,
+                                     embedding::SortStrategy::Radix,
+                                     embedding::KeysPreprocessStrategy::None,
+                                     embedding::AllreduceStrategy::Dense,
+                                     CommunicationStrategy::Uniform};
+
+  HugeCTR::OptParams opt_param;
+  opt_param.optimizer = HugeCTR::Optimizer_t::SGD;
+  opt_param.lr = 1.f;
+  opt_param.scaler = 1.f;
+  RaggedStaticEmbeddingTable embedding_table(*resource_manager->get_local_gpu(0), core,
+                                             table_param_list, ebc_param, 0, opt_param);
+  EXPECT_THAT(embedding_table.dirty_key_num_per_table(), ::testing::ElementsAre(0, 0, 0));
+
+  core23::Device device(core23::DeviceType::GPU, core->get_device_id());
+  core23::TensorParams params = core23::TensorParams().device(device);
+
+  // Two keys of table 0 and one key of table 2, all of them with a gradient of 1.
+  std::vector<key_t> cpu_keys{7, 3, 5};
+  std::vector<uint32_t> cpu_id_space_offset{0, 2, 3};
+  std::vector<int> cpu_id_space_list{0, 2};
+  std::vector<int> cpu_table_ids{0, 0, 2};
+  std::vector<uint32_t> cpu_ev_start_indices{0, 8, 16};
+  std::vector<float> cpu_wgrad(32, 1.f);
+
+  auto keys = core23::Tensor(params.shape({3}).data_type(key_type));
+  auto num_keys = core23::Tensor(params.shape({1}).data_type(core23::ScalarType::UInt64));
+  auto id_space_offset = core23::Tensor(params.shape({3}).data_type(core23::ScalarType::UInt32));
+  auto id_space_list = core23::Tensor(params.shape({2}).data_type(core23::ScalarType::Int32));
+  auto table_ids = core23::Tensor(params.shape({3}).data_type(core23::ScalarType::Int32));
+  auto ev_start_indices = core23::Tensor(params.shape({3}).data_type(core23::ScalarType::UInt32));
+  auto wgrad = core23::Tensor(params.shape({32}).data_type(core23::ScalarType::Float));
+  core23::copy_sync(keys, cpu_keys);
+  core23::copy_sync(num_keys, std::vector<uint64_t>{3});
+  core23::copy_sync(id_space_offset, cpu_id_space_offset);
+  core23::copy_sync(id_space_list, cpu_id_space_list);
+  core23::copy_sync(table_ids, cpu_table_ids);
+  core23::copy_sync(ev_start_indices, cpu_ev_start_indices);
+  core23::copy_sync(wgrad, cpu_wgrad);
+
+  KeysToIndicesConverter converter(core, table_param_list, ebc_param, 0);
+  converter.convert(keys, keys.num_elements(), id_space_offset, id_space_list);
+
+  core23::Device cpu_device(core23::DeviceType::CPU);
+  core23::TensorParams cpu_params = core23::TensorParams().device(cpu_device);
+  const int64_t num_table_keys = table_param_list[0].max_vocabulary_size;
+  const int ev_size = table_param_list[0].ev_size;
+  auto h_keys_before = core23::Tensor(cpu_params.shape({num_table_keys}).data_type(key_type));
+  auto h_weights_before = core23::Tensor(
+      cpu_params.shape({num_table_keys * ev_size}).data_type(core23::ScalarType::Float));
+  embedding_table.dump_by_id(&h_keys_before, &h_weights_before, 0);
+
+  embedding_table.update(keys, num_keys, table_ids, ev_start_indices, wgrad);
+  EXPECT_THAT(embedding_table.dirty_key_num_per_table(), ::testing::ElementsAre(2, 0, 1));
+
+  auto h_keys = core23::Tensor(cpu_params.shape({2}).data_type(key_type));
+  auto h_weights =
+      core23::Tensor(cpu_params.shape({2 * ev_size}).data_type(core23::ScalarType::Float));
+  embedding_table.dump_dirty_by_id(&h_keys, &h_weights, 0);
+  EXPECT_EQ(h_keys.data<key_t>()[0], 3);
+  EXPECT_EQ(h_keys.data<key_t>()[1], 7);
+  for (int i = 0; i < 2; ++i) {
+    const key_t key = h_keys.data<key_t>()[i];
+    for (int j = 0; j < ev_size; ++j) {
+      EXPECT_FLOAT_EQ(h_weights.data<float>()[i * ev_size + j],
+                      h_weights_before.data<float>()[key * ev_size + j] - 1.f);
+    }
+  }
+  // The dump starts the next delta, the other tables keep their dirty rows.
+  EXPECT_THAT(embedding_table.dirty_key_num_per_table(), ::testing::ElementsAre(0, 0, 1));
+
+  // Unlike the dirty rows, the update counts are not reset by the dump.
+  embedding_table.update(keys, num_keys, table_ids, ev_start_indices, wgrad);
+  auto h_update_counts =
+      core23::Tensor(cpu_params.shape({num_table_keys}).data_type(core23::ScalarType::UInt8));
+  embedding_table.dump_update_counts_by_id(&h_update_counts, 0);
+  for (int64_t row = 0; row < num_table_keys; ++row) {
+    const key_t key = h_keys_before.data<key_t>()[row];
+    EXPECT_EQ(h_update_counts.data<uint8_t>()[row], key == 3 || key == 7 ? 2 : 0);
+  }
+}
+
 TEST(ragged_static_embedding_table, ragged_static_embedding_table) {
   test_embedding_table<int32_t, uint32_t>(0, 0);
 }
 
+TEST(ragged_static_embedding_table, dirty_rows) {
+  test_ragged_static_embedding_table_dirty_rows<int32_t, uint32_t>(0);
+  test_ragged_static_embedding_table_dirty_rows<int64_t, uint32_t>(0);
+}
+
 TEST(dynamic_embedding_table, dynamic_embedding_table) {
   test_embedding_table<int32_t, size_t>(0, 1);
   test_embedding_table<int32_t, int32_t>(0, 1);
@@ -452,6 +452,10 @@ TEST(dynamic_embedding_table, optimizer) {
                                                     10);
   test_embedding_table_optimizer<int64_t, uint32_t>(0, "Dynamic", HugeCTR::Optimizer_t::Adam, 10);
   test_embedding_table_optimizer<int64_t, uint32_t>(0, "Dynamic", HugeCTR::Optimizer_t::Ftrl, 10);
+  test_embedding_table_optimizer<int64_t, uint32_t>(0, "Dynamic",
+                                                    HugeCTR::Optimizer_t::RowWiseAdaGrad, 10);
+  test_embedding_table_optimizer<int64_t, uint32_t>(0, "Dynamic", HugeCTR::Optimizer_t::LazyAdam,
+                                                    10);
 }
 
 TEST(static_embedding_table, optimizer) {
@@ -461,4 +465,8 @@ TEST(static_embedding_table, optimizer) {
                                                     HugeCTR::Optimizer_t::AdaGrad, 10);
   test_embedding_table_optimizer<int64_t, uint32_t>(0, "RaggedStatic", HugeCTR::Optimizer_t::Ftrl,
                                                     10);
+  test_embedding_table_optimizer<int64_t, uint32_t>(0, "RaggedStatic",
+                                                    HugeCTR::Optimizer_t::RowWiseAdaGrad, 10);
+  test_embedding_table_optimizer<int64_t, uint32_t>(0, "RaggedStatic",
+                                                    HugeCTR::Optimizer_t::LazyAdam, 10);
 }
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include <core/hctr_impl/hctr_backend.hpp>
+#include <core23/tensor_operations.hpp>
+#include <embedding/operators/wgrad_accumulation.hpp>
+#include <map>
+#include <resource_managers/resource_manager_ext.hpp>
+
+using namespace embedding;
+
+namespace {
+
+const std::vector<int> ev_sizes = {4, 8};
+
+void set_wgrad(const std::vector<int64_t> &keys, const std::vector<int> &table_ids,
+               const std::vector<float> &values, Wgrad &wgrad) {
+  std::vector<uint64_t> num_keys{keys.size()};
+  std::vector<uint32_t> ev_start_indices{0};
+  for (int table_id : table_ids) {
+    ev_start_indices.push_back(ev_start_indices.back() + ev_sizes[table_id]);
+  }
+  std::vector<float> data;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    data.insert(data.end(), ev_sizes[table_ids[i]], values[i]);
+  }
+  HCTR_LIB_THROW(cudaMemcpy(wgrad.unique_keys.data(), keys.data(), keys.size() * sizeof(int64_t),
+                            cudaMemcpyHostToDevice));
+  HCTR_LIB_THROW(cudaMemcpy(wgrad.table_ids.data(), table_ids.data(),
+                            table_ids.size() * sizeof(int), cudaMemcpyHostToDevice));
+  HCTR_LIB_THROW(cudaMemcpy(wgrad.ev_start_indices.data(), ev_start_indices.data(),
+                            ev_start_indices.size() * sizeof(uint32_t), cudaMemcpyHostToDevice));
+  HCTR_LIB_THROW(cudaMemcpy(wgrad.data.data(), data.data(), data.size() * sizeof(float),
+                            cudaMemcpyHostToDevice));
+  HCTR_LIB_THROW(cudaMemcpy(wgrad.num_unique_keys.data(), num_keys.data(), sizeof(uint64_t),
+                            cudaMemcpyHostToDevice));
+}
+
+}  // namespace
+
+TEST(test_wgrad_accumulation, merges_micro_batches) {
+  auto resource_manager = HugeCTR::ResourceManagerExt::create({{0}}, 0);
+  auto core = std::make_shared<hctr_internal::HCTRCoreResourceManager>(resource_manager, 0);
+  HugeCTR::CudaDeviceContext context(core->get_device_id());
+  core23::Device device(core23::DeviceType::GPU, core->get_device_id());
+  core23::TensorParams params = core23::TensorParams().device(device);
+
+  std::vector<LookupParam> lookup_params = {{0, 0, Combiner::Sum, 1, ev_sizes[0]},
+                                            {1, 1, Combiner::Sum, 1, ev_sizes[1]}};
+  std::vector<GroupedTableParam> grouped_table_params = {
+      {TablePlacementStrategy::ModelParallel, {0, 1}}};
+  EmbeddingCollectionParam ebc_param{2,
+                                     2,
+                                     lookup_params,
+                                     {{1, 1}},
+                                     grouped_table_params,
+                                     4,
+                                     core23::ScalarType::Int64,
+                                     core23::ScalarType::UInt32,
+                                     core23::ScalarType::UInt32,
+                                     core23::ScalarType::Float,
+                                     core23::ScalarType::Float,
+                                     EmbeddingLayout::FeatureMajor,
+                                     EmbeddingLayout::FeatureMajor,
+                                     SortStrategy::Segmented,
+                                     KeysPreprocessStrategy::None,
+                                     AllreduceStrategy::Dense,
+                                     CommunicationStrategy::Uniform};
+  ebc_param.num_gradient_accumulation_steps_ = 2;
+
+  const int64_t max_num_keys = 4;
+  Wgrad wgrad;
+  wgrad.attr.init(core, ebc_param, 0);
+  wgrad.unique_keys = core23::Tensor(params.shape({max_num_keys}).data_type(ebc_param.key_type));
+  wgrad.num_unique_keys = core23::Tensor(params.shape({1}).data_type(core23::ScalarType::UInt64));
+  wgrad.table_ids =
+      core23::Tensor(params.shape({max_num_keys}).data_type(core23::ScalarType::Int32));
+  wgrad.ev_start_indices =
+      core23::Tensor(params.shape({max_num_keys + 1}).data_type(core23::ScalarType::UInt32));
+  wgrad.data = core23::Tensor(
+      params.shape({max_num_keys * ev_sizes[1]}).data_type(core23::ScalarType::Float));
+
+  WgradAccumulator accumulator(core, ebc_param, 0, wgrad, {100, 100});
+  auto stream = core->get_local_gpu()->get_stream();
+
+  // Key 5 is in both tables, it is a different row in each.
+  for (int round = 0; round < 2; ++round) {
+    set_wgrad({5, 7}, {0, 1}, {1.f, 2.f}, wgrad);
+    accumulator.accumulate(wgrad, 0.5f);
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    set_wgrad({5, 3, 7}, {1, 0, 1}, {4.f, 6.f, 8.f}, wgrad);
+    accumulator.accumulate(wgrad, 0.5f);
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+
+    const auto &merged = accumulator.get_accumulated_wgrad();
+    std::vector<uint64_t> num_keys(1);
+    core23::copy_sync(num_keys, merged.num_unique_keys);
+    ASSERT_EQ(num_keys[0], 4);
+
+    std::vector<int64_t> keys(merged.unique_keys.num_elements());
+    std::vector<int> table_ids(merged.table_ids.num_elements());
+    std::vector<uint32_t> ev_start_indices(merged.ev_start_indices.num_elements());
+    std::vector<float> data(merged.data.num_elements());
+    core23::copy_sync(keys, merged.unique_keys);
+    core23::copy_sync(table_ids, merged.table_ids);
+    core23::copy_sync(ev_start_indices, merged.ev_start_indices);
+    core23::copy_sync(data, merged.data);
+
+    std::map<std::pair<int64_t, int>, float> expected{
+        {{5, 0}, 0.5f}, {{7, 1}, 5.f}, {{5, 1}, 2.f}, {{3, 0}, 3.f}};
+    for (uint64_t i = 0; i < num_keys[0]; ++i) {
+      auto it = expected.find({keys[i], table_ids[i]});
+      ASSERT_TRUE(it != expected.end());
+      for (int j = 0; j < ev_sizes[table_ids[i]]; ++j) {
+        EXPECT_FLOAT_EQ(data[ev_start_indices[i] + j], it->second);
+      }
+      expected.erase(it);
+    }
+
+    // The next round starts from an empty accumulator.
+    accumulator.clear();
+  }
+}
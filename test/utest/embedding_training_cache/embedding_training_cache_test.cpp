@@ -58,7 +58,8 @@ template <typename TypeKey>
 void do_upload_and_download_snapshot(int batch_num_train, TrainPSType_t ps_type,
                                      bool is_distributed, Optimizer_t opt_type = Optimizer_t::Adam,
                                      std::string local_path = "./",
-                                     HMemCacheConfig hc_config = HMemCacheConfig()) {
+                                     HMemCacheConfig hc_config = HMemCacheConfig(),
+                                     bool async_tiering = false) {
   Embedding_t embedding_type = is_distributed ? Embedding_t::DistributedSlotSparseEmbeddingHash
                                               : Embedding_t::LocalizedSlotSparseEmbeddingHash;
 
@@ -190,7 +191,8 @@ void do_upload_and_download_snapshot(int batch_num_train, TrainPSType_t ps_type,
   bool use_mixed_precision{false};
   std::shared_ptr<EmbeddingTrainingCache> embedding_training_cache(
       new EmbeddingTrainingCache({ps_type}, {embedding}, {snapshot_dst_file}, resource_manager,
-                                 use_mixed_precision, is_i64_key, {local_path}, {hc_config}));
+                                 use_mixed_precision, is_i64_key, {local_path}, {hc_config},
+                                 async_tiering));
 
   Timer timer_ps;
   timer_ps.start();
@@ -205,7 +207,15 @@ void do_upload_and_download_snapshot(int batch_num_train, TrainPSType_t ps_type,
   (void)read_file_and_output;
 
   // upload embedding table from disk according to keyset
-  embedding_training_cache->update(keyset_file_list);
+  if (async_tiering) {
+    // The second pass takes the prefetched vectors overlaid with the ones the first pass dumped
+    for (int pass = 0; pass < 2; pass++) {
+      embedding_training_cache->prefetch(keyset_file_list);
+      embedding_training_cache->update(keyset_file_list);
+    }
+  } else {
+    embedding_training_cache->update(keyset_file_list);
+  }
   embedding_training_cache->dump();
   embedding_training_cache->update_sparse_model_file();
 
@@ -296,6 +306,15 @@ TEST(embedding_training_cache_test, long_long_cache_distributed_adam) {
 TEST(embedding_training_cache_test, unsigned_host_localized) {
   do_upload_and_download_snapshot<unsigned>(20, TrainPSType_t::Staged, false);
 }
+TEST(embedding_training_cache_test, unsigned_host_distributed_async) {
+  do_upload_and_download_snapshot<unsigned>(20, TrainPSType_t::Staged, true, Optimizer_t::Adam,
+                                            "./", HMemCacheConfig(), true);
+}
+TEST(embedding_training_cache_test, long_long_cache_localized_async) {
+  HMemCacheConfig hc_config(1, 0.5, 0);
+  do_upload_and_download_snapshot<long long>(20, TrainPSType_t::Cached, false, Optimizer_t::Adam,
+                                             "./", hc_config, true);
+}
 TEST(embedding_training_cache_test, unsigned_cache_localized_sgd) {
   HMemCacheConfig hc_config(1, 0.5, 0);
   do_upload_and_download_snapshot<unsigned>(30, TrainPSType_t::Cached, false, Optimizer_t::SGD,
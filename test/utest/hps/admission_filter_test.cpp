@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <hps/admission_filter.hpp>
+#include <numeric>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+const size_t num_keys = 4096;
+
+std::vector<long long> make_keys(const long long first_key) {
+  std::vector<long long> keys(num_keys);
+  std::iota(keys.begin(), keys.end(), first_key);
+  return keys;
+}
+
+}  // namespace
+
+TEST(admission_filter_test, disabled) {
+  AdmissionFilter<long long> filter(AdmissionPolicy_t::Disabled, 0, num_keys);
+  const std::vector<long long> keys{make_keys(0)};
+  std::vector<uint64_t> admitted(num_keys);
+  ASSERT_EQ(filter.admit(keys.data(), num_keys, admitted.data()), num_keys);
+  for (size_t i = 0; i < num_keys; ++i) {
+    EXPECT_EQ(admitted[i], i);
+  }
+}
+
+TEST(admission_filter_test, frequency) {
+  AdmissionFilter<long long> filter(AdmissionPolicy_t::Frequency, 3, 16 * num_keys);
+  const std::vector<long long> keys{make_keys(0)};
+  std::vector<uint64_t> admitted(num_keys);
+  EXPECT_LT(filter.admit(keys.data(), num_keys, admitted.data()), num_keys / 100);
+  EXPECT_LT(filter.admit(keys.data(), num_keys, admitted.data()), num_keys / 100);
+  // The third miss of each key reaches the threshold.
+  EXPECT_EQ(filter.admit(keys.data(), num_keys, admitted.data()), num_keys);
+}
+
+TEST(admission_filter_test, probabilistic) {
+  AdmissionFilter<long long> filter(AdmissionPolicy_t::Probabilistic, 0.25f, num_keys);
+  const std::vector<long long> keys{make_keys(0)};
+  std::vector<uint64_t> admitted(num_keys);
+  const size_t num_admitted{filter.admit(keys.data(), num_keys, admitted.data())};
+  EXPECT_GT(num_admitted, num_keys / 8);
+  EXPECT_LT(num_admitted, num_keys / 2);
+  EXPECT_EQ(filter.num_rejected_keys(), num_keys - num_admitted);
+  for (size_t i = 1; i < num_admitted; ++i) {
+    EXPECT_LT(admitted[i - 1], admitted[i]);
+  }
+}
+
+TEST(admission_filter_test, doorkeeper) {
+  AdmissionFilter<long long> filter(AdmissionPolicy_t::Doorkeeper, 0, 16 * num_keys);
+  const std::vector<long long> keys{make_keys(0)};
+  std::vector<uint64_t> admitted(num_keys);
+  // One-off keys are rejected (except for false positives), repeated keys are admitted.
+  EXPECT_LT(filter.admit(keys.data(), num_keys, admitted.data()), num_keys / 20);
+  EXPECT_EQ(filter.admit(keys.data(), num_keys, admitted.data()), num_keys);
+
+  // A scan of new keys does not get in either.
+  const std::vector<long long> scan{make_keys(num_keys)};
+  EXPECT_LT(filter.admit(scan.data(), num_keys, admitted.data()), num_keys / 20);
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <hps/cache_capacity_balancer.hpp>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+TEST(cache_ghost_list, counts_keys_that_miss_again) {
+  CacheGhostList ghosts(4);
+  const std::vector<long long> first{1, 2, 3};
+  ghosts.record(first.data(), first.size());
+  EXPECT_EQ(ghosts.take_hits(), 0u);
+
+  const std::vector<long long> second{2, 3, 4};
+  ghosts.record(second.data(), second.size());
+  EXPECT_EQ(ghosts.take_hits(), 2u);
+  EXPECT_EQ(ghosts.take_hits(), 0u);
+}
+
+TEST(cache_ghost_list, forgets_the_least_recent_keys) {
+  CacheGhostList ghosts(2);
+  const std::vector<unsigned int> keys{1, 2, 3};
+  ghosts.record(keys.data(), keys.size());
+  const std::vector<unsigned int> again{1};
+  ghosts.record(again.data(), again.size());
+  EXPECT_EQ(ghosts.take_hits(), 0u);
+
+  // Shrinking keeps only 1, which 3 then replaces.
+  ghosts.set_capacity(1);
+  const std::vector<unsigned int> evicting{3};
+  ghosts.record(evicting.data(), evicting.size());
+  ghosts.record(again.data(), again.size());
+  EXPECT_EQ(ghosts.take_hits(), 0u);
+  EXPECT_EQ(ghosts.capacity(), 1u);
+}
+
+TEST(rebalance_cache_sets, moves_sets_to_the_highest_gain) {
+  const std::vector<size_t> num_sets{100, 100, 100};
+  const std::vector<size_t> set_bytes{1000, 1000, 1000};
+  const std::vector<size_t> new_num_sets =
+      rebalance_cache_sets(num_sets, set_bytes, {1.0, 5.0, 2.0}, 0.1);
+  EXPECT_EQ(new_num_sets, (std::vector<size_t>{90, 110, 100}));
+}
+
+TEST(rebalance_cache_sets, keeps_the_byte_budget) {
+  // One set of the receiver costs three of the donor.
+  const std::vector<size_t> num_sets{10, 10};
+  const std::vector<size_t> set_bytes{3000, 1000};
+  const std::vector<size_t> new_num_sets =
+      rebalance_cache_sets(num_sets, set_bytes, {4.0, 1.0}, 0.1);
+  EXPECT_EQ(new_num_sets, (std::vector<size_t>{11, 7}));
+  EXPECT_LE(new_num_sets[0] * set_bytes[0] + new_num_sets[1] * set_bytes[1],
+            num_sets[0] * set_bytes[0] + num_sets[1] * set_bytes[1]);
+}
+
+TEST(rebalance_cache_sets, holds_without_a_clear_gain) {
+  const std::vector<size_t> num_sets{100, 100};
+  const std::vector<size_t> set_bytes{1000, 1000};
+  EXPECT_EQ(rebalance_cache_sets(num_sets, set_bytes, {1.0, 1.5}, 0.1), num_sets);
+  EXPECT_EQ(rebalance_cache_sets(num_sets, set_bytes, {0.0, 0.0}, 0.1), num_sets);
+  // Every table keeps a set.
+  EXPECT_EQ(rebalance_cache_sets({100, 1}, set_bytes, {5.0, 0.0}, 0.1),
+            (std::vector<size_t>{100, 1}));
+}
+
+}  // namespace
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <hps/cache_key_log.hpp>
+#include <string>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+const std::string log_path{"cache_key_log_test.bin"};
+
+TEST(cache_key_log, round_trip) {
+  const std::vector<std::string> table_names{"sparse_embedding1", "sparse_embedding2", "empty"};
+  const std::vector<std::vector<long long>> keys{{1, 5, 1LL << 40}, {7}, {}};
+  CacheKeyLog<long long>::write(log_path, table_names, keys);
+
+  const CacheKeyLog<long long> log(log_path);
+  EXPECT_EQ(log.num_tables(), 3u);
+  for (size_t i = 0; i < table_names.size(); i++) {
+    ASSERT_NE(log.keys(table_names[i]), nullptr);
+    EXPECT_EQ(*log.keys(table_names[i]), keys[i]);
+  }
+  EXPECT_EQ(log.keys("sparse_embedding3"), nullptr);
+  std::filesystem::remove(log_path);
+}
+
+TEST(cache_key_log, is_independent_of_the_key_type) {
+  CacheKeyLog<unsigned int>::write(log_path, {"table"}, {{3, 4294967295u}});
+  const CacheKeyLog<long long> log(log_path);
+  ASSERT_NE(log.keys("table"), nullptr);
+  EXPECT_EQ(*log.keys("table"), (std::vector<long long>{3, 4294967295LL}));
+
+  CacheKeyLog<long long>::write(log_path, {"table"}, {{3, 9}});
+  const CacheKeyLog<unsigned int> narrow_log(log_path);
+  ASSERT_NE(narrow_log.keys("table"), nullptr);
+  EXPECT_EQ(*narrow_log.keys("table"), (std::vector<unsigned int>{3, 9}));
+  std::filesystem::remove(log_path);
+}
+
+TEST(cache_key_log, rejects_broken_files) {
+  EXPECT_ANY_THROW(CacheKeyLog<long long>("no_such_cache_key_log.bin"));
+
+  CacheKeyLog<long long>::write(log_path, {"table"}, {{1, 2, 3, 4}});
+  std::filesystem::resize_file(log_path, std::filesystem::file_size(log_path) - 1);
+  EXPECT_ANY_THROW(CacheKeyLog<long long>{log_path});
+
+  std::ofstream(log_path, std::ios::binary | std::ios::trunc) << "not a cache key log";
+  EXPECT_ANY_THROW(CacheKeyLog<long long>{log_path});
+  std::filesystem::remove(log_path);
+}
+
+}  // namespace
@@ -17,17 +17,24 @@
 #include <cuda_profiler_api.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <core23/logger.hpp>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <hps/database_backend.hpp>
+#include <hps/distributed_hash_map_backend.hpp>
 #include <hps/hash_map_backend.hpp>
 #include <hps/hier_parameter_server_base.hpp>
 #include <hps/mp_hash_map_backend.hpp>
+#include <hps/near_cache_backend.hpp>
 #include <hps/redis_backend.hpp>
 #include <hps/rocksdb_backend.hpp>
 #include <memory>
+#include <numeric>
+#include <thread>
 #include <vector>
 
 using namespace HugeCTR;
@@ -119,6 +126,142 @@ void db_backend_insert_fetch_test(const DatabaseType_t database_type) {
   }
 }
 
+template <typename Key>
+void db_backend_concurrent_insert_fetch_test(const DatabaseType_t database_type) {
+  std::unique_ptr<DatabaseBackendBase<Key>> db{make_db<Key>(database_type)};
+
+  const std::string& tag{HierParameterServerBase::make_tag_name("concurrent", "test")};
+  constexpr Key num_keys{10000};
+  constexpr size_t num_writers{2};
+  constexpr size_t num_readers{4};
+
+  // Seed first half of the keys.
+  {
+    std::vector<Key> keys(num_keys / 2);
+    std::vector<double> values(keys.size());
+    for (Key k{0}; k < num_keys / 2; ++k) {
+      keys[k] = k;
+      values[k] = static_cast<double>(k * k);
+    }
+    db->insert(tag, keys.size(), keys.data(), reinterpret_cast<const char*>(values.data()),
+               sizeof(double), sizeof(double));
+  }
+
+  // Writers keep inserting the second half, while readers fetch the first half.
+  std::vector<std::thread> threads;
+  for (size_t w{0}; w < num_writers; ++w) {
+    threads.emplace_back([&, w]() {
+      for (Key k{num_keys / 2 + static_cast<Key>(w)}; k < num_keys; k += num_writers) {
+        const double kk{static_cast<double>(k * k)};
+        db->insert(tag, 1, &k, reinterpret_cast<const char*>(&kk), sizeof(double),
+                   sizeof(double));
+      }
+    });
+  }
+  for (size_t r{0}; r < num_readers; ++r) {
+    threads.emplace_back([&]() {
+      std::vector<Key> keys(num_keys / 2);
+      std::iota(keys.begin(), keys.end(), 0);
+      std::vector<double> values(keys.size());
+      for (size_t n{0}; n < 10; ++n) {
+        db->fetch(tag, keys.size(), keys.data(), reinterpret_cast<char*>(values.data()),
+                  sizeof(double), [&](size_t index) { FAIL(); });
+        for (size_t i{0}; i < keys.size(); ++i) {
+          EXPECT_DOUBLE_EQ(values[i], static_cast<double>(keys[i] * keys[i]));
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(db->size(tag), static_cast<size_t>(num_keys));
+}
+
+template <typename Key>
+void db_backend_hash_map_compaction_test() {
+  HashMapBackendParams params;
+  params.max_batch_size = 100;
+  params.num_partitions = 1;
+  params.allocation_rate = 100 * sizeof(double);
+  params.overflow_margin = 1000;
+  params.overflow_resolution_target = 0.2;
+  params.overflow_policy = DatabaseOverflowPolicy_t::EvictOldest;
+  HashMapBackend<Key> db(params);
+
+  const std::string& tag{HierParameterServerBase::make_tag_name("compaction", "test")};
+
+  // Fill up the table until overflow handling kicks in.
+  std::vector<Key> keys(params.overflow_margin + 1);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::vector<double> values(keys.begin(), keys.end());
+  for (size_t i{0}; i < keys.size(); i += 100) {
+    const size_t n{std::min<size_t>(keys.size() - i, 100)};
+    db.insert(tag, n, &keys[i], reinterpret_cast<const char*>(&values[i]), sizeof(double),
+              sizeof(double));
+  }
+
+  // After evicting 80% of the values, the table should have been compacted. That is, there should
+  // be less than one page worth of free slots.
+  const size_t size{db.size(tag)};
+  const HashMapBackendMemoryStats& stats{db.memory_stats(tag)};
+  EXPECT_LT(size, keys.size());
+  EXPECT_EQ(stats.num_slots - stats.num_free_slots, size);
+  EXPECT_LE(stats.fragmentation(), params.compaction_threshold);
+  EXPECT_LT(stats.num_free_slots, stats.num_slots / stats.num_pages);
+
+  // Relocated values must still be intact.
+  std::vector<double> fetched(keys.size());
+  const size_t hit_count{db.fetch(
+      tag, keys.size(), keys.data(), reinterpret_cast<char*>(fetched.data()), sizeof(double),
+      [](size_t) {}, std::chrono::nanoseconds::zero())};
+  EXPECT_EQ(hit_count, size);
+  for (size_t i{0}; i < keys.size(); ++i) {
+    if (fetched[i] != 0) {
+      EXPECT_DOUBLE_EQ(fetched[i], values[i]);
+    }
+  }
+}
+
+template <typename Key>
+void db_backend_hash_map_clock_eviction_test() {
+  HashMapBackendParams params;
+  params.num_partitions = 2;
+  params.overflow_margin = 1000;
+  params.overflow_resolution_target = 0.5;
+  params.overflow_policy = DatabaseOverflowPolicy_t::EvictClock;
+  std::unique_ptr<DatabaseBackendBase<Key>> db{std::make_unique<HashMapBackend<Key>>(params)};
+
+  const std::string& tag{HierParameterServerBase::make_tag_name("clock", "test")};
+
+  std::vector<Key> keys(3000);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::vector<double> values(keys.begin(), keys.end());
+
+  // The first 100 keys are hot and accessed after each insertion. Cold keys are never accessed.
+  constexpr size_t num_hot_keys{100};
+  std::vector<double> fetched(num_hot_keys);
+  const auto& fetch_hot_keys{[&]() {
+    return db->fetch(
+        tag, num_hot_keys, keys.data(), reinterpret_cast<char*>(fetched.data()), sizeof(double),
+        [](size_t) {}, std::chrono::nanoseconds::zero());
+  }};
+
+  for (size_t i{0}; i < keys.size(); i += num_hot_keys) {
+    db->insert(tag, num_hot_keys, &keys[i], reinterpret_cast<const char*>(&values[i]),
+               sizeof(double), sizeof(double));
+    fetch_hot_keys();
+  }
+
+  // Overflow handling must have evicted cold keys only.
+  EXPECT_LT(db->size(tag), keys.size());
+  EXPECT_EQ(fetch_hot_keys(), num_hot_keys);
+  for (size_t i{0}; i < num_hot_keys; ++i) {
+    EXPECT_DOUBLE_EQ(fetched[i], values[i]);
+  }
+}
+
 template <typename Key>
 void db_backend_multi_evict_test(const DatabaseType_t database_type) {
   std::unique_ptr<DatabaseBackendBase<Key>> db{make_db<Key>(database_type)};
@@ -249,6 +392,266 @@ void db_backend_dump_test(DatabaseType_t database_type) {
   }
 }
 
+template <typename Key>
+void db_backend_near_cache_test() {
+  // Another process of the shared database is emulated by writing to the backend directly.
+  auto backend_ptr{make_db<Key>(DatabaseType_t::HashMap)};
+  DatabaseBackendBase<Key>* const backend{backend_ptr.get()};
+  HashMapBackendParams params;
+  params.num_partitions = 4;
+  params.overflow_margin = 1000;
+  NearCacheBackend<Key> db(std::move(backend_ptr), params, std::chrono::milliseconds{200});
+
+  const std::string& tag{HierParameterServerBase::make_tag_name("near_cache", "test")};
+  std::vector<Key> keys(100);
+  std::iota(keys.begin(), keys.end(), 0);
+  const auto insert{[&](DatabaseBackendBase<Key>& target, const double offset) {
+    std::vector<double> values(keys.size());
+    std::transform(keys.begin(), keys.end(), values.begin(),
+                   [offset](const Key k) -> double { return k + offset; });
+    target.insert(tag, keys.size(), keys.data(), reinterpret_cast<char*>(values.data()),
+                  sizeof(double), sizeof(double));
+  }};
+  const auto expect_values{[&](const double offset) {
+    std::vector<Key> query{keys};
+    query.push_back(1000000);
+    std::vector<double> values(query.size());
+    size_t num_misses{0};
+    EXPECT_EQ(db.fetch(tag, query.size(), query.data(), reinterpret_cast<char*>(values.data()),
+                       sizeof(double), [&](size_t index) { ++num_misses; },
+                       std::chrono::nanoseconds::zero()),
+              keys.size());
+    EXPECT_EQ(num_misses, 1);
+    for (size_t i{0}; i < keys.size(); ++i) {
+      EXPECT_DOUBLE_EQ(values[i], keys[i] + offset);
+    }
+  }};
+
+  // Inserts through the near cache are written through.
+  insert(db, 0);
+  expect_values(0);
+  EXPECT_EQ(backend->size(tag), keys.size());
+
+  // The fetched values are served by the near cache until they are invalidated.
+  insert(*backend, 1);
+  expect_values(0);
+  EXPECT_EQ(db.invalidate(tag, keys.size(), keys.data()), keys.size());
+  expect_values(1);
+
+  // Or until they expire.
+  insert(*backend, 2);
+  expect_values(1);
+  std::this_thread::sleep_for(std::chrono::milliseconds{250});
+  expect_values(2);
+
+  // Evicted keys are gone from both.
+  EXPECT_EQ(db.evict(tag, keys.size(), keys.data()), keys.size());
+  EXPECT_EQ(backend->size(tag), 0);
+}
+
+template <typename Key>
+void db_backend_hash_map_value_format_test() {
+  const std::string& fp16_tag{HierParameterServerBase::make_tag_name("value_format", "fp16")};
+  const std::string& bf16_tag{HierParameterServerBase::make_tag_name("value_format", "bf16")};
+  const std::string& fp8_tag{HierParameterServerBase::make_tag_name("value_format", "fp8")};
+  HashMapBackendParams params;
+  params.num_partitions = 4;
+  params.allocation_rate = 64 * 1024;
+  params.value_format = DatabaseValueFormat_t::Float16;
+  params.table_value_formats[bf16_tag] = DatabaseValueFormat_t::BFloat16;
+  params.table_value_formats[fp8_tag] = DatabaseValueFormat_t::FP8;
+  HashMapBackend<Key> db(params);
+
+  constexpr size_t dim{32};
+  std::vector<Key> keys(1000);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::vector<float> values(keys.size() * dim);
+  for (size_t i{0}; i < values.size(); ++i) {
+    values[i] = std::sin(static_cast<float>(i)) * static_cast<float>(i % 7);
+  }
+
+  // Relative accuracy of each format (the fp8 error is bounded by the largest element of the row).
+  for (const auto& [tag, tolerance] : {std::make_pair(fp16_tag, 1.f / 1024),
+                                       std::make_pair(bf16_tag, 1.f / 128),
+                                       std::make_pair(fp8_tag, 1.f / 8)}) {
+    EXPECT_EQ(db.insert(tag, keys.size(), keys.data(), reinterpret_cast<char*>(values.data()),
+                        dim * sizeof(float), dim * sizeof(float)),
+              keys.size());
+
+    std::vector<float> fetched(values.size());
+    EXPECT_EQ(db.fetch(tag, keys.size(), keys.data(), reinterpret_cast<char*>(fetched.data()),
+                       dim * sizeof(float), [](size_t) {}, std::chrono::nanoseconds::zero()),
+              keys.size());
+    for (size_t i{0}; i < keys.size(); ++i) {
+      const float* const row{&values[i * dim]};
+      const float amax{std::abs(*std::max_element(
+          row, &row[dim], [](float a, float b) { return std::abs(a) < std::abs(b); }))};
+      for (size_t j{0}; j < dim; ++j) {
+        const float bound{tag == fp8_tag ? amax : std::abs(row[j])};
+        EXPECT_NEAR(fetched[i * dim + j], row[j], bound * tolerance + 1e-6f);
+      }
+    }
+  }
+
+  // Each value page holds 2x (fp16, bf16) and ~3.5x (fp8) as many values.
+  const size_t fp32_slots_per_page{params.allocation_rate / (dim * sizeof(float))};
+  for (const std::string& tag : {fp16_tag, bf16_tag, fp8_tag}) {
+    const HashMapBackendMemoryStats stats{db.memory_stats(tag)};
+    const size_t ratio{tag == fp8_tag ? 3 : 2};
+    EXPECT_GE(stats.num_slots / stats.num_pages, fp32_slots_per_page * ratio);
+  }
+
+  // Only float vectors can be compressed.
+  std::vector<char> odd_values(keys.size() * 3);
+  EXPECT_ANY_THROW(db.insert(HierParameterServerBase::make_tag_name("value_format", "odd"),
+                             keys.size(), keys.data(), odd_values.data(), 3, 3));
+}
+
+template <typename Key>
+void db_backend_hash_map_parallel_dump_test(const bool direct_io) {
+  const std::string& tag0{HierParameterServerBase::make_tag_name("parallel_dump", "tbl0")};
+  const std::string& tag1{HierParameterServerBase::make_tag_name("parallel_dump", "tbl1")};
+  HashMapBackendParams params;
+  params.num_partitions = 7;
+  params.max_batch_size = 4096;
+  params.load_dump_num_threads = 5;
+  params.load_dump_direct_io = direct_io;
+  HashMapBackend<Key> db(params);
+
+  // An odd value size, so that the pairs straddle the blocks read with O_DIRECT.
+  constexpr size_t value_size{20};
+  std::vector<Key> keys(100003);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::vector<char> values(keys.size() * value_size);
+  for (size_t i{0}; i < values.size(); ++i) {
+    values[i] = static_cast<char>(i * 31 + i / value_size);
+  }
+  db.insert(tag0, keys.size(), keys.data(), values.data(), value_size, value_size);
+
+  EXPECT_EQ(db.dump(tag0, "parallel_dump.bin"), keys.size());
+  EXPECT_EQ(std::filesystem::file_size("parallel_dump.bin"),
+            4 * sizeof(uint32_t) + keys.size() * (sizeof(Key) + value_size));
+
+  EXPECT_EQ(db.load_dump(tag1, "parallel_dump.bin"), keys.size());
+  EXPECT_EQ(db.size(tag1), keys.size());
+  std::vector<char> fetched(values.size());
+  EXPECT_EQ(db.fetch(tag1, keys.size(), keys.data(), fetched.data(), value_size,
+                     [](size_t) { FAIL(); }, std::chrono::nanoseconds::zero()),
+            keys.size());
+  EXPECT_EQ(fetched, values);
+
+  // An empty table still gets a valid dump.
+  const std::string& tag2{HierParameterServerBase::make_tag_name("parallel_dump", "tbl2")};
+  EXPECT_EQ(db.dump(tag2, "parallel_dump_empty.bin"), 0u);
+  EXPECT_EQ(db.load_dump(tag2, "parallel_dump_empty.bin"), 0u);
+}
+
+#ifdef HCTR_USE_ROCKS_DB
+template <typename Key>
+void db_backend_rocksdb_bulk_load_test() {
+  RocksDBBackendParams params;
+  params.path = "/hugectr/Test_Data/rockdb_bulk_load";
+  params.bulk_load_file_size = 4096;  // Split the table into many ranges.
+  std::filesystem::remove_all(params.path);
+  RocksDBBackend<Key> db(params);
+
+  const std::string& tag{HierParameterServerBase::make_tag_name("bulk_load", "test")};
+  std::vector<Key> keys(10000);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::reverse(keys.begin(), keys.end());
+  std::vector<double> values(keys.size());
+  {
+    RocksDBBulkLoader<Key> loader(db, tag, keys.size(), sizeof(double));
+    // The later value of a key added twice wins.
+    std::fill(values.begin(), values.end(), -1);
+    loader.add(100, keys.data(), reinterpret_cast<char*>(values.data()), sizeof(double));
+    std::transform(keys.begin(), keys.end(), values.begin(),
+                   [](const Key k) -> double { return k * k; });
+    const size_t half{keys.size() / 2};
+    loader.add(half, keys.data(), reinterpret_cast<char*>(values.data()), sizeof(double));
+    loader.add(keys.size() - half, &keys[half], reinterpret_cast<char*>(&values[half]),
+               sizeof(double));
+    EXPECT_EQ(loader.finish(), keys.size());
+  }
+
+  keys.push_back(1000000);
+  std::vector<double> fetched(keys.size());
+  size_t num_misses{0};
+  EXPECT_EQ(db.fetch(tag, keys.size(), keys.data(), reinterpret_cast<char*>(fetched.data()),
+                     sizeof(double), [&](size_t index) { ++num_misses; },
+                     std::chrono::nanoseconds::zero()),
+            keys.size() - 1);
+  EXPECT_EQ(num_misses, 1);
+  for (size_t i{0}; i < values.size(); ++i) {
+    EXPECT_DOUBLE_EQ(fetched[i], values[i]);
+  }
+  db.evict(tag);
+}
+#endif  // HCTR_USE_ROCKS_DB
+
+#ifdef HCTR_USE_RDMA
+template <typename Key>
+void db_backend_distributed_hash_map_test() {
+  // Two hosts in one process, connected through the local RDMA device.
+  std::vector<std::future<std::unique_ptr<DistributedHashMapBackend<Key>>>> futures;
+  for (size_t rank{0}; rank < 2; ++rank) {
+    futures.emplace_back(std::async(std::launch::async, [rank]() {
+      DistributedHashMapBackendParams params;
+      params.hosts = {"127.0.0.1:7600", "127.0.0.1:7601"};
+      params.rank = rank;
+      params.message_size = 4096;  // Split the batches into several requests.
+      params.connect_timeout = 30;
+      return std::make_unique<DistributedHashMapBackend<Key>>(params);
+    }));
+  }
+  std::vector<std::unique_ptr<DistributedHashMapBackend<Key>>> dbs;
+  for (auto& future : futures) {
+    dbs.emplace_back(future.get());
+  }
+
+  const std::string& tag{HierParameterServerBase::make_tag_name("distributed", "test")};
+  std::vector<Key> keys(2000);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::vector<double> values(keys.size());
+  std::transform(keys.begin(), keys.end(), values.begin(),
+                 [](const Key k) -> double { return k * k; });
+  EXPECT_EQ(dbs[0]->insert(tag, keys.size(), keys.data(), reinterpret_cast<char*>(values.data()),
+                           sizeof(double), sizeof(double)),
+            keys.size());
+
+  // Both hosts own some of the keys, and see all of them.
+  EXPECT_GT(dbs[0]->size(tag), 0);
+  EXPECT_GT(dbs[1]->size(tag), 0);
+  for (const auto& db : dbs) {
+    EXPECT_EQ(db->size(tag), keys.size());
+    EXPECT_EQ(db->contains(tag, keys.size(), keys.data(), std::chrono::nanoseconds::zero()),
+              keys.size());
+  }
+
+  // Fetch from the other host, including missing keys.
+  keys.push_back(1000000);
+  std::vector<double> fetched(keys.size());
+  size_t num_misses{0};
+  EXPECT_EQ(dbs[1]->fetch(tag, keys.size(), keys.data(), reinterpret_cast<char*>(fetched.data()),
+                          sizeof(double), [&](size_t index) {
+                            EXPECT_EQ(index, keys.size() - 1);
+                            ++num_misses;
+                          },
+                          std::chrono::nanoseconds::zero()),
+            keys.size() - 1);
+  EXPECT_EQ(num_misses, 1);
+  for (size_t i{0}; i < values.size(); ++i) {
+    EXPECT_DOUBLE_EQ(fetched[i], values[i]);
+  }
+
+  EXPECT_EQ(dbs[1]->find_tables("distributed"), std::vector<std::string>{tag});
+  EXPECT_EQ(dbs[1]->evict(tag, 100, keys.data()), 100);
+  EXPECT_EQ(dbs[0]->size(tag), keys.size() - 101);
+  EXPECT_EQ(dbs[0]->evict(tag), keys.size() - 101);
+  EXPECT_EQ(dbs[1]->size(tag), 0);
+}
+#endif  // HCTR_USE_RDMA
+
 }  // namespace
 
 TEST(db_backend_insert_fetch_test, HashMap) {
@@ -261,6 +664,18 @@ TEST(db_backend_insert_fetch_test, Rocksdb) {
   db_backend_insert_fetch_test<long long>(DatabaseType_t::RocksDB);
 }
 
+TEST(db_backend_concurrent_insert_fetch_test, HashMap) {
+  db_backend_concurrent_insert_fetch_test<long long>(DatabaseType_t::HashMap);
+}
+
+TEST(db_backend_hash_map_compaction_test, HashMap) {
+  db_backend_hash_map_compaction_test<long long>();
+}
+
+TEST(db_backend_hash_map_clock_eviction_test, HashMap) {
+  db_backend_hash_map_clock_eviction_test<long long>();
+}
+
 TEST(db_backend_multi_evict, HashMap) {
   db_backend_multi_evict_test<long long>(DatabaseType_t::HashMap);
 }
@@ -276,3 +691,26 @@ TEST(db_backend_dump_load, RedisCluster) {
   db_backend_dump_test<long long>(DatabaseType_t::RedisCluster);
 }
 TEST(db_backend_dump_load, RocksDB) { db_backend_dump_test<long long>(DatabaseType_t::RocksDB); }
+
+TEST(db_backend_near_cache_test, HashMap) { db_backend_near_cache_test<long long>(); }
+
+TEST(db_backend_hash_map_value_format_test, HashMap) {
+  db_backend_hash_map_value_format_test<long long>();
+}
+
+TEST(db_backend_hash_map_parallel_dump_test, HashMap) {
+  db_backend_hash_map_parallel_dump_test<long long>(false);
+}
+TEST(db_backend_hash_map_parallel_dump_test, HashMapDirectIO) {
+  db_backend_hash_map_parallel_dump_test<long long>(true);
+}
+
+#ifdef HCTR_USE_ROCKS_DB
+TEST(db_backend_rocksdb_bulk_load_test, RocksDB) { db_backend_rocksdb_bulk_load_test<long long>(); }
+#endif  // HCTR_USE_ROCKS_DB
+
+#ifdef HCTR_USE_RDMA
+TEST(db_backend_distributed_hash_map_test, DistributedHashMap) {
+  db_backend_distributed_hash_map_test<long long>();
+}
+#endif  // HCTR_USE_RDMA
@@ -99,7 +99,8 @@ void parameter_server_test(const std::string& config_file, const std::string& mo
                            const std::vector<size_t>& embedding_feature_num,
                            const std::vector<size_t>& slot_num_per_table, size_t max_batch_size,
                            float hit_rate_threshold, size_t max_iterations,
-                           DatabaseType_t database_t = DatabaseType_t::ParallelHashMap) {
+                           DatabaseType_t database_t = DatabaseType_t::ParallelHashMap,
+                           float refresh_time_budget_ms = 0) {
   VolatileDatabaseParams dis_database;
   PersistentDatabaseParams per_database;
   switch (database_t) {
@@ -125,6 +126,10 @@ void parameter_server_test(const std::string& config_file, const std::string& mo
                               0, true, 1, true);
   infer_param.volatile_db = dis_database;
   infer_param.persistent_db = per_database;
+  if (refresh_time_budget_ms > 0) {
+    infer_param.cache_refresh_percentage_per_iteration = 0.1f;
+    infer_param.refresh_time_budget_ms = refresh_time_budget_ms;
+  }
   std::vector<InferenceParams> inference_params{infer_param};
   std::vector<std::string> model_config_path{config_file};
 
@@ -248,8 +253,13 @@ void parameter_server_test(const std::string& config_file, const std::string& mo
                             vec_length_per_batch * sizeof(float), cudaMemcpyDeviceToHost));
   compare_lookup(h_embeddingvector_gt, h_embeddingvector, vec_length_per_batch, 0.01f);
 
-  // Refresh embedding cache
-  parameter_server->refresh_embedding_cache(model, 0);
+  // Refresh embedding cache. With a time budget, each call refreshes a part of the cache and the
+  // next call continues there.
+  const size_t num_refreshes = refresh_time_budget_ms > 0 ? 16 : 1;
+  for (size_t i = 0; i < num_refreshes; i++) {
+    parameter_server->refresh_embedding_cache(model, 0);
+    embedding_cache_look_up();
+  }
 
   // Embedding cache lookup and check results with ground truth
   embedding_cache_look_up();
@@ -322,6 +332,12 @@ TEST(parameter_server, CPU_look_up_1024x05x100) {
                                    slot_num_per_table_wdl, 1024, 0.5f, 100,
                                    DatabaseType_t::ParallelHashMap);
 }
+TEST(parameter_server, CPU_look_up_1024x00x100_budgeted_refresh) {
+  parameter_server_test<long long>(network, model_name, dense_model, sparse_models,
+                                   embedding_vec_size_wdl, embedding_featre_num_wdl,
+                                   slot_num_per_table_wdl, 1024, 0.f, 100,
+                                   DatabaseType_t::ParallelHashMap, 0.01f);
+}
 TEST(parameter_server, Rocksdb_look_up_1024x00x100) {
   parameter_server_test<long long>(network, model_name, dense_model, sparse_models,
                                    embedding_vec_size_wdl, embedding_featre_num_wdl,
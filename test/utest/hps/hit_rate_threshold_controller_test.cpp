@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <hps/hit_rate_threshold_controller.hpp>
+
+using namespace HugeCTR;
+
+namespace {
+
+const size_t window = 32;
+
+// Half of the lookups hit 50% (100 misses), the other half 90% (10 misses). Resolving a missing key
+// costs 1 us.
+float learned_threshold(const double latency_budget_us) {
+  HitRateThresholdController controller(0.8f, latency_budget_us, window, window);
+  controller.record_insert(100, 100.0);
+  for (size_t i = 0; i < window; ++i) {
+    if (i % 2 == 0) {
+      controller.record_lookup(0.5, 100);
+    } else {
+      controller.record_lookup(0.9, 10);
+    }
+  }
+  return controller.threshold();
+}
+
+}  // namespace
+
+TEST(hit_rate_threshold_controller_test, initial_threshold) {
+  HitRateThresholdController controller(0.8f, 10.0, window, window);
+  // Without any measured insert cost, the configured threshold is kept.
+  for (size_t i = 0; i < window; ++i) {
+    controller.record_lookup(0.5, 100);
+  }
+  EXPECT_EQ(controller.threshold(), 0.8f);
+}
+
+TEST(hit_rate_threshold_controller_test, all_lookups_affordable) {
+  // 16 * 100 us + 16 * 10 us = 55 us per lookup.
+  EXPECT_GT(learned_threshold(55.0), 0.9f);
+}
+
+TEST(hit_rate_threshold_controller_test, worst_lookups_affordable) {
+  const float threshold = learned_threshold(50.0);
+  EXPECT_GT(threshold, 0.5f);
+  EXPECT_LE(threshold, 0.9f);
+}
+
+TEST(hit_rate_threshold_controller_test, nothing_affordable) {
+  EXPECT_EQ(learned_threshold(1.0), 0.f);
+}
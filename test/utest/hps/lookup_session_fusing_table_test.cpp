@@ -116,13 +116,15 @@ void generate_config_file(const std::string& ps_config_file, bool i64_input_key,
                           const std::vector<std::string>& sparse_files,
                           const std::vector<size_t>& embedding_vecsize_per_table,
                           const std::vector<size_t>& maxnum_catfeature_query_per_table_per_sample,
-                          const std::string& embedding_cache_type) {
+                          const std::string& embedding_cache_type,
+                          float lookup_batching_window_us = 0, bool enable_pagelock = false) {
   EXPECT_EQ(sparse_files.size(), embedding_vecsize_per_table.size());
   EXPECT_EQ(sparse_files.size(), maxnum_catfeature_query_per_table_per_sample.size());
 
   nlohmann::json ps_config;
   ps_config["supportlonglong"] = i64_input_key;
-  ps_config["fuse_embedding_table"] = true;
+  // Lookup batching doesn't support fused tables
+  ps_config["fuse_embedding_table"] = lookup_batching_window_us == 0;
 
   nlohmann::json model_config;
   {
@@ -148,6 +150,8 @@ void generate_config_file(const std::string& ps_config_file, bool i64_input_key,
     model_config["gpucache"] = true;
     model_config["embedding_cache_type"] = embedding_cache_type;
     model_config["use_context_stream"] = true;
+    model_config["lookup_batching_window_us"] = lookup_batching_window_us;
+    model_config["enable_pagelock"] = enable_pagelock;
   }
 
   ps_config["models"] = std::vector<nlohmann::json>{model_config};
@@ -192,11 +196,13 @@ void lookup_session_fusing_table_test(
     const std::vector<long long>& key_offset_per_table,
     const std::vector<size_t>& embedding_vecsize_per_table,
     const std::vector<size_t>& maxnum_catfeature_query_per_table_per_sample,
-    bool test_internal_multithreading, const std::string& embedding_cache_type) {
+    bool test_internal_multithreading, const std::string& embedding_cache_type,
+    bool enable_pagelock = false) {
   bool i64_input_key = std::is_same<long long, TypeHashKey>::value;
   generate_embedding_tables(sparse_files, embedding_vecsize_per_table, key_offset_per_table);
   generate_config_file(ps_config_file, i64_input_key, sparse_files, embedding_vecsize_per_table,
-                       maxnum_catfeature_query_per_table_per_sample, embedding_cache_type);
+                       maxnum_catfeature_query_per_table_per_sample, embedding_cache_type, 0,
+                       enable_pagelock);
 
   // Parse configuration file
   parameter_server_config ps_config{ps_config_file};
@@ -318,6 +324,83 @@ void lookup_session_fusing_table_test(
   }
 }
 
+// Concurrent callers look up small requests from the same table, which are merged into batches.
+template <typename TypeHashKey>
+void lookup_session_batching_test(const std::string& ps_config_file,
+                                  const std::string& sparse_file, size_t num_callers,
+                                  size_t num_keys_per_caller, bool use_caller_stream) {
+  const std::vector<long long> key_offset_per_table{0, 10000};
+  const std::vector<size_t> embedding_vecsize_per_table{32};
+  const size_t emb_vec_size = embedding_vecsize_per_table[0];
+  bool i64_input_key = std::is_same<long long, TypeHashKey>::value;
+  generate_embedding_tables({sparse_file}, embedding_vecsize_per_table, key_offset_per_table);
+  generate_config_file(ps_config_file, i64_input_key, {sparse_file}, embedding_vecsize_per_table,
+                       {10}, "dynamic", 200);
+
+  parameter_server_config ps_config{ps_config_file};
+  auto inference_params = ps_config.inference_params_array[0];
+  auto device_id = inference_params.deployed_devices[0];
+  auto parameter_server = HierParameterServerBase::create(ps_config);
+  auto embedding_cache =
+      parameter_server->get_embedding_cache(inference_params.model_name, device_id);
+  auto lookup_session = LookupSessionBase::create(inference_params, embedding_cache);
+
+  std::map<size_t, std::map<TypeHashKey, std::vector<float>>> embeddings_per_table;
+  get_embedding_per_table({sparse_file}, embedding_vecsize_per_table, embeddings_per_table);
+
+  CudaDeviceContext context(device_id);
+  std::vector<std::vector<TypeHashKey>> h_keys(num_callers);
+  std::vector<TypeHashKey*> d_keys(num_callers);
+  std::vector<float*> d_vectors(num_callers);
+  std::vector<cudaStream_t> streams(num_callers);
+  for (size_t c{0}; c < num_callers; ++c) {
+    h_keys[c].resize(num_keys_per_caller);
+    for (auto& key : h_keys[c]) {
+      key = static_cast<TypeHashKey>(rand() % key_offset_per_table[1]);
+    }
+    HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void**>(&d_keys[c]),
+                              num_keys_per_caller * sizeof(TypeHashKey)));
+    HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void**>(&d_vectors[c]),
+                              num_keys_per_caller * emb_vec_size * sizeof(float)));
+    HCTR_LIB_THROW(cudaMemcpy(d_keys[c], h_keys[c].data(),
+                              num_keys_per_caller * sizeof(TypeHashKey), cudaMemcpyHostToDevice));
+    HCTR_LIB_THROW(cudaStreamCreateWithFlags(&streams[c], cudaStreamNonBlocking));
+  }
+
+  for (size_t iter{0}; iter < 10; ++iter) {
+    std::vector<std::thread> callers;
+    for (size_t c{0}; c < num_callers; ++c) {
+      callers.emplace_back([&, c] {
+        if (use_caller_stream) {
+          lookup_session->lookup_from_device(d_keys[c], d_vectors[c], num_keys_per_caller, 0,
+                                             streams[c]);
+          HCTR_LIB_THROW(cudaStreamSynchronize(streams[c]));
+        } else {
+          lookup_session->lookup_from_device(d_keys[c], d_vectors[c], num_keys_per_caller, 0);
+        }
+      });
+    }
+    for (auto& caller : callers) {
+      caller.join();
+    }
+    for (size_t c{0}; c < num_callers; ++c) {
+      std::vector<float> h_vectors(num_keys_per_caller * emb_vec_size);
+      std::vector<float> h_vectors_gt(num_keys_per_caller * emb_vec_size);
+      HCTR_LIB_THROW(cudaMemcpy(h_vectors.data(), d_vectors[c], h_vectors.size() * sizeof(float),
+                                cudaMemcpyDeviceToHost));
+      lookup_from_ground_truth(h_vectors_gt.data(), h_keys[c].data(), num_keys_per_caller,
+                               embeddings_per_table[0]);
+      compare_lookup(h_vectors_gt.data(), h_vectors.data(), h_vectors.size(), 0.001);
+    }
+  }
+
+  for (size_t c{0}; c < num_callers; ++c) {
+    HCTR_LIB_THROW(cudaStreamDestroy(streams[c]));
+    HCTR_LIB_THROW(cudaFree(d_keys[c]));
+    HCTR_LIB_THROW(cudaFree(d_vectors[c]));
+  }
+}
+
 }  // end namespace
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -351,6 +434,15 @@ TEST(lookup_session, static_table_8_i64) {
       {128, 32, 32, 128, 128, 128, 32, 128}, {10, 20, 10, 10, 30, 20, 10, 30}, false, "static");
 }
 
+// The vectors in host memory, of sizes gathered in one, several or no float4 chunks per lane
+TEST(lookup_session, static_table_4_pagelock) {
+  lookup_session_fusing_table_test<long long>(
+      "fusion_utest.json",
+      {"fusion_utest/table0", "fusion_utest/table1", "fusion_utest/table2", "fusion_utest/table3"},
+      {0, 10000, 20000, 30000, 40000}, {128, 260, 17, 32}, {10, 20, 10, 30}, false, "static",
+      true);
+}
+
 TEST(lookup_session, static_table_1_internal_multithreading) {
   lookup_session_fusing_table_test<unsigned int>("fusion_utest.json", {"fusion_utest/table0"},
                                                  {0, 10000}, {128}, {10}, true, "static");
@@ -495,4 +587,22 @@ TEST(lookup_session, uvm_table_8_i64_internal_multithreading) {
        "fusion_utest/table4", "fusion_utest/table5", "fusion_utest/table6", "fusion_utest/table7"},
       {0, 10000, 20000, 30000, 40000, 50000, 60000, 70000, 80000},
       {128, 32, 32, 128, 128, 128, 32, 128}, {10, 20, 10, 10, 30, 20, 10, 30}, true, "uvm");
-}
\ No newline at end of file
+}
+//////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Lookup Batching Test
+//////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST(lookup_session, batching_32_callers) {
+  lookup_session_batching_test<unsigned int>("batching_utest.json", "batching_utest/table0", 32,
+                                             40, false);
+}
+
+TEST(lookup_session, batching_32_callers_i64_caller_stream) {
+  lookup_session_batching_test<long long>("batching_utest.json", "batching_utest/table0", 32, 40,
+                                          true);
+}
+
+TEST(lookup_session, batching_over_key_budget) {
+  // 8 callers of 1000 keys exceed the budget of 256 x 10 keys, so they form several batches
+  lookup_session_batching_test<long long>("batching_utest.json", "batching_utest/table0", 8, 1000,
+                                          true);
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <hps/miss_coalescer.hpp>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+const size_t emb_vec_size = 4;
+
+template <typename Key>
+void fill_vectors(const Key* const keys, const size_t num_keys, float* const vectors) {
+  for (size_t i = 0; i < num_keys; ++i) {
+    for (size_t j = 0; j < emb_vec_size; ++j) {
+      vectors[i * emb_vec_size + j] = static_cast<float>(keys[i]) + static_cast<float>(j) * 0.25f;
+    }
+  }
+}
+
+template <typename Key>
+void miss_coalescer_concurrent_test(const size_t num_threads, const size_t num_keys,
+                                    const size_t key_range) {
+  MissCoalescer<Key> coalescer;
+  std::atomic<size_t> num_fetched{0};
+  auto fetch = [&](const Key* const keys, const size_t n, float* const vectors) {
+    num_fetched += n;
+    // Make sure that fetches overlap.
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    fill_vectors(keys, n, vectors);
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      std::vector<Key> keys(num_keys);
+      for (size_t i = 0; i < num_keys; ++i) {
+        keys[i] = static_cast<Key>((i * 7 + t) % key_range);
+      }
+      std::vector<float> vectors(num_keys * emb_vec_size);
+      coalescer.fetch(keys.data(), keys.size(), emb_vec_size, vectors.data(), fetch);
+
+      std::vector<float> expected(num_keys * emb_vec_size);
+      fill_vectors(keys.data(), keys.size(), expected.data());
+      EXPECT_EQ(vectors, expected);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // Every key must have been fetched at least once, and duplicates must have been coalesced.
+  EXPECT_GE(num_fetched.load(), key_range);
+  EXPECT_EQ(num_fetched.load() + coalescer.num_coalesced_keys(), num_threads * num_keys);
+}
+
+template <typename Key>
+void miss_coalescer_exception_test() {
+  MissCoalescer<Key> coalescer;
+  const std::vector<Key> keys{1, 2, 3};
+  std::vector<float> vectors(keys.size() * emb_vec_size);
+
+  auto failing_fetch = [](const Key*, size_t, float*) { throw std::runtime_error("fetch failed"); };
+  EXPECT_THROW(coalescer.fetch(keys.data(), keys.size(), emb_vec_size, vectors.data(),
+                               failing_fetch),
+               std::runtime_error);
+
+  // Failed keys must not remain claimed.
+  auto fetch = [](const Key* const k, const size_t n, float* const v) { fill_vectors(k, n, v); };
+  coalescer.fetch(keys.data(), keys.size(), emb_vec_size, vectors.data(), fetch);
+  std::vector<float> expected(keys.size() * emb_vec_size);
+  fill_vectors(keys.data(), keys.size(), expected.data());
+  EXPECT_EQ(vectors, expected);
+}
+
+}  // namespace
+
+TEST(miss_coalescer_test, concurrent_i32) {
+  miss_coalescer_concurrent_test<unsigned int>(8, 1000, 1500);
+}
+TEST(miss_coalescer_test, concurrent_i64) {
+  miss_coalescer_concurrent_test<long long>(8, 1000, 1500);
+}
+TEST(miss_coalescer_test, exception) { miss_coalescer_exception_test<long long>(); }
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <hps/modelloader.hpp>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+const size_t emb_vec_size = 4;
+
+// Writes a raw model of num_keys keys, in which every vector element is derived from its key.
+std::string write_raw_model(const std::string& name, const size_t num_keys) {
+  const std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+  std::filesystem::create_directories(path);
+  std::vector<long long> keys(num_keys);
+  std::vector<float> vectors(num_keys * emb_vec_size);
+  for (size_t i = 0; i < num_keys; ++i) {
+    keys[i] = static_cast<long long>(i * 7 + 1);
+    for (size_t j = 0; j < emb_vec_size; ++j) {
+      vectors[i * emb_vec_size + j] = static_cast<float>(keys[i]) + static_cast<float>(j) * 0.25f;
+    }
+  }
+  std::ofstream(path / "key", std::ios::binary)
+      .write(reinterpret_cast<const char*>(keys.data()), keys.size() * sizeof(long long));
+  std::ofstream(path / "emb_vector", std::ios::binary)
+      .write(reinterpret_cast<const char*>(vectors.data()), vectors.size() * sizeof(float));
+  return path.string();
+}
+
+template <typename TKey>
+void for_each_chunk_test(const size_t num_keys, const size_t keys_per_chunk) {
+  const std::string path = write_raw_model("hps_model_loader_test", num_keys);
+  std::unique_ptr<IModelLoader> loader(
+      ModelLoader<TKey, float>::CreateLoader(DatabaseTableDumpFormat_t::Raw));
+  loader->load("table", path, keys_per_chunk);
+  EXPECT_EQ(loader->getkeycount(), num_keys);
+  EXPECT_EQ(loader->get_num_iterations(), (num_keys + keys_per_chunk - 1) / keys_per_chunk);
+
+  size_t num_streamed = 0;
+  size_t num_chunks = 0;
+  loader->for_each_chunk(emb_vec_size, [&](const void* const keys, const void* const vectors,
+                                           const size_t num_chunk_keys) {
+    EXPECT_LE(num_chunk_keys, keys_per_chunk);
+    const TKey* const chunk_keys = reinterpret_cast<const TKey*>(keys);
+    const float* const chunk_vectors = reinterpret_cast<const float*>(vectors);
+    for (size_t i = 0; i < num_chunk_keys; ++i) {
+      const size_t index = num_streamed + i;
+      ASSERT_EQ(chunk_keys[i], static_cast<TKey>(index * 7 + 1));
+      for (size_t j = 0; j < emb_vec_size; ++j) {
+        ASSERT_EQ(chunk_vectors[i * emb_vec_size + j],
+                  static_cast<float>(index * 7 + 1) + static_cast<float>(j) * 0.25f);
+      }
+    }
+    num_streamed += num_chunk_keys;
+    num_chunks++;
+  });
+  EXPECT_EQ(num_streamed, num_keys);
+  EXPECT_EQ(num_chunks, loader->get_num_iterations());
+  std::filesystem::remove_all(path);
+}
+
+TEST(model_loader, for_each_chunk_long_long) { for_each_chunk_test<long long>(1000, 64); }
+TEST(model_loader, for_each_chunk_unsigned) { for_each_chunk_test<unsigned int>(1000, 64); }
+TEST(model_loader, for_each_chunk_single) { for_each_chunk_test<long long>(10, 100); }
+
+TEST(model_loader, for_each_chunk_stops_on_error) {
+  const std::string path = write_raw_model("hps_model_loader_error_test", 256);
+  std::unique_ptr<IModelLoader> loader(
+      ModelLoader<long long, float>::CreateLoader(DatabaseTableDumpFormat_t::Raw));
+  loader->load("table", path, 16);
+  size_t num_chunks = 0;
+  EXPECT_THROW(loader->for_each_chunk(emb_vec_size,
+                                      [&](const void*, const void*, size_t) {
+                                        if (++num_chunks == 3) {
+                                          throw std::runtime_error("insertion failed");
+                                        }
+                                      }),
+               std::runtime_error);
+  EXPECT_EQ(num_chunks, 3);
+  std::filesystem::remove_all(path);
+}
+
+TEST(model_loader, default_chunks_are_tenths) {
+  // Without a number of keys per iteration, a table is read in tenths.
+  const std::string path = write_raw_model("hps_model_loader_default_test", 1000);
+  std::unique_ptr<IModelLoader> loader(
+      ModelLoader<long long, float>::CreateLoader(DatabaseTableDumpFormat_t::Raw));
+  loader->load("table", path);
+  EXPECT_EQ(loader->get_num_iterations(), 10);
+  std::filesystem::remove_all(path);
+}
+
+}  // namespace
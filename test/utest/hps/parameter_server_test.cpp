@@ -20,6 +20,7 @@
 #include <cassert>
 #include <filesystem>
 #include <fstream>
+#include <hps/cpu_lookup_session.hpp>
 #include <hps/embedding_cache.hpp>
 #include <hps/hier_parameter_server.hpp>
 #include <hps/inference_utils.hpp>
@@ -90,7 +91,8 @@ template <typename TypeHashKey>
 void parameter_server_test(const std::string& config_file, const std::string& model,
                            const std::string& dense_model, std::vector<std::string> sparse_models,
                            const std::vector<size_t> embedding_vec_size,
-                           DatabaseType_t database_t = DatabaseType_t::ParallelHashMap) {
+                           DatabaseType_t database_t = DatabaseType_t::ParallelHashMap,
+                           bool reload_model = false) {
   VolatileDatabaseParams dis_database;
   PersistentDatabaseParams per_database;
   switch (database_t) {
@@ -123,6 +125,60 @@ void parameter_server_test(const std::string& config_file, const std::string& mo
       HierParameterServerBase::create(ps_config);
   validate_lookup_result_per_table<long long>(config_file, infer_param, embedding_vec_size,
                                               parameter_server);
+  if (reload_model) {
+    // The unchanged chunks of the new version are shared with the previous one, and its embedding
+    // caches start from the keys of the previous ones.
+    parameter_server->update_database_per_model(infer_param);
+    parameter_server->create_embedding_cache_per_model(infer_param);
+    validate_lookup_result_per_table<long long>(config_file, infer_param, embedding_vec_size,
+                                                parameter_server);
+  }
+}
+
+// Looks up a query with many duplicate keys through a CPU lookup session of a model without
+// deployed devices, split into partitions of few keys.
+void cpu_lookup_session_test(const std::string& config_file, const std::string& model,
+                             const std::string& dense_model, std::vector<std::string> sparse_models,
+                             const std::vector<size_t>& embedding_vec_size) {
+  InferenceParams infer_param(model, 1, 0.5, dense_model, sparse_models, 0, true, 0.8, false);
+  infer_param.sparse_model_files.swap(sparse_models);
+  infer_param.deployed_devices.clear();
+  std::vector<InferenceParams> inference_params{infer_param};
+  std::vector<std::string> model_config_path{config_file};
+  parameter_server_config ps_config{model_config_path, inference_params};
+  std::shared_ptr<HierParameterServerBase> parameter_server =
+      HierParameterServerBase::create(ps_config);
+  CpuLookupSession lookup_session(infer_param, parameter_server, embedding_vec_size, 64);
+
+  for (size_t j = 0; j < infer_param.sparse_model_files.size(); j++) {
+    const std::string emb_file_prefix = infer_param.sparse_model_files[j] + "/";
+    const std::string key_file = emb_file_prefix + "key";
+    const std::string vec_file = emb_file_prefix + "emb_vector";
+    const size_t embedding_size = embedding_vec_size[j];
+    const size_t num_key = std::filesystem::file_size(key_file) / sizeof(long long);
+    std::vector<long long> key_vec(num_key);
+    std::vector<float> vec_vec(num_key * embedding_size);
+    std::ifstream(key_file).read(reinterpret_cast<char*>(key_vec.data()),
+                                 key_vec.size() * sizeof(long long));
+    std::ifstream(vec_file).read(reinterpret_cast<char*>(vec_vec.data()),
+                                 vec_vec.size() * sizeof(float));
+
+    const size_t num_query_keys = 4096;
+    const size_t num_distinct_keys = std::min<size_t>(num_key, 1000);
+    std::vector<size_t> index(num_query_keys);
+    std::vector<long long> query_keys(num_query_keys);
+    for (size_t i = 0; i < num_query_keys; i++) {
+      index[i] = rand() % num_distinct_keys;
+      query_keys[i] = key_vec[index[i]];
+    }
+    std::vector<float> h_vectors(num_query_keys * embedding_size);
+    lookup_session.lookup(query_keys.data(), h_vectors.data(), num_query_keys, j);
+    for (size_t i = 0; i < num_query_keys; i++) {
+      for (size_t k = 0; k < embedding_size; k++) {
+        ASSERT_EQ(vec_vec[index[i] * embedding_size + k], h_vectors[i * embedding_size + k]);
+      }
+    }
+  }
 }
 }  // namespace
 
@@ -136,6 +192,10 @@ TEST(parameter_server, CPU_look_up) {
   parameter_server_test<long long>(network, model_name, dense_model, sparse_models,
                                    embedding_vec_size_wdl, DatabaseType_t::ParallelHashMap);
 }
+TEST(parameter_server, CPU_look_up_reload) {
+  parameter_server_test<long long>(network, model_name, dense_model, sparse_models,
+                                   embedding_vec_size_wdl, DatabaseType_t::ParallelHashMap, true);
+}
 TEST(parameter_server, Rocksdb_look_up) {
   parameter_server_test<long long>(network, model_name, dense_model, sparse_models,
                                    embedding_vec_size_wdl, DatabaseType_t::RocksDB);
@@ -143,4 +203,7 @@ TEST(parameter_server, Rocksdb_look_up) {
 TEST(parameter_server, Redis_look_up) {
   parameter_server_test<long long>(network, model_name, dense_model, sparse_models,
                                    embedding_vec_size_wdl, DatabaseType_t::RedisCluster);
-}
\ No newline at end of file
+}
+TEST(parameter_server, CPU_lookup_session) {
+  cpu_lookup_session_test(network, model_name, dense_model, sparse_models, embedding_vec_size_wdl);
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <hps/hash_map_backend.hpp>
+#include <hps/hier_parameter_server_base.hpp>
+#include <hps/prehashed_table.hpp>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+const size_t emb_vec_size = 3;
+
+// Writes a raw model of random keys, including ~0, 0 and a duplicate, and returns the row of the
+// first occurrence of every key.
+std::unordered_map<long long, size_t> write_raw_model(const std::string& path,
+                                                      const size_t num_rows,
+                                                      std::vector<float>& vectors) {
+  std::filesystem::create_directories(path);
+  std::vector<long long> keys(num_rows);
+  vectors.resize(num_rows * emb_vec_size);
+  std::mt19937_64 gen(42);
+  for (size_t i = 0; i < num_rows; ++i) {
+    keys[i] = static_cast<long long>(gen() % 1000000000);
+    for (size_t j = 0; j < emb_vec_size; ++j) {
+      vectors[i * emb_vec_size + j] = static_cast<float>(i) + static_cast<float>(j) * 0.5f;
+    }
+  }
+  keys[5] = -1;
+  keys[7] = 0;
+  keys[9] = keys[3];
+  std::ofstream(path + "/key", std::ios::binary)
+      .write(reinterpret_cast<const char*>(keys.data()), keys.size() * sizeof(long long));
+  std::ofstream(path + "/emb_vector", std::ios::binary)
+      .write(reinterpret_cast<const char*>(vectors.data()), vectors.size() * sizeof(float));
+
+  std::unordered_map<long long, size_t> rows;
+  for (size_t i = 0; i < num_rows; ++i) {
+    rows.emplace(keys[i], i);
+  }
+  return rows;
+}
+
+}  // namespace
+
+TEST(prehashed_table, find) {
+  const std::string path = std::filesystem::temp_directory_path() / "hps_prehashed_table_find";
+  std::vector<float> vectors;
+  const auto rows = write_raw_model(path, 100000, vectors);
+  PrehashedTable<long long>::write(path);
+
+  PrehashedTable<long long> table(PrehashedTable<long long>::default_path(path));
+  EXPECT_EQ(table.num_keys(), rows.size());
+  EXPECT_EQ(table.num_rows(), 100000);
+  EXPECT_EQ(table.num_slots(), PrehashedTable<long long>::num_slots_for(100000));
+  EXPECT_EQ(table.value_size(), emb_vec_size * sizeof(float));
+  for (const auto& [key, row] : rows) {
+    const float* const value = reinterpret_cast<const float*>(table.find(key));
+    ASSERT_NE(value, nullptr);
+    for (size_t j = 0; j < emb_vec_size; ++j) {
+      ASSERT_EQ(value[j], vectors[row * emb_vec_size + j]);
+    }
+  }
+  for (long long key = 2000000000; key < 2000100000; ++key) {
+    ASSERT_EQ(table.find(key), nullptr);
+  }
+
+  // The key type is part of the format.
+  EXPECT_THROW(PrehashedTable<unsigned int>(PrehashedTable<long long>::default_path(path)),
+               std::runtime_error);
+  std::filesystem::remove_all(path);
+}
+
+TEST(prehashed_table, hash_map_backend) {
+  const std::string path = std::filesystem::temp_directory_path() / "hps_prehashed_table_db";
+  std::vector<float> vectors;
+  const auto rows = write_raw_model(path, 10000, vectors);
+  PrehashedTable<long long>::write(path);
+
+  HashMapBackendParams params;
+  params.num_partitions = 4;
+  HashMapBackend<long long> db(params);
+  const std::string tag = HierParameterServerBase::make_tag_name("prehashed", "test");
+  const size_t value_size = emb_vec_size * sizeof(float);
+  EXPECT_THROW(db.attach_prehashed_table(tag, PrehashedTable<long long>::default_path(path), 4),
+               std::runtime_error);
+  EXPECT_EQ(db.attach_prehashed_table(tag, PrehashedTable<long long>::default_path(path),
+                                      value_size),
+            rows.size());
+  EXPECT_EQ(db.size(tag), rows.size());
+  EXPECT_EQ(db.find_tables("prehashed"), std::vector<std::string>{tag});
+
+  // Inserted pairs take precedence over the file.
+  std::vector<long long> keys;
+  for (const auto& pair : rows) {
+    keys.push_back(pair.first);
+  }
+  const std::vector<float> overlay(emb_vec_size, -1.f);
+  db.insert(tag, 1, &keys[0], reinterpret_cast<const char*>(overlay.data()), value_size,
+            value_size);
+  keys.push_back(2000000000);
+  EXPECT_EQ(db.contains(tag, keys.size(), keys.data(), std::chrono::nanoseconds::zero()),
+            rows.size());
+
+  std::vector<float> fetched(keys.size() * emb_vec_size);
+  std::vector<size_t> misses;
+  const size_t hit_count = db.fetch(
+      tag, keys.size(), keys.data(), reinterpret_cast<char*>(fetched.data()), value_size,
+      [&](const size_t index) { misses.push_back(index); }, std::chrono::nanoseconds::zero());
+  EXPECT_EQ(hit_count, rows.size());
+  EXPECT_EQ(misses, std::vector<size_t>{keys.size() - 1});
+  for (size_t j = 0; j < emb_vec_size; ++j) {
+    EXPECT_EQ(fetched[j], -1.f);
+  }
+  for (size_t i = 1; i < rows.size(); ++i) {
+    const size_t row = rows.at(keys[i]);
+    for (size_t j = 0; j < emb_vec_size; ++j) {
+      ASSERT_EQ(fetched[i * emb_vec_size + j], vectors[row * emb_vec_size + j]);
+    }
+  }
+
+  // Evicting the table detaches the file.
+  db.evict(tag);
+  EXPECT_EQ(db.size(tag), 0);
+  EXPECT_TRUE(db.find_tables("prehashed").empty());
+  std::filesystem::remove_all(path);
+}
@@ -16,9 +16,14 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
 #include <data_generator.hpp>
+#include <filesystem>
 #include <fstream>
+#include <io/caching_filesystem.hpp>
 #include <io/filesystem.hpp>
+#include <io/local_filesystem.hpp>
+#include <thread>
 #include <utest/test_utils.hpp>
 
 using namespace HugeCTR;
@@ -97,10 +102,86 @@ void append_test() {
   delete[] buffer_for_read;
 }
 
+size_t num_cached_files(const std::string& cache_dir) {
+  size_t num_files = 0;
+  for (const auto& entry : std::filesystem::directory_iterator(cache_dir)) {
+    num_files += entry.path().filename().string().front() != '.';
+  }
+  return num_files;
+}
+
+void caching_test() {
+  const std::string cache_dir = "./tmp/cache";
+  std::filesystem::remove_all(cache_dir);
+  const std::string path1 = "./tmp/cached/data1.txt";
+  const std::string path2 = "./tmp/cached/data2.txt";
+  const std::string text = "Hello, Cache!\n";
+
+  LocalFileSystem remote;
+  remote.write(path1, text.data(), text.size(), true);
+  remote.write(path2, text.data(), text.size(), true);
+
+  // Room for one file only
+  CachingFileSystem hs(std::make_unique<LocalFileSystem>(), cache_dir, text.size() + 1);
+  std::string buffer(text.size(), ' ');
+  EXPECT_EQ(hs.read(path1, buffer.data(), text.size(), 0), static_cast<int>(text.size()));
+  EXPECT_EQ(buffer, text);
+  EXPECT_EQ(num_cached_files(cache_dir), 1u);
+
+  // The cached copy is read once the remote file is gone.
+  remote.delete_file(path1);
+  buffer.assign(text.size(), ' ');
+  EXPECT_EQ(hs.read(path1, buffer.data(), 5, 7), 5);
+  EXPECT_EQ(buffer.substr(0, 5), text.substr(7, 5));
+
+  // Caching the second file evicts the first one.
+  EXPECT_EQ(hs.read(path2, buffer.data(), text.size(), 0), static_cast<int>(text.size()));
+  EXPECT_EQ(buffer, text);
+  EXPECT_EQ(num_cached_files(cache_dir), 1u);
+  EXPECT_ANY_THROW(hs.read(path1, buffer.data(), text.size(), 0));
+}
+
+void prefetch_test() {
+  const std::string cache_dir = "./tmp/prefetch_cache";
+  std::filesystem::remove_all(cache_dir);
+  const std::string path = "./tmp/cached/large.bin";
+  // Several chunks of the ranged download, the last one partial
+  std::string data((size_t{8} << 20) * 5 + 123, ' ');
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<char>(i * 7919 % 251);
+  }
+  LocalFileSystem remote;
+  remote.write(path, data.data(), data.size(), true);
+
+  CachingFileSystem hs(std::make_unique<LocalFileSystem>(), cache_dir, 0, 2, true);
+  hs.prefetch({path});
+  // Readable at once, from the remote file system until the download completes
+  std::string buffer(100, ' ');
+  EXPECT_EQ(hs.read(path, buffer.data(), buffer.size(), data.size() - 100), 100);
+  EXPECT_EQ(buffer, data.substr(data.size() - 100));
+
+  for (int i = 0; i < 1000 && num_cached_files(cache_dir) != 1; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_EQ(num_cached_files(cache_dir), 1u);
+  remote.delete_file(path);
+  buffer.assign(data.size(), ' ');
+  EXPECT_EQ(hs.read(path, buffer.data(), buffer.size(), 0), static_cast<int>(data.size()));
+  EXPECT_EQ(buffer, data);
+
+  // A consumed file leaves the cache.
+  hs.release(path);
+  EXPECT_EQ(num_cached_files(cache_dir), 0u);
+}
+
 TEST(local_fs_test, fs_builder_test) { simple_read_write_test_with_builder(); }
 
 TEST(local_fs_test, read_write_test) { simple_read_write_test(); }
 
 TEST(local_fs_test, local_append_test) { append_test(); }
 
+TEST(local_fs_test, caching_test) { caching_test(); }
+
+TEST(local_fs_test, prefetch_test) { prefetch_test(); }
+
 }  // namespace
\ No newline at end of file
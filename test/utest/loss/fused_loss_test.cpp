@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <HugeCTR/include/network_buffer_channels.hpp>
+#include <cstdlib>
+#include <loss.hpp>
+#include <map>
+#include <regularizers/no_regularizer.hpp>
+#include <string>
+#include <utest/test_utils.hpp>
+#include <vector>
+
+using namespace HugeCTR;
+using namespace HugeCTR::test;
+
+namespace {
+
+core23::Tensor create_tensor(int64_t rows) {
+  core23::BufferParams blobs_buffer_params = {};
+  blobs_buffer_params.channel = GetBlobsBufferChannel();
+  return core23::Tensor(core23::TensorParams()
+                            .data_type(core23::ToScalarType<float>::value)
+                            .shape({rows, 1})
+                            .buffer_params(blobs_buffer_params));
+}
+
+// Compares the fused loss of num_tasks BCE heads with the heads computed one by one
+void fused_binary_cross_entropy_loss(int64_t batch_size, int64_t current_batch_size,
+                                     int num_tasks, bool is_train) {
+  std::shared_ptr<NoRegularizer<float>> no_regularizer(
+      new NoRegularizer<float>(std::nullopt, std::nullopt, batch_size, test::get_default_gpu()));
+
+  std::map<std::string, std::unique_ptr<ILoss>> fused_heads;
+  std::vector<std::unique_ptr<ILoss>> ref_heads;
+  std::vector<core23::Tensor> fused_inputs, ref_inputs, fused_losses, ref_losses;
+  srand(time(NULL));
+  for (int task = 0; task < num_tasks; ++task) {
+    core23::Tensor label_tensor = create_tensor(batch_size);
+    fused_inputs.push_back(create_tensor(batch_size));
+    ref_inputs.push_back(create_tensor(batch_size));
+    fused_losses.push_back(create_tensor(1));
+    ref_losses.push_back(create_tensor(1));
+
+    const std::string name = "label" + std::to_string(task);
+    fused_heads[name] = std::make_unique<BinaryCrossEntropyLoss<float>>(
+        label_tensor, fused_inputs.back(), fused_losses.back(), no_regularizer,
+        test::get_default_gpu(), 1);
+    ref_heads.push_back(std::make_unique<BinaryCrossEntropyLoss<float>>(
+        label_tensor, ref_inputs.back(), ref_losses.back(), no_regularizer,
+        test::get_default_gpu(), 1));
+    const float label_weight = 0.5f + task;
+    fused_heads[name]->set_label_weight(label_weight);
+    ref_heads.back()->set_label_weight(label_weight);
+
+    std::vector<float> h_input(batch_size);
+    std::vector<float> h_label(batch_size);
+    for (int64_t i = 0; i < batch_size; ++i) h_input[i] = (rand() % 200 - 100) * 0.01f;
+    for (int64_t i = 0; i < batch_size; ++i) h_label[i] = rand() % 2;
+    HCTR_LIB_THROW(cudaMemcpy(fused_inputs.back().data(), h_input.data(),
+                              sizeof(float) * batch_size, cudaMemcpyHostToDevice));
+    HCTR_LIB_THROW(cudaMemcpy(ref_inputs.back().data(), h_input.data(),
+                              sizeof(float) * batch_size, cudaMemcpyHostToDevice));
+    HCTR_LIB_THROW(cudaMemcpy(label_tensor.data(), h_label.data(), sizeof(float) * batch_size,
+                              cudaMemcpyHostToDevice));
+  }
+
+  auto fused_loss = create_fused_loss<float>(fused_heads);
+  ASSERT_NE(fused_loss, nullptr);
+  const float rterm = 0.25f;
+  // twice, since the fused loss resets its running sums itself
+  for (int iter = 0; iter < 2; ++iter) {
+    fused_loss->compute(is_train, current_batch_size, rterm);
+  }
+  float ref_total = 0.f;
+  for (int task = 0; task < num_tasks; ++task) {
+    // the second iteration runs on the outputs of the first one, as for the fused loss
+    for (int iter = 0; iter < 2; ++iter) {
+      ref_heads[task]->compute(is_train, current_batch_size, rterm);
+    }
+    float ref_loss = 0.f;
+    HCTR_LIB_THROW(cudaMemcpy(&ref_loss, ref_losses[task].data(), sizeof(float),
+                              cudaMemcpyDeviceToHost));
+    ref_total += ref_loss;
+
+    std::vector<float> h_ref_input(batch_size);
+    HCTR_LIB_THROW(cudaMemcpy(h_ref_input.data(), ref_inputs[task].data(),
+                              sizeof(float) * batch_size, cudaMemcpyDeviceToHost));
+    ASSERT_EQ(true, cpu_gpu_cmp(&ref_loss, fused_losses[task].data<float>(), 1))
+        << " Fused BCE Loss calculation failed for task " << task << std::endl;
+    ASSERT_EQ(true, cpu_gpu_cmp(h_ref_input.data(), fused_inputs[task].data<float>(), batch_size))
+        << " Fused BCE Gradient calculation failed for task " << task << std::endl;
+  }
+  ASSERT_EQ(true, cpu_gpu_cmp(&ref_total, fused_loss->get_total_loss_tensor().data<float>(), 1))
+      << " Fused BCE total Loss calculation failed" << std::endl;
+}
+
+}  // namespace
+
+TEST(fused_loss_test, FusedBinaryCrossEntropyLoss_2048x12) {
+  fused_binary_cross_entropy_loss(2048, 2048, 12, true);
+}
+TEST(fused_loss_test, FusedBinaryCrossEntropyLoss_64x2) {
+  fused_binary_cross_entropy_loss(64, 64, 2, true);
+}
+TEST(fused_loss_test, FusedBinaryCrossEntropyLoss_partial_batch) {
+  fused_binary_cross_entropy_loss(2048, 1000, 4, true);
+}
+TEST(fused_loss_test, FusedBinaryCrossEntropyLoss_eval) {
+  fused_binary_cross_entropy_loss(1024, 1024, 3, false);
+}
+TEST(fused_loss_test, FusedBinaryCrossEntropyLoss_not_fused) {
+  std::shared_ptr<NoRegularizer<float>> no_regularizer(
+      new NoRegularizer<float>(std::nullopt, std::nullopt, 64, test::get_default_gpu()));
+  std::map<std::string, std::unique_ptr<ILoss>> heads;
+  heads["label"] = std::make_unique<BinaryCrossEntropyLoss<float>>(
+      create_tensor(64), create_tensor(64), create_tensor(1), no_regularizer,
+      test::get_default_gpu(), 1);
+  ASSERT_EQ(create_fused_loss<float>(heads), nullptr);
+}
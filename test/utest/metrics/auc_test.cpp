@@ -31,6 +31,8 @@ using namespace HugeCTR;
 namespace {
 
 const float eps = 2.0e-6;
+// The histogram bins of StreamingAUC bound its error rather than the float precision
+const float streaming_eps = 1.0e-3;
 
 template <typename T>
 float sklearn_ref(size_t num_total_samples, size_t num_classes, const std::vector<float>& labels,
@@ -188,7 +190,8 @@ static int execution_number = 0;
 
 template <typename T, typename Generator>
 void metric_test(std::vector<int> device_list, size_t batch_size, size_t num_total_samples,
-                 Generator gen, bool auc, size_t num_evals = 1, size_t num_classes = 1) {
+                 Generator gen, bool auc, size_t num_evals = 1, size_t num_classes = 1,
+                 bool streaming = false) {
   int num_procs = 1, rank = 0;
 #ifdef ENABLE_MPI
   HCTR_MPI_THROW(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
@@ -249,7 +252,9 @@ void metric_test(std::vector<int> device_list, size_t batch_size, size_t num_tot
 
   // Create metric
   metrics::Metric* metric;
-  if (auc) {
+  if (auc && streaming) {
+    metric = new metrics::StreamingAUC<T>(batch_size / num_classes, num_classes, resource_manager);
+  } else if (auc) {
     metric =
         new metrics::AUC<T>(batch_size / num_classes, num_batches, num_classes, resource_manager);
   } else {
@@ -262,6 +267,7 @@ void metric_test(std::vector<int> device_list, size_t batch_size, size_t num_tot
   execution_number++;
 
   float gpu_result;
+  float half_width = 0.0f;
   for (size_t eval = 0; eval < num_evals; eval++) {
     size_t num_processed = 0;
     for (size_t batch = 0; batch < num_batches; batch++) {
@@ -289,6 +295,10 @@ void metric_test(std::vector<int> device_list, size_t batch_size, size_t num_tot
       num_processed += batch_size_per_iter;
       metric->global_reduce(1);
     }
+    if (streaming) {
+      // must not disturb the reduction
+      half_width = metric->get_confidence_half_width();
+    }
     gpu_result = metric->finalize_metric();
   }
 
@@ -296,7 +306,11 @@ void metric_test(std::vector<int> device_list, size_t batch_size, size_t num_tot
   // HCTR_LOG(INFO, WORLD, "GPU %f, ref %f \n", gpu_result, ref_result);
 
   float error_margin = auc ? eps : 10 * eps;  // Use a larger margin of error for NDCG
+  if (streaming) {
+    error_margin = streaming_eps;
+  }
   ASSERT_NEAR(gpu_result, ref_result, error_margin);
+  ASSERT_GE(half_width, 0.0f);
   delete metric;
 }
 
@@ -376,6 +390,27 @@ TEST(auc_test, fp32_2gpu_random_multilabel) {
   metric_test<float>({3, 5}, 12, 2341, gen_random<float>, 1, 1, 3);
 }
 
+// Streaming AUC tests
+
+TEST(auc_test, streaming_fp32_1gpu) {
+  metric_test<float>({0}, 10, 200, gen_random<float>, 1, 1, 1, true);
+}
+TEST(auc_test, streaming_fp32_2gpu_odd) {
+  metric_test<float>({0, 1}, 10, 443, gen_random<float>, 1, 2, 1, true);
+}
+TEST(auc_test, streaming_fp32_4gpu_same) {
+  metric_test<float>({0, 1, 2, 3}, 12, 154, gen_same<float>, 1, 1, 1, true);
+}
+TEST(auc_test, streaming_fp32_8gpu_correct) {
+  metric_test<float>({0, 1, 2, 3, 4, 5, 6, 7}, 5423, 874345, gen_correct<float>, 1, 1, 1, true);
+}
+TEST(auc_test, streaming_fp16_4gpu) {
+  metric_test<__half>({0, 1, 2, 3}, 5500, 22 * 5500 + 424, gen_random<__half>, 1, 1, 1, true);
+}
+TEST(auc_test, streaming_fp32_2gpu_multilabel) {
+  metric_test<float>({0, 1}, 10, 443, gen_random<float>, 1, 1, 5, true);
+}
+
 // Multi-label AUC performance tests
 const std::vector<int> one_gpu{0};
 const std::vector<int> two_gpu{0, 1};
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <metrics.hpp>
+#include <numeric>
+#include <random>
+#include <resource_managers/resource_manager_ext.hpp>
+#include <utest/test_utils.hpp>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+const float eps = 1e-4f;
+
+// HitRate@K, NDCG@K and MRR of one query, by sorting its candidates; false if none is relevant
+bool query_metrics_cpu(const float* preds, const float* labels, int num_candidates, int top_k,
+                       double& hit, double& ndcg, double& rr) {
+  std::vector<int> order(num_candidates);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](int a, int b) { return preds[a] > preds[b]; });
+  std::vector<float> ideal(labels, labels + num_candidates);
+  std::sort(ideal.begin(), ideal.end(), std::greater<float>());
+  if (ideal[0] <= 0.0f) {
+    return false;
+  }
+
+  double dcg = 0.0, ideal_dcg = 0.0;
+  int first = -1;
+  for (int rank = 0; rank < num_candidates; rank++) {
+    const float label = labels[order[rank]];
+    if (label > 0.0f && first < 0) {
+      first = rank;
+    }
+    if (rank < top_k) {
+      dcg += std::max(label, 0.0f) / std::log2(rank + 2.0);
+      ideal_dcg += std::max(ideal[rank], 0.0f) / std::log2(rank + 2.0);
+    }
+  }
+  hit = first < top_k ? 1.0 : 0.0;
+  ndcg = dcg / ideal_dcg;
+  rr = 1.0 / (first + 1);
+  return true;
+}
+
+void query_metric_test(int num_queries, int num_candidates, int top_k, int max_label) {
+  const std::vector<std::vector<int>> vvgpu{{0}};
+  const auto resource_manager = ResourceManagerExt::create(vvgpu, 0);
+  const int device_id = resource_manager->get_local_gpu(0)->get_device_id();
+  CudaDeviceContext context(device_id);
+
+  const int num_samples = num_queries * num_candidates;
+  std::mt19937 gen(424242);
+  std::uniform_real_distribution<float> dis_pred(0.0f, 1.0f);
+  std::uniform_int_distribution<int> dis_label(1, max_label);
+  std::uniform_int_distribution<int> dis_num_relevant(0, 3);
+  std::uniform_int_distribution<int> dis_candidate(0, num_candidates - 1);
+  std::vector<float> h_preds(num_samples), h_labels(num_samples, 0.0f);
+  for (int q = 0; q < num_queries; q++) {
+    for (int i = 0; i < num_candidates; i++) {
+      // Coarse predictions, so that ties happen
+      h_preds[q * num_candidates + i] = std::round(dis_pred(gen) * 64.0f) / 64.0f;
+    }
+    for (int n = dis_num_relevant(gen); n > 0; n--) {
+      h_labels[q * num_candidates + dis_candidate(gen)] = dis_label(gen);
+    }
+  }
+
+  // Two batches of the same queries are reduced, the second one cut in the middle of the last
+  // query, which is dropped
+  double hits = 0.0, ndcgs = 0.0, rrs = 0.0;
+  int num_relevant_queries = 0;
+  for (int q = 0; q < num_queries; q++) {
+    double hit, ndcg, rr;
+    if (query_metrics_cpu(h_preds.data() + q * num_candidates,
+                          h_labels.data() + q * num_candidates, num_candidates, top_k, hit, ndcg,
+                          rr)) {
+      const int num_batches = q < num_queries - 1 ? 2 : 1;
+      hits += num_batches * hit;
+      ndcgs += num_batches * ndcg;
+      rrs += num_batches * rr;
+      num_relevant_queries += num_batches;
+    }
+  }
+  ASSERT_GT(num_relevant_queries, 0);
+
+  const core23::Shape shape({num_samples, 1});
+  const auto params = core23::TensorParams()
+                          .data_type(core23::ScalarType::Float)
+                          .device(core23::Device(core23::DeviceType::GPU, device_id))
+                          .shape(shape);
+  core23::Tensor preds(params), labels(params);
+  HCTR_LIB_THROW(cudaMemcpy(preds.data(), h_preds.data(), num_samples * sizeof(float),
+                            cudaMemcpyHostToDevice));
+  HCTR_LIB_THROW(cudaMemcpy(labels.data(), h_labels.data(), num_samples * sizeof(float),
+                            cudaMemcpyHostToDevice));
+  metrics::Core23RawMetricMap metric_map = {{metrics::RawType::Pred, preds},
+                                            {metrics::RawType::Label, labels}};
+
+  const std::vector<std::pair<metrics::Type, double>> expected = {
+      {metrics::Type::QueryHitRate, hits / num_relevant_queries},
+      {metrics::Type::QueryNDCG, ndcgs / num_relevant_queries},
+      {metrics::Type::QueryMRR, rrs / num_relevant_queries}};
+  for (const auto& [type, value] : expected) {
+    metrics::QueryMetric<float> metric(type, num_samples, top_k, num_candidates,
+                                       resource_manager);
+    metric.set_current_batch_size(num_samples);
+    metric.local_reduce(0, metric_map);
+    metric.set_current_batch_size(num_samples - num_candidates / 2);
+    metric.local_reduce(0, metric_map);
+    EXPECT_NEAR(metric.finalize_metric(), value, eps) << metric.name();
+  }
+}
+
+TEST(query_metric, 64x100_top10) { query_metric_test(64, 100, 10, 1); }
+TEST(query_metric, 40x3000_top50_graded) { query_metric_test(40, 3000, 50, 4); }
+
+}  // namespace
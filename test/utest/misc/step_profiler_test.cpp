@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <resource_managers/resource_manager_ext.hpp>
+#include <step_profiler.hpp>
+#include <utils.hpp>
+
+using namespace HugeCTR;
+
+namespace {
+
+TEST(step_profiler, ranks_parts_by_time_and_bound) {
+  const std::vector<std::vector<int>> vvgpu{{0}};
+  const auto resource_manager = ResourceManagerExt::create(vvgpu, 0);
+  const auto& gpu = resource_manager->get_local_gpu(0);
+  CudaDeviceContext context(gpu->get_device_id());
+
+  const size_t big_bytes = size_t{256} << 20, small_bytes = 4096;
+  void* buffer = nullptr;
+  HCTR_LIB_THROW(cudaMalloc(&buffer, big_bytes));
+
+  // 100 TFLOP/s and 1000 GB/s, the ridge point is at 100 FLOPs per byte
+  StepProfiler profiler(resource_manager, 2, false, 100.0, 1000.0);
+  for (int i = 0; i < 2; i++) {
+    ASSERT_TRUE(profiler.active());
+    profiler.time(
+        0, "fill", StepProfiler::Kind::Layer,
+        [&] { HCTR_LIB_THROW(cudaMemsetAsync(buffer, 0, big_bytes, gpu->get_stream())); }, 0.0,
+        big_bytes);
+    profiler.time(
+        0, "math", StepProfiler::Kind::Optimizer,
+        [&] { HCTR_LIB_THROW(cudaMemsetAsync(buffer, 0, small_bytes, gpu->get_stream())); },
+        1e9, 1e6);
+    profiler.time(0, "idle", StepProfiler::Kind::Communication, [] {});
+    profiler.end_iteration();
+  }
+  EXPECT_FALSE(profiler.active());
+
+  const std::string report = profiler.report();
+  EXPECT_NE(report.find("fill"), std::string::npos);
+  EXPECT_NE(report.find("math"), std::string::npos);
+
+  const std::string path = "step_profiler_test.json";
+  profiler.write_json(path);
+  nlohmann::json json;
+  std::ifstream(path) >> json;
+  std::remove(path.c_str());
+
+  EXPECT_EQ(json["iterations"], 2);
+  EXPECT_DOUBLE_EQ(json["peak_tflops"].get<double>(), 100.0);
+  const auto& parts = json["parts"];
+  ASSERT_EQ(parts.size(), 3);
+  // The fill of the large buffer takes the longest
+  EXPECT_EQ(parts[0]["name"], "fill");
+  EXPECT_GT(parts[0]["milliseconds"].get<double>(), 0.0);
+  EXPECT_DOUBLE_EQ(parts[0]["bytes"].get<double>(), big_bytes);
+  EXPECT_EQ(parts[0]["bound"], "memory");
+  EXPECT_GT(parts[0]["peak_fraction"].get<double>(), 0.0);
+  for (const auto& part : parts) {
+    if (part["name"] == "math") {
+      EXPECT_EQ(part["kind"], "optimizer");
+      EXPECT_EQ(part["bound"], "compute");
+    } else if (part["name"] == "idle") {
+      EXPECT_EQ(part["bound"], "-");
+    }
+  }
+
+  HCTR_LIB_THROW(cudaFree(buffer));
+}
+
+}  // namespace
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread_pool.hpp>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+TEST(thread_pool, share_bounds_concurrency) {
+  ThreadPool pool("bounded share", TaskPriority::Dump, 2);
+  EXPECT_TRUE(pool.shared());
+  EXPECT_EQ(pool.size(), 2);
+
+  std::atomic<int> running{0}, max_running{0}, done{0};
+  std::vector<std::future<void>> results;
+  for (int i = 0; i < 64; ++i) {
+    results.emplace_back(pool.submit([&]() {
+      const int now = ++running;
+      int max = max_running;
+      while (now > max && !max_running.compare_exchange_weak(max, now)) {
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+      --running;
+      ++done;
+    }));
+  }
+  ThreadPool::await(results.begin(), results.end());
+  pool.await_idle();
+  EXPECT_TRUE(pool.idle());
+  EXPECT_EQ(done, 64);
+  EXPECT_LE(max_running, 2);
+}
+
+TEST(thread_pool, share_of_one_runs_in_order) {
+  ThreadPool pool("serial share", TaskPriority::Lookup, 1);
+  std::vector<int> order;
+  std::vector<std::future<void>> results;
+  for (int i = 0; i < 256; ++i) {
+    results.emplace_back(pool.submit([&order, i]() { order.emplace_back(i); }));
+  }
+  ThreadPool::await(results.begin(), results.end());
+  ASSERT_EQ(order.size(), 256);
+  for (int i = 0; i < 256; ++i) {
+    EXPECT_EQ(order[i], i);
+  }
+}
+
+TEST(thread_pool, nested_await_on_shared_workers) {
+  // Every outer task waits for inner tasks of the same share, which must not starve the workers.
+  std::atomic<int> done{0};
+  std::vector<std::future<void>> outer;
+  for (int i = 0; i < 128; ++i) {
+    outer.emplace_back(ThreadPool::get().submit([&done]() {
+      std::vector<std::future<void>> inner;
+      for (int j = 0; j < 8; ++j) {
+        inner.emplace_back(ThreadPool::get().submit([&done]() { ++done; }));
+      }
+      ThreadPool::await(inner.begin(), inner.end());
+    }));
+  }
+  ThreadPool::await(outer.begin(), outer.end());
+  EXPECT_EQ(done, 128 * 8);
+}
+
+TEST(thread_pool, share_forwards_exceptions) {
+  ThreadPool pool("throwing share", TaskPriority::Refresh);
+  auto result = pool.submit([]() { throw std::runtime_error("task failed"); });
+  EXPECT_THROW(result.get(), std::runtime_error);
+  pool.await_idle();
+  EXPECT_NO_THROW(pool.submit([]() {}).get());
+}
+
+TEST(thread_pool, dedicated_workers) {
+  ThreadPool pool("dedicated", 3);
+  EXPECT_FALSE(pool.shared());
+  EXPECT_EQ(pool.size(), 3);
+  std::atomic<int> done{0};
+  std::vector<std::future<void>> results;
+  for (int i = 0; i < 32; ++i) {
+    results.emplace_back(pool.submit([&done]() { ++done; }));
+  }
+  ThreadPool::await(results.begin(), results.end());
+  EXPECT_EQ(done, 32);
+}
+
+}  // namespace
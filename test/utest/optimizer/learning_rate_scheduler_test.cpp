@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <common.hpp>
+#include <gpu_learning_rate_scheduler.hpp>
+#include <learning_rate_scheduler.hpp>
+#include <utest/test_utils.hpp>
+
+using namespace HugeCTR;
+
+namespace {
+
+constexpr float kBaseLr = 1.f;
+constexpr float kEndLr = 0.1f;
+
+// The CPU scheduler counts the steps from 1, the schedule starts after decay_start = 5
+float expected_cpu_lr(LrPolicy_t policy, size_t step) {
+  if (step <= 5) {
+    return kBaseLr;
+  }
+  const size_t k = step - 5;
+  if (policy == LrPolicy_t::step) {
+    return std::max(kBaseLr * std::pow(0.5f, static_cast<float>(k / 10)), kEndLr);
+  }
+  if (k >= 10) {
+    return kEndLr;
+  }
+  return kEndLr + (kBaseLr - kEndLr) * 0.5f * (1.f + std::cos(M_PI * k / 10.f));
+}
+
+// The GPU scheduler counts the steps from 0 and keeps the last decayed rate after the decay
+float expected_gpu_lr(LrPolicy_t policy, size_t step) {
+  if (policy == LrPolicy_t::step) {
+    return std::max(kBaseLr * std::pow(0.5f, static_cast<float>(step / 10)), kEndLr);
+  }
+  const size_t k = std::min<size_t>(step, 9);
+  return kEndLr + (kBaseLr - kEndLr) * 0.5f * (1.f + std::cos(M_PI * k / 10.f));
+}
+
+void cpu_schedule_test(LrPolicy_t policy) {
+  LearningRateScheduler scheduler(kBaseLr, 1, 5, 10, 2.f, kEndLr, policy, 0.5f);
+  for (size_t step = 1; step <= 50; ++step) {
+    EXPECT_NEAR(scheduler.get_next(), expected_cpu_lr(policy, step), 1e-5f) << "step " << step;
+  }
+}
+
+void gpu_schedule_test(LrPolicy_t policy) {
+  auto gpu = test::get_default_gpu();
+  CudaDeviceContext context(gpu->get_device_id());
+  GpuLearningRateScheduler scheduler(kBaseLr, 0, 0, 10, 2.f, kEndLr, gpu, policy, 0.5f);
+  for (size_t step = 0; step < 50; ++step) {
+    if (step > 0) {
+      scheduler.update();
+    }
+    float lr;
+    HCTR_LIB_THROW(cudaMemcpyAsync(&lr, scheduler.get_learning_rate(), sizeof(float),
+                                   cudaMemcpyDeviceToHost, gpu->get_stream()));
+    HCTR_LIB_THROW(cudaStreamSynchronize(gpu->get_stream()));
+    EXPECT_NEAR(lr, expected_gpu_lr(policy, step), 1e-5f) << "step " << step;
+  }
+}
+
+}  // namespace
+
+TEST(learning_rate_scheduler, cpu_cosine) { cpu_schedule_test(LrPolicy_t::cosine); }
+TEST(learning_rate_scheduler, cpu_step) { cpu_schedule_test(LrPolicy_t::step); }
+TEST(learning_rate_scheduler, gpu_cosine) { gpu_schedule_test(LrPolicy_t::cosine); }
+TEST(learning_rate_scheduler, gpu_step) { gpu_schedule_test(LrPolicy_t::step); }
+TEST(learning_rate_scheduler, step_needs_a_decay_rate) {
+  EXPECT_THROW(LearningRateScheduler(kBaseLr, 1, 5, 10, 2.f, kEndLr, LrPolicy_t::step, 0.f),
+               std::exception);
+}
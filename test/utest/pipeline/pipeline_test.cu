@@ -104,6 +104,70 @@ void pipeline_test(const std::vector<int> &device_list, bool use_graph) {
   cudaProfilerStop();
 }
 
+__global__ void add(const float *a, const float *b, float *c, int count) {
+  for (int tid = threadIdx.x; tid < count; tid += blockDim.x) {
+    c[tid] = a[tid] + b[tid];
+  }
+}
+
+// a and b run on separate streams, c and d wait for both of them
+void dependency_pipeline_test(const std::vector<int> &device_list, bool capture_as_one_graph) {
+  const auto &resource_manager = ResourceManager::create({device_list}, 0);
+  std::vector<Pipeline> pipeline_list(resource_manager->get_local_gpu_count());
+  std::vector<float *> result_list(resource_manager->get_local_gpu_count());
+  const int count = 1024 * 1024;
+
+  for (size_t i = 0; i < resource_manager->get_local_gpu_count(); ++i) {
+    auto gpu_resource = resource_manager->get_local_gpu(i);
+    CudaDeviceContext context{gpu_resource->get_device_id()};
+    float *x, *y, *z;
+    HCTR_LIB_THROW(cudaMalloc(&x, count * sizeof(float)));
+    HCTR_LIB_THROW(cudaMalloc(&y, count * sizeof(float)));
+    HCTR_LIB_THROW(cudaMalloc(&z, count * sizeof(float)));
+    result_list[i] = z;
+
+    auto a = std::make_shared<StreamContextScheduleable>(
+        [=] { setA<<<1, 1024, 0, gpu_resource->get_stream()>>>(x, count); });
+    auto b = std::make_shared<StreamContextScheduleable>(
+        [=] { setB<<<1, 1024, 0, gpu_resource->get_stream()>>>(y, count); });
+    auto c = std::make_shared<StreamContextScheduleable>(
+        [=] { add<<<1, 1024, 0, gpu_resource->get_stream()>>>(x, y, z, count); });
+    auto d = std::make_shared<StreamContextScheduleable>(
+        [=] { add<<<1, 1024, 0, gpu_resource->get_stream()>>>(z, y, z, count); });
+
+    pipeline_list[i] = Pipeline{"default",
+                                gpu_resource,
+                                {{a, {}, {"x"}},
+                                 {b, {}, {"y"}},
+                                 {c, {"x", "y"}, {"z"}},
+                                 {d, {"z", "y"}, {"z"}}},
+                                capture_as_one_graph};
+  }
+#pragma omp parallel num_threads(resource_manager->get_local_gpu_count())
+  {
+    size_t id = omp_get_thread_num();
+    auto device_id = resource_manager->get_local_gpu(id)->get_device_id();
+    CudaCPUDeviceContext context(device_id);
+    pipeline_list[id].run_graph();
+    pipeline_list[id].run_graph();
+    pipeline_list[id].run();
+  }
+  for (size_t i = 0; i < resource_manager->get_local_gpu_count(); ++i) {
+    CudaDeviceContext context{resource_manager->get_local_gpu(i)->get_device_id()};
+    HCTR_LIB_THROW(cudaStreamSynchronize(resource_manager->get_local_gpu(i)->get_stream()));
+    std::vector<float> h_z(count);
+    HCTR_LIB_THROW(
+        cudaMemcpy(h_z.data(), result_list[i], count * sizeof(float), cudaMemcpyDeviceToHost));
+    for (int j = 0; j < count; ++j) {
+      ASSERT_EQ(h_z[j], 3.f);
+    }
+  }
+}
+
 TEST(pipeline_test, graph_test) { pipeline_test({0, 1}, true); }
 
-TEST(pipeline_test, no_graph_test) { pipeline_test({0, 1}, false); }
\ No newline at end of file
+TEST(pipeline_test, no_graph_test) { pipeline_test({0, 1}, false); }
+
+TEST(pipeline_test, dependency_test) { dependency_pipeline_test({0, 1}, false); }
+
+TEST(pipeline_test, dependency_one_graph_test) { dependency_pipeline_test({0, 1}, true); }
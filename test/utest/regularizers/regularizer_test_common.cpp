@@ -118,6 +118,26 @@ void regularizer_test_common(size_t batch_size, std::vector<core23::Shape> shape
   }
   ASSERT_TRUE(test::compare_array_approx<float>(&out_wgrad.front(), &ref_wgrad.front(),
                                                 ref_wgrad.size(), eps));
+
+  // fused into the optimizer, the gradient is added by the update and the term is deferred
+  auto regularization = regularizer->fuse_into_optimizer(1);
+  std::vector<float> fused_wgrad(h_weights.size());
+  std::transform(h_weights.begin(), h_weights.end(), fused_wgrad.begin(), regularization);
+  ASSERT_TRUE(test::compare_array_approx<float>(&fused_wgrad.front(), &ref_wgrad.front(),
+                                                ref_wgrad.size(), eps));
+
+  regularizer->initialize_wgrad();
+  HCTR_LIB_THROW(cudaStreamSynchronize(test::get_default_gpu()->get_stream()));
+  core23::copy_sync(out_wgrad.data(), flat_wgrad_tensor.data(),
+                    flat_wgrad_tensor.size(0) * sizeof(float), core23::DeviceType::CPU, device);
+  std::vector<float> zero_wgrad(out_wgrad.size(), 0.f);
+  ASSERT_TRUE(test::compare_array_approx<float>(&out_wgrad.front(), &zero_wgrad.front(),
+                                                zero_wgrad.size(), eps));
+
+  regularizer->compute_rterm();
+  ASSERT_EQ(regularizer->get_rterm(), 0.f);
+  float deferred_term = regularizer->compute_deferred_rterm();
+  ASSERT_TRUE(test::compare_array_approx<float>(&deferred_term, &ref_term, 1, eps));
 }
 
 }  // namespace test
@@ -111,8 +111,8 @@ static_map<Key, Element, Initializer>::device_mutable_view::lookup_or_insert(
 
       if (status == insert_result::OCCUPIED_EMPTY || status == insert_result::OCCUPIED_RECLAIMED) {
         auto const value = g.shfl(current_slot.value(), src_lane);
-        detail::init_and_copy_array(g, this->get_dimension(), value, lookup_or_insert_pair.second,
-                                    this->get_initializer());
+        detail::init_and_copy_array(g, lookup_or_insert_pair.first, this->get_dimension(), value,
+                                    lookup_or_insert_pair.second, this->get_initializer());
         current_slot.lock().release(g, src_lane);
       } else if (status == insert_result::DUPLICATE) {
         auto const value = g.shfl(current_slot.value(), src_lane);
@@ -172,7 +172,8 @@ __device__ auto static_map<Key, Element, Initializer>::device_mutable_view::look
       element_type *insert_ptr = nullptr;
       if (status == insert_result::OCCUPIED_EMPTY || status == insert_result::OCCUPIED_RECLAIMED) {
         auto const value = g.shfl(current_slot.value(), src_lane);
-        detail::init_array(g, this->get_dimension(), value, this->get_initializer());
+        detail::init_array(g, lookup_or_insert_key, this->get_dimension(), value,
+                           this->get_initializer());
         current_slot.lock().release(g, src_lane);
         insert_ptr = value;
       } else if (status == insert_result::DUPLICATE) {
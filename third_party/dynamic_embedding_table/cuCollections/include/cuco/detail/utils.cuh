@@ -42,19 +42,20 @@ __device__ __forceinline__ void copy_array(CG const &g, uint32_t n, Element *t,
   }
 }
 
-template <typename CG, typename Element, typename Initializer>
-__device__ __forceinline__ void init_array(CG const &g, uint32_t n, Element *t,
+template <typename CG, typename Key, typename Element, typename Initializer>
+__device__ __forceinline__ void init_array(CG const &g, Key const &key, uint32_t n, Element *t,
                                            Initializer initializer) {
   for (auto i = g.thread_rank(); i < n; i += g.size()) {
-    t[i] = initializer();
+    t[i] = initializer(key, i);
   }
 }
 
-template <typename CG, typename Element, typename Initializer>
-__device__ __forceinline__ void init_and_copy_array(CG const &g, uint32_t n, Element *t1,
-                                                    Element *t2, Initializer initializer) {
+template <typename CG, typename Key, typename Element, typename Initializer>
+__device__ __forceinline__ void init_and_copy_array(CG const &g, Key const &key, uint32_t n,
+                                                    Element *t1, Element *t2,
+                                                    Initializer initializer) {
   for (auto i = g.thread_rank(); i < n; i += g.size()) {
-    t1[i] = t2[i] = initializer();
+    t1[i] = t2[i] = initializer(key, i);
   }
 }
 
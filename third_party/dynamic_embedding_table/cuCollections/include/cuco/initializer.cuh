@@ -20,36 +20,34 @@
 
 namespace cuco {
 
-namespace {
-__device__ __forceinline__ unsigned int GlobalThreadId() {
-  unsigned int smid;
-  unsigned int warpid;
-  unsigned int laneid;
-  asm("mov.u32 %0, %%smid;" : "=r"(smid));
-  asm("mov.u32 %0, %%warpid;" : "=r"(warpid));
-  asm("mov.u32 %0, %%laneid;" : "=r"(laneid));
-  return smid * 2048 + warpid * 32 + laneid;
-}
-
-}  // namespace
-
+// Initial elements of the rows inserted into a map. The random elements are drawn by Philox from
+// the seed, the key of the row and the index of the element, so that a row starts with the same
+// values whichever GPU inserts it, in whatever order, and however often it is evicted.
 class initializer {
-  curandState *states_;
+  unsigned long long seed_;
   bool use_val_;
   float val_;
+  float lower_;
+  float upper_;
 
  public:
-  initializer(curandState *states, bool use_val, float val)
-      : states_(states), use_val_(use_val), val_(val) {}
+  // Constant elements.
+  explicit initializer(float val) : seed_(0), use_val_(true), val_(val), lower_(val), upper_(val) {}
+
+  // Uniform elements in (lower, upper].
+  initializer(unsigned long long seed, float lower, float upper)
+      : seed_(seed), use_val_(false), val_(0.f), lower_(lower), upper_(upper) {}
 
-  __device__ float operator()() const {
+  template <typename Key>
+  __device__ float operator()(Key const &key, uint32_t i) const {
     if (use_val_) {
       return val_;
     }
-    float val = curand_uniform(states_ + GlobalThreadId());
-    val = (val - 0.5) * 0.1;
-    return val;
+    // Philox only advances its counter to the key and the element, it keeps no state.
+    curandStatePhilox4_32_10_t state;
+    curand_init(seed_, static_cast<unsigned long long>(key), i, &state);
+    return lower_ + (upper_ - lower_) * curand_uniform(&state);
   }
 };
 
-}  // namespace cuco
\ No newline at end of file
+}  // namespace cuco
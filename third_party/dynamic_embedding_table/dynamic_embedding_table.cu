@@ -17,40 +17,51 @@
 
 #include "dynamic_embedding_table.hpp"
 
+namespace det {
+
 namespace {
-template <typename Seed>
-__global__ void setup_kernel(Seed seed, curandState *state) {
-  auto grid = cooperative_groups::this_grid();
-  curand_init(seed, grid.thread_rank(), 0, &state[grid.thread_rank()]);
+
+cuco::initializer make_initializer(std::string const &initializer) {
+  if (initializer == "ones") {
+    return cuco::initializer(1.0f);
+  }
+  if (initializer == "zeros") {
+    return cuco::initializer(0.0f);
+  }
+  if (initializer != "") {
+    try {
+      return cuco::initializer(std::stof(initializer));
+    } catch (std::invalid_argument &err) {
+      std::cout << "Using random initializer." << std::endl;
+    }
+  }
+  std::random_device rd;
+  return cuco::initializer((static_cast<unsigned long long>(rd()) << 32) | rd(), -0.05f, 0.05f);
 }
-}  // namespace
 
-namespace det {
+}  // namespace
 
 template <typename KeyType, typename ValueType>
 DynamicEmbeddingTable<KeyType, ValueType>::DynamicEmbeddingTable(size_t num_classes,
                                                                  size_t const *dimension_per_class,
                                                                  std::string initializer,
                                                                  size_t initial_capacity)
+    : DynamicEmbeddingTable(num_classes, dimension_per_class,
+                            std::vector<cuco::initializer>(num_classes,
+                                                           make_initializer(initializer)),
+                            initial_capacity) {}
+
+template <typename KeyType, typename ValueType>
+DynamicEmbeddingTable<KeyType, ValueType>::DynamicEmbeddingTable(
+    size_t num_classes, size_t const *dimension_per_class,
+    std::vector<cuco::initializer> initializer_per_class, size_t initial_capacity)
     : initial_capacity_(initial_capacity),
       num_classes_(num_classes),
       dimension_per_class_(dimension_per_class, dimension_per_class + num_classes),
-      initializer_(initializer) {}
+      initializer_per_class_(std::move(initializer_per_class)) {}
 
 template <typename KeyType, typename ValueType>
 void DynamicEmbeddingTable<KeyType, ValueType>::initialize(cudaStream_t stream) {
-  std::random_device rd;
-  auto seed = rd();
-
-  int device;
-  CUCO_CUDA_TRY(cudaGetDevice(&device));
-  cudaDeviceProp deviceProp;
-  CUCO_CUDA_TRY(cudaGetDeviceProperties(&deviceProp, device));
-  CUCO_CUDA_TRY(cudaMallocAsync(
-      &curand_states_, sizeof(curandState) * deviceProp.multiProcessorCount * 2048, stream));
-
-  setup_kernel<<<deviceProp.multiProcessorCount * 2, 1024>>>(seed, curand_states_);
-
   for (size_t i = 0; i < num_classes_; i++) {
     cudaStream_t stream;
     CUCO_CUDA_TRY(cudaStreamCreate(&stream));
@@ -66,29 +77,8 @@ void DynamicEmbeddingTable<KeyType, ValueType>::initialize(cudaStream_t stream)
   CUCO_CUDA_TRY(cudaEventCreate(&primary_event_));
 
   for (size_t i = 0; i < num_classes_; i++) {
-    bool use_const_initializer = false;
-    float initial_val = 0.0;
-    if (initializer_ != "") {
-      if (initializer_ == "ones") {
-        use_const_initializer = true;
-        initial_val = 1.0;
-      } else if (initializer_ == "zeros") {
-        use_const_initializer = true;
-        initial_val = 0.0;
-      } else {
-        try {
-          initial_val = std::stof(initializer_);
-          use_const_initializer = true;
-        } catch (std::invalid_argument &err) {
-          std::cout << "Using random initializer." << std::endl;
-          use_const_initializer = false;
-          initial_val = 0.0;
-        }
-      }
-    }
     auto map = std::make_unique<cuco::dynamic_map<KeyType, ValueType, cuco::initializer>>(
-        dimension_per_class_[i], initial_capacity_,
-        cuco::initializer(curand_states_, use_const_initializer, initial_val));
+        dimension_per_class_[i], initial_capacity_, initializer_per_class_[i]);
     map->initialize(stream);
     maps_.push_back(std::move(map));
   }
@@ -112,7 +102,6 @@ void DynamicEmbeddingTable<KeyType, ElementType>::uninitialize(cudaStream_t stre
     CUCO_CUDA_TRY(cudaStreamDestroy(stream_per_class_[i]));
   }
 
-  CUCO_CUDA_TRY(cudaFreeAsync(curand_states_, stream));
   CUCO_CUDA_TRY(cudaGetLastError());
 }
 
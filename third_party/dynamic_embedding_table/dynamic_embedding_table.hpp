@@ -18,6 +18,7 @@
 #include <cuco/dynamic_map.cuh>
 #include <cuco/initializer.cuh>
 #include <string>
+#include <vector>
 
 namespace det {
 
@@ -26,18 +27,21 @@ class DynamicEmbeddingTable {
   const size_t initial_capacity_;
   const size_t num_classes_;
   std::vector<size_t> dimension_per_class_;
-  curandState *curand_states_;
+  std::vector<cuco::initializer> initializer_per_class_;
   std::vector<std::unique_ptr<cuco::dynamic_map<KeyType, ElementType, cuco::initializer>>> maps_;
   std::vector<cudaStream_t> stream_per_class_;
   std::vector<cudaEvent_t> event_per_class_;
   cudaEvent_t primary_event_;
-  std::string initializer_;
 
   void reserve(size_t n);
 
  public:
   DynamicEmbeddingTable(size_t num_classes, size_t const *dimension_per_class,
                         std::string initializer = "", size_t initial_capacity_for_class = 1048576);
+  // The rows of class i are created by initializer_per_class[i] from their key.
+  DynamicEmbeddingTable(size_t num_classes, size_t const *dimension_per_class,
+                        std::vector<cuco::initializer> initializer_per_class,
+                        size_t initial_capacity_for_class = 1048576);
   ~DynamicEmbeddingTable() {}
 
   void initialize(cudaStream_t stream = 0);
@@ -16,16 +16,22 @@
 
 #include <argparse/argparse.hpp>
 #include <core/memory.hpp>
+#include <atomic>
 #include <core23/logger.hpp>
+#include <fstream>
 #include <hps/hash_map_backend.hpp>
 #include <hps/hier_parameter_server_base.hpp>
+#include <hps/kafka_message.hpp>
 #include <hps/mp_hash_map_backend.hpp>
 #include <hps/redis_backend.hpp>
 #include <hps/rocksdb_backend.hpp>
+#include <inference_benchmark/workload.hpp>
 #include <iostream>
+#include <mutex>
 #include <random>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -148,6 +154,46 @@ int main(int argc, char** argv) {
       .default_value<size_t>(10)
       .scan<'u', size_t>();
 
+  // Mixed workload (YCSB-style), runs after the tests above on the filled database.
+  args.add_argument("--mixed")
+      .help("Enables the mixed workload test.")
+      .default_value(false)
+      .implicit_value(true);
+
+  args.add_argument("--mixed_threads")
+      .help("Number of client threads of the mixed workload.")
+      .default_value<size_t>(4)
+      .scan<'u', size_t>();
+
+  args.add_argument("--mixed_ops")
+      .help("Number of operations per client thread.")
+      .default_value<size_t>(10000)
+      .scan<'u', size_t>();
+
+  args.add_argument("--mixed_batch_size")
+      .help("Number of keys per operation.")
+      .default_value<size_t>(1024)
+      .scan<'u', size_t>();
+
+  args.add_argument("--mixed_read_ratio")
+      .help("Fraction of the operations that are fetches, the others are upserts.")
+      .default_value<double>(0.95)
+      .scan<'g', double>();
+
+  args.add_argument("--zipf_theta")
+      .help("Skew of the key popularity in [0, 1), 0 = uniform, 0.99 = YCSB default.")
+      .default_value<double>(0.99)
+      .scan<'g', double>();
+
+  args.add_argument("--kafka_update_rate")
+      .help("Keys per second updated through Kafka during the mixed workload, 0 = off.")
+      .default_value<size_t>(0)
+      .scan<'u', size_t>();
+
+  args.add_argument("--json_output")
+      .help("Writes the results of the mixed workload to this JSON file.")
+      .default_value<std::string>("");
+
   try {
     args.parse_args(argc, argv);
   } catch (const std::runtime_error& err) {
@@ -185,6 +231,19 @@ int main(int argc, char** argv) {
   const auto fill_burst = args.get<size_t>("--fill_burst");
   const auto query_amount = args.get<size_t>("--query_amount");
   const auto query_repeat = args.get<size_t>("--query_repeat");
+  // Mixed workload.
+  const auto mixed = args.get<bool>("--mixed");
+  const auto mixed_threads = args.get<size_t>("--mixed_threads");
+  const auto mixed_ops = args.get<size_t>("--mixed_ops");
+  const auto mixed_batch_size = args.get<size_t>("--mixed_batch_size");
+  const auto mixed_read_ratio = args.get<double>("--mixed_read_ratio");
+  const auto zipf_theta = args.get<double>("--zipf_theta");
+  const auto kafka_update_rate = args.get<size_t>("--kafka_update_rate");
+  const auto json_output = args.get<std::string>("--json_output");
+  HCTR_CHECK_HINT(zipf_theta >= 0 && zipf_theta < 1, "zipf_theta must be in [0, 1)!");
+  HCTR_CHECK_HINT(mixed_read_ratio >= 0 && mixed_read_ratio <= 1,
+                  "mixed_read_ratio must be in [0, 1]!");
+  HCTR_CHECK_HINT(mixed_batch_size <= fill_burst, "mixed_batch_size must not exceed fill_burst!");
 
   std::cout << "Options: " << std::endl
             << "  -----------------------------" << std::endl
@@ -218,6 +277,15 @@ int main(int argc, char** argv) {
             << "  fill_burst   = " << fill_burst << std::endl
             << "  query_amount = " << query_amount << std::endl
             << "  query_repeat = " << query_repeat << std::endl
+            << "  -----------------------------" << std::endl
+            << "  mixed             = " << mixed << std::endl
+            << "  mixed_threads     = " << mixed_threads << std::endl
+            << "  mixed_ops         = " << mixed_ops << std::endl
+            << "  mixed_batch_size  = " << mixed_batch_size << std::endl
+            << "  mixed_read_ratio  = " << mixed_read_ratio << std::endl
+            << "  zipf_theta        = " << zipf_theta << std::endl
+            << "  kafka_update_rate = " << kafka_update_rate << std::endl
+            << "  json_output       = " << json_output << std::endl
             << "  -----------------------------" << std::endl;
 
   const std::string tag_name = HierParameterServerBase::make_tag_name(model_name, table_name);
@@ -380,6 +448,155 @@ int main(int argc, char** argv) {
         }
       }
     }
+
+    if (mixed) {
+      HCTR_LOG_S(INFO, WORLD) << "Preparing key distribution over " << fill_amount
+                              << " keys..." << std::endl;
+      const KeyGenerator key_gen(fill_amount, zipf_theta);
+      const uint32_t value_size = static_cast<uint32_t>(emb_size * sizeof(float));
+
+      // Background updates: produced to Kafka and applied to the database like in the HPS.
+      std::unique_ptr<KafkaMessageSink<Key>> kafka_sink;
+      std::unique_ptr<KafkaMessageSource<Key>> kafka_source;
+      std::atomic<bool> clients_done{false};
+      std::atomic<size_t> num_keys_applied{0};
+      LatencyStats apply_stats;
+      std::mutex apply_stats_mutex;
+      std::thread kafka_producer;
+      if (kafka_update_rate) {
+        KafkaMessageSinkParams sink_params;
+        sink_params.brokers = kafka_broker;
+        kafka_sink = std::make_unique<KafkaMessageSink<Key>>(sink_params);
+        kafka_source =
+            std::make_unique<KafkaMessageSource<Key>>(kafka_broker, "db_bench_" + model_name);
+        kafka_source->engage([&](const std::string& tag, const size_t num_pairs,
+                                 const Key* const keys, const char* const values,
+                                 const size_t value_size) {
+          const auto t0 = std::chrono::high_resolution_clock::now();
+          db->insert(tag, num_pairs, keys, values, static_cast<uint32_t>(value_size),
+                     value_size);
+          const auto t1 = std::chrono::high_resolution_clock::now();
+          num_keys_applied += num_pairs;
+          const std::lock_guard<std::mutex> lock(apply_stats_mutex);
+          apply_stats.record(t1 - t0, num_pairs);
+        });
+
+        kafka_producer = std::thread([&]() {
+          std::mt19937_64 gen(seed + mixed_threads);
+          KeyGenerator gen_key(key_gen);
+          std::vector<Key> keys(std::min(kafka_update_rate, mixed_batch_size));
+          const auto interval = std::chrono::nanoseconds(1'000'000'000LL *
+                                                         static_cast<int64_t>(keys.size()) /
+                                                         static_cast<int64_t>(kafka_update_rate));
+          auto next = std::chrono::steady_clock::now();
+          while (!clients_done) {
+            for (Key& key : keys) {
+              key = static_cast<Key>(gen_key(gen));
+            }
+            kafka_sink->post(tag_name, keys.size(), keys.data(),
+                             reinterpret_cast<const char*>(in_values.data()), value_size);
+            next += interval;
+            std::this_thread::sleep_until(next);
+          }
+          kafka_sink->flush();
+        });
+      }
+
+      HCTR_LOG_S(INFO, WORLD) << "Running mixed workload with " << mixed_threads
+                              << " client threads..." << std::endl;
+      std::vector<LatencyStats> fetch_stats(mixed_threads);
+      std::vector<LatencyStats> upsert_stats(mixed_threads);
+      std::vector<size_t> num_misses(mixed_threads);
+      std::vector<std::thread> clients;
+      const auto t0 = std::chrono::high_resolution_clock::now();
+      for (size_t t = 0; t < mixed_threads; ++t) {
+        clients.emplace_back([&, t]() {
+          std::mt19937_64 gen(seed + t);
+          KeyGenerator gen_key(key_gen);
+          std::bernoulli_distribution is_read(mixed_read_ratio);
+          std::vector<Key> keys(mixed_batch_size);
+          std::vector<float, AlignedAllocator<float>> values(mixed_batch_size * emb_size);
+          for (size_t op = 0; op < mixed_ops; ++op) {
+            for (Key& key : keys) {
+              key = static_cast<Key>(gen_key(gen));
+            }
+            if (is_read(gen)) {
+              const auto op_t0 = std::chrono::high_resolution_clock::now();
+              const size_t num_hits =
+                  db->fetch(tag_name, keys.size(), keys.data(),
+                            reinterpret_cast<char*>(values.data()), value_size, [](size_t) {});
+              fetch_stats[t].record(std::chrono::high_resolution_clock::now() - op_t0,
+                                    keys.size());
+              num_misses[t] += keys.size() - num_hits;
+            } else {
+              const auto op_t0 = std::chrono::high_resolution_clock::now();
+              db->insert(tag_name, keys.size(), keys.data(),
+                         reinterpret_cast<const char*>(in_values.data()), value_size, value_size);
+              upsert_stats[t].record(std::chrono::high_resolution_clock::now() - op_t0,
+                                     keys.size());
+            }
+          }
+        });
+      }
+      for (std::thread& client : clients) {
+        client.join();
+      }
+      const double seconds = std::chrono::duration<double>(
+                                 std::chrono::high_resolution_clock::now() - t0)
+                                 .count();
+      clients_done = true;
+      if (kafka_producer.joinable()) {
+        kafka_producer.join();
+      }
+      // Stops consuming before the stats are read.
+      kafka_source.reset();
+      kafka_sink.reset();
+
+      for (size_t t = 1; t < mixed_threads; ++t) {
+        fetch_stats[0].merge(fetch_stats[t]);
+        upsert_stats[0].merge(upsert_stats[t]);
+        num_misses[0] += num_misses[t];
+      }
+      const auto report = [&](const char* const name, LatencyStats& stats) {
+        stats.finalize();
+        HCTR_LOG_S(INFO, WORLD) << name << ": ops = " << stats.num_ops()
+                                << ", keys = " << stats.num_keys() << std::fixed
+                                << std::setprecision(1) << ", mean = " << stats.mean()
+                                << " us, p50 = " << stats.percentile(50)
+                                << " us, p99 = " << stats.percentile(99)
+                                << " us, p999 = " << stats.percentile(99.9)
+                                << " us, max = " << stats.percentile(100) << " us, "
+                                << stats.num_keys() / seconds << " keys/s" << std::endl;
+      };
+      HCTR_LOG_S(INFO, WORLD) << "Mixed workload took " << seconds << " s" << std::endl;
+      report("fetch", fetch_stats[0]);
+      report("upsert", upsert_stats[0]);
+      if (kafka_update_rate) {
+        report("kafka apply", apply_stats);
+      }
+
+      if (!json_output.empty()) {
+        nlohmann::json results;
+        results["db_type"] = db_type;
+        results["config"] = {
+            {"fill_amount", fill_amount},        {"emb_size", emb_size},
+            {"threads", mixed_threads},          {"ops_per_thread", mixed_ops},
+            {"batch_size", mixed_batch_size},    {"read_ratio", mixed_read_ratio},
+            {"zipf_theta", zipf_theta},          {"kafka_update_rate", kafka_update_rate},
+        };
+        results["seconds"] = seconds;
+        results["fetch"] = fetch_stats[0].to_json(seconds);
+        results["fetch"]["misses"] = num_misses[0];
+        results["upsert"] = upsert_stats[0].to_json(seconds);
+        if (kafka_update_rate) {
+          results["kafka_apply"] = apply_stats.to_json(seconds);
+          results["kafka_apply"]["keys_applied"] = num_keys_applied.load();
+        }
+        std::ofstream file(json_output);
+        file << results.dump(2) << std::endl;
+        HCTR_LOG_S(INFO, WORLD) << "Results written to " << json_output << std::endl;
+      }
+    }
   } catch (const DatabaseBackendError& error) {
     HCTR_LOG_S(ERROR, WORLD) << "Partition #" << error.partition() << ": " << error.what()
                              << std::endl;
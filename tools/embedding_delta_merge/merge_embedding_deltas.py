@@ -0,0 +1,164 @@
+"""
+ Copyright (c) 2023, NVIDIA CORPORATION.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+"""
+
+import argparse
+import glob
+import logging
+import os
+import numpy as np
+
+logging.basicConfig(format="%(asctime)s %(message)s")
+logging.root.setLevel(logging.NOTSET)
+
+# Layout of the files written by Model.embedding_dump, see EmbeddingParameterIO.
+FILE_HEAD_NBYTES = 128
+META_DATA_HEAD_LENGTH = 5
+KEY_FILE_TYPE = 1
+WEIGHT_FILE_TYPE = 2
+KEY_TYPES = {0: np.uint32, 1: np.int64}
+
+
+def read_meta_data(ebc_path):
+    with open(os.path.join(ebc_path, "meta_data"), "rb") as f:
+        buffer = f.read()
+    head = np.frombuffer(buffer, dtype=np.int32, count=META_DATA_HEAD_LENGTH)
+    num_tables = int(head[0])
+    offset = META_DATA_HEAD_LENGTH * 4
+    table_ids = np.frombuffer(buffer, dtype=np.int32, count=num_tables, offset=offset)
+    offset += num_tables * 4
+    key_nums = np.frombuffer(buffer, dtype=np.uint64, count=num_tables, offset=offset)
+    offset += num_tables * 8
+    ev_lengths = np.frombuffer(buffer, dtype=np.int32, count=num_tables, offset=offset)
+    tables = {
+        int(table_id): (int(key_num), int(ev_length))
+        for table_id, key_num, ev_length in zip(table_ids, key_nums, ev_lengths)
+    }
+    return head.copy(), tables
+
+
+def write_meta_data(ebc_path, head, tables):
+    table_ids = sorted(tables)
+    head[0] = len(table_ids)
+    with open(os.path.join(ebc_path, "meta_data"), "wb") as f:
+        f.write(head.astype(np.int32).tobytes())
+        f.write(np.array(table_ids, dtype=np.int32).tobytes())
+        f.write(np.array([tables[t][0] for t in table_ids], dtype=np.uint64).tobytes())
+        f.write(np.array([tables[t][1] for t in table_ids], dtype=np.int32).tobytes())
+
+
+def read_table(ebc_path, table_id, key_type, ev_length):
+    with open(os.path.join(ebc_path, "key" + str(table_id)), "rb") as f:
+        f.seek(FILE_HEAD_NBYTES)
+        keys = np.fromfile(f, dtype=key_type)
+    with open(os.path.join(ebc_path, "weight" + str(table_id)), "rb") as f:
+        f.seek(FILE_HEAD_NBYTES)
+        weights = np.fromfile(f, dtype=np.float32).reshape(-1, ev_length)
+    if keys.shape[0] != weights.shape[0]:
+        raise RuntimeError(
+            "{}: table {} has {} keys but {} embedding vectors".format(
+                ebc_path, table_id, keys.shape[0], weights.shape[0]
+            )
+        )
+    return keys, weights
+
+
+def write_file(path, file_type, table_id, array):
+    head = np.zeros(FILE_HEAD_NBYTES // 4, dtype=np.int32)
+    head[0] = file_type
+    head[1] = table_id
+    with open(path, "wb") as f:
+        f.write(head.tobytes())
+        f.write(np.ascontiguousarray(array).tobytes())
+
+
+def merge_embedding_collection(ebc_name, src_dir_paths, dst_dir_path):
+    ebc_paths = [os.path.join(path, ebc_name) for path in src_dir_paths]
+    ebc_paths = [path for path in ebc_paths if os.path.exists(os.path.join(path, "meta_data"))]
+    metas = [read_meta_data(path) for path in ebc_paths]
+    head = metas[0][0]
+    key_type = KEY_TYPES[int(head[1])]
+
+    dst_ebc_path = os.path.join(dst_dir_path, ebc_name)
+    os.makedirs(dst_ebc_path, exist_ok=True)
+    merged_tables = {}
+    for table_id in sorted(set(t for _, tables in metas for t in tables)):
+        ev_length = next(tables[table_id][1] for _, tables in metas if table_id in tables)
+        keys = []
+        weights = []
+        for path, (_, tables) in zip(ebc_paths, metas):
+            if table_id in tables:
+                table_keys, table_weights = read_table(path, table_id, key_type, ev_length)
+                keys.append(table_keys)
+                weights.append(table_weights)
+        num_snapshots = len(keys)
+        keys = np.concatenate(keys)
+        weights = np.concatenate(weights)
+        # The last snapshot that holds a key has its latest row.
+        _, last_index = np.unique(keys[::-1], return_index=True)
+        last_index = keys.shape[0] - 1 - last_index
+        write_file(
+            os.path.join(dst_ebc_path, "key" + str(table_id)),
+            KEY_FILE_TYPE,
+            table_id,
+            keys[last_index],
+        )
+        write_file(
+            os.path.join(dst_ebc_path, "weight" + str(table_id)),
+            WEIGHT_FILE_TYPE,
+            table_id,
+            weights[last_index],
+        )
+        merged_tables[table_id] = (last_index.shape[0], ev_length)
+        logging.info(
+            "{} table {}: {} keys from {} snapshots".format(
+                ebc_name, table_id, last_index.shape[0], num_snapshots
+            )
+        )
+    write_meta_data(dst_ebc_path, head, merged_tables)
+
+
+def merge_embedding_deltas(base_dir_path, delta_dir_paths, dst_dir_path):
+    src_dir_paths = [base_dir_path] + delta_dir_paths
+    ebc_names = set()
+    for path in src_dir_paths:
+        ebc_names.update(
+            os.path.basename(ebc_path)
+            for ebc_path in glob.glob(os.path.join(path, "embedding_collection_*"))
+        )
+    for ebc_name in sorted(ebc_names):
+        merge_embedding_collection(ebc_name, src_dir_paths, dst_dir_path)
+    logging.info("Merged {} deltas into {}".format(len(delta_dir_paths), dst_dir_path))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description="Merge incremental embedding dumps into a full one"
+    )
+    parser.add_argument(
+        "--base_dir_path", type=str, required=True, help="The full Model.embedding_dump."
+    )
+    parser.add_argument(
+        "--delta_dir_paths",
+        type=str,
+        nargs="+",
+        required=True,
+        help="The incremental dumps, oldest first.",
+    )
+    parser.add_argument(
+        "--dst_dir_path", type=str, required=True, help="The directory to write the merged dump."
+    )
+    args = parser.parse_args()
+    merge_embedding_deltas(args.base_dir_path, args.delta_dir_paths, args.dst_dir_path)
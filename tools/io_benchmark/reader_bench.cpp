@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * End-to-end benchmark of the data readers: every batch is read, uploaded and split into
+ * label/dense/sparse tensors on the GPUs exactly like in training, but no model consumes it.
+ *
+ * The time of a batch is split into three stages:
+ *   read     read_a_batch_to_device_delay_release(), waits for the workers and launches the
+ *            upload and the split-3-way
+ *   collect  ready_to_collect(), hands the buffers back to the workers
+ *   device   until the GPU work of the batch is done on every local GPU
+ */
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <argparse/argparse.hpp>
+#include <chrono>
+#include <common.hpp>
+#include <data_readers/async_reader/async_reader_adapter.hpp>
+#include <data_readers/data_reader.hpp>
+#include <data_readers/metadata.hpp>
+#include <data_readers/multi_hot/async_data_reader.hpp>
+#include <fstream>
+#include <resource_manager.hpp>
+#include <thread>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+using TypeKey = long long;
+
+std::vector<int> str_to_vec(const std::string& str) {
+  std::istringstream is(str);
+  std::vector<std::string> tokens{std::istream_iterator<std::string>{is},
+                                  std::istream_iterator<std::string>{}};
+  std::vector<int> res;
+  for (auto& s : tokens) {
+    res.push_back(std::stoi(s));
+  }
+  return res;
+}
+
+// Latencies in power-of-two microsecond buckets
+class LatencyHistogram {
+ public:
+  void add(double us) {
+    samples_.push_back(us);
+    size_t bucket = 0;
+    while (bucket + 1 < buckets_.size() && us >= static_cast<double>(1ul << bucket)) {
+      ++bucket;
+    }
+    buckets_[bucket]++;
+  }
+
+  void print(const std::string& name) {
+    if (samples_.empty()) {
+      return;
+    }
+    std::sort(samples_.begin(), samples_.end());
+    auto percentile = [&](double p) {
+      return samples_[std::min(samples_.size() - 1, static_cast<size_t>(p * samples_.size()))];
+    };
+    double sum = 0.;
+    for (double s : samples_) sum += s;
+    HCTR_LOG(INFO, WORLD,
+             "%-8s mean %10.1fus  p50 %10.1fus  p90 %10.1fus  p99 %10.1fus  max %10.1fus\n",
+             name.c_str(), sum / samples_.size(), percentile(0.5), percentile(0.9),
+             percentile(0.99), samples_.back());
+    for (size_t bucket = 0; bucket < buckets_.size(); ++bucket) {
+      if (buckets_[bucket] == 0) {
+        continue;
+      }
+      const size_t lo = bucket == 0 ? 0 : 1ul << (bucket - 1);
+      HCTR_LOG(INFO, WORLD, "         [%8zu, %8zu)us %8zu %5.1f%%\n", lo, 1ul << bucket,
+               buckets_[bucket], 100. * buckets_[bucket] / samples_.size());
+    }
+  }
+
+ private:
+  std::vector<double> samples_;
+  std::vector<size_t> buckets_ = std::vector<size_t>(32, 0);
+};
+
+double cpu_seconds() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+         (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+}
+
+std::string first_parquet_file(const std::string& file_list) {
+  std::ifstream read_stream(file_list, std::ifstream::in);
+  if (!read_stream.is_open()) {
+    HCTR_OWN_THROW(Error_t::FileCannotOpen, "file list open failed: " + file_list);
+  }
+  std::string buff, first_file_name;
+  std::getline(read_stream, buff);
+  if (std::stoi(buff) == 0) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "Empty file list: " + file_list);
+  }
+  std::getline(read_stream, first_file_name);
+  return first_file_name;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  argparse::ArgumentParser args("reader_bench");
+
+  args.add_argument("--format")
+      .default_value(std::string("raw_async"))
+      .help("One of norm, raw, parquet, raw_async");
+
+  args.add_argument("--one_hot")
+      .default_value(false)
+      .implicit_value(true)
+      .help("Use the one-hot RawAsync reader instead of the multi-hot one");
+
+  args.add_argument("--label_dim").default_value(1).action([](const std::string& value) {
+    return std::stoi(value);
+  });
+
+  args.add_argument("--num_dense").default_value(13).action([](const std::string& value) {
+    return std::stoi(value);
+  });
+
+  args.add_argument("--num_categorical").default_value(26).action([](const std::string& value) {
+    return std::stoi(value);
+  });
+
+  args.add_argument("--hotness").default_value(1).action([](const std::string& value) {
+    return std::stoi(value);
+  });
+
+  args.add_argument("--batch_size").default_value(65536).action([](const std::string& value) {
+    return std::stoi(value);
+  });
+
+  args.add_argument("--gpus")
+      .default_value(std::string("0"))
+      .help("Space-delimited list of GPUs to upload the data onto");
+
+  args.add_argument("--num_workers")
+      .default_value(12)
+      .help("Worker threads of the Norm, Raw and Parquet readers")
+      .action([](const std::string& value) { return std::stoi(value); });
+
+  args.add_argument("--num_threads")
+      .default_value(1)
+      .help("I/O threads of the RawAsync readers")
+      .action([](const std::string& value) { return std::stoi(value); });
+
+  args.add_argument("--num_batches_per_thread")
+      .default_value(4)
+      .action([](const std::string& value) { return std::stoi(value); });
+
+  args.add_argument("--io_block_size").default_value(524288).action([](const std::string& value) {
+    return std::stoi(value);
+  });
+
+  args.add_argument("--io_depth").default_value(2).action([](const std::string& value) {
+    return std::stoi(value);
+  });
+
+  args.add_argument("--io_alignment").default_value(512).action([](const std::string& value) {
+    return std::stoi(value);
+  });
+
+  args.add_argument("--num_samples")
+      .default_value(0ll)
+      .help("Samples in the file, required by the Raw reader")
+      .action([](const std::string& value) { return std::stoll(value); });
+
+  args.add_argument("--num_batches").default_value(1000).action([](const std::string& value) {
+    return std::stoi(value);
+  });
+
+  args.add_argument("--warmup_batches").default_value(10).action([](const std::string& value) {
+    return std::stoi(value);
+  });
+
+  args.add_argument("--float_label_dense").default_value(false).implicit_value(true);
+
+  args.add_argument("--mixed_precision").default_value(false).implicit_value(true);
+
+  args.add_argument("file").help("Data file, or file list of the Norm and Parquet readers");
+
+  try {
+    args.parse_args(argc, argv);
+  } catch (const std::runtime_error& err) {
+    std::cout << err.what() << std::endl;
+    std::cout << args;
+    exit(1);
+  }
+
+  std::string fname;
+  try {
+    fname = args.get<std::string>("file");
+  } catch (std::logic_error& e) {
+    std::cout << "No input file provided" << std::endl;
+    exit(1);
+  }
+
+  const std::string format = args.get<std::string>("--format");
+  const bool one_hot = args.get<bool>("--one_hot");
+  const int label_dim = args.get<int>("--label_dim");
+  const int dense_dim = args.get<int>("--num_dense");
+  const int num_slots = args.get<int>("--num_categorical");
+  const int hotness = args.get<int>("--hotness");
+  const int batch_size = args.get<int>("--batch_size");
+  const int num_threads = args.get<int>("--num_threads");
+  const int num_batches_per_thread = args.get<int>("--num_batches_per_thread");
+  const bool float_label_dense = args.get<bool>("--float_label_dense");
+  const bool mixed_precision = args.get<bool>("--mixed_precision");
+  const bool fixed_length = format == "raw" || format == "raw_async";
+
+  // Without padding, the bytes of a sample once decoded
+  const size_t sample_size_bytes =
+      (label_dim + dense_dim) * sizeof(int) + num_slots * hotness * sizeof(TypeKey);
+
+#ifdef ENABLE_MPI
+  HCTR_MPI_THROW(MPI_Init(&argc, &argv));
+#endif
+  HCTR_LIB_THROW(nvmlInit_v2());
+
+  std::vector<std::vector<int>> vvgpu;
+  vvgpu.push_back(str_to_vec(args.get<std::string>("--gpus")));
+  const auto resource_manager = ResourceManager::create(vvgpu, 424242);
+
+  std::vector<DataReaderSparseParam> params{DataReaderSparseParam(
+      "data", std::vector<int>(num_slots, hotness), fixed_length, num_slots)};
+
+  std::unique_ptr<IDataReader> reader;
+  if (format == "norm" || format == "raw" || format == "parquet") {
+    auto data_reader = new DataReader<TypeKey>(batch_size, label_dim, dense_dim, params,
+                                               resource_manager, true,
+                                               args.get<int>("--num_workers"), mixed_precision);
+    reader.reset(data_reader);
+    if (format == "norm") {
+      data_reader->create_drwg_norm(fname, Check_t::Sum, true);
+    } else if (format == "raw") {
+      const long long num_samples = args.get<long long>("--num_samples");
+      HCTR_CHECK_HINT(num_samples > 0, "--num_samples is required by the Raw reader");
+      data_reader->create_drwg_raw(fname, num_samples, float_label_dense, false, true);
+    } else {
+#ifdef DISABLE_CUDF
+      HCTR_OWN_THROW(Error_t::WrongInput, "Parquet is not supported under DISABLE_CUDF");
+#else
+      std::string first_file = first_parquet_file(fname);
+      Metadata metadata;
+      metadata.reset_metadata(first_file.substr(0, first_file.find_last_of("/\\")) +
+                              "/_metadata.json");
+      const int label_dense_num = static_cast<int>(metadata.get_label_names().size() +
+                                                   metadata.get_cont_names().size());
+      data_reader->create_drwg_parquet(fname, false, {}, true, metadata.get_max_row_group(),
+                                       label_dense_num, label_dim + dense_dim);
+#endif
+    }
+  } else if (format == "raw_async" && one_hot) {
+    reader.reset(new AsyncReader<TypeKey>(
+        fname, batch_size, label_dim, dense_dim, params, mixed_precision, resource_manager,
+        num_threads, num_batches_per_thread, args.get<int>("--io_block_size"),
+        args.get<int>("--io_depth"), args.get<int>("--io_alignment")));
+  } else if (format == "raw_async") {
+    MultiHot::FileSource file_source;
+    file_source.name = fname;
+    file_source.slot_id = 0;
+    reader.reset(new MultiHot::AsyncDataReader<TypeKey>(
+        {file_source}, resource_manager, batch_size, num_threads, num_batches_per_thread, params,
+        label_dim, dense_dim, mixed_precision, false, false, float_label_dense));
+  } else {
+    HCTR_OWN_THROW(Error_t::WrongInput, "Unknown format " + format);
+  }
+  if (!reader->is_started()) {
+    reader->start();
+  }
+
+  LatencyHistogram read_latency, collect_latency, device_latency, batch_latency;
+  auto sync_devices = [&]() {
+    for (size_t i = 0; i < resource_manager->get_local_gpu_count(); ++i) {
+      CudaDeviceContext context(resource_manager->get_local_gpu(i)->get_device_id());
+      HCTR_LIB_THROW(cudaDeviceSynchronize());
+    }
+  };
+  using clock = std::chrono::high_resolution_clock;
+  auto elapsed_us = [](clock::time_point a, clock::time_point b) {
+    return std::chrono::duration<double, std::micro>(b - a).count();
+  };
+
+  for (int i = 0; i < args.get<int>("--warmup_batches"); ++i) {
+    reader->read_a_batch_to_device();
+  }
+  sync_devices();
+
+  HCTR_LOG(INFO, WORLD, "Initialization done, starting to read...\n");
+  fflush(stdout);
+
+  long long num_samples = 0;
+  int num_batches = 0;
+  const double cpu_start = cpu_seconds();
+  const auto start = clock::now();
+  for (; num_batches < args.get<int>("--num_batches"); ++num_batches) {
+    const auto t0 = clock::now();
+    const long long current_batch_size = reader->read_a_batch_to_device_delay_release();
+    const auto t1 = clock::now();
+    reader->ready_to_collect();
+    const auto t2 = clock::now();
+    sync_devices();
+    const auto t3 = clock::now();
+    if (current_batch_size == 0) {
+      break;
+    }
+    num_samples += current_batch_size;
+    read_latency.add(elapsed_us(t0, t1));
+    collect_latency.add(elapsed_us(t1, t2));
+    device_latency.add(elapsed_us(t2, t3));
+    batch_latency.add(elapsed_us(t0, t3));
+  }
+  const double seconds = elapsed_us(start, clock::now()) * 1e-6;
+  const double cpu_utilization = (cpu_seconds() - cpu_start) / seconds;
+
+  HCTR_LOG(INFO, WORLD, "%s: %d batches of %d samples on %zu GPU(s) in %.3fs\n", format.c_str(),
+           num_batches, batch_size, resource_manager->get_local_gpu_count(), seconds);
+  HCTR_LOG(INFO, WORLD, "Throughput %.0f samples/s, %.2f GB/s\n", num_samples / seconds,
+           num_samples * sample_size_bytes / (seconds * 1e9));
+  HCTR_LOG(INFO, WORLD, "CPU utilization %.1f cores (%.1f%% of %u)\n", cpu_utilization,
+           100. * cpu_utilization / std::thread::hardware_concurrency(),
+           std::thread::hardware_concurrency());
+  read_latency.print("read");
+  collect_latency.print("collect");
+  device_latency.print("device");
+  batch_latency.print("batch");
+
+  reader.reset();
+
+#ifdef ENABLE_MPI
+  HCTR_MPI_THROW(MPI_Finalize());
+#endif
+
+  return 0;
+}
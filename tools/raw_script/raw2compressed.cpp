@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nvcomp/lz4.h>
+
+#include <algorithm>
+#include <data_readers/multi_hot/compressed_format.hpp>
+#include <fstream>
+#include <string>
+#include <utils.hpp>
+#include <vector>
+
+using namespace HugeCTR;
+
+static std::string usage_str =
+    "usage: ./raw2compressed in.bin out.bin sample_size_bytes [samples_per_chunk=128]";
+
+// Chunks compressed per nvCOMP call
+static const size_t chunks_per_step = 1024;
+
+static void check_nvcomp(nvcompStatus_t status, const char *what) {
+  if (status != nvcompSuccess) {
+    HCTR_OWN_THROW(Error_t::UnspecificError,
+                   std::string(what) + " failed with nvCOMP status " + std::to_string(status));
+  }
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 4 && argc != 5) {
+    HCTR_LOG_S(INFO, WORLD) << usage_str << std::endl;
+    exit(-1);
+  }
+  const size_t sample_size_bytes = std::stoull(argv[3]);
+  const size_t samples_per_chunk = argc == 5 ? std::stoull(argv[4]) : 128;
+  const size_t chunk_bytes = sample_size_bytes * samples_per_chunk;
+  if (sample_size_bytes == 0 || samples_per_chunk == 0) {
+    HCTR_LOG_S(ERROR, WORLD) << usage_str << std::endl;
+    exit(-1);
+  }
+  if (chunk_bytes > nvcompLZ4CompressionMaxAllowedChunkSize) {
+    HCTR_LOG_S(ERROR, WORLD) << "Chunks of " << chunk_bytes << " bytes are larger than the "
+                             << nvcompLZ4CompressionMaxAllowedChunkSize
+                             << " bytes supported by nvCOMP LZ4" << std::endl;
+    exit(-1);
+  }
+
+  std::ifstream in_file(argv[1], std::ifstream::binary | std::ifstream::ate);
+  if (!in_file.is_open()) {
+    HCTR_LOG_S(ERROR, WORLD) << "Cannot open " << argv[1] << std::endl;
+    exit(-1);
+  }
+  const size_t file_size = in_file.tellg();
+  if (file_size % sample_size_bytes) {
+    HCTR_LOG_S(ERROR, WORLD) << "The size of " << argv[1] << " is not a multiple of "
+                             << sample_size_bytes << std::endl;
+    exit(-1);
+  }
+  in_file.seekg(0);
+  std::ofstream out_file(argv[2], std::ofstream::binary | std::ofstream::trunc);
+
+  const auto opts = nvcompBatchedLZ4DefaultOpts;
+  size_t temp_bytes = 0;
+  size_t max_compressed_chunk_bytes = 0;
+  check_nvcomp(nvcompBatchedLZ4CompressGetTempSize(chunks_per_step, chunk_bytes, opts, &temp_bytes),
+               "nvcompBatchedLZ4CompressGetTempSize");
+  check_nvcomp(
+      nvcompBatchedLZ4CompressGetMaxOutputChunkSize(chunk_bytes, opts, &max_compressed_chunk_bytes),
+      "nvcompBatchedLZ4CompressGetMaxOutputChunkSize");
+
+  void *temp;
+  uint8_t *uncompressed, *compressed;
+  void **uncompressed_ptrs, **compressed_ptrs;
+  size_t *uncompressed_bytes, *compressed_bytes;
+  cudaStream_t stream;
+  HCTR_LIB_THROW(cudaStreamCreate(&stream));
+  HCTR_LIB_THROW(cudaMalloc(&temp, temp_bytes));
+  HCTR_LIB_THROW(cudaMalloc(&uncompressed, chunks_per_step * chunk_bytes));
+  HCTR_LIB_THROW(cudaMalloc(&compressed, chunks_per_step * max_compressed_chunk_bytes));
+  HCTR_LIB_THROW(cudaMalloc(&uncompressed_ptrs, chunks_per_step * sizeof(void *)));
+  HCTR_LIB_THROW(cudaMalloc(&compressed_ptrs, chunks_per_step * sizeof(void *)));
+  HCTR_LIB_THROW(cudaMalloc(&uncompressed_bytes, chunks_per_step * sizeof(size_t)));
+  HCTR_LIB_THROW(cudaMalloc(&compressed_bytes, chunks_per_step * sizeof(size_t)));
+
+  std::vector<void *> h_uncompressed_ptrs(chunks_per_step), h_compressed_ptrs(chunks_per_step);
+  for (size_t c = 0; c < chunks_per_step; ++c) {
+    h_uncompressed_ptrs[c] = uncompressed + c * chunk_bytes;
+    h_compressed_ptrs[c] = compressed + c * max_compressed_chunk_bytes;
+  }
+  HCTR_LIB_THROW(cudaMemcpy(uncompressed_ptrs, h_uncompressed_ptrs.data(),
+                            chunks_per_step * sizeof(void *), cudaMemcpyHostToDevice));
+  HCTR_LIB_THROW(cudaMemcpy(compressed_ptrs, h_compressed_ptrs.data(),
+                            chunks_per_step * sizeof(void *), cudaMemcpyHostToDevice));
+
+  std::vector<char> h_uncompressed(chunks_per_step * chunk_bytes);
+  std::vector<char> h_compressed(chunks_per_step * max_compressed_chunk_bytes);
+  std::vector<size_t> h_uncompressed_bytes(chunks_per_step), h_compressed_bytes(chunks_per_step);
+  std::vector<uint64_t> index(1, 0);
+  const char padding[8] = {};
+
+  for (size_t offset = 0; offset < file_size;) {
+    const size_t step_bytes = std::min(chunks_per_step * chunk_bytes, file_size - offset);
+    const size_t num_chunks = (step_bytes + chunk_bytes - 1) / chunk_bytes;
+    in_file.read(h_uncompressed.data(), step_bytes);
+    for (size_t c = 0; c < num_chunks; ++c) {
+      h_uncompressed_bytes[c] = std::min(chunk_bytes, step_bytes - c * chunk_bytes);
+    }
+
+    HCTR_LIB_THROW(cudaMemcpyAsync(uncompressed, h_uncompressed.data(), step_bytes,
+                                   cudaMemcpyHostToDevice, stream));
+    HCTR_LIB_THROW(cudaMemcpyAsync(uncompressed_bytes, h_uncompressed_bytes.data(),
+                                   num_chunks * sizeof(size_t), cudaMemcpyHostToDevice, stream));
+    check_nvcomp(nvcompBatchedLZ4CompressAsync(uncompressed_ptrs, uncompressed_bytes, chunk_bytes,
+                                               num_chunks, temp, temp_bytes, compressed_ptrs,
+                                               compressed_bytes, opts, stream),
+                 "nvcompBatchedLZ4CompressAsync");
+    HCTR_LIB_THROW(cudaMemcpyAsync(h_compressed_bytes.data(), compressed_bytes,
+                                   num_chunks * sizeof(size_t), cudaMemcpyDeviceToHost, stream));
+    HCTR_LIB_THROW(cudaMemcpyAsync(h_compressed.data(), compressed,
+                                   num_chunks * max_compressed_chunk_bytes, cudaMemcpyDeviceToHost,
+                                   stream));
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+
+    for (size_t c = 0; c < num_chunks; ++c) {
+      CompressedChunkHeader header{h_compressed_bytes[c], h_uncompressed_bytes[c]};
+      const size_t size = sizeof(header) + header.compressed_bytes;
+      const size_t padded_size = (size + 7) / 8 * 8;
+      out_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+      out_file.write(h_compressed.data() + c * max_compressed_chunk_bytes,
+                     header.compressed_bytes);
+      out_file.write(padding, padded_size - size);
+      index.push_back(index.back() + padded_size);
+    }
+    offset += step_bytes;
+  }
+
+  CompressedFileFooter footer{COMPRESSED_MAGIC, file_size / sample_size_bytes, index.size() - 1,
+                              static_cast<uint32_t>(samples_per_chunk),
+                              static_cast<uint32_t>(sample_size_bytes)};
+  out_file.write(reinterpret_cast<const char *>(index.data()), index.size() * sizeof(uint64_t));
+  out_file.write(reinterpret_cast<const char *>(&footer), sizeof(footer));
+  out_file.close();
+  if (!out_file) {
+    HCTR_LOG_S(ERROR, WORLD) << "Failed to write " << argv[2] << std::endl;
+    exit(-1);
+  }
+  HCTR_LOG_S(INFO, WORLD) << "#samples: " << footer.num_samples << ", #chunks: "
+                          << footer.num_chunks << ", compression ratio: "
+                          << static_cast<double>(file_size) / index.back() << std::endl;
+
+  cudaFree(temp);
+  cudaFree(uncompressed);
+  cudaFree(compressed);
+  cudaFree(uncompressed_ptrs);
+  cudaFree(compressed_ptrs);
+  cudaFree(uncompressed_bytes);
+  cudaFree(compressed_bytes);
+  cudaStreamDestroy(stream);
+  return 0;
+}